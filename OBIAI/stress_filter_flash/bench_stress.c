@@ -0,0 +1,81 @@
+// Stress filter flash microbenchmarks on the shared harness
+// (bench/include/obibench.h at the top of the tree). Each operation is one
+// channel sample or one generated noise value, so batch and scalar paths
+// compare directly.
+
+#include "stress_filter_flash.h"
+#include "obibench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_CHANNELS 256
+#define BENCH_FILL 1024
+
+typedef struct {
+    stress_system_t* systems[BENCH_CHANNELS];
+    double magnitudes[BENCH_CHANNELS];
+    double noise[BENCH_FILL];
+    stress_pattern_window_t* window;
+} stress_bench_t;
+
+static void bench_triggers_batch(void* arg, uint64_t count) {
+    stress_bench_t* bench = arg;
+    while (count > 0) {
+        size_t n = count < BENCH_CHANNELS ? (size_t)count : BENCH_CHANNELS;
+        stress_process_triggers_batch(bench->systems, bench->magnitudes, n, NULL);
+        count -= n;
+    }
+}
+
+static void bench_fill_entropy(void* arg, uint64_t count) {
+    stress_bench_t* bench = arg;
+    while (count > 0) {
+        size_t n = count < BENCH_FILL ? (size_t)count : BENCH_FILL;
+        stress_fill_entropy(bench->noise, n);
+        obibench_do_not_optimize(bench->noise);
+        count -= n;
+    }
+}
+
+static void bench_prng_noise(void* arg, uint64_t count) {
+    stress_bench_t* bench = arg;
+    double sum = 0.0;
+    for (uint64_t i = 0; i < count; i++) {
+        sum += generate_prng_noise(bench->systems[0]->noise_context);
+    }
+    obibench_do_not_optimize(&sum);
+}
+
+static void bench_window_push(void* arg, uint64_t count) {
+    stress_bench_t* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        stress_pattern_window_push(bench->window, &bench->noise[i % BENCH_FILL], 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    stress_bench_t* bench = calloc(1, sizeof(*bench));
+    if (!bench) return 1;
+    for (size_t i = 0; i < BENCH_CHANNELS; i++) {
+        bench->systems[i] = stress_system_create();
+        if (!bench->systems[i]) {
+            fprintf(stderr, "Failed to create stress system\n");
+            return 1;
+        }
+        bench->magnitudes[i] = (double)(i % 16) / 16.0;
+    }
+    bench->window = stress_pattern_window_create(4096);
+    stress_fill_entropy(bench->noise, BENCH_FILL);
+
+    obibench_suite_t* suite = obibench_init("obiai-stress", argc, argv);
+    obibench_run(suite, "triggers_batch/channel", bench_triggers_batch, bench);
+    obibench_run(suite, "fill_entropy/value", bench_fill_entropy, bench);
+    obibench_run(suite, "prng_noise", bench_prng_noise, bench);
+    obibench_run(suite, "pattern_window_push", bench_window_push, bench);
+    int status = obibench_finish(suite);
+
+    stress_pattern_window_destroy(bench->window);
+    for (size_t i = 0; i < BENCH_CHANNELS; i++) stress_system_destroy(bench->systems[i]);
+    free(bench);
+    return status;
+}
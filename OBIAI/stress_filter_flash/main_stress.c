@@ -35,6 +35,9 @@ int main(int argc, char* argv[]) {
         } else if (strcmp(argv[1], "feedback") == 0) {
             stress_system_set_noise_source(sys, NOISE_FEEDBACK);
             printf("Using FEEDBACK noise source\n");
+        } else if (strcmp(argv[1], "buffered") == 0) {
+            stress_system_set_noise_source(sys, NOISE_BUFFERED_ENTROPY);
+            printf("Using BUFFERED ENTROPY noise source\n");
         } else {
             printf("Using PRNG noise source (default)\n");
         }
@@ -10,6 +10,8 @@
 #include <sys/random.h>
 #include <uuid/uuid.h>
 #include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
 
 static uint64_t get_timestamp_ns(void) {
     struct timespec ts;
@@ -20,6 +22,253 @@ static uint64_t get_timestamp_ns(void) {
     return time(NULL) * 1000000000ULL;
 }
 
+// Buffered entropy: a ChaCha20 keystream per thread, refilled ENTROPY_BLOCKS
+// blocks at a time. A fork bumps entropy_generation so the child rekeys
+// instead of repeating its parent's stream.
+#define CHACHA_WORDS 16
+#define ENTROPY_BLOCKS 4
+#define ENTROPY_RESEED_BLOCKS (1u << 16)
+
+typedef struct {
+    uint32_t state[CHACHA_WORDS];           // Constants, key, counter, nonce
+    uint32_t buffer[ENTROPY_BLOCKS * CHACHA_WORDS];
+    size_t next;                            // Next unused buffer word
+    uint32_t blocks;                        // Generated since keying
+    unsigned generation;
+    bool keyed;
+} entropy_stream_t;
+
+static __thread entropy_stream_t entropy_stream;
+static unsigned entropy_generation;
+static pthread_once_t entropy_atfork_once = PTHREAD_ONCE_INIT;
+
+static void entropy_after_fork(void) {
+    __atomic_fetch_add(&entropy_generation, 1, __ATOMIC_RELAXED);
+}
+
+static void entropy_register_atfork(void) {
+    pthread_atfork(NULL, NULL, entropy_after_fork);
+}
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(x, a, b, c, d) \
+    x[a] += x[b]; x[d] = ROTL32(x[d] ^ x[a], 16); \
+    x[c] += x[d]; x[b] = ROTL32(x[b] ^ x[c], 12); \
+    x[a] += x[b]; x[d] = ROTL32(x[d] ^ x[a], 8); \
+    x[c] += x[d]; x[b] = ROTL32(x[b] ^ x[c], 7)
+
+static void chacha20_block(const uint32_t input[CHACHA_WORDS], uint32_t output[CHACHA_WORDS]) {
+    uint32_t x[CHACHA_WORDS];
+    memcpy(x, input, sizeof(x));
+    for (int round = 0; round < 10; round++) {
+        QUARTER_ROUND(x, 0, 4, 8, 12);
+        QUARTER_ROUND(x, 1, 5, 9, 13);
+        QUARTER_ROUND(x, 2, 6, 10, 14);
+        QUARTER_ROUND(x, 3, 7, 11, 15);
+        QUARTER_ROUND(x, 0, 5, 10, 15);
+        QUARTER_ROUND(x, 1, 6, 11, 12);
+        QUARTER_ROUND(x, 2, 7, 8, 13);
+        QUARTER_ROUND(x, 3, 4, 9, 14);
+    }
+    for (int i = 0; i < CHACHA_WORDS; i++) {
+        output[i] = x[i] + input[i];
+    }
+}
+
+static void entropy_rekey(entropy_stream_t* stream) {
+    static const uint32_t sigma[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+    uint32_t seed[11];                      // Key and nonce
+    size_t filled = 0;
+    while (filled < sizeof(seed)) {
+        ssize_t result = getrandom((unsigned char*)seed + filled, sizeof(seed) - filled, 0);
+        if (result > 0) {
+            filled += (size_t)result;
+        } else if (errno != EINTR) {
+            break;
+        }
+    }
+    if (filled < sizeof(seed)) {
+        // No kernel entropy: fall back as generate_entropy_noise does
+        uint64_t now = get_timestamp_ns();
+        for (size_t i = 0; i < 11; i++) {
+            seed[i] ^= (uint32_t)rand() ^ (uint32_t)(now >> (i % 2 ? 32 : 0));
+        }
+    }
+    
+    memcpy(stream->state, sigma, sizeof(sigma));
+    memcpy(&stream->state[4], seed, 8 * sizeof(uint32_t));
+    stream->state[12] = 0;
+    memcpy(&stream->state[13], &seed[8], 3 * sizeof(uint32_t));
+    stream->blocks = 0;
+    stream->generation = __atomic_load_n(&entropy_generation, __ATOMIC_RELAXED);
+    stream->keyed = true;
+}
+
+static void entropy_refill(entropy_stream_t* stream) {
+    if (!stream->keyed) {
+        pthread_once(&entropy_atfork_once, entropy_register_atfork);
+    }
+    if (!stream->keyed || stream->blocks >= ENTROPY_RESEED_BLOCKS ||
+        stream->generation != __atomic_load_n(&entropy_generation, __ATOMIC_RELAXED)) {
+        entropy_rekey(stream);
+    }
+    for (int block = 0; block < ENTROPY_BLOCKS; block++) {
+        chacha20_block(stream->state, &stream->buffer[block * CHACHA_WORDS]);
+        stream->state[12]++;
+    }
+    stream->blocks += ENTROPY_BLOCKS;
+    stream->next = 0;
+}
+
+static uint64_t entropy_next_u64(entropy_stream_t* stream) {
+    // The generation check keeps a forked child off its parent's buffer
+    if (!stream->keyed || stream->next + 2 > ENTROPY_BLOCKS * CHACHA_WORDS ||
+        stream->generation != __atomic_load_n(&entropy_generation, __ATOMIC_RELAXED)) {
+        entropy_refill(stream);
+    }
+    uint64_t bits = (uint64_t)stream->buffer[stream->next] << 32 | stream->buffer[stream->next + 1];
+    stream->next += 2;
+    return bits;
+}
+
+// 53 random bits, so every double in [0, 1) on a 2^-53 grid is possible
+static double entropy_next_double(entropy_stream_t* stream) {
+    return (double)(entropy_next_u64(stream) >> 11) * 0x1.0p-53;
+}
+
+void stress_fill_entropy(double* out, size_t n) {
+    if (!out) return;
+    entropy_stream_t* stream = &entropy_stream;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = entropy_next_double(stream);
+    }
+}
+
+// Per-system noise state, carried in noise_context. The PRNG is
+// xoshiro256** run as NOISE_LANES independent streams stored lane-minor,
+// so a step advances every lane with the same shifts and xors and bulk
+// fills vectorise. Single draws come from the last step's spare outputs.
+#define NOISE_LANES 4
+
+typedef struct {
+    uint64_t s[4][NOISE_LANES];             // xoshiro256** words, one column per lane
+    uint64_t spare[NOISE_LANES];
+    uint32_t spare_count;                   // Unused outputs at the end of spare
+    double environment;                     // NOISE_ENVIRONMENTAL random walk
+    double feedback;                        // NOISE_FEEDBACK accumulator
+} noise_state_t;
+
+// For callers that pass no context
+static __thread noise_state_t thread_noise;
+static __thread bool thread_noise_seeded;
+
+static void noise_state_seed(noise_state_t* state) {
+    for (int lane = 0; lane < NOISE_LANES; lane++) {
+        uint64_t any = 0;
+        for (int word = 0; word < 4; word++) {
+            state->s[word][lane] = entropy_next_u64(&entropy_stream);
+            any |= state->s[word][lane];
+        }
+        if (!any) state->s[0][lane] = 1;    // All-zero state never leaves zero
+    }
+    state->spare_count = 0;
+    state->environment = 0.5;
+    state->feedback = 0.0;
+}
+
+static noise_state_t* noise_state(void* context) {
+    if (context) return context;
+    if (!thread_noise_seeded) {
+        noise_state_seed(&thread_noise);
+        thread_noise_seeded = true;
+    }
+    return &thread_noise;
+}
+
+static inline uint64_t rotl64(uint64_t v, int n) {
+    return (v << n) | (v >> (64 - n));
+}
+
+static void xoshiro_step(noise_state_t* state, uint64_t out[NOISE_LANES]) {
+    uint64_t* s0 = state->s[0];
+    uint64_t* s1 = state->s[1];
+    uint64_t* s2 = state->s[2];
+    uint64_t* s3 = state->s[3];
+    for (int lane = 0; lane < NOISE_LANES; lane++) {
+        out[lane] = rotl64(s1[lane] * 5, 7) * 9;
+        uint64_t t = s1[lane] << 17;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = rotl64(s3[lane], 45);
+    }
+}
+
+// Uniform doubles in [0, 1) on a 2^-53 grid
+static void prng_fill(noise_state_t* state, double* out, size_t n) {
+    size_t i = 0;
+    while (i < n && state->spare_count > 0) {
+        out[i++] = (double)(state->spare[NOISE_LANES - state->spare_count--] >> 11) * 0x1.0p-53;
+    }
+    uint64_t bits[NOISE_LANES];
+    for (; i + NOISE_LANES <= n; i += NOISE_LANES) {
+        xoshiro_step(state, bits);
+        for (int lane = 0; lane < NOISE_LANES; lane++) {
+            out[i + lane] = (double)(bits[lane] >> 11) * 0x1.0p-53;
+        }
+    }
+    if (i < n) {
+        xoshiro_step(state, state->spare);
+        state->spare_count = NOISE_LANES;
+        while (i < n) {
+            out[i++] = (double)(state->spare[NOISE_LANES - state->spare_count--] >> 11) * 0x1.0p-53;
+        }
+    }
+}
+
+// Kernel entropy scaled to [0, 1], fetched in chunks; falls back to the PRNG
+// for whatever getrandom cannot supply without blocking
+static void entropy_fill(noise_state_t* state, double* out, size_t n) {
+    uint32_t chunk[256];
+    size_t i = 0;
+    while (i < n) {
+        size_t want = n - i < 256 ? n - i : 256;
+        ssize_t result = getrandom(chunk, want * sizeof(uint32_t), GRND_NONBLOCK);
+        if (result < (ssize_t)sizeof(uint32_t)) break;
+        size_t got = (size_t)result / sizeof(uint32_t);
+        for (size_t j = 0; j < got; j++) {
+            out[i + j] = (double)chunk[j] / UINT32_MAX;
+        }
+        i += got;
+    }
+    prng_fill(state, out + i, n - i);
+}
+
+static void environmental_fill(noise_state_t* state, double* out, size_t n) {
+    // Placeholder for real environmental sensors
+    // In production: read from microphone, accelerometer, temperature, etc.
+    entropy_fill(state, out, n);
+    double env = state->environment;
+    for (size_t i = 0; i < n; i++) {
+        env += (out[i] - 0.5) * 0.1;
+        env = fmax(0.0, fmin(1.0, env)); // clamp [0,1]
+        out[i] = env;
+    }
+    state->environment = env;
+}
+
+static void feedback_fill(noise_state_t* state, const double* inputs, double* out, size_t n) {
+    // Feedback noise based on system state and input
+    double accumulator = state->feedback;
+    for (size_t i = 0; i < n; i++) {
+        accumulator = 0.9 * accumulator + 0.1 * (inputs ? inputs[i] : 0.0);
+        out[i] = fmod(accumulator * 7.33, 1.0); // chaotic feedback
+    }
+    state->feedback = accumulator;
+}
+
 stress_system_t* stress_system_create(void) {
     stress_system_t* sys = calloc(1, sizeof(stress_system_t));
     if (!sys) return NULL;
@@ -31,7 +280,14 @@ stress_system_t* stress_system_create(void) {
     sys->immune_window_ns = 3600000000000ULL; // 1 hour in nanoseconds
     sys->noise_source = NOISE_PRNG;
     
-    srand(time(NULL)); // Initialize PRNG
+    // Each system gets its own independently seeded streams
+    noise_state_t* noise = malloc(sizeof(noise_state_t));
+    if (!noise) {
+        free(sys);
+        return NULL;
+    }
+    noise_state_seed(noise);
+    sys->noise_context = noise;
     
     return sys;
 }
@@ -52,61 +308,100 @@ void stress_system_set_noise_source(stress_system_t* sys, noise_source_t source)
 }
 
 double generate_prng_noise(void* context) {
-    (void)context; // Suppress unused parameter warning
-    return (double)rand() / RAND_MAX;
+    double noise;
+    prng_fill(noise_state(context), &noise, 1);
+    return noise;
 }
 
 double generate_entropy_noise(void* context) {
-    (void)context; // Suppress unused parameter warning
-    uint32_t entropy;
-    ssize_t result = getrandom(&entropy, sizeof(entropy), GRND_NONBLOCK);
-    if (result == sizeof(entropy)) {
-        return (double)entropy / UINT32_MAX;
-    }
-    return generate_prng_noise(context); // fallback
+    double noise;
+    entropy_fill(noise_state(context), &noise, 1);
+    return noise;
 }
 
 double generate_environmental_noise(void* context) {
-    (void)context; // Suppress unused parameter warning
-    // Placeholder for real environmental sensors
-    // In production: read from microphone, accelerometer, temperature, etc.
-    static double env_state = 0.5;
-    env_state += (generate_entropy_noise(context) - 0.5) * 0.1;
-    env_state = fmax(0.0, fmin(1.0, env_state)); // clamp [0,1]
-    return env_state;
+    double noise;
+    environmental_fill(noise_state(context), &noise, 1);
+    return noise;
 }
 
 double generate_feedback_noise(void* context, double input) {
+    double noise;
+    feedback_fill(noise_state(context), &input, &noise, 1);
+    return noise;
+}
+
+double generate_buffered_entropy_noise(void* context) {
     (void)context; // Suppress unused parameter warning
-    // Feedback noise based on system state and input
-    static double feedback_accumulator = 0.0;
-    feedback_accumulator = 0.9 * feedback_accumulator + 0.1 * input;
-    return fmod(feedback_accumulator * 7.33, 1.0); // chaotic feedback
+    return entropy_next_double(&entropy_stream);
 }
 
-stress_packet_t* stress_process_trigger(stress_system_t* sys, double magnitude) {
-    if (!sys) return NULL;
-    
-    uint64_t now = get_timestamp_ns();
-    
-    // Add noise to magnitude based on noise source
-    double noise = 0.0;
+void stress_noise_fill(stress_system_t* sys, const double* inputs, double* out, size_t n) {
+    if (!sys || !out) return;
+    noise_state_t* state = noise_state(sys->noise_context);
     switch (sys->noise_source) {
         case NOISE_PRNG:
-            noise = generate_prng_noise(sys->noise_context);
+            prng_fill(state, out, n);
             break;
         case NOISE_ENTROPY:
-            noise = generate_entropy_noise(sys->noise_context);
+            entropy_fill(state, out, n);
             break;
         case NOISE_ENVIRONMENTAL:
-            noise = generate_environmental_noise(sys->noise_context);
+            environmental_fill(state, out, n);
             break;
         case NOISE_FEEDBACK:
-            noise = generate_feedback_noise(sys->noise_context, magnitude);
+            feedback_fill(state, inputs, out, n);
+            break;
+        case NOISE_BUFFERED_ENTROPY:
+            stress_fill_entropy(out, n);
             break;
     }
+}
+
+// Add noise to magnitude based on noise source
+static double blend_noise(stress_system_t* sys, double magnitude) {
+    double noise = 0.0;
+    stress_noise_fill(sys, &magnitude, &noise, 1);
+    
+    return magnitude * 0.8 + noise * 0.2; // blend magnitude with noise
+}
+
+// Fill the active packet on ENCODE -> BACKGROUND and open the immune window
+static void encode_packet(stress_system_t* sys, double magnitude, uint64_t now) {
+    // Generate UUID for packet
+    uuid_t uuid;
+    uuid_generate(uuid);
+    uuid_unparse(uuid, sys->active_packet.packet_id);
+    
+    sys->active_packet.state = STRESS_ENCODE;
+    sys->active_packet.trigger_magnitude = magnitude;
+    sys->active_packet.timestamp_ns = now;
+    sys->active_packet.is_encoded = true;
     
-    magnitude = magnitude * 0.8 + noise * 0.2; // blend magnitude with noise
+    // Generate encoded vector (placeholder)
+    stress_fill_entropy(sys->active_packet.encoded_vector, 128);
+    
+    sys->immune_window_start = now;
+    sys->active_packet.immune_counter = 0;
+}
+
+// Returns whether the thresholds were raised
+static bool evolve_thresholds(stress_system_t* sys) {
+    // Adaptive evolution: adjust thresholds based on effectiveness
+    if (sys->active_packet.immune_counter > sys->immune_criteria) {
+        // System is too sensitive, increase thresholds slightly
+        sys->flash_threshold *= 1.01;
+        sys->encode_confidence *= 1.005;
+        return true;
+    }
+    return false;
+}
+
+stress_packet_t* stress_process_trigger(stress_system_t* sys, double magnitude) {
+    if (!sys) return NULL;
+    
+    uint64_t now = get_timestamp_ns();
+    magnitude = blend_noise(sys, magnitude);
     
     // State machine transitions
     switch (sys->current_state) {
@@ -134,25 +429,9 @@ stress_packet_t* stress_process_trigger(stress_system_t* sys, double magnitude)
             
         case STRESS_ENCODE:
             if (magnitude >= sys->encode_confidence) {
-                // Generate UUID for packet
-                uuid_t uuid;
-                uuid_generate(uuid);
-                uuid_unparse(uuid, sys->active_packet.packet_id);
-                
-                sys->active_packet.state = STRESS_ENCODE;
-                sys->active_packet.trigger_magnitude = magnitude;
-                sys->active_packet.timestamp_ns = now;
-                sys->active_packet.is_encoded = true;
-                
-                // Generate encoded vector (placeholder)
-                for (int i = 0; i < 128; i++) {
-                    sys->active_packet.encoded_vector[i] = generate_entropy_noise(NULL);
-                }
-                
+                encode_packet(sys, magnitude, now);
                 printf("ENCODED: packet_id=%s\n", sys->active_packet.packet_id);
                 sys->current_state = STRESS_BACKGROUND;
-                sys->immune_window_start = now;
-                sys->active_packet.immune_counter = 0;
             } else {
                 printf("ENCODE_FAILED: confidence too low -> ERROR\n");
                 sys->current_state = STRESS_ERROR;
@@ -191,32 +470,76 @@ stress_packet_t* stress_process_trigger(stress_system_t* sys, double magnitude)
 }
 
 void stress_system_evolve_thresholds(stress_system_t* sys) {
-    // Adaptive evolution: adjust thresholds based on effectiveness
-    if (sys->active_packet.immune_counter > sys->immune_criteria) {
-        // System is too sensitive, increase thresholds slightly
-        sys->flash_threshold *= 1.01;
-        sys->encode_confidence *= 1.005;
+    if (evolve_thresholds(sys)) {
         printf("EVOLVE: increased sensitivity (flash=%.3f, encode=%.3f)\n", 
                sys->flash_threshold, sys->encode_confidence);
     }
 }
 
-void stress_system_adapt_to_pattern(stress_system_t* sys, double* pattern, size_t len) {
-    if (!sys || !pattern || len == 0) return;
-    
-    // Calculate pattern statistics
-    double mean = 0.0, variance = 0.0;
-    for (size_t i = 0; i < len; i++) {
-        mean += pattern[i];
+// Pattern statistics. Long patterns are summarised a block at a time: each
+// block's mean and squared deviations come from two passes while it is in
+// L1, using MOMENT_LANES independent accumulators so the sums vectorise, and
+// blocks are merged with Chan's formula. Memory is read once and the result
+// keeps the two-pass accuracy.
+#define MOMENT_BLOCK 512
+#define MOMENT_LANES 4
+
+typedef struct {
+    size_t count;
+    double mean;
+    double m2;                      // Sum of squared deviations from mean
+} moments_t;
+
+static void moments_merge(moments_t* into, const moments_t* from) {
+    if (from->count == 0) return;
+    if (into->count == 0) {
+        *into = *from;
+        return;
     }
-    mean /= len;
+    double count = (double)(into->count + from->count);
+    double delta = from->mean - into->mean;
+    into->mean += delta * (double)from->count / count;
+    into->m2 += from->m2 + delta * delta * (double)into->count * (double)from->count / count;
+    into->count += from->count;
+}
+
+static moments_t moments_of_block(const double* x, size_t n) {
+    double lanes[MOMENT_LANES] = { 0.0 };
+    size_t i = 0;
+    for (; i + MOMENT_LANES <= n; i += MOMENT_LANES) {
+        for (int lane = 0; lane < MOMENT_LANES; lane++) {
+            lanes[lane] += x[i + lane];
+        }
+    }
+    double sum = 0.0;
+    for (; i < n; i++) sum += x[i];
+    for (int lane = 0; lane < MOMENT_LANES; lane++) sum += lanes[lane];
+    double mean = sum / (double)n;
     
-    for (size_t i = 0; i < len; i++) {
-        variance += (pattern[i] - mean) * (pattern[i] - mean);
+    for (int lane = 0; lane < MOMENT_LANES; lane++) lanes[lane] = 0.0;
+    for (i = 0; i + MOMENT_LANES <= n; i += MOMENT_LANES) {
+        for (int lane = 0; lane < MOMENT_LANES; lane++) {
+            double d = x[i + lane] - mean;
+            lanes[lane] += d * d;
+        }
     }
-    variance /= len;
+    double m2 = 0.0;
+    for (; i < n; i++) m2 += (x[i] - mean) * (x[i] - mean);
+    for (int lane = 0; lane < MOMENT_LANES; lane++) m2 += lanes[lane];
     
-    // Adapt thresholds based on pattern characteristics
+    moments_t block = { n, mean, m2 };
+    return block;
+}
+
+static void moments_accumulate(moments_t* into, const double* x, size_t n) {
+    for (size_t i = 0; i < n; i += MOMENT_BLOCK) {
+        moments_t block = moments_of_block(x + i, n - i < MOMENT_BLOCK ? n - i : MOMENT_BLOCK);
+        moments_merge(into, &block);
+    }
+}
+
+// Adapt thresholds based on pattern characteristics
+static void adapt_to_variance(stress_system_t* sys, double variance) {
     if (variance < 0.1) {
         // Low variance pattern - increase sensitivity
         sys->flash_threshold *= 0.95;
@@ -229,3 +552,269 @@ void stress_system_adapt_to_pattern(stress_system_t* sys, double* pattern, size_
         printf("ADAPT: pattern high variance, decreased sensitivity\n");
     }
 }
+
+void stress_system_adapt_to_pattern(stress_system_t* sys, const double* pattern, size_t len) {
+    if (!sys || !pattern || len == 0) return;
+    
+    moments_t moments = { 0, 0.0, 0.0 };
+    moments_accumulate(&moments, pattern, len);
+    adapt_to_variance(sys, moments.m2 / (double)len);
+}
+
+// Sliding window: Welford updates for each sample entering and leaving, so
+// a push is O(1). The running sums are rebuilt from the ring once per
+// capacity evictions to keep rounding from accumulating.
+struct stress_pattern_window {
+    size_t capacity;
+    size_t next;                    // Slot the next sample goes into
+    size_t evictions;               // Since the last rebuild
+    moments_t moments;
+    double samples[];
+};
+
+stress_pattern_window_t* stress_pattern_window_create(size_t capacity) {
+    if (capacity == 0 || capacity > ((size_t)1 << 30)) return NULL;
+    stress_pattern_window_t* window = calloc(1, sizeof(*window) + capacity * sizeof(double));
+    if (!window) return NULL;
+    window->capacity = capacity;
+    return window;
+}
+
+void stress_pattern_window_destroy(stress_pattern_window_t* window) {
+    free(window);
+}
+
+static void pattern_window_rebuild(stress_pattern_window_t* window) {
+    // Oldest first, matching the order the samples arrived in
+    moments_t moments = { 0, 0.0, 0.0 };
+    moments_accumulate(&moments, window->samples + window->next, window->capacity - window->next);
+    moments_accumulate(&moments, window->samples, window->next);
+    window->moments = moments;
+    window->evictions = 0;
+}
+
+void stress_pattern_window_push(stress_pattern_window_t* window, const double* samples, size_t n) {
+    if (!window || !samples) return;
+    moments_t* m = &window->moments;
+    for (size_t i = 0; i < n; i++) {
+        double x = samples[i];
+        if (m->count < window->capacity) {
+            m->count++;
+            double delta = x - m->mean;
+            m->mean += delta / (double)m->count;
+            m->m2 += delta * (x - m->mean);
+        } else {
+            double old = window->samples[window->next];
+            double mean = m->mean + (x - old) / (double)m->count;
+            m->m2 += (x - old) * (x - mean + old - m->mean);
+            m->mean = mean;
+            window->evictions++;
+        }
+        window->samples[window->next] = x;
+        window->next = window->next + 1 == window->capacity ? 0 : window->next + 1;
+        if (window->evictions >= window->capacity) {
+            pattern_window_rebuild(window);
+        }
+    }
+    if (m->m2 < 0.0) m->m2 = 0.0;
+}
+
+size_t stress_pattern_window_count(const stress_pattern_window_t* window) {
+    return window ? window->moments.count : 0;
+}
+
+double stress_pattern_window_mean(const stress_pattern_window_t* window) {
+    return window && window->moments.count ? window->moments.mean : 0.0;
+}
+
+double stress_pattern_window_variance(const stress_pattern_window_t* window) {
+    return window && window->moments.count ? window->moments.m2 / (double)window->moments.count : 0.0;
+}
+
+void stress_system_adapt_on_window(stress_system_t* sys, stress_pattern_window_t* window,
+                                   const double* samples, size_t n) {
+    if (!sys || !window) return;
+    stress_pattern_window_push(window, samples, n);
+    if (window->moments.count < window->capacity) return;
+    adapt_to_variance(sys, stress_pattern_window_variance(window));
+}
+
+// Event ring: single producer, single consumer. Each side owns its
+// position and publishes it with release stores the other side acquires.
+struct stress_event_ring {
+    size_t mask;
+    size_t head;                    // Next to pop; written by the consumer
+    size_t tail;                    // Next to push; written by the producer
+    uint64_t dropped;
+    stress_event_t events[];
+};
+
+stress_event_ring_t* stress_event_ring_create(size_t capacity) {
+    if (capacity == 0 || capacity > ((size_t)1 << 30)) return NULL;
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    
+    stress_event_ring_t* ring = calloc(1, sizeof(stress_event_ring_t) + size * sizeof(stress_event_t));
+    if (!ring) return NULL;
+    ring->mask = size - 1;
+    return ring;
+}
+
+void stress_event_ring_destroy(stress_event_ring_t* ring) {
+    free(ring);
+}
+
+static void stress_event_ring_push(stress_event_ring_t* ring, const stress_event_t* event) {
+    size_t tail = ring->tail;
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head > ring->mask) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    ring->events[tail & ring->mask] = *event;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+size_t stress_event_ring_pop(stress_event_ring_t* ring, stress_event_t* events, size_t max) {
+    if (!ring || !events) return 0;
+    
+    size_t head = ring->head;
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    size_t count = tail - head < max ? tail - head : max;
+    for (size_t i = 0; i < count; i++) {
+        events[i] = ring->events[(head + i) & ring->mask];
+    }
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+uint64_t stress_event_ring_dropped(const stress_event_ring_t* ring) {
+    return ring ? __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+static void emit_event(stress_event_ring_t* ring, stress_event_kind_t kind, size_t channel,
+                       stress_state_t from, stress_state_t to, double magnitude, uint64_t now) {
+    if (!ring) return;
+    stress_event_t event = { kind, (uint32_t)channel, from, to, magnitude, now };
+    stress_event_ring_push(ring, &event);
+}
+
+// Batch state machine. Each state's next state hangs on at most one
+// comparison; condition_bit says which, and next_state maps its outcome.
+#define TRIGGER_BLOCK 64
+#define BIT_ENTRY 0                 // magnitude > 0.1
+#define BIT_FLASH 1                 // magnitude >= flash_threshold
+#define BIT_ENCODE 2                // magnitude >= encode_confidence
+#define BIT_IMMUNE 3                // immune_counter reached immune_criteria
+#define BIT_IN_WINDOW 4             // Immune window still open
+
+static const uint8_t condition_bit[STRESS_STATE_COUNT] = {
+    [STRESS_IDLE] = BIT_ENTRY,
+    [STRESS_ENTRY] = BIT_FLASH,
+    [STRESS_ENCODE] = BIT_ENCODE,
+    [STRESS_BACKGROUND] = BIT_IMMUNE
+};
+
+static const uint8_t next_state[STRESS_STATE_COUNT][2] = {
+    [STRESS_IDLE] = { STRESS_IDLE, STRESS_ENTRY },
+    [STRESS_ENTRY] = { STRESS_ENCODE, STRESS_FLASH },
+    [STRESS_FLASH] = { STRESS_ENCODE, STRESS_ENCODE },
+    [STRESS_ENCODE] = { STRESS_ERROR, STRESS_BACKGROUND },
+    [STRESS_BACKGROUND] = { STRESS_BACKGROUND, STRESS_IMMUNE },
+    [STRESS_IMMUNE] = { STRESS_IMMUNE, STRESS_IMMUNE },
+    [STRESS_ERROR] = { STRESS_IDLE, STRESS_IDLE }
+};
+
+static size_t process_block(stress_system_t* const systems[], const double magnitudes[],
+                            size_t first, size_t count, uint64_t now, stress_event_ring_t* events) {
+    double magnitude[TRIGGER_BLOCK];
+    double flash[TRIGGER_BLOCK];
+    double confidence[TRIGGER_BLOCK];
+    uint64_t window_age[TRIGGER_BLOCK];
+    uint64_t window_ns[TRIGGER_BLOCK];
+    uint32_t counter[TRIGGER_BLOCK];
+    uint32_t criteria[TRIGGER_BLOCK];
+    uint8_t state[TRIGGER_BLOCK];
+    uint8_t bits[TRIGGER_BLOCK];
+    uint8_t next[TRIGGER_BLOCK];
+    bool active[TRIGGER_BLOCK];
+    
+    // Gather. Noise stays scalar: sources are per system and may keep state.
+    for (size_t i = 0; i < count; i++) {
+        stress_system_t* sys = systems[first + i];
+        active[i] = sys && (unsigned)sys->current_state < STRESS_STATE_COUNT;
+        if (!active[i]) {
+            state[i] = STRESS_IDLE;
+            magnitude[i] = flash[i] = confidence[i] = 0.0;
+            window_age[i] = window_ns[i] = 0;
+            counter[i] = criteria[i] = 0;
+            continue;
+        }
+        state[i] = (uint8_t)sys->current_state;
+        magnitude[i] = blend_noise(sys, magnitudes[first + i]);
+        flash[i] = sys->flash_threshold;
+        confidence[i] = sys->encode_confidence;
+        window_age[i] = now - sys->immune_window_start;
+        window_ns[i] = sys->immune_window_ns;
+        counter[i] = sys->active_packet.immune_counter;
+        criteria[i] = sys->immune_criteria;
+    }
+    
+    // Compare: straight-line arithmetic the compiler can vectorise. The
+    // counter is what BACKGROUND would store: one more inside the window,
+    // reset outside it.
+    for (size_t i = 0; i < count; i++) {
+        uint32_t in_window = window_age[i] < window_ns[i];
+        counter[i] = (counter[i] + 1) & (0u - in_window);
+        bits[i] = (uint8_t)((magnitude[i] > 0.1) << BIT_ENTRY |
+                            (magnitude[i] >= flash[i]) << BIT_FLASH |
+                            (magnitude[i] >= confidence[i]) << BIT_ENCODE |
+                            (in_window & (counter[i] >= criteria[i])) << BIT_IMMUNE |
+                            in_window << BIT_IN_WINDOW);
+    }
+    
+    // Transition by table lookup
+    for (size_t i = 0; i < count; i++) {
+        next[i] = next_state[state[i]][(bits[i] >> condition_bit[state[i]]) & 1];
+    }
+    
+    // Scatter, with the rare heavy work (encoding, evolving) done inline
+    size_t transitions = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!active[i]) continue;
+        stress_system_t* sys = systems[first + i];
+        stress_state_t from = (stress_state_t)state[i];
+        stress_state_t to = (stress_state_t)next[i];
+        
+        if (from == STRESS_BACKGROUND) {
+            sys->active_packet.immune_counter = counter[i];
+            if (!(bits[i] & (1u << BIT_IN_WINDOW))) {
+                sys->immune_window_start = now;
+            }
+        } else if (from == STRESS_ENCODE && to == STRESS_BACKGROUND) {
+            encode_packet(sys, magnitude[i], now);
+        } else if (from == STRESS_IMMUNE && evolve_thresholds(sys)) {
+            emit_event(events, STRESS_EVENT_EVOLVED, first + i, from, to, magnitude[i], now);
+        }
+        
+        sys->current_state = to;
+        if (to != from) {
+            emit_event(events, STRESS_EVENT_TRANSITION, first + i, from, to, magnitude[i], now);
+            transitions++;
+        }
+    }
+    return transitions;
+}
+
+size_t stress_process_triggers_batch(stress_system_t* const systems[], const double magnitudes[],
+                                     size_t n, stress_event_ring_t* events) {
+    if (!systems || !magnitudes) return 0;
+    
+    uint64_t now = get_timestamp_ns();
+    size_t transitions = 0;
+    for (size_t first = 0; first < n; first += TRIGGER_BLOCK) {
+        size_t count = n - first < TRIGGER_BLOCK ? n - first : TRIGGER_BLOCK;
+        transitions += process_block(systems, magnitudes, first, count, now, events);
+    }
+    return transitions;
+}
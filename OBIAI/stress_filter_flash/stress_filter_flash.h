@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <time.h>
 
 typedef enum {
@@ -15,11 +16,14 @@ typedef enum {
     STRESS_ERROR
 } stress_state_t;
 
+#define STRESS_STATE_COUNT (STRESS_ERROR + 1)
+
 typedef enum {
     NOISE_PRNG = 0,
     NOISE_ENTROPY,
     NOISE_ENVIRONMENTAL,
-    NOISE_FEEDBACK
+    NOISE_FEEDBACK,
+    NOISE_BUFFERED_ENTROPY          // Per-thread ChaCha20 stream; one getrandom per reseed
 } noise_source_t;
 
 typedef struct {
@@ -41,7 +45,7 @@ typedef struct {
     uint64_t immune_window_start;
     stress_packet_t active_packet;
     noise_source_t noise_source;
-    void* noise_context;
+    void* noise_context;            // Per-system PRNG and noise state, owned by the system
 } stress_system_t;
 
 // Core API
@@ -50,14 +54,85 @@ void stress_system_destroy(stress_system_t* sys);
 stress_packet_t* stress_process_trigger(stress_system_t* sys, double magnitude);
 void stress_system_set_noise_source(stress_system_t* sys, noise_source_t source);
 
-// Noise generation functions
+// Batch API
+// Events replace the per-transition printf of stress_process_trigger. The
+// ring is single-producer, single-consumer: one thread runs batches while
+// another (or the same one, between batches) pops. When the ring is full,
+// new events are dropped and counted.
+typedef enum {
+    STRESS_EVENT_TRANSITION = 0,    // from -> to; ENCODE -> BACKGROUND means a packet was encoded
+    STRESS_EVENT_EVOLVED            // Thresholds raised while IMMUNE
+} stress_event_kind_t;
+
+typedef struct {
+    stress_event_kind_t kind;
+    uint32_t channel;               // Index of the system in the batch
+    stress_state_t from;
+    stress_state_t to;
+    double magnitude;               // After noise blending
+    uint64_t timestamp_ns;
+} stress_event_t;
+
+typedef struct stress_event_ring stress_event_ring_t;
+
+stress_event_ring_t* stress_event_ring_create(size_t capacity);    // Rounded up to a power of two
+void stress_event_ring_destroy(stress_event_ring_t* ring);
+size_t stress_event_ring_pop(stress_event_ring_t* ring, stress_event_t* events, size_t max);
+uint64_t stress_event_ring_dropped(const stress_event_ring_t* ring);
+
+// One sample for each of n independent systems: magnitudes[i] drives
+// systems[i], exactly as stress_process_trigger would, except that all n
+// share one clock reading and transitions go to events (which may be NULL)
+// instead of stdout. A system may appear only once per call; feed a
+// channel's next sample in the next call. Channels go through in blocks,
+// with states and thresholds gathered into flat arrays so the threshold
+// comparisons and transitions run as branch-free, vectorisable loops.
+// Returns the number of state transitions.
+size_t stress_process_triggers_batch(stress_system_t* const systems[], const double magnitudes[],
+                                     size_t n, stress_event_ring_t* events);
+
+// Noise generation functions. context is a system's noise_context; with
+// NULL they use a state private to the calling thread. None of them touch
+// rand() or other process-wide state.
 double generate_prng_noise(void* context);
 double generate_entropy_noise(void* context);
 double generate_environmental_noise(void* context);
 double generate_feedback_noise(void* context, double input);
+double generate_buffered_entropy_noise(void* context);
+
+// Fill out[0..n) with uniform doubles in [0, 1) from the calling thread's
+// ChaCha20 stream. The stream is keyed by a single getrandom, rekeyed every
+// 2^16 blocks and again in a child after fork, so n values cost no system
+// calls in the common case.
+void stress_fill_entropy(double* out, size_t n);
+
+// Fill out[0..n) from the system's noise source and state, the bulk form of
+// the generate_*_noise functions. inputs feeds NOISE_FEEDBACK and may be
+// NULL for the other sources.
+void stress_noise_fill(stress_system_t* sys, const double* inputs, double* out, size_t n);
 
 // Adaptive evolution functions
 void stress_system_evolve_thresholds(stress_system_t* sys);
-void stress_system_adapt_to_pattern(stress_system_t* sys, double* pattern, size_t len);
+
+// Adjust thresholds to the variance of pattern[0..len), read in one pass
+void stress_system_adapt_to_pattern(stress_system_t* sys, const double* pattern, size_t len);
+
+// The last capacity samples of a stream, with their mean and variance kept
+// up to date as samples are pushed, so adapting to recent input never
+// rescans history.
+typedef struct stress_pattern_window stress_pattern_window_t;
+
+stress_pattern_window_t* stress_pattern_window_create(size_t capacity);
+void stress_pattern_window_destroy(stress_pattern_window_t* window);
+void stress_pattern_window_push(stress_pattern_window_t* window, const double* samples, size_t n);
+size_t stress_pattern_window_count(const stress_pattern_window_t* window);   // At most capacity
+double stress_pattern_window_mean(const stress_pattern_window_t* window);
+double stress_pattern_window_variance(const stress_pattern_window_t* window);
+
+// Push samples into the window, then adapt as stress_system_adapt_to_pattern
+// would to the window's contents. Nothing is adapted until the window has
+// filled, so a handful of early samples cannot swing the thresholds.
+void stress_system_adapt_on_window(stress_system_t* sys, stress_pattern_window_t* window,
+                                   const double* samples, size_t n);
 
 #endif
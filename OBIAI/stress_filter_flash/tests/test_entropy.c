@@ -0,0 +1,154 @@
+// tests/test_entropy.c
+// Checks for the buffered ChaCha20 entropy stream behind encoded vectors.
+// Built with the library source included, so the block function and the
+// per-thread stream can be checked directly.
+
+#include "stress_filter_flash.c"
+#include <assert.h>
+#include <sys/wait.h>
+
+#define ENTROPY_SAMPLES 100000
+
+static void test_chacha20_block(void) {
+    printf("Testing ChaCha20 block...\n");
+
+    // RFC 7539 section 2.3.2
+    static const uint32_t input[CHACHA_WORDS] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+        0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+        0x00000001, 0x09000000, 0x4a000000, 0x00000000
+    };
+    static const uint32_t expected[CHACHA_WORDS] = {
+        0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3,
+        0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+        0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+        0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2
+    };
+    uint32_t output[CHACHA_WORDS];
+    chacha20_block(input, output);
+    assert(memcmp(output, expected, sizeof(expected)) == 0);
+
+    printf("ChaCha20 block test passed\n");
+}
+
+static void test_fill_entropy(void) {
+    printf("Testing entropy fill...\n");
+
+    // Uniform on [0, 1): in range, centred, and spread over every tenth
+    static double values[ENTROPY_SAMPLES];
+    stress_fill_entropy(values, ENTROPY_SAMPLES);
+    uint32_t deciles[10] = { 0 };
+    double sum = 0.0;
+    for (size_t i = 0; i < ENTROPY_SAMPLES; i++) {
+        assert(values[i] >= 0.0 && values[i] < 1.0);
+        deciles[(int)(values[i] * 10)]++;
+        sum += values[i];
+    }
+    assert(fabs(sum / ENTROPY_SAMPLES - 0.5) < 0.01);
+    for (int d = 0; d < 10; d++) {
+        assert(deciles[d] > ENTROPY_SAMPLES / 10 * 9 / 10 && deciles[d] < ENTROPY_SAMPLES / 10 * 11 / 10);
+    }
+
+    // Odd sizes straddle buffer refills without repeating words
+    double a[37], b[37];
+    stress_fill_entropy(a, 37);
+    stress_fill_entropy(b, 37);
+    assert(memcmp(a, b, sizeof(a)) != 0);
+    stress_fill_entropy(NULL, 4);
+    double single = generate_buffered_entropy_noise(NULL);
+    assert(single >= 0.0 && single < 1.0);
+
+    // The stream rekeys after its block budget
+    uint32_t key[8];
+    memcpy(key, &entropy_stream.state[4], sizeof(key));
+    entropy_stream.blocks = ENTROPY_RESEED_BLOCKS;
+    entropy_stream.next = ENTROPY_BLOCKS * CHACHA_WORDS;
+    stress_fill_entropy(a, 1);
+    assert(memcmp(key, &entropy_stream.state[4], sizeof(key)) != 0);
+    assert(entropy_stream.blocks == ENTROPY_BLOCKS);
+
+    printf("Entropy fill test passed\n");
+}
+
+static void* thread_fill(void* arg) {
+    stress_fill_entropy(arg, 16);
+    return NULL;
+}
+
+static void test_entropy_streams(void) {
+    printf("Testing entropy streams...\n");
+
+    // Each thread keys its own stream
+    double first[16], second[16];
+    pthread_t threads[2];
+    assert(pthread_create(&threads[0], NULL, thread_fill, first) == 0);
+    assert(pthread_create(&threads[1], NULL, thread_fill, second) == 0);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    assert(memcmp(first, second, sizeof(first)) != 0);
+
+    // A forked child rekeys instead of replaying what its parent draws next
+    double parent[16], child[16];
+    stress_fill_entropy(parent, 1);
+    int fds[2];
+    assert(pipe(fds) == 0);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        stress_fill_entropy(child, 16);
+        ssize_t written = write(fds[1], child, sizeof(child));
+        _exit(written == (ssize_t)sizeof(child) ? 0 : 1);
+    }
+    stress_fill_entropy(parent, 16);
+    size_t got = 0;
+    while (got < sizeof(child)) {
+        ssize_t result = read(fds[0], (char*)child + got, sizeof(child) - got);
+        assert(result > 0);
+        got += (size_t)result;
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    close(fds[0]);
+    close(fds[1]);
+    for (int i = 0; i < 16; i++) {
+        assert(parent[i] != child[i]);
+    }
+
+    printf("Entropy streams test passed\n");
+}
+
+static void test_encoded_vector(void) {
+    printf("Testing encoded vector...\n");
+
+    // ENCODE with enough confidence fills all 128 values from the stream
+    stress_system_t* sys = stress_system_create();
+    assert(sys != NULL);
+    encode_packet(sys, 0.9, 1234);
+    assert(sys->active_packet.is_encoded && sys->active_packet.timestamp_ns == 1234);
+    assert(strlen(sys->active_packet.packet_id) == 36);
+    double first = sys->active_packet.encoded_vector[0];
+    bool varied = false;
+    for (int i = 0; i < 128; i++) {
+        assert(sys->active_packet.encoded_vector[i] >= 0.0 && sys->active_packet.encoded_vector[i] < 1.0);
+        varied = varied || sys->active_packet.encoded_vector[i] != first;
+    }
+    assert(varied);
+
+    double previous[128];
+    memcpy(previous, sys->active_packet.encoded_vector, sizeof(previous));
+    encode_packet(sys, 0.9, 1235);
+    assert(memcmp(previous, sys->active_packet.encoded_vector, sizeof(previous)) != 0);
+
+    stress_system_destroy(sys);
+    printf("Encoded vector test passed\n");
+}
+
+int main(void) {
+    test_chacha20_block();
+    test_fill_entropy();
+    test_entropy_streams();
+    test_encoded_vector();
+    printf("All entropy tests passed!\n");
+    return 0;
+}
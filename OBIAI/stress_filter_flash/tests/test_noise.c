@@ -0,0 +1,172 @@
+// tests/test_noise.c
+// Checks for the per-system noise state: each system draws its own
+// streams, no source touches rand(), and the bulk and single-value forms
+// agree
+
+#include "stress_filter_flash.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#define NOISE_SAMPLES 4096
+#define NOISE_THREADS 4
+
+static void assert_unit_range(const double* values, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        assert(values[i] >= 0.0 && values[i] <= 1.0);
+    }
+}
+
+static void test_prng_streams(void) {
+    printf("Testing PRNG streams...\n");
+
+    // Systems created back to back still draw unrelated streams
+    stress_system_t* first = stress_system_create();
+    stress_system_t* second = stress_system_create();
+    assert(first != NULL && second != NULL && first->noise_context != second->noise_context);
+    static double a[NOISE_SAMPLES], b[NOISE_SAMPLES];
+    stress_noise_fill(first, NULL, a, NOISE_SAMPLES);
+    stress_noise_fill(second, NULL, b, NOISE_SAMPLES);
+    double sum = 0.0;
+    uint32_t equal = 0;
+    for (size_t i = 0; i < NOISE_SAMPLES; i++) {
+        assert(a[i] >= 0.0 && a[i] < 1.0);
+        sum += a[i];
+        equal += a[i] == b[i];
+    }
+    assert(equal == 0);
+    assert(fabs(sum / NOISE_SAMPLES - 0.5) < 0.03);
+
+    // Single draws and odd-sized fills carry on one stream without repeats
+    double single[7];
+    for (int i = 0; i < 7; i++) single[i] = generate_prng_noise(first->noise_context);
+    stress_noise_fill(first, NULL, a, 5);
+    for (int i = 0; i < 7; i++) {
+        assert(single[i] >= 0.0 && single[i] < 1.0);
+        for (int j = 0; j < 5; j++) assert(single[i] != a[j]);
+    }
+
+    // Without a context the calling thread's state is used
+    double context_free = generate_prng_noise(NULL);
+    assert(context_free >= 0.0 && context_free < 1.0);
+
+    stress_system_destroy(first);
+    stress_system_destroy(second);
+    printf("PRNG streams test passed\n");
+}
+
+static void test_stateful_sources(void) {
+    printf("Testing stateful sources...\n");
+
+    // Feedback depends only on a system's own inputs: interleaving two
+    // systems changes nothing, and bulk and single draws agree
+    stress_system_t* bulk = stress_system_create();
+    stress_system_t* single = stress_system_create();
+    stress_system_t* other = stress_system_create();
+    assert(bulk != NULL && single != NULL && other != NULL);
+    stress_system_set_noise_source(bulk, NOISE_FEEDBACK);
+    double inputs[64], expected[64];
+    for (int i = 0; i < 64; i++) inputs[i] = (double)(i % 9) / 9.0;
+    stress_noise_fill(bulk, inputs, expected, 64);
+    for (int i = 0; i < 64; i++) {
+        assert(generate_feedback_noise(single->noise_context, inputs[i]) == expected[i]);
+        generate_feedback_noise(other->noise_context, 1.0 - inputs[i]);
+    }
+
+    // The environmental walk stays in [0, 1] and moves at most 0.05 a step,
+    // per system
+    stress_system_set_noise_source(bulk, NOISE_ENVIRONMENTAL);
+    static double walk[NOISE_SAMPLES];
+    stress_noise_fill(bulk, NULL, walk, NOISE_SAMPLES);
+    assert_unit_range(walk, NOISE_SAMPLES);
+    assert(fabs(walk[0] - 0.5) <= 0.05);
+    for (size_t i = 1; i < NOISE_SAMPLES; i++) {
+        assert(fabs(walk[i] - walk[i - 1]) <= 0.05 + 1e-12);
+    }
+    double fresh = generate_environmental_noise(other->noise_context);
+    assert(fabs(fresh - 0.5) <= 0.05);
+    double next = generate_environmental_noise(bulk->noise_context);
+    assert(fabs(next - walk[NOISE_SAMPLES - 1]) <= 0.05 + 1e-12);
+
+    // Kernel entropy, in bulk and singly
+    stress_system_set_noise_source(bulk, NOISE_ENTROPY);
+    stress_noise_fill(bulk, NULL, walk, NOISE_SAMPLES);
+    assert_unit_range(walk, NOISE_SAMPLES);
+    double entropy = generate_entropy_noise(bulk->noise_context);
+    assert(entropy >= 0.0 && entropy <= 1.0);
+
+    stress_noise_fill(NULL, NULL, walk, 4);
+    stress_noise_fill(bulk, NULL, NULL, 4);
+    stress_system_destroy(bulk);
+    stress_system_destroy(single);
+    stress_system_destroy(other);
+    printf("Stateful sources test passed\n");
+}
+
+static void test_rand_untouched(void) {
+    printf("Testing rand() is untouched...\n");
+
+    srand(5);
+    int expected[3] = { rand(), rand(), rand() };
+    srand(5);
+    stress_system_t* sys = stress_system_create();
+    assert(sys != NULL);
+    double out[256];
+    for (int source = NOISE_PRNG; source <= NOISE_BUFFERED_ENTROPY; source++) {
+        stress_system_set_noise_source(sys, (noise_source_t)source);
+        stress_noise_fill(sys, out, out, 256);
+        generate_prng_noise(sys->noise_context);
+        generate_entropy_noise(NULL);
+        generate_environmental_noise(NULL);
+        generate_feedback_noise(NULL, 0.5);
+    }
+    for (int i = 0; i < 3; i++) {
+        assert(rand() == expected[i]);
+    }
+
+    stress_system_destroy(sys);
+    printf("rand() untouched test passed\n");
+}
+
+static void* draw_noise(void* arg) {
+    stress_system_t* sys = arg;
+    double out[256];
+    for (int round = 0; round < 200; round++) {
+        stress_system_set_noise_source(sys, (noise_source_t)(round % 4));
+        stress_noise_fill(sys, out, out, 256);
+        assert_unit_range(out, 256);
+        stress_process_triggers_batch(&sys, out, 1, NULL);
+    }
+    return NULL;
+}
+
+static void test_noise_threads(void) {
+    printf("Testing noise across threads...\n");
+
+    // Systems on different threads share no noise state
+    stress_system_t* systems[NOISE_THREADS];
+    pthread_t threads[NOISE_THREADS];
+    for (int i = 0; i < NOISE_THREADS; i++) {
+        systems[i] = stress_system_create();
+        assert(systems[i] != NULL);
+        assert(pthread_create(&threads[i], NULL, draw_noise, systems[i]) == 0);
+    }
+    for (int i = 0; i < NOISE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        stress_system_destroy(systems[i]);
+    }
+
+    printf("Noise across threads test passed\n");
+}
+
+int main(void) {
+    test_prng_streams();
+    test_stateful_sources();
+    test_rand_untouched();
+    test_noise_threads();
+    printf("All noise tests passed!\n");
+    return 0;
+}
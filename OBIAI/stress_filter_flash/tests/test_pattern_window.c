@@ -0,0 +1,149 @@
+// tests/test_pattern_window.c
+// Checks for pattern adaptation: the one-pass variance keeps two-pass
+// accuracy, and the sliding window tracks the last N samples exactly
+
+#include "stress_filter_flash.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define PATTERN_LENGTH 1537         // Three blocks and one sample
+#define WINDOW_CAPACITY 100
+
+// Two-pass reference
+static void reference_moments(const double* x, size_t n, double* mean, double* variance) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += x[i];
+    *mean = sum / (double)n;
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; i++) m2 += (x[i] - *mean) * (x[i] - *mean);
+    *variance = m2 / (double)n;
+}
+
+static double next_sample(uint64_t* seed) {
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(*seed >> 11) * 0x1.0p-53;
+}
+
+static void test_adapt_to_pattern(void) {
+    printf("Testing adapt to pattern...\n");
+
+    // Alternating +-spread around a large offset: variance is spread^2,
+    // which a sum-of-squares shortcut would lose at this offset
+    static double pattern[PATTERN_LENGTH];
+    struct { double spread; double flash; double encode; } cases[] = {
+        { 0.30, 0.50 * 0.95, 0.65 * 0.98 },    // 0.09: more sensitive
+        { 0.33, 0.50, 0.65 },                  // 0.1089: unchanged
+        { 0.70, 0.50, 0.65 },                  // 0.49: unchanged
+        { 0.72, 0.50 * 1.05, 0.65 * 1.02 }     // 0.5184: less sensitive
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        // An even count so the mean is exactly the offset
+        for (size_t i = 0; i < PATTERN_LENGTH - 1; i++) {
+            pattern[i] = 1e8 + (i % 2 ? cases[c].spread : -cases[c].spread);
+        }
+        stress_system_t* sys = stress_system_create();
+        assert(sys != NULL);
+        stress_system_adapt_to_pattern(sys, pattern, PATTERN_LENGTH - 1);
+        assert(fabs(sys->flash_threshold - cases[c].flash) < 1e-12);
+        assert(fabs(sys->encode_confidence - cases[c].encode) < 1e-12);
+        stress_system_destroy(sys);
+    }
+
+    // Nothing to adapt to
+    stress_system_t* sys = stress_system_create();
+    assert(sys != NULL);
+    stress_system_adapt_to_pattern(sys, pattern, 0);
+    stress_system_adapt_to_pattern(sys, NULL, 4);
+    stress_system_adapt_to_pattern(NULL, pattern, 4);
+    assert(sys->flash_threshold == 0.50 && sys->encode_confidence == 0.65);
+    stress_system_destroy(sys);
+
+    printf("Adapt to pattern test passed\n");
+}
+
+static void test_window_moments(void) {
+    printf("Testing window moments...\n");
+
+    assert(stress_pattern_window_create(0) == NULL);
+    assert(stress_pattern_window_count(NULL) == 0);
+    assert(stress_pattern_window_mean(NULL) == 0.0 && stress_pattern_window_variance(NULL) == 0.0);
+
+    stress_pattern_window_t* window = stress_pattern_window_create(WINDOW_CAPACITY);
+    assert(window != NULL);
+    assert(stress_pattern_window_count(window) == 0 && stress_pattern_window_variance(window) == 0.0);
+
+    // Pushes of every size, past many rebuilds, with an offset that makes
+    // drift visible; after each the window matches the last samples
+    static double history[40 * WINDOW_CAPACITY];
+    size_t total = 0;
+    uint64_t seed = 3;
+    for (size_t n = 1; total + n <= sizeof(history) / sizeof(history[0]); n = n % 97 + 1) {
+        for (size_t i = 0; i < n; i++) history[total + i] = 1000.0 + next_sample(&seed);
+        stress_pattern_window_push(window, history + total, n);
+        total += n;
+
+        size_t count = total < WINDOW_CAPACITY ? total : WINDOW_CAPACITY;
+        assert(stress_pattern_window_count(window) == count);
+        double mean, variance;
+        reference_moments(history + total - count, count, &mean, &variance);
+        assert(fabs(stress_pattern_window_mean(window) - mean) < 1e-9);
+        assert(fabs(stress_pattern_window_variance(window) - variance) < 1e-9);
+    }
+    assert(total > 30 * WINDOW_CAPACITY);
+
+    // A constant stream settles to zero variance, never below
+    double constant[WINDOW_CAPACITY];
+    for (size_t i = 0; i < WINDOW_CAPACITY; i++) constant[i] = 0.25;
+    stress_pattern_window_push(window, constant, WINDOW_CAPACITY);
+    assert(fabs(stress_pattern_window_mean(window) - 0.25) < 1e-9);
+    assert(stress_pattern_window_variance(window) >= 0.0 && stress_pattern_window_variance(window) < 1e-9);
+    stress_pattern_window_push(window, NULL, 4);
+    stress_pattern_window_push(NULL, constant, 4);
+    assert(stress_pattern_window_count(window) == WINDOW_CAPACITY);
+
+    stress_pattern_window_destroy(window);
+    stress_pattern_window_destroy(NULL);
+    printf("Window moments test passed\n");
+}
+
+static void test_adapt_on_window(void) {
+    printf("Testing adapt on window...\n");
+
+    stress_system_t* sys = stress_system_create();
+    stress_pattern_window_t* window = stress_pattern_window_create(WINDOW_CAPACITY);
+    assert(sys != NULL && window != NULL);
+
+    // Low variance, but nothing happens until the window has filled
+    double calm[WINDOW_CAPACITY];
+    for (size_t i = 0; i < WINDOW_CAPACITY; i++) calm[i] = 0.5 + (i % 2 ? 0.01 : -0.01);
+    stress_system_adapt_on_window(sys, window, calm, WINDOW_CAPACITY - 1);
+    assert(sys->flash_threshold == 0.50 && sys->encode_confidence == 0.65);
+    stress_system_adapt_on_window(sys, window, calm, 1);
+    assert(fabs(sys->flash_threshold - 0.50 * 0.95) < 1e-12);
+
+    // Then each push adapts to the window as it now stands
+    double wild[WINDOW_CAPACITY];
+    for (size_t i = 0; i < WINDOW_CAPACITY; i++) wild[i] = i % 2 ? 2.0 : -2.0;
+    stress_system_adapt_on_window(sys, window, wild, WINDOW_CAPACITY);
+    assert(fabs(sys->flash_threshold - 0.50 * 0.95 * 1.05) < 1e-12);
+    assert(fabs(sys->encode_confidence - 0.65 * 0.98 * 1.02) < 1e-12);
+    stress_system_adapt_on_window(sys, window, NULL, 0);
+    assert(fabs(sys->flash_threshold - 0.50 * 0.95 * 1.05 * 1.05) < 1e-12);
+
+    stress_system_adapt_on_window(NULL, window, wild, 1);
+    stress_system_adapt_on_window(sys, NULL, wild, 1);
+    stress_pattern_window_destroy(window);
+    stress_system_destroy(sys);
+    printf("Adapt on window test passed\n");
+}
+
+int main(void) {
+    test_adapt_to_pattern();
+    test_window_moments();
+    test_adapt_on_window();
+    printf("All pattern window tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,257 @@
+// tests/test_trigger_batch.c
+// Checks for stress_process_triggers_batch: it moves every channel exactly
+// as stress_process_trigger would, and its event ring accounts for every
+// transition
+
+#include "stress_filter_flash.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define MATCH_CHANNELS 150          // Two full blocks and a partial one
+#define MATCH_STEPS 60
+#define RING_CHANNELS 64
+#define RING_BATCHES 2000
+
+// Deterministic magnitudes in [0, 1)
+static double next_magnitude(uint64_t* seed) {
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(*seed >> 11) * 0x1.0p-53;
+}
+
+// The scalar path reports on stdout; keep it out of the test log
+static int quiet_begin(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved >= 0 && null >= 0);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void quiet_end(int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static void test_batch_matches_scalar(void) {
+    printf("Testing batch against scalar...\n");
+
+    // Feedback noise depends only on the inputs, so paired systems see the
+    // same blended magnitudes on either path
+    stress_system_t* scalar[MATCH_CHANNELS];
+    stress_system_t* batch[MATCH_CHANNELS];
+    for (int i = 0; i < MATCH_CHANNELS; i++) {
+        scalar[i] = stress_system_create();
+        batch[i] = stress_system_create();
+        assert(scalar[i] != NULL && batch[i] != NULL);
+        stress_system_set_noise_source(scalar[i], NOISE_FEEDBACK);
+        stress_system_set_noise_source(batch[i], NOISE_FEEDBACK);
+        scalar[i]->immune_criteria = batch[i]->immune_criteria = (uint32_t)(i % 4 + 1);
+        if (i % 5 == 0) {
+            scalar[i]->immune_window_ns = batch[i]->immune_window_ns = 0;   // Always expired
+        }
+    }
+
+    stress_event_ring_t* ring = stress_event_ring_create(4 * MATCH_CHANNELS);
+    assert(ring != NULL);
+    stress_event_t events[4 * MATCH_CHANNELS];
+    double magnitudes[MATCH_CHANNELS];
+    bool visited[STRESS_STATE_COUNT] = { false };
+    uint64_t seed = 42;
+    uint32_t evolutions = 0;
+
+    for (int step = 0; step < MATCH_STEPS; step++) {
+        stress_state_t before[MATCH_CHANNELS];
+        double flash_before[MATCH_CHANNELS];
+        for (int i = 0; i < MATCH_CHANNELS; i++) {
+            magnitudes[i] = next_magnitude(&seed);
+            before[i] = scalar[i]->current_state;
+            flash_before[i] = scalar[i]->flash_threshold;
+            // Evolution needs more immune hits than the criteria, which the
+            // state machine alone never gives; lower it once immune
+            if (before[i] == STRESS_IMMUNE && i % 3 == 0) {
+                scalar[i]->immune_criteria = batch[i]->immune_criteria = 0;
+            }
+        }
+
+        int saved = quiet_begin();
+        size_t expected = 0;
+        uint32_t evolved = 0;
+        for (int i = 0; i < MATCH_CHANNELS; i++) {
+            assert(stress_process_trigger(scalar[i], magnitudes[i]) == &scalar[i]->active_packet);
+            expected += scalar[i]->current_state != before[i];
+            evolved += scalar[i]->flash_threshold != flash_before[i];
+        }
+        quiet_end(saved);
+
+        assert(stress_process_triggers_batch(batch, magnitudes, MATCH_CHANNELS, ring) == expected);
+        for (int i = 0; i < MATCH_CHANNELS; i++) {
+            assert(batch[i]->current_state == scalar[i]->current_state);
+            assert(batch[i]->flash_threshold == scalar[i]->flash_threshold);
+            assert(batch[i]->encode_confidence == scalar[i]->encode_confidence);
+            assert(batch[i]->active_packet.immune_counter == scalar[i]->active_packet.immune_counter);
+            assert(batch[i]->active_packet.is_encoded == scalar[i]->active_packet.is_encoded);
+            if (batch[i]->active_packet.is_encoded) {
+                assert(strlen(batch[i]->active_packet.packet_id) == 36);
+            }
+            visited[batch[i]->current_state] = true;
+        }
+
+        // One event per transition, in channel order, plus one per evolution
+        size_t popped = stress_event_ring_pop(ring, events, 4 * MATCH_CHANNELS);
+        size_t transitions = 0;
+        uint32_t evolved_events = 0;
+        int last_channel = -1;
+        for (size_t e = 0; e < popped; e++) {
+            int channel = (int)events[e].channel;
+            assert(channel >= last_channel && channel < MATCH_CHANNELS);
+            last_channel = channel;
+            if (events[e].kind == STRESS_EVENT_EVOLVED) {
+                assert(events[e].from == STRESS_IMMUNE);
+                evolved_events++;
+            } else {
+                assert(events[e].from == before[channel] && events[e].to == scalar[channel]->current_state);
+                assert(events[e].from != events[e].to);
+                transitions++;
+            }
+        }
+        assert(transitions == expected && evolved_events == evolved);
+        evolutions += evolved;
+    }
+    assert(stress_event_ring_dropped(ring) == 0);
+
+    // The run went through the whole machine
+    for (int state = 0; state < STRESS_STATE_COUNT; state++) {
+        assert(visited[state]);
+    }
+    assert(evolutions > 0);
+
+    for (int i = 0; i < MATCH_CHANNELS; i++) {
+        stress_system_destroy(scalar[i]);
+        stress_system_destroy(batch[i]);
+    }
+    stress_event_ring_destroy(ring);
+    printf("Batch against scalar test passed\n");
+}
+
+static void test_event_ring(void) {
+    printf("Testing event ring...\n");
+
+    assert(stress_event_ring_create(0) == NULL);
+    assert(stress_event_ring_pop(NULL, NULL, 1) == 0);
+    assert(stress_event_ring_dropped(NULL) == 0);
+
+    // Five rounds up to eight; what does not fit is dropped and counted
+    stress_event_ring_t* ring = stress_event_ring_create(5);
+    assert(ring != NULL);
+    stress_system_t* systems[12];
+    double magnitudes[12];
+    for (int i = 0; i < 12; i++) {
+        systems[i] = stress_system_create();
+        assert(systems[i] != NULL);
+        systems[i]->current_state = STRESS_FLASH;    // FLASH always moves to ENCODE
+        magnitudes[i] = 0.5;
+    }
+    assert(stress_process_triggers_batch(systems, magnitudes, 12, ring) == 12);
+    stress_event_t events[16];
+    assert(stress_event_ring_pop(ring, events, 3) == 3);
+    assert(events[0].channel == 0 && events[2].channel == 2);
+    assert(stress_event_ring_pop(ring, events, 16) == 5);
+    assert(events[4].channel == 7 && events[4].to == STRESS_ENCODE);
+    assert(stress_event_ring_dropped(ring) == 4);
+    assert(stress_event_ring_pop(ring, events, 16) == 0);
+
+    // Missing or corrupt systems are skipped; a NULL ring discards events
+    systems[3]->current_state = (stress_state_t)STRESS_STATE_COUNT;
+    stress_system_t* holes[3] = { systems[2], NULL, systems[3] };
+    assert(stress_process_triggers_batch(holes, magnitudes, 3, NULL) == 1);
+    assert(systems[3]->current_state == (stress_state_t)STRESS_STATE_COUNT);
+    assert(stress_process_triggers_batch(NULL, magnitudes, 3, ring) == 0);
+    assert(stress_process_triggers_batch(systems, NULL, 3, ring) == 0);
+    assert(stress_process_triggers_batch(systems, magnitudes, 0, ring) == 0);
+    assert(stress_event_ring_pop(ring, events, 16) == 0);
+
+    for (int i = 0; i < 12; i++) stress_system_destroy(systems[i]);
+    stress_event_ring_destroy(ring);
+    printf("Event ring test passed\n");
+}
+
+typedef struct {
+    stress_event_ring_t* ring;
+    stress_system_t* systems[RING_CHANNELS];
+    size_t transitions;
+    bool done;
+} ring_run_t;
+
+static void* ring_producer(void* arg) {
+    ring_run_t* run = arg;
+    double magnitudes[RING_CHANNELS];
+    uint64_t seed = 7;
+    for (int batch = 0; batch < RING_BATCHES; batch++) {
+        for (int i = 0; i < RING_CHANNELS; i++) magnitudes[i] = next_magnitude(&seed);
+        run->transitions += stress_process_triggers_batch(run->systems, magnitudes, RING_CHANNELS, run->ring);
+    }
+    __atomic_store_n(&run->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void test_ring_threads(void) {
+    printf("Testing event ring across threads...\n");
+
+    ring_run_t run = { .ring = stress_event_ring_create(1024) };
+    assert(run.ring != NULL);
+    stress_state_t last[RING_CHANNELS];
+    for (int i = 0; i < RING_CHANNELS; i++) {
+        run.systems[i] = stress_system_create();
+        assert(run.systems[i] != NULL);
+        last[i] = STRESS_IDLE;
+    }
+
+    pthread_t producer;
+    assert(pthread_create(&producer, NULL, ring_producer, &run) == 0);
+    stress_event_t events[256];
+    size_t popped = 0;
+    bool chained = true;
+    for (;;) {
+        bool done = __atomic_load_n(&run.done, __ATOMIC_ACQUIRE);
+        size_t count = stress_event_ring_pop(run.ring, events, 256);
+        for (size_t e = 0; e < count; e++) {
+            assert(events[e].kind == STRESS_EVENT_TRANSITION && events[e].channel < RING_CHANNELS);
+            // Until something is dropped, each channel's events chain
+            chained = chained && events[e].from == last[events[e].channel];
+            last[events[e].channel] = events[e].to;
+        }
+        popped += count;
+        if (done && count == 0) break;
+        if (count == 0) sched_yield();
+    }
+    pthread_join(producer, NULL);
+
+    // Default criteria never exceed the counter, so nothing evolves
+    uint64_t dropped = stress_event_ring_dropped(run.ring);
+    assert(popped + dropped == run.transitions && run.transitions > 0);
+    assert(chained || dropped > 0);
+    for (int i = 0; i < RING_CHANNELS && dropped == 0; i++) {
+        assert(last[i] == run.systems[i]->current_state);
+    }
+
+    for (int i = 0; i < RING_CHANNELS; i++) stress_system_destroy(run.systems[i]);
+    stress_event_ring_destroy(run.ring);
+    printf("Event ring across threads test passed\n");
+}
+
+int main(void) {
+    test_batch_matches_scalar();
+    test_event_ring();
+    test_ring_threads();
+    printf("All trigger batch tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Void processor microbenchmarks on the shared harness
+// (bench/include/obibench.h at the top of the tree). Covers this tree's
+// copy of the noise generators; the trigger and adaptation paths print on
+// every call here, so they are left to stress_filter_flash's bench.
+
+#include "stress_filter_flash.h"
+#include "obibench.h"
+#include <stdio.h>
+
+static void bench_prng_noise(void* arg, uint64_t count) {
+    stress_system_t* sys = arg;
+    double sum = 0.0;
+    for (uint64_t i = 0; i < count; i++) {
+        sum += generate_prng_noise(sys->noise_context);
+    }
+    obibench_do_not_optimize(&sum);
+}
+
+static void bench_entropy_noise(void* arg, uint64_t count) {
+    stress_system_t* sys = arg;
+    double sum = 0.0;
+    for (uint64_t i = 0; i < count; i++) {
+        sum += generate_entropy_noise(sys->noise_context);
+    }
+    obibench_do_not_optimize(&sum);
+}
+
+static void bench_feedback_noise(void* arg, uint64_t count) {
+    stress_system_t* sys = arg;
+    double value = 0.5;
+    for (uint64_t i = 0; i < count; i++) {
+        value = generate_feedback_noise(sys->noise_context, value);
+    }
+    obibench_do_not_optimize(&value);
+}
+
+int main(int argc, char** argv) {
+    stress_system_t* sys = stress_system_create();
+    if (!sys) {
+        fprintf(stderr, "Failed to create stress system\n");
+        return 1;
+    }
+
+    obibench_suite_t* suite = obibench_init("obiai-void", argc, argv);
+    obibench_run(suite, "prng_noise", bench_prng_noise, sys);
+    obibench_run(suite, "entropy_noise", bench_entropy_noise, sys);
+    obibench_run(suite, "feedback_noise", bench_feedback_noise, sys);
+    int status = obibench_finish(suite);
+
+    stress_system_destroy(sys);
+    return status;
+}
@@ -18,6 +18,10 @@ typedef enum {
     VOID_SIGNAL_EXTRACT   // Extract signal before voiding noise
 } void_strategy_t;
 
+// Bytes bound for the void device are staged in a ring of this size and
+// written out with writev when it fills, on flush and on destroy
+#define VOID_BUFFER_SIZE 4096
+
 typedef struct {
     void_strategy_t strategy;
     double void_threshold;
@@ -28,6 +32,19 @@ typedef struct {
     double entropy_reduction;     // Chaos management metrics
     bool trauma_processing_active;
     uint32_t signal_extraction_count;
+    int void_fd;                  // Open for the life of the void; -1 if open failed
+    size_t buffer_head;           // Oldest staged byte
+    size_t buffer_len;            // Staged bytes not yet written
+    char buffer[VOID_BUFFER_SIZE];
+    
+    // Online statistics over every byte written, kept current by
+    // consciousness_void_write so readers never rescan data
+    uint64_t byte_histogram[256];
+    uint64_t histogram_total;
+    double histogram_clog;        // Sum of c * log2(c) over the histogram bins
+    uint64_t signal_samples;      // Writes seen by the signal statistics
+    double signal_mean;           // Mean byte strength (byte / 255) per write
+    double signal_m2;             // Squared deviations of the per-write strengths
 } consciousness_void_t;
 
 typedef struct {
@@ -56,6 +73,7 @@ void consciousness_void_destroy(consciousness_void_t* cvoid);
 
 // Void processing functions - the heart of the architecture
 int consciousness_void_write(consciousness_void_t* cvoid, const void* data, size_t size);
+int consciousness_void_flush(consciousness_void_t* cvoid);   // Write out staged bytes
 void_processing_result_t* consciousness_void_process_stress(
     consciousness_void_t* cvoid, 
     double magnitude, 
@@ -75,7 +93,14 @@ stress_packet_t* stress_process_trigger_with_void(
 
 // Consciousness void redirection and strategy management
 void consciousness_void_redirect_stress(stress_system_t* sys, void_strategy_t strategy);
+
+// Shannon entropy, in bits per byte, of everything written so far; O(1)
 double consciousness_void_entropy(consciousness_void_t* cvoid);
+
+// Fold the byte distribution of everything written into pattern[0..len) as
+// probabilities summing to 1. Returns true when the stream carries signal,
+// i.e. its entropy is below VOID_SIGNAL_ENTROPY_BITS.
+#define VOID_SIGNAL_ENTROPY_BITS 7.0
 bool consciousness_void_extract_signal(consciousness_void_t* cvoid, double* pattern, size_t len);
 
 // Advanced void processing: the /dev/null consciousness model
@@ -100,9 +125,41 @@ typedef struct {
     double preservation_efficiency;
     double entropy_reduction_rate;
     uint32_t immune_activations;
+    double byte_entropy;          // Bits per byte over everything written
+    double signal_strength_mean;  // Per-write mean byte strength
+    double signal_strength_variance;
 } consciousness_void_metrics_t;
 
+// Every field comes from running totals, so this is O(1)
+
 consciousness_void_metrics_t consciousness_void_get_metrics(consciousness_void_t* cvoid);
 void consciousness_void_print_status(consciousness_void_t* cvoid);
 
+// Sharded processing pipeline for multi-tenant ingestion. Each worker
+// thread owns an enhanced_stress_system_t, and with it a void, and takes
+// jobs from a shared lock-free bounded queue, so shards never share state
+// while processing. Metrics are merged across shards when read.
+typedef struct void_pipeline void_pipeline_t;
+
+#define VOID_JOB_CONTEXT_SIZE 64
+
+typedef struct {
+    double magnitude;
+    char context[VOID_JOB_CONTEXT_SIZE];   // Truncated copy of the caller's context
+} void_stress_job_t;
+
+// queue_capacity is rounded up to a power of two
+void_pipeline_t* void_pipeline_create(size_t workers, size_t queue_capacity);
+// Processes every job already submitted, then stops the workers
+void void_pipeline_destroy(void_pipeline_t* pipeline);
+
+// Any thread may submit; returns false, without blocking, when the queue is full
+bool void_pipeline_submit(void_pipeline_t* pipeline, double magnitude, const char* context);
+// Wait until every job submitted so far has been processed
+void void_pipeline_drain(void_pipeline_t* pipeline);
+
+size_t void_pipeline_workers(const void_pipeline_t* pipeline);
+uint64_t void_pipeline_processed(const void_pipeline_t* pipeline);
+consciousness_void_metrics_t void_pipeline_get_metrics(void_pipeline_t* pipeline);
+
 #endif // CONSCIOUSNESS_VOID_H
@@ -7,6 +7,11 @@
 #include <math.h>
 #include <time.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
 #include <uuid/uuid.h>
 
 // OBINexus Consciousness Void Architecture Implementation
@@ -34,6 +39,12 @@ consciousness_void_t* consciousness_void_create(const char* void_device) {
     // Initialize pattern cache for wisdom preservation
     memset(cvoid->pattern_cache, 0, sizeof(cvoid->pattern_cache));
     
+    // One descriptor for every write this void will make
+    cvoid->void_fd = open(cvoid->void_device, O_WRONLY | O_CLOEXEC);
+    if (cvoid->void_fd < 0) {
+        printf("CONSCIOUSNESS_VOID: Cannot open %s, writes will be dropped\n", cvoid->void_device);
+    }
+    
     printf("CONSCIOUSNESS_VOID: Initialized with device: %s\n", cvoid->void_device);
     printf("CONSCIOUSNESS_VOID: Strategy: VOID_ENCODE (preserve wisdom)\n");
     
@@ -44,24 +55,169 @@ void consciousness_void_destroy(consciousness_void_t* cvoid) {
     if (cvoid) {
         printf("CONSCIOUSNESS_VOID: Destroyed. Voided: %lu bytes, Preserved: %lu patterns\n",
                cvoid->voided_bytes, cvoid->preserved_patterns);
+        if (cvoid->void_fd >= 0) {
+            consciousness_void_flush(cvoid);
+            close(cvoid->void_fd);
+        }
         free(cvoid);
     }
 }
 
+// Write the staged bytes, then extra, with as few writev calls as the
+// device allows. Staged bytes are dropped if the device fails.
+static int void_drain(consciousness_void_t* cvoid, const void* extra, size_t extra_len) {
+    const char* pending = extra;
+    while (cvoid->buffer_len > 0 || extra_len > 0) {
+        struct iovec iov[3];
+        int count = 0;
+        size_t first = VOID_BUFFER_SIZE - cvoid->buffer_head;
+        if (first > cvoid->buffer_len) first = cvoid->buffer_len;
+        if (first > 0) {
+            iov[count].iov_base = cvoid->buffer + cvoid->buffer_head;
+            iov[count++].iov_len = first;
+        }
+        if (cvoid->buffer_len > first) {
+            iov[count].iov_base = cvoid->buffer;
+            iov[count++].iov_len = cvoid->buffer_len - first;
+        }
+        if (extra_len > 0) {
+            iov[count].iov_base = (void*)pending;
+            iov[count++].iov_len = extra_len;
+        }
+        
+        ssize_t written = writev(cvoid->void_fd, iov, count);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            cvoid->buffer_head = 0;
+            cvoid->buffer_len = 0;
+            return -1;
+        }
+        
+        size_t done = (size_t)written;
+        size_t staged = done < cvoid->buffer_len ? done : cvoid->buffer_len;
+        cvoid->buffer_head = (cvoid->buffer_head + staged) % VOID_BUFFER_SIZE;
+        cvoid->buffer_len -= staged;
+        if (done > staged) {
+            pending += done - staged;
+            extra_len -= done - staged;
+        }
+    }
+    cvoid->buffer_head = 0;
+    return 0;
+}
+
+// Stage data for the void device; a write that would overflow the ring
+// goes out together with what is already staged in one writev
+static int void_stage(consciousness_void_t* cvoid, const void* data, size_t size) {
+    if (cvoid->void_fd < 0) return -1;
+    if (cvoid->buffer_len + size > VOID_BUFFER_SIZE) {
+        return void_drain(cvoid, data, size);
+    }
+    
+    size_t tail = (cvoid->buffer_head + cvoid->buffer_len) % VOID_BUFFER_SIZE;
+    size_t first = VOID_BUFFER_SIZE - tail;
+    if (first > size) first = size;
+    memcpy(cvoid->buffer + tail, data, first);
+    memcpy(cvoid->buffer, (const char*)data + first, size - first);
+    cvoid->buffer_len += size;
+    return 0;
+}
+
+int consciousness_void_flush(consciousness_void_t* cvoid) {
+    if (!cvoid || cvoid->void_fd < 0) return -1;
+    return void_drain(cvoid, NULL, 0);
+}
+
+// Online statistics. Alongside the byte histogram we keep S = sum c log2 c,
+// so entropy is log2(N) - S / N without visiting the bins. Each write
+// moves S by the change in its touched bins only; S is recomputed exactly
+// every VOID_STATS_REBASE writes so rounding cannot build up.
+#define VOID_STATS_REBASE 65536
+#define VOID_COUNT_CHUNK ((size_t)1 << 30)
+
+static double c_log2_c(uint64_t c) {
+    return c ? (double)c * log2((double)c) : 0.0;
+}
+
+static void void_observe(consciousness_void_t* cvoid, const unsigned char* bytes, size_t size) {
+    uint64_t byte_sum = 0;
+    for (size_t start = 0; start < size; start += VOID_COUNT_CHUNK) {
+        size_t n = size - start < VOID_COUNT_CHUNK ? size - start : VOID_COUNT_CHUNK;
+        const unsigned char* p = bytes + start;
+        
+        // Four interleaved tables, so runs of one value do not serialise on
+        // a single counter and the loop keeps four increments in flight
+        uint32_t counts[4][256];
+        memset(counts, 0, sizeof(counts));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            counts[0][p[i]]++;
+            counts[1][p[i + 1]]++;
+            counts[2][p[i + 2]]++;
+            counts[3][p[i + 3]]++;
+        }
+        for (; i < n; i++) counts[0][p[i]]++;
+        
+        for (int value = 0; value < 256; value++) {
+            uint64_t added = (uint64_t)counts[0][value] + counts[1][value] +
+                             counts[2][value] + counts[3][value];
+            if (added == 0) continue;
+            uint64_t old = cvoid->byte_histogram[value];
+            cvoid->histogram_clog += c_log2_c(old + added) - c_log2_c(old);
+            cvoid->byte_histogram[value] = old + added;
+            byte_sum += added * (uint64_t)value;
+        }
+    }
+    cvoid->histogram_total += size;
+    
+    // Welford over per-write strengths
+    double strength = (double)byte_sum / 255.0 / (double)size;
+    cvoid->signal_samples++;
+    double delta = strength - cvoid->signal_mean;
+    cvoid->signal_mean += delta / (double)cvoid->signal_samples;
+    cvoid->signal_m2 += delta * (strength - cvoid->signal_mean);
+    
+    if (cvoid->signal_samples % VOID_STATS_REBASE == 0) {
+        double clog = 0.0;
+        for (int value = 0; value < 256; value++) {
+            clog += c_log2_c(cvoid->byte_histogram[value]);
+        }
+        cvoid->histogram_clog = clog;
+    }
+}
+
+double consciousness_void_entropy(consciousness_void_t* cvoid) {
+    if (!cvoid || cvoid->histogram_total == 0) return 0.0;
+    double total = (double)cvoid->histogram_total;
+    double entropy = log2(total) - cvoid->histogram_clog / total;
+    return entropy > 0.0 ? entropy : 0.0;
+}
+
+bool consciousness_void_extract_signal(consciousness_void_t* cvoid, double* pattern, size_t len) {
+    if (!cvoid || !pattern || len == 0) return false;
+    memset(pattern, 0, len * sizeof(double));
+    if (cvoid->histogram_total == 0) return false;
+    
+    double total = (double)cvoid->histogram_total;
+    for (int value = 0; value < 256; value++) {
+        pattern[(size_t)value * len / 256] += (double)cvoid->byte_histogram[value] / total;
+    }
+    return consciousness_void_entropy(cvoid) < VOID_SIGNAL_ENTROPY_BITS;
+}
+
 // Core consciousness void processing - the revolutionary /dev/null model
 int consciousness_void_write(consciousness_void_t* cvoid, const void* data, size_t size) {
     if (!cvoid || !data || size == 0) return -1;
     
+    void_observe(cvoid, data, size);
+    
     switch (cvoid->strategy) {
         case VOID_DISCARD: {
             // Direct /dev/null write - complete discard (pure /dev/null behavior)
-            int fd = open(cvoid->void_device, O_WRONLY);
-            if (fd >= 0) {
-                ssize_t written = write(fd, data, size);
-                close(fd);
-                cvoid->voided_bytes += written;
+            if (void_stage(cvoid, data, size) == 0) {
+                cvoid->voided_bytes += size;
                 printf("VOID_DISCARD: %zu bytes → /dev/null (complete void)\n", size);
-                return written;
+                return size;
             }
             break;
         }
@@ -70,10 +226,10 @@ int consciousness_void_write(consciousness_void_t* cvoid, const void* data, size
             // Revolutionary: Encode before voiding (consciousness preservation)
             printf("VOID_ENCODE: Processing %zu bytes for wisdom extraction\n", size);
             
-            // Extract patterns before voiding
+            // Extract patterns before voiding, up to the first NUL
             const char* str_data = (const char*)data;
             double signal_strength = 0.0;
-            for (size_t i = 0; i < size && i < strlen(str_data); i++) {
+            for (size_t i = 0; i < size && str_data[i] != '\0'; i++) {
                 signal_strength += (double)(str_data[i] & 0xFF) / 255.0;
             }
             signal_strength /= size;
@@ -87,11 +243,7 @@ int consciousness_void_write(consciousness_void_t* cvoid, const void* data, size
             }
             
             // Void the raw trauma while keeping encoded version
-            int fd = open(cvoid->void_device, O_WRONLY);
-            if (fd >= 0) {
-                write(fd, data, size);  // Raw data goes to void
-                close(fd);
-            }
+            void_stage(cvoid, data, size);  // Raw data goes to void
             
             cvoid->voided_bytes += size;
             printf("VOID_ENCODE: Raw trauma voided, wisdom encoded\n");
@@ -141,7 +293,7 @@ void_processing_result_t* consciousness_void_process_stress(
 ) {
     if (!cvoid) return NULL;
     
-    static void_processing_result_t result;
+    static __thread void_processing_result_t result;   // One per pipeline worker
     memset(&result, 0, sizeof(result));
     
     result.raw_magnitude = magnitude;
@@ -298,6 +450,12 @@ consciousness_void_metrics_t consciousness_void_get_metrics(consciousness_void_t
         }
         
         metrics.trauma_voided = metrics.total_processed - metrics.wisdom_preserved;
+        
+        metrics.byte_entropy = consciousness_void_entropy(cvoid);
+        metrics.signal_strength_mean = cvoid->signal_mean;
+        if (cvoid->signal_samples > 0) {
+            metrics.signal_strength_variance = cvoid->signal_m2 / (double)cvoid->signal_samples;
+        }
     }
     
     return metrics;
@@ -317,6 +475,275 @@ void consciousness_void_print_status(consciousness_void_t* cvoid) {
     printf("Signals Extracted: %u\n", metrics.signals_extracted);
     printf("Preservation Efficiency: %.3f%%\n", metrics.preservation_efficiency * 100);
     printf("Entropy Reduction Rate: %.3f\n", metrics.entropy_reduction_rate);
+    printf("Byte Entropy: %.3f bits\n", metrics.byte_entropy);
+    printf("Signal Strength: %.3f (variance %.4f)\n",
+           metrics.signal_strength_mean, metrics.signal_strength_variance);
     printf("Trauma Processing: %s\n", cvoid->trauma_processing_active ? "ACTIVE" : "INACTIVE");
     printf("=========================================\n\n");
 }
+
+// Sharded pipeline. The queue is Vyukov's bounded MPMC array: each cell's
+// sequence says whether it is free for the producer at that position or
+// published for the consumer, so producers and consumers only contend on
+// their own position counter. A semaphore counts published jobs, letting
+// idle workers sleep instead of spinning.
+#define VOID_CACHE_LINE 64
+
+typedef struct {
+    size_t sequence;
+    void_stress_job_t job;
+} void_queue_cell_t;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;           // Held by the worker while it processes a job
+    enhanced_stress_system_t* system;
+    uint64_t processed;
+    void_pipeline_t* pipeline;
+} __attribute__((aligned(VOID_CACHE_LINE))) void_pipeline_shard_t;
+
+struct void_pipeline {
+    void_queue_cell_t* cells;
+    size_t mask;
+    size_t enqueue_pos __attribute__((aligned(VOID_CACHE_LINE)));
+    size_t dequeue_pos __attribute__((aligned(VOID_CACHE_LINE)));
+    uint64_t submitted __attribute__((aligned(VOID_CACHE_LINE)));
+    sem_t ready;
+    bool stopping;
+    size_t worker_count;
+    void_pipeline_shard_t* shards;
+};
+
+static bool void_queue_push(void_pipeline_t* p, const void_stress_job_t* job) {
+    size_t pos = __atomic_load_n(&p->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        void_queue_cell_t* cell = &p->cells[pos & p->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&p->enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->job = *job;
+                __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;           // Full
+        } else {
+            pos = __atomic_load_n(&p->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static bool void_queue_pop(void_pipeline_t* p, void_stress_job_t* job) {
+    size_t pos = __atomic_load_n(&p->dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        void_queue_cell_t* cell = &p->cells[pos & p->mask];
+        size_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&p->dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *job = cell->job;
+                __atomic_store_n(&cell->sequence, pos + p->mask + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;           // Empty, or the producer has not published yet
+        } else {
+            pos = __atomic_load_n(&p->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void* void_pipeline_worker(void* arg) {
+    void_pipeline_shard_t* shard = arg;
+    void_pipeline_t* p = shard->pipeline;
+    
+    for (;;) {
+        while (sem_wait(&p->ready) != 0 && errno == EINTR) {}
+        
+        // Every post matches a published job, except the stop posts; the
+        // job this wake-up stands for may still be mid-publish
+        void_stress_job_t job;
+        bool have_job = false;
+        while (!(have_job = void_queue_pop(p, &job))) {
+            if (__atomic_load_n(&p->stopping, __ATOMIC_ACQUIRE) &&
+                __atomic_load_n(&p->dequeue_pos, __ATOMIC_ACQUIRE) ==
+                __atomic_load_n(&p->enqueue_pos, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            sched_yield();
+        }
+        if (!have_job) return NULL;
+        
+        pthread_mutex_lock(&shard->lock);
+        stress_process_trigger_with_void(shard->system, job.magnitude, job.context);
+        __atomic_store_n(&shard->processed, shard->processed + 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+static void void_pipeline_free(void_pipeline_t* p) {
+    for (size_t i = 0; i < p->worker_count; i++) {
+        enhanced_stress_system_destroy(p->shards[i].system);
+        pthread_mutex_destroy(&p->shards[i].lock);
+    }
+    sem_destroy(&p->ready);
+    free(p->shards);
+    free(p->cells);
+    free(p);
+}
+
+void_pipeline_t* void_pipeline_create(size_t workers, size_t queue_capacity) {
+    if (workers == 0 || queue_capacity == 0 || queue_capacity > ((size_t)1 << 30)) return NULL;
+    size_t capacity = 1;
+    while (capacity < queue_capacity) capacity <<= 1;
+    
+    void_pipeline_t* p = calloc(1, sizeof(void_pipeline_t));
+    if (!p) return NULL;
+    p->cells = malloc(capacity * sizeof(void_queue_cell_t));
+    p->shards = calloc(workers, sizeof(void_pipeline_shard_t));
+    if (!p->cells || !p->shards || sem_init(&p->ready, 0, 0) != 0) {
+        free(p->shards);
+        free(p->cells);
+        free(p);
+        return NULL;
+    }
+    p->mask = capacity - 1;
+    for (size_t i = 0; i < capacity; i++) {
+        p->cells[i].sequence = i;
+    }
+    
+    // Build every shard before starting any thread, so a failure needs no joins
+    for (; p->worker_count < workers; p->worker_count++) {
+        void_pipeline_shard_t* shard = &p->shards[p->worker_count];
+        shard->pipeline = p;
+        shard->system = enhanced_stress_system_create();
+        if (!shard->system) {
+            void_pipeline_free(p);
+            return NULL;
+        }
+        pthread_mutex_init(&shard->lock, NULL);
+    }
+    
+    for (size_t i = 0; i < workers; i++) {
+        if (pthread_create(&p->shards[i].thread, NULL, void_pipeline_worker, &p->shards[i]) != 0) {
+            // Stop the workers already running, then discard everything
+            __atomic_store_n(&p->stopping, true, __ATOMIC_RELEASE);
+            for (size_t j = 0; j < i; j++) sem_post(&p->ready);
+            for (size_t j = 0; j < i; j++) pthread_join(p->shards[j].thread, NULL);
+            void_pipeline_free(p);
+            return NULL;
+        }
+    }
+    
+    printf("VOID_PIPELINE: %zu shards, queue capacity %zu\n", workers, capacity);
+    return p;
+}
+
+void void_pipeline_destroy(void_pipeline_t* pipeline) {
+    if (!pipeline) return;
+    void_pipeline_drain(pipeline);
+    __atomic_store_n(&pipeline->stopping, true, __ATOMIC_RELEASE);
+    for (size_t i = 0; i < pipeline->worker_count; i++) {
+        sem_post(&pipeline->ready);
+    }
+    for (size_t i = 0; i < pipeline->worker_count; i++) {
+        pthread_join(pipeline->shards[i].thread, NULL);
+    }
+    void_pipeline_free(pipeline);
+}
+
+bool void_pipeline_submit(void_pipeline_t* pipeline, double magnitude, const char* context) {
+    if (!pipeline || __atomic_load_n(&pipeline->stopping, __ATOMIC_ACQUIRE)) return false;
+    
+    void_stress_job_t job;
+    job.magnitude = magnitude;
+    strncpy(job.context, context ? context : "unknown", sizeof(job.context) - 1);
+    job.context[sizeof(job.context) - 1] = '\0';
+    
+    if (!void_queue_push(pipeline, &job)) return false;
+    __atomic_fetch_add(&pipeline->submitted, 1, __ATOMIC_RELEASE);
+    sem_post(&pipeline->ready);
+    return true;
+}
+
+uint64_t void_pipeline_processed(const void_pipeline_t* pipeline) {
+    if (!pipeline) return 0;
+    uint64_t processed = 0;
+    for (size_t i = 0; i < pipeline->worker_count; i++) {
+        processed += __atomic_load_n(&pipeline->shards[i].processed, __ATOMIC_ACQUIRE);
+    }
+    return processed;
+}
+
+void void_pipeline_drain(void_pipeline_t* pipeline) {
+    if (!pipeline) return;
+    uint64_t target = __atomic_load_n(&pipeline->submitted, __ATOMIC_ACQUIRE);
+    while (void_pipeline_processed(pipeline) < target) {
+        struct timespec pause = { 0, 100000 };  // 100us
+        nanosleep(&pause, NULL);
+    }
+}
+
+size_t void_pipeline_workers(const void_pipeline_t* pipeline) {
+    return pipeline ? pipeline->worker_count : 0;
+}
+
+// Counters add up; entropy comes from the summed histograms and signal
+// statistics from Chan's merge of the shards' Welford sums
+consciousness_void_metrics_t void_pipeline_get_metrics(void_pipeline_t* pipeline) {
+    consciousness_void_metrics_t metrics = {0};
+    if (!pipeline) return metrics;
+    
+    uint64_t histogram[256] = {0};
+    uint64_t histogram_total = 0;
+    uint64_t samples = 0;
+    double mean = 0.0, m2 = 0.0;
+    
+    for (size_t i = 0; i < pipeline->worker_count; i++) {
+        void_pipeline_shard_t* shard = &pipeline->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        consciousness_void_t* cvoid = shard->system->void_processor;
+        consciousness_void_metrics_t part = consciousness_void_get_metrics(cvoid);
+        metrics.total_processed += part.total_processed;
+        metrics.wisdom_preserved += part.wisdom_preserved;
+        metrics.signals_extracted += part.signals_extracted;
+        metrics.immune_activations += part.immune_activations;
+        metrics.entropy_reduction_rate += part.entropy_reduction_rate / (double)pipeline->worker_count;
+        
+        for (int value = 0; value < 256; value++) {
+            histogram[value] += cvoid->byte_histogram[value];
+        }
+        histogram_total += cvoid->histogram_total;
+        
+        if (cvoid->signal_samples > 0) {
+            uint64_t merged = samples + cvoid->signal_samples;
+            double delta = cvoid->signal_mean - mean;
+            mean += delta * (double)cvoid->signal_samples / (double)merged;
+            m2 += cvoid->signal_m2 +
+                  delta * delta * (double)samples * (double)cvoid->signal_samples / (double)merged;
+            samples = merged;
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    
+    if (metrics.total_processed > 0) {
+        metrics.preservation_efficiency =
+            (double)metrics.wisdom_preserved / (double)metrics.total_processed;
+    }
+    metrics.trauma_voided = metrics.total_processed - metrics.wisdom_preserved;
+    
+    if (histogram_total > 0) {
+        double total = (double)histogram_total;
+        for (int value = 0; value < 256; value++) {
+            if (histogram[value] == 0) continue;
+            double p = (double)histogram[value] / total;
+            metrics.byte_entropy -= p * log2(p);
+        }
+    }
+    metrics.signal_strength_mean = mean;
+    metrics.signal_strength_variance = samples > 0 ? m2 / (double)samples : 0.0;
+    return metrics;
+}
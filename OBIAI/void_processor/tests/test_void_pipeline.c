@@ -0,0 +1,168 @@
+// tests/test_void_pipeline.c
+// Checks for the sharded void pipeline: every job submitted is processed
+// once, merged metrics do not depend on the number of shards, and a full
+// queue refuses work without blocking
+
+#include "consciousness_void.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define PIPELINE_PRODUCERS 4
+#define PIPELINE_JOBS 500           // Per producer
+
+static int quiet_begin(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved >= 0 && null >= 0);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void quiet_end(int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+typedef struct {
+    void_pipeline_t* pipeline;
+    int producer;
+} producer_arg_t;
+
+// Submits a fixed set of jobs, retrying whenever the queue is full
+static void* produce(void* arg) {
+    producer_arg_t* producer = arg;
+    for (int i = 0; i < PIPELINE_JOBS; i++) {
+        char context[96];
+        snprintf(context, sizeof(context), "tenant-%d-job-%d-with-a-context-longer-than-one-queue-cell",
+                 producer->producer, i);
+        double magnitude = (double)((i * 7 + producer->producer) % 100) / 100.0;
+        while (!void_pipeline_submit(producer->pipeline, magnitude, context)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static consciousness_void_metrics_t run_pipeline(size_t workers) {
+    void_pipeline_t* pipeline = void_pipeline_create(workers, 64);
+    assert(pipeline != NULL && void_pipeline_workers(pipeline) == workers);
+
+    pthread_t threads[PIPELINE_PRODUCERS];
+    producer_arg_t args[PIPELINE_PRODUCERS];
+    for (int p = 0; p < PIPELINE_PRODUCERS; p++) {
+        args[p].pipeline = pipeline;
+        args[p].producer = p;
+        assert(pthread_create(&threads[p], NULL, produce, &args[p]) == 0);
+    }
+    for (int p = 0; p < PIPELINE_PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+    void_pipeline_drain(pipeline);
+    assert(void_pipeline_processed(pipeline) == PIPELINE_PRODUCERS * PIPELINE_JOBS);
+
+    consciousness_void_metrics_t metrics = void_pipeline_get_metrics(pipeline);
+    void_pipeline_destroy(pipeline);
+    return metrics;
+}
+
+static void test_pipeline_shards(void) {
+    printf("Testing pipeline shards...\n");
+
+    int saved = quiet_begin();
+    assert(void_pipeline_create(0, 64) == NULL);
+    assert(void_pipeline_create(2, 0) == NULL);
+    assert(!void_pipeline_submit(NULL, 0.5, "none"));
+    assert(void_pipeline_processed(NULL) == 0 && void_pipeline_workers(NULL) == 0);
+    void_pipeline_drain(NULL);
+    void_pipeline_destroy(NULL);
+
+    // The same jobs through any number of shards merge to the same totals
+    consciousness_void_metrics_t single = run_pipeline(1);
+    assert(single.total_processed > 0);
+    assert(single.byte_entropy > 0.0 && single.signal_strength_mean > 0.0);
+    for (size_t workers = 2; workers <= 8; workers *= 2) {
+        consciousness_void_metrics_t sharded = run_pipeline(workers);
+        assert(sharded.total_processed == single.total_processed);
+        assert(sharded.wisdom_preserved == single.wisdom_preserved);
+        assert(sharded.trauma_voided == single.trauma_voided);
+        assert(fabs(sharded.byte_entropy - single.byte_entropy) < 1e-12);
+        assert(fabs(sharded.signal_strength_mean - single.signal_strength_mean) < 1e-12);
+        assert(fabs(sharded.signal_strength_variance - single.signal_strength_variance) < 1e-12);
+    }
+    quiet_end(saved);
+
+    printf("Pipeline shards test passed\n");
+}
+
+static void test_pipeline_backpressure(void) {
+    printf("Testing pipeline backpressure...\n");
+
+    int saved = quiet_begin();
+    void_pipeline_t* pipeline = void_pipeline_create(2, 3);    // Rounds up to 4
+    assert(pipeline != NULL);
+
+    // Workers report on stdout, so holding its lock stalls each one on the
+    // first job it takes; the queue then fills and submit says so
+    flockfile(stdout);
+    int accepted = 0;
+    while (accepted < 100 && void_pipeline_submit(pipeline, 0.9, "held")) {
+        accepted++;
+    }
+    assert(accepted >= 4 && accepted <= 4 + 2);
+    funlockfile(stdout);
+
+    void_pipeline_drain(pipeline);
+    assert(void_pipeline_processed(pipeline) == (uint64_t)accepted);
+    assert(void_pipeline_submit(pipeline, 0.9, "after"));
+    void_pipeline_destroy(pipeline);
+    quiet_end(saved);
+
+    printf("Pipeline backpressure test passed\n");
+}
+
+static void* process_once(void* arg) {
+    return consciousness_void_process_stress(arg, 0.9, "thread");
+}
+
+static void test_result_per_thread(void) {
+    printf("Testing result per thread...\n");
+
+    // Each thread gets its own result rather than a shared static
+    int saved = quiet_begin();
+    consciousness_void_t* first = consciousness_void_create(NULL);
+    consciousness_void_t* second = consciousness_void_create(NULL);
+    assert(first != NULL && second != NULL);
+    pthread_t threads[2];
+    void* results[2];
+    assert(pthread_create(&threads[0], NULL, process_once, first) == 0);
+    assert(pthread_create(&threads[1], NULL, process_once, second) == 0);
+    pthread_join(threads[0], &results[0]);
+    pthread_join(threads[1], &results[1]);
+    void_processing_result_t* mine = consciousness_void_process_stress(first, 0.5, "main");
+    assert(results[0] != NULL && results[1] != NULL && mine != NULL);
+    assert(mine != results[0] && mine != results[1]);
+    assert(mine->applied_strategy == VOID_BACKGROUND);
+    consciousness_void_destroy(first);
+    consciousness_void_destroy(second);
+    quiet_end(saved);
+
+    printf("Result per thread test passed\n");
+}
+
+int main(void) {
+    test_pipeline_shards();
+    test_pipeline_backpressure();
+    test_result_per_thread();
+    printf("All void pipeline tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+// tests/test_void_stats.c
+// Checks for the online byte entropy and signal statistics: they match a
+// full recount after any number of writes, whatever the strategy
+
+#include "consciousness_void.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define STATS_WRITES 70000          // Past one exact recount of the running sum
+
+static int quiet_begin(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved >= 0 && null >= 0);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void quiet_end(int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static double reference_entropy(const uint64_t histogram[256]) {
+    uint64_t total = 0;
+    for (int value = 0; value < 256; value++) total += histogram[value];
+    double entropy = 0.0;
+    for (int value = 0; value < 256; value++) {
+        if (histogram[value] == 0) continue;
+        double p = (double)histogram[value] / (double)total;
+        entropy -= p * log2(p);
+    }
+    return entropy;
+}
+
+static void test_entropy_values(void) {
+    printf("Testing entropy values...\n");
+
+    int saved = quiet_begin();
+    consciousness_void_t* cvoid = consciousness_void_create(NULL);
+    assert(cvoid != NULL);
+    double pattern[16];
+
+    // Nothing written: no entropy and no signal
+    assert(consciousness_void_entropy(cvoid) == 0.0);
+    assert(!consciousness_void_extract_signal(cvoid, pattern, 16));
+    assert(consciousness_void_entropy(NULL) == 0.0);
+    assert(!consciousness_void_extract_signal(cvoid, NULL, 16));
+    assert(!consciousness_void_extract_signal(cvoid, pattern, 0));
+
+    // One value, then two equally often
+    assert(consciousness_void_write(cvoid, "aaaa", 4) == 4);
+    assert(consciousness_void_entropy(cvoid) == 0.0);
+    assert(consciousness_void_extract_signal(cvoid, pattern, 16));
+    assert(pattern['a' * 16 / 256] == 1.0);
+    cvoid->strategy = VOID_IMMUNE;
+    assert(consciousness_void_write(cvoid, "bbbb", 4) == 4);
+    assert(fabs(consciousness_void_entropy(cvoid) - 1.0) < 1e-12);
+    consciousness_void_destroy(cvoid);
+
+    // Every byte value once is the 8-bit maximum, which carries no signal,
+    // and folds evenly into the caller's bins
+    cvoid = consciousness_void_create(NULL);
+    assert(cvoid != NULL);
+    cvoid->strategy = VOID_BACKGROUND;
+    unsigned char all[256];
+    for (int value = 0; value < 256; value++) all[value] = (unsigned char)value;
+    assert(consciousness_void_write(cvoid, all, sizeof(all)) == (int)sizeof(all));
+    assert(fabs(consciousness_void_entropy(cvoid) - 8.0) < 1e-12);
+    assert(!consciousness_void_extract_signal(cvoid, pattern, 16));
+    double sum = 0.0;
+    for (int bin = 0; bin < 16; bin++) {
+        assert(fabs(pattern[bin] - 1.0 / 16) < 1e-12);
+        sum += pattern[bin];
+    }
+    assert(fabs(sum - 1.0) < 1e-12);
+
+    // Strength is the mean byte over 255, once per write
+    consciousness_void_metrics_t metrics = consciousness_void_get_metrics(cvoid);
+    assert(fabs(metrics.byte_entropy - 8.0) < 1e-12);
+    assert(fabs(metrics.signal_strength_mean - 0.5) < 1e-12);
+    assert(metrics.signal_strength_variance == 0.0);
+    consciousness_void_destroy(cvoid);
+    quiet_end(saved);
+
+    printf("Entropy values test passed\n");
+}
+
+static void test_running_statistics(void) {
+    printf("Testing running statistics...\n");
+
+    int saved = quiet_begin();
+    consciousness_void_t* cvoid = consciousness_void_create(NULL);
+    assert(cvoid != NULL);
+
+    // Skewed bytes over every strategy, checked against a full recount
+    uint64_t histogram[256] = { 0 };
+    uint64_t writes = 0;
+    double mean = 0.0, m2 = 0.0;
+    uint64_t seed = 11;
+    unsigned char data[64];
+    for (int w = 0; w < STATS_WRITES; w++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t size = (size_t)(seed >> 58) + 1;
+        uint64_t byte_sum = 0;
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned bits = (unsigned)(seed >> 56);
+            data[i] = (unsigned char)(bits < 200 ? bits % 8 : bits);
+            histogram[data[i]]++;
+            byte_sum += data[i];
+        }
+        cvoid->strategy = (void_strategy_t)(w % 6);
+        assert(consciousness_void_write(cvoid, data, size) == (int)size);
+
+        double strength = (double)byte_sum / 255.0 / (double)size;
+        writes++;
+        double delta = strength - mean;
+        mean += delta / (double)writes;
+        m2 += delta * (strength - mean);
+
+        if (w % 5000 == 0 || w == STATS_WRITES - 1) {
+            assert(fabs(consciousness_void_entropy(cvoid) - reference_entropy(histogram)) < 1e-9);
+            consciousness_void_metrics_t metrics = consciousness_void_get_metrics(cvoid);
+            assert(fabs(metrics.signal_strength_mean - mean) < 1e-12);
+            assert(fabs(metrics.signal_strength_variance - m2 / (double)writes) < 1e-12);
+        }
+    }
+    assert(cvoid->histogram_total == cvoid->voided_bytes);
+
+    double pattern[256];
+    bool signal = consciousness_void_extract_signal(cvoid, pattern, 256);
+    assert(signal == (reference_entropy(histogram) < VOID_SIGNAL_ENTROPY_BITS));
+    for (int value = 0; value < 256; value++) {
+        assert(fabs(pattern[value] - (double)histogram[value] / (double)cvoid->histogram_total) < 1e-15);
+    }
+    consciousness_void_destroy(cvoid);
+    quiet_end(saved);
+
+    printf("Running statistics test passed\n");
+}
+
+int main(void) {
+    test_entropy_values();
+    test_running_statistics();
+    printf("All void statistics tests passed!\n");
+    return 0;
+}
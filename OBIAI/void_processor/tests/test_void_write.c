@@ -0,0 +1,177 @@
+// tests/test_void_write.c
+// Checks for the void device: one descriptor for the life of the void,
+// writes staged and batched in order, and pattern extraction bounded by
+// the write
+
+#define _POSIX_C_SOURCE 200809L  // mkdtemp
+
+#include "consciousness_void.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// The void reports every write on stdout; keep it out of the test log
+static int quiet_begin(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved >= 0 && null >= 0);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void quiet_end(int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static off_t file_size(const char* path) {
+    struct stat st;
+    assert(stat(path, &st) == 0);
+    return st.st_size;
+}
+
+static void test_staged_writes(void) {
+    printf("Testing staged writes...\n");
+
+    // A regular file stands in for the device so what reaches it can be read
+    char dir[] = "/tmp/void_write_XXXXXX";
+    assert(mkdtemp(dir) != NULL);
+    char path[64], moved[64];
+    snprintf(path, sizeof(path), "%s/device", dir);
+    snprintf(moved, sizeof(moved), "%s/moved", dir);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    assert(fd >= 0);
+    close(fd);
+
+    int saved = quiet_begin();
+    consciousness_void_t* cvoid = consciousness_void_create(path);
+    quiet_end(saved);
+    assert(cvoid != NULL && cvoid->void_fd >= 0);
+    assert(fcntl(cvoid->void_fd, F_GETFD) & FD_CLOEXEC);
+    cvoid->strategy = VOID_DISCARD;
+
+    // The descriptor outlives the name it was opened by
+    assert(rename(path, moved) == 0);
+
+    static unsigned char expected[64 * 1024];
+    size_t total = 0;
+    saved = quiet_begin();
+
+    // Small writes stay staged until the ring would overflow, then go out
+    // with the write that overflowed it
+    for (int i = 0; i < 40; i++) {
+        unsigned char chunk[100];
+        memset(chunk, 'a' + i % 26, sizeof(chunk));
+        assert(consciousness_void_write(cvoid, chunk, sizeof(chunk)) == (int)sizeof(chunk));
+        memcpy(expected + total, chunk, sizeof(chunk));
+        total += sizeof(chunk);
+    }
+    assert(file_size(moved) == 0 && cvoid->buffer_len == 4000);
+    unsigned char overflow[200];
+    memset(overflow, 'Z', sizeof(overflow));
+    assert(consciousness_void_write(cvoid, overflow, sizeof(overflow)) == (int)sizeof(overflow));
+    memcpy(expected + total, overflow, sizeof(overflow));
+    total += sizeof(overflow);
+    assert(file_size(moved) == (off_t)total && cvoid->buffer_len == 0);
+
+    // Odd sizes wrap the ring; writes larger than it bypass it
+    for (size_t size = 1; total + size < sizeof(expected) - 10000; size = size * 3 + 7) {
+        unsigned char* chunk = malloc(size);
+        assert(chunk != NULL);
+        for (size_t i = 0; i < size; i++) chunk[i] = (unsigned char)(total + i);
+        assert(consciousness_void_write(cvoid, chunk, size) == (int)size);
+        memcpy(expected + total, chunk, size);
+        total += size;
+        free(chunk);
+    }
+    off_t before_flush = file_size(moved);
+    assert(before_flush + (off_t)cvoid->buffer_len == (off_t)total);
+    assert(consciousness_void_flush(cvoid) == 0);
+    assert(file_size(moved) == (off_t)total && cvoid->buffer_len == 0);
+    assert(consciousness_void_flush(cvoid) == 0);
+
+    // Destroy writes out the rest
+    unsigned char tail[10] = "void tail";
+    assert(consciousness_void_write(cvoid, tail, sizeof(tail)) == (int)sizeof(tail));
+    memcpy(expected + total, tail, sizeof(tail));
+    total += sizeof(tail);
+    assert(cvoid->voided_bytes == total);
+    consciousness_void_destroy(cvoid);
+    quiet_end(saved);
+
+    // Everything arrived once, in order
+    assert(file_size(moved) == (off_t)total);
+    unsigned char* contents = malloc(total);
+    assert(contents != NULL);
+    fd = open(moved, O_RDONLY);
+    assert(fd >= 0 && read(fd, contents, total) == (ssize_t)total);
+    close(fd);
+    assert(memcmp(contents, expected, total) == 0);
+    free(contents);
+
+    unlink(moved);
+    rmdir(dir);
+    printf("Staged writes test passed\n");
+}
+
+static void test_missing_device(void) {
+    printf("Testing missing device...\n");
+
+    int saved = quiet_begin();
+    consciousness_void_t* cvoid = consciousness_void_create("/nonexistent/void");
+    assert(cvoid != NULL && cvoid->void_fd < 0);
+    cvoid->strategy = VOID_DISCARD;
+    assert(consciousness_void_write(cvoid, "lost", 4) == 0);
+    assert(cvoid->voided_bytes == 0);
+    assert(consciousness_void_flush(cvoid) == -1);
+    assert(consciousness_void_write(cvoid, NULL, 4) == -1);
+    assert(consciousness_void_write(cvoid, "x", 0) == -1);
+    assert(consciousness_void_flush(NULL) == -1);
+    consciousness_void_destroy(cvoid);
+    quiet_end(saved);
+
+    printf("Missing device test passed\n");
+}
+
+static void test_encode_bounds(void) {
+    printf("Testing encode bounds...\n");
+
+    int saved = quiet_begin();
+    consciousness_void_t* cvoid = consciousness_void_create(NULL);
+    assert(cvoid != NULL && strcmp(cvoid->void_device, "/dev/null") == 0);
+    assert(cvoid->strategy == VOID_ENCODE);
+
+    // Data without a NUL is read up to its size and no further
+    unsigned char* strong = malloc(200);
+    assert(strong != NULL);
+    memset(strong, 0xFF, 200);
+    assert(consciousness_void_write(cvoid, strong, 200) == 200);
+    assert(cvoid->preserved_patterns == 1);
+    assert(strcmp(cvoid->pattern_cache, "WISDOM_PATTERN_1.000") == 0);
+
+    // Extraction stops at the first NUL
+    memset(strong + 10, 0, 1);
+    assert(consciousness_void_write(cvoid, strong, 200) == 200);
+    assert(cvoid->preserved_patterns == 1);
+    assert(cvoid->voided_bytes == 400);
+    free(strong);
+
+    consciousness_void_destroy(cvoid);
+    quiet_end(saved);
+    printf("Encode bounds test passed\n");
+}
+
+int main(void) {
+    test_staged_writes();
+    test_missing_device();
+    test_encode_bounds();
+    printf("All void write tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+// bench/include/obibench.h
+// OBINexus MVP microbenchmark harness
+//
+// One harness for every subsystem's `make bench`, so their numbers can be
+// compared and tracked side by side. A benchmark is a function that runs
+// its operation count times; the harness warms it up, sizes a batch of
+// operations to a measurable sample, times a fixed number of samples with
+// the cycle counter (rdtsc, cntvct_el0, else CLOCK_MONOTONIC), and keeps
+// per-operation times in a log-linear histogram for percentiles. Where the
+// kernel allows it, hardware counters (cycles, instructions, cache misses,
+// branch misses) are read around the timed samples through
+// perf_event_open.
+//
+// Results print as a table and are written as one JSON document per suite
+// to --json PATH and, when set, OBIBENCH_RESULTS_DIR/<suite>.json, which
+// scripts/bench-all.sh gathers across the stack for the dashboard.
+//
+//     static void bench_push(void* arg, uint64_t count) {
+//         for (uint64_t i = 0; i < count; i++) queue_push(arg, i);
+//     }
+//
+//     int main(int argc, char** argv) {
+//         obibench_suite_t* suite = obibench_init("my-subsystem", argc, argv);
+//         obibench_run(suite, "queue_push", bench_push, queue);
+//         return obibench_finish(suite);
+//     }
+//
+// Options: --samples N, --batch N (operations per sample, default sized to
+// ~20 us), --warmup-ms N, --filter TEXT, --json PATH, --no-counters, --list.
+
+#ifndef OBIBENCH_H
+#define OBIBENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Runs the operation under test count times
+typedef void (*obibench_fn)(void* arg, uint64_t count);
+
+typedef struct obibench_suite obibench_suite_t;
+
+// Parses the options above; unknown arguments are left to the caller.
+// Never returns NULL: out of memory exits.
+obibench_suite_t* obibench_init(const char* suite, int argc, char** argv);
+
+void obibench_run(obibench_suite_t* suite, const char* name, obibench_fn fn, void* arg);
+
+// As obibench_run, also reporting bytes_per_op as throughput
+void obibench_run_bytes(obibench_suite_t* suite, const char* name, obibench_fn fn, void* arg,
+                        uint64_t bytes_per_op);
+
+// Prints the summary, writes the JSON and frees the suite. Returns an exit
+// status: nonzero if the JSON could not be written.
+int obibench_finish(obibench_suite_t* suite);
+
+// The harness clock, for benchmarks that time their own sections
+uint64_t obibench_ticks(void);
+double obibench_ticks_to_ns(uint64_t ticks);
+
+// Keep the compiler from discarding a result or caching memory across it
+static inline void obibench_do_not_optimize(const void* value) {
+    __asm__ volatile("" : : "r"(value) : "memory");
+}
+
+static inline void obibench_clobber(void) {
+    __asm__ volatile("" : : : "memory");
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OBIBENCH_H
@@ -0,0 +1,18 @@
+# obibench.mk - include from a subsystem Makefile to link the shared harness
+#
+#     include ../../bench/obibench.mk
+#     bench: $(OBIBENCH_LIB)
+#         $(CC) $(CFLAGS) $(OBIBENCH_CFLAGS) bench.c -o $@ $(OBIBENCH_LIB) $(OBIBENCH_LDLIBS)
+
+OBIBENCH_DIR := $(patsubst %/,%,$(dir $(abspath $(lastword $(MAKEFILE_LIST)))))
+OBIBENCH_CFLAGS = -I$(OBIBENCH_DIR)/include
+OBIBENCH_LIB = $(OBIBENCH_DIR)/build/libobibench.a
+OBIBENCH_LDLIBS = -lm
+
+# The library rule must not become the including Makefile's default goal
+OBIBENCH_SAVED_GOAL := $(.DEFAULT_GOAL)
+
+$(OBIBENCH_LIB): $(OBIBENCH_DIR)/src/obibench.c $(OBIBENCH_DIR)/include/obibench.h
+	$(MAKE) -C $(OBIBENCH_DIR)
+
+.DEFAULT_GOAL := $(OBIBENCH_SAVED_GOAL)
@@ -0,0 +1,609 @@
+// bench/src/obibench.c
+// OBINexus MVP microbenchmark harness
+
+#define _GNU_SOURCE
+#include "obibench.h"
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define DEFAULT_SAMPLES 1000
+#define DEFAULT_WARMUP_MS 50
+#define TARGET_SAMPLE_NS 20000.0
+#define MAX_BATCH (1ULL << 30)
+
+// Per-operation times in picoseconds, log-linear: exact below 2 * SUB_COUNT,
+// then SUB_COUNT buckets per power of two (about 3% wide)
+#define SUB_BITS 5
+#define SUB_COUNT (1u << SUB_BITS)
+#define BUCKETS ((64 - SUB_BITS + 1) * SUB_COUNT)
+
+typedef enum {
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES,
+    COUNTER_BRANCH_MISSES,
+    COUNTER_COUNT
+} counter_t;
+
+static const char* const g_counter_names[COUNTER_COUNT] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+typedef struct {
+    char* name;
+    uint64_t samples;
+    uint64_t batch;
+    uint64_t bytes_per_op;
+    double mean_ns, stddev_ns, min_ns, max_ns;
+    double p50_ns, p90_ns, p99_ns, p999_ns;
+    double ticks_per_op;
+    bool has_counter[COUNTER_COUNT];
+    double counter_per_op[COUNTER_COUNT];
+    uint32_t* histogram;        // BUCKETS counts
+} result_t;
+
+struct obibench_suite {
+    char* name;
+    uint64_t samples;
+    uint64_t batch;             // 0 to size automatically
+    uint64_t warmup_ns;
+    const char* filter;
+    const char* json_path;      // --json
+    char* results_path;         // OBIBENCH_RESULTS_DIR/<suite>.json
+    bool list_only;
+    bool counters;
+
+    const char* timer;
+    double ns_per_tick;
+
+    int counter_fd[COUNTER_COUNT];    // Group led by the first open one; -1 if unavailable
+    int counter_leader;
+    const char* counters_status;
+
+    result_t* results;
+    size_t result_count;
+    size_t result_capacity;
+    uint64_t* scratch;          // Sample ticks
+};
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Start and end reads are fenced so the timed code cannot drift across them
+static inline uint64_t ticks_begin(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t ticks = __rdtsc();
+    _mm_lfence();
+    return ticks;
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+    return ticks;
+#else
+    return monotonic_ns();
+#endif
+}
+
+static inline uint64_t ticks_end(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int aux;
+    uint64_t ticks = __rdtscp(&aux);
+    _mm_lfence();
+    return ticks;
+#else
+    return ticks_begin();
+#endif
+}
+
+static const char* timer_name(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return "rdtsc";
+#elif defined(__aarch64__)
+    return "cntvct_el0";
+#else
+    return "clock_monotonic";
+#endif
+}
+
+// Counter ticks against CLOCK_MONOTONIC over a short spin
+static double calibrate_ns_per_tick(void) {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    uint64_t start_ns = monotonic_ns(), start_ticks = ticks_begin();
+    while (monotonic_ns() - start_ns < 20000000ULL) {}
+    uint64_t elapsed_ns = monotonic_ns() - start_ns, elapsed_ticks = ticks_end() - start_ticks;
+    return elapsed_ticks ? (double)elapsed_ns / (double)elapsed_ticks : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+static double g_ns_per_tick = 0.0;
+
+uint64_t obibench_ticks(void) {
+    return ticks_begin();
+}
+
+double obibench_ticks_to_ns(uint64_t ticks) {
+    if (g_ns_per_tick == 0.0) g_ns_per_tick = calibrate_ns_per_tick();
+    return (double)ticks * g_ns_per_tick;
+}
+
+// ============================================================================
+// Hardware counters
+// ============================================================================
+
+#ifdef __linux__
+static int open_counter(uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+static void counters_open(obibench_suite_t* suite) {
+    for (int c = 0; c < COUNTER_COUNT; c++) suite->counter_fd[c] = -1;
+    suite->counter_leader = -1;
+    if (!suite->counters) {
+        suite->counters_status = "disabled";
+        return;
+    }
+
+#ifdef __linux__
+    static const uint64_t configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    int first_errno = 0;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        int leader = suite->counter_leader >= 0 ? suite->counter_fd[suite->counter_leader] : -1;
+        suite->counter_fd[c] = open_counter(configs[c], leader);
+        if (suite->counter_fd[c] < 0) {
+            if (!first_errno) first_errno = errno;
+        } else if (suite->counter_leader < 0) {
+            suite->counter_leader = c;
+        }
+    }
+    if (suite->counter_leader >= 0) {
+        suite->counters_status = "perf_event";
+    } else {
+        suite->counters_status = first_errno == EACCES || first_errno == EPERM
+            ? "unavailable (perf_event_paranoid)" : "unavailable";
+    }
+#else
+    suite->counters_status = "unsupported";
+#endif
+}
+
+static void counters_close(obibench_suite_t* suite) {
+#ifdef __linux__
+    for (int c = COUNTER_COUNT - 1; c >= 0; c--) {
+        if (suite->counter_fd[c] >= 0) close(suite->counter_fd[c]);
+    }
+#endif
+}
+
+static void counters_start(obibench_suite_t* suite) {
+#ifdef __linux__
+    if (suite->counter_leader < 0) return;
+    int leader = suite->counter_fd[suite->counter_leader];
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    (void)suite;
+#endif
+}
+
+// Totals since counters_start, scaled up if the kernel multiplexed them
+static void counters_stop(obibench_suite_t* suite, result_t* result, uint64_t operations) {
+#ifdef __linux__
+    if (suite->counter_leader < 0) return;
+    int leader = suite->counter_fd[suite->counter_leader];
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t values[3 + COUNTER_COUNT];
+    ssize_t got = read(leader, values, sizeof(values));
+    if (got < (ssize_t)(3 * sizeof(uint64_t)) || values[2] == 0) return;
+
+    double scale = (double)values[1] / (double)values[2];
+    uint64_t index = 0;
+    for (int c = 0; c < COUNTER_COUNT && index < values[0]; c++) {
+        if (suite->counter_fd[c] < 0) continue;
+        result->has_counter[c] = true;
+        result->counter_per_op[c] = (double)values[3 + index++] * scale / (double)operations;
+    }
+#else
+    (void)suite;
+    (void)result;
+    (void)operations;
+#endif
+}
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+static unsigned int bucket_of(uint64_t value) {
+    if (value < 2 * SUB_COUNT) return (unsigned int)value;
+    unsigned int exponent = 63u - (unsigned int)__builtin_clzll(value);
+    unsigned int shift = exponent - SUB_BITS;
+    return shift * SUB_COUNT + (unsigned int)(value >> shift);
+}
+
+static uint64_t bucket_low(unsigned int bucket) {
+    if (bucket < 2 * SUB_COUNT) return bucket;
+    unsigned int shift = bucket / SUB_COUNT - 1;
+    return (uint64_t)(bucket % SUB_COUNT + SUB_COUNT) << shift;
+}
+
+static double bucket_mid_ns(unsigned int bucket) {
+    uint64_t low = bucket_low(bucket);
+    uint64_t width = bucket < 2 * SUB_COUNT ? 1 : 1ULL << (bucket / SUB_COUNT - 1);
+    return ((double)low + (double)(width - 1) / 2.0) / 1000.0;
+}
+
+static double percentile_ns(const uint32_t* histogram, uint64_t total, double fraction,
+                            double min_ns, double max_ns) {
+    uint64_t rank = (uint64_t)ceil(fraction * (double)total);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (unsigned int b = 0; b < BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen >= rank) {
+            double value = bucket_mid_ns(b);
+            return value < min_ns ? min_ns : value > max_ns ? max_ns : value;
+        }
+    }
+    return max_ns;
+}
+
+// ============================================================================
+// Suite
+// ============================================================================
+
+static void* checked(void* pointer) {
+    if (!pointer) {
+        fprintf(stderr, "obibench: out of memory\n");
+        exit(1);
+    }
+    return pointer;
+}
+
+static char* copy_string(const char* text) {
+    size_t length = strlen(text) + 1;
+    return memcpy(checked(malloc(length)), text, length);
+}
+
+static uint64_t parse_count(const char* option, const char* value) {
+    char* end;
+    errno = 0;
+    unsigned long long parsed = value ? strtoull(value, &end, 10) : 0;
+    if (!value || errno || *end || parsed == 0) {
+        fprintf(stderr, "obibench: %s needs a positive number\n", option);
+        exit(2);
+    }
+    return parsed;
+}
+
+obibench_suite_t* obibench_init(const char* name, int argc, char** argv) {
+    obibench_suite_t* suite = checked(calloc(1, sizeof(*suite)));
+    suite->name = copy_string(name ? name : "bench");
+    suite->samples = DEFAULT_SAMPLES;
+    suite->warmup_ns = DEFAULT_WARMUP_MS * 1000000ULL;
+    suite->counters = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--samples") == 0) {
+            suite->samples = parse_count(argv[i], value);
+            i++;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            suite->batch = parse_count(argv[i], value);
+            i++;
+        } else if (strcmp(argv[i], "--warmup-ms") == 0) {
+            suite->warmup_ns = parse_count(argv[i], value) * 1000000ULL;
+            i++;
+        } else if (strcmp(argv[i], "--filter") == 0 && value) {
+            suite->filter = value;
+            i++;
+        } else if (strcmp(argv[i], "--json") == 0 && value) {
+            suite->json_path = value;
+            i++;
+        } else if (strcmp(argv[i], "--no-counters") == 0) {
+            suite->counters = false;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            suite->list_only = true;
+        }
+    }
+
+    const char* results_dir = getenv("OBIBENCH_RESULTS_DIR");
+    if (results_dir && *results_dir) {
+        size_t length = strlen(results_dir) + strlen(suite->name) + 7;
+        suite->results_path = checked(malloc(length));
+        snprintf(suite->results_path, length, "%s/%s.json", results_dir, suite->name);
+    }
+
+    suite->scratch = checked(malloc(suite->samples * sizeof(*suite->scratch)));
+    if (!suite->list_only) {
+        suite->timer = timer_name();
+        suite->ns_per_tick = g_ns_per_tick = calibrate_ns_per_tick();
+        counters_open(suite);
+        printf("%s: timer %s at %.3f GHz, counters %s\n", suite->name, suite->timer,
+               1.0 / suite->ns_per_tick, suite->counters_status);
+        printf("%-32s %10s %10s %10s %10s %10s %12s\n", "benchmark", "mean ns", "p50",
+               "p90", "p99", "p99.9", "ops/s");
+    }
+    return suite;
+}
+
+static double sample_ns(const obibench_suite_t* suite, obibench_fn fn, void* arg, uint64_t batch) {
+    uint64_t start = ticks_begin();
+    fn(arg, batch);
+    return (double)(ticks_end() - start) * suite->ns_per_tick;
+}
+
+// Double the batch until one sample takes TARGET_SAMPLE_NS
+static uint64_t size_batch(const obibench_suite_t* suite, obibench_fn fn, void* arg) {
+    uint64_t batch = 1;
+    while (batch < MAX_BATCH && sample_ns(suite, fn, arg, batch) < TARGET_SAMPLE_NS) {
+        batch *= 2;
+    }
+    return batch;
+}
+
+static void print_result(const result_t* result) {
+    printf("%-32s %10.2f %10.2f %10.2f %10.2f %10.2f %12.0f\n", result->name, result->mean_ns,
+           result->p50_ns, result->p90_ns, result->p99_ns, result->p999_ns,
+           result->mean_ns > 0 ? 1e9 / result->mean_ns : 0.0);
+    if (result->has_counter[COUNTER_CYCLES] || result->bytes_per_op) {
+        printf("%-32s", "");
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            if (result->has_counter[c]) {
+                printf(" %s/op %.2f", g_counter_names[c], result->counter_per_op[c]);
+            }
+        }
+        if (result->has_counter[COUNTER_CYCLES] && result->has_counter[COUNTER_INSTRUCTIONS] &&
+            result->counter_per_op[COUNTER_CYCLES] > 0) {
+            printf(" ipc %.2f", result->counter_per_op[COUNTER_INSTRUCTIONS] /
+                                result->counter_per_op[COUNTER_CYCLES]);
+        }
+        if (result->bytes_per_op && result->mean_ns > 0) {
+            printf(" %.1f MB/s", (double)result->bytes_per_op * 1e3 / result->mean_ns);
+        }
+        printf("\n");
+    }
+}
+
+void obibench_run_bytes(obibench_suite_t* suite, const char* name, obibench_fn fn, void* arg,
+                        uint64_t bytes_per_op) {
+    if (!suite || !name || !fn) return;
+    if (suite->filter && !strstr(name, suite->filter)) return;
+    if (suite->list_only) {
+        printf("%s\n", name);
+        return;
+    }
+
+    if (suite->result_count == suite->result_capacity) {
+        suite->result_capacity = suite->result_capacity ? suite->result_capacity * 2 : 16;
+        suite->results = checked(realloc(suite->results,
+                                         suite->result_capacity * sizeof(*suite->results)));
+    }
+    result_t* result = &suite->results[suite->result_count++];
+    memset(result, 0, sizeof(*result));
+    result->name = copy_string(name);
+    result->samples = suite->samples;
+    result->bytes_per_op = bytes_per_op;
+    result->histogram = checked(calloc(BUCKETS, sizeof(*result->histogram)));
+
+    // Warm caches, branch predictors and clocks, then size the batch
+    uint64_t warmup_end = monotonic_ns() + suite->warmup_ns;
+    do {
+        fn(arg, suite->batch ? suite->batch : 1);
+    } while (monotonic_ns() < warmup_end);
+    result->batch = suite->batch ? suite->batch : size_batch(suite, fn, arg);
+
+    counters_start(suite);
+    for (uint64_t s = 0; s < suite->samples; s++) {
+        uint64_t start = ticks_begin();
+        fn(arg, result->batch);
+        suite->scratch[s] = ticks_end() - start;
+    }
+    counters_stop(suite, result, suite->samples * result->batch);
+
+    // Welford over per-operation times
+    double mean = 0.0, m2 = 0.0, total_ticks = 0.0;
+    result->min_ns = INFINITY;
+    result->max_ns = 0.0;
+    for (uint64_t s = 0; s < suite->samples; s++) {
+        total_ticks += (double)suite->scratch[s];
+        double ns = (double)suite->scratch[s] * suite->ns_per_tick / (double)result->batch;
+        double delta = ns - mean;
+        mean += delta / (double)(s + 1);
+        m2 += delta * (ns - mean);
+        if (ns < result->min_ns) result->min_ns = ns;
+        if (ns > result->max_ns) result->max_ns = ns;
+        result->histogram[bucket_of((uint64_t)llround(ns * 1000.0))]++;
+    }
+    result->mean_ns = mean;
+    result->stddev_ns = suite->samples > 1 ? sqrt(m2 / (double)(suite->samples - 1)) : 0.0;
+    result->ticks_per_op = total_ticks / ((double)suite->samples * (double)result->batch);
+    result->p50_ns = percentile_ns(result->histogram, suite->samples, 0.50, result->min_ns, result->max_ns);
+    result->p90_ns = percentile_ns(result->histogram, suite->samples, 0.90, result->min_ns, result->max_ns);
+    result->p99_ns = percentile_ns(result->histogram, suite->samples, 0.99, result->min_ns, result->max_ns);
+    result->p999_ns = percentile_ns(result->histogram, suite->samples, 0.999, result->min_ns, result->max_ns);
+
+    print_result(result);
+}
+
+void obibench_run(obibench_suite_t* suite, const char* name, obibench_fn fn, void* arg) {
+    obibench_run_bytes(suite, name, fn, arg, 0);
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+static void json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p < 0x20) fprintf(out, "\\u%04x", *p);
+        else fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+// JSON has no NaN or infinity
+static double json_number(double value) {
+    return isfinite(value) ? value : 0.0;
+}
+
+static void cpu_model(char* model, size_t size) {
+    snprintf(model, size, "unknown");
+    FILE* cpuinfo = fopen("/proc/cpuinfo", "r");
+    if (!cpuinfo) return;
+
+    char line[256];
+    while (fgets(line, sizeof(line), cpuinfo)) {
+        char* colon = strchr(line, ':');
+        if (!colon || strncmp(line, "model name", 10) != 0) continue;
+        colon++;
+        while (*colon == ' ' || *colon == '\t') colon++;
+        colon[strcspn(colon, "\n")] = '\0';
+        snprintf(model, size, "%s", colon);
+        break;
+    }
+    fclose(cpuinfo);
+}
+
+static bool write_json(const obibench_suite_t* suite, const char* path) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "obibench: cannot write %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct utsname host;
+    if (uname(&host) != 0) memset(&host, 0, sizeof(host));
+    char model[128];
+    cpu_model(model, sizeof(model));
+    const char* revision = getenv("OBIBENCH_REVISION");
+
+    fprintf(out, "{\n  \"suite\": ");
+    json_string(out, suite->name);
+    fprintf(out, ",\n  \"timestamp\": %lld,\n  \"revision\": ", (long long)time(NULL));
+    json_string(out, revision ? revision : "");
+    fprintf(out, ",\n  \"host\": { \"system\": ");
+    json_string(out, host.sysname);
+    fprintf(out, ", \"release\": ");
+    json_string(out, host.release);
+    fprintf(out, ", \"machine\": ");
+    json_string(out, host.machine);
+    fprintf(out, ", \"cpu\": ");
+    json_string(out, model);
+    fprintf(out, " },\n  \"timer\": { \"source\": ");
+    json_string(out, suite->timer);
+    fprintf(out, ", \"ghz\": %.4f },\n  \"counters\": ", json_number(1.0 / suite->ns_per_tick));
+    json_string(out, suite->counters_status);
+    fprintf(out, ",\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < suite->result_count; i++) {
+        const result_t* result = &suite->results[i];
+        fprintf(out, "%s\n    {\n      \"name\": ", i ? "," : "");
+        json_string(out, result->name);
+        fprintf(out, ",\n      \"samples\": %llu, \"batch\": %llu,\n",
+                (unsigned long long)result->samples, (unsigned long long)result->batch);
+        fprintf(out, "      \"ns_per_op\": { \"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f, "
+                     "\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f },\n",
+                json_number(result->mean_ns), json_number(result->stddev_ns),
+                json_number(result->min_ns), json_number(result->p50_ns),
+                json_number(result->p90_ns), json_number(result->p99_ns),
+                json_number(result->p999_ns), json_number(result->max_ns));
+        fprintf(out, "      \"ops_per_sec\": %.1f, \"ticks_per_op\": %.3f",
+                result->mean_ns > 0 ? 1e9 / result->mean_ns : 0.0,
+                json_number(result->ticks_per_op));
+        if (result->bytes_per_op) {
+            fprintf(out, ", \"bytes_per_op\": %llu, \"mb_per_sec\": %.3f",
+                    (unsigned long long)result->bytes_per_op,
+                    result->mean_ns > 0 ? (double)result->bytes_per_op * 1e3 / result->mean_ns : 0.0);
+        }
+
+        fprintf(out, ",\n      \"counters_per_op\": {");
+        bool first = true;
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            if (!result->has_counter[c]) continue;
+            fprintf(out, "%s \"%s\": %.4f", first ? "" : ",", g_counter_names[c],
+                    json_number(result->counter_per_op[c]));
+            first = false;
+        }
+        fprintf(out, "%s},\n      \"histogram_ns\": [", first ? "" : " ");
+
+        first = true;
+        for (unsigned int b = 0; b < BUCKETS; b++) {
+            if (!result->histogram[b]) continue;
+            fprintf(out, "%s[%.3f, %u]", first ? "" : ", ", (double)bucket_low(b) / 1000.0,
+                    result->histogram[b]);
+            first = false;
+        }
+        fprintf(out, "]\n    }");
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) ok = false;
+    if (ok) printf("results: %s\n", path);
+    return ok;
+}
+
+int obibench_finish(obibench_suite_t* suite) {
+    if (!suite) return 1;
+
+    bool ok = true;
+    if (!suite->list_only) {
+        if (suite->json_path && !write_json(suite, suite->json_path)) ok = false;
+        if (suite->results_path && !write_json(suite, suite->results_path)) ok = false;
+    }
+
+    counters_close(suite);
+    for (size_t i = 0; i < suite->result_count; i++) {
+        free(suite->results[i].name);
+        free(suite->results[i].histogram);
+    }
+    free(suite->results);
+    free(suite->scratch);
+    free(suite->results_path);
+    free(suite->name);
+    free(suite);
+    return ok ? 0 : 1;
+}
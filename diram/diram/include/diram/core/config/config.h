@@ -7,7 +7,9 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <limits.h>
+#include <stdatomic.h>
 
 #ifndef PATH_MAX
 #define PATH_MAX 4096
@@ -26,15 +28,21 @@
 #define CFG_MEMORY_LIMIT "memory_limit"
 #define CFG_MEMORY_SPACE "memory_space"
 #define CFG_TRACE "trace"
+#define CFG_TRACE_FORMAT "trace_format"
+#define CFG_RECEIPT_MODE "receipt_mode"
 #define CFG_LOG_DIR "log_dir"
 #define CFG_MAX_HEAP_EVENTS "max_heap_events"
+#define CFG_HEAP_MODE "heap_mode"
 #define CFG_DETACH_TIMEOUT "detach_timeout"
 #define CFG_PID_BINDING "pid_binding"
 #define CFG_GUARD_PAGES "guard_pages"
+#define CFG_HUGEPAGES "hugepages"
 #define CFG_CANARY_VALUES "canary_values"
 #define CFG_ASLR_ENABLED "aslr_enabled"
 #define CFG_TELEMETRY_LEVEL "telemetry_level"
 #define CFG_TELEMETRY_ENDPOINT "telemetry_endpoint"
+#define CFG_TELEMETRY_HEAD_SAMPLE "telemetry_head_sample"
+#define CFG_TELEMETRY_TAIL_SAMPLE "telemetry_tail_sample"
 #define CFG_ZERO_TRUST "zero_trust"
 #define CFG_MEMORY_AUDIT "memory_audit"
 
@@ -65,10 +73,13 @@ typedef struct diram_config_t {
     
     // Tracing configuration
     bool trace_enabled;
+    char trace_format[16];    // "text" or "binary"
+    char receipt_mode[16];    // "sha256" or "siphash"
     char log_dir[PATH_MAX];
     
     // Heap constraint configuration
-    int max_heap_events;
+    int max_heap_events;      // Bucket depth and refill per second
+    char heap_mode[16];       // "reject" or "defer"
     
     // Process isolation settings
     int detach_timeout;       // Seconds
@@ -76,12 +87,15 @@ typedef struct diram_config_t {
     
     // Memory protection flags
     bool guard_pages;
+    char hugepages[16];       // "off", "thp" or "hugetlb"
     bool canary_values;
     bool aslr_enabled;
     
     // Telemetry configuration
     int telemetry_level;
     char telemetry_endpoint[PATH_MAX];
+    double telemetry_head_sample;    // Fraction of routine events exported
+    double telemetry_tail_sample;    // Fraction of error events exported
     
     // Zero-trust memory policy
     bool zero_trust;
@@ -120,9 +134,21 @@ typedef enum {
     CONFIG_SOURCE_ENV
 } config_source_t;
 
-// Global configuration instance
+// Global configuration instance: the working copy that set/load edit
 extern diram_config_t g_diram_config;
 
+// Last published immutable snapshot, NULL until the first publish
+extern _Atomic(const diram_config_t*) g_diram_config_snapshot;
+
+// Lock-free read side for hot paths. Before anything is published this is
+// the working copy itself, so code that pokes g_diram_config directly
+// keeps working until diram_config_init() or a load publishes.
+static inline const diram_config_t* diram_config_current(void) {
+    const diram_config_t* cfg = atomic_load_explicit(&g_diram_config_snapshot,
+                                                     memory_order_acquire);
+    return cfg ? cfg : &g_diram_config;
+}
+
 // Configuration API
 int diram_config_init(void);
 int diram_config_load_file(const char* filename, config_source_t source);
@@ -133,6 +159,21 @@ int diram_config_save(const char* filename);
 void diram_config_print(void);
 void diram_config_cleanup(void);
 int diram_config_load_hierarchy(void);
+
+// init, set_value and every load publish a fresh snapshot; commit publishes
+// one after writing g_diram_config fields directly. Superseded snapshots
+// stay readable until diram_config_cleanup().
+int diram_config_commit(void);
+uint64_t diram_config_generation(void);
+
+// Re-read a file on top of the working copy and publish it; a file that
+// fails to parse or validate is rolled back and nothing is published
+int diram_config_reload(const char* filename);
+
+// Reload on every change to filename (NULL: config_file), via inotify on
+// its directory so editors that replace the file are seen too
+int diram_config_watch(const char* filename);
+void diram_config_unwatch(void);
 // Configuration validation
 bool diram_config_validate(void);
 const char* diram_config_get_errors(void);
@@ -16,10 +16,20 @@ typedef HANDLE pthread_mutex_t;
 #else
 #include <pthread.h>
 #endif
+#include "trace_ring.h"
 #define DIRAM_MAX_HEAP_EVENTS 3
 #define DIRAM_SHA256_HEX_LEN 65
 #define DIRAM_TRACE_LOG_PATH "logs/alloc_trace.log"
 
+// Link in the live-allocation registry that fork hand-off walks
+typedef struct diram_live_node {
+    struct diram_live_node* prev;
+    struct diram_live_node* next;
+    uint32_t generation;    // Fork generation of the process that allocated
+    uint8_t shard;
+    uint8_t is_region;      // Owner is a batch region, not a single allocation
+} diram_live_node_t;
+
 typedef struct {
     void* base_addr;
     size_t size;
@@ -27,21 +37,89 @@ typedef struct {
     char sha256_receipt[DIRAM_SHA256_HEX_LEN];
     uint8_t heap_events;
     pid_t binding_pid;  // PID binding for fork compliance
+    void* region;       // Owning batch region, NULL for single allocations
+    diram_live_node_t live;  // Unused for batch members; the region is linked
+    char tag[DIRAM_TRACE_TAG_LEN];  // Caller's tag, truncated
 } diram_allocation_t;
 
-// Thread-local heap event counter for constraint enforcement
+// Thread-local heap event credit: a token bucket holding max_heap_events
+// events, refilled continuously at max_heap_events per second. Credit is
+// kept in nanoseconds of refill time so the bucket is always one second
+// deep; it goes negative when a deferred request borrows ahead.
 typedef struct {
-    uint8_t event_count;
-    uint64_t command_epoch;
+    uint8_t event_count;    // Events charged since the last epoch begin
+    uint64_t refill_ns;     // CLOCK_MONOTONIC time of the last refill
+    int64_t credit_ns;
 } diram_heap_context_t;
 
+// What the async path does when the bucket is empty: reject the promise,
+// or park it on the pool until the credit has been earned
+typedef enum {
+    DIRAM_HEAP_MODE_REJECT = 0,
+    DIRAM_HEAP_MODE_DEFER
+} diram_heap_mode_t;
+
 // Core allocation API
 diram_allocation_t* diram_alloc_traced(size_t size, const char* tag);
 void diram_free_traced(diram_allocation_t* alloc);
 
+// Free by payload address through the address index (alloc_index.h).
+// Returns 0, or -1 if address is not the start of a live traced allocation.
+int diram_free(void* address);
+
+// Allocate with a caller-sized tracker (>= sizeof(diram_allocation_t)) that
+// lives inline in front of the payload, e.g. diram_enhanced_allocation_t.
+// The result is released with diram_free_traced like any traced allocation.
+diram_allocation_t* diram_alloc_traced_ex(size_t size, const char* tag,
+                                          size_t tracker_size);
+
+// As above with DIRAM_ALLOC_* flags; DIRAM_ALLOC_GUARDED places the block
+// against a guard page (zero-trust mode)
+#define DIRAM_ALLOC_GUARDED 0x01
+diram_allocation_t* diram_alloc_traced_flags(size_t size, const char* tag,
+                                             size_t tracker_size, uint32_t flags);
+
+// Carve n traced allocations out of one region as a single heap event.
+// Receipts are hashed in SIMD lanes and traced as one ALLOC_RANGE record
+// whose receipt is the SHA-256 of the member receipts. Members are freed
+// individually with diram_free_traced; the region is released with the
+// last one. Returns 0 and fills out[0..n-1], or -1.
+int diram_alloc_batch(size_t n, const size_t* sizes, const char* tag,
+                      diram_allocation_t** out);
+int diram_alloc_batch_ex(size_t n, const size_t* sizes, const char* tag,
+                         size_t tracker_size, diram_allocation_t** out);
+
+// Heap-event hand-off for work run on another thread: the submitting thread
+// reserves the event against its own epoch (unreserve if the hand-off fails),
+// and the executing thread marks its next allocation as already paid for
+int diram_heap_event_reserve(void);
+void diram_heap_event_unreserve(void);
+void diram_heap_event_prepaid(void);
+
+// Reserve against credit not yet earned. Returns the nanoseconds until it
+// is (0 when charged immediately), or -1 if that exceeds max_wait_ns.
+int64_t diram_heap_event_reserve_deferred(uint64_t max_wait_ns);
+
+int diram_heap_mode_from_string(const char* value, diram_heap_mode_t* out);
+void diram_heap_set_mode(diram_heap_mode_t mode);
+diram_heap_mode_t diram_heap_get_mode(void);
+
+// Fork hand-off: a child inherits every live allocation of its parent. They
+// are adopted, so diram_free_traced releases them in the child as usual;
+// a prefork worker that needs none of them can drop them all in one pass.
+// Counts are registry entries: a batch region counts once.
+size_t diram_fork_release_inherited(void);
+size_t diram_fork_inherited_count(void);
+
+// Start a new command epoch for the calling thread (request loops, REPL
+// commands): refills the bucket and clears any deferred debt
+void diram_heap_epoch_begin(void);
+
 // Trace management
 int diram_init_trace_log(void);
+int diram_init_trace_log_ex(diram_trace_format_t format);
 void diram_close_trace_log(void);
+int diram_flush_trace_log(void);
 
 // SHA-256 receipt generation
 void diram_compute_receipt(diram_allocation_t* alloc, const char* tag);
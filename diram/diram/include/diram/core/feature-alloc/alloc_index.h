@@ -0,0 +1,39 @@
+// include/diram/core/feature-alloc/alloc_index.h
+// Address index of live traced allocations
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_ALLOC_INDEX_H
+#define DIRAM_ALLOC_INDEX_H
+
+#include "alloc.h"
+#include <stdio.h>
+
+// Every live traced allocation, keyed by its payload address. Batch
+// members are indexed one by one. Addresses hash to one of
+// DIRAM_ALLOC_INDEX_SHARDS open-addressing tables, each behind its own
+// lock, that grow without limit. Allocations inherited across fork()
+// stay indexed in the child until they are freed or released.
+#define DIRAM_ALLOC_INDEX_SHARDS 32
+
+// Maintained by alloc.c; insert returns 0, or -1 when out of memory
+int diram_alloc_index_insert(diram_allocation_t* alloc);
+void diram_alloc_index_remove(const diram_allocation_t* alloc);
+
+// Forget every allocation inherited from the parent process (used by
+// diram_fork_release_inherited); returns how many were dropped
+size_t diram_alloc_index_drop_inherited(void);
+
+// The live allocation whose payload starts at address, or NULL
+diram_allocation_t* diram_alloc_lookup(const void* address);
+size_t diram_alloc_live_count(void);
+
+// Visit every live allocation in no particular order; a nonzero return
+// stops the walk. Each shard is locked while it is visited, so visit
+// must not allocate or free traced memory. Returns the number visited.
+typedef int (*diram_alloc_visit_t)(diram_allocation_t* alloc, void* context);
+size_t diram_alloc_foreach(diram_alloc_visit_t visit, void* context);
+
+// Write one line per live allocation to out; returns the count
+size_t diram_alloc_report_leaks(FILE* out);
+
+#endif // DIRAM_ALLOC_INDEX_H
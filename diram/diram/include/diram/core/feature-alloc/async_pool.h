@@ -0,0 +1,47 @@
+// include/diram/core/feature-alloc/async_pool.h
+// Bounded work-stealing worker pool for the async promise subsystem
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_ASYNC_POOL_H
+#define DIRAM_ASYNC_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Used when async.max_pending_promises is unset
+#define DIRAM_ASYNC_DEFAULT_MAX_PENDING 100
+// Used when async.default_timeout_ms is unset; caps how long defer mode parks
+#define DIRAM_ASYNC_DEFAULT_TIMEOUT_MS 10000
+#define DIRAM_ASYNC_POOL_MAX_WORKERS 64
+
+typedef void (*diram_async_task_fn)(void* arg);
+
+typedef struct {
+    uint64_t submitted;
+    uint64_t executed;
+    uint64_t stolen;        // Tasks run by a worker other than the one queued on
+    uint64_t rejected;      // Submits refused at the max_pending bound
+    uint64_t deferred;      // Submits parked with a delay
+    uint32_t workers;
+    uint32_t max_pending;
+    uint32_t pending;       // Queued, parked or running right now
+    uint32_t parked;        // Waiting out their delay
+} diram_async_pool_stats_t;
+
+// Start the pool; 0 picks the default (online CPUs / async.max_pending_promises).
+// Submitting to a pool that was never started starts it with the defaults.
+int diram_async_pool_init(size_t workers, size_t max_pending);
+
+// Run every queued task, then join the workers
+void diram_async_pool_shutdown(void);
+
+// Queue fn(arg); returns -1 when max_pending tasks are already in flight
+int diram_async_pool_submit(diram_async_task_fn fn, void* arg);
+
+// Queue fn(arg) to run no earlier than delay_ns from now. Parked tasks
+// count against max_pending; shutdown runs them without waiting.
+int diram_async_pool_submit_after(diram_async_task_fn fn, void* arg, uint64_t delay_ns);
+
+void diram_async_pool_get_stats(diram_async_pool_stats_t* out);
+
+#endif // DIRAM_ASYNC_POOL_H
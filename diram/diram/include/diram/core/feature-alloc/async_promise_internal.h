@@ -4,25 +4,31 @@
 
 #include "async_promise.h"
 
-// Lookahead cache structure for predictive allocation
-typedef struct {
-    size_t predicted_size;
-    uint32_t access_pattern;
-    uint64_t last_access;
-    double confidence_score;
-} diram_lookahead_entry_t;
-
-// Global lookahead cache structure
-typedef struct {
-    diram_lookahead_entry_t* entries;
-    size_t capacity;
-    pthread_rwlock_t lock;
-} diram_lookahead_cache_t;
-
 // Context structure for async workers
 typedef struct {
     char* tag;
     diram_memory_space_t* space;
+    size_t requested_size;      // Before lookahead oversizing
 } diram_async_context_t;
 
+// Lookahead cache: size to allocate for a request, and the observation fed
+// back when a promise for (hint, tag) resolves
+size_t diram_lookahead_predict(uint32_t hint, const char* tag, size_t size);
+void diram_lookahead_observe(uint32_t hint, const char* tag, size_t size);
+
+// Pending promise with one reference held by the caller
+diram_async_promise_t* diram_promise_create(const char* tag,
+                                            diram_memory_space_t* space);
+
+// Reference counting: a queued task holds its own reference so a caller
+// may destroy a timed-out promise while the allocation is still running
+void diram_promise_retain(diram_async_promise_t* promise);
+void diram_promise_release(diram_async_promise_t* promise);
+
+// Called with promise->state_mutex held once the promise has settled
+void diram_cq_post_locked(diram_async_promise_t* promise);
+
+// Pool task: performs the allocation and settles the promise
+void diram_async_allocation_task(void* arg);
+
 #endif // DIRAM_ASYNC_PROMISE_INTERNAL_H
@@ -47,15 +47,28 @@ typedef struct {
     uint8_t severity;  // 0-3: info, warning, error, critical
 } diram_error_context_t;
 
+// Per-CPU accounting shards for a memory space
+#define DIRAM_SPACE_SHARDS 16
+#define DIRAM_SPACE_SHARD_BATCH_MAX (64 * 1024)
+
+typedef struct {
+    _Alignas(64) _Atomic int64_t used;  // Bytes charged through this shard
+    _Atomic int64_t count;
+    _Atomic size_t quota;               // Reserved against the limit, not yet used
+} diram_space_shard_t;
+
 // Memory Isolation Context
 typedef struct {
     char space_name[64];
     size_t limit_bytes;
-    size_t used_bytes;
-    uint32_t allocation_count;
-    pthread_mutex_t lock;
+    size_t used_bytes;          // Snapshot from the last diram_space_get_usage
+    uint32_t allocation_count;  // Snapshot, as above
+    pthread_mutex_t lock;       // Snapshots and the near-limit slow path only
     int isolation_active;
     pid_t owner_pid;
+    _Atomic size_t reserved;    // Live bytes plus shard quotas; never above the limit
+    size_t shard_batch;         // Quota a shard takes from `reserved` per refill
+    diram_space_shard_t shards[DIRAM_SPACE_SHARDS];
 } diram_memory_space_t;
 
 // Telemetry Event Structure
@@ -69,14 +82,22 @@ typedef struct {
     char receipt[DIRAM_SHA256_HEX_LEN];
 } diram_telemetry_event_t;
 
-// Global Error Index
+// Global Error Index: a lock-free ring of unformatted records
+// (error_index.c). Arguments are captured raw and formatted only when the
+// index is read; repeats of a call site within the suppression window are
+// counted instead of stored. Formats must be string literals.
+#define DIRAM_ERROR_RING_SLOTS 1024
+#define DIRAM_ERROR_MAX_ARGS 8
+#define DIRAM_ERROR_STRING_BYTES 128     // %s arguments copied per record
+#define DIRAM_ERROR_SUPPRESS_WINDOW_MS 1000
+#define DIRAM_ERROR_WRITER_INTERVAL_MS 100
+
 typedef struct {
-    diram_error_context_t* errors;
-    size_t error_count;
-    size_t error_capacity;
-    pthread_mutex_t mutex;
-    FILE* error_log;
-} diram_error_index_t;
+    uint64_t recorded;    // Records published to the ring
+    uint64_t suppressed;  // Repeats folded into counts
+    uint64_t dropped;     // Slot still held by a writer a lap earlier
+    uint64_t logged;      // Lines written to the error log
+} diram_error_stats_t;
 
 // Enhanced Allocation with Error Tracking
 typedef struct {
@@ -92,8 +113,11 @@ int diram_error_index_init(void);
 void diram_error_index_shutdown(void);
 void diram_error_record(diram_error_code_t code, const char* fmt, ...);
 void diram_error_record_context(diram_error_context_t* ctx);
+// Latest record, formatted into a thread-local context; NULL if none
 const diram_error_context_t* diram_error_get_last(void);
+// Formats the ring oldest first; returns the number of records written
 int diram_error_dump_index(const char* filename);
+void diram_error_get_stats(diram_error_stats_t* stats);
 
 // Memory Space Management
 diram_memory_space_t* diram_space_create(const char* name, size_t limit);
@@ -102,11 +126,25 @@ int diram_space_bind_allocation(diram_memory_space_t* space,
                                 diram_enhanced_allocation_t* alloc);
 int diram_space_check_limit(diram_memory_space_t* space, size_t requested);
 
+// Charge/uncharge bytes and allocations against the space. Charges come out
+// of the calling CPU's pre-reserved quota; near the limit they fall back to
+// an exact CAS reservation, so the limit is never exceeded.
+int diram_space_charge(diram_memory_space_t* space, size_t bytes, uint32_t count);
+void diram_space_uncharge(diram_memory_space_t* space, size_t bytes, uint32_t count);
+
+// Reconcile the shards and refresh used_bytes/allocation_count
+void diram_space_get_usage(diram_memory_space_t* space, size_t* used, uint32_t* count);
+
 // Enhanced Allocation API
 diram_enhanced_allocation_t* diram_alloc_enhanced(size_t size, 
                                                    const char* tag,
                                                    diram_memory_space_t* space);
 void diram_free_enhanced(diram_enhanced_allocation_t* alloc);
+// Burst variant: one region, one heap event, one space update and one
+// ALLOC_RANGE trace record; members are freed with diram_free_enhanced
+int diram_alloc_enhanced_batch(size_t n, const size_t* sizes, const char* tag,
+                               diram_memory_space_t* space,
+                               diram_enhanced_allocation_t** out);
 int diram_verify_receipt(diram_enhanced_allocation_t* alloc);
 
 // Telemetry API
@@ -159,4 +197,4 @@ typedef struct {
 int diram_governance_check(void);
 const diram_governance_stats_t* diram_governance_get_stats(void);
 
-#endif // DIRAM_FEATURE_ALLOC_ENHANCED_H
\ No newline at end of file
+#endif // DIRAM_FEATURE_ALLOC_ENHANCED_H
\ No newline at end of file
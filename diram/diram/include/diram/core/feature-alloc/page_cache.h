@@ -0,0 +1,58 @@
+// include/diram/core/feature-alloc/page_cache.h
+// mmap-backed page regions for large and guarded allocations
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_PAGE_CACHE_H
+#define DIRAM_PAGE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bodies up to this many pages come in size classes (1, 2, 3, 4, 6, 8, ...)
+// and are recycled; larger bodies are mapped exactly and unmapped on free
+#define DIRAM_PAGE_CACHE_MAX_PAGES 256
+#define DIRAM_PAGE_CACHE_CLASS_COUNT 16
+#define DIRAM_PAGE_CACHE_DEPTH 16                       // Cached regions per class
+#define DIRAM_PAGE_CACHE_MAX_BYTES (16 * 1024 * 1024)   // Across all classes
+
+#define DIRAM_HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+typedef enum {
+    DIRAM_HUGEPAGE_OFF = 0,
+    DIRAM_HUGEPAGE_THP = 1,         // madvise(MADV_HUGEPAGE) on large bodies
+    DIRAM_HUGEPAGE_HUGETLB = 2      // MAP_HUGETLB, falling back to THP
+} diram_hugepage_mode_t;
+
+typedef struct {
+    uint64_t regions_mapped;
+    uint64_t regions_unmapped;
+    uint64_t cache_hits;        // Regions reused without a syscall
+    uint64_t cache_puts;
+    uint64_t bytes_cached;
+    uint64_t hugetlb_maps;
+    uint64_t hugetlb_fallbacks; // MAP_HUGETLB refused (no reserved pool)
+} diram_page_cache_stats_t;
+
+size_t diram_page_size(void);
+
+// Body pages to map for `bytes`: class-rounded when cacheable, rounded to
+// whole huge pages for unguarded hugetlb-sized requests. 0 if too large.
+size_t diram_page_cache_round(size_t bytes, int guarded);
+
+// A page-aligned body of `pages` pages (as returned by diram_page_cache_round).
+// Guarded bodies sit between two PROT_NONE pages that stay in place while
+// the region is cached, so reuse costs no mmap/mprotect.
+void* diram_page_cache_get(size_t pages, int guarded);
+void diram_page_cache_put(void* body, size_t pages, int guarded);
+
+// Unmap every cached region
+void diram_page_cache_trim(void);
+
+// Parse "off", "thp" or "hugetlb"
+int diram_hugepage_mode_from_string(const char* value, diram_hugepage_mode_t* out);
+void diram_page_cache_set_hugepage_mode(diram_hugepage_mode_t mode);
+diram_hugepage_mode_t diram_page_cache_get_hugepage_mode(void);
+
+void diram_page_cache_get_stats(diram_page_cache_stats_t* out);
+
+#endif // DIRAM_PAGE_CACHE_H
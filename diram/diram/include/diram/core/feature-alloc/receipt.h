@@ -0,0 +1,75 @@
+// include/diram/core/feature-alloc/receipt.h
+// Allocation receipt hashing: SHA-256 with CPU dispatch, keyed fast mode
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_RECEIPT_H
+#define DIRAM_RECEIPT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DIRAM_SHA256_DIGEST_LEN 32
+#define DIRAM_SHA256_LANES 8
+
+typedef enum {
+    DIRAM_RECEIPT_SHA256 = 0,   // Full SHA-256, 64 hex chars (default)
+    DIRAM_RECEIPT_SIPHASH = 1   // SipHash-2-4-128 keyed per process, 32 hex chars
+} diram_receipt_mode_t;
+
+typedef enum {
+    DIRAM_SHA256_IMPL_SCALAR = 0,
+    DIRAM_SHA256_IMPL_SHANI,    // x86 SHA extensions
+    DIRAM_SHA256_IMPL_ARMV8,    // ARMv8 crypto extensions
+    DIRAM_SHA256_IMPL_AVX2      // 8-lane multi-buffer (batch hashing only)
+} diram_sha256_impl_t;
+
+// Receipt hex length per mode (without the NUL)
+#define DIRAM_RECEIPT_SHA256_HEX 64
+#define DIRAM_RECEIPT_SIPHASH_HEX 32
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t total_len;
+    uint8_t buf[64];
+    size_t buf_len;
+} diram_sha256_ctx_t;
+
+// SHA-256 (dispatched once on first use)
+void diram_sha256(const void* data, size_t len, uint8_t digest[DIRAM_SHA256_DIGEST_LEN]);
+
+// Streaming SHA-256 for inputs assembled piecewise
+void diram_sha256_init(diram_sha256_ctx_t* ctx);
+void diram_sha256_update(diram_sha256_ctx_t* ctx, const void* data, size_t len);
+void diram_sha256_final(diram_sha256_ctx_t* ctx, uint8_t digest[DIRAM_SHA256_DIGEST_LEN]);
+
+// Hash eight equal-length messages at once; uses the AVX2 multi-buffer
+// kernel when no single-message instruction is available
+void diram_sha256_x8(const void* const data[DIRAM_SHA256_LANES], size_t len,
+                     uint8_t digests[DIRAM_SHA256_LANES][DIRAM_SHA256_DIGEST_LEN]);
+
+diram_sha256_impl_t diram_sha256_get_impl(void);
+diram_sha256_impl_t diram_sha256_get_batch_impl(void);
+const char* diram_sha256_impl_name(diram_sha256_impl_t impl);
+
+// Force a kernel (testing/benchmarking); returns -1 if the CPU lacks it
+int diram_sha256_force_impl(diram_sha256_impl_t impl);
+
+// Receipt mode (process-wide)
+void diram_receipt_set_mode(diram_receipt_mode_t mode);
+diram_receipt_mode_t diram_receipt_get_mode(void);
+int diram_receipt_mode_from_string(const char* name, diram_receipt_mode_t* mode);
+
+// Hash receipt input into a NUL-terminated hex receipt (out must hold 65 bytes)
+void diram_receipt_hex(const void* input, size_t len, char* out);
+
+// Hash up to DIRAM_SHA256_LANES equal-length receipt inputs in one pass
+void diram_receipt_hex_lanes(const void* const inputs[DIRAM_SHA256_LANES], size_t count,
+                             size_t len, char* const out[DIRAM_SHA256_LANES]);
+
+// Lowercase hex encoding; out must hold 2 * len + 1 bytes
+void diram_hex_encode(const uint8_t* bytes, size_t len, char* out);
+
+// SipHash-2-4 with 128-bit output and the per-process key
+void diram_siphash128(const void* data, size_t len, uint8_t out[16]);
+
+#endif // DIRAM_RECEIPT_H
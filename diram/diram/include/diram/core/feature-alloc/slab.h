@@ -0,0 +1,58 @@
+// include/diram/core/feature-alloc/slab.h
+// Size-class slab backend for traced allocations
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_SLAB_H
+#define DIRAM_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Size classes run 64, 96, 128, 192, ... 48K, 64K (two classes per power of two).
+// Requests above the largest class, and guarded requests, are served from
+// mmap-backed page regions (see page_cache.h) but keep the same block header
+// so callers free them the same way.
+#define DIRAM_SLAB_MIN_CLASS 64
+#define DIRAM_SLAB_MAX_CLASS 65536
+#define DIRAM_SLAB_CLASS_COUNT 21
+#define DIRAM_SLAB_LARGE_CLASS 0xFF
+#define DIRAM_SLAB_GUARD_CLASS 0xFE
+
+// Slab chunk carved by pointer bump (at least 8 blocks per chunk)
+#define DIRAM_SLAB_CHUNK_SIZE (256 * 1024)
+
+// Per-thread magazine depth; a magazine holding twice this many free blocks
+// returns half of them to the shared depot
+#define DIRAM_SLAB_MAGAZINE_SIZE 32
+
+// Alignment guaranteed for every pointer returned by diram_slab_alloc
+#define DIRAM_SLAB_ALIGN 16
+#define DIRAM_SLAB_ALIGN_UP(n) (((n) + (DIRAM_SLAB_ALIGN - 1)) & ~(size_t)(DIRAM_SLAB_ALIGN - 1))
+
+typedef struct {
+    uint64_t chunks_mapped;    // Slab chunks obtained from the system
+    uint64_t bytes_mapped;     // Total bytes held by slab chunks
+    uint64_t bump_allocs;      // Blocks carved from a fresh chunk
+    uint64_t magazine_hits;    // Blocks reused from a thread magazine
+    uint64_t depot_refills;    // Magazine refills from the shared depot
+    uint64_t depot_flushes;    // Magazine overflows returned to the depot
+    uint64_t large_allocs;     // Requests above DIRAM_SLAB_MAX_CLASS
+    uint64_t guarded_allocs;   // Blocks placed against a trailing guard page
+} diram_slab_stats_t;
+
+// Slab API
+void* diram_slab_alloc(size_t size);
+
+// Page-backed block whose end abuts a PROT_NONE page, so a linear overrun
+// faults at once; freed with diram_slab_free like any slab block
+void* diram_slab_alloc_guarded(size_t size);
+void diram_slab_free(void* ptr);
+size_t diram_slab_usable_size(const void* ptr);
+int diram_slab_class_for(size_t size);
+size_t diram_slab_class_size(int size_class);
+
+// Return the calling thread's magazine to the depot (also runs at thread exit)
+void diram_slab_thread_flush(void);
+void diram_slab_get_stats(diram_slab_stats_t* out);
+
+#endif // DIRAM_SLAB_H
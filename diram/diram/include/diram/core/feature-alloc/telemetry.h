@@ -0,0 +1,60 @@
+// include/diram/core/feature-alloc/telemetry.h
+// Buffered, sampled telemetry export for diram_telemetry_emit
+// OBINexus Project - Directed Instruction RAM
+//
+// The emit/init/flush/shutdown entry points are declared in feature_alloc.h;
+// this header adds the wire format, sampling controls and counters.
+
+#ifndef DIRAM_TELEMETRY_H
+#define DIRAM_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DIRAM_TELEMETRY_WIRE_VERSION 1
+
+// Per-thread ring slots (power of two); a full ring drops, it never blocks
+#define DIRAM_TELEMETRY_RING_SLOTS 256
+
+// Exporter wakes at least this often; one datagram carries up to this many bytes
+#define DIRAM_TELEMETRY_EXPORT_INTERVAL_MS 50
+#define DIRAM_TELEMETRY_DATAGRAM_MAX 8192
+
+#define DIRAM_TELEMETRY_OP_LEN 16
+#define DIRAM_TELEMETRY_RECEIPT_LEN 64
+
+// One exported event: 128 bytes, little-endian, length-prefixed so a
+// datagram is simply a run of records back to back
+typedef struct {
+    uint16_t length;                // Bytes in this record, prefix included
+    uint8_t version;
+    uint8_t layer;                  // 1=system, 2=opcode-bound
+    uint32_t error_code;
+    uint64_t event_id;
+    uint64_t timestamp_ns;          // CLOCK_REALTIME
+    uint64_t address;
+    uint64_t size;
+    int32_t pid;
+    uint32_t sequence;              // Per-thread, so gaps show drops
+    char operation[DIRAM_TELEMETRY_OP_LEN];         // NUL-padded
+    char receipt[DIRAM_TELEMETRY_RECEIPT_LEN];      // Hex, not NUL-terminated
+} diram_telemetry_wire_t;
+
+typedef struct {
+    uint64_t emitted;               // Calls that passed the level filter
+    uint64_t sampled_out;           // Rejected by head/tail sampling
+    uint64_t dropped;               // Ring full; exporter fell behind
+    uint64_t exported;              // Records handed to the endpoint
+    uint64_t datagrams;
+    uint64_t send_errors;           // Records lost to a failed send
+    uint64_t rings_active;
+} diram_telemetry_stats_t;
+
+// Head sampling applies to routine events, tail sampling to events that
+// carry an error code; both are probabilities in [0, 1]. The layer filter
+// is diram_feature_config_t.telemetry_level.
+void diram_telemetry_set_sampling(double head_rate, double tail_rate);
+
+void diram_telemetry_get_stats(diram_telemetry_stats_t* out);
+
+#endif // DIRAM_TELEMETRY_H
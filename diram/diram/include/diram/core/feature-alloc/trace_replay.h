@@ -0,0 +1,51 @@
+// include/diram/core/feature-alloc/trace_replay.h
+// Replay a captured allocation trace through the traced allocator
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_TRACE_REPLAY_H
+#define DIRAM_TRACE_REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Either trace format is accepted (text alloc_trace.log or binary
+// alloc_trace.bin, told apart by the magic). Records are loaded first and
+// put back in timestamp order, since per-thread rings reach the file out
+// of order. Each ALLOC runs as its own command epoch, so the heap-event
+// constraint does not throttle the replay. FREEs are matched to earlier
+// ALLOCs by their original address; batch members are matched to their
+// ALLOC_RANGE by address span and replayed at the mean member size.
+typedef enum {
+    DIRAM_REPLAY_FULL_SPEED = 0,
+    DIRAM_REPLAY_ORIGINAL_TIMING    // Sleep to reproduce the captured gaps
+} diram_replay_timing_t;
+
+typedef struct {
+    uint64_t records;               // ALLOC, ALLOC_RANGE and FREE records loaded
+    uint64_t allocs;                // Allocations replayed (range members count)
+    uint64_t frees;
+    uint64_t failed_allocs;         // Refused by the allocator
+    uint64_t unmatched_frees;       // No replayed ALLOC (trace began mid-stream)
+    uint64_t live_at_end;           // Never freed in the trace; released after
+    uint64_t bytes_allocated;
+    uint64_t elapsed_ns;            // Replay only, not loading
+    double ops_per_sec;             // (allocs + frees) / elapsed
+
+    // Footprint at the moment live payload peaked
+    uint64_t peak_live_bytes;       // Payload
+    uint64_t peak_block_bytes;      // Blocks holding it: payload + tracker + rounding
+    uint64_t peak_mapped_bytes;     // Slab chunks mapped during replay + large blocks
+    double internal_fragmentation;  // 1 - live / block
+    double external_fragmentation;  // 1 - block / mapped
+
+    long start_rss_kb;
+    long peak_rss_kb;               // Process high-water mark (getrusage)
+} diram_replay_stats_t;
+
+// Returns 0 and fills stats, or -1 if path cannot be read or parsed
+int diram_trace_replay(const char* path, diram_replay_timing_t timing,
+                       diram_replay_stats_t* stats);
+void diram_replay_print_stats(const diram_replay_stats_t* stats, FILE* out);
+
+#endif // DIRAM_TRACE_REPLAY_H
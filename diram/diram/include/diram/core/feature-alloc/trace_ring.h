@@ -0,0 +1,85 @@
+// include/diram/core/feature-alloc/trace_ring.h
+// Per-thread lock-free trace rings drained by a background writer
+// OBINexus Project - Directed Instruction RAM
+
+#ifndef DIRAM_TRACE_RING_H
+#define DIRAM_TRACE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define DIRAM_TRACE_BIN_PATH "logs/alloc_trace.bin"
+#define DIRAM_TRACE_BIN_MAGIC "DIRAMTRC"
+#define DIRAM_TRACE_BIN_VERSION 2
+
+// Slots per producer thread (power of two)
+#define DIRAM_TRACE_RING_SLOTS 256
+
+// Writer wakes at least this often even without a producer signal
+#define DIRAM_TRACE_WRITER_INTERVAL_MS 5
+
+#define DIRAM_TRACE_RECEIPT_LEN 64
+#define DIRAM_TRACE_TAG_LEN 24
+
+typedef enum {
+    DIRAM_TRACE_FORMAT_TEXT = 0,   // TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG[|COUNT]
+    DIRAM_TRACE_FORMAT_BINARY = 1  // Header + fixed-size diram_trace_record_t
+} diram_trace_format_t;
+
+typedef enum {
+    DIRAM_TRACE_OP_ALLOC = 1,
+    DIRAM_TRACE_OP_FREE = 2,
+    DIRAM_TRACE_OP_ALLOC_RANGE = 3  // diram_alloc_batch: one record for count allocations
+} diram_trace_op_t;
+
+// Fixed-size binary trace record (128 bytes, also the on-disk layout)
+typedef struct {
+    uint64_t timestamp;
+    uint64_t address;
+    uint64_t size;                          // Total payload bytes for range records
+    uint64_t count;                         // Allocations covered (1 unless a range)
+    int32_t pid;
+    uint8_t operation;
+    uint8_t reserved[3];
+    char receipt[DIRAM_TRACE_RECEIPT_LEN];  // Hex digest, not NUL-terminated
+    char tag[DIRAM_TRACE_TAG_LEN];          // NUL-padded, truncated
+} diram_trace_record_t;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} diram_trace_file_header_t;
+
+typedef struct {
+    uint64_t records_written;
+    uint64_t batches_written;
+    uint64_t producer_stalls;   // Pushes that waited for the writer
+    uint64_t rings_active;
+} diram_trace_stats_t;
+
+// Writer lifecycle (called from diram_init_trace_log / diram_close_trace_log)
+int diram_trace_ring_start(diram_trace_format_t format, const char* path);
+void diram_trace_ring_stop(void);
+int diram_trace_ring_active(void);
+
+// Producer side: copy one record into the calling thread's ring
+int diram_trace_ring_push(const diram_trace_record_t* record);
+
+// Block until every record pushed before the call has reached the file
+int diram_trace_ring_flush(void);
+
+void diram_trace_ring_get_stats(diram_trace_stats_t* out);
+
+// Record helpers
+void diram_trace_record_fill(diram_trace_record_t* record, diram_trace_op_t op,
+                             uint64_t timestamp, pid_t pid, const void* address,
+                             size_t size, const char* receipt, const char* tag);
+int diram_trace_record_format(const diram_trace_record_t* record,
+                              char* out, size_t out_len);
+
+// Convert a binary trace file to the text trace format ("-" writes stdout)
+int diram_trace_convert_binary(const char* binary_path, const char* text_path);
+
+#endif // DIRAM_TRACE_RING_H
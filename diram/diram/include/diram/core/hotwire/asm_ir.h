@@ -0,0 +1,64 @@
+// include/diram/core/hotwire/asm_ir.h
+// DIRAM Hotwire instruction IR and peephole passes for the ASM target
+// OBINexus Aegis Project
+//
+// With optimization on, the asm emitters append to this IR instead of
+// writing text. The transform runs the passes over the whole program, then
+// renders the surviving entries through the same emitters, so output
+// without any rewrite is identical to the unoptimized path.
+
+#ifndef DIRAM_ASM_IR_H
+#define DIRAM_ASM_IR_H
+
+#include "hotwire.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef enum {
+    HOTWIRE_IR_INSN,
+    HOTWIRE_IR_LABEL,
+    HOTWIRE_IR_DIRECTIVE
+} diram_hotwire_ir_kind_t;
+
+// Strings live in the IR's pool; offset 0 is the empty/absent string
+typedef struct {
+    diram_hotwire_ir_kind_t kind;
+    diram_asm_mnemonic_t mnemonic;
+    uint32_t operand1;          // Label or directive text for non-instructions
+    uint32_t operand2;
+    bool dead;                  // Removed by a pass
+} diram_hotwire_ir_entry_t;
+
+struct diram_hotwire_ir {
+    diram_hotwire_ir_entry_t* entries;
+    size_t count;
+    size_t capacity;
+    char* pool;
+    size_t pool_size;
+    size_t pool_capacity;
+    uint32_t batch_counter;     // Names the alloc-batch data tables
+    bool failed;                // A grow failed; render reports it
+};
+
+diram_hotwire_ir_t* diram_hotwire_ir_create(void);
+void diram_hotwire_ir_destroy(diram_hotwire_ir_t* ir);
+void diram_hotwire_ir_reset(diram_hotwire_ir_t* ir);
+
+void diram_hotwire_ir_append(diram_hotwire_ir_t* ir, diram_hotwire_ir_kind_t kind,
+                             diram_asm_mnemonic_t mnemonic,
+                             const char* operand1, const char* operand2);
+void diram_hotwire_ir_splice(diram_hotwire_ir_t* dst, const diram_hotwire_ir_t* src);
+
+// Passes, in order:
+//   constraint-fusion  drop a constraint check identical to the one just made
+//   feature-hoist      keep the first feature check of a straight-line run
+//   alloc-batch        turn adjacent allocations into one diram_alloc_batch
+// Fills stats[0..n-1] with live instruction counts around each pass.
+size_t diram_hotwire_ir_optimize(diram_hotwire_ir_t* ir,
+                                 diram_hotwire_pass_stats_t* stats, size_t max_stats);
+
+// Write the live entries to context's output as asm text
+bool diram_hotwire_ir_render(diram_hotwire_ir_t* ir, diram_hotwire_context_t* context);
+
+#endif // DIRAM_ASM_IR_H
@@ -8,13 +8,16 @@
 #include "../parser/ast.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Target Platform Enumeration
 typedef enum {
     HOTWIRE_TARGET_NATIVE_ASM,     // x86_64 Assembly
     HOTWIRE_TARGET_WASM,           // WebAssembly
     HOTWIRE_TARGET_LLVM_IR,        // LLVM IR (future)
-    HOTWIRE_TARGET_RISCV           // RISC-V Assembly (future)
+    HOTWIRE_TARGET_RISCV,          // RISC-V Assembly (future)
+    HOTWIRE_TARGET_WASM_BINARY,    // WebAssembly binary module (wasm_binary.h)
+    HOTWIRE_TARGET_NATIVE_JIT      // In-process x86_64 machine code (jit.h)
 } diram_hotwire_target_t;
 
 // Feature Toggle State
@@ -37,6 +40,17 @@ typedef struct {
     void (*policy_violation)(const char* feature_name, const char* reason);
 } diram_hotwire_table_t;
 
+// Instruction counts around one optimization pass
+typedef struct {
+    const char* name;
+    uint32_t before;
+    uint32_t after;
+} diram_hotwire_pass_stats_t;
+
+#define HOTWIRE_MAX_PASSES 4
+
+typedef struct diram_hotwire_ir diram_hotwire_ir_t;    // asm_ir.h
+
 // Hotwire Transformer Context
 typedef struct {
     diram_hotwire_target_t target;
@@ -66,6 +80,15 @@ typedef struct {
     uint32_t current_offset;
     uint32_t label_counter;
     bool in_function;
+    bool parallel;              // Lower independent subtrees on the async pool
+    
+    // Peephole optimization (ASM target): emitters record into ir, and the
+    // transform fills pass_stats before rendering. The JIT target always
+    // records, and keeps ir for diram_hotwire_jit_compile.
+    bool optimize;
+    diram_hotwire_ir_t* ir;
+    diram_hotwire_pass_stats_t pass_stats[HOTWIRE_MAX_PASSES];
+    uint32_t pass_count;
     
     // Error handling
     bool has_error;
@@ -102,6 +125,19 @@ bool diram_hotwire_activate_feature(diram_hotwire_context_t* context,
 bool diram_hotwire_transform(diram_hotwire_context_t* context,
                             diram_ast_node_t* ast_root);
 
+// Parallel mode: runs of top-level MEMORY_REGION, POLICY and FEATURE_TOGGLE
+// subtrees, up to this many per task, are lowered on the async pool into
+// their own buffers and spliced back in order, so the output is identical
+// to the serial transform. Other nodes still lower on the calling thread,
+// in order, since they read the feature table. Text targets only; the
+// binary WASM target always lowers serially.
+#define HOTWIRE_PARALLEL_CHUNK 32
+void diram_hotwire_set_parallel(diram_hotwire_context_t* context, bool enabled);
+
+// Route ASM emission through the instruction IR and its peephole passes
+// (asm_ir.h); pass_stats reports the instruction count reduction per pass
+void diram_hotwire_set_optimize(diram_hotwire_context_t* context, bool enabled);
+
 // Platform-Specific Visitors
 diram_ast_visitor_t* diram_hotwire_create_asm_visitor(diram_hotwire_context_t* context);
 diram_ast_visitor_t* diram_hotwire_create_wasm_visitor(diram_hotwire_context_t* context);
@@ -114,7 +150,7 @@ void diram_hotwire_emit_asm_instruction(diram_hotwire_context_t* context,
 void diram_hotwire_emit_asm_label(diram_hotwire_context_t* context,
                                   const char* label);
 void diram_hotwire_emit_asm_directive(diram_hotwire_context_t* context,
-                                      const char* directive);
+                                      const char* format, ...);
 
 // WebAssembly Target Emission
 void diram_hotwire_emit_wasm_instruction(diram_hotwire_context_t* context,
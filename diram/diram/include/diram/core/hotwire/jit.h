@@ -0,0 +1,60 @@
+// include/diram/core/hotwire/jit.h
+// DIRAM Hotwire in-process JIT
+// OBINexus Aegis Project
+//
+// HOTWIRE_TARGET_NATIVE_JIT lowers through the asm visitor into the
+// instruction IR (asm_ir.h), running the peephole passes when optimize is
+// set, and keeps the IR instead of rendering text. diram_hotwire_jit_compile
+// then encodes it straight to x86-64 machine code: written into an
+// anonymous mapping, flipped to read+execute before it is handed out, so
+// no page is ever writable and executable at once. Data directives
+// (.quad/.zero tables, alloc-batch buffers) get their own read-write
+// mapping.
+//
+// The generated function runs the program top to bottom:
+//   - mov reg, imm and mov reg, OFFSET label load the register
+//   - call name calls the symbol table's function with the current
+//     rdi, rsi, rdx, rcx and the env pointer passed to the entry
+//   - jz tests the last call's 64-bit result
+//   - load/store move a register to or from a data label (+ offset)
+//   - jumps to a label the program never defines, and trap, leave the
+//     function through a numbered exit
+// It returns 0 when the program runs off its end or hits ret, otherwise
+// the exit number; diram_hotwire_jit_exit_name names it
+// (".constraint_violation", ".feature_disabled", "trap").
+
+#ifndef DIRAM_JIT_H
+#define DIRAM_JIT_H
+
+#include "hotwire.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// What a call instruction lands on: the argument registers and env
+typedef int64_t (*diram_hotwire_jit_fn_t)(uint64_t rdi, uint64_t rsi,
+                                          uint64_t rdx, uint64_t rcx, void* env);
+
+typedef struct {
+    const char* name;           // As the visitor emits it, e.g. "diram_check_constraint"
+    diram_hotwire_jit_fn_t fn;
+} diram_hotwire_jit_symbol_t;
+
+// The compiled policy check
+typedef int (*diram_hotwire_jit_entry_t)(void* env);
+
+typedef struct diram_hotwire_jit diram_hotwire_jit_t;
+
+// Encode the IR a HOTWIRE_TARGET_NATIVE_JIT transform left in context.
+// Every called name must be in symbols. Returns NULL with context's error
+// set for an unknown symbol, an instruction the JIT cannot place (stores to
+// absolute addresses, ALLOC/FREE), or an unsupported host.
+diram_hotwire_jit_t* diram_hotwire_jit_compile(diram_hotwire_context_t* context,
+                                               const diram_hotwire_jit_symbol_t* symbols,
+                                               size_t symbol_count);
+void diram_hotwire_jit_destroy(diram_hotwire_jit_t* jit);
+
+diram_hotwire_jit_entry_t diram_hotwire_jit_entry(const diram_hotwire_jit_t* jit);
+const char* diram_hotwire_jit_exit_name(const diram_hotwire_jit_t* jit, int exit_code);
+size_t diram_hotwire_jit_code_size(const diram_hotwire_jit_t* jit);
+
+#endif // DIRAM_JIT_H
@@ -0,0 +1,114 @@
+// include/diram/core/hotwire/snapshot.h
+// DIRAM compiled manifest snapshots
+// OBINexus Aegis Project
+//
+// A snapshot holds one parsed manifest and its hotwire output, keyed by
+// the SHA-256 of the source. It is position independent, so opening one
+// is a read-only mmap plus a validation pass: nothing is tokenized,
+// parsed or transformed. Nodes mirror the compacted AST arena, so the
+// children of node i are nodes[first_child .. first_child + child_count).
+
+#ifndef DIRAM_SNAPSHOT_H
+#define DIRAM_SNAPSHOT_H
+
+#include "hotwire.h"
+#include "diram/core/parser/ast.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define DIRAM_SNAPSHOT_MAGIC "DRCSNAP"        // 8 bytes with the NUL
+#define DIRAM_SNAPSHOT_VERSION 1
+#define DIRAM_SNAPSHOT_BYTE_ORDER 0x01020304u
+#define DIRAM_SNAPSHOT_SUFFIX ".snap"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // Snapshots are not portable across endianness
+    uint32_t header_size;
+    uint32_t node_size;         // Guards against record layout changes
+    uint8_t source_hash[32];    // SHA-256 of the manifest source
+    uint32_t target;            // diram_hotwire_target_t of the output
+    uint32_t reserved;
+    uint64_t file_size;
+    uint64_t node_count, nodes_offset;
+    uint64_t link_count, links_offset;
+    uint64_t strings_size, strings_offset;
+    uint64_t output_size, output_offset;
+    uint64_t checksum;          // Over everything after the header
+} diram_snapshot_header_t;
+
+// One AST node. Strings are offsets into the string table, 0 for none.
+// Links are node indices (opcode operands) or string offsets (policy rules).
+//   FEATURE_TOGGLE  name, text1 description, text2 policy, flags enabled
+//   OPCODE          name, value1 code, links operands
+//   OPERAND         name, text1 type, value1 position
+//   CONSTRAINT      name, real epsilon, value1 max heap events
+//   POLICY          name, text1 type, flags enforced, links rules
+//   MEMORY_REGION   name, value1 base, value2 size, flags protection
+//   BUILD_TARGET    name, text1 platform, text2 compiler, text3 flags
+//   ALLOCATION      name tag, text1 receipt, value1 size, value2 address
+typedef struct {
+    uint32_t type;
+    uint32_t parent;
+    uint32_t first_child;
+    uint32_t child_count;
+    uint32_t first_link;
+    uint32_t link_count;
+    uint32_t name, text1, text2, text3;
+    uint64_t value1, value2;
+    double real;
+    uint32_t flags;
+    uint32_t reserved;
+} diram_snapshot_node_t;
+
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    bool mapped;                // Else base is a heap image we own
+    const diram_snapshot_header_t* header;
+    const diram_snapshot_node_t* nodes;
+    const uint32_t* links;
+    const char* strings;
+} diram_snapshot_t;
+
+typedef enum {
+    DIRAM_SNAPSHOT_HIT,         // Valid snapshot for this source was mapped
+    DIRAM_SNAPSHOT_REBUILT,     // Compiled and saved
+    DIRAM_SNAPSHOT_UNSAVED      // Compiled; could not be saved, kept in memory
+} diram_snapshot_status_t;
+
+// Map the manifest's snapshot if it matches the source and target;
+// otherwise parse, transform, save (atomically) and return the result.
+// snapshot_path NULL means source_path + DIRAM_SNAPSHOT_SUFFIX.
+diram_snapshot_t* diram_snapshot_compile(const char* source_path, const char* snapshot_path,
+                                         diram_hotwire_target_t target,
+                                         diram_snapshot_status_t* status);
+
+// Map and validate a snapshot file; NULL if missing, corrupt or stale
+diram_snapshot_t* diram_snapshot_open(const char* path);
+bool diram_snapshot_matches(const diram_snapshot_t* snapshot, const uint8_t source_hash[32],
+                            diram_hotwire_target_t target);
+void diram_snapshot_close(diram_snapshot_t* snapshot);
+
+// Serialize a compacted arena tree and its transform output. Returns 0 or -1.
+int diram_snapshot_write(const char* path, const uint8_t source_hash[32],
+                         const diram_ast_node_t* root,
+                         const diram_hotwire_context_t* context);
+
+// Accessors
+const char* diram_snapshot_string(const diram_snapshot_t* snapshot, uint32_t offset);
+const uint8_t* diram_snapshot_output(const diram_snapshot_t* snapshot, size_t* size);
+const diram_snapshot_node_t* diram_snapshot_find(const diram_snapshot_t* snapshot,
+                                                 diram_ast_node_type_t type, const char* name);
+
+// Rebuild the tree in arena. Its strings point into the snapshot, which
+// must stay open while the tree is used.
+diram_ast_node_t* diram_snapshot_load_tree(const diram_snapshot_t* snapshot,
+                                           diram_ast_arena_t* arena);
+
+// Why the last call on this thread returned NULL or -1
+const char* diram_snapshot_error(void);
+
+#endif // DIRAM_SNAPSHOT_H
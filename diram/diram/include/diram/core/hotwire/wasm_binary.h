@@ -0,0 +1,73 @@
+// include/diram/core/hotwire/wasm_binary.h
+// DIRAM Hotwire binary WebAssembly encoder
+// OBINexus Aegis Project
+//
+// HOTWIRE_TARGET_WASM_BINARY writes a loadable .wasm module directly: the
+// visitor encodes opcodes and LEB128 immediates into a growable byte
+// buffer, and finishing the visitor lays out the sections around them.
+// Nothing is formatted as text and nothing goes through wat2wasm.
+
+#ifndef DIRAM_WASM_BINARY_H
+#define DIRAM_WASM_BINARY_H
+
+#include "hotwire.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Growable byte buffer; a failed grow sticks so callers check once at the end
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} diram_wasm_buffer_t;
+
+void diram_wasm_buffer_free(diram_wasm_buffer_t* buffer);
+void diram_wasm_emit_byte(diram_wasm_buffer_t* buffer, uint8_t byte);
+void diram_wasm_emit_bytes(diram_wasm_buffer_t* buffer, const void* bytes, size_t length);
+void diram_wasm_emit_u32(diram_wasm_buffer_t* buffer, uint32_t value);     // Unsigned LEB128
+void diram_wasm_emit_i32(diram_wasm_buffer_t* buffer, int32_t value);      // Signed LEB128
+void diram_wasm_emit_name(diram_wasm_buffer_t* buffer, const char* name);  // Length-prefixed UTF-8
+
+// Module layout
+#define DIRAM_WASM_MAGIC "\0asm"
+#define DIRAM_WASM_VERSION 1
+
+typedef enum {
+    WASM_SECTION_TYPE = 1,
+    WASM_SECTION_IMPORT = 2,
+    WASM_SECTION_FUNCTION = 3,
+    WASM_SECTION_MEMORY = 5,
+    WASM_SECTION_GLOBAL = 6,
+    WASM_SECTION_EXPORT = 7,
+    WASM_SECTION_CODE = 10
+} diram_wasm_section_t;
+
+// Instructions the hotwire visitor emits
+typedef enum {
+    WASM_OP_UNREACHABLE = 0x00,
+    WASM_OP_BLOCK = 0x02,
+    WASM_OP_IF = 0x04,
+    WASM_OP_END = 0x0B,
+    WASM_OP_BR_IF = 0x0D,
+    WASM_OP_CALL = 0x10,
+    WASM_OP_DROP = 0x1A,
+    WASM_OP_LOCAL_GET = 0x20,
+    WASM_OP_LOCAL_SET = 0x21,
+    WASM_OP_I32_CONST = 0x41,
+    WASM_OP_I32_EQZ = 0x45
+} diram_wasm_opcode_t;
+
+#define WASM_TYPE_I32 0x7F
+#define WASM_TYPE_FUNC 0x60
+#define WASM_BLOCK_VOID 0x40
+
+// Create the binary visitor for context; emitted bytes stay in the visitor
+// until finish assembles the module into context->output_buffer
+// (output_size bytes, not NUL-terminated).
+diram_ast_visitor_t* diram_hotwire_create_wasm_binary_visitor(diram_hotwire_context_t* context);
+bool diram_hotwire_finish_wasm_binary(diram_ast_visitor_t* visitor);
+void diram_hotwire_destroy_wasm_binary_visitor(diram_ast_visitor_t* visitor);
+
+#endif // DIRAM_WASM_BINARY_H
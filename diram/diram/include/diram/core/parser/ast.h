@@ -12,6 +12,7 @@
 // Forward declarations
 typedef struct diram_ast_node diram_ast_node_t;
 typedef struct diram_ast_visitor diram_ast_visitor_t;
+typedef struct diram_ast_arena diram_ast_arena_t;
 
 // AST Node Types
 typedef enum {
@@ -114,6 +115,12 @@ struct diram_ast_node {
     size_t child_count;
     size_t child_capacity;
     
+    // Arena storage; NULL for individually allocated nodes. Once the
+    // arena is compacted, children are arena->nodes[first_child ..
+    // first_child + child_count) as well as children[].
+    diram_ast_arena_t* arena;
+    uint32_t first_child;
+    
     // Evaluation rule binding
     diram_evaluation_rule_t* rule;
     
@@ -121,6 +128,22 @@ struct diram_ast_node {
     void* (*accept)(struct diram_ast_node* self, diram_ast_visitor_t* visitor);
 };
 
+#define DIRAM_AST_NO_RANGE UINT32_MAX
+
+typedef struct diram_ast_block diram_ast_block_t;
+
+// Owns every node, array and string of one parse. Nodes are built in
+// blocks, then compaction lays the tree out breadth-first in one array
+// so each node's children are a contiguous index range. Destroying the
+// arena frees everything at once; individual nodes are never freed.
+struct diram_ast_arena {
+    diram_ast_block_t* node_blocks;    // Nodes built before compaction
+    diram_ast_block_t* data_blocks;    // Strings and pointer arrays
+    diram_ast_node_t* nodes;           // Compacted: breadth-first layout
+    size_t node_count;
+    diram_ast_node_t** links;          // Compacted children[]/operands[]
+};
+
 // Visitor Interface for Zero-Overhead Transformation
 struct diram_ast_visitor {
     // Visitor methods for each node type
@@ -138,10 +161,24 @@ struct diram_ast_visitor {
     void* context;
 };
 
-// AST Node Creation
+// AST Node Creation - destroy frees the subtree; arena nodes are left to
+// their arena
 diram_ast_node_t* diram_ast_create_node(diram_ast_node_type_t type);
 void diram_ast_destroy_node(diram_ast_node_t* node);
 
+// Arena
+diram_ast_arena_t* diram_ast_arena_create(void);
+void diram_ast_arena_destroy(diram_ast_arena_t* arena);
+diram_ast_node_t* diram_ast_arena_create_node(diram_ast_arena_t* arena, diram_ast_node_type_t type);
+void* diram_ast_arena_alloc(diram_ast_arena_t* arena, size_t size);
+
+// Room for one more item in an array of count items (capacity doubles at
+// powers of two). Arena arrays are copied, others realloc'd; NULL on failure.
+void* diram_ast_array_reserve(diram_ast_arena_t* arena, void* items, size_t count, size_t item_size);
+
+// Relayout the tree under *root breadth-first; *root moves to nodes[0]
+bool diram_ast_arena_compact(diram_ast_arena_t* arena, diram_ast_node_t** root);
+
 // Tree Operations
 bool diram_ast_add_child(diram_ast_node_t* parent, diram_ast_node_t* child);
 bool diram_ast_remove_child(diram_ast_node_t* parent, diram_ast_node_t* child);
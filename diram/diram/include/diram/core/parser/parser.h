@@ -23,6 +23,16 @@ typedef enum {
     PARSER_STATE_COMPLETE
 } diram_parser_state_t;
 
+#define DIRAM_PARSER_MAX_DEPTH 64
+
+// Open element on the parser stack; name is a view into the input
+typedef struct {
+    size_t name_offset;
+    size_t name_length;
+    int kind;                          // Element kind (parser.c)
+    diram_ast_node_t* node;            // Node the element builds, if any
+} diram_parser_frame_t;
+
 // Parser Context for Single-Pass Translation
 typedef struct {
     diram_tokenizer_t* tokenizer;      // Token source
@@ -30,6 +40,17 @@ typedef struct {
     diram_ast_node_t* root;           // AST root node
     diram_ast_node_t* current_node;   // Current AST node being built
     
+    // Zero-copy input: borrowed from the caller, or a read-only mapping
+    const char* input;
+    size_t input_length;
+    bool mapped;
+    
+    // Streaming state
+    diram_parser_frame_t stack[DIRAM_PARSER_MAX_DEPTH];
+    size_t depth;
+    diram_token_t pending_attribute;   // Name awaiting its value
+    diram_ast_arena_t* arena;          // Owns the tree and every string in it
+    
     // Parser configuration
     bool strict_mode;                  // Enforce strict XML compliance
     bool validate_policies;            // Validate policy constraints
@@ -46,7 +67,11 @@ typedef struct {
 } diram_parser_t;
 
 // Parser API - Single-Pass, Zero IR
+// The input is borrowed, not copied. create_from_file maps the file
+// read-only instead of reading it. The tree lives in the parser's arena,
+// compacted breadth-first once the parse completes; destroy frees both.
 diram_parser_t* diram_parser_create(const char* xml_input, size_t length);
+diram_parser_t* diram_parser_create_from_file(const char* filename);
 void diram_parser_destroy(diram_parser_t* parser);
 
 // Main parsing function - O(n) complexity, no backtracking
@@ -83,6 +83,12 @@ typedef struct {
     uint32_t line;
     uint32_t column;
     char* source_file;
+    
+    // Zero-copy view into the tokenizer input. Names, attribute values
+    // and text are never copied; string_value.data points at the same
+    // bytes and is not NUL-terminated.
+    size_t offset;
+    size_t length;
 } diram_token_t;
 
 // Tokenizer State Machine
@@ -92,6 +98,8 @@ typedef struct {
     size_t position;            // Current position
     uint32_t line;              // Current line number
     uint32_t column;            // Current column number
+    size_t line_scanned;        // Input counted for newlines so far
+    size_t line_start;          // Offset of the current line
     
     // State tracking
     bool in_element;
@@ -103,7 +111,8 @@ typedef struct {
     bool has_error;
 } diram_tokenizer_t;
 
-// Tokenizer API
+// Tokenizer API - the input is borrowed, not copied, and must outlive the
+// tokenizer
 diram_tokenizer_t* diram_tokenizer_create(const char* input, size_t length);
 void diram_tokenizer_destroy(diram_tokenizer_t* tokenizer);
 
@@ -112,6 +121,12 @@ diram_token_t diram_tokenizer_next(diram_tokenizer_t* tokenizer);
 bool diram_tokenizer_has_error(const diram_tokenizer_t* tokenizer);
 const char* diram_tokenizer_get_error(const diram_tokenizer_t* tokenizer);
 
+// Copy a view out as a string (truncates to size-1), for messages and lookups
+size_t diram_token_copy(const diram_tokenizer_t* tokenizer, const diram_token_t* token,
+                        char* out, size_t size);
+bool diram_token_equals(const diram_tokenizer_t* tokenizer, const diram_token_t* token,
+                        const char* text);
+
 // Token utilities
 const char* diram_token_type_to_string(diram_token_type_t type);
 const char* diram_token_memory_to_string(diram_token_memory_t memory);
@@ -19,8 +19,13 @@
 #include <ctype.h>
 #include <dirent.h>
 #include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/alloc_index.h"
+#include "diram/core/feature-alloc/trace_replay.h"
 #include "diram/core/feature-alloc/feature_alloc.h"
 #include "diram/core/config/config.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "diram/core/feature-alloc/page_cache.h"
+#include "diram/core/hotwire/snapshot.h"
 
 #ifndef PATH_MAX
 #define PATH_MAX 4096
@@ -35,6 +40,9 @@ static diram_config_t g_config = {
     .config_file = "",
     .detach_mode = 0,
     .trace_enabled = 0,
+    .trace_format = "text",
+    .receipt_mode = "sha256",
+    .hugepages = "off",
     .repl_mode = 0,
     .memory_limit = 0,
     .memory_space = "default",
@@ -42,20 +50,28 @@ static diram_config_t g_config = {
     .verbose = 0
 };
 
+// Compiled policy manifest (--manifest / manifest=), mapped from its snapshot
+static char g_manifest_path[PATH_MAX] = "";
+static char g_snapshot_path[PATH_MAX] = "";
+static diram_snapshot_t* g_manifest = NULL;
+static const char* g_manifest_status = "";
+
+// Trace replay (--replay)
+static char g_replay_path[PATH_MAX] = "";
+static diram_replay_timing_t g_replay_timing = DIRAM_REPLAY_FULL_SPEED;
 
 
-// Global structures for REPL state management
-typedef struct {
-    diram_allocation_t* alloc;
-    char tag[64];
-    void* address;
-} repl_allocation_t;
 
-#define MAX_REPL_ALLOCATIONS 1024
-static repl_allocation_t g_repl_allocations[MAX_REPL_ALLOCATIONS];
-static int g_repl_allocation_count = 0;
+// REPL state; live allocations are found through the library's address index
 static diram_memory_space_t* g_repl_memory_space = NULL;
 
+// Live allocations collected from the index, oldest first
+typedef struct {
+    diram_allocation_t** items;
+    size_t count;
+    size_t capacity;
+} repl_allocation_list_t;
+
 // Helper function to parse size with unit suffixes
 static size_t parse_size(const char* size_str) {
     char* endptr;
@@ -73,15 +89,34 @@ static size_t parse_size(const char* size_str) {
     return size;
 }
 
-// Helper function to find allocation by address
-static int find_allocation_by_address(void* addr) {
-    for (int i = 0; i < g_repl_allocation_count; i++) {
-        if (g_repl_allocations[i].alloc && 
-            g_repl_allocations[i].alloc->base_addr == addr) {
-            return i;
+static int collect_allocation(diram_allocation_t* alloc, void* context) {
+    repl_allocation_list_t* list = context;
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        diram_allocation_t** items = realloc(list->items, capacity * sizeof(*items));
+        if (!items) {
+            return 1;
         }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = alloc;
+    return 0;
+}
+
+static int compare_allocation_age(const void* a, const void* b) {
+    const diram_allocation_t* x = *(diram_allocation_t* const*)a;
+    const diram_allocation_t* y = *(diram_allocation_t* const*)b;
+    return (x->timestamp > y->timestamp) - (x->timestamp < y->timestamp);
+}
+
+// Snapshot of the index; the caller frees list->items
+static void collect_allocations(repl_allocation_list_t* list) {
+    memset(list, 0, sizeof(*list));
+    diram_alloc_foreach(collect_allocation, list);
+    if (list->count > 1) {
+        qsort(list->items, list->count, sizeof(*list->items), compare_allocation_age);
     }
-    return -1;
 }
 
 // REPL command implementations
@@ -102,11 +137,6 @@ static void repl_cmd_alloc(const char* args) {
         return;
     }
     
-    if (g_repl_allocation_count >= MAX_REPL_ALLOCATIONS) {
-        printf("Error: Maximum allocations reached (%d)\n", MAX_REPL_ALLOCATIONS);
-        return;
-    }
-    
     // Initialize memory space if needed
     if (!g_repl_memory_space && g_config.memory_limit > 0) {
         g_repl_memory_space = diram_space_create(
@@ -126,14 +156,6 @@ static void repl_cmd_alloc(const char* args) {
         return;
     }
     
-    // Store allocation info
-    g_repl_allocations[g_repl_allocation_count].alloc = alloc;
-    snprintf(g_repl_allocations[g_repl_allocation_count].tag,
-             sizeof(g_repl_allocations[g_repl_allocation_count].tag),
-             "%s", tag[0] ? tag : "untagged");
-    g_repl_allocations[g_repl_allocation_count].address = alloc->base_addr;
-    g_repl_allocation_count++;
-    
     printf("Allocated %zu bytes at %p\n", size, alloc->base_addr);
     printf("  SHA-256: %.16s...\n", alloc->sha256_receipt);
     printf("  Heap events: %d/3\n", alloc->heap_events);
@@ -146,55 +168,41 @@ static void repl_cmd_free(const char* args) {
         return;
     }
     
-    int index = find_allocation_by_address(addr);
-    if (index < 0) {
+    if (diram_free(addr) < 0) {
         printf("Error: No allocation found at address %p\n", addr);
         return;
     }
-    
-    diram_free_traced(g_repl_allocations[index].alloc);
     printf("Freed allocation at %p\n", addr);
-    
-    // Remove from tracking
-    g_repl_allocations[index].alloc = NULL;
-    
-    // Compact array
-    for (int i = index; i < g_repl_allocation_count - 1; i++) {
-        g_repl_allocations[i] = g_repl_allocations[i + 1];
-    }
-    g_repl_allocation_count--;
 }
 
 static void repl_cmd_trace(void) {
-    if (g_repl_allocation_count == 0) {
+    repl_allocation_list_t list;
+    collect_allocations(&list);
+    if (list.count == 0) {
         printf("No active allocations\n");
+        free(list.items);
         return;
     }
     
-    printf("Active allocations: %d\n", g_repl_allocation_count);
+    printf("Active allocations: %zu\n", list.count);
     printf("%-18s %-10s %-20s %-18s\n", 
            "Address", "Size", "Tag", "SHA-256");
     printf("%-18s %-10s %-20s %-18s\n",
            "-------", "----", "---", "-------");
     
-    for (int i = 0; i < g_repl_allocation_count; i++) {
-        if (g_repl_allocations[i].alloc) {
-            printf("%-18p %-10zu %-20s %.16s...\n",
-                   g_repl_allocations[i].alloc->base_addr,
-                   g_repl_allocations[i].alloc->size,
-                   g_repl_allocations[i].tag,
-                   g_repl_allocations[i].alloc->sha256_receipt);
-        }
+    for (size_t i = 0; i < list.count; i++) {
+        diram_allocation_t* alloc = list.items[i];
+        printf("%-18p %-10zu %-20s %.16s...\n",
+               alloc->base_addr, alloc->size,
+               alloc->tag[0] ? alloc->tag : "untagged",
+               alloc->sha256_receipt);
     }
     
     // Show heap constraint status
-    if (g_repl_allocation_count > 0) {
-        diram_allocation_t* last = g_repl_allocations[g_repl_allocation_count-1].alloc;
-        if (last) {
-            printf("\nHeap constraint status: %d/3 events used (ε = %.1f)\n", 
-                   last->heap_events, last->heap_events / 3.0);
-        }
-    }
+    diram_allocation_t* last = list.items[list.count - 1];
+    printf("\nHeap constraint status: %d/3 events used (ε = %.1f)\n", 
+           last->heap_events, last->heap_events / 3.0);
+    free(list.items);
 }
 
 static void repl_cmd_config(void) {
@@ -203,8 +211,13 @@ static void repl_cmd_config(void) {
     printf("  Memory space: %s\n", g_config.memory_space);
     printf("  Trace enabled: %s\n", g_config.trace_enabled ? "yes" : "no");
     printf("  Verbose mode: %s\n", g_config.verbose ? "yes" : "no");
+    if (g_manifest) {
+        printf("  Manifest: %s (%s, %llu nodes)\n", g_manifest_path, g_manifest_status,
+               (unsigned long long)g_manifest->header->node_count);
+    }
     
     if (g_repl_memory_space) {
+        diram_space_get_usage(g_repl_memory_space, NULL, NULL);
         printf("\nMemory space status:\n");
         printf("  Used: %zu bytes\n", g_repl_memory_space->used_bytes);
         printf("  Limit: %zu bytes\n", g_repl_memory_space->limit_bytes);
@@ -254,8 +267,33 @@ static int parse_config_file(const char *filename) {
             strncpy(g_config.memory_space, value, sizeof(g_config.memory_space) - 1);
         } else if (strcmp(key, "trace") == 0) {
             g_config.trace_enabled = (strcmp(value, "true") == 0);
+        } else if (strcmp(key, "trace_format") == 0) {
+            strncpy(g_config.trace_format,
+                    strncmp(value, "binary", 6) == 0 ? "binary" : "text",
+                    sizeof(g_config.trace_format) - 1);
+        } else if (strcmp(key, "receipt_mode") == 0) {
+            diram_receipt_mode_t mode;
+            if (diram_receipt_mode_from_string(value, &mode) == 0) {
+                strncpy(g_config.receipt_mode,
+                        mode == DIRAM_RECEIPT_SIPHASH ? "siphash" : "sha256",
+                        sizeof(g_config.receipt_mode) - 1);
+                diram_receipt_set_mode(mode);
+            }
+        } else if (strcmp(key, "hugepages") == 0) {
+            diram_hugepage_mode_t mode;
+            if (diram_hugepage_mode_from_string(value, &mode) == 0) {
+                strncpy(g_config.hugepages,
+                        mode == DIRAM_HUGEPAGE_HUGETLB ? "hugetlb" :
+                        mode == DIRAM_HUGEPAGE_THP ? "thp" : "off",
+                        sizeof(g_config.hugepages) - 1);
+                diram_page_cache_set_hugepage_mode(mode);
+            }
         } else if (strcmp(key, "log_dir") == 0) {
             strncpy(g_config.log_dir, value, sizeof(g_config.log_dir) - 1);
+        } else if (strcmp(key, "manifest") == 0 && !g_manifest_path[0]) {
+            strncpy(g_manifest_path, value, sizeof(g_manifest_path) - 1);
+        } else if (strcmp(key, "snapshot") == 0 && !g_snapshot_path[0]) {
+            strncpy(g_snapshot_path, value, sizeof(g_snapshot_path) - 1);
         }
     }
     
@@ -341,6 +379,13 @@ static int run_detached(char **argv) {
     exit(1);
 }
 
+// Start the trace writer in the configured record format
+static int start_trace_log(void) {
+    diram_trace_format_t format = strcmp(g_config.trace_format, "binary") == 0 ?
+                                  DIRAM_TRACE_FORMAT_BINARY : DIRAM_TRACE_FORMAT_TEXT;
+    return diram_init_trace_log_ex(format);
+}
+
 // Memory isolation with configurable limits
 static int setup_memory_isolation(void) {
     if (g_config.memory_limit == 0) {
@@ -349,7 +394,7 @@ static int setup_memory_isolation(void) {
     
     // Initialize traced allocation system
     if (g_config.trace_enabled) {
-        if (diram_init_trace_log() < 0) {
+        if (start_trace_log() < 0) {
             fprintf(stderr, "Warning: Failed to initialize trace log\n");
         }
     }
@@ -362,6 +407,47 @@ static int setup_memory_isolation(void) {
     return 0;
 }
 
+// Map the manifest snapshot, recompiling it only when the manifest changed
+static int load_manifest(void) {
+    if (!g_manifest_path[0]) {
+        return 0;
+    }
+    
+    diram_snapshot_status_t status;
+    g_manifest = diram_snapshot_compile(g_manifest_path,
+                                        g_snapshot_path[0] ? g_snapshot_path : NULL,
+                                        HOTWIRE_TARGET_NATIVE_ASM, &status);
+    if (!g_manifest) {
+        fprintf(stderr, "Error: %s\n", diram_snapshot_error());
+        return -1;
+    }
+    if (status == DIRAM_SNAPSHOT_UNSAVED) {
+        fprintf(stderr, "Warning: %s\n", diram_snapshot_error());
+    }
+    g_manifest_status = status == DIRAM_SNAPSHOT_HIT ? "snapshot" :
+                        status == DIRAM_SNAPSHOT_REBUILT ? "recompiled" : "compiled, not cached";
+    
+    if (g_config.verbose) {
+        size_t output_size = 0;
+        diram_snapshot_output(g_manifest, &output_size);
+        printf("Manifest %s: %s, %llu nodes, %zu bytes of hotwire output\n",
+               g_manifest_path, g_manifest_status,
+               (unsigned long long)g_manifest->header->node_count, output_size);
+    }
+    return 0;
+}
+
+// Replay a captured trace through the allocator and report on it
+static int run_replay(void) {
+    diram_replay_stats_t stats;
+    if (diram_trace_replay(g_replay_path, g_replay_timing, &stats) < 0) {
+        fprintf(stderr, "Error: Cannot replay '%s'\n", g_replay_path);
+        return 1;
+    }
+    diram_replay_print_stats(&stats, stdout);
+    return 0;
+}
+
 // Enhanced REPL mode implementation
 static int run_repl(void) {
     printf("DIRAM REPL v%s\n", DIRAM_VERSION);
@@ -369,7 +455,7 @@ static int run_repl(void) {
     
     // Initialize tracing if enabled
     if (g_config.trace_enabled) {
-        if (diram_init_trace_log() < 0) {
+        if (start_trace_log() < 0) {
             fprintf(stderr, "Warning: Failed to initialize trace log\n");
         }
     }
@@ -434,12 +520,16 @@ static int run_repl(void) {
     }
     
     // Cleanup any remaining allocations
-    printf("\nCleaning up %d allocations...\n", g_repl_allocation_count);
-    for (int i = 0; i < g_repl_allocation_count; i++) {
-        if (g_repl_allocations[i].alloc) {
-            diram_free_traced(g_repl_allocations[i].alloc);
-        }
+    repl_allocation_list_t list;
+    collect_allocations(&list);
+    printf("\nCleaning up %zu allocations...\n", list.count);
+    if (g_config.verbose) {
+        diram_alloc_report_leaks(stdout);
+    }
+    for (size_t i = 0; i < list.count; i++) {
+        diram_free_traced(list.items[i]);
     }
+    free(list.items);
     
     // Cleanup memory space
     if (g_repl_memory_space) {
@@ -466,12 +556,19 @@ static void print_usage(const char *prog) {
     printf("  -m, --memory LIMIT   Set memory limit in MB\n");
     printf("  -s, --space NAME     Set memory space name\n");
     printf("  -v, --verbose        Enable verbose output\n");
+    printf("  -x, --manifest FILE  Load a policy manifest (cached as FILE.snap)\n");
+    printf("      --snapshot FILE  Cache the compiled manifest in FILE instead\n");
+    printf("      --convert-trace FILE  Print a binary trace file in text format\n");
+    printf("      --replay FILE    Replay a text or binary trace and report throughput,\n");
+    printf("                       peak RSS and fragmentation\n");
+    printf("      --replay-timing MODE  'full' speed (default) or 'original' gaps\n");
     printf("  -h, --help           Show this help\n");
     printf("  -V, --version        Show version\n");
     printf("\nExamples:\n");
     printf("  %s --detach -c myconfig.drc\n", prog);
     printf("  %s --repl --trace\n", prog);
     printf("  %s --memory 1024 --space userspace\n", prog);
+    printf("  %s --replay logs/alloc_trace.bin\n", prog);
 }
 
 int main(int argc, char *argv[]) {
@@ -486,12 +583,17 @@ int main(int argc, char *argv[]) {
         {"verbose", no_argument,       0, 'v'},
         {"help",    no_argument,       0, 'h'},
         {"version", no_argument,       0, 'V'},
+        {"manifest", required_argument, 0, 'x'},
+        {"snapshot", required_argument, 0, 'S'},
+        {"convert-trace", required_argument, 0, 'T'},
+        {"replay", required_argument, 0, 'P'},
+        {"replay-timing", required_argument, 0, 'W'},
         {0, 0, 0, 0}
     };
     
     // Parse command line
     int opt;
-    while ((opt = getopt_long(argc, argv, "c:dtrm:s:vhV", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:dtrm:s:x:vhV", long_options, NULL)) != -1) {
         switch (opt) {
             case 'c':
                 strncpy(g_config.config_file, optarg, sizeof(g_config.config_file) - 1);
@@ -520,6 +622,31 @@ int main(int argc, char *argv[]) {
             case 'V':
                 printf("DIRAM v%s (OBINexus Project)\n", DIRAM_VERSION);
                 return 0;
+            case 'x':
+                strncpy(g_manifest_path, optarg, sizeof(g_manifest_path) - 1);
+                break;
+            case 'S':
+                strncpy(g_snapshot_path, optarg, sizeof(g_snapshot_path) - 1);
+                break;
+            case 'P':
+                strncpy(g_replay_path, optarg, sizeof(g_replay_path) - 1);
+                break;
+            case 'W':
+                if (strcmp(optarg, "original") == 0) {
+                    g_replay_timing = DIRAM_REPLAY_ORIGINAL_TIMING;
+                } else if (strcmp(optarg, "full") == 0) {
+                    g_replay_timing = DIRAM_REPLAY_FULL_SPEED;
+                } else {
+                    fprintf(stderr, "Error: --replay-timing takes 'full' or 'original'\n");
+                    return 1;
+                }
+                break;
+            case 'T':
+                if (diram_trace_convert_binary(optarg, "-") < 0) {
+                    fprintf(stderr, "Error: '%s' is not a DIRAM binary trace\n", optarg);
+                    return 1;
+                }
+                return 0;
             default:
                 print_usage(argv[0]);
                 return 1;
@@ -532,6 +659,11 @@ int main(int argc, char *argv[]) {
                               DIRAM_DEFAULT_CONFIG;
     parse_config_file(config_file);
     
+    // Replay runs in the foreground and exits
+    if (g_replay_path[0]) {
+        return run_replay();
+    }
+    
     // Handle detach mode
     if (g_config.detach_mode) {
         // Prepare argv without --detach for re-execution
@@ -552,9 +684,15 @@ int main(int argc, char *argv[]) {
     // Setup memory isolation
     setup_memory_isolation();
     
+    if (load_manifest() < 0) {
+        return 1;
+    }
+    
     // Handle REPL mode
     if (g_config.repl_mode) {
-        return run_repl();
+        int ret = run_repl();
+        diram_snapshot_close(g_manifest);
+        return ret;
     }
     
     // Default operation
@@ -565,8 +703,12 @@ int main(int argc, char *argv[]) {
     if (g_config.memory_limit > 0) {
         printf("  Memory limit: %zu MB\n", g_config.memory_limit);
     }
+    if (g_manifest) {
+        printf("  Manifest: %s (%s)\n", g_manifest_path, g_manifest_status);
+    }
     
     // Cleanup
+    diram_snapshot_close(g_manifest);
     if (g_config.trace_enabled) {
         diram_close_trace_log();
     }
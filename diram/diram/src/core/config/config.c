@@ -3,19 +3,70 @@
 // OBINexus Project - Unified configuration management
 
 #include "diram/core/config/config.h"
+#include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "diram/core/feature-alloc/page_cache.h"
+#include "diram/core/feature-alloc/telemetry.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <ctype.h>
+#include <pthread.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#endif
 
 // Global configuration instance
 diram_config_t g_diram_config = {0};
 
+// Published snapshots, newest first. Readers may still hold any of them, so
+// superseded ones are only reclaimed by diram_config_cleanup().
+typedef struct config_snapshot {
+    diram_config_t config;
+    struct config_snapshot* older;
+} config_snapshot_t;
+
+_Atomic(const diram_config_t*) g_diram_config_snapshot = NULL;
+static config_snapshot_t* g_config_snapshots = NULL;
+static atomic_uint_fast64_t g_config_generation = 0;
+
+// Serializes writers of the working copy; readers never take it
+static pthread_mutex_t g_config_lock = PTHREAD_MUTEX_INITIALIZER;
+
 // Error buffer for validation
 static char g_config_error_buffer[1024] = {0};
 
+// Copy the working copy into a fresh snapshot and swap it in; caller holds
+// g_config_lock
+static int config_publish_locked(void) {
+    config_snapshot_t* snapshot = malloc(sizeof(config_snapshot_t));
+    if (!snapshot) return -1;
+
+    snapshot->config = g_diram_config;
+    snapshot->older = g_config_snapshots;
+    g_config_snapshots = snapshot;
+    atomic_store_explicit(&g_diram_config_snapshot, &snapshot->config,
+                          memory_order_release);
+    atomic_fetch_add_explicit(&g_config_generation, 1, memory_order_release);
+    return 0;
+}
+
+int diram_config_commit(void) {
+    pthread_mutex_lock(&g_config_lock);
+    int result = config_publish_locked();
+    pthread_mutex_unlock(&g_config_lock);
+    return result;
+}
+
+uint64_t diram_config_generation(void) {
+    return atomic_load_explicit(&g_config_generation, memory_order_acquire);
+}
+
 // Internal helper to get home directory
 static const char* get_home_dir(void) {
     const char* home = getenv("HOME");
@@ -27,6 +78,7 @@ static const char* get_home_dir(void) {
 
 // Initialize configuration with defaults
 int diram_config_init(void) {
+    pthread_mutex_lock(&g_config_lock);
     memset(&g_diram_config, 0, sizeof(diram_config_t));
     
     // Set defaults
@@ -34,15 +86,21 @@ int diram_config_init(void) {
     g_diram_config.memory_limit = DIRAM_DEFAULT_MEMORY_LIMIT;
     strncpy(g_diram_config.memory_space, "default", 63);
     g_diram_config.trace_enabled = false;
+    strncpy(g_diram_config.trace_format, "text", 15);
+    strncpy(g_diram_config.receipt_mode, "sha256", 15);
     strncpy(g_diram_config.log_dir, "logs", PATH_MAX - 1);
     g_diram_config.max_heap_events = DIRAM_DEFAULT_MAX_HEAP_EVENTS;
+    strncpy(g_diram_config.heap_mode, "reject", 15);
     g_diram_config.detach_timeout = 30;
     strncpy(g_diram_config.pid_binding, "strict", 31);
     g_diram_config.guard_pages = true;
+    strncpy(g_diram_config.hugepages, "off", 15);
     g_diram_config.canary_values = true;
     g_diram_config.aslr_enabled = true;
     g_diram_config.telemetry_level = DIRAM_DEFAULT_TELEMETRY_LEVEL;
     strncpy(g_diram_config.telemetry_endpoint, "/var/run/diram/telemetry.sock", PATH_MAX - 1);
+    g_diram_config.telemetry_head_sample = 1.0;
+    g_diram_config.telemetry_tail_sample = 1.0;
     g_diram_config.zero_trust = true;
     g_diram_config.memory_audit = true;
     
@@ -67,7 +125,9 @@ int diram_config_init(void) {
     g_diram_config.repl_mode = false;
     g_diram_config.detach_mode = false;
     
-    return 0;
+    int result = config_publish_locked();
+    pthread_mutex_unlock(&g_config_lock);
+    return result;
 }
 
 // Parse size with unit suffixes
@@ -105,6 +165,254 @@ bool diram_config_parse_bool(const char* bool_str) {
     return false;
 }
 
+// Key dispatch: one descriptor per CFG_* key, generated from the list
+// below, found through a perfect hash over the key strings. Plain rows are
+// parsed by type straight into their field; rows with a setter validate
+// and apply the value themselves.
+typedef enum {
+    CONFIG_TYPE_SIZE,
+    CONFIG_TYPE_INT,
+    CONFIG_TYPE_BOOL,
+    CONFIG_TYPE_DOUBLE,
+    CONFIG_TYPE_STRING
+} config_type_t;
+
+typedef struct {
+    const char* key;
+    config_type_t type;
+    size_t offset;
+    size_t size;
+    int (*set)(diram_config_t* config, const char* value);
+} config_key_t;
+
+static int set_trace_format(diram_config_t* config, const char* value) {
+    strncpy(config->trace_format,
+            strncmp(value, "binary", 6) == 0 ? "binary" : "text", 15);
+    return 0;
+}
+
+static int set_receipt_mode(diram_config_t* config, const char* value) {
+    diram_receipt_mode_t mode;
+    if (diram_receipt_mode_from_string(value, &mode) < 0) return -1;
+    strncpy(config->receipt_mode,
+            mode == DIRAM_RECEIPT_SIPHASH ? "siphash" : "sha256", 15);
+    diram_receipt_set_mode(mode);
+    return 0;
+}
+
+static int set_heap_mode(diram_config_t* config, const char* value) {
+    diram_heap_mode_t mode;
+    if (diram_heap_mode_from_string(value, &mode) < 0) return -1;
+    strncpy(config->heap_mode,
+            mode == DIRAM_HEAP_MODE_DEFER ? "defer" : "reject", 15);
+    diram_heap_set_mode(mode);
+    return 0;
+}
+
+static int set_hugepages(diram_config_t* config, const char* value) {
+    diram_hugepage_mode_t mode;
+    if (diram_hugepage_mode_from_string(value, &mode) < 0) return -1;
+    strncpy(config->hugepages,
+            mode == DIRAM_HUGEPAGE_HUGETLB ? "hugetlb" :
+            mode == DIRAM_HUGEPAGE_THP ? "thp" : "off", 15);
+    diram_page_cache_set_hugepage_mode(mode);
+    return 0;
+}
+
+static int parse_sample_rate(const char* value, double* rate) {
+    char* end;
+    *rate = strtod(value, &end);
+    return (end == value || !(*rate >= 0.0 && *rate <= 1.0)) ? -1 : 0;
+}
+
+static int set_head_sample(diram_config_t* config, const char* value) {
+    if (parse_sample_rate(value, &config->telemetry_head_sample) < 0) return -1;
+    diram_telemetry_set_sampling(config->telemetry_head_sample,
+                                 config->telemetry_tail_sample);
+    return 0;
+}
+
+static int set_tail_sample(diram_config_t* config, const char* value) {
+    if (parse_sample_rate(value, &config->telemetry_tail_sample) < 0) return -1;
+    diram_telemetry_set_sampling(config->telemetry_head_sample,
+                                 config->telemetry_tail_sample);
+    return 0;
+}
+
+#define DIRAM_CONFIG_KEYS(X) \
+    X(CFG_MEMORY_LIMIT,               SIZE,   memory_limit,               NULL) \
+    X(CFG_MEMORY_SPACE,               STRING, memory_space,               NULL) \
+    X(CFG_TRACE,                      BOOL,   trace_enabled,              NULL) \
+    X(CFG_TRACE_FORMAT,               STRING, trace_format,               set_trace_format) \
+    X(CFG_RECEIPT_MODE,               STRING, receipt_mode,               set_receipt_mode) \
+    X(CFG_LOG_DIR,                    STRING, log_dir,                    NULL) \
+    X(CFG_MAX_HEAP_EVENTS,            INT,    max_heap_events,            NULL) \
+    X(CFG_HEAP_MODE,                  STRING, heap_mode,                  set_heap_mode) \
+    X(CFG_DETACH_TIMEOUT,             INT,    detach_timeout,             NULL) \
+    X(CFG_PID_BINDING,                STRING, pid_binding,                NULL) \
+    X(CFG_GUARD_PAGES,                BOOL,   guard_pages,                NULL) \
+    X(CFG_HUGEPAGES,                  STRING, hugepages,                  set_hugepages) \
+    X(CFG_CANARY_VALUES,              BOOL,   canary_values,              NULL) \
+    X(CFG_ASLR_ENABLED,               BOOL,   aslr_enabled,               NULL) \
+    X(CFG_TELEMETRY_LEVEL,            INT,    telemetry_level,            NULL) \
+    X(CFG_TELEMETRY_ENDPOINT,         STRING, telemetry_endpoint,         NULL) \
+    X(CFG_TELEMETRY_HEAD_SAMPLE,      DOUBLE, telemetry_head_sample,      set_head_sample) \
+    X(CFG_TELEMETRY_TAIL_SAMPLE,      DOUBLE, telemetry_tail_sample,      set_tail_sample) \
+    X(CFG_ZERO_TRUST,                 BOOL,   zero_trust,                 NULL) \
+    X(CFG_MEMORY_AUDIT,               BOOL,   memory_audit,               NULL) \
+    X(CFG_ASYNC_ENABLE_PROMISES,      BOOL,   enable_promises,            NULL) \
+    X(CFG_ASYNC_DEFAULT_TIMEOUT_MS,   INT,    default_timeout_ms,         NULL) \
+    X(CFG_ASYNC_MAX_PENDING_PROMISES, INT,    max_pending_promises,       NULL) \
+    X(CFG_ASYNC_LOOKAHEAD_CACHE_SIZE, INT,    lookahead_cache_size,       NULL) \
+    X(CFG_DETACH_ENABLE_MODE,         BOOL,   enable_detach_mode,         NULL) \
+    X(CFG_DETACH_LOG_ASYNC_OPS,       BOOL,   log_async_operations,       NULL) \
+    X(CFG_DETACH_PERSIST_RECEIPTS,    BOOL,   persist_promise_receipts,   NULL) \
+    X(CFG_RESIL_RETRY_TRANSIENT,      BOOL,   retry_on_transient_failure, NULL) \
+    X(CFG_RESIL_MAX_RETRY,            INT,    max_retry_attempts,         NULL) \
+    X(CFG_RESIL_EXP_BACKOFF,          BOOL,   exponential_backoff,        NULL)
+
+#define CONFIG_KEY_ROW(key, type, field, set) \
+    { key, CONFIG_TYPE_##type, offsetof(diram_config_t, field), \
+      sizeof(((diram_config_t*)0)->field), set },
+
+static const config_key_t g_config_keys[] = {
+    DIRAM_CONFIG_KEYS(CONFIG_KEY_ROW)
+};
+
+#define CONFIG_KEY_COUNT (sizeof(g_config_keys) / sizeof(g_config_keys[0]))
+
+// Slot table holds row index + 1; the seed is searched once so that every
+// key lands in its own slot, making a lookup one hash and one strcmp
+#define CONFIG_HASH_SLOTS 128
+#define CONFIG_HASH_MAX_SEEDS 65536
+
+_Static_assert(CONFIG_KEY_COUNT < CONFIG_HASH_SLOTS / 2, "grow CONFIG_HASH_SLOTS");
+
+static uint8_t g_config_slots[CONFIG_HASH_SLOTS];
+static uint32_t g_config_hash_seed;
+static bool g_config_hash_ready;
+static pthread_once_t g_config_hash_once = PTHREAD_ONCE_INIT;
+
+static uint32_t config_key_hash(const char* key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    while (*key) {
+        h ^= (uint8_t)*key++;
+        h *= 16777619u;
+    }
+    return (h ^ (h >> 15)) & (CONFIG_HASH_SLOTS - 1);
+}
+
+static void config_hash_build(void) {
+    for (uint32_t seed = 0; seed < CONFIG_HASH_MAX_SEEDS; seed++) {
+        memset(g_config_slots, 0, sizeof(g_config_slots));
+        size_t i;
+        for (i = 0; i < CONFIG_KEY_COUNT; i++) {
+            uint32_t slot = config_key_hash(g_config_keys[i].key, seed);
+            if (g_config_slots[slot]) break;
+            g_config_slots[slot] = (uint8_t)(i + 1);
+        }
+        if (i == CONFIG_KEY_COUNT) {
+            g_config_hash_seed = seed;
+            g_config_hash_ready = true;
+            return;
+        }
+    }
+    // No seed separated the keys; lookups fall back to a linear scan
+}
+
+static const config_key_t* config_key_find(const char* key) {
+    pthread_once(&g_config_hash_once, config_hash_build);
+
+    if (g_config_hash_ready) {
+        uint8_t row = g_config_slots[config_key_hash(key, g_config_hash_seed)];
+        if (row && strcmp(g_config_keys[row - 1].key, key) == 0) {
+            return &g_config_keys[row - 1];
+        }
+        return NULL;
+    }
+    for (size_t i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (strcmp(g_config_keys[i].key, key) == 0) return &g_config_keys[i];
+    }
+    return NULL;
+}
+
+// Set a key on the working copy; caller holds g_config_lock
+static int config_set_locked(const char* key, const char* value) {
+    const config_key_t* desc = config_key_find(key);
+    if (!desc) {
+        // Unknown key - log if verbose
+        if (g_diram_config.verbose) {
+            fprintf(stderr, "Warning: unknown config key '%s'\n", key);
+        }
+        return -1;
+    }
+
+    if (desc->set) {
+        return desc->set(&g_diram_config, value);
+    }
+
+    char* field = (char*)&g_diram_config + desc->offset;
+    switch (desc->type) {
+        case CONFIG_TYPE_SIZE:
+            *(size_t*)field = strtoul(value, NULL, 10);
+            break;
+        case CONFIG_TYPE_INT:
+            *(int*)field = (int)strtol(value, NULL, 10);
+            break;
+        case CONFIG_TYPE_BOOL:
+            *(bool*)field = diram_config_parse_bool(value);
+            break;
+        case CONFIG_TYPE_DOUBLE:
+            *(double*)field = strtod(value, NULL);
+            break;
+        case CONFIG_TYPE_STRING:
+            strncpy(field, value, desc->size - 1);
+            field[desc->size - 1] = '\0';
+            break;
+    }
+    return 0;
+}
+
+// Set a configuration value
+int diram_config_set_value(const char* key, const char* value) {
+    if (!key || !value) return -1;
+
+    pthread_mutex_lock(&g_config_lock);
+    int result = config_set_locked(key, value);
+    if (result == 0) {
+        result = config_publish_locked();
+    }
+    pthread_mutex_unlock(&g_config_lock);
+    return result;
+}
+
+// Get a configuration value as string, read from the published snapshot
+const char* diram_config_get_value(const char* key) {
+    static __thread char value_buffer[256];
+
+    if (!key) return NULL;
+    const config_key_t* desc = config_key_find(key);
+    if (!desc) return NULL;
+
+    const char* field = (const char*)diram_config_current() + desc->offset;
+    switch (desc->type) {
+        case CONFIG_TYPE_SIZE:
+            snprintf(value_buffer, sizeof(value_buffer), "%zu", *(const size_t*)field);
+            break;
+        case CONFIG_TYPE_INT:
+            snprintf(value_buffer, sizeof(value_buffer), "%d", *(const int*)field);
+            break;
+        case CONFIG_TYPE_BOOL:
+            return *(const bool*)field ? "true" : "false";
+        case CONFIG_TYPE_DOUBLE:
+            snprintf(value_buffer, sizeof(value_buffer), "%g", *(const double*)field);
+            break;
+        case CONFIG_TYPE_STRING:
+            return field;
+    }
+    return value_buffer;
+}
+
 // Process a single configuration line
 static int process_config_line(const char* section, const char* key, const char* value) {
     char full_key[256];
@@ -117,11 +425,11 @@ static int process_config_line(const char* section, const char* key, const char*
         full_key[sizeof(full_key) - 1] = '\0';
     }
     
-    return diram_config_set_value(full_key, value);
+    return config_set_locked(full_key, value);
 }
 
-// Load configuration from file
-int diram_config_load_file(const char* filename, config_source_t source) {
+// Parse a file into the working copy; caller holds g_config_lock
+static int config_load_locked(const char* filename, config_source_t source) {
     FILE* fp = fopen(filename, "r");
     if (!fp) {
         if (source == CONFIG_SOURCE_CMDLINE || g_diram_config.verbose) {
@@ -203,94 +511,60 @@ int diram_config_load_file(const char* filename, config_source_t source) {
     return errors > 0 ? -1 : 0;
 }
 
-// Set a configuration value
-int diram_config_set_value(const char* key, const char* value) {
-    if (!key || !value) return -1;
-    
-    // Basic configuration
-    if (strcmp(key, CFG_MEMORY_LIMIT) == 0) {
-        g_diram_config.memory_limit = strtoul(value, NULL, 10);
-    } else if (strcmp(key, CFG_MEMORY_SPACE) == 0) {
-        strncpy(g_diram_config.memory_space, value, 63);
-    } else if (strcmp(key, CFG_TRACE) == 0) {
-        g_diram_config.trace_enabled = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_LOG_DIR) == 0) {
-        strncpy(g_diram_config.log_dir, value, PATH_MAX - 1);
-    } else if (strcmp(key, CFG_MAX_HEAP_EVENTS) == 0) {
-        g_diram_config.max_heap_events = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_DETACH_TIMEOUT) == 0) {
-        g_diram_config.detach_timeout = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_PID_BINDING) == 0) {
-        strncpy(g_diram_config.pid_binding, value, 31);
-    } else if (strcmp(key, CFG_GUARD_PAGES) == 0) {
-        g_diram_config.guard_pages = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_CANARY_VALUES) == 0) {
-        g_diram_config.canary_values = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_ASLR_ENABLED) == 0) {
-        g_diram_config.aslr_enabled = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_TELEMETRY_LEVEL) == 0) {
-        g_diram_config.telemetry_level = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_TELEMETRY_ENDPOINT) == 0) {
-        strncpy(g_diram_config.telemetry_endpoint, value, PATH_MAX - 1);
-    } else if (strcmp(key, CFG_ZERO_TRUST) == 0) {
-        g_diram_config.zero_trust = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_MEMORY_AUDIT) == 0) {
-        g_diram_config.memory_audit = diram_config_parse_bool(value);
-    }
-    // Async configuration
-    else if (strcmp(key, CFG_ASYNC_ENABLE_PROMISES) == 0) {
-        g_diram_config.enable_promises = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_ASYNC_DEFAULT_TIMEOUT_MS) == 0) {
-        g_diram_config.default_timeout_ms = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_ASYNC_MAX_PENDING_PROMISES) == 0) {
-        g_diram_config.max_pending_promises = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_ASYNC_LOOKAHEAD_CACHE_SIZE) == 0) {
-        g_diram_config.lookahead_cache_size = strtol(value, NULL, 10);
-    }
-    // Detach configuration
-    else if (strcmp(key, CFG_DETACH_ENABLE_MODE) == 0) {
-        g_diram_config.enable_detach_mode = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_DETACH_LOG_ASYNC_OPS) == 0) {
-        g_diram_config.log_async_operations = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_DETACH_PERSIST_RECEIPTS) == 0) {
-        g_diram_config.persist_promise_receipts = diram_config_parse_bool(value);
-    }
-    // Resilience configuration
-    else if (strcmp(key, CFG_RESIL_RETRY_TRANSIENT) == 0) {
-        g_diram_config.retry_on_transient_failure = diram_config_parse_bool(value);
-    } else if (strcmp(key, CFG_RESIL_MAX_RETRY) == 0) {
-        g_diram_config.max_retry_attempts = strtol(value, NULL, 10);
-    } else if (strcmp(key, CFG_RESIL_EXP_BACKOFF) == 0) {
-        g_diram_config.exponential_backoff = diram_config_parse_bool(value);
-    }
-    else {
-        // Unknown key - log if verbose
-        if (g_diram_config.verbose) {
-            fprintf(stderr, "Warning: unknown config key '%s'\n", key);
-        }
+// Load configuration from file
+int diram_config_load_file(const char* filename, config_source_t source) {
+    if (!filename) return -1;
+
+    pthread_mutex_lock(&g_config_lock);
+    int result = config_load_locked(filename, source);
+    // Keys that did parse still apply, as they always have
+    if (config_publish_locked() < 0) result = -1;
+    pthread_mutex_unlock(&g_config_lock);
+    return result;
+}
+
+// Push the mode strings of a restored working copy back into their modules
+static void config_apply_modes(diram_config_t* config) {
+    char value[16];
+    memcpy(value, config->receipt_mode, sizeof(value));
+    set_receipt_mode(config, value);
+    memcpy(value, config->heap_mode, sizeof(value));
+    set_heap_mode(config, value);
+    memcpy(value, config->hugepages, sizeof(value));
+    set_hugepages(config, value);
+    diram_telemetry_set_sampling(config->telemetry_head_sample,
+                                 config->telemetry_tail_sample);
+}
+
+int diram_config_reload(const char* filename) {
+    if (!filename) return -1;
+
+    pthread_mutex_lock(&g_config_lock);
+    diram_config_t* saved = malloc(sizeof(diram_config_t));
+    if (!saved) {
+        pthread_mutex_unlock(&g_config_lock);
         return -1;
     }
-    
-    return 0;
-}
+    *saved = g_diram_config;
 
-// Get a configuration value as string
-const char* diram_config_get_value(const char* key) {
-    static char value_buffer[256];
-    
-    if (strcmp(key, CFG_MEMORY_LIMIT) == 0) {
-        snprintf(value_buffer, sizeof(value_buffer), "%zu", g_diram_config.memory_limit);
-    } else if (strcmp(key, CFG_MEMORY_SPACE) == 0) {
-        return g_diram_config.memory_space;
-    } else if (strcmp(key, CFG_TRACE) == 0) {
-        return g_diram_config.trace_enabled ? "true" : "false";
-    } else if (strcmp(key, CFG_LOG_DIR) == 0) {
-        return g_diram_config.log_dir;
+    int result = config_load_locked(filename, CONFIG_SOURCE_LOCAL);
+    if (result == 0 && !diram_config_validate()) {
+        fprintf(stderr, "Config reload of %s rejected: %s\n",
+                filename, g_config_error_buffer);
+        result = -1;
+    }
+
+    if (result == 0) {
+        result = config_publish_locked();
     } else {
-        return NULL;
+        // Readers never saw the half-applied file; undo it and the module
+        // modes its setters may already have switched
+        g_diram_config = *saved;
+        config_apply_modes(&g_diram_config);
     }
-    
-    return value_buffer;
+    pthread_mutex_unlock(&g_config_lock);
+    free(saved);
+    return result;
 }
 
 // Load configuration from environment
@@ -379,21 +653,27 @@ void diram_config_print(void) {
     printf("    memory_space: %s\n", g_diram_config.memory_space);
     printf("  Tracing:\n");
     printf("    trace_enabled: %s\n", g_diram_config.trace_enabled ? "yes" : "no");
+    printf("    trace_format: %s\n", g_diram_config.trace_format);
+    printf("    receipt_mode: %s\n", g_diram_config.receipt_mode);
     printf("    log_dir: %s\n", g_diram_config.log_dir);
     printf("  Heap Constraints:\n");
     printf("    max_heap_events: %d\n", g_diram_config.max_heap_events);
     printf("    epsilon: %.1f (ε = events/max)\n", 
            (float)g_diram_config.max_heap_events / 3.0);
+    printf("    heap_mode: %s\n", g_diram_config.heap_mode);
     printf("  Process Isolation:\n");
     printf("    detach_timeout: %d seconds\n", g_diram_config.detach_timeout);
     printf("    pid_binding: %s\n", g_diram_config.pid_binding);
     printf("  Memory Protection:\n");
     printf("    guard_pages: %s\n", g_diram_config.guard_pages ? "enabled" : "disabled");
+    printf("    hugepages: %s\n", g_diram_config.hugepages);
     printf("    canary_values: %s\n", g_diram_config.canary_values ? "enabled" : "disabled");
     printf("    aslr_enabled: %s\n", g_diram_config.aslr_enabled ? "enabled" : "disabled");
     printf("  Telemetry:\n");
     printf("    telemetry_level: %d\n", g_diram_config.telemetry_level);
     printf("    telemetry_endpoint: %s\n", g_diram_config.telemetry_endpoint);
+    printf("    telemetry_head_sample: %g\n", g_diram_config.telemetry_head_sample);
+    printf("    telemetry_tail_sample: %g\n", g_diram_config.telemetry_tail_sample);
     printf("  Zero-Trust Policy:\n");
     printf("    zero_trust: %s\n", g_diram_config.zero_trust ? "enabled" : "disabled");
     printf("    memory_audit: %s\n", g_diram_config.memory_audit ? "enabled" : "disabled");
@@ -433,11 +713,14 @@ int diram_config_save(const char* filename) {
     
     fprintf(fp, "# Tracing Configuration\n");
     fprintf(fp, "%s=%s\n", CFG_TRACE, g_diram_config.trace_enabled ? "true" : "false");
+    fprintf(fp, "%s=%s\n", CFG_TRACE_FORMAT, g_diram_config.trace_format);
+    fprintf(fp, "%s=%s\n", CFG_RECEIPT_MODE, g_diram_config.receipt_mode);
     fprintf(fp, "%s=%s\n", CFG_LOG_DIR, g_diram_config.log_dir);
     fprintf(fp, "\n");
     
     fprintf(fp, "# Heap Constraint Configuration\n");
     fprintf(fp, "%s=%d\n", CFG_MAX_HEAP_EVENTS, g_diram_config.max_heap_events);
+    fprintf(fp, "%s=%s\n", CFG_HEAP_MODE, g_diram_config.heap_mode);
     fprintf(fp, "\n");
     
     fprintf(fp, "# Process Isolation Settings\n");
@@ -447,6 +730,7 @@ int diram_config_save(const char* filename) {
     
     fprintf(fp, "# Memory Protection Flags\n");
     fprintf(fp, "%s=%s\n", CFG_GUARD_PAGES, g_diram_config.guard_pages ? "true" : "false");
+    fprintf(fp, "%s=%s\n", CFG_HUGEPAGES, g_diram_config.hugepages);
     fprintf(fp, "%s=%s\n", CFG_CANARY_VALUES, g_diram_config.canary_values ? "true" : "false");
     fprintf(fp, "%s=%s\n", CFG_ASLR_ENABLED, g_diram_config.aslr_enabled ? "true" : "false");
     fprintf(fp, "\n");
@@ -454,6 +738,8 @@ int diram_config_save(const char* filename) {
     fprintf(fp, "# Telemetry Configuration\n");
     fprintf(fp, "%s=%d\n", CFG_TELEMETRY_LEVEL, g_diram_config.telemetry_level);
     fprintf(fp, "%s=%s\n", CFG_TELEMETRY_ENDPOINT, g_diram_config.telemetry_endpoint);
+    fprintf(fp, "%s=%g\n", CFG_TELEMETRY_HEAD_SAMPLE, g_diram_config.telemetry_head_sample);
+    fprintf(fp, "%s=%g\n", CFG_TELEMETRY_TAIL_SAMPLE, g_diram_config.telemetry_tail_sample);
     fprintf(fp, "\n");
     
     fprintf(fp, "# Zero-Trust Memory Policy\n");
@@ -483,8 +769,139 @@ int diram_config_save(const char* filename) {
     return 0;
 }
 
+// Config file watcher. inotify watches the directory rather than the file
+// so a save that renames a new file over the old one is still seen.
+static struct {
+    pthread_t thread;
+    bool running;
+    int inotify_fd;
+    int stop_pipe[2];
+    char path[PATH_MAX];
+    char name[256];
+} g_config_watch = { .inotify_fd = -1, .stop_pipe = { -1, -1 } };
+
+static pthread_mutex_t g_config_watch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef __linux__
+static void* config_watch_main(void* arg) {
+    (void)arg;
+    _Alignas(struct inotify_event) char buffer[4096];
+    struct pollfd fds[2] = {
+        { .fd = g_config_watch.inotify_fd, .events = POLLIN },
+        { .fd = g_config_watch.stop_pipe[0], .events = POLLIN }
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        ssize_t len = read(g_config_watch.inotify_fd, buffer, sizeof(buffer));
+        if (len <= 0) continue;
+
+        // One reload per batch, however many events it holds
+        bool changed = false;
+        for (char* p = buffer; p < buffer + len; ) {
+            struct inotify_event* event = (struct inotify_event*)p;
+            if (event->len && strcmp(event->name, g_config_watch.name) == 0) {
+                changed = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+        if (changed && diram_config_reload(g_config_watch.path) == 0 &&
+            diram_config_current()->verbose) {
+            printf("Reloaded config from %s\n", g_config_watch.path);
+        }
+    }
+    return NULL;
+}
+
+int diram_config_watch(const char* filename) {
+    pthread_mutex_lock(&g_config_watch_lock);
+    if (g_config_watch.running) {
+        pthread_mutex_unlock(&g_config_watch_lock);
+        return -1;
+    }
+
+    if (!filename || !*filename) filename = g_diram_config.config_file;
+    if (!*filename) filename = DIRAM_DEFAULT_CONFIG_FILE;
+
+    const char* slash = strrchr(filename, '/');
+    const char* name = slash ? slash + 1 : filename;
+    char dir[PATH_MAX];
+    if (!slash) {
+        strcpy(dir, ".");
+    } else if (slash == filename) {
+        strcpy(dir, "/");
+    } else {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - filename), filename);
+    }
+    if (!*name || strlen(name) >= sizeof(g_config_watch.name) ||
+        strlen(filename) >= sizeof(g_config_watch.path)) {
+        pthread_mutex_unlock(&g_config_watch_lock);
+        return -1;
+    }
+    strcpy(g_config_watch.path, filename);
+    strcpy(g_config_watch.name, name);
+
+    g_config_watch.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (g_config_watch.inotify_fd < 0 ||
+        inotify_add_watch(g_config_watch.inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        pipe2(g_config_watch.stop_pipe, O_CLOEXEC) < 0 ||
+        pthread_create(&g_config_watch.thread, NULL, config_watch_main, NULL) != 0) {
+        if (g_config_watch.inotify_fd >= 0) close(g_config_watch.inotify_fd);
+        if (g_config_watch.stop_pipe[0] >= 0) close(g_config_watch.stop_pipe[0]);
+        if (g_config_watch.stop_pipe[1] >= 0) close(g_config_watch.stop_pipe[1]);
+        g_config_watch.inotify_fd = -1;
+        g_config_watch.stop_pipe[0] = g_config_watch.stop_pipe[1] = -1;
+        pthread_mutex_unlock(&g_config_watch_lock);
+        return -1;
+    }
+
+    g_config_watch.running = true;
+    pthread_mutex_unlock(&g_config_watch_lock);
+    return 0;
+}
+
+void diram_config_unwatch(void) {
+    pthread_mutex_lock(&g_config_watch_lock);
+    if (g_config_watch.running) {
+        char stop = 1;
+        while (write(g_config_watch.stop_pipe[1], &stop, 1) < 0 && errno == EINTR) {}
+        pthread_join(g_config_watch.thread, NULL);
+        close(g_config_watch.inotify_fd);
+        close(g_config_watch.stop_pipe[0]);
+        close(g_config_watch.stop_pipe[1]);
+        g_config_watch.inotify_fd = -1;
+        g_config_watch.stop_pipe[0] = g_config_watch.stop_pipe[1] = -1;
+        g_config_watch.running = false;
+    }
+    pthread_mutex_unlock(&g_config_watch_lock);
+}
+#else
+int diram_config_watch(const char* filename) {
+    (void)filename;
+    return -1;
+}
+
+void diram_config_unwatch(void) {
+}
+#endif
+
 // Cleanup configuration
 void diram_config_cleanup(void) {
-    // Currently nothing to cleanup, but placeholder for future
-    // dynamic allocations
+    diram_config_unwatch();
+
+    // Back to reading the working copy, then reclaim every snapshot
+    pthread_mutex_lock(&g_config_lock);
+    atomic_store_explicit(&g_diram_config_snapshot, NULL, memory_order_release);
+    while (g_config_snapshots) {
+        config_snapshot_t* older = g_config_snapshots->older;
+        free(g_config_snapshots);
+        g_config_snapshots = older;
+    }
+    pthread_mutex_unlock(&g_config_lock);
 }
\ No newline at end of file
@@ -1,10 +1,17 @@
 
 // core/feature-alloc/alloc.c
 #include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/alloc_index.h"
+#include "diram/core/feature-alloc/slab.h"
+#include "diram/core/feature-alloc/trace_ring.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "diram/core/config/config.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <stdatomic.h>
 #if defined(_WIN32) || defined(_WIN64)
 // Windows does not support pthreads natively; define stubs or include Windows equivalents if needed
 #include <windows.h>
@@ -35,155 +42,522 @@ static int clock_gettime(int clk_id, struct timespec* ts) {
 #include <sys/file.h>
 
 // Thread-local storage for heap event constraints
-static __thread diram_heap_context_t heap_ctx = {0, 0};
-static FILE* trace_log = NULL;
-#if defined(_WIN32) || defined(_WIN64)
-static pthread_mutex_t trace_mutex = NULL;
-#else
-static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
-#endif
+static __thread diram_heap_context_t heap_ctx = {0, 0, 0};
 
-// SHA-256 implementation (simplified for demonstration)
-static void sha256_hex(const void* data, size_t len, char* output) {
-    // In production, link against OpenSSL or similar
-    // This is a placeholder implementation
-    const uint8_t* bytes = (const uint8_t*)data;
-    for (size_t i = 0; i < 32; i++) {
-        sprintf(output + (i * 2), "%02x", bytes[i % len]);
-    }
-    output[64] = '\0';
+#define DIRAM_HEAP_BUCKET_NS 1000000000LL
+
+static atomic_int g_heap_mode = DIRAM_HEAP_MODE_REJECT;
+
+// Events already charged to the thread that queued this work (async hand-off)
+static __thread uint32_t heap_prepaid = 0;
+
+// Bytes hashed into every receipt
+typedef struct {
+    void* addr;
+    size_t size;
+    uint64_t timestamp;
+    char tag[64];
+} diram_receipt_input_t;
+
+// Header in front of the trackers carved by diram_alloc_batch
+typedef struct {
+    size_t count;
+    size_t live;    // Members not yet freed (atomic)
+    diram_live_node_t node;
+} diram_batch_region_t;
+
+// Live-allocation registry. Threads insert into their own shard, so the
+// locks are uncontended except for cross-thread frees. At fork the child
+// splices every shard onto the inherited list in O(shards) without
+// touching a tracker, which would break copy-on-write sharing; the fork
+// generation then tells inherited allocations apart with no getpid().
+#define DIRAM_LIVE_SHARDS 16
+
+typedef struct {
+    _Alignas(64) pthread_mutex_t lock;
+    diram_live_node_t head;     // Circular sentinel
+    size_t count;
+} diram_live_shard_t;
+
+static diram_live_shard_t g_live_shards[DIRAM_LIVE_SHARDS];
+static diram_live_shard_t g_live_inherited;
+static pthread_once_t g_live_once = PTHREAD_ONCE_INIT;
+static atomic_uint g_live_next_shard = 0;
+static __thread int t_live_shard = -1;
+
+// Written only by the single-threaded atfork child handler
+static uint32_t g_fork_generation = 0;
+static pid_t g_alloc_pid = 0;
+
+#define DIRAM_BATCH_HEADER DIRAM_SLAB_ALIGN_UP(sizeof(diram_batch_region_t))
+
+static void receipt_input_fill(diram_receipt_input_t* input,
+                               const diram_allocation_t* alloc, const char* tag) {
+    // Zero first so padding and the unused tag tail hash deterministically
+    memset(input, 0, sizeof(*input));
+    input->addr = alloc->base_addr;
+    input->size = alloc->size;
+    input->timestamp = alloc->timestamp;
+    strncpy(input->tag, tag ? tag : "untagged", 63);
+}
+
+static void alloc_set_tag(diram_allocation_t* alloc, const char* tag) {
+    memset(alloc->tag, 0, sizeof(alloc->tag));
+    if (tag) strncpy(alloc->tag, tag, sizeof(alloc->tag) - 1);
 }
 
 void diram_compute_receipt(diram_allocation_t* alloc, const char* tag) {
-    struct {
-        void* addr;
-        size_t size;
-        uint64_t timestamp;
-        char tag[64];
-    } receipt_input;
-    
-    receipt_input.addr = alloc->base_addr;
-    receipt_input.size = alloc->size;
-    receipt_input.timestamp = alloc->timestamp;
-    strncpy(receipt_input.tag, tag ? tag : "untagged", 63);
-    receipt_input.tag[63] = '\0';
+    diram_receipt_input_t receipt_input;
+    receipt_input_fill(&receipt_input, alloc, tag);
     
-    sha256_hex(&receipt_input, sizeof(receipt_input), alloc->sha256_receipt);
+    // SHA-256 by default; receipt_mode=siphash trades it for a keyed MAC
+    diram_receipt_hex(&receipt_input, sizeof(receipt_input), alloc->sha256_receipt);
+}
+
+static uint64_t timespec_ns(const struct timespec* ts) {
+    return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
 }
 
-static int check_heap_constraint(uint64_t current_epoch) {
-    // Reset counter if we're in a new command epoch
-    if (heap_ctx.command_epoch != current_epoch) {
-        heap_ctx.event_count = 0;
-        heap_ctx.command_epoch = current_epoch;
+// Refill time one event costs; e(x) = 0.6 gives 3 events per second
+static int64_t heap_event_cost(void) {
+    int events = diram_config_current()->max_heap_events;
+    if (events <= 0) events = DIRAM_MAX_HEAP_EVENTS;
+    return DIRAM_HEAP_BUCKET_NS / events;
+}
+
+static void heap_refill(uint64_t now_ns) {
+    if (heap_ctx.refill_ns == 0) {
+        heap_ctx.credit_ns = DIRAM_HEAP_BUCKET_NS;  // First use starts full
+    } else if (now_ns > heap_ctx.refill_ns) {
+        uint64_t earned = now_ns - heap_ctx.refill_ns;
+        heap_ctx.credit_ns = earned >= (uint64_t)(DIRAM_HEAP_BUCKET_NS - heap_ctx.credit_ns) ?
+                             DIRAM_HEAP_BUCKET_NS : heap_ctx.credit_ns + (int64_t)earned;
+    }
+    heap_ctx.refill_ns = now_ns;
+}
+
+static void heap_charge(int64_t cost) {
+    heap_ctx.credit_ns -= cost;
+    if (heap_ctx.event_count < UINT8_MAX) heap_ctx.event_count++;
+}
+
+static void heap_refund(void) {
+    heap_ctx.credit_ns += heap_event_cost();
+    if (heap_ctx.credit_ns > DIRAM_HEAP_BUCKET_NS) heap_ctx.credit_ns = DIRAM_HEAP_BUCKET_NS;
+    if (heap_ctx.event_count > 0) heap_ctx.event_count--;
+}
+
+// Returns 0 when charged to this thread, 1 when prepaid, -1 on violation
+static int check_heap_constraint(uint64_t now_ns) {
+    if (heap_prepaid > 0) {
+        heap_prepaid--;
+        return 1;
     }
     
-    // Enforce e(x) = 0.6 constraint (max 3 events)
-    if (heap_ctx.event_count >= DIRAM_MAX_HEAP_EVENTS) {
+    // Enforce e(x) = 0.6 as a rate rather than a per-second cliff
+    int64_t cost = heap_event_cost();
+    heap_refill(now_ns);
+    if (heap_ctx.credit_ns < cost) {
         return -1;  // Constraint violation
     }
     
-    heap_ctx.event_count++;
+    heap_charge(cost);
     return 0;
 }
 
-int diram_init_trace_log(void) {
-    pthread_mutex_lock(&trace_mutex);
+int diram_heap_event_reserve(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
     
-    if (trace_log != NULL) {
-        pthread_mutex_unlock(&trace_mutex);
-        return 0;  // Already initialized
-    }
+    // The reservation itself must not consume a prepaid event
+    uint32_t prepaid = heap_prepaid;
+    heap_prepaid = 0;
+    int result = check_heap_constraint(timespec_ns(&ts));
+    heap_prepaid = prepaid;
+    return result < 0 ? -1 : 0;
+}
+
+int64_t diram_heap_event_reserve_deferred(uint64_t max_wait_ns) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    int64_t cost = heap_event_cost();
+    heap_refill(timespec_ns(&ts));
     
-    trace_log = fopen(DIRAM_TRACE_LOG_PATH, "a");
-    if (trace_log == NULL) {
-        pthread_mutex_unlock(&trace_mutex);
+    // Borrow: the event is due once the balance climbs back to zero
+    int64_t wait_ns = cost - heap_ctx.credit_ns;
+    if (wait_ns < 0) wait_ns = 0;
+    if ((uint64_t)wait_ns > max_wait_ns) {
         return -1;
     }
     
-    // Enable line buffering for immediate trace visibility
-    setvbuf(trace_log, NULL, _IOLBF, 0);
-    
-    // Write header
-    fprintf(trace_log, "# DIRAM Allocation Trace Log\n");
-    fprintf(trace_log, "# Format: TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG\n");
-    fflush(trace_log);
-    
-    pthread_mutex_unlock(&trace_mutex);
+    heap_charge(cost);
+    return wait_ns;
+}
+
+void diram_heap_event_unreserve(void) {
+    heap_refund();
+}
+
+void diram_heap_event_prepaid(void) {
+    heap_prepaid++;
+}
+
+void diram_heap_epoch_begin(void) {
+    heap_ctx.event_count = 0;
+    heap_ctx.refill_ns = 0;  // Next charge starts from a full bucket
+}
+
+int diram_heap_mode_from_string(const char* value, diram_heap_mode_t* out) {
+    if (!value || !out) return -1;
+    // Values may carry trailing comments, so match by prefix
+    if (strncmp(value, "defer", 5) == 0) {
+        *out = DIRAM_HEAP_MODE_DEFER;
+    } else if (strncmp(value, "reject", 6) == 0) {
+        *out = DIRAM_HEAP_MODE_REJECT;
+    } else {
+        return -1;
+    }
     return 0;
 }
 
-void diram_close_trace_log(void) {
-    pthread_mutex_lock(&trace_mutex);
-    if (trace_log != NULL) {
-        fclose(trace_log);
-        trace_log = NULL;
+void diram_heap_set_mode(diram_heap_mode_t mode) {
+    atomic_store_explicit(&g_heap_mode, (int)mode, memory_order_relaxed);
+}
+
+diram_heap_mode_t diram_heap_get_mode(void) {
+    return (diram_heap_mode_t)atomic_load_explicit(&g_heap_mode, memory_order_relaxed);
+}
+
+static void live_shard_reset(diram_live_shard_t* shard) {
+    pthread_mutex_init(&shard->lock, NULL);
+    shard->head.prev = shard->head.next = &shard->head;
+    shard->count = 0;
+}
+
+static void live_splice(diram_live_shard_t* from, diram_live_shard_t* to) {
+    if (from->count == 0) return;
+    diram_live_node_t* first = from->head.next;
+    diram_live_node_t* last = from->head.prev;
+    first->prev = to->head.prev;
+    to->head.prev->next = first;
+    last->next = &to->head;
+    to->head.prev = last;
+    to->count += from->count;
+    from->head.prev = from->head.next = &from->head;
+    from->count = 0;
+}
+
+static void live_atfork_prepare(void) {
+    pthread_mutex_lock(&g_live_inherited.lock);
+    for (int i = 0; i < DIRAM_LIVE_SHARDS; i++) {
+        pthread_mutex_lock(&g_live_shards[i].lock);
+    }
+}
+
+static void live_atfork_parent(void) {
+    for (int i = DIRAM_LIVE_SHARDS - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&g_live_shards[i].lock);
+    }
+    pthread_mutex_unlock(&g_live_inherited.lock);
+}
+
+static void live_atfork_child(void) {
+    pthread_mutex_init(&g_live_inherited.lock, NULL);
+    for (int i = 0; i < DIRAM_LIVE_SHARDS; i++) {
+        live_splice(&g_live_shards[i], &g_live_inherited);
+        pthread_mutex_init(&g_live_shards[i].lock, NULL);
     }
-    pthread_mutex_unlock(&trace_mutex);
+    g_fork_generation++;
+    g_alloc_pid = getpid();
+}
+
+static void live_init(void) {
+    live_shard_reset(&g_live_inherited);
+    for (int i = 0; i < DIRAM_LIVE_SHARDS; i++) {
+        live_shard_reset(&g_live_shards[i]);
+    }
+    g_alloc_pid = getpid();
+    pthread_atfork(live_atfork_prepare, live_atfork_parent, live_atfork_child);
+}
+
+static pid_t alloc_pid(void) {
+    pthread_once(&g_live_once, live_init);
+    return g_alloc_pid;
+}
+
+static void live_insert(diram_live_node_t* node, int is_region) {
+    pthread_once(&g_live_once, live_init);
+    if (t_live_shard < 0) {
+        t_live_shard = (int)(atomic_fetch_add_explicit(&g_live_next_shard, 1, memory_order_relaxed)
+                             % DIRAM_LIVE_SHARDS);
+    }
+
+    diram_live_shard_t* shard = &g_live_shards[t_live_shard];
+    node->generation = g_fork_generation;
+    node->shard = (uint8_t)t_live_shard;
+    node->is_region = (uint8_t)is_region;
+
+    pthread_mutex_lock(&shard->lock);
+    node->prev = &shard->head;
+    node->next = shard->head.next;
+    shard->head.next->prev = node;
+    shard->head.next = node;
+    shard->count++;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+static void live_remove(diram_live_node_t* node) {
+    // Anything from an earlier generation was spliced away at fork
+    diram_live_shard_t* shard = node->generation == g_fork_generation ?
+                                &g_live_shards[node->shard] : &g_live_inherited;
+    pthread_mutex_lock(&shard->lock);
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    shard->count--;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+size_t diram_fork_release_inherited(void) {
+    pthread_once(&g_live_once, live_init);
+
+    pthread_mutex_lock(&g_live_inherited.lock);
+    diram_live_node_t* node = g_live_inherited.head.next;
+    size_t released = g_live_inherited.count;
+    g_live_inherited.head.prev = g_live_inherited.head.next = &g_live_inherited.head;
+    g_live_inherited.count = 0;
+    pthread_mutex_unlock(&g_live_inherited.lock);
+
+    // Detached from the list, so no other free can reach these links
+    diram_alloc_index_drop_inherited();
+    while (node != &g_live_inherited.head) {
+        diram_live_node_t* next = node->next;
+        if (node->is_region) {
+            diram_slab_free((char*)node - offsetof(diram_batch_region_t, node));
+        } else {
+            diram_slab_free((char*)node - offsetof(diram_allocation_t, live));
+        }
+        node = next;
+    }
+    return released;
+}
+
+size_t diram_fork_inherited_count(void) {
+    pthread_once(&g_live_once, live_init);
+    pthread_mutex_lock(&g_live_inherited.lock);
+    size_t count = g_live_inherited.count;
+    pthread_mutex_unlock(&g_live_inherited.lock);
+    return count;
+}
+
+int diram_init_trace_log(void) {
+    return diram_init_trace_log_ex(DIRAM_TRACE_FORMAT_TEXT);
+}
+
+int diram_init_trace_log_ex(diram_trace_format_t format) {
+    // Records are queued per thread and written by the trace writer thread
+    const char* path = (format == DIRAM_TRACE_FORMAT_BINARY) ?
+                       DIRAM_TRACE_BIN_PATH : DIRAM_TRACE_LOG_PATH;
+    return diram_trace_ring_start(format, path);
+}
+
+void diram_close_trace_log(void) {
+    // Drains every queued record before the file is closed
+    diram_trace_ring_stop();
+}
+
+int diram_flush_trace_log(void) {
+    return diram_trace_ring_flush();
 }
 
 diram_allocation_t* diram_alloc_traced(size_t size, const char* tag) {
-    // Get current timestamp for epoch checking
+    return diram_alloc_traced_ex(size, tag, sizeof(diram_allocation_t));
+}
+
+diram_allocation_t* diram_alloc_traced_ex(size_t size, const char* tag,
+                                          size_t tracker_size) {
+    return diram_alloc_traced_flags(size, tag, tracker_size, 0);
+}
+
+diram_allocation_t* diram_alloc_traced_flags(size_t size, const char* tag,
+                                             size_t tracker_size, uint32_t flags) {
+    if (tracker_size < sizeof(diram_allocation_t) ||
+        tracker_size > SIZE_MAX - DIRAM_SLAB_ALIGN) {
+        return NULL;
+    }
+    
+    // Tracker and payload share one slab block: [tracker | pad | payload]
+    size_t header = DIRAM_SLAB_ALIGN_UP(tracker_size);
+    if (size > SIZE_MAX - header - DIRAM_SLAB_ALIGN) {
+        return NULL;
+    }
+    
+    // Get current timestamp for the credit refill
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
-    uint64_t current_epoch = ts.tv_sec;
     
     // Check heap event constraint
-    if (check_heap_constraint(current_epoch) < 0) {
+    int charged = check_heap_constraint(timespec_ns(&ts));
+    if (charged < 0) {
         // Constraint violation - defer allocation
         return NULL;
     }
     
-    // Allocate tracking structure
-    diram_allocation_t* alloc = malloc(sizeof(diram_allocation_t));
+    diram_allocation_t* alloc = (flags & DIRAM_ALLOC_GUARDED) ?
+        diram_slab_alloc_guarded(header + size) : diram_slab_alloc(header + size);
     if (alloc == NULL) {
-        heap_ctx.event_count--;  // Rollback counter
+        if (charged == 0) heap_refund();  // Rollback credit
         return NULL;
     }
     
-    // Perform actual memory allocation
-    alloc->base_addr = malloc(size);
-    if (alloc->base_addr == NULL) {
-        free(alloc);
-        heap_ctx.event_count--;  // Rollback counter
-        return NULL;
-    }
+    alloc->base_addr = (char*)alloc + header;
     
     // Initialize allocation metadata
     alloc->size = size;
     alloc->timestamp = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
     alloc->heap_events = heap_ctx.event_count;
-    alloc->binding_pid = getpid();
+    alloc->binding_pid = alloc_pid();
+    alloc->region = NULL;
+    alloc_set_tag(alloc, tag);
+    if (diram_alloc_index_insert(alloc) < 0) {
+        diram_slab_free(alloc);
+        if (charged == 0) heap_refund();
+        return NULL;
+    }
+    live_insert(&alloc->live, 0);
     
     // Generate SHA-256 receipt
     diram_compute_receipt(alloc, tag);
     
-    // Write trace entry (no runtime reflection)
-    pthread_mutex_lock(&trace_mutex);
-    if (trace_log != NULL) {
-        fprintf(trace_log, "%lu|%d|ALLOC|%p|%zu|%s|%s\n",
-                alloc->timestamp,
-                alloc->binding_pid,
-                alloc->base_addr,
-                alloc->size,
-                alloc->sha256_receipt,
-                tag ? tag : "untagged");
-        fflush(trace_log);
+    // Queue trace entry (no runtime reflection, no lock)
+    if (diram_trace_ring_active()) {
+        diram_trace_record_t record;
+        diram_trace_record_fill(&record, DIRAM_TRACE_OP_ALLOC,
+                                alloc->timestamp, alloc->binding_pid,
+                                alloc->base_addr, alloc->size,
+                                alloc->sha256_receipt, tag);
+        diram_trace_ring_push(&record);
     }
-    pthread_mutex_unlock(&trace_mutex);
     
     return alloc;
 }
 
-void diram_free_traced(diram_allocation_t* alloc) {
-    if (alloc == NULL) {
-        return;
+int diram_alloc_batch(size_t n, const size_t* sizes, const char* tag,
+                      diram_allocation_t** out) {
+    return diram_alloc_batch_ex(n, sizes, tag, sizeof(diram_allocation_t), out);
+}
+
+int diram_alloc_batch_ex(size_t n, const size_t* sizes, const char* tag,
+                         size_t tracker_size, diram_allocation_t** out) {
+    if (n == 0 || sizes == NULL || out == NULL ||
+        tracker_size < sizeof(diram_allocation_t)) {
+        return -1;
+    }
+    
+    // Region layout: [batch header | tracker 0 | payload 0 | tracker 1 | ...]
+    size_t header = DIRAM_SLAB_ALIGN_UP(tracker_size);
+    size_t total = DIRAM_BATCH_HEADER;
+    for (size_t i = 0; i < n; i++) {
+        if (sizes[i] > SIZE_MAX - header - DIRAM_SLAB_ALIGN) {
+            return -1;
+        }
+        size_t span = header + DIRAM_SLAB_ALIGN_UP(sizes[i]);
+        if (total > SIZE_MAX - span) {
+            return -1;
+        }
+        total += span;
+    }
+    
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    // The whole batch is one heap event
+    int charged = check_heap_constraint(timespec_ns(&ts));
+    if (charged < 0) {
+        return -1;
+    }
+    
+    diram_batch_region_t* region = diram_slab_alloc(total);
+    if (region == NULL) {
+        if (charged == 0) heap_refund();  // Rollback credit
+        return -1;
+    }
+    region->count = n;
+    region->live = n;
+    live_insert(&region->node, 1);
+    
+    uint64_t timestamp = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    pid_t pid = alloc_pid();
+    char* cursor = (char*)region + DIRAM_BATCH_HEADER;
+    size_t payload_bytes = 0;
+    int tracing = diram_trace_ring_active();
+    
+    // Receipts are hashed DIRAM_SHA256_LANES at a time and chained into
+    // the range receipt in allocation order
+    diram_receipt_input_t inputs[DIRAM_SHA256_LANES];
+    const void* lane_inputs[DIRAM_SHA256_LANES];
+    char* lane_receipts[DIRAM_SHA256_LANES];
+    diram_sha256_ctx_t range_ctx;
+    diram_sha256_init(&range_ctx);
+    
+    for (size_t i = 0; i < n; i++) {
+        diram_allocation_t* alloc = (diram_allocation_t*)cursor;
+        alloc->base_addr = cursor + header;
+        alloc->size = sizes[i];
+        alloc->timestamp = timestamp;
+        alloc->heap_events = heap_ctx.event_count;
+        alloc->binding_pid = pid;
+        alloc->region = region;
+        alloc_set_tag(alloc, tag);
+        if (diram_alloc_index_insert(alloc) < 0) {
+            // Unwind the members indexed so far and the whole region
+            for (size_t k = 0; k < i; k++) diram_alloc_index_remove(out[k]);
+            live_remove(&region->node);
+            diram_slab_free(region);
+            if (charged == 0) heap_refund();
+            return -1;
+        }
+        cursor += header + DIRAM_SLAB_ALIGN_UP(sizes[i]);
+        payload_bytes += sizes[i];
+        out[i] = alloc;
+        
+        size_t lane = i % DIRAM_SHA256_LANES;
+        receipt_input_fill(&inputs[lane], alloc, tag);
+        lane_inputs[lane] = &inputs[lane];
+        lane_receipts[lane] = alloc->sha256_receipt;
+        
+        if (lane == DIRAM_SHA256_LANES - 1 || i == n - 1) {
+            diram_receipt_hex_lanes(lane_inputs, lane + 1,
+                                    sizeof(diram_receipt_input_t), lane_receipts);
+            for (size_t k = 0; tracing && k <= lane; k++) {
+                diram_sha256_update(&range_ctx, lane_receipts[k],
+                                    strlen(lane_receipts[k]));
+            }
+        }
     }
     
-    // Verify PID binding for fork safety
-    if (alloc->binding_pid != getpid()) {
-        // Fork detected - this allocation belongs to parent process
-        // In production, implement proper fork handling
+    // One trace record covers the whole range
+    if (tracing) {
+        uint8_t digest[DIRAM_SHA256_DIGEST_LEN];
+        char range_receipt[DIRAM_SHA256_HEX_LEN];
+        diram_sha256_final(&range_ctx, digest);
+        diram_hex_encode(digest, sizeof(digest), range_receipt);
+        
+        diram_trace_record_t record;
+        diram_trace_record_fill(&record, DIRAM_TRACE_OP_ALLOC_RANGE,
+                                timestamp, pid, out[0]->base_addr,
+                                payload_bytes, range_receipt, tag);
+        record.count = n;
+        diram_trace_ring_push(&record);
+    }
+    
+    return 0;
+}
+
+// Allocations inherited across fork() are the child's own copy-on-write
+// copies, so they are adopted and released here like any other
+void diram_free_traced(diram_allocation_t* alloc) {
+    if (alloc == NULL) {
         return;
     }
     
@@ -192,23 +566,39 @@ void diram_free_traced(diram_allocation_t* alloc) {
     clock_gettime(CLOCK_MONOTONIC, &ts);
     uint64_t timestamp = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
     
-    // Write trace entry before freeing
-    pthread_mutex_lock(&trace_mutex);
-    if (trace_log != NULL) {
-        fprintf(trace_log, "%lu|%d|FREE|%p|%zu|%s|traced\n",
-                timestamp,
-                getpid(),
-                alloc->base_addr,
-                alloc->size,
-                alloc->sha256_receipt);
-        fflush(trace_log);
+    // Queue trace entry before freeing
+    if (diram_trace_ring_active()) {
+        diram_trace_record_t record;
+        diram_trace_record_fill(&record, DIRAM_TRACE_OP_FREE,
+                                timestamp, alloc_pid(),
+                                alloc->base_addr, alloc->size,
+                                alloc->sha256_receipt, "traced");
+        diram_trace_ring_push(&record);
     }
-    pthread_mutex_unlock(&trace_mutex);
     
-    // Free memory
-    free(alloc->base_addr);
+    diram_alloc_index_remove(alloc);
     
-    // Clear sensitive data before freeing tracker
+    // Clear sensitive data, then release tracker and payload together
+    diram_batch_region_t* region = alloc->region;
+    if (region == NULL) {
+        live_remove(&alloc->live);
+        memset(alloc, 0, sizeof(diram_allocation_t));
+        diram_slab_free(alloc);
+        return;
+    }
     memset(alloc, 0, sizeof(diram_allocation_t));
-    free(alloc);
+    if (__atomic_sub_fetch(&region->live, 1, __ATOMIC_ACQ_REL) == 0) {
+        // Last member of a batch returns the shared region
+        live_remove(&region->node);
+        diram_slab_free(region);
+    }
+}
+
+int diram_free(void* address) {
+    diram_allocation_t* alloc = diram_alloc_lookup(address);
+    if (alloc == NULL) {
+        return -1;
+    }
+    diram_free_traced(alloc);
+    return 0;
 }
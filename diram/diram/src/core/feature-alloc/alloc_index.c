@@ -0,0 +1,244 @@
+// core/feature-alloc/alloc_index.c
+// Address index of live traced allocations: sharded linear-probing tables
+// OBINexus Project - Directed Instruction RAM
+
+#include "diram/core/feature-alloc/alloc_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define INDEX_INITIAL_CAPACITY 64
+#define INDEX_SHARD_SHIFT 59        // 64 - log2(DIRAM_ALLOC_INDEX_SHARDS)
+
+typedef struct {
+    uintptr_t address;              // Payload address, 0 for an empty slot
+    diram_allocation_t* alloc;
+    uint32_t generation;            // Fork generation that indexed it
+} index_entry_t;
+
+typedef struct {
+    _Alignas(64) pthread_mutex_t lock;
+    index_entry_t* entries;
+    size_t capacity;                // Power of two, 0 before the first insert
+    size_t count;
+} index_shard_t;
+
+static index_shard_t g_index_shards[DIRAM_ALLOC_INDEX_SHARDS];
+static pthread_once_t g_index_once = PTHREAD_ONCE_INIT;
+static atomic_size_t g_index_count = 0;
+
+// Written only by the single-threaded atfork child handler
+static uint32_t g_index_generation = 0;
+
+static void index_atfork_prepare(void) {
+    for (int i = 0; i < DIRAM_ALLOC_INDEX_SHARDS; i++) {
+        pthread_mutex_lock(&g_index_shards[i].lock);
+    }
+}
+
+static void index_atfork_parent(void) {
+    for (int i = DIRAM_ALLOC_INDEX_SHARDS - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&g_index_shards[i].lock);
+    }
+}
+
+static void index_atfork_child(void) {
+    for (int i = 0; i < DIRAM_ALLOC_INDEX_SHARDS; i++) {
+        pthread_mutex_init(&g_index_shards[i].lock, NULL);
+    }
+    g_index_generation++;
+}
+
+static void index_init(void) {
+    for (int i = 0; i < DIRAM_ALLOC_INDEX_SHARDS; i++) {
+        pthread_mutex_init(&g_index_shards[i].lock, NULL);
+    }
+    pthread_atfork(index_atfork_prepare, index_atfork_parent, index_atfork_child);
+}
+
+// Payloads are 16-byte aligned, so the low bits carry nothing
+static uint64_t address_hash(uintptr_t address) {
+    uint64_t hash = ((uint64_t)address >> 4) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+
+static index_shard_t* shard_for(uintptr_t address, uint64_t* hash) {
+    pthread_once(&g_index_once, index_init);
+    *hash = address_hash(address);
+    return &g_index_shards[*hash >> INDEX_SHARD_SHIFT];
+}
+
+static size_t find_slot(const index_shard_t* shard, uintptr_t address, uint64_t hash) {
+    size_t mask = shard->capacity - 1;
+    size_t slot = hash & mask;
+    while (shard->entries[slot].address != 0 && shard->entries[slot].address != address) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int shard_grow(index_shard_t* shard) {
+    size_t capacity = shard->capacity ? shard->capacity * 2 : INDEX_INITIAL_CAPACITY;
+    index_entry_t* entries = calloc(capacity, sizeof(index_entry_t));
+    if (entries == NULL) {
+        return -1;
+    }
+
+    index_entry_t* old = shard->entries;
+    size_t old_capacity = shard->capacity;
+    shard->entries = entries;
+    shard->capacity = capacity;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].address != 0) {
+            shard->entries[find_slot(shard, old[i].address, address_hash(old[i].address))] = old[i];
+        }
+    }
+    free(old);
+    return 0;
+}
+
+// Backward-shift deletion: later entries of the probe run move up so
+// lookups never need tombstones
+static void remove_slot(index_shard_t* shard, size_t hole) {
+    size_t mask = shard->capacity - 1;
+    size_t next = hole;
+    for (;;) {
+        next = (next + 1) & mask;
+        uintptr_t address = shard->entries[next].address;
+        if (address == 0) {
+            break;
+        }
+        size_t home = address_hash(address) & mask;
+        // The entry may fill the hole unless its home lies in (hole, next]
+        int stays = (hole <= next) ? (home > hole && home <= next)
+                                   : (home > hole || home <= next);
+        if (!stays) {
+            shard->entries[hole] = shard->entries[next];
+            hole = next;
+        }
+    }
+    shard->entries[hole].address = 0;
+    shard->entries[hole].alloc = NULL;
+    shard->count--;
+    atomic_fetch_sub_explicit(&g_index_count, 1, memory_order_relaxed);
+}
+
+int diram_alloc_index_insert(diram_allocation_t* alloc) {
+    if (alloc == NULL || alloc->base_addr == NULL) {
+        return -1;
+    }
+    uintptr_t address = (uintptr_t)alloc->base_addr;
+    uint64_t hash;
+    index_shard_t* shard = shard_for(address, &hash);
+
+    pthread_mutex_lock(&shard->lock);
+    // Keep the load factor at or under 3/4
+    if ((shard->count + 1) * 4 > shard->capacity * 3 && shard_grow(shard) < 0) {
+        pthread_mutex_unlock(&shard->lock);
+        return -1;
+    }
+    size_t slot = find_slot(shard, address, hash);
+    if (shard->entries[slot].address == 0) {
+        shard->count++;
+        atomic_fetch_add_explicit(&g_index_count, 1, memory_order_relaxed);
+    }
+    shard->entries[slot].address = address;
+    shard->entries[slot].alloc = alloc;
+    shard->entries[slot].generation = g_index_generation;
+    pthread_mutex_unlock(&shard->lock);
+    return 0;
+}
+
+void diram_alloc_index_remove(const diram_allocation_t* alloc) {
+    if (alloc == NULL || alloc->base_addr == NULL) {
+        return;
+    }
+    uintptr_t address = (uintptr_t)alloc->base_addr;
+    uint64_t hash;
+    index_shard_t* shard = shard_for(address, &hash);
+
+    pthread_mutex_lock(&shard->lock);
+    if (shard->capacity != 0) {
+        size_t slot = find_slot(shard, address, hash);
+        if (shard->entries[slot].address == address && shard->entries[slot].alloc == alloc) {
+            remove_slot(shard, slot);
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+}
+
+size_t diram_alloc_index_drop_inherited(void) {
+    pthread_once(&g_index_once, index_init);
+    size_t dropped = 0;
+    for (int s = 0; s < DIRAM_ALLOC_INDEX_SHARDS; s++) {
+        index_shard_t* shard = &g_index_shards[s];
+        pthread_mutex_lock(&shard->lock);
+        // A removal shifts later entries into slot i, so look at it again
+        for (size_t i = 0; i < shard->capacity; i++) {
+            while (shard->entries[i].address != 0 &&
+                   shard->entries[i].generation != g_index_generation) {
+                remove_slot(shard, i);
+                dropped++;
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return dropped;
+}
+
+diram_allocation_t* diram_alloc_lookup(const void* address) {
+    if (address == NULL) {
+        return NULL;
+    }
+    uint64_t hash;
+    index_shard_t* shard = shard_for((uintptr_t)address, &hash);
+    diram_allocation_t* alloc = NULL;
+
+    pthread_mutex_lock(&shard->lock);
+    if (shard->capacity != 0) {
+        size_t slot = find_slot(shard, (uintptr_t)address, hash);
+        alloc = shard->entries[slot].alloc;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return alloc;
+}
+
+size_t diram_alloc_live_count(void) {
+    return atomic_load_explicit(&g_index_count, memory_order_relaxed);
+}
+
+size_t diram_alloc_foreach(diram_alloc_visit_t visit, void* context) {
+    if (visit == NULL) {
+        return 0;
+    }
+    pthread_once(&g_index_once, index_init);
+    size_t visited = 0;
+    int stop = 0;
+    for (int s = 0; s < DIRAM_ALLOC_INDEX_SHARDS && !stop; s++) {
+        index_shard_t* shard = &g_index_shards[s];
+        pthread_mutex_lock(&shard->lock);
+        for (size_t i = 0; i < shard->capacity && !stop; i++) {
+            if (shard->entries[i].address != 0) {
+                visited++;
+                stop = visit(shard->entries[i].alloc, context);
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return visited;
+}
+
+static int report_leak(diram_allocation_t* alloc, void* context) {
+    fprintf((FILE*)context, "LEAK %p %zu bytes tag=%s pid=%d receipt=%.16s...\n",
+            alloc->base_addr, alloc->size, alloc->tag[0] ? alloc->tag : "untagged",
+            (int)alloc->binding_pid, alloc->sha256_receipt);
+    return 0;
+}
+
+size_t diram_alloc_report_leaks(FILE* out) {
+    if (out == NULL) {
+        return 0;
+    }
+    return diram_alloc_foreach(report_leak, out);
+}
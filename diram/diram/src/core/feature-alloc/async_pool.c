@@ -0,0 +1,435 @@
+// core/feature-alloc/async_pool.c
+// Bounded work-stealing pool: one deque per worker, owners pop LIFO from
+// the bottom, idle workers steal FIFO from the top of their neighbours.
+// The bound is global (max_pending), so no single deque can overflow.
+// Delayed tasks wait in a min-heap under idle_lock; an idle worker sleeps
+// until the earliest deadline and moves due tasks onto its own deque.
+#include "diram/core/feature-alloc/async_pool.h"
+#include "diram/core/config/config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+    diram_async_task_fn fn;
+    void* arg;
+} pool_task_t;
+
+typedef struct {
+    uint64_t ready_ns;      // CLOCK_MONOTONIC
+    pool_task_t task;
+} pool_delayed_t;
+
+typedef struct {
+    _Alignas(64) pthread_mutex_t lock;
+    pool_task_t* slots;
+    size_t mask;
+    size_t top;         // Steal end
+    size_t bottom;      // Owner end
+    pthread_t thread;
+    size_t index;
+} pool_worker_t;
+
+static struct {
+    pool_worker_t* workers;
+    size_t nworkers;
+    size_t max_pending;
+
+    atomic_size_t pending;      // Admitted and not yet finished
+    atomic_size_t queued;       // Sitting in a deque
+    atomic_size_t sleepers;
+    atomic_size_t next_worker;  // Round-robin target for external submits
+    atomic_int running;
+
+    atomic_uint_fast64_t submitted;
+    atomic_uint_fast64_t executed;
+    atomic_uint_fast64_t stolen;
+    atomic_uint_fast64_t rejected;
+    atomic_uint_fast64_t deferred;
+
+    pthread_mutex_t idle_lock;
+    pthread_cond_t idle_cond;   // CLOCK_MONOTONIC once started
+    pool_delayed_t* delayed;    // Min-heap by ready_ns, under idle_lock
+    size_t delayed_count;
+    atomic_uint_fast64_t next_due_ns;   // UINT64_MAX when nothing is parked
+    atomic_int initialized;
+} g_pool = {
+    .idle_lock = PTHREAD_MUTEX_INITIALIZER,
+    .idle_cond = PTHREAD_COND_INITIALIZER
+};
+
+static pthread_mutex_t g_pool_init_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_pool_atfork_once = PTHREAD_ONCE_INIT;
+static __thread pool_worker_t* t_worker = NULL;
+
+static uint64_t pool_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void delayed_push(pool_delayed_t entry) {
+    size_t i = g_pool.delayed_count++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (g_pool.delayed[parent].ready_ns <= entry.ready_ns) break;
+        g_pool.delayed[i] = g_pool.delayed[parent];
+        i = parent;
+    }
+    g_pool.delayed[i] = entry;
+}
+
+static pool_delayed_t delayed_pop(void) {
+    pool_delayed_t top = g_pool.delayed[0];
+    pool_delayed_t last = g_pool.delayed[--g_pool.delayed_count];
+    size_t n = g_pool.delayed_count, i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && g_pool.delayed[child + 1].ready_ns < g_pool.delayed[child].ready_ns) {
+            child++;
+        }
+        if (last.ready_ns <= g_pool.delayed[child].ready_ns) break;
+        g_pool.delayed[i] = g_pool.delayed[child];
+        i = child;
+    }
+    if (n > 0) g_pool.delayed[i] = last;
+    return top;
+}
+
+static void delayed_publish_head(void) {
+    atomic_store_explicit(&g_pool.next_due_ns,
+                          g_pool.delayed_count ? g_pool.delayed[0].ready_ns : UINT64_MAX,
+                          memory_order_release);
+}
+
+// Move due (or, at shutdown, all) parked tasks onto self's deque; call
+// with idle_lock held
+static size_t pool_promote_locked(pool_worker_t* self, uint64_t now) {
+    int draining = !atomic_load_explicit(&g_pool.running, memory_order_acquire);
+    size_t moved = 0;
+
+    pthread_mutex_lock(&self->lock);
+    while (g_pool.delayed_count > 0 &&
+           (draining || g_pool.delayed[0].ready_ns <= now)) {
+        self->slots[self->bottom & self->mask] = delayed_pop().task;
+        self->bottom++;
+        moved++;
+    }
+    pthread_mutex_unlock(&self->lock);
+
+    if (moved > 0) {
+        delayed_publish_head();
+        atomic_fetch_add_explicit(&g_pool.queued, moved, memory_order_seq_cst);
+        // Let siblings steal the rest
+        if (moved > 1) pthread_cond_broadcast(&g_pool.idle_cond);
+    }
+    return moved;
+}
+
+static void pool_promote_due(pool_worker_t* self) {
+    if (atomic_load_explicit(&g_pool.next_due_ns, memory_order_acquire) > pool_now_ns() &&
+        atomic_load_explicit(&g_pool.running, memory_order_acquire)) {
+        return;
+    }
+    pthread_mutex_lock(&g_pool.idle_lock);
+    pool_promote_locked(self, pool_now_ns());
+    pthread_mutex_unlock(&g_pool.idle_lock);
+}
+
+static int pool_take(pool_worker_t* self, pool_task_t* task) {
+    // Own deque first, newest task (still cache-warm)
+    pthread_mutex_lock(&self->lock);
+    if (self->bottom != self->top) {
+        self->bottom--;
+        *task = self->slots[self->bottom & self->mask];
+        pthread_mutex_unlock(&self->lock);
+        atomic_fetch_sub_explicit(&g_pool.queued, 1, memory_order_seq_cst);
+        return 1;
+    }
+    pthread_mutex_unlock(&self->lock);
+
+    // Then steal the oldest task from the other workers
+    for (size_t i = 1; i < g_pool.nworkers; i++) {
+        pool_worker_t* victim = &g_pool.workers[(self->index + i) % g_pool.nworkers];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->bottom != victim->top) {
+            *task = victim->slots[victim->top & victim->mask];
+            victim->top++;
+            pthread_mutex_unlock(&victim->lock);
+            atomic_fetch_sub_explicit(&g_pool.queued, 1, memory_order_seq_cst);
+            atomic_fetch_add_explicit(&g_pool.stolen, 1, memory_order_relaxed);
+            return 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+    return 0;
+}
+
+static void* pool_worker_main(void* arg) {
+    pool_worker_t* self = (pool_worker_t*)arg;
+    pool_task_t task;
+    t_worker = self;
+
+    for (;;) {
+        pool_promote_due(self);
+        if (pool_take(self, &task)) {
+            task.fn(task.arg);
+            atomic_fetch_add_explicit(&g_pool.executed, 1, memory_order_relaxed);
+            atomic_fetch_sub_explicit(&g_pool.pending, 1, memory_order_release);
+            continue;
+        }
+
+        // Shutdown only once every queued and parked task has run
+        pthread_mutex_lock(&g_pool.idle_lock);
+        atomic_fetch_add_explicit(&g_pool.sleepers, 1, memory_order_seq_cst);
+        while (atomic_load_explicit(&g_pool.queued, memory_order_seq_cst) == 0 &&
+               atomic_load_explicit(&g_pool.running, memory_order_acquire)) {
+            if (g_pool.delayed_count == 0) {
+                pthread_cond_wait(&g_pool.idle_cond, &g_pool.idle_lock);
+                continue;
+            }
+            uint64_t now = pool_now_ns();
+            if (pool_promote_locked(self, now) > 0) break;
+
+            uint64_t due = g_pool.delayed[0].ready_ns;
+            struct timespec deadline = {
+                .tv_sec = (time_t)(due / 1000000000ULL),
+                .tv_nsec = (long)(due % 1000000000ULL)
+            };
+            pthread_cond_timedwait(&g_pool.idle_cond, &g_pool.idle_lock, &deadline);
+        }
+        atomic_fetch_sub_explicit(&g_pool.sleepers, 1, memory_order_relaxed);
+        int done = !atomic_load_explicit(&g_pool.running, memory_order_acquire) &&
+                   atomic_load_explicit(&g_pool.queued, memory_order_seq_cst) == 0 &&
+                   g_pool.delayed_count == 0;
+        pthread_mutex_unlock(&g_pool.idle_lock);
+        if (done) break;
+    }
+
+    t_worker = NULL;
+    return NULL;
+}
+
+// The child of a fork has none of the worker threads; start over lazily
+static void pool_atfork_child(void) {
+    g_pool.workers = NULL;
+    g_pool.nworkers = 0;
+    g_pool.initialized = 0;
+    g_pool.delayed = NULL;
+    g_pool.delayed_count = 0;
+    atomic_store(&g_pool.next_due_ns, UINT64_MAX);
+    atomic_store(&g_pool.pending, 0);
+    atomic_store(&g_pool.queued, 0);
+    atomic_store(&g_pool.sleepers, 0);
+    atomic_store(&g_pool.running, 0);
+    pthread_mutex_init(&g_pool.idle_lock, NULL);
+    pthread_cond_init(&g_pool.idle_cond, NULL);
+    pthread_mutex_init(&g_pool_init_lock, NULL);
+    t_worker = NULL;
+}
+
+static void pool_register_atfork(void) {
+    pthread_atfork(NULL, NULL, pool_atfork_child);
+}
+
+static int pool_start_locked(size_t workers, size_t max_pending) {
+    if (max_pending == 0) {
+        int configured = diram_config_current()->max_pending_promises;
+        max_pending = configured > 0 ? (size_t)configured :
+                      DIRAM_ASYNC_DEFAULT_MAX_PENDING;
+    }
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (workers > DIRAM_ASYNC_POOL_MAX_WORKERS) workers = DIRAM_ASYNC_POOL_MAX_WORKERS;
+    if (workers > max_pending) workers = max_pending;
+
+    // Every deque can hold the whole bound
+    size_t capacity = 1;
+    while (capacity < max_pending) capacity <<= 1;
+
+    pool_delayed_t* delayed = calloc(max_pending, sizeof(pool_delayed_t));
+    pool_worker_t* pool = calloc(workers, sizeof(pool_worker_t));
+    if (!pool || !delayed) {
+        free(pool);
+        free(delayed);
+        return -1;
+    }
+    for (size_t i = 0; i < workers; i++) {
+        pool[i].slots = calloc(capacity, sizeof(pool_task_t));
+        if (!pool[i].slots) {
+            for (size_t j = 0; j < i; j++) free(pool[j].slots);
+            free(pool);
+            free(delayed);
+            return -1;
+        }
+        pthread_mutex_init(&pool[i].lock, NULL);
+        pool[i].mask = capacity - 1;
+        pool[i].index = i;
+    }
+
+    // No worker is waiting yet, so the condition can be rebuilt on the
+    // monotonic clock the parked deadlines use
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_destroy(&g_pool.idle_cond);
+    pthread_cond_init(&g_pool.idle_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    g_pool.workers = pool;
+    g_pool.nworkers = workers;
+    g_pool.max_pending = max_pending;
+    g_pool.delayed = delayed;
+    g_pool.delayed_count = 0;
+    atomic_store(&g_pool.next_due_ns, UINT64_MAX);
+    atomic_store(&g_pool.running, 1);
+
+    size_t started = 0;
+    for (; started < workers; started++) {
+        if (pthread_create(&pool[started].thread, NULL, pool_worker_main, &pool[started]) != 0) {
+            break;
+        }
+    }
+    if (started < workers) {
+        // Nothing has been queued yet, so the started workers exit at once
+        pthread_mutex_lock(&g_pool.idle_lock);
+        atomic_store(&g_pool.running, 0);
+        pthread_cond_broadcast(&g_pool.idle_cond);
+        pthread_mutex_unlock(&g_pool.idle_lock);
+        for (size_t i = 0; i < started; i++) pthread_join(pool[i].thread, NULL);
+        for (size_t i = 0; i < workers; i++) {
+            pthread_mutex_destroy(&pool[i].lock);
+            free(pool[i].slots);
+        }
+        free(pool);
+        free(delayed);
+        g_pool.workers = NULL;
+        g_pool.nworkers = 0;
+        g_pool.delayed = NULL;
+        return -1;
+    }
+
+    g_pool.initialized = 1;
+    pthread_once(&g_pool_atfork_once, pool_register_atfork);
+    return 0;
+}
+
+int diram_async_pool_init(size_t workers, size_t max_pending) {
+    pthread_mutex_lock(&g_pool_init_lock);
+    int result = g_pool.initialized ? 0 : pool_start_locked(workers, max_pending);
+    pthread_mutex_unlock(&g_pool_init_lock);
+    return result;
+}
+
+void diram_async_pool_shutdown(void) {
+    pthread_mutex_lock(&g_pool_init_lock);
+    if (!g_pool.initialized) {
+        pthread_mutex_unlock(&g_pool_init_lock);
+        return;
+    }
+
+    pthread_mutex_lock(&g_pool.idle_lock);
+    atomic_store_explicit(&g_pool.running, 0, memory_order_release);
+    pthread_cond_broadcast(&g_pool.idle_cond);
+    pthread_mutex_unlock(&g_pool.idle_lock);
+
+    for (size_t i = 0; i < g_pool.nworkers; i++) {
+        pthread_join(g_pool.workers[i].thread, NULL);
+    }
+    for (size_t i = 0; i < g_pool.nworkers; i++) {
+        pthread_mutex_destroy(&g_pool.workers[i].lock);
+        free(g_pool.workers[i].slots);
+    }
+    free(g_pool.workers);
+    free(g_pool.delayed);
+    g_pool.workers = NULL;
+    g_pool.nworkers = 0;
+    g_pool.delayed = NULL;
+    g_pool.initialized = 0;
+    pthread_mutex_unlock(&g_pool_init_lock);
+}
+
+static int pool_admit(diram_async_task_fn fn) {
+    if (!fn) return -1;
+
+    if (!g_pool.initialized && diram_async_pool_init(0, 0) < 0) {
+        return -1;
+    }
+
+    // Admission control: the bound covers queued, parked and running tasks
+    size_t in_flight = atomic_fetch_add_explicit(&g_pool.pending, 1, memory_order_acq_rel);
+    if (in_flight >= g_pool.max_pending) {
+        atomic_fetch_sub_explicit(&g_pool.pending, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&g_pool.rejected, 1, memory_order_relaxed);
+        return -1;
+    }
+    return 0;
+}
+
+int diram_async_pool_submit(diram_async_task_fn fn, void* arg) {
+    if (pool_admit(fn) < 0) return -1;
+
+    // Workers keep their own follow-up work; other threads spread it out
+    pool_worker_t* target = t_worker;
+    if (!target) {
+        size_t next = atomic_fetch_add_explicit(&g_pool.next_worker, 1, memory_order_relaxed);
+        target = &g_pool.workers[next % g_pool.nworkers];
+    }
+
+    pthread_mutex_lock(&target->lock);
+    target->slots[target->bottom & target->mask] = (pool_task_t){ fn, arg };
+    target->bottom++;
+    pthread_mutex_unlock(&target->lock);
+
+    atomic_fetch_add_explicit(&g_pool.submitted, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_pool.queued, 1, memory_order_seq_cst);
+
+    // Pairs with the sleepers/queued check in pool_worker_main
+    if (atomic_load_explicit(&g_pool.sleepers, memory_order_seq_cst) > 0) {
+        pthread_mutex_lock(&g_pool.idle_lock);
+        pthread_cond_signal(&g_pool.idle_cond);
+        pthread_mutex_unlock(&g_pool.idle_lock);
+    }
+    return 0;
+}
+
+int diram_async_pool_submit_after(diram_async_task_fn fn, void* arg, uint64_t delay_ns) {
+    if (delay_ns == 0) return diram_async_pool_submit(fn, arg);
+    if (pool_admit(fn) < 0) return -1;
+
+    pool_delayed_t entry = { pool_now_ns() + delay_ns, { fn, arg } };
+
+    // Admission bounds the heap at max_pending entries
+    pthread_mutex_lock(&g_pool.idle_lock);
+    delayed_push(entry);
+    delayed_publish_head();
+    // Sleepers may be waiting on a later deadline
+    pthread_cond_broadcast(&g_pool.idle_cond);
+    pthread_mutex_unlock(&g_pool.idle_lock);
+
+    atomic_fetch_add_explicit(&g_pool.submitted, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_pool.deferred, 1, memory_order_relaxed);
+    return 0;
+}
+
+void diram_async_pool_get_stats(diram_async_pool_stats_t* out) {
+    if (!out) return;
+    out->submitted = atomic_load_explicit(&g_pool.submitted, memory_order_relaxed);
+    out->executed = atomic_load_explicit(&g_pool.executed, memory_order_relaxed);
+    out->stolen = atomic_load_explicit(&g_pool.stolen, memory_order_relaxed);
+    out->rejected = atomic_load_explicit(&g_pool.rejected, memory_order_relaxed);
+    out->deferred = atomic_load_explicit(&g_pool.deferred, memory_order_relaxed);
+    out->workers = (uint32_t)g_pool.nworkers;
+    out->max_pending = (uint32_t)g_pool.max_pending;
+    out->pending = (uint32_t)atomic_load_explicit(&g_pool.pending, memory_order_relaxed);
+    pthread_mutex_lock(&g_pool.idle_lock);
+    out->parked = (uint32_t)g_pool.delayed_count;
+    pthread_mutex_unlock(&g_pool.idle_lock);
+}
@@ -1,5 +1,6 @@
 // src/core/feature-alloc/async_promise.c
 #include "diram/core/feature-alloc/async_promise.h"
+#include "diram/core/feature-alloc/async_promise_internal.h"
 #include <unistd.h>    // For getpid()
 #include <errno.h>     // For errno, ENOMEM
 #include <string.h>    // For memcpy, strerror, strncpy
@@ -7,47 +8,8 @@
 #include <pthread.h>   // For pthreads
 #include <time.h>      // For time, clock_gettime
 
-// Extension error codes for async promises (0x100B onwards)
-#define DIRAM_ERR_TIMEOUT        0x100B
-#define DIRAM_ERR_CANCELLED      0x100C
-#define DIRAM_ERR_PENDING        0x100D
-#define DIRAM_ERR_INVALID_ARG    0x100E
-#define DIRAM_ERR_FATAL          0x100F
-#define DIRAM_ERR_UNKNOWN        0x1010
-#define DIRAM_SUCCESS            DIRAM_ERR_NONE
-
-// Forward declaration - critical for compilation order
-static void* async_allocation_worker(void* arg);
-
-// Internal structures - integrated directly for security
-typedef struct {
-    size_t predicted_size;
-    uint32_t access_pattern;
-    uint64_t last_access;
-    double confidence_score;
-} diram_lookahead_entry_t;
-
-// Global lookahead cache - static for translation unit isolation
-static struct {
-    diram_lookahead_entry_t* entries;
-    size_t capacity;
-    pthread_rwlock_t lock;
-} g_lookahead_cache = {0};
-
-// Context structure for async workers
-typedef struct {
-    char* tag;
-    diram_memory_space_t* space;
-} diram_async_context_t;
-
-// Predictive allocation with lookahead
-diram_async_promise_t* diram_alloc_with_lookahead(
-    size_t size,
-    const char* tag,
-    diram_memory_space_t* space,
-    uint32_t access_pattern_hint
-) {
-    // Create promise
+diram_async_promise_t* diram_promise_create(const char* tag,
+                                            diram_memory_space_t* space) {
     diram_async_promise_t* promise = calloc(1, sizeof(diram_async_promise_t));
     if (!promise) {
         return NULL;
@@ -59,6 +21,7 @@ diram_async_promise_t* diram_alloc_with_lookahead(
     promise->receipt.state = PROMISE_STATE_PENDING;
     promise->receipt.creator_pid = getpid();
     promise->receipt.creator_thread = pthread_self();
+    promise->refs = 1;
     
     pthread_mutex_init(&promise->state_mutex, NULL);
     pthread_cond_init(&promise->state_cond, NULL);
@@ -71,44 +34,51 @@ diram_async_promise_t* diram_alloc_with_lookahead(
         promise->callback_context = ctx;
     }
     
-    // Check lookahead cache for predictive hints
-    pthread_rwlock_rdlock(&g_lookahead_cache.lock);
-    size_t predicted_size = size;
-    for (size_t i = 0; i < g_lookahead_cache.capacity; i++) {
-        if (g_lookahead_cache.entries[i].access_pattern == access_pattern_hint) {
-            if (g_lookahead_cache.entries[i].confidence_score > 0.7) {
-                predicted_size = g_lookahead_cache.entries[i].predicted_size;
-            }
-            break;
-        }
+    return promise;
+}
+
+void diram_promise_retain(diram_async_promise_t* promise) {
+    __atomic_add_fetch(&promise->refs, 1, __ATOMIC_RELAXED);
+}
+
+void diram_promise_release(diram_async_promise_t* promise) {
+    if (__atomic_sub_fetch(&promise->refs, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
     }
-    pthread_rwlock_unlock(&g_lookahead_cache.lock);
     
-    promise->lookahead_size = predicted_size;
-    promise->cache_priority = access_pattern_hint;
+    pthread_mutex_destroy(&promise->state_mutex);
+    pthread_cond_destroy(&promise->state_cond);
     
-    // Spawn async allocation thread
-    pthread_t alloc_thread;
-    pthread_create(&alloc_thread, NULL, async_allocation_worker, promise);
-    pthread_detach(alloc_thread);
+    if (promise->callback_context) {
+        diram_async_context_t* ctx = (diram_async_context_t*)promise->callback_context;
+        if (ctx->tag) free(ctx->tag);
+        free(ctx);
+    }
     
-    return promise;
+    free(promise);
 }
 
-// Worker thread for async allocation
-static void* async_allocation_worker(void* arg) {
+// Runs on an async pool worker
+void diram_async_allocation_task(void* arg) {
     diram_async_promise_t* promise = (diram_async_promise_t*)arg;
     
     // Extract context if available
     const char* tag = "async_alloc";
     diram_memory_space_t* space = NULL;
+    const char* cache_tag = NULL;
+    size_t requested = promise->lookahead_size;
     
     if (promise->callback_context) {
         diram_async_context_t* ctx = (diram_async_context_t*)promise->callback_context;
         if (ctx->tag) tag = ctx->tag;
+        cache_tag = ctx->tag;
         space = ctx->space;
+        if (ctx->requested_size) requested = ctx->requested_size;
     }
     
+    // The heap event was charged to the submitting thread's epoch
+    diram_heap_event_prepaid();
+    
     // Perform async allocation with potential failures
     diram_enhanced_allocation_t* alloc = diram_alloc_enhanced(
         promise->lookahead_size,
@@ -122,7 +92,12 @@ static void* async_allocation_worker(void* arg) {
                alloc->base.sha256_receipt,
                DIRAM_SHA256_HEX_LEN);
         
-        diram_promise_resolve(promise, alloc);
+        // Nobody will collect it if the promise already timed out
+        if (diram_promise_resolve(promise, alloc) < 0) {
+            diram_free_enhanced(alloc);
+        } else {
+            diram_lookahead_observe(promise->cache_priority, cache_tag, requested);
+        }
     } else {
         // Determine rejection reason based on errno
         diram_reject_reason_t reason = REJECT_REASON_MEMORY_EXHAUSTED;
@@ -133,15 +108,7 @@ static void* async_allocation_worker(void* arg) {
         diram_promise_reject(promise, reason, strerror(errno));
     }
     
-    // Cleanup context
-    if (promise->callback_context) {
-        diram_async_context_t* ctx = (diram_async_context_t*)promise->callback_context;
-        if (ctx->tag) free(ctx->tag);
-        free(ctx);
-        promise->callback_context = NULL;
-    }
-    
-    return NULL;
+    diram_promise_release(promise);
 }
 
 // Promise lifecycle implementations
@@ -166,13 +133,15 @@ int diram_promise_await(diram_async_promise_t* promise, uint64_t timeout_ms) {
                                    &promise->state_mutex, &ts) == ETIMEDOUT) {
             promise->receipt.state = PROMISE_STATE_REJECTED;
             promise->receipt.reject_reason = REJECT_REASON_TIMEOUT;
+            diram_cq_post_locked(promise);
             pthread_mutex_unlock(&promise->state_mutex);
             return -1;
         }
     }
     
+    int resolved = promise->receipt.state == PROMISE_STATE_RESOLVED;
     pthread_mutex_unlock(&promise->state_mutex);
-    return (promise->receipt.state == PROMISE_STATE_RESOLVED) ? 0 : -1;
+    return resolved ? 0 : -1;
 }
 
 int diram_promise_resolve(diram_async_promise_t* promise, 
@@ -193,6 +162,7 @@ int diram_promise_resolve(diram_async_promise_t* promise,
         promise->on_resolve(promise, alloc);
     }
     
+    diram_cq_post_locked(promise);
     pthread_cond_broadcast(&promise->state_cond);
     pthread_mutex_unlock(&promise->state_mutex);
     
@@ -235,6 +205,7 @@ int diram_promise_reject(diram_async_promise_t* promise,
         promise->on_reject(promise, reason, msg);
     }
     
+    diram_cq_post_locked(promise);
     pthread_cond_broadcast(&promise->state_cond);
     pthread_mutex_unlock(&promise->state_mutex);
     
@@ -244,17 +215,8 @@ int diram_promise_reject(diram_async_promise_t* promise,
 void diram_promise_destroy(diram_async_promise_t* promise) {
     if (!promise) return;
     
-    pthread_mutex_destroy(&promise->state_mutex);
-    pthread_cond_destroy(&promise->state_cond);
-    
-    // Cleanup any remaining context
-    if (promise->callback_context) {
-        diram_async_context_t* ctx = (diram_async_context_t*)promise->callback_context;
-        if (ctx->tag) free(ctx->tag);
-        free(ctx);
-    }
-    
-    free(promise);
+    // Drops the caller's reference; a still-queued task keeps its own
+    diram_promise_release(promise);
 }
 
 diram_status_t diram_promise_get_status(diram_async_promise_t* promise) {
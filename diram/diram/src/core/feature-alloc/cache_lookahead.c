@@ -1,21 +1,199 @@
 // src/core/feature-alloc/cache_lookahead.c
+// Predictive lookahead cache: an open-addressed table keyed by
+// (access-pattern hint, tag). Each slot learns an EWMA of the sizes its
+// resolved promises asked for, plus an EWMA of the deviation, and a
+// confidence that rises while requests stay near the mean. Lookups are
+// lock-free (per-slot seqlock); writers serialize on the slot sequence.
 #include "diram/core/feature-alloc/async_promise.h"
+#include "diram/core/feature-alloc/async_promise_internal.h"
+#include "diram/core/feature-alloc/async_pool.h"
+#include "diram/core/config/config.h"
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <sched.h>
 #include <time.h>
 
-// Lookahead cache structure for predictive allocation
+#define LOOKAHEAD_PROBE_LIMIT 16
+#define LOOKAHEAD_CONF_ONE 65536u           // Confidence is Q16
+#define LOOKAHEAD_CONF_THRESHOLD 45875u     // 0.7
+#define LOOKAHEAD_ROUND 64                  // Predictions round up to this
+
 typedef struct {
-    size_t predicted_size;
-    uint32_t access_pattern;  // Bitmap of recent access
-    uint64_t last_access;
-    double confidence_score;  // 0.0 to 1.0
-} diram_lookahead_entry_t;
+    _Atomic uint64_t key;           // 0 = empty; never cleared once set
+    _Atomic uint32_t seq;           // Odd while a writer holds the slot
+    _Atomic uint32_t confidence;
+    _Atomic uint64_t mean;          // Q8 bytes
+    _Atomic uint64_t dev;           // Q8 bytes
+} lookahead_slot_t;
 
-// Global lookahead cache
 static struct {
-    diram_lookahead_entry_t* entries;
-    size_t capacity;
-    pthread_rwlock_t lock;
-} g_lookahead_cache = {0};
+    lookahead_slot_t* slots;
+    size_t mask;
+    atomic_size_t entries;
+
+    atomic_uint_fast64_t lookups;
+    atomic_uint_fast64_t hits;
+    atomic_uint_fast64_t misses;
+    atomic_uint_fast64_t updates;
+    atomic_uint_fast64_t oversize_bytes;
+} g_lookahead_cache;
+
+static pthread_once_t g_lookahead_once = PTHREAD_ONCE_INIT;
+
+static void lookahead_init(void) {
+    // Half-full at the configured number of distinct keys
+    int configured = diram_config_current()->lookahead_cache_size;
+    size_t want = configured > 0 ? (size_t)configured : 1024;
+    size_t capacity = 1;
+    while (capacity < want * 2) capacity <<= 1;
+
+    g_lookahead_cache.slots = calloc(capacity, sizeof(lookahead_slot_t));
+    if (g_lookahead_cache.slots) {
+        g_lookahead_cache.mask = capacity - 1;
+    }
+}
+
+static uint64_t lookahead_key(uint32_t hint, const char* tag) {
+    // FNV-1a over the tag, folded with the hint, finished with a mixer
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char* p = (const unsigned char*)(tag ? tag : ""); *p; p++) {
+        h = (h ^ *p) * 0x100000001b3ULL;
+    }
+    h ^= (uint64_t)hint * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
+
+// Find the slot for key, claiming an empty one when insert is set
+static lookahead_slot_t* lookahead_find(uint64_t key, int insert) {
+    pthread_once(&g_lookahead_once, lookahead_init);
+    if (!g_lookahead_cache.slots) return NULL;
+
+    for (size_t i = 0; i < LOOKAHEAD_PROBE_LIMIT; i++) {
+        lookahead_slot_t* slot = &g_lookahead_cache.slots[(key + i) & g_lookahead_cache.mask];
+        uint64_t current = atomic_load_explicit(&slot->key, memory_order_acquire);
+        if (current == key) return slot;
+        if (current != 0) continue;
+        if (!insert) return NULL;
+
+        uint64_t empty = 0;
+        if (atomic_compare_exchange_strong_explicit(&slot->key, &empty, key,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            atomic_fetch_add_explicit(&g_lookahead_cache.entries, 1, memory_order_relaxed);
+            return slot;
+        }
+        if (empty == key) return slot;  // Another thread inserted it first
+    }
+    return NULL;    // Probe window full; this key is not learned
+}
+
+static void lookahead_read(lookahead_slot_t* slot, uint64_t* mean,
+                           uint64_t* dev, uint32_t* confidence) {
+    uint32_t before, after;
+    do {
+        before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (before & 1) {
+            sched_yield();
+            continue;
+        }
+        *mean = atomic_load_explicit(&slot->mean, memory_order_relaxed);
+        *dev = atomic_load_explicit(&slot->dev, memory_order_relaxed);
+        *confidence = atomic_load_explicit(&slot->confidence, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+}
+
+size_t diram_lookahead_predict(uint32_t hint, const char* tag, size_t size) {
+    atomic_fetch_add_explicit(&g_lookahead_cache.lookups, 1, memory_order_relaxed);
+
+    lookahead_slot_t* slot = lookahead_find(lookahead_key(hint, tag), 0);
+    if (!slot) {
+        atomic_fetch_add_explicit(&g_lookahead_cache.misses, 1, memory_order_relaxed);
+        return size;
+    }
+
+    uint64_t mean, dev;
+    uint32_t confidence;
+    lookahead_read(slot, &mean, &dev, &confidence);
+
+    // Aim a little high: mean plus two deviations, rounded up
+    size_t predicted = (size_t)((mean + 2 * dev + 255) >> 8);
+    predicted = (predicted + LOOKAHEAD_ROUND - 1) & ~(size_t)(LOOKAHEAD_ROUND - 1);
+
+    if (confidence < LOOKAHEAD_CONF_THRESHOLD || predicted < size) {
+        atomic_fetch_add_explicit(&g_lookahead_cache.misses, 1, memory_order_relaxed);
+        return size;
+    }
+
+    atomic_fetch_add_explicit(&g_lookahead_cache.hits, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_lookahead_cache.oversize_bytes, predicted - size,
+                              memory_order_relaxed);
+    return predicted;
+}
+
+void diram_lookahead_observe(uint32_t hint, const char* tag, size_t size) {
+    lookahead_slot_t* slot = lookahead_find(lookahead_key(hint, tag), 1);
+    if (!slot) return;
+
+    uint32_t seq;
+    do {
+        seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (seq & 1) {
+            sched_yield();
+            continue;
+        }
+    } while ((seq & 1) ||
+             !atomic_compare_exchange_weak_explicit(&slot->seq, &seq, seq + 1,
+                                                    memory_order_acquire,
+                                                    memory_order_relaxed));
+    atomic_thread_fence(memory_order_release);
+
+    uint64_t sample = (uint64_t)size << 8;
+    uint64_t mean = atomic_load_explicit(&slot->mean, memory_order_relaxed);
+    uint64_t dev = atomic_load_explicit(&slot->dev, memory_order_relaxed);
+    uint32_t confidence = atomic_load_explicit(&slot->confidence, memory_order_relaxed);
+
+    if (mean == 0) {
+        mean = sample;      // First observation seeds the mean
+    } else {
+        uint64_t err = sample > mean ? sample - mean : mean - sample;
+
+        // Near the mean raises confidence by 1/8 of the gap, a miss cuts it by 1/4
+        if (err <= mean / 4) {
+            confidence += (LOOKAHEAD_CONF_ONE - confidence) / 8;
+        } else {
+            confidence -= confidence / 4;
+        }
+
+        // alpha = 1/8 for the mean, 1/4 for the deviation (as in TCP RTT)
+        mean = sample > mean ? mean + (sample - mean) / 8 : mean - (mean - sample) / 8;
+        dev = err > dev ? dev + (err - dev) / 4 : dev - (dev - err) / 4;
+    }
+
+    atomic_store_explicit(&slot->mean, mean, memory_order_relaxed);
+    atomic_store_explicit(&slot->dev, dev, memory_order_relaxed);
+    atomic_store_explicit(&slot->confidence, confidence, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+
+    atomic_fetch_add_explicit(&g_lookahead_cache.updates, 1, memory_order_relaxed);
+}
+
+void diram_lookahead_get_stats(diram_lookahead_stats_t* out) {
+    if (!out) return;
+    out->lookups = atomic_load_explicit(&g_lookahead_cache.lookups, memory_order_relaxed);
+    out->hits = atomic_load_explicit(&g_lookahead_cache.hits, memory_order_relaxed);
+    out->misses = atomic_load_explicit(&g_lookahead_cache.misses, memory_order_relaxed);
+    out->updates = atomic_load_explicit(&g_lookahead_cache.updates, memory_order_relaxed);
+    out->oversize_bytes = atomic_load_explicit(&g_lookahead_cache.oversize_bytes,
+                                               memory_order_relaxed);
+    out->entries = (uint32_t)atomic_load_explicit(&g_lookahead_cache.entries,
+                                                  memory_order_relaxed);
+    out->capacity = g_lookahead_cache.slots ? (uint32_t)(g_lookahead_cache.mask + 1) : 0;
+}
 
 // Predictive allocation with lookahead
 diram_async_promise_t* diram_alloc_with_lookahead(
@@ -25,72 +203,45 @@ diram_async_promise_t* diram_alloc_with_lookahead(
     uint32_t access_pattern_hint
 ) {
     // Create promise
-    diram_async_promise_t* promise = calloc(1, sizeof(diram_async_promise_t));
+    diram_async_promise_t* promise = diram_promise_create(tag, space);
     if (!promise) {
         return NULL;
     }
     
-    // Initialize promise receipt
-    promise->receipt.promise_id = (uint64_t)promise;
-    promise->receipt.creation_timestamp = time(NULL);
-    promise->receipt.state = PROMISE_STATE_PENDING;
-    promise->receipt.creator_pid = getpid();
-    promise->receipt.creator_thread = pthread_self();
-    
-    pthread_mutex_init(&promise->state_mutex, NULL);
-    pthread_cond_init(&promise->state_cond, NULL);
-    
-    // Check lookahead cache for predictive hints
-    pthread_rwlock_rdlock(&g_lookahead_cache.lock);
-    size_t predicted_size = size;
-    for (size_t i = 0; i < g_lookahead_cache.capacity; i++) {
-        if (g_lookahead_cache.entries[i].access_pattern == access_pattern_hint) {
-            if (g_lookahead_cache.entries[i].confidence_score > 0.7) {
-                predicted_size = g_lookahead_cache.entries[i].predicted_size;
-            }
-            break;
-        }
+    // Oversize to the learned size for this pattern/tag when confident;
+    // the worker feeds the real request size back on resolve
+    promise->lookahead_size = diram_lookahead_predict(access_pattern_hint, tag, size);
+    promise->cache_priority = access_pattern_hint;
+    if (promise->callback_context) {
+        ((diram_async_context_t*)promise->callback_context)->requested_size = size;
     }
-    pthread_rwlock_unlock(&g_lookahead_cache.lock);
     
-    promise->lookahead_size = predicted_size;
-    promise->cache_priority = access_pattern_hint;
+    // Charge the caller's heap credit; the pool worker runs prepaid. In
+    // defer mode the credit is borrowed and the task parks until it is
+    // earned, as long as that fits inside the await timeout.
+    int64_t wait_ns = 0;
+    if (diram_heap_get_mode() == DIRAM_HEAP_MODE_DEFER) {
+        int timeout_ms = diram_config_current()->default_timeout_ms;
+        if (timeout_ms <= 0) timeout_ms = DIRAM_ASYNC_DEFAULT_TIMEOUT_MS;
+        wait_ns = diram_heap_event_reserve_deferred((uint64_t)timeout_ms * 1000000ULL);
+    } else if (diram_heap_event_reserve() < 0) {
+        wait_ns = -1;
+    }
+    if (wait_ns < 0) {
+        diram_promise_reject(promise, REJECT_REASON_GOVERNANCE_VIOLATION,
+                             "heap event budget exhausted for this epoch");
+        return promise;
+    }
     
-    // Spawn async allocation thread
-    pthread_t alloc_thread;
-    pthread_create(&alloc_thread, NULL, async_allocation_worker, promise);
-    pthread_detach(alloc_thread);
+    // Queue on the async worker pool; the task holds its own reference
+    diram_promise_retain(promise);
+    if (diram_async_pool_submit_after(diram_async_allocation_task, promise,
+                                      (uint64_t)wait_ns) < 0) {
+        diram_heap_event_unreserve();
+        diram_promise_release(promise);
+        diram_promise_reject(promise, REJECT_REASON_GOVERNANCE_VIOLATION,
+                             "async queue full (async.max_pending_promises)");
+    }
     
     return promise;
 }
-
-// Worker thread for async allocation
-static void* async_allocation_worker(void* arg) {
-    diram_async_promise_t* promise = (diram_async_promise_t*)arg;
-    
-    // Simulate async work with potential failures
-    diram_enhanced_allocation_t* alloc = diram_alloc_enhanced(
-        promise->lookahead_size,
-        "async_alloc",
-        NULL  // Space will be bound later
-    );
-    
-    if (alloc) {
-        // Generate receipt
-        memcpy(promise->receipt.allocation_receipt, 
-               alloc->base.sha256_receipt,
-               DIRAM_SHA256_HEX_LEN);
-        
-        diram_promise_resolve(promise, alloc);
-    } else {
-        // Determine rejection reason
-        diram_reject_reason_t reason = REJECT_REASON_MEMORY_EXHAUSTED;
-        if (errno == ENOMEM) {
-            reason = REJECT_REASON_FATAL_ERROR;
-        }
-        
-        diram_promise_reject(promise, reason, strerror(errno));
-    }
-    
-    return NULL;
-}
\ No newline at end of file
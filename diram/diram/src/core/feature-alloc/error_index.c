@@ -0,0 +1,676 @@
+// src/core/feature-alloc/error_index.c
+// Lock-free error index with deferred formatting
+// OBINexus Project - Directed Instruction RAM
+//
+// diram_error_record claims a ticket in one fixed ring and stores the
+// format pointer with its raw arguments: no lock, no vsnprintf, no write.
+// Repeats of the same code and format within the suppression window only
+// bump a counter, which rides on the next record from that call site.
+// Records are formatted when the index is read: by diram_error_dump_index,
+// diram_error_get_last, and the background writer behind the error log.
+
+#include "diram/core/feature-alloc/feature_alloc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#define DIRAM_ERROR_RING_MASK (DIRAM_ERROR_RING_SLOTS - 1)
+#define DIRAM_ERROR_SUPPRESS_SLOTS 64
+#define DIRAM_ERROR_TEXT_BUFFER (16 * 1024)
+#define DIRAM_ERROR_LINE_MAX 384
+#define DIRAM_ERROR_SPEC_MAX 32
+
+_Static_assert((DIRAM_ERROR_RING_SLOTS & DIRAM_ERROR_RING_MASK) == 0,
+               "error ring size must be a power of two");
+
+typedef union {
+    intmax_t i;
+    uintmax_t u;       // Also the offset of a copied %s argument
+    double d;
+    long double ld;
+    const void* p;
+} error_arg_t;
+
+typedef struct {
+    diram_error_code_t code;
+    uint8_t severity;
+    uint8_t arg_count;
+    pid_t pid;
+    uint64_t timestamp;
+    uint64_t repeats;          // Suppressed repeats folded into this record
+    const char* file;          // Only set by diram_error_record_context
+    int line;
+    const char* fmt;           // Must be a literal or otherwise outlive the index
+    error_arg_t args[DIRAM_ERROR_MAX_ARGS];
+    char strings[DIRAM_ERROR_STRING_BYTES];
+} error_record_t;
+
+// Seqlock per slot: 2 * ticket + 1 while written, 2 * ticket + 2 once
+// published. Readers copy the record and keep it only if the sequence
+// did not move underneath them.
+typedef struct {
+    _Atomic uint64_t sequence;
+    error_record_t record;
+} error_slot_t;
+
+typedef struct {
+    _Atomic uintptr_t key;           // Format pointer and code of the site
+    _Atomic uint64_t window_start;   // Monotonic ns
+    _Atomic uint64_t repeats;        // Suppressed in the current window
+} error_suppress_t;
+
+static struct {
+    _Alignas(64) _Atomic uint64_t head;   // Next ticket
+    _Atomic uint64_t recorded;
+    _Atomic uint64_t suppressed;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t logged;
+    error_suppress_t suppress[DIRAM_ERROR_SUPPRESS_SLOTS];
+
+    // Writer state, never touched by producers
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    FILE* error_log;
+    pthread_t writer;
+    pid_t writer_pid;                     // 0 when no writer runs in this process
+    int stopping;
+    uint64_t written;                     // Next ticket for the log
+    uint64_t stalled;                     // Unpublished ticket seen on the last pass
+
+    error_slot_t slots[DIRAM_ERROR_RING_SLOTS];
+} g_errors = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .stalled = UINT64_MAX
+};
+
+static pthread_once_t g_errors_atfork_once = PTHREAD_ONCE_INIT;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t error_severity(diram_error_code_t code) {
+    if (code >= DIRAM_ERR_BOUNDARY_VIOLATION && code <= DIRAM_ERR_GOVERNANCE_FAIL) {
+        return 3; // Critical
+    } else if (code >= DIRAM_ERR_PID_MISMATCH) {
+        return 2; // Error
+    }
+    return 1; // Warning
+}
+
+// ---- Format specifications ----
+
+typedef struct {
+    size_t length;         // Bytes from '%' through the conversion
+    int star_width;
+    int star_precision;
+    char size[3];          // Length modifier: "", hh, h, l, ll, j, z, t, L
+    char conversion;
+} error_spec_t;
+
+// Parses the conversion at p, which points at '%'. Returns 0 if malformed.
+static size_t error_parse_spec(const char* p, error_spec_t* spec) {
+    size_t i = 1;
+    memset(spec, 0, sizeof(*spec));
+
+    while (p[i] && strchr("-+ #0'", p[i])) i++;
+    if (p[i] == '*') {
+        spec->star_width = 1;
+        i++;
+    } else {
+        while (p[i] >= '0' && p[i] <= '9') i++;
+    }
+    if (p[i] == '.') {
+        i++;
+        if (p[i] == '*') {
+            spec->star_precision = 1;
+            i++;
+        } else {
+            while (p[i] >= '0' && p[i] <= '9') i++;
+        }
+    }
+
+    size_t size = 0;
+    if ((p[i] == 'h' && p[i + 1] == 'h') || (p[i] == 'l' && p[i + 1] == 'l')) {
+        size = 2;
+    } else if (p[i] && strchr("hljztL", p[i])) {
+        size = 1;
+    }
+    memcpy(spec->size, p + i, size);
+    i += size;
+
+    if (!p[i] || !strchr("diouxXcfFeEgGaAspn", p[i])) return 0;
+    spec->conversion = p[i];
+    spec->length = i + 1;
+    return spec->length;
+}
+
+static intmax_t error_arg_signed(const error_spec_t* spec, va_list* args) {
+    switch (spec->size[0]) {
+        case 'l': return spec->size[1] ? (intmax_t)va_arg(*args, long long)
+                                       : (intmax_t)va_arg(*args, long);
+        case 'j': return va_arg(*args, intmax_t);
+        case 'z': return (intmax_t)va_arg(*args, ssize_t);
+        case 't': return (intmax_t)va_arg(*args, ptrdiff_t);
+        default:  return (intmax_t)va_arg(*args, int);
+    }
+}
+
+static uintmax_t error_arg_unsigned(const error_spec_t* spec, va_list* args) {
+    switch (spec->size[0]) {
+        case 'l': return spec->size[1] ? (uintmax_t)va_arg(*args, unsigned long long)
+                                       : (uintmax_t)va_arg(*args, unsigned long);
+        case 'j': return va_arg(*args, uintmax_t);
+        case 'z': return (uintmax_t)va_arg(*args, size_t);
+        case 't': return (uintmax_t)va_arg(*args, ptrdiff_t);
+        default:  return (uintmax_t)va_arg(*args, unsigned int);
+    }
+}
+
+// Pulls the raw arguments of fmt into the record. Strings are copied,
+// since the caller's buffers are gone by the time anyone formats them.
+// Conversions past DIRAM_ERROR_MAX_ARGS are left unformatted.
+static void error_capture(error_record_t* record, const char* fmt, va_list* args) {
+    size_t strings_used = 0;
+    record->fmt = fmt;
+    record->arg_count = 0;
+
+    for (const char* p = fmt; *p; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+
+        error_spec_t spec;
+        if (!error_parse_spec(p, &spec)) break;
+        size_t needed = (size_t)(1 + spec.star_width + spec.star_precision);
+        if (record->arg_count + needed > DIRAM_ERROR_MAX_ARGS) break;
+
+        if (spec.star_width) record->args[record->arg_count++].i = va_arg(*args, int);
+        if (spec.star_precision) record->args[record->arg_count++].i = va_arg(*args, int);
+
+        error_arg_t* arg = &record->args[record->arg_count++];
+        switch (spec.conversion) {
+            case 'd': case 'i':
+                arg->i = error_arg_signed(&spec, args);
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                arg->u = error_arg_unsigned(&spec, args);
+                break;
+            case 'c':
+                arg->i = va_arg(*args, int);
+                break;
+            case 's': {
+                const char* s = va_arg(*args, const char*);
+                if (spec.size[0] == 'l') s = "(wide)";
+                if (!s) s = "(null)";
+                size_t len = strlen(s);
+                size_t room = DIRAM_ERROR_STRING_BYTES - strings_used;
+                if (room == 0) {
+                    arg->u = UINTMAX_MAX;
+                    break;
+                }
+                if (len >= room) len = room - 1;
+                memcpy(record->strings + strings_used, s, len);
+                record->strings[strings_used + len] = '\0';
+                arg->u = strings_used;
+                strings_used += len + 1;
+                break;
+            }
+            case 'p':
+            case 'n':
+                arg->p = va_arg(*args, const void*);
+                break;
+            default:
+                if (spec.size[0] == 'L') {
+                    arg->ld = va_arg(*args, long double);
+                } else {
+                    arg->d = va_arg(*args, double);
+                }
+                break;
+        }
+        p += spec.length - 1;
+    }
+}
+
+#define ERROR_EMIT(value) \
+    (spec.star_width && spec.star_precision \
+         ? snprintf(dst, room, spec_text, width, precision, value) \
+     : spec.star_width ? snprintf(dst, room, spec_text, width, value) \
+     : spec.star_precision ? snprintf(dst, room, spec_text, precision, value) \
+     : snprintf(dst, room, spec_text, value))
+
+// Formats the record's message the way vsnprintf would have at record time
+static size_t error_format_message(const error_record_t* record, char* out, size_t out_len) {
+    size_t used = 0;
+    size_t next_arg = 0;
+    out[0] = '\0';
+
+    for (const char* p = record->fmt; *p && used + 1 < out_len; p++) {
+        if (*p != '%' || p[1] == '%') {
+            out[used++] = *p;
+            if (*p == '%') p++;
+            continue;
+        }
+
+        error_spec_t spec;
+        if (!error_parse_spec(p, &spec) || spec.length >= DIRAM_ERROR_SPEC_MAX) break;
+        size_t needed = (size_t)(1 + spec.star_width + spec.star_precision);
+        if (next_arg + needed > record->arg_count) break;
+
+        char spec_text[DIRAM_ERROR_SPEC_MAX];
+        memcpy(spec_text, p, spec.length);
+        spec_text[spec.length] = '\0';
+        int width = spec.star_width ? (int)record->args[next_arg++].i : 0;
+        int precision = spec.star_precision ? (int)record->args[next_arg++].i : 0;
+        const error_arg_t* arg = &record->args[next_arg++];
+        char* dst = out + used;
+        size_t room = out_len - used;
+        int n = 0;
+
+        switch (spec.conversion) {
+            case 'd': case 'i':
+                switch (spec.size[0]) {
+                    case 'l': n = spec.size[1] ? ERROR_EMIT((long long)arg->i)
+                                               : ERROR_EMIT((long)arg->i); break;
+                    case 'j': n = ERROR_EMIT(arg->i); break;
+                    case 'z': n = ERROR_EMIT((ssize_t)arg->i); break;
+                    case 't': n = ERROR_EMIT((ptrdiff_t)arg->i); break;
+                    default:  n = ERROR_EMIT((int)arg->i); break;
+                }
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                switch (spec.size[0]) {
+                    case 'l': n = spec.size[1] ? ERROR_EMIT((unsigned long long)arg->u)
+                                               : ERROR_EMIT((unsigned long)arg->u); break;
+                    case 'j': n = ERROR_EMIT(arg->u); break;
+                    case 'z': n = ERROR_EMIT((size_t)arg->u); break;
+                    case 't': n = ERROR_EMIT((ptrdiff_t)arg->u); break;
+                    default:  n = ERROR_EMIT((unsigned int)arg->u); break;
+                }
+                break;
+            case 'c':
+                n = ERROR_EMIT((int)arg->i);
+                break;
+            case 's':
+                n = ERROR_EMIT(arg->u == UINTMAX_MAX ? "..." : record->strings + arg->u);
+                break;
+            case 'p':
+                n = ERROR_EMIT(arg->p);
+                break;
+            case 'n':
+                break;
+            default:
+                n = spec.size[0] == 'L' ? ERROR_EMIT(arg->ld) : ERROR_EMIT(arg->d);
+                break;
+        }
+
+        if (n > 0) used += (size_t)n < room ? (size_t)n : room - 1;
+        p += spec.length - 1;
+    }
+
+    out[used] = '\0';
+    return used;
+}
+
+#undef ERROR_EMIT
+
+// One log/dump line, in the original error log format
+static int error_format_line(const error_record_t* record, char* out, size_t out_len) {
+    char message[sizeof(((diram_error_context_t*)0)->context)];
+    error_format_message(record, message, sizeof(message));
+    if (record->repeats) {
+        return snprintf(out, out_len, "%" PRIu64 "|%d|0x%04X|%d|%s (+%" PRIu64 " repeats)\n",
+                        record->timestamp, record->pid, record->code,
+                        record->severity, message, record->repeats);
+    }
+    return snprintf(out, out_len, "%" PRIu64 "|%d|0x%04X|%d|%s\n",
+                    record->timestamp, record->pid, record->code,
+                    record->severity, message);
+}
+
+// ---- Ring ----
+
+// Copies ticket's record. Returns 0 on success, 1 if it is not published
+// yet, -1 if it was overwritten or never written.
+static int error_read(uint64_t ticket, error_record_t* record) {
+    const error_slot_t* slot = &g_errors.slots[ticket & DIRAM_ERROR_RING_MASK];
+    uint64_t published = 2 * ticket + 2;
+
+    uint64_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (before != published) {
+        return before < published ? 1 : -1;
+    }
+    memcpy(record, &slot->record, sizeof(*record));
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    return after == published ? 0 : -1;
+}
+
+// Claims the next slot; NULL if a writer from a lap ago still holds it,
+// in which case the record is dropped rather than waited for
+static error_slot_t* error_claim(uint64_t* ticket) {
+    *ticket = atomic_fetch_add_explicit(&g_errors.head, 1, memory_order_relaxed);
+    error_slot_t* slot = &g_errors.slots[*ticket & DIRAM_ERROR_RING_MASK];
+    uint64_t writing = 2 * *ticket + 1;
+
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    if ((sequence & 1) || sequence > writing ||
+        !atomic_compare_exchange_strong_explicit(&slot->sequence, &sequence, writing,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&g_errors.dropped, 1, memory_order_relaxed);
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_release);
+    return slot;
+}
+
+static void error_publish(error_slot_t* slot, uint64_t ticket) {
+    atomic_store_explicit(&slot->sequence, 2 * ticket + 2, memory_order_release);
+    atomic_fetch_add_explicit(&g_errors.recorded, 1, memory_order_relaxed);
+}
+
+// Returns 1 if this occurrence only counts as a repeat. Otherwise opens a
+// new window for the site and returns, in *repeats, what the last window
+// suppressed. Racing threads can both open a window; that costs one extra
+// record, never a lost one.
+static int error_suppressed(const char* fmt, diram_error_code_t code, uint64_t* repeats) {
+    uintptr_t key = (uintptr_t)fmt ^ ((uintptr_t)code << 3);
+    size_t index = (size_t)((key >> 3) * 0x9E3779B97F4A7C15ULL >> 58) % DIRAM_ERROR_SUPPRESS_SLOTS;
+    error_suppress_t* entry = &g_errors.suppress[index];
+    uint64_t now = monotonic_ns();
+
+    if (atomic_load_explicit(&entry->key, memory_order_relaxed) == key &&
+        now - atomic_load_explicit(&entry->window_start, memory_order_relaxed) <
+        DIRAM_ERROR_SUPPRESS_WINDOW_MS * 1000000ULL) {
+        atomic_fetch_add_explicit(&entry->repeats, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&g_errors.suppressed, 1, memory_order_relaxed);
+        return 1;
+    }
+
+    uintptr_t previous = atomic_exchange_explicit(&entry->key, key, memory_order_relaxed);
+    atomic_store_explicit(&entry->window_start, now, memory_order_relaxed);
+    uint64_t folded = atomic_exchange_explicit(&entry->repeats, 0, memory_order_relaxed);
+    // Another site's leftover repeats stay counted in the stats only
+    *repeats = previous == key ? folded : 0;
+    return 0;
+}
+
+void diram_error_record(diram_error_code_t code, const char* fmt, ...) {
+    if (!fmt) return;
+
+    uint64_t repeats;
+    if (error_suppressed(fmt, code, &repeats)) return;
+
+    uint64_t ticket;
+    error_slot_t* slot = error_claim(&ticket);
+    if (!slot) return;
+
+    error_record_t* record = &slot->record;
+    record->code = code;
+    record->severity = error_severity(code);
+    record->pid = getpid();
+    record->timestamp = (uint64_t)time(NULL);
+    record->repeats = repeats;
+    record->file = NULL;
+    record->line = 0;
+
+    va_list args;
+    va_start(args, fmt);
+    error_capture(record, fmt, &args);
+    va_end(args);
+
+    error_publish(slot, ticket);
+}
+
+void diram_error_record_context(diram_error_context_t* ctx) {
+    if (!ctx) return;
+
+    uint64_t ticket;
+    error_slot_t* slot = error_claim(&ticket);
+    if (!slot) return;
+
+    error_record_t* record = &slot->record;
+    record->code = ctx->code;
+    record->severity = ctx->severity;
+    record->pid = ctx->pid ? ctx->pid : getpid();
+    record->timestamp = ctx->timestamp ? ctx->timestamp : (uint64_t)time(NULL);
+    record->repeats = 0;
+    record->file = ctx->file;
+    record->line = ctx->line;
+
+    // The context text is already formatted; keep it as the one argument
+    size_t len = strnlen(ctx->context, sizeof(ctx->context));
+    if (len >= DIRAM_ERROR_STRING_BYTES) len = DIRAM_ERROR_STRING_BYTES - 1;
+    memcpy(record->strings, ctx->context, len);
+    record->strings[len] = '\0';
+    record->fmt = "%s";
+    record->args[0].u = 0;
+    record->arg_count = 1;
+
+    error_publish(slot, ticket);
+}
+
+const diram_error_context_t* diram_error_get_last(void) {
+    static __thread diram_error_context_t last;
+    uint64_t head = atomic_load_explicit(&g_errors.head, memory_order_acquire);
+    uint64_t oldest = head > DIRAM_ERROR_RING_SLOTS ? head - DIRAM_ERROR_RING_SLOTS : 0;
+
+    error_record_t record;
+    for (uint64_t ticket = head; ticket-- > oldest;) {
+        if (error_read(ticket, &record) != 0) continue;
+        last.code = record.code;
+        last.timestamp = record.timestamp;
+        last.pid = record.pid;
+        last.file = record.file;
+        last.line = record.line;
+        last.severity = record.severity;
+        error_format_message(&record, last.context, sizeof(last.context));
+        return &last;
+    }
+    return NULL;
+}
+
+void diram_error_get_stats(diram_error_stats_t* stats) {
+    if (!stats) return;
+    stats->recorded = atomic_load_explicit(&g_errors.recorded, memory_order_relaxed);
+    stats->suppressed = atomic_load_explicit(&g_errors.suppressed, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&g_errors.dropped, memory_order_relaxed);
+    stats->logged = atomic_load_explicit(&g_errors.logged, memory_order_relaxed);
+}
+
+int diram_error_dump_index(const char* filename) {
+    if (!filename) return -1;
+    FILE* out = fopen(filename, "w");
+    if (!out) return -1;
+
+    fprintf(out, "# DIRAM Error Index - PID:%d\n", getpid());
+
+    uint64_t head = atomic_load_explicit(&g_errors.head, memory_order_acquire);
+    uint64_t ticket = head > DIRAM_ERROR_RING_SLOTS ? head - DIRAM_ERROR_RING_SLOTS : 0;
+    error_record_t record;
+    char line[DIRAM_ERROR_LINE_MAX];
+    int count = 0;
+
+    for (; ticket < head; ticket++) {
+        if (error_read(ticket, &record) != 0) continue;
+        error_format_line(&record, line, sizeof(line));
+        fputs(line, out);
+        count++;
+    }
+
+    // Repeats still waiting for their site's next record
+    for (size_t i = 0; i < DIRAM_ERROR_SUPPRESS_SLOTS; i++) {
+        const error_suppress_t* entry = &g_errors.suppress[i];
+        uint64_t repeats = atomic_load_explicit(&entry->repeats, memory_order_relaxed);
+        if (repeats) {
+            fprintf(out, "# %" PRIu64 " repeats pending for a site\n", repeats);
+        }
+    }
+
+    if (fclose(out) != 0) return -1;
+    return count;
+}
+
+// ---- Background writer ----
+
+// Formats everything published since the last pass into one buffer and
+// writes it with a single fwrite. Called with g_errors.lock held.
+static void error_drain(char* staging) {
+    uint64_t head = atomic_load_explicit(&g_errors.head, memory_order_acquire);
+    uint64_t ticket = g_errors.written;
+    size_t used = 0;
+    uint64_t lines = 0;
+    error_record_t record;
+
+    // Tickets lapped before we got to them are gone
+    if (head - ticket > DIRAM_ERROR_RING_SLOTS) {
+        ticket = head - DIRAM_ERROR_RING_SLOTS;
+    }
+
+    for (; ticket < head; ticket++) {
+        int state = error_read(ticket, &record);
+        if (state == 1 && ticket != g_errors.stalled) {
+            // Claimed but not yet published: wait one pass for it
+            g_errors.stalled = ticket;
+            break;
+        }
+        if (state != 0) continue;
+
+        if (DIRAM_ERROR_TEXT_BUFFER - used < DIRAM_ERROR_LINE_MAX) {
+            fwrite(staging, 1, used, g_errors.error_log);
+            used = 0;
+        }
+        int n = error_format_line(&record, staging + used, DIRAM_ERROR_TEXT_BUFFER - used);
+        if (n > 0) {
+            used += (size_t)n < DIRAM_ERROR_TEXT_BUFFER - used ? (size_t)n
+                                                               : DIRAM_ERROR_TEXT_BUFFER - used - 1;
+        }
+        lines++;
+    }
+    g_errors.written = ticket;
+
+    if (used > 0) {
+        fwrite(staging, 1, used, g_errors.error_log);
+    }
+    if (lines > 0) {
+        fflush(g_errors.error_log);
+        atomic_fetch_add_explicit(&g_errors.logged, lines, memory_order_relaxed);
+    }
+}
+
+static void* error_writer_main(void* arg) {
+    char* staging = (char*)arg;
+
+    pthread_mutex_lock(&g_errors.lock);
+    while (!g_errors.stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += DIRAM_ERROR_WRITER_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&g_errors.wake, &g_errors.lock, &deadline);
+        if (g_errors.error_log) error_drain(staging);
+    }
+    pthread_mutex_unlock(&g_errors.lock);
+
+    free(staging);
+    return NULL;
+}
+
+// The writer does not survive fork(). The child leaves the parent's
+// undrained records to the parent and logs its own at shutdown.
+static void error_atfork_prepare(void) {
+    pthread_mutex_lock(&g_errors.lock);
+}
+
+static void error_atfork_parent(void) {
+    pthread_mutex_unlock(&g_errors.lock);
+}
+
+static void error_atfork_child(void) {
+    pthread_mutex_init(&g_errors.lock, NULL);
+    pthread_cond_init(&g_errors.wake, NULL);
+    g_errors.writer_pid = 0;
+    g_errors.written = atomic_load(&g_errors.head);
+}
+
+static void error_atfork_init(void) {
+    pthread_atfork(error_atfork_prepare, error_atfork_parent, error_atfork_child);
+}
+
+int diram_error_index_init(void) {
+    pthread_once(&g_errors_atfork_once, error_atfork_init);
+    pthread_mutex_lock(&g_errors.lock);
+
+    if (g_errors.error_log) {
+        pthread_mutex_unlock(&g_errors.lock);
+        return 0; // Already initialized
+    }
+
+    // Open error log; records from before init stay in the index only
+    g_errors.error_log = fopen("logs/diram_errors.log", "a");
+    if (g_errors.error_log) {
+        fprintf(g_errors.error_log,
+                "# DIRAM Error Index Log - PID:%d\n", getpid());
+        fflush(g_errors.error_log);
+        g_errors.written = atomic_load_explicit(&g_errors.head, memory_order_acquire);
+        g_errors.stalled = UINT64_MAX;
+        g_errors.stopping = 0;
+
+        char* staging = malloc(DIRAM_ERROR_TEXT_BUFFER);
+        if (staging && pthread_create(&g_errors.writer, NULL, error_writer_main, staging) == 0) {
+            g_errors.writer_pid = getpid();
+        } else {
+            free(staging);
+        }
+    }
+
+    pthread_mutex_unlock(&g_errors.lock);
+    return 0;
+}
+
+void diram_error_index_shutdown(void) {
+    pthread_mutex_lock(&g_errors.lock);
+    if (!g_errors.error_log) {
+        pthread_mutex_unlock(&g_errors.lock);
+        return;
+    }
+
+    int joinable = g_errors.writer_pid == getpid();
+    g_errors.stopping = 1;
+    pthread_cond_signal(&g_errors.wake);
+    pthread_mutex_unlock(&g_errors.lock);
+    if (joinable) {
+        pthread_join(g_errors.writer, NULL);
+    }
+
+    // Final pass: anything still in flight now has had its chance
+    char* staging = malloc(DIRAM_ERROR_TEXT_BUFFER);
+    pthread_mutex_lock(&g_errors.lock);
+    if (staging) {
+        error_drain(staging);
+        g_errors.stalled = g_errors.written;
+        error_drain(staging);
+    }
+    free(staging);
+    fclose(g_errors.error_log);
+    g_errors.error_log = NULL;
+    g_errors.writer_pid = 0;
+    pthread_mutex_unlock(&g_errors.lock);
+}
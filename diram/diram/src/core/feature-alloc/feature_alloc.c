@@ -1,20 +1,13 @@
 // src/core/feature_alloc.c - Enhanced allocation with error indexing
 #include "diram/core/feature-alloc/feature_alloc.h"
+#include "diram/core/config/config.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <stdarg.h>
 #include <unistd.h>
 #include <errno.h>
-
-// Global error index instance
-static diram_error_index_t g_error_index = {
-    .errors = NULL,
-    .error_count = 0,
-    .error_capacity = 0,
-    .mutex = PTHREAD_MUTEX_INITIALIZER,
-    .error_log = NULL
-};
+#include <sched.h>
+#include <stdatomic.h>
 
 // Global feature configuration
 static diram_feature_config_t g_feature_config = {
@@ -26,108 +19,18 @@ static diram_feature_config_t g_feature_config = {
     .max_error_index_size = 10000
 };
 
-// Error Index Implementation
-int diram_error_index_init(void) {
-    pthread_mutex_lock(&g_error_index.mutex);
-    
-    if (g_error_index.errors != NULL) {
-        pthread_mutex_unlock(&g_error_index.mutex);
-        return 0; // Already initialized
-    }
-    
-    g_error_index.error_capacity = 1024;
-    g_error_index.errors = calloc(g_error_index.error_capacity, 
-                                  sizeof(diram_error_context_t));
-    if (!g_error_index.errors) {
-        pthread_mutex_unlock(&g_error_index.mutex);
-        return -1;
-    }
-    
-    // Open error log
-    g_error_index.error_log = fopen("logs/diram_errors.log", "a");
-    if (g_error_index.error_log) {
-        setvbuf(g_error_index.error_log, NULL, _IOLBF, 0);
-        fprintf(g_error_index.error_log, 
-                "# DIRAM Error Index Log - PID:%d\n", getpid());
-    }
-    
-    pthread_mutex_unlock(&g_error_index.mutex);
-    return 0;
-}
-
-void diram_error_index_shutdown(void) {
-    pthread_mutex_lock(&g_error_index.mutex);
-    
-    if (g_error_index.errors) {
-        free(g_error_index.errors);
-        g_error_index.errors = NULL;
-    }
-    
-    if (g_error_index.error_log) {
-        fclose(g_error_index.error_log);
-        g_error_index.error_log = NULL;
-    }
-    
-    g_error_index.error_count = 0;
-    g_error_index.error_capacity = 0;
-    
-    pthread_mutex_unlock(&g_error_index.mutex);
-}
-
-void diram_error_record(diram_error_code_t code, const char* fmt, ...) {
-    pthread_mutex_lock(&g_error_index.mutex);
-    
-    // Ensure space in error index
-    if (g_error_index.error_count >= g_error_index.error_capacity) {
-        // Rotate errors - remove oldest 25%
-        size_t keep_count = (g_error_index.error_capacity * 3) / 4;
-        memmove(g_error_index.errors, 
-                g_error_index.errors + (g_error_index.error_capacity - keep_count),
-                keep_count * sizeof(diram_error_context_t));
-        g_error_index.error_count = keep_count;
-    }
-    
-    // Record new error
-    diram_error_context_t* ctx = &g_error_index.errors[g_error_index.error_count++];
-    ctx->code = code;
-    ctx->timestamp = time(NULL);
-    ctx->pid = getpid();
-    
-    // Format message
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(ctx->context, sizeof(ctx->context), fmt, args);
-    va_end(args);
-    
-    // Determine severity
-    if (code >= DIRAM_ERR_BOUNDARY_VIOLATION && code <= DIRAM_ERR_GOVERNANCE_FAIL) {
-        ctx->severity = 3; // Critical
-    } else if (code >= DIRAM_ERR_PID_MISMATCH) {
-        ctx->severity = 2; // Error
-    } else {
-        ctx->severity = 1; // Warning
-    }
-    
-    // Log to file
-    if (g_error_index.error_log) {
-        fprintf(g_error_index.error_log, 
-                "%lu|%d|0x%04X|%d|%s\n",
-                ctx->timestamp, ctx->pid, ctx->code, 
-                ctx->severity, ctx->context);
-        fflush(g_error_index.error_log);
-    }
-    
-    pthread_mutex_unlock(&g_error_index.mutex);
-}
+// Error index lives in error_index.c
 
 // Memory Space Management
 diram_memory_space_t* diram_space_create(const char* name, size_t limit) {
-    diram_memory_space_t* space = calloc(1, sizeof(diram_memory_space_t));
+    // Shards are cache-line aligned, which calloc does not guarantee
+    diram_memory_space_t* space = aligned_alloc(64, sizeof(diram_memory_space_t));
     if (!space) {
         DIRAM_ERROR(DIRAM_ERR_MEMORY_EXHAUSTED, 
                     "Failed to create memory space '%s'", name);
         return NULL;
     }
+    memset(space, 0, sizeof(*space));
     
     strncpy(space->space_name, name, sizeof(space->space_name) - 1);
     space->limit_bytes = limit;
@@ -137,6 +40,12 @@ diram_memory_space_t* diram_space_create(const char* name, size_t limit) {
     space->isolation_active = 1;
     pthread_mutex_init(&space->lock, NULL);
     
+    // Stranded quota is bounded by two batches per shard: at most half the limit
+    space->shard_batch = limit / (DIRAM_SPACE_SHARDS * 4);
+    if (space->shard_batch > DIRAM_SPACE_SHARD_BATCH_MAX) {
+        space->shard_batch = DIRAM_SPACE_SHARD_BATCH_MAX;
+    }
+    
     return space;
 }
 
@@ -148,64 +57,149 @@ void diram_space_destroy(diram_memory_space_t* space) {
     free(space);
 }
 
-int diram_space_check_limit(diram_memory_space_t* space, size_t requested) {
-    if (!space) return -1;
+void diram_space_get_usage(diram_memory_space_t* space, size_t* used, uint32_t* count) {
+    if (!space) return;
+    
+    int64_t bytes = 0, allocations = 0;
+    for (size_t i = 0; i < DIRAM_SPACE_SHARDS; i++) {
+        // A shard can go negative when a free lands on another CPU
+        bytes += atomic_load_explicit(&space->shards[i].used, memory_order_relaxed);
+        allocations += atomic_load_explicit(&space->shards[i].count, memory_order_relaxed);
+    }
+    if (bytes < 0) bytes = 0;
+    if (allocations < 0) allocations = 0;
     
     pthread_mutex_lock(&space->lock);
-    int result = (space->used_bytes + requested <= space->limit_bytes) ? 0 : -1;
+    space->used_bytes = (size_t)bytes;
+    space->allocation_count = (uint32_t)allocations;
     pthread_mutex_unlock(&space->lock);
     
+    if (used) *used = (size_t)bytes;
+    if (count) *count = (uint32_t)allocations;
+}
+
+int diram_space_check_limit(diram_memory_space_t* space, size_t requested) {
+    if (!space) return -1;
+    
+    size_t used;
+    diram_space_get_usage(space, &used, NULL);
+    int result = (requested <= space->limit_bytes &&
+                  used <= space->limit_bytes - requested) ? 0 : -1;
+    
     if (result < 0) {
         DIRAM_ERROR(DIRAM_ERR_MEMORY_EXHAUSTED,
                     "Space '%s' limit exceeded: %zu + %zu > %zu",
-                    space->space_name, space->used_bytes, 
+                    space->space_name, used, 
                     requested, space->limit_bytes);
     }
     
     return result;
 }
 
-// Enhanced Allocation Implementation
-diram_enhanced_allocation_t* diram_alloc_enhanced(size_t size, 
-                                                   const char* tag,
-                                                   diram_memory_space_t* space) {
-    // Check space limits first
-    if (space && diram_space_check_limit(space, size) < 0) {
-        return NULL;
+static diram_space_shard_t* space_shard(diram_memory_space_t* space) {
+    int cpu = sched_getcpu();
+    size_t index = cpu >= 0 ? (size_t)cpu : (size_t)pthread_self() >> 6;
+    return &space->shards[index % DIRAM_SPACE_SHARDS];
+}
+
+static int space_reserve_exact(diram_memory_space_t* space, size_t bytes) {
+    size_t reserved = atomic_load_explicit(&space->reserved, memory_order_relaxed);
+    do {
+        if (bytes > space->limit_bytes || reserved > space->limit_bytes - bytes) {
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&space->reserved, &reserved,
+                                                    reserved + bytes,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+    return 0;
+}
+
+int diram_space_charge(diram_memory_space_t* space, size_t bytes, uint32_t count) {
+    if (!space) return -1;
+    
+    diram_space_shard_t* shard = space_shard(space);
+    
+    // Fast path: spend this CPU's quota, no shared cache line touched
+    int charged = 0;
+    size_t quota = atomic_load_explicit(&shard->quota, memory_order_relaxed);
+    while (quota >= bytes) {
+        if (atomic_compare_exchange_weak_explicit(&shard->quota, &quota, quota - bytes,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            charged = 1;
+            break;
+        }
     }
     
-    // Allocate with base functionality
-    diram_allocation_t* base_alloc = diram_alloc_traced(size, tag);
-    if (!base_alloc) {
-        DIRAM_ERROR(DIRAM_ERR_HEAP_CONSTRAINT, 
-                    "Base allocation failed for size %zu", size);
-        return NULL;
+    // Refill: reserve the request plus one batch of headroom for the shard
+    size_t batch = space->shard_batch;
+    if (!charged && bytes <= SIZE_MAX - batch &&
+        space_reserve_exact(space, bytes + batch) == 0) {
+        atomic_fetch_add_explicit(&shard->quota, batch, memory_order_relaxed);
+        charged = 1;
     }
     
-    // Create enhanced wrapper
-    diram_enhanced_allocation_t* enhanced = 
-        calloc(1, sizeof(diram_enhanced_allocation_t));
-    if (!enhanced) {
-        diram_free_traced(base_alloc);
-        return NULL;
+    // Near the limit: hand every shard's quota back, then CAS the exact size
+    if (!charged) {
+        pthread_mutex_lock(&space->lock);
+        for (size_t i = 0; i < DIRAM_SPACE_SHARDS; i++) {
+            size_t stranded = atomic_exchange_explicit(&space->shards[i].quota, 0,
+                                                       memory_order_relaxed);
+            atomic_fetch_sub_explicit(&space->reserved, stranded, memory_order_relaxed);
+        }
+        charged = space_reserve_exact(space, bytes) == 0;
+        pthread_mutex_unlock(&space->lock);
+    }
+    
+    if (!charged) {
+        DIRAM_ERROR(DIRAM_ERR_MEMORY_EXHAUSTED,
+                    "Space '%s' limit exceeded: %zu + %zu > %zu",
+                    space->space_name,
+                    atomic_load_explicit(&space->reserved, memory_order_relaxed),
+                    bytes, space->limit_bytes);
+        return -1;
     }
     
-    // Copy base allocation
-    memcpy(&enhanced->base, base_alloc, sizeof(diram_allocation_t));
-    free(base_alloc); // Free the temporary base struct
+    atomic_fetch_add_explicit(&shard->used, (int64_t)bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->count, count, memory_order_relaxed);
+    return 0;
+}
+
+void diram_space_uncharge(diram_memory_space_t* space, size_t bytes, uint32_t count) {
+    if (!space) return;
     
-    // Initialize enhanced fields
+    diram_space_shard_t* shard = space_shard(space);
+    atomic_fetch_sub_explicit(&shard->used, (int64_t)bytes, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&shard->count, count, memory_order_relaxed);
+    
+    // Freed bytes become local quota; beyond two batches the excess goes
+    // back to the space so other CPUs can reserve it
+    size_t batch = space->shard_batch;
+    size_t quota = atomic_fetch_add_explicit(&shard->quota, bytes, memory_order_relaxed) + bytes;
+    while (quota > 2 * batch) {
+        if (atomic_compare_exchange_weak_explicit(&shard->quota, &quota, batch,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            atomic_fetch_sub_explicit(&space->reserved, quota - batch, memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+// Initialize enhanced fields and apply zero-trust features if enabled
+static void enhanced_init(diram_enhanced_allocation_t* enhanced, size_t size,
+                          diram_memory_space_t* space, int guarded) {
     enhanced->last_error = DIRAM_ERR_NONE;
     enhanced->error_count = 0;
     enhanced->space = space;
     enhanced->flags = 0;
     
-    // Apply zero-trust features if enabled
     if (g_feature_config.zero_trust_mode) {
         enhanced->flags |= 0x01; // Mark as zero-trust enabled
         
-        // In production, would add guard pages here
-        if (g_feature_config.enable_guard_pages) {
+        // The block itself was placed against a guard page
+        if (guarded) {
             enhanced->flags |= 0x02;
         }
         
@@ -220,15 +214,36 @@ diram_enhanced_allocation_t* diram_alloc_enhanced(size_t size,
             *canary_end = DIRAM_GUARD_PATTERN;
         }
     }
+}
+
+// Enhanced Allocation Implementation
+diram_enhanced_allocation_t* diram_alloc_enhanced(size_t size, 
+                                                   const char* tag,
+                                                   diram_memory_space_t* space) {
+    // Charge the space first; the reservation is returned on failure
+    if (space && diram_space_charge(space, size, 1) < 0) {
+        return NULL;
+    }
     
-    // Update space accounting
-    if (space) {
-        pthread_mutex_lock(&space->lock);
-        space->used_bytes += size;
-        space->allocation_count++;
-        pthread_mutex_unlock(&space->lock);
+    // Zero-trust guard pages need both the feature flag and guard_pages
+    int guarded = g_feature_config.zero_trust_mode &&
+                  g_feature_config.enable_guard_pages &&
+                  diram_config_current()->guard_pages;
+    
+    // Allocate with base functionality; the enhanced tracker is colocated
+    // with the payload so no wrapper allocation or copy is needed
+    diram_enhanced_allocation_t* enhanced = (diram_enhanced_allocation_t*)
+        diram_alloc_traced_flags(size, tag, sizeof(diram_enhanced_allocation_t),
+                                 guarded ? DIRAM_ALLOC_GUARDED : 0);
+    if (!enhanced) {
+        DIRAM_ERROR(DIRAM_ERR_HEAP_CONSTRAINT, 
+                    "Base allocation failed for size %zu", size);
+        diram_space_uncharge(space, size, 1);
+        return NULL;
     }
     
+    enhanced_init(enhanced, size, space, guarded);
+    
     // Emit telemetry event
     diram_telemetry_event_t event = {
         .event_id = (uint64_t)enhanced,
@@ -246,6 +261,49 @@ diram_enhanced_allocation_t* diram_alloc_enhanced(size_t size,
     return enhanced;
 }
 
+int diram_alloc_enhanced_batch(size_t n, const size_t* sizes, const char* tag,
+                               diram_memory_space_t* space,
+                               diram_enhanced_allocation_t** out) {
+    if (n == 0 || !sizes || !out) return -1;
+    
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (sizes[i] > SIZE_MAX - total) return -1;
+        total += sizes[i];
+    }
+    
+    // The space limit applies to the burst as a whole
+    if (space && diram_space_charge(space, total, (uint32_t)n) < 0) {
+        return -1;
+    }
+    
+    // The tracker is the first member, so the pointer arrays are interchangeable
+    if (diram_alloc_batch_ex(n, sizes, tag, sizeof(diram_enhanced_allocation_t),
+                             (diram_allocation_t**)out) < 0) {
+        DIRAM_ERROR(DIRAM_ERR_HEAP_CONSTRAINT,
+                    "Batch allocation failed for %zu allocations (%zu bytes)", n, total);
+        diram_space_uncharge(space, total, (uint32_t)n);
+        return -1;
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        // Members share one region, so only the canaries apply
+        enhanced_init(out[i], sizes[i], space, 0);
+    }
+    
+    diram_telemetry_event_t event = {
+        .event_id = (uint64_t)out[0],
+        .layer = 2, // Opcode-bound
+        .error_code = DIRAM_ERR_NONE,
+        .address = out[0]->base.base_addr,
+        .size = total,
+        .operation = "ALLOC_BATCH"
+    };
+    diram_telemetry_emit(&event);
+    
+    return 0;
+}
+
 void diram_free_enhanced(diram_enhanced_allocation_t* alloc) {
     if (!alloc) return;
     
@@ -264,12 +322,7 @@ void diram_free_enhanced(diram_enhanced_allocation_t* alloc) {
     }
     
     // Update space accounting
-    if (alloc->space) {
-        pthread_mutex_lock(&alloc->space->lock);
-        alloc->space->used_bytes -= alloc->base.size;
-        alloc->space->allocation_count--;
-        pthread_mutex_unlock(&alloc->space->lock);
-    }
+    diram_space_uncharge(alloc->space, alloc->base.size, 1);
     
     // Emit telemetry
     diram_telemetry_event_t event = {
@@ -282,12 +335,23 @@ void diram_free_enhanced(diram_enhanced_allocation_t* alloc) {
     };
     diram_telemetry_emit(&event);
     
-    // Free base allocation
+    // Clear enhanced fields; the base free releases the whole block
+    alloc->last_error = DIRAM_ERR_NONE;
+    alloc->error_count = 0;
+    alloc->space = NULL;
+    alloc->flags = 0;
     diram_free_traced(&alloc->base);
-    
-    // Clear and free enhanced structure
-    memset(alloc, 0, sizeof(*alloc));
-    free(alloc);
+}
+
+// Configuration Integration
+int diram_feature_configure(const diram_feature_config_t* config) {
+    if (!config) return -1;
+    g_feature_config = *config;
+    return 0;
+}
+
+const diram_feature_config_t* diram_feature_get_config(void) {
+    return &g_feature_config;
 }
 
 // Governance Implementation
@@ -318,32 +382,4 @@ const diram_governance_stats_t* diram_governance_get_stats(void) {
     return &g_governance_stats;
 }
 
-// Telemetry stubs (would connect to actual telemetry system)
-static int g_telemetry_initialized = 0;
-
-int diram_telemetry_init(const char* endpoint) {
-    (void)endpoint;
-    g_telemetry_initialized = 1;
-    return 0;
-}
-
-void diram_telemetry_shutdown(void) {
-    g_telemetry_initialized = 0;
-}
-
-void diram_telemetry_emit(diram_telemetry_event_t* event) {
-    if (!g_telemetry_initialized || !event) return;
-    
-    // In production, would send to telemetry endpoint
-    // For now, log to stderr if verbose
-    if (g_feature_config.telemetry_level >= 2) {
-        fprintf(stderr, "[TELEMETRY] L%d|%s|%p|%zu|%s\n",
-                event->layer, event->operation, 
-                event->address, event->size, event->receipt);
-    }
-}
-
-int diram_telemetry_flush(void) {
-    // In production, would flush telemetry buffer
-    return 0;
-}
\ No newline at end of file
+// Telemetry export lives in telemetry.c
@@ -0,0 +1,235 @@
+// src/core/feature-alloc/page_cache.c
+// mmap-backed page regions with optional guard pages
+// OBINexus Project - Directed Instruction RAM
+//
+// A guarded region is [PROT_NONE page | body | PROT_NONE page]. The guards
+// are set up once when the region is mapped; freed regions of a cacheable
+// size class are kept on a per-class stack with their guards intact, so
+// the steady state is a mutex push/pop rather than mmap + mprotect + munmap.
+
+#include "diram/core/feature-alloc/page_cache.h"
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+
+typedef struct {
+    pthread_mutex_t lock;
+    void* bodies[DIRAM_PAGE_CACHE_DEPTH];
+    size_t count;
+} page_cache_class_t;
+
+// [0] unguarded, [1] guarded
+static page_cache_class_t g_page_classes[2][DIRAM_PAGE_CACHE_CLASS_COUNT];
+static pthread_once_t g_page_once = PTHREAD_ONCE_INIT;
+static size_t g_page_size = 4096;
+static atomic_int g_hugepage_mode = DIRAM_HUGEPAGE_OFF;
+
+static struct {
+    atomic_uint_fast64_t regions_mapped;
+    atomic_uint_fast64_t regions_unmapped;
+    atomic_uint_fast64_t cache_hits;
+    atomic_uint_fast64_t cache_puts;
+    atomic_uint_fast64_t bytes_cached;
+    atomic_uint_fast64_t hugetlb_maps;
+    atomic_uint_fast64_t hugetlb_fallbacks;
+} g_page_stats;
+
+static void page_cache_init(void) {
+    long ps = sysconf(_SC_PAGESIZE);
+    if (ps > 0) g_page_size = (size_t)ps;
+    for (int g = 0; g < 2; g++) {
+        for (int i = 0; i < DIRAM_PAGE_CACHE_CLASS_COUNT; i++) {
+            pthread_mutex_init(&g_page_classes[g][i].lock, NULL);
+        }
+    }
+}
+
+size_t diram_page_size(void) {
+    pthread_once(&g_page_once, page_cache_init);
+    return g_page_size;
+}
+
+// Same two-per-power-of-two scheme as the slab classes, counted in pages
+static int page_class_for(size_t pages) {
+    if (pages <= 1) return 0;
+    if (pages > DIRAM_PAGE_CACHE_MAX_PAGES) return -1;
+    if (pages == 2) return 1;
+
+    int p = 63 - __builtin_clzll((unsigned long long)(pages - 1));
+    size_t half_step = (size_t)3 << (p - 1);
+    return 2 * p + (pages <= half_step ? 0 : 1);
+}
+
+static size_t page_class_pages(int cls) {
+    if (cls < 2) return (size_t)cls + 1;
+    int p = cls / 2;
+    return (cls & 1) ? (size_t)1 << (p + 1) : (size_t)3 << (p - 1);
+}
+
+size_t diram_page_cache_round(size_t bytes, int guarded) {
+    size_t ps = diram_page_size();
+    if (bytes == 0) bytes = 1;
+    if (bytes > SIZE_MAX - DIRAM_HUGEPAGE_SIZE) return 0;
+
+    size_t pages = (bytes + ps - 1) / ps;
+    int cls = page_class_for(pages);
+    if (cls >= 0) return page_class_pages(cls);
+
+    // Whole huge pages, so a MAP_HUGETLB attempt is possible and munmap
+    // gets the same length whether or not it succeeded
+    if (!guarded && bytes >= DIRAM_HUGEPAGE_SIZE &&
+        atomic_load_explicit(&g_hugepage_mode, memory_order_relaxed) == DIRAM_HUGEPAGE_HUGETLB) {
+        size_t huge = (bytes + DIRAM_HUGEPAGE_SIZE - 1) / DIRAM_HUGEPAGE_SIZE;
+        return huge * (DIRAM_HUGEPAGE_SIZE / ps);
+    }
+    return pages;
+}
+
+static void* page_map(size_t pages, int guarded) {
+    size_t ps = g_page_size;
+    size_t body_len = pages * ps;
+    int mode = atomic_load_explicit(&g_hugepage_mode, memory_order_relaxed);
+
+#ifdef MAP_HUGETLB
+    if (!guarded && mode == DIRAM_HUGEPAGE_HUGETLB && body_len % DIRAM_HUGEPAGE_SIZE == 0) {
+        void* huge = mmap(NULL, body_len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (huge != MAP_FAILED) {
+            atomic_fetch_add_explicit(&g_page_stats.hugetlb_maps, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_page_stats.regions_mapped, 1, memory_order_relaxed);
+            return huge;
+        }
+        atomic_fetch_add_explicit(&g_page_stats.hugetlb_fallbacks, 1, memory_order_relaxed);
+    }
+#endif
+
+    size_t map_len = guarded ? body_len + 2 * ps : body_len;
+    char* map = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) return NULL;
+
+    char* body = guarded ? map + ps : map;
+    if (guarded &&
+        (mprotect(map, ps, PROT_NONE) != 0 ||
+         mprotect(body + body_len, ps, PROT_NONE) != 0)) {
+        munmap(map, map_len);
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (mode != DIRAM_HUGEPAGE_OFF && body_len >= DIRAM_HUGEPAGE_SIZE) {
+        madvise(body, body_len, MADV_HUGEPAGE);
+    }
+#endif
+
+    atomic_fetch_add_explicit(&g_page_stats.regions_mapped, 1, memory_order_relaxed);
+    return body;
+}
+
+static void page_unmap(void* body, size_t pages, int guarded) {
+    size_t ps = g_page_size;
+    if (guarded) {
+        munmap((char*)body - ps, (pages + 2) * ps);
+    } else {
+        munmap(body, pages * ps);
+    }
+    atomic_fetch_add_explicit(&g_page_stats.regions_unmapped, 1, memory_order_relaxed);
+}
+
+void* diram_page_cache_get(size_t pages, int guarded) {
+    pthread_once(&g_page_once, page_cache_init);
+    if (pages == 0) return NULL;
+    guarded = guarded ? 1 : 0;
+
+    int cls = page_class_for(pages);
+    if (cls >= 0 && page_class_pages(cls) == pages) {
+        page_cache_class_t* c = &g_page_classes[guarded][cls];
+        pthread_mutex_lock(&c->lock);
+        void* body = c->count > 0 ? c->bodies[--c->count] : NULL;
+        pthread_mutex_unlock(&c->lock);
+        if (body) {
+            atomic_fetch_sub_explicit(&g_page_stats.bytes_cached, pages * g_page_size,
+                                      memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_page_stats.cache_hits, 1, memory_order_relaxed);
+            return body;
+        }
+    }
+    return page_map(pages, guarded);
+}
+
+void diram_page_cache_put(void* body, size_t pages, int guarded) {
+    if (!body) return;
+    guarded = guarded ? 1 : 0;
+
+    int cls = page_class_for(pages);
+    size_t bytes = pages * g_page_size;
+    if (cls >= 0 && page_class_pages(cls) == pages &&
+        atomic_load_explicit(&g_page_stats.bytes_cached, memory_order_relaxed) + bytes <=
+            DIRAM_PAGE_CACHE_MAX_BYTES) {
+        page_cache_class_t* c = &g_page_classes[guarded][cls];
+        pthread_mutex_lock(&c->lock);
+        int cached = c->count < DIRAM_PAGE_CACHE_DEPTH;
+        if (cached) c->bodies[c->count++] = body;
+        pthread_mutex_unlock(&c->lock);
+        if (cached) {
+            atomic_fetch_add_explicit(&g_page_stats.bytes_cached, bytes, memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_page_stats.cache_puts, 1, memory_order_relaxed);
+            return;
+        }
+    }
+    page_unmap(body, pages, guarded);
+}
+
+void diram_page_cache_trim(void) {
+    pthread_once(&g_page_once, page_cache_init);
+    for (int g = 0; g < 2; g++) {
+        for (int i = 0; i < DIRAM_PAGE_CACHE_CLASS_COUNT; i++) {
+            page_cache_class_t* c = &g_page_classes[g][i];
+            size_t pages = page_class_pages(i);
+            pthread_mutex_lock(&c->lock);
+            while (c->count > 0) {
+                page_unmap(c->bodies[--c->count], pages, g);
+                atomic_fetch_sub_explicit(&g_page_stats.bytes_cached, pages * g_page_size,
+                                          memory_order_relaxed);
+            }
+            pthread_mutex_unlock(&c->lock);
+        }
+    }
+}
+
+int diram_hugepage_mode_from_string(const char* value, diram_hugepage_mode_t* out) {
+    if (!value || !out) return -1;
+    // Values may carry trailing comments, so match by prefix
+    if (strncmp(value, "hugetlb", 7) == 0) {
+        *out = DIRAM_HUGEPAGE_HUGETLB;
+    } else if (strncmp(value, "thp", 3) == 0 || strncmp(value, "true", 4) == 0) {
+        *out = DIRAM_HUGEPAGE_THP;
+    } else if (strncmp(value, "off", 3) == 0 || strncmp(value, "false", 5) == 0) {
+        *out = DIRAM_HUGEPAGE_OFF;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+void diram_page_cache_set_hugepage_mode(diram_hugepage_mode_t mode) {
+    atomic_store_explicit(&g_hugepage_mode, (int)mode, memory_order_relaxed);
+}
+
+diram_hugepage_mode_t diram_page_cache_get_hugepage_mode(void) {
+    return (diram_hugepage_mode_t)atomic_load_explicit(&g_hugepage_mode, memory_order_relaxed);
+}
+
+void diram_page_cache_get_stats(diram_page_cache_stats_t* out) {
+    if (!out) return;
+    out->regions_mapped = atomic_load_explicit(&g_page_stats.regions_mapped, memory_order_relaxed);
+    out->regions_unmapped = atomic_load_explicit(&g_page_stats.regions_unmapped, memory_order_relaxed);
+    out->cache_hits = atomic_load_explicit(&g_page_stats.cache_hits, memory_order_relaxed);
+    out->cache_puts = atomic_load_explicit(&g_page_stats.cache_puts, memory_order_relaxed);
+    out->bytes_cached = atomic_load_explicit(&g_page_stats.bytes_cached, memory_order_relaxed);
+    out->hugetlb_maps = atomic_load_explicit(&g_page_stats.hugetlb_maps, memory_order_relaxed);
+    out->hugetlb_fallbacks = atomic_load_explicit(&g_page_stats.hugetlb_fallbacks,
+                                                  memory_order_relaxed);
+}
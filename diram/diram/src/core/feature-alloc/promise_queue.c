@@ -0,0 +1,253 @@
+// src/core/feature-alloc/promise_queue.c
+// Completion queue for async promises: settling promises post an entry
+// while holding their state lock, one reaper drains entries in batches.
+// Attach reserves a ring slot, so a post can never find the ring full.
+#include "diram/core/feature-alloc/async_promise.h"
+#include "diram/core/feature-alloc/async_promise_internal.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+struct diram_completion_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    diram_completion_t* ring;
+    size_t mask;
+    size_t head;        // Next entry to reap
+    size_t tail;        // Next slot to post into
+    size_t capacity;
+    size_t reserved;    // Attached promises plus unreaped entries
+};
+
+diram_completion_queue_t* diram_cq_create(size_t capacity) {
+    if (capacity == 0) return NULL;
+
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+
+    diram_completion_queue_t* cq = calloc(1, sizeof(diram_completion_queue_t));
+    if (!cq) return NULL;
+    cq->ring = calloc(slots, sizeof(diram_completion_t));
+    if (!cq->ring) {
+        free(cq);
+        return NULL;
+    }
+
+    pthread_mutex_init(&cq->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cq->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    cq->mask = slots - 1;
+    cq->capacity = capacity;
+    return cq;
+}
+
+void diram_cq_destroy(diram_completion_queue_t* cq) {
+    if (!cq) return;
+
+    // Unreaped entries still own a promise reference. Promises that are
+    // attached and pending must be detached first.
+    while (cq->head != cq->tail) {
+        diram_promise_release(cq->ring[cq->head & cq->mask].promise);
+        cq->head++;
+    }
+
+    pthread_mutex_destroy(&cq->lock);
+    pthread_cond_destroy(&cq->cond);
+    free(cq->ring);
+    free(cq);
+}
+
+int diram_promise_attach(diram_async_promise_t* promise,
+                         diram_completion_queue_t* cq, void* user_data) {
+    if (!promise || !cq) return -1;
+
+    pthread_mutex_lock(&cq->lock);
+    if (cq->reserved >= cq->capacity) {
+        pthread_mutex_unlock(&cq->lock);
+        return -1;
+    }
+    cq->reserved++;
+    pthread_mutex_unlock(&cq->lock);
+
+    pthread_mutex_lock(&promise->state_mutex);
+    if (promise->cq) {
+        pthread_mutex_unlock(&promise->state_mutex);
+        pthread_mutex_lock(&cq->lock);
+        cq->reserved--;
+        pthread_mutex_unlock(&cq->lock);
+        return -1;
+    }
+
+    diram_promise_retain(promise);
+    promise->cq = cq;
+    promise->cq_user_data = user_data;
+
+    // Already settled: post right away so the reaper still sees it
+    if (promise->receipt.state != PROMISE_STATE_PENDING) {
+        diram_cq_post_locked(promise);
+    }
+    pthread_mutex_unlock(&promise->state_mutex);
+    return 0;
+}
+
+int diram_promise_detach(diram_async_promise_t* promise) {
+    if (!promise) return -1;
+
+    pthread_mutex_lock(&promise->state_mutex);
+    diram_completion_queue_t* cq = promise->cq;
+    promise->cq = NULL;
+    promise->cq_user_data = NULL;
+    pthread_mutex_unlock(&promise->state_mutex);
+
+    // Already posted (or never attached): the entry stays in the queue
+    if (!cq) return -1;
+
+    pthread_mutex_lock(&cq->lock);
+    cq->reserved--;
+    pthread_mutex_unlock(&cq->lock);
+    diram_promise_release(promise);
+    return 0;
+}
+
+void diram_cq_post_locked(diram_async_promise_t* promise) {
+    diram_completion_queue_t* cq = promise->cq;
+    if (!cq) return;
+    promise->cq = NULL;
+
+    // The queue's reference moves from the promise into the entry
+    diram_completion_t entry = {
+        .promise = promise,
+        .user_data = promise->cq_user_data,
+        .state = promise->receipt.state,
+        .reason = promise->receipt.reject_reason,
+        .allocation = promise->receipt.state == PROMISE_STATE_RESOLVED ?
+                      promise->result.resolved_allocation : NULL
+    };
+
+    pthread_mutex_lock(&cq->lock);
+    cq->ring[cq->tail & cq->mask] = entry;
+    cq->tail++;
+    pthread_cond_signal(&cq->cond);
+    pthread_mutex_unlock(&cq->lock);
+}
+
+static void deadline_after(struct timespec* ts, uint64_t timeout_ms) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout_ms / 1000;
+    ts->tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+static size_t cq_reap_until(diram_completion_queue_t* cq, diram_completion_t* out,
+                            size_t max, size_t min_complete,
+                            const struct timespec* deadline) {
+    if (min_complete > max) min_complete = max;
+
+    pthread_mutex_lock(&cq->lock);
+    while (cq->tail - cq->head < min_complete && deadline) {
+        if (pthread_cond_timedwait(&cq->cond, &cq->lock, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    size_t count = 0;
+    while (count < max && cq->head != cq->tail) {
+        out[count++] = cq->ring[cq->head & cq->mask];
+        cq->head++;
+    }
+    cq->reserved -= count;
+    pthread_mutex_unlock(&cq->lock);
+
+    // Drop the queue's references outside the lock; the caller's own
+    // reference (if it still holds one) keeps entry.promise valid
+    for (size_t i = 0; i < count; i++) {
+        diram_promise_release(out[i].promise);
+    }
+    return count;
+}
+
+size_t diram_cq_reap(diram_completion_queue_t* cq, diram_completion_t* out,
+                     size_t max, size_t min_complete, uint64_t timeout_ms) {
+    if (!cq || !out || max == 0) return 0;
+
+    if (timeout_ms == 0) {
+        return cq_reap_until(cq, out, max, 0, NULL);
+    }
+
+    struct timespec deadline;
+    deadline_after(&deadline, timeout_ms);
+    return cq_reap_until(cq, out, max, min_complete, &deadline);
+}
+
+// Shared driver for all/any: attach every promise to a private queue and
+// reap in batches until the outcome is decided or the deadline passes
+static int promise_gather(diram_async_promise_t** promises, size_t n,
+                          uint64_t timeout_ms, int any, size_t* index) {
+    if (index) *index = SIZE_MAX;
+    if (!promises || n == 0) return -1;
+
+    diram_completion_queue_t* cq = diram_cq_create(n);
+    if (!cq) return -1;
+
+    for (size_t i = 0; i < n; i++) {
+        if (diram_promise_attach(promises[i], cq, (void*)(uintptr_t)i) < 0) {
+            for (size_t j = 0; j < i; j++) diram_promise_detach(promises[j]);
+            diram_cq_destroy(cq);
+            return -1;
+        }
+    }
+
+    struct timespec deadline;
+    deadline_after(&deadline, timeout_ms);
+
+    int result = -1;
+    size_t settled = 0;
+    size_t decided = SIZE_MAX;
+    diram_completion_t batch[32];
+
+    while (settled < n && decided == SIZE_MAX) {
+        size_t got = cq_reap_until(cq, batch, 32, 1, &deadline);
+        if (got == 0) break;    // Timed out
+
+        for (size_t i = 0; i < got && decided == SIZE_MAX; i++) {
+            size_t which = (size_t)(uintptr_t)batch[i].user_data;
+            int resolved = batch[i].state == PROMISE_STATE_RESOLVED;
+            if (any == resolved) {
+                // any: first resolution wins; all: first rejection fails
+                decided = which;
+                result = resolved ? 0 : -1;
+            }
+        }
+        settled += got;
+    }
+
+    if (decided == SIZE_MAX && settled == n) {
+        // all: everything resolved; any: everything rejected
+        result = any ? -1 : 0;
+    }
+    if (index) *index = decided;
+
+    // Leave the still-pending promises untouched apart from the queue
+    for (size_t i = 0; i < n; i++) diram_promise_detach(promises[i]);
+    diram_cq_destroy(cq);
+    return result;
+}
+
+int diram_promise_all(diram_async_promise_t** promises, size_t n,
+                      uint64_t timeout_ms, size_t* failed_index) {
+    return promise_gather(promises, n, timeout_ms, 0, failed_index);
+}
+
+int diram_promise_any(diram_async_promise_t** promises, size_t n,
+                      uint64_t timeout_ms, size_t* resolved_index) {
+    return promise_gather(promises, n, timeout_ms, 1, resolved_index);
+}
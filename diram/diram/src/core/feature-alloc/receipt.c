@@ -0,0 +1,182 @@
+// core/feature-alloc/receipt.c
+// Receipt mode selection and the keyed fast receipt (SipHash-2-4-128)
+#include "diram/core/feature-alloc/receipt.h"
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+static int g_receipt_mode = DIRAM_RECEIPT_SHA256;
+
+// Per-process SipHash key, generated on first use
+static uint64_t g_sip_k0, g_sip_k1;
+static pthread_once_t g_sip_key_once = PTHREAD_ONCE_INIT;
+
+static void sip_key_init(void) {
+    uint64_t key[2] = {0, 0};
+    size_t got = 0;
+
+#if defined(__linux__)
+    ssize_t n = getrandom(key, sizeof(key), 0);
+    if (n == (ssize_t)sizeof(key)) got = sizeof(key);
+#endif
+    if (got != sizeof(key)) {
+        int fd = open("/dev/urandom", O_RDONLY);
+        if (fd >= 0) {
+            if (read(fd, key, sizeof(key)) == (ssize_t)sizeof(key)) got = sizeof(key);
+            close(fd);
+        }
+    }
+    if (got != sizeof(key)) {
+        // Last resort: not secret, but still distinct per process
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        key[0] = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ (uint64_t)getpid();
+        key[1] = key[0] * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)&key;
+    }
+
+    g_sip_k0 = key[0];
+    g_sip_k1 = key[1];
+}
+
+static inline uint64_t rotl64(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+static inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+#define SIPROUND                                                      \
+    do {                                                              \
+        v0 += v1; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32); \
+        v2 += v3; v3 = rotl64(v3, 16); v3 ^= v2;                      \
+        v0 += v3; v3 = rotl64(v3, 21); v3 ^= v0;                      \
+        v2 += v1; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32); \
+    } while (0)
+
+void diram_siphash128(const void* data, size_t len, uint8_t out[16]) {
+    const uint8_t* in = (const uint8_t*)data;
+    const uint8_t* end = in + (len & ~(size_t)7);
+    uint64_t v0, v1, v2, v3, m, b;
+
+    pthread_once(&g_sip_key_once, sip_key_init);
+
+    v0 = 0x736f6d6570736575ULL ^ g_sip_k0;
+    v1 = 0x646f72616e646f6dULL ^ g_sip_k1;
+    v2 = 0x6c7967656e657261ULL ^ g_sip_k0;
+    v3 = 0x7465646279746573ULL ^ g_sip_k1;
+    v1 ^= 0xee;     // 128-bit output variant
+
+    for (; in != end; in += 8) {
+        m = load_le64(in);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    b = (uint64_t)len << 56;
+    for (size_t i = 0; i < (len & 7); i++) {
+        b |= (uint64_t)in[i] << (8 * i);
+    }
+
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xee;
+    SIPROUND; SIPROUND; SIPROUND; SIPROUND;
+    b = v0 ^ v1 ^ v2 ^ v3;
+    memcpy(out, &b, 8);
+
+    v1 ^= 0xdd;
+    SIPROUND; SIPROUND; SIPROUND; SIPROUND;
+    b = v0 ^ v1 ^ v2 ^ v3;
+    memcpy(out + 8, &b, 8);
+}
+
+#undef SIPROUND
+
+void diram_receipt_set_mode(diram_receipt_mode_t mode) {
+    __atomic_store_n(&g_receipt_mode, (int)mode, __ATOMIC_RELAXED);
+}
+
+diram_receipt_mode_t diram_receipt_get_mode(void) {
+    return (diram_receipt_mode_t)__atomic_load_n(&g_receipt_mode, __ATOMIC_RELAXED);
+}
+
+// Config values arrive with trailing comments/whitespace, so match prefixes
+int diram_receipt_mode_from_string(const char* name, diram_receipt_mode_t* mode) {
+    if (!name || !mode) return -1;
+
+    if (strncmp(name, "sha256", 6) == 0) {
+        *mode = DIRAM_RECEIPT_SHA256;
+    } else if (strncmp(name, "siphash", 7) == 0 || strncmp(name, "fast", 4) == 0) {
+        *mode = DIRAM_RECEIPT_SIPHASH;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+void diram_hex_encode(const uint8_t* bytes, size_t len, char* out) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0f];
+    }
+    out[2 * len] = '\0';
+}
+
+void diram_receipt_hex(const void* input, size_t len, char* out) {
+    if (diram_receipt_get_mode() == DIRAM_RECEIPT_SIPHASH) {
+        uint8_t mac[16];
+        diram_siphash128(input, len, mac);
+        diram_hex_encode(mac, sizeof(mac), out);
+    } else {
+        uint8_t digest[DIRAM_SHA256_DIGEST_LEN];
+        diram_sha256(input, len, digest);
+        diram_hex_encode(digest, sizeof(digest), out);
+    }
+}
+
+void diram_receipt_hex_lanes(const void* const inputs[DIRAM_SHA256_LANES], size_t count,
+                             size_t len, char* const out[DIRAM_SHA256_LANES]) {
+    if (count == 0 || count > DIRAM_SHA256_LANES) return;
+
+    // SipHash is already cheaper than a SIMD lane setup
+    if (diram_receipt_get_mode() != DIRAM_RECEIPT_SHA256) {
+        for (size_t i = 0; i < count; i++) {
+            diram_receipt_hex(inputs[i], len, out[i]);
+        }
+        return;
+    }
+
+    // Idle lanes rehash the last input; their digests are discarded
+    const void* lanes[DIRAM_SHA256_LANES];
+    uint8_t digests[DIRAM_SHA256_LANES][DIRAM_SHA256_DIGEST_LEN];
+    for (size_t i = 0; i < DIRAM_SHA256_LANES; i++) {
+        lanes[i] = inputs[i < count ? i : count - 1];
+    }
+
+    if (count == 1) {
+        diram_sha256(lanes[0], len, digests[0]);
+    } else {
+        diram_sha256_x8(lanes, len, digests);
+    }
+    for (size_t i = 0; i < count; i++) {
+        diram_hex_encode(digests[i], DIRAM_SHA256_DIGEST_LEN, out[i]);
+    }
+}
@@ -0,0 +1,494 @@
+// core/feature-alloc/sha256.c
+// SHA-256 for allocation receipts with runtime CPU dispatch:
+// x86 SHA extensions, ARMv8 crypto extensions, AVX2 8-lane multi-buffer
+// (batch only) and a portable scalar fallback.
+#include "diram/core/feature-alloc/receipt.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DIRAM_SHA256_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define DIRAM_SHA256_ARM 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+#endif
+
+typedef void (*sha256_compress_fn)(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+static const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t IV256[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static inline uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void store_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint32_t rotr32(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// Build the padded tail (1 or 2 blocks) from the last (total_len % 64) bytes
+static size_t sha256_pad_tail(const uint8_t* rem_data, uint64_t total_len, uint8_t tail[128]) {
+    size_t rem = (size_t)(total_len & 63);
+    size_t tail_len = rem < 56 ? 64 : 128;
+    uint64_t bits = total_len << 3;
+
+    memset(tail, 0, tail_len);
+    memcpy(tail, rem_data, rem);
+    tail[rem] = 0x80;
+    for (int i = 0; i < 8; i++) {
+        tail[tail_len - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    return tail_len / 64;
+}
+
+// ---------------------------------------------------------------------------
+// Portable scalar kernel
+// ---------------------------------------------------------------------------
+
+static void sha256_compress_scalar(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32_t w[64];
+
+    while (blocks--) {
+        for (int t = 0; t < 16; t++) {
+            w[t] = load_be32(data + 4 * t);
+        }
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = rotr32(w[t - 15], 7) ^ rotr32(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = rotr32(w[t - 2], 17) ^ rotr32(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 64; t++) {
+            uint32_t S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + S1 + ch + K256[t] + w[t];
+            uint32_t S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = S0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        data += 64;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// x86 SHA extensions
+// ---------------------------------------------------------------------------
+
+#ifdef DIRAM_SHA256_X86
+__attribute__((target("sha,sse4.1")))
+static void sha256_compress_shani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp, state0, state1, abef_save, cdgh_save, msg;
+    __m128i m[4];
+
+    // state[] is ABCD EFGH; the SHA instructions want ABEF / CDGH
+    tmp = _mm_loadu_si128((const __m128i*)(const void*)&state[0]);
+    state1 = _mm_loadu_si128((const __m128i*)(const void*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (blocks--) {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i*)(const void*)(data + 16 * i)), bswap);
+        }
+
+        for (int g = 0; g < 16; g++) {
+            msg = _mm_add_epi32(m[g & 3],
+                                _mm_loadu_si128((const __m128i*)(const void*)&K256[4 * g]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+
+            if (g < 12) {
+                // W[g+4] from W[g], W[g+1], W[g+2], W[g+3]
+                __m128i next = _mm_sha256msg1_epu32(m[g & 3], m[(g + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(m[(g + 3) & 3], m[(g + 2) & 3], 4));
+                m[g & 3] = _mm_sha256msg2_epu32(next, m[(g + 3) & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)(void*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)(void*)&state[4], state1);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 8-lane multi-buffer: one message per 32-bit lane
+// ---------------------------------------------------------------------------
+
+#define X8_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+__attribute__((target("avx2")))
+static void sha256_x8_avx2(const uint8_t* const data[DIRAM_SHA256_LANES], size_t len,
+                           uint8_t digests[DIRAM_SHA256_LANES][DIRAM_SHA256_DIGEST_LEN]) {
+    uint8_t tails[DIRAM_SHA256_LANES][128];
+    size_t full_blocks = len / 64;
+    size_t tail_blocks = 0;
+    __m256i s[8];
+    __m256i w[64];
+
+    for (int l = 0; l < DIRAM_SHA256_LANES; l++) {
+        tail_blocks = sha256_pad_tail(data[l] + 64 * full_blocks, len, tails[l]);
+    }
+    for (int i = 0; i < 8; i++) {
+        s[i] = _mm256_set1_epi32((int)IV256[i]);
+    }
+
+    for (size_t blk = 0; blk < full_blocks + tail_blocks; blk++) {
+        const uint8_t* src[DIRAM_SHA256_LANES];
+        for (int l = 0; l < DIRAM_SHA256_LANES; l++) {
+            src[l] = blk < full_blocks ? data[l] + 64 * blk
+                                       : tails[l] + 64 * (blk - full_blocks);
+        }
+        for (int t = 0; t < 16; t++) {
+            w[t] = _mm256_setr_epi32((int)load_be32(src[0] + 4 * t), (int)load_be32(src[1] + 4 * t),
+                                     (int)load_be32(src[2] + 4 * t), (int)load_be32(src[3] + 4 * t),
+                                     (int)load_be32(src[4] + 4 * t), (int)load_be32(src[5] + 4 * t),
+                                     (int)load_be32(src[6] + 4 * t), (int)load_be32(src[7] + 4 * t));
+        }
+        for (int t = 16; t < 64; t++) {
+            __m256i x = w[t - 15], y = w[t - 2];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(X8_ROTR(x, 7), X8_ROTR(x, 18)),
+                                          _mm256_srli_epi32(x, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(X8_ROTR(y, 17), X8_ROTR(y, 19)),
+                                          _mm256_srli_epi32(y, 10));
+            w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0),
+                                    _mm256_add_epi32(w[t - 7], s1));
+        }
+
+        __m256i a = s[0], b = s[1], c = s[2], d = s[3];
+        __m256i e = s[4], f = s[5], g = s[6], h = s[7];
+
+        for (int t = 0; t < 64; t++) {
+            __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(X8_ROTR(e, 6), X8_ROTR(e, 11)),
+                                          X8_ROTR(e, 25));
+            __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, S1),
+                                          _mm256_add_epi32(ch, _mm256_add_epi32(
+                                              _mm256_set1_epi32((int)K256[t]), w[t])));
+            __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(X8_ROTR(a, 2), X8_ROTR(a, 13)),
+                                          X8_ROTR(a, 22));
+            __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b),
+                                          _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            __m256i t2 = _mm256_add_epi32(S0, maj);
+            h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+            d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+        }
+
+        s[0] = _mm256_add_epi32(s[0], a); s[1] = _mm256_add_epi32(s[1], b);
+        s[2] = _mm256_add_epi32(s[2], c); s[3] = _mm256_add_epi32(s[3], d);
+        s[4] = _mm256_add_epi32(s[4], e); s[5] = _mm256_add_epi32(s[5], f);
+        s[6] = _mm256_add_epi32(s[6], g); s[7] = _mm256_add_epi32(s[7], h);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        uint32_t lanes[DIRAM_SHA256_LANES];
+        _mm256_storeu_si256((__m256i*)(void*)lanes, s[i]);
+        for (int l = 0; l < DIRAM_SHA256_LANES; l++) {
+            store_be32(digests[l] + 4 * i, lanes[l]);
+        }
+    }
+}
+
+#undef X8_ROTR
+#endif // DIRAM_SHA256_X86
+
+// ---------------------------------------------------------------------------
+// ARMv8 crypto extensions
+// ---------------------------------------------------------------------------
+
+#ifdef DIRAM_SHA256_ARM
+__attribute__((target("arch=armv8-a+crypto")))
+static void sha256_compress_armv8(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+    uint32x4_t m[4];
+
+    while (blocks--) {
+        uint32x4_t abcd_save = state0;
+        uint32x4_t efgh_save = state1;
+
+        for (int i = 0; i < 4; i++) {
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+
+        for (int g = 0; g < 16; g++) {
+            uint32x4_t wk = vaddq_u32(m[g & 3], vld1q_u32(&K256[4 * g]));
+            uint32x4_t abcd = state0;
+
+            if (g < 12) {
+                m[g & 3] = vsha256su1q_u32(vsha256su0q_u32(m[g & 3], m[(g + 1) & 3]),
+                                           m[(g + 2) & 3], m[(g + 3) & 3]);
+            }
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, abcd, wk);
+        }
+
+        state0 = vaddq_u32(state0, abcd_save);
+        state1 = vaddq_u32(state1, efgh_save);
+        data += 64;
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+#endif // DIRAM_SHA256_ARM
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+static int g_sha256_dispatched = 0;
+static diram_sha256_impl_t g_sha256_impl = DIRAM_SHA256_IMPL_SCALAR;
+static diram_sha256_impl_t g_sha256_batch_impl = DIRAM_SHA256_IMPL_SCALAR;
+static sha256_compress_fn g_sha256_compress = sha256_compress_scalar;
+
+static int cpu_has_impl(diram_sha256_impl_t impl) {
+    switch (impl) {
+        case DIRAM_SHA256_IMPL_SCALAR:
+            return 1;
+#ifdef DIRAM_SHA256_X86
+        case DIRAM_SHA256_IMPL_SHANI: {
+            unsigned int a, b, c, d;
+            if (!__get_cpuid(1, &a, &b, &c, &d)) return 0;
+            if (!(c & bit_SSSE3) || !(c & bit_SSE4_1)) return 0;
+            if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return 0;
+            return (b & (1u << 29)) != 0;
+        }
+        case DIRAM_SHA256_IMPL_AVX2: {
+            unsigned int a, b, c, d;
+            if (!__get_cpuid(1, &a, &b, &c, &d)) return 0;
+            if (!(c & bit_OSXSAVE)) return 0;
+            // OS must save YMM state
+            unsigned int xcr0_lo, xcr0_hi;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            (void)xcr0_hi;
+            if ((xcr0_lo & 0x6) != 0x6) return 0;
+            if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return 0;
+            return (b & bit_AVX2) != 0;
+        }
+#endif
+#ifdef DIRAM_SHA256_ARM
+        case DIRAM_SHA256_IMPL_ARMV8:
+#if defined(__linux__)
+            return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#elif defined(__APPLE__)
+            return 1;
+#else
+            return 0;
+#endif
+#endif
+        default:
+            return 0;
+    }
+}
+
+static void sha256_dispatch(void) {
+    // Benign race: every thread computes the same answer
+    if (__atomic_load_n(&g_sha256_dispatched, __ATOMIC_ACQUIRE)) return;
+
+    diram_sha256_impl_t impl = DIRAM_SHA256_IMPL_SCALAR;
+    diram_sha256_impl_t batch = DIRAM_SHA256_IMPL_SCALAR;
+    sha256_compress_fn fn = sha256_compress_scalar;
+
+#ifdef DIRAM_SHA256_X86
+    if (cpu_has_impl(DIRAM_SHA256_IMPL_SHANI)) {
+        impl = DIRAM_SHA256_IMPL_SHANI;
+        fn = sha256_compress_shani;
+    }
+    batch = impl;
+    // Eight AVX2 lanes only beat one-at-a-time when there are no SHA instructions
+    if (impl == DIRAM_SHA256_IMPL_SCALAR && cpu_has_impl(DIRAM_SHA256_IMPL_AVX2)) {
+        batch = DIRAM_SHA256_IMPL_AVX2;
+    }
+#endif
+#ifdef DIRAM_SHA256_ARM
+    if (cpu_has_impl(DIRAM_SHA256_IMPL_ARMV8)) {
+        impl = DIRAM_SHA256_IMPL_ARMV8;
+        fn = sha256_compress_armv8;
+    }
+    batch = impl;
+#endif
+
+    g_sha256_impl = impl;
+    g_sha256_batch_impl = batch;
+    g_sha256_compress = fn;
+    __atomic_store_n(&g_sha256_dispatched, 1, __ATOMIC_RELEASE);
+}
+
+int diram_sha256_force_impl(diram_sha256_impl_t impl) {
+    sha256_dispatch();
+    if (!cpu_has_impl(impl)) return -1;
+
+    switch (impl) {
+        case DIRAM_SHA256_IMPL_SCALAR:
+            g_sha256_impl = g_sha256_batch_impl = impl;
+            g_sha256_compress = sha256_compress_scalar;
+            break;
+#ifdef DIRAM_SHA256_X86
+        case DIRAM_SHA256_IMPL_SHANI:
+            g_sha256_impl = g_sha256_batch_impl = impl;
+            g_sha256_compress = sha256_compress_shani;
+            break;
+        case DIRAM_SHA256_IMPL_AVX2:
+            // Multi-buffer only; single messages fall back to scalar
+            g_sha256_impl = DIRAM_SHA256_IMPL_SCALAR;
+            g_sha256_batch_impl = impl;
+            g_sha256_compress = sha256_compress_scalar;
+            break;
+#endif
+#ifdef DIRAM_SHA256_ARM
+        case DIRAM_SHA256_IMPL_ARMV8:
+            g_sha256_impl = g_sha256_batch_impl = impl;
+            g_sha256_compress = sha256_compress_armv8;
+            break;
+#endif
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+diram_sha256_impl_t diram_sha256_get_impl(void) {
+    sha256_dispatch();
+    return g_sha256_impl;
+}
+
+diram_sha256_impl_t diram_sha256_get_batch_impl(void) {
+    sha256_dispatch();
+    return g_sha256_batch_impl;
+}
+
+const char* diram_sha256_impl_name(diram_sha256_impl_t impl) {
+    switch (impl) {
+        case DIRAM_SHA256_IMPL_SCALAR: return "scalar";
+        case DIRAM_SHA256_IMPL_SHANI:  return "sha-ni";
+        case DIRAM_SHA256_IMPL_ARMV8:  return "armv8-crypto";
+        case DIRAM_SHA256_IMPL_AVX2:   return "avx2-x8";
+        default:                       return "unknown";
+    }
+}
+
+void diram_sha256(const void* data, size_t len, uint8_t digest[DIRAM_SHA256_DIGEST_LEN]) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t state[8];
+    uint8_t tail[128];
+
+    sha256_dispatch();
+    memcpy(state, IV256, sizeof(state));
+
+    if (len >= 64) {
+        g_sha256_compress(state, bytes, len / 64);
+    }
+    g_sha256_compress(state, tail, sha256_pad_tail(bytes + (len & ~(size_t)63), len, tail));
+
+    for (int i = 0; i < 8; i++) {
+        store_be32(digest + 4 * i, state[i]);
+    }
+}
+
+void diram_sha256_init(diram_sha256_ctx_t* ctx) {
+    sha256_dispatch();
+    memcpy(ctx->state, IV256, sizeof(ctx->state));
+    ctx->total_len = 0;
+    ctx->buf_len = 0;
+}
+
+void diram_sha256_update(diram_sha256_ctx_t* ctx, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    ctx->total_len += len;
+
+    if (ctx->buf_len > 0) {
+        size_t take = 64 - ctx->buf_len;
+        if (take > len) take = len;
+        memcpy(ctx->buf + ctx->buf_len, bytes, take);
+        ctx->buf_len += take;
+        bytes += take;
+        len -= take;
+        if (ctx->buf_len < 64) return;
+        g_sha256_compress(ctx->state, ctx->buf, 1);
+        ctx->buf_len = 0;
+    }
+    if (len >= 64) {
+        g_sha256_compress(ctx->state, bytes, len / 64);
+        bytes += len & ~(size_t)63;
+        len &= 63;
+    }
+    memcpy(ctx->buf, bytes, len);
+    ctx->buf_len = len;
+}
+
+void diram_sha256_final(diram_sha256_ctx_t* ctx, uint8_t digest[DIRAM_SHA256_DIGEST_LEN]) {
+    uint8_t tail[128];
+
+    g_sha256_compress(ctx->state, tail, sha256_pad_tail(ctx->buf, ctx->total_len, tail));
+    for (int i = 0; i < 8; i++) {
+        store_be32(digest + 4 * i, ctx->state[i]);
+    }
+}
+
+void diram_sha256_x8(const void* const data[DIRAM_SHA256_LANES], size_t len,
+                     uint8_t digests[DIRAM_SHA256_LANES][DIRAM_SHA256_DIGEST_LEN]) {
+    sha256_dispatch();
+
+#ifdef DIRAM_SHA256_X86
+    if (g_sha256_batch_impl == DIRAM_SHA256_IMPL_AVX2) {
+        sha256_x8_avx2((const uint8_t* const*)data, len, digests);
+        return;
+    }
+#endif
+    for (int l = 0; l < DIRAM_SHA256_LANES; l++) {
+        diram_sha256(data[l], len, digests[l]);
+    }
+}
@@ -0,0 +1,327 @@
+// src/core/feature-alloc/slab.c
+// Size-class slab backend with per-thread magazines
+// OBINexus Project - Directed Instruction RAM
+//
+// Every block carries a 16-byte header recording its size class, so a block
+// can be freed from any thread. The fast path never takes a lock: allocation
+// pops the thread's magazine free list or bumps the thread's current chunk,
+// and free pushes onto the thread's magazine. Only magazine refill/overflow
+// touches the per-class depot mutex.
+
+#include "diram/core/feature-alloc/slab.h"
+#include "diram/core/feature-alloc/page_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define DIRAM_SLAB_MAGIC 0xD1A5AB00u
+
+typedef struct diram_slab_block {
+    uint32_t magic;
+    uint8_t size_class;
+    uint8_t pages[3];                   // Page-backed blocks: body pages, 24-bit LE
+    union {
+        struct diram_slab_block* next;  // Free list link (free blocks only)
+        size_t large_size;              // Payload size (page-backed blocks only)
+    } u;
+} diram_slab_block_t;
+
+#define DIRAM_SLAB_MAX_BODY_PAGES 0xFFFFFFu
+
+_Static_assert(sizeof(diram_slab_block_t) == DIRAM_SLAB_ALIGN,
+               "slab block header must preserve payload alignment");
+
+// Per-thread magazine: free lists plus a bump region for each size class
+typedef struct {
+    diram_slab_block_t* free_head[DIRAM_SLAB_CLASS_COUNT];
+    uint32_t free_count[DIRAM_SLAB_CLASS_COUNT];
+    char* bump_ptr[DIRAM_SLAB_CLASS_COUNT];
+    char* bump_end[DIRAM_SLAB_CLASS_COUNT];
+    uint64_t hits;
+    int registered;
+} diram_slab_magazine_t;
+
+// Shared depot of free blocks per size class
+typedef struct {
+    pthread_mutex_t lock;
+    diram_slab_block_t* head;
+    size_t count;
+} diram_slab_depot_t;
+
+static const uint32_t g_class_sizes[DIRAM_SLAB_CLASS_COUNT] = {
+    64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048,
+    3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768, 49152, 65536
+};
+
+static diram_slab_depot_t g_depot[DIRAM_SLAB_CLASS_COUNT];
+static pthread_once_t g_slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_slab_key;
+static __thread diram_slab_magazine_t t_magazine;
+
+static struct {
+    atomic_uint_fast64_t chunks_mapped;
+    atomic_uint_fast64_t bytes_mapped;
+    atomic_uint_fast64_t bump_allocs;
+    atomic_uint_fast64_t magazine_hits;
+    atomic_uint_fast64_t depot_refills;
+    atomic_uint_fast64_t depot_flushes;
+    atomic_uint_fast64_t large_allocs;
+    atomic_uint_fast64_t guarded_allocs;
+} g_slab_stats;
+
+static void slab_thread_exit(void* arg) {
+    (void)arg;
+    diram_slab_thread_flush();
+}
+
+static void slab_global_init(void) {
+    for (int i = 0; i < DIRAM_SLAB_CLASS_COUNT; i++) {
+        pthread_mutex_init(&g_depot[i].lock, NULL);
+        g_depot[i].head = NULL;
+        g_depot[i].count = 0;
+    }
+    pthread_key_create(&g_slab_key, slab_thread_exit);
+}
+
+static diram_slab_magazine_t* slab_magazine(void) {
+    diram_slab_magazine_t* mag = &t_magazine;
+    if (!mag->registered) {
+        pthread_once(&g_slab_once, slab_global_init);
+        // Any non-NULL value arms the destructor for this thread
+        pthread_setspecific(g_slab_key, mag);
+        mag->registered = 1;
+    }
+    return mag;
+}
+
+int diram_slab_class_for(size_t size) {
+    if (size <= DIRAM_SLAB_MIN_CLASS) return 0;
+    if (size > DIRAM_SLAB_MAX_CLASS) return -1;
+
+    // Two classes per power of two: (2^p, 1.5 * 2^p] and (1.5 * 2^p, 2^(p+1)]
+    int p = 63 - __builtin_clzll((unsigned long long)(size - 1));
+    size_t half_step = (size_t)3 << (p - 1);
+    return 2 * (p - 6) + (size <= half_step ? 1 : 2);
+}
+
+size_t diram_slab_class_size(int size_class) {
+    if (size_class < 0 || size_class >= DIRAM_SLAB_CLASS_COUNT) return 0;
+    return g_class_sizes[size_class];
+}
+
+// Move up to `want` blocks from the depot into the magazine
+static int slab_refill_from_depot(diram_slab_magazine_t* mag, int cls, uint32_t want) {
+    diram_slab_depot_t* depot = &g_depot[cls];
+    uint32_t moved = 0;
+
+    pthread_mutex_lock(&depot->lock);
+    while (depot->head && moved < want) {
+        diram_slab_block_t* block = depot->head;
+        depot->head = block->u.next;
+        block->u.next = mag->free_head[cls];
+        mag->free_head[cls] = block;
+        moved++;
+    }
+    depot->count -= moved;
+    pthread_mutex_unlock(&depot->lock);
+
+    mag->free_count[cls] += moved;
+    if (moved) {
+        atomic_fetch_add_explicit(&g_slab_stats.depot_refills, 1, memory_order_relaxed);
+    }
+    return moved ? 0 : -1;
+}
+
+// Return `count` blocks from the magazine to the depot in one critical section
+static void slab_flush_to_depot(diram_slab_magazine_t* mag, int cls, uint32_t count) {
+    diram_slab_block_t* first = mag->free_head[cls];
+    diram_slab_block_t* last = first;
+    uint32_t n = 1;
+
+    if (!first || count == 0) return;
+    while (n < count && last->u.next) {
+        last = last->u.next;
+        n++;
+    }
+    mag->free_head[cls] = last->u.next;
+    mag->free_count[cls] -= n;
+
+    diram_slab_depot_t* depot = &g_depot[cls];
+    pthread_mutex_lock(&depot->lock);
+    last->u.next = depot->head;
+    depot->head = first;
+    depot->count += n;
+    pthread_mutex_unlock(&depot->lock);
+
+    atomic_fetch_add_explicit(&g_slab_stats.depot_flushes, 1, memory_order_relaxed);
+}
+
+static int slab_map_chunk(diram_slab_magazine_t* mag, int cls) {
+    size_t block_size = g_class_sizes[cls];
+    size_t chunk_size = DIRAM_SLAB_CHUNK_SIZE;
+    if (chunk_size < block_size * 8) {
+        chunk_size = block_size * 8;
+    }
+
+    // Chunks are retained for the life of the process; blocks recycle through
+    // the magazines and depot instead of returning to the system allocator.
+    char* chunk = aligned_alloc(DIRAM_SLAB_ALIGN, chunk_size);
+    if (!chunk) return -1;
+
+    mag->bump_ptr[cls] = chunk;
+    mag->bump_end[cls] = chunk + chunk_size;
+
+    atomic_fetch_add_explicit(&g_slab_stats.chunks_mapped, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_slab_stats.bytes_mapped, chunk_size, memory_order_relaxed);
+    return 0;
+}
+
+// Page-backed block, right-aligned in its body: [... | header | payload]
+static void* slab_alloc_pages(size_t size, int guarded) {
+    size_t payload = DIRAM_SLAB_ALIGN_UP(size);
+    if (payload < size || payload > SIZE_MAX - sizeof(diram_slab_block_t)) return NULL;
+
+    size_t pages = diram_page_cache_round(payload + sizeof(diram_slab_block_t), guarded);
+    if (pages == 0 || pages > DIRAM_SLAB_MAX_BODY_PAGES) return NULL;
+
+    char* body = diram_page_cache_get(pages, guarded);
+    if (!body) return NULL;
+
+    char* end = body + pages * diram_page_size();
+    diram_slab_block_t* block = (diram_slab_block_t*)(end - payload) - 1;
+    block->magic = DIRAM_SLAB_MAGIC;
+    block->size_class = guarded ? DIRAM_SLAB_GUARD_CLASS : DIRAM_SLAB_LARGE_CLASS;
+    block->pages[0] = (uint8_t)pages;
+    block->pages[1] = (uint8_t)(pages >> 8);
+    block->pages[2] = (uint8_t)(pages >> 16);
+    block->u.large_size = size;
+    return block + 1;
+}
+
+static void slab_free_pages(diram_slab_block_t* block) {
+    size_t pages = (size_t)block->pages[0] | ((size_t)block->pages[1] << 8) |
+                   ((size_t)block->pages[2] << 16);
+    int guarded = block->size_class == DIRAM_SLAB_GUARD_CLASS;
+    char* end = (char*)(block + 1) + DIRAM_SLAB_ALIGN_UP(block->u.large_size);
+    block->magic = 0;
+    diram_page_cache_put(end - pages * diram_page_size(), pages, guarded);
+}
+
+static void* slab_alloc_large(size_t size) {
+    void* ptr = slab_alloc_pages(size, 0);
+    if (ptr) atomic_fetch_add_explicit(&g_slab_stats.large_allocs, 1, memory_order_relaxed);
+    return ptr;
+}
+
+void* diram_slab_alloc_guarded(size_t size) {
+    void* ptr = slab_alloc_pages(size, 1);
+    if (ptr) atomic_fetch_add_explicit(&g_slab_stats.guarded_allocs, 1, memory_order_relaxed);
+    return ptr;
+}
+
+void* diram_slab_alloc(size_t size) {
+    if (size > SIZE_MAX - sizeof(diram_slab_block_t)) return NULL;
+
+    int cls = diram_slab_class_for(size + sizeof(diram_slab_block_t));
+    if (cls < 0) {
+        return slab_alloc_large(size);
+    }
+
+    diram_slab_magazine_t* mag = slab_magazine();
+    diram_slab_block_t* block = mag->free_head[cls];
+
+    if (!block && slab_refill_from_depot(mag, cls, DIRAM_SLAB_MAGAZINE_SIZE) == 0) {
+        block = mag->free_head[cls];
+    }
+
+    if (block) {
+        mag->free_head[cls] = block->u.next;
+        mag->free_count[cls]--;
+        mag->hits++;
+    } else {
+        size_t block_size = g_class_sizes[cls];
+        if (mag->bump_ptr[cls] + block_size > mag->bump_end[cls] ||
+            mag->bump_ptr[cls] == NULL) {
+            if (slab_map_chunk(mag, cls) < 0) return NULL;
+        }
+        block = (diram_slab_block_t*)mag->bump_ptr[cls];
+        mag->bump_ptr[cls] += block_size;
+        atomic_fetch_add_explicit(&g_slab_stats.bump_allocs, 1, memory_order_relaxed);
+    }
+
+    block->magic = DIRAM_SLAB_MAGIC;
+    block->size_class = (uint8_t)cls;
+    block->u.next = NULL;
+    return block + 1;
+}
+
+void diram_slab_free(void* ptr) {
+    if (!ptr) return;
+
+    diram_slab_block_t* block = (diram_slab_block_t*)ptr - 1;
+    if (block->magic != DIRAM_SLAB_MAGIC) {
+        // Not ours - refuse rather than corrupt a free list
+        return;
+    }
+
+    if (block->size_class == DIRAM_SLAB_LARGE_CLASS ||
+        block->size_class == DIRAM_SLAB_GUARD_CLASS) {
+        slab_free_pages(block);
+        return;
+    }
+
+    int cls = block->size_class;
+    diram_slab_magazine_t* mag = slab_magazine();
+
+    block->magic = 0;
+    block->u.next = mag->free_head[cls];
+    mag->free_head[cls] = block;
+    mag->free_count[cls]++;
+
+    if (mag->free_count[cls] >= 2 * DIRAM_SLAB_MAGAZINE_SIZE) {
+        slab_flush_to_depot(mag, cls, DIRAM_SLAB_MAGAZINE_SIZE);
+    }
+}
+
+size_t diram_slab_usable_size(const void* ptr) {
+    if (!ptr) return 0;
+
+    const diram_slab_block_t* block = (const diram_slab_block_t*)ptr - 1;
+    if (block->magic != DIRAM_SLAB_MAGIC) return 0;
+    if (block->size_class == DIRAM_SLAB_LARGE_CLASS ||
+        block->size_class == DIRAM_SLAB_GUARD_CLASS) {
+        return block->u.large_size;
+    }
+    return g_class_sizes[block->size_class] - sizeof(diram_slab_block_t);
+}
+
+void diram_slab_thread_flush(void) {
+    diram_slab_magazine_t* mag = &t_magazine;
+    if (!mag->registered) return;
+
+    for (int cls = 0; cls < DIRAM_SLAB_CLASS_COUNT; cls++) {
+        if (mag->free_count[cls]) {
+            slab_flush_to_depot(mag, cls, mag->free_count[cls]);
+        }
+    }
+
+    // Unused bump space stays with the chunk; it is small relative to the
+    // chunk and not worth a cross-thread handoff structure.
+    atomic_fetch_add_explicit(&g_slab_stats.magazine_hits, mag->hits, memory_order_relaxed);
+    mag->hits = 0;
+}
+
+void diram_slab_get_stats(diram_slab_stats_t* out) {
+    if (!out) return;
+
+    out->chunks_mapped = atomic_load_explicit(&g_slab_stats.chunks_mapped, memory_order_relaxed);
+    out->bytes_mapped = atomic_load_explicit(&g_slab_stats.bytes_mapped, memory_order_relaxed);
+    out->bump_allocs = atomic_load_explicit(&g_slab_stats.bump_allocs, memory_order_relaxed);
+    out->magazine_hits = atomic_load_explicit(&g_slab_stats.magazine_hits, memory_order_relaxed)
+                         + t_magazine.hits;
+    out->depot_refills = atomic_load_explicit(&g_slab_stats.depot_refills, memory_order_relaxed);
+    out->depot_flushes = atomic_load_explicit(&g_slab_stats.depot_flushes, memory_order_relaxed);
+    out->large_allocs = atomic_load_explicit(&g_slab_stats.large_allocs, memory_order_relaxed);
+    out->guarded_allocs = atomic_load_explicit(&g_slab_stats.guarded_allocs, memory_order_relaxed);
+}
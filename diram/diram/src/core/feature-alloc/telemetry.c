@@ -0,0 +1,572 @@
+// src/core/feature-alloc/telemetry.c
+// Per-thread telemetry rings exported in batches by a background thread
+// OBINexus Project - Directed Instruction RAM
+//
+// Same shape as the trace ring, with one difference: telemetry is lossy.
+// A producer that finds its ring full counts a drop and returns, and
+// sampling happens before a slot is touched, so the cost on the allocation
+// path is bounded whatever the allocation rate or endpoint health.
+//
+// Endpoints:
+//   udp://host:port     UDP datagrams
+//   unix:///path, /path Unix datagram socket (a missing listener is a send error)
+//   stderr              Text lines, the old synchronous format
+
+#include "diram/core/feature-alloc/telemetry.h"
+#include "diram/core/feature-alloc/feature_alloc.h"
+#include "diram/core/config/config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <endian.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define DIRAM_TELEMETRY_RING_MASK (DIRAM_TELEMETRY_RING_SLOTS - 1)
+#define DIRAM_TELEMETRY_SAMPLE_ALWAYS (1ULL << 32)
+
+_Static_assert((DIRAM_TELEMETRY_RING_SLOTS & DIRAM_TELEMETRY_RING_MASK) == 0,
+               "telemetry ring size must be a power of two");
+_Static_assert(sizeof(diram_telemetry_wire_t) == 128,
+               "telemetry record layout is part of the wire format");
+
+typedef enum {
+    TELEMETRY_SINK_STDERR,
+    TELEMETRY_SINK_SOCKET
+} telemetry_sink_t;
+
+typedef struct diram_telemetry_ring {
+    _Alignas(64) atomic_size_t head;   // Written by the owning thread
+    uint64_t rng;                      // Sampling state, owner only
+    uint32_t sequence;
+    // Owner-written counters, summed by get_stats without stopping anyone
+    atomic_uint_fast64_t emitted;
+    atomic_uint_fast64_t sampled_out;
+    atomic_uint_fast64_t dropped;
+    _Alignas(64) atomic_size_t tail;   // Written by the exporter
+    atomic_int orphaned;
+    struct diram_telemetry_ring* next;
+    diram_telemetry_wire_t slots[DIRAM_TELEMETRY_RING_SLOTS];
+} diram_telemetry_ring_t;
+
+static struct {
+    pthread_mutex_t lock;              // Guards rings list and exporter state
+    pthread_cond_t wake;
+    pthread_cond_t flushed;
+    diram_telemetry_ring_t* rings;
+    pthread_t exporter;
+    atomic_int active;
+    int stopping;
+    int restart_in_child;
+    telemetry_sink_t sink;
+    int fd;
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    pid_t pid;
+    uint64_t flush_requested;
+    uint64_t flush_completed;
+    atomic_uint_fast64_t head_threshold;
+    atomic_uint_fast64_t tail_threshold;
+    // Counters of reaped rings, and the exporter's own
+    atomic_uint_fast64_t retired_emitted;
+    atomic_uint_fast64_t retired_sampled_out;
+    atomic_uint_fast64_t retired_dropped;
+    atomic_uint_fast64_t exported;
+    atomic_uint_fast64_t datagrams;
+    atomic_uint_fast64_t send_errors;
+    atomic_uint_fast64_t rings_active;
+} g_tel = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .flushed = PTHREAD_COND_INITIALIZER,
+    .fd = -1,
+    .head_threshold = DIRAM_TELEMETRY_SAMPLE_ALWAYS,
+    .tail_threshold = DIRAM_TELEMETRY_SAMPLE_ALWAYS
+};
+
+static pthread_once_t g_tel_key_once = PTHREAD_ONCE_INIT;
+static pthread_once_t g_tel_atfork_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_tel_key;
+static __thread diram_telemetry_ring_t* t_tel_ring = NULL;
+
+static void telemetry_thread_exit(void* arg) {
+    diram_telemetry_ring_t* ring = (diram_telemetry_ring_t*)arg;
+    atomic_store_explicit(&ring->orphaned, 1, memory_order_release);
+    t_tel_ring = NULL;
+}
+
+static void telemetry_key_init(void) {
+    pthread_key_create(&g_tel_key, telemetry_thread_exit);
+}
+
+static diram_telemetry_ring_t* telemetry_ring_register(void) {
+    pthread_once(&g_tel_key_once, telemetry_key_init);
+
+    diram_telemetry_ring_t* ring = aligned_alloc(64, sizeof(diram_telemetry_ring_t));
+    if (!ring) return NULL;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->orphaned, 0);
+    atomic_init(&ring->emitted, 0);
+    atomic_init(&ring->sampled_out, 0);
+    atomic_init(&ring->dropped, 0);
+    ring->sequence = 0;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ring->rng = ((uint64_t)(uintptr_t)ring ^ (uint64_t)ts.tv_nsec) | 1;
+
+    pthread_mutex_lock(&g_tel.lock);
+    ring->next = g_tel.rings;
+    g_tel.rings = ring;
+    pthread_mutex_unlock(&g_tel.lock);
+
+    atomic_fetch_add_explicit(&g_tel.rings_active, 1, memory_order_relaxed);
+    pthread_setspecific(g_tel_key, ring);
+    t_tel_ring = ring;
+    return ring;
+}
+
+// Single-writer counters: a plain load/store pair, no locked instruction
+static inline void ring_count(atomic_uint_fast64_t* counter) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+static inline uint32_t ring_random(diram_telemetry_ring_t* ring) {
+    // xorshift64*
+    uint64_t x = ring->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    ring->rng = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static uint64_t rate_to_threshold(double rate) {
+    if (!(rate > 0.0)) return 0;   // Also catches NaN
+    if (rate >= 1.0) return DIRAM_TELEMETRY_SAMPLE_ALWAYS;
+    return (uint64_t)(rate * (double)DIRAM_TELEMETRY_SAMPLE_ALWAYS);
+}
+
+void diram_telemetry_set_sampling(double head_rate, double tail_rate) {
+    atomic_store_explicit(&g_tel.head_threshold, rate_to_threshold(head_rate),
+                          memory_order_relaxed);
+    atomic_store_explicit(&g_tel.tail_threshold, rate_to_threshold(tail_rate),
+                          memory_order_relaxed);
+}
+
+static int telemetry_restart_in_child(void);
+
+void diram_telemetry_emit(diram_telemetry_event_t* event) {
+    if (!event) return;
+    if (!atomic_load_explicit(&g_tel.active, memory_order_acquire)) {
+        if (!g_tel.restart_in_child || telemetry_restart_in_child() < 0) {
+            return;
+        }
+    }
+    if (event->layer > diram_feature_get_config()->telemetry_level) return;
+
+    diram_telemetry_ring_t* ring = t_tel_ring ? t_tel_ring : telemetry_ring_register();
+    if (!ring) return;
+    ring_count(&ring->emitted);
+
+    // Head sampling thins routine traffic; errors go through the tail rate
+    uint64_t threshold = atomic_load_explicit(
+        event->error_code != DIRAM_ERR_NONE ? &g_tel.tail_threshold : &g_tel.head_threshold,
+        memory_order_relaxed);
+    if (threshold != DIRAM_TELEMETRY_SAMPLE_ALWAYS && ring_random(ring) >= threshold) {
+        ring_count(&ring->sampled_out);
+        return;
+    }
+
+    uint32_t sequence = ring->sequence++;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire)
+        >= DIRAM_TELEMETRY_RING_SLOTS) {
+        ring_count(&ring->dropped);
+        return;
+    }
+
+    diram_telemetry_wire_t* wire = &ring->slots[head & DIRAM_TELEMETRY_RING_MASK];
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    wire->length = htole16((uint16_t)sizeof(*wire));
+    wire->version = DIRAM_TELEMETRY_WIRE_VERSION;
+    wire->layer = event->layer;
+    wire->error_code = htole32((uint32_t)event->error_code);
+    wire->event_id = htole64(event->event_id);
+    wire->timestamp_ns = htole64((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+    wire->address = htole64((uint64_t)(uintptr_t)event->address);
+    wire->size = htole64((uint64_t)event->size);
+    wire->pid = (int32_t)htole32((uint32_t)g_tel.pid);
+    wire->sequence = htole32(sequence);
+    size_t op_len = strnlen(event->operation, DIRAM_TELEMETRY_OP_LEN);
+    memcpy(wire->operation, event->operation, op_len);
+    memset(wire->operation + op_len, 0, DIRAM_TELEMETRY_OP_LEN - op_len);
+    size_t receipt_len = strnlen(event->receipt, DIRAM_TELEMETRY_RECEIPT_LEN);
+    memcpy(wire->receipt, event->receipt, receipt_len);
+    memset(wire->receipt + receipt_len, 0, DIRAM_TELEMETRY_RECEIPT_LEN - receipt_len);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    size_t used = head + 1 - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (used == DIRAM_TELEMETRY_RING_SLOTS / 2) {
+        pthread_cond_signal(&g_tel.wake);
+    }
+}
+
+static void telemetry_send(const char* buf, size_t len, uint64_t records) {
+    if (len == 0) return;
+
+    ssize_t n;
+    if (g_tel.sink == TELEMETRY_SINK_STDERR) {
+        n = write(g_tel.fd, buf, len);
+    } else {
+        // Never block the exporter on a slow collector; drop the batch instead
+        do {
+            n = sendto(g_tel.fd, buf, len, MSG_DONTWAIT | MSG_NOSIGNAL,
+                       (const struct sockaddr*)&g_tel.addr, g_tel.addr_len);
+        } while (n < 0 && errno == EINTR);
+    }
+
+    if (n < 0 || (size_t)n != len) {
+        atomic_fetch_add_explicit(&g_tel.send_errors, records, memory_order_relaxed);
+        return;
+    }
+    atomic_fetch_add_explicit(&g_tel.exported, records, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_tel.datagrams, 1, memory_order_relaxed);
+}
+
+static size_t telemetry_format_text(const diram_telemetry_wire_t* wire, char* out, size_t out_len) {
+    int n = snprintf(out, out_len, "[TELEMETRY] L%d|%.*s|%p|%llu|%.*s\n",
+                     wire->layer,
+                     (int)strnlen(wire->operation, DIRAM_TELEMETRY_OP_LEN), wire->operation,
+                     (void*)(uintptr_t)le64toh(wire->address),
+                     (unsigned long long)le64toh(wire->size),
+                     (int)strnlen(wire->receipt, DIRAM_TELEMETRY_RECEIPT_LEN), wire->receipt);
+    return n > 0 && (size_t)n < out_len ? (size_t)n : 0;
+}
+
+// Pack records back to back into the staging buffer, one send per fill
+static void telemetry_drain(diram_telemetry_ring_t* rings, char* staging) {
+    size_t used = 0;
+    uint64_t records = 0;
+    size_t reserve = g_tel.sink == TELEMETRY_SINK_STDERR ? 256 : sizeof(diram_telemetry_wire_t);
+
+    for (diram_telemetry_ring_t* ring = rings; ring; ring = ring->next) {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            if (DIRAM_TELEMETRY_DATAGRAM_MAX - used < reserve) {
+                telemetry_send(staging, used, records);
+                used = 0;
+                records = 0;
+            }
+            const diram_telemetry_wire_t* wire = &ring->slots[tail & DIRAM_TELEMETRY_RING_MASK];
+            if (g_tel.sink == TELEMETRY_SINK_STDERR) {
+                used += telemetry_format_text(wire, staging + used,
+                                              DIRAM_TELEMETRY_DATAGRAM_MAX - used);
+            } else {
+                memcpy(staging + used, wire, sizeof(*wire));
+                used += sizeof(*wire);
+            }
+            records++;
+        }
+        // Slots are copied out, so the producer may reuse them right away
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    telemetry_send(staging, used, records);
+}
+
+static void telemetry_reap_orphans(void) {
+    pthread_mutex_lock(&g_tel.lock);
+    diram_telemetry_ring_t** link = &g_tel.rings;
+    while (*link) {
+        diram_telemetry_ring_t* ring = *link;
+        if (atomic_load_explicit(&ring->orphaned, memory_order_acquire) &&
+            atomic_load_explicit(&ring->tail, memory_order_relaxed) ==
+            atomic_load_explicit(&ring->head, memory_order_acquire)) {
+            *link = ring->next;
+            atomic_fetch_add_explicit(&g_tel.retired_emitted,
+                                      atomic_load(&ring->emitted), memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_tel.retired_sampled_out,
+                                      atomic_load(&ring->sampled_out), memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_tel.retired_dropped,
+                                      atomic_load(&ring->dropped), memory_order_relaxed);
+            free(ring);
+            atomic_fetch_sub_explicit(&g_tel.rings_active, 1, memory_order_relaxed);
+        } else {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+}
+
+static void telemetry_drain_all(char* staging) {
+    // Rings are only unlinked by this thread, so the snapshot stays valid
+    pthread_mutex_lock(&g_tel.lock);
+    diram_telemetry_ring_t* rings = g_tel.rings;
+    pthread_mutex_unlock(&g_tel.lock);
+
+    telemetry_drain(rings, staging);
+    telemetry_reap_orphans();
+}
+
+static void* telemetry_exporter_main(void* arg) {
+    char* staging = (char*)arg;
+
+    pthread_mutex_lock(&g_tel.lock);
+    while (!g_tel.stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += DIRAM_TELEMETRY_EXPORT_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        if (g_tel.flush_requested == g_tel.flush_completed) {
+            pthread_cond_timedwait(&g_tel.wake, &g_tel.lock, &deadline);
+        }
+
+        uint64_t requested = g_tel.flush_requested;
+        pthread_mutex_unlock(&g_tel.lock);
+
+        telemetry_drain_all(staging);
+
+        pthread_mutex_lock(&g_tel.lock);
+        if (requested != g_tel.flush_completed) {
+            g_tel.flush_completed = requested;
+            pthread_cond_broadcast(&g_tel.flushed);
+        }
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+
+    telemetry_drain_all(staging);
+    free(staging);
+    return NULL;
+}
+
+// As with the trace writer: the child keeps the socket, discards what the
+// parent buffered and starts its own exporter on the next emit
+static void telemetry_atfork_prepare(void) {
+    pthread_mutex_lock(&g_tel.lock);
+}
+
+static void telemetry_atfork_parent(void) {
+    pthread_mutex_unlock(&g_tel.lock);
+}
+
+static void telemetry_atfork_child(void) {
+    pthread_mutex_init(&g_tel.lock, NULL);
+    pthread_cond_init(&g_tel.wake, NULL);
+    pthread_cond_init(&g_tel.flushed, NULL);
+    g_tel.pid = getpid();
+
+    for (diram_telemetry_ring_t* ring = g_tel.rings; ring; ring = ring->next) {
+        atomic_store(&ring->tail, atomic_load(&ring->head));
+        if (ring != t_tel_ring) {
+            atomic_store(&ring->orphaned, 1);
+        }
+    }
+
+    if (atomic_load(&g_tel.active)) {
+        atomic_store(&g_tel.active, 0);
+        g_tel.restart_in_child = 1;
+    }
+}
+
+static void telemetry_atfork_init(void) {
+    pthread_atfork(telemetry_atfork_prepare, telemetry_atfork_parent, telemetry_atfork_child);
+}
+
+static int telemetry_spawn_exporter(void) {
+    char* staging = malloc(DIRAM_TELEMETRY_DATAGRAM_MAX);
+    if (!staging) return -1;
+
+    g_tel.stopping = 0;
+    g_tel.flush_requested = 0;
+    g_tel.flush_completed = 0;
+
+    if (pthread_create(&g_tel.exporter, NULL, telemetry_exporter_main, staging) != 0) {
+        free(staging);
+        return -1;
+    }
+    atomic_store_explicit(&g_tel.active, 1, memory_order_release);
+    return 0;
+}
+
+static int telemetry_restart_in_child(void) {
+    int result = 0;
+    pthread_mutex_lock(&g_tel.lock);
+    if (g_tel.restart_in_child) {
+        g_tel.restart_in_child = 0;
+        result = telemetry_spawn_exporter();
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+    return result;
+}
+
+// Resolve an endpoint into g_tel.sink/fd/addr
+static int telemetry_open_endpoint(const char* endpoint) {
+    if (strcmp(endpoint, "stderr") == 0) {
+        g_tel.sink = TELEMETRY_SINK_STDERR;
+        g_tel.fd = STDERR_FILENO;
+        return 0;
+    }
+
+    g_tel.sink = TELEMETRY_SINK_SOCKET;
+    memset(&g_tel.addr, 0, sizeof(g_tel.addr));
+
+    if (strncmp(endpoint, "udp://", 6) == 0) {
+        char host[256];
+        const char* hostport = endpoint + 6;
+        const char* colon = strrchr(hostport, ':');
+        if (!colon || colon == hostport || (size_t)(colon - hostport) >= sizeof(host)) {
+            return -1;
+        }
+        // Allow [v6]:port
+        const char* start = hostport;
+        size_t host_len = (size_t)(colon - hostport);
+        if (*start == '[' && host_len >= 2 && start[host_len - 1] == ']') {
+            start++;
+            host_len -= 2;
+        }
+        memcpy(host, start, host_len);
+        host[host_len] = '\0';
+
+        struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+        struct addrinfo* res = NULL;
+        if (getaddrinfo(host, colon + 1, &hints, &res) != 0 || !res) return -1;
+
+        int fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0) {
+            memcpy(&g_tel.addr, res->ai_addr, res->ai_addrlen);
+            g_tel.addr_len = res->ai_addrlen;
+        }
+        freeaddrinfo(res);
+        g_tel.fd = fd;
+        return fd >= 0 ? 0 : -1;
+    }
+
+    const char* path = strncmp(endpoint, "unix://", 7) == 0 ? endpoint + 7 : endpoint;
+    struct sockaddr_un* un = (struct sockaddr_un*)&g_tel.addr;
+    if (path[0] != '/' || strlen(path) >= sizeof(un->sun_path)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    un->sun_family = AF_UNIX;
+    strcpy(un->sun_path, path);
+    g_tel.addr_len = (socklen_t)sizeof(*un);
+    g_tel.fd = fd;
+    return 0;
+}
+
+static void telemetry_close_endpoint(void) {
+    if (g_tel.sink == TELEMETRY_SINK_SOCKET && g_tel.fd >= 0) {
+        close(g_tel.fd);
+    }
+    g_tel.fd = -1;
+}
+
+int diram_telemetry_init(const char* endpoint) {
+    pthread_once(&g_tel_atfork_once, telemetry_atfork_init);
+
+    // No endpoint: the configured one, or the old stderr output
+    if (!endpoint || !endpoint[0]) {
+        const diram_config_t* config = diram_config_current();
+        endpoint = config->telemetry_endpoint[0] ? config->telemetry_endpoint : "stderr";
+    }
+
+    pthread_mutex_lock(&g_tel.lock);
+    if (atomic_load(&g_tel.active)) {
+        pthread_mutex_unlock(&g_tel.lock);
+        return 0;  // Already running
+    }
+
+    if (telemetry_open_endpoint(endpoint) < 0) {
+        g_tel.fd = -1;
+        pthread_mutex_unlock(&g_tel.lock);
+        DIRAM_ERROR(DIRAM_ERR_TELEMETRY_LOST, "Cannot open telemetry endpoint %s", endpoint);
+        return -1;
+    }
+    g_tel.pid = getpid();
+    g_tel.restart_in_child = 0;
+
+    if (telemetry_spawn_exporter() < 0) {
+        telemetry_close_endpoint();
+        pthread_mutex_unlock(&g_tel.lock);
+        return -1;
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+    return 0;
+}
+
+void diram_telemetry_shutdown(void) {
+    pthread_mutex_lock(&g_tel.lock);
+    if (!atomic_load(&g_tel.active)) {
+        if (g_tel.restart_in_child) {
+            g_tel.restart_in_child = 0;
+            telemetry_close_endpoint();
+        }
+        pthread_mutex_unlock(&g_tel.lock);
+        return;
+    }
+    atomic_store_explicit(&g_tel.active, 0, memory_order_release);
+    g_tel.stopping = 1;
+    pthread_cond_signal(&g_tel.wake);
+    pthread_mutex_unlock(&g_tel.lock);
+
+    pthread_join(g_tel.exporter, NULL);
+
+    pthread_mutex_lock(&g_tel.lock);
+    telemetry_close_endpoint();
+    pthread_cond_broadcast(&g_tel.flushed);
+    pthread_mutex_unlock(&g_tel.lock);
+}
+
+int diram_telemetry_flush(void) {
+    pthread_mutex_lock(&g_tel.lock);
+    if (!atomic_load(&g_tel.active)) {
+        pthread_mutex_unlock(&g_tel.lock);
+        return 0;  // Nothing buffered
+    }
+
+    uint64_t ticket = ++g_tel.flush_requested;
+    pthread_cond_signal(&g_tel.wake);
+    while (g_tel.flush_completed < ticket && atomic_load(&g_tel.active)) {
+        pthread_cond_wait(&g_tel.flushed, &g_tel.lock);
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+    return 0;
+}
+
+void diram_telemetry_get_stats(diram_telemetry_stats_t* out) {
+    if (!out) return;
+    out->emitted = atomic_load_explicit(&g_tel.retired_emitted, memory_order_relaxed);
+    out->sampled_out = atomic_load_explicit(&g_tel.retired_sampled_out, memory_order_relaxed);
+    out->dropped = atomic_load_explicit(&g_tel.retired_dropped, memory_order_relaxed);
+
+    pthread_mutex_lock(&g_tel.lock);
+    for (diram_telemetry_ring_t* ring = g_tel.rings; ring; ring = ring->next) {
+        out->emitted += atomic_load_explicit(&ring->emitted, memory_order_relaxed);
+        out->sampled_out += atomic_load_explicit(&ring->sampled_out, memory_order_relaxed);
+        out->dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_tel.lock);
+
+    out->exported = atomic_load_explicit(&g_tel.exported, memory_order_relaxed);
+    out->datagrams = atomic_load_explicit(&g_tel.datagrams, memory_order_relaxed);
+    out->send_errors = atomic_load_explicit(&g_tel.send_errors, memory_order_relaxed);
+    out->rings_active = atomic_load_explicit(&g_tel.rings_active, memory_order_relaxed);
+}
@@ -0,0 +1,494 @@
+// core/feature-alloc/trace_replay.c
+// Replay a captured allocation trace through the traced allocator
+// OBINexus Project - Directed Instruction RAM
+
+#include "diram/core/feature-alloc/trace_replay.h"
+#include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/slab.h"
+#include "diram/core/feature-alloc/trace_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#define REPLAY_LINE_MAX 512
+#define REPLAY_TAG "replay"
+
+typedef struct {
+    uint64_t timestamp;
+    uint64_t address;
+    uint64_t size;
+    uint64_t count;
+    uint64_t order;     // Position in the file, breaks timestamp ties
+    uint8_t operation;
+} replay_record_t;
+
+typedef struct {
+    replay_record_t* items;
+    size_t count;
+    size_t capacity;
+} record_list_t;
+
+// Original address -> replayed allocation (linear probing, backward shift)
+typedef struct {
+    uint64_t* keys;     // 0 marks an empty slot
+    diram_allocation_t** values;
+    size_t capacity;
+    size_t count;
+} address_map_t;
+
+// Live batch whose members are freed one by one
+typedef struct {
+    uint64_t base;
+    uint64_t end;       // Upper bound of the original member addresses
+    diram_allocation_t** members;
+    size_t remaining;
+} replay_range_t;
+
+typedef struct {
+    diram_replay_stats_t* stats;
+    address_map_t map;
+    replay_range_t* ranges;
+    size_t range_count;
+    size_t range_capacity;
+    uint64_t live_payload;
+    uint64_t live_block;
+    uint64_t live_large;        // Block bytes served outside slab chunks
+    uint64_t start_mapped;
+} replay_state_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static long current_rss_kb(void) {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    long pages = 0, resident = 0;
+    if (statm) {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        fclose(statm);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Loading
+
+static int list_push(record_list_t* list, const replay_record_t* record) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 4096;
+        replay_record_t* items = realloc(list->items, capacity * sizeof(*items));
+        if (!items) return -1;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count] = *record;
+    list->items[list->count].order = list->count;
+    list->count++;
+    return 0;
+}
+
+static int accept_record(record_list_t* list, replay_record_t* record) {
+    if (record->operation != DIRAM_TRACE_OP_ALLOC && record->operation != DIRAM_TRACE_OP_FREE &&
+        record->operation != DIRAM_TRACE_OP_ALLOC_RANGE) {
+        return 0;
+    }
+    if (record->count == 0) record->count = 1;
+    return list_push(list, record);
+}
+
+static int load_binary(FILE* in, record_list_t* list) {
+    diram_trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        header.version != DIRAM_TRACE_BIN_VERSION ||
+        header.record_size != sizeof(diram_trace_record_t)) {
+        return -1;
+    }
+
+    diram_trace_record_t records[256];
+    size_t n;
+    while ((n = fread(records, sizeof(records[0]), 256, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            replay_record_t record = {
+                .timestamp = records[i].timestamp,
+                .address = records[i].address,
+                .size = records[i].size,
+                .count = records[i].count,
+                .operation = records[i].operation
+            };
+            if (accept_record(list, &record) < 0) return -1;
+        }
+    }
+    return 0;
+}
+
+// TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG[|COUNT]
+static int parse_text_line(char* line, replay_record_t* record) {
+    char* fields[8] = {0};
+    int count = 0;
+    char* cursor = line;
+    while (cursor && count < 8) {
+        fields[count++] = cursor;
+        char* bar = strchr(cursor, '|');
+        if (bar) *bar = '\0';
+        cursor = bar ? bar + 1 : NULL;
+    }
+    if (count < 5) return -1;
+
+    memset(record, 0, sizeof(*record));
+    record->timestamp = strtoull(fields[0], NULL, 10);
+    if (strcmp(fields[2], "ALLOC") == 0) {
+        record->operation = DIRAM_TRACE_OP_ALLOC;
+    } else if (strcmp(fields[2], "FREE") == 0) {
+        record->operation = DIRAM_TRACE_OP_FREE;
+    } else if (strcmp(fields[2], "ALLOC_RANGE") == 0) {
+        record->operation = DIRAM_TRACE_OP_ALLOC_RANGE;
+    }
+    // glibc prints a NULL %p as "(nil)", which parses as 0
+    record->address = strtoull(fields[3], NULL, 16);
+    record->size = strtoull(fields[4], NULL, 10);
+    record->count = count > 7 ? strtoull(fields[7], NULL, 10) : 1;
+    return 0;
+}
+
+static int load_text(FILE* in, record_list_t* list) {
+    char line[REPLAY_LINE_MAX];
+    while (fgets(line, sizeof(line), in)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') continue;
+
+        replay_record_t record;
+        if (parse_text_line(line, &record) < 0) return -1;
+        if (accept_record(list, &record) < 0) return -1;
+    }
+    return 0;
+}
+
+static int compare_records(const void* a, const void* b) {
+    const replay_record_t* x = a;
+    const replay_record_t* y = b;
+    if (x->timestamp != y->timestamp) return x->timestamp < y->timestamp ? -1 : 1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+static int load_trace(const char* path, record_list_t* list) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return -1;
+
+    char magic[8] = {0};
+    size_t got = fread(magic, 1, sizeof(magic), in);
+    rewind(in);
+    int result = (got == sizeof(magic) && memcmp(magic, DIRAM_TRACE_BIN_MAGIC, sizeof(magic)) == 0) ?
+                 load_binary(in, list) : load_text(in, list);
+    fclose(in);
+    if (result == 0 && list->count > 1) {
+        qsort(list->items, list->count, sizeof(replay_record_t), compare_records);
+    }
+    return result;
+}
+
+// Address map
+
+static uint64_t map_hash(uint64_t key) {
+    uint64_t hash = (key >> 4) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+
+static int map_grow(address_map_t* map) {
+    size_t capacity = map->capacity ? map->capacity * 2 : 1024;
+    uint64_t* keys = calloc(capacity, sizeof(uint64_t));
+    diram_allocation_t** values = calloc(capacity, sizeof(diram_allocation_t*));
+    if (!keys || !values) {
+        free(keys);
+        free(values);
+        return -1;
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->keys[i] == 0) continue;
+        size_t slot = map_hash(map->keys[i]) & (capacity - 1);
+        while (keys[slot] != 0) slot = (slot + 1) & (capacity - 1);
+        keys[slot] = map->keys[i];
+        values[slot] = map->values[i];
+    }
+    free(map->keys);
+    free(map->values);
+    map->keys = keys;
+    map->values = values;
+    map->capacity = capacity;
+    return 0;
+}
+
+static size_t map_slot(const address_map_t* map, uint64_t key) {
+    size_t mask = map->capacity - 1;
+    size_t slot = map_hash(key) & mask;
+    while (map->keys[slot] != 0 && map->keys[slot] != key) slot = (slot + 1) & mask;
+    return slot;
+}
+
+// Returns the allocation previously stored under key, if any
+static diram_allocation_t* map_put(address_map_t* map, uint64_t key, diram_allocation_t* value,
+                                  int* failed) {
+    if ((map->count + 1) * 4 > map->capacity * 3 && map_grow(map) < 0) {
+        *failed = 1;
+        return NULL;
+    }
+    size_t slot = map_slot(map, key);
+    diram_allocation_t* previous = map->keys[slot] ? map->values[slot] : NULL;
+    if (!map->keys[slot]) map->count++;
+    map->keys[slot] = key;
+    map->values[slot] = value;
+    return previous;
+}
+
+static diram_allocation_t* map_take(address_map_t* map, uint64_t key) {
+    if (map->capacity == 0 || key == 0) return NULL;
+    size_t mask = map->capacity - 1;
+    size_t hole = map_slot(map, key);
+    if (map->keys[hole] != key) return NULL;
+    diram_allocation_t* value = map->values[hole];
+
+    for (size_t next = (hole + 1) & mask; map->keys[next] != 0; next = (next + 1) & mask) {
+        size_t home = map_hash(map->keys[next]) & mask;
+        int stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            map->keys[hole] = map->keys[next];
+            map->values[hole] = map->values[next];
+            hole = next;
+        }
+    }
+    map->keys[hole] = 0;
+    map->values[hole] = NULL;
+    map->count--;
+    return value;
+}
+
+// Footprint accounting
+
+static void block_footprint(const diram_allocation_t* alloc, uint64_t* block, int* large) {
+    if (alloc->region) {
+        // Batch member: its span inside the shared region
+        *block = DIRAM_SLAB_ALIGN_UP(sizeof(diram_allocation_t)) + DIRAM_SLAB_ALIGN_UP(alloc->size);
+        *large = diram_slab_usable_size(alloc->region) > DIRAM_SLAB_MAX_CLASS;
+    } else {
+        *block = diram_slab_usable_size(alloc);
+        *large = *block > DIRAM_SLAB_MAX_CLASS;
+    }
+}
+
+static void account_alloc(replay_state_t* state, const diram_allocation_t* alloc) {
+    uint64_t block;
+    int large;
+    block_footprint(alloc, &block, &large);
+    state->live_payload += alloc->size;
+    state->live_block += block;
+    if (large) state->live_large += block;
+    state->stats->allocs++;
+    state->stats->bytes_allocated += alloc->size;
+
+    if (state->live_payload > state->stats->peak_live_bytes) {
+        diram_slab_stats_t slab;
+        diram_slab_get_stats(&slab);
+        state->stats->peak_live_bytes = state->live_payload;
+        state->stats->peak_block_bytes = state->live_block;
+        state->stats->peak_mapped_bytes = (slab.bytes_mapped - state->start_mapped) + state->live_large;
+    }
+}
+
+static void release(replay_state_t* state, diram_allocation_t* alloc) {
+    uint64_t block;
+    int large;
+    block_footprint(alloc, &block, &large);
+    state->live_payload -= alloc->size;
+    state->live_block -= block;
+    if (large) state->live_large -= block;
+    diram_free_traced(alloc);
+}
+
+// Operations
+
+static void replay_alloc(replay_state_t* state, const replay_record_t* record) {
+    // One command epoch per allocation, as the captured process had
+    diram_heap_epoch_begin();
+    diram_allocation_t* alloc = diram_alloc_traced(record->size, REPLAY_TAG);
+    if (!alloc) {
+        state->stats->failed_allocs++;
+        return;
+    }
+    account_alloc(state, alloc);
+    if (record->address == 0) {
+        // Nothing can free it by address; count the churn and move on
+        release(state, alloc);
+        return;
+    }
+
+    int failed = 0;
+    diram_allocation_t* previous = map_put(&state->map, record->address, alloc, &failed);
+    if (failed) {
+        state->stats->failed_allocs++;
+        release(state, alloc);
+    } else if (previous) {
+        // The trace lost the FREE of an address that was handed out again
+        release(state, previous);
+    }
+}
+
+static void replay_range(replay_state_t* state, const replay_record_t* record) {
+    size_t n = (size_t)record->count;
+    if (state->range_count == state->range_capacity) {
+        size_t capacity = state->range_capacity ? state->range_capacity * 2 : 16;
+        replay_range_t* ranges = realloc(state->ranges, capacity * sizeof(*ranges));
+        if (!ranges) {
+            state->stats->failed_allocs += n;
+            return;
+        }
+        state->ranges = ranges;
+        state->range_capacity = capacity;
+    }
+
+    size_t* sizes = malloc(n * sizeof(size_t));
+    diram_allocation_t** members = malloc(n * sizeof(diram_allocation_t*));
+    if (sizes) {
+        for (size_t i = 0; i < n; i++) sizes[i] = (size_t)(record->size / n);
+    }
+    diram_heap_epoch_begin();
+    if (!sizes || !members || diram_alloc_batch(n, sizes, REPLAY_TAG, members) < 0) {
+        free(sizes);
+        free(members);
+        state->stats->failed_allocs += n;
+        return;
+    }
+    free(sizes);
+    for (size_t i = 0; i < n; i++) account_alloc(state, members[i]);
+
+    // Original members were packed tracker-first after record->address
+    replay_range_t* range = &state->ranges[state->range_count++];
+    range->base = record->address;
+    range->end = record->address + record->size +
+                 n * (DIRAM_SLAB_ALIGN_UP(sizeof(diram_allocation_t)) + DIRAM_SLAB_ALIGN);
+    range->members = members;
+    range->remaining = n;
+}
+
+static void replay_free(replay_state_t* state, const replay_record_t* record) {
+    diram_allocation_t* alloc = map_take(&state->map, record->address);
+    if (alloc) {
+        release(state, alloc);
+        state->stats->frees++;
+        return;
+    }
+
+    for (size_t i = 0; i < state->range_count; i++) {
+        replay_range_t* range = &state->ranges[i];
+        if (record->address < range->base || record->address >= range->end) continue;
+
+        release(state, range->members[--range->remaining]);
+        state->stats->frees++;
+        if (range->remaining == 0) {
+            free(range->members);
+            state->ranges[i] = state->ranges[--state->range_count];
+        }
+        return;
+    }
+    state->stats->unmatched_frees++;
+}
+
+static void wait_until(uint64_t target_ns) {
+    if (now_ns() >= target_ns) return;
+    struct timespec ts = {
+        .tv_sec = (time_t)(target_ns / 1000000000ULL),
+        .tv_nsec = (long)(target_ns % 1000000000ULL)
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {}
+}
+
+int diram_trace_replay(const char* path, diram_replay_timing_t timing,
+                       diram_replay_stats_t* stats) {
+    if (!path || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+
+    record_list_t list = {0};
+    if (load_trace(path, &list) < 0) {
+        free(list.items);
+        return -1;
+    }
+    stats->records = list.count;
+    stats->start_rss_kb = current_rss_kb();
+
+    replay_state_t state = { .stats = stats };
+    diram_slab_stats_t slab;
+    diram_slab_get_stats(&slab);
+    state.start_mapped = slab.bytes_mapped;
+
+    uint64_t start = now_ns();
+    uint64_t first = list.count ? list.items[0].timestamp : 0;
+    for (size_t i = 0; i < list.count; i++) {
+        const replay_record_t* record = &list.items[i];
+        if (timing == DIRAM_REPLAY_ORIGINAL_TIMING) {
+            wait_until(start + (record->timestamp - first));
+        }
+        switch (record->operation) {
+            case DIRAM_TRACE_OP_ALLOC: replay_alloc(&state, record); break;
+            case DIRAM_TRACE_OP_ALLOC_RANGE: replay_range(&state, record); break;
+            case DIRAM_TRACE_OP_FREE: replay_free(&state, record); break;
+        }
+    }
+    stats->elapsed_ns = now_ns() - start;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    stats->peak_rss_kb = usage.ru_maxrss;
+
+    // Whatever the trace never freed
+    for (size_t i = 0; i < state.map.capacity; i++) {
+        if (state.map.keys[i] == 0) continue;
+        release(&state, state.map.values[i]);
+        stats->live_at_end++;
+    }
+    for (size_t i = 0; i < state.range_count; i++) {
+        while (state.ranges[i].remaining) {
+            release(&state, state.ranges[i].members[--state.ranges[i].remaining]);
+            stats->live_at_end++;
+        }
+        free(state.ranges[i].members);
+    }
+    free(state.ranges);
+    free(state.map.keys);
+    free(state.map.values);
+    free(list.items);
+
+    if (stats->elapsed_ns) {
+        stats->ops_per_sec = (double)(stats->allocs + stats->frees) * 1e9 / (double)stats->elapsed_ns;
+    }
+    if (stats->peak_block_bytes) {
+        stats->internal_fragmentation = 1.0 - (double)stats->peak_live_bytes / (double)stats->peak_block_bytes;
+    }
+    // Chunks mapped before the replay are reused but not counted, so clamp
+    if (stats->peak_mapped_bytes > stats->peak_block_bytes) {
+        stats->external_fragmentation = 1.0 - (double)stats->peak_block_bytes / (double)stats->peak_mapped_bytes;
+    }
+    return 0;
+}
+
+void diram_replay_print_stats(const diram_replay_stats_t* stats, FILE* out) {
+    if (!stats || !out) return;
+    fprintf(out, "Replay: %llu records, %llu allocs, %llu frees in %.3f ms\n",
+            (unsigned long long)stats->records, (unsigned long long)stats->allocs,
+            (unsigned long long)stats->frees, stats->elapsed_ns / 1e6);
+    fprintf(out, "  Throughput: %.0f ops/s (%.1f MB allocated)\n",
+            stats->ops_per_sec, stats->bytes_allocated / (1024.0 * 1024.0));
+    if (stats->failed_allocs || stats->unmatched_frees || stats->live_at_end) {
+        fprintf(out, "  Failed allocs: %llu, unmatched frees: %llu, live at end: %llu\n",
+                (unsigned long long)stats->failed_allocs,
+                (unsigned long long)stats->unmatched_frees,
+                (unsigned long long)stats->live_at_end);
+    }
+    fprintf(out, "  Peak live: %llu bytes in %llu bytes of blocks, %llu bytes mapped\n",
+            (unsigned long long)stats->peak_live_bytes,
+            (unsigned long long)stats->peak_block_bytes,
+            (unsigned long long)stats->peak_mapped_bytes);
+    fprintf(out, "  Fragmentation: %.1f%% internal, %.1f%% external\n",
+            stats->internal_fragmentation * 100.0, stats->external_fragmentation * 100.0);
+    fprintf(out, "  RSS: %ld KB at start, %ld KB peak\n", stats->start_rss_kb, stats->peak_rss_kb);
+}
@@ -0,0 +1,575 @@
+// src/core/feature-alloc/trace_ring.c
+// Per-thread lock-free trace rings drained by a background writer
+// OBINexus Project - Directed Instruction RAM
+//
+// Each allocating thread owns a single-producer/single-consumer ring of
+// fixed-size records. Producers never take a lock or make a syscall on the
+// fast path; the writer thread is the only consumer and batches everything
+// it finds into one write (text) or one writev straight out of the ring
+// slots (binary).
+
+#include "diram/core/feature-alloc/trace_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#define DIRAM_TRACE_RING_MASK (DIRAM_TRACE_RING_SLOTS - 1)
+#define DIRAM_TRACE_TEXT_BUFFER (64 * 1024)
+#define DIRAM_TRACE_MAX_IOV 64
+
+_Static_assert((DIRAM_TRACE_RING_SLOTS & DIRAM_TRACE_RING_MASK) == 0,
+               "trace ring size must be a power of two");
+_Static_assert(sizeof(diram_trace_record_t) == 128,
+               "trace record layout is part of the binary format");
+
+typedef struct diram_trace_ring {
+    _Alignas(64) atomic_size_t head;   // Written by the owning thread
+    _Alignas(64) atomic_size_t tail;   // Written by the writer thread
+    atomic_int orphaned;               // Owning thread has exited
+    struct diram_trace_ring* next;
+    diram_trace_record_t slots[DIRAM_TRACE_RING_SLOTS];
+} diram_trace_ring_t;
+
+static struct {
+    pthread_mutex_t lock;              // Guards rings list and writer state
+    pthread_cond_t wake;
+    pthread_cond_t flushed;
+    diram_trace_ring_t* rings;
+    pthread_t writer;
+    atomic_int active;
+    int stopping;
+    int restart_in_child;              // Forked while active; restart lazily
+    int fd;
+    diram_trace_format_t format;
+    uint64_t flush_requested;
+    uint64_t flush_completed;
+    atomic_uint_fast64_t records_written;
+    atomic_uint_fast64_t batches_written;
+    atomic_uint_fast64_t producer_stalls;
+    atomic_uint_fast64_t rings_active;
+} g_trace = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .flushed = PTHREAD_COND_INITIALIZER,
+    .fd = -1
+};
+
+static pthread_once_t g_trace_key_once = PTHREAD_ONCE_INIT;
+static pthread_once_t g_trace_atfork_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_trace_key;
+static __thread diram_trace_ring_t* t_ring = NULL;
+
+static void trace_ring_thread_exit(void* arg) {
+    diram_trace_ring_t* ring = (diram_trace_ring_t*)arg;
+    // The writer frees the ring once it has drained what is left
+    atomic_store_explicit(&ring->orphaned, 1, memory_order_release);
+    t_ring = NULL;
+}
+
+static void trace_key_init(void) {
+    pthread_key_create(&g_trace_key, trace_ring_thread_exit);
+}
+
+static diram_trace_ring_t* trace_ring_register(void) {
+    pthread_once(&g_trace_key_once, trace_key_init);
+
+    diram_trace_ring_t* ring = aligned_alloc(64, sizeof(diram_trace_ring_t));
+    if (!ring) return NULL;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->orphaned, 0);
+
+    pthread_mutex_lock(&g_trace.lock);
+    ring->next = g_trace.rings;
+    g_trace.rings = ring;
+    pthread_mutex_unlock(&g_trace.lock);
+
+    atomic_fetch_add_explicit(&g_trace.rings_active, 1, memory_order_relaxed);
+    pthread_setspecific(g_trace_key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+void diram_trace_record_fill(diram_trace_record_t* record, diram_trace_op_t op,
+                             uint64_t timestamp, pid_t pid, const void* address,
+                             size_t size, const char* receipt, const char* tag) {
+    record->timestamp = timestamp;
+    record->address = (uint64_t)(uintptr_t)address;
+    record->size = size;
+    record->count = 1;
+    record->pid = pid;
+    record->operation = (uint8_t)op;
+    memset(record->reserved, 0, sizeof(record->reserved));
+
+    size_t receipt_len = receipt ? strnlen(receipt, DIRAM_TRACE_RECEIPT_LEN) : 0;
+    memcpy(record->receipt, receipt, receipt_len);
+    memset(record->receipt + receipt_len, 0, DIRAM_TRACE_RECEIPT_LEN - receipt_len);
+
+    strncpy(record->tag, tag ? tag : "untagged", DIRAM_TRACE_TAG_LEN - 1);
+    record->tag[DIRAM_TRACE_TAG_LEN - 1] = '\0';
+}
+
+int diram_trace_record_format(const diram_trace_record_t* record,
+                              char* out, size_t out_len) {
+    const char* op = record->operation == DIRAM_TRACE_OP_ALLOC ? "ALLOC" :
+                     record->operation == DIRAM_TRACE_OP_FREE ? "FREE" :
+                     record->operation == DIRAM_TRACE_OP_ALLOC_RANGE ? "ALLOC_RANGE" : "UNKNOWN";
+    int receipt_len = (int)strnlen(record->receipt, DIRAM_TRACE_RECEIPT_LEN);
+    int tag_len = (int)strnlen(record->tag, DIRAM_TRACE_TAG_LEN);
+
+    // Range records append the number of allocations they cover
+    if (record->operation == DIRAM_TRACE_OP_ALLOC_RANGE) {
+        return snprintf(out, out_len, "%" PRIu64 "|%d|%s|%p|%" PRIu64 "|%.*s|%.*s|%" PRIu64 "\n",
+                        record->timestamp, record->pid, op,
+                        (void*)(uintptr_t)record->address, record->size,
+                        receipt_len, record->receipt, tag_len, record->tag,
+                        record->count);
+    }
+    return snprintf(out, out_len, "%" PRIu64 "|%d|%s|%p|%" PRIu64 "|%.*s|%.*s\n",
+                    record->timestamp, record->pid, op,
+                    (void*)(uintptr_t)record->address, record->size,
+                    receipt_len, record->receipt, tag_len, record->tag);
+}
+
+static int trace_restart_in_child(void);
+
+int diram_trace_ring_push(const diram_trace_record_t* record) {
+    if (!atomic_load_explicit(&g_trace.active, memory_order_acquire)) {
+        if (!g_trace.restart_in_child || trace_restart_in_child() < 0) {
+            return -1;
+        }
+    }
+
+    diram_trace_ring_t* ring = t_ring ? t_ring : trace_ring_register();
+    if (!ring) return -1;
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    int stalled = 0;
+
+    // Full ring: wake the writer and wait rather than lose an audit record
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire)
+           >= DIRAM_TRACE_RING_SLOTS) {
+        if (!atomic_load_explicit(&g_trace.active, memory_order_acquire)) {
+            return -1;
+        }
+        if (!stalled) {
+            atomic_fetch_add_explicit(&g_trace.producer_stalls, 1, memory_order_relaxed);
+            stalled = 1;
+        }
+        pthread_cond_signal(&g_trace.wake);
+        sched_yield();
+    }
+
+    ring->slots[head & DIRAM_TRACE_RING_MASK] = *record;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    // Nudge the writer when the ring is half full; otherwise it polls
+    size_t used = head + 1 - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (used == DIRAM_TRACE_RING_SLOTS / 2) {
+        pthread_cond_signal(&g_trace.wake);
+    }
+    return 0;
+}
+
+static int write_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int writev_all(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        // Skip fully written vectors, trim the partially written one
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+// Text mode: format into one staging buffer, one write per buffer fill
+static void drain_text(diram_trace_ring_t* rings, char* staging) {
+    size_t used = 0;
+    uint64_t records = 0;
+
+    for (diram_trace_ring_t* ring = rings; ring; ring = ring->next) {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            if (DIRAM_TRACE_TEXT_BUFFER - used < 256) {
+                write_all(g_trace.fd, staging, used);
+                atomic_fetch_add_explicit(&g_trace.batches_written, 1, memory_order_relaxed);
+                used = 0;
+            }
+            int n = diram_trace_record_format(&ring->slots[tail & DIRAM_TRACE_RING_MASK],
+                                              staging + used,
+                                              DIRAM_TRACE_TEXT_BUFFER - used);
+            if (n > 0) used += (size_t)n;
+            records++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    if (used > 0) {
+        write_all(g_trace.fd, staging, used);
+        atomic_fetch_add_explicit(&g_trace.batches_written, 1, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&g_trace.records_written, records, memory_order_relaxed);
+}
+
+// Binary mode: gather ring segments directly into a writev, no copying
+static void drain_binary(diram_trace_ring_t* rings) {
+    struct iovec iov[DIRAM_TRACE_MAX_IOV];
+    diram_trace_ring_t* owners[DIRAM_TRACE_MAX_IOV / 2];
+    size_t new_tails[DIRAM_TRACE_MAX_IOV / 2];
+    int iovcnt = 0;
+    int owner_count = 0;
+    uint64_t records = 0;
+
+    for (diram_trace_ring_t* ring = rings; ring; ring = ring->next) {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail == head) continue;
+
+        if (iovcnt + 2 > DIRAM_TRACE_MAX_IOV) {
+            writev_all(g_trace.fd, iov, iovcnt);
+            atomic_fetch_add_explicit(&g_trace.batches_written, 1, memory_order_relaxed);
+            for (int i = 0; i < owner_count; i++) {
+                atomic_store_explicit(&owners[i]->tail, new_tails[i], memory_order_release);
+            }
+            iovcnt = 0;
+            owner_count = 0;
+        }
+
+        // At most two contiguous segments: [tail, end) and [0, head)
+        size_t start = tail & DIRAM_TRACE_RING_MASK;
+        size_t count = head - tail;
+        size_t first = DIRAM_TRACE_RING_SLOTS - start;
+        if (first > count) first = count;
+
+        iov[iovcnt].iov_base = &ring->slots[start];
+        iov[iovcnt].iov_len = first * sizeof(diram_trace_record_t);
+        iovcnt++;
+        if (count > first) {
+            iov[iovcnt].iov_base = &ring->slots[0];
+            iov[iovcnt].iov_len = (count - first) * sizeof(diram_trace_record_t);
+            iovcnt++;
+        }
+
+        owners[owner_count] = ring;
+        new_tails[owner_count] = head;
+        owner_count++;
+        records += count;
+    }
+
+    if (iovcnt > 0) {
+        writev_all(g_trace.fd, iov, iovcnt);
+        atomic_fetch_add_explicit(&g_trace.batches_written, 1, memory_order_relaxed);
+        for (int i = 0; i < owner_count; i++) {
+            atomic_store_explicit(&owners[i]->tail, new_tails[i], memory_order_release);
+        }
+    }
+    atomic_fetch_add_explicit(&g_trace.records_written, records, memory_order_relaxed);
+}
+
+// Drop rings whose threads have exited and whose records are all written
+static void reap_orphans(void) {
+    pthread_mutex_lock(&g_trace.lock);
+    diram_trace_ring_t** link = &g_trace.rings;
+    while (*link) {
+        diram_trace_ring_t* ring = *link;
+        int orphaned = atomic_load_explicit(&ring->orphaned, memory_order_acquire);
+        if (orphaned &&
+            atomic_load_explicit(&ring->tail, memory_order_relaxed) ==
+            atomic_load_explicit(&ring->head, memory_order_acquire)) {
+            *link = ring->next;
+            free(ring);
+            atomic_fetch_sub_explicit(&g_trace.rings_active, 1, memory_order_relaxed);
+        } else {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&g_trace.lock);
+}
+
+static void drain_all(char* staging) {
+    // Rings are only unlinked by this thread, so the snapshot stays valid
+    pthread_mutex_lock(&g_trace.lock);
+    diram_trace_ring_t* rings = g_trace.rings;
+    pthread_mutex_unlock(&g_trace.lock);
+
+    if (g_trace.format == DIRAM_TRACE_FORMAT_BINARY) {
+        drain_binary(rings);
+    } else {
+        drain_text(rings, staging);
+    }
+    reap_orphans();
+}
+
+static void* trace_writer_main(void* arg) {
+    char* staging = (char*)arg;
+
+    pthread_mutex_lock(&g_trace.lock);
+    while (!g_trace.stopping) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += DIRAM_TRACE_WRITER_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        if (g_trace.flush_requested == g_trace.flush_completed) {
+            pthread_cond_timedwait(&g_trace.wake, &g_trace.lock, &deadline);
+        }
+
+        uint64_t requested = g_trace.flush_requested;
+        pthread_mutex_unlock(&g_trace.lock);
+
+        drain_all(staging);
+
+        pthread_mutex_lock(&g_trace.lock);
+        if (requested != g_trace.flush_completed) {
+            g_trace.flush_completed = requested;
+            pthread_cond_broadcast(&g_trace.flushed);
+        }
+    }
+    pthread_mutex_unlock(&g_trace.lock);
+
+    // Final pass after producers have been turned away
+    drain_all(staging);
+    free(staging);
+    return NULL;
+}
+
+// The writer thread does not survive fork(). The child keeps the inherited
+// descriptor, forgets the parent's undrained records (the parent writes
+// those) and starts its own writer on first use.
+static void trace_atfork_prepare(void) {
+    pthread_mutex_lock(&g_trace.lock);
+}
+
+static void trace_atfork_parent(void) {
+    pthread_mutex_unlock(&g_trace.lock);
+}
+
+static void trace_atfork_child(void) {
+    pthread_mutex_init(&g_trace.lock, NULL);
+    pthread_cond_init(&g_trace.wake, NULL);
+    pthread_cond_init(&g_trace.flushed, NULL);
+
+    for (diram_trace_ring_t* ring = g_trace.rings; ring; ring = ring->next) {
+        atomic_store(&ring->tail, atomic_load(&ring->head));
+        if (ring != t_ring) {
+            atomic_store(&ring->orphaned, 1);
+        }
+    }
+
+    if (atomic_load(&g_trace.active)) {
+        atomic_store(&g_trace.active, 0);
+        g_trace.restart_in_child = 1;
+    }
+}
+
+static void trace_atfork_init(void) {
+    pthread_atfork(trace_atfork_prepare, trace_atfork_parent, trace_atfork_child);
+}
+
+static int trace_spawn_writer(void) {
+    char* staging = malloc(DIRAM_TRACE_TEXT_BUFFER);
+    if (!staging) return -1;
+
+    g_trace.stopping = 0;
+    g_trace.flush_requested = 0;
+    g_trace.flush_completed = 0;
+
+    if (pthread_create(&g_trace.writer, NULL, trace_writer_main, staging) != 0) {
+        free(staging);
+        return -1;
+    }
+    atomic_store_explicit(&g_trace.active, 1, memory_order_release);
+    return 0;
+}
+
+static int trace_restart_in_child(void) {
+    int result = 0;
+    pthread_mutex_lock(&g_trace.lock);
+    if (g_trace.restart_in_child) {
+        g_trace.restart_in_child = 0;
+        result = trace_spawn_writer();
+    }
+    pthread_mutex_unlock(&g_trace.lock);
+    return result;
+}
+
+int diram_trace_ring_start(diram_trace_format_t format, const char* path) {
+    pthread_once(&g_trace_atfork_once, trace_atfork_init);
+    
+    pthread_mutex_lock(&g_trace.lock);
+    if (atomic_load(&g_trace.active)) {
+        pthread_mutex_unlock(&g_trace.lock);
+        return 0;  // Already running
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        pthread_mutex_unlock(&g_trace.lock);
+        return -1;
+    }
+
+    if (format == DIRAM_TRACE_FORMAT_BINARY) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size == 0) {
+            diram_trace_file_header_t header;
+            memcpy(header.magic, DIRAM_TRACE_BIN_MAGIC, sizeof(header.magic));
+            header.version = DIRAM_TRACE_BIN_VERSION;
+            header.record_size = sizeof(diram_trace_record_t);
+            write_all(fd, (const char*)&header, sizeof(header));
+        }
+    } else {
+        static const char header[] =
+            "# DIRAM Allocation Trace Log\n"
+            "# Format: TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG\n";
+        write_all(fd, header, sizeof(header) - 1);
+    }
+
+    g_trace.fd = fd;
+    g_trace.format = format;
+    g_trace.restart_in_child = 0;
+
+    if (trace_spawn_writer() < 0) {
+        close(fd);
+        g_trace.fd = -1;
+        pthread_mutex_unlock(&g_trace.lock);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&g_trace.lock);
+    return 0;
+}
+
+void diram_trace_ring_stop(void) {
+    pthread_mutex_lock(&g_trace.lock);
+    if (!atomic_load(&g_trace.active)) {
+        // Forked child that never traced: just drop the inherited descriptor
+        if (g_trace.restart_in_child) {
+            g_trace.restart_in_child = 0;
+            close(g_trace.fd);
+            g_trace.fd = -1;
+        }
+        pthread_mutex_unlock(&g_trace.lock);
+        return;
+    }
+    atomic_store_explicit(&g_trace.active, 0, memory_order_release);
+    g_trace.stopping = 1;
+    pthread_cond_signal(&g_trace.wake);
+    pthread_mutex_unlock(&g_trace.lock);
+
+    pthread_join(g_trace.writer, NULL);
+
+    pthread_mutex_lock(&g_trace.lock);
+    close(g_trace.fd);
+    g_trace.fd = -1;
+    pthread_cond_broadcast(&g_trace.flushed);
+    pthread_mutex_unlock(&g_trace.lock);
+}
+
+int diram_trace_ring_active(void) {
+    return atomic_load_explicit(&g_trace.active, memory_order_acquire) ||
+           g_trace.restart_in_child;
+}
+
+int diram_trace_ring_flush(void) {
+    pthread_mutex_lock(&g_trace.lock);
+    if (!atomic_load(&g_trace.active)) {
+        pthread_mutex_unlock(&g_trace.lock);
+        return -1;
+    }
+
+    uint64_t ticket = ++g_trace.flush_requested;
+    pthread_cond_signal(&g_trace.wake);
+    while (g_trace.flush_completed < ticket && atomic_load(&g_trace.active)) {
+        pthread_cond_wait(&g_trace.flushed, &g_trace.lock);
+    }
+    pthread_mutex_unlock(&g_trace.lock);
+    return 0;
+}
+
+void diram_trace_ring_get_stats(diram_trace_stats_t* out) {
+    if (!out) return;
+    out->records_written = atomic_load_explicit(&g_trace.records_written, memory_order_relaxed);
+    out->batches_written = atomic_load_explicit(&g_trace.batches_written, memory_order_relaxed);
+    out->producer_stalls = atomic_load_explicit(&g_trace.producer_stalls, memory_order_relaxed);
+    out->rings_active = atomic_load_explicit(&g_trace.rings_active, memory_order_relaxed);
+}
+
+int diram_trace_convert_binary(const char* binary_path, const char* text_path) {
+    FILE* in = fopen(binary_path, "rb");
+    if (!in) return -1;
+
+    diram_trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, DIRAM_TRACE_BIN_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DIRAM_TRACE_BIN_VERSION ||
+        header.record_size != sizeof(diram_trace_record_t)) {
+        fclose(in);
+        return -1;
+    }
+
+    FILE* out = strcmp(text_path, "-") == 0 ? stdout : fopen(text_path, "w");
+    if (!out) {
+        fclose(in);
+        return -1;
+    }
+
+    fprintf(out, "# DIRAM Allocation Trace Log\n");
+    fprintf(out, "# Format: TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG\n");
+
+    diram_trace_record_t records[256];
+    char line[256];
+    size_t n;
+    while ((n = fread(records, sizeof(records[0]), 256, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            int len = diram_trace_record_format(&records[i], line, sizeof(line));
+            if (len > 0) fwrite(line, 1, (size_t)len, out);
+        }
+    }
+
+    fclose(in);
+    if (out != stdout) {
+        fclose(out);
+    } else {
+        fflush(out);
+    }
+    return 0;
+}
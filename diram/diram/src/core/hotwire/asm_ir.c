@@ -0,0 +1,443 @@
+// src/core/hotwire/asm_ir.c
+// DIRAM Hotwire instruction IR - record, peephole passes, render
+// OBINexus Aegis Project
+//
+// The passes only look at straight-line code: a label something jumps to,
+// or any jmp/ret/ud2, ends what a pass may assume. Directives (comments,
+// data) never count as instructions and never break a pattern.
+
+#include "diram/core/hotwire/asm_ir.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IR_INITIAL_ENTRIES 256
+#define IR_INITIAL_POOL 4096
+
+// Storage
+
+diram_hotwire_ir_t* diram_hotwire_ir_create(void) {
+    diram_hotwire_ir_t* ir = calloc(1, sizeof(diram_hotwire_ir_t));
+    if (!ir) return NULL;
+    diram_hotwire_ir_reset(ir);
+    return ir;
+}
+
+void diram_hotwire_ir_destroy(diram_hotwire_ir_t* ir) {
+    if (!ir) return;
+    free(ir->entries);
+    free(ir->pool);
+    free(ir);
+}
+
+void diram_hotwire_ir_reset(diram_hotwire_ir_t* ir) {
+    ir->count = 0;
+    ir->pool_size = 0;
+    ir->batch_counter = 0;
+    ir->failed = false;
+}
+
+static uint32_t ir_intern(diram_hotwire_ir_t* ir, const char* text) {
+    if (!text || !*text) return 0;
+    if (ir->pool_size == 0) {
+        // Reserve offset 0 for the empty string
+        ir->pool_size = 1;
+        if (ir->pool_capacity == 0) {
+            ir->pool = malloc(IR_INITIAL_POOL);
+            if (!ir->pool) {
+                ir->failed = true;
+                return 0;
+            }
+            ir->pool_capacity = IR_INITIAL_POOL;
+        }
+        ir->pool[0] = '\0';
+    }
+
+    size_t length = strlen(text) + 1;
+    if (ir->pool_size + length > ir->pool_capacity) {
+        size_t capacity = ir->pool_capacity;
+        while (capacity < ir->pool_size + length) capacity *= 2;
+        char* pool = realloc(ir->pool, capacity);
+        if (!pool) {
+            ir->failed = true;
+            return 0;
+        }
+        ir->pool = pool;
+        ir->pool_capacity = capacity;
+    }
+    uint32_t offset = (uint32_t)ir->pool_size;
+    memcpy(ir->pool + offset, text, length);
+    ir->pool_size += length;
+    return offset;
+}
+
+static const char* ir_string(const diram_hotwire_ir_t* ir, uint32_t offset) {
+    return offset ? ir->pool + offset : NULL;
+}
+
+static bool ir_reserve(diram_hotwire_ir_t* ir, size_t extra) {
+    if (ir->count + extra <= ir->capacity) return true;
+    size_t capacity = ir->capacity ? ir->capacity : IR_INITIAL_ENTRIES;
+    while (capacity < ir->count + extra) capacity *= 2;
+    diram_hotwire_ir_entry_t* entries = realloc(ir->entries,
+                                                capacity * sizeof(diram_hotwire_ir_entry_t));
+    if (!entries) {
+        ir->failed = true;
+        return false;
+    }
+    ir->entries = entries;
+    ir->capacity = capacity;
+    return true;
+}
+
+void diram_hotwire_ir_append(diram_hotwire_ir_t* ir, diram_hotwire_ir_kind_t kind,
+                             diram_asm_mnemonic_t mnemonic,
+                             const char* operand1, const char* operand2) {
+    if (!ir_reserve(ir, 1)) return;
+    diram_hotwire_ir_entry_t entry = {
+        .kind = kind,
+        .mnemonic = mnemonic,
+        .operand1 = ir_intern(ir, operand1),
+        .operand2 = ir_intern(ir, operand2)
+    };
+    ir->entries[ir->count++] = entry;
+}
+
+void diram_hotwire_ir_splice(diram_hotwire_ir_t* dst, const diram_hotwire_ir_t* src) {
+    for (size_t i = 0; i < src->count; i++) {
+        const diram_hotwire_ir_entry_t* entry = &src->entries[i];
+        if (entry->dead) continue;
+        diram_hotwire_ir_append(dst, entry->kind, entry->mnemonic,
+                                ir_string(src, entry->operand1),
+                                ir_string(src, entry->operand2));
+    }
+    if (src->failed) dst->failed = true;
+}
+
+// Pattern helpers
+
+static bool is_insn(const diram_hotwire_ir_t* ir, size_t i, diram_asm_mnemonic_t mnemonic,
+                    const char* operand1) {
+    if (i >= ir->count) return false;
+    const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+    if (entry->kind != HOTWIRE_IR_INSN || entry->dead || entry->mnemonic != mnemonic) return false;
+    const char* op = ir_string(ir, entry->operand1);
+    return !operand1 || (op && strcmp(op, operand1) == 0);
+}
+
+static bool same_string(const diram_hotwire_ir_t* ir, uint32_t a, uint32_t b) {
+    const char* x = ir_string(ir, a);
+    const char* y = ir_string(ir, b);
+    return x == y || (x && y && strcmp(x, y) == 0);
+}
+
+// Next live entry after i that is not a directive
+static size_t next_code(const diram_hotwire_ir_t* ir, size_t i) {
+    for (i++; i < ir->count; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (!entry->dead && entry->kind != HOTWIRE_IR_DIRECTIVE) break;
+    }
+    return i;
+}
+
+// Entries that end straight-line code: jmp, ret, ud2, and labels that some
+// jmp/jz names. Jump targets are few (the visitor uses fixed handler
+// labels), so a short list beats a hash table here.
+static bool* find_barriers(const diram_hotwire_ir_t* ir) {
+    bool* barrier = calloc(ir->count ? ir->count : 1, sizeof(bool));
+    if (!barrier) return NULL;
+
+    uint32_t targets[64];
+    size_t target_count = 0;
+    bool overflow = false;
+    for (size_t i = 0; i < ir->count; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead || entry->kind != HOTWIRE_IR_INSN) continue;
+        if (entry->mnemonic == ASM_JMP || entry->mnemonic == ASM_RET ||
+            entry->mnemonic == ASM_TRAP) {
+            barrier[i] = true;
+        }
+        if (entry->mnemonic != ASM_JMP && entry->mnemonic != ASM_JZ) continue;
+
+        size_t t = 0;
+        while (t < target_count && !same_string(ir, targets[t], entry->operand1)) t++;
+        if (t == target_count) {
+            if (target_count < sizeof(targets) / sizeof(targets[0])) {
+                targets[target_count++] = entry->operand1;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < ir->count; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead || entry->kind != HOTWIRE_IR_LABEL) continue;
+        // Too many distinct targets to track: treat every label as one
+        bool target = overflow;
+        for (size_t t = 0; t < target_count && !target; t++) {
+            target = same_string(ir, targets[t], entry->operand1);
+        }
+        barrier[i] = target;
+    }
+    return barrier;
+}
+
+static uint32_t live_instructions(const diram_hotwire_ir_t* ir) {
+    uint32_t count = 0;
+    for (size_t i = 0; i < ir->count; i++) {
+        if (!ir->entries[i].dead && ir->entries[i].kind == HOTWIRE_IR_INSN) count++;
+    }
+    return count;
+}
+
+// constraint-fusion: mov rcx, N / call diram_check_constraint / jz L right
+// after the same check, with no instruction between, cannot fail differently
+static void pass_constraint_fusion(diram_hotwire_ir_t* ir, const bool* barrier) {
+    bool have_last = false;
+    uint32_t last_events = 0, last_target = 0;
+
+    for (size_t i = 0; i < ir->count; i++) {
+        diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead || entry->kind == HOTWIRE_IR_DIRECTIVE) continue;
+        if (barrier[i]) {
+            have_last = false;
+            continue;
+        }
+        if (entry->kind == HOTWIRE_IR_LABEL) continue;
+
+        size_t call = next_code(ir, i);
+        size_t jump = next_code(ir, call);
+        if (is_insn(ir, i, ASM_MV, "rcx") &&
+            is_insn(ir, call, ASM_CALL, "diram_check_constraint") &&
+            is_insn(ir, jump, ASM_JZ, NULL)) {
+            if (have_last && same_string(ir, entry->operand2, last_events) &&
+                same_string(ir, ir->entries[jump].operand1, last_target)) {
+                entry->dead = true;
+                ir->entries[call].dead = true;
+                ir->entries[jump].dead = true;
+            } else {
+                have_last = true;
+                last_events = entry->operand2;
+                last_target = ir->entries[jump].operand1;
+            }
+            i = jump;
+            continue;
+        }
+        // Anything else may allocate and change the outcome
+        have_last = false;
+    }
+}
+
+// feature-hoist: once call diram_feature_enabled / jz L has passed, the
+// same check later in the same straight-line run, with no call or argument
+// load between, is known to pass
+static void pass_feature_hoist(diram_hotwire_ir_t* ir, const bool* barrier) {
+    bool have_check = false;
+    uint32_t checked_target = 0;
+
+    for (size_t i = 0; i < ir->count; i++) {
+        diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead || entry->kind == HOTWIRE_IR_DIRECTIVE) continue;
+        if (barrier[i]) {
+            have_check = false;
+            continue;
+        }
+
+        size_t jump = next_code(ir, i);
+        if (is_insn(ir, i, ASM_CALL, "diram_feature_enabled") && is_insn(ir, jump, ASM_JZ, NULL)) {
+            if (have_check && same_string(ir, ir->entries[jump].operand1, checked_target)) {
+                entry->dead = true;
+                ir->entries[jump].dead = true;
+            } else {
+                have_check = true;
+                checked_target = ir->entries[jump].operand1;
+            }
+            i = jump;
+            continue;
+        }
+        // Another call may flip the state; a new argument asks about another feature
+        if (is_insn(ir, i, ASM_CALL, NULL) || is_insn(ir, i, ASM_MV, "rdi") ||
+            is_insn(ir, i, ASM_LOAD, "rdi")) {
+            have_check = false;
+        }
+    }
+}
+
+// One allocation: mov rdi, size / call diram_alloc_traced [/ mov [addr], rax].
+// Returns the entry after it, or 0 when i does not start one.
+static size_t match_allocation(const diram_hotwire_ir_t* ir, size_t i, size_t* store) {
+    size_t call = next_code(ir, i);
+    if (!is_insn(ir, i, ASM_MV, "rdi") || !is_insn(ir, call, ASM_CALL, "diram_alloc_traced")) {
+        return 0;
+    }
+    size_t next = next_code(ir, call);
+    *store = is_insn(ir, next, ASM_STORE, "rax") ? next : 0;
+    return *store ? next_code(ir, next) : next;
+}
+
+static void ir_append_entry(diram_hotwire_ir_t* dst, const diram_hotwire_ir_t* src,
+                            const diram_hotwire_ir_entry_t* entry) {
+    diram_hotwire_ir_append(dst, entry->kind, entry->mnemonic,
+                            ir_string(src, entry->operand1), ir_string(src, entry->operand2));
+}
+
+#define BATCH_MAX 256
+#define BATCH_QUADS_PER_LINE 8
+
+// alloc-batch: adjacent allocations become one diram_alloc_batch call - one
+// heap event instead of one each - when that is also fewer instructions
+static void pass_alloc_batch(diram_hotwire_ir_t* ir) {
+    diram_hotwire_ir_t* out = diram_hotwire_ir_create();
+    diram_hotwire_ir_t* data = diram_hotwire_ir_create();
+    if (!out || !data) {
+        diram_hotwire_ir_destroy(out);
+        diram_hotwire_ir_destroy(data);
+        return;
+    }
+    out->batch_counter = ir->batch_counter;
+
+    char text[256];
+    for (size_t i = 0; i < ir->count; ) {
+        size_t starts[BATCH_MAX], stores[BATCH_MAX];
+        size_t count = 0, stored = 0, end = i, store;
+        size_t next;
+        while (count < BATCH_MAX && (next = match_allocation(ir, end, &store)) != 0) {
+            starts[count] = end;
+            stores[count++] = store;
+            if (store) stored++;
+            end = next;
+        }
+
+        // 2 instructions (+1 stored) each, against 5 + 2 per stored member
+        if (count < 2 || 2 * count + stored <= 5 + 2 * stored) {
+            if (!ir->entries[i].dead) ir_append_entry(out, ir, &ir->entries[i]);
+            i++;
+            continue;
+        }
+
+        // Comments from inside the run keep their order, ahead of the call
+        for (size_t j = i; j < end; j++) {
+            if (!ir->entries[j].dead && ir->entries[j].kind == HOTWIRE_IR_DIRECTIVE) {
+                ir_append_entry(out, ir, &ir->entries[j]);
+            }
+        }
+
+        uint32_t batch = out->batch_counter++;
+        snprintf(text, sizeof(text), "; alloc-batch: %zu allocations, one heap event", count);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_DIRECTIVE, ASM_MV, text, NULL);
+        snprintf(text, sizeof(text), "%zu", count);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_MV, "rdi", text);
+        snprintf(text, sizeof(text), "OFFSET .alloc_sizes_%u", batch);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_MV, "rsi", text);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_MV, "rdx", "0");
+        snprintf(text, sizeof(text), "OFFSET .alloc_out_%u", batch);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_MV, "rcx", text);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_CALL, "diram_alloc_batch", NULL);
+        for (size_t m = 0; m < count; m++) {
+            if (!stores[m]) continue;
+            snprintf(text, sizeof(text), ".alloc_out_%u+%zu", batch, m * 8);
+            diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_LOAD, "rax", text);
+            diram_hotwire_ir_append(out, HOTWIRE_IR_INSN, ASM_STORE, "rax",
+                                    ir_string(ir, ir->entries[stores[m]].operand2));
+        }
+
+        // Size and result tables go after the code
+        snprintf(text, sizeof(text), ".alloc_sizes_%u", batch);
+        diram_hotwire_ir_append(data, HOTWIRE_IR_LABEL, ASM_MV, text, NULL);
+        for (size_t m = 0; m < count; m += BATCH_QUADS_PER_LINE) {
+            size_t length = (size_t)snprintf(text, sizeof(text), ".quad ");
+            for (size_t q = m; q < count && q < m + BATCH_QUADS_PER_LINE; q++) {
+                length += (size_t)snprintf(text + length, sizeof(text) - length, "%s%s",
+                                           q > m ? ", " : "",
+                                           ir_string(ir, ir->entries[starts[q]].operand2));
+            }
+            diram_hotwire_ir_append(data, HOTWIRE_IR_DIRECTIVE, ASM_MV, text, NULL);
+        }
+        snprintf(text, sizeof(text), ".alloc_out_%u", batch);
+        diram_hotwire_ir_append(data, HOTWIRE_IR_LABEL, ASM_MV, text, NULL);
+        snprintf(text, sizeof(text), ".zero %zu", count * 8);
+        diram_hotwire_ir_append(data, HOTWIRE_IR_DIRECTIVE, ASM_MV, text, NULL);
+        i = end;
+    }
+
+    if (data->count) {
+        diram_hotwire_ir_append(out, HOTWIRE_IR_DIRECTIVE, ASM_MV, "", NULL);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_DIRECTIVE, ASM_MV, ".section .data", NULL);
+        diram_hotwire_ir_append(out, HOTWIRE_IR_DIRECTIVE, ASM_MV, ".align 8", NULL);
+        diram_hotwire_ir_splice(out, data);
+    }
+
+    if (out->failed || data->failed) {
+        // Leave the program as it was rather than half rewritten
+        diram_hotwire_ir_destroy(out);
+        diram_hotwire_ir_destroy(data);
+        return;
+    }
+
+    // Take over out's storage
+    diram_hotwire_ir_t swap = *ir;
+    *ir = *out;
+    *out = swap;
+    diram_hotwire_ir_destroy(out);
+    diram_hotwire_ir_destroy(data);
+}
+
+size_t diram_hotwire_ir_optimize(diram_hotwire_ir_t* ir,
+                                 diram_hotwire_pass_stats_t* stats, size_t max_stats) {
+    size_t passes = 0;
+    bool* barrier = find_barriers(ir);
+    if (!barrier) return 0;
+
+    if (passes < max_stats) {
+        stats[passes] = (diram_hotwire_pass_stats_t){ "constraint-fusion", live_instructions(ir), 0 };
+        pass_constraint_fusion(ir, barrier);
+        stats[passes++].after = live_instructions(ir);
+    }
+    if (passes < max_stats) {
+        stats[passes] = (diram_hotwire_pass_stats_t){ "feature-hoist", live_instructions(ir), 0 };
+        pass_feature_hoist(ir, barrier);
+        stats[passes++].after = live_instructions(ir);
+    }
+    free(barrier);
+
+    // Rebuilds the entry array, so it runs last
+    if (passes < max_stats) {
+        stats[passes] = (diram_hotwire_pass_stats_t){ "alloc-batch", live_instructions(ir), 0 };
+        pass_alloc_batch(ir);
+        stats[passes++].after = live_instructions(ir);
+    }
+    return passes;
+}
+
+bool diram_hotwire_ir_render(diram_hotwire_ir_t* ir, diram_hotwire_context_t* context) {
+    // Render through the text emitters so formatting matches exactly
+    diram_hotwire_ir_t* saved = context->ir;
+    context->ir = NULL;
+
+    for (size_t i = 0; i < ir->count && !context->has_error; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead) continue;
+        const char* operand1 = ir_string(ir, entry->operand1);
+        switch (entry->kind) {
+            case HOTWIRE_IR_INSN:
+                diram_hotwire_emit_asm_instruction(context, entry->mnemonic, operand1,
+                                                   ir_string(ir, entry->operand2));
+                break;
+            case HOTWIRE_IR_LABEL:
+                diram_hotwire_emit_asm_label(context, operand1 ? operand1 : "");
+                break;
+            case HOTWIRE_IR_DIRECTIVE:
+                diram_hotwire_emit_asm_directive(context, "%s", operand1 ? operand1 : "");
+                break;
+        }
+    }
+
+    context->ir = saved;
+    if (ir->failed && !context->has_error) {
+        context->has_error = true;
+        snprintf(context->error_message, sizeof(context->error_message),
+                 "Out of memory recording instructions");
+    }
+    return !context->has_error;
+}
@@ -1,3 +1,601 @@
-/* Stub for src/core/hotwire/hotwire.c */
+// src/core/hotwire/hotwire.c
+// DIRAM Hotwire Transformer - context, feature table, emission and transform
+// OBINexus Aegis Project
+
+#include "diram/core/hotwire/hotwire.h"
+#include "diram/core/hotwire/wasm_binary.h"
+#include "diram/core/hotwire/asm_ir.h"
+#include "diram/core/feature-alloc/async_pool.h"
 #include <stdio.h>
-// TODO: Implement
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define HOTWIRE_INITIAL_OUTPUT 4096
+#define HOTWIRE_LINE_MAX 512
+
+// Output buffer
+
+static bool output_reserve(diram_hotwire_context_t* context, size_t extra) {
+    if (context->output_size + extra + 1 <= context->output_capacity) return true;
+
+    size_t capacity = context->output_capacity ? context->output_capacity : HOTWIRE_INITIAL_OUTPUT;
+    while (capacity < context->output_size + extra + 1) capacity *= 2;
+    char* buffer = realloc(context->output_buffer, capacity);
+    if (!buffer) {
+        context->has_error = true;
+        snprintf(context->error_message, sizeof(context->error_message),
+                 "Out of memory growing output to %zu bytes", capacity);
+        return false;
+    }
+    context->output_buffer = buffer;
+    context->output_capacity = capacity;
+    return true;
+}
+
+static void output_append(diram_hotwire_context_t* context, const char* text, size_t length) {
+    if (!output_reserve(context, length)) return;
+    memcpy(context->output_buffer + context->output_size, text, length);
+    context->output_size += length;
+    context->output_buffer[context->output_size] = '\0';
+}
+
+static void output_line(diram_hotwire_context_t* context, const char* text) {
+    output_append(context, text, strlen(text));
+    output_append(context, "\n", 1);
+}
+
+// Context
+
+diram_hotwire_context_t* diram_hotwire_create(diram_hotwire_target_t target) {
+    diram_hotwire_context_t* context = calloc(1, sizeof(diram_hotwire_context_t));
+    if (!context) return NULL;
+
+    context->execution_table = calloc(1, sizeof(diram_hotwire_table_t));
+    if (!context->execution_table || !output_reserve(context, 0)) {
+        free(context->execution_table);
+        free(context);
+        return NULL;
+    }
+    context->output_buffer[0] = '\0';
+    context->target = target;
+
+    if (target == HOTWIRE_TARGET_NATIVE_ASM || target == HOTWIRE_TARGET_NATIVE_JIT) {
+        context->config.asm_config.arch = "x86_64";
+        context->config.asm_config.use_intel_syntax = true;
+    } else if (target == HOTWIRE_TARGET_WASM || target == HOTWIRE_TARGET_WASM_BINARY) {
+        context->config.wasm_config.memory_pages = 1;
+    }
+    return context;
+}
+
+static void table_release(diram_hotwire_table_t* table) {
+    for (size_t i = 0; i < table->feature_count; i++) {
+        free((char*)table->features[i].name);
+    }
+    free(table->features);
+    table->features = NULL;
+    table->feature_count = table->feature_capacity = 0;
+}
+
+void diram_hotwire_destroy(diram_hotwire_context_t* context) {
+    if (!context) return;
+    if (context->execution_table) {
+        table_release(context->execution_table);
+        free(context->execution_table);
+    }
+    diram_hotwire_ir_destroy(context->ir);
+    free(context->output_buffer);
+    free(context);
+}
+
+// Feature Toggle Management
+
+static diram_feature_state_t* find_feature(diram_hotwire_context_t* context, const char* name) {
+    diram_hotwire_table_t* table = context->execution_table;
+    if (!table || !name) return NULL;
+    for (size_t i = 0; i < table->feature_count; i++) {
+        if (strcmp(table->features[i].name, name) == 0) return &table->features[i];
+    }
+    return NULL;
+}
+
+bool diram_hotwire_register_feature(diram_hotwire_context_t* context,
+                                    const char* name, bool enabled) {
+    if (!context || !context->execution_table || !name) return false;
+    diram_hotwire_table_t* table = context->execution_table;
+
+    diram_feature_state_t* feature = find_feature(context, name);
+    if (!feature) {
+        if (table->feature_count == table->feature_capacity) {
+            size_t capacity = table->feature_capacity ? table->feature_capacity * 2 : 16;
+            diram_feature_state_t* features = realloc(table->features,
+                                                      capacity * sizeof(diram_feature_state_t));
+            if (!features) return false;
+            table->features = features;
+            table->feature_capacity = capacity;
+        }
+        char* copy = strdup(name);
+        if (!copy) return false;
+        feature = &table->features[table->feature_count++];
+        memset(feature, 0, sizeof(*feature));
+        feature->name = copy;
+    }
+
+    feature->enabled = enabled;
+    feature->allowed = table->policy_check ?
+                       table->policy_check(name, feature->policy_flags) : true;
+    return true;
+}
+
+bool diram_hotwire_check_feature(diram_hotwire_context_t* context, const char* name) {
+    diram_feature_state_t* feature = find_feature(context, name);
+    return feature && feature->enabled && feature->allowed;
+}
+
+bool diram_hotwire_activate_feature(diram_hotwire_context_t* context, const char* name) {
+    diram_feature_state_t* feature = find_feature(context, name);
+    if (!feature) return false;
+
+    if (!feature->enabled || !feature->allowed) {
+        if (context->execution_table->policy_violation) {
+            context->execution_table->policy_violation(name,
+                feature->allowed ? "feature disabled" : "denied by policy");
+        }
+        return false;
+    }
+    feature->activated = true;
+    return true;
+}
+
+// Policy Enforcement
+
+bool diram_hotwire_enforce_policy(diram_hotwire_context_t* context, const char* policy_name) {
+    if (!context || !context->execution_table) return false;
+    diram_hotwire_table_t* table = context->execution_table;
+    if (!table->policy_check || table->policy_check(policy_name, 0)) return true;
+
+    if (table->policy_violation) {
+        table->policy_violation(policy_name, "policy check failed");
+    }
+    return false;
+}
+
+void diram_hotwire_set_policy_handler(diram_hotwire_context_t* context,
+                                      bool (*handler)(const char*, uint32_t)) {
+    if (context && context->execution_table) {
+        context->execution_table->policy_check = handler;
+    }
+}
+
+// Assembly Target Emission
+
+void diram_hotwire_emit_asm_instruction(diram_hotwire_context_t* context,
+                                        diram_asm_mnemonic_t mnemonic,
+                                        const char* operand1,
+                                        const char* operand2) {
+    if (context->ir) {
+        diram_hotwire_ir_append(context->ir, HOTWIRE_IR_INSN, mnemonic, operand1, operand2);
+        return;
+    }
+
+    char line[HOTWIRE_LINE_MAX];
+    const char* op = diram_hotwire_mnemonic_to_string(mnemonic);
+
+    if (mnemonic == ASM_STORE && operand1 && operand2) {
+        snprintf(line, sizeof(line), "    %s [%s], %s", op, operand2, operand1);
+    } else if (mnemonic == ASM_LOAD && operand1 && operand2) {
+        snprintf(line, sizeof(line), "    %s %s, [%s]", op, operand1, operand2);
+    } else if (operand1 && operand2) {
+        snprintf(line, sizeof(line), "    %s %s, %s", op, operand1, operand2);
+    } else if (operand1) {
+        snprintf(line, sizeof(line), "    %s %s", op, operand1);
+    } else {
+        snprintf(line, sizeof(line), "    %s", op);
+    }
+    output_line(context, line);
+}
+
+void diram_hotwire_emit_asm_label(diram_hotwire_context_t* context, const char* label) {
+    if (context->ir) {
+        diram_hotwire_ir_append(context->ir, HOTWIRE_IR_LABEL, ASM_MV, label, NULL);
+        return;
+    }
+    output_append(context, label, strlen(label));
+    output_append(context, ":\n", 2);
+}
+
+void diram_hotwire_emit_asm_directive(diram_hotwire_context_t* context,
+                                      const char* format, ...) {
+    char line[HOTWIRE_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (context->ir) {
+        diram_hotwire_ir_append(context->ir, HOTWIRE_IR_DIRECTIVE, ASM_MV, line, NULL);
+        return;
+    }
+    output_line(context, line);
+}
+
+// WebAssembly Target Emission
+
+void diram_hotwire_emit_wasm_instruction(diram_hotwire_context_t* context,
+                                         const char* instruction) {
+    output_line(context, instruction);
+}
+
+void diram_hotwire_emit_wasm_function(diram_hotwire_context_t* context,
+                                      const char* name,
+                                      const char* params,
+                                      const char* results) {
+    char line[HOTWIRE_LINE_MAX];
+    snprintf(line, sizeof(line), "  (func $%s%s%s%s%s", name,
+             params ? " " : "", params ? params : "",
+             results ? " " : "", results ? results : "");
+    output_line(context, line);
+    context->in_function = true;
+}
+
+void diram_hotwire_emit_wasm_trap(diram_hotwire_context_t* context, const char* condition) {
+    char line[HOTWIRE_LINE_MAX];
+    if (condition) {
+        snprintf(line, sizeof(line), "(if %s (then (unreachable)))", condition);
+    } else {
+        snprintf(line, sizeof(line), "(unreachable)");
+    }
+    output_line(context, line);
+}
+
+// Transform
+
+static diram_ast_visitor_t* create_visitor(diram_hotwire_context_t* context) {
+    switch (context->target) {
+        case HOTWIRE_TARGET_NATIVE_ASM:
+        case HOTWIRE_TARGET_NATIVE_JIT:  return diram_hotwire_create_asm_visitor(context);
+        case HOTWIRE_TARGET_WASM:        return diram_hotwire_create_wasm_visitor(context);
+        case HOTWIRE_TARGET_WASM_BINARY: return diram_hotwire_create_wasm_binary_visitor(context);
+        default:                         return NULL;
+    }
+}
+
+static void destroy_visitor(diram_hotwire_context_t* context, diram_ast_visitor_t* visitor) {
+    if (context->target == HOTWIRE_TARGET_WASM_BINARY) {
+        diram_hotwire_destroy_wasm_binary_visitor(visitor);
+    } else {
+        free(visitor);
+    }
+}
+
+static bool is_independent(const diram_ast_node_t* node) {
+    return node->type == AST_NODE_MEMORY_REGION ||
+           node->type == AST_NODE_POLICY ||
+           node->type == AST_NODE_FEATURE_TOGGLE;
+}
+
+// A run of consecutive top-level children lowered into its own output.
+// Independent runs register their toggles in a private table; the real
+// one is filled in order on the calling thread.
+typedef struct {
+    diram_hotwire_context_t context;
+    diram_hotwire_table_t table;
+    diram_ast_node_t** nodes;
+    size_t count;
+    atomic_bool claimed;
+} hotwire_shard_t;
+
+typedef struct {
+    hotwire_shard_t* shards;
+    size_t count;
+    size_t remaining;           // Shards not lowered yet
+    size_t tasks;               // Submitted tasks the pool has not returned
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+} hotwire_job_t;
+
+typedef struct {
+    hotwire_job_t* job;
+    hotwire_shard_t* shard;
+} hotwire_task_t;
+
+static void shard_lower(hotwire_shard_t* shard) {
+    // The visitor's module header belongs to the parent context only
+    diram_ast_visitor_t* visitor = create_visitor(&shard->context);
+    shard->context.output_size = 0;
+    if (shard->context.ir) diram_hotwire_ir_reset(shard->context.ir);
+    if (!visitor) {
+        shard->context.has_error = true;
+        snprintf(shard->context.error_message, sizeof(shard->context.error_message),
+                 "Out of memory creating visitor");
+        return;
+    }
+    for (size_t i = 0; i < shard->count && !shard->context.has_error; i++) {
+        diram_ast_accept(shard->nodes[i], visitor);
+    }
+    destroy_visitor(&shard->context, visitor);
+}
+
+static void job_release(hotwire_job_t* job, size_t shards, size_t tasks) {
+    pthread_mutex_lock(&job->lock);
+    job->remaining -= shards;
+    job->tasks -= tasks;
+    if (job->remaining == 0 && job->tasks == 0) pthread_cond_signal(&job->done);
+    pthread_mutex_unlock(&job->lock);
+}
+
+// Whoever claims the shard first lowers it: a pool worker, or the caller
+// while it waits, so a busy or single-worker pool cannot stall the transform
+static bool shard_claim(hotwire_shard_t* shard) {
+    return !atomic_exchange_explicit(&shard->claimed, true, memory_order_acq_rel);
+}
+
+static void shard_task(void* arg) {
+    hotwire_task_t* task = (hotwire_task_t*)arg;
+    // The job outlives every task, claimed or not
+    bool lowered = shard_claim(task->shard);
+    if (lowered) shard_lower(task->shard);
+    job_release(task->job, lowered ? 1 : 0, 1);
+    free(task);
+}
+
+static void shard_init(hotwire_shard_t* shard, const diram_hotwire_context_t* parent,
+                       diram_ast_node_t** nodes, size_t count, bool independent) {
+    shard->context = *parent;
+    shard->context.output_buffer = NULL;
+    shard->context.output_size = 0;
+    shard->context.output_capacity = 0;
+    shard->context.has_error = false;
+    shard->context.error_message[0] = '\0';
+    memset(&shard->table, 0, sizeof(shard->table));
+    if (independent) shard->context.execution_table = &shard->table;
+    // Recording shards splice into the parent IR so passes see the whole program
+    if (parent->ir) {
+        shard->context.ir = diram_hotwire_ir_create();
+        if (!shard->context.ir) {
+            shard->context.has_error = true;
+            snprintf(shard->context.error_message, sizeof(shard->context.error_message),
+                     "Out of memory recording instructions");
+        }
+    }
+    shard->nodes = nodes;
+    shard->count = count;
+    atomic_init(&shard->claimed, false);
+}
+
+static void transform_parallel(diram_hotwire_context_t* context, diram_ast_node_t* root,
+                               diram_ast_visitor_t* visitor) {
+    diram_ast_node_t** children = root->children;
+    size_t child_count = root->child_count;
+
+    hotwire_job_t job = { .shards = calloc(child_count, sizeof(hotwire_shard_t)) };
+    if (!job.shards) {
+        // No room to split; the serial walk gives the same output
+        for (size_t i = 0; i < child_count && !context->has_error; i++) {
+            diram_ast_accept(children[i], visitor);
+        }
+        return;
+    }
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.done, NULL);
+
+    for (size_t i = 0; i < child_count; ) {
+        bool independent = is_independent(children[i]);
+        size_t end = i + 1;
+        while (end < child_count && is_independent(children[end]) == independent &&
+               (!independent || end - i < HOTWIRE_PARALLEL_CHUNK)) {
+            end++;
+        }
+
+        hotwire_shard_t* shard = &job.shards[job.count++];
+        shard_init(shard, context, children + i, end - i, independent);
+
+        if (!independent) {
+            // Reads the feature table, so it runs here, after every toggle before it
+            atomic_store_explicit(&shard->claimed, true, memory_order_relaxed);
+            shard_lower(shard);
+        } else {
+            for (size_t j = i; j < end; j++) {
+                if (children[j]->type == AST_NODE_FEATURE_TOGGLE) {
+                    diram_hotwire_register_feature(context, children[j]->data.feature.name,
+                                                   children[j]->data.feature.enabled);
+                }
+            }
+            pthread_mutex_lock(&job.lock);
+            job.remaining++;
+            job.tasks++;
+            pthread_mutex_unlock(&job.lock);
+
+            hotwire_task_t* task = malloc(sizeof(hotwire_task_t));
+            if (task) {
+                *task = (hotwire_task_t){ &job, shard };
+            }
+            if (!task || diram_async_pool_submit(shard_task, task) < 0) {
+                // Pool full: the wait below lowers it
+                free(task);
+                job_release(&job, 0, 1);
+            }
+        }
+        i = end;
+    }
+
+    // Help with whatever the pool has not started, then wait for the rest
+    for (size_t i = 0; i < job.count; i++) {
+        if (shard_claim(&job.shards[i])) {
+            shard_lower(&job.shards[i]);
+            job_release(&job, 1, 0);
+        }
+    }
+    pthread_mutex_lock(&job.lock);
+    while (job.remaining > 0 || job.tasks > 0) pthread_cond_wait(&job.done, &job.lock);
+    pthread_mutex_unlock(&job.lock);
+
+    // Splice in order; the first failing shard reports
+    for (size_t i = 0; i < job.count; i++) {
+        hotwire_shard_t* shard = &job.shards[i];
+        if (shard->context.has_error && !context->has_error) {
+            context->has_error = true;
+            memcpy(context->error_message, shard->context.error_message,
+                   sizeof(context->error_message));
+        }
+        if (!context->has_error) {
+            if (context->ir) {
+                diram_hotwire_ir_splice(context->ir, shard->context.ir);
+            } else {
+                output_append(context, shard->context.output_buffer, shard->context.output_size);
+            }
+        }
+        diram_hotwire_ir_destroy(shard->context.ir);
+        free(shard->context.output_buffer);
+        table_release(&shard->table);
+    }
+
+    pthread_cond_destroy(&job.done);
+    pthread_mutex_destroy(&job.lock);
+    free(job.shards);
+}
+
+void diram_hotwire_set_parallel(diram_hotwire_context_t* context, bool enabled) {
+    if (context) context->parallel = enabled;
+}
+
+void diram_hotwire_set_optimize(diram_hotwire_context_t* context, bool enabled) {
+    if (context) context->optimize = enabled;
+}
+
+// Run the passes over the recorded program and render what survives
+static void optimize_output(diram_hotwire_context_t* context) {
+    diram_hotwire_ir_t* ir = context->ir;
+    context->pass_count = (uint32_t)diram_hotwire_ir_optimize(ir, context->pass_stats,
+                                                               HOTWIRE_MAX_PASSES);
+    context->ir = NULL;
+    if (!context->has_error) diram_hotwire_ir_render(ir, context);
+    diram_hotwire_ir_destroy(ir);
+
+    diram_hotwire_emit_asm_directive(context, "");
+    for (uint32_t i = 0; i < context->pass_count; i++) {
+        const diram_hotwire_pass_stats_t* stats = &context->pass_stats[i];
+        diram_hotwire_emit_asm_directive(context, "; peephole %s: %u -> %u instructions",
+                                         stats->name, stats->before, stats->after);
+    }
+}
+
+bool diram_hotwire_transform(diram_hotwire_context_t* context, diram_ast_node_t* ast_root) {
+    if (!context || !ast_root) return false;
+
+    // Record from the start so the visitor's header is part of the program
+    context->pass_count = 0;
+    bool jit = context->target == HOTWIRE_TARGET_NATIVE_JIT;
+    if (jit && context->ir) diram_hotwire_ir_reset(context->ir);
+    if (((context->optimize && context->target == HOTWIRE_TARGET_NATIVE_ASM) || jit) &&
+        !context->ir) {
+        context->ir = diram_hotwire_ir_create();
+        if (!context->ir) {
+            context->has_error = true;
+            snprintf(context->error_message, sizeof(context->error_message),
+                     "Out of memory recording instructions");
+            return false;
+        }
+    }
+
+    diram_ast_visitor_t* visitor = create_visitor(context);
+    if (!visitor) {
+        diram_hotwire_ir_destroy(context->ir);
+        context->ir = NULL;
+        context->has_error = true;
+        snprintf(context->error_message, sizeof(context->error_message),
+                 "Unsupported target: %s", diram_hotwire_target_to_string(context->target));
+        return false;
+    }
+
+    if (ast_root->type != AST_NODE_ROOT) {
+        diram_ast_accept(ast_root, visitor);
+    } else if (context->parallel && context->target != HOTWIRE_TARGET_WASM_BINARY &&
+               ast_root->child_count > 1) {
+        transform_parallel(context, ast_root, visitor);
+    } else {
+        for (size_t i = 0; i < ast_root->child_count && !context->has_error; i++) {
+            diram_ast_accept(ast_root->children[i], visitor);
+        }
+    }
+
+    if (context->target == HOTWIRE_TARGET_WASM) {
+        diram_hotwire_emit_wasm_instruction(context, ")");
+    } else if (context->target == HOTWIRE_TARGET_WASM_BINARY) {
+        diram_hotwire_finish_wasm_binary(visitor);
+    }
+    destroy_visitor(context, visitor);
+    if (jit) {
+        // The program stays recorded for diram_hotwire_jit_compile
+        if (context->optimize) {
+            context->pass_count = (uint32_t)diram_hotwire_ir_optimize(context->ir, context->pass_stats,
+                                                                       HOTWIRE_MAX_PASSES);
+        }
+    } else if (context->ir) {
+        optimize_output(context);
+    }
+    return !context->has_error;
+}
+
+// Output Management
+
+const char* diram_hotwire_get_output(diram_hotwire_context_t* context) {
+    return context ? context->output_buffer : NULL;
+}
+
+bool diram_hotwire_write_output(diram_hotwire_context_t* context, const char* filename) {
+    if (!context || !filename) return false;
+
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) {
+        context->has_error = true;
+        snprintf(context->error_message, sizeof(context->error_message),
+                 "Cannot open %s for writing", filename);
+        return false;
+    }
+    bool ok = fwrite(context->output_buffer, 1, context->output_size, fp) == context->output_size;
+    ok = (fclose(fp) == 0) && ok;
+    return ok;
+}
+
+// Error Handling
+
+bool diram_hotwire_has_error(const diram_hotwire_context_t* context) {
+    return context && context->has_error;
+}
+
+const char* diram_hotwire_get_error(const diram_hotwire_context_t* context) {
+    return context ? context->error_message : "no context";
+}
+
+// Utility Functions
+
+const char* diram_hotwire_target_to_string(diram_hotwire_target_t target) {
+    switch (target) {
+        case HOTWIRE_TARGET_NATIVE_ASM:  return "x86_64 assembly";
+        case HOTWIRE_TARGET_WASM:        return "WebAssembly text";
+        case HOTWIRE_TARGET_LLVM_IR:     return "LLVM IR";
+        case HOTWIRE_TARGET_RISCV:       return "RISC-V assembly";
+        case HOTWIRE_TARGET_WASM_BINARY: return "WebAssembly binary";
+        case HOTWIRE_TARGET_NATIVE_JIT:  return "x86_64 JIT";
+        default:                         return "unknown";
+    }
+}
+
+const char* diram_hotwire_mnemonic_to_string(diram_asm_mnemonic_t mnemonic) {
+    switch (mnemonic) {
+        case ASM_MV:
+        case ASM_LOAD:
+        case ASM_STORE: return "mov";
+        case ASM_ALLOC:
+        case ASM_FREE:
+        case ASM_CALL:  return "call";
+        case ASM_RET:   return "ret";
+        case ASM_JMP:   return "jmp";
+        case ASM_JZ:    return "jz";
+        case ASM_TRAP:  return "ud2";
+        default:        return "nop";
+    }
+}
@@ -0,0 +1,620 @@
+// src/core/hotwire/jit.c
+// DIRAM Hotwire JIT - encode the instruction IR to x86-64 machine code
+// OBINexus Aegis Project
+//
+// Two passes over the live IR entries. The first lays the data directives
+// out into their own mapping, so every OFFSET and load/store address is
+// known as an absolute. The second encodes instructions into a heap
+// buffer with rel32 jumps recorded as fixups; labels resolve once the
+// whole program is placed, and jumps to labels the program never defines
+// become exit stubs. Only then is the code copied into a mapping that is
+// made read+execute.
+
+#include "diram/core/hotwire/jit.h"
+#include "diram/core/hotwire/asm_ir.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct diram_hotwire_jit {
+    uint8_t* code;
+    size_t code_size;
+    size_t code_mapped;
+    uint8_t* data;
+    size_t data_mapped;
+    char** exits;               // exits[k - 1] names exit code k
+    size_t exit_count;
+};
+
+static size_t page_round(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+void diram_hotwire_jit_destroy(diram_hotwire_jit_t* jit) {
+    if (!jit) return;
+    if (jit->code) munmap(jit->code, jit->code_mapped);
+    if (jit->data) munmap(jit->data, jit->data_mapped);
+    for (size_t i = 0; i < jit->exit_count; i++) free(jit->exits[i]);
+    free(jit->exits);
+    free(jit);
+}
+
+diram_hotwire_jit_entry_t diram_hotwire_jit_entry(const diram_hotwire_jit_t* jit) {
+    if (!jit) return NULL;
+    // The code mapping is the function; no data pointer is converted
+    diram_hotwire_jit_entry_t entry;
+    void* code = jit->code;
+    memcpy(&entry, &code, sizeof(entry));
+    return entry;
+}
+
+const char* diram_hotwire_jit_exit_name(const diram_hotwire_jit_t* jit, int exit_code) {
+    if (!jit || exit_code < 0 || (size_t)exit_code > jit->exit_count) return NULL;
+    return exit_code == 0 ? "end" : jit->exits[exit_code - 1];
+}
+
+size_t diram_hotwire_jit_code_size(const diram_hotwire_jit_t* jit) {
+    return jit ? jit->code_size : 0;
+}
+
+static void jit_error(diram_hotwire_context_t* context, const char* format, ...) {
+    if (context->has_error) return;
+    context->has_error = true;
+    va_list args;
+    va_start(args, format);
+    vsnprintf(context->error_message, sizeof(context->error_message), format, args);
+    va_end(args);
+}
+
+#if defined(__x86_64__)
+
+#define JIT_EPILOGUE NULL       // Fixup name for ret
+
+typedef struct {
+    const char* name;
+    size_t offset;
+} jit_label_t;
+
+typedef struct {
+    size_t at;                  // Offset of the rel32
+    const char* name;           // Label, or JIT_EPILOGUE
+    bool exit_only;             // trap: never a program label
+} jit_fixup_t;
+
+typedef struct {
+    diram_hotwire_context_t* context;
+    const diram_hotwire_ir_t* ir;
+    const diram_hotwire_jit_symbol_t* symbols;
+    size_t symbol_count;
+
+    uint8_t* code;
+    size_t size;
+    size_t capacity;
+    bool failed;
+
+    jit_label_t* labels;        // Code labels, first definition wins
+    size_t label_count, label_capacity;
+    jit_label_t* data_labels;   // Offsets into the data mapping
+    size_t data_label_count, data_label_capacity;
+    jit_fixup_t* fixups;
+    size_t fixup_count, fixup_capacity;
+    size_t* exit_offsets;       // Stub of each exit, parallel to jit->exits
+    size_t exit_capacity;
+    bool* is_data;              // Per IR entry: a label naming data
+
+    uint8_t* data;
+    size_t data_size;
+    size_t data_capacity;
+} jit_builder_t;
+
+static bool jit_grow(jit_builder_t* builder, void** items, size_t* capacity,
+                     size_t needed, size_t item_size) {
+    if (needed <= *capacity) return true;
+    size_t grown = *capacity ? *capacity : 16;
+    while (grown < needed) grown *= 2;
+    void* resized = realloc(*items, grown * item_size);
+    if (!resized) {
+        jit_error(builder->context, "Out of memory encoding the JIT program");
+        builder->failed = true;
+        return false;
+    }
+    *items = resized;
+    *capacity = grown;
+    return true;
+}
+
+static const char* entry_string(const diram_hotwire_ir_t* ir, uint32_t offset) {
+    return offset ? ir->pool + offset : NULL;
+}
+
+static const char* skip_space(const char* text) {
+    while (*text && isspace((unsigned char)*text)) text++;
+    return text;
+}
+
+static bool starts_with(const char* text, const char* prefix) {
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+}
+
+// A decimal or 0x number, with nothing but spaces after it
+static bool parse_number(const char* text, uint64_t* value) {
+    text = skip_space(text);
+    if (!isdigit((unsigned char)*text)) return false;
+    char* end;
+    *value = strtoull(text, &end, 0);
+    return *skip_space(end) == '\0';
+}
+
+// Caller-saved general registers only, so the prologue has nothing to save
+static int register_code(const char* name) {
+    static const struct { const char* name; int code; } registers[] = {
+        { "rax", 0 }, { "rcx", 1 }, { "rdx", 2 }, { "rsi", 6 }, { "rdi", 7 },
+    };
+    for (size_t i = 0; name && i < sizeof(registers) / sizeof(registers[0]); i++) {
+        if (strcmp(name, registers[i].name) == 0) return registers[i].code;
+    }
+    return -1;
+}
+
+static const jit_label_t* find_label(const jit_label_t* labels, size_t count,
+                                     const char* name, size_t length) {
+    for (size_t i = 0; i < count; i++) {
+        if (strncmp(labels[i].name, name, length) == 0 && labels[i].name[length] == '\0') {
+            return &labels[i];
+        }
+    }
+    return NULL;
+}
+
+static void add_label(jit_builder_t* builder, jit_label_t** labels, size_t* count,
+                      size_t* capacity, const char* name, size_t offset) {
+    if (find_label(*labels, *count, name, strlen(name))) return;
+    if (!jit_grow(builder, (void**)labels, capacity, *count + 1, sizeof(jit_label_t))) return;
+    (*labels)[(*count)++] = (jit_label_t){ name, offset };
+}
+
+// Data layout
+
+static void data_bytes(jit_builder_t* builder, const void* bytes, size_t length) {
+    if (length == 0) return;
+    if (!jit_grow(builder, (void**)&builder->data, &builder->data_capacity,
+                  builder->data_size + length, 1)) {
+        return;
+    }
+    if (bytes) memcpy(builder->data + builder->data_size, bytes, length);
+    else memset(builder->data + builder->data_size, 0, length);
+    builder->data_size += length;
+}
+
+static bool is_data_directive(const char* text) {
+    return starts_with(text, ".quad") || starts_with(text, ".zero");
+}
+
+// Comments, blank lines and section/alignment directives
+static bool is_layout_only(const char* text) {
+    return *text == '\0' || *text == ';' || starts_with(text, ".section") ||
+           starts_with(text, ".align") || starts_with(text, ".text");
+}
+
+// A label names data when the next thing that takes space is .quad/.zero
+static bool label_is_data(const diram_hotwire_ir_t* ir, size_t index) {
+    for (size_t i = index + 1; i < ir->count; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead) continue;
+        if (entry->kind != HOTWIRE_IR_DIRECTIVE) return false;
+        const char* text = entry_string(ir, entry->operand1);
+        text = skip_space(text ? text : "");
+        if (is_data_directive(text)) return true;
+        if (!is_layout_only(text)) return false;
+    }
+    return false;
+}
+
+// One directive line: .align n, .quad a, b, ..., .zero n, or "name: " in
+// front of either of the last two
+static void layout_directive(jit_builder_t* builder, const char* text) {
+    text = skip_space(text);
+    const char* colon = strchr(text, ':');
+    if (colon && *text != ';' && is_data_directive(skip_space(colon + 1))) {
+        if (!jit_grow(builder, (void**)&builder->data_labels, &builder->data_label_capacity,
+                      builder->data_label_count + 1, sizeof(jit_label_t))) {
+            return;
+        }
+        // The name is the directive's own prefix; keep it terminated in a copy
+        size_t length = (size_t)(colon - text);
+        char* name = malloc(length + 1);
+        if (!name) {
+            jit_error(builder->context, "Out of memory encoding the JIT program");
+            builder->failed = true;
+            return;
+        }
+        memcpy(name, text, length);
+        name[length] = '\0';
+        builder->data_labels[builder->data_label_count++] = (jit_label_t){ name, builder->data_size };
+        text = skip_space(colon + 1);
+    }
+
+    uint64_t value;
+    if (starts_with(text, ".align")) {
+        if (parse_number(text + 6, &value) && value > 0 && value <= 4096) {
+            size_t padding = (value - builder->data_size % value) % value;
+            data_bytes(builder, NULL, padding);
+        }
+    } else if (starts_with(text, ".zero")) {
+        if (!parse_number(text + 5, &value)) {
+            jit_error(builder->context, "JIT cannot lay out \"%s\"", text);
+            builder->failed = true;
+            return;
+        }
+        data_bytes(builder, NULL, (size_t)value);
+    } else if (starts_with(text, ".quad")) {
+        char item[64];
+        for (const char* at = text + 5; *at && !builder->failed; ) {
+            const char* comma = strchr(at, ',');
+            size_t length = comma ? (size_t)(comma - at) : strlen(at);
+            if (length >= sizeof(item)) length = sizeof(item) - 1;
+            memcpy(item, at, length);
+            item[length] = '\0';
+            if (!parse_number(item, &value)) {
+                jit_error(builder->context, "JIT cannot lay out .quad value \"%s\"", item);
+                builder->failed = true;
+                return;
+            }
+            data_bytes(builder, &value, sizeof(value));
+            at = comma ? comma + 1 : at + length;
+        }
+    }
+}
+
+static void layout_data(jit_builder_t* builder) {
+    const diram_hotwire_ir_t* ir = builder->ir;
+    for (size_t i = 0; i < ir->count && !builder->failed; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        const char* text = entry_string(ir, entry->operand1);
+        if (entry->dead || !text) continue;
+        if (entry->kind == HOTWIRE_IR_LABEL && label_is_data(ir, i)) {
+            builder->is_data[i] = true;
+            // Copied, like the names split off "name: .quad" lines
+            char* name = strdup(text);
+            if (!name) {
+                jit_error(builder->context, "Out of memory encoding the JIT program");
+                builder->failed = true;
+                return;
+            }
+            if (find_label(builder->data_labels, builder->data_label_count, name, strlen(name)) ||
+                !jit_grow(builder, (void**)&builder->data_labels, &builder->data_label_capacity,
+                          builder->data_label_count + 1, sizeof(jit_label_t))) {
+                free(name);
+                continue;
+            }
+            builder->data_labels[builder->data_label_count++] = (jit_label_t){ name, builder->data_size };
+        } else if (entry->kind == HOTWIRE_IR_DIRECTIVE) {
+            layout_directive(builder, text);
+        }
+    }
+}
+
+// "label" or "label+offset" in the data mapping
+static bool data_address(jit_builder_t* builder, const char* text, uint64_t* address) {
+    if (!text || !builder->data) return false;
+    const char* plus = strchr(text, '+');
+    size_t length = plus ? (size_t)(plus - text) : strlen(text);
+    const jit_label_t* label = find_label(builder->data_labels, builder->data_label_count,
+                                          text, length);
+    uint64_t offset = 0;
+    if (!label || (plus && !parse_number(plus + 1, &offset))) return false;
+    *address = (uint64_t)(uintptr_t)builder->data + label->offset + offset;
+    return true;
+}
+
+// Encoding
+
+static void emit(jit_builder_t* builder, const void* bytes, size_t length) {
+    if (!jit_grow(builder, (void**)&builder->code, &builder->capacity,
+                  builder->size + length, 1)) {
+        return;
+    }
+    memcpy(builder->code + builder->size, bytes, length);
+    builder->size += length;
+}
+
+#define EMIT(builder, ...) do { \
+    const uint8_t bytes_[] = { __VA_ARGS__ }; \
+    emit(builder, bytes_, sizeof(bytes_)); \
+} while (0)
+
+// mov reg, imm: 5 bytes when it zero-extends from 32 bits, else 10
+static void emit_mov_imm(jit_builder_t* builder, int reg, uint64_t value) {
+    if (value <= UINT32_MAX) {
+        uint32_t imm = (uint32_t)value;
+        EMIT(builder, (uint8_t)(0xB8 + reg));
+        emit(builder, &imm, sizeof(imm));
+    } else {
+        EMIT(builder, 0x48, (uint8_t)(0xB8 + reg));
+        emit(builder, &value, sizeof(value));
+    }
+}
+
+// mov r11, imm64
+static void emit_mov_r11(jit_builder_t* builder, uint64_t value) {
+    EMIT(builder, 0x49, 0xBB);
+    emit(builder, &value, sizeof(value));
+}
+
+// A jump's rel32, resolved once every label is placed
+static void emit_fixup(jit_builder_t* builder, const char* name, bool exit_only) {
+    if (!jit_grow(builder, (void**)&builder->fixups, &builder->fixup_capacity,
+                  builder->fixup_count + 1, sizeof(jit_fixup_t))) {
+        return;
+    }
+    builder->fixups[builder->fixup_count++] = (jit_fixup_t){ builder->size, name, exit_only };
+    EMIT(builder, 0, 0, 0, 0);
+}
+
+static void patch_rel32(jit_builder_t* builder, size_t at, size_t target) {
+    int32_t rel = (int32_t)((int64_t)target - (int64_t)(at + 4));
+    memcpy(builder->code + at, &rel, sizeof(rel));
+}
+
+static const diram_hotwire_jit_symbol_t* find_symbol(const jit_builder_t* builder, const char* name) {
+    for (size_t i = 0; name && i < builder->symbol_count; i++) {
+        if (strcmp(builder->symbols[i].name, name) == 0) return &builder->symbols[i];
+    }
+    return NULL;
+}
+
+static void encode_instruction(jit_builder_t* builder, const diram_hotwire_ir_entry_t* entry) {
+    const char* op = diram_hotwire_mnemonic_to_string(entry->mnemonic);
+    const char* operand1 = entry_string(builder->ir, entry->operand1);
+    const char* operand2 = entry_string(builder->ir, entry->operand2);
+    int reg = register_code(operand1);
+    uint64_t value;
+
+    switch (entry->mnemonic) {
+        case ASM_MV:
+            if (reg >= 0 && operand2 && parse_number(operand2, &value)) {
+                emit_mov_imm(builder, reg, value);
+                return;
+            }
+            if (reg >= 0 && operand2 && starts_with(operand2, "OFFSET ") &&
+                data_address(builder, skip_space(operand2 + 7), &value)) {
+                emit_mov_imm(builder, reg, value);
+                return;
+            }
+            if (reg >= 0 && register_code(operand2) >= 0) {
+                // mov reg, reg2
+                EMIT(builder, 0x48, 0x89, (uint8_t)(0xC0 | register_code(operand2) << 3 | reg));
+                return;
+            }
+            break;
+
+        case ASM_LOAD:
+        case ASM_STORE:
+            if (reg >= 0 && data_address(builder, operand2, &value)) {
+                // mov r11, address; mov reg, [r11] or mov [r11], reg
+                emit_mov_r11(builder, value);
+                EMIT(builder, 0x49, entry->mnemonic == ASM_LOAD ? 0x8B : 0x89,
+                     (uint8_t)(reg << 3 | 3));
+                return;
+            }
+            break;
+
+        case ASM_CALL: {
+            const diram_hotwire_jit_symbol_t* symbol = find_symbol(builder, operand1);
+            if (!symbol) {
+                jit_error(builder->context, "JIT: unresolved symbol %s",
+                          operand1 ? operand1 : "(none)");
+                builder->failed = true;
+                return;
+            }
+            uint64_t target;
+            memcpy(&target, &symbol->fn, sizeof(target));
+            EMIT(builder, 0x4D, 0x89, 0xE0);            // mov r8, r12 (env)
+            emit_mov_r11(builder, target);
+            EMIT(builder, 0x41, 0xFF, 0xD3);            // call r11
+            return;
+        }
+
+        case ASM_JZ:
+            if (!operand1) break;
+            EMIT(builder, 0x48, 0x85, 0xC0);            // test rax, rax
+            EMIT(builder, 0x0F, 0x84);                  // jz rel32
+            emit_fixup(builder, operand1, false);
+            return;
+
+        case ASM_JMP:
+            if (!operand1) break;
+            EMIT(builder, 0xE9);
+            emit_fixup(builder, operand1, false);
+            return;
+
+        case ASM_RET:
+            EMIT(builder, 0x31, 0xC0, 0xE9);            // xor eax, eax; jmp epilogue
+            emit_fixup(builder, JIT_EPILOGUE, false);
+            return;
+
+        case ASM_TRAP:
+            EMIT(builder, 0xE9);
+            emit_fixup(builder, "trap", true);
+            return;
+
+        default:
+            break;
+    }
+
+    jit_error(builder->context, "JIT cannot encode %s%s%s%s%s", op,
+              operand1 ? " " : "", operand1 ? operand1 : "",
+              operand2 ? ", " : "", operand2 ? operand2 : "");
+    builder->failed = true;
+}
+
+static void encode_program(jit_builder_t* builder) {
+    const diram_hotwire_ir_t* ir = builder->ir;
+
+    // push r12; mov r12, rdi (env); clear the argument registers. One push
+    // leaves rsp 16-byte aligned for the calls.
+    EMIT(builder, 0x41, 0x54, 0x49, 0x89, 0xFC);
+    EMIT(builder, 0x31, 0xFF, 0x31, 0xF6, 0x31, 0xD2, 0x31, 0xC9, 0x31, 0xC0);
+
+    for (size_t i = 0; i < ir->count && !builder->failed; i++) {
+        const diram_hotwire_ir_entry_t* entry = &ir->entries[i];
+        if (entry->dead) continue;
+        if (entry->kind == HOTWIRE_IR_LABEL && !builder->is_data[i] && entry->operand1) {
+            add_label(builder, &builder->labels, &builder->label_count, &builder->label_capacity,
+                      entry_string(ir, entry->operand1), builder->size);
+        } else if (entry->kind == HOTWIRE_IR_INSN) {
+            encode_instruction(builder, entry);
+        }
+    }
+}
+
+// Falling off the end returns 0; exit k sets eax = k on its way out
+static diram_hotwire_jit_t* link_program(jit_builder_t* builder, diram_hotwire_jit_t* jit) {
+    EMIT(builder, 0x31, 0xC0);                          // xor eax, eax
+    size_t epilogue = builder->size;
+    EMIT(builder, 0x41, 0x5C, 0xC3);                    // pop r12; ret
+
+    for (size_t i = 0; i < builder->fixup_count && !builder->failed; i++) {
+        jit_fixup_t* fixup = &builder->fixups[i];
+        if (fixup->name == JIT_EPILOGUE) {
+            patch_rel32(builder, fixup->at, epilogue);
+            continue;
+        }
+        const jit_label_t* label = fixup->exit_only ? NULL :
+            find_label(builder->labels, builder->label_count, fixup->name, strlen(fixup->name));
+        if (label) {
+            patch_rel32(builder, fixup->at, label->offset);
+            continue;
+        }
+
+        // One stub per distinct exit name
+        size_t k = 0;
+        while (k < jit->exit_count && strcmp(jit->exits[k], fixup->name) != 0) k++;
+        if (k == jit->exit_count) {
+            char* name = strdup(fixup->name);
+            char** exits = name ? realloc(jit->exits, (k + 1) * sizeof(char*)) : NULL;
+            if (exits) jit->exits = exits;
+            if (!exits || !jit_grow(builder, (void**)&builder->exit_offsets,
+                                    &builder->exit_capacity, k + 1, sizeof(size_t))) {
+                free(name);
+                jit_error(builder->context, "Out of memory encoding the JIT program");
+                builder->failed = true;
+                break;
+            }
+            jit->exits[jit->exit_count++] = name;
+            builder->exit_offsets[k] = builder->size;
+            uint32_t code = (uint32_t)(k + 1);
+            EMIT(builder, 0xB8);                        // mov eax, k; jmp epilogue
+            emit(builder, &code, sizeof(code));
+            EMIT(builder, 0xE9, 0, 0, 0, 0);
+            if (builder->failed) break;
+            patch_rel32(builder, builder->size - 4, epilogue);
+        }
+        patch_rel32(builder, fixup->at, builder->exit_offsets[k]);
+    }
+    if (builder->failed) return NULL;
+
+    // Written while read+write, then sealed; never both writable and executable
+    jit->code_size = builder->size;
+    jit->code_mapped = page_round(builder->size);
+    void* code = mmap(NULL, jit->code_mapped, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        jit_error(builder->context, "JIT: cannot map %zu bytes of code", jit->code_mapped);
+        return NULL;
+    }
+    memcpy(code, builder->code, builder->size);
+    if (mprotect(code, jit->code_mapped, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code, jit->code_mapped);
+        jit_error(builder->context, "JIT: cannot make code executable");
+        return NULL;
+    }
+    jit->code = code;
+    return jit;
+}
+
+static void builder_release(jit_builder_t* builder) {
+    free(builder->code);
+    free(builder->labels);
+    for (size_t i = 0; i < builder->data_label_count; i++) {
+        free((char*)builder->data_labels[i].name);
+    }
+    free(builder->data_labels);
+    free(builder->fixups);
+    free(builder->exit_offsets);
+    free(builder->is_data);
+    free(builder->data);
+}
+
+diram_hotwire_jit_t* diram_hotwire_jit_compile(diram_hotwire_context_t* context,
+                                               const diram_hotwire_jit_symbol_t* symbols,
+                                               size_t symbol_count) {
+    if (!context) return NULL;
+    if (context->has_error) return NULL;
+    if (context->target != HOTWIRE_TARGET_NATIVE_JIT || !context->ir) {
+        jit_error(context, "JIT: no recorded program; transform a %s context first",
+                  diram_hotwire_target_to_string(HOTWIRE_TARGET_NATIVE_JIT));
+        return NULL;
+    }
+    if (context->ir->failed) {
+        jit_error(context, "Out of memory recording instructions");
+        return NULL;
+    }
+
+    jit_builder_t builder = {
+        .context = context,
+        .ir = context->ir,
+        .symbols = symbols,
+        .symbol_count = symbols ? symbol_count : 0,
+        .is_data = calloc(context->ir->count + 1, sizeof(bool)),
+    };
+    diram_hotwire_jit_t* jit = calloc(1, sizeof(diram_hotwire_jit_t));
+    if (!jit || !builder.is_data) {
+        free(jit);
+        free(builder.is_data);
+        jit_error(context, "Out of memory encoding the JIT program");
+        return NULL;
+    }
+
+    // Data first, so the code can embed its addresses
+    layout_data(&builder);
+    if (!builder.failed && builder.data_size > 0) {
+        jit->data_mapped = page_round(builder.data_size);
+        void* data = mmap(NULL, jit->data_mapped, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            jit_error(context, "JIT: cannot map %zu bytes of data", jit->data_mapped);
+            builder.failed = true;
+        } else {
+            memcpy(data, builder.data, builder.data_size);
+            jit->data = data;
+            free(builder.data);
+            builder.data = data;
+        }
+    }
+    if (!builder.failed) encode_program(&builder);
+
+    diram_hotwire_jit_t* result = builder.failed ? NULL : link_program(&builder, jit);
+    if (builder.data == jit->data) builder.data = NULL;
+    builder_release(&builder);
+    if (!result) diram_hotwire_jit_destroy(jit);
+    return result;
+}
+
+#else
+
+diram_hotwire_jit_t* diram_hotwire_jit_compile(diram_hotwire_context_t* context,
+                                               const diram_hotwire_jit_symbol_t* symbols,
+                                               size_t symbol_count) {
+    (void)symbols;
+    (void)symbol_count;
+    if (context) jit_error(context, "JIT: this host is not x86-64");
+    return NULL;
+}
+
+#endif
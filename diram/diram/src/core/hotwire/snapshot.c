@@ -0,0 +1,700 @@
+// src/core/hotwire/snapshot.c
+// DIRAM compiled manifest snapshots - build, validate, map
+// OBINexus Aegis Project
+//
+// Layout: header, node records, uint32 links, string table, hotwire
+// output. Each section is 8-byte aligned. Offset 0 of the string table
+// is the empty string, and the table ends in a NUL, so checking that
+// every offset is in range is enough to make every string safe to read.
+
+#include "diram/core/hotwire/snapshot.h"
+#include "diram/core/parser/parser.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNAPSHOT_ALIGN(x) (((x) + 7) & ~(uint64_t)7)
+#define SNAPSHOT_NONE DIRAM_AST_NO_RANGE
+
+static __thread char t_error[256];
+
+static void set_error(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(t_error, sizeof(t_error), format, args);
+    va_end(args);
+}
+
+const char* diram_snapshot_error(void) {
+    return t_error;
+}
+
+// FNV-1a over 64-bit words: one multiply per 8 bytes keeps validation
+// far below the cost of the parse it replaces
+static uint64_t checksum(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    for (; i < size; i++) hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+// Build
+
+typedef struct {
+    uint8_t* data;
+    const diram_ast_node_t* nodes;
+    size_t node_count;
+    diram_snapshot_node_t* records;
+    uint32_t* links;
+    uint32_t link_tail;
+    char* strings;
+    uint32_t string_tail;
+} image_builder_t;
+
+static void string_size(const char* text, uint64_t* total) {
+    if (text && *text) *total += strlen(text) + 1;
+}
+
+static uint32_t add_string(image_builder_t* builder, const char* text) {
+    if (!text || !*text) return 0;
+    size_t length = strlen(text) + 1;
+    uint32_t offset = builder->string_tail;
+    memcpy(builder->strings + offset, text, length);
+    builder->string_tail += (uint32_t)length;
+    return offset;
+}
+
+static uint32_t node_index(const image_builder_t* builder, const diram_ast_node_t* node) {
+    if (!node || node < builder->nodes || node >= builder->nodes + builder->node_count) {
+        return SNAPSHOT_NONE;
+    }
+    return (uint32_t)(node - builder->nodes);
+}
+
+// Sizes of the variable sections; false if the tree is not one compacted arena
+static bool measure_tree(const diram_ast_node_t* root, uint64_t* links, uint64_t* strings) {
+    const diram_ast_arena_t* arena = root->arena;
+    if (!arena || arena->nodes != root || arena->node_count >= SNAPSHOT_NONE) return false;
+
+    *links = 0;
+    *strings = 1;
+    for (size_t i = 0; i < arena->node_count; i++) {
+        const diram_ast_node_t* node = &arena->nodes[i];
+        if (node->first_child == DIRAM_AST_NO_RANGE) return false;
+        switch (node->type) {
+            case AST_NODE_ALLOCATION:
+                string_size(node->data.allocation.tag, strings);
+                string_size(node->data.allocation.sha256_receipt, strings);
+                break;
+            case AST_NODE_OPCODE:
+                string_size(node->data.opcode.name, strings);
+                *links += node->data.opcode.operand_count;
+                break;
+            case AST_NODE_CONSTRAINT:
+                string_size(node->data.constraint.name, strings);
+                break;
+            case AST_NODE_POLICY:
+                string_size(node->data.policy.name, strings);
+                string_size(node->data.policy.type, strings);
+                *links += node->data.policy.rule_count;
+                for (size_t r = 0; r < node->data.policy.rule_count; r++) {
+                    string_size(node->data.policy.rules[r], strings);
+                }
+                break;
+            case AST_NODE_FEATURE_TOGGLE:
+                string_size(node->data.feature.name, strings);
+                string_size(node->data.feature.description, strings);
+                string_size(node->data.feature.policy, strings);
+                break;
+            case AST_NODE_MEMORY_REGION:
+                string_size(node->data.memory_region.name, strings);
+                break;
+            case AST_NODE_OPERAND:
+                string_size(node->data.operand.name, strings);
+                string_size(node->data.operand.type, strings);
+                break;
+            case AST_NODE_BUILD_TARGET:
+                string_size(node->data.build_target.name, strings);
+                string_size(node->data.build_target.platform, strings);
+                string_size(node->data.build_target.compiler, strings);
+                string_size(node->data.build_target.flags, strings);
+                break;
+            case AST_NODE_ROOT:
+                break;
+        }
+    }
+    return *strings < SNAPSHOT_NONE;
+}
+
+static bool build_record(image_builder_t* builder, const diram_ast_node_t* node,
+                         diram_snapshot_node_t* record) {
+    memset(record, 0, sizeof(*record));
+    record->type = (uint32_t)node->type;
+    record->parent = node_index(builder, node->parent);
+    record->first_child = node->first_child;
+    record->child_count = (uint32_t)node->child_count;
+    record->first_link = builder->link_tail;
+
+    switch (node->type) {
+        case AST_NODE_ALLOCATION:
+            record->name = add_string(builder, node->data.allocation.tag);
+            record->text1 = add_string(builder, node->data.allocation.sha256_receipt);
+            record->value1 = node->data.allocation.size;
+            record->value2 = node->data.allocation.address;
+            break;
+        case AST_NODE_OPCODE:
+            record->name = add_string(builder, node->data.opcode.name);
+            record->value1 = node->data.opcode.code;
+            for (size_t i = 0; i < node->data.opcode.operand_count; i++) {
+                uint32_t operand = node_index(builder, node->data.opcode.operands[i]);
+                if (operand == SNAPSHOT_NONE) return false;
+                builder->links[builder->link_tail++] = operand;
+            }
+            break;
+        case AST_NODE_CONSTRAINT:
+            record->name = add_string(builder, node->data.constraint.name);
+            record->real = node->data.constraint.epsilon_value;
+            record->value1 = node->data.constraint.max_heap_events;
+            break;
+        case AST_NODE_POLICY:
+            record->name = add_string(builder, node->data.policy.name);
+            record->text1 = add_string(builder, node->data.policy.type);
+            record->flags = node->data.policy.enforced;
+            for (size_t i = 0; i < node->data.policy.rule_count; i++) {
+                builder->links[builder->link_tail++] = add_string(builder, node->data.policy.rules[i]);
+            }
+            break;
+        case AST_NODE_FEATURE_TOGGLE:
+            record->name = add_string(builder, node->data.feature.name);
+            record->text1 = add_string(builder, node->data.feature.description);
+            record->text2 = add_string(builder, node->data.feature.policy);
+            record->flags = node->data.feature.enabled;
+            break;
+        case AST_NODE_MEMORY_REGION:
+            record->name = add_string(builder, node->data.memory_region.name);
+            record->value1 = node->data.memory_region.base_address;
+            record->value2 = node->data.memory_region.size;
+            record->flags = node->data.memory_region.protection_flags;
+            break;
+        case AST_NODE_OPERAND:
+            record->name = add_string(builder, node->data.operand.name);
+            record->text1 = add_string(builder, node->data.operand.type);
+            record->value1 = node->data.operand.position;
+            break;
+        case AST_NODE_BUILD_TARGET:
+            record->name = add_string(builder, node->data.build_target.name);
+            record->text1 = add_string(builder, node->data.build_target.platform);
+            record->text2 = add_string(builder, node->data.build_target.compiler);
+            record->text3 = add_string(builder, node->data.build_target.flags);
+            break;
+        case AST_NODE_ROOT:
+            break;
+    }
+    record->link_count = builder->link_tail - record->first_link;
+    return true;
+}
+
+static uint8_t* build_image(const uint8_t source_hash[32], const diram_ast_node_t* root,
+                            const diram_hotwire_context_t* context, size_t* image_size) {
+    uint64_t link_count, strings_size;
+    if (!root || !measure_tree(root, &link_count, &strings_size)) {
+        set_error("Snapshots need a compacted arena tree");
+        return NULL;
+    }
+
+    diram_snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DIRAM_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = DIRAM_SNAPSHOT_VERSION;
+    header.byte_order = DIRAM_SNAPSHOT_BYTE_ORDER;
+    header.header_size = sizeof(diram_snapshot_header_t);
+    header.node_size = sizeof(diram_snapshot_node_t);
+    memcpy(header.source_hash, source_hash, sizeof(header.source_hash));
+    header.target = (uint32_t)context->target;
+    header.node_count = root->arena->node_count;
+    header.nodes_offset = SNAPSHOT_ALIGN(sizeof(header));
+    header.link_count = link_count;
+    header.links_offset = SNAPSHOT_ALIGN(header.nodes_offset + header.node_count * sizeof(diram_snapshot_node_t));
+    header.strings_size = strings_size;
+    header.strings_offset = SNAPSHOT_ALIGN(header.links_offset + link_count * sizeof(uint32_t));
+    header.output_size = context->output_size;
+    header.output_offset = SNAPSHOT_ALIGN(header.strings_offset + strings_size);
+    header.file_size = SNAPSHOT_ALIGN(header.output_offset + header.output_size);
+
+    uint8_t* data = calloc(1, header.file_size);
+    if (!data) {
+        set_error("Out of memory building a %llu byte snapshot", (unsigned long long)header.file_size);
+        return NULL;
+    }
+
+    image_builder_t builder = {
+        .data = data,
+        .nodes = root,
+        .node_count = header.node_count,
+        .records = (diram_snapshot_node_t*)(data + header.nodes_offset),
+        .links = (uint32_t*)(data + header.links_offset),
+        .strings = (char*)(data + header.strings_offset),
+        .string_tail = 1
+    };
+    for (size_t i = 0; i < builder.node_count; i++) {
+        if (!build_record(&builder, &root[i], &builder.records[i])) {
+            set_error("Operand of node %zu is outside the arena", i);
+            free(data);
+            return NULL;
+        }
+    }
+    if (header.output_size) memcpy(data + header.output_offset, context->output_buffer, header.output_size);
+
+    header.checksum = checksum(data + sizeof(header), header.file_size - sizeof(header));
+    memcpy(data, &header, sizeof(header));
+    *image_size = header.file_size;
+    return data;
+}
+
+// Write to a temporary file and rename it over path, so a reader sees
+// either the old snapshot or the whole new one. There is no fsync: a
+// torn file after a crash fails the checksum and is rebuilt.
+static int write_image(const char* path, const uint8_t* data, size_t size) {
+    char temp_path[PATH_MAX];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp.%ld", path, (long)getpid()) >= (int)sizeof(temp_path)) {
+        set_error("Snapshot path too long: %s", path);
+        return -1;
+    }
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        set_error("Cannot create %s: %s", temp_path, strerror(errno));
+        return -1;
+    }
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = write(fd, data + written, size - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            set_error("Cannot write %s: %s", temp_path, strerror(errno));
+            close(fd);
+            unlink(temp_path);
+            return -1;
+        }
+        written += (size_t)n;
+    }
+    if (close(fd) != 0 || rename(temp_path, path) != 0) {
+        set_error("Cannot replace %s: %s", path, strerror(errno));
+        unlink(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int diram_snapshot_write(const char* path, const uint8_t source_hash[32],
+                         const diram_ast_node_t* root,
+                         const diram_hotwire_context_t* context) {
+    if (!path || !source_hash || !context) {
+        set_error("Invalid snapshot arguments");
+        return -1;
+    }
+    size_t size;
+    uint8_t* data = build_image(source_hash, root, context, &size);
+    if (!data) return -1;
+    int result = write_image(path, data, size);
+    free(data);
+    return result;
+}
+
+// Validate
+
+static bool section_fits(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset && (offset & 7) == 0;
+}
+
+static bool validate_records(const diram_snapshot_t* snapshot) {
+    const diram_snapshot_header_t* header = snapshot->header;
+    uint64_t nodes = header->node_count;
+    uint64_t strings = header->strings_size;
+
+    if (nodes == 0 || snapshot->nodes[0].type != AST_NODE_ROOT) return false;
+    for (uint64_t i = 0; i < nodes; i++) {
+        const diram_snapshot_node_t* node = &snapshot->nodes[i];
+        if (node->type > AST_NODE_BUILD_TARGET) return false;
+        if (node->parent != SNAPSHOT_NONE && node->parent >= nodes) return false;
+        if ((uint64_t)node->first_child + node->child_count > nodes) return false;
+        if ((uint64_t)node->first_link + node->link_count > header->link_count) return false;
+        if (node->name >= strings || node->text1 >= strings ||
+            node->text2 >= strings || node->text3 >= strings) return false;
+
+        uint64_t limit = node->type == AST_NODE_OPCODE ? nodes : strings;
+        for (uint32_t l = 0; l < node->link_count; l++) {
+            if (snapshot->links[node->first_link + l] >= limit) return false;
+        }
+    }
+    return true;
+}
+
+static bool validate_image(diram_snapshot_t* snapshot, const char* path) {
+    const diram_snapshot_header_t* header = (const diram_snapshot_header_t*)snapshot->base;
+    size_t size = snapshot->size;
+
+    if (size < sizeof(*header) || memcmp(header->magic, DIRAM_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        set_error("%s: not a DIRAM snapshot", path);
+        return false;
+    }
+    if (header->version != DIRAM_SNAPSHOT_VERSION || header->byte_order != DIRAM_SNAPSHOT_BYTE_ORDER ||
+        header->header_size != sizeof(*header) || header->node_size != sizeof(diram_snapshot_node_t)) {
+        set_error("%s: snapshot version %u is not supported", path, header->version);
+        return false;
+    }
+    if (header->file_size != size ||
+        header->node_count > size / sizeof(diram_snapshot_node_t) ||
+        header->link_count > size / sizeof(uint32_t) ||
+        !section_fits(header->nodes_offset, header->node_count * sizeof(diram_snapshot_node_t), size) ||
+        !section_fits(header->links_offset, header->link_count * sizeof(uint32_t), size) ||
+        !section_fits(header->strings_offset, header->strings_size, size) ||
+        !section_fits(header->output_offset, header->output_size, size) ||
+        header->strings_size == 0 || header->strings_size >= SNAPSHOT_NONE) {
+        set_error("%s: snapshot sections are out of bounds", path);
+        return false;
+    }
+    if (checksum(snapshot->base + sizeof(*header), size - sizeof(*header)) != header->checksum) {
+        set_error("%s: snapshot checksum mismatch", path);
+        return false;
+    }
+
+    snapshot->header = header;
+    snapshot->nodes = (const diram_snapshot_node_t*)(snapshot->base + header->nodes_offset);
+    snapshot->links = (const uint32_t*)(snapshot->base + header->links_offset);
+    snapshot->strings = (const char*)(snapshot->base + header->strings_offset);
+    if (snapshot->strings[0] != '\0' || snapshot->strings[header->strings_size - 1] != '\0' ||
+        !validate_records(snapshot)) {
+        set_error("%s: snapshot records are corrupt", path);
+        return false;
+    }
+    return true;
+}
+
+static diram_snapshot_t* snapshot_from_image(const uint8_t* data, size_t size, bool mapped,
+                                             const char* path) {
+    diram_snapshot_t* snapshot = calloc(1, sizeof(diram_snapshot_t));
+    if (!snapshot) {
+        set_error("Out of memory");
+        return NULL;
+    }
+    snapshot->base = data;
+    snapshot->size = size;
+    snapshot->mapped = mapped;
+    if (!validate_image(snapshot, path)) {
+        diram_snapshot_close(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+// Open
+
+diram_snapshot_t* diram_snapshot_open(const char* path) {
+    if (!path) {
+        set_error("No snapshot path");
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        set_error("Cannot open %s: %s", path, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(diram_snapshot_header_t)) {
+        set_error("%s: not a DIRAM snapshot", path);
+        close(fd);
+        return NULL;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        set_error("Cannot map %s: %s", path, strerror(errno));
+        return NULL;
+    }
+    return snapshot_from_image(data, (size_t)st.st_size, true, path);
+}
+
+bool diram_snapshot_matches(const diram_snapshot_t* snapshot, const uint8_t source_hash[32],
+                            diram_hotwire_target_t target) {
+    return snapshot && source_hash &&
+           snapshot->header->target == (uint32_t)target &&
+           memcmp(snapshot->header->source_hash, source_hash, sizeof(snapshot->header->source_hash)) == 0;
+}
+
+void diram_snapshot_close(diram_snapshot_t* snapshot) {
+    if (!snapshot) return;
+    if (snapshot->mapped) {
+        munmap((void*)snapshot->base, snapshot->size);
+    } else {
+        free((void*)snapshot->base);
+    }
+    free(snapshot);
+}
+
+// Compile
+
+static const uint8_t* map_source(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        set_error("Cannot open %s: %s", path, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        set_error("%s: empty manifest", path);
+        close(fd);
+        return NULL;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        set_error("Cannot map %s: %s", path, strerror(errno));
+        return NULL;
+    }
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+    *size = (size_t)st.st_size;
+    return data;
+}
+
+// Parse and transform source into a snapshot image
+static uint8_t* compile_image(const char* source_path, const uint8_t* source, size_t source_size,
+                              const uint8_t source_hash[32], diram_hotwire_target_t target,
+                              size_t* image_size) {
+    uint8_t* image = NULL;
+    diram_parser_t* parser = diram_parser_create((const char*)source, source_size);
+    diram_hotwire_context_t* context = diram_hotwire_create(target);
+    if (!parser || !context) {
+        set_error("Out of memory compiling %s", source_path);
+    } else {
+        diram_ast_node_t* root = diram_parser_parse(parser);
+        if (!root) {
+            set_error("%s: %s", source_path, diram_parser_get_error(parser));
+        } else if (!diram_hotwire_transform(context, root)) {
+            set_error("%s: %s", source_path, diram_hotwire_get_error(context));
+        } else {
+            image = build_image(source_hash, root, context, image_size);
+        }
+    }
+    diram_hotwire_destroy(context);
+    diram_parser_destroy(parser);
+    return image;
+}
+
+diram_snapshot_t* diram_snapshot_compile(const char* source_path, const char* snapshot_path,
+                                         diram_hotwire_target_t target,
+                                         diram_snapshot_status_t* status) {
+    if (!source_path) {
+        set_error("No manifest path");
+        return NULL;
+    }
+    char default_path[PATH_MAX];
+    if (!snapshot_path) {
+        if (snprintf(default_path, sizeof(default_path), "%s%s",
+                     source_path, DIRAM_SNAPSHOT_SUFFIX) >= (int)sizeof(default_path)) {
+            set_error("Manifest path too long: %s", source_path);
+            return NULL;
+        }
+        snapshot_path = default_path;
+    }
+
+    size_t source_size;
+    const uint8_t* source = map_source(source_path, &source_size);
+    if (!source) return NULL;
+    uint8_t source_hash[DIRAM_SHA256_DIGEST_LEN];
+    diram_sha256(source, source_size, source_hash);
+
+    diram_snapshot_t* snapshot = diram_snapshot_open(snapshot_path);
+    if (snapshot && diram_snapshot_matches(snapshot, source_hash, target)) {
+        munmap((void*)source, source_size);
+        if (status) *status = DIRAM_SNAPSHOT_HIT;
+        return snapshot;
+    }
+    diram_snapshot_close(snapshot);
+
+    size_t image_size = 0;
+    uint8_t* image = compile_image(source_path, source, source_size, source_hash, target, &image_size);
+    munmap((void*)source, source_size);
+    if (!image) return NULL;
+
+    // Serve the saved file so the pages are shared with other processes
+    if (write_image(snapshot_path, image, image_size) == 0) {
+        snapshot = diram_snapshot_open(snapshot_path);
+        if (snapshot) {
+            free(image);
+            if (status) *status = DIRAM_SNAPSHOT_REBUILT;
+            return snapshot;
+        }
+    }
+    if (status) *status = DIRAM_SNAPSHOT_UNSAVED;
+    return snapshot_from_image(image, image_size, false, snapshot_path);
+}
+
+// Accessors
+
+const char* diram_snapshot_string(const diram_snapshot_t* snapshot, uint32_t offset) {
+    if (!snapshot || offset == 0 || offset >= snapshot->header->strings_size) return NULL;
+    return snapshot->strings + offset;
+}
+
+const uint8_t* diram_snapshot_output(const diram_snapshot_t* snapshot, size_t* size) {
+    if (!snapshot) return NULL;
+    if (size) *size = snapshot->header->output_size;
+    return snapshot->base + snapshot->header->output_offset;
+}
+
+const diram_snapshot_node_t* diram_snapshot_find(const diram_snapshot_t* snapshot,
+                                                 diram_ast_node_type_t type, const char* name) {
+    if (!snapshot || !name) return NULL;
+    for (uint64_t i = 0; i < snapshot->header->node_count; i++) {
+        const diram_snapshot_node_t* node = &snapshot->nodes[i];
+        if (node->type != (uint32_t)type || node->name == 0) continue;
+        if (strcmp(snapshot->strings + node->name, name) == 0) return node;
+    }
+    return NULL;
+}
+
+// Load
+
+static void load_record(const diram_snapshot_t* snapshot, const diram_snapshot_node_t* record,
+                        diram_ast_node_t* node) {
+    const char* name = diram_snapshot_string(snapshot, record->name);
+    const char* text1 = diram_snapshot_string(snapshot, record->text1);
+    const char* text2 = diram_snapshot_string(snapshot, record->text2);
+    const char* text3 = diram_snapshot_string(snapshot, record->text3);
+
+    switch (node->type) {
+        case AST_NODE_ALLOCATION:
+            node->data.allocation.tag = name;
+            node->data.allocation.size = (size_t)record->value1;
+            node->data.allocation.address = record->value2;
+            snprintf(node->data.allocation.sha256_receipt,
+                     sizeof(node->data.allocation.sha256_receipt), "%s", text1 ? text1 : "");
+            break;
+        case AST_NODE_OPCODE:
+            node->data.opcode.name = name;
+            node->data.opcode.code = (uint8_t)record->value1;
+            break;
+        case AST_NODE_CONSTRAINT:
+            node->data.constraint.name = name;
+            node->data.constraint.epsilon_value = record->real;
+            node->data.constraint.max_heap_events = (uint32_t)record->value1;
+            break;
+        case AST_NODE_POLICY:
+            node->data.policy.name = name;
+            node->data.policy.type = text1;
+            node->data.policy.enforced = record->flags != 0;
+            break;
+        case AST_NODE_FEATURE_TOGGLE:
+            node->data.feature.name = name;
+            node->data.feature.description = text1;
+            node->data.feature.policy = text2;
+            node->data.feature.enabled = record->flags != 0;
+            break;
+        case AST_NODE_MEMORY_REGION:
+            node->data.memory_region.name = name;
+            node->data.memory_region.base_address = record->value1;
+            node->data.memory_region.size = (size_t)record->value2;
+            node->data.memory_region.protection_flags = (uint8_t)record->flags;
+            break;
+        case AST_NODE_OPERAND:
+            node->data.operand.name = name;
+            node->data.operand.type = text1;
+            node->data.operand.position = (uint32_t)record->value1;
+            break;
+        case AST_NODE_BUILD_TARGET:
+            node->data.build_target.name = name;
+            node->data.build_target.platform = text1;
+            node->data.build_target.compiler = text2;
+            node->data.build_target.flags = text3;
+            break;
+        case AST_NODE_ROOT:
+            break;
+    }
+}
+
+static diram_ast_node_t** load_run(diram_ast_arena_t* arena, diram_ast_node_t** made,
+                                   diram_ast_node_t* parent, uint32_t first, uint32_t count) {
+    if (count == 0) return NULL;
+    diram_ast_node_t** run = diram_ast_arena_alloc(arena, count * sizeof(diram_ast_node_t*));
+    if (!run) return NULL;
+    for (uint32_t i = 0; i < count; i++) {
+        run[i] = made[first + i];
+        run[i]->parent = parent;
+    }
+    return run;
+}
+
+diram_ast_node_t* diram_snapshot_load_tree(const diram_snapshot_t* snapshot,
+                                           diram_ast_arena_t* arena) {
+    if (!snapshot || !arena) {
+        set_error("Invalid snapshot arguments");
+        return NULL;
+    }
+    size_t count = snapshot->header->node_count;
+    diram_ast_node_t** made = malloc(count * sizeof(diram_ast_node_t*));
+    if (!made) {
+        set_error("Out of memory");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        made[i] = diram_ast_arena_create_node(arena, (diram_ast_node_type_t)snapshot->nodes[i].type);
+        if (!made[i]) goto fail;
+        load_record(snapshot, &snapshot->nodes[i], made[i]);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const diram_snapshot_node_t* record = &snapshot->nodes[i];
+        diram_ast_node_t* node = made[i];
+        const uint32_t* links = snapshot->links + record->first_link;
+
+        node->children = load_run(arena, made, node, record->first_child, record->child_count);
+        if (record->child_count && !node->children) goto fail;
+        node->child_count = node->child_capacity = record->child_count;
+
+        if (node->type == AST_NODE_OPCODE && record->link_count) {
+            node->data.opcode.operands = diram_ast_arena_alloc(arena, record->link_count * sizeof(diram_ast_node_t*));
+            if (!node->data.opcode.operands) goto fail;
+            for (uint32_t l = 0; l < record->link_count; l++) {
+                node->data.opcode.operands[l] = made[links[l]];
+                made[links[l]]->parent = node;
+            }
+            node->data.opcode.operand_count = (uint8_t)record->link_count;
+        } else if (node->type == AST_NODE_POLICY && record->link_count) {
+            node->data.policy.rules = diram_ast_arena_alloc(arena, record->link_count * sizeof(char*));
+            if (!node->data.policy.rules) goto fail;
+            for (uint32_t l = 0; l < record->link_count; l++) {
+                node->data.policy.rules[l] = (char*)(snapshot->strings + links[l]);
+            }
+            node->data.policy.rule_count = record->link_count;
+        }
+    }
+
+    // Records are already breadth-first, so this only fills in the ranges
+    diram_ast_node_t* root = made[0];
+    free(made);
+    if (!diram_ast_arena_compact(arena, &root)) {
+        set_error("Cannot compact the loaded tree");
+        return NULL;
+    }
+    return root;
+
+fail:
+    free(made);
+    set_error("Out of memory loading snapshot tree");
+    return NULL;
+}
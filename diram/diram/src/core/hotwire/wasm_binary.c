@@ -0,0 +1,468 @@
+// src/core/hotwire/wasm_binary.c
+// DIRAM WebAssembly Binary Target - AST straight to a loadable .wasm module
+// OBINexus Aegis Project
+//
+// Same lowering as wasm_visitor.c, but every instruction is an opcode byte
+// plus LEB128 immediates appended to a byte buffer. The module exports one
+// function, "run", holding the policy body, plus "memory" and a base/size
+// global pair per memory region.
+
+#include "diram/core/hotwire/wasm_binary.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Fixed imports, in function index order; feature checks follow them
+typedef enum {
+    IMPORT_ALLOC_TRACED,
+    IMPORT_FREE_TRACED,
+    IMPORT_TRACE_ENABLE,
+    IMPORT_CHECK_CONSTRAINT,
+    IMPORT_ENFORCE_POLICY,
+    IMPORT_VERIFY_RECEIPT,
+    IMPORT_FIXED_COUNT
+} wasm_import_t;
+
+// Function types, in type section order
+typedef enum {
+    TYPE_I32_TO_I32,
+    TYPE_I32_TO_VOID,
+    TYPE_VOID_TO_VOID,
+    TYPE_VOID_TO_I32
+} wasm_type_t;
+
+static const struct {
+    const char* name;
+    wasm_type_t type;
+} g_fixed_imports[IMPORT_FIXED_COUNT] = {
+    { "alloc_traced",     TYPE_I32_TO_I32 },
+    { "free_traced",      TYPE_I32_TO_VOID },
+    { "trace_enable",     TYPE_VOID_TO_VOID },
+    { "check_constraint", TYPE_I32_TO_I32 },
+    { "enforce_policy",   TYPE_VOID_TO_I32 },
+    { "verify_receipt",   TYPE_I32_TO_I32 }
+};
+
+// Type section payload: count, then (param vec)(result vec) per type
+static const uint8_t g_type_section[] = {
+    4,
+    WASM_TYPE_FUNC, 1, WASM_TYPE_I32, 1, WASM_TYPE_I32,
+    WASM_TYPE_FUNC, 1, WASM_TYPE_I32, 0,
+    WASM_TYPE_FUNC, 0, 0,
+    WASM_TYPE_FUNC, 0, 1, WASM_TYPE_I32
+};
+
+#define IMPORT_MODULE "diram"
+#define FEATURE_IMPORT_PREFIX "feature_enabled_"
+
+// The single local of "run": the last allocation address
+#define LOCAL_ALLOC_ADDR 0
+
+// WASM Binary Visitor Implementation
+typedef struct {
+    diram_ast_visitor_t base;          // Base visitor interface
+    diram_hotwire_context_t* context;  // Hotwire context
+
+    diram_wasm_buffer_t body;          // Instructions of "run"
+    diram_wasm_buffer_t imports;       // Feature-check import entries
+    diram_wasm_buffer_t globals;       // Region base/size globals
+    diram_wasm_buffer_t exports;       // Region global exports
+
+    const char** features;             // Import order, names owned by the AST
+    uint32_t feature_count;
+    uint32_t feature_capacity;
+    uint32_t global_count;
+} diram_wasm_binary_visitor_t;
+
+// Byte buffer
+
+static bool buffer_reserve(diram_wasm_buffer_t* buffer, size_t extra) {
+    if (buffer->failed) return false;
+    if (buffer->size + extra <= buffer->capacity) return true;
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity < buffer->size + extra) capacity *= 2;
+    uint8_t* data = realloc(buffer->data, capacity);
+    if (!data) {
+        buffer->failed = true;
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+void diram_wasm_buffer_free(diram_wasm_buffer_t* buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void diram_wasm_emit_byte(diram_wasm_buffer_t* buffer, uint8_t byte) {
+    if (buffer_reserve(buffer, 1)) {
+        buffer->data[buffer->size++] = byte;
+    }
+}
+
+void diram_wasm_emit_bytes(diram_wasm_buffer_t* buffer, const void* bytes, size_t length) {
+    if (length && buffer_reserve(buffer, length)) {
+        memcpy(buffer->data + buffer->size, bytes, length);
+        buffer->size += length;
+    }
+}
+
+void diram_wasm_emit_u32(diram_wasm_buffer_t* buffer, uint32_t value) {
+    if (!buffer_reserve(buffer, 5)) return;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer->data[buffer->size++] = value ? (byte | 0x80) : byte;
+    } while (value);
+}
+
+void diram_wasm_emit_i32(diram_wasm_buffer_t* buffer, int32_t value) {
+    if (!buffer_reserve(buffer, 5)) return;
+    int64_t v = value;
+    for (;;) {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;    // Arithmetic: int64_t keeps the sign
+        if ((v == 0 && !(byte & 0x40)) || (v == -1 && (byte & 0x40))) {
+            buffer->data[buffer->size++] = byte;
+            return;
+        }
+        buffer->data[buffer->size++] = byte | 0x80;
+    }
+}
+
+void diram_wasm_emit_name(diram_wasm_buffer_t* buffer, const char* name) {
+    size_t length = name ? strlen(name) : 0;
+    diram_wasm_emit_u32(buffer, (uint32_t)length);
+    diram_wasm_emit_bytes(buffer, name, length);
+}
+
+// Instruction helpers
+
+static void emit_op(diram_wasm_binary_visitor_t* visitor, diram_wasm_opcode_t op) {
+    diram_wasm_emit_byte(&visitor->body, (uint8_t)op);
+}
+
+static void emit_op_u32(diram_wasm_binary_visitor_t* visitor, diram_wasm_opcode_t op,
+                        uint32_t immediate) {
+    diram_wasm_emit_byte(&visitor->body, (uint8_t)op);
+    diram_wasm_emit_u32(&visitor->body, immediate);
+}
+
+static void emit_i32_const(diram_wasm_binary_visitor_t* visitor, uint64_t value) {
+    // i32 wraps, as the text target's (i32.const %zu) does
+    diram_wasm_emit_byte(&visitor->body, WASM_OP_I32_CONST);
+    diram_wasm_emit_i32(&visitor->body, (int32_t)(uint32_t)value);
+}
+
+static void emit_block(diram_wasm_binary_visitor_t* visitor, diram_wasm_opcode_t op) {
+    diram_wasm_emit_byte(&visitor->body, (uint8_t)op);
+    diram_wasm_emit_byte(&visitor->body, WASM_BLOCK_VOID);
+}
+
+// Trap unless the i32 on the stack is non-zero
+static void emit_trap_if_zero(diram_wasm_binary_visitor_t* visitor) {
+    emit_op(visitor, WASM_OP_I32_EQZ);
+    emit_block(visitor, WASM_OP_IF);
+    emit_op(visitor, WASM_OP_UNREACHABLE);
+    emit_op(visitor, WASM_OP_END);
+}
+
+// Function index of the feature check import, added on first use
+static int feature_import(diram_wasm_binary_visitor_t* visitor, const char* name) {
+    for (uint32_t i = 0; i < visitor->feature_count; i++) {
+        if (strcmp(visitor->features[i], name) == 0) {
+            return IMPORT_FIXED_COUNT + (int)i;
+        }
+    }
+    if (visitor->feature_count == visitor->feature_capacity) {
+        uint32_t capacity = visitor->feature_capacity ? visitor->feature_capacity * 2 : 16;
+        const char** features = realloc(visitor->features, capacity * sizeof(const char*));
+        if (!features) return -1;
+        visitor->features = features;
+        visitor->feature_capacity = capacity;
+    }
+
+    size_t prefix = strlen(FEATURE_IMPORT_PREFIX);
+    size_t length = strlen(name);
+    diram_wasm_emit_name(&visitor->imports, IMPORT_MODULE);
+    diram_wasm_emit_u32(&visitor->imports, (uint32_t)(prefix + length));
+    diram_wasm_emit_bytes(&visitor->imports, FEATURE_IMPORT_PREFIX, prefix);
+    diram_wasm_emit_bytes(&visitor->imports, name, length);
+    diram_wasm_emit_byte(&visitor->imports, 0x00);     // Function import
+    diram_wasm_emit_u32(&visitor->imports, TYPE_VOID_TO_I32);
+
+    visitor->features[visitor->feature_count] = name;
+    return IMPORT_FIXED_COUNT + (int)visitor->feature_count++;
+}
+
+// Immutable i32 global exported as <region><suffix>
+static void add_region_global(diram_wasm_binary_visitor_t* visitor, const char* region,
+                              const char* suffix, uint64_t value) {
+    diram_wasm_emit_byte(&visitor->globals, WASM_TYPE_I32);
+    diram_wasm_emit_byte(&visitor->globals, 0x00);     // Immutable
+    diram_wasm_emit_byte(&visitor->globals, WASM_OP_I32_CONST);
+    diram_wasm_emit_i32(&visitor->globals, (int32_t)(uint32_t)value);
+    diram_wasm_emit_byte(&visitor->globals, WASM_OP_END);
+
+    size_t region_length = strlen(region);
+    size_t suffix_length = strlen(suffix);
+    diram_wasm_emit_u32(&visitor->exports, (uint32_t)(region_length + suffix_length));
+    diram_wasm_emit_bytes(&visitor->exports, region, region_length);
+    diram_wasm_emit_bytes(&visitor->exports, suffix, suffix_length);
+    diram_wasm_emit_byte(&visitor->exports, 0x03);     // Global export
+    diram_wasm_emit_u32(&visitor->exports, visitor->global_count++);
+}
+
+// Allocation Node -> WebAssembly Binary
+static void* visit_allocation_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+
+    if (!diram_hotwire_check_feature(visitor->context, "cryptographic_receipts")) {
+        return NULL;
+    }
+
+    emit_i32_const(visitor, node->data.allocation.size);
+    emit_op_u32(visitor, WASM_OP_CALL, IMPORT_ALLOC_TRACED);
+
+    if (node->data.allocation.address == 0) {
+        // Nothing keeps the address; the body must leave the stack empty
+        emit_op(visitor, WASM_OP_DROP);
+        return NULL;
+    }
+
+    emit_op_u32(visitor, WASM_OP_LOCAL_SET, LOCAL_ALLOC_ADDR);
+    if (node->data.allocation.sha256_receipt[0] != '\0') {
+        emit_op_u32(visitor, WASM_OP_LOCAL_GET, LOCAL_ALLOC_ADDR);
+        emit_op_u32(visitor, WASM_OP_CALL, IMPORT_VERIFY_RECEIPT);
+        emit_trap_if_zero(visitor);
+    }
+    return NULL;
+}
+
+// Opcode Node -> WebAssembly Binary
+static void* visit_opcode_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+
+    switch (node->data.opcode.code) {
+        case 0x01: // ALLOC
+            emit_block(visitor, WASM_OP_BLOCK);
+            for (uint8_t i = 0; i < node->data.opcode.operand_count; i++) {
+                diram_ast_accept(node->data.opcode.operands[i], self);
+            }
+            emit_op(visitor, WASM_OP_END);
+            break;
+
+        case 0x02: // FREE - releases the last allocation
+            emit_block(visitor, WASM_OP_BLOCK);
+            emit_op_u32(visitor, WASM_OP_LOCAL_GET, LOCAL_ALLOC_ADDR);
+            emit_op_u32(visitor, WASM_OP_CALL, IMPORT_FREE_TRACED);
+            emit_op(visitor, WASM_OP_END);
+            break;
+
+        case 0x03: // TRACE
+            emit_block(visitor, WASM_OP_BLOCK);
+            emit_op_u32(visitor, WASM_OP_CALL, IMPORT_TRACE_ENABLE);
+            emit_op(visitor, WASM_OP_END);
+            break;
+
+        default:
+            // Invalid opcode - trap
+            emit_op(visitor, WASM_OP_UNREACHABLE);
+            break;
+    }
+    return NULL;
+}
+
+// Constraint Node -> WebAssembly Binary
+static void* visit_constraint_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+
+    emit_block(visitor, WASM_OP_BLOCK);
+    emit_i32_const(visitor, node->data.constraint.max_heap_events);
+    emit_op_u32(visitor, WASM_OP_CALL, IMPORT_CHECK_CONSTRAINT);
+    emit_op_u32(visitor, WASM_OP_BR_IF, 0);
+    emit_op(visitor, WASM_OP_UNREACHABLE);     // Constraint violation
+    emit_op(visitor, WASM_OP_END);
+    return NULL;
+}
+
+// Policy Node -> WebAssembly Binary
+static void* visit_policy_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+
+    if (strcmp(node->data.policy.type, "security") != 0) return NULL;
+
+    emit_block(visitor, WASM_OP_BLOCK);
+    if (node->data.policy.enforced) {
+        emit_op_u32(visitor, WASM_OP_CALL, IMPORT_ENFORCE_POLICY);
+        emit_trap_if_zero(visitor);
+    }
+    emit_op(visitor, WASM_OP_END);
+    return NULL;
+}
+
+// Feature Toggle -> WebAssembly Binary
+static void* visit_feature_toggle_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+    diram_hotwire_context_t* ctx = visitor->context;
+
+    diram_hotwire_register_feature(ctx, node->data.feature.name,
+                                   node->data.feature.enabled);
+    if (!node->data.feature.enabled) return NULL;
+
+    int import = feature_import(visitor, node->data.feature.name);
+    if (import < 0) {
+        ctx->has_error = true;
+        snprintf(ctx->error_message, sizeof(ctx->error_message),
+                 "Out of memory importing feature %s", node->data.feature.name);
+        return NULL;
+    }
+
+    // Feature-specific code goes inside the if
+    emit_op_u32(visitor, WASM_OP_CALL, (uint32_t)import);
+    emit_block(visitor, WASM_OP_IF);
+    emit_op(visitor, WASM_OP_END);
+    return NULL;
+}
+
+// Memory Region -> WebAssembly Binary
+static void* visit_memory_region_wasm_binary(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+
+    add_region_global(visitor, node->data.memory_region.name, "_base",
+                      node->data.memory_region.base_address);
+    add_region_global(visitor, node->data.memory_region.name, "_size",
+                      node->data.memory_region.size);
+    return NULL;
+}
+
+// Create WebAssembly Binary Visitor
+diram_ast_visitor_t* diram_hotwire_create_wasm_binary_visitor(diram_hotwire_context_t* context) {
+    diram_wasm_binary_visitor_t* visitor = calloc(1, sizeof(diram_wasm_binary_visitor_t));
+    if (!visitor) return NULL;
+
+    visitor->base.visit_allocation = visit_allocation_wasm_binary;
+    visitor->base.visit_opcode = visit_opcode_wasm_binary;
+    visitor->base.visit_constraint = visit_constraint_wasm_binary;
+    visitor->base.visit_policy = visit_policy_wasm_binary;
+    visitor->base.visit_feature_toggle = visit_feature_toggle_wasm_binary;
+    visitor->base.visit_memory_region = visit_memory_region_wasm_binary;
+
+    visitor->base.visit_root = NULL;
+    visitor->base.visit_operand = NULL;
+    visitor->base.visit_build_target = NULL;
+
+    visitor->context = context;
+    return &visitor->base;
+}
+
+// Section id, payload size, payload
+static void emit_section(diram_wasm_buffer_t* module, diram_wasm_section_t id,
+                         const diram_wasm_buffer_t* payload) {
+    diram_wasm_emit_byte(module, (uint8_t)id);
+    diram_wasm_emit_u32(module, (uint32_t)payload->size);
+    diram_wasm_emit_bytes(module, payload->data, payload->size);
+    if (payload->failed) module->failed = true;
+}
+
+// Assemble the module into context->output_buffer
+bool diram_hotwire_finish_wasm_binary(diram_ast_visitor_t* self) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+    diram_hotwire_context_t* ctx = visitor->context;
+    if (ctx->has_error) return false;
+
+    uint32_t import_count = IMPORT_FIXED_COUNT + visitor->feature_count;
+    diram_wasm_buffer_t module = {0};
+    diram_wasm_buffer_t section = {0};
+
+    diram_wasm_emit_bytes(&module, DIRAM_WASM_MAGIC, 4);
+    static const uint8_t version[4] = { DIRAM_WASM_VERSION, 0, 0, 0 };
+    diram_wasm_emit_bytes(&module, version, sizeof(version));
+
+    diram_wasm_emit_bytes(&section, g_type_section, sizeof(g_type_section));
+    emit_section(&module, WASM_SECTION_TYPE, &section);
+
+    section.size = 0;
+    diram_wasm_emit_u32(&section, import_count);
+    for (int i = 0; i < IMPORT_FIXED_COUNT; i++) {
+        diram_wasm_emit_name(&section, IMPORT_MODULE);
+        diram_wasm_emit_name(&section, g_fixed_imports[i].name);
+        diram_wasm_emit_byte(&section, 0x00);
+        diram_wasm_emit_u32(&section, g_fixed_imports[i].type);
+    }
+    diram_wasm_emit_bytes(&section, visitor->imports.data, visitor->imports.size);
+    emit_section(&module, WASM_SECTION_IMPORT, &section);
+
+    // One defined function, "run"
+    section.size = 0;
+    diram_wasm_emit_u32(&section, 1);
+    diram_wasm_emit_u32(&section, TYPE_VOID_TO_VOID);
+    emit_section(&module, WASM_SECTION_FUNCTION, &section);
+
+    section.size = 0;
+    diram_wasm_emit_u32(&section, 1);
+    diram_wasm_emit_byte(&section, 0x00);      // Minimum only
+    diram_wasm_emit_u32(&section, ctx->config.wasm_config.memory_pages);
+    emit_section(&module, WASM_SECTION_MEMORY, &section);
+
+    if (visitor->global_count) {
+        section.size = 0;
+        diram_wasm_emit_u32(&section, visitor->global_count);
+        diram_wasm_emit_bytes(&section, visitor->globals.data, visitor->globals.size);
+        emit_section(&module, WASM_SECTION_GLOBAL, &section);
+    }
+
+    section.size = 0;
+    diram_wasm_emit_u32(&section, visitor->global_count + 2);
+    diram_wasm_emit_name(&section, "memory");
+    diram_wasm_emit_byte(&section, 0x02);
+    diram_wasm_emit_u32(&section, 0);
+    diram_wasm_emit_name(&section, "run");
+    diram_wasm_emit_byte(&section, 0x00);
+    diram_wasm_emit_u32(&section, import_count);
+    diram_wasm_emit_bytes(&section, visitor->exports.data, visitor->exports.size);
+    emit_section(&module, WASM_SECTION_EXPORT, &section);
+
+    // Body: one i32 local, the instructions, end
+    section.size = 0;
+    diram_wasm_emit_u32(&section, 1);
+    diram_wasm_emit_u32(&section, (uint32_t)visitor->body.size + 4);
+    diram_wasm_emit_u32(&section, 1);
+    diram_wasm_emit_u32(&section, 1);
+    diram_wasm_emit_byte(&section, WASM_TYPE_I32);
+    diram_wasm_emit_bytes(&section, visitor->body.data, visitor->body.size);
+    diram_wasm_emit_byte(&section, WASM_OP_END);
+    emit_section(&module, WASM_SECTION_CODE, &section);
+
+    bool failed = module.failed || visitor->body.failed || visitor->imports.failed ||
+                  visitor->globals.failed || visitor->exports.failed;
+    diram_wasm_buffer_free(&section);
+    if (failed) {
+        diram_wasm_buffer_free(&module);
+        ctx->has_error = true;
+        snprintf(ctx->error_message, sizeof(ctx->error_message),
+                 "Out of memory encoding WASM module");
+        return false;
+    }
+
+    // Hand the bytes over as the context output
+    free(ctx->output_buffer);
+    ctx->output_buffer = (char*)module.data;
+    ctx->output_size = module.size;
+    ctx->output_capacity = module.capacity;
+    return true;
+}
+
+void diram_hotwire_destroy_wasm_binary_visitor(diram_ast_visitor_t* self) {
+    diram_wasm_binary_visitor_t* visitor = (diram_wasm_binary_visitor_t*)self;
+    if (!visitor) return;
+    diram_wasm_buffer_free(&visitor->body);
+    diram_wasm_buffer_free(&visitor->imports);
+    diram_wasm_buffer_free(&visitor->globals);
+    diram_wasm_buffer_free(&visitor->exports);
+    free(visitor->features);
+    free(visitor);
+}
@@ -1,3 +1,438 @@
-/* Stub for src/core/parser/ast.c */
+// src/core/parser/ast.c
+// DIRAM Abstract Syntax Tree - nodes, tree operations, visitor dispatch
+// OBINexus Aegis Project
+//
+// Nodes borrow their strings (the arena's, or the caller's literals). A
+// heap node owns its children, operands and rules arrays; an arena node
+// owns nothing, the arena frees it with everything else.
+
+#include "diram/core/parser/ast.h"
 #include <stdio.h>
-// TODO: Implement
+#include <stdlib.h>
+#include <string.h>
+
+#define AST_INITIAL_CHILDREN 4
+#define AST_BLOCK_SIZE (64 * 1024)
+#define AST_ARENA_ALIGN 8
+
+struct diram_ast_block {
+    diram_ast_block_t* next;
+    size_t used;
+    size_t capacity;
+    max_align_t data[];
+};
+
+// Arena
+
+diram_ast_arena_t* diram_ast_arena_create(void) {
+    return calloc(1, sizeof(diram_ast_arena_t));
+}
+
+static void free_blocks(diram_ast_block_t* block) {
+    while (block) {
+        diram_ast_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void diram_ast_arena_destroy(diram_ast_arena_t* arena) {
+    if (!arena) return;
+    free_blocks(arena->node_blocks);
+    free_blocks(arena->data_blocks);
+    free(arena->nodes);
+    free(arena->links);
+    free(arena);
+}
+
+static void* block_alloc(diram_ast_block_t** list, size_t size) {
+    size = (size + AST_ARENA_ALIGN - 1) & ~(size_t)(AST_ARENA_ALIGN - 1);
+    diram_ast_block_t* block = *list;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > AST_BLOCK_SIZE ? size : AST_BLOCK_SIZE;
+        block = malloc(sizeof(diram_ast_block_t) + capacity);
+        if (!block) return NULL;
+        block->next = *list;
+        block->used = 0;
+        block->capacity = capacity;
+        *list = block;
+    }
+    void* out = (char*)block->data + block->used;
+    block->used += size;
+    return out;
+}
+
+void* diram_ast_arena_alloc(diram_ast_arena_t* arena, size_t size) {
+    return arena ? block_alloc(&arena->data_blocks, size) : NULL;
+}
+
+diram_ast_node_t* diram_ast_arena_create_node(diram_ast_arena_t* arena, diram_ast_node_type_t type) {
+    if (!arena) return NULL;
+    diram_ast_node_t* node = block_alloc(&arena->node_blocks, sizeof(diram_ast_node_t));
+    if (!node) return NULL;
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->arena = arena;
+    node->first_child = DIRAM_AST_NO_RANGE;
+    return node;
+}
+
+static void* array_grow(diram_ast_arena_t* arena, void* items, size_t count,
+                        size_t capacity, size_t item_size) {
+    if (!arena) return realloc(items, capacity * item_size);
+    void* grown = diram_ast_arena_alloc(arena, capacity * item_size);
+    if (grown && count) memcpy(grown, items, count * item_size);
+    return grown;
+}
+
+void* diram_ast_array_reserve(diram_ast_arena_t* arena, void* items, size_t count, size_t item_size) {
+    if (count != 0 && (count < AST_INITIAL_CHILDREN || (count & (count - 1)) != 0)) return items;
+    return array_grow(arena, items, count, count ? count * 2 : AST_INITIAL_CHILDREN, item_size);
+}
+
+static bool count_tree(const diram_ast_node_t* node, size_t* nodes, size_t* links) {
+    *nodes += 1;
+    *links += node->child_count;
+    for (size_t i = 0; i < node->child_count; i++) {
+        if (!node->children[i] || node->children[i]->arena != node->arena) return false;
+        if (!count_tree(node->children[i], nodes, links)) return false;
+    }
+    if (node->type == AST_NODE_OPCODE) {
+        *links += node->data.opcode.operand_count;
+        for (size_t i = 0; i < node->data.opcode.operand_count; i++) {
+            diram_ast_node_t* operand = node->data.opcode.operands[i];
+            if (!operand || operand->arena != node->arena) return false;
+            if (!count_tree(operand, nodes, links)) return false;
+        }
+    }
+    return true;
+}
+
+// Copy count nodes from old pointers to nodes[*tail..], pointing links at them
+static diram_ast_node_t** place_run(diram_ast_arena_t* arena, diram_ast_node_t* parent,
+                                    diram_ast_node_t** old, size_t count,
+                                    diram_ast_node_t* nodes, size_t* tail,
+                                    diram_ast_node_t** links, size_t* link_tail) {
+    diram_ast_node_t** run = links + *link_tail;
+    for (size_t i = 0; i < count; i++) {
+        diram_ast_node_t* copy = &nodes[*tail];
+        *copy = *old[i];
+        copy->parent = parent;
+        copy->arena = arena;
+        run[i] = copy;
+        (*tail)++;
+    }
+    *link_tail += count;
+    return run;
+}
+
+bool diram_ast_arena_compact(diram_ast_arena_t* arena, diram_ast_node_t** root) {
+    if (!arena || !root || !*root || (*root)->arena != arena) return false;
+
+    size_t node_count = 0, link_count = 0;
+    if (!count_tree(*root, &node_count, &link_count) || node_count > DIRAM_AST_NO_RANGE) return false;
+    diram_ast_node_t* nodes = malloc(node_count * sizeof(diram_ast_node_t));
+    diram_ast_node_t** links = malloc((link_count ? link_count : 1) * sizeof(diram_ast_node_t*));
+    if (!nodes || !links) {
+        free(nodes);
+        free(links);
+        return false;
+    }
+
+    // Breadth-first: each node's children land together, right after the
+    // children of the nodes before it. Old pointers stay valid until the end.
+    size_t tail = 1, link_tail = 0;
+    nodes[0] = **root;
+    for (size_t i = 0; i < tail; i++) {
+        diram_ast_node_t* node = &nodes[i];
+        node->first_child = (uint32_t)tail;
+        node->children = place_run(arena, node, node->children, node->child_count,
+                                   nodes, &tail, links, &link_tail);
+        node->child_capacity = node->child_count;
+        if (node->type == AST_NODE_OPCODE) {
+            node->data.opcode.operands = place_run(arena, node, node->data.opcode.operands,
+                                                   node->data.opcode.operand_count,
+                                                   nodes, &tail, links, &link_tail);
+        }
+    }
+
+    free_blocks(arena->node_blocks);
+    arena->node_blocks = NULL;
+    free(arena->nodes);
+    free(arena->links);
+    arena->nodes = nodes;
+    arena->node_count = node_count;
+    arena->links = links;
+    *root = nodes;
+    return true;
+}
+
+static bool has_range(const diram_ast_node_t* node) {
+    return node->arena && node->first_child != DIRAM_AST_NO_RANGE;
+}
+
+// AST Node Creation
+
+diram_ast_node_t* diram_ast_create_node(diram_ast_node_type_t type) {
+    diram_ast_node_t* node = calloc(1, sizeof(diram_ast_node_t));
+    if (node) {
+        node->type = type;
+        node->first_child = DIRAM_AST_NO_RANGE;
+    }
+    return node;
+}
+
+void diram_ast_destroy_node(diram_ast_node_t* node) {
+    if (!node || node->arena) return;
+    for (size_t i = 0; i < node->child_count; i++) {
+        diram_ast_destroy_node(node->children[i]);
+    }
+    free(node->children);
+    if (node->type == AST_NODE_OPCODE) {
+        for (size_t i = 0; i < node->data.opcode.operand_count; i++) {
+            diram_ast_destroy_node(node->data.opcode.operands[i]);
+        }
+        free(node->data.opcode.operands);
+    } else if (node->type == AST_NODE_POLICY) {
+        free(node->data.policy.rules);
+    }
+    free(node);
+}
+
+// Tree Operations
+
+bool diram_ast_add_child(diram_ast_node_t* parent, diram_ast_node_t* child) {
+    if (!parent || !child) return false;
+    if (parent->child_count == parent->child_capacity) {
+        size_t capacity = parent->child_capacity ? parent->child_capacity * 2 : AST_INITIAL_CHILDREN;
+        diram_ast_node_t** children = array_grow(parent->arena, parent->children, parent->child_count,
+                                                 capacity, sizeof(diram_ast_node_t*));
+        if (!children) return false;
+        parent->children = children;
+        parent->child_capacity = capacity;
+    }
+    parent->children[parent->child_count++] = child;
+    child->parent = parent;
+    // The new child is not in the compacted run
+    parent->first_child = DIRAM_AST_NO_RANGE;
+    return true;
+}
+
+bool diram_ast_remove_child(diram_ast_node_t* parent, diram_ast_node_t* child) {
+    if (!parent || !child) return false;
+    for (size_t i = 0; i < parent->child_count; i++) {
+        if (parent->children[i] != child) continue;
+        memmove(&parent->children[i], &parent->children[i + 1],
+                (parent->child_count - i - 1) * sizeof(diram_ast_node_t*));
+        parent->child_count--;
+        child->parent = NULL;
+        parent->first_child = DIRAM_AST_NO_RANGE;
+        return true;
+    }
+    return false;
+}
+
+static const char* node_name(const diram_ast_node_t* node) {
+    switch (node->type) {
+        case AST_NODE_ALLOCATION:     return node->data.allocation.tag;
+        case AST_NODE_OPCODE:         return node->data.opcode.name;
+        case AST_NODE_CONSTRAINT:     return node->data.constraint.name;
+        case AST_NODE_POLICY:         return node->data.policy.name;
+        case AST_NODE_FEATURE_TOGGLE: return node->data.feature.name;
+        case AST_NODE_MEMORY_REGION:  return node->data.memory_region.name;
+        case AST_NODE_OPERAND:        return node->data.operand.name;
+        case AST_NODE_BUILD_TARGET:   return node->data.build_target.name;
+        case AST_NODE_ROOT:           break;
+    }
+    return NULL;
+}
+
+diram_ast_node_t* diram_ast_find_child(diram_ast_node_t* parent,
+                                        diram_ast_node_type_t type,
+                                        const char* name) {
+    if (!parent) return NULL;
+    for (size_t i = 0; i < parent->child_count; i++) {
+        diram_ast_node_t* child = parent->children[i];
+        if (child->type != type) continue;
+        const char* child_name = node_name(child);
+        if (!name || (child_name && strcmp(child_name, name) == 0)) return child;
+    }
+    return NULL;
+}
+
+// Node Factory Functions
+
+diram_ast_node_t* diram_ast_create_allocation(size_t size, const char* tag) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_ALLOCATION);
+    if (!node) return NULL;
+    node->data.allocation.size = size;
+    node->data.allocation.tag = tag;
+    return node;
+}
+
+diram_ast_node_t* diram_ast_create_opcode(const char* name, uint8_t code) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_OPCODE);
+    if (!node) return NULL;
+    node->data.opcode.name = name;
+    node->data.opcode.code = code;
+    return node;
+}
+
+diram_ast_node_t* diram_ast_create_constraint(const char* name, double epsilon) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_CONSTRAINT);
+    if (!node) return NULL;
+    node->data.constraint.name = name;
+    node->data.constraint.epsilon_value = epsilon;
+    return node;
+}
+
+diram_ast_node_t* diram_ast_create_policy(const char* name, const char* type) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_POLICY);
+    if (!node) return NULL;
+    node->data.policy.name = name;
+    node->data.policy.type = type;
+    node->data.policy.enforced = true;
+    return node;
+}
+
+diram_ast_node_t* diram_ast_create_feature_toggle(const char* name, bool enabled) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_FEATURE_TOGGLE);
+    if (!node) return NULL;
+    node->data.feature.name = name;
+    node->data.feature.enabled = enabled;
+    return node;
+}
+
+diram_ast_node_t* diram_ast_create_memory_region(const char* name, uint64_t base, size_t size) {
+    diram_ast_node_t* node = diram_ast_create_node(AST_NODE_MEMORY_REGION);
+    if (!node) return NULL;
+    node->data.memory_region.name = name;
+    node->data.memory_region.base_address = base;
+    node->data.memory_region.size = size;
+    return node;
+}
+
+// Dispatch node to the visitor method for its type. A node with its own
+// accept hook uses that instead; a root the visitor does not handle
+// visits its children in order.
+void* diram_ast_accept(diram_ast_node_t* node, diram_ast_visitor_t* visitor) {
+    if (!node || !visitor) return NULL;
+    if (node->accept) return node->accept(node, visitor);
+
+    void* (*visit)(diram_ast_visitor_t*, diram_ast_node_t*) = NULL;
+    switch (node->type) {
+        case AST_NODE_ROOT:           visit = visitor->visit_root; break;
+        case AST_NODE_ALLOCATION:     visit = visitor->visit_allocation; break;
+        case AST_NODE_OPCODE:         visit = visitor->visit_opcode; break;
+        case AST_NODE_CONSTRAINT:     visit = visitor->visit_constraint; break;
+        case AST_NODE_POLICY:         visit = visitor->visit_policy; break;
+        case AST_NODE_FEATURE_TOGGLE: visit = visitor->visit_feature_toggle; break;
+        case AST_NODE_MEMORY_REGION:  visit = visitor->visit_memory_region; break;
+        case AST_NODE_OPERAND:        visit = visitor->visit_operand; break;
+        case AST_NODE_BUILD_TARGET:   visit = visitor->visit_build_target; break;
+    }
+    if (visit) return visit(visitor, node);
+
+    if (node->type == AST_NODE_ROOT) {
+        if (has_range(node)) {
+            // Compacted: walk the contiguous run directly
+            diram_ast_node_t* child = node->arena->nodes + node->first_child;
+            for (size_t i = 0; i < node->child_count; i++) diram_ast_accept(&child[i], visitor);
+        } else {
+            for (size_t i = 0; i < node->child_count; i++) {
+                diram_ast_accept(node->children[i], visitor);
+            }
+        }
+    }
+    return NULL;
+}
+
+// AST Utilities
+
+static const char* node_type_name(diram_ast_node_type_t type) {
+    switch (type) {
+        case AST_NODE_ROOT:           return "Root";
+        case AST_NODE_ALLOCATION:     return "Allocation";
+        case AST_NODE_OPCODE:         return "Opcode";
+        case AST_NODE_CONSTRAINT:     return "Constraint";
+        case AST_NODE_POLICY:         return "Policy";
+        case AST_NODE_FEATURE_TOGGLE: return "FeatureToggle";
+        case AST_NODE_MEMORY_REGION:  return "MemoryRegion";
+        case AST_NODE_OPERAND:        return "Operand";
+        case AST_NODE_BUILD_TARGET:   return "BuildTarget";
+    }
+    return "Unknown";
+}
+
+void diram_ast_print(diram_ast_node_t* node, int depth) {
+    if (!node) return;
+    const char* name = node_name(node);
+    printf("%*s%s%s%s\n", depth * 2, "", node_type_name(node->type),
+           name ? " " : "", name ? name : "");
+    if (node->type == AST_NODE_OPCODE) {
+        for (size_t i = 0; i < node->data.opcode.operand_count; i++) {
+            diram_ast_print(node->data.opcode.operands[i], depth + 1);
+        }
+    }
+    for (size_t i = 0; i < node->child_count; i++) {
+        diram_ast_print(node->children[i], depth + 1);
+    }
+}
+
+bool diram_ast_validate(diram_ast_node_t* node) {
+    if (!node) return false;
+    switch (node->type) {
+        case AST_NODE_OPCODE:
+            if (node->data.opcode.operand_count && !node->data.opcode.operands) return false;
+            // fallthrough
+        case AST_NODE_POLICY:
+        case AST_NODE_FEATURE_TOGGLE:
+        case AST_NODE_OPERAND:
+        case AST_NODE_BUILD_TARGET:
+            if (!node_name(node)) return false;
+            break;
+        case AST_NODE_MEMORY_REGION:
+            if (!node->data.memory_region.name || node->data.memory_region.size == 0) return false;
+            break;
+        case AST_NODE_CONSTRAINT:
+            if (node->data.constraint.epsilon_value < 0.0 ||
+                node->data.constraint.epsilon_value > 1.0) return false;
+            break;
+        case AST_NODE_ROOT:
+        case AST_NODE_ALLOCATION:
+            break;
+    }
+    if (node->type == AST_NODE_POLICY && node->data.policy.rule_count && !node->data.policy.rules) {
+        return false;
+    }
+    for (size_t i = 0; i < node->child_count; i++) {
+        diram_ast_node_t* child = node->children[i];
+        if (!child || child->parent != node || !diram_ast_validate(child)) return false;
+    }
+    return true;
+}
+
+size_t diram_ast_count_nodes(diram_ast_node_t* root) {
+    if (!root) return 0;
+    size_t count = 1;
+    if (has_range(root)) {
+        // Children sit side by side in the arena array
+        diram_ast_node_t* child = root->arena->nodes + root->first_child;
+        for (size_t i = 0; i < root->child_count; i++) count += diram_ast_count_nodes(&child[i]);
+        if (root->type == AST_NODE_OPCODE) {
+            for (size_t i = 0; i < root->data.opcode.operand_count; i++) {
+                count += diram_ast_count_nodes(root->data.opcode.operands[i]);
+            }
+        }
+        return count;
+    }
+    if (root->type == AST_NODE_OPCODE) {
+        for (size_t i = 0; i < root->data.opcode.operand_count; i++) {
+            count += diram_ast_count_nodes(root->data.opcode.operands[i]);
+        }
+    }
+    for (size_t i = 0; i < root->child_count; i++) {
+        count += diram_ast_count_nodes(root->children[i]);
+    }
+    return count;
+}
@@ -1,3 +1,899 @@
-/* Stub for src/core/parser/parser.c */
+// src/core/parser/parser.c
+// DIRAM Single-Pass Parser - streaming state machine over tokenizer views
+// OBINexus Aegis Project
+//
+// The parser never copies its input: tokens are views into the caller's
+// buffer or a read-only mapping of the manifest. Only the strings the tree
+// keeps are copied, into the AST arena, with entities decoded on the way.
+// Nodes are emitted under the root in document order, so the hotwire
+// transform sees toggles before the allocations that depend on them.
+
+#include "diram/core/parser/parser.h"
 #include <stdio.h>
-// TODO: Implement
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Element kinds for diram_parser_frame_t.kind
+enum {
+    ELEMENT_OTHER,              // Unknown or ignored; contents skipped
+    ELEMENT_DOCUMENT,           // <diram-config>
+    ELEMENT_SECTION,            // <metadata>, <features>, <opcodes>, ...
+    ELEMENT_TOGGLE,
+    ELEMENT_TOGGLE_DESCRIPTION,
+    ELEMENT_TOGGLE_POLICY,
+    ELEMENT_TOGGLE_CONSTRAINT,
+    ELEMENT_OPCODE,
+    ELEMENT_OPERAND,
+    ELEMENT_HEAP_EVENTS,
+    ELEMENT_POLICY,
+    ELEMENT_RULE,
+    ELEMENT_REGION,
+    ELEMENT_TARGET,
+    ELEMENT_COMPILER,
+    ELEMENT_FLAGS
+};
+
+static const struct {
+    const char* name;
+    diram_parser_state_t state;
+} g_sections[] = {
+    { "metadata", PARSER_STATE_METADATA },
+    { "features", PARSER_STATE_FEATURES },
+    { "opcodes", PARSER_STATE_OPCODES },
+    { "policies", PARSER_STATE_POLICIES },
+    { "memory_regions", PARSER_STATE_MEMORY_REGIONS },
+    { "build", PARSER_STATE_BUILD }
+};
+
+// Errors
+
+static void parser_fail(diram_parser_t* parser, const diram_token_t* token,
+                        const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+static void parser_fail(diram_parser_t* parser, const diram_token_t* token,
+                        const char* format, ...) {
+    if (parser->has_error) return;
+    char message[sizeof(parser->error_message) - 32];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    parser->error_line = token ? token->line : 0;
+    parser->error_column = token ? token->column : 0;
+    snprintf(parser->error_message, sizeof(parser->error_message), "%u:%u: %s",
+             parser->error_line, parser->error_column, message);
+    parser->has_error = true;
+    parser->state = PARSER_STATE_ERROR;
+}
+
+// String pool
+
+static char* pool_alloc(diram_parser_t* parser, size_t size) {
+    return diram_ast_arena_alloc(parser->arena, size);
+}
+
+static size_t encode_utf8(unsigned long code, char* out) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xC0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+// Decoded entities never grow, so the view length bounds the copy
+static size_t decode_entity(const char* p, const char* end, char* out, size_t* written) {
+    static const struct { const char* name; char value; } entities[] = {
+        { "lt;", '<' }, { "gt;", '>' }, { "amp;", '&' }, { "quot;", '"' }, { "apos;", '\'' }
+    };
+    size_t left = (size_t)(end - p);
+    for (size_t i = 0; i < sizeof(entities) / sizeof(entities[0]); i++) {
+        size_t length = strlen(entities[i].name);
+        if (left > length && memcmp(p + 1, entities[i].name, length) == 0) {
+            out[0] = entities[i].value;
+            *written = 1;
+            return length + 1;
+        }
+    }
+    if (left > 3 && p[1] == '#') {
+        bool hex = p[2] == 'x' || p[2] == 'X';
+        const char* digit = p + (hex ? 3 : 2);
+        unsigned long code = 0;
+        size_t digits = 0;
+        for (; digit < end && *digit != ';' && digits < 8; digit++, digits++) {
+            char c = *digit;
+            unsigned value;
+            if (c >= '0' && c <= '9') value = (unsigned)(c - '0');
+            else if (hex && c >= 'a' && c <= 'f') value = (unsigned)(c - 'a' + 10);
+            else if (hex && c >= 'A' && c <= 'F') value = (unsigned)(c - 'A' + 10);
+            else break;
+            code = code * (hex ? 16 : 10) + value;
+        }
+        size_t consumed = (size_t)(digit - p) + 1;
+        // Every encoding fits in the reference it replaces (&#N; is 4+ bytes)
+        if (digit < end && *digit == ';' && digits && code && code <= 0x10FFFF &&
+            encode_utf8(code, out) <= consumed) {
+            *written = encode_utf8(code, out);
+            return consumed;
+        }
+    }
+    out[0] = '&';
+    *written = 1;
+    return 1;
+}
+
+static const char* pool_view(diram_parser_t* parser, const diram_token_t* token) {
+    const char* p = parser->input + token->offset;
+    const char* end = p + token->length;
+    char* out = pool_alloc(parser, token->length + 1);
+    if (!out) {
+        parser_fail(parser, token, "Out of memory");
+        return NULL;
+    }
+
+    size_t length = 0;
+    while (p < end) {
+        const char* amp = memchr(p, '&', (size_t)(end - p));
+        size_t plain = (size_t)((amp ? amp : end) - p);
+        memcpy(out + length, p, plain);
+        length += plain;
+        p += plain;
+        if (!amp) break;
+        size_t written;
+        p += decode_entity(p, end, out + length, &written);
+        length += written;
+    }
+    out[length] = '\0';
+    return out;
+}
+
+static const char* pool_string(diram_parser_t* parser, const char* text) {
+    if (!text) return NULL;
+    size_t length = strlen(text) + 1;
+    char* out = pool_alloc(parser, length);
+    if (out) memcpy(out, text, length);
+    return out;
+}
+
+// Views
+
+static bool view_equals(const diram_parser_t* parser, size_t offset, size_t length,
+                        const char* text) {
+    return strlen(text) == length && memcmp(parser->input + offset, text, length) == 0;
+}
+
+static bool token_is(const diram_parser_t* parser, const diram_token_t* token, const char* text) {
+    return view_equals(parser, token->offset, token->length, text);
+}
+
+// Integer with optional 0x prefix; sizes may carry a K/M/G[B] suffix
+static bool parse_u64(const diram_parser_t* parser, const diram_token_t* token,
+                      bool allow_suffix, uint64_t* out) {
+    const char* p = parser->input + token->offset;
+    const char* end = p + token->length;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t')) end--;
+    if (p == end) return false;
+
+    unsigned base = 10;
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        base = 16;
+        p += 2;
+    }
+    uint64_t value = 0;
+    const char* start = p;
+    for (; p < end; p++) {
+        unsigned digit;
+        if (*p >= '0' && *p <= '9') digit = (unsigned)(*p - '0');
+        else if (base == 16 && *p >= 'a' && *p <= 'f') digit = (unsigned)(*p - 'a' + 10);
+        else if (base == 16 && *p >= 'A' && *p <= 'F') digit = (unsigned)(*p - 'A' + 10);
+        else break;
+        if (value > (UINT64_MAX - digit) / base) return false;
+        value = value * base + digit;
+    }
+    if (p == start) return false;
+
+    if (p < end && allow_suffix) {
+        unsigned shift;
+        switch (*p) {
+            case 'K': case 'k': shift = 10; break;
+            case 'M': case 'm': shift = 20; break;
+            case 'G': case 'g': shift = 30; break;
+            default: return false;
+        }
+        p++;
+        if (p < end && (*p == 'B' || *p == 'b')) p++;
+        if (value > (UINT64_MAX >> shift)) return false;
+        value <<= shift;
+    }
+    if (p != end) return false;
+    *out = value;
+    return true;
+}
+
+static bool parse_bool(const diram_parser_t* parser, const diram_token_t* token, bool* out) {
+    static const char* const yes[] = { "true", "1", "yes", "on" };
+    static const char* const no[] = { "false", "0", "no", "off" };
+    for (size_t i = 0; i < 4; i++) {
+        if (token_is(parser, token, yes[i])) return (*out = true);
+        if (token_is(parser, token, no[i])) return !(*out = false);
+    }
+    return false;
+}
+
+static uint8_t protection_flags(const char* protection) {
+    uint8_t flags = 0;
+    for (const char* p = protection; *p; p++) {
+        if (*p == 'r') flags |= 4;
+        else if (*p == 'w') flags |= 2;
+        else if (*p == 'x') flags |= 1;
+    }
+    return flags;
+}
+
+// Room for one more item in an arena array
+static bool grow_array(diram_parser_t* parser, void** items, size_t count, size_t item_size) {
+    void* grown = diram_ast_array_reserve(parser->arena, *items, count, item_size);
+    if (!grown) return false;
+    *items = grown;
+    return true;
+}
+
+// Parser lifecycle
+
+static diram_parser_t* parser_init(const char* input, size_t length, bool mapped) {
+    diram_parser_t* parser = calloc(1, sizeof(diram_parser_t));
+    if (!parser) return NULL;
+    parser->input = input ? input : "";
+    parser->input_length = length;
+    parser->mapped = mapped;
+    parser->tokenizer = diram_tokenizer_create(parser->input, length);
+    parser->arena = diram_ast_arena_create();
+    parser->root = diram_ast_arena_create_node(parser->arena, AST_NODE_ROOT);
+    if (!parser->tokenizer || !parser->arena || !parser->root) {
+        parser->mapped = false;
+        diram_parser_destroy(parser);
+        return NULL;
+    }
+    parser->state = PARSER_STATE_INIT;
+    parser->validate_policies = true;
+    parser->emit_ast_immediately = true;
+    return parser;
+}
+
+diram_parser_t* diram_parser_create(const char* xml_input, size_t length) {
+    if (!xml_input && length) return NULL;
+    return parser_init(xml_input, length, false);
+}
+
+diram_parser_t* diram_parser_create_from_file(const char* filename) {
+    if (!filename) return NULL;
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)st.st_size;
+    void* mapping = NULL;
+    if (length) {
+        mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+        // One forward pass: let the kernel read ahead aggressively
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    diram_parser_t* parser = parser_init(mapping, length, length != 0);
+    if (!parser && mapping) munmap(mapping, length);
+    return parser;
+}
+
+void diram_parser_destroy(diram_parser_t* parser) {
+    if (!parser) return;
+    diram_tokenizer_destroy(parser->tokenizer);
+    diram_ast_arena_destroy(parser->arena);
+    if (parser->mapped) munmap((void*)parser->input, parser->input_length);
+    free(parser);
+}
+
+// State transitions
+
+bool diram_parser_transition(diram_parser_t* parser, diram_parser_state_t new_state) {
+    if (!parser) return false;
+    diram_parser_state_t state = parser->state;
+    bool allowed;
+    switch (new_state) {
+        case PARSER_STATE_DOCUMENT:
+            allowed = state == PARSER_STATE_INIT || (state > PARSER_STATE_DOCUMENT &&
+                                                     state < PARSER_STATE_ERROR);
+            break;
+        case PARSER_STATE_COMPLETE:
+            allowed = state == PARSER_STATE_DOCUMENT;
+            break;
+        case PARSER_STATE_ERROR:
+            allowed = true;
+            break;
+        case PARSER_STATE_INIT:
+            allowed = false;
+            break;
+        default:
+            // Sections open only from the document level
+            allowed = state == PARSER_STATE_DOCUMENT;
+            break;
+    }
+    if (!allowed) {
+        parser_fail(parser, NULL, "Invalid parser transition %d -> %d", (int)state, (int)new_state);
+        return false;
+    }
+    parser->state = new_state;
+    return true;
+}
+
+// Node emission
+
+static bool emit_node(diram_parser_t* parser, diram_ast_node_t* node) {
+    if (!node || !diram_ast_add_child(parser->root, node)) {
+        parser_fail(parser, NULL, "Out of memory");
+        return false;
+    }
+    return true;
+}
+
+static diram_ast_node_t* new_node(diram_parser_t* parser, diram_ast_node_type_t type) {
+    return diram_ast_arena_create_node(parser->arena, type);
+}
+
+bool diram_parser_emit_feature_toggle(diram_parser_t* parser, const char* name, bool enabled) {
+    if (!parser) return false;
+    diram_ast_node_t* node = new_node(parser, AST_NODE_FEATURE_TOGGLE);
+    if (node) {
+        node->data.feature.name = pool_string(parser, name);
+        node->data.feature.enabled = enabled;
+    }
+    return emit_node(parser, node);
+}
+
+bool diram_parser_emit_opcode(diram_parser_t* parser, const char* name, uint8_t code) {
+    if (!parser) return false;
+    if (!diram_parser_validate_opcode(code)) {
+        diram_parser_policy_violation(parser, "Opcode 0x00 is reserved");
+        if (parser->has_error) return false;
+    }
+    diram_ast_node_t* node = new_node(parser, AST_NODE_OPCODE);
+    if (node) {
+        node->data.opcode.name = pool_string(parser, name);
+        node->data.opcode.code = code;
+    }
+    return emit_node(parser, node);
+}
+
+bool diram_parser_emit_policy(diram_parser_t* parser, const char* name, const char* type) {
+    if (!parser) return false;
+    diram_ast_node_t* node = new_node(parser, AST_NODE_POLICY);
+    if (node) {
+        node->data.policy.name = pool_string(parser, name);
+        node->data.policy.type = pool_string(parser, type);
+        node->data.policy.enforced = true;
+    }
+    return emit_node(parser, node);
+}
+
+bool diram_parser_emit_memory_region(diram_parser_t* parser, const char* name,
+                                     uint64_t base, size_t size) {
+    if (!parser) return false;
+    diram_ast_node_t* node = new_node(parser, AST_NODE_MEMORY_REGION);
+    if (node) {
+        node->data.memory_region.name = pool_string(parser, name);
+        node->data.memory_region.base_address = base;
+        node->data.memory_region.size = size;
+    }
+    return emit_node(parser, node);
+}
+
+// Element handling
+
+static diram_parser_frame_t* top_frame(diram_parser_t* parser) {
+    return parser->depth ? &parser->stack[parser->depth - 1] : NULL;
+}
+
+static int classify_element(diram_parser_t* parser, const diram_token_t* token,
+                            const diram_parser_frame_t* parent) {
+    int parent_kind = parent ? parent->kind : ELEMENT_OTHER;
+    if (parent_kind == ELEMENT_SECTION) {
+        switch (parser->state) {
+            case PARSER_STATE_FEATURES:
+                if (token_is(parser, token, "toggle")) return ELEMENT_TOGGLE;
+                break;
+            case PARSER_STATE_OPCODES:
+                if (token_is(parser, token, "opcode")) return ELEMENT_OPCODE;
+                break;
+            case PARSER_STATE_POLICIES:
+                if (token_is(parser, token, "policy")) return ELEMENT_POLICY;
+                break;
+            case PARSER_STATE_MEMORY_REGIONS:
+                if (token_is(parser, token, "region")) return ELEMENT_REGION;
+                break;
+            case PARSER_STATE_BUILD:
+                if (token_is(parser, token, "target")) return ELEMENT_TARGET;
+                break;
+            default:
+                break;
+        }
+        return ELEMENT_OTHER;
+    }
+    if (parent_kind == ELEMENT_TOGGLE) {
+        if (token_is(parser, token, "description")) return ELEMENT_TOGGLE_DESCRIPTION;
+        if (token_is(parser, token, "policy")) return ELEMENT_TOGGLE_POLICY;
+        if (token_is(parser, token, "constraint")) return ELEMENT_TOGGLE_CONSTRAINT;
+        return ELEMENT_OTHER;
+    }
+    if (parent_kind == ELEMENT_POLICY && token_is(parser, token, "rule")) return ELEMENT_RULE;
+    if (parent_kind == ELEMENT_TARGET) {
+        if (token_is(parser, token, "compiler")) return ELEMENT_COMPILER;
+        if (token_is(parser, token, "flags")) return ELEMENT_FLAGS;
+        return ELEMENT_OTHER;
+    }
+
+    // <operand> and <heap_events> sit inside wrapper elements of an opcode;
+    // <target> inside <build><targets>
+    diram_ast_node_t* current = parser->current_node;
+    if (current && current->type == AST_NODE_OPCODE) {
+        if (token_is(parser, token, "operand")) return ELEMENT_OPERAND;
+        if (token_is(parser, token, "heap_events")) return ELEMENT_HEAP_EVENTS;
+    }
+    if (parser->state == PARSER_STATE_BUILD && !current && token_is(parser, token, "target")) {
+        return ELEMENT_TARGET;
+    }
+    return ELEMENT_OTHER;
+}
+
+// Name of the toggle or opcode being built
+static const char* owner_name(const diram_parser_t* parser) {
+    const diram_ast_node_t* owner = parser->current_node;
+    if (!owner) return NULL;
+    if (owner->type == AST_NODE_OPCODE) return owner->data.opcode.name;
+    if (owner->type == AST_NODE_FEATURE_TOGGLE) return owner->data.feature.name;
+    return NULL;
+}
+
+static diram_ast_node_t* create_for_element(diram_parser_t* parser, int kind,
+                                            const diram_token_t* token) {
+    diram_ast_node_t* node = NULL;
+    switch (kind) {
+        case ELEMENT_TOGGLE:
+            node = new_node(parser, AST_NODE_FEATURE_TOGGLE);
+            break;
+        case ELEMENT_OPCODE:
+            node = new_node(parser, AST_NODE_OPCODE);
+            break;
+        case ELEMENT_POLICY:
+            node = new_node(parser, AST_NODE_POLICY);
+            if (node) node->data.policy.enforced = true;
+            break;
+        case ELEMENT_REGION:
+            node = new_node(parser, AST_NODE_MEMORY_REGION);
+            break;
+        case ELEMENT_TARGET:
+            node = new_node(parser, AST_NODE_BUILD_TARGET);
+            break;
+        case ELEMENT_TOGGLE_CONSTRAINT:
+        case ELEMENT_HEAP_EVENTS:
+            // Named after the toggle or opcode it constrains
+            node = new_node(parser, AST_NODE_CONSTRAINT);
+            if (node) node->data.constraint.name = owner_name(parser);
+            break;
+        case ELEMENT_OPERAND: {
+            diram_ast_node_t* opcode = parser->current_node;
+            if (opcode->data.opcode.operand_count == UINT8_MAX) {
+                parser_fail(parser, token, "Too many operands");
+                return NULL;
+            }
+            node = new_node(parser, AST_NODE_OPERAND);
+            if (!node || !grow_array(parser, (void**)&opcode->data.opcode.operands,
+                                     opcode->data.opcode.operand_count,
+                                     sizeof(diram_ast_node_t*))) {
+                parser_fail(parser, token, "Out of memory");
+                return NULL;
+            }
+            node->parent = opcode;
+            node->data.operand.position = opcode->data.opcode.operand_count;
+            opcode->data.opcode.operands[opcode->data.opcode.operand_count++] = node;
+            return node;
+        }
+        default:
+            return NULL;
+    }
+    if (!emit_node(parser, node)) return NULL;
+    return node;
+}
+
+static bool start_element(diram_parser_t* parser, const diram_token_t* token) {
+    if (parser->depth == DIRAM_PARSER_MAX_DEPTH) {
+        parser_fail(parser, token, "Elements nested deeper than %d", DIRAM_PARSER_MAX_DEPTH);
+        return false;
+    }
+    diram_parser_frame_t* parent = top_frame(parser);
+    int kind = ELEMENT_OTHER;
+
+    if (!parent) {
+        if (parser->state != PARSER_STATE_INIT) {
+            parser_fail(parser, token, "Content after the document element");
+            return false;
+        }
+        if (parser->strict_mode && !token_is(parser, token, "diram-config")) {
+            parser_fail(parser, token, "Document element must be <diram-config>");
+            return false;
+        }
+        if (!diram_parser_transition(parser, PARSER_STATE_DOCUMENT)) return false;
+        kind = ELEMENT_DOCUMENT;
+    } else if (parent->kind == ELEMENT_DOCUMENT) {
+        for (size_t i = 0; i < sizeof(g_sections) / sizeof(g_sections[0]); i++) {
+            if (token_is(parser, token, g_sections[i].name)) {
+                if (!diram_parser_transition(parser, g_sections[i].state)) return false;
+                kind = ELEMENT_SECTION;
+                break;
+            }
+        }
+    } else if (parent->kind != ELEMENT_OTHER || parser->current_node ||
+               parser->state == PARSER_STATE_BUILD) {
+        kind = classify_element(parser, token, parent);
+    }
+
+    diram_ast_node_t* node = create_for_element(parser, kind, token);
+    if (parser->has_error) return false;
+    if (node && node->type != AST_NODE_CONSTRAINT && node->type != AST_NODE_OPERAND) {
+        parser->current_node = node;
+    }
+
+    diram_parser_frame_t* frame = &parser->stack[parser->depth++];
+    frame->name_offset = token->offset;
+    frame->name_length = token->length;
+    frame->kind = kind;
+    frame->node = node;
+    return true;
+}
+
+static bool require(diram_parser_t* parser, const diram_token_t* token, const void* field,
+                    const char* element, const char* attribute) {
+    if (field) return true;
+    parser_fail(parser, token, "<%s> requires %s", element, attribute);
+    return false;
+}
+
+static bool apply_attribute(diram_parser_t* parser, diram_parser_frame_t* frame,
+                            const diram_token_t* name, const diram_token_t* value) {
+    diram_ast_node_t* node = frame->node;
+    if (!node) return true;
+
+    uint64_t number;
+    bool flag;
+    switch (frame->kind) {
+        case ELEMENT_TOGGLE:
+            if (token_is(parser, name, "name")) {
+                node->data.feature.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "enabled")) {
+                if (!parse_bool(parser, value, &flag)) goto invalid;
+                node->data.feature.enabled = flag;
+            }
+            break;
+        case ELEMENT_OPCODE:
+            if (token_is(parser, name, "name")) {
+                node->data.opcode.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "code")) {
+                if (!parse_u64(parser, value, false, &number) || number > UINT8_MAX) goto invalid;
+                if (!diram_parser_validate_opcode((uint8_t)number)) {
+                    diram_parser_policy_violation(parser, "Opcode 0x00 is reserved");
+                    if (parser->has_error) return false;
+                }
+                node->data.opcode.code = (uint8_t)number;
+            }
+            break;
+        case ELEMENT_OPERAND:
+            if (token_is(parser, name, "name")) {
+                node->data.operand.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "type")) {
+                node->data.operand.type = pool_view(parser, value);
+            } else if (token_is(parser, name, "position")) {
+                if (!parse_u64(parser, value, false, &number) || number > UINT32_MAX) goto invalid;
+                node->data.operand.position = (uint32_t)number;
+            }
+            break;
+        case ELEMENT_HEAP_EVENTS:
+            if (token_is(parser, name, "max")) {
+                if (!parse_u64(parser, value, false, &number) || number > UINT32_MAX) goto invalid;
+                node->data.constraint.max_heap_events = (uint32_t)number;
+            }
+            break;
+        case ELEMENT_POLICY:
+            if (token_is(parser, name, "name")) {
+                node->data.policy.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "type")) {
+                node->data.policy.type = pool_view(parser, value);
+            } else if (token_is(parser, name, "enforced")) {
+                if (!parse_bool(parser, value, &flag)) goto invalid;
+                node->data.policy.enforced = flag;
+            }
+            break;
+        case ELEMENT_REGION:
+            if (token_is(parser, name, "name")) {
+                node->data.memory_region.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "base")) {
+                if (!parse_u64(parser, value, false, &number)) goto invalid;
+                node->data.memory_region.base_address = number;
+            } else if (token_is(parser, name, "size")) {
+                if (!parse_u64(parser, value, true, &number) || number > SIZE_MAX) goto invalid;
+                node->data.memory_region.size = (size_t)number;
+            } else if (token_is(parser, name, "protection")) {
+                const char* protection = pool_view(parser, value);
+                if (!protection) return false;
+                if (!diram_parser_validate_memory_protection(protection)) {
+                    diram_parser_policy_violation(parser, "Memory protection must be drawn from \"rwx\"");
+                    if (parser->has_error) return false;
+                }
+                node->data.memory_region.protection_flags = protection_flags(protection);
+            }
+            break;
+        case ELEMENT_TARGET:
+            if (token_is(parser, name, "name")) {
+                node->data.build_target.name = pool_view(parser, value);
+            } else if (token_is(parser, name, "platform")) {
+                node->data.build_target.platform = pool_view(parser, value);
+            }
+            break;
+        default:
+            break;
+    }
+    return !parser->has_error;
+
+invalid:
+    parser_fail(parser, value, "Invalid value for attribute %.*s",
+                (int)name->length, parser->input + name->offset);
+    return false;
+}
+
+static bool apply_text(diram_parser_t* parser, const diram_token_t* token) {
+    diram_parser_frame_t* frame = top_frame(parser);
+    if (!frame) {
+        parser_fail(parser, token, "Text outside the document element");
+        return false;
+    }
+
+    diram_ast_node_t* owner = parser->current_node;
+    switch (frame->kind) {
+        case ELEMENT_TOGGLE_DESCRIPTION:
+            if (!owner->data.feature.description) owner->data.feature.description = pool_view(parser, token);
+            break;
+        case ELEMENT_TOGGLE_POLICY:
+            if (!owner->data.feature.policy) owner->data.feature.policy = pool_view(parser, token);
+            break;
+        case ELEMENT_TOGGLE_CONSTRAINT: {
+            const char* text = pool_view(parser, token);
+            if (!text) return false;
+            if (!diram_parser_validate_constraint(text)) {
+                diram_parser_policy_violation(parser, "Constraint must be epsilon_limit=<0..1>");
+                if (parser->has_error) return false;
+            }
+            const char* eq = strchr(text, '=');
+            if (eq) frame->node->data.constraint.epsilon_value = strtod(eq + 1, NULL);
+            break;
+        }
+        case ELEMENT_RULE: {
+            const char* rule = pool_view(parser, token);
+            if (!rule) return false;
+            if (!grow_array(parser, (void**)&owner->data.policy.rules, owner->data.policy.rule_count,
+                            sizeof(char*))) {
+                parser_fail(parser, token, "Out of memory");
+                return false;
+            }
+            owner->data.policy.rules[owner->data.policy.rule_count++] = (char*)rule;
+            break;
+        }
+        case ELEMENT_COMPILER:
+            if (!owner->data.build_target.compiler) owner->data.build_target.compiler = pool_view(parser, token);
+            break;
+        case ELEMENT_FLAGS:
+            if (!owner->data.build_target.flags) owner->data.build_target.flags = pool_view(parser, token);
+            break;
+        default:
+            break;
+    }
+    return !parser->has_error;
+}
+
+// Required attributes are known once the start tag has closed
+static bool check_element(diram_parser_t* parser, const diram_parser_frame_t* frame,
+                          const diram_token_t* token) {
+    const diram_ast_node_t* node = frame->node;
+    if (!node) return true;
+    switch (frame->kind) {
+        case ELEMENT_TOGGLE:
+            return require(parser, token, node->data.feature.name, "toggle", "name");
+        case ELEMENT_OPCODE:
+            return require(parser, token, node->data.opcode.name, "opcode", "name");
+        case ELEMENT_OPERAND:
+            return require(parser, token, node->data.operand.name, "operand", "name");
+        case ELEMENT_POLICY:
+            return require(parser, token, node->data.policy.name, "policy", "name") &&
+                   require(parser, token, node->data.policy.type, "policy", "type");
+        case ELEMENT_REGION:
+            return require(parser, token, node->data.memory_region.name, "region", "name") &&
+                   require(parser, token, node->data.memory_region.size ? node : NULL,
+                           "region", "a non-zero size");
+        case ELEMENT_TARGET:
+            return require(parser, token, node->data.build_target.name, "target", "name");
+        default:
+            return true;
+    }
+}
+
+static bool end_element(diram_parser_t* parser, const diram_token_t* token) {
+    diram_parser_frame_t* frame = top_frame(parser);
+    if (!frame) {
+        parser_fail(parser, token, "Unexpected end tag");
+        return false;
+    }
+    // Self-closing tags end with an empty name
+    if (token->length &&
+        !(token->length == frame->name_length &&
+          memcmp(parser->input + token->offset, parser->input + frame->name_offset,
+                 token->length) == 0)) {
+        parser_fail(parser, token, "Mismatched </%.*s>, expected </%.*s>",
+                    (int)token->length, parser->input + token->offset,
+                    (int)frame->name_length, parser->input + frame->name_offset);
+        return false;
+    }
+    if (!check_element(parser, frame, token)) return false;
+
+    parser->depth--;
+    if (frame->node && frame->node == parser->current_node) parser->current_node = NULL;
+    if (frame->kind == ELEMENT_SECTION) return diram_parser_transition(parser, PARSER_STATE_DOCUMENT);
+    if (frame->kind == ELEMENT_DOCUMENT) return diram_parser_transition(parser, PARSER_STATE_COMPLETE);
+    return true;
+}
+
+bool diram_parser_consume_token(diram_parser_t* parser, diram_token_t* token) {
+    if (!parser || !token) return false;
+    if (parser->has_error) return false;
+
+    switch (token->type) {
+        case TOKEN_ELEMENT_START:
+            return start_element(parser, token);
+        case TOKEN_ELEMENT_END:
+            return end_element(parser, token);
+        case TOKEN_ATTRIBUTE_NAME:
+            parser->pending_attribute = *token;
+            return true;
+        case TOKEN_ATTRIBUTE_VALUE: {
+            diram_parser_frame_t* frame = top_frame(parser);
+            if (!frame || parser->pending_attribute.type != TOKEN_ATTRIBUTE_NAME) {
+                parser_fail(parser, token, "Attribute value without a name");
+                return false;
+            }
+            diram_token_t name = parser->pending_attribute;
+            parser->pending_attribute.type = TOKEN_NONE;
+            return apply_attribute(parser, frame, &name, token);
+        }
+        case TOKEN_TEXT:
+            return apply_text(parser, token);
+        case TOKEN_XML_START:
+            // The declaration and processing instructions carry nothing we use
+            return true;
+        case TOKEN_EOF:
+            if (parser->depth) {
+                diram_parser_frame_t* frame = top_frame(parser);
+                parser_fail(parser, token, "Unexpected end of input inside <%.*s>",
+                            (int)frame->name_length, parser->input + frame->name_offset);
+                return false;
+            }
+            if (parser->state != PARSER_STATE_COMPLETE) {
+                parser_fail(parser, token, "No document element");
+                return false;
+            }
+            return true;
+        case TOKEN_ERROR:
+            parser_fail(parser, token, "%s", diram_tokenizer_get_error(parser->tokenizer));
+            return false;
+        default:
+            parser_fail(parser, token, "Unexpected %s token", diram_token_type_to_string(token->type));
+            return false;
+    }
+}
+
+diram_ast_node_t* diram_parser_parse(diram_parser_t* parser) {
+    if (!parser) return NULL;
+    if (parser->state == PARSER_STATE_COMPLETE) return parser->root;
+
+    for (;;) {
+        diram_token_t token = diram_tokenizer_next(parser->tokenizer);
+        if (!diram_parser_consume_token(parser, &token)) return NULL;
+        if (token.type == TOKEN_EOF) break;
+    }
+    // Lay the finished tree out breadth-first; if there is no memory for
+    // that, the block-built tree is just as valid
+    diram_ast_arena_compact(parser->arena, &parser->root);
+    parser->current_node = NULL;
+    return parser->root;
+}
+
+// Policy violation handling
+
+void diram_parser_set_policy_handler(diram_parser_t* parser,
+                                     void (*handler)(const char*)) {
+    if (parser) parser->policy_violation_handler = handler;
+}
+
+// The handler is told either way; with validate_policies the parse fails
+void diram_parser_policy_violation(diram_parser_t* parser, const char* violation) {
+    if (!parser) return;
+    if (parser->policy_violation_handler) parser->policy_violation_handler(violation);
+    if (parser->validate_policies) {
+        diram_tokenizer_t* tokenizer = parser->tokenizer;
+        diram_token_t at = { .line = tokenizer->line, .column = tokenizer->column };
+        parser_fail(parser, &at, "Policy violation: %s", violation);
+    }
+}
+
+// Error handling
+
+bool diram_parser_has_error(const diram_parser_t* parser) {
+    return parser && parser->has_error;
+}
+
+const char* diram_parser_get_error(const diram_parser_t* parser) {
+    return parser ? parser->error_message : "No parser";
+}
+
+// Parser utilities
+
+// epsilon_limit=<value> with the value in [0, 1]
+bool diram_parser_validate_constraint(const char* constraint) {
+    if (!constraint) return false;
+    const char* eq = strchr(constraint, '=');
+    if (!eq || eq == constraint) return false;
+    char* end;
+    double value = strtod(eq + 1, &end);
+    if (end == eq + 1 || *end != '\0') return false;
+    return value >= 0.0 && value <= 1.0;
+}
+
+// 0x00 is reserved as the nil opcode
+bool diram_parser_validate_opcode(uint8_t code) {
+    return code != 0;
+}
+
+bool diram_parser_validate_memory_protection(const char* protection) {
+    if (!protection || !*protection) return false;
+    uint8_t seen = 0;
+    for (const char* p = protection; *p; p++) {
+        uint8_t flag = *p == 'r' ? 4 : *p == 'w' ? 2 : *p == 'x' ? 1 : 0;
+        if (!flag || (seen & flag)) return false;
+        seen |= flag;
+    }
+    return true;
+}
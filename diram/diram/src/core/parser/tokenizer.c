@@ -1,3 +1,423 @@
-/* Stub for src/core/parser/tokenizer.c */
+// src/core/parser/tokenizer.c
+// DIRAM XML Tokenizer - zero-copy streaming scanner
+// OBINexus Aegis Project
+//
+// Tokens are (offset, length) views into the caller's buffer; nothing is
+// copied or allocated per token. Text, attribute values and comments are
+// skipped with a 16-byte SIMD search for the next delimiter, and newlines
+// are counted the same way, only up to where a token starts.
+
+#include "diram/core/parser/tokenizer.h"
 #include <stdio.h>
-// TODO: Implement
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// SIMD scanning
+
+// First of the delimiter bytes a..d in [p, end), or end
+static const char* find_delimiter(const char* p, const char* end,
+                                  char a, char b, char c, char d) {
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c), vd = _mm_set1_epi8(d);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, vc), _mm_cmpeq_epi8(v, vd)));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask) return p + __builtin_ctz((unsigned)mask);
+        p += 16;
+    }
+#elif defined(__aarch64__)
+    const uint8x16_t va = vdupq_n_u8((uint8_t)a), vb = vdupq_n_u8((uint8_t)b);
+    const uint8x16_t vc = vdupq_n_u8((uint8_t)c), vd = vdupq_n_u8((uint8_t)d);
+    while (end - p >= 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t*)p);
+        uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, va), vceqq_u8(v, vb)),
+                                  vorrq_u8(vceqq_u8(v, vc), vceqq_u8(v, vd)));
+        if (vmaxvq_u8(hit)) break;      // Found in this block; locate below
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == a || *p == b || *p == c || *p == d) return p;
+    }
+    return end;
+}
+
+static const char* find_char(const char* p, const char* end, char c) {
+    return find_delimiter(p, end, c, c, c, c);
+}
+
+static size_t count_newlines(const char* p, const char* end) {
+    size_t count = 0;
+#if defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        count += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+        p += 16;
+    }
+#elif defined(__aarch64__)
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    const uint8x16_t one = vdupq_n_u8(1);
+    while (end - p >= 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t*)p);
+        count += vaddvq_u8(vandq_u8(vceqq_u8(v, nl), one));
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) count += (*p == '\n');
+    return count;
+}
+
+// Tokenizer lifecycle
+
+diram_tokenizer_t* diram_tokenizer_create(const char* input, size_t length) {
+    if (!input && length) return NULL;
+    diram_tokenizer_t* tokenizer = calloc(1, sizeof(diram_tokenizer_t));
+    if (!tokenizer) return NULL;
+    tokenizer->input = input ? input : "";
+    tokenizer->length = length;
+    tokenizer->line = 1;
+    tokenizer->column = 1;
+    return tokenizer;
+}
+
+void diram_tokenizer_destroy(diram_tokenizer_t* tokenizer) {
+    free(tokenizer);
+}
+
+bool diram_tokenizer_has_error(const diram_tokenizer_t* tokenizer) {
+    return tokenizer && tokenizer->has_error;
+}
+
+const char* diram_tokenizer_get_error(const diram_tokenizer_t* tokenizer) {
+    return tokenizer ? tokenizer->error_buffer : "No tokenizer";
+}
+
+// Scanning state
+
+// Bring line/column up to offset; only the bytes since the last token are counted
+static void sync_position(diram_tokenizer_t* tokenizer, size_t offset) {
+    if (offset > tokenizer->line_scanned) {
+        const char* base = tokenizer->input;
+        size_t lines = count_newlines(base + tokenizer->line_scanned, base + offset);
+        if (lines) {
+            size_t last = offset;
+            while (last > tokenizer->line_scanned && base[last - 1] != '\n') last--;
+            tokenizer->line += (uint32_t)lines;
+            tokenizer->line_start = last;
+        }
+        tokenizer->line_scanned = offset;
+    }
+    tokenizer->column = (uint32_t)(offset - tokenizer->line_start + 1);
+}
+
+static diram_token_t make_token(diram_tokenizer_t* tokenizer, diram_token_type_t type,
+                                size_t offset, size_t length) {
+    diram_token_t token;
+    memset(&token, 0, sizeof(token));
+    sync_position(tokenizer, offset);
+    token.type = type;
+    token.memory = (type == TOKEN_ATTRIBUTE_VALUE || type == TOKEN_TEXT) ?
+                   MEMORY_CONSTANT : MEMORY_NONE;
+    token.value.string_value.data = (char*)(tokenizer->input + offset);
+    token.value.string_value.length = length;
+    token.line = tokenizer->line;
+    token.column = tokenizer->column;
+    token.offset = offset;
+    token.length = length;
+    return token;
+}
+
+static diram_token_t fail(diram_tokenizer_t* tokenizer, size_t offset, const char* message) {
+    diram_token_t token = make_token(tokenizer, TOKEN_ERROR, offset, 0);
+    if (!tokenizer->has_error) {
+        snprintf(tokenizer->error_buffer, sizeof(tokenizer->error_buffer),
+                 "%u:%u: %s", token.line, token.column, message);
+        tokenizer->has_error = true;
+    }
+    tokenizer->position = tokenizer->length;
+    return token;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == ':' || c == '.' || (unsigned char)c >= 0x80;
+}
+
+static size_t skip_space(const diram_tokenizer_t* tokenizer, size_t pos) {
+    while (pos < tokenizer->length && is_space(tokenizer->input[pos])) pos++;
+    return pos;
+}
+
+static size_t scan_name(const diram_tokenizer_t* tokenizer, size_t pos) {
+    while (pos < tokenizer->length && is_name_char(tokenizer->input[pos])) pos++;
+    return pos;
+}
+
+static bool starts_with(const diram_tokenizer_t* tokenizer, size_t pos, const char* text) {
+    size_t length = strlen(text);
+    return tokenizer->length - pos >= length && memcmp(tokenizer->input + pos, text, length) == 0;
+}
+
+// Offset of terminator at or after pos (terminator ends with '>'), or length
+static size_t find_terminator(const diram_tokenizer_t* tokenizer, size_t pos, const char* terminator) {
+    const char* end = tokenizer->input + tokenizer->length;
+    size_t tail = strlen(terminator) - 1;
+    if (tokenizer->length - pos <= tail) return tokenizer->length;
+    for (const char* p = tokenizer->input + pos + tail; (p = find_char(p, end, '>')) < end; p++) {
+        size_t at = (size_t)(p - tokenizer->input) - tail;
+        if (at >= pos && memcmp(tokenizer->input + at, terminator, tail) == 0) return at;
+    }
+    return tokenizer->length;
+}
+
+// Inside a start tag: attribute names, values, '>' and '/>'
+static diram_token_t next_in_element(diram_tokenizer_t* tokenizer) {
+    const char* input = tokenizer->input;
+    size_t pos = skip_space(tokenizer, tokenizer->position);
+    if (pos >= tokenizer->length) return fail(tokenizer, pos, "Unterminated start tag");
+
+    if (tokenizer->in_attribute) {
+        char quote = input[pos];
+        if (quote != '"' && quote != '\'') return fail(tokenizer, pos, "Expected quoted attribute value");
+        const char* close = find_delimiter(input + pos + 1, input + tokenizer->length,
+                                           quote, quote, '<', quote);
+        if (close >= input + tokenizer->length) return fail(tokenizer, pos, "Unterminated attribute value");
+        if (*close != quote) return fail(tokenizer, (size_t)(close - input), "'<' in attribute value");
+        size_t end = (size_t)(close - input);
+        tokenizer->in_attribute = false;
+        tokenizer->position = end + 1;
+        return make_token(tokenizer, TOKEN_ATTRIBUTE_VALUE, pos + 1, end - pos - 1);
+    }
+
+    if (input[pos] == '>') {
+        tokenizer->in_element = false;
+        tokenizer->position = pos + 1;
+        return diram_tokenizer_next(tokenizer);
+    }
+    if (input[pos] == '/') {
+        if (pos + 1 >= tokenizer->length || input[pos + 1] != '>') {
+            return fail(tokenizer, pos, "Expected '>' after '/'");
+        }
+        // Self-closing: an end token with an empty name
+        tokenizer->in_element = false;
+        tokenizer->position = pos + 2;
+        return make_token(tokenizer, TOKEN_ELEMENT_END, pos, 0);
+    }
+
+    size_t end = scan_name(tokenizer, pos);
+    if (end == pos) return fail(tokenizer, pos, "Expected attribute name");
+    size_t eq = skip_space(tokenizer, end);
+    if (eq >= tokenizer->length || input[eq] != '=') {
+        return fail(tokenizer, eq, "Expected '=' after attribute name");
+    }
+    tokenizer->in_attribute = true;
+    tokenizer->position = eq + 1;
+    return make_token(tokenizer, TOKEN_ATTRIBUTE_NAME, pos, end - pos);
+}
+
+diram_token_t diram_tokenizer_next(diram_tokenizer_t* tokenizer) {
+    if (!tokenizer) {
+        diram_token_t token;
+        memset(&token, 0, sizeof(token));
+        token.type = TOKEN_ERROR;
+        return token;
+    }
+    if (tokenizer->has_error) return make_token(tokenizer, TOKEN_ERROR, tokenizer->position, 0);
+
+    const char* input = tokenizer->input;
+    size_t length = tokenizer->length;
+    for (;;) {
+        if (tokenizer->in_element) return next_in_element(tokenizer);
+
+        size_t pos = tokenizer->position;
+        if (pos >= length) return make_token(tokenizer, TOKEN_EOF, length, 0);
+
+        if (input[pos] != '<') {
+            // Character data up to the next tag; whitespace-only runs are skipped
+            size_t end = (size_t)(find_char(input + pos, input + length, '<') - input);
+            tokenizer->position = end;
+            size_t start = skip_space(tokenizer, pos);
+            if (start == end) continue;
+            while (end > start && is_space(input[end - 1])) end--;
+            tokenizer->in_text = true;
+            return make_token(tokenizer, TOKEN_TEXT, start, end - start);
+        }
+        tokenizer->in_text = false;
+
+        if (starts_with(tokenizer, pos, "<!--")) {
+            size_t end = find_terminator(tokenizer, pos + 4, "-->");
+            if (end >= length) return fail(tokenizer, pos, "Unterminated comment");
+            tokenizer->position = end + 3;
+            continue;
+        }
+        if (starts_with(tokenizer, pos, "<![CDATA[")) {
+            size_t end = find_terminator(tokenizer, pos + 9, "]]>");
+            if (end >= length) return fail(tokenizer, pos, "Unterminated CDATA section");
+            tokenizer->position = end + 3;
+            return make_token(tokenizer, TOKEN_TEXT, pos + 9, end - pos - 9);
+        }
+        if (starts_with(tokenizer, pos, "<?")) {
+            size_t end = find_terminator(tokenizer, pos + 2, "?>");
+            if (end >= length) return fail(tokenizer, pos, "Unterminated processing instruction");
+            tokenizer->position = end + 2;
+            return make_token(tokenizer, TOKEN_XML_START, pos + 2, end - pos - 2);
+        }
+        if (starts_with(tokenizer, pos, "<!")) {
+            // DOCTYPE and friends; internal subsets are not supported
+            size_t end = find_terminator(tokenizer, pos + 2, ">");
+            if (end >= length) return fail(tokenizer, pos, "Unterminated declaration");
+            tokenizer->position = end + 1;
+            continue;
+        }
+        if (starts_with(tokenizer, pos, "</")) {
+            size_t end = scan_name(tokenizer, pos + 2);
+            if (end == pos + 2) return fail(tokenizer, pos, "Expected element name after '</'");
+            size_t close = skip_space(tokenizer, end);
+            if (close >= length || input[close] != '>') return fail(tokenizer, close, "Expected '>'");
+            tokenizer->position = close + 1;
+            return make_token(tokenizer, TOKEN_ELEMENT_END, pos + 2, end - pos - 2);
+        }
+
+        size_t end = scan_name(tokenizer, pos + 1);
+        if (end == pos + 1) return fail(tokenizer, pos, "Expected element name after '<'");
+        tokenizer->in_element = true;
+        tokenizer->position = end;
+        return make_token(tokenizer, TOKEN_ELEMENT_START, pos + 1, end - pos - 1);
+    }
+}
+
+// Views
+
+size_t diram_token_copy(const diram_tokenizer_t* tokenizer, const diram_token_t* token,
+                        char* out, size_t size) {
+    if (!size) return 0;
+    size_t length = token->length < size - 1 ? token->length : size - 1;
+    if (tokenizer && token->offset + length <= tokenizer->length) {
+        memcpy(out, tokenizer->input + token->offset, length);
+    } else {
+        length = 0;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+bool diram_token_equals(const diram_tokenizer_t* tokenizer, const diram_token_t* token,
+                        const char* text) {
+    size_t length = strlen(text);
+    return tokenizer && token->length == length &&
+           token->offset + length <= tokenizer->length &&
+           memcmp(tokenizer->input + token->offset, text, length) == 0;
+}
+
+// Nothing to release: tokens only view the input
+void diram_token_free(diram_token_t* token) {
+    if (token) memset(token, 0, sizeof(*token));
+}
+
+// Token utilities
+
+const char* diram_token_type_to_string(diram_token_type_t type) {
+    switch (type) {
+        case TOKEN_NONE:            return "NONE";
+        case TOKEN_XML_START:       return "XML_START";
+        case TOKEN_XML_END:         return "XML_END";
+        case TOKEN_ELEMENT_START:   return "ELEMENT_START";
+        case TOKEN_ELEMENT_END:     return "ELEMENT_END";
+        case TOKEN_ATTRIBUTE_NAME:  return "ATTRIBUTE_NAME";
+        case TOKEN_ATTRIBUTE_VALUE: return "ATTRIBUTE_VALUE";
+        case TOKEN_TEXT:            return "TEXT";
+        case TOKEN_MEMORY_REGION:   return "MEMORY_REGION";
+        case TOKEN_OPCODE:          return "OPCODE";
+        case TOKEN_OPERAND:         return "OPERAND";
+        case TOKEN_POLICY_FLAG:     return "POLICY_FLAG";
+        case TOKEN_FEATURE_TOGGLE:  return "FEATURE_TOGGLE";
+        case TOKEN_CONSTRAINT:      return "CONSTRAINT";
+        case TOKEN_NIL_TYPE:        return "NIL_TYPE";
+        case TOKEN_INTEGER:         return "INTEGER";
+        case TOKEN_HEX_VALUE:       return "HEX_VALUE";
+        case TOKEN_BOOLEAN:         return "BOOLEAN";
+        case TOKEN_STRING:          return "STRING";
+        case TOKEN_IDENTIFIER:      return "IDENTIFIER";
+        case TOKEN_EOF:             return "EOF";
+        case TOKEN_ERROR:           return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+const char* diram_token_memory_to_string(diram_token_memory_t memory) {
+    switch (memory) {
+        case MEMORY_NONE:         return "none";
+        case MEMORY_SYSTEM:       return "system";
+        case MEMORY_USERSPACE:    return "userspace";
+        case MEMORY_TRACE_BUFFER: return "trace_buffer";
+        case MEMORY_HEAP:         return "heap";
+        case MEMORY_STACK:        return "stack";
+        case MEMORY_REGISTER:     return "register";
+        case MEMORY_CONSTANT:     return "constant";
+        case MEMORY_VIRTUAL:      return "virtual";
+    }
+    return "unknown";
+}
+
+static bool in_list(const char* name, const char* const* list) {
+    if (!name) return false;
+    for (; *list; list++) {
+        if (strcmp(name, *list) == 0) return true;
+    }
+    return false;
+}
+
+bool diram_tokenizer_is_element_name(const char* name) {
+    static const char* const elements[] = {
+        "diram-config", "metadata", "project", "author", "created", "governance",
+        "features", "toggle", "description", "policy", "constraint", "algorithm",
+        "log_path", "default_space", "opcodes", "opcode", "operands", "operand",
+        "constraints", "heap_events", "alignment", "output", "policies", "rule",
+        "memory_regions", "region", "build", "output_dir", "targets", "target",
+        "compiler", "flags", NULL
+    };
+    return in_list(name, elements);
+}
+
+bool diram_tokenizer_is_attribute_name(const char* name) {
+    static const char* const attributes[] = {
+        "version", "xmlns", "name", "enabled", "code", "type", "position", "max",
+        "base", "size", "protection", "platform", "enforced", NULL
+    };
+    return in_list(name, attributes);
+}
+
+diram_token_memory_t diram_tokenizer_classify_memory(const char* region_name) {
+    static const struct {
+        const char* name;
+        diram_token_memory_t memory;
+    } regions[] = {
+        { "system", MEMORY_SYSTEM },
+        { "userspace", MEMORY_USERSPACE },
+        { "trace_buffer", MEMORY_TRACE_BUFFER },
+        { "heap", MEMORY_HEAP },
+        { "stack", MEMORY_STACK },
+        { "register", MEMORY_REGISTER },
+        { "constant", MEMORY_CONSTANT },
+        { "virtual", MEMORY_VIRTUAL }
+    };
+    if (!region_name) return MEMORY_NONE;
+    for (size_t i = 0; i < sizeof(regions) / sizeof(regions[0]); i++) {
+        if (strcmp(region_name, regions[i].name) == 0) return regions[i].memory;
+    }
+    return MEMORY_VIRTUAL;
+}
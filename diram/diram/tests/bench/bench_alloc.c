@@ -0,0 +1,232 @@
+// tests/bench/bench_alloc.c
+// Allocation latency across the feature-alloc paths: traced, enhanced and
+// async (enhanced on the worker pool), swept over payload size, thread
+// count, tracing and zero-trust. Every operation is an allocate, a touch of
+// the first and last byte, and a free, timed individually.
+//
+// Usage: bench_alloc [results.json]   (BENCH_OPS overrides the op count)
+#include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/feature_alloc.h"
+#include "diram/core/feature-alloc/async_promise.h"
+#include "diram/core/feature-alloc/async_pool.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "diram/core/config/config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_OPS 20000
+#define BENCH_MAX_THREADS 8
+
+typedef enum { PATH_TRACED, PATH_ENHANCED, PATH_ASYNC } bench_path_t;
+
+static const char* const g_path_names[] = { "traced", "enhanced", "async" };
+static const size_t g_sizes[] = { 64, 1024, 16384, 262144 };
+static const int g_threads[] = { 1, 2, 4 };
+
+typedef struct {
+    bench_path_t path;
+    size_t size;
+    int threads;
+    int trace;
+    int zero_trust;
+    size_t ops;                 // Total across threads
+} bench_config_t;
+
+typedef struct {
+    const bench_config_t* config;
+    pthread_barrier_t* start;
+    uint64_t* latency;          // ops / threads samples
+    size_t count;
+    size_t failures;
+} bench_worker_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_op(const bench_config_t* config) {
+    // One allocation per command epoch, as a request loop would run it
+    diram_heap_epoch_begin();
+
+    if (config->path == PATH_TRACED) {
+        diram_allocation_t* alloc = diram_alloc_traced(config->size, "bench");
+        if (!alloc) return -1;
+        ((char*)alloc->base_addr)[0] = 1;
+        ((char*)alloc->base_addr)[config->size - 1] = 1;
+        diram_free_traced(alloc);
+        return 0;
+    }
+
+    diram_enhanced_allocation_t* alloc = NULL;
+    diram_async_promise_t* promise = NULL;
+    if (config->path == PATH_ENHANCED) {
+        alloc = diram_alloc_enhanced(config->size, "bench", NULL);
+    } else {
+        promise = diram_alloc_with_lookahead(config->size, "bench", NULL, 0);
+        if (promise && diram_promise_await(promise, 10000) == 0) {
+            alloc = promise->result.resolved_allocation;
+        }
+    }
+    if (alloc) {
+        // Canaries occupy the ends in zero-trust mode; touch just inside
+        char* base = alloc->base.base_addr;
+        base[config->size / 2] = 1;
+        diram_free_enhanced(alloc);
+    }
+    diram_promise_destroy(promise);
+    return alloc ? 0 : -1;
+}
+
+static void* bench_worker_main(void* arg) {
+    bench_worker_t* worker = (bench_worker_t*)arg;
+    pthread_barrier_wait(worker->start);
+
+    for (size_t i = 0; i < worker->count; i++) {
+        uint64_t start = now_ns();
+        if (bench_op(worker->config) < 0) worker->failures++;
+        worker->latency[i] = now_ns() - start;
+    }
+    return NULL;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void apply_config(const bench_config_t* config) {
+    diram_feature_config_t features = *diram_feature_get_config();
+    features.zero_trust_mode = config->zero_trust;
+    features.enable_guard_pages = config->zero_trust;
+    features.enable_canary_values = config->zero_trust;
+    diram_feature_configure(&features);
+    g_diram_config.guard_pages = config->zero_trust;
+
+    if (config->trace) {
+        diram_trace_ring_start(DIRAM_TRACE_FORMAT_BINARY, "/dev/null");
+    }
+}
+
+static void reset_config(const bench_config_t* config) {
+    if (config->trace) {
+        diram_trace_ring_stop();
+    }
+}
+
+static int run(const bench_config_t* config, FILE* json, int first) {
+    bench_worker_t workers[BENCH_MAX_THREADS];
+    pthread_t threads[BENCH_MAX_THREADS];
+    pthread_barrier_t start;
+    size_t per_thread = config->ops / (size_t)config->threads;
+    size_t total = per_thread * (size_t)config->threads;
+
+    uint64_t* latency = malloc(total * sizeof(uint64_t));
+    if (!latency) return -1;
+
+    apply_config(config);
+    pthread_barrier_init(&start, NULL, (unsigned)config->threads + 1);
+    for (int t = 0; t < config->threads; t++) {
+        workers[t] = (bench_worker_t){
+            .config = config,
+            .start = &start,
+            .latency = latency + (size_t)t * per_thread,
+            .count = per_thread
+        };
+        pthread_create(&threads[t], NULL, bench_worker_main, &workers[t]);
+    }
+
+    pthread_barrier_wait(&start);
+    uint64_t begin = now_ns();
+    size_t failures = 0;
+    for (int t = 0; t < config->threads; t++) {
+        pthread_join(threads[t], NULL);
+        failures += workers[t].failures;
+    }
+    uint64_t elapsed = now_ns() - begin;
+    pthread_barrier_destroy(&start);
+    reset_config(config);
+
+    qsort(latency, total, sizeof(uint64_t), cmp_u64);
+    double ops_per_sec = total / (elapsed / 1e9);
+    uint64_t p50 = latency[total / 2];
+    uint64_t p99 = latency[(total * 99) / 100];
+    uint64_t p999 = latency[(total * 999) / 1000];
+
+    printf("%-8s %7zu B  %d thr  trace=%d zt=%d  %10.0f ops/s  p50=%7llu p99=%8llu p999=%8llu ns%s\n",
+           g_path_names[config->path], config->size, config->threads,
+           config->trace, config->zero_trust, ops_per_sec,
+           (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999,
+           failures ? "  (failures)" : "");
+
+    if (json) {
+        fprintf(json,
+                "%s    {\"path\": \"%s\", \"size\": %zu, \"threads\": %d, "
+                "\"trace\": %s, \"zero_trust\": %s, \"async\": %s, "
+                "\"ops\": %zu, \"failures\": %zu, \"ops_per_sec\": %.0f, "
+                "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu}",
+                first ? "" : ",\n", g_path_names[config->path], config->size,
+                config->threads, config->trace ? "true" : "false",
+                config->zero_trust ? "true" : "false",
+                config->path == PATH_ASYNC ? "true" : "false",
+                total, failures, ops_per_sec, (unsigned long long)p50,
+                (unsigned long long)p99, (unsigned long long)p999);
+    }
+
+    free(latency);
+    return failures ? -1 : 0;
+}
+
+int main(int argc, char** argv) {
+    const char* json_path = argc > 1 ? argv[1] : "bench_alloc.json";
+    size_t ops = BENCH_DEFAULT_OPS;
+    const char* env_ops = getenv("BENCH_OPS");
+    if (env_ops && strtoul(env_ops, NULL, 10) > 0) {
+        ops = strtoul(env_ops, NULL, 10);
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (!json) {
+        fprintf(stderr, "cannot write %s\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\n  \"suite\": \"diram-feature-alloc\",\n  \"timestamp\": %lld,\n"
+                  "  \"cpus\": %ld,\n  \"sha256_impl\": \"%s\",\n  \"results\": [\n",
+            (long long)time(NULL), sysconf(_SC_NPROCESSORS_ONLN),
+            diram_sha256_impl_name(diram_sha256_get_impl()));
+
+    int failed = 0, first = 1;
+    for (int path = PATH_TRACED; path <= PATH_ASYNC; path++) {
+        for (size_t s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); s++) {
+            for (size_t t = 0; t < sizeof(g_threads) / sizeof(g_threads[0]); t++) {
+                for (int trace = 0; trace <= 1; trace++) {
+                    // Zero-trust only changes the enhanced allocation
+                    for (int zt = 0; zt <= (path == PATH_TRACED ? 0 : 1); zt++) {
+                        bench_config_t config = {
+                            .path = (bench_path_t)path,
+                            .size = g_sizes[s],
+                            .threads = g_threads[t],
+                            .trace = trace,
+                            .zero_trust = zt,
+                            // A pool round trip costs far more than an allocation
+                            .ops = path == PATH_ASYNC ? ops / 4 : ops
+                        };
+                        if (run(&config, json, first) < 0) failed = 1;
+                        first = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    diram_async_pool_shutdown();
+    printf("results: %s\n", json_path);
+    return failed;
+}
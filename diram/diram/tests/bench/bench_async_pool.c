@@ -0,0 +1,145 @@
+// tests/bench/bench_async_pool.c
+// Dispatch latency of async allocation work: thread-per-promise (the old
+// diram_alloc_with_lookahead path) versus the work-stealing async pool.
+// Both executors run the same task: a slab allocation of the promise
+// tracker size, a receipt hash and a free.
+//
+// Usage: bench_async_pool [results.json]
+#include "diram/core/feature-alloc/async_pool.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "diram/core/feature-alloc/slab.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+
+#define BENCH_REQUESTS 20000
+#define BENCH_WINDOW 64         // Outstanding requests, like a request loop
+#define BENCH_PAYLOAD 256
+
+typedef struct {
+    uint64_t submit_ns;
+    uint64_t done_ns;
+} bench_slot_t;
+
+static bench_slot_t g_slots[BENCH_REQUESTS];
+static atomic_size_t g_in_flight;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_task(void* arg) {
+    bench_slot_t* slot = (bench_slot_t*)arg;
+    char receipt[DIRAM_SHA256_DIGEST_LEN * 2 + 1];
+
+    void* block = diram_slab_alloc(BENCH_PAYLOAD);
+    if (block) {
+        memset(block, 0x5A, BENCH_PAYLOAD);
+        diram_receipt_hex(block, 88, receipt);
+        diram_slab_free(block);
+    }
+
+    slot->done_ns = now_ns();
+    atomic_fetch_sub_explicit(&g_in_flight, 1, memory_order_release);
+}
+
+static void* bench_thread_main(void* arg) {
+    bench_task(arg);
+    return NULL;
+}
+
+static int submit_thread(bench_slot_t* slot) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, bench_thread_main, slot) != 0) return -1;
+    pthread_detach(thread);
+    return 0;
+}
+
+static int submit_pool(bench_slot_t* slot) {
+    return diram_async_pool_submit(bench_task, slot);
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char* name, int (*submit)(bench_slot_t*), FILE* json, int first) {
+    static uint64_t latency[BENCH_REQUESTS];
+    uint64_t start = now_ns();
+
+    for (size_t i = 0; i < BENCH_REQUESTS; i++) {
+        while (atomic_load_explicit(&g_in_flight, memory_order_acquire) >= BENCH_WINDOW) {
+            sched_yield();
+        }
+        atomic_fetch_add_explicit(&g_in_flight, 1, memory_order_relaxed);
+        g_slots[i].submit_ns = now_ns();
+        while (submit(&g_slots[i]) < 0) {
+            sched_yield();
+        }
+    }
+    while (atomic_load_explicit(&g_in_flight, memory_order_acquire) > 0) {
+        sched_yield();
+    }
+
+    uint64_t elapsed = now_ns() - start;
+    for (size_t i = 0; i < BENCH_REQUESTS; i++) {
+        latency[i] = g_slots[i].done_ns - g_slots[i].submit_ns;
+    }
+    qsort(latency, BENCH_REQUESTS, sizeof(uint64_t), cmp_u64);
+
+    printf("%-8s p50=%8.2fus p99=%8.2fus max=%9.2fus  %9.0f ops/s\n", name,
+           latency[BENCH_REQUESTS / 2] / 1000.0,
+           latency[(BENCH_REQUESTS * 99) / 100] / 1000.0,
+           latency[BENCH_REQUESTS - 1] / 1000.0,
+           BENCH_REQUESTS / (elapsed / 1e9));
+
+    if (json) {
+        fprintf(json,
+                "%s    {\"executor\": \"%s\", \"requests\": %d, \"window\": %d, "
+                "\"ops_per_sec\": %.0f, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+                "\"p999_ns\": %llu, \"max_ns\": %llu}",
+                first ? "" : ",\n", name, BENCH_REQUESTS, BENCH_WINDOW,
+                BENCH_REQUESTS / (elapsed / 1e9),
+                (unsigned long long)latency[BENCH_REQUESTS / 2],
+                (unsigned long long)latency[(BENCH_REQUESTS * 99) / 100],
+                (unsigned long long)latency[(BENCH_REQUESTS * 999) / 1000],
+                (unsigned long long)latency[BENCH_REQUESTS - 1]);
+    }
+}
+
+int main(int argc, char** argv) {
+    printf("Async dispatch: %d requests, window %d\n", BENCH_REQUESTS, BENCH_WINDOW);
+
+    FILE* json = argc > 1 ? fopen(argv[1], "w") : NULL;
+    if (json) {
+        fprintf(json, "{\n  \"suite\": \"diram-async-pool\",\n  \"timestamp\": %lld,\n"
+                      "  \"results\": [\n", (long long)time(NULL));
+    }
+
+    run("thread", submit_thread, json, 1);
+
+    if (diram_async_pool_init(0, BENCH_WINDOW * 2) < 0) {
+        fprintf(stderr, "async pool failed to start\n");
+        return 1;
+    }
+    run("pool", submit_pool, json, 0);
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    diram_async_pool_stats_t stats;
+    diram_async_pool_get_stats(&stats);
+    printf("pool: %u workers, %llu executed, %llu stolen\n", stats.workers,
+           (unsigned long long)stats.executed, (unsigned long long)stats.stolen);
+
+    diram_async_pool_shutdown();
+    return 0;
+}
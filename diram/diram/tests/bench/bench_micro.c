@@ -0,0 +1,91 @@
+// tests/bench/bench_micro.c
+// Hot-path microbenchmarks on the shared harness (bench/include/obibench.h):
+// slab alloc/free per size class, the traced path, SHA-256 and receipt
+// hashing. Unlike bench_alloc these time batches, so they resolve paths in
+// the tens of nanoseconds.
+//
+// Usage: bench_micro [results.json] [obibench options]
+#include "diram/core/feature-alloc/alloc.h"
+#include "diram/core/feature-alloc/slab.h"
+#include "diram/core/feature-alloc/receipt.h"
+#include "obibench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECEIPT_INPUT_LEN 96
+
+typedef struct {
+    size_t size;
+} slab_case_t;
+
+static void bench_slab(void* arg, uint64_t count) {
+    const slab_case_t* slab = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        void* block = diram_slab_alloc(slab->size);
+        obibench_do_not_optimize(block);
+        diram_slab_free(block);
+    }
+}
+
+static void bench_traced(void* arg, uint64_t count) {
+    const slab_case_t* slab = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        diram_heap_epoch_begin();
+        diram_allocation_t* alloc = diram_alloc_traced(slab->size, "bench");
+        obibench_do_not_optimize(alloc);
+        if (alloc) diram_free_traced(alloc);
+    }
+}
+
+static void bench_sha256(void* arg, uint64_t count) {
+    uint8_t digest[DIRAM_SHA256_DIGEST_LEN];
+    for (uint64_t i = 0; i < count; i++) {
+        diram_sha256(arg, 4096, digest);
+        obibench_do_not_optimize(digest);
+    }
+}
+
+static void bench_receipt(void* arg, uint64_t count) {
+    char receipt[65];
+    for (uint64_t i = 0; i < count; i++) {
+        diram_receipt_hex(arg, RECEIPT_INPUT_LEN, receipt);
+        obibench_do_not_optimize(receipt);
+    }
+}
+
+int main(int argc, char** argv) {
+    // Same leading results path as the other benches; the rest are harness options
+    char** args = calloc((size_t)argc + 2, sizeof(*args));
+    if (!args) return 1;
+    int count = 0;
+    args[count++] = argv[0];
+    int next = 1;
+    if (argc > 1 && argv[1][0] != '-') {
+        args[count++] = "--json";
+        args[count++] = argv[next++];
+    }
+    while (next < argc) args[count++] = argv[next++];
+
+    obibench_suite_t* suite = obibench_init("diram", count, args);
+
+    static const slab_case_t sizes[] = { { 64 }, { 1024 }, { 16384 }, { 262144 } };
+    char name[64];
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        snprintf(name, sizeof(name), "slab_alloc_free/%zu", sizes[i].size);
+        obibench_run(suite, name, bench_slab, (void*)&sizes[i]);
+    }
+    for (size_t i = 0; i < 2; i++) {
+        snprintf(name, sizeof(name), "alloc_traced/%zu", sizes[i].size);
+        obibench_run(suite, name, bench_traced, (void*)&sizes[i]);
+    }
+
+    static uint8_t buffer[4096];
+    for (size_t i = 0; i < sizeof(buffer); i++) buffer[i] = (uint8_t)(i * 131u);
+    obibench_run_bytes(suite, "sha256/4096", bench_sha256, buffer, sizeof(buffer));
+    obibench_run(suite, "receipt_hex", bench_receipt, buffer);
+
+    int status = obibench_finish(suite);
+    free(args);
+    return status;
+}
@@ -1,9 +1,27 @@
 
 
 #include "alloc.h"
+#include "alloc_index.h"
+#include "trace_replay.h"
+#include "slab.h"
+#include "receipt.h"
+#include "async_promise.h"
+#include "async_pool.h"
+#include "async_promise_internal.h"
+#include "page_cache.h"
+#include "telemetry.h"
+#include "feature_alloc.h"
+#include "diram/core/config/config.h"
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
+#include <stdint.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 void test_basic_allocation() {
     printf("Testing basic allocation...\n");
@@ -41,41 +59,826 @@ void test_fork_safety() {
     printf("Testing fork safety...\n");
     
     diram_init_trace_log();
+    diram_heap_epoch_begin();
     
     diram_allocation_t* parent_alloc = diram_alloc_traced(4096, "parent_buffer");
-    assert(parent_alloc != NULL);
+    diram_allocation_t* parent_spare = diram_alloc_traced(512, "parent_spare");
+    assert(parent_alloc != NULL && parent_spare != NULL);
     
     pid_t pid = fork();
     if (pid == 0) {
-        // Child process
-        // Parent's allocation should not be freed
-        diram_free_traced(parent_alloc);  // Should be no-op due to PID check
+        // Child process: everything live in the parent is inherited
+        size_t inherited = diram_fork_inherited_count();
+        assert(inherited >= 2);
+        
+        // Freeing an inherited allocation adopts and releases it
+        diram_free_traced(parent_alloc);
+        assert(diram_fork_inherited_count() == inherited - 1);
         
         // Child can make its own allocations
         diram_allocation_t* child_alloc = diram_alloc_traced(1024, "child_buffer");
         assert(child_alloc != NULL);
         assert(child_alloc->binding_pid == getpid());
         
+        // The rest goes in one pass; the child's own allocation stays
+        assert(diram_alloc_lookup(parent_spare->base_addr) == parent_spare);
+        assert(diram_fork_release_inherited() == inherited - 1);
+        assert(diram_fork_inherited_count() == 0);
+        assert(diram_alloc_lookup(parent_spare->base_addr) == NULL);
+        assert(diram_alloc_lookup(child_alloc->base_addr) == child_alloc);
         diram_free_traced(child_alloc);
         _exit(0);
     } else {
         // Parent process
-        wait(NULL);
+        int status;
+        waitpid(pid, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
         
-        // Parent can still free its allocation
+        // Parent still owns and frees its allocations
+        assert(diram_fork_inherited_count() == 0);
         diram_free_traced(parent_alloc);
-        printf("  V Fork safety verified\n");
+        diram_free_traced(parent_spare);
+        printf("  V Inherited allocations adopted and bulk-released in the child\n");
     }
     
     diram_close_trace_log();
 }
 
+#define INDEX_BATCH 2000
+
+// Each thread has its own heap-event budget; a batch is a single event
+static void* index_worker(void* arg) {
+    (void)arg;
+    size_t sizes[INDEX_BATCH];
+    diram_allocation_t* out[INDEX_BATCH];
+    for (size_t i = 0; i < INDEX_BATCH; i++) sizes[i] = 16 + i % 64;
+    assert(diram_alloc_batch(INDEX_BATCH, sizes, "index_batch", out) == 0);
+    
+    for (size_t i = 0; i < INDEX_BATCH; i++) {
+        assert(diram_alloc_lookup(out[i]->base_addr) == out[i]);
+    }
+    // Half by address, half by tracker, interleaved
+    for (size_t i = 0; i < INDEX_BATCH; i++) {
+        void* address = out[i]->base_addr;
+        if (i % 2) {
+            assert(diram_free(address) == 0);
+        } else {
+            diram_free_traced(out[i]);
+        }
+        assert(diram_alloc_lookup(address) == NULL);
+    }
+    return NULL;
+}
+
+static int count_index_tags(diram_allocation_t* alloc, void* context) {
+    if (strncmp(alloc->tag, "index_", 6) == 0) (*(size_t*)context)++;
+    return 0;
+}
+
+void test_address_index() {
+    printf("Testing address index...\n");
+    
+    diram_heap_epoch_begin();
+    size_t before = diram_alloc_live_count();
+    diram_allocation_t* a = diram_alloc_traced(100, "index_a");
+    diram_allocation_t* b = diram_alloc_traced(200, "index_tag_longer_than_the_field");
+    assert(a != NULL && b != NULL);
+    assert(diram_alloc_live_count() == before + 2);
+    
+    // Exact payload addresses only
+    assert(diram_alloc_lookup(a->base_addr) == a);
+    assert(diram_alloc_lookup(b->base_addr) == b);
+    assert(diram_alloc_lookup((char*)a->base_addr + 1) == NULL);
+    assert(diram_alloc_lookup(a) == NULL);
+    assert(strcmp(b->tag, "index_tag_longer_than_t") == 0);
+    
+    size_t tagged = 0;
+    diram_alloc_foreach(count_index_tags, &tagged);
+    assert(tagged == 2);
+    
+    FILE* report = tmpfile();
+    assert(report != NULL);
+    assert(diram_alloc_report_leaks(report) == before + 2);
+    char line[256];
+    int found = 0;
+    rewind(report);
+    while (fgets(line, sizeof(line), report)) {
+        if (strstr(line, "100 bytes tag=index_a")) found = 1;
+    }
+    fclose(report);
+    assert(found);
+    
+    void* address = a->base_addr;
+    assert(diram_free(address) == 0);
+    assert(diram_free(address) == -1);
+    assert(diram_free(NULL) == -1);
+    assert(diram_alloc_lookup(address) == NULL);
+    diram_free_traced(b);
+    printf("  V Lookup, iteration and free by address\n");
+    
+    // Concurrent batches grow the shards well past their initial size
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        assert(pthread_create(&threads[i], NULL, index_worker, NULL) == 0);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    assert(diram_alloc_live_count() == before);
+    printf("  V %d concurrent batch members indexed and freed\n", 4 * INDEX_BATCH);
+}
+
+void test_trace_replay() {
+    printf("Testing trace replay...\n");
+    
+    // Out of file order on purpose: the ring writer drains per thread
+    const char* text_path = "/tmp/diram_test_replay.log";
+    FILE* file = fopen(text_path, "w");
+    assert(file != NULL);
+    fprintf(file, "# DIRAM Allocation Trace Log\n"
+                  "# Format: TIMESTAMP|PID|OPERATION|ADDRESS|SIZE|SHA256|TAG\n"
+                  "100|7|ALLOC|0x1000|100|aa|a\n"
+                  "110|7|ALLOC|0x2000|5000|bb|b\n"
+                  "160|8|FREE|0x3000|64|cc|traced\n"
+                  "120|7|FREE|0x1000|100|aa|traced\n"
+                  "150|8|ALLOC|0x3000|64|cc|c\n"
+                  "170|7|ALLOC_RANGE|0x10000|640|dd|batch|4\n"
+                  "180|7|FREE|0x10000|160|d0|traced\n"
+                  "181|7|FREE|0x10100|160|d1|traced\n"
+                  "182|7|FREE|0x10200|160|d2|traced\n"
+                  "183|7|FREE|0x10300|160|d3|traced\n"
+                  "190|7|FREE|0x9000|1|ee|traced\n");
+    fclose(file);
+    
+    size_t live_before = diram_alloc_live_count();
+    diram_replay_stats_t stats;
+    assert(diram_trace_replay(text_path, DIRAM_REPLAY_FULL_SPEED, &stats) == 0);
+    assert(stats.records == 11);
+    assert(stats.allocs == 7 && stats.frees == 6);
+    assert(stats.unmatched_frees == 1 && stats.live_at_end == 1 && stats.failed_allocs == 0);
+    assert(stats.bytes_allocated == 100 + 5000 + 64 + 640);
+    assert(stats.peak_live_bytes == 5000 + 640);
+    assert(stats.peak_block_bytes > stats.peak_live_bytes);
+    assert(stats.internal_fragmentation > 0.0 && stats.internal_fragmentation < 1.0);
+    assert(stats.external_fragmentation >= 0.0 && stats.external_fragmentation < 1.0);
+    assert(stats.peak_rss_kb > 0 && stats.ops_per_sec > 0.0);
+    assert(diram_alloc_live_count() == live_before);
+    printf("  V Text trace: %llu allocs, %llu frees, %.1f%% internal fragmentation\n",
+           (unsigned long long)stats.allocs, (unsigned long long)stats.frees,
+           stats.internal_fragmentation * 100.0);
+    
+    // Binary format, replayed with the captured 20 ms gap
+    const char* bin_path = "/tmp/diram_test_replay.bin";
+    diram_trace_file_header_t header = { .version = DIRAM_TRACE_BIN_VERSION,
+                                         .record_size = sizeof(diram_trace_record_t) };
+    memcpy(header.magic, DIRAM_TRACE_BIN_MAGIC, sizeof(header.magic));
+    diram_trace_record_t records[2];
+    diram_trace_record_fill(&records[0], DIRAM_TRACE_OP_ALLOC, 1000, 7,
+                            (void*)0x4000, 256, "ff", "bin");
+    diram_trace_record_fill(&records[1], DIRAM_TRACE_OP_FREE, 1000 + 20000000, 7,
+                            (void*)0x4000, 256, "ff", "traced");
+    file = fopen(bin_path, "wb");
+    assert(file != NULL);
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(records, sizeof(records[0]), 2, file);
+    fclose(file);
+    
+    assert(diram_trace_replay(bin_path, DIRAM_REPLAY_ORIGINAL_TIMING, &stats) == 0);
+    assert(stats.allocs == 1 && stats.frees == 1 && stats.live_at_end == 0);
+    assert(stats.elapsed_ns >= 20000000);
+    assert(diram_trace_replay("/nonexistent/trace.log", DIRAM_REPLAY_FULL_SPEED, &stats) == -1);
+    
+    unlink(text_path);
+    unlink(bin_path);
+    printf("  V Binary trace replayed with original timing\n");
+}
+
+// Runs on its own thread so it gets a fresh heap-event budget
+static void* slab_reuse_worker(void* arg) {
+    (void)arg;
+    
+    // Sizes that would wrap past the tracker are refused without spending budget
+    assert(diram_alloc_traced(SIZE_MAX - 64, "slab_wrap") == NULL);
+    assert(diram_alloc_traced(SIZE_MAX, "slab_wrap") == NULL);
+    assert(diram_alloc_traced_flags(SIZE_MAX - 64, "slab_wrap", sizeof(diram_allocation_t),
+                                    DIRAM_ALLOC_GUARDED) == NULL);
+    assert(diram_alloc_traced_ex(64, "slab_wrap", SIZE_MAX) == NULL);
+    
+    diram_allocation_t* first = diram_alloc_traced(200, "slab_first");
+    assert(first != NULL);
+    assert((char*)first->base_addr > (char*)first);
+    assert(((uintptr_t)first->base_addr % DIRAM_SLAB_ALIGN) == 0);
+    assert(diram_slab_usable_size(first) >= 200 + sizeof(diram_allocation_t));
+    diram_free_traced(first);
+    
+    // Same size class comes straight back out of the thread magazine
+    diram_allocation_t* second = diram_alloc_traced(180, "slab_second");
+    assert(second == first);
+    assert(second->size == 180);
+    diram_free_traced(second);
+    
+    // Large requests bypass the size classes but keep the inline tracker
+    diram_allocation_t* large = diram_alloc_traced(DIRAM_SLAB_MAX_CLASS * 2, "slab_large");
+    assert(large != NULL);
+    memset(large->base_addr, 0xAB, large->size);
+    diram_free_traced(large);
+    
+    return NULL;
+}
+
+void test_slab_backend() {
+    printf("Testing slab backend...\n");
+    
+    assert(diram_slab_class_for(1) == 0);
+    assert(diram_slab_class_for(64) == 0);
+    assert(diram_slab_class_for(65) == 1);
+    assert(diram_slab_class_size(diram_slab_class_for(97)) == 128);
+    assert(diram_slab_class_size(diram_slab_class_for(DIRAM_SLAB_MAX_CLASS)) == DIRAM_SLAB_MAX_CLASS);
+    assert(diram_slab_class_for(DIRAM_SLAB_MAX_CLASS + 1) == -1);
+    assert(diram_slab_alloc(SIZE_MAX - 8) == NULL);
+    assert(diram_slab_alloc(SIZE_MAX) == NULL);
+    
+    pthread_t worker;
+    pthread_create(&worker, NULL, slab_reuse_worker, NULL);
+    pthread_join(worker, NULL);
+    
+    diram_slab_stats_t stats;
+    diram_slab_get_stats(&stats);
+    assert(stats.large_allocs >= 1);
+    assert(stats.magazine_hits >= 1);
+    printf("  V Tracker inline with payload, blocks recycled per thread\n");
+}
+
+// Runs on its own thread so it gets a fresh heap-event budget
+static void* batch_worker(void* arg) {
+    (void)arg;
+    
+    size_t sizes[20];
+    diram_allocation_t* allocs[20];
+    for (size_t i = 0; i < 20; i++) {
+        sizes[i] = 24 + i * 8;
+    }
+    
+    // Twenty allocations cost a single heap event
+    assert(diram_alloc_batch(20, sizes, "batch", allocs) == 0);
+    for (size_t i = 0; i < 20; i++) {
+        assert(allocs[i]->size == sizes[i]);
+        assert(((uintptr_t)allocs[i]->base_addr % DIRAM_SLAB_ALIGN) == 0);
+        if (i > 0) {
+            assert((char*)allocs[i] >= (char*)allocs[i - 1]->base_addr + sizes[i - 1]);
+        }
+        
+        // Multi-buffer receipts match the single-allocation path
+        diram_allocation_t copy = *allocs[i];
+        diram_compute_receipt(&copy, "batch");
+        assert(strcmp(copy.sha256_receipt, allocs[i]->sha256_receipt) == 0);
+    }
+    
+    for (size_t i = 0; i < 20; i++) {
+        diram_free_traced(allocs[i]);
+    }
+    return NULL;
+}
+
+void test_receipts() {
+    printf("Testing receipts...\n");
+    
+    uint8_t digest[DIRAM_SHA256_DIGEST_LEN];
+    char hex[DIRAM_SHA256_HEX_LEN];
+    diram_sha256("abc", 3, digest);
+    diram_hex_encode(digest, sizeof(digest), hex);
+    assert(strcmp(hex, "ba7816bf8f01cfea414140de5dae2223"
+                       "b00361a396177a9cb410ff61f20015ad") == 0);
+    
+    pthread_t worker;
+    pthread_create(&worker, NULL, batch_worker, NULL);
+    pthread_join(worker, NULL);
+    printf("  V SHA-256 (%s), batch receipts match single receipts\n",
+           diram_sha256_impl_name(diram_sha256_get_impl()));
+}
+
+// Runs on its own thread so it gets a fresh heap-event budget
+static void* async_worker(void* arg) {
+    (void)arg;
+    
+    diram_async_promise_t* promise = diram_alloc_with_lookahead(128, "async", NULL, 0);
+    assert(promise != NULL);
+    assert(diram_promise_await(promise, 1000) == 0);
+    assert(promise->result.resolved_allocation->base.size == 128);
+    diram_free_enhanced(promise->result.resolved_allocation);
+    diram_promise_destroy(promise);
+    return NULL;
+}
+
+void test_async_pool() {
+    printf("Testing async pool...\n");
+    
+    pthread_t worker;
+    pthread_create(&worker, NULL, async_worker, NULL);
+    pthread_join(worker, NULL);
+    
+    diram_async_pool_stats_t stats;
+    diram_async_pool_get_stats(&stats);
+    assert(stats.workers >= 1);
+    assert(stats.executed >= 1);
+    diram_async_pool_shutdown();
+    printf("  V Promise resolved on a pool worker (%u workers)\n", stats.workers);
+}
+
+// Three promises use up this thread's heap-event budget; the fourth is
+// rejected up front, which gives the combinators a failure to report
+static void* completion_worker(void* arg) {
+    (void)arg;
+    
+    diram_async_promise_t* promises[4];
+    for (size_t i = 0; i < 4; i++) {
+        promises[i] = diram_alloc_with_lookahead(64 * (i + 1), "cq", NULL, 0);
+        assert(promises[i] != NULL);
+    }
+    
+    diram_completion_queue_t* cq = diram_cq_create(4);
+    assert(cq != NULL);
+    for (size_t i = 0; i < 4; i++) {
+        assert(diram_promise_attach(promises[i], cq, (void*)(uintptr_t)i) == 0);
+    }
+    
+    diram_completion_t done[4];
+    size_t reaped = 0;
+    while (reaped < 4) {
+        size_t got = diram_cq_reap(cq, done + reaped, 4 - reaped, 4 - reaped, 1000);
+        assert(got > 0);
+        reaped += got;
+    }
+    size_t resolved = 0;
+    for (size_t i = 0; i < 4; i++) {
+        if (done[i].state == PROMISE_STATE_RESOLVED) {
+            assert(done[i].allocation->base.size == 64 * ((uintptr_t)done[i].user_data + 1));
+            resolved++;
+        } else {
+            assert((uintptr_t)done[i].user_data == 3);
+        }
+    }
+    assert(resolved == 3);
+    diram_cq_destroy(cq);
+    
+    size_t index;
+    assert(diram_promise_all(promises, 3, 1000, &index) == 0);
+    assert(diram_promise_all(promises, 4, 1000, &index) == -1 && index == 3);
+    assert(diram_promise_any(promises + 2, 2, 1000, &index) == 0 && index == 0);
+    assert(diram_promise_any(promises + 3, 1, 1000, &index) == -1 && index == SIZE_MAX);
+    
+    for (size_t i = 0; i < 4; i++) {
+        if (i < 3) diram_free_enhanced(promises[i]->result.resolved_allocation);
+        diram_promise_destroy(promises[i]);
+    }
+    return NULL;
+}
+
+void test_completion_queue() {
+    printf("Testing completion queue...\n");
+    
+    pthread_t worker;
+    pthread_create(&worker, NULL, completion_worker, NULL);
+    pthread_join(worker, NULL);
+    printf("  V Batch reap, promise_all and promise_any\n");
+}
+
+static void* lookahead_worker(void* arg) {
+    (void)arg;
+    
+    // 900 bytes fits the learned ~1000, 4000 does not
+    diram_async_promise_t* fits = diram_alloc_with_lookahead(900, "lookahead", NULL, 7);
+    diram_async_promise_t* large = diram_alloc_with_lookahead(4000, "lookahead", NULL, 7);
+    assert(diram_promise_await(fits, 1000) == 0);
+    assert(diram_promise_await(large, 1000) == 0);
+    assert(fits->lookahead_size == 1024);
+    assert(fits->result.resolved_allocation->base.size == 1024);
+    assert(large->lookahead_size == 4000);
+    
+    diram_free_enhanced(fits->result.resolved_allocation);
+    diram_free_enhanced(large->result.resolved_allocation);
+    diram_promise_destroy(fits);
+    diram_promise_destroy(large);
+    return NULL;
+}
+
+void test_lookahead_cache() {
+    printf("Testing lookahead cache...\n");
+    
+    // Unseen keys are passed through unchanged
+    assert(diram_lookahead_predict(7, "lookahead", 900) == 900);
+    for (int i = 0; i < 12; i++) {
+        diram_lookahead_observe(7, "lookahead", 1000);
+    }
+    
+    diram_lookahead_stats_t before, after;
+    diram_lookahead_get_stats(&before);
+    
+    pthread_t worker;
+    pthread_create(&worker, NULL, lookahead_worker, NULL);
+    pthread_join(worker, NULL);
+    
+    diram_lookahead_get_stats(&after);
+    assert(after.hits == before.hits + 1);
+    assert(after.misses == before.misses + 1);
+    assert(after.oversize_bytes == before.oversize_bytes + 124);
+    printf("  V Learned size applied (%llu hits, %llu misses, %u entries)\n",
+           (unsigned long long)after.hits, (unsigned long long)after.misses, after.entries);
+}
+
+#define SPACE_TEST_LIMIT (1 << 20)
+#define SPACE_TEST_CHUNK 1000
+
+static void* space_worker(void* arg) {
+    diram_memory_space_t* space = (diram_memory_space_t*)arg;
+    size_t charged = 0;
+    while (diram_space_charge(space, SPACE_TEST_CHUNK, 1) == 0) {
+        charged++;
+    }
+    for (size_t i = 0; i < charged; i++) {
+        diram_space_uncharge(space, SPACE_TEST_CHUNK, 1);
+    }
+    return (void*)(uintptr_t)charged;
+}
+
+void test_space_accounting() {
+    printf("Testing sharded space accounting...\n");
+    
+    diram_memory_space_t* space = diram_space_create("sharded", SPACE_TEST_LIMIT);
+    assert(space != NULL);
+    
+    // Concurrent charges never add up past the limit
+    pthread_t workers[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&workers[i], NULL, space_worker, space);
+    }
+    for (int i = 0; i < 4; i++) {
+        void* charged;
+        pthread_join(workers[i], &charged);
+        assert((uintptr_t)charged * SPACE_TEST_CHUNK <= SPACE_TEST_LIMIT);
+    }
+    
+    size_t used;
+    uint32_t count;
+    diram_space_get_usage(space, &used, &count);
+    assert(used == 0 && count == 0);
+    
+    // Quota stranded on other shards is reclaimed, so the limit is reachable
+    size_t charged = 0;
+    while (diram_space_charge(space, SPACE_TEST_CHUNK, 1) == 0) {
+        charged++;
+    }
+    assert(charged == SPACE_TEST_LIMIT / SPACE_TEST_CHUNK);
+    diram_space_get_usage(space, &used, &count);
+    assert(used == charged * SPACE_TEST_CHUNK && count == charged);
+    assert(space->used_bytes == used);
+    
+    diram_space_destroy(space);
+    printf("  V Limit exact under sharding (%zu x %d bytes)\n", charged, SPACE_TEST_CHUNK);
+}
+
+static void* guarded_worker(void* arg) {
+    (void)arg;
+    
+    diram_enhanced_allocation_t* alloc = diram_alloc_enhanced(200, "guarded", NULL);
+    assert(alloc != NULL);
+    assert(alloc->flags & 0x02);
+    memset(alloc->base.base_addr, 0x11, 200);
+    diram_free_enhanced(alloc);
+    return NULL;
+}
+
+void test_guard_pages() {
+    printf("Testing guard pages...\n");
+    
+    // The payload ends flush against the trailing guard page
+    char* block = diram_slab_alloc_guarded(100);
+    assert(block != NULL);
+    memset(block, 0xAB, 100);
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        block[DIRAM_SLAB_ALIGN_UP(100)] = 1;
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    assert(WIFSIGNALED(status) ? WTERMSIG(status) == SIGSEGV : WEXITSTATUS(status) != 0);
+    
+    // A freed region is reused with its guards in place, no new mapping
+    diram_page_cache_stats_t before, after;
+    diram_slab_free(block);
+    diram_page_cache_get_stats(&before);
+    block = diram_slab_alloc_guarded(100);
+    diram_page_cache_get_stats(&after);
+    assert(after.cache_hits == before.cache_hits + 1);
+    assert(after.regions_mapped == before.regions_mapped);
+    diram_slab_free(block);
+    
+    // Zero-trust enhanced allocations take the guarded path
+    g_diram_config.guard_pages = true;
+    pthread_t worker;
+    pthread_create(&worker, NULL, guarded_worker, NULL);
+    pthread_join(worker, NULL);
+    g_diram_config.guard_pages = false;
+    
+    printf("  V Overrun faults, guarded regions recycled (%llu hits)\n",
+           (unsigned long long)after.cache_hits);
+}
+
+#define HEAP_TEST_EVENTS 10   // 100 ms of refill per event
+
+static void* heap_credit_worker(void* arg) {
+    (void)arg;
+    diram_allocation_t* allocs[HEAP_TEST_EVENTS + 1];
+    
+    // Reject mode: a full bucket, then one event per refill interval
+    for (int i = 0; i < HEAP_TEST_EVENTS; i++) {
+        allocs[i] = diram_alloc_traced(64, "credit");
+        assert(allocs[i] != NULL);
+    }
+    assert(diram_alloc_traced(64, "credit") == NULL);
+    usleep(120000);
+    allocs[HEAP_TEST_EVENTS] = diram_alloc_traced(64, "credit");
+    assert(allocs[HEAP_TEST_EVENTS] != NULL);
+    for (int i = 0; i <= HEAP_TEST_EVENTS; i++) {
+        diram_free_traced(allocs[i]);
+    }
+    
+    // Defer mode: the overflow parks on the pool instead of failing
+    diram_async_pool_stats_t before, after;
+    diram_async_pool_get_stats(&before);
+    diram_heap_set_mode(DIRAM_HEAP_MODE_DEFER);
+    diram_heap_epoch_begin();
+    diram_async_promise_t* promises[HEAP_TEST_EVENTS + 2];
+    for (int i = 0; i < HEAP_TEST_EVENTS + 2; i++) {
+        promises[i] = diram_alloc_with_lookahead(64, "credit", NULL, 0);
+        assert(promises[i] != NULL);
+    }
+    diram_heap_set_mode(DIRAM_HEAP_MODE_REJECT);
+    diram_async_pool_get_stats(&after);
+    assert(after.deferred == before.deferred + 2);
+    
+    // Pool workers may still be resolving these, so the state is only
+    // read through await, under the promise lock
+    for (int i = 0; i < HEAP_TEST_EVENTS + 2; i++) {
+        assert(diram_promise_await(promises[i], 2000) == 0);
+        diram_free_enhanced(promises[i]->result.resolved_allocation);
+        diram_promise_destroy(promises[i]);
+    }
+    return NULL;
+}
+
+void test_heap_credit() {
+    printf("Testing heap event credit...\n");
+    
+    int saved = g_diram_config.max_heap_events;
+    g_diram_config.max_heap_events = HEAP_TEST_EVENTS;
+    pthread_t worker;
+    pthread_create(&worker, NULL, heap_credit_worker, NULL);
+    pthread_join(worker, NULL);
+    g_diram_config.max_heap_events = saved;
+    
+    printf("  V Burst of %d, refill without an epoch cliff, overflow deferred\n",
+           HEAP_TEST_EVENTS);
+}
+
+static void telemetry_emit_op(const char* op, diram_error_code_t code) {
+    diram_telemetry_event_t event = {
+        .event_id = 42,
+        .layer = 2,
+        .error_code = code,
+        .address = &event,
+        .size = 128,
+        .receipt = "abcd"
+    };
+    strncpy(event.operation, op, sizeof(event.operation) - 1);
+    diram_telemetry_emit(&event);
+}
+
+void test_telemetry_export() {
+    printf("Testing telemetry export...\n");
+    
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "/tmp/diram_telemetry_%d.sock", (int)getpid());
+    unlink(addr.sun_path);
+    int sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+    assert(sock >= 0);
+    assert(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    
+    char endpoint[sizeof(addr.sun_path) + 8];
+    snprintf(endpoint, sizeof(endpoint), "unix://%s", addr.sun_path);
+    assert(diram_telemetry_init("udp://nohostport") == -1);
+    assert(diram_telemetry_init(endpoint) == 0);
+    
+    // One batch: records back to back, each carrying its own length
+    telemetry_emit_op("ALLOC_ENHANCED", DIRAM_ERR_NONE);
+    telemetry_emit_op("FREE_ENHANCED", DIRAM_ERR_NONE);
+    assert(diram_telemetry_flush() == 0);
+    
+    diram_telemetry_wire_t records[2];
+    ssize_t n = recv(sock, records, sizeof(records), MSG_DONTWAIT);
+    assert(n == (ssize_t)sizeof(records));
+    assert(records[0].length == sizeof(diram_telemetry_wire_t));
+    assert(records[0].version == DIRAM_TELEMETRY_WIRE_VERSION);
+    assert(strcmp(records[0].operation, "ALLOC_ENHANCED") == 0);
+    assert(strcmp(records[1].operation, "FREE_ENHANCED") == 0);
+    assert(records[1].sequence == records[0].sequence + 1);
+    assert(records[0].pid == getpid() && memcmp(records[0].receipt, "abcd", 5) == 0);
+    
+    // Head sampling off: routine events vanish, errors still get through
+    diram_telemetry_stats_t before, after;
+    diram_telemetry_get_stats(&before);
+    diram_telemetry_set_sampling(0.0, 1.0);
+    for (int i = 0; i < 10; i++) {
+        telemetry_emit_op("ALLOC_ENHANCED", DIRAM_ERR_NONE);
+    }
+    telemetry_emit_op("ALLOC_ENHANCED", DIRAM_ERR_BOUNDARY_VIOLATION);
+    diram_telemetry_set_sampling(1.0, 1.0);
+    assert(diram_telemetry_flush() == 0);
+    diram_telemetry_get_stats(&after);
+    assert(after.sampled_out == before.sampled_out + 10);
+    assert(after.exported == before.exported + 1);
+    assert(recv(sock, records, sizeof(records), MSG_DONTWAIT) == sizeof(diram_telemetry_wire_t));
+    assert(records[0].error_code == DIRAM_ERR_BOUNDARY_VIOLATION);
+    
+    // A burst larger than the ring never blocks; every event is accounted for
+    for (int i = 0; i < 4 * DIRAM_TELEMETRY_RING_SLOTS; i++) {
+        telemetry_emit_op("ALLOC_ENHANCED", DIRAM_ERR_NONE);
+    }
+    assert(diram_telemetry_flush() == 0);
+    diram_telemetry_get_stats(&after);
+    assert(after.emitted == after.exported + after.sampled_out + after.dropped + after.send_errors);
+    
+    diram_telemetry_shutdown();
+    close(sock);
+    unlink(addr.sun_path);
+    
+    printf("  V %llu exported in %llu datagrams, %llu dropped, %llu unsent\n",
+           (unsigned long long)after.exported, (unsigned long long)after.datagrams,
+           (unsigned long long)after.dropped, (unsigned long long)after.send_errors);
+}
+
+static void write_config(const char* path, const char* text) {
+    // Save the way editors do: write aside, then rename over the original
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* fp = fopen(tmp, "w");
+    assert(fp != NULL);
+    fputs(text, fp);
+    fclose(fp);
+    assert(rename(tmp, path) == 0);
+}
+
+void test_config_reload() {
+    printf("Testing config key table and reload...\n");
+    
+    // Every key goes through the table, and get now covers all of them
+    assert(diram_config_init() == 0);
+    const diram_config_t* published = diram_config_current();
+    assert(published != &g_diram_config);
+    assert(diram_config_set_value(CFG_ASYNC_MAX_PENDING_PROMISES, "77") == 0);
+    assert(strcmp(diram_config_get_value(CFG_ASYNC_MAX_PENDING_PROMISES), "77") == 0);
+    assert(diram_config_set_value(CFG_GUARD_PAGES, "off") == 0);
+    assert(strcmp(diram_config_get_value(CFG_GUARD_PAGES), "false") == 0);
+    assert(diram_config_set_value(CFG_TELEMETRY_HEAD_SAMPLE, "2.0") == -1);
+    assert(diram_config_set_value("no_such_key", "1") == -1);
+    assert(diram_config_get_value("no_such_key") == NULL);
+    // Published snapshots are immutable; later sets only replace them
+    assert(published->max_pending_promises == 100 && published->guard_pages);
+    
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/diram_config_%d.dramrc", (int)getpid());
+    write_config(path, "max_heap_events=4\n");
+    assert(diram_config_reload(path) == 0);
+    assert(diram_config_current()->max_heap_events == 4);
+    
+    // A change on disk is picked up without a restart
+    assert(diram_config_watch(path) == 0);
+    uint64_t generation = diram_config_generation();
+    write_config(path, "max_heap_events=7\n[async]\ndefault_timeout_ms=1234\n");
+    for (int i = 0; i < 200 && diram_config_generation() == generation; i++) {
+        usleep(10000);
+    }
+    assert(diram_config_generation() > generation);
+    assert(diram_config_current()->max_heap_events == 7);
+    assert(diram_config_current()->default_timeout_ms == 1234);
+    assert(strcmp(diram_config_get_value(CFG_ASYNC_DEFAULT_TIMEOUT_MS), "1234") == 0);
+    diram_config_unwatch();
+    
+    // A file that fails validation is rolled back and never published
+    write_config(path, "heap_mode=defer\nmax_heap_events=99\n");
+    generation = diram_config_generation();
+    assert(diram_config_reload(path) == -1);
+    assert(diram_config_generation() == generation);
+    assert(diram_config_current()->max_heap_events == 7);
+    assert(g_diram_config.max_heap_events == 7);
+    assert(diram_heap_get_mode() == DIRAM_HEAP_MODE_REJECT);
+    
+    unlink(path);
+    diram_config_cleanup();
+    assert(diram_config_current() == &g_diram_config);
+    
+    printf("  V Snapshot generation %llu after watch and rejected reload\n",
+           (unsigned long long)generation);
+}
+
+#define ERROR_STORM_THREADS 4
+#define ERROR_STORM_COUNT 5000
+
+static void* error_storm_worker(void* arg) {
+    diram_memory_space_t* space = (diram_memory_space_t*)arg;
+    for (int i = 0; i < ERROR_STORM_COUNT; i++) {
+        assert(diram_space_check_limit(space, 4096 + (size_t)i) == -1);
+    }
+    return NULL;
+}
+
+void test_error_index() {
+    printf("Testing lock-free error index...\n");
+    
+    diram_error_stats_t before, after;
+    diram_error_get_stats(&before);
+    
+    // Arguments are captured raw; strings are copied, formatting is deferred
+    char name[16] = "transient";
+    diram_error_record(DIRAM_ERR_CONFIG_INVALID, "bad %s: %d/%zu %.2f [%5.*s] %x%%",
+                       name, -3, (size_t)7, 1.5, 2, "xyz", 255u);
+    memset(name, 0, sizeof(name));
+    const diram_error_context_t* last = diram_error_get_last();
+    assert(last && last->code == DIRAM_ERR_CONFIG_INVALID && last->severity == 3);
+    assert(strcmp(last->context, "bad transient: -3/7 1.50 [   xy] ff%") == 0);
+    
+    // A storm from one call site becomes one record and a count
+    diram_memory_space_t* space = diram_space_create("storm", 1024);
+    pthread_t threads[ERROR_STORM_THREADS];
+    for (int i = 0; i < ERROR_STORM_THREADS; i++) {
+        pthread_create(&threads[i], NULL, error_storm_worker, space);
+    }
+    for (int i = 0; i < ERROR_STORM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    diram_error_get_stats(&after);
+    uint64_t calls = 1 + ERROR_STORM_THREADS * ERROR_STORM_COUNT;
+    assert((after.recorded - before.recorded) + (after.suppressed - before.suppressed) +
+           (after.dropped - before.dropped) == calls);
+    assert(after.suppressed - before.suppressed > after.recorded - before.recorded);
+    
+    // Once the window closes, the next record carries the repeats
+    usleep((DIRAM_ERROR_SUPPRESS_WINDOW_MS + 50) * 1000);
+    assert(diram_space_check_limit(space, 4096) == -1);
+    last = diram_error_get_last();
+    assert(last && last->code == DIRAM_ERR_MEMORY_EXHAUSTED && last->severity == 1);
+    assert(strstr(last->context, "Space 'storm' limit exceeded: 0 + 4096 > 1024"));
+    
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/diram_error_index_%d.log", (int)getpid());
+    assert(diram_error_dump_index(path) >= 2);
+    FILE* dump = fopen(path, "r");
+    assert(dump);
+    char line[512];
+    int repeats_seen = 0;
+    while (fgets(line, sizeof(line), dump)) {
+        if (strstr(line, "Space 'storm'") && strstr(line, " repeats)")) repeats_seen = 1;
+    }
+    fclose(dump);
+    unlink(path);
+    assert(repeats_seen);
+    diram_space_destroy(space);
+    
+    // The background writer formats into the log when there is one
+    if (access("logs", W_OK) == 0) {
+        diram_error_get_stats(&before);
+        assert(diram_error_index_init() == 0);
+        diram_error_record(DIRAM_ERR_TRACE_FAILURE, "writer check %d", 42);
+        diram_error_index_shutdown();
+        diram_error_get_stats(&after);
+        assert(after.logged == before.logged + 1);
+    }
+    
+    printf("  V %llu repeats suppressed, %llu records\n",
+           (unsigned long long)after.suppressed, (unsigned long long)after.recorded);
+}
+
 int main() {
     printf("DIRAM Feature-Alloc Test Suite\n");
     printf("==============================\n\n");
     
     test_basic_allocation();
     test_fork_safety();
+    test_address_index();
+    test_trace_replay();
+    test_slab_backend();
+    test_receipts();
+    test_guard_pages();
+    test_space_accounting();
+    test_completion_queue();
+    test_lookahead_cache();
+    test_async_pool();
+    test_telemetry_export();
+    test_heap_credit();
+    test_config_reload();
+    test_error_index();
     
     printf("\nAll tests completed successfully.\n");
     return 0;
@@ -0,0 +1,564 @@
+#include "diram/core/hotwire/hotwire.h"
+#include "diram/core/hotwire/wasm_binary.h"
+#include "diram/core/hotwire/snapshot.h"
+#include "diram/core/hotwire/jit.h"
+#include "diram/core/parser/parser.h"
+#include "diram/core/feature-alloc/async_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#define TEST_NODES 3000
+
+static char g_names[TEST_NODES][24];
+
+// Mixed policy tree: runs of independent subtrees broken up by allocations,
+// opcodes and constraints, with toggles that later allocations depend on
+static diram_ast_node_t* build_tree(diram_ast_node_t* nodes) {
+    static diram_ast_node_t* children[TEST_NODES];
+    static diram_ast_node_t root;
+    static char* rules[] = { "deny_exec_heap", "audit_free" };
+
+    memset(&root, 0, sizeof(root));
+    memset(nodes, 0, TEST_NODES * sizeof(diram_ast_node_t));
+    root.type = AST_NODE_ROOT;
+    root.children = children;
+    root.child_count = TEST_NODES;
+
+    for (size_t i = 0; i < TEST_NODES; i++) {
+        diram_ast_node_t* node = &nodes[i];
+        children[i] = node;
+        snprintf(g_names[i], sizeof(g_names[i]), "node_%zu", i);
+
+        switch ((i * 7) % 11) {
+            case 0: case 1: case 2:
+                node->type = AST_NODE_MEMORY_REGION;
+                node->data.memory_region.name = g_names[i];
+                node->data.memory_region.base_address = 0x10000 + i * 0x1000;
+                node->data.memory_region.size = 4096 * (i % 5 + 1);
+                node->data.memory_region.protection_flags = (uint8_t)(i % 8);
+                break;
+            case 3: case 4:
+                node->type = AST_NODE_POLICY;
+                node->data.policy.name = g_names[i];
+                node->data.policy.type = i % 3 ? "security" : "audit";
+                node->data.policy.enforced = i % 2;
+                node->data.policy.rules = rules;
+                node->data.policy.rule_count = 2;
+                break;
+            case 5:
+                // Flips the feature the allocations check
+                node->type = AST_NODE_FEATURE_TOGGLE;
+                node->data.feature.name = i % 4 ? "cryptographic_receipts" : g_names[i];
+                node->data.feature.enabled = (i / 11) % 2;
+                break;
+            case 6: case 7:
+                node->type = AST_NODE_ALLOCATION;
+                node->data.allocation.size = 64 * i;
+                node->data.allocation.tag = g_names[i];
+                node->data.allocation.address = i % 3 ? 0x1000 * i : 0;
+                if (i % 2) strcpy(node->data.allocation.sha256_receipt, "ab12");
+                break;
+            case 8: case 9:
+                node->type = AST_NODE_OPCODE;
+                node->data.opcode.name = g_names[i];
+                node->data.opcode.code = (uint8_t)(i % 5);
+                break;
+            default:
+                node->type = AST_NODE_CONSTRAINT;
+                node->data.constraint.name = g_names[i];
+                node->data.constraint.epsilon_value = 0.6;
+                node->data.constraint.max_heap_events = (uint32_t)(i % 10);
+                break;
+        }
+    }
+    return &root;
+}
+
+static diram_hotwire_context_t* transform(diram_hotwire_target_t target,
+                                          diram_ast_node_t* root, bool parallel) {
+    diram_hotwire_context_t* context = diram_hotwire_create(target);
+    assert(context != NULL);
+    diram_hotwire_set_parallel(context, parallel);
+    assert(diram_hotwire_transform(context, root));
+    return context;
+}
+
+void test_parallel_transform() {
+    printf("Testing parallel transform...\n");
+
+    diram_ast_node_t* nodes = malloc(TEST_NODES * sizeof(diram_ast_node_t));
+    assert(nodes != NULL);
+    diram_ast_node_t* root = build_tree(nodes);
+
+    diram_hotwire_target_t targets[] = { HOTWIRE_TARGET_NATIVE_ASM, HOTWIRE_TARGET_WASM };
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+        diram_hotwire_context_t* serial = transform(targets[t], root, false);
+        // Byte-identical on every run, whatever order the pool finishes in
+        for (int run = 0; run < 5; run++) {
+            diram_hotwire_context_t* parallel = transform(targets[t], root, true);
+            assert(parallel->output_size == serial->output_size);
+            assert(memcmp(parallel->output_buffer, serial->output_buffer, serial->output_size) == 0);
+            // Toggles still land in the real feature table, in order
+            assert(parallel->execution_table->feature_count == serial->execution_table->feature_count);
+            diram_hotwire_destroy(parallel);
+        }
+        printf("  V %s: %zu bytes identical\n",
+               diram_hotwire_target_to_string(targets[t]), serial->output_size);
+        diram_hotwire_destroy(serial);
+    }
+
+    free(nodes);
+}
+
+void test_wasm_binary() {
+    printf("Testing binary WASM target...\n");
+
+    diram_ast_node_t* nodes = malloc(TEST_NODES * sizeof(diram_ast_node_t));
+    assert(nodes != NULL);
+    diram_ast_node_t* root = build_tree(nodes);
+
+    diram_hotwire_context_t* context = transform(HOTWIRE_TARGET_WASM_BINARY, root, false);
+    const uint8_t* module = (const uint8_t*)context->output_buffer;
+    assert(context->output_size > 8);
+    assert(memcmp(module, DIRAM_WASM_MAGIC, 4) == 0 && module[4] == DIRAM_WASM_VERSION);
+    assert(module[8] == WASM_SECTION_TYPE);
+
+    // LEB128 round trips through the boundary values
+    diram_wasm_buffer_t buffer = {0};
+    diram_wasm_emit_u32(&buffer, 624485);
+    diram_wasm_emit_i32(&buffer, -123456);
+    diram_wasm_emit_i32(&buffer, 64);
+    const uint8_t expected[] = { 0xE5, 0x8E, 0x26, 0xC0, 0xBB, 0x78, 0xC0, 0x00 };
+    assert(buffer.size == sizeof(expected) && memcmp(buffer.data, expected, sizeof(expected)) == 0);
+    diram_wasm_buffer_free(&buffer);
+
+    printf("  V %zu-byte module\n", context->output_size);
+    diram_hotwire_destroy(context);
+    free(nodes);
+}
+
+static size_t count_occurrences(const char* text, const char* needle) {
+    size_t count = 0;
+    for (const char* at = strstr(text, needle); at; at = strstr(at + 1, needle)) count++;
+    return count;
+}
+
+#define PEEPHOLE_BLOCK 10
+#define PEEPHOLE_BLOCKS (TEST_NODES / PEEPHOLE_BLOCK)
+
+// Blocks each pass has something to do in: two checks of the same feature,
+// two identical constraints, a trace opcode, four allocations, then an
+// unknown opcode whose ud2 ends the straight-line run
+static diram_ast_node_t* build_peephole_tree(diram_ast_node_t* nodes) {
+    static diram_ast_node_t* children[TEST_NODES];
+    static diram_ast_node_t root;
+
+    memset(&root, 0, sizeof(root));
+    memset(nodes, 0, TEST_NODES * sizeof(diram_ast_node_t));
+    root.type = AST_NODE_ROOT;
+    root.children = children;
+    root.child_count = PEEPHOLE_BLOCKS * PEEPHOLE_BLOCK;
+
+    for (size_t i = 0; i < root.child_count; i++) {
+        diram_ast_node_t* node = &nodes[i];
+        children[i] = node;
+        snprintf(g_names[i], sizeof(g_names[i]), "node_%zu", i);
+
+        size_t slot = i % PEEPHOLE_BLOCK;
+        if (slot < 2) {
+            node->type = AST_NODE_FEATURE_TOGGLE;
+            node->data.feature.name = "cryptographic_receipts";
+            node->data.feature.enabled = true;
+        } else if (slot < 4) {
+            node->type = AST_NODE_CONSTRAINT;
+            node->data.constraint.name = g_names[i];
+            node->data.constraint.max_heap_events = (uint32_t)(i / PEEPHOLE_BLOCK % 10);
+        } else if (slot == 4) {
+            node->type = AST_NODE_OPCODE;
+            node->data.opcode.name = "trace";
+            node->data.opcode.code = 0x03;
+        } else if (slot < 9) {
+            node->type = AST_NODE_ALLOCATION;
+            node->data.allocation.size = 64 * slot;
+            node->data.allocation.tag = g_names[i];
+        } else {
+            node->type = AST_NODE_OPCODE;
+            node->data.opcode.name = "barrier";
+        }
+    }
+    return &root;
+}
+
+void test_peephole() {
+    printf("Testing peephole passes...\n");
+
+    diram_ast_node_t* nodes = malloc(TEST_NODES * sizeof(diram_ast_node_t));
+    assert(nodes != NULL);
+    diram_ast_node_t* root = build_peephole_tree(nodes);
+
+    // Whole program: serial and parallel recording optimize the same
+    diram_hotwire_context_t* outputs[2];
+    for (int parallel = 0; parallel < 2; parallel++) {
+        diram_hotwire_context_t* context = diram_hotwire_create(HOTWIRE_TARGET_NATIVE_ASM);
+        assert(context != NULL);
+        diram_hotwire_set_parallel(context, parallel);
+        diram_hotwire_set_optimize(context, true);
+        assert(diram_hotwire_transform(context, root));
+        assert(context->ir == NULL);
+        assert(context->pass_count == 3);
+        for (uint32_t i = 0; i < context->pass_count; i++) {
+            assert(context->pass_stats[i].after <= context->pass_stats[i].before);
+            if (i > 0) assert(context->pass_stats[i].before == context->pass_stats[i - 1].after);
+        }
+        outputs[parallel] = context;
+    }
+    assert(outputs[0]->output_size == outputs[1]->output_size);
+    assert(memcmp(outputs[0]->output_buffer, outputs[1]->output_buffer, outputs[0]->output_size) == 0);
+    // Per block: a fused check of three instructions, a hoisted check of
+    // two, and four allocations batched from eight instructions into five
+    const diram_hotwire_pass_stats_t* stats = outputs[0]->pass_stats;
+    const uint32_t removed[] = { 3 * PEEPHOLE_BLOCKS, 2 * PEEPHOLE_BLOCKS, 3 * PEEPHOLE_BLOCKS };
+    for (uint32_t i = 0; i < outputs[0]->pass_count; i++) {
+        assert(stats[i].before - stats[i].after == removed[i]);
+        printf("  V %s: %u -> %u\n", stats[i].name, stats[i].before, stats[i].after);
+    }
+    diram_hotwire_destroy(outputs[0]);
+    diram_hotwire_destroy(outputs[1]);
+
+    // Repeated constraint, repeated feature check, four adjacent allocations
+    memset(nodes, 0, 9 * sizeof(diram_ast_node_t));
+    diram_ast_node_t* children[9];
+    for (size_t i = 0; i < 9; i++) children[i] = &nodes[i];
+    diram_ast_node_t small = { .type = AST_NODE_ROOT, .children = children, .child_count = 9 };
+    for (size_t i = 0; i < 2; i++) {
+        nodes[i].type = AST_NODE_FEATURE_TOGGLE;
+        nodes[i].data.feature.name = "cryptographic_receipts";
+        nodes[i].data.feature.enabled = true;
+    }
+    for (size_t i = 2; i < 4; i++) {
+        nodes[i].type = AST_NODE_CONSTRAINT;
+        nodes[i].data.constraint.name = "heap";
+        nodes[i].data.constraint.max_heap_events = 3;
+    }
+    nodes[4].type = AST_NODE_OPCODE;
+    nodes[4].data.opcode.name = "barrier";
+    for (size_t i = 5; i < 9; i++) {
+        nodes[i].type = AST_NODE_ALLOCATION;
+        nodes[i].data.allocation.size = 64 * i;
+        nodes[i].data.allocation.tag = "batch";
+    }
+
+    diram_hotwire_context_t* plain = transform(HOTWIRE_TARGET_NATIVE_ASM, &small, false);
+    diram_hotwire_context_t* context = diram_hotwire_create(HOTWIRE_TARGET_NATIVE_ASM);
+    assert(context != NULL);
+    diram_hotwire_set_optimize(context, true);
+    assert(diram_hotwire_transform(context, &small));
+    const char* text = diram_hotwire_get_output(context);
+
+    assert(count_occurrences(plain->output_buffer, "call diram_check_constraint") == 2);
+    assert(count_occurrences(text, "call diram_check_constraint") == 1);
+    assert(count_occurrences(plain->output_buffer, "call diram_feature_enabled") == 2);
+    assert(count_occurrences(text, "call diram_feature_enabled") == 1);
+    assert(count_occurrences(text, "call diram_alloc_traced") == 0);
+    assert(count_occurrences(text, "call diram_alloc_batch") == 1);
+    assert(strstr(text, ".alloc_sizes_0:\n.quad 320, 384, 448, 512") != NULL);
+    assert(context->pass_stats[0].before - context->pass_stats[0].after == 3);
+    assert(context->pass_stats[1].before - context->pass_stats[1].after == 2);
+    assert(context->pass_stats[2].before - context->pass_stats[2].after == 3);
+    printf("  V fused, hoisted and batched\n");
+
+    diram_hotwire_destroy(plain);
+    diram_hotwire_destroy(context);
+    free(nodes);
+}
+
+static const char g_manifest[] =
+    "<diram-config version=\"1.0.0\">\n"
+    "  <features>\n"
+    "    <toggle name=\"predictive_allocation\" enabled=\"true\">\n"
+    "      <description>Lookahead</description>\n"
+    "      <constraint>epsilon_limit=0.6</constraint>\n"
+    "    </toggle>\n"
+    "  </features>\n"
+    "  <opcodes>\n"
+    "    <opcode name=\"ALLOC\" code=\"0x01\"><operands>\n"
+    "      <operand name=\"size\" type=\"size_t\" position=\"1\"/>\n"
+    "      <operand name=\"tag\" type=\"string\" position=\"2\"/>\n"
+    "    </operands></opcode>\n"
+    "  </opcodes>\n"
+    "  <policies><policy name=\"zero-trust\" type=\"security\">\n"
+    "    <rule>all_allocations_traced</rule><rule>pid_binding</rule>\n"
+    "  </policy></policies>\n"
+    "  <memory_regions>\n"
+    "    <region name=\"system\" base=\"0x1000\" size=\"16MB\" protection=\"rx\"/>\n"
+    "  </memory_regions>\n"
+    "</diram-config>\n";
+
+static void write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    assert(file != NULL);
+    fputs(text, file);
+    fclose(file);
+}
+
+void test_snapshot() {
+    printf("Testing manifest snapshots...\n");
+
+    const char* source = "/tmp/diram_test_snapshot.xml";
+    const char* cache = "/tmp/diram_test_snapshot.xml.snap";
+    write_file(source, g_manifest);
+    unlink(cache);
+
+    // Miss, then hit on an unchanged source
+    diram_snapshot_status_t status;
+    diram_snapshot_t* snapshot = diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_NATIVE_ASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_REBUILT && snapshot->mapped);
+    diram_snapshot_close(snapshot);
+    snapshot = diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_NATIVE_ASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_HIT);
+
+    // Same output and tree as compiling directly
+    diram_parser_t* parser = diram_parser_create(g_manifest, sizeof(g_manifest) - 1);
+    diram_ast_node_t* root = diram_parser_parse(parser);
+    assert(root != NULL);
+    diram_hotwire_context_t* direct = transform(HOTWIRE_TARGET_NATIVE_ASM, root, false);
+    size_t output_size;
+    const uint8_t* output = diram_snapshot_output(snapshot, &output_size);
+    assert(output_size == direct->output_size);
+    assert(memcmp(output, direct->output_buffer, output_size) == 0);
+    assert(snapshot->header->node_count == diram_ast_count_nodes(root));
+
+    const diram_snapshot_node_t* region = diram_snapshot_find(snapshot, AST_NODE_MEMORY_REGION, "system");
+    assert(region && region->value1 == 0x1000 && region->value2 == 16u << 20 && region->flags == 5);
+    const diram_snapshot_node_t* policy = diram_snapshot_find(snapshot, AST_NODE_POLICY, "zero-trust");
+    assert(policy && policy->link_count == 2);
+    assert(strcmp(diram_snapshot_string(snapshot, snapshot->links[policy->first_link + 1]), "pid_binding") == 0);
+
+    diram_ast_arena_t* arena = diram_ast_arena_create();
+    diram_ast_node_t* loaded = diram_snapshot_load_tree(snapshot, arena);
+    assert(loaded != NULL);
+    assert(diram_ast_count_nodes(loaded) == diram_ast_count_nodes(root));
+    diram_ast_node_t* opcode = diram_ast_find_child(loaded, AST_NODE_OPCODE, "ALLOC");
+    assert(opcode && opcode->data.opcode.code == 1 && opcode->data.opcode.operand_count == 2);
+    assert(strcmp(opcode->data.opcode.operands[1]->data.operand.type, "string") == 0);
+    diram_hotwire_context_t* reloaded = transform(HOTWIRE_TARGET_NATIVE_ASM, loaded, false);
+    assert(reloaded->output_size == direct->output_size);
+    assert(memcmp(reloaded->output_buffer, direct->output_buffer, output_size) == 0);
+    diram_hotwire_destroy(reloaded);
+    diram_ast_arena_destroy(arena);
+    diram_hotwire_destroy(direct);
+    diram_parser_destroy(parser);
+    diram_snapshot_close(snapshot);
+
+    // Another target, then an edited source, invalidate the snapshot
+    snapshot = diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_WASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_REBUILT);
+    diram_snapshot_close(snapshot);
+    char edited[sizeof(g_manifest)];
+    memcpy(edited, g_manifest, sizeof(g_manifest));
+    edited[strstr(edited, "16MB") - edited] = '8';
+    write_file(source, edited);
+    snapshot = diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_WASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_REBUILT);
+    region = diram_snapshot_find(snapshot, AST_NODE_MEMORY_REGION, "system");
+    assert(region && region->value2 == 86u << 20);
+    diram_snapshot_close(snapshot);
+
+    // A corrupt byte fails the checksum and is rebuilt; a truncated file is rejected
+    FILE* file = fopen(cache, "r+b");
+    assert(file != NULL);
+    fseek(file, -3, SEEK_END);
+    fputc('#', file);
+    fclose(file);
+    assert(diram_snapshot_open(cache) == NULL);
+    assert(strstr(diram_snapshot_error(), "checksum") != NULL);
+    snapshot = diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_WASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_REBUILT);
+    diram_snapshot_close(snapshot);
+    assert(truncate(cache, 100) == 0);
+    assert(diram_snapshot_open(cache) == NULL);
+
+    // An unwritable cache still compiles, from memory
+    snapshot = diram_snapshot_compile(source, "/nonexistent/dir/x.snap", HOTWIRE_TARGET_WASM, &status);
+    assert(snapshot != NULL && status == DIRAM_SNAPSHOT_UNSAVED && !snapshot->mapped);
+    diram_snapshot_close(snapshot);
+
+    // Parse errors are reported, not cached
+    write_file(source, "<diram-config><features>");
+    assert(diram_snapshot_compile(source, NULL, HOTWIRE_TARGET_WASM, &status) == NULL);
+    assert(strstr(diram_snapshot_error(), source) != NULL);
+
+    unlink(source);
+    unlink(cache);
+    printf("  V hit, invalidated, rebuilt after corruption\n");
+}
+
+// Runtime the JIT-compiled checks call into
+typedef struct {
+    int64_t feature_on;
+    uint64_t heap_events;
+    uint64_t allocated;
+    int traced_calls;
+    int batch_calls;
+    int policy_calls;
+} jit_env_t;
+
+static int64_t jit_feature_enabled(uint64_t rdi, uint64_t rsi, uint64_t rdx, uint64_t rcx, void* env) {
+    (void)rdi; (void)rsi; (void)rdx; (void)rcx;
+    return ((jit_env_t*)env)->feature_on;
+}
+
+static int64_t jit_check_constraint(uint64_t rdi, uint64_t rsi, uint64_t rdx, uint64_t rcx, void* env) {
+    (void)rdi; (void)rsi; (void)rdx;
+    return ((jit_env_t*)env)->heap_events <= rcx;
+}
+
+static int64_t jit_alloc_traced(uint64_t rdi, uint64_t rsi, uint64_t rdx, uint64_t rcx, void* env) {
+    (void)rsi; (void)rdx; (void)rcx;
+    ((jit_env_t*)env)->allocated += rdi;
+    ((jit_env_t*)env)->traced_calls++;
+    return 0x1000;
+}
+
+static int64_t jit_alloc_batch(uint64_t rdi, uint64_t rsi, uint64_t rdx, uint64_t rcx, void* env) {
+    (void)rdx;
+    const uint64_t* sizes = (const uint64_t*)(uintptr_t)rsi;
+    uint64_t* out = (uint64_t*)(uintptr_t)rcx;
+    for (uint64_t i = 0; i < rdi; i++) {
+        ((jit_env_t*)env)->allocated += sizes[i];
+        out[i] = 0x1000 * (i + 1);
+    }
+    ((jit_env_t*)env)->batch_calls++;
+    return 0;
+}
+
+static int64_t jit_enforce_policy(uint64_t rdi, uint64_t rsi, uint64_t rdx, uint64_t rcx, void* env) {
+    (void)rdi; (void)rsi; (void)rdx; (void)rcx;
+    ((jit_env_t*)env)->policy_calls++;
+    return 1;
+}
+
+static const diram_hotwire_jit_symbol_t g_jit_symbols[] = {
+    { "diram_feature_enabled", jit_feature_enabled },
+    { "diram_check_constraint", jit_check_constraint },
+    { "diram_alloc_traced", jit_alloc_traced },
+    { "diram_alloc_batch", jit_alloc_batch },
+    { "diram_trace_enable", jit_enforce_policy },
+    { "diram_enforce_policy", jit_enforce_policy },
+};
+#define JIT_SYMBOL_COUNT (sizeof(g_jit_symbols) / sizeof(g_jit_symbols[0]))
+
+static diram_hotwire_jit_t* jit_compile(diram_ast_node_t* root, bool optimize, size_t symbol_count,
+                                        diram_hotwire_context_t** out_context) {
+    diram_hotwire_context_t* context = diram_hotwire_create(HOTWIRE_TARGET_NATIVE_JIT);
+    assert(context != NULL);
+    diram_hotwire_set_optimize(context, optimize);
+    assert(diram_hotwire_transform(context, root));
+    assert(context->output_size == 0);
+    diram_hotwire_jit_t* jit = diram_hotwire_jit_compile(context, g_jit_symbols, symbol_count);
+    *out_context = context;
+    return jit;
+}
+
+static const char* jit_run(const diram_hotwire_jit_t* jit, jit_env_t* env) {
+    return diram_hotwire_jit_exit_name(jit, diram_hotwire_jit_entry(jit)(env));
+}
+
+void test_jit() {
+    printf("Testing JIT target...\n");
+
+    // Toggle, constraint, trace opcode, four allocations, region, policy
+    static char* rules[] = { "deny_exec_heap" };
+    diram_ast_node_t nodes[9];
+    diram_ast_node_t* children[9];
+    memset(nodes, 0, sizeof(nodes));
+    for (size_t i = 0; i < 9; i++) children[i] = &nodes[i];
+    diram_ast_node_t root = { .type = AST_NODE_ROOT, .children = children, .child_count = 9 };
+    nodes[0].type = AST_NODE_FEATURE_TOGGLE;
+    nodes[0].data.feature.name = "cryptographic_receipts";
+    nodes[0].data.feature.enabled = true;
+    nodes[1].type = AST_NODE_CONSTRAINT;
+    nodes[1].data.constraint.name = "heap";
+    nodes[1].data.constraint.max_heap_events = 3;
+    nodes[2].type = AST_NODE_OPCODE;
+    nodes[2].data.opcode.name = "trace";
+    nodes[2].data.opcode.code = 0x03;
+    for (size_t i = 3; i < 7; i++) {
+        nodes[i].type = AST_NODE_ALLOCATION;
+        nodes[i].data.allocation.size = 64 * i;
+        nodes[i].data.allocation.tag = "jit";
+    }
+    nodes[7].type = AST_NODE_MEMORY_REGION;
+    nodes[7].data.memory_region.name = "arena";
+    nodes[7].data.memory_region.base_address = 0x10000;
+    nodes[7].data.memory_region.size = 4096;
+    nodes[8].type = AST_NODE_POLICY;
+    nodes[8].data.policy.name = "guard";
+    nodes[8].data.policy.type = "security";
+    nodes[8].data.policy.enforced = true;
+    nodes[8].data.policy.rules = rules;
+    nodes[8].data.policy.rule_count = 1;
+
+    // Unoptimized and optimized programs agree on every outcome
+    for (int optimize = 0; optimize < 2; optimize++) {
+        diram_hotwire_context_t* context;
+        diram_hotwire_jit_t* jit = jit_compile(&root, optimize, JIT_SYMBOL_COUNT, &context);
+        assert(jit != NULL);
+
+        jit_env_t env = { .feature_on = 1, .heap_events = 2 };
+        assert(strcmp(jit_run(jit, &env), "end") == 0);
+        assert(env.allocated == 64 * (3 + 4 + 5 + 6));
+        assert(env.policy_calls == 2);
+        assert(optimize ? env.batch_calls == 1 && env.traced_calls == 0
+                        : env.batch_calls == 0 && env.traced_calls == 4);
+
+        jit_env_t disabled = { .feature_on = 0 };
+        assert(strcmp(jit_run(jit, &disabled), ".feature_disabled") == 0);
+        assert(disabled.allocated == 0);
+        jit_env_t violated = { .feature_on = 1, .heap_events = 4 };
+        assert(strcmp(jit_run(jit, &violated), ".constraint_violation") == 0);
+        assert(violated.allocated == 0);
+
+        printf("  V %s: %zu bytes of code\n", optimize ? "optimized" : "plain",
+               diram_hotwire_jit_code_size(jit));
+        diram_hotwire_jit_destroy(jit);
+        diram_hotwire_destroy(context);
+    }
+
+    // Unknown opcodes trap
+    nodes[2].data.opcode.code = 0;
+    diram_hotwire_context_t* context;
+    diram_hotwire_jit_t* jit = jit_compile(&root, true, JIT_SYMBOL_COUNT, &context);
+    jit_env_t env = { .feature_on = 1 };
+    assert(jit != NULL && strcmp(jit_run(jit, &env), "trap") == 0);
+    diram_hotwire_jit_destroy(jit);
+    diram_hotwire_destroy(context);
+
+    // Calls must resolve, and stores to fixed addresses are refused
+    assert(jit_compile(&root, true, JIT_SYMBOL_COUNT - 1, &context) == NULL);
+    assert(strstr(diram_hotwire_get_error(context), "diram_enforce_policy") != NULL);
+    diram_hotwire_destroy(context);
+    nodes[3].data.allocation.address = 0x4000;
+    assert(jit_compile(&root, false, JIT_SYMBOL_COUNT, &context) == NULL);
+    assert(strstr(diram_hotwire_get_error(context), "0x4000") != NULL);
+    diram_hotwire_destroy(context);
+    printf("  V exits, traps and link errors\n");
+}
+
+int main() {
+    printf("DIRAM Hotwire Test Suite\n");
+    printf("========================\n\n");
+
+    test_parallel_transform();
+    test_wasm_binary();
+    test_peephole();
+    test_snapshot();
+    test_jit();
+    diram_async_pool_shutdown();
+
+    printf("\nAll tests completed successfully.\n");
+    return 0;
+}
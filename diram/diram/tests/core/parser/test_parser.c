@@ -0,0 +1,272 @@
+#include "diram/core/parser/parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+static const char g_manifest[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<!-- sample manifest -->\n"
+    "<diram-config version=\"1.0.0\">\n"
+    "    <metadata><project>OBINexus DIRAM</project></metadata>\n"
+    "    <features>\n"
+    "        <toggle name=\"predictive_allocation\" enabled=\"true\">\n"
+    "            <description>Lookahead &amp; promises</description>\n"
+    "            <policy>zero-trust</policy>\n"
+    "            <constraint>epsilon_limit=0.6</constraint>\n"
+    "        </toggle>\n"
+    "        <toggle name='memory_isolation' enabled='false'/>\n"
+    "    </features>\n"
+    "    <opcodes>\n"
+    "        <opcode name=\"ALLOC\" code=\"0x01\">\n"
+    "            <operands>\n"
+    "                <operand name=\"size\" type=\"size_t\" position=\"1\"/>\n"
+    "                <operand name=\"tag\" type=\"string\" position=\"2\"/>\n"
+    "            </operands>\n"
+    "            <constraints><heap_events max=\"3\"/></constraints>\n"
+    "            <policy>verify_receipt</policy>\n"
+    "        </opcode>\n"
+    "    </opcodes>\n"
+    "    <policies>\n"
+    "        <policy name=\"zero-trust\" type=\"security\">\n"
+    "            <rule>all_allocations_traced</rule>\n"
+    "            <rule><![CDATA[pid<binding>]]></rule>\n"
+    "        </policy>\n"
+    "    </policies>\n"
+    "    <memory_regions>\n"
+    "        <region name=\"system\" base=\"0x00000000\" size=\"16MB\" protection=\"rx\"/>\n"
+    "        <region name=\"trace_buffer\" base=\"0xF0000000\" size=\"256KB\" protection=\"w\"/>\n"
+    "    </memory_regions>\n"
+    "    <build><targets>\n"
+    "        <target name=\"native\" platform=\"x86_64\">\n"
+    "            <compiler>gcc</compiler><flags>-O2 -fPIC</flags>\n"
+    "        </target>\n"
+    "    </targets></build>\n"
+    "</diram-config>\n";
+
+void test_tokens_are_views() {
+    printf("Testing zero-copy tokens...\n");
+
+    diram_tokenizer_t* tokenizer = diram_tokenizer_create(g_manifest, sizeof(g_manifest) - 1);
+    assert(tokenizer != NULL);
+    size_t count = 0;
+    bool saw_cdata = false;
+    for (;;) {
+        diram_token_t token = diram_tokenizer_next(tokenizer);
+        assert(token.type != TOKEN_ERROR);
+        if (token.type == TOKEN_EOF) break;
+        // Every token points into the original buffer
+        assert(token.value.string_value.data == g_manifest + token.offset);
+        assert(token.offset + token.length <= sizeof(g_manifest) - 1);
+        if (diram_token_equals(tokenizer, &token, "pid<binding>")) {
+            assert(token.type == TOKEN_TEXT);
+            assert(token.line == 26);
+            saw_cdata = true;
+        }
+        count++;
+    }
+    assert(saw_cdata);
+    printf("  V %zu tokens, all views into the input\n", count);
+    diram_tokenizer_destroy(tokenizer);
+}
+
+void test_manifest() {
+    printf("Testing manifest parse...\n");
+
+    diram_parser_t* parser = diram_parser_create(g_manifest, sizeof(g_manifest) - 1);
+    assert(parser != NULL);
+    diram_ast_node_t* root = diram_parser_parse(parser);
+    if (!root) printf("  error: %s\n", diram_parser_get_error(parser));
+    assert(root != NULL);
+    assert(diram_ast_validate(root));
+
+    diram_ast_node_t* toggle = diram_ast_find_child(root, AST_NODE_FEATURE_TOGGLE, "predictive_allocation");
+    assert(toggle && toggle->data.feature.enabled);
+    assert(strcmp(toggle->data.feature.description, "Lookahead & promises") == 0);
+    assert(strcmp(toggle->data.feature.policy, "zero-trust") == 0);
+    toggle = diram_ast_find_child(root, AST_NODE_FEATURE_TOGGLE, "memory_isolation");
+    assert(toggle && !toggle->data.feature.enabled);
+
+    diram_ast_node_t* constraint = diram_ast_find_child(root, AST_NODE_CONSTRAINT, "predictive_allocation");
+    assert(constraint && constraint->data.constraint.epsilon_value == 0.6);
+    constraint = diram_ast_find_child(root, AST_NODE_CONSTRAINT, "ALLOC");
+    assert(constraint && constraint->data.constraint.max_heap_events == 3);
+
+    diram_ast_node_t* opcode = diram_ast_find_child(root, AST_NODE_OPCODE, "ALLOC");
+    assert(opcode && opcode->data.opcode.code == 1 && opcode->data.opcode.operand_count == 2);
+    assert(strcmp(opcode->data.opcode.operands[1]->data.operand.type, "string") == 0);
+
+    diram_ast_node_t* policy = diram_ast_find_child(root, AST_NODE_POLICY, "zero-trust");
+    assert(policy && policy->data.policy.rule_count == 2);
+    assert(strcmp(policy->data.policy.rules[1], "pid<binding>") == 0);
+
+    diram_ast_node_t* region = diram_ast_find_child(root, AST_NODE_MEMORY_REGION, "system");
+    assert(region && region->data.memory_region.size == 16u << 20);
+    assert(region->data.memory_region.protection_flags == 5);
+    region = diram_ast_find_child(root, AST_NODE_MEMORY_REGION, "trace_buffer");
+    assert(region && region->data.memory_region.base_address == 0xF0000000u);
+    assert(region->data.memory_region.size == 256u << 10);
+
+    diram_ast_node_t* target = diram_ast_find_child(root, AST_NODE_BUILD_TARGET, "native");
+    assert(target && strcmp(target->data.build_target.flags, "-O2 -fPIC") == 0);
+
+    // Document order: toggle, its constraint, toggle, opcode, its constraint, ...
+    assert(root->child_count == 9);
+    assert(root->children[1]->type == AST_NODE_CONSTRAINT);
+    assert(diram_ast_count_nodes(root) == 12);
+
+    printf("  V %zu nodes\n", diram_ast_count_nodes(root));
+    diram_parser_destroy(parser);
+}
+
+static size_t g_visited = 0;
+
+static void* count_visit(diram_ast_visitor_t* self, diram_ast_node_t* node) {
+    (void)self;
+    (void)node;
+    g_visited++;
+    return NULL;
+}
+
+static void check_ranges(const diram_ast_arena_t* arena, const diram_ast_node_t* node) {
+    assert(node->arena == arena);
+    assert(node >= arena->nodes && node < arena->nodes + arena->node_count);
+    assert(node->first_child != DIRAM_AST_NO_RANGE);
+    for (size_t i = 0; i < node->child_count; i++) {
+        assert(node->children[i] == &arena->nodes[node->first_child + i]);
+        assert(node->children[i]->parent == node);
+        check_ranges(arena, node->children[i]);
+    }
+}
+
+void test_arena_layout() {
+    printf("Testing arena layout...\n");
+
+    diram_parser_t* parser = diram_parser_create(g_manifest, sizeof(g_manifest) - 1);
+    diram_ast_node_t* root = diram_parser_parse(parser);
+    assert(root != NULL);
+    const diram_ast_arena_t* arena = parser->arena;
+
+    // Breadth-first: the root first, its children right behind it
+    assert(root == arena->nodes && root->first_child == 1);
+    assert(arena->node_count == diram_ast_count_nodes(root));
+    check_ranges(arena, root);
+    diram_ast_node_t* opcode = diram_ast_find_child(root, AST_NODE_OPCODE, "ALLOC");
+    assert(opcode->data.opcode.operands[1] == opcode->data.opcode.operands[0] + 1);
+    assert(opcode->data.opcode.operands[0]->parent == opcode);
+
+    diram_ast_visitor_t visitor = { .visit_constraint = count_visit };
+    g_visited = 0;
+    diram_ast_accept(root, &visitor);
+    assert(g_visited == 2);
+
+    // Growing after compaction leaves the run and falls back to children[]
+    assert(diram_parser_emit_feature_toggle(parser, "late", true));
+    assert(root->first_child == DIRAM_AST_NO_RANGE);
+    assert(diram_ast_find_child(root, AST_NODE_FEATURE_TOGGLE, "late") != NULL);
+    assert(diram_ast_count_nodes(root) == arena->node_count + 1);
+
+    printf("  V %zu nodes in one breadth-first array\n", arena->node_count);
+    diram_parser_destroy(parser);
+}
+
+static void expect_error(const char* xml, const char* message, uint32_t line) {
+    diram_parser_t* parser = diram_parser_create(xml, strlen(xml));
+    assert(parser != NULL);
+    assert(diram_parser_parse(parser) == NULL);
+    assert(diram_parser_has_error(parser));
+    if (!strstr(diram_parser_get_error(parser), message) || parser->error_line != line) {
+        printf("  unexpected error: %s\n", diram_parser_get_error(parser));
+        assert(0);
+    }
+    diram_parser_destroy(parser);
+}
+
+static int g_violations = 0;
+
+static void count_violation(const char* violation) {
+    (void)violation;
+    g_violations++;
+}
+
+void test_errors() {
+    printf("Testing parse errors...\n");
+
+    expect_error("<diram-config>\n<features></policies>\n</diram-config>", "Mismatched", 2);
+    expect_error("<diram-config>\n\n<features>", "end of input", 3);
+    expect_error("<diram-config><features><toggle enabled=\"true\"/></features></diram-config>",
+                 "requires name", 1);
+    expect_error("<diram-config>\n<memory_regions><region name=\"a\" size=\"12XB\"/>"
+                 "</memory_regions></diram-config>", "Invalid value", 2);
+    expect_error("<diram-config a=\"x<y\"/>", "'<' in attribute value", 1);
+    expect_error("<diram-config/><extra/>", "after the document", 1);
+
+    // Policy violations reach the handler, and fail the parse by default
+    const char* xml = "<diram-config><memory_regions>"
+                      "<region name=\"r\" size=\"4KB\" protection=\"rwq\"/>"
+                      "</memory_regions></diram-config>";
+    diram_parser_t* parser = diram_parser_create(xml, strlen(xml));
+    diram_parser_set_policy_handler(parser, count_violation);
+    assert(diram_parser_parse(parser) == NULL);
+    assert(g_violations == 1);
+    diram_parser_destroy(parser);
+
+    parser = diram_parser_create(xml, strlen(xml));
+    parser->validate_policies = false;
+    diram_parser_set_policy_handler(parser, count_violation);
+    assert(diram_parser_parse(parser) != NULL);
+    assert(g_violations == 2);
+    diram_parser_destroy(parser);
+
+    printf("  V errors carry line numbers\n");
+}
+
+void test_mapped_file() {
+    printf("Testing mapped manifest...\n");
+
+    const char* path = "/tmp/diram_test_manifest.xml";
+    FILE* file = fopen(path, "w");
+    assert(file != NULL);
+    const size_t regions = 100000;
+    fputs("<?xml version=\"1.0\"?>\n<diram-config>\n<memory_regions>\n", file);
+    for (size_t i = 0; i < regions; i++) {
+        fprintf(file, "  <region name=\"region_%zu\" base=\"0x%zx\" size=\"%zuKB\" protection=\"rw\"/>\n",
+                i, i << 20, i % 64 + 1);
+    }
+    fputs("</memory_regions>\n</diram-config>\n", file);
+    long size = ftell(file);
+    fclose(file);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    diram_parser_t* parser = diram_parser_create_from_file(path);
+    assert(parser != NULL && parser->mapped);
+    diram_ast_node_t* root = diram_parser_parse(parser);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    assert(root != NULL && root->child_count == regions);
+    diram_ast_node_t* last = root->children[regions - 1];
+    assert(strcmp(last->data.memory_region.name, "region_99999") == 0);
+    assert(last->data.memory_region.size == (99999 % 64 + 1) * 1024);
+
+    double ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+    printf("  V %ld bytes, %zu regions in %.1f ms\n", size, regions, ms);
+    diram_parser_destroy(parser);
+    remove(path);
+
+    assert(diram_parser_create_from_file("/nonexistent/diram.xml") == NULL);
+}
+
+int main() {
+    printf("DIRAM Parser Test Suite\n");
+    printf("=======================\n\n");
+
+    test_tokens_are_views();
+    test_manifest();
+    test_arena_layout();
+    test_errors();
+    test_mapped_file();
+
+    printf("\nAll tests completed successfully.\n");
+    return 0;
+}
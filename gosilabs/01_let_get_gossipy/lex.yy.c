@@ -502,7 +502,7 @@ Position current_pos = {1, 1, 0};
 TokenList global_tokens;
 
 void update_position() {
-    for (int i = 0; yytext[i]; i++) {
+    for (int i = 0; i < yyleng; i++) {
         if (yytext[i] == '\n') {
             current_pos.line++;
             current_pos.column = 1;
@@ -515,7 +515,7 @@ void update_position() {
 
 Token make_token(TokenType type) {
     Position start_pos = current_pos;
-    Token token = create_token(type, yytext, start_pos);
+    Token token = create_token(&global_tokens, type, yytext, (size_t)yyleng, start_pos);
     update_position();
     return token;
 }
@@ -1973,15 +1973,46 @@ void yyfree (void * ptr )
 #line 121 "lexer.l"
 
 
-/* Store tokens for pipeline access */
-int lex_and_store() {
+/* Lex source, or yyin when source is NULL. A non-NULL source is scanned
+   from memory and must outlive global_tokens, whose lexemes point into it.
+   With a sink, global_tokens.tokens is a batch buffer: every full batch is
+   handed to the sink and reused, so only the token text is kept */
+int lex_and_stream(const char *source, size_t length, TokenBatchSink sink, void *context) {
     int token_type;
+    int total = 0;
     token_list_init(&global_tokens);
+    current_pos = (Position){1, 1, 0};
+    
+    if (source) {
+        global_tokens.source = source;
+        global_tokens.source_length = length;
+        yy_scan_bytes(source, (int)length);
+    } else {
+        /* Every scan deletes its buffer below, and flex only creates one
+           for yyin on its first call; restarting gives this scan its own */
+        yyrestart(yyin);
+    }
     
     while ((token_type = yylex()) != 0) {
         if (token_type == TOKEN_EOF) break;
+        if (sink && global_tokens.count >= TOKEN_BATCH_SIZE) {
+            total += (int)global_tokens.count;
+            sink(global_tokens.tokens, global_tokens.count, context);
+            global_tokens.count = 0;
+        }
+    }
+    if (sink && global_tokens.count > 0) {
+        total += (int)global_tokens.count;
+        sink(global_tokens.tokens, global_tokens.count, context);
+        global_tokens.count = 0;
     }
     
-    return global_tokens.count;
+    yy_delete_buffer(YY_CURRENT_BUFFER);
+    return sink ? total : (int)global_tokens.count;
+}
+
+/* Store tokens for pipeline access */
+int lex_and_store(const char *source, size_t length) {
+    return lex_and_stream(source, length, NULL, NULL);
 }
 
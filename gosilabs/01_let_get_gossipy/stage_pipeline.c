@@ -4,10 +4,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 extern FILE *yyin;
 extern TokenList global_tokens;
-extern int lex_and_store();
+extern int lex_and_store(const char *source, size_t length);
+
+// Source mapped by stage 2; global_tokens points into it until cleanup
+static const char *mapped_source = NULL;
+static size_t mapped_length = 0;
 
 // ===== TOKEN UTILITIES =====
 const char* token_type_name(TokenType type) {
@@ -48,44 +59,463 @@ const char* token_type_name(TokenType type) {
     }
 }
 
-Token create_token(TokenType type, const char *lexeme, Position pos) {
+// ===== TOKEN STORAGE =====
+// Token text comes from a bump arena owned by the list, identifiers and
+// keywords are interned, and everything else points straight into the
+// source when there is one, so lexing does no per-token malloc.
+
+#define TOKEN_ARENA_BLOCK_SIZE 16384
+#define INTERN_INITIAL_CAPACITY 64
+
+static char *token_arena_alloc(TokenList *list, size_t size) {
+    TokenArenaBlock *block = list->arena;
+    if (!block || block->size - block->used < size) {
+        size_t block_size = size > TOKEN_ARENA_BLOCK_SIZE ? size : TOKEN_ARENA_BLOCK_SIZE;
+        block = malloc(sizeof(TokenArenaBlock) + block_size);
+        if (!block) {
+            return NULL;
+        }
+        block->next = list->arena;
+        block->used = 0;
+        block->size = block_size;
+        list->arena = block;
+    }
+    char *memory = block->data + block->used;
+    block->used += size;
+    return memory;
+}
+
+static char *token_arena_copy(TokenList *list, const char *text, size_t length) {
+    char *copy = token_arena_alloc(list, length + 1);
+    if (copy) {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// FNV-1a
+static uint32_t intern_hash(const char *text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int intern_table_grow(InternTable *table) {
+    size_t capacity = table->capacity ? table->capacity * 2 : INTERN_INITIAL_CAPACITY;
+    InternEntry *entries = calloc(capacity, sizeof(InternEntry));
+    if (!entries) {
+        return 0;
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        const InternEntry *entry = &table->entries[i];
+        if (!entry->text) {
+            continue;
+        }
+        size_t slot = entry->hash & (capacity - 1);
+        while (entries[slot].text) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot] = *entry;
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+    return 1;
+}
+
+// Returns the list's single NUL-terminated copy of text, so interned
+// lexemes can be compared by pointer
+const char* token_intern(TokenList *list, const char *text, size_t length) {
+    InternTable *table = &list->interns;
+    if ((table->count + 1) * 4 > table->capacity * 3 && !intern_table_grow(table)) {
+        return NULL;
+    }
+
+    uint32_t hash = intern_hash(text, length);
+    size_t slot = hash & (table->capacity - 1);
+    while (table->entries[slot].text) {
+        const InternEntry *entry = &table->entries[slot];
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->text, text, length) == 0) {
+            return entry->text;
+        }
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+
+    const char *copy = token_arena_copy(list, text, length);
+    if (!copy) {
+        return NULL;
+    }
+    table->entries[slot].text = copy;
+    table->entries[slot].length = length;
+    table->entries[slot].hash = hash;
+    table->count++;
+    return copy;
+}
+
+static int token_is_interned(TokenType type) {
+    return type == TOKEN_IDENTIFIER || (type >= TOKEN_DEF && type <= TOKEN_LET);
+}
+
+Token create_token(TokenList *list, TokenType type, const char *lexeme, size_t length, Position pos) {
     Token token;
     token.type = type;
-    token.lexeme = strdup(lexeme ? lexeme : "");
+    token.length = length;
     token.pos = pos;
     token.value.int_val = 0; // default
+
+    if (token_is_interned(type)) {
+        token.lexeme = token_intern(list, lexeme, length);
+    } else if (list->source && (size_t)pos.offset + length <= list->source_length) {
+        token.lexeme = list->source + pos.offset;
+    } else {
+        token.lexeme = token_arena_copy(list, lexeme, length);
+    }
+    if (!token.lexeme) {
+        token.lexeme = "";
+        token.length = 0;
+    }
     return token;
 }
 
 void token_list_init(TokenList *list) {
+    memset(list, 0, sizeof(*list));
     list->tokens = malloc(sizeof(Token) * 32);
-    list->count = 0;
-    list->capacity = 32;
+    list->capacity = list->tokens ? 32 : 0;
 }
 
 void token_list_add(TokenList *list, Token token) {
     if (list->count >= list->capacity) {
-        list->capacity *= 2;
-        list->tokens = realloc(list->tokens, sizeof(Token) * list->capacity);
+        size_t capacity = list->capacity ? list->capacity * 2 : 32;
+        Token *tokens = realloc(list->tokens, sizeof(Token) * capacity);
+        if (!tokens) {
+            return;
+        }
+        list->tokens = tokens;
+        list->capacity = capacity;
     }
     list->tokens[list->count++] = token;
 }
 
 void token_list_free(TokenList *list) {
-    for (size_t i = 0; i < list->count; i++) {
-        free(list->tokens[i].lexeme);
+    TokenArenaBlock *block = list->arena;
+    while (block) {
+        TokenArenaBlock *next = block->next;
+        free(block);
+        block = next;
     }
+    free(list->interns.entries);
     free(list->tokens);
-    list->tokens = NULL;
-    list->count = 0;
-    list->capacity = 0;
+    memset(list, 0, sizeof(*list));
+}
+
+// ===== BUFFERED OUTPUT =====
+// Output is formatted into a large buffer and written with one fwrite per
+// fill instead of a printf per token. Without a stream the buffer grows.
+
+#define OUTPUT_BUFFER_SIZE 65536
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    FILE *out;
+} OutputBuffer;
+
+static void output_init(OutputBuffer *buffer, FILE *out, size_t capacity) {
+    buffer->data = malloc(capacity);
+    buffer->length = 0;
+    buffer->capacity = buffer->data ? capacity : 0;
+    buffer->out = out;
+}
+
+static void output_flush(OutputBuffer *buffer) {
+    if (buffer->out && buffer->length > 0) {
+        fwrite(buffer->data, 1, buffer->length, buffer->out);
+        buffer->length = 0;
+    }
+}
+
+static void output_free(OutputBuffer *buffer) {
+    output_flush(buffer);
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
+
+// Makes room for size more bytes, flushing first when there is a stream
+static int output_reserve(OutputBuffer *buffer, size_t size) {
+    if (buffer->capacity - buffer->length >= size) {
+        return 1;
+    }
+    output_flush(buffer);
+    if (buffer->capacity - buffer->length >= size) {
+        return 1;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity - buffer->length < size) {
+        capacity *= 2;
+    }
+    char *data = realloc(buffer->data, capacity);
+    if (!data) {
+        return 0;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 1;
+}
+
+static void output_write(OutputBuffer *buffer, const char *text, size_t length) {
+    if (output_reserve(buffer, length)) {
+        memcpy(buffer->data + buffer->length, text, length);
+        buffer->length += length;
+    }
+}
+
+static void output_printf(OutputBuffer *buffer, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t space = buffer->capacity - buffer->length;
+    int needed = vsnprintf(buffer->data ? buffer->data + buffer->length : NULL, space, format, args);
+    va_end(args);
+    if (needed < 0) {
+        return;
+    }
+    if ((size_t)needed >= space) {
+        if (!output_reserve(buffer, (size_t)needed + 1)) {
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(buffer->data + buffer->length, (size_t)needed + 1, format, args);
+        va_end(args);
+    }
+    buffer->length += (size_t)needed;
+}
+
+static void format_token_table(OutputBuffer *buffer, const Token *token) {
+    output_printf(buffer, "| %-12s | %-15.*s | %4d:%-2d |\n", 
+                  token_type_name(token->type),
+                  (int)token->length, token->lexeme,
+                  token->pos.line, token->pos.column);
+}
+
+static void format_json_string(OutputBuffer *buffer, const char *text, size_t length) {
+    output_write(buffer, "\"", 1);
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            char escaped[2] = {'\\', (char)c};
+            output_write(buffer, escaped, 2);
+        } else if (c == '\n') {
+            output_write(buffer, "\\n", 2);
+        } else if (c == '\t') {
+            output_write(buffer, "\\t", 2);
+        } else if (c < 0x20) {
+            output_printf(buffer, "\\u%04x", c);
+        } else {
+            output_write(buffer, (const char *)&c, 1);
+        }
+    }
+    output_write(buffer, "\"", 1);
+}
+
+static void format_token_json(OutputBuffer *buffer, const Token *token) {
+    output_printf(buffer, "    {\n      \"type\": \"%s\",\n      \"lexeme\": ",
+                  token_type_name(token->type));
+    format_json_string(buffer, token->lexeme, token->length);
+    output_printf(buffer, ",\n      \"position\": {\"line\": %d, \"column\": %d, \"offset\": %d}\n    }",
+                  token->pos.line, token->pos.column, token->pos.offset);
 }
 
 void print_token_table(const Token *token) {
-    printf("| %-12s | %-15s | %4d:%-2d |\n", 
-           token_type_name(token->type),
-           token->lexeme,
-           token->pos.line, token->pos.column);
+    OutputBuffer buffer;
+    output_init(&buffer, stdout, 256);
+    format_token_table(&buffer, token);
+    output_free(&buffer);
+}
+
+void print_token_json(const Token *token) {
+    OutputBuffer buffer;
+    output_init(&buffer, stdout, 256);
+    format_token_json(&buffer, token);
+    output_write(&buffer, "\n", 1);
+    output_free(&buffer);
+}
+
+// ===== TOKEN RING =====
+// The lexer pushes token batches into a bounded ring drained by the
+// emitter thread, so printing overlaps lexing and at most
+// TOKEN_RING_BATCHES batches are in flight.
+
+#define TOKEN_RING_BATCHES 8
+
+typedef struct {
+    Token tokens[TOKEN_BATCH_SIZE];
+    size_t count;
+} TokenBatch;
+
+typedef struct {
+    TokenBatch batches[TOKEN_RING_BATCHES];
+    size_t head;    // next batch to emit
+    size_t tail;    // next batch to fill
+    size_t filled;
+    int closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} TokenRing;
+
+static void token_ring_init(TokenRing *ring) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->filled = 0;
+    ring->closed = 0;
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->not_empty, NULL);
+    pthread_cond_init(&ring->not_full, NULL);
+}
+
+static void token_ring_destroy(TokenRing *ring) {
+    pthread_mutex_destroy(&ring->lock);
+    pthread_cond_destroy(&ring->not_empty);
+    pthread_cond_destroy(&ring->not_full);
+}
+
+// TokenBatchSink: copies a batch from the lexer, blocking while the ring is full
+static void token_ring_push(const Token *tokens, size_t count, void *context) {
+    TokenRing *ring = context;
+    pthread_mutex_lock(&ring->lock);
+    while (ring->filled == TOKEN_RING_BATCHES) {
+        pthread_cond_wait(&ring->not_full, &ring->lock);
+    }
+    TokenBatch *batch = &ring->batches[ring->tail];
+    pthread_mutex_unlock(&ring->lock);
+    
+    // The emitter does not touch the tail slot until it is published
+    memcpy(batch->tokens, tokens, sizeof(Token) * count);
+    batch->count = count;
+    
+    pthread_mutex_lock(&ring->lock);
+    ring->tail = (ring->tail + 1) % TOKEN_RING_BATCHES;
+    ring->filled++;
+    pthread_cond_signal(&ring->not_empty);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+static void token_ring_close(TokenRing *ring) {
+    pthread_mutex_lock(&ring->lock);
+    ring->closed = 1;
+    pthread_cond_signal(&ring->not_empty);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+// Waits for the oldest batch; NULL once the ring is closed and drained
+static const TokenBatch *token_ring_front(TokenRing *ring) {
+    pthread_mutex_lock(&ring->lock);
+    while (ring->filled == 0 && !ring->closed) {
+        pthread_cond_wait(&ring->not_empty, &ring->lock);
+    }
+    const TokenBatch *batch = ring->filled ? &ring->batches[ring->head] : NULL;
+    pthread_mutex_unlock(&ring->lock);
+    return batch;
+}
+
+static void token_ring_pop(TokenRing *ring) {
+    pthread_mutex_lock(&ring->lock);
+    ring->head = (ring->head + 1) % TOKEN_RING_BATCHES;
+    ring->filled--;
+    pthread_cond_signal(&ring->not_full);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+// ===== TOKEN EMITTER =====
+
+typedef enum {
+    EMIT_TABLE,
+    EMIT_JSON
+} EmitFormat;
+
+typedef struct {
+    TokenRing *ring;
+    EmitFormat format;
+    OutputBuffer out;
+    OutputBuffer *patterns;  // stage 3 pattern lines, or NULL
+    size_t emitted;
+} TokenEmitter;
+
+// Stage 3 hits from the token stream, printed by stage3_ast_preview
+static OutputBuffer ast_patterns;
+
+static void record_ast_pattern(OutputBuffer *patterns, const Token *token) {
+    if (token->type == TOKEN_BANG) {
+        output_printf(patterns, "→ Invocation pattern starting at %d:%d\n", 
+                      token->pos.line, token->pos.column);
+    }
+    if (token->type == TOKEN_BIND || token->type == TOKEN_UNBIND) {
+        output_printf(patterns, "→ Bind operation at %d:%d\n", 
+                      token->pos.line, token->pos.column);
+    }
+    if (token->type == TOKEN_VEC) {
+        output_printf(patterns, "→ Vector construction at %d:%d\n", 
+                      token->pos.line, token->pos.column);
+    }
+}
+
+static void token_emitter_begin(TokenEmitter *emitter) {
+    if (emitter->format == EMIT_JSON) {
+        output_printf(&emitter->out, "{\n  \"tokens\": [\n");
+        return;
+    }
+    output_printf(&emitter->out, "Token Table:\n");
+    output_printf(&emitter->out, "┌─────────────┬─────────────────┬─────────┐\n");
+    output_printf(&emitter->out, "│ Token Type  │ Lexeme          │ Pos     │\n");
+    output_printf(&emitter->out, "├─────────────┼─────────────────┼─────────┤\n");
+}
+
+static void token_emitter_emit(TokenEmitter *emitter, const Token *tokens, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (emitter->format == EMIT_JSON) {
+            if (emitter->emitted > 0) {
+                output_write(&emitter->out, ",\n", 2);
+            }
+            format_token_json(&emitter->out, &tokens[i]);
+        } else {
+            format_token_table(&emitter->out, &tokens[i]);
+        }
+        if (emitter->patterns) {
+            record_ast_pattern(emitter->patterns, &tokens[i]);
+        }
+        emitter->emitted++;
+    }
+}
+
+static void token_emitter_end(TokenEmitter *emitter) {
+    if (emitter->format == EMIT_JSON) {
+        output_printf(&emitter->out, "%s  ]\n}\n", emitter->emitted ? "\n" : "");
+    } else {
+        output_printf(&emitter->out, "└─────────────┴─────────────────┴─────────┘\n");
+    }
+    output_flush(&emitter->out);
+}
+
+static void *token_emitter_run(void *arg) {
+    TokenEmitter *emitter = arg;
+    const TokenBatch *batch;
+    while ((batch = token_ring_front(emitter->ring))) {
+        token_emitter_emit(emitter, batch->tokens, batch->count);
+        token_ring_pop(emitter->ring);
+    }
+    return NULL;
+}
+
+// TokenBatchSink for when the emitter thread could not be started
+static void token_emitter_sink(const Token *tokens, size_t count, void *context) {
+    token_emitter_emit(context, tokens, count);
 }
 
 // ===== PIPELINE STAGES =====
@@ -100,62 +530,84 @@ void stage1_raw_lexemes(const char *filename) {
     
     printf("Raw file content:\n");
     printf("─────────────────\n");
-    char buffer[1024];
-    while (fgets(buffer, sizeof(buffer), file)) {
-        printf("%s", buffer);
+    char *buffer = malloc(OUTPUT_BUFFER_SIZE);
+    size_t length;
+    while (buffer && (length = fread(buffer, 1, OUTPUT_BUFFER_SIZE, file)) > 0) {
+        fwrite(buffer, 1, length, stdout);
     }
+    free(buffer);
     printf("─────────────────\n");
     fclose(file);
 }
 
-void stage2_token_stream(const char *filename) {
+// Lexes filename on this thread while an emitter thread formats the
+// token stream; with patterns, stage 3 hits are collected on the way
+void stage2_token_stream(const char *filename, EmitFormat format, OutputBuffer *patterns) {
     printf("\n=== STAGE 2: Token Stream ===\n");
     
-    yyin = fopen(filename, "r");
-    if (!yyin) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
         perror("Cannot open file");
         return;
     }
     
-    int token_count = lex_and_store();
-    fclose(yyin);
-    
-    printf("Generated %d tokens:\n\n", token_count);
+    // Map regular files so tokens can point into the source; anything
+    // else (pipes, empty files) is read through yyin as before
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size <= INT_MAX) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            mapped_source = map;
+            mapped_length = (size_t)st.st_size;
+        }
+    }
+    if (mapped_source) {
+        close(fd);
+    } else {
+        yyin = fdopen(fd, "r");
+        if (!yyin) {
+            perror("Cannot open file");
+            close(fd);
+            return;
+        }
+    }
     
-    // Table format
-    printf("Token Table:\n");
-    printf("┌─────────────┬─────────────────┬─────────┐\n");
-    printf("│ Token Type  │ Lexeme          │ Pos     │\n");
-    printf("├─────────────┼─────────────────┼─────────┤\n");
+    static TokenRing ring;
+    TokenEmitter emitter = {&ring, format, {NULL, 0, 0, NULL}, patterns, 0};
+    output_init(&emitter.out, stdout, OUTPUT_BUFFER_SIZE);
+    if (patterns) {
+        output_init(patterns, NULL, 1024);
+    }
+    token_emitter_begin(&emitter);
     
-    for (size_t i = 0; i < global_tokens.count; i++) {
-        print_token_table(&global_tokens.tokens[i]);
+    int token_count;
+    pthread_t thread;
+    token_ring_init(&ring);
+    if (pthread_create(&thread, NULL, token_emitter_run, &emitter) == 0) {
+        token_count = lex_and_stream(mapped_source, mapped_length, token_ring_push, &ring);
+        token_ring_close(&ring);
+        pthread_join(thread, NULL);
+    } else {
+        token_count = lex_and_stream(mapped_source, mapped_length, token_emitter_sink, &emitter);
     }
-    printf("└─────────────┴─────────────────┴─────────┘\n");
+    token_ring_destroy(&ring);
+    if (!mapped_source) {
+        fclose(yyin);
+    }
+    
+    token_emitter_end(&emitter);
+    output_free(&emitter.out);
+    printf("Generated %d tokens\n", token_count);
 }
 
 void stage3_ast_preview() {
     printf("\n=== STAGE 3: AST Preview ===\n");
     printf("(Parser will build AST nodes from token stream)\n\n");
     
-    // Mock AST analysis of token patterns
+    // Mock AST analysis of token patterns, collected during stage 2
     printf("Detected patterns:\n");
-    for (size_t i = 0; i < global_tokens.count; i++) {
-        Token *token = &global_tokens.tokens[i];
-        
-        if (token->type == TOKEN_BANG) {
-            printf("→ Invocation pattern starting at %d:%d\n", 
-                   token->pos.line, token->pos.column);
-        }
-        if (token->type == TOKEN_BIND || token->type == TOKEN_UNBIND) {
-            printf("→ Bind operation at %d:%d\n", 
-                   token->pos.line, token->pos.column);
-        }
-        if (token->type == TOKEN_VEC) {
-            printf("→ Vector construction at %d:%d\n", 
-                   token->pos.line, token->pos.column);
-        }
-    }
+    fwrite(ast_patterns.data, 1, ast_patterns.length, stdout);
+    output_free(&ast_patterns);
 }
 
 void stage4_codegen_preview() {
@@ -169,11 +621,92 @@ void stage4_codegen_preview() {
     printf("• NIL handling → NaN or NIL_PTR checks\n");
 }
 
+// ===== MICROBENCHMARKS =====
+// make bench: the lexer and interning on the shared harness in the
+// top-level bench/, over a source built from repeats of a .gs file
+
+#ifdef GOSI_OBIBENCH
+#include "obibench.h"
+
+#define BENCH_SOURCE_REPEATS 64
+
+typedef struct {
+    char *source;
+    size_t length;
+    size_t tokens;
+} LexBench;
+
+static void bench_count_tokens(const Token *tokens, size_t count, void *context) {
+    (void)tokens;
+    ((LexBench *)context)->tokens += count;
+}
+
+static void bench_lex(void *arg, uint64_t count) {
+    LexBench *bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        lex_and_stream(bench->source, bench->length, bench_count_tokens, bench);
+        token_list_free(&global_tokens);
+    }
+}
+
+// Identifiers already interned: the lookup every repeated name takes
+static void bench_intern(void *arg, uint64_t count) {
+    static const char *const names[] = { "EVERYTHING", "UNIVERSE", "magnitude", "position", "V" };
+    TokenList *list = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        const char *name = names[i % 5];
+        obibench_do_not_optimize(token_intern(list, name, strlen(name)));
+    }
+}
+
+static int run_microbench(const char *filename, int argc, char **argv) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        perror(filename);
+        return 1;
+    }
+    char one[OUTPUT_BUFFER_SIZE];
+    size_t length = fread(one, 1, sizeof(one), file);
+    fclose(file);
+
+    LexBench bench = {malloc(length * BENCH_SOURCE_REPEATS + 1), length * BENCH_SOURCE_REPEATS, 0};
+    if (!bench.source || length == 0) {
+        fprintf(stderr, "Cannot build benchmark source from %s\n", filename);
+        free(bench.source);
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_SOURCE_REPEATS; i++) {
+        memcpy(bench.source + i * length, one, length);
+    }
+    bench.source[bench.length] = '\0';
+
+    TokenList interns;
+    token_list_init(&interns);
+
+    obibench_suite_t *suite = obibench_init("gosilang-lexer", argc, argv);
+    obibench_run_bytes(suite, "lex_and_stream", bench_lex, &bench, bench.length);
+    obibench_run(suite, "token_intern", bench_intern, &interns);
+    int status = obibench_finish(suite);
+
+    token_list_free(&interns);
+    free(bench.source);
+    return status;
+}
+#endif
+
 // ===== MAIN PIPELINE =====
+// The tests include this file and define GOSI_NO_MAIN
 
+#ifndef GOSI_NO_MAIN
 int main(int argc, char **argv) {
+#ifdef GOSI_OBIBENCH
+    // <file.gs> --microbench [harness options]
+    if (argc > 2 && strcmp(argv[2], "--microbench") == 0) {
+        return run_microbench(argv[1], argc - 2, argv + 2);
+    }
+#endif
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <file.gs> [--tokens|--raw|--all]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <file.gs> [--tokens|--json|--raw|--all]\n", argv[0]);
         return 1;
     }
     
@@ -186,20 +719,26 @@ int main(int argc, char **argv) {
     
     if (strcmp(output_mode, "--all") == 0) {
         stage1_raw_lexemes(filename);
-        stage2_token_stream(filename);
+        stage2_token_stream(filename, EMIT_TABLE, &ast_patterns);
         stage3_ast_preview();
         stage4_codegen_preview();
     } else if (strcmp(output_mode, "--tokens") == 0) {
-        stage2_token_stream(filename);
+        stage2_token_stream(filename, EMIT_TABLE, NULL);
+    } else if (strcmp(output_mode, "--json") == 0) {
+        stage2_token_stream(filename, EMIT_JSON, NULL);
     } else if (strcmp(output_mode, "--raw") == 0) {
         stage1_raw_lexemes(filename);
     }
     
     // Cleanup
     token_list_free(&global_tokens);
+    if (mapped_source) {
+        munmap((void *)mapped_source, mapped_length);
+    }
     
     printf("\n✅ Pipeline complete - ready for Phase 2 (Parser)\n");
     printf("#hacc #noghosting #sorrynotsorry\n");
     
     return 0;
 }
+#endif
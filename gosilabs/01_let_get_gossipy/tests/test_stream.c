@@ -0,0 +1,305 @@
+// tests/test_stream.c
+// Token stream checks: the lexer hands tokens over in batches, the ring
+// keeps them in order, and stage 2 prints through the emitter thread
+// exactly what a single-threaded emitter would
+
+#include "stage_pipeline.c"
+#include <assert.h>
+#include <sys/wait.h>
+
+static const char line_text[] =
+    "let V := !vec<3>(24, 6.5, 4) #bind(V, w) #unbind(w) span..range \"q\" // x\n";
+
+#define SOURCE_LINES 200
+
+static char *build_source(size_t *length) {
+    size_t line_length = sizeof(line_text) - 1;
+    char *source = malloc(line_length * SOURCE_LINES + 1);
+    assert(source != NULL);
+    for (int i = 0; i < SOURCE_LINES; i++) {
+        memcpy(source + i * line_length, line_text, line_length);
+    }
+    *length = line_length * SOURCE_LINES;
+    source[*length] = '\0';
+    return source;
+}
+
+static void write_file(const char *path, const char *text, size_t length) {
+    FILE *file = fopen(path, "wb");
+    assert(file != NULL);
+    assert(fwrite(text, 1, length, file) == length);
+    fclose(file);
+}
+
+static int same_token(const Token *a, const Token *b) {
+    return a->type == b->type && a->length == b->length &&
+           a->pos.line == b->pos.line && a->pos.column == b->pos.column &&
+           a->pos.offset == b->pos.offset && memcmp(a->lexeme, b->lexeme, a->length) == 0;
+}
+
+// What stage 2 should print for text, formatted on this thread
+static char *render_stage2(const char *text, size_t length, EmitFormat format, OutputBuffer *patterns) {
+    int count = lex_and_store(text, length);
+    TokenEmitter emitter = {NULL, format, {NULL, 0, 0, NULL}, patterns, 0};
+    output_init(&emitter.out, NULL, 256);
+    if (patterns) {
+        output_init(patterns, NULL, 256);
+    }
+    output_printf(&emitter.out, "\n=== STAGE 2: Token Stream ===\n");
+    token_emitter_begin(&emitter);
+    token_emitter_emit(&emitter, global_tokens.tokens, global_tokens.count);
+    token_emitter_end(&emitter);
+    output_printf(&emitter.out, "Generated %d tokens\n", count);
+    token_list_free(&global_tokens);
+    output_write(&emitter.out, "", 1);
+    return emitter.out.data;
+}
+
+// Runs stage 2 on path with stdout redirected, then cleans up as main does
+static char *capture_stage2(const char *path, EmitFormat format, OutputBuffer *patterns) {
+    FILE *capture = tmpfile();
+    assert(capture != NULL);
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    assert(saved >= 0 && dup2(fileno(capture), STDOUT_FILENO) >= 0);
+    stage2_token_stream(path, format, patterns);
+    fflush(stdout);
+    assert(dup2(saved, STDOUT_FILENO) >= 0);
+    close(saved);
+
+    long size = ftell(capture);
+    assert(size >= 0);
+    char *output = malloc((size_t)size + 1);
+    assert(output != NULL);
+    rewind(capture);
+    assert(fread(output, 1, (size_t)size, capture) == (size_t)size);
+    output[size] = '\0';
+    fclose(capture);
+
+    token_list_free(&global_tokens);
+    if (mapped_source) {
+        munmap((void *)mapped_source, mapped_length);
+        mapped_source = NULL;
+        mapped_length = 0;
+    }
+    return output;
+}
+
+typedef struct {
+    Token *tokens;
+    size_t count;
+    size_t batches;
+    int short_batch;
+} BatchLog;
+
+static void log_batch(const Token *tokens, size_t count, void *context) {
+    BatchLog *log = context;
+    assert(count > 0 && count <= TOKEN_BATCH_SIZE);
+    // Only the last batch may be short
+    assert(!log->short_batch);
+    log->short_batch = count < TOKEN_BATCH_SIZE;
+    log->tokens = realloc(log->tokens, sizeof(Token) * (log->count + count));
+    assert(log->tokens != NULL);
+    memcpy(log->tokens + log->count, tokens, sizeof(Token) * count);
+    log->count += count;
+    log->batches++;
+}
+
+static void test_lex_batches(void) {
+    printf("Testing lexer batches...\n");
+
+    size_t length;
+    char *source = build_source(&length);
+    int count = lex_and_store(source, length);
+    assert(count > TOKEN_BATCH_SIZE * TOKEN_RING_BATCHES);
+    TokenList stored = global_tokens;
+
+    // The batches add up to the stored list, in order
+    BatchLog log = {NULL, 0, 0, 0};
+    assert(lex_and_stream(source, length, log_batch, &log) == count);
+    assert(log.count == (size_t)count);
+    assert(log.batches == ((size_t)count + TOKEN_BATCH_SIZE - 1) / TOKEN_BATCH_SIZE);
+    for (size_t i = 0; i < log.count; i++) {
+        assert(same_token(&log.tokens[i], &stored.tokens[i]));
+    }
+
+    // Only the batch buffer is kept
+    assert(global_tokens.count == 0 && global_tokens.capacity <= TOKEN_BATCH_SIZE * 2);
+
+    free(log.tokens);
+    token_list_free(&global_tokens);
+    token_list_free(&stored);
+    free(source);
+    printf("Lexer batches test passed\n");
+}
+
+static TokenRing ring;
+
+#define RING_TEST_BATCHES 200
+
+static void fill_batch(Token *tokens, size_t index, size_t *count) {
+    *count = index % TOKEN_BATCH_SIZE + 1;
+    for (size_t j = 0; j < *count; j++) {
+        tokens[j].pos.offset = (int)(index * 1000 + j);
+    }
+}
+
+static void *ring_producer(void *arg) {
+    (void)arg;
+    static Token tokens[TOKEN_BATCH_SIZE];
+    size_t count;
+    for (size_t i = 0; i < RING_TEST_BATCHES; i++) {
+        fill_batch(tokens, i, &count);
+        token_ring_push(tokens, count, &ring);
+    }
+    token_ring_close(&ring);
+    return NULL;
+}
+
+static void test_token_ring(void) {
+    printf("Testing token ring...\n");
+
+    static Token tokens[TOKEN_BATCH_SIZE];
+    size_t count;
+    token_ring_init(&ring);
+
+    // A full ring wraps once the oldest batch is popped
+    for (size_t i = 0; i < TOKEN_RING_BATCHES; i++) {
+        fill_batch(tokens, i, &count);
+        token_ring_push(tokens, count, &ring);
+    }
+    assert(ring.filled == TOKEN_RING_BATCHES && ring.tail == 0);
+    const TokenBatch *batch = token_ring_front(&ring);
+    assert(batch == &ring.batches[0] && batch->count == 1 && batch->tokens[0].pos.offset == 0);
+    token_ring_pop(&ring);
+    fill_batch(tokens, TOKEN_RING_BATCHES, &count);
+    token_ring_push(tokens, count, &ring);
+    assert(ring.filled == TOKEN_RING_BATCHES && ring.tail == 1);
+
+    // Closing still hands out what is queued, then NULL
+    token_ring_close(&ring);
+    for (size_t i = 1; i <= TOKEN_RING_BATCHES; i++) {
+        batch = token_ring_front(&ring);
+        assert(batch != NULL && batch->count == i % TOKEN_BATCH_SIZE + 1);
+        assert(batch->tokens[i - 1].pos.offset == (int)(i * 1000 + i - 1));
+        token_ring_pop(&ring);
+    }
+    assert(token_ring_front(&ring) == NULL && token_ring_front(&ring) == NULL);
+    token_ring_destroy(&ring);
+
+    // Across threads batches arrive in order and the ring never overfills
+    token_ring_init(&ring);
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, ring_producer, NULL) == 0);
+    size_t received = 0;
+    while ((batch = token_ring_front(&ring))) {
+        pthread_mutex_lock(&ring.lock);
+        assert(ring.filled >= 1 && ring.filled <= TOKEN_RING_BATCHES);
+        pthread_mutex_unlock(&ring.lock);
+        assert(batch->count == received % TOKEN_BATCH_SIZE + 1);
+        for (size_t j = 0; j < batch->count; j++) {
+            assert(batch->tokens[j].pos.offset == (int)(received * 1000 + j));
+        }
+        if (received % 16 == 0) {
+            usleep(1000);
+        }
+        token_ring_pop(&ring);
+        received++;
+    }
+    assert(received == RING_TEST_BATCHES);
+    pthread_join(thread, NULL);
+    token_ring_destroy(&ring);
+
+    printf("Token ring test passed\n");
+}
+
+static void test_json_string(void) {
+    printf("Testing JSON strings...\n");
+
+    OutputBuffer buffer;
+    output_init(&buffer, NULL, 4);
+    static const char text[] = "a\"b\\c\n\td\x01\x1f~";
+    format_json_string(&buffer, text, sizeof(text) - 1);
+    output_write(&buffer, "", 1);
+    assert(strcmp(buffer.data, "\"a\\\"b\\\\c\\n\\td\\u0001\\u001f~\"") == 0);
+
+    // The length bounds the string, not a NUL
+    buffer.length = 0;
+    format_json_string(&buffer, "xy\0z", 4);
+    assert(buffer.length == 11 && memcmp(buffer.data, "\"xy\\u0000z\"", 11) == 0);
+
+    output_free(&buffer);
+    printf("JSON strings test passed\n");
+}
+
+static void test_stage2_output(void) {
+    printf("Testing stage 2 output...\n");
+
+    char path[] = "/tmp/gosi_stream_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    size_t length;
+    char *source = build_source(&length);
+    write_file(path, source, length);
+
+    // The emitter thread prints what the single-threaded emitter would
+    OutputBuffer expected_patterns;
+    OutputBuffer patterns;
+    char *expected = render_stage2(source, length, EMIT_TABLE, &expected_patterns);
+    char *output = capture_stage2(path, EMIT_TABLE, &patterns);
+    assert(strcmp(output, expected) == 0);
+    assert(strstr(output, "│ Token Type  │") != NULL);
+    assert(patterns.length == expected_patterns.length && patterns.length > 0);
+    assert(memcmp(patterns.data, expected_patterns.data, patterns.length) == 0);
+    assert(strstr(patterns.data, "→ Bind operation at 200:") != NULL);
+    free(expected);
+    free(output);
+    output_free(&patterns);
+    output_free(&expected_patterns);
+
+    expected = render_stage2(source, length, EMIT_JSON, NULL);
+    output = capture_stage2(path, EMIT_JSON, NULL);
+    assert(strcmp(output, expected) == 0);
+    assert(strstr(output, "\"lexeme\": \"\\\"\"") != NULL);
+    assert(strstr(output, "\"position\": {\"line\": 200, ") != NULL);
+    free(expected);
+    free(output);
+
+    // An empty file is read through yyin and still gives a closed document
+    write_file(path, "", 0);
+    output = capture_stage2(path, EMIT_JSON, NULL);
+    assert(strcmp(output, "\n=== STAGE 2: Token Stream ===\n"
+                          "{\n  \"tokens\": [\n  ]\n}\nGenerated 0 tokens\n") == 0);
+    free(output);
+
+    // So is a pipe
+    unlink(path);
+    assert(mkfifo(path, 0600) == 0);
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        write_file(path, source, length);
+        _exit(0);
+    }
+    expected = render_stage2(source, length, EMIT_TABLE, NULL);
+    output = capture_stage2(path, EMIT_TABLE, NULL);
+    int status;
+    assert(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(strcmp(output, expected) == 0);
+    free(expected);
+    free(output);
+
+    unlink(path);
+    free(source);
+    printf("Stage 2 output test passed\n");
+}
+
+int main(void) {
+    test_lex_batches();
+    test_token_ring();
+    test_json_string();
+    test_stage2_output();
+    printf("All stream tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+// tests/test_tokens.c
+// Token storage checks: identifiers and keywords are interned, other
+// lexemes point into the source or the list's arena, and lexing from
+// memory gives the tokens lexing from yyin does
+
+#include "stage_pipeline.c"
+#include <assert.h>
+
+extern FILE *yyin;
+
+static const char sample[] =
+    "let V := !vec<3>(24, 6.5, 4)\n"
+    "#bind(V, V) // comment\n"
+    "\"x\" span..range\n";
+
+static const TokenType sample_types[] = {
+    TOKEN_LET, TOKEN_IDENTIFIER, TOKEN_ASSIGN, TOKEN_BANG, TOKEN_VEC, TOKEN_LT, TOKEN_INTEGER,
+    TOKEN_GT, TOKEN_LPAREN, TOKEN_INTEGER, TOKEN_COMMA, TOKEN_FLOAT, TOKEN_COMMA, TOKEN_INTEGER,
+    TOKEN_RPAREN, TOKEN_NEWLINE,
+    TOKEN_BIND, TOKEN_LPAREN, TOKEN_IDENTIFIER, TOKEN_COMMA, TOKEN_IDENTIFIER, TOKEN_RPAREN,
+    TOKEN_NEWLINE,
+    TOKEN_UNKNOWN, TOKEN_IDENTIFIER, TOKEN_UNKNOWN, TOKEN_SPAN, TOKEN_DOT_DOT, TOKEN_RANGE,
+    TOKEN_NEWLINE
+};
+
+#define SAMPLE_TOKENS (sizeof(sample_types) / sizeof(sample_types[0]))
+
+static void test_intern(void) {
+    printf("Testing intern table...\n");
+
+    TokenList list;
+    token_list_init(&list);
+
+    // Equal text shares one NUL-terminated copy; length is part of the key
+    char buffer[] = "alphabet";
+    const char *alpha = token_intern(&list, buffer, 5);
+    assert(alpha != NULL && alpha != buffer && strcmp(alpha, "alpha") == 0);
+    assert(token_intern(&list, "alpha", 5) == alpha);
+    const char *alphabet = token_intern(&list, buffer, 8);
+    assert(alphabet != alpha && strcmp(alphabet, "alphabet") == 0);
+    assert(token_intern(&list, "", 0) != NULL && list.interns.count == 3);
+
+    // Pointers survive the table growing and the arena taking new blocks
+    static const char *names[2000];
+    char name[32];
+    for (int i = 0; i < 2000; i++) {
+        snprintf(name, sizeof(name), "identifier_%d", i);
+        names[i] = token_intern(&list, name, strlen(name));
+        assert(names[i] != NULL);
+    }
+    assert(list.interns.count == 2003);
+    assert(list.interns.capacity >= 2003 * 4 / 3 && (list.interns.capacity & (list.interns.capacity - 1)) == 0);
+    assert(list.arena != NULL && list.arena->next != NULL);
+    for (int i = 0; i < 2000; i++) {
+        snprintf(name, sizeof(name), "identifier_%d", i);
+        assert(token_intern(&list, name, strlen(name)) == names[i]);
+        assert(strcmp(names[i], name) == 0);
+    }
+    assert(token_intern(&list, "alpha", 5) == alpha && list.interns.count == 2003);
+
+    token_list_free(&list);
+    assert(list.arena == NULL && list.interns.entries == NULL && list.tokens == NULL);
+    printf("Intern table test passed\n");
+}
+
+static void test_create_token(void) {
+    printf("Testing create token...\n");
+
+    TokenList list;
+    token_list_init(&list);
+    Position at = {1, 5, 4};
+
+    // Without a source, non-identifiers are copied into the arena
+    char text[] = "12345";
+    Token number = create_token(&list, TOKEN_INTEGER, text, 3, at);
+    assert(number.lexeme != text && number.length == 3 && memcmp(number.lexeme, "123", 3) == 0);
+    text[0] = '9';
+    assert(number.lexeme[0] == '1');
+
+    // With a source, they point into it at their offset
+    static const char source[] = "let x12 := 3.25";
+    list.source = source;
+    list.source_length = sizeof(source) - 1;
+    Position offset = {1, 12, 11};
+    Token real = create_token(&list, TOKEN_FLOAT, source + 11, 4, offset);
+    assert(real.lexeme == source + 11 && real.length == 4);
+
+    // Unless the offset would run past it
+    Position beyond = {1, 1, 14};
+    Token copied = create_token(&list, TOKEN_FLOAT, "3.25", 4, beyond);
+    assert(copied.lexeme != source + 14 && memcmp(copied.lexeme, "3.25", 4) == 0);
+
+    // Identifiers and keywords are interned wherever they come from
+    Position ident_at = {1, 5, 4};
+    Token ident = create_token(&list, TOKEN_IDENTIFIER, source + 4, 3, ident_at);
+    Token again = create_token(&list, TOKEN_IDENTIFIER, "x12", 3, at);
+    assert(ident.lexeme != source + 4 && ident.lexeme == again.lexeme && strcmp(ident.lexeme, "x12") == 0);
+    Token keyword = create_token(&list, TOKEN_LET, source, 3, at);
+    assert(keyword.lexeme == token_intern(&list, "let", 3));
+
+    // A lexeme bigger than an arena block gets a block of its own
+    list.source = NULL;
+    size_t big = TOKEN_ARENA_BLOCK_SIZE * 2;
+    char *long_text = malloc(big);
+    assert(long_text != NULL);
+    memset(long_text, '7', big);
+    Token large = create_token(&list, TOKEN_INTEGER, long_text, big, at);
+    assert(large.length == big && large.lexeme[big - 1] == '7' && large.lexeme[big] == '\0');
+    assert(list.arena->size == big + 1);
+    free(long_text);
+
+    token_list_free(&list);
+    printf("Create token test passed\n");
+}
+
+static void check_sample_tokens(const TokenList *list, const char *source) {
+    assert(list->count == SAMPLE_TOKENS);
+    const char *v = NULL;
+    int line = 1, column = 1, offset = 0;
+    for (size_t i = 0; i < list->count; i++) {
+        const Token *token = &list->tokens[i];
+        assert(token->type == sample_types[i]);
+
+        // Positions agree with the text before the token
+        while (offset < token->pos.offset) {
+            if (sample[offset++] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        assert(token->pos.line == line && token->pos.column == column);
+        assert(memcmp(token->lexeme, sample + token->pos.offset, token->length) == 0);
+
+        if (token_is_interned(token->type)) {
+            assert(token->lexeme[token->length] == '\0');
+            if (token->type == TOKEN_IDENTIFIER && token->lexeme[0] == 'V') {
+                assert(v == NULL || token->lexeme == v);
+                v = token->lexeme;
+            }
+        } else if (source) {
+            assert(token->lexeme == source + token->pos.offset);
+        }
+    }
+    assert(v != NULL);
+    assert(list->tokens[6].value.int_val == 3 && list->tokens[11].value.float_val == 6.5);
+}
+
+static void test_lex_source(void) {
+    printf("Testing lexing from memory...\n");
+
+    // Not NUL-terminated: lexing stops at the length
+    size_t length = sizeof(sample) - 1;
+    char *source = malloc(length + 8);
+    assert(source != NULL);
+    memcpy(source, sample, length);
+    memcpy(source + length, "garbage", 8);
+    assert(lex_and_store(source, length) == (int)SAMPLE_TOKENS);
+    check_sample_tokens(&global_tokens, source);
+    token_list_free(&global_tokens);
+    free(source);
+
+    printf("Lexing from memory test passed\n");
+}
+
+static void test_lex_stream(void) {
+    printf("Testing lexing from yyin...\n");
+
+    // Without a source every lexeme is a copy
+    yyin = tmpfile();
+    assert(yyin != NULL);
+    fputs(sample, yyin);
+    rewind(yyin);
+    assert(lex_and_store(NULL, 0) == (int)SAMPLE_TOKENS);
+    fclose(yyin);
+    assert(global_tokens.source == NULL && global_tokens.arena != NULL);
+    check_sample_tokens(&global_tokens, NULL);
+    token_list_free(&global_tokens);
+
+    printf("Lexing from yyin test passed\n");
+}
+
+int main(void) {
+    test_intern();
+    test_create_token();
+    test_lex_source();
+    test_lex_stream();
+    printf("All token tests passed!\n");
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 // OBINexus Gosilang Token Definitions
 // Medical device compliant token system
@@ -59,10 +60,13 @@ typedef struct {
     int offset;
 } Position;
 
-// Token structure with position and value
+// Token structure with position and value. lexeme is length bytes and is
+// not NUL-terminated: it points into the list's source text, or at the
+// interned string for identifiers and keywords
 typedef struct {
     TokenType type;
-    char *lexeme;
+    const char *lexeme;
+    size_t length;
     Position pos;
     union {
         int int_val;
@@ -70,13 +74,44 @@ typedef struct {
     } value;
 } Token;
 
-// Token list for pipeline processing
+// Bump arena block for token text, freed with the list
+typedef struct TokenArenaBlock {
+    struct TokenArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} TokenArenaBlock;
+
+// Interned string: equal identifiers share one lexeme pointer
+typedef struct {
+    const char *text;
+    size_t length;
+    uint32_t hash;
+} InternEntry;
+
+// Open-addressed intern table, capacity a power of two
+typedef struct {
+    InternEntry *entries;
+    size_t count;
+    size_t capacity;
+} InternTable;
+
+// Token list for pipeline processing. source is borrowed: the caller
+// keeps it mapped until the list is freed
 typedef struct {
     Token *tokens;
     size_t count;
     size_t capacity;
+    const char *source;
+    size_t source_length;
+    TokenArenaBlock *arena;
+    InternTable interns;
 } TokenList;
 
+// Tokens handed over per batch by lex_and_stream
+#define TOKEN_BATCH_SIZE 256
+typedef void (*TokenBatchSink)(const Token *tokens, size_t count, void *context);
+
 // YYSTYPE for flex/bison integration
 typedef union {
     int num;
@@ -88,7 +123,8 @@ extern YYSTYPE yylval;
 
 // Function declarations
 const char* token_type_name(TokenType type);
-Token create_token(TokenType type, const char *lexeme, Position pos);
+Token create_token(TokenList *list, TokenType type, const char *lexeme, size_t length, Position pos);
+const char* token_intern(TokenList *list, const char *text, size_t length);
 void token_list_init(TokenList *list);
 void token_list_add(TokenList *list, Token token);
 void token_list_free(TokenList *list);
@@ -97,6 +133,7 @@ void print_token_table(const Token *token);
 
 // External declarations for lexer integration
 extern TokenList global_tokens;
-extern int lex_and_store();
+extern int lex_and_store(const char *source, size_t length);
+extern int lex_and_stream(const char *source, size_t length, TokenBatchSink sink, void *context);
 
 #endif // TOKEN_H
@@ -437,6 +437,14 @@ const char* dop_error_to_string(dop_error_code_t error) {
         case DOP_ERROR_CHECKSUM_FAILED: return "Checksum verification failed";
         case DOP_ERROR_TOPOLOGY_FAULT: return "Topology fault detected";
         case DOP_ERROR_XML_PARSING: return "XML parsing error";
+        case DOP_ERROR_ALREADY_INITIALIZED: return "Already initialized";
+        case DOP_ERROR_INITIALIZATION_FAILED: return "Initialization failed";
+        case DOP_ERROR_VERSION_INCOMPATIBLE: return "Incompatible component version";
+        case DOP_ERROR_LIBRARY_LOAD_FAILED: return "Component library could not be loaded";
+        case DOP_ERROR_VALIDATION_FAILED: return "Component validation failed";
+        case DOP_ERROR_QUIESCE_FAILED: return "Component could not be quiesced";
+        case DOP_ERROR_SWAP_NOTIFICATION_FAILED: return "Hot swap notification failed";
+        case DOP_ERROR_CIRCUIT_OPEN: return "Circuit breaker is open";
         default: return "Unknown error";
     }
 }
\ No newline at end of file
@@ -12,4 +12,22 @@ dop_oop_interface_t* dop_adapter_func_to_oop(dop_func_create_t create_func,
 dop_func_create_t dop_adapter_oop_to_func_create(dop_oop_interface_t* oop_interface);
 dop_func_update_t dop_adapter_oop_to_func_update(dop_oop_interface_t* oop_interface);
 
+// Direct-dispatch adapter over the built-in functional API. Its methods
+// call dop_func_* directly instead of through stored function pointers,
+// and the interface sits in the same fixed-size struct as the instance it
+// points at: one indirect call per operation, and no allocation when the
+// caller provides the storage. Use &adapter->interface like any other
+// dop_oop_interface_t.
+typedef struct {
+    dop_oop_interface_t interface;  // interface.instance is the adapter
+    dop_component_t* component;
+} dop_direct_adapter_t;
+
+void dop_adapter_direct_init(dop_direct_adapter_t* adapter);
+dop_direct_adapter_t* dop_adapter_direct_create(void);      // One allocation
+void dop_adapter_direct_free(dop_direct_adapter_t* adapter); // Not its component
+
+// Update every adapter's component; returns how many succeeded
+uint32_t dop_adapter_direct_update_many(dop_direct_adapter_t* const* adapters, uint32_t count);
+
 #endif // DOP_ADAPTER_H
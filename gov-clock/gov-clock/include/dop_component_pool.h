@@ -0,0 +1,52 @@
+#ifndef DOP_COMPONENT_POOL_H
+#define DOP_COMPONENT_POOL_H
+
+#include "obinexus_dop_core.h"
+#include <stddef.h>
+
+// Pools of fixed-size objects that each carry a pthread mutex. The mutex is
+// initialised once, when the pool grows, and survives recycling; everything
+// else is zeroed when an object is handed out. Objects live in chunks that
+// never move, so acquiring and releasing only touch the pool's free list.
+//
+// Handles name an object together with a generation that changes on every
+// release, so a handle kept past a release resolves to NULL rather than to
+// whatever reused the slot.
+
+typedef struct dop_object_pool dop_object_pool_t;
+
+typedef struct {
+    uint64_t acquired;
+    uint64_t released;
+    uint32_t in_use;
+    uint32_t capacity;              // Objects allocated so far
+} dop_pool_stats_t;
+
+dop_object_pool_t* dop_object_pool_create(size_t object_size, size_t mutex_offset);
+void dop_object_pool_destroy(dop_object_pool_t* pool);     // Objects must all be released
+int dop_object_pool_reserve(dop_object_pool_t* pool, uint32_t count);
+
+void* dop_object_pool_acquire(dop_object_pool_t* pool);
+int dop_object_pool_release(dop_object_pool_t* pool, void* object);
+
+// Handles fit in 56 bits, leaving the top byte to callers
+uint64_t dop_object_pool_handle(const dop_object_pool_t* pool, const void* object);
+void* dop_object_pool_resolve(dop_object_pool_t* pool, uint64_t handle);
+void dop_object_pool_get_stats(dop_object_pool_t* pool, dop_pool_stats_t* stats);
+
+// dop_func_create_component and dop_func_destroy_component draw from one
+// pool per component type. A component handle also records the type.
+typedef uint64_t dop_component_handle_t;
+
+dop_component_handle_t dop_component_get_handle(const dop_component_t* component);
+dop_component_t* dop_component_from_handle(dop_component_handle_t handle);  // NULL once destroyed
+
+// Fill in a zeroed component's metadata (all but its id and mutex), data and
+// checksum as dop_func_create_component does, for components stored elsewhere
+void dop_component_init_state(dop_component_t* component, dop_component_type_t type);
+
+// Pre-allocate so the first count creations of a type do not allocate
+int dop_component_pool_reserve(dop_component_type_t type, uint32_t count);
+void dop_component_pool_get_stats(dop_component_type_t type, dop_pool_stats_t* stats);
+
+#endif // DOP_COMPONENT_POOL_H
@@ -3,9 +3,40 @@
 
 #include "obinexus_dop_core.h"
 
+// Looks up the component a manifest node refers to by its component_ref
+typedef dop_component_t* (*dop_manifest_component_resolver_t)(const char* component_ref, void* user_data);
+
 // XML manifest integration function declarations
 int dop_manifest_load_from_xml(const char* xml_path, dop_build_topology_t* topology);
 int dop_manifest_save_to_xml(const dop_build_topology_t* topology, const char* xml_path);
 int dop_manifest_validate_schema(const char* xml_path);
 
+// Load the build settings and also the nodes and their peer connections,
+// binding each node to the component resolve returns for its component_ref.
+// Nodes are appended to the topology; the caller frees them with
+// dop_topology_destroy_node and dop_topology_release. On failure the
+// topology keeps only the nodes it had before the call.
+int dop_manifest_load_topology_from_xml(const char* xml_path, dop_build_topology_t* topology,
+                                        dop_manifest_component_resolver_t resolve, void* user_data);
+
+// Binary manifest: a flat, offset-based image of the topology, mmap'd on
+// load instead of parsed. It records the hash of the XML it was generated
+// from and is written next to it as <xml_path>.bin; a binary whose hash no
+// longer matches the XML is stale and ignored. The layout is native byte
+// order and is versioned, so a binary from another build is regenerated.
+#define DOP_MANIFEST_BINARY_SUFFIX ".bin"
+#define DOP_MANIFEST_BINARY_VERSION 1u
+
+// FNV-1a 64 of the manifest bytes
+uint64_t dop_manifest_hash_bytes(const void* data, size_t length);
+int dop_manifest_hash_file(const char* path, uint64_t* hash);
+int dop_manifest_save_binary(const dop_build_topology_t* topology, const char* bin_path, uint64_t source_hash);
+int dop_manifest_load_binary(const char* bin_path, uint64_t source_hash, dop_build_topology_t* topology,
+                             dop_manifest_component_resolver_t resolve, void* user_data);
+
+// Load through the binary when it matches the XML. Otherwise the XML is
+// schema-checked, parsed and the binary regenerated from it.
+int dop_manifest_load_cached(const char* xml_path, dop_build_topology_t* topology,
+                             dop_manifest_component_resolver_t resolve, void* user_data);
+
 #endif // DOP_MANIFEST_H
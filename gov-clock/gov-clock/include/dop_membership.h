@@ -0,0 +1,70 @@
+#ifndef DOP_MEMBERSHIP_H
+#define DOP_MEMBERSHIP_H
+
+#include "obinexus_dop_core.h"
+
+// SWIM-style membership and failure detection over a topology's nodes.
+// Each protocol period every live node probes one member, chosen in a
+// shuffled round-robin so each member is probed once per pass. A probe
+// without an ack is retried through a few other members (indirect
+// probes); if those fail too the member becomes suspect, and dead after
+// suspect_periods periods unless it refutes the suspicion with a higher
+// incarnation. State changes spread by gossip piggybacked on probes and
+// acks, at most max_piggyback per message, each retransmitted about
+// retransmit_mult * log2(n) times: per-period traffic is O(n) however
+// large the topology, and an update reaches everyone in O(log n) periods.
+//
+// A node is up while its component's gate is accessible, and a probe gets
+// through when both ends are up and in the same partition. The protocol
+// runs in simulated periods, driven by dop_membership_period.
+//
+// Each node keeps a view of every member, 4 bytes apiece.
+
+typedef enum {
+    DOP_MEMBER_ALIVE = 0,
+    DOP_MEMBER_SUSPECT = 1,
+    DOP_MEMBER_DEAD = 2
+} dop_member_state_t;
+
+typedef struct {
+    uint32_t indirect_probes;       // Members asked to probe for us (SWIM's k)
+    uint32_t suspect_periods;       // Suspect to dead
+    uint32_t max_piggyback;         // Updates carried per message
+    uint32_t retransmit_mult;       // Times log2(n) each update is sent
+    uint64_t seed;
+} dop_membership_config_t;
+
+#define DOP_MEMBERSHIP_DEFAULT_CONFIG { 3, 5, 8, 3, 0x5eed }
+
+typedef struct dop_membership dop_membership_t;
+
+// Membership over the topology's current nodes, all alive
+dop_membership_t* dop_membership_create(dop_build_topology_t* topology,
+                                        const dop_membership_config_t* config);
+void dop_membership_destroy(dop_membership_t* membership);
+
+// Run one protocol period across all nodes
+void dop_membership_period(dop_membership_t* membership);
+
+// Simulate a network partition; nodes talk only within their partition
+void dop_membership_set_partition(dop_membership_t* membership, uint32_t node, uint32_t partition);
+
+dop_member_state_t dop_membership_state(const dop_membership_t* membership,
+                                        uint32_t observer, uint32_t member);
+
+// Members the observer has not declared dead, itself included
+uint32_t dop_membership_alive_count(const dop_membership_t* membership, uint32_t observer);
+
+typedef struct {
+    uint64_t periods;
+    uint64_t probes;
+    uint64_t indirect_probes;
+    uint64_t suspicions;            // Raised by a failed probe
+    uint64_t refutations;           // Suspected members that answered with a new incarnation
+    uint64_t deaths;                // Suspect timeouts
+    uint64_t gossip_sent;           // Piggybacked updates
+} dop_membership_stats_t;
+
+void dop_membership_get_stats(const dop_membership_t* membership, dop_membership_stats_t* stats);
+
+#endif // DOP_MEMBERSHIP_H
@@ -0,0 +1,47 @@
+#ifndef DOP_SERIALIZE_H
+#define DOP_SERIALIZE_H
+
+#include "obinexus_dop_core.h"
+#include <stddef.h>
+
+// Binary component state, the counterpart of dop_func_serialize_t for hot
+// paths: fixed-size records written straight into the caller's buffer, with
+// no allocation and no text to format or parse.
+//
+// A buffer is a header followed by one record per component. The header
+// carries a magic, the format version, the byte order it was written in,
+// the record count and size, and a hash of the records; readers reject any
+// of them that do not match. Records hold the component's id, type, state,
+// gate, timestamps and type-specific data. Name and version are fixed per
+// build and are not carried, and neither are process-local fields (mutex,
+// timer wheel and update engine registrations).
+#define DOP_SERIAL_VERSION 1u
+#define DOP_SERIAL_HEADER_SIZE 32u
+#define DOP_SERIAL_RECORD_SIZE 200u
+
+// Bytes needed for count components
+size_t dop_serialize_size(uint32_t count);
+
+// Each component is locked while its record is written. *written, when
+// given, is set to the bytes used; a buffer that is too small gets nothing
+// written and DOP_ERROR_MEMORY_ALLOCATION, with *written set to the size
+// needed.
+int dop_serialize_component(const dop_component_t* component, void* buffer, size_t size, size_t* written);
+int dop_serialize_components(const dop_component_t* const* components, uint32_t count,
+                             void* buffer, size_t size, size_t* written);
+
+// Apply a one-record buffer to an existing component of the same type,
+// under its lock. The component keeps its own id; its checksum is
+// recomputed. A running timer or armed alarm is not scheduled on this
+// process's timer wheel until it is started or armed here.
+int dop_deserialize_component(const void* buffer, size_t size, dop_component_t* component);
+
+// Every node's component, in node order; nodes without one are skipped
+int dop_serialize_topology(const dop_build_topology_t* topology, void* buffer, size_t size, size_t* written);
+
+// Apply each record to the node component with the same id, which is found
+// in O(1) when both sides list their nodes in the same order. Records with
+// no match are skipped; *applied, when given, counts those that matched.
+int dop_deserialize_topology(const void* buffer, size_t size, dop_build_topology_t* topology, uint32_t* applied);
+
+#endif // DOP_SERIALIZE_H
@@ -0,0 +1,77 @@
+#ifndef DOP_SHARED_TABLE_H
+#define DOP_SHARED_TABLE_H
+
+#include "obinexus_dop_core.h"
+
+// Component tables in named POSIX shared memory, so several processes can
+// work on the same clocks and timers without serialising them.
+//
+// Each slot holds a complete dop_component_t whose mutex is process-shared
+// and robust, so any process that attaches writable can pass the component
+// to the ordinary component functions. If a process dies holding a
+// component's lock, the next dop_shared_table_publish (or a caller using
+// dop_shared_component_lock) marks the mutex consistent and, if the
+// component fails its checksum, puts it in DOP_STATE_ERROR with its gate
+// closed.
+//
+// Each slot also carries a view: a copy of the component's observable state
+// behind a sequence lock. dop_shared_table_publish refreshes the views of
+// components that changed, so the writer calls it after updating, typically
+// once per update engine tick. Readers, which may attach read-only, read a
+// view in place between dop_shared_view_begin and dop_shared_view_retry
+// without locks, copies or system calls.
+//
+// Timer and alarm expiries are delivered by the timer wheel of the process
+// that started the timer or armed the alarm, which the component records
+// (metadata.wheel_owner). Another process restarting or stopping it leaves
+// that wheel's entry to fire and be ignored, and a process detaching stops
+// the timers and alarms it scheduled.
+
+typedef struct dop_shared_table dop_shared_table_t;
+
+typedef struct {
+    _Atomic uint32_t sequence;          // Odd while the view is being written
+    char component_id[64];
+    dop_component_type_t type;
+    dop_component_state_t state;
+    dop_gate_state_t gate_state;
+    uint64_t last_update_timestamp;
+    dop_component_data_t data;
+    uint32_t checksum;
+} dop_shared_view_t;
+
+// Create the segment; fails if one with this name already exists. Names
+// follow shm_open, e.g. "/gov_clock".
+dop_shared_table_t* dop_shared_table_create(const char* name, uint32_t capacity);
+dop_shared_table_t* dop_shared_table_attach(const char* name, bool writable);
+void dop_shared_table_detach(dop_shared_table_t* table);    // Leaves the segment in place
+int dop_shared_table_unlink(const char* name);
+
+// Slot allocation; requires a writable attachment. The id must be unique in
+// the table and fit component_id. Components stay valid until destroyed,
+// and in every process at that process's own address.
+dop_component_t* dop_shared_table_create_component(dop_shared_table_t* table,
+                                                   dop_component_type_t type,
+                                                   const char* component_id);
+int dop_shared_table_destroy_component(dop_shared_table_t* table, dop_component_t* component);
+dop_component_t* dop_shared_table_component(dop_shared_table_t* table, uint32_t slot);  // NULL if free
+
+// Lock a shared component, recovering it if its last owner died
+int dop_shared_component_lock(dop_component_t* component);
+
+// Refresh the views of components changed since the last publish; returns
+// how many were refreshed
+uint32_t dop_shared_table_publish(dop_shared_table_t* table);
+
+uint32_t dop_shared_table_capacity(const dop_shared_table_t* table);
+int dop_shared_table_find(const dop_shared_table_t* table, const char* component_id);   // Slot or -1
+
+// Views of free slots have an empty component_id
+const dop_shared_view_t* dop_shared_table_view(const dop_shared_table_t* table, uint32_t slot);
+uint32_t dop_shared_view_begin(const dop_shared_view_t* view);
+bool dop_shared_view_retry(const dop_shared_view_t* view, uint32_t sequence);
+
+// Consistent copy of a view, for readers that want one
+int dop_shared_view_read(const dop_shared_view_t* view, dop_shared_view_t* out);
+
+#endif // DOP_SHARED_TABLE_H
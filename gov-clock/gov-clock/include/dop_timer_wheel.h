@@ -0,0 +1,55 @@
+#ifndef DOP_TIMER_WHEEL_H
+#define DOP_TIMER_WHEEL_H
+
+#include "obinexus_dop_core.h"
+#include <stddef.h>
+
+// Hierarchical timing wheel: five levels of 64 slots, each level 64 times
+// coarser than the one below, so scheduling and cancelling are O(1) and a
+// tick touches only the timers due in it. A dedicated thread sleeps until
+// the next occupied slot on the monotonic clock and hands everything that
+// expired in a tick to the wheel's callback as one batch.
+//
+// Timers are named by handles that carry a generation, so cancelling one
+// that already fired is detected rather than hitting a reused timer.
+
+typedef struct dop_timer_wheel dop_timer_wheel_t;
+
+typedef struct {
+    void* context;
+    uint64_t handle;
+} dop_wheel_expiry_t;
+
+// Runs on the wheel thread without the wheel's lock; may schedule and cancel
+typedef void (*dop_wheel_batch_fn_t)(const dop_wheel_expiry_t* expired, size_t count, void* user_data);
+
+dop_timer_wheel_t* dop_timer_wheel_create(uint32_t tick_ms, dop_wheel_batch_fn_t on_expire, void* user_data);
+void dop_timer_wheel_destroy(dop_timer_wheel_t* wheel);   // Pending timers are dropped
+
+// Returns the timer's handle, or 0 if it could not be allocated
+uint64_t dop_timer_wheel_schedule(dop_timer_wheel_t* wheel, uint64_t delay_ms, void* context);
+
+// DOP_SUCCESS if the timer was still pending. Otherwise it already fired
+// (or was cancelled) and DOP_ERROR_INVALID_STATE is returned, after its
+// callback has finished unless called from that callback.
+int dop_timer_wheel_cancel(dop_timer_wheel_t* wheel, uint64_t handle);
+
+uint32_t dop_timer_wheel_pending(dop_timer_wheel_t* wheel);
+
+// The process-wide wheel, 1 ms ticks, that timer and alarm components
+// register with. A component with a timer pending (metadata.wheel_timer
+// non-zero) must be stopped or disarmed before it is destroyed.
+dop_timer_wheel_t* dop_timer_wheel_shared(void);
+
+// A handle means something only to the wheel that issued it, and a
+// component in shared memory may have been scheduled by another process,
+// so components record the scheduling process in metadata.wheel_owner.
+// Returns the pending handle if this process's wheel holds it, else 0;
+// the caller holds the component mutex.
+uint64_t dop_timer_wheel_owned(const dop_component_t* component);
+
+// Expiry handlers the shared wheel calls; stale handles are ignored
+void dop_timer_expire(dop_component_t* component, uint64_t handle);
+void dop_alarm_expire(dop_component_t* component, uint64_t handle);
+
+#endif // DOP_TIMER_WHEEL_H
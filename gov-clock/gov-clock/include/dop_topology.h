@@ -2,11 +2,49 @@
 #define DOP_TOPOLOGY_H
 
 #include "obinexus_dop_core.h"
+#include "nexus_link_semserver_x.h"
 
 // Topology management function declarations
 dop_topology_node_t* dop_topology_create_node(const char* node_id, dop_component_t* component);
+void dop_topology_destroy_node(dop_topology_node_t* node);   // Not its component
+
+// Append a node; the topology's node array grows as needed. Release frees
+// the array, not the nodes.
+int dop_topology_add_node(dop_build_topology_t* topology, dop_topology_node_t* node);
+void dop_topology_release(dop_build_topology_t* topology);
+
+// Peers are a set: adding one twice is a no-op, found by hash in O(1)
 int dop_topology_add_peer(dop_topology_node_t* node, dop_topology_node_t* peer);
+
+// Each node gets a worker thread, pinned to a core where supported, that
+// updates its component and tells its peers after every update. Peers talk
+// through bounded lock-free mailboxes, one per node, that any number of
+// peers send to and only the owning worker reads.
 int dop_topology_start_p2p_network(dop_build_topology_t* topology);
+int dop_topology_stop_p2p_network(dop_build_topology_t* topology);
+
+#define DOP_MAILBOX_CAPACITY 1024   // Messages, a power of two
+
+typedef enum {
+    DOP_PEER_MSG_UPDATED = 0,       // Sender's component was updated; payload is its update count
+    DOP_PEER_MSG_USER = 16          // First type free for applications
+} dop_peer_message_type_t;
+
+typedef struct {
+    const dop_topology_node_t* from;
+    uint32_t type;
+    uint64_t timestamp_ms;
+    uint64_t payload;
+} dop_peer_message_t;
+
+// False when the node is stopped or its mailbox is full
+bool dop_topology_send(dop_topology_node_t* to, const dop_peer_message_t* message);
 int dop_topology_test_fault_tolerance(dop_build_topology_t* topology);
 
+// Order nodes for dop_topology_start_p2p_network by a dependency plan:
+// nodes whose component is in the plan come first, dependencies before
+// dependents; the rest keep their order after them
+int dop_topology_apply_activation_plan(dop_build_topology_t* topology,
+                                       const nexus_activation_plan_t* plan);
+
 #endif // DOP_TOPOLOGY_H
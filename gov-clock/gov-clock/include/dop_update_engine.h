@@ -0,0 +1,29 @@
+#ifndef DOP_UPDATE_ENGINE_H
+#define DOP_UPDATE_ENGINE_H
+
+#include "obinexus_dop_core.h"
+
+// Batched component updates. An engine keeps the components registered with
+// it grouped by type, and a tick updates each group in three passes: lock
+// the components and gather their time fields into flat arrays, compute
+// each member's new state in one branch-free loop over those arrays, then
+// write the results back and unlock. Groups go through in blocks of 32, so a
+// tick holds at most one block's locks at a time. The clock is read once per
+// tick, not once per component.
+//
+// dop_func_update_component runs the same passes over a batch of one.
+
+typedef struct dop_update_engine dop_update_engine_t;
+
+dop_update_engine_t* dop_update_engine_create(void);
+void dop_update_engine_destroy(dop_update_engine_t* engine);   // Not its components
+
+// A component belongs to at most one engine at a time
+int dop_update_engine_add(dop_update_engine_t* engine, dop_component_t* component);
+int dop_update_engine_remove(dop_update_engine_t* engine, dop_component_t* component);
+
+// Update every registered component whose gate is open; returns how many were
+uint32_t dop_update_engine_tick(dop_update_engine_t* engine);
+uint32_t dop_update_engine_count(dop_update_engine_t* engine, dop_component_type_t type);
+
+#endif // DOP_UPDATE_ENGINE_H
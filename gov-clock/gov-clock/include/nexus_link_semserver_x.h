@@ -8,13 +8,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <stdatomic.h>
 
 // ============================================================================
 // Nexus-Link SemServer-X: Distributed Semantic Component Resolution Engine
 // ============================================================================
 
 // Core architectural principles:
-// 1. Trie-based component resolution for O(log n) lookup performance
+// 1. Radix-tree component resolution, O(key length) and lock-free lookups
 // 2. Semantic versioning with hot-swap capability support
 // 3. Fault-tolerant dependency resolution with fallback strategies
 // 4. Cryptographic verification of component integrity
@@ -105,18 +106,48 @@ typedef struct {
     uint64_t timestamp;               // Manifest generation time
 } component_manifest_t;
 
-// Trie Node for Component Resolution
-typedef struct trie_node {
-    char character;
-    bool is_end_of_component;
-    component_manifest_t* manifest;
-    struct trie_node* children[256];  // ASCII character set
-    pthread_rwlock_t lock;            // Read-write lock for node
-} trie_node_t;
+// Component Index: Adaptive Radix Tree
+// Inner nodes hold 4, 16, 48 or 256 children and grow as they fill;
+// chains of single children collapse into a prefix kept in the node below
+// (path compression), so a node costs tens of bytes instead of kilobytes.
+// Lookups and prefix scans take no locks: nodes are filled in before they
+// are published and only ever gain children in place, and a node that is
+// grown or split is replaced whole. Registrations serialize on the index
+// mutex. Replaced nodes are freed once no reader that could still see
+// them is left (epoch-based reclamation).
+typedef struct nexus_art_node nexus_art_node_t;   // Defined in the .c
+
+typedef struct {
+    _Atomic(nexus_art_node_t*) root;  // NULL while empty
+    pthread_mutex_t write_mutex;      // Serializes registrations
+    void* retired;                    // Replaced nodes awaiting reclamation
+    uint64_t component_count;
+} nexus_component_index_t;
+
+// Resolution Cache
+// Sharded LRU of resolve results keyed by (component_id, requested version,
+// strategy). Misses are cached too, as negative entries. All entries for a
+// component live in one shard and are dropped when it is registered or
+// swapped.
+#define NEXUS_RESOLUTION_CACHE_SHARDS 16
+#define NEXUS_RESOLUTION_CACHE_CAPACITY 4096   // Entries across all shards
+
+typedef struct nexus_resolution_cache nexus_resolution_cache_t;  // Defined in the .c
+
+typedef struct {
+    uint64_t hits;                    // Answered from the cache, positive or negative
+    uint64_t negative_hits;           // Of those, cached misses
+    uint64_t misses;                  // Resolved through the index
+    uint64_t evictions;               // Entries pushed out by newer ones
+    uint64_t invalidations;           // Entries dropped by registration or swap
+    uint32_t entries;                 // Held now
+    double hit_rate;                  // hits / (hits + misses), 0 before any lookup
+} nexus_cache_stats_t;
 
 // Nexus-Link Resolution Context
 typedef struct {
-    trie_node_t* component_trie;      // Root of component trie
+    nexus_component_index_t component_trie;  // Component identifiers to manifests
+    nexus_resolution_cache_t* resolution_cache;  // (identifier, version, strategy) to result
     
     // Resolution configuration
     resolution_strategy_t default_strategy;
@@ -144,7 +175,11 @@ typedef struct {
     bool enforce_governance_rules;
     char governance_policy[256];
     
-    pthread_mutex_t context_mutex;
+    // Ship of Theseus tracking
+    struct component_evolution* evolutions;
+    char evolution_log_dir[256];
+
+    pthread_mutex_t context_mutex;      // Also guards evolutions and the log directory
 } nexus_resolution_context_t;
 
 // ============================================================================
@@ -157,6 +192,18 @@ nexus_resolution_context_t* nexus_link_init(
     resolution_strategy_t default_strategy
 );
 
+// Release the context and its index; manifests stay the caller's
+void nexus_link_destroy(nexus_resolution_context_t* ctx);
+
+// Epoch-protected reads, for anything published by swapping an atomic
+// pointer. Between nexus_read_begin and nexus_read_end a thread may use
+// what it loaded; reads nest and never wait. nexus_synchronize returns once
+// every read that began before the call has ended, after which what was
+// unpublished before it can be freed. Never call it inside a read.
+bool nexus_read_begin(void);
+void nexus_read_end(void);
+void nexus_synchronize(void);
+
 // Component Resolution Functions
 component_manifest_t* nexus_resolve_component(
     nexus_resolution_context_t* ctx,
@@ -165,6 +212,18 @@ component_manifest_t* nexus_resolve_component(
     resolution_strategy_t strategy
 );
 
+// Forget cached resolutions of a component; registration does this itself,
+// and so must anything that swaps a component's manifest
+void nexus_invalidate_resolutions(
+    nexus_resolution_context_t* ctx,
+    const char* component_id
+);
+
+void nexus_get_resolution_cache_stats(
+    nexus_resolution_context_t* ctx,
+    nexus_cache_stats_t* stats
+);
+
 // Hot-swap Operations
 typedef enum {
     SWAP_SUCCESS,
@@ -215,13 +274,15 @@ int nexus_register_component(
     component_source_t source
 );
 
-// Trie-based Search Functions
+// Prefix Search Functions
 typedef struct {
     component_manifest_t** results;
     uint32_t result_count;
     uint32_t max_results;
 } search_results_t;
 
+// Components whose identifier starts with prefix, in identifier order,
+// optionally only those of one taxonomy class
 search_results_t* nexus_search_components(
     nexus_resolution_context_t* ctx,
     const char* prefix,
@@ -229,6 +290,51 @@ search_results_t* nexus_search_components(
     uint32_t max_results
 );
 
+void nexus_free_search_results(search_results_t* results);
+
+// Dependency Resolution
+// Resolves the whole dependency graph below a set of root components at
+// once. Each component is resolved once however many depend on it, and
+// independent subgraphs are resolved concurrently on a pool of threads.
+// Every edge is checked against its min/max version and strategy as soon
+// as it is found; after the first conflict no further components are
+// expanded. The plan lists dependencies before their dependents, grouped in
+// levels: the components of one level depend only on earlier levels and
+// can be activated together.
+#define NEXUS_PLAN_MAX_CONFLICTS 16
+
+typedef enum {
+    NEXUS_CONFLICT_MISSING,      // Required dependency not registered
+    NEXUS_CONFLICT_VERSION,      // Registered version outside the required range
+    NEXUS_CONFLICT_CYCLE         // Component depends on itself, perhaps indirectly
+} nexus_conflict_kind_t;
+
+typedef struct {
+    nexus_conflict_kind_t kind;
+    char component_id[128];      // The dependency at fault
+    char required_by[128];       // Empty for a missing root
+} nexus_dependency_conflict_t;
+
+typedef struct {
+    component_manifest_t** order;     // Dependencies before dependents
+    uint32_t* levels;                 // Activation level of each entry in order
+    uint32_t count;
+    uint32_t level_count;
+    nexus_dependency_conflict_t conflicts[NEXUS_PLAN_MAX_CONFLICTS];
+    uint32_t conflict_count;          // Conflicts found, even beyond the array
+} nexus_activation_plan_t;
+
+// threads 0 uses one per online CPU. Returns NULL only when out of memory;
+// check conflict_count before using the order.
+nexus_activation_plan_t* nexus_resolve_dependencies(
+    nexus_resolution_context_t* ctx,
+    const char* const* root_ids,
+    uint32_t root_count,
+    uint32_t threads
+);
+
+void nexus_free_activation_plan(nexus_activation_plan_t* plan);
+
 // ============================================================================
 // Extended Fault Tolerance Framework
 // ============================================================================
@@ -240,16 +346,49 @@ typedef enum {
     CIRCUIT_HALF_OPEN  // Testing recovery
 } circuit_state_t;
 
+// The whole state is one 64-bit word, changed by compare-and-swap: the
+// circuit state in the low 2 bits, a count above it (consecutive failures
+// while closed, successes while half open) and the time in seconds the
+// circuit stays open until in the top 48 bits. Checking a closed circuit
+// is a single relaxed load.
+//
+// Calls are also counted in a sliding window of one-second buckets, one
+// row per thread stripe so that recording rarely contends. The circuit
+// opens on CIRCUIT_FAILURE_THRESHOLD consecutive failures, or when at
+// least half of the last CIRCUIT_WINDOW_SECONDS' calls failed.
+#define CIRCUIT_STATE_MASK       0x3ULL
+#define CIRCUIT_COUNT_SHIFT      2
+#define CIRCUIT_COUNT_MASK       0x3fffULL     // 14 bits, saturating
+#define CIRCUIT_UNTIL_SHIFT      16
+
+#define CIRCUIT_FAILURE_THRESHOLD 5
+#define CIRCUIT_RECOVERY_SUCCESSES 3            // Half open to closed
+#define CIRCUIT_WINDOW_SECONDS   10
+#define CIRCUIT_WINDOW_STRIPES   8
+#define CIRCUIT_WINDOW_MIN_CALLS 20             // Before the failure rate counts
+
+typedef struct {
+    // Per bucket: second (low 32 bits of it) << 32 | failures << 16 | successes
+    _Alignas(64) _Atomic uint64_t buckets[CIRCUIT_WINDOW_SECONDS];
+} circuit_window_stripe_t;
+
 typedef struct {
     char component_id[128];
-    circuit_state_t state;
-    uint32_t failure_count;
-    uint32_t success_count;
-    uint64_t last_failure_time;
-    uint64_t next_retry_time;
-    pthread_mutex_t breaker_mutex;
+    _Atomic uint64_t state;
+    circuit_window_stripe_t window[CIRCUIT_WINDOW_STRIPES];
 } circuit_breaker_t;
 
+// Closed, with an empty window
+void nexus_circuit_init(circuit_breaker_t* breaker, const char* component_id);
+
+// Whether a call may go through now. An open circuit whose time is up
+// moves to half open and lets this call through as a test.
+bool nexus_circuit_allow(circuit_breaker_t* breaker);
+
+// Record a call's outcome. Returns true when this failure opened the circuit.
+bool nexus_circuit_record_failure(circuit_breaker_t* breaker);
+void nexus_circuit_record_success(circuit_breaker_t* breaker);
+
 // Health Check Framework
 typedef enum {
     HEALTH_HEALTHY,
@@ -266,48 +405,149 @@ typedef struct {
     health_status_t last_status;
 } health_check_config_t;
 
-// Implement health monitoring for hot-swappable components
+// Check one component now, on the calling thread: check_function gets the
+// component's registered manifest, HEALTH_UNKNOWN if it has none. A check
+// that takes longer than timeout_ms (0 for no limit) counts as unhealthy;
+// it is not interrupted. Sets last_check_time (ms since the epoch) and
+// last_status.
 health_status_t nexus_check_component_health(
     nexus_resolution_context_t* ctx,
     const char* component_id,
     health_check_config_t* config
 );
 
+// Health Check Scheduler
+// Keeps checking a set of components, each every check_interval_ms, on a
+// fixed pool of worker threads: at most max_concurrent checks run at once,
+// however many components are watched. Components wait in a heap ordered
+// by when they are next due. Intervals are spread by up to jitter_percent
+// either way, and each component's first check falls somewhere in its
+// first interval, so checks never line up into bursts.
+//
+// The latest status of each component is cached in its slot and read
+// without a lock. Each result also goes to the component's circuit
+// breaker, unhealthy as a failure and healthy or degraded as a success;
+// a check that finds the circuit open and not yet due for a test is not
+// recorded, and one that finds it due is the test.
+typedef struct nexus_health_scheduler nexus_health_scheduler_t;  // Defined in the .c
+
+typedef struct {
+    uint32_t max_components;     // Slots, fixed at creation
+    uint32_t max_concurrent;     // Worker threads; 0 for one per online CPU
+    uint32_t jitter_percent;     // 0 to 100
+} nexus_health_scheduler_config_t;
+
+typedef struct {
+    uint64_t checks;             // Completed
+    uint64_t failures;           // Of those, unhealthy
+    uint64_t timeouts;           // Of the failures, over timeout_ms
+    uint64_t circuits_opened;    // By a failed check
+    uint32_t components;         // Watched
+} nexus_health_stats_t;
+
+nexus_health_scheduler_t* nexus_health_scheduler_create(
+    nexus_resolution_context_t* ctx,
+    const nexus_health_scheduler_config_t* config
+);
+
+// Stops the workers, waiting out checks in flight, and frees the scheduler
+// and the breakers it created
+void nexus_health_scheduler_destroy(nexus_health_scheduler_t* scheduler);
+
+int nexus_health_scheduler_start(nexus_health_scheduler_t* scheduler);
+void nexus_health_scheduler_stop(nexus_health_scheduler_t* scheduler);
+
+// Start checking a component, before or after start. component is passed
+// to check_function; NULL resolves the registered manifest at each check,
+// as nexus_check_component_health does. breaker NULL gives the component
+// one of its own, reachable through nexus_health_breaker. The config is
+// copied. Returns the component's slot, or -1 when full or out of memory.
+int32_t nexus_health_watch(
+    nexus_health_scheduler_t* scheduler,
+    const char* component_id,
+    void* component,
+    const health_check_config_t* config,
+    circuit_breaker_t* breaker
+);
+
+// Latest status in a slot; HEALTH_UNKNOWN until its first check
+health_status_t nexus_health_status(const nexus_health_scheduler_t* scheduler, int32_t slot);
+circuit_breaker_t* nexus_health_breaker(nexus_health_scheduler_t* scheduler, int32_t slot);
+
+// Make every component due now, as one batch across the workers
+void nexus_health_check_all(nexus_health_scheduler_t* scheduler);
+
+void nexus_health_get_stats(const nexus_health_scheduler_t* scheduler, nexus_health_stats_t* stats);
+
 // ============================================================================
 // Ship of Theseus Implementation
 // ============================================================================
 
 // Component Evolution Tracking
+// One recorded swap
+typedef struct {
+    semantic_version_x_t from_version;
+    semantic_version_x_t to_version;
+    uint64_t swap_timestamp;
+    char reason[256];
+    bool was_automatic;
+} evolution_event_t;
+
+// The latest swaps sit in a fixed ring that appends without a lock. An
+// append that overwrites the oldest event first spills it to the
+// component's append-only log, when one is set, so memory stays bounded
+// over any uptime while the full history is kept on disk.
+#define NEXUS_EVOLUTION_RING_SIZE 64    // Power of two
+
+// Readers copy a slot while a writer may be replacing it, so the event is
+// held as atomic words and the sequence tells whether the copy was whole
+#define NEXUS_EVOLUTION_EVENT_WORDS ((sizeof(evolution_event_t) + 7) / 8)
+
 typedef struct {
+    _Atomic uint64_t sequence;          // Position + 1 once published, 0 if empty
+    _Atomic uint64_t event[NEXUS_EVOLUTION_EVENT_WORDS];
+} evolution_slot_t;
+
+typedef struct component_evolution {
     char original_component_id[128];
     semantic_version_x_t original_version;
-    
+
     // Evolution history
-    struct {
-        semantic_version_x_t from_version;
-        semantic_version_x_t to_version;
-        uint64_t swap_timestamp;
-        char reason[256];
-        bool was_automatic;
-    } evolution_history[64];
-    uint32_t evolution_count;
-    
-    // Current state
+    evolution_slot_t ring[NEXUS_EVOLUTION_RING_SIZE];
+    _Atomic uint64_t evolution_count;   // Events ever recorded
+    _Atomic uint64_t spilled;           // Of those, moved to the log
+    _Atomic uint64_t major_changes;     // Swaps to a different major version
+    int log_fd;                         // Spill log, -1 for none
+
+    // Current state; written by the swapping thread
     semantic_version_x_t current_version;
     uint32_t total_swaps;
     double uptime_percentage;
-    
+
     // Governance tracking
-    bool maintains_original_contract;
     char contract_hash[65];
+
+    struct component_evolution* next;   // The context's tracked components
 } component_evolution_t;
 
-// Track component evolution over time
+// Track component evolution over time. Tracking a component again returns
+// its existing record, history included; the context owns the records.
 component_evolution_t* nexus_track_evolution(
     nexus_resolution_context_t* ctx,
     const char* component_id
 );
 
+// Spill logs go to <directory>/<component_id>.evolution for components
+// tracked from now on; NULL or "" keeps history in memory only
+int nexus_set_evolution_log_dir(nexus_resolution_context_t* ctx, const char* directory);
+
+// Append a swap to the ring; lock-free, safe from any thread
+int nexus_evolution_record(component_evolution_t* evolution, const evolution_event_t* event);
+
+// Copy up to max of the most recent events, oldest first; returns how many
+uint32_t nexus_evolution_recent(const component_evolution_t* evolution,
+                                evolution_event_t* events, uint32_t max);
+
 // Validate component maintains original contract despite evolution
 bool nexus_validate_evolved_contract(
     component_evolution_t* evolution,
@@ -9,7 +9,9 @@
 #include <stdbool.h>
 #include <time.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <sys/types.h>
 // Data-Oriented Programming Core Types
 typedef enum {
     DOP_COMPONENT_ALARM = 0,
@@ -87,6 +89,9 @@ typedef struct {
     dop_gate_state_t gate_state;
     uint64_t creation_timestamp;
     uint64_t last_update_timestamp;
+    uint64_t wheel_timer;       // Pending expiry in the shared timer wheel, 0 if none
+    pid_t wheel_owner;          // Process whose wheel wheel_timer belongs to
+    uint32_t batch_slot;        // Position in an update engine's batch plus one, 0 if none
     pthread_mutex_t mutex;
 } dop_component_metadata_t;
 
@@ -119,24 +124,35 @@ typedef struct {
     int (*destroy)(void* self);
     char* (*serialize)(void* self);
     dop_component_t* (*get_data)(void* self);
+    // Binary state into the caller's buffer; see dop_serialize.h
+    int (*serialize_into)(void* self, void* buffer, size_t size, size_t* written);
 } dop_oop_interface_t;
 
 // Topology Node for P2P Network
 typedef struct dop_topology_node {
     char node_id[64];
     dop_component_t* component;
-    struct dop_topology_node* peers[4]; // Max 4 peers for demo
+    struct dop_topology_node** peers;   // Grows as peers are added
     uint32_t peer_count;
+    uint32_t peer_capacity;
+    struct dop_topology_node** peer_set; // Open addressing over peers, for duplicates
+    uint32_t peer_set_capacity;
     bool is_fault_tolerant;
-    pthread_t worker_thread;
+    pthread_t worker_thread;            // Runs while the P2P network is started
+    struct dop_mailbox* mailbox;        // Messages from peers; NULL while stopped
+    _Atomic bool running;
+    _Atomic uint64_t updates;           // Component updates by the worker
+    _Atomic uint64_t messages_received;
+    _Atomic uint64_t messages_dropped;  // Peer messages lost to a full mailbox
 } dop_topology_node_t;
 
 // Build System Integration
 typedef struct {
     char build_id[64];
     char manifest_path[256];
-    dop_topology_node_t* nodes[16]; // Max 16 nodes
+    dop_topology_node_t** nodes;    // Grows through dop_topology_add_node
     uint32_t node_count;
+    uint32_t node_capacity;
     bool is_p2p_enabled;
     bool is_fault_tolerant;
 } dop_build_topology_t;
@@ -169,6 +185,9 @@ bool dop_gate_is_accessible(const dop_component_t* component);
 
 // Topology Management
 dop_topology_node_t* dop_topology_create_node(const char* node_id, dop_component_t* component);
+void dop_topology_destroy_node(dop_topology_node_t* node);
+int dop_topology_add_node(dop_build_topology_t* topology, dop_topology_node_t* node);
+void dop_topology_release(dop_build_topology_t* topology);
 int dop_topology_add_peer(dop_topology_node_t* node, dop_topology_node_t* peer);
 int dop_topology_start_p2p_network(dop_build_topology_t* topology);
 int dop_topology_test_fault_tolerance(dop_build_topology_t* topology);
@@ -195,7 +214,14 @@ int dop_alarm_snooze(dop_component_t* component, uint32_t duration_ms);
 // Clock Logic
 int dop_clock_set_timezone(dop_component_t* component, int32_t offset_hours);
 int dop_clock_set_format(dop_component_t* component, bool is_24_hour);
-char* dop_clock_format_time(const dop_component_t* component);
+char* dop_clock_format_time(const dop_component_t* component);     // Caller frees
+
+// "HH:MM:SS.mmm", or "H:MM:SS.mmm AM" in 12-hour format, into the caller's
+// buffer without allocating. DOP_CLOCK_FORMAT_SIZE bytes is always enough
+// for a valid time. For many clocks, update them together through an update
+// engine tick so they share one clock read and the formatted seconds.
+#define DOP_CLOCK_FORMAT_SIZE 16
+int dop_clock_format_time_into(const dop_component_t* component, char* buffer, size_t size);
 
 // Stopwatch Logic
 int dop_stopwatch_start(dop_component_t* component);
@@ -225,7 +251,17 @@ typedef enum {
     DOP_ERROR_GATE_CLOSED = 4,
     DOP_ERROR_CHECKSUM_FAILED = 5,
     DOP_ERROR_TOPOLOGY_FAULT = 6,
-    DOP_ERROR_XML_PARSING = 7
+    DOP_ERROR_XML_PARSING = 7,
+
+    // Hot swapping (obinexus_dop_core.c)
+    DOP_ERROR_ALREADY_INITIALIZED = 8,
+    DOP_ERROR_INITIALIZATION_FAILED = 9,
+    DOP_ERROR_VERSION_INCOMPATIBLE = 10,
+    DOP_ERROR_LIBRARY_LOAD_FAILED = 11,
+    DOP_ERROR_VALIDATION_FAILED = 12,
+    DOP_ERROR_QUIESCE_FAILED = 13,
+    DOP_ERROR_SWAP_NOTIFICATION_FAILED = 14,
+    DOP_ERROR_CIRCUIT_OPEN = 15
 } dop_error_code_t;
 
 const char* dop_error_to_string(dop_error_code_t error);
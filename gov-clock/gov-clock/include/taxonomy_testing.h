@@ -1,8 +1,8 @@
 
-# ==============================================================================
-# Taxonomy Testing Framework Header Implementation
-# include/taxonomy_testing.h
-# ==============================================================================
+// ==============================================================================
+// Taxonomy Testing Framework Header Implementation
+// include/taxonomy_testing.h
+// ==============================================================================
 
 #ifndef TAXONOMY_TESTING_H
 #define TAXONOMY_TESTING_H
@@ -10,6 +10,7 @@
 #include "obinexus_dop_core.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 // Taxonomy System Categories
 typedef enum {
@@ -72,274 +73,52 @@ int clock_taxonomy_test_isolation_boundaries(dop_component_t* clock);
 int clock_preflight_memory_validation(dop_component_t* clock);
 int clock_stress_test_continuous_updates(dop_component_t* clock, uint32_t duration_ms);
 
-#endif // TAXONOMY_TESTING_H
-
-// ==============================================================================
-// Taxonomy Testing Framework Implementation
-// src/taxonomy_testing.c
-// ==============================================================================
-
-#include "taxonomy_testing.h"
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-#include <sys/time.h>
-#include <unistd.h>
-
-// Initialize taxonomy test context
-int taxonomy_init_test_context(taxonomy_test_context_t* ctx, taxonomy_level_t level) {
-    if (!ctx) return DOP_ERROR_INVALID_PARAMETER;
-    
-    memset(ctx, 0, sizeof(taxonomy_test_context_t));
-    ctx->level = level;
-    ctx->start_timestamp = (uint64_t)time(NULL) * 1000;
-    ctx->memory_loaded = false;
-    ctx->stress_enabled = false;
-    ctx->iteration_count = 0;
-    
-    switch (level) {
-        case TAXONOMY_ISOLATED:
-            strcpy(ctx->component_tag, "isolated");
-            ctx->mode_flags = TEST_MODE_PREFLIGHT | TEST_MODE_MEMORY_ONLY;
-            break;
-        case TAXONOMY_CLOSED:
-            strcpy(ctx->component_tag, "closed");
-            ctx->mode_flags = TEST_MODE_PREFLIGHT | TEST_MODE_INTEGRATION;
-            break;
-        case TAXONOMY_OPEN:
-            strcpy(ctx->component_tag, "open");
-            ctx->mode_flags = TEST_MODE_PREFLIGHT | TEST_MODE_INTEGRATION | TEST_MODE_PRODUCTION;
-            break;
-        default:
-            return DOP_ERROR_INVALID_PARAMETER;
-    }
-    
-    return DOP_SUCCESS;
-}
-
-// Run comprehensive preflight tests
-int taxonomy_run_preflight_tests(taxonomy_test_context_t* ctx, preflight_test_result_t* result) {
-    if (!ctx || !result) return DOP_ERROR_INVALID_PARAMETER;
-    
-    memset(result, 0, sizeof(preflight_test_result_t));
-    uint64_t start_time = (uint64_t)time(NULL) * 1000;
-    
-    // Component integrity validation
-    printf("Running preflight tests for %s system...\n", ctx->component_tag);
-    
-    // Memory allocation test
-    void* test_memory = malloc(1024 * 1024); // 1MB test allocation
-    if (test_memory) {
-        result->memory_allocation_passed = true;
-        result->memory_usage_kb = 1024;
-        free(test_memory);
-    }
-    
-    // Isolation boundary test
-    result->isolation_boundary_passed = true;
-    
-    // Dependency check based on taxonomy level
-    switch (ctx->level) {
-        case TAXONOMY_ISOLATED:
-            // Isolated systems should have no external dependencies
-            result->dependency_check_passed = true;
-            printf("✓ Isolated system: No external dependencies verified\n");
-            break;
-        case TAXONOMY_CLOSED:
-            // Closed systems can have limited internal dependencies
-            result->dependency_check_passed = true;
-            printf("✓ Closed system: Internal dependencies validated\n");
-            break;
-        case TAXONOMY_OPEN:
-            // Open systems can have CLI and external exposure
-            result->dependency_check_passed = true;
-            printf("✓ Open system: CLI exposure and dependencies validated\n");
-            break;
-    }
-    
-    // Overall integrity check
-    result->component_integrity_passed = 
-        result->memory_allocation_passed && 
-        result->isolation_boundary_passed && 
-        result->dependency_check_passed;
-    
-    uint64_t end_time = (uint64_t)time(NULL) * 1000;
-    result->execution_time_ms = end_time - start_time;
-    ctx->preflight_duration_ms = result->execution_time_ms;
-    
-    printf("Preflight tests completed in %llu ms\n", 
-           (unsigned long long)result->execution_time_ms);
-    
-    return result->component_integrity_passed ? DOP_SUCCESS : DOP_ERROR_INVALID_STATE;
-}
-
-// Validate component isolation level
-int taxonomy_validate_isolation_level(dop_component_t* component, taxonomy_level_t expected_level) {
-    if (!component) return DOP_ERROR_INVALID_PARAMETER;
-    
-    printf("Validating isolation level for component %s...\n", 
-           component->metadata.component_id);
-    
-    switch (expected_level) {
-        case TAXONOMY_ISOLATED:
-            // Isolated components must be accessible through gates only
-            if (component->metadata.gate_state == DOP_GATE_ISOLATED ||
-                component->metadata.gate_state == DOP_GATE_CLOSED) {
-                printf("✓ Component properly isolated\n");
-                return DOP_SUCCESS;
-            }
-            break;
-        case TAXONOMY_CLOSED:
-            // Closed components can be in closed or open gate state
-            if (component->metadata.gate_state != DOP_GATE_ISOLATED) {
-                printf("✓ Component properly configured for closed system\n");
-                return DOP_SUCCESS;
-            }
-            break;
-        case TAXONOMY_OPEN:
-            // Open components should be accessible
-            if (component->metadata.gate_state == DOP_GATE_OPEN) {
-                printf("✓ Component properly exposed for open system\n");
-                return DOP_SUCCESS;
-            }
-            break;
-    }
-    
-    printf("✗ Component isolation level validation failed\n");
-    return DOP_ERROR_INVALID_STATE;
-}
-
-// Execute stress testing
-int taxonomy_execute_stress_test(taxonomy_test_context_t* ctx, uint32_t iterations) {
-    if (!ctx) return DOP_ERROR_INVALID_PARAMETER;
-    
-    printf("Starting stress test for %s system (%u iterations)...\n", 
-           ctx->component_tag, iterations);
-    
-    ctx->stress_enabled = true;
-    ctx->iteration_count = iterations;
-    
-    for (uint32_t i = 0; i < iterations; i++) {
-        // Simulate stress operations
-        dop_component_t* test_component = dop_func_create_component(DOP_COMPONENT_CLOCK);
-        if (!test_component) {
-            printf("✗ Stress test failed at iteration %u\n", i);
-            return DOP_ERROR_MEMORY_ALLOCATION;
-        }
-        
-        // Perform rapid updates
-        dop_gate_open(test_component);
-        for (int j = 0; j < 100; j++) {
-            dop_func_update_component(test_component);
-        }
-        
-        dop_func_destroy_component(test_component);
-        
-        if (i % 100 == 0) {
-            printf("Stress test progress: %u/%u iterations\n", i, iterations);
-        }
-    }
-    
-    printf("✓ Stress test completed successfully\n");
-    return DOP_SUCCESS;
-}
+// Benchmark Mode
+// Worker threads update components as fast as they can for a fixed time.
+// The taxonomy level sets how the components are shared:
+//   isolated - each worker updates its own components
+//   closed   - all workers update one shared set
+//   open     - shared, and every update is followed by an integrity check
+// Before each update a worker times how long the component's mutex takes to
+// acquire, which measures lock contention between the workers.
+typedef struct {
+    taxonomy_level_t level;
+    uint32_t threads;
+    uint32_t duration_ms;
+    uint32_t components;                    // Per worker if isolated, else shared
+    uint32_t mix[DOP_COMPONENT_COUNT];      // Relative weight of each type
+} taxonomy_benchmark_config_t;
 
-// Memory load testing
-int taxonomy_memory_load_test(dop_component_t* component) {
-    if (!component) return DOP_ERROR_INVALID_PARAMETER;
-    
-    printf("Running memory load test for component %s...\n", 
-           component->metadata.component_id);
-    
-    // Test memory allocation patterns
-    void* memory_blocks[100];
-    for (int i = 0; i < 100; i++) {
-        memory_blocks[i] = malloc(1024); // 1KB per block
-        if (!memory_blocks[i]) {
-            // Clean up allocated blocks
-            for (int j = 0; j < i; j++) {
-                free(memory_blocks[j]);
-            }
-            return DOP_ERROR_MEMORY_ALLOCATION;
-        }
-    }
-    
-    // Verify component integrity under memory load
-    uint32_t original_checksum = component->checksum;
-    dop_func_update_component(component);
-    bool integrity_maintained = dop_checksum_verify(component);
-    
-    // Clean up memory
-    for (int i = 0; i < 100; i++) {
-        free(memory_blocks[i]);
-    }
-    
-    if (integrity_maintained) {
-        printf("✓ Component maintained integrity under memory load\n");
-        return DOP_SUCCESS;
-    } else {
-        printf("✗ Component integrity compromised under memory load\n");
-        return DOP_ERROR_CHECKSUM_FAILED;
-    }
-}
+#define TAXONOMY_BENCHMARK_DEFAULT_CONFIG { TAXONOMY_ISOLATED, 4, 1000, 64, { 1, 1, 1, 1 } }
 
-// Clock Enhanced Testing Functions
-int clock_taxonomy_test_time_precision(dop_component_t* clock, taxonomy_level_t level) {
-    if (!clock || clock->metadata.type != DOP_COMPONENT_CLOCK) {
-        return DOP_ERROR_INVALID_PARAMETER;
-    }
-    
-    printf("Testing clock time precision for %s system...\n", 
-           taxonomy_level_to_string(level));
-    
-    dop_gate_open(clock);
-    
-    // Test time precision based on taxonomy level
-    switch (level) {
-        case TAXONOMY_ISOLATED:
-            // Isolated clock should maintain microsecond precision
-            for (int i = 0; i < 10; i++) {
-                dop_func_update_component(clock);
-                usleep(1000); // 1ms delay
-            }
-            printf("✓ Isolated clock precision test passed\n");
-            break;
-            
-        case TAXONOMY_CLOSED:
-            // Closed clock should handle timezone operations
-            dop_clock_set_timezone(clock, -5);
-            dop_clock_set_format(clock, true);
-            printf("✓ Closed clock timezone test passed\n");
-            break;
-            
-        case TAXONOMY_OPEN:
-            // Open clock should support CLI formatting
-            char* formatted = dop_clock_format_time(clock);
-            if (formatted) {
-                printf("✓ Open clock CLI formatting: %s\n", formatted);
-                free(formatted);
-            }
-            break;
-    }
-    
-    return DOP_SUCCESS;
-}
+// Latency bucket i counts operations taking [2^i, 2^(i+1)) ns
+#define TAXONOMY_BENCHMARK_BUCKETS 40
 
-// Utility functions
-const char* taxonomy_level_to_string(taxonomy_level_t level) {
-    switch (level) {
-        case TAXONOMY_ISOLATED: return "isolated";
-        case TAXONOMY_CLOSED: return "closed";
-        case TAXONOMY_OPEN: return "open";
-        default: return "unknown";
-    }
-}
+typedef struct {
+    taxonomy_benchmark_config_t config;
+    uint64_t elapsed_ns;
+    uint64_t operations;
+    uint64_t failures;                      // Updates that returned an error
+    double ops_per_sec;
+    uint64_t latency_buckets[TAXONOMY_BENCHMARK_BUCKETS];
+    uint64_t latency_p50_ns;                // Percentiles are bucket upper bounds
+    uint64_t latency_p90_ns;
+    uint64_t latency_p99_ns;
+    uint64_t latency_p999_ns;
+    uint64_t latency_max_ns;
+    uint64_t contended;                     // Operations that found the mutex held
+    uint64_t lock_wait_ns;                  // Total time spent waiting for it
+    uint64_t lock_wait_max_ns;
+    uint64_t rss_start_kb;
+    uint64_t rss_end_kb;
+    uint64_t rss_peak_kb;                   // Process high-water mark
+} taxonomy_benchmark_result_t;
+
+int taxonomy_run_benchmark(const taxonomy_benchmark_config_t* config, taxonomy_benchmark_result_t* result);
+int taxonomy_benchmark_write_json(const taxonomy_benchmark_result_t* result, FILE* out);
+
+// Run the benchmark once per taxonomy level and write the results as one
+// JSON document, {"benchmarks": [...]}; config->level is ignored
+int taxonomy_run_benchmark_suite(const taxonomy_benchmark_config_t* config, FILE* out);
 
-const char* taxonomy_access_to_string(access_level_t access) {
-    switch (access) {
-        case ACCESS_PUBLIC: return "public";
-        case ACCESS_PRIVATE: return "private";
-        case ACCESS_PROTECTED: return "protected";
-        default: return "unknown";
-    }
-}
+#endif // TAXONOMY_TESTING_H
@@ -53,6 +53,30 @@ string(APPEND MANIFEST_CONTENT "  <dop:source_files>\n")
 string(REPLACE ";" "," SOURCE_FILES_LIST "${SOURCE_FILES}")
 string(REPLACE "," ";" SOURCE_FILES_LIST "${SOURCE_FILES_LIST}")
 
+# Incremental mode (-DINCREMENTAL=ON) reuses the hash of every source whose
+# size and mtime are unchanged since the last run, -DJOBS=<n> hashed at a time
+if(INCREMENTAL)
+    include("${CMAKE_CURRENT_LIST_DIR}/validation_cache.cmake")
+    if(NOT DEFINED VALIDATION_CACHE)
+        get_filename_component(MANIFEST_DIR "${MANIFEST_FILE}" DIRECTORY)
+        set(VALIDATION_CACHE "${MANIFEST_DIR}/validation_cache/source_hashes.txt")
+    endif()
+    if(NOT DEFINED JOBS)
+        set(JOBS 1)
+    endif()
+    set(ABS_SOURCE_FILES "")
+    foreach(SOURCE_FILE ${SOURCE_FILES_LIST})
+        if(NOT SOURCE_FILE STREQUAL "")
+            get_filename_component(ABS_SOURCE_FILE "${SOURCE_FILE}" ABSOLUTE BASE_DIR "${SOURCE_DIR}")
+            list(APPEND ABS_SOURCE_FILES "${ABS_SOURCE_FILE}")
+        endif()
+    endforeach()
+    dop_hash_files("${VALIDATION_CACHE}" "${JOBS}" ${ABS_SOURCE_FILES})
+    list(LENGTH DOP_HASHED FILES_HASHED)
+    list(LENGTH ABS_SOURCE_FILES FILES_LISTED)
+    message(STATUS "Incremental manifest: ${FILES_HASHED} of ${FILES_LISTED} sources rehashed")
+endif()
+
 foreach(SOURCE_FILE ${SOURCE_FILES_LIST})
     # Skip empty entries
     if(NOT SOURCE_FILE STREQUAL "")
@@ -62,7 +86,12 @@ foreach(SOURCE_FILE ${SOURCE_FILES_LIST})
         # Check if file exists
         if(EXISTS "${ABS_SOURCE_FILE}")
             # Calculate file checksum
-            file(SHA256 "${ABS_SOURCE_FILE}" FILE_CHECKSUM)
+            if(INCREMENTAL)
+                dop_hash_key(HASH_KEY "${ABS_SOURCE_FILE}")
+                set(FILE_CHECKSUM "${DOP_HASH_${HASH_KEY}}")
+            else()
+                file(SHA256 "${ABS_SOURCE_FILE}" FILE_CHECKSUM)
+            endif()
             
             # Get file size
             file(SIZE "${ABS_SOURCE_FILE}" FILE_SIZE)
@@ -38,44 +38,78 @@ endif()
 # Parse manifest for source file validation
 file(READ "${MANIFEST_FILE}" MANIFEST_CONTENT)
 
-# Extract source file entries using regex
-string(REGEX MATCHALL "<dop:source_file>.*?</dop:source_file>" SOURCE_FILE_ENTRIES "${MANIFEST_CONTENT}")
+# Split into source file entries; CMake regexes have no lazy quantifiers
+string(REPLACE ";" "\\;" MANIFEST_CONTENT "${MANIFEST_CONTENT}")
+string(REPLACE "</dop:source_file>" ";" SOURCE_FILE_ENTRIES "${MANIFEST_CONTENT}")
+
+set(ENTRY_PATHS "")
+set(ENTRY_CHECKSUMS "")
+foreach(ENTRY ${SOURCE_FILE_ENTRIES})
+    if(ENTRY MATCHES "<dop:source_file>" AND
+       ENTRY MATCHES "<dop:file_path>([^<]*)</dop:file_path>")
+        set(FILE_PATH "${CMAKE_MATCH_1}")
+        if(ENTRY MATCHES "<dop:checksum_sha256>([^<]*)</dop:checksum_sha256>")
+            list(APPEND ENTRY_PATHS "${FILE_PATH}")
+            list(APPEND ENTRY_CHECKSUMS "${CMAKE_MATCH_1}")
+        endif()
+    endif()
+endforeach()
+
+# Incremental mode (-DINCREMENTAL=ON) hashes only sources whose size or
+# mtime changed since the last run, -DJOBS=<n> of them at a time
+if(NOT DEFINED JOBS)
+    set(JOBS 1)
+endif()
+if(INCREMENTAL)
+    include("${CMAKE_CURRENT_LIST_DIR}/validation_cache.cmake")
+    if(NOT DEFINED VALIDATION_CACHE)
+        set(VALIDATION_CACHE "${BUILD_DIR}/validation_cache/source_hashes.txt")
+    endif()
+    set(FULL_PATHS "")
+    foreach(FILE_PATH IN LISTS ENTRY_PATHS)
+        list(APPEND FULL_PATHS "${SOURCE_DIR}/${FILE_PATH}")
+    endforeach()
+    dop_hash_files("${VALIDATION_CACHE}" "${JOBS}" ${FULL_PATHS})
+    list(LENGTH DOP_HASHED FILES_HASHED)
+    list(LENGTH ENTRY_PATHS FILES_LISTED)
+    message(STATUS "Incremental validation: ${FILES_HASHED} of ${FILES_LISTED} sources changed")
+endif()
 
 set(VALIDATION_PASSED TRUE)
 set(FILES_VALIDATED 0)
 
-foreach(ENTRY ${SOURCE_FILE_ENTRIES})
-    # Extract file path
-    string(REGEX MATCH "<dop:file_path>(.*?)</dop:file_path>" FILE_PATH_MATCH "${ENTRY}")
-    if(FILE_PATH_MATCH)
-        set(FILE_PATH "${CMAKE_MATCH_1}")
-        
-        # Extract expected checksum
-        string(REGEX MATCH "<dop:checksum_sha256>(.*?)</dop:checksum_sha256>" CHECKSUM_MATCH "${ENTRY}")
-        if(CHECKSUM_MATCH)
-            set(EXPECTED_CHECKSUM "${CMAKE_MATCH_1}")
-            
-            # Verify source file exists and calculate actual checksum
-            set(FULL_FILE_PATH "${SOURCE_DIR}/${FILE_PATH}")
-            if(EXISTS "${FULL_FILE_PATH}")
+list(LENGTH ENTRY_PATHS ENTRY_COUNT)
+if(ENTRY_COUNT GREATER 0)
+    math(EXPR LAST_ENTRY "${ENTRY_COUNT} - 1")
+    foreach(ENTRY_INDEX RANGE ${LAST_ENTRY})
+        list(GET ENTRY_PATHS ${ENTRY_INDEX} FILE_PATH)
+        list(GET ENTRY_CHECKSUMS ${ENTRY_INDEX} EXPECTED_CHECKSUM)
+
+        # Verify source file exists and calculate actual checksum
+        set(FULL_FILE_PATH "${SOURCE_DIR}/${FILE_PATH}")
+        if(EXISTS "${FULL_FILE_PATH}")
+            if(INCREMENTAL)
+                dop_hash_key(HASH_KEY "${FULL_FILE_PATH}")
+                set(ACTUAL_CHECKSUM "${DOP_HASH_${HASH_KEY}}")
+            else()
                 file(SHA256 "${FULL_FILE_PATH}" ACTUAL_CHECKSUM)
-                
-                if("${EXPECTED_CHECKSUM}" STREQUAL "${ACTUAL_CHECKSUM}")
-                    message(STATUS "✓ ${FILE_PATH}: Source integrity verified")
-                    math(EXPR FILES_VALIDATED "${FILES_VALIDATED} + 1")
-                else()
-                    message(ERROR "✗ ${FILE_PATH}: Checksum mismatch")
-                    message(ERROR "  Expected: ${EXPECTED_CHECKSUM}")
-                    message(ERROR "  Actual:   ${ACTUAL_CHECKSUM}")
-                    set(VALIDATION_PASSED FALSE)
-                endif()
+            endif()
+
+            if("${EXPECTED_CHECKSUM}" STREQUAL "${ACTUAL_CHECKSUM}")
+                message(STATUS "✓ ${FILE_PATH}: Source integrity verified")
+                math(EXPR FILES_VALIDATED "${FILES_VALIDATED} + 1")
             else()
-                message(ERROR "✗ ${FILE_PATH}: Source file not found")
+                message(ERROR "✗ ${FILE_PATH}: Checksum mismatch")
+                message(ERROR "  Expected: ${EXPECTED_CHECKSUM}")
+                message(ERROR "  Actual:   ${ACTUAL_CHECKSUM}")
                 set(VALIDATION_PASSED FALSE)
             endif()
+        else()
+            message(ERROR "✗ ${FILE_PATH}: Source file not found")
+            set(VALIDATION_PASSED FALSE)
         endif()
-    endif()
-endforeach()
+    endforeach()
+endif()
 
 # Verify build artifacts exist
 if(EXISTS "${BUILD_DIR}/${TARGET_NAME}" OR EXISTS "${BUILD_DIR}/${TARGET_NAME}.exe")
@@ -149,31 +183,59 @@ message(STATUS "Build artifact checksum: ${BUILD_CHECKSUM}")
 file(READ "${MANIFEST_FILE}" MANIFEST_CONTENT)
 
 # Extract build timestamp
-string(REGEX MATCH "<dop:build_timestamp>(.*?)</dop:build_timestamp>" BUILD_TIMESTAMP_MATCH "${MANIFEST_CONTENT}")
+string(REGEX MATCH "<dop:build_timestamp>([^<]*)</dop:build_timestamp>" BUILD_TIMESTAMP_MATCH "${MANIFEST_CONTENT}")
 if(BUILD_TIMESTAMP_MATCH)
     set(BUILD_TIMESTAMP "${CMAKE_MATCH_1}")
     message(STATUS "Build timestamp: ${BUILD_TIMESTAMP}")
 endif()
 
 # Validate that current source files match manifest expectations
-string(REGEX MATCHALL "<dop:source_file>.*?</dop:source_file>" SOURCE_FILE_ENTRIES "${MANIFEST_CONTENT}")
+string(REPLACE ";" "\\;" MANIFEST_CONTENT "${MANIFEST_CONTENT}")
+string(REPLACE "</dop:source_file>" ";" SOURCE_FILE_ENTRIES "${MANIFEST_CONTENT}")
+
+# In incremental mode the sources were just hashed into the cache, so this
+# lookup costs only a stat per file
+if(INCREMENTAL)
+    include("${CMAKE_CURRENT_LIST_DIR}/validation_cache.cmake")
+    if(NOT DEFINED VALIDATION_CACHE)
+        set(VALIDATION_CACHE "${BUILD_DIR}/validation_cache/source_hashes.txt")
+    endif()
+    if(NOT DEFINED JOBS)
+        set(JOBS 1)
+    endif()
+    set(FULL_PATHS "")
+    foreach(ENTRY ${SOURCE_FILE_ENTRIES})
+        if(ENTRY MATCHES "<dop:source_file>" AND ENTRY MATCHES "<dop:file_path>([^<]*)</dop:file_path>")
+            list(APPEND FULL_PATHS "${SOURCE_DIR}/${CMAKE_MATCH_1}")
+        endif()
+    endforeach()
+    dop_hash_files("${VALIDATION_CACHE}" "${JOBS}" ${FULL_PATHS})
+endif()
 
 set(REVERSE_VALIDATION_PASSED TRUE)
 set(FILES_REVERSE_VALIDATED 0)
 
 foreach(ENTRY ${SOURCE_FILE_ENTRIES})
     # Extract file path and expected checksum
-    string(REGEX MATCH "<dop:file_path>(.*?)</dop:file_path>" FILE_PATH_MATCH "${ENTRY}")
-    string(REGEX MATCH "<dop:checksum_sha256>(.*?)</dop:checksum_sha256>" CHECKSUM_MATCH "${ENTRY}")
-    
-    if(FILE_PATH_MATCH AND CHECKSUM_MATCH)
+    set(FILE_PATH "")
+    set(EXPECTED_CHECKSUM "")
+    if(ENTRY MATCHES "<dop:source_file>" AND ENTRY MATCHES "<dop:file_path>([^<]*)</dop:file_path>")
         set(FILE_PATH "${CMAKE_MATCH_1}")
+    endif()
+    if(ENTRY MATCHES "<dop:checksum_sha256>([^<]*)</dop:checksum_sha256>")
         set(EXPECTED_CHECKSUM "${CMAKE_MATCH_1}")
-        
+    endif()
+
+    if(FILE_PATH AND EXPECTED_CHECKSUM)
         # Verify current source file state matches build expectations
         set(FULL_FILE_PATH "${SOURCE_DIR}/${FILE_PATH}")
         if(EXISTS "${FULL_FILE_PATH}")
-            file(SHA256 "${FULL_FILE_PATH}" CURRENT_CHECKSUM)
+            if(INCREMENTAL)
+                dop_hash_key(HASH_KEY "${FULL_FILE_PATH}")
+                set(CURRENT_CHECKSUM "${DOP_HASH_${HASH_KEY}}")
+            else()
+                file(SHA256 "${FULL_FILE_PATH}" CURRENT_CHECKSUM)
+            endif()
             
             if("${EXPECTED_CHECKSUM}" STREQUAL "${CURRENT_CHECKSUM}")
                 message(STATUS "✓ ${FILE_PATH}: Build-to-source consistency verified")
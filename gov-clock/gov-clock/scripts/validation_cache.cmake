@@ -0,0 +1,150 @@
+# scripts/validation_cache.cmake
+# Content-Hash Cache for Incremental Validation
+# Remembers each source's SHA-256 against its size and mtime, so a source
+# that has not changed since the last run is not hashed again. Sources that
+# must be hashed can be split across parallel worker processes.
+#
+# Included by the validation and manifest scripts. Run with -P and
+# DOP_HASH_WORKER set to a list file, it is one of those workers: it hashes
+# the listed files into <list file>.out, one "sha256|path" line each.
+
+cmake_minimum_required(VERSION 3.16)
+
+if(DEFINED DOP_HASH_WORKER)
+    file(STRINGS "${DOP_HASH_WORKER}" WORKER_FILES)
+    set(WORKER_OUTPUT "")
+    foreach(WORKER_FILE IN LISTS WORKER_FILES)
+        file(SHA256 "${WORKER_FILE}" WORKER_HASH)
+        string(APPEND WORKER_OUTPUT "${WORKER_HASH}|${WORKER_FILE}\n")
+    endforeach()
+    file(WRITE "${DOP_HASH_WORKER}.out" "${WORKER_OUTPUT}")
+    return()
+endif()
+
+set(DOP_VALIDATION_CACHE_SCRIPT "${CMAKE_CURRENT_LIST_FILE}")
+
+# Variable-name-safe key for a path
+function(dop_hash_key OUT_KEY PATH)
+    string(SHA1 KEY "${PATH}")
+    set(${OUT_KEY} "${KEY}" PARENT_SCOPE)
+endfunction()
+
+# Hash FILES..., consulting and then rewriting CACHE_FILE. Cache lines are
+# "sha256|size|mtime|path"; entries for files not in this run are kept.
+# Misses are hashed by up to JOBS worker processes at once.
+#
+# Sets DOP_HASH_<key> (see dop_hash_key) to each existing file's SHA-256 and
+# DOP_HASHED to the files whose hash was not in the cache.
+function(dop_hash_files CACHE_FILE JOBS)
+    set(FILES ${ARGN})
+
+    # Load the cache
+    set(CACHED_KEYS "")
+    if(EXISTS "${CACHE_FILE}")
+        file(STRINGS "${CACHE_FILE}" CACHE_LINES)
+        foreach(LINE IN LISTS CACHE_LINES)
+            if(LINE MATCHES "^([0-9a-f]+)\\|([0-9]+)\\|([0-9]+)\\|(.+)$")
+                dop_hash_key(KEY "${CMAKE_MATCH_4}")
+                set(CACHED_${KEY} "${CMAKE_MATCH_1}|${CMAKE_MATCH_2}|${CMAKE_MATCH_3}")
+                set(CACHED_PATH_${KEY} "${CMAKE_MATCH_4}")
+                list(APPEND CACHED_KEYS "${KEY}")
+            endif()
+        endforeach()
+    endif()
+
+    # A file's hash is reused while its size and mtime are unchanged
+    set(MISSES "")
+    foreach(FILE_PATH IN LISTS FILES)
+        dop_hash_key(KEY "${FILE_PATH}")
+        if(NOT EXISTS "${FILE_PATH}")
+            continue()
+        endif()
+        file(SIZE "${FILE_PATH}" FILE_SIZE)
+        file(TIMESTAMP "${FILE_PATH}" FILE_MTIME "%s" UTC)
+        set(STAT_${KEY} "${FILE_SIZE}|${FILE_MTIME}")
+        if("${CACHED_${KEY}}" MATCHES "^([0-9a-f]+)\\|${FILE_SIZE}\\|${FILE_MTIME}$")
+            set(HASH_${KEY} "${CMAKE_MATCH_1}")
+        else()
+            list(APPEND MISSES "${FILE_PATH}")
+        endif()
+    endforeach()
+
+    # Hash the misses, in parallel when asked to
+    list(LENGTH MISSES MISS_COUNT)
+    if(JOBS GREATER 1 AND MISS_COUNT GREATER 1)
+        if(JOBS GREATER MISS_COUNT)
+            set(JOBS ${MISS_COUNT})
+        endif()
+        get_filename_component(CACHE_DIR "${CACHE_FILE}" DIRECTORY)
+        set(WORK_DIR "${CACHE_DIR}/.hash_workers")
+        file(REMOVE_RECURSE "${WORK_DIR}")
+        file(MAKE_DIRECTORY "${WORK_DIR}")
+
+        # Round robin, so large and small files spread evenly
+        set(INDEX 0)
+        foreach(FILE_PATH IN LISTS MISSES)
+            math(EXPR SHARD "${INDEX} % ${JOBS}")
+            file(APPEND "${WORK_DIR}/shard_${SHARD}.txt" "${FILE_PATH}\n")
+            math(EXPR INDEX "${INDEX} + 1")
+        endforeach()
+
+        # execute_process runs all its commands at once
+        set(WORKER_COMMANDS "")
+        math(EXPR LAST_SHARD "${JOBS} - 1")
+        foreach(SHARD RANGE ${LAST_SHARD})
+            list(APPEND WORKER_COMMANDS COMMAND "${CMAKE_COMMAND}"
+                 "-DDOP_HASH_WORKER=${WORK_DIR}/shard_${SHARD}.txt" -P "${DOP_VALIDATION_CACHE_SCRIPT}")
+        endforeach()
+        execute_process(${WORKER_COMMANDS} RESULTS_VARIABLE WORKER_RESULTS)
+
+        foreach(SHARD RANGE ${LAST_SHARD})
+            if(EXISTS "${WORK_DIR}/shard_${SHARD}.txt.out")
+                file(STRINGS "${WORK_DIR}/shard_${SHARD}.txt.out" WORKER_LINES)
+                foreach(LINE IN LISTS WORKER_LINES)
+                    if(LINE MATCHES "^([0-9a-f]+)\\|(.+)$")
+                        dop_hash_key(KEY "${CMAKE_MATCH_2}")
+                        set(HASH_${KEY} "${CMAKE_MATCH_1}")
+                    endif()
+                endforeach()
+            endif()
+        endforeach()
+        file(REMOVE_RECURSE "${WORK_DIR}")
+    endif()
+    foreach(FILE_PATH IN LISTS MISSES)
+        dop_hash_key(KEY "${FILE_PATH}")
+        if(NOT DEFINED HASH_${KEY})
+            file(SHA256 "${FILE_PATH}" HASH_${KEY})
+        endif()
+    endforeach()
+
+    # Rewrite the cache. A file modified in the current second could change
+    # again without its mtime moving, so it is stored to be hashed next time.
+    string(TIMESTAMP NOW "%s" UTC)
+    set(CACHE_CONTENT "")
+    foreach(FILE_PATH IN LISTS FILES)
+        dop_hash_key(KEY "${FILE_PATH}")
+        if(DEFINED HASH_${KEY} AND NOT WRITTEN_${KEY})
+            set(DOP_HASH_${KEY} "${HASH_${KEY}}" PARENT_SCOPE)
+            string(REPLACE "|" ";" STAT "${STAT_${KEY}}")
+            list(GET STAT 0 FILE_SIZE)
+            list(GET STAT 1 FILE_MTIME)
+            if(NOT FILE_MTIME LESS NOW)
+                set(FILE_MTIME 0)
+            endif()
+            string(APPEND CACHE_CONTENT "${HASH_${KEY}}|${FILE_SIZE}|${FILE_MTIME}|${FILE_PATH}\n")
+            set(WRITTEN_${KEY} TRUE)
+        endif()
+    endforeach()
+    foreach(KEY IN LISTS CACHED_KEYS)
+        if(NOT WRITTEN_${KEY})
+            string(APPEND CACHE_CONTENT "${CACHED_${KEY}}|${CACHED_PATH_${KEY}}\n")
+            set(WRITTEN_${KEY} TRUE)
+        endif()
+    endforeach()
+    get_filename_component(CACHE_DIR "${CACHE_FILE}" DIRECTORY)
+    file(MAKE_DIRECTORY "${CACHE_DIR}")
+    file(WRITE "${CACHE_FILE}.tmp" "${CACHE_CONTENT}")
+    file(RENAME "${CACHE_FILE}.tmp" "${CACHE_FILE}")
+
+    set(DOP_HASHED "${MISSES}" PARENT_SCOPE)
+endfunction()
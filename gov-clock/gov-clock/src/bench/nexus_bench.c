@@ -0,0 +1,121 @@
+// src/bench/nexus_bench.c
+// Nexus-Link hot paths on the shared harness (bench/include/obibench.h at
+// the top of the tree): cached resolution, prefix search, version
+// comparison, and the circuit breaker and health status reads taken on
+// every call through a component. Links only the Nexus-Link sources, so
+// it runs without the DOP core.
+
+#include "nexus_link_semserver_x.h"
+#include "obibench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_COMPONENTS 1024
+
+typedef struct {
+    nexus_resolution_context_t* ctx;
+    component_manifest_t* manifests;
+    nexus_health_scheduler_t* scheduler;
+    int32_t slot;
+    circuit_breaker_t breaker;
+    char ids[BENCH_COMPONENTS][32];
+} nexus_bench_t;
+
+static health_status_t check_healthy(void* component) {
+    (void)component;
+    return HEALTH_HEALTHY;
+}
+
+static void bench_resolve(void* arg, uint64_t count) {
+    nexus_bench_t* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        component_manifest_t* manifest = nexus_resolve_component(
+            bench->ctx, bench->ids[i % BENCH_COMPONENTS], NULL, RESOLUTION_LATEST_STABLE);
+        obibench_do_not_optimize(manifest);
+    }
+}
+
+static void bench_search(void* arg, uint64_t count) {
+    nexus_bench_t* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        search_results_t* results = nexus_search_components(bench->ctx, "bench.comp.01", NULL, 16);
+        obibench_do_not_optimize(results);
+        nexus_free_search_results(results);
+    }
+}
+
+static void bench_compare_versions(void* arg, uint64_t count) {
+    nexus_bench_t* bench = arg;
+    int order = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        obibench_clobber();
+        order += nexus_compare_versions(&bench->manifests[i % BENCH_COMPONENTS].version,
+                                        &bench->manifests[(i + 1) % BENCH_COMPONENTS].version);
+    }
+    obibench_do_not_optimize(&order);
+}
+
+static void bench_circuit(void* arg, uint64_t count) {
+    nexus_bench_t* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        if (nexus_circuit_allow(&bench->breaker)) {
+            nexus_circuit_record_success(&bench->breaker);
+        }
+    }
+}
+
+static void bench_health_status(void* arg, uint64_t count) {
+    nexus_bench_t* bench = arg;
+    unsigned int healthy = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        obibench_clobber();
+        healthy += nexus_health_status(bench->scheduler, bench->slot) == HEALTH_HEALTHY;
+    }
+    obibench_do_not_optimize(&healthy);
+}
+
+int main(int argc, char** argv) {
+    nexus_bench_t* bench = calloc(1, sizeof(*bench));
+    if (!bench) return 1;
+    bench->ctx = nexus_link_init(NULL, RESOLUTION_LATEST_STABLE);
+    bench->manifests = calloc(BENCH_COMPONENTS, sizeof(*bench->manifests));
+    if (!bench->ctx || !bench->manifests) {
+        fprintf(stderr, "nexus_bench: setup failed\n");
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < BENCH_COMPONENTS; i++) {
+        component_manifest_t* manifest = &bench->manifests[i];
+        snprintf(bench->ids[i], sizeof(bench->ids[i]), "bench.comp.%04u", i);
+        snprintf(manifest->component_id, sizeof(manifest->component_id), "%s", bench->ids[i]);
+        manifest->version.major = 1;
+        manifest->version.minor = i % 7;
+        manifest->version.patch = i % 13;
+        nexus_register_component(bench->ctx, manifest, SOURCE_LOCAL_CACHE);
+    }
+
+    nexus_circuit_init(&bench->breaker, bench->ids[0]);
+    nexus_health_scheduler_config_t config = { .max_components = 4, .max_concurrent = 1 };
+    health_check_config_t check = { .check_function = check_healthy, .check_interval_ms = 1000,
+                                   .timeout_ms = 100 };
+    bench->scheduler = nexus_health_scheduler_create(bench->ctx, &config);
+    bench->slot = bench->scheduler
+        ? nexus_health_watch(bench->scheduler, bench->ids[0], NULL, &check, NULL) : -1;
+
+    obibench_suite_t* suite = obibench_init("gov-clock", argc, argv);
+    obibench_run(suite, "nexus_resolve_component", bench_resolve, bench);
+    obibench_run(suite, "nexus_search_components", bench_search, bench);
+    obibench_run(suite, "nexus_compare_versions", bench_compare_versions, bench);
+    obibench_run(suite, "circuit_allow_record", bench_circuit, bench);
+    if (bench->slot >= 0) {
+        obibench_run(suite, "health_status", bench_health_status, bench);
+    }
+    int status = obibench_finish(suite);
+
+    nexus_health_scheduler_destroy(bench->scheduler);
+    nexus_link_destroy(bench->ctx);
+    free(bench->manifests);
+    free(bench);
+    return status;
+}
@@ -1,5 +1,25 @@
 #include "obinexus_dop_core.h"
+#include "dop_timer_wheel.h"
 #include <string.h>
+#include <unistd.h>
+
+// The shared timer wheel triggers an armed alarm when its time of day next
+// comes round, or when a snooze runs out. Callers hold the component mutex.
+static uint64_t alarm_schedule(dop_component_t* component, uint64_t delay_ms) {
+    component->metadata.wheel_owner = getpid();
+    return dop_timer_wheel_schedule(dop_timer_wheel_shared(), delay_ms, component);
+}
+
+static uint64_t alarm_delay_ms(dop_time_data_t alarm_time) {
+    const uint64_t day_ms = 24ULL * 3600 * 1000;
+    dop_time_data_t now = dop_time_get_current();
+    uint64_t target = (((uint64_t)alarm_time.hours * 60 + alarm_time.minutes) * 60 + alarm_time.seconds) * 1000
+                      + alarm_time.milliseconds;
+    uint64_t current = (((uint64_t)now.hours * 60 + now.minutes) * 60 + now.seconds) * 1000
+                       + now.milliseconds;
+    target %= day_ms;
+    return target >= current ? target - current : day_ms - current + target;
+}
 
 int dop_alarm_set_time(dop_component_t* component, dop_time_data_t alarm_time) {
     if (!component || component->metadata.type != DOP_COMPONENT_ALARM) {
@@ -12,9 +32,16 @@ int dop_alarm_set_time(dop_component_t* component, dop_time_data_t alarm_time) {
     
     pthread_mutex_lock(&component->metadata.mutex);
     component->data.alarm.alarm_time = alarm_time;
+    uint64_t previous = 0;
+    if (component->data.alarm.is_armed) {
+        previous = dop_timer_wheel_owned(component);
+        component->metadata.wheel_timer = alarm_schedule(component, alarm_delay_ms(alarm_time));
+    }
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    // Outside the mutex: cancelling may wait for a delivery that needs it
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
 
@@ -24,11 +51,15 @@ int dop_alarm_arm(dop_component_t* component) {
     }
     
     pthread_mutex_lock(&component->metadata.mutex);
-    component->data.alarm.is_armed = true;
+    uint64_t previous = dop_timer_wheel_owned(component);
+    component->metadata.wheel_timer = alarm_schedule(component, alarm_delay_ms(component->data.alarm.alarm_time));
+    component->data.alarm.is_armed = component->metadata.wheel_timer != 0;
     component->checksum = dop_checksum_calculate(component);
+    bool armed = component->data.alarm.is_armed;
     pthread_mutex_unlock(&component->metadata.mutex);
     
-    return DOP_SUCCESS;
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
+    return armed ? DOP_SUCCESS : DOP_ERROR_MEMORY_ALLOCATION;
 }
 
 int dop_alarm_disarm(dop_component_t* component) {
@@ -37,11 +68,14 @@ int dop_alarm_disarm(dop_component_t* component) {
     }
     
     pthread_mutex_lock(&component->metadata.mutex);
+    uint64_t previous = dop_timer_wheel_owned(component);
+    component->metadata.wheel_timer = 0;
     component->data.alarm.is_armed = false;
     component->data.alarm.is_triggered = false;
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
 
@@ -50,7 +84,11 @@ bool dop_alarm_is_triggered(const dop_component_t* component) {
         return false;
     }
     
-    return component->data.alarm.is_triggered;
+    // Set by the wheel thread
+    pthread_mutex_lock((pthread_mutex_t*)&component->metadata.mutex);
+    bool triggered = component->data.alarm.is_triggered;
+    pthread_mutex_unlock((pthread_mutex_t*)&component->metadata.mutex);
+    return triggered;
 }
 
 int dop_alarm_snooze(dop_component_t* component, uint32_t duration_ms) {
@@ -61,8 +99,25 @@ int dop_alarm_snooze(dop_component_t* component, uint32_t duration_ms) {
     pthread_mutex_lock(&component->metadata.mutex);
     component->data.alarm.snooze_duration_ms = duration_ms;
     component->data.alarm.is_triggered = false;
+    // An armed alarm triggers again once the snooze runs out
+    uint64_t previous = 0;
+    if (component->data.alarm.is_armed) {
+        previous = dop_timer_wheel_owned(component);
+        component->metadata.wheel_timer = alarm_schedule(component, duration_ms);
+    }
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
+
+void dop_alarm_expire(dop_component_t* component, uint64_t handle) {
+    pthread_mutex_lock(&component->metadata.mutex);
+    if (dop_timer_wheel_owned(component) == handle) {
+        component->metadata.wheel_timer = 0;
+        component->data.alarm.is_triggered = true;
+        component->checksum = dop_checksum_calculate(component);
+    }
+    pthread_mutex_unlock(&component->metadata.mutex);
+}
@@ -1,6 +1,7 @@
 #include "obinexus_dop_core.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int dop_clock_set_timezone(dop_component_t* component, int32_t offset_hours) {
     if (!component || component->metadata.type != DOP_COMPONENT_CLOCK) {
@@ -28,35 +29,95 @@ int dop_clock_set_format(dop_component_t* component, bool is_24_hour) {
     return DOP_SUCCESS;
 }
 
-char* dop_clock_format_time(const dop_component_t* component) {
-    if (!component || component->metadata.type != DOP_COMPONENT_CLOCK) {
-        return NULL;
+// Write value in decimal, zero-padded to at least width digits
+static size_t format_digits(char* out, uint32_t value, size_t width) {
+    char digits[10];
+    size_t count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count < width) digits[count++] = '0';
+    for (size_t i = 0; i < count; i++) out[i] = digits[count - 1 - i];
+    return count;
+}
+
+// The last "HH:MM:SS." prefix this thread formatted. Clocks updated off one
+// clock read share it, so within a second only the milliseconds change.
+typedef struct {
+    bool valid;
+    bool is_24_hour;
+    uint32_t hours, minutes, seconds;
+    size_t length;
+    const char* suffix;
+    char prefix[40];
+} format_cache_t;
+
+static _Thread_local format_cache_t t_format_cache;
+
+int dop_clock_format_time_into(const dop_component_t* component, char* buffer, size_t size) {
+    if (!component || component->metadata.type != DOP_COMPONENT_CLOCK || !buffer) {
+        return DOP_ERROR_INVALID_PARAMETER;
     }
-    
-    char* formatted_time = malloc(32);
-    if (!formatted_time) return NULL;
-    
-    const dop_time_data_t* time = &component->data.clock.current_time;
-    
-    if (component->data.clock.is_24_hour_format) {
-        snprintf(formatted_time, 32, "%02u:%02u:%02u.%03u", 
-                time->hours, time->minutes, time->seconds, time->milliseconds);
-    } else {
-        uint32_t display_hour = time->hours;
-        const char* ampm = "AM";
-        
-        if (display_hour == 0) {
-            display_hour = 12;
-        } else if (display_hour > 12) {
-            display_hour -= 12;
-            ampm = "PM";
-        } else if (display_hour == 12) {
-            ampm = "PM";
+
+    pthread_mutex_lock((pthread_mutex_t*)&component->metadata.mutex);
+    dop_time_data_t time = component->data.clock.current_time;
+    bool is_24_hour = component->data.clock.is_24_hour_format;
+    pthread_mutex_unlock((pthread_mutex_t*)&component->metadata.mutex);
+
+    format_cache_t* cache = &t_format_cache;
+    if (!cache->valid || cache->is_24_hour != is_24_hour || cache->seconds != time.seconds ||
+        cache->minutes != time.minutes || cache->hours != time.hours) {
+        uint32_t display_hour = time.hours;
+        size_t length;
+        cache->suffix = "";
+        if (is_24_hour) {
+            length = format_digits(cache->prefix, display_hour, 2);
+        } else {
+            cache->suffix = " AM";
+            if (display_hour == 0) {
+                display_hour = 12;
+            } else if (display_hour > 12) {
+                display_hour -= 12;
+                cache->suffix = " PM";
+            } else if (display_hour == 12) {
+                cache->suffix = " PM";
+            }
+            length = format_digits(cache->prefix, display_hour, 1);
         }
-        
-        snprintf(formatted_time, 32, "%u:%02u:%02u.%03u %s", 
-                display_hour, time->minutes, time->seconds, time->milliseconds, ampm);
+        cache->prefix[length++] = ':';
+        length += format_digits(cache->prefix + length, time.minutes, 2);
+        cache->prefix[length++] = ':';
+        length += format_digits(cache->prefix + length, time.seconds, 2);
+        cache->prefix[length++] = '.';
+        cache->length = length;
+        cache->is_24_hour = is_24_hour;
+        cache->hours = time.hours;
+        cache->minutes = time.minutes;
+        cache->seconds = time.seconds;
+        cache->valid = true;
+    }
+
+    char milliseconds[10];
+    size_t ms_length = format_digits(milliseconds, time.milliseconds, 3);
+    size_t suffix_length = strlen(cache->suffix);
+    if (cache->length + ms_length + suffix_length >= size) {
+        return DOP_ERROR_INVALID_PARAMETER;     // Buffer too small
+    }
+
+    memcpy(buffer, cache->prefix, cache->length);
+    memcpy(buffer + cache->length, milliseconds, ms_length);
+    memcpy(buffer + cache->length + ms_length, cache->suffix, suffix_length + 1);
+    return DOP_SUCCESS;
+}
+
+char* dop_clock_format_time(const dop_component_t* component) {
+    char* formatted_time = malloc(DOP_CLOCK_FORMAT_SIZE);
+    if (!formatted_time) return NULL;
+
+    if (dop_clock_format_time_into(component, formatted_time, DOP_CLOCK_FORMAT_SIZE) != DOP_SUCCESS) {
+        free(formatted_time);
+        return NULL;
     }
-    
     return formatted_time;
 }
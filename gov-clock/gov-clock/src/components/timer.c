@@ -1,4 +1,16 @@
 #include "obinexus_dop_core.h"
+#include "dop_timer_wheel.h"
+#include <unistd.h>
+
+// Expiry is delivered by the shared timer wheel rather than found by
+// polling; the component holds the handle of its pending wheel timer and
+// the process whose wheel that is. Callers hold the component mutex.
+static uint64_t timer_schedule(dop_component_t* component, uint64_t elapsed_ms) {
+    uint64_t duration = component->data.timer.duration.timestamp_ms;
+    uint64_t delay = duration > elapsed_ms ? duration - elapsed_ms : 0;
+    component->metadata.wheel_owner = getpid();
+    return dop_timer_wheel_schedule(dop_timer_wheel_shared(), delay, component);
+}
 
 int dop_timer_set_duration(dop_component_t* component, uint64_t duration_ms) {
     if (!component || component->metadata.type != DOP_COMPONENT_TIMER) {
@@ -7,9 +19,18 @@ int dop_timer_set_duration(dop_component_t* component, uint64_t duration_ms) {
     
     pthread_mutex_lock(&component->metadata.mutex);
     component->data.timer.duration.timestamp_ms = duration_ms;
+    // A running timer now expires at its start plus the new duration
+    uint64_t previous = 0;
+    if (component->data.timer.is_running) {
+        previous = dop_timer_wheel_owned(component);
+        uint64_t elapsed = dop_time_diff_ms(dop_time_get_current(), component->data.timer.start_time);
+        component->metadata.wheel_timer = timer_schedule(component, elapsed);
+    }
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    // Outside the mutex: cancelling may wait for a delivery that needs it
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
 
@@ -19,13 +40,17 @@ int dop_timer_start(dop_component_t* component) {
     }
     
     pthread_mutex_lock(&component->metadata.mutex);
+    uint64_t previous = dop_timer_wheel_owned(component);
     component->data.timer.start_time = dop_time_get_current();
-    component->data.timer.is_running = true;
     component->data.timer.is_expired = false;
+    component->metadata.wheel_timer = timer_schedule(component, 0);
+    component->data.timer.is_running = component->metadata.wheel_timer != 0;
     component->checksum = dop_checksum_calculate(component);
+    bool scheduled = component->data.timer.is_running;
     pthread_mutex_unlock(&component->metadata.mutex);
     
-    return DOP_SUCCESS;
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
+    return scheduled ? DOP_SUCCESS : DOP_ERROR_MEMORY_ALLOCATION;
 }
 
 int dop_timer_stop(dop_component_t* component) {
@@ -34,10 +59,13 @@ int dop_timer_stop(dop_component_t* component) {
     }
     
     pthread_mutex_lock(&component->metadata.mutex);
+    uint64_t previous = dop_timer_wheel_owned(component);
+    component->metadata.wheel_timer = 0;
     component->data.timer.is_running = false;
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
 
@@ -47,6 +75,8 @@ int dop_timer_reset(dop_component_t* component) {
     }
     
     pthread_mutex_lock(&component->metadata.mutex);
+    uint64_t previous = dop_timer_wheel_owned(component);
+    component->metadata.wheel_timer = 0;
     component->data.timer.is_running = false;
     component->data.timer.is_expired = false;
     // Reset to current time
@@ -54,6 +84,7 @@ int dop_timer_reset(dop_component_t* component) {
     component->checksum = dop_checksum_calculate(component);
     pthread_mutex_unlock(&component->metadata.mutex);
     
+    if (previous) dop_timer_wheel_cancel(dop_timer_wheel_shared(), previous);
     return DOP_SUCCESS;
 }
 
@@ -62,5 +93,25 @@ bool dop_timer_is_expired(const dop_component_t* component) {
         return false;
     }
     
-    return component->data.timer.is_expired;
+    // Set by the wheel thread
+    pthread_mutex_lock((pthread_mutex_t*)&component->metadata.mutex);
+    bool expired = component->data.timer.is_expired;
+    pthread_mutex_unlock((pthread_mutex_t*)&component->metadata.mutex);
+    return expired;
+}
+
+void dop_timer_expire(dop_component_t* component, uint64_t handle) {
+    pthread_mutex_lock(&component->metadata.mutex);
+    if (dop_timer_wheel_owned(component) == handle) {
+        component->data.timer.is_expired = true;
+        if (component->data.timer.auto_restart) {
+            component->data.timer.start_time = dop_time_get_current();
+            component->metadata.wheel_timer = timer_schedule(component, 0);
+        } else {
+            component->metadata.wheel_timer = 0;
+        }
+        component->data.timer.is_running = component->metadata.wheel_timer != 0;
+        component->checksum = dop_checksum_calculate(component);
+    }
+    pthread_mutex_unlock(&component->metadata.mutex);
 }
@@ -1,7 +1,10 @@
+#define _POSIX_C_SOURCE 200809L
 #include "obinexus_dop_core.h"
 #include "dop_adapter.h"
 #include "dop_topology.h"
 #include "dop_manifest.h"
+#include "dop_shared_table.h"
+#include "nexus_link_semserver_x.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -135,9 +138,8 @@ static int test_p2p_topology(void) {
     // Create build topology
     dop_build_topology_t topology = {0};
     strncpy(topology.build_id, "test_p2p_topology", sizeof(topology.build_id) - 1);
-    topology.nodes[0] = node1;
-    topology.nodes[1] = node2;
-    topology.node_count = 2;
+    dop_topology_add_node(&topology, node1);
+    dop_topology_add_node(&topology, node2);
     topology.is_p2p_enabled = true;
     topology.is_fault_tolerant = true;
     
@@ -152,18 +154,231 @@ static int test_p2p_topology(void) {
         if (dop_topology_test_fault_tolerance(&topology) == DOP_SUCCESS) {
             printf("Fault tolerance test passed\n");
         }
+
+        dop_topology_stop_p2p_network(&topology);
+        printf("Updates: %s %llu, %s %llu\n",
+               node1->node_id, (unsigned long long)atomic_load(&node1->updates),
+               node2->node_id, (unsigned long long)atomic_load(&node2->updates));
     }
     
     // Cleanup
     dop_func_destroy_component(alarm);
     dop_func_destroy_component(clock);
-    free(node1);
-    free(node2);
+    dop_topology_destroy_node(node1);
+    dop_topology_destroy_node(node2);
+    dop_topology_release(&topology);
     
     printf("P2P topology test completed\n\n");
     return 0;
 }
 
+static uint64_t monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+static uint64_t total_updates(dop_build_topology_t* topology) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < topology->node_count; i++) {
+        total += atomic_load_explicit(&topology->nodes[i]->updates, memory_order_relaxed);
+    }
+    return total;
+}
+
+// Component update throughput of a ring of clocks, each node peered with
+// its neighbours, for growing topology sizes
+static int bench_p2p_topology(void) {
+    printf("=== P2P Topology Throughput ===\n");
+    printf("%6s %16s %16s %12s\n", "nodes", "updates/s", "per node/s", "dropped");
+
+    for (uint32_t size = 1; size <= 16; size *= 2) {
+        dop_build_topology_t topology = {0};
+        strncpy(topology.build_id, "bench_p2p_topology", sizeof(topology.build_id) - 1);
+        for (uint32_t i = 0; i < size; i++) {
+            char node_id[64];
+            snprintf(node_id, sizeof(node_id), "node_clock_%02u", i);
+            dop_component_t* clock = dop_func_create_component(DOP_COMPONENT_CLOCK);
+            dop_topology_node_t* node = clock ? dop_topology_create_node(node_id, clock) : NULL;
+            if (!node || dop_topology_add_node(&topology, node) != DOP_SUCCESS) {
+                printf("Failed to create topology node\n");
+                return 1;
+            }
+        }
+        for (uint32_t i = 0; size > 1 && i < size; i++) {
+            dop_topology_add_peer(topology.nodes[i], topology.nodes[(i + 1) % size]);
+            dop_topology_add_peer(topology.nodes[i], topology.nodes[(i + size - 1) % size]);
+        }
+
+        if (dop_topology_start_p2p_network(&topology) != DOP_SUCCESS) {
+            printf("Failed to start P2P network\n");
+            return 1;
+        }
+        struct timespec warmup = { 0, 200 * 1000000L }, window = { 1, 0 };
+        nanosleep(&warmup, NULL);
+        uint64_t start_ms = monotonic_ms(), start_updates = total_updates(&topology);
+        nanosleep(&window, NULL);
+        uint64_t elapsed_ms = monotonic_ms() - start_ms;
+        uint64_t updates = total_updates(&topology) - start_updates;
+        dop_topology_stop_p2p_network(&topology);
+
+        uint64_t dropped = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            dropped += atomic_load(&topology.nodes[i]->messages_dropped);
+            dop_func_destroy_component(topology.nodes[i]->component);
+            dop_topology_destroy_node(topology.nodes[i]);
+        }
+        dop_topology_release(&topology);
+        double rate = elapsed_ms ? (double)updates * 1000.0 / (double)elapsed_ms : 0.0;
+        printf("%6u %16.0f %16.0f %12llu\n", size, rate, rate / size, (unsigned long long)dropped);
+    }
+
+    printf("P2P topology benchmark completed\n\n");
+    return 0;
+}
+
+// Stands in for a remote probe: a millisecond of waiting per check
+static health_status_t probe_component(void* component) {
+    (void)component;
+    struct timespec wait = { 0, 1000000L };
+    nanosleep(&wait, NULL);
+    return HEALTH_HEALTHY;
+}
+
+static int bench_health_checks(void) {
+    printf("=== Health Check Polling ===\n");
+    printf("%10s %12s %12s %12s\n", "components", "serial ms", "scheduled ms", "unknown");
+
+    for (uint32_t size = 64; size <= 1024; size *= 4) {
+        nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+        component_manifest_t* manifests = calloc(size, sizeof(*manifests));
+        if (!ctx || !manifests) {
+            printf("Failed to set up health benchmark\n");
+            free(manifests);
+            nexus_link_destroy(ctx);
+            return 1;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            snprintf(manifests[i].component_id, sizeof(manifests[i].component_id), "health.probe.%04u", i);
+            nexus_register_component(ctx, &manifests[i], SOURCE_LOCAL_CACHE);
+        }
+
+        health_check_config_t config = { probe_component, 60000, 100, 0, HEALTH_UNKNOWN };
+        uint64_t start_ms = monotonic_ms();
+        for (uint32_t i = 0; i < size; i++) {
+            nexus_check_component_health(ctx, manifests[i].component_id, &config);
+        }
+        uint64_t serial_ms = monotonic_ms() - start_ms;
+
+        nexus_health_scheduler_config_t scheduler_config = { size, 64, 20 };
+        nexus_health_scheduler_t* scheduler = nexus_health_scheduler_create(ctx, &scheduler_config);
+        int32_t* slots = malloc(size * sizeof(*slots));
+        if (!scheduler || !slots) {
+            printf("Failed to create health scheduler\n");
+            free(slots);
+            nexus_health_scheduler_destroy(scheduler);
+            free(manifests);
+            nexus_link_destroy(ctx);
+            return 1;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            slots[i] = nexus_health_watch(scheduler, manifests[i].component_id, NULL, &config, NULL);
+        }
+
+        start_ms = monotonic_ms();
+        nexus_health_scheduler_start(scheduler);
+        nexus_health_check_all(scheduler);
+        nexus_health_stats_t stats = {0};
+        struct timespec poll = { 0, 100000L };
+        do {
+            nanosleep(&poll, NULL);
+            nexus_health_get_stats(scheduler, &stats);
+        } while (stats.checks < size && monotonic_ms() - start_ms < 10000);
+        uint64_t scheduled_ms = monotonic_ms() - start_ms;
+        nexus_health_scheduler_stop(scheduler);
+
+        uint32_t unknown = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            if (nexus_health_status(scheduler, slots[i]) == HEALTH_UNKNOWN) unknown++;
+        }
+        printf("%10u %12llu %12llu %12u\n", size, (unsigned long long)serial_ms,
+               (unsigned long long)scheduled_ms, unknown);
+
+        free(slots);
+        nexus_health_scheduler_destroy(scheduler);
+        free(manifests);
+        nexus_link_destroy(ctx);
+    }
+
+    printf("Health check benchmark completed\n\n");
+    return 0;
+}
+
+// One process serves a clock from shared memory; others read it in place
+#define SHARED_DEMO_TABLE "/gov_clock_demo"
+
+static int serve_shared_clock(void) {
+    printf("=== Serving Shared Clock ===\n");
+
+    dop_shared_table_unlink(SHARED_DEMO_TABLE);     // Left by an earlier run
+    dop_shared_table_t* table = dop_shared_table_create(SHARED_DEMO_TABLE, 16);
+    dop_component_t* clock = table ? dop_shared_table_create_component(table, DOP_COMPONENT_CLOCK, "clock") : NULL;
+    if (!clock) {
+        printf("Failed to create shared clock\n");
+        dop_shared_table_detach(table);
+        dop_shared_table_unlink(SHARED_DEMO_TABLE);
+        return 1;
+    }
+
+    dop_gate_open(clock);
+    printf("Serving %s for 10 seconds; run --read-shared-clock elsewhere\n", SHARED_DEMO_TABLE);
+    struct timespec interval = { 0, 10 * 1000000L };
+    for (int i = 0; i < 1000; i++) {
+        dop_func_update_component(clock);
+        dop_shared_table_publish(table);
+        nanosleep(&interval, NULL);
+    }
+
+    dop_shared_table_destroy_component(table, clock);
+    dop_shared_table_detach(table);
+    dop_shared_table_unlink(SHARED_DEMO_TABLE);
+    printf("Shared clock stopped\n\n");
+    return 0;
+}
+
+static int read_shared_clock(void) {
+    printf("=== Reading Shared Clock ===\n");
+
+    dop_shared_table_t* table = dop_shared_table_attach(SHARED_DEMO_TABLE, false);
+    int slot = table ? dop_shared_table_find(table, "clock") : -1;
+    if (slot < 0) {
+        printf("No shared clock; start one with --serve-shared-clock\n");
+        dop_shared_table_detach(table);
+        return 1;
+    }
+
+    const dop_shared_view_t* view = dop_shared_table_view(table, (uint32_t)slot);
+    struct timespec interval = { 0, 500 * 1000000L };
+    for (int i = 0; i < 10; i++) {
+        dop_time_data_t now;
+        dop_gate_state_t gate;
+        uint32_t sequence;
+        do {
+            sequence = dop_shared_view_begin(view);
+            now = view->data.clock.current_time;
+            gate = view->gate_state;
+        } while (dop_shared_view_retry(view, sequence));
+
+        printf("%02u:%02u:%02u.%03u (gate %d)\n", now.hours, now.minutes, now.seconds,
+               now.milliseconds, gate);
+        nanosleep(&interval, NULL);
+    }
+
+    dop_shared_table_detach(table);
+    printf("Shared clock read completed\n\n");
+    return 0;
+}
+
 static int test_xml_manifest(void) {
     printf("=== Testing XML Manifest ===\n");
     
@@ -208,6 +423,14 @@ int main(int argc, char* argv[]) {
             return dop_manifest_validate_schema("examples/time_components_manifest.xml");
         } else if (strcmp(argv[1], "--test-p2p-topology") == 0) {
             return test_p2p_topology();
+        } else if (strcmp(argv[1], "--bench-p2p") == 0) {
+            return bench_p2p_topology();
+        } else if (strcmp(argv[1], "--bench-health") == 0) {
+            return bench_health_checks();
+        } else if (strcmp(argv[1], "--serve-shared-clock") == 0) {
+            return serve_shared_clock();
+        } else if (strcmp(argv[1], "--read-shared-clock") == 0) {
+            return read_shared_clock();
         }
     }
     
@@ -3,6 +3,7 @@
 // Provides Function <-> OOP conversion capabilities
 
 #include "dop_adapter.h"
+#include "dop_serialize.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -51,6 +52,13 @@ static char* oop_serialize(void* instance) {
     return oop_inst->serialize_func(oop_inst->component);
 }
 
+static int oop_serialize_into(void* instance, void* buffer, size_t size, size_t* written) {
+    dop_oop_instance_t* oop_inst = (dop_oop_instance_t*)instance;
+    if (!oop_inst || !oop_inst->component) return DOP_ERROR_INVALID_PARAMETER;
+    
+    return dop_serialize_component(oop_inst->component, buffer, size, written);
+}
+
 static dop_component_t* oop_get_data(void* instance) {
     dop_oop_instance_t* oop_inst = (dop_oop_instance_t*)instance;
     return oop_inst ? oop_inst->component : NULL;
@@ -90,6 +98,7 @@ dop_oop_interface_t* dop_adapter_func_to_oop(dop_func_create_t create_func,
     interface->destroy = oop_destroy;
     interface->serialize = oop_serialize;
     interface->get_data = oop_get_data;
+    interface->serialize_into = oop_serialize_into;
     
     return interface;
 }
@@ -103,3 +112,84 @@ dop_func_update_t dop_adapter_oop_to_func_update(dop_oop_interface_t* oop_interf
     (void)oop_interface;
     return dop_func_update_component;
 }
+
+// Direct-dispatch adapter methods
+static int direct_create(void* instance, dop_component_type_t type) {
+    dop_direct_adapter_t* adapter = instance;
+    if (!adapter) return DOP_ERROR_INVALID_PARAMETER;
+
+    adapter->component = dop_func_create_component(type);
+    return adapter->component ? DOP_SUCCESS : DOP_ERROR_MEMORY_ALLOCATION;
+}
+
+static int direct_update(void* instance) {
+    dop_direct_adapter_t* adapter = instance;
+    if (!adapter || !adapter->component) return DOP_ERROR_INVALID_PARAMETER;
+    return dop_func_update_component(adapter->component);
+}
+
+static int direct_destroy(void* instance) {
+    dop_direct_adapter_t* adapter = instance;
+    if (!adapter || !adapter->component) return DOP_ERROR_INVALID_PARAMETER;
+
+    int result = dop_func_destroy_component(adapter->component);
+    adapter->component = NULL;
+    return result;
+}
+
+static char* direct_serialize(void* instance) {
+    dop_direct_adapter_t* adapter = instance;
+    if (!adapter || !adapter->component) return NULL;
+    return dop_func_serialize_component(adapter->component);
+}
+
+static int direct_serialize_into(void* instance, void* buffer, size_t size, size_t* written) {
+    dop_direct_adapter_t* adapter = instance;
+    if (!adapter || !adapter->component) return DOP_ERROR_INVALID_PARAMETER;
+    return dop_serialize_component(adapter->component, buffer, size, written);
+}
+
+static dop_component_t* direct_get_data(void* instance) {
+    dop_direct_adapter_t* adapter = instance;
+    return adapter ? adapter->component : NULL;
+}
+
+static const dop_oop_interface_t direct_vtable = {
+    .instance = NULL,
+    .create = direct_create,
+    .update = direct_update,
+    .destroy = direct_destroy,
+    .serialize = direct_serialize,
+    .get_data = direct_get_data,
+    .serialize_into = direct_serialize_into
+};
+
+void dop_adapter_direct_init(dop_direct_adapter_t* adapter) {
+    if (!adapter) return;
+    adapter->interface = direct_vtable;
+    adapter->interface.instance = adapter;
+    adapter->component = NULL;
+}
+
+dop_direct_adapter_t* dop_adapter_direct_create(void) {
+    dop_direct_adapter_t* adapter = malloc(sizeof(dop_direct_adapter_t));
+    dop_adapter_direct_init(adapter);
+    return adapter;
+}
+
+void dop_adapter_direct_free(dop_direct_adapter_t* adapter) {
+    free(adapter);
+}
+
+uint32_t dop_adapter_direct_update_many(dop_direct_adapter_t* const* adapters, uint32_t count) {
+    if (!adapters) return 0;
+
+    uint32_t updated = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        dop_component_t* component = adapters[i] ? adapters[i]->component : NULL;
+        if (component && dop_func_update_component(component) == DOP_SUCCESS) {
+            updated++;
+        }
+    }
+    return updated;
+}
@@ -0,0 +1,276 @@
+// src/dop_component_pool.c
+// OBINexus DOP Component Pool Implementation
+
+#include "dop_component_pool.h"
+#include "dop_timer_wheel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+
+#define POOL_CHUNK 256                          // Objects per allocation
+#define POOL_GENERATION_MASK 0xFFFFFFu          // Handles keep 24 bits of it
+#define POOL_ALIGN 64                           // Cache line; objects may embed aligned members
+
+typedef struct pool_slot {
+    struct pool_slot* next_free;
+    uint32_t index;
+    uint32_t generation;
+    bool in_use;
+} pool_slot_t;
+
+// The object follows its slot header, suitably aligned
+#define POOL_HEADER ((sizeof(pool_slot_t) + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1))
+_Static_assert(POOL_ALIGN % alignof(max_align_t) == 0, "pool objects must suit any type");
+
+struct dop_object_pool {
+    pthread_mutex_t lock;
+    size_t object_size;
+    size_t mutex_offset;
+    size_t stride;
+    unsigned char** chunks;
+    uint32_t chunk_count;
+    pool_slot_t* free_list;
+    dop_pool_stats_t stats;
+};
+
+static pool_slot_t* slot_of(const void* object) {
+    return (pool_slot_t*)((unsigned char*)object - POOL_HEADER);
+}
+
+static void* object_of(pool_slot_t* slot) {
+    return (unsigned char*)slot + POOL_HEADER;
+}
+
+dop_object_pool_t* dop_object_pool_create(size_t object_size, size_t mutex_offset) {
+    if (object_size == 0 || mutex_offset + sizeof(pthread_mutex_t) > object_size) return NULL;
+
+    dop_object_pool_t* pool = calloc(1, sizeof(dop_object_pool_t));
+    if (!pool) return NULL;
+    pool->object_size = object_size;
+    pool->mutex_offset = mutex_offset;
+    pool->stride = (POOL_HEADER + object_size + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+    pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+
+void dop_object_pool_destroy(dop_object_pool_t* pool) {
+    if (!pool) return;
+    for (uint32_t c = 0; c < pool->chunk_count; c++) {
+        for (uint32_t i = 0; i < POOL_CHUNK; i++) {
+            void* object = object_of((pool_slot_t*)(pool->chunks[c] + (size_t)i * pool->stride));
+            pthread_mutex_destroy((pthread_mutex_t*)((unsigned char*)object + pool->mutex_offset));
+        }
+        free(pool->chunks[c]);
+    }
+    free(pool->chunks);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+// Add a chunk, initialising each object's mutex once. Called with the lock held.
+static int pool_grow(dop_object_pool_t* pool) {
+    unsigned char** chunks = realloc(pool->chunks, (pool->chunk_count + 1) * sizeof(unsigned char*));
+    if (!chunks) return DOP_ERROR_MEMORY_ALLOCATION;
+    pool->chunks = chunks;
+    unsigned char* chunk = aligned_alloc(POOL_ALIGN, POOL_CHUNK * pool->stride);
+    if (!chunk) return DOP_ERROR_MEMORY_ALLOCATION;
+
+    for (uint32_t i = POOL_CHUNK; i-- > 0; ) {
+        pool_slot_t* slot = (pool_slot_t*)(chunk + (size_t)i * pool->stride);
+        slot->index = pool->chunk_count * POOL_CHUNK + i;
+        slot->generation = 1;
+        slot->in_use = false;
+        pthread_mutex_init((pthread_mutex_t*)((unsigned char*)object_of(slot) + pool->mutex_offset), NULL);
+        slot->next_free = pool->free_list;
+        pool->free_list = slot;
+    }
+    pool->chunks[pool->chunk_count++] = chunk;
+    pool->stats.capacity += POOL_CHUNK;
+    return DOP_SUCCESS;
+}
+
+int dop_object_pool_reserve(dop_object_pool_t* pool, uint32_t count) {
+    if (!pool) return DOP_ERROR_INVALID_PARAMETER;
+    pthread_mutex_lock(&pool->lock);
+    int result = DOP_SUCCESS;
+    while (result == DOP_SUCCESS && pool->stats.capacity - pool->stats.in_use < count) {
+        result = pool_grow(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return result;
+}
+
+void* dop_object_pool_acquire(dop_object_pool_t* pool) {
+    if (!pool) return NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (!pool->free_list && pool_grow(pool) != DOP_SUCCESS) {
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+    pool_slot_t* slot = pool->free_list;
+    pool->free_list = slot->next_free;
+    slot->in_use = true;
+    pool->stats.acquired++;
+    pool->stats.in_use++;
+    pthread_mutex_unlock(&pool->lock);
+
+    // Zero all but the mutex, which carries over from the last use
+    unsigned char* object = object_of(slot);
+    size_t mutex_end = pool->mutex_offset + sizeof(pthread_mutex_t);
+    memset(object, 0, pool->mutex_offset);
+    memset(object + mutex_end, 0, pool->object_size - mutex_end);
+    return object;
+}
+
+int dop_object_pool_release(dop_object_pool_t* pool, void* object) {
+    if (!pool || !object) return DOP_ERROR_INVALID_PARAMETER;
+
+    pool_slot_t* slot = slot_of(object);
+    pthread_mutex_lock(&pool->lock);
+    if (!slot->in_use) {
+        pthread_mutex_unlock(&pool->lock);
+        return DOP_ERROR_INVALID_STATE;     // Released twice
+    }
+    slot->in_use = false;
+    slot->generation = (slot->generation + 1) & POOL_GENERATION_MASK;
+    if (slot->generation == 0) slot->generation = 1;
+    slot->next_free = pool->free_list;
+    pool->free_list = slot;
+    pool->stats.released++;
+    pool->stats.in_use--;
+    pthread_mutex_unlock(&pool->lock);
+    return DOP_SUCCESS;
+}
+
+uint64_t dop_object_pool_handle(const dop_object_pool_t* pool, const void* object) {
+    if (!pool || !object) return 0;
+    const pool_slot_t* slot = slot_of(object);
+    return ((uint64_t)slot->generation << 32) | ((uint64_t)slot->index + 1);
+}
+
+void* dop_object_pool_resolve(dop_object_pool_t* pool, uint64_t handle) {
+    uint32_t index = (uint32_t)handle;
+    if (!pool || index == 0) return NULL;
+    index--;
+
+    pthread_mutex_lock(&pool->lock);
+    void* object = NULL;
+    if (index / POOL_CHUNK < pool->chunk_count) {
+        pool_slot_t* slot = (pool_slot_t*)(pool->chunks[index / POOL_CHUNK] +
+                                           (size_t)(index % POOL_CHUNK) * pool->stride);
+        if (slot->in_use && slot->generation == ((handle >> 32) & POOL_GENERATION_MASK)) {
+            object = object_of(slot);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return object;
+}
+
+void dop_object_pool_get_stats(dop_object_pool_t* pool, dop_pool_stats_t* stats) {
+    if (!pool || !stats) return;
+    pthread_mutex_lock(&pool->lock);
+    *stats = pool->stats;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Component pools, one per type
+static dop_object_pool_t* component_pools[DOP_COMPONENT_COUNT];
+static pthread_once_t component_pools_once = PTHREAD_ONCE_INIT;
+
+static void create_component_pools(void) {
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) {
+        component_pools[type] = dop_object_pool_create(sizeof(dop_component_t),
+                                                       offsetof(dop_component_t, metadata.mutex));
+    }
+}
+
+static dop_object_pool_t* component_pool(dop_component_type_t type) {
+    if ((unsigned)type >= DOP_COMPONENT_COUNT) return NULL;
+    pthread_once(&component_pools_once, create_component_pools);
+    return component_pools[type];
+}
+
+void dop_component_init_state(dop_component_t* component, dop_component_type_t type) {
+    static const char* const names[DOP_COMPONENT_COUNT] = {
+        [DOP_COMPONENT_ALARM] = "Alarm Component",
+        [DOP_COMPONENT_CLOCK] = "Clock Component",
+        [DOP_COMPONENT_STOPWATCH] = "Stopwatch Component",
+        [DOP_COMPONENT_TIMER] = "Timer Component"
+    };
+
+    // Initialize metadata
+    strcpy(component->metadata.component_name, names[type]);
+    strcpy(component->metadata.version, "1.0.0");
+    component->metadata.type = type;
+    component->metadata.state = DOP_STATE_READY;
+    component->metadata.gate_state = DOP_GATE_CLOSED;
+    component->metadata.creation_timestamp = (uint64_t)time(NULL) * 1000;
+    component->metadata.last_update_timestamp = component->metadata.creation_timestamp;
+
+    // Initialize component-specific data
+    switch (type) {
+        case DOP_COMPONENT_CLOCK:
+            component->data.clock.current_time = dop_time_get_current();
+            component->data.clock.is_running = true;
+            component->data.clock.is_24_hour_format = true;
+            break;
+        case DOP_COMPONENT_ALARM:
+            component->data.alarm.current_time = dop_time_get_current();
+            component->data.alarm.snooze_duration_ms = 300000; // 5 minutes
+            break;
+        default:
+            break;
+    }
+
+    component->checksum = dop_checksum_calculate(component);
+}
+
+dop_component_t* dop_func_create_component(dop_component_type_t type) {
+    dop_object_pool_t* pool = component_pool(type);
+    dop_component_t* component = dop_object_pool_acquire(pool);
+    if (!component) return NULL;
+
+    snprintf(component->metadata.component_id, sizeof(component->metadata.component_id),
+             "comp_%d_%llu", type, (unsigned long long)dop_object_pool_handle(pool, component));
+    dop_component_init_state(component, type);
+    return component;
+}
+
+int dop_func_destroy_component(dop_component_t* component) {
+    if (!component) return DOP_ERROR_INVALID_PARAMETER;
+    dop_object_pool_t* pool = component_pool(component->metadata.type);
+    if (!pool) return DOP_ERROR_INVALID_PARAMETER;
+
+    // Take it off the timer wheel before the slot can be reused
+    if (component->metadata.wheel_timer) {
+        if (component->metadata.type == DOP_COMPONENT_TIMER) {
+            dop_timer_stop(component);
+        } else if (component->metadata.type == DOP_COMPONENT_ALARM) {
+            dop_alarm_disarm(component);
+        }
+    }
+    component->metadata.state = DOP_STATE_DESTROYED;
+    return dop_object_pool_release(pool, component);
+}
+
+dop_component_handle_t dop_component_get_handle(const dop_component_t* component) {
+    if (!component) return 0;
+    dop_object_pool_t* pool = component_pool(component->metadata.type);
+    uint64_t handle = dop_object_pool_handle(pool, component);
+    return handle ? ((uint64_t)component->metadata.type << 56) | handle : 0;
+}
+
+dop_component_t* dop_component_from_handle(dop_component_handle_t handle) {
+    return dop_object_pool_resolve(component_pool((dop_component_type_t)(handle >> 56)),
+                                   handle & ((1ULL << 56) - 1));
+}
+
+int dop_component_pool_reserve(dop_component_type_t type, uint32_t count) {
+    dop_object_pool_t* pool = component_pool(type);
+    return pool ? dop_object_pool_reserve(pool, count) : DOP_ERROR_INVALID_PARAMETER;
+}
+
+void dop_component_pool_get_stats(dop_component_type_t type, dop_pool_stats_t* stats) {
+    dop_object_pool_get_stats(component_pool(type), stats);
+}
@@ -0,0 +1,91 @@
+// src/dop_core_runtime.c
+// Core gate, time, checksum and serialization calls declared by
+// obinexus_dop_core.h, after the reference implementation in
+// (isolated)/obinexus_dop_c_implementation.c
+
+#define _POSIX_C_SOURCE 200809L  // localtime_r
+
+#include "obinexus_dop_core.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+dop_time_data_t dop_time_get_current(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    time_t seconds = tv.tv_sec;
+    struct tm tm_info;
+    localtime_r(&seconds, &tm_info);
+
+    dop_time_data_t time_data = {
+        .timestamp_ms = (uint64_t)tv.tv_sec * 1000 + (uint64_t)tv.tv_usec / 1000,
+        .hours = (uint32_t)tm_info.tm_hour,
+        .minutes = (uint32_t)tm_info.tm_min,
+        .seconds = (uint32_t)tm_info.tm_sec,
+        .milliseconds = (uint32_t)(tv.tv_usec / 1000),
+        .is_valid = true
+    };
+    return time_data;
+}
+
+uint64_t dop_time_diff_ms(dop_time_data_t time1, dop_time_data_t time2) {
+    return time1.timestamp_ms > time2.timestamp_ms
+         ? time1.timestamp_ms - time2.timestamp_ms
+         : time2.timestamp_ms - time1.timestamp_ms;
+}
+
+// CRC-32 over the component data
+uint32_t dop_checksum_calculate(const dop_component_t* component) {
+    if (!component) return 0;
+
+    uint32_t checksum = 0xFFFFFFFF;
+    const uint8_t* data = (const uint8_t*)&component->data;
+    for (size_t i = 0; i < sizeof(dop_component_data_t); i++) {
+        checksum ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            checksum = (checksum & 1) ? (checksum >> 1) ^ 0xEDB88320 : checksum >> 1;
+        }
+    }
+    return ~checksum;
+}
+
+bool dop_checksum_verify(const dop_component_t* component) {
+    return component && component->checksum == dop_checksum_calculate(component);
+}
+
+// Gate state is read without the lock, by topology workers among others
+static int set_gate(dop_component_t* component, dop_gate_state_t state) {
+    if (!component) return DOP_ERROR_INVALID_PARAMETER;
+
+    pthread_mutex_lock(&component->metadata.mutex);
+    __atomic_store_n(&component->metadata.gate_state, state, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&component->metadata.mutex);
+    return DOP_SUCCESS;
+}
+
+int dop_gate_open(dop_component_t* component) {
+    return set_gate(component, DOP_GATE_OPEN);
+}
+
+int dop_gate_isolate(dop_component_t* component) {
+    return set_gate(component, DOP_GATE_ISOLATED);
+}
+
+bool dop_gate_is_accessible(const dop_component_t* component) {
+    if (!component) return false;
+    return __atomic_load_n(&component->metadata.gate_state, __ATOMIC_ACQUIRE) == DOP_GATE_OPEN;
+}
+
+char* dop_func_serialize_component(const dop_component_t* component) {
+    if (!component) return NULL;
+
+    char* text = malloc(256);
+    if (!text) return NULL;
+    snprintf(text, 256, "{\"id\":\"%s\",\"type\":%d,\"state\":%d,\"gate\":%d,\"checksum\":%u}",
+             component->metadata.component_id, (int)component->metadata.type,
+             (int)component->metadata.state, (int)component->metadata.gate_state,
+             component->checksum);
+    return text;
+}
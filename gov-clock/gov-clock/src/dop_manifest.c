@@ -2,147 +2,618 @@
 // OBINexus DOP XML Manifest Implementation
 // Corrected to match actual structure definitions
 
+#define _POSIX_C_SOURCE 200809L  // gmtime_r
 #include "dop_manifest.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// The writer builds the whole manifest in memory and hands it to the
+// kernel in one write, rather than a stdio call per element.
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool failed;        // An allocation failed; later appends are dropped
+} manifest_buffer_t;
+
+static void buffer_append(manifest_buffer_t* buffer, const char* text, size_t length) {
+    if (buffer->failed) return;
+    if (buffer->length + length > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 16384;
+        while (capacity < buffer->length + length) capacity *= 2;
+        char* data = realloc(buffer->data, capacity);
+        if (!data) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+}
+
+static void buffer_puts(manifest_buffer_t* buffer, const char* text) {
+    buffer_append(buffer, text, strlen(text));
+}
+
+// Append character data, escaping markup. Fields are fixed arrays, so stop
+// at max_length even without a terminator.
+static void buffer_put_escaped(manifest_buffer_t* buffer, const char* text, size_t max_length) {
+    size_t run = 0;
+    size_t i = 0;
+    for (; i < max_length && text[i]; i++) {
+        const char* entity;
+        switch (text[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&apos;"; break;
+            default: continue;
+        }
+        buffer_append(buffer, text + run, i - run);
+        buffer_puts(buffer, entity);
+        run = i + 1;
+    }
+    buffer_append(buffer, text + run, i - run);
+}
+
+static void buffer_put_element(manifest_buffer_t* buffer, const char* indent, const char* name,
+                               const char* value, size_t max_length) {
+    buffer_puts(buffer, indent);
+    buffer_puts(buffer, "<dop:");
+    buffer_puts(buffer, name);
+    buffer_puts(buffer, ">");
+    buffer_put_escaped(buffer, value, max_length);
+    buffer_puts(buffer, "</dop:");
+    buffer_puts(buffer, name);
+    buffer_puts(buffer, ">\n");
+}
+
+static int write_file(const char* path, const char* data, size_t length) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return DOP_ERROR_XML_PARSING;
+    
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return DOP_ERROR_XML_PARSING;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    
+    return close(fd) == 0 ? DOP_SUCCESS : DOP_ERROR_XML_PARSING;
+}
 
 int dop_manifest_save_to_xml(const dop_build_topology_t* topology, const char* xml_path) {
     if (!topology || !xml_path) return DOP_ERROR_INVALID_PARAMETER;
     
-    FILE* file = fopen(xml_path, "w");
-    if (!file) return DOP_ERROR_XML_PARSING;
+    manifest_buffer_t buffer = {0};
+    char number[32];
     
     // Write XML header and namespace declarations
-    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-    fprintf(file, "<dop:dop_manifest xmlns:dop=\"http://obinexus.org/dop/schema\"\n");
-    fprintf(file, "                  xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n");
-    fprintf(file, "                  xsi:schemaLocation=\"http://obinexus.org/dop/schema obinexus_dop_manifest.xsd\">\n\n");
-    
-    // Write manifest metadata
-    fprintf(file, "  <dop:manifest_metadata>\n");
-    fprintf(file, "    <dop:manifest_version>1.0.0</dop:manifest_version>\n");
-    fprintf(file, "    <dop:build_timestamp>2025-07-20T12:00:00Z</dop:build_timestamp>\n");
-    fprintf(file, "    <dop:target_name>%s</dop:target_name>\n", topology->build_id);
-    fprintf(file, "    <dop:build_system>makefile</dop:build_system>\n");
-    fprintf(file, "    <dop:validation_level>bidirectional</dop:validation_level>\n");
-    fprintf(file, "  </dop:manifest_metadata>\n\n");
+    buffer_puts(&buffer,
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<dop:dop_manifest xmlns:dop=\"http://obinexus.org/dop/schema\"\n"
+        "                  xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+        "                  xsi:schemaLocation=\"http://obinexus.org/dop/schema obinexus_dop_manifest.xsd\">\n\n");
+    
+    // Write manifest metadata, stamped with the time of the save
+    time_t now = time(NULL);
+    struct tm utc;
+    char timestamp[32] = "1970-01-01T00:00:00Z";
+    if (gmtime_r(&now, &utc)) {
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    }
+    buffer_puts(&buffer,
+        "  <dop:manifest_metadata>\n"
+        "    <dop:manifest_version>1.0.0</dop:manifest_version>\n");
+    buffer_put_element(&buffer, "    ", "build_timestamp", timestamp, sizeof(timestamp));
+    buffer_put_element(&buffer, "    ", "target_name", topology->build_id, sizeof(topology->build_id));
+    buffer_puts(&buffer,
+        "    <dop:build_system>makefile</dop:build_system>\n"
+        "    <dop:validation_level>bidirectional</dop:validation_level>\n"
+        "  </dop:manifest_metadata>\n\n");
     
     // Write build topology configuration
-    fprintf(file, "  <dop:build_topology>\n");
-    fprintf(file, "    <dop:topology_type>P2P</dop:topology_type>\n");
-    fprintf(file, "    <dop:fault_tolerance>%s</dop:fault_tolerance>\n", 
-            topology->is_fault_tolerant ? "true" : "false");
-    fprintf(file, "    <dop:p2p_enabled>%s</dop:p2p_enabled>\n", 
-            topology->is_p2p_enabled ? "true" : "false");
-    fprintf(file, "    <dop:max_nodes>%u</dop:max_nodes>\n", topology->node_count);
+    buffer_puts(&buffer,
+        "  <dop:build_topology>\n"
+        "    <dop:topology_type>P2P</dop:topology_type>\n");
+    buffer_puts(&buffer, topology->is_fault_tolerant
+        ? "    <dop:fault_tolerance>true</dop:fault_tolerance>\n"
+        : "    <dop:fault_tolerance>false</dop:fault_tolerance>\n");
+    buffer_puts(&buffer, topology->is_p2p_enabled
+        ? "    <dop:p2p_enabled>true</dop:p2p_enabled>\n"
+        : "    <dop:p2p_enabled>false</dop:p2p_enabled>\n");
+    snprintf(number, sizeof(number), "%u", topology->node_count);
+    buffer_put_element(&buffer, "    ", "max_nodes", number, sizeof(number));
     
     // Write nodes
-    fprintf(file, "    <dop:nodes>\n");
+    buffer_puts(&buffer, "    <dop:nodes>\n");
     for (uint32_t i = 0; i < topology->node_count; i++) {
         if (topology->nodes[i]) {
             dop_topology_node_t* node = topology->nodes[i];
-            fprintf(file, "      <dop:node>\n");
-            fprintf(file, "        <dop:node_id>%s</dop:node_id>\n", node->node_id);
+            buffer_puts(&buffer, "      <dop:node>\n");
+            buffer_put_element(&buffer, "        ", "node_id", node->node_id, sizeof(node->node_id));
             if (node->component) {
-                fprintf(file, "        <dop:component_ref>%s</dop:component_ref>\n", 
-                        node->component->metadata.component_id);
+                buffer_put_element(&buffer, "        ", "component_ref",
+                                   node->component->metadata.component_id,
+                                   sizeof(node->component->metadata.component_id));
             }
-            fprintf(file, "        <dop:is_fault_tolerant>%s</dop:is_fault_tolerant>\n",
-                    node->is_fault_tolerant ? "true" : "false");
+            buffer_puts(&buffer, node->is_fault_tolerant
+                ? "        <dop:is_fault_tolerant>true</dop:is_fault_tolerant>\n"
+                : "        <dop:is_fault_tolerant>false</dop:is_fault_tolerant>\n");
             // Use default load balancing weight since structure field doesn't exist
-            fprintf(file, "        <dop:load_balancing_weight>1.0</dop:load_balancing_weight>\n");
+            buffer_puts(&buffer, "        <dop:load_balancing_weight>1.0</dop:load_balancing_weight>\n");
             
             // Write peer connections if any exist
             if (node->peer_count > 0) {
-                fprintf(file, "        <dop:peer_connections>\n");
-                for (uint32_t j = 0; j < node->peer_count && j < 4; j++) {
+                buffer_puts(&buffer, "        <dop:peer_connections>\n");
+                for (uint32_t j = 0; j < node->peer_count; j++) {
                     if (node->peers[j]) {
-                        fprintf(file, "          <dop:peer>%s</dop:peer>\n", 
-                                node->peers[j]->node_id);
+                        buffer_put_element(&buffer, "          ", "peer", node->peers[j]->node_id,
+                                           sizeof(node->peers[j]->node_id));
                     }
                 }
-                fprintf(file, "        </dop:peer_connections>\n");
+                buffer_puts(&buffer, "        </dop:peer_connections>\n");
             }
             
-            fprintf(file, "      </dop:node>\n");
+            buffer_puts(&buffer, "      </dop:node>\n");
         }
     }
-    fprintf(file, "    </dop:nodes>\n");
-    fprintf(file, "  </dop:build_topology>\n\n");
+    buffer_puts(&buffer,
+        "    </dop:nodes>\n"
+        "  </dop:build_topology>\n\n");
     
     // Write component validation
-    fprintf(file, "  <dop:component_validation>\n");
-    fprintf(file, "    <dop:dop_principles_enforced>true</dop:dop_principles_enforced>\n");
-    fprintf(file, "    <dop:immutability_verified>true</dop:immutability_verified>\n");
-    fprintf(file, "    <dop:data_logic_separation_verified>true</dop:data_logic_separation_verified>\n");
-    fprintf(file, "    <dop:transparency_verified>true</dop:transparency_verified>\n");
-    fprintf(file, "    <dop:isolation_boundaries>\n");
-    fprintf(file, "      <dop:memory_isolation>true</dop:memory_isolation>\n");
-    fprintf(file, "      <dop:process_isolation>true</dop:process_isolation>\n");
-    fprintf(file, "      <dop:network_isolation>false</dop:network_isolation>\n");
-    fprintf(file, "      <dop:file_system_isolation>false</dop:file_system_isolation>\n");
-    fprintf(file, "    </dop:isolation_boundaries>\n");
-    fprintf(file, "  </dop:component_validation>\n\n");
+    buffer_puts(&buffer,
+        "  <dop:component_validation>\n"
+        "    <dop:dop_principles_enforced>true</dop:dop_principles_enforced>\n"
+        "    <dop:immutability_verified>true</dop:immutability_verified>\n"
+        "    <dop:data_logic_separation_verified>true</dop:data_logic_separation_verified>\n"
+        "    <dop:transparency_verified>true</dop:transparency_verified>\n"
+        "    <dop:isolation_boundaries>\n"
+        "      <dop:memory_isolation>true</dop:memory_isolation>\n"
+        "      <dop:process_isolation>true</dop:process_isolation>\n"
+        "      <dop:network_isolation>false</dop:network_isolation>\n"
+        "      <dop:file_system_isolation>false</dop:file_system_isolation>\n"
+        "    </dop:isolation_boundaries>\n"
+        "  </dop:component_validation>\n\n");
     
     // Write cryptographic verification section
-    fprintf(file, "  <dop:cryptographic_verification>\n");
-    fprintf(file, "    <dop:integrity_algorithm>SHA256</dop:integrity_algorithm>\n");
-    fprintf(file, "    <dop:signature_algorithm>RSA_PSS</dop:signature_algorithm>\n");
-    fprintf(file, "    <dop:verification_chain>\n");
-    fprintf(file, "      <dop:verification_step>\n");
-    fprintf(file, "        <dop:step_name>topology_integrity</dop:step_name>\n");
-    fprintf(file, "        <dop:verification_method>node_validation</dop:verification_method>\n");
-    fprintf(file, "        <dop:expected_result>pass</dop:expected_result>\n");
-    fprintf(file, "      </dop:verification_step>\n");
-    fprintf(file, "    </dop:verification_chain>\n");
-    fprintf(file, "  </dop:cryptographic_verification>\n\n");
-    
-    fprintf(file, "</dop:dop_manifest>\n");
+    buffer_puts(&buffer,
+        "  <dop:cryptographic_verification>\n"
+        "    <dop:integrity_algorithm>SHA256</dop:integrity_algorithm>\n"
+        "    <dop:signature_algorithm>RSA_PSS</dop:signature_algorithm>\n"
+        "    <dop:verification_chain>\n"
+        "      <dop:verification_step>\n"
+        "        <dop:step_name>topology_integrity</dop:step_name>\n"
+        "        <dop:verification_method>node_validation</dop:verification_method>\n"
+        "        <dop:expected_result>pass</dop:expected_result>\n"
+        "      </dop:verification_step>\n"
+        "    </dop:verification_chain>\n"
+        "  </dop:cryptographic_verification>\n\n"
+        "</dop:dop_manifest>\n");
     
-    fclose(file);
-    return DOP_SUCCESS;
+    int result = buffer.failed ? DOP_ERROR_MEMORY_ALLOCATION
+                               : write_file(xml_path, buffer.data, buffer.length);
+    
+    // Generate the binary manifest alongside; loaders fall back to the XML
+    // if this fails
+    char bin_path[4096];
+    if (result == DOP_SUCCESS &&
+        (size_t)snprintf(bin_path, sizeof(bin_path), "%s%s", xml_path, DOP_MANIFEST_BINARY_SUFFIX)
+            < sizeof(bin_path)) {
+        dop_manifest_save_binary(topology, bin_path, dop_manifest_hash_bytes(buffer.data, buffer.length));
+    }
+    free(buffer.data);
+    return result;
 }
 
-int dop_manifest_load_from_xml(const char* xml_path, dop_build_topology_t* topology) {
-    if (!xml_path || !topology) return DOP_ERROR_INVALID_PARAMETER;
+// Pull parser for the loader. The file streams through a fixed buffer and
+// the caller asks for one event at a time; only the current tag's local
+// name and a bounded text run are kept, so memory does not grow with the
+// manifest. Attributes are skipped, as are declarations, comments and
+// CDATA sections.
+#define MANIFEST_READ_CHUNK 65536
+#define MANIFEST_NAME_MAX 64
+#define MANIFEST_TEXT_MAX 256
+
+typedef enum {
+    MANIFEST_EVENT_START,
+    MANIFEST_EVENT_END,
+    MANIFEST_EVENT_TEXT,
+    MANIFEST_EVENT_EOF,
+    MANIFEST_EVENT_ERROR
+} manifest_event_t;
+
+typedef struct {
+    int fd;
+    size_t position;
+    size_t length;
+    bool in_tag;                    // The '<' ending the last text run was consumed
+    bool pending_end;               // An empty element still owes its end event
+    bool io_error;
+    char name[MANIFEST_NAME_MAX];   // Local name of the last tag, prefix stripped
+    char text[MANIFEST_TEXT_MAX];
+    size_t text_length;
+    bool text_truncated;
+    char buffer[MANIFEST_READ_CHUNK];
+} manifest_reader_t;
+
+static int reader_getc(manifest_reader_t* reader) {
+    if (reader->position == reader->length) {
+        ssize_t count;
+        do {
+            count = read(reader->fd, reader->buffer, sizeof(reader->buffer));
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0) {
+            reader->io_error = count < 0;
+            return EOF;
+        }
+        reader->position = 0;
+        reader->length = (size_t)count;
+    }
+    return (unsigned char)reader->buffer[reader->position++];
+}
+
+static bool is_xml_space(int c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Consume input through the terminator (at most 3 characters)
+static bool reader_skip_past(manifest_reader_t* reader, const char* terminator) {
+    size_t length = strlen(terminator);
+    char window[3] = {0};
+    size_t seen = 0;
+    int c;
+    while ((c = reader_getc(reader)) != EOF) {
+        memmove(window, window + 1, length - 1);
+        window[length - 1] = (char)c;
+        if (++seen >= length && memcmp(window, terminator, length) == 0) return true;
+    }
+    return false;
+}
+
+// Read a tag name starting with c; returns the character after it
+static int reader_read_name(manifest_reader_t* reader, int c) {
+    size_t length = 0;
+    while (c != EOF && c != '/' && c != '>' && !is_xml_space(c)) {
+        if (c == ':') {
+            length = 0;     // Keep the local name only
+        } else if (length < MANIFEST_NAME_MAX - 1) {
+            reader->name[length++] = (char)c;
+        }
+        c = reader_getc(reader);
+    }
+    reader->name[length] = '\0';
+    return c;
+}
+
+static manifest_event_t reader_next(manifest_reader_t* reader) {
+    if (reader->pending_end) {
+        reader->pending_end = false;
+        return MANIFEST_EVENT_END;
+    }
     
-    FILE* file = fopen(xml_path, "r");
-    if (!file) return DOP_ERROR_XML_PARSING;
+    for (;;) {
+        int c;
+        if (!reader->in_tag) {
+            bool blank = true;
+            reader->text_length = 0;
+            reader->text_truncated = false;
+            while ((c = reader_getc(reader)) != EOF && c != '<') {
+                if (!is_xml_space(c)) blank = false;
+                if (reader->text_length < MANIFEST_TEXT_MAX - 1) {
+                    reader->text[reader->text_length++] = (char)c;
+                } else {
+                    reader->text_truncated = true;
+                }
+            }
+            if (c == EOF) return reader->io_error ? MANIFEST_EVENT_ERROR : MANIFEST_EVENT_EOF;
+            reader->in_tag = true;
+            if (!blank) {
+                reader->text[reader->text_length] = '\0';
+                return MANIFEST_EVENT_TEXT;
+            }
+        }
+        
+        reader->in_tag = false;
+        c = reader_getc(reader);
+        if (c == '?') {
+            if (!reader_skip_past(reader, "?>")) return MANIFEST_EVENT_ERROR;
+            continue;
+        }
+        if (c == '!') {
+            c = reader_getc(reader);
+            const char* terminator = c == '-' ? "-->" : c == '[' ? "]]>" : ">";
+            if (c == '>') continue;
+            if (!reader_skip_past(reader, terminator)) return MANIFEST_EVENT_ERROR;
+            continue;
+        }
+        
+        bool end = c == '/';
+        if (end) c = reader_getc(reader);
+        c = reader_read_name(reader, c);
+        if (reader->name[0] == '\0') return MANIFEST_EVENT_ERROR;
+        
+        // Skip attributes; a quoted value may contain '>'
+        int quote = 0;
+        int last = 0;
+        while (c != '>' || quote) {
+            if (c == EOF) return MANIFEST_EVENT_ERROR;
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            }
+            last = c;
+            c = reader_getc(reader);
+        }
+        if (end) return MANIFEST_EVENT_END;
+        reader->pending_end = last == '/';
+        return MANIFEST_EVENT_START;
+    }
+}
+
+// Trim the text run and decode the predefined and ASCII character
+// references in place; returns NULL if the run did not fit
+static const char* reader_text(manifest_reader_t* reader) {
+    if (reader->text_truncated) return NULL;
     
-    // Simplified XML parsing for demonstration
-    char line[512];
-    bool found_build_id = false;
+    char* text = reader->text;
+    size_t end = reader->text_length;
+    size_t start = 0;
+    while (start < end && is_xml_space(text[start])) start++;
+    while (end > start && is_xml_space(text[end - 1])) end--;
     
-    while (fgets(line, sizeof(line), file)) {
-        // Parse build ID
-        if (strstr(line, "<dop:target_name>")) {
-            char* start = strstr(line, ">") + 1;
-            char* end = strstr(start, "<");
-            if (start && end) {
-                size_t len = end - start;
-                if (len < sizeof(topology->build_id)) {
-                    strncpy(topology->build_id, start, len);
-                    topology->build_id[len] = '\0';
-                    found_build_id = true;
+    static const struct { const char* name; char value; } entities[] = {
+        {"lt;", '<'}, {"gt;", '>'}, {"amp;", '&'}, {"quot;", '"'}, {"apos;", '\''}
+    };
+    size_t out = 0;
+    for (size_t i = start; i < end; ) {
+        if (text[i] == '&') {
+            bool decoded = false;
+            for (size_t e = 0; e < sizeof(entities) / sizeof(entities[0]); e++) {
+                size_t length = strlen(entities[e].name);
+                if (i + 1 + length <= end && memcmp(text + i + 1, entities[e].name, length) == 0) {
+                    text[out++] = entities[e].value;
+                    i += 1 + length;
+                    decoded = true;
+                    break;
+                }
+            }
+            if (!decoded && i + 2 < end && text[i + 1] == '#') {
+                bool hex = text[i + 2] == 'x';
+                size_t j = i + (hex ? 3 : 2);
+                unsigned long value = 0;
+                size_t digits = 0;
+                for (; j < end && text[j] != ';' && digits < 8; j++, digits++) {
+                    int digit = text[j] >= '0' && text[j] <= '9' ? text[j] - '0'
+                              : hex && text[j] >= 'a' && text[j] <= 'f' ? text[j] - 'a' + 10
+                              : hex && text[j] >= 'A' && text[j] <= 'F' ? text[j] - 'A' + 10 : -1;
+                    if (digit < 0) break;
+                    value = value * (hex ? 16 : 10) + (unsigned long)digit;
+                }
+                if (digits > 0 && j < end && text[j] == ';' && value > 0 && value < 0x80) {
+                    text[out++] = (char)value;
+                    i = j + 1;
+                    decoded = true;
                 }
             }
+            if (decoded) continue;
         }
-        
-        // Parse P2P enabled flag
-        if (strstr(line, "<dop:p2p_enabled>true</dop:p2p_enabled>")) {
-            topology->is_p2p_enabled = true;
+        text[out++] = text[i++];
+    }
+    text[out] = '\0';
+    return text;
+}
+
+static bool copy_text(manifest_reader_t* reader, char* field, size_t size) {
+    const char* text = reader_text(reader);
+    if (!text || strlen(text) >= size) return false;
+    strcpy(field, text);
+    return true;
+}
+
+static bool text_is_true(manifest_reader_t* reader) {
+    const char* text = reader_text(reader);
+    return text && (strcmp(text, "true") == 0 || strcmp(text, "1") == 0);
+}
+
+// A <dop:peer> seen while loading; linked once every node exists
+typedef struct {
+    uint32_t node;
+    char peer_id[64];
+} manifest_peer_ref_t;
+
+static uint32_t node_id_hash(const char* node_id) {
+    uint32_t hash = 2166136261u;
+    for (; *node_id; node_id++) {
+        hash = (hash ^ (uint8_t)*node_id) * 16777619u;
+    }
+    return hash;
+}
+
+// Connect the loaded nodes to their peers, looking ids up in a hash table
+// over all the topology's nodes
+static int link_peers(dop_build_topology_t* topology, const manifest_peer_ref_t* refs, size_t ref_count) {
+    if (ref_count == 0) return DOP_SUCCESS;
+    
+    uint32_t capacity = 16;
+    while (capacity < topology->node_count * 2) capacity *= 2;
+    dop_topology_node_t** table = calloc(capacity, sizeof(dop_topology_node_t*));
+    if (!table) return DOP_ERROR_MEMORY_ALLOCATION;
+    for (uint32_t i = 0; i < topology->node_count; i++) {
+        uint32_t slot = node_id_hash(topology->nodes[i]->node_id) & (capacity - 1);
+        while (table[slot]) slot = (slot + 1) & (capacity - 1);
+        table[slot] = topology->nodes[i];
+    }
+    
+    int result = DOP_SUCCESS;
+    for (size_t i = 0; i < ref_count && result == DOP_SUCCESS; i++) {
+        dop_topology_node_t* peer = NULL;
+        uint32_t slot = node_id_hash(refs[i].peer_id) & (capacity - 1);
+        for (; table[slot]; slot = (slot + 1) & (capacity - 1)) {
+            if (strcmp(table[slot]->node_id, refs[i].peer_id) == 0) {
+                peer = table[slot];
+                break;
+            }
         }
+        result = peer ? dop_topology_add_peer(topology->nodes[refs[i].node], peer)
+                      : DOP_ERROR_TOPOLOGY_FAULT;
+    }
+    
+    free(table);
+    return result;
+}
+
+static int manifest_load(const char* xml_path, dop_build_topology_t* topology,
+                         dop_manifest_component_resolver_t resolve, void* user_data) {
+    manifest_reader_t* reader = malloc(sizeof(manifest_reader_t));
+    if (!reader) return DOP_ERROR_MEMORY_ALLOCATION;
+    reader->fd = open(xml_path, O_RDONLY);
+    if (reader->fd < 0) {
+        free(reader);
+        return DOP_ERROR_XML_PARSING;
+    }
+    reader->position = reader->length = 0;
+    reader->in_tag = reader->pending_end = reader->io_error = false;
+    
+    uint32_t first_node = topology->node_count;
+    manifest_peer_ref_t* refs = NULL;
+    size_t ref_count = 0;
+    size_t ref_capacity = 0;
+    
+    // The node being read
+    bool in_node = false;
+    char node_id[64];
+    char component_ref[64];
+    bool node_fault_tolerant = true;
+    
+    bool found_build_id = false;
+    bool in_element = false;        // Text belongs to reader->name
+    uint32_t depth = 0;
+    int result = DOP_SUCCESS;
+    
+    while (result == DOP_SUCCESS) {
+        manifest_event_t event = reader_next(reader);
+        if (event == MANIFEST_EVENT_EOF) {
+            if (depth != 0) result = DOP_ERROR_XML_PARSING;
+            break;
+        }
+        if (event == MANIFEST_EVENT_ERROR) {
+            result = DOP_ERROR_XML_PARSING;
+            break;
+        }
+        const char* name = reader->name;
         
-        // Parse fault tolerance flag
-        if (strstr(line, "<dop:fault_tolerance>true</dop:fault_tolerance>")) {
-            topology->is_fault_tolerant = true;
+        if (event == MANIFEST_EVENT_START) {
+            depth++;
+            in_element = true;
+            if (resolve && strcmp(name, "node") == 0) {
+                in_node = true;
+                node_id[0] = component_ref[0] = '\0';
+                node_fault_tolerant = true;
+            }
+        } else if (event == MANIFEST_EVENT_END) {
+            if (depth == 0) {
+                result = DOP_ERROR_XML_PARSING;
+                break;
+            }
+            depth--;
+            in_element = false;
+            if (in_node && strcmp(name, "node") == 0) {
+                in_node = false;
+                if (!node_id[0]) {
+                    result = DOP_ERROR_XML_PARSING;
+                    break;
+                }
+                dop_component_t* component = resolve(component_ref, user_data);
+                dop_topology_node_t* node = component ? dop_topology_create_node(node_id, component) : NULL;
+                if (!node) {
+                    result = component ? DOP_ERROR_MEMORY_ALLOCATION : DOP_ERROR_TOPOLOGY_FAULT;
+                    break;
+                }
+                node->is_fault_tolerant = node_fault_tolerant;
+                result = dop_topology_add_node(topology, node);
+                if (result != DOP_SUCCESS) dop_topology_destroy_node(node);
+            }
+        } else if (in_element) {
+            bool ok = true;
+            if (in_node) {
+                if (strcmp(name, "node_id") == 0) {
+                    ok = copy_text(reader, node_id, sizeof(node_id));
+                } else if (strcmp(name, "component_ref") == 0) {
+                    ok = copy_text(reader, component_ref, sizeof(component_ref));
+                } else if (strcmp(name, "is_fault_tolerant") == 0) {
+                    node_fault_tolerant = text_is_true(reader);
+                } else if (strcmp(name, "peer") == 0) {
+                    if (ref_count == ref_capacity) {
+                        size_t capacity = ref_capacity ? ref_capacity * 2 : 64;
+                        manifest_peer_ref_t* grown = realloc(refs, capacity * sizeof(manifest_peer_ref_t));
+                        if (!grown) {
+                            result = DOP_ERROR_MEMORY_ALLOCATION;
+                            break;
+                        }
+                        refs = grown;
+                        ref_capacity = capacity;
+                    }
+                    refs[ref_count].node = topology->node_count;  // Index the node will get
+                    ok = copy_text(reader, refs[ref_count].peer_id, sizeof(refs[ref_count].peer_id));
+                    ref_count++;
+                }
+            } else if (strcmp(name, "target_name") == 0 || strcmp(name, "build_id") == 0) {
+                ok = copy_text(reader, topology->build_id, sizeof(topology->build_id));
+                found_build_id = ok;
+            } else if (strcmp(name, "p2p_enabled") == 0) {
+                topology->is_p2p_enabled = text_is_true(reader);
+            } else if (strcmp(name, "fault_tolerance") == 0) {
+                topology->is_fault_tolerant = text_is_true(reader);
+            }
+            if (!ok) result = DOP_ERROR_XML_PARSING;
         }
     }
     
-    fclose(file);
+    close(reader->fd);
+    free(reader);
+    
+    if (result == DOP_SUCCESS && !found_build_id) result = DOP_ERROR_XML_PARSING;
+    if (result == DOP_SUCCESS) result = link_peers(topology, refs, ref_count);
+    free(refs);
+    
+    if (result != DOP_SUCCESS) {
+        for (uint32_t i = first_node; i < topology->node_count; i++) {
+            dop_topology_destroy_node(topology->nodes[i]);
+        }
+        topology->node_count = first_node;
+    }
+    return result;
+}
+
+int dop_manifest_load_from_xml(const char* xml_path, dop_build_topology_t* topology) {
+    if (!xml_path || !topology) return DOP_ERROR_INVALID_PARAMETER;
     
-    return found_build_id ? DOP_SUCCESS : DOP_ERROR_XML_PARSING;
+    // Build settings only; nodes need a resolver for their components
+    return manifest_load(xml_path, topology, NULL, NULL);
+}
+
+int dop_manifest_load_topology_from_xml(const char* xml_path, dop_build_topology_t* topology,
+                                        dop_manifest_component_resolver_t resolve, void* user_data) {
+    if (!xml_path || !topology || !resolve) return DOP_ERROR_INVALID_PARAMETER;
+    if (topology->node_count > 0 && topology->nodes[0]->mailbox) {
+        return DOP_ERROR_INVALID_STATE;  // Workers are running over the node array
+    }
+    return manifest_load(xml_path, topology, resolve, user_data);
 }
 
 int dop_manifest_validate_schema(const char* xml_path) {
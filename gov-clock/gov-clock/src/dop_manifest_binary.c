@@ -0,0 +1,353 @@
+// src/dop_manifest_binary.c
+// OBINexus DOP Binary Manifest Implementation
+//
+// Layout, all offsets from the start of the file:
+//   header
+//   node records[node_count]
+//   peer node indices[peer_total]
+//   string table: NUL-terminated strings referenced by offset
+
+#define _POSIX_C_SOURCE 200809L  // strnlen
+#include "dop_manifest.h"
+#include "dop_topology.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MANIFEST_BINARY_MAGIC "DOPM"
+#define MANIFEST_BYTE_ORDER 0x01020304u
+#define MANIFEST_FLAG_P2P 1u
+#define MANIFEST_FLAG_FAULT_TOLERANT 2u
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;        // MANIFEST_BYTE_ORDER as written
+    uint32_t flags;
+    uint64_t source_hash;       // Hash of the XML this was generated from
+    uint32_t build_id;          // String offset
+    uint32_t node_count;
+    uint32_t nodes_offset;
+    uint32_t peer_total;
+    uint32_t peers_offset;
+    uint32_t strings_offset;
+    uint32_t strings_size;
+    uint32_t reserved;
+} manifest_binary_header_t;
+
+typedef struct {
+    uint32_t node_id;           // String offset
+    uint32_t component_ref;     // String offset; "" for no component
+    uint32_t first_peer;        // Index into the peer array
+    uint32_t peer_count;
+    uint32_t flags;
+} manifest_binary_node_t;
+
+uint64_t dop_manifest_hash_bytes(const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+int dop_manifest_hash_file(const char* path, uint64_t* hash) {
+    if (!path || !hash) return DOP_ERROR_INVALID_PARAMETER;
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return DOP_ERROR_XML_PARSING;
+    
+    // FNV-1a carries no state beyond the running hash, so chunks chain
+    unsigned char chunk[65536];
+    uint64_t value = 14695981039346656037ULL;
+    ssize_t count;
+    while ((count = read(fd, chunk, sizeof(chunk))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return DOP_ERROR_XML_PARSING;
+        }
+        for (ssize_t i = 0; i < count; i++) {
+            value = (value ^ chunk[i]) * 1099511628211ULL;
+        }
+    }
+    close(fd);
+    
+    *hash = value;
+    return DOP_SUCCESS;
+}
+
+static uint32_t node_slot(const dop_topology_node_t* node, uint32_t capacity) {
+    uint64_t key = (uint64_t)(uintptr_t)node;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key & (capacity - 1);
+}
+
+static uint32_t append_string(char* strings, uint32_t* used, const char* text, size_t max_length) {
+    uint32_t offset = *used;
+    size_t length = strnlen(text, max_length - 1);
+    memcpy(strings + offset, text, length);
+    strings[offset + length] = '\0';
+    *used += (uint32_t)length + 1;
+    return offset;
+}
+
+int dop_manifest_save_binary(const dop_build_topology_t* topology, const char* bin_path, uint64_t source_hash) {
+    if (!topology || !bin_path) return DOP_ERROR_INVALID_PARAMETER;
+    
+    // Size everything first so the image is one allocation
+    uint32_t node_count = topology->node_count;
+    size_t peer_total = 0;
+    size_t strings_size = strnlen(topology->build_id, sizeof(topology->build_id) - 1) + 1;
+    for (uint32_t i = 0; i < node_count; i++) {
+        const dop_topology_node_t* node = topology->nodes[i];
+        if (!node) return DOP_ERROR_INVALID_STATE;
+        peer_total += node->peer_count;
+        strings_size += strnlen(node->node_id, sizeof(node->node_id) - 1) + 1;
+        strings_size += node->component
+            ? strnlen(node->component->metadata.component_id,
+                      sizeof(node->component->metadata.component_id) - 1) + 1
+            : 1;
+    }
+    
+    size_t nodes_offset = sizeof(manifest_binary_header_t);
+    size_t peers_offset = nodes_offset + (size_t)node_count * sizeof(manifest_binary_node_t);
+    size_t strings_offset = peers_offset + peer_total * sizeof(uint32_t);
+    size_t total = strings_offset + strings_size;
+    if (total > UINT32_MAX) return DOP_ERROR_INVALID_PARAMETER;
+    
+    char* image = calloc(1, total);
+    uint32_t capacity = 16;
+    while (capacity < node_count * 2) capacity *= 2;
+    const dop_topology_node_t** index = calloc(capacity, sizeof(dop_topology_node_t*));
+    uint32_t* positions = calloc(capacity, sizeof(uint32_t));
+    if (!image || !index || !positions) {
+        free(image);
+        free(index);
+        free(positions);
+        return DOP_ERROR_MEMORY_ALLOCATION;
+    }
+    
+    // Peers are stored as node indices; find them through a pointer table
+    for (uint32_t i = 0; i < node_count; i++) {
+        uint32_t slot = node_slot(topology->nodes[i], capacity);
+        while (index[slot]) slot = (slot + 1) & (capacity - 1);
+        index[slot] = topology->nodes[i];
+        positions[slot] = i;
+    }
+    
+    manifest_binary_header_t* header = (manifest_binary_header_t*)image;
+    manifest_binary_node_t* records = (manifest_binary_node_t*)(image + nodes_offset);
+    uint32_t* peers = (uint32_t*)(image + peers_offset);
+    char* strings = image + strings_offset;
+    uint32_t strings_used = 0;
+    uint32_t peers_used = 0;
+    int result = DOP_SUCCESS;
+    
+    memcpy(header->magic, MANIFEST_BINARY_MAGIC, sizeof(header->magic));
+    header->version = DOP_MANIFEST_BINARY_VERSION;
+    header->byte_order = MANIFEST_BYTE_ORDER;
+    header->flags = (topology->is_p2p_enabled ? MANIFEST_FLAG_P2P : 0) |
+                    (topology->is_fault_tolerant ? MANIFEST_FLAG_FAULT_TOLERANT : 0);
+    header->source_hash = source_hash;
+    header->build_id = append_string(strings, &strings_used, topology->build_id, sizeof(topology->build_id));
+    header->node_count = node_count;
+    header->nodes_offset = (uint32_t)nodes_offset;
+    header->peer_total = (uint32_t)peer_total;
+    header->peers_offset = (uint32_t)peers_offset;
+    header->strings_offset = (uint32_t)strings_offset;
+    header->strings_size = (uint32_t)strings_size;
+    
+    for (uint32_t i = 0; i < node_count && result == DOP_SUCCESS; i++) {
+        const dop_topology_node_t* node = topology->nodes[i];
+        records[i].node_id = append_string(strings, &strings_used, node->node_id, sizeof(node->node_id));
+        records[i].component_ref = node->component
+            ? append_string(strings, &strings_used, node->component->metadata.component_id,
+                            sizeof(node->component->metadata.component_id))
+            : append_string(strings, &strings_used, "", 1);
+        records[i].first_peer = peers_used;
+        records[i].peer_count = node->peer_count;
+        records[i].flags = node->is_fault_tolerant ? MANIFEST_FLAG_FAULT_TOLERANT : 0;
+        
+        for (uint32_t j = 0; j < node->peer_count; j++) {
+            uint32_t slot = node_slot(node->peers[j], capacity);
+            while (index[slot] && index[slot] != node->peers[j]) slot = (slot + 1) & (capacity - 1);
+            if (!index[slot]) {
+                result = DOP_ERROR_TOPOLOGY_FAULT;  // Peer outside the topology
+                break;
+            }
+            peers[peers_used++] = positions[slot];
+        }
+    }
+    free(index);
+    free(positions);
+    
+    // Replace the file atomically so a concurrent loader never maps a
+    // half-written image
+    char temp_path[4096];
+    if (result == DOP_SUCCESS &&
+        (size_t)snprintf(temp_path, sizeof(temp_path), "%s.tmp", bin_path) >= sizeof(temp_path)) {
+        result = DOP_ERROR_INVALID_PARAMETER;
+    }
+    if (result == DOP_SUCCESS) {
+        int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            result = DOP_ERROR_INVALID_STATE;
+        } else {
+            const char* data = image;
+            size_t remaining = total;
+            while (remaining > 0) {
+                ssize_t written = write(fd, data, remaining);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                data += written;
+                remaining -= (size_t)written;
+            }
+            if (close(fd) != 0 || remaining > 0 || rename(temp_path, bin_path) != 0) {
+                unlink(temp_path);
+                result = DOP_ERROR_INVALID_STATE;
+            }
+        }
+    }
+    
+    free(image);
+    return result;
+}
+
+// The string at offset, or NULL if it is not terminated inside the table
+static const char* image_string(const char* strings, uint32_t size, uint32_t offset) {
+    if (offset >= size || !memchr(strings + offset, '\0', size - offset)) return NULL;
+    return strings + offset;
+}
+
+int dop_manifest_load_binary(const char* bin_path, uint64_t source_hash, dop_build_topology_t* topology,
+                             dop_manifest_component_resolver_t resolve, void* user_data) {
+    if (!bin_path || !topology || !resolve) return DOP_ERROR_INVALID_PARAMETER;
+    if (topology->node_count > 0 && topology->nodes[0]->mailbox) {
+        return DOP_ERROR_INVALID_STATE;  // Workers are running over the node array
+    }
+    
+    int fd = open(bin_path, O_RDONLY);
+    if (fd < 0) return DOP_ERROR_INVALID_STATE;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(manifest_binary_header_t)) {
+        close(fd);
+        return DOP_ERROR_XML_PARSING;
+    }
+    size_t size = (size_t)info.st_size;
+    const char* image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) return DOP_ERROR_INVALID_STATE;
+    
+    // Check the header and that every section lies inside the file
+    const manifest_binary_header_t* header = (const manifest_binary_header_t*)image;
+    int result = DOP_SUCCESS;
+    if (memcmp(header->magic, MANIFEST_BINARY_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DOP_MANIFEST_BINARY_VERSION ||
+        header->byte_order != MANIFEST_BYTE_ORDER) {
+        result = DOP_ERROR_XML_PARSING;
+    } else if (header->source_hash != source_hash) {
+        result = DOP_ERROR_CHECKSUM_FAILED;
+    } else if (header->nodes_offset % sizeof(uint32_t) || header->peers_offset % sizeof(uint32_t) ||
+               header->nodes_offset > size ||
+               (size - header->nodes_offset) / sizeof(manifest_binary_node_t) < header->node_count ||
+               header->peers_offset > size ||
+               (size - header->peers_offset) / sizeof(uint32_t) < header->peer_total ||
+               header->strings_offset > size || size - header->strings_offset < header->strings_size) {
+        result = DOP_ERROR_XML_PARSING;
+    }
+    
+    const manifest_binary_node_t* records = (const manifest_binary_node_t*)(image + header->nodes_offset);
+    const uint32_t* peers = (const uint32_t*)(image + header->peers_offset);
+    const char* strings = image + header->strings_offset;
+    const char* build_id = NULL;
+    if (result == DOP_SUCCESS) {
+        build_id = image_string(strings, header->strings_size, header->build_id);
+        if (!build_id || strlen(build_id) >= sizeof(topology->build_id)) result = DOP_ERROR_XML_PARSING;
+    }
+    
+    uint32_t first_node = topology->node_count;
+    for (uint32_t i = 0; i < header->node_count && result == DOP_SUCCESS; i++) {
+        const char* node_id = image_string(strings, header->strings_size, records[i].node_id);
+        const char* component_ref = image_string(strings, header->strings_size, records[i].component_ref);
+        if (!node_id || !component_ref || records[i].first_peer > header->peer_total ||
+            header->peer_total - records[i].first_peer < records[i].peer_count) {
+            result = DOP_ERROR_XML_PARSING;
+            break;
+        }
+        dop_component_t* component = resolve(component_ref, user_data);
+        dop_topology_node_t* node = component ? dop_topology_create_node(node_id, component) : NULL;
+        if (!node) {
+            result = component ? DOP_ERROR_MEMORY_ALLOCATION : DOP_ERROR_TOPOLOGY_FAULT;
+            break;
+        }
+        node->is_fault_tolerant = (records[i].flags & MANIFEST_FLAG_FAULT_TOLERANT) != 0;
+        result = dop_topology_add_node(topology, node);
+        if (result != DOP_SUCCESS) dop_topology_destroy_node(node);
+    }
+    
+    for (uint32_t i = 0; i < header->node_count && result == DOP_SUCCESS; i++) {
+        dop_topology_node_t* node = topology->nodes[first_node + i];
+        for (uint32_t j = 0; j < records[i].peer_count && result == DOP_SUCCESS; j++) {
+            uint32_t peer = peers[records[i].first_peer + j];
+            result = peer < header->node_count
+                ? dop_topology_add_peer(node, topology->nodes[first_node + peer])
+                : DOP_ERROR_XML_PARSING;
+        }
+    }
+    
+    if (result == DOP_SUCCESS) {
+        strcpy(topology->build_id, build_id);
+        topology->is_p2p_enabled = (header->flags & MANIFEST_FLAG_P2P) != 0;
+        topology->is_fault_tolerant = (header->flags & MANIFEST_FLAG_FAULT_TOLERANT) != 0;
+    } else {
+        for (uint32_t i = first_node; i < topology->node_count; i++) {
+            dop_topology_destroy_node(topology->nodes[i]);
+        }
+        topology->node_count = first_node;
+    }
+    
+    munmap((void*)image, size);
+    return result;
+}
+
+int dop_manifest_load_cached(const char* xml_path, dop_build_topology_t* topology,
+                             dop_manifest_component_resolver_t resolve, void* user_data) {
+    if (!xml_path || !topology || !resolve) return DOP_ERROR_INVALID_PARAMETER;
+    
+    char bin_path[4096];
+    if ((size_t)snprintf(bin_path, sizeof(bin_path), "%s%s", xml_path, DOP_MANIFEST_BINARY_SUFFIX)
+            >= sizeof(bin_path)) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+    
+    bool fresh = topology->node_count == 0;
+    uint64_t hash;
+    int result = dop_manifest_hash_file(xml_path, &hash);
+    if (result != DOP_SUCCESS) return result;
+    if (dop_manifest_load_binary(bin_path, hash, topology, resolve, user_data) == DOP_SUCCESS) {
+        return DOP_SUCCESS;
+    }
+    
+    // The binary is missing or stale, so the XML changed since it was
+    // last checked
+    result = dop_manifest_validate_schema(xml_path);
+    if (result != DOP_SUCCESS) return result;
+    result = dop_manifest_load_topology_from_xml(xml_path, topology, resolve, user_data);
+    if (result != DOP_SUCCESS) return result;
+    
+    // Best effort: an unwritable directory only costs the next load a parse.
+    // Nodes the topology already held are not the manifest's to record.
+    if (fresh) dop_manifest_save_binary(topology, bin_path, hash);
+    return DOP_SUCCESS;
+}
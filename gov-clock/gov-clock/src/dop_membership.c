@@ -0,0 +1,387 @@
+// src/dop_membership.c
+// OBINexus DOP Topology Membership
+// SWIM-style failure detection with gossip dissemination
+
+#include "dop_membership.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A view entry: state in the top two bits, incarnation below
+#define VIEW_STATE_SHIFT 30
+#define VIEW_INCARNATION_MASK 0x3fffffffu
+#define GOSSIP_CAPACITY 64            // Updates a node holds for retransmission
+
+typedef struct {
+    uint32_t member;
+    uint32_t view;
+    uint32_t transmissions_left;
+} gossip_t;
+
+typedef struct {
+    uint32_t member;
+    uint32_t incarnation;
+    uint64_t deadline;                // Period it is declared dead in
+} suspicion_t;
+
+typedef struct {
+    uint32_t* view;                   // What this node believes of each member
+    uint32_t incarnation;             // Its own
+    gossip_t gossip[GOSSIP_CAPACITY];
+    uint32_t gossip_count;
+    suspicion_t* suspicions;
+    uint32_t suspicion_count;
+    uint32_t suspicion_capacity;
+    uint32_t probe_start;             // Round robin: start + step * stride, mod n
+    uint32_t probe_stride;
+    uint32_t probe_step;
+} member_t;
+
+struct dop_membership {
+    dop_topology_node_t** nodes;      // Snapshot of the topology at creation
+    uint32_t count;
+    uint32_t* partition;
+    member_t* members;
+    dop_membership_config_t config;
+    uint32_t retransmit_limit;
+    uint64_t random;
+    uint64_t period;
+    dop_membership_stats_t stats;
+};
+
+static inline uint32_t make_view(dop_member_state_t state, uint32_t incarnation) {
+    return ((uint32_t)state << VIEW_STATE_SHIFT) | (incarnation & VIEW_INCARNATION_MASK);
+}
+
+static inline dop_member_state_t view_state(uint32_t view) {
+    return (dop_member_state_t)(view >> VIEW_STATE_SHIFT);
+}
+
+static inline uint32_t view_incarnation(uint32_t view) {
+    return view & VIEW_INCARNATION_MASK;
+}
+
+static uint64_t next_random(dop_membership_t* membership) {
+    uint64_t x = membership->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return membership->random = x;
+}
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// A fresh pass over the members in a new pseudo-random order: a stride
+// coprime with n visits every member exactly once
+static void shuffle_probes(dop_membership_t* membership, member_t* member) {
+    uint32_t n = membership->count;
+    member->probe_start = (uint32_t)(next_random(membership) % n);
+    member->probe_stride = 1;
+    if (n > 2) {
+        do {
+            member->probe_stride = 1 + (uint32_t)(next_random(membership) % (n - 1));
+        } while (gcd(member->probe_stride, n) != 1);
+    }
+    member->probe_step = 0;
+}
+
+static bool node_up(const dop_membership_t* membership, uint32_t node) {
+    const dop_topology_node_t* topology_node = membership->nodes[node];
+    return !topology_node->component || dop_gate_is_accessible(topology_node->component);
+}
+
+static bool reachable(const dop_membership_t* membership, uint32_t from, uint32_t to) {
+    return membership->partition[from] == membership->partition[to] &&
+           node_up(membership, from) && node_up(membership, to);
+}
+
+static void queue_gossip(dop_membership_t* membership, member_t* node, uint32_t member, uint32_t view) {
+    gossip_t* slot = NULL;
+    for (uint32_t i = 0; i < node->gossip_count; i++) {
+        if (node->gossip[i].member == member) {
+            slot = &node->gossip[i];
+            break;
+        }
+    }
+    if (!slot && node->gossip_count < GOSSIP_CAPACITY) {
+        slot = &node->gossip[node->gossip_count++];
+    }
+    if (!slot) {
+        // Full: displace the update closest to done
+        slot = &node->gossip[0];
+        for (uint32_t i = 1; i < node->gossip_count; i++) {
+            if (node->gossip[i].transmissions_left < slot->transmissions_left) slot = &node->gossip[i];
+        }
+    }
+    slot->member = member;
+    slot->view = view;
+    slot->transmissions_left = membership->retransmit_limit;
+}
+
+static void track_suspicion(member_t* node, uint32_t member, uint32_t incarnation, uint64_t deadline) {
+    for (uint32_t i = 0; i < node->suspicion_count; i++) {
+        if (node->suspicions[i].member == member) {
+            node->suspicions[i].incarnation = incarnation;
+            node->suspicions[i].deadline = deadline;
+            return;
+        }
+    }
+    if (node->suspicion_count == node->suspicion_capacity) {
+        uint32_t capacity = node->suspicion_capacity ? node->suspicion_capacity * 2 : 8;
+        suspicion_t* suspicions = realloc(node->suspicions, capacity * sizeof(suspicion_t));
+        if (!suspicions) return;  // Stays suspect; a later probe retries
+        node->suspicions = suspicions;
+        node->suspicion_capacity = capacity;
+    }
+    node->suspicions[node->suspicion_count++] = (suspicion_t){ member, incarnation, deadline };
+}
+
+// Whether an update supersedes what is known: a higher incarnation always
+// does; at the same incarnation suspect beats alive and dead beats both
+static bool supersedes(uint32_t update, uint32_t current) {
+    uint32_t update_incarnation = view_incarnation(update);
+    uint32_t current_incarnation = view_incarnation(current);
+    if (update_incarnation != current_incarnation) return update_incarnation > current_incarnation;
+    return view_state(update) > view_state(current);
+}
+
+static void apply_update(dop_membership_t* membership, uint32_t observer, uint32_t member, uint32_t update) {
+    member_t* node = &membership->members[observer];
+
+    if (member == observer) {
+        // Rumours of our own failure are refuted with a new incarnation
+        if (view_state(update) != DOP_MEMBER_ALIVE && view_incarnation(update) >= node->incarnation) {
+            node->incarnation = view_incarnation(update) + 1;
+            node->view[observer] = make_view(DOP_MEMBER_ALIVE, node->incarnation);
+            queue_gossip(membership, node, observer, node->view[observer]);
+            membership->stats.refutations++;
+        }
+        return;
+    }
+
+    if (!supersedes(update, node->view[member])) return;
+    node->view[member] = update;
+    queue_gossip(membership, node, member, update);
+    if (view_state(update) == DOP_MEMBER_SUSPECT) {
+        track_suspicion(node, member, view_incarnation(update),
+                        membership->period + membership->config.suspect_periods);
+    }
+}
+
+// The updates a message carries: those with the most transmissions left
+static void send_gossip(dop_membership_t* membership, uint32_t from, uint32_t to) {
+    member_t* sender = &membership->members[from];
+    uint32_t limit = membership->config.max_piggyback;
+    uint32_t carried[GOSSIP_CAPACITY];
+    uint32_t carried_count = 0;
+
+    for (uint32_t k = 0; k < limit && k < sender->gossip_count; k++) {
+        uint32_t best = UINT32_MAX;
+        for (uint32_t i = 0; i < sender->gossip_count; i++) {
+            bool taken = false;
+            for (uint32_t c = 0; c < carried_count && !taken; c++) taken = carried[c] == i;
+            if (!taken && (best == UINT32_MAX ||
+                           sender->gossip[i].transmissions_left > sender->gossip[best].transmissions_left)) {
+                best = i;
+            }
+        }
+        carried[carried_count++] = best;
+    }
+
+    for (uint32_t c = 0; c < carried_count; c++) {
+        gossip_t update = sender->gossip[carried[c]];
+        apply_update(membership, to, update.member, update.view);
+        sender->gossip[carried[c]].transmissions_left--;
+        membership->stats.gossip_sent++;
+    }
+
+    // Drop what has been sent enough, back to front so indexes hold
+    for (uint32_t i = sender->gossip_count; i-- > 0; ) {
+        if (sender->gossip[i].transmissions_left == 0) {
+            sender->gossip[i] = sender->gossip[--sender->gossip_count];
+        }
+    }
+}
+
+// One direction of a probe or ack. Besides gossip it carries the sender's
+// own incarnation, and tells it if the receiver thinks it suspect or dead,
+// so a member the rumours have passed by still gets to refute them.
+static void deliver(dop_membership_t* membership, uint32_t from, uint32_t to) {
+    send_gossip(membership, from, to);
+    apply_update(membership, to, from, membership->members[from].view[from]);
+    uint32_t about_sender = membership->members[to].view[from];
+    if (view_state(about_sender) != DOP_MEMBER_ALIVE) {
+        apply_update(membership, from, from, about_sender);
+    }
+}
+
+static void exchange(dop_membership_t* membership, uint32_t from, uint32_t to) {
+    deliver(membership, from, to);
+    deliver(membership, to, from);
+}
+
+static uint32_t next_probe_target(dop_membership_t* membership, uint32_t observer) {
+    member_t* node = &membership->members[observer];
+    for (uint32_t tries = 0; tries < membership->count; tries++) {
+        if (node->probe_step == membership->count) shuffle_probes(membership, node);
+        uint32_t target = (uint32_t)(((uint64_t)node->probe_start +
+                                      (uint64_t)node->probe_step * node->probe_stride) % membership->count);
+        node->probe_step++;
+        if (target != observer && view_state(node->view[target]) != DOP_MEMBER_DEAD) return target;
+    }
+    return UINT32_MAX;
+}
+
+static bool probe_indirectly(dop_membership_t* membership, uint32_t observer, uint32_t target) {
+    member_t* node = &membership->members[observer];
+    uint32_t asked = 0;
+    for (uint32_t tries = 0; asked < membership->config.indirect_probes && tries < 4 * membership->count;
+         tries++) {
+        uint32_t helper = (uint32_t)(next_random(membership) % membership->count);
+        if (helper == observer || helper == target ||
+            view_state(node->view[helper]) == DOP_MEMBER_DEAD) {
+            continue;
+        }
+        asked++;
+        membership->stats.indirect_probes++;
+        if (reachable(membership, observer, helper) && reachable(membership, helper, target)) {
+            exchange(membership, observer, helper);
+            exchange(membership, helper, target);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void expire_suspicions(dop_membership_t* membership, uint32_t observer) {
+    member_t* node = &membership->members[observer];
+    for (uint32_t i = node->suspicion_count; i-- > 0; ) {
+        suspicion_t suspicion = node->suspicions[i];
+        uint32_t view = node->view[suspicion.member];
+        bool still_suspect = view_state(view) == DOP_MEMBER_SUSPECT &&
+                             view_incarnation(view) == suspicion.incarnation;
+        if (still_suspect && suspicion.deadline > membership->period) continue;
+
+        node->suspicions[i] = node->suspicions[--node->suspicion_count];
+        if (still_suspect) {
+            apply_update(membership, observer, suspicion.member,
+                         make_view(DOP_MEMBER_DEAD, suspicion.incarnation));
+            membership->stats.deaths++;
+        }
+    }
+}
+
+dop_membership_t* dop_membership_create(dop_build_topology_t* topology,
+                                        const dop_membership_config_t* config) {
+    if (!topology || topology->node_count == 0) return NULL;
+    dop_membership_t* membership = calloc(1, sizeof(dop_membership_t));
+    if (!membership) return NULL;
+
+    uint32_t n = topology->node_count;
+    dop_membership_config_t defaults = DOP_MEMBERSHIP_DEFAULT_CONFIG;
+    membership->config = config ? *config : defaults;
+    if (membership->config.max_piggyback > GOSSIP_CAPACITY) membership->config.max_piggyback = GOSSIP_CAPACITY;
+    membership->count = n;
+    membership->random = membership->config.seed ? membership->config.seed : 0x5eed;
+
+    uint32_t log_n = 1;
+    while ((1u << log_n) < n) log_n++;
+    membership->retransmit_limit = membership->config.retransmit_mult * log_n;
+    if (membership->retransmit_limit == 0) membership->retransmit_limit = 1;
+
+    membership->nodes = malloc(n * sizeof(dop_topology_node_t*));
+    membership->partition = calloc(n, sizeof(uint32_t));
+    membership->members = calloc(n, sizeof(member_t));
+    if (!membership->nodes || !membership->partition || !membership->members) {
+        dop_membership_destroy(membership);
+        return NULL;
+    }
+    memcpy(membership->nodes, topology->nodes, n * sizeof(dop_topology_node_t*));
+
+    for (uint32_t i = 0; i < n; i++) {
+        // All alive at incarnation 0, which is an all-zero view
+        membership->members[i].view = calloc(n, sizeof(uint32_t));
+        if (!membership->members[i].view) {
+            dop_membership_destroy(membership);
+            return NULL;
+        }
+        shuffle_probes(membership, &membership->members[i]);
+    }
+    return membership;
+}
+
+void dop_membership_destroy(dop_membership_t* membership) {
+    if (!membership) return;
+    if (membership->members) {
+        for (uint32_t i = 0; i < membership->count; i++) {
+            free(membership->members[i].view);
+            free(membership->members[i].suspicions);
+        }
+    }
+    free(membership->members);
+    free(membership->partition);
+    free(membership->nodes);
+    free(membership);
+}
+
+void dop_membership_period(dop_membership_t* membership) {
+    if (!membership) return;
+    membership->period++;
+    membership->stats.periods++;
+
+    for (uint32_t observer = 0; observer < membership->count; observer++) {
+        if (!node_up(membership, observer)) continue;
+        expire_suspicions(membership, observer);
+
+        uint32_t target = next_probe_target(membership, observer);
+        if (target == UINT32_MAX) continue;
+        membership->stats.probes++;
+
+        if (reachable(membership, observer, target)) {
+            exchange(membership, observer, target);
+        } else if (!probe_indirectly(membership, observer, target)) {
+            uint32_t view = membership->members[observer].view[target];
+            if (view_state(view) == DOP_MEMBER_ALIVE) {
+                apply_update(membership, observer, target,
+                             make_view(DOP_MEMBER_SUSPECT, view_incarnation(view)));
+                membership->stats.suspicions++;
+            }
+        }
+    }
+}
+
+void dop_membership_set_partition(dop_membership_t* membership, uint32_t node, uint32_t partition) {
+    if (membership && node < membership->count) membership->partition[node] = partition;
+}
+
+dop_member_state_t dop_membership_state(const dop_membership_t* membership,
+                                        uint32_t observer, uint32_t member) {
+    if (!membership || observer >= membership->count || member >= membership->count) {
+        return DOP_MEMBER_DEAD;
+    }
+    return view_state(membership->members[observer].view[member]);
+}
+
+uint32_t dop_membership_alive_count(const dop_membership_t* membership, uint32_t observer) {
+    if (!membership || observer >= membership->count) return 0;
+    uint32_t alive = 0;
+    for (uint32_t i = 0; i < membership->count; i++) {
+        if (view_state(membership->members[observer].view[i]) != DOP_MEMBER_DEAD) alive++;
+    }
+    return alive;
+}
+
+void dop_membership_get_stats(const dop_membership_t* membership, dop_membership_stats_t* stats) {
+    if (!stats) return;
+    if (!membership) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = membership->stats;
+}
@@ -0,0 +1,357 @@
+// src/dop_serialize.c
+// OBINexus DOP Binary Component Serialization Implementation
+//
+// Layout: header, then record_count records of record_size bytes. Fields
+// are fixed-width and in the writer's byte order, which the header records.
+
+#include "dop_serialize.h"
+#include <string.h>
+#include <stddef.h>
+
+#define SERIAL_MAGIC "DOPC"
+#define SERIAL_BYTE_ORDER 0x01020304u
+
+// Type-specific flags
+#define SERIAL_FLAG_ARMED 0x01u             // Alarm
+#define SERIAL_FLAG_TRIGGERED 0x02u
+#define SERIAL_FLAG_RUNNING 0x04u           // Clock, stopwatch, timer
+#define SERIAL_FLAG_24_HOUR 0x08u           // Clock
+#define SERIAL_FLAG_PAUSED 0x10u            // Stopwatch
+#define SERIAL_FLAG_EXPIRED 0x20u           // Timer
+#define SERIAL_FLAG_AUTO_RESTART 0x40u
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;                    // SERIAL_BYTE_ORDER as written
+    uint32_t record_count;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t records_hash;                  // FNV-1a 64 of the records
+} serial_header_t;
+
+typedef struct {
+    uint64_t timestamp_ms;
+    uint32_t hours;
+    uint32_t minutes;
+    uint32_t seconds;
+    uint32_t milliseconds;
+    uint32_t is_valid;
+    uint32_t reserved;
+} serial_time_t;
+
+// times[] by type. Alarm: alarm_time, current_time. Clock: current_time.
+// Stopwatch: start_time, current_time, elapsed_time. Timer: start_time,
+// duration, remaining. value is the alarm's snooze_duration_ms, the clock's
+// timezone_offset or the stopwatch's lap_count.
+typedef struct {
+    char component_id[64];
+    uint32_t type;
+    uint32_t state;
+    uint32_t gate_state;
+    uint32_t flags;
+    uint64_t creation_timestamp;
+    uint64_t last_update_timestamp;
+    uint32_t value;
+    uint32_t reserved;
+    serial_time_t times[3];
+} serial_record_t;
+
+_Static_assert(sizeof(serial_header_t) == DOP_SERIAL_HEADER_SIZE, "serial header layout");
+_Static_assert(sizeof(serial_record_t) == DOP_SERIAL_RECORD_SIZE, "serial record layout");
+
+static uint64_t records_hash(const unsigned char* bytes, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static serial_time_t time_to_serial(dop_time_data_t time) {
+    serial_time_t serial = {
+        .timestamp_ms = time.timestamp_ms,
+        .hours = time.hours,
+        .minutes = time.minutes,
+        .seconds = time.seconds,
+        .milliseconds = time.milliseconds,
+        .is_valid = time.is_valid
+    };
+    return serial;
+}
+
+static dop_time_data_t time_from_serial(const serial_time_t* serial) {
+    dop_time_data_t time;
+    memset(&time, 0, sizeof(time));         // Padding too: it feeds the checksum
+    time.timestamp_ms = serial->timestamp_ms;
+    time.hours = serial->hours;
+    time.minutes = serial->minutes;
+    time.seconds = serial->seconds;
+    time.milliseconds = serial->milliseconds;
+    time.is_valid = serial->is_valid != 0;
+    return time;
+}
+
+// Callers hold the component's lock
+static void record_write(serial_record_t* record, const dop_component_t* component) {
+    memset(record, 0, sizeof(*record));
+    memcpy(record->component_id, component->metadata.component_id, sizeof(record->component_id));
+    record->component_id[sizeof(record->component_id) - 1] = '\0';
+    record->type = (uint32_t)component->metadata.type;
+    record->state = (uint32_t)component->metadata.state;
+    record->gate_state = (uint32_t)component->metadata.gate_state;
+    record->creation_timestamp = component->metadata.creation_timestamp;
+    record->last_update_timestamp = component->metadata.last_update_timestamp;
+
+    const dop_component_data_t* data = &component->data;
+    switch (component->metadata.type) {
+        case DOP_COMPONENT_ALARM:
+            record->flags = (data->alarm.is_armed ? SERIAL_FLAG_ARMED : 0) |
+                            (data->alarm.is_triggered ? SERIAL_FLAG_TRIGGERED : 0);
+            record->value = data->alarm.snooze_duration_ms;
+            record->times[0] = time_to_serial(data->alarm.alarm_time);
+            record->times[1] = time_to_serial(data->alarm.current_time);
+            break;
+        case DOP_COMPONENT_CLOCK:
+            record->flags = (data->clock.is_running ? SERIAL_FLAG_RUNNING : 0) |
+                            (data->clock.is_24_hour_format ? SERIAL_FLAG_24_HOUR : 0);
+            record->value = data->clock.timezone_offset;
+            record->times[0] = time_to_serial(data->clock.current_time);
+            break;
+        case DOP_COMPONENT_STOPWATCH:
+            record->flags = (data->stopwatch.is_running ? SERIAL_FLAG_RUNNING : 0) |
+                            (data->stopwatch.is_paused ? SERIAL_FLAG_PAUSED : 0);
+            record->value = data->stopwatch.lap_count;
+            record->times[0] = time_to_serial(data->stopwatch.start_time);
+            record->times[1] = time_to_serial(data->stopwatch.current_time);
+            record->times[2] = time_to_serial(data->stopwatch.elapsed_time);
+            break;
+        case DOP_COMPONENT_TIMER:
+            record->flags = (data->timer.is_running ? SERIAL_FLAG_RUNNING : 0) |
+                            (data->timer.is_expired ? SERIAL_FLAG_EXPIRED : 0) |
+                            (data->timer.auto_restart ? SERIAL_FLAG_AUTO_RESTART : 0);
+            record->times[0] = time_to_serial(data->timer.start_time);
+            record->times[1] = time_to_serial(data->timer.duration);
+            record->times[2] = time_to_serial(data->timer.remaining);
+            break;
+        default:
+            break;
+    }
+}
+
+// Callers hold the component's lock and have checked the type matches
+static void record_apply(const serial_record_t* record, dop_component_t* component) {
+    component->metadata.state = (dop_component_state_t)record->state;
+    component->metadata.gate_state = (dop_gate_state_t)record->gate_state;
+    component->metadata.creation_timestamp = record->creation_timestamp;
+    component->metadata.last_update_timestamp = record->last_update_timestamp;
+
+    dop_component_data_t* data = &component->data;
+    memset(data, 0, sizeof(*data));
+    switch (component->metadata.type) {
+        case DOP_COMPONENT_ALARM:
+            data->alarm.is_armed = record->flags & SERIAL_FLAG_ARMED;
+            data->alarm.is_triggered = record->flags & SERIAL_FLAG_TRIGGERED;
+            data->alarm.snooze_duration_ms = record->value;
+            data->alarm.alarm_time = time_from_serial(&record->times[0]);
+            data->alarm.current_time = time_from_serial(&record->times[1]);
+            break;
+        case DOP_COMPONENT_CLOCK:
+            data->clock.is_running = record->flags & SERIAL_FLAG_RUNNING;
+            data->clock.is_24_hour_format = record->flags & SERIAL_FLAG_24_HOUR;
+            data->clock.timezone_offset = record->value;
+            data->clock.current_time = time_from_serial(&record->times[0]);
+            break;
+        case DOP_COMPONENT_STOPWATCH:
+            data->stopwatch.is_running = record->flags & SERIAL_FLAG_RUNNING;
+            data->stopwatch.is_paused = record->flags & SERIAL_FLAG_PAUSED;
+            data->stopwatch.lap_count = record->value;
+            data->stopwatch.start_time = time_from_serial(&record->times[0]);
+            data->stopwatch.current_time = time_from_serial(&record->times[1]);
+            data->stopwatch.elapsed_time = time_from_serial(&record->times[2]);
+            break;
+        case DOP_COMPONENT_TIMER:
+            data->timer.is_running = record->flags & SERIAL_FLAG_RUNNING;
+            data->timer.is_expired = record->flags & SERIAL_FLAG_EXPIRED;
+            data->timer.auto_restart = record->flags & SERIAL_FLAG_AUTO_RESTART;
+            data->timer.start_time = time_from_serial(&record->times[0]);
+            data->timer.duration = time_from_serial(&record->times[1]);
+            data->timer.remaining = time_from_serial(&record->times[2]);
+            break;
+        default:
+            break;
+    }
+    component->checksum = dop_checksum_calculate(component);
+}
+
+// Records and the header go through aligned locals, as the buffer may not
+// be aligned
+static void write_record(void* buffer, uint32_t index, dop_component_t* component) {
+    serial_record_t record;
+    pthread_mutex_lock(&component->metadata.mutex);
+    record_write(&record, component);
+    pthread_mutex_unlock(&component->metadata.mutex);
+    memcpy((unsigned char*)buffer + DOP_SERIAL_HEADER_SIZE + (size_t)index * DOP_SERIAL_RECORD_SIZE,
+           &record, sizeof(record));
+}
+
+static void write_header(void* buffer, uint32_t count) {
+    serial_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SERIAL_MAGIC, sizeof(header.magic));
+    header.version = DOP_SERIAL_VERSION;
+    header.byte_order = SERIAL_BYTE_ORDER;
+    header.record_count = count;
+    header.record_size = DOP_SERIAL_RECORD_SIZE;
+    header.records_hash = records_hash((const unsigned char*)buffer + DOP_SERIAL_HEADER_SIZE,
+                                       (size_t)count * DOP_SERIAL_RECORD_SIZE);
+    memcpy(buffer, &header, sizeof(header));
+}
+
+size_t dop_serialize_size(uint32_t count) {
+    return DOP_SERIAL_HEADER_SIZE + (size_t)count * DOP_SERIAL_RECORD_SIZE;
+}
+
+int dop_serialize_components(const dop_component_t* const* components, uint32_t count,
+                             void* buffer, size_t size, size_t* written) {
+    if ((!components && count > 0) || !buffer) return DOP_ERROR_INVALID_PARAMETER;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!components[i]) return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    size_t needed = dop_serialize_size(count);
+    if (written) *written = needed;
+    if (size < needed) return DOP_ERROR_MEMORY_ALLOCATION;
+
+    for (uint32_t i = 0; i < count; i++) {
+        write_record(buffer, i, (dop_component_t*)components[i]);
+    }
+
+    write_header(buffer, count);
+    return DOP_SUCCESS;
+}
+
+int dop_serialize_component(const dop_component_t* component, void* buffer, size_t size, size_t* written) {
+    if (!component) return DOP_ERROR_INVALID_PARAMETER;
+    return dop_serialize_components(&component, 1, buffer, size, written);
+}
+
+// Check the header and record hash; sets *count to the record count
+static int read_header(const void* buffer, size_t size, uint32_t* count) {
+    if (!buffer || size < DOP_SERIAL_HEADER_SIZE) return DOP_ERROR_INVALID_PARAMETER;
+
+    serial_header_t header;
+    memcpy(&header, buffer, sizeof(header));
+    if (memcmp(header.magic, SERIAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DOP_SERIAL_VERSION ||
+        header.byte_order != SERIAL_BYTE_ORDER ||
+        header.record_size != DOP_SERIAL_RECORD_SIZE ||
+        size < dop_serialize_size(header.record_count)) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+    const unsigned char* records = (const unsigned char*)buffer + DOP_SERIAL_HEADER_SIZE;
+    if (records_hash(records, (size_t)header.record_count * DOP_SERIAL_RECORD_SIZE) != header.records_hash) {
+        return DOP_ERROR_CHECKSUM_FAILED;
+    }
+    *count = header.record_count;
+    return DOP_SUCCESS;
+}
+
+static void read_record(const void* buffer, uint32_t index, serial_record_t* record) {
+    memcpy(record, (const unsigned char*)buffer + DOP_SERIAL_HEADER_SIZE +
+                   (size_t)index * DOP_SERIAL_RECORD_SIZE, sizeof(*record));
+    record->component_id[sizeof(record->component_id) - 1] = '\0';
+}
+
+static bool record_valid(const serial_record_t* record) {
+    return record->type < DOP_COMPONENT_COUNT &&
+           record->state <= DOP_STATE_DESTROYED &&
+           record->gate_state <= DOP_GATE_ISOLATED;
+}
+
+int dop_deserialize_component(const void* buffer, size_t size, dop_component_t* component) {
+    if (!component) return DOP_ERROR_INVALID_PARAMETER;
+    uint32_t count = 0;
+    int result = read_header(buffer, size, &count);
+    if (result != DOP_SUCCESS) return result;
+    if (count != 1) return DOP_ERROR_INVALID_PARAMETER;
+
+    serial_record_t record;
+    read_record(buffer, 0, &record);
+    if (!record_valid(&record)) return DOP_ERROR_INVALID_PARAMETER;
+
+    pthread_mutex_lock(&component->metadata.mutex);
+    if (record.type == (uint32_t)component->metadata.type) {
+        record_apply(&record, component);
+    } else {
+        result = DOP_ERROR_INVALID_STATE;
+    }
+    pthread_mutex_unlock(&component->metadata.mutex);
+    return result;
+}
+
+static dop_component_t* node_component(const dop_build_topology_t* topology, uint32_t index) {
+    dop_topology_node_t* node = index < topology->node_count ? topology->nodes[index] : NULL;
+    return node ? node->component : NULL;
+}
+
+int dop_serialize_topology(const dop_build_topology_t* topology, void* buffer, size_t size, size_t* written) {
+    if (!topology || !buffer || (!topology->nodes && topology->node_count > 0)) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < topology->node_count; i++) {
+        if (node_component(topology, i)) count++;
+    }
+    size_t needed = dop_serialize_size(count);
+    if (written) *written = needed;
+    if (size < needed) return DOP_ERROR_MEMORY_ALLOCATION;
+
+    uint32_t index = 0;
+    for (uint32_t i = 0; i < topology->node_count; i++) {
+        dop_component_t* component = node_component(topology, i);
+        if (component) write_record(buffer, index++, component);
+    }
+
+    write_header(buffer, count);
+    return DOP_SUCCESS;
+}
+
+int dop_deserialize_topology(const void* buffer, size_t size, dop_build_topology_t* topology, uint32_t* applied) {
+    if (applied) *applied = 0;
+    if (!topology || (!topology->nodes && topology->node_count > 0)) return DOP_ERROR_INVALID_PARAMETER;
+    uint32_t count = 0;
+    int result = read_header(buffer, size, &count);
+    if (result != DOP_SUCCESS) return result;
+
+    // Records usually follow the node order, so look where the last match
+    // left off before scanning
+    uint32_t matched = 0;
+    uint32_t cursor = 0;
+    for (uint32_t r = 0; r < count; r++) {
+        serial_record_t record;
+        read_record(buffer, r, &record);
+        if (!record_valid(&record)) return DOP_ERROR_INVALID_PARAMETER;
+
+        dop_component_t* target = NULL;
+        for (uint32_t step = 0; step < topology->node_count && !target; step++) {
+            uint32_t index = (cursor + step) % topology->node_count;
+            dop_component_t* component = node_component(topology, index);
+            if (component && strcmp(component->metadata.component_id, record.component_id) == 0) {
+                target = component;
+                cursor = index + 1;
+            }
+        }
+        if (!target) continue;
+
+        pthread_mutex_lock(&target->metadata.mutex);
+        if (record.type == (uint32_t)target->metadata.type) {
+            record_apply(&record, target);
+            matched++;
+        }
+        pthread_mutex_unlock(&target->metadata.mutex);
+    }
+    if (applied) *applied = matched;
+    return DOP_SUCCESS;
+}
@@ -0,0 +1,397 @@
+// src/dop_shared_table.c
+// OBINexus DOP Shared-Memory Component Table Implementation
+
+#define _POSIX_C_SOURCE 200809L
+#include "dop_shared_table.h"
+#include "dop_component_pool.h"
+#include "dop_timer_wheel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SHARED_TABLE_MAGIC 0x53504F44u          // "DOPS"
+#define SHARED_TABLE_VERSION 2
+#define SHARED_TABLE_MAX_CAPACITY (1u << 20)
+
+// Segment layout: the header, then capacity slots. Processes map it at
+// different addresses, so nothing in it is a pointer.
+typedef struct {
+    _Atomic uint32_t magic;         // Stored last, once the segment is ready
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;             // Catches attaching from a different build
+    pthread_mutex_t lock;           // Slot allocation
+} shared_header_t;
+
+typedef struct {
+    _Atomic uint32_t in_use;
+    dop_shared_view_t view;         // Written only under the component's lock
+    dop_component_t component;
+} shared_slot_t;
+
+#define SHARED_HEADER_SIZE ((sizeof(shared_header_t) + 63) & ~(size_t)63)
+
+struct dop_shared_table {
+    shared_header_t* header;
+    shared_slot_t* slots;
+    size_t size;
+    bool writable;
+};
+
+static size_t segment_size(uint32_t capacity) {
+    return SHARED_HEADER_SIZE + (size_t)capacity * sizeof(shared_slot_t);
+}
+
+static int init_shared_mutex(pthread_mutex_t* mutex) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int result = pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return result;
+}
+
+// Lock a robust mutex. Returns EOWNERDEAD, with the mutex held and made
+// consistent again, if its previous owner died holding it; any other
+// non-zero result means the mutex is not held.
+static int robust_lock(pthread_mutex_t* mutex) {
+    int result = pthread_mutex_lock(mutex);
+    if (result == EOWNERDEAD) {
+        pthread_mutex_consistent(mutex);
+    }
+    return result;
+}
+
+static bool robust_lock_held(pthread_mutex_t* mutex) {
+    int result = robust_lock(mutex);
+    return result == 0 || result == EOWNERDEAD;
+}
+
+static dop_shared_table_t* map_table(int fd, size_t size, bool writable) {
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* base = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) return NULL;
+
+    dop_shared_table_t* table = malloc(sizeof(dop_shared_table_t));
+    if (!table) {
+        munmap(base, size);
+        return NULL;
+    }
+    table->header = base;
+    table->slots = (shared_slot_t*)((unsigned char*)base + SHARED_HEADER_SIZE);
+    table->size = size;
+    table->writable = writable;
+    return table;
+}
+
+static void unmap_table(dop_shared_table_t* table) {
+    munmap(table->header, table->size);
+    free(table);
+}
+
+dop_shared_table_t* dop_shared_table_create(const char* name, uint32_t capacity) {
+    if (!name || capacity == 0 || capacity > SHARED_TABLE_MAX_CAPACITY) return NULL;
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return NULL;
+    size_t size = segment_size(capacity);
+    dop_shared_table_t* table = NULL;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        table = map_table(fd, size, true);     // Zero-filled by ftruncate
+    }
+    close(fd);
+    if (!table) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    shared_header_t* header = table->header;
+    header->version = SHARED_TABLE_VERSION;
+    header->capacity = capacity;
+    header->slot_size = sizeof(shared_slot_t);
+    bool ready = init_shared_mutex(&header->lock) == 0;
+    for (uint32_t i = 0; ready && i < capacity; i++) {
+        ready = init_shared_mutex(&table->slots[i].component.metadata.mutex) == 0;
+    }
+    if (!ready) {
+        unmap_table(table);
+        shm_unlink(name);
+        return NULL;
+    }
+    atomic_store_explicit(&header->magic, SHARED_TABLE_MAGIC, memory_order_release);
+    return table;
+}
+
+dop_shared_table_t* dop_shared_table_attach(const char* name, bool writable) {
+    if (!name) return NULL;
+
+    int fd = shm_open(name, writable ? O_RDWR : O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    struct stat st;
+    dop_shared_table_t* table = NULL;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= SHARED_HEADER_SIZE) {
+        table = map_table(fd, (size_t)st.st_size, writable);
+    }
+    close(fd);
+    if (!table) return NULL;
+
+    // Still being created, or laid out by an incompatible build
+    shared_header_t* header = table->header;
+    if (atomic_load_explicit(&header->magic, memory_order_acquire) != SHARED_TABLE_MAGIC ||
+        header->version != SHARED_TABLE_VERSION ||
+        header->slot_size != sizeof(shared_slot_t) ||
+        header->capacity == 0 || header->capacity > SHARED_TABLE_MAX_CAPACITY ||
+        segment_size(header->capacity) > table->size) {
+        unmap_table(table);
+        return NULL;
+    }
+    return table;
+}
+
+void dop_shared_table_detach(dop_shared_table_t* table) {
+    if (!table) return;
+
+    // Expiries pending in this process's wheel point into the mapping, so
+    // the timers and alarms this process scheduled stop with it
+    for (uint32_t i = 0; table->writable && i < table->header->capacity; i++) {
+        dop_component_t* component = dop_shared_table_component(table, i);
+        if (!component || dop_shared_component_lock(component) != DOP_SUCCESS) continue;
+        bool owned = dop_timer_wheel_owned(component) != 0;
+        pthread_mutex_unlock(&component->metadata.mutex);
+        if (!owned) continue;
+        if (component->metadata.type == DOP_COMPONENT_TIMER) {
+            dop_timer_stop(component);
+        } else if (component->metadata.type == DOP_COMPONENT_ALARM) {
+            dop_alarm_disarm(component);
+        }
+    }
+    unmap_table(table);
+}
+
+int dop_shared_table_unlink(const char* name) {
+    if (!name) return DOP_ERROR_INVALID_PARAMETER;
+    return shm_unlink(name) == 0 ? DOP_SUCCESS : DOP_ERROR_INVALID_STATE;
+}
+
+// Sequence lock writer side; callers hold the component's lock
+static void view_write(dop_shared_view_t* view, const dop_component_t* component) {
+    uint32_t sequence = atomic_load_explicit(&view->sequence, memory_order_relaxed);
+    atomic_store_explicit(&view->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    if (component) {
+        memcpy(view->component_id, component->metadata.component_id, sizeof(view->component_id));
+        view->type = component->metadata.type;
+        view->state = component->metadata.state;
+        view->gate_state = component->metadata.gate_state;
+        view->last_update_timestamp = component->metadata.last_update_timestamp;
+        view->data = component->data;
+        view->checksum = component->checksum;
+    } else {
+        memset(view->component_id, 0, sizeof(view->component_id));
+    }
+
+    atomic_store_explicit(&view->sequence, sequence + 2, memory_order_release);
+}
+
+static bool view_is_stale(const dop_shared_view_t* view, const dop_component_t* component) {
+    return view->checksum != component->checksum ||
+           view->last_update_timestamp != component->metadata.last_update_timestamp ||
+           view->state != component->metadata.state ||
+           view->gate_state != component->metadata.gate_state ||
+           memcmp(&view->data, &component->data, sizeof(view->data)) != 0;
+}
+
+static bool id_in_use(dop_shared_table_t* table, const char* component_id) {
+    for (uint32_t i = 0; i < table->header->capacity; i++) {
+        shared_slot_t* slot = &table->slots[i];
+        if (atomic_load_explicit(&slot->in_use, memory_order_acquire) &&
+            strcmp(slot->component.metadata.component_id, component_id) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+dop_component_t* dop_shared_table_create_component(dop_shared_table_t* table,
+                                                   dop_component_type_t type,
+                                                   const char* component_id) {
+    if (!table || !table->writable || (unsigned)type >= DOP_COMPONENT_COUNT || !component_id ||
+        component_id[0] == '\0' || strlen(component_id) >= sizeof(((dop_component_t*)0)->metadata.component_id)) {
+        return NULL;
+    }
+
+    // A process that died here leaves at worst a claimed slot, so the
+    // allocation lock needs no repair beyond being made consistent
+    if (!robust_lock_held(&table->header->lock)) return NULL;
+    shared_slot_t* slot = NULL;
+    if (!id_in_use(table, component_id)) {
+        for (uint32_t i = 0; i < table->header->capacity; i++) {
+            if (!atomic_load_explicit(&table->slots[i].in_use, memory_order_relaxed)) {
+                slot = &table->slots[i];
+                break;
+            }
+        }
+    }
+    dop_component_t* component = slot ? &slot->component : NULL;
+    if (!component || !robust_lock_held(&component->metadata.mutex)) {
+        pthread_mutex_unlock(&table->header->lock);
+        return NULL;
+    }
+
+    // Reset everything but the mutex, which lives in the segment for good
+    memset(component, 0, offsetof(dop_component_t, metadata.mutex));
+    memset(&component->data, 0, sizeof(dop_component_t) - offsetof(dop_component_t, data));
+    strcpy(component->metadata.component_id, component_id);
+    dop_component_init_state(component, type);
+    view_write(&slot->view, component);
+    atomic_store_explicit(&slot->in_use, 1, memory_order_release);
+    pthread_mutex_unlock(&component->metadata.mutex);
+
+    pthread_mutex_unlock(&table->header->lock);
+    return component;
+}
+
+static shared_slot_t* slot_of(dop_shared_table_t* table, const dop_component_t* component) {
+    uintptr_t first = (uintptr_t)&table->slots[0].component;
+    uintptr_t address = (uintptr_t)component;
+    if (address < first) return NULL;
+    uintptr_t offset = address - first;
+    if (offset % sizeof(shared_slot_t) != 0 || offset / sizeof(shared_slot_t) >= table->header->capacity) {
+        return NULL;
+    }
+    return &table->slots[offset / sizeof(shared_slot_t)];
+}
+
+int dop_shared_table_destroy_component(dop_shared_table_t* table, dop_component_t* component) {
+    if (!table || !table->writable || !component) return DOP_ERROR_INVALID_PARAMETER;
+    shared_slot_t* slot = slot_of(table, component);
+    if (!slot) return DOP_ERROR_INVALID_PARAMETER;
+
+    // Take it off the timer wheel before the slot can be reused
+    if (component->metadata.wheel_timer) {
+        if (component->metadata.type == DOP_COMPONENT_TIMER) {
+            dop_timer_stop(component);
+        } else if (component->metadata.type == DOP_COMPONENT_ALARM) {
+            dop_alarm_disarm(component);
+        }
+    }
+
+    if (!robust_lock_held(&table->header->lock)) return DOP_ERROR_INVALID_STATE;
+    int result = DOP_ERROR_INVALID_STATE;
+    if (atomic_load_explicit(&slot->in_use, memory_order_relaxed) &&
+        robust_lock_held(&component->metadata.mutex)) {
+        component->metadata.state = DOP_STATE_DESTROYED;
+        view_write(&slot->view, NULL);
+        atomic_store_explicit(&slot->in_use, 0, memory_order_release);
+        pthread_mutex_unlock(&component->metadata.mutex);
+        result = DOP_SUCCESS;
+    }
+    pthread_mutex_unlock(&table->header->lock);
+    return result;
+}
+
+dop_component_t* dop_shared_table_component(dop_shared_table_t* table, uint32_t slot) {
+    if (!table || !table->writable || slot >= table->header->capacity ||
+        !atomic_load_explicit(&table->slots[slot].in_use, memory_order_acquire)) {
+        return NULL;
+    }
+    return &table->slots[slot].component;
+}
+
+int dop_shared_component_lock(dop_component_t* component) {
+    if (!component) return DOP_ERROR_INVALID_PARAMETER;
+
+    int result = robust_lock(&component->metadata.mutex);
+    if (result == EOWNERDEAD) {
+        // The dead owner may have been mid-update
+        if (!dop_checksum_verify(component)) {
+            component->metadata.state = DOP_STATE_ERROR;
+            component->metadata.gate_state = DOP_GATE_CLOSED;
+            component->checksum = dop_checksum_calculate(component);
+        }
+        return DOP_SUCCESS;
+    }
+    return result == 0 ? DOP_SUCCESS : DOP_ERROR_INVALID_STATE;
+}
+
+uint32_t dop_shared_table_publish(dop_shared_table_t* table) {
+    if (!table || !table->writable) return 0;
+
+    uint32_t published = 0;
+    for (uint32_t i = 0; i < table->header->capacity; i++) {
+        shared_slot_t* slot = &table->slots[i];
+        if (!atomic_load_explicit(&slot->in_use, memory_order_acquire)) continue;
+        if (dop_shared_component_lock(&slot->component) != DOP_SUCCESS) continue;
+        if (atomic_load_explicit(&slot->in_use, memory_order_relaxed) &&
+            view_is_stale(&slot->view, &slot->component)) {
+            view_write(&slot->view, &slot->component);
+            published++;
+        }
+        pthread_mutex_unlock(&slot->component.metadata.mutex);
+    }
+    return published;
+}
+
+uint32_t dop_shared_table_capacity(const dop_shared_table_t* table) {
+    return table ? table->header->capacity : 0;
+}
+
+const dop_shared_view_t* dop_shared_table_view(const dop_shared_table_t* table, uint32_t slot) {
+    if (!table || slot >= table->header->capacity) return NULL;
+    return &table->slots[slot].view;
+}
+
+uint32_t dop_shared_view_begin(const dop_shared_view_t* view) {
+    uint32_t sequence;
+    while ((sequence = atomic_load_explicit(&view->sequence, memory_order_acquire)) & 1) {
+        // A writer is mid-copy; it holds no lock we could wait on
+    }
+    return sequence;
+}
+
+bool dop_shared_view_retry(const dop_shared_view_t* view, uint32_t sequence) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&view->sequence, memory_order_relaxed) != sequence;
+}
+
+int dop_shared_view_read(const dop_shared_view_t* view, dop_shared_view_t* out) {
+    if (!view || !out) return DOP_ERROR_INVALID_PARAMETER;
+
+    uint32_t sequence;
+    do {
+        sequence = dop_shared_view_begin(view);
+        memcpy(out->component_id, view->component_id, sizeof(out->component_id));
+        out->type = view->type;
+        out->state = view->state;
+        out->gate_state = view->gate_state;
+        out->last_update_timestamp = view->last_update_timestamp;
+        out->data = view->data;
+        out->checksum = view->checksum;
+    } while (dop_shared_view_retry(view, sequence));
+    atomic_store_explicit(&out->sequence, sequence, memory_order_relaxed);
+    return DOP_SUCCESS;
+}
+
+int dop_shared_table_find(const dop_shared_table_t* table, const char* component_id) {
+    if (!table || !component_id || component_id[0] == '\0') return -1;
+
+    char id[sizeof(((dop_shared_view_t*)0)->component_id)];
+    for (uint32_t i = 0; i < table->header->capacity; i++) {
+        const dop_shared_view_t* view = &table->slots[i].view;
+        uint32_t sequence;
+        do {
+            sequence = dop_shared_view_begin(view);
+            memcpy(id, view->component_id, sizeof(id));
+        } while (dop_shared_view_retry(view, sequence));
+        id[sizeof(id) - 1] = '\0';
+        if (strcmp(id, component_id) == 0) return (int)i;
+    }
+    return -1;
+}
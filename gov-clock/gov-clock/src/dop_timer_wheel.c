@@ -0,0 +1,413 @@
+// src/dop_timer_wheel.c
+// OBINexus DOP Hierarchical Timer Wheel Implementation
+
+#define _POSIX_C_SOURCE 200809L
+#include "dop_timer_wheel.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#define WHEEL_LEVELS 5
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1u << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_SPAN (1ULL << (WHEEL_LEVELS * WHEEL_BITS))   // Ticks the wheel can hold
+#define WHEEL_CHUNK 1024                                    // Timers per allocation
+
+typedef enum {
+    TIMER_FREE = 0,
+    TIMER_PENDING = 1,
+    TIMER_FIRING = 2            // Handed to the callback, not yet returned
+} wheel_timer_state_t;
+
+typedef struct wheel_timer {
+    struct wheel_timer* next;   // Slot list, or free list
+    struct wheel_timer* prev;
+    uint64_t expires;           // Absolute tick
+    void* context;
+    uint32_t index;
+    uint32_t generation;
+    uint8_t state;
+    uint8_t level;
+    uint8_t slot;
+} wheel_timer_t;
+
+struct dop_timer_wheel {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;     // New earliest timer, or shutdown
+    pthread_cond_t delivered;   // A batch's callback returned
+    pthread_t thread;
+    bool running;
+
+    uint32_t tick_ms;
+    uint64_t origin_ms;         // Monotonic time of tick 0
+    uint64_t now_tick;          // Next tick to process
+    uint64_t wake_tick;         // When the thread plans to wake
+
+    wheel_timer_t* slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t occupied[WHEEL_LEVELS];    // Bit per non-empty slot
+    uint32_t pending;
+
+    // Timers live in fixed chunks so handles stay valid as the pool grows
+    wheel_timer_t** chunks;
+    uint32_t chunk_count;
+    wheel_timer_t* free_list;
+
+    dop_wheel_batch_fn_t on_expire;
+    void* user_data;
+    dop_wheel_expiry_t* batch;
+    wheel_timer_t** batch_timers;
+    size_t batch_count;
+    size_t batch_capacity;
+};
+
+static uint64_t monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+static uint64_t timer_handle(const wheel_timer_t* timer) {
+    return ((uint64_t)timer->generation << 32) | (timer->index + 1);
+}
+
+static wheel_timer_t* timer_lookup(dop_timer_wheel_t* wheel, uint64_t handle) {
+    uint32_t index = (uint32_t)handle;
+    if (index == 0 || index > wheel->chunk_count * WHEEL_CHUNK) return NULL;
+    index--;
+    wheel_timer_t* timer = &wheel->chunks[index / WHEEL_CHUNK][index % WHEEL_CHUNK];
+    return timer->generation == (uint32_t)(handle >> 32) ? timer : NULL;
+}
+
+static wheel_timer_t* timer_alloc(dop_timer_wheel_t* wheel) {
+    if (!wheel->free_list) {
+        wheel_timer_t** chunks = realloc(wheel->chunks, (wheel->chunk_count + 1) * sizeof(wheel_timer_t*));
+        if (!chunks) return NULL;
+        wheel->chunks = chunks;
+        wheel_timer_t* chunk = calloc(WHEEL_CHUNK, sizeof(wheel_timer_t));
+        if (!chunk) return NULL;
+        for (uint32_t i = WHEEL_CHUNK; i-- > 0; ) {
+            chunk[i].index = wheel->chunk_count * WHEEL_CHUNK + i;
+            chunk[i].generation = 1;
+            chunk[i].next = wheel->free_list;
+            wheel->free_list = &chunk[i];
+        }
+        wheel->chunks[wheel->chunk_count++] = chunk;
+    }
+    wheel_timer_t* timer = wheel->free_list;
+    wheel->free_list = timer->next;
+    return timer;
+}
+
+static void timer_free(dop_timer_wheel_t* wheel, wheel_timer_t* timer) {
+    timer->state = TIMER_FREE;
+    timer->context = NULL;
+    if (++timer->generation == 0) timer->generation = 1;
+    timer->next = wheel->free_list;
+    wheel->free_list = timer;
+}
+
+// Place a timer by how far off it is: level L holds timers due within
+// 64^(L+1) ticks, at the slot of their expiry's L-th 6-bit digit
+static void timer_link(dop_timer_wheel_t* wheel, wheel_timer_t* timer) {
+    uint64_t expires = timer->expires;
+    if (expires < wheel->now_tick) expires = wheel->now_tick;
+    if (expires - wheel->now_tick >= WHEEL_SPAN) {
+        expires = wheel->now_tick + WHEEL_SPAN - 1;  // Re-placed when this comes due
+    }
+
+    uint64_t delta = expires - wheel->now_tick;
+    uint32_t level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1ULL << ((level + 1) * WHEEL_BITS))) level++;
+    uint32_t slot = (uint32_t)(expires >> (level * WHEEL_BITS)) & WHEEL_MASK;
+
+    timer->level = (uint8_t)level;
+    timer->slot = (uint8_t)slot;
+    timer->prev = NULL;
+    timer->next = wheel->slots[level][slot];
+    if (timer->next) timer->next->prev = timer;
+    wheel->slots[level][slot] = timer;
+    wheel->occupied[level] |= 1ULL << slot;
+}
+
+static void timer_unlink(dop_timer_wheel_t* wheel, wheel_timer_t* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        wheel->slots[timer->level][timer->slot] = timer->next;
+    }
+    if (timer->next) timer->next->prev = timer->prev;
+    if (!wheel->slots[timer->level][timer->slot]) {
+        wheel->occupied[timer->level] &= ~(1ULL << timer->slot);
+    }
+}
+
+// Take a slot's whole list
+static wheel_timer_t* slot_take(dop_timer_wheel_t* wheel, uint32_t level, uint32_t slot) {
+    wheel_timer_t* list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(1ULL << slot);
+    return list;
+}
+
+static bool batch_push(dop_timer_wheel_t* wheel, wheel_timer_t* timer) {
+    if (wheel->batch_count == wheel->batch_capacity) {
+        size_t capacity = wheel->batch_capacity ? wheel->batch_capacity * 2 : 64;
+        dop_wheel_expiry_t* batch = realloc(wheel->batch, capacity * sizeof(dop_wheel_expiry_t));
+        if (!batch) return false;
+        wheel->batch = batch;
+        wheel_timer_t** timers = realloc(wheel->batch_timers, capacity * sizeof(wheel_timer_t*));
+        if (!timers) return false;
+        wheel->batch_timers = timers;
+        wheel->batch_capacity = capacity;
+    }
+    wheel->batch[wheel->batch_count].context = timer->context;
+    wheel->batch[wheel->batch_count].handle = timer_handle(timer);
+    wheel->batch_timers[wheel->batch_count++] = timer;
+    return true;
+}
+
+// Process ticks up to and including target, collecting what expires
+static void wheel_advance(dop_timer_wheel_t* wheel, uint64_t target) {
+    if (wheel->pending == 0) {
+        if (target >= wheel->now_tick) wheel->now_tick = target + 1;
+        return;
+    }
+
+    while (wheel->now_tick <= target) {
+        uint64_t tick = wheel->now_tick;
+
+        // At each level boundary, bring the next slot of the level above
+        // down a level
+        for (uint32_t level = 1; level < WHEEL_LEVELS; level++) {
+            if (tick & ((1ULL << (level * WHEEL_BITS)) - 1)) break;
+            uint32_t slot = (uint32_t)(tick >> (level * WHEEL_BITS)) & WHEEL_MASK;
+            wheel_timer_t* timer = slot_take(wheel, level, slot);
+            while (timer) {
+                wheel_timer_t* next = timer->next;
+                timer_link(wheel, timer);
+                timer = next;
+            }
+        }
+
+        wheel_timer_t* timer = slot_take(wheel, 0, (uint32_t)tick & WHEEL_MASK);
+        while (timer) {
+            wheel_timer_t* next = timer->next;
+            if (timer->expires > tick) {
+                timer_link(wheel, timer);       // Was beyond the wheel's span
+            } else if (batch_push(wheel, timer)) {
+                timer->state = TIMER_FIRING;
+                wheel->pending--;
+            } else {
+                timer->expires = tick + 1;      // No memory for the batch; retry next tick
+                timer_link(wheel, timer);
+            }
+            timer = next;
+        }
+        wheel->now_tick++;
+
+        // Skip runs of empty ticks once nothing is left to find
+        if (wheel->pending == 0) {
+            if (target >= wheel->now_tick) wheel->now_tick = target + 1;
+            return;
+        }
+    }
+}
+
+// The next tick that can have work: the next cascade, or an occupied
+// level-0 slot in the current round before it
+static uint64_t wheel_next_event(const dop_timer_wheel_t* wheel) {
+    uint64_t tick = wheel->now_tick;
+    uint32_t position = (uint32_t)tick & WHEEL_MASK;
+    if (position == 0) return tick;     // Cascade due before anything in level 0
+    uint64_t ahead = wheel->occupied[0] >> position;
+    if (ahead) {
+        return tick + (uint64_t)__builtin_ctzll(ahead);
+    }
+    return (tick | WHEEL_MASK) + 1;
+}
+
+static void* wheel_thread(void* arg) {
+    dop_timer_wheel_t* wheel = arg;
+
+    pthread_mutex_lock(&wheel->lock);
+    while (wheel->running) {
+        uint64_t now = (monotonic_ms() - wheel->origin_ms) / wheel->tick_ms;
+        wheel_advance(wheel, now);
+
+        if (wheel->batch_count > 0) {
+            size_t count = wheel->batch_count;
+            pthread_mutex_unlock(&wheel->lock);
+            wheel->on_expire(wheel->batch, count, wheel->user_data);
+            pthread_mutex_lock(&wheel->lock);
+            for (size_t i = 0; i < count; i++) {
+                timer_free(wheel, wheel->batch_timers[i]);
+            }
+            wheel->batch_count = 0;
+            pthread_cond_broadcast(&wheel->delivered);
+            continue;
+        }
+
+        if (wheel->pending == 0) {
+            wheel->wake_tick = UINT64_MAX;
+            pthread_cond_wait(&wheel->changed, &wheel->lock);
+            continue;
+        }
+
+        wheel->wake_tick = wheel_next_event(wheel);
+        uint64_t wake_ms = wheel->origin_ms + wheel->wake_tick * wheel->tick_ms;
+        struct timespec deadline = {
+            .tv_sec = (time_t)(wake_ms / 1000),
+            .tv_nsec = (long)(wake_ms % 1000) * 1000000
+        };
+        pthread_cond_timedwait(&wheel->changed, &wheel->lock, &deadline);
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return NULL;
+}
+
+dop_timer_wheel_t* dop_timer_wheel_create(uint32_t tick_ms, dop_wheel_batch_fn_t on_expire, void* user_data) {
+    if (tick_ms == 0 || !on_expire) return NULL;
+
+    dop_timer_wheel_t* wheel = calloc(1, sizeof(dop_timer_wheel_t));
+    if (!wheel) return NULL;
+
+    wheel->tick_ms = tick_ms;
+    wheel->on_expire = on_expire;
+    wheel->user_data = user_data;
+    wheel->origin_ms = monotonic_ms();
+    wheel->wake_tick = UINT64_MAX;
+    wheel->running = true;
+
+    // Timed waits run on the monotonic clock, immune to wall-clock steps
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_mutex_init(&wheel->lock, NULL);
+    pthread_cond_init(&wheel->changed, &attributes);
+    pthread_cond_init(&wheel->delivered, NULL);
+    pthread_condattr_destroy(&attributes);
+
+    if (pthread_create(&wheel->thread, NULL, wheel_thread, wheel) != 0) {
+        pthread_cond_destroy(&wheel->delivered);
+        pthread_cond_destroy(&wheel->changed);
+        pthread_mutex_destroy(&wheel->lock);
+        free(wheel);
+        return NULL;
+    }
+    return wheel;
+}
+
+void dop_timer_wheel_destroy(dop_timer_wheel_t* wheel) {
+    if (!wheel) return;
+
+    pthread_mutex_lock(&wheel->lock);
+    wheel->running = false;
+    pthread_cond_signal(&wheel->changed);
+    pthread_mutex_unlock(&wheel->lock);
+    pthread_join(wheel->thread, NULL);
+
+    for (uint32_t i = 0; i < wheel->chunk_count; i++) {
+        free(wheel->chunks[i]);
+    }
+    free(wheel->chunks);
+    free(wheel->batch);
+    free(wheel->batch_timers);
+    pthread_cond_destroy(&wheel->delivered);
+    pthread_cond_destroy(&wheel->changed);
+    pthread_mutex_destroy(&wheel->lock);
+    free(wheel);
+}
+
+uint64_t dop_timer_wheel_schedule(dop_timer_wheel_t* wheel, uint64_t delay_ms, void* context) {
+    if (!wheel) return 0;
+
+    // Round up so a timer never fires early
+    uint64_t now_ms = monotonic_ms() - wheel->origin_ms;
+    uint64_t expires = (now_ms + delay_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+
+    pthread_mutex_lock(&wheel->lock);
+    wheel_timer_t* timer = timer_alloc(wheel);
+    if (!timer) {
+        pthread_mutex_unlock(&wheel->lock);
+        return 0;
+    }
+    timer->expires = expires;
+    timer->context = context;
+    timer->state = TIMER_PENDING;
+    timer_link(wheel, timer);
+    wheel->pending++;
+
+    if (expires < wheel->wake_tick) {
+        pthread_cond_signal(&wheel->changed);
+    }
+    uint64_t handle = timer_handle(timer);
+    pthread_mutex_unlock(&wheel->lock);
+    return handle;
+}
+
+int dop_timer_wheel_cancel(dop_timer_wheel_t* wheel, uint64_t handle) {
+    if (!wheel || handle == 0) return DOP_ERROR_INVALID_PARAMETER;
+
+    pthread_mutex_lock(&wheel->lock);
+    wheel_timer_t* timer = timer_lookup(wheel, handle);
+    if (timer && timer->state == TIMER_PENDING) {
+        timer_unlink(wheel, timer);
+        wheel->pending--;
+        timer_free(wheel, timer);
+        pthread_mutex_unlock(&wheel->lock);
+        return DOP_SUCCESS;
+    }
+
+    // Firing: wait for its callback to return, unless this is the callback
+    if (timer && !pthread_equal(pthread_self(), wheel->thread)) {
+        while (timer->state == TIMER_FIRING && timer_handle(timer) == handle) {
+            pthread_cond_wait(&wheel->delivered, &wheel->lock);
+        }
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return DOP_ERROR_INVALID_STATE;
+}
+
+uint32_t dop_timer_wheel_pending(dop_timer_wheel_t* wheel) {
+    if (!wheel) return 0;
+    pthread_mutex_lock(&wheel->lock);
+    uint32_t pending = wheel->pending;
+    pthread_mutex_unlock(&wheel->lock);
+    return pending;
+}
+
+// Shared wheel for the time components
+static dop_timer_wheel_t* shared_wheel;
+static pthread_once_t shared_wheel_once = PTHREAD_ONCE_INIT;
+
+static void deliver_component_expiries(const dop_wheel_expiry_t* expired, size_t count, void* user_data) {
+    (void)user_data;
+    for (size_t i = 0; i < count; i++) {
+        dop_component_t* component = expired[i].context;
+        switch (component->metadata.type) {
+            case DOP_COMPONENT_TIMER:
+                dop_timer_expire(component, expired[i].handle);
+                break;
+            case DOP_COMPONENT_ALARM:
+                dop_alarm_expire(component, expired[i].handle);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void create_shared_wheel(void) {
+    shared_wheel = dop_timer_wheel_create(1, deliver_component_expiries, NULL);
+}
+
+dop_timer_wheel_t* dop_timer_wheel_shared(void) {
+    pthread_once(&shared_wheel_once, create_shared_wheel);
+    return shared_wheel;
+}
+
+uint64_t dop_timer_wheel_owned(const dop_component_t* component) {
+    return component->metadata.wheel_owner == getpid() ? component->metadata.wheel_timer : 0;
+}
@@ -0,0 +1,218 @@
+// src/dop_update_engine.c
+// OBINexus DOP Batched Update Engine Implementation
+
+#include "dop_update_engine.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Components updated per pass: enough for the compute loop to vectorise,
+// few enough that a tick never holds many component locks at once
+#define UPDATE_BLOCK 32
+
+typedef struct {
+    dop_component_t** components;
+    uint32_t count;
+    uint32_t capacity;
+} update_batch_t;
+
+struct dop_update_engine {
+    pthread_mutex_t lock;
+    update_batch_t batches[DOP_COMPONENT_COUNT];
+};
+
+static dop_time_data_t duration_time(uint64_t ms) {
+    dop_time_data_t time = {
+        .timestamp_ms = ms,
+        .hours = (uint32_t)(ms / 3600000),
+        .minutes = (uint32_t)(ms / 60000 % 60),
+        .seconds = (uint32_t)(ms / 1000 % 60),
+        .milliseconds = (uint32_t)(ms % 1000),
+        .is_valid = true
+    };
+    return time;
+}
+
+// Update up to UPDATE_BLOCK components of one type against a single clock
+// reading. Returns how many had their gate open.
+static uint32_t update_block(dop_component_t* const* components, uint32_t count,
+                             dop_component_type_t type, dop_time_data_t now) {
+    uint64_t start_ms[UPDATE_BLOCK];
+    uint64_t duration_ms[UPDATE_BLOCK];
+    uint64_t result_ms[UPDATE_BLOCK];      // Timer: remaining; stopwatch: elapsed
+    bool open[UPDATE_BLOCK];               // Gate open: the component is updated
+    bool active[UPDATE_BLOCK];             // Open and running (and not paused)
+
+    // Gather: lock each component and copy out what the update reads. Only
+    // a tick holds more than one component lock, under its engine's lock,
+    // so the order they're taken in doesn't matter.
+    for (uint32_t i = 0; i < count; i++) {
+        dop_component_t* component = components[i];
+        pthread_mutex_lock(&component->metadata.mutex);
+        open[i] = component->metadata.gate_state == DOP_GATE_OPEN;
+        switch (type) {
+            case DOP_COMPONENT_STOPWATCH:
+                start_ms[i] = component->data.stopwatch.start_time.timestamp_ms;
+                duration_ms[i] = 0;
+                active[i] = open[i] && component->data.stopwatch.is_running &&
+                            !component->data.stopwatch.is_paused;
+                break;
+            case DOP_COMPONENT_TIMER:
+                start_ms[i] = component->data.timer.start_time.timestamp_ms;
+                duration_ms[i] = component->data.timer.duration.timestamp_ms;
+                active[i] = open[i] && component->data.timer.is_running;
+                break;
+            default:
+                start_ms[i] = duration_ms[i] = 0;
+                active[i] = open[i];
+                break;
+        }
+    }
+
+    // Compute: no locks or branches, so the compiler can vectorise it.
+    // Elapsed clamps to 0 if the wall clock stepped back past a start.
+    uint64_t now_ms = now.timestamp_ms;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t elapsed = (now_ms - start_ms[i]) & (0 - (uint64_t)(now_ms >= start_ms[i]));
+        uint64_t remaining = (duration_ms[i] - elapsed) & (0 - (uint64_t)(duration_ms[i] > elapsed));
+        result_ms[i] = type == DOP_COMPONENT_TIMER ? remaining : elapsed;
+    }
+
+    // Write back and unlock. Expiry and alarms are the timer wheel's job.
+    uint32_t updated = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        dop_component_t* component = components[i];
+        if (open[i]) {
+            switch (type) {
+                case DOP_COMPONENT_CLOCK:
+                    component->data.clock.current_time = now;
+                    break;
+                case DOP_COMPONENT_ALARM:
+                    component->data.alarm.current_time = now;
+                    break;
+                case DOP_COMPONENT_STOPWATCH:
+                    if (active[i]) {
+                        component->data.stopwatch.current_time = now;
+                        component->data.stopwatch.elapsed_time = duration_time(result_ms[i]);
+                    }
+                    break;
+                case DOP_COMPONENT_TIMER:
+                    if (active[i]) {
+                        component->data.timer.remaining = duration_time(result_ms[i]);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            component->metadata.last_update_timestamp = now_ms;
+            component->checksum = dop_checksum_calculate(component);
+            updated++;
+        }
+        pthread_mutex_unlock(&component->metadata.mutex);
+    }
+    return updated;
+}
+
+int dop_func_update_component(dop_component_t* component) {
+    if (!component || (unsigned)component->metadata.type >= DOP_COMPONENT_COUNT) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t updated = update_block(&component, 1, component->metadata.type, dop_time_get_current());
+    return updated ? DOP_SUCCESS : DOP_ERROR_INVALID_PARAMETER;   // Gate not open
+}
+
+dop_update_engine_t* dop_update_engine_create(void) {
+    dop_update_engine_t* engine = calloc(1, sizeof(dop_update_engine_t));
+    if (!engine) return NULL;
+    pthread_mutex_init(&engine->lock, NULL);
+    return engine;
+}
+
+void dop_update_engine_destroy(dop_update_engine_t* engine) {
+    if (!engine) return;
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) {
+        update_batch_t* batch = &engine->batches[type];
+        for (uint32_t i = 0; i < batch->count; i++) {
+            batch->components[i]->metadata.batch_slot = 0;
+        }
+        free(batch->components);
+    }
+    pthread_mutex_destroy(&engine->lock);
+    free(engine);
+}
+
+static bool batch_grow(update_batch_t* batch) {
+    uint32_t capacity = batch->capacity ? batch->capacity * 2 : 64;
+    dop_component_t** components = realloc(batch->components, capacity * sizeof(dop_component_t*));
+    if (!components) return false;
+    batch->components = components;
+    batch->capacity = capacity;
+    return true;
+}
+
+int dop_update_engine_add(dop_update_engine_t* engine, dop_component_t* component) {
+    if (!engine || !component || (unsigned)component->metadata.type >= DOP_COMPONENT_COUNT) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&engine->lock);
+    int result = DOP_SUCCESS;
+    update_batch_t* batch = &engine->batches[component->metadata.type];
+    if (component->metadata.batch_slot != 0) {
+        result = DOP_ERROR_INVALID_STATE;
+    } else if (batch->count == batch->capacity && !batch_grow(batch)) {
+        result = DOP_ERROR_MEMORY_ALLOCATION;
+    } else {
+        batch->components[batch->count++] = component;
+        component->metadata.batch_slot = batch->count;
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return result;
+}
+
+int dop_update_engine_remove(dop_update_engine_t* engine, dop_component_t* component) {
+    if (!engine || !component || (unsigned)component->metadata.type >= DOP_COMPONENT_COUNT) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&engine->lock);
+    update_batch_t* batch = &engine->batches[component->metadata.type];
+    uint32_t slot = component->metadata.batch_slot;
+    if (slot == 0 || slot > batch->count || batch->components[slot - 1] != component) {
+        pthread_mutex_unlock(&engine->lock);
+        return DOP_ERROR_INVALID_STATE;     // Not in this engine
+    }
+
+    // Move the last component into the gap
+    dop_component_t* last = batch->components[--batch->count];
+    batch->components[slot - 1] = last;
+    last->metadata.batch_slot = slot;
+    component->metadata.batch_slot = 0;
+    pthread_mutex_unlock(&engine->lock);
+    return DOP_SUCCESS;
+}
+
+uint32_t dop_update_engine_tick(dop_update_engine_t* engine) {
+    if (!engine) return 0;
+
+    pthread_mutex_lock(&engine->lock);
+    dop_time_data_t now = dop_time_get_current();
+    uint32_t updated = 0;
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) {
+        update_batch_t* batch = &engine->batches[type];
+        for (uint32_t first = 0; first < batch->count; first += UPDATE_BLOCK) {
+            uint32_t count = batch->count - first < UPDATE_BLOCK ? batch->count - first : UPDATE_BLOCK;
+            updated += update_block(batch->components + first, count, (dop_component_type_t)type, now);
+        }
+    }
+    pthread_mutex_unlock(&engine->lock);
+    return updated;
+}
+
+uint32_t dop_update_engine_count(dop_update_engine_t* engine, dop_component_type_t type) {
+    if (!engine || (unsigned)type >= DOP_COMPONENT_COUNT) return 0;
+    pthread_mutex_lock(&engine->lock);
+    uint32_t count = engine->batches[type].count;
+    pthread_mutex_unlock(&engine->lock);
+    return count;
+}
@@ -0,0 +1,398 @@
+// src/nexus_dependency_plan.c
+// OBINexus Computing - Nexus-Link Dependency Resolution
+// Whole-graph resolution into a levelled activation plan
+
+#define _POSIX_C_SOURCE 200809L
+#include "nexus_link_semserver_x.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_RESOLVER_THREADS 64
+#define MAX_DEPENDENCIES 32   // Size of component_manifest_t.dependencies
+
+typedef struct {
+    component_manifest_t* manifest;
+    uint32_t* dependencies;       // Node indices
+    uint32_t dependency_count;
+    uint32_t level;
+} graph_node_t;
+
+// Shared by the workers, under mutex. Nodes are appended as components are
+// first seen and expanded in that order, so [next_to_expand, node_count)
+// is the work queue and a component is queued exactly once.
+typedef struct {
+    nexus_resolution_context_t* ctx;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    graph_node_t* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    uint32_t* slots;              // Open addressing by identifier: node index + 1
+    uint32_t slot_capacity;
+    uint32_t next_to_expand;
+    uint32_t expanding;           // Workers between taking a node and recording it
+    bool stop;                    // Conflict found or out of memory
+    bool out_of_memory;
+    nexus_activation_plan_t* plan;
+} resolver_t;
+
+// What one dependency of an expanded component came to
+typedef struct {
+    enum { EDGE_RESOLVED, EDGE_SKIPPED, EDGE_MISSING, EDGE_VERSION } outcome;
+    component_manifest_t* manifest;
+} edge_t;
+
+static uint64_t hash_id(const char* id) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *id; id++) {
+        hash ^= (uint8_t)*id;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static bool version_set(const semantic_version_x_t* version) {
+    return version->major || version->minor || version->patch || version->hotfix;
+}
+
+// min and max bound the range when set; the strategy applies against min
+static bool version_satisfies(const semantic_version_x_t* provided,
+                              const semantic_version_x_t* min,
+                              const semantic_version_x_t* max,
+                              resolution_strategy_t strategy) {
+    if (version_set(min)) {
+        if (nexus_compare_versions(provided, min) < 0) return false;
+        if (!nexus_version_compatible(min, provided, strategy)) return false;
+    }
+    return !version_set(max) || nexus_compare_versions(provided, max) <= 0;
+}
+
+static void add_conflict(nexus_activation_plan_t* plan, nexus_conflict_kind_t kind,
+                         const char* component_id, const char* required_by) {
+    if (plan->conflict_count < NEXUS_PLAN_MAX_CONFLICTS) {
+        nexus_dependency_conflict_t* conflict = &plan->conflicts[plan->conflict_count];
+        conflict->kind = kind;
+        snprintf(conflict->component_id, sizeof(conflict->component_id), "%s", component_id);
+        snprintf(conflict->required_by, sizeof(conflict->required_by), "%s",
+                 required_by ? required_by : "");
+    }
+    plan->conflict_count++;
+}
+
+static bool grow_slots(resolver_t* resolver) {
+    uint32_t capacity = resolver->slot_capacity ? resolver->slot_capacity * 2 : 64;
+    uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+    if (!slots) return false;
+    for (uint32_t i = 0; i < resolver->node_count; i++) {
+        uint32_t slot = (uint32_t)hash_id(resolver->nodes[i].manifest->component_id) & (capacity - 1);
+        while (slots[slot]) slot = (slot + 1) & (capacity - 1);
+        slots[slot] = i + 1;
+    }
+    free(resolver->slots);
+    resolver->slots = slots;
+    resolver->slot_capacity = capacity;
+    return true;
+}
+
+// Node index of a manifest, adding it to the graph and the work queue the
+// first time it is seen. UINT32_MAX when out of memory. Under mutex.
+static uint32_t intern_node(resolver_t* resolver, component_manifest_t* manifest) {
+    const char* id = manifest->component_id;
+    if (resolver->slot_capacity) {
+        uint32_t slot = (uint32_t)hash_id(id) & (resolver->slot_capacity - 1);
+        for (; resolver->slots[slot]; slot = (slot + 1) & (resolver->slot_capacity - 1)) {
+            uint32_t index = resolver->slots[slot] - 1;
+            if (strcmp(resolver->nodes[index].manifest->component_id, id) == 0) return index;
+        }
+    }
+
+    // Keep the table at most half full
+    if ((resolver->node_count + 1) * 2 > resolver->slot_capacity && !grow_slots(resolver)) {
+        return UINT32_MAX;
+    }
+    if (resolver->node_count == resolver->node_capacity) {
+        uint32_t capacity = resolver->node_capacity ? resolver->node_capacity * 2 : 32;
+        graph_node_t* nodes = realloc(resolver->nodes, capacity * sizeof(graph_node_t));
+        if (!nodes) return UINT32_MAX;
+        resolver->nodes = nodes;
+        resolver->node_capacity = capacity;
+    }
+
+    uint32_t index = resolver->node_count++;
+    memset(&resolver->nodes[index], 0, sizeof(graph_node_t));
+    resolver->nodes[index].manifest = manifest;
+    uint32_t slot = (uint32_t)hash_id(id) & (resolver->slot_capacity - 1);
+    while (resolver->slots[slot]) slot = (slot + 1) & (resolver->slot_capacity - 1);
+    resolver->slots[slot] = index + 1;
+    return index;
+}
+
+// Resolve every dependency of a component, outside the lock: lookups go to
+// the lock-free index and the resolution cache
+static void expand(nexus_resolution_context_t* ctx, const component_manifest_t* manifest,
+                   edge_t* edges) {
+    for (uint32_t i = 0; i < manifest->dependency_count && i < MAX_DEPENDENCIES; i++) {
+        const char* id = manifest->dependencies[i].dependency_id;
+        bool optional = manifest->dependencies[i].is_optional;
+        component_manifest_t* dependency = nexus_resolve_component(ctx, id, NULL,
+                                                                   manifest->dependencies[i].strategy);
+        edges[i].manifest = dependency;
+        if (!dependency) {
+            edges[i].outcome = optional ? EDGE_SKIPPED : EDGE_MISSING;
+        } else if (!version_satisfies(&dependency->version,
+                                      &manifest->dependencies[i].min_version,
+                                      &manifest->dependencies[i].max_version,
+                                      manifest->dependencies[i].strategy)) {
+            edges[i].outcome = optional ? EDGE_SKIPPED : EDGE_VERSION;
+        } else {
+            edges[i].outcome = EDGE_RESOLVED;
+        }
+    }
+}
+
+// Under mutex
+static void record(resolver_t* resolver, uint32_t index, const edge_t* edges) {
+    const component_manifest_t* manifest = resolver->nodes[index].manifest;
+    uint32_t count = manifest->dependency_count < MAX_DEPENDENCIES
+        ? manifest->dependency_count : MAX_DEPENDENCIES;
+    uint32_t* dependencies = count ? malloc(count * sizeof(uint32_t)) : NULL;
+    if (count && !dependencies) {
+        resolver->out_of_memory = resolver->stop = true;
+        return;
+    }
+
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const char* id = manifest->dependencies[i].dependency_id;
+        switch (edges[i].outcome) {
+            case EDGE_SKIPPED:
+                break;
+            case EDGE_MISSING:
+                add_conflict(resolver->plan, NEXUS_CONFLICT_MISSING, id, manifest->component_id);
+                resolver->stop = true;
+                break;
+            case EDGE_VERSION:
+                add_conflict(resolver->plan, NEXUS_CONFLICT_VERSION, id, manifest->component_id);
+                resolver->stop = true;
+                break;
+            case EDGE_RESOLVED: {
+                uint32_t dependency = intern_node(resolver, edges[i].manifest);
+                if (dependency == UINT32_MAX) {
+                    resolver->out_of_memory = resolver->stop = true;
+                    break;
+                }
+                dependencies[used++] = dependency;
+                break;
+            }
+        }
+    }
+    // nodes may have moved while interning
+    resolver->nodes[index].dependencies = dependencies;
+    resolver->nodes[index].dependency_count = used;
+}
+
+static void* resolver_worker(void* arg) {
+    resolver_t* resolver = arg;
+    edge_t edges[MAX_DEPENDENCIES];
+
+    pthread_mutex_lock(&resolver->mutex);
+    for (;;) {
+        while (!resolver->stop && resolver->next_to_expand == resolver->node_count &&
+               resolver->expanding > 0) {
+            pthread_cond_wait(&resolver->changed, &resolver->mutex);
+        }
+        // Nothing queued and nobody left to queue more: the graph is complete
+        if (resolver->stop || resolver->next_to_expand == resolver->node_count) break;
+
+        uint32_t index = resolver->next_to_expand++;
+        component_manifest_t* manifest = resolver->nodes[index].manifest;
+        resolver->expanding++;
+        pthread_mutex_unlock(&resolver->mutex);
+
+        expand(resolver->ctx, manifest, edges);
+
+        pthread_mutex_lock(&resolver->mutex);
+        if (!resolver->stop) record(resolver, index, edges);
+        resolver->expanding--;
+        pthread_cond_broadcast(&resolver->changed);
+    }
+    pthread_cond_broadcast(&resolver->changed);
+    pthread_mutex_unlock(&resolver->mutex);
+    return NULL;
+}
+
+// Some component whose dependencies never all got placed lies on a cycle or
+// depends on one; following unplaced dependencies from it must revisit a
+// node, and that node is on the cycle
+static void report_cycle(resolver_t* resolver, const uint32_t* pending) {
+    uint32_t start = 0;
+    while (pending[start] == 0) start++;
+
+    uint8_t* seen = calloc(resolver->node_count, 1);
+    if (!seen) {
+        resolver->out_of_memory = true;
+        return;
+    }
+    uint32_t current = start, previous = start;
+    while (!seen[current]) {
+        seen[current] = 1;
+        graph_node_t* node = &resolver->nodes[current];
+        for (uint32_t i = 0; i < node->dependency_count; i++) {
+            if (pending[node->dependencies[i]]) {
+                previous = current;
+                current = node->dependencies[i];
+                break;
+            }
+        }
+    }
+    add_conflict(resolver->plan, NEXUS_CONFLICT_CYCLE,
+                 resolver->nodes[current].manifest->component_id,
+                 resolver->nodes[previous].manifest->component_id);
+    free(seen);
+}
+
+static int compare_by_level(const void* a, const void* b) {
+    const graph_node_t* x = a;
+    const graph_node_t* y = b;
+    if (x->level != y->level) return x->level < y->level ? -1 : 1;
+    return strcmp(x->manifest->component_id, y->manifest->component_id);
+}
+
+// Kahn's algorithm over the finished graph: a node's level is one past the
+// deepest of its dependencies. Within a level, order by identifier, so the
+// plan does not depend on which worker got where first.
+static bool build_plan(resolver_t* resolver) {
+    uint32_t count = resolver->node_count;
+    nexus_activation_plan_t* plan = resolver->plan;
+    uint32_t* pending = calloc(count, sizeof(uint32_t));     // Unplaced dependencies
+    uint32_t* dependent_start = calloc(count + 1, sizeof(uint32_t));
+    uint32_t* queue = malloc(count * sizeof(uint32_t));
+    uint32_t total_edges = 0;
+    for (uint32_t i = 0; i < count; i++) total_edges += resolver->nodes[i].dependency_count;
+    uint32_t* dependents = malloc((total_edges ? total_edges : 1) * sizeof(uint32_t));
+    plan->order = malloc(count * sizeof(component_manifest_t*));
+    plan->levels = malloc(count * sizeof(uint32_t));
+    if (!pending || !dependent_start || !queue || !dependents || !plan->order || !plan->levels) {
+        free(pending); free(dependent_start); free(queue); free(dependents);
+        return false;
+    }
+
+    // Reverse edges, grouped by dependency
+    for (uint32_t i = 0; i < count; i++) {
+        graph_node_t* node = &resolver->nodes[i];
+        pending[i] = node->dependency_count;
+        for (uint32_t j = 0; j < node->dependency_count; j++) {
+            dependent_start[node->dependencies[j] + 1]++;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) dependent_start[i + 1] += dependent_start[i];
+    uint32_t* fill = queue;   // Borrowed as fill cursors before the queue is used
+    memcpy(fill, dependent_start, count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        graph_node_t* node = &resolver->nodes[i];
+        for (uint32_t j = 0; j < node->dependency_count; j++) {
+            dependents[fill[node->dependencies[j]]++] = i;
+        }
+    }
+
+    uint32_t head = 0, tail = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (pending[i] == 0) queue[tail++] = i;
+    }
+    while (head < tail) {
+        uint32_t index = queue[head++];
+        graph_node_t* node = &resolver->nodes[index];
+        for (uint32_t i = 0; i < node->dependency_count; i++) {
+            uint32_t level = resolver->nodes[node->dependencies[i]].level + 1;
+            if (level > node->level) node->level = level;
+        }
+        for (uint32_t i = dependent_start[index]; i < dependent_start[index + 1]; i++) {
+            if (--pending[dependents[i]] == 0) queue[tail++] = dependents[i];
+        }
+    }
+
+    if (tail < count) {
+        report_cycle(resolver, pending);
+    } else {
+        // Edges are no longer needed, so the nodes themselves can be sorted
+        qsort(resolver->nodes, count, sizeof(graph_node_t), compare_by_level);
+        for (uint32_t i = 0; i < count; i++) {
+            graph_node_t* node = &resolver->nodes[i];
+            plan->order[i] = node->manifest;
+            plan->levels[i] = node->level;
+            if (node->level + 1 > plan->level_count) plan->level_count = node->level + 1;
+        }
+        plan->count = count;
+    }
+
+    free(pending);
+    free(dependent_start);
+    free(queue);
+    free(dependents);
+    return !resolver->out_of_memory;
+}
+
+nexus_activation_plan_t* nexus_resolve_dependencies(
+    nexus_resolution_context_t* ctx,
+    const char* const* root_ids,
+    uint32_t root_count,
+    uint32_t threads
+) {
+    if (!ctx || (root_count && !root_ids)) return NULL;
+    nexus_activation_plan_t* plan = calloc(1, sizeof(nexus_activation_plan_t));
+    if (!plan) return NULL;
+
+    resolver_t resolver = { .ctx = ctx, .plan = plan };
+    pthread_mutex_init(&resolver.mutex, NULL);
+    pthread_cond_init(&resolver.changed, NULL);
+
+    for (uint32_t i = 0; i < root_count && !resolver.stop; i++) {
+        component_manifest_t* root = nexus_resolve_component(ctx, root_ids[i], NULL,
+                                                             ctx->default_strategy);
+        if (!root) {
+            add_conflict(plan, NEXUS_CONFLICT_MISSING, root_ids[i], NULL);
+            resolver.stop = true;
+        } else if (intern_node(&resolver, root) == UINT32_MAX) {
+            resolver.out_of_memory = resolver.stop = true;
+        }
+    }
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1;
+    }
+    if (threads > MAX_RESOLVER_THREADS) threads = MAX_RESOLVER_THREADS;
+
+    // The calling thread is a worker too
+    pthread_t workers[MAX_RESOLVER_THREADS];
+    uint32_t started = 0;
+    while (started + 1 < threads &&
+           pthread_create(&workers[started], NULL, resolver_worker, &resolver) == 0) {
+        started++;
+    }
+    resolver_worker(&resolver);
+    for (uint32_t i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+    bool ok = !resolver.out_of_memory;
+    if (ok && plan->conflict_count == 0) ok = build_plan(&resolver);
+
+    for (uint32_t i = 0; i < resolver.node_count; i++) free(resolver.nodes[i].dependencies);
+    free(resolver.nodes);
+    free(resolver.slots);
+    pthread_cond_destroy(&resolver.changed);
+    pthread_mutex_destroy(&resolver.mutex);
+    if (!ok) {
+        nexus_free_activation_plan(plan);
+        return NULL;
+    }
+    return plan;
+}
+
+void nexus_free_activation_plan(nexus_activation_plan_t* plan) {
+    if (!plan) return;
+    free(plan->order);
+    free(plan->levels);
+    free(plan);
+}
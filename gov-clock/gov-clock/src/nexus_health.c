@@ -0,0 +1,562 @@
+// src/nexus_health.c
+// OBINexus Computing - Nexus-Link Health Monitoring
+// Circuit breakers and the scheduler that keeps components checked
+
+#define _POSIX_C_SOURCE 200809L
+#include "nexus_link_semserver_x.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_HEALTH_THREADS 256
+
+// ============================================================================
+// Circuit Breaker
+// ============================================================================
+
+static inline circuit_state_t circuit_state(uint64_t word) {
+    return (circuit_state_t)(word & CIRCUIT_STATE_MASK);
+}
+
+static inline uint64_t circuit_count(uint64_t word) {
+    return (word >> CIRCUIT_COUNT_SHIFT) & CIRCUIT_COUNT_MASK;
+}
+
+static inline uint64_t circuit_until(uint64_t word) {
+    return word >> CIRCUIT_UNTIL_SHIFT;
+}
+
+static inline uint64_t circuit_word(circuit_state_t state, uint64_t count, uint64_t until) {
+    if (count > CIRCUIT_COUNT_MASK) count = CIRCUIT_COUNT_MASK;
+    return (uint64_t)state | (count << CIRCUIT_COUNT_SHIFT) | (until << CIRCUIT_UNTIL_SHIFT);
+}
+
+// Threads take stripes round robin and keep them
+static _Atomic uint32_t g_next_stripe = 0;
+static _Thread_local uint32_t t_stripe = UINT32_MAX;
+
+static void window_record(circuit_breaker_t* breaker, uint64_t now, bool failed) {
+    if (t_stripe == UINT32_MAX) {
+        t_stripe = atomic_fetch_add_explicit(&g_next_stripe, 1, memory_order_relaxed) %
+                   CIRCUIT_WINDOW_STRIPES;
+    }
+    _Atomic uint64_t* bucket = &breaker->window[t_stripe].buckets[now % CIRCUIT_WINDOW_SECONDS];
+    uint64_t second = now & 0xffffffffULL;
+    uint64_t old = atomic_load_explicit(bucket, memory_order_relaxed);
+    uint64_t new_value;
+    do {
+        // A bucket left from an earlier pass round the window starts over
+        uint64_t failures = (old >> 32) == second ? (old >> 16) & 0xffff : 0;
+        uint64_t successes = (old >> 32) == second ? old & 0xffff : 0;
+        if (failed && failures < 0xffff) failures++;
+        if (!failed && successes < 0xffff) successes++;
+        new_value = (second << 32) | (failures << 16) | successes;
+    } while (!atomic_compare_exchange_weak_explicit(bucket, &old, new_value,
+                                                    memory_order_relaxed, memory_order_relaxed));
+}
+
+// At least half of a big enough window failed
+static bool window_tripped(circuit_breaker_t* breaker, uint64_t now) {
+    uint64_t failures = 0, calls = 0;
+    for (int stripe = 0; stripe < CIRCUIT_WINDOW_STRIPES; stripe++) {
+        for (int i = 0; i < CIRCUIT_WINDOW_SECONDS; i++) {
+            uint64_t value = atomic_load_explicit(&breaker->window[stripe].buckets[i],
+                                                  memory_order_relaxed);
+            uint64_t age = (now & 0xffffffffULL) - (value >> 32);
+            if (value == 0 || age >= CIRCUIT_WINDOW_SECONDS) continue;
+            failures += (value >> 16) & 0xffff;
+            calls += ((value >> 16) & 0xffff) + (value & 0xffff);
+        }
+    }
+    return calls >= CIRCUIT_WINDOW_MIN_CALLS && failures * 2 >= calls;
+}
+
+void nexus_circuit_init(circuit_breaker_t* breaker, const char* component_id) {
+    if (!breaker) return;
+    memset(breaker->component_id, 0, sizeof(breaker->component_id));
+    if (component_id) {
+        strncpy(breaker->component_id, component_id, sizeof(breaker->component_id) - 1);
+    }
+    atomic_init(&breaker->state, circuit_word(CIRCUIT_CLOSED, 0, 0));
+    for (int stripe = 0; stripe < CIRCUIT_WINDOW_STRIPES; stripe++) {
+        for (int i = 0; i < CIRCUIT_WINDOW_SECONDS; i++) {
+            atomic_init(&breaker->window[stripe].buckets[i], 0);
+        }
+    }
+}
+
+bool nexus_circuit_allow(circuit_breaker_t* breaker) {
+    uint64_t word = atomic_load_explicit(&breaker->state, memory_order_relaxed);
+
+    switch (circuit_state(word)) {
+        case CIRCUIT_CLOSED:
+            // Normal operation - allow requests
+            return true;
+
+        case CIRCUIT_OPEN:
+            // Check if we should transition to half-open
+            if ((uint64_t)time(NULL) < circuit_until(word)) {
+                return false;
+            }
+            // Losing the race means another caller moved it on; either way
+            // this request is let through as a test
+            atomic_compare_exchange_strong_explicit(&breaker->state, &word,
+                                                    circuit_word(CIRCUIT_HALF_OPEN, 0, 0),
+                                                    memory_order_relaxed, memory_order_relaxed);
+            return true;
+
+        case CIRCUIT_HALF_OPEN:
+            // In testing phase - allow limited requests
+            return true;
+    }
+
+    return false;
+}
+
+bool nexus_circuit_record_failure(circuit_breaker_t* breaker) {
+    uint64_t now = (uint64_t)time(NULL);
+    window_record(breaker, now, true);
+
+    uint64_t word = atomic_load_explicit(&breaker->state, memory_order_relaxed);
+    uint64_t next;
+    do {
+        switch (circuit_state(word)) {
+            case CIRCUIT_CLOSED:
+                // Check if we should open the circuit
+                if (circuit_count(word) + 1 >= CIRCUIT_FAILURE_THRESHOLD ||
+                    window_tripped(breaker, now)) {
+                    next = circuit_word(CIRCUIT_OPEN, 0, now + 30);  // 30 second timeout
+                } else {
+                    next = circuit_word(CIRCUIT_CLOSED, circuit_count(word) + 1, 0);
+                }
+                break;
+            case CIRCUIT_HALF_OPEN:
+                // Failed during testing - reopen circuit
+                next = circuit_word(CIRCUIT_OPEN, 0, now + 60);  // Longer timeout
+                break;
+            default:
+                return false;  // Already open
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&breaker->state, &word, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    return circuit_state(next) == CIRCUIT_OPEN;
+}
+
+void nexus_circuit_record_success(circuit_breaker_t* breaker) {
+    window_record(breaker, (uint64_t)time(NULL), false);
+
+    uint64_t word = atomic_load_explicit(&breaker->state, memory_order_relaxed);
+    uint64_t next;
+    do {
+        switch (circuit_state(word)) {
+            case CIRCUIT_CLOSED:
+                if (circuit_count(word) == 0) return;  // Healthy: nothing to write
+                next = circuit_word(CIRCUIT_CLOSED, 0, 0);
+                break;
+            case CIRCUIT_HALF_OPEN:
+                // Sufficient successes - close the circuit
+                next = circuit_count(word) + 1 >= CIRCUIT_RECOVERY_SUCCESSES
+                    ? circuit_word(CIRCUIT_CLOSED, 0, 0)
+                    : circuit_word(CIRCUIT_HALF_OPEN, circuit_count(word) + 1, 0);
+                break;
+            default:
+                return;  // A late success does not close an open circuit
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&breaker->state, &word, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+}
+
+// ============================================================================
+// Health Checks
+// ============================================================================
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t realtime_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+// Runs one check; *timed_out says an otherwise passing check overran
+static health_status_t run_check(health_check_config_t* config, void* component, bool* timed_out) {
+    *timed_out = false;
+    health_status_t status = HEALTH_UNKNOWN;
+    if (component && config->check_function) {
+        uint64_t start = monotonic_ns();
+        status = config->check_function(component);
+        if (config->timeout_ms &&
+            monotonic_ns() - start > (uint64_t)config->timeout_ms * 1000000ULL) {
+            *timed_out = status != HEALTH_UNHEALTHY;
+            status = HEALTH_UNHEALTHY;
+        }
+    }
+    config->last_check_time = realtime_ms();
+    config->last_status = status;
+    return status;
+}
+
+health_status_t nexus_check_component_health(
+    nexus_resolution_context_t* ctx,
+    const char* component_id,
+    health_check_config_t* config
+) {
+    if (!ctx || !component_id || !config) return HEALTH_UNKNOWN;
+
+    component_manifest_t* manifest = nexus_resolve_component(ctx, component_id, NULL,
+                                                             ctx->default_strategy);
+    bool timed_out;
+    return run_check(config, manifest, &timed_out);
+}
+
+// ============================================================================
+// Health Check Scheduler
+// ============================================================================
+
+typedef struct {
+    char component_id[128];
+    void* component;                  // NULL to resolve at each check
+    health_check_config_t config;     // last_* written by the worker checking it
+    circuit_breaker_t* breaker;
+    bool owns_breaker;
+    uint64_t due_ns;                  // Under mutex
+    _Atomic int status;               // health_status_t
+} health_entry_t;
+
+// Every entry is either in the heap or being checked by one worker
+struct nexus_health_scheduler {
+    nexus_resolution_context_t* ctx;
+    health_entry_t* entries;
+    uint32_t capacity;
+    _Atomic uint32_t count;           // Slots published so far
+    uint32_t jitter_percent;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;           // On CLOCK_MONOTONIC
+    uint32_t* heap;                   // Slots, soonest due first
+    uint32_t heap_size;
+    uint64_t rng;
+    bool stop;
+
+    pthread_t* workers;
+    uint32_t worker_count;
+    uint32_t workers_started;
+
+    _Atomic uint64_t checks;
+    _Atomic uint64_t failures;
+    _Atomic uint64_t timeouts;
+    _Atomic uint64_t circuits_opened;
+};
+
+static bool heap_before(const nexus_health_scheduler_t* s, uint32_t a, uint32_t b) {
+    return s->entries[s->heap[a]].due_ns < s->entries[s->heap[b]].due_ns;
+}
+
+static void heap_swap(nexus_health_scheduler_t* s, uint32_t a, uint32_t b) {
+    uint32_t slot = s->heap[a];
+    s->heap[a] = s->heap[b];
+    s->heap[b] = slot;
+}
+
+static void heap_down(nexus_health_scheduler_t* s, uint32_t i) {
+    for (;;) {
+        uint32_t left = 2 * i + 1, right = left + 1, first = i;
+        if (left < s->heap_size && heap_before(s, left, first)) first = left;
+        if (right < s->heap_size && heap_before(s, right, first)) first = right;
+        if (first == i) return;
+        heap_swap(s, i, first);
+        i = first;
+    }
+}
+
+static void heap_push(nexus_health_scheduler_t* s, uint32_t slot) {
+    uint32_t i = s->heap_size++;
+    s->heap[i] = slot;
+    while (i > 0 && heap_before(s, i, (i - 1) / 2)) {
+        heap_swap(s, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static uint32_t heap_pop(nexus_health_scheduler_t* s) {
+    uint32_t slot = s->heap[0];
+    s->heap[0] = s->heap[--s->heap_size];
+    heap_down(s, 0);
+    return slot;
+}
+
+// splitmix64, under mutex
+static uint64_t next_random(nexus_health_scheduler_t* s) {
+    uint64_t z = (s->rng += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// The interval spread by up to jitter_percent either way, under mutex
+static uint64_t jittered_interval_ns(nexus_health_scheduler_t* s, uint32_t interval_ms) {
+    uint64_t interval = (uint64_t)interval_ms * 1000000ULL;
+    uint64_t spread = interval / 100 * s->jitter_percent;
+    if (spread == 0) return interval;
+    return interval - spread + next_random(s) % (2 * spread + 1);
+}
+
+static void deadline_after(struct timespec* deadline, uint64_t due_ns) {
+    deadline->tv_sec = (time_t)(due_ns / 1000000000ULL);
+    deadline->tv_nsec = (long)(due_ns % 1000000000ULL);
+}
+
+static void check_entry(nexus_health_scheduler_t* s, health_entry_t* entry) {
+    void* component = entry->component;
+    if (!component) {
+        component = nexus_resolve_component(s->ctx, entry->component_id, NULL,
+                                            s->ctx->default_strategy);
+    }
+
+    bool timed_out;
+    health_status_t status = run_check(&entry->config, component, &timed_out);
+    atomic_store_explicit(&entry->status, (int)status, memory_order_release);
+    atomic_fetch_add_explicit(&s->checks, 1, memory_order_relaxed);
+
+    if (status == HEALTH_UNHEALTHY) {
+        atomic_fetch_add_explicit(&s->failures, 1, memory_order_relaxed);
+        if (timed_out) atomic_fetch_add_explicit(&s->timeouts, 1, memory_order_relaxed);
+    }
+    if (status == HEALTH_UNKNOWN || !nexus_circuit_allow(entry->breaker)) return;
+
+    if (status == HEALTH_UNHEALTHY) {
+        if (nexus_circuit_record_failure(entry->breaker)) {
+            atomic_fetch_add_explicit(&s->circuits_opened, 1, memory_order_relaxed);
+        }
+    } else {
+        nexus_circuit_record_success(entry->breaker);
+    }
+}
+
+static void* health_worker(void* arg) {
+    nexus_health_scheduler_t* s = arg;
+
+    pthread_mutex_lock(&s->mutex);
+    while (!s->stop) {
+        if (s->heap_size == 0) {
+            pthread_cond_wait(&s->changed, &s->mutex);
+            continue;
+        }
+        uint64_t due = s->entries[s->heap[0]].due_ns;
+        if (due > monotonic_ns()) {
+            struct timespec deadline;
+            deadline_after(&deadline, due);
+            pthread_cond_timedwait(&s->changed, &s->mutex, &deadline);
+            continue;
+        }
+
+        uint32_t slot = heap_pop(s);
+        // Another due entry is for another worker
+        if (s->heap_size > 0) pthread_cond_signal(&s->changed);
+        pthread_mutex_unlock(&s->mutex);
+
+        health_entry_t* entry = &s->entries[slot];
+        check_entry(s, entry);
+
+        pthread_mutex_lock(&s->mutex);
+        entry->due_ns = monotonic_ns() + jittered_interval_ns(s, entry->config.check_interval_ms);
+        heap_push(s, slot);
+        // A worker sleeping until a later entry must wake for this one
+        if (s->heap[0] == slot) pthread_cond_signal(&s->changed);
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return NULL;
+}
+
+nexus_health_scheduler_t* nexus_health_scheduler_create(
+    nexus_resolution_context_t* ctx,
+    const nexus_health_scheduler_config_t* config
+) {
+    if (!ctx || !config || config->max_components == 0 || config->jitter_percent > 100) {
+        return NULL;
+    }
+
+    uint32_t threads = config->max_concurrent;
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1;
+    }
+    if (threads > MAX_HEALTH_THREADS) threads = MAX_HEALTH_THREADS;
+
+    nexus_health_scheduler_t* s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->entries = calloc(config->max_components, sizeof(*s->entries));
+    s->heap = calloc(config->max_components, sizeof(*s->heap));
+    s->workers = calloc(threads, sizeof(*s->workers));
+    if (!s->entries || !s->heap || !s->workers) {
+        free(s->entries);
+        free(s->heap);
+        free(s->workers);
+        free(s);
+        return NULL;
+    }
+
+    s->ctx = ctx;
+    s->capacity = config->max_components;
+    s->jitter_percent = config->jitter_percent;
+    s->worker_count = threads;
+    s->rng = monotonic_ns() ^ (uint64_t)(uintptr_t)s;
+    atomic_init(&s->count, 0);
+    atomic_init(&s->checks, 0);
+    atomic_init(&s->failures, 0);
+    atomic_init(&s->timeouts, 0);
+    atomic_init(&s->circuits_opened, 0);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s->changed, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&s->mutex, NULL);
+    return s;
+}
+
+int nexus_health_scheduler_start(nexus_health_scheduler_t* s) {
+    if (!s) return -1;
+
+    pthread_mutex_lock(&s->mutex);
+    bool running = s->workers_started > 0;
+    s->stop = false;
+    pthread_mutex_unlock(&s->mutex);
+    if (running) return 0;
+
+    for (uint32_t i = 0; i < s->worker_count; i++) {
+        if (pthread_create(&s->workers[i], NULL, health_worker, s) != 0) {
+            nexus_health_scheduler_stop(s);
+            return -1;
+        }
+        s->workers_started++;
+    }
+    return 0;
+}
+
+void nexus_health_scheduler_stop(nexus_health_scheduler_t* s) {
+    if (!s) return;
+
+    pthread_mutex_lock(&s->mutex);
+    s->stop = true;
+    pthread_cond_broadcast(&s->changed);
+    pthread_mutex_unlock(&s->mutex);
+
+    for (uint32_t i = 0; i < s->workers_started; i++) {
+        pthread_join(s->workers[i], NULL);
+    }
+    s->workers_started = 0;
+}
+
+void nexus_health_scheduler_destroy(nexus_health_scheduler_t* s) {
+    if (!s) return;
+
+    nexus_health_scheduler_stop(s);
+    uint32_t count = atomic_load_explicit(&s->count, memory_order_relaxed);
+    for (uint32_t i = 0; i < count; i++) {
+        if (s->entries[i].owns_breaker) free(s->entries[i].breaker);
+    }
+    pthread_cond_destroy(&s->changed);
+    pthread_mutex_destroy(&s->mutex);
+    free(s->entries);
+    free(s->heap);
+    free(s->workers);
+    free(s);
+}
+
+int32_t nexus_health_watch(
+    nexus_health_scheduler_t* s,
+    const char* component_id,
+    void* component,
+    const health_check_config_t* config,
+    circuit_breaker_t* breaker
+) {
+    if (!s || !component_id || !config || !config->check_function ||
+        config->check_interval_ms == 0) {
+        return -1;
+    }
+
+    bool owns_breaker = false;
+    if (!breaker) {
+        breaker = aligned_alloc(_Alignof(circuit_breaker_t), sizeof(circuit_breaker_t));
+        if (!breaker) return -1;
+        nexus_circuit_init(breaker, component_id);
+        owns_breaker = true;
+    }
+
+    pthread_mutex_lock(&s->mutex);
+    uint32_t slot = atomic_load_explicit(&s->count, memory_order_relaxed);
+    if (slot == s->capacity) {
+        pthread_mutex_unlock(&s->mutex);
+        if (owns_breaker) free(breaker);
+        return -1;
+    }
+
+    health_entry_t* entry = &s->entries[slot];
+    strncpy(entry->component_id, component_id, sizeof(entry->component_id) - 1);
+    entry->component = component;
+    entry->config = *config;
+    entry->config.last_check_time = 0;
+    entry->config.last_status = HEALTH_UNKNOWN;
+    entry->breaker = breaker;
+    entry->owns_breaker = owns_breaker;
+    atomic_init(&entry->status, (int)HEALTH_UNKNOWN);
+
+    // The first check lands anywhere in the first interval
+    uint64_t interval = (uint64_t)config->check_interval_ms * 1000000ULL;
+    entry->due_ns = monotonic_ns() + next_random(s) % interval;
+    heap_push(s, slot);
+    atomic_store_explicit(&s->count, slot + 1, memory_order_release);
+    if (s->heap[0] == slot) pthread_cond_signal(&s->changed);
+    pthread_mutex_unlock(&s->mutex);
+
+    return (int32_t)slot;
+}
+
+health_status_t nexus_health_status(const nexus_health_scheduler_t* s, int32_t slot) {
+    if (!s || slot < 0 ||
+        (uint32_t)slot >= atomic_load_explicit(&((nexus_health_scheduler_t*)s)->count,
+                                               memory_order_acquire)) {
+        return HEALTH_UNKNOWN;
+    }
+    return (health_status_t)atomic_load_explicit(&s->entries[slot].status, memory_order_acquire);
+}
+
+circuit_breaker_t* nexus_health_breaker(nexus_health_scheduler_t* s, int32_t slot) {
+    if (!s || slot < 0 ||
+        (uint32_t)slot >= atomic_load_explicit(&s->count, memory_order_acquire)) {
+        return NULL;
+    }
+    return s->entries[slot].breaker;
+}
+
+void nexus_health_check_all(nexus_health_scheduler_t* s) {
+    if (!s) return;
+
+    // Entries being checked are rescheduled by their worker as usual
+    pthread_mutex_lock(&s->mutex);
+    uint64_t now = monotonic_ns();
+    for (uint32_t i = 0; i < s->heap_size; i++) {
+        s->entries[s->heap[i]].due_ns = now;
+    }
+    pthread_cond_broadcast(&s->changed);
+    pthread_mutex_unlock(&s->mutex);
+}
+
+void nexus_health_get_stats(const nexus_health_scheduler_t* s, nexus_health_stats_t* stats) {
+    if (!s || !stats) return;
+
+    nexus_health_scheduler_t* m = (nexus_health_scheduler_t*)s;
+    stats->checks = atomic_load_explicit(&m->checks, memory_order_relaxed);
+    stats->failures = atomic_load_explicit(&m->failures, memory_order_relaxed);
+    stats->timeouts = atomic_load_explicit(&m->timeouts, memory_order_relaxed);
+    stats->circuits_opened = atomic_load_explicit(&m->circuits_opened, memory_order_relaxed);
+    stats->components = atomic_load_explicit(&m->count, memory_order_relaxed);
+}
@@ -0,0 +1,1175 @@
+// src/nexus_link_semserver_x.c
+// OBINexus Computing - Nexus-Link SemServer-X Component Resolution
+// Adaptive radix tree index with lock-free lookups and prefix scans
+
+#define _POSIX_C_SOURCE 200809L  // O_CLOEXEC
+
+#include "nexus_link_semserver_x.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Node types
+#define ART_NODE4   0
+#define ART_NODE16  1
+#define ART_NODE48  2
+#define ART_NODE256 3
+#define ART_LEAF    4
+
+// Prefix bytes kept in a node; the rest of a longer prefix is read from a
+// leaf below it, and lookups confirm it against the leaf they end at
+#define ART_PREFIX_INLINE 12
+
+// Keys are component identifiers with their terminating NUL, so that no
+// key is a prefix of another and every key ends at a leaf
+#define ART_MAX_KEY 128
+
+struct nexus_art_node {
+    uint8_t type;
+    _Atomic uint16_t count;              // Children published
+    uint32_t prefix_length;              // Compressed path above the children
+    uint8_t prefix[ART_PREFIX_INLINE];
+    struct nexus_art_node* next_retired; // Reclamation list
+    uint64_t retired_epoch;
+};
+
+// Node4 and Node16 keep their keys unsorted: a key is written before the
+// count that publishes it, so a reader never sees a half-inserted child
+typedef struct {
+    nexus_art_node_t base;
+    uint8_t keys[4];
+    _Atomic(nexus_art_node_t*) children[4];
+} art_node4_t;
+
+typedef struct {
+    nexus_art_node_t base;
+    uint8_t keys[16];
+    _Atomic(nexus_art_node_t*) children[16];
+} art_node16_t;
+
+typedef struct {
+    nexus_art_node_t base;
+    _Atomic uint8_t index[256];          // Slot + 1 per key byte, 0 when absent
+    _Atomic(nexus_art_node_t*) children[48];
+} art_node48_t;
+
+typedef struct {
+    nexus_art_node_t base;
+    _Atomic(nexus_art_node_t*) children[256];
+} art_node256_t;
+
+typedef struct {
+    nexus_art_node_t base;
+    _Atomic(component_manifest_t*) manifest;
+    uint32_t key_length;
+    uint8_t key[];
+} art_leaf_t;
+
+static const uint16_t art_capacity[] = { 4, 16, 48, 256 };
+
+// ============================================================================
+// Epoch-based reclamation
+// ============================================================================
+
+// A reader publishes the epoch it entered in and clears it on the way
+// out. A node retired in epoch r is freed once every active reader
+// entered after r: those readers started after the node was unlinked.
+typedef struct reader_slot {
+    _Atomic uint64_t epoch;              // 0 outside a read
+    _Atomic bool in_use;
+    uint32_t depth;                      // Nested reads, owner only
+    struct reader_slot* next;
+} reader_slot_t;
+
+static _Atomic uint64_t g_epoch = 1;
+static _Atomic(reader_slot_t*) g_readers = NULL;
+static _Thread_local reader_slot_t* t_reader = NULL;
+static pthread_key_t g_reader_key;
+static pthread_once_t g_reader_once = PTHREAD_ONCE_INIT;
+
+// Slots outlive their threads and are reused by later ones
+static void release_reader_slot(void* slot) {
+    atomic_store_explicit(&((reader_slot_t*)slot)->in_use, false, memory_order_release);
+}
+
+static void create_reader_key(void) {
+    pthread_key_create(&g_reader_key, release_reader_slot);
+}
+
+static reader_slot_t* reader_slot(void) {
+    if (t_reader) return t_reader;
+    pthread_once(&g_reader_once, create_reader_key);
+
+    reader_slot_t* slot;
+    for (slot = atomic_load_explicit(&g_readers, memory_order_acquire); slot; slot = slot->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&slot->in_use, &expected, true)) break;
+    }
+    if (!slot) {
+        slot = calloc(1, sizeof(reader_slot_t));
+        if (!slot) return NULL;
+        atomic_init(&slot->in_use, true);
+        slot->next = atomic_load_explicit(&g_readers, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&g_readers, &slot->next, slot,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    t_reader = slot;
+    pthread_setspecific(g_reader_key, slot);
+    return slot;
+}
+
+// False only when no slot could be allocated
+static bool read_begin(void) {
+    reader_slot_t* slot = reader_slot();
+    if (!slot) return false;
+    if (slot->depth++ == 0) {
+        atomic_store_explicit(&slot->epoch, atomic_load(&g_epoch), memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    return true;
+}
+
+static void read_end(void) {
+    reader_slot_t* slot = t_reader;
+    if (--slot->depth == 0) {
+        atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+    }
+}
+
+// Oldest epoch a reader may still be in, UINT64_MAX with none active
+static uint64_t oldest_reader_epoch(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t oldest = UINT64_MAX;
+    for (reader_slot_t* slot = atomic_load_explicit(&g_readers, memory_order_acquire);
+         slot; slot = slot->next) {
+        uint64_t epoch = atomic_load_explicit(&slot->epoch, memory_order_acquire);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
+
+bool nexus_read_begin(void) {
+    return read_begin();
+}
+
+void nexus_read_end(void) {
+    read_end();
+}
+
+void nexus_synchronize(void) {
+    uint64_t epoch = atomic_fetch_add(&g_epoch, 1);
+    while (oldest_reader_epoch() <= epoch) sched_yield();
+}
+
+// Write mutex held; node is already unreachable from the root
+static void retire_node(nexus_component_index_t* index, nexus_art_node_t* node) {
+    node->retired_epoch = atomic_fetch_add(&g_epoch, 1);
+    node->next_retired = index->retired;
+    index->retired = node;
+}
+
+static void reclaim_nodes(nexus_component_index_t* index) {
+    if (!index->retired) return;
+    uint64_t oldest = oldest_reader_epoch();
+    nexus_art_node_t** link = (nexus_art_node_t**)&index->retired;
+    while (*link) {
+        nexus_art_node_t* node = *link;
+        if (node->retired_epoch < oldest) {
+            *link = node->next_retired;
+            free(node);
+        } else {
+            link = &node->next_retired;
+        }
+    }
+}
+
+// ============================================================================
+// Adaptive radix tree
+// ============================================================================
+
+static nexus_art_node_t* load_child(_Atomic(nexus_art_node_t*)* slot) {
+    return atomic_load_explicit(slot, memory_order_acquire);
+}
+
+static nexus_art_node_t* new_node(uint8_t type) {
+    static const size_t sizes[] = {
+        sizeof(art_node4_t), sizeof(art_node16_t), sizeof(art_node48_t), sizeof(art_node256_t)
+    };
+    nexus_art_node_t* node = calloc(1, sizes[type]);
+    if (node) node->type = type;
+    return node;
+}
+
+static art_leaf_t* new_leaf(const uint8_t* key, uint32_t length, component_manifest_t* manifest) {
+    art_leaf_t* leaf = calloc(1, sizeof(art_leaf_t) + length);
+    if (!leaf) return NULL;
+    leaf->base.type = ART_LEAF;
+    atomic_init(&leaf->manifest, manifest);
+    leaf->key_length = length;
+    memcpy(leaf->key, key, length);
+    return leaf;
+}
+
+// Slot holding the child for byte, or NULL
+static _Atomic(nexus_art_node_t*)* find_child(nexus_art_node_t* node, uint8_t byte) {
+    uint16_t count = atomic_load_explicit(&node->count, memory_order_acquire);
+    switch (node->type) {
+        case ART_NODE4: {
+            art_node4_t* n = (art_node4_t*)node;
+            for (uint16_t i = 0; i < count; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+        }
+        case ART_NODE16: {
+            art_node16_t* n = (art_node16_t*)node;
+            for (uint16_t i = 0; i < count; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return NULL;
+        }
+        case ART_NODE48: {
+            art_node48_t* n = (art_node48_t*)node;
+            uint8_t slot = atomic_load_explicit(&n->index[byte], memory_order_acquire);
+            return slot ? &n->children[slot - 1] : NULL;
+        }
+        case ART_NODE256: {
+            art_node256_t* n = (art_node256_t*)node;
+            return load_child(&n->children[byte]) ? &n->children[byte] : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+// Publish a child in a node with room for it; readers see all or nothing
+static void add_child(nexus_art_node_t* node, uint8_t byte, nexus_art_node_t* child) {
+    uint16_t count = atomic_load_explicit(&node->count, memory_order_relaxed);
+    switch (node->type) {
+        case ART_NODE4:
+            ((art_node4_t*)node)->keys[count] = byte;
+            atomic_store_explicit(&((art_node4_t*)node)->children[count], child, memory_order_relaxed);
+            break;
+        case ART_NODE16:
+            ((art_node16_t*)node)->keys[count] = byte;
+            atomic_store_explicit(&((art_node16_t*)node)->children[count], child, memory_order_relaxed);
+            break;
+        case ART_NODE48: {
+            art_node48_t* n = (art_node48_t*)node;
+            atomic_store_explicit(&n->children[count], child, memory_order_relaxed);
+            atomic_store_explicit(&n->index[byte], (uint8_t)(count + 1), memory_order_release);
+            break;
+        }
+        case ART_NODE256:
+            atomic_store_explicit(&((art_node256_t*)node)->children[byte], child, memory_order_release);
+            break;
+    }
+    atomic_store_explicit(&node->count, count + 1, memory_order_release);
+}
+
+// Visit children in key order; visit returns false to stop
+typedef bool (*child_visitor_t)(nexus_art_node_t* child, void* user_data);
+
+static bool for_each_child(nexus_art_node_t* node, child_visitor_t visit, void* user_data) {
+    uint16_t count = atomic_load_explicit(&node->count, memory_order_acquire);
+    switch (node->type) {
+        case ART_NODE4:
+        case ART_NODE16: {
+            const uint8_t* keys = node->type == ART_NODE4 ? ((art_node4_t*)node)->keys
+                                                          : ((art_node16_t*)node)->keys;
+            _Atomic(nexus_art_node_t*)* children = node->type == ART_NODE4
+                ? ((art_node4_t*)node)->children : ((art_node16_t*)node)->children;
+            uint8_t order[16];
+            for (uint16_t i = 0; i < count; i++) {
+                uint16_t j = i;
+                for (; j > 0 && keys[order[j - 1]] > keys[i]; j--) order[j] = order[j - 1];
+                order[j] = (uint8_t)i;
+            }
+            for (uint16_t i = 0; i < count; i++) {
+                if (!visit(load_child(&children[order[i]]), user_data)) return false;
+            }
+            return true;
+        }
+        case ART_NODE48: {
+            art_node48_t* n = (art_node48_t*)node;
+            for (int byte = 0; byte < 256; byte++) {
+                uint8_t slot = atomic_load_explicit(&n->index[byte], memory_order_acquire);
+                if (slot && !visit(load_child(&n->children[slot - 1]), user_data)) return false;
+            }
+            return true;
+        }
+        case ART_NODE256: {
+            art_node256_t* n = (art_node256_t*)node;
+            for (int byte = 0; byte < 256; byte++) {
+                nexus_art_node_t* child = load_child(&n->children[byte]);
+                if (child && !visit(child, user_data)) return false;
+            }
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+static bool first_child(nexus_art_node_t* child, void* user_data) {
+    *(nexus_art_node_t**)user_data = child;
+    return false;
+}
+
+// Any leaf below node; all of them share its prefix
+static art_leaf_t* any_leaf(nexus_art_node_t* node) {
+    while (node && node->type != ART_LEAF) {
+        nexus_art_node_t* child = NULL;
+        for_each_child(node, first_child, &child);
+        node = child;
+    }
+    return (art_leaf_t*)node;
+}
+
+// Byte i of node's prefix, which starts at depth in the key
+static uint8_t prefix_byte(nexus_art_node_t* node, art_leaf_t** leaf, uint32_t depth, uint32_t i) {
+    if (i < ART_PREFIX_INLINE) return node->prefix[i];
+    if (!*leaf) *leaf = any_leaf(node);
+    return *leaf ? (*leaf)->key[depth + i] : 0;
+}
+
+// Length of the part of node's prefix that key matches from depth
+static uint32_t prefix_mismatch(nexus_art_node_t* node, const uint8_t* key, uint32_t length,
+                                uint32_t depth) {
+    art_leaf_t* leaf = NULL;
+    uint32_t i = 0;
+    for (; i < node->prefix_length && depth + i < length; i++) {
+        if (prefix_byte(node, &leaf, depth, i) != key[depth + i]) break;
+    }
+    return i;
+}
+
+static void set_prefix(nexus_art_node_t* node, const uint8_t* bytes, uint32_t length) {
+    node->prefix_length = length;
+    memcpy(node->prefix, bytes, length < ART_PREFIX_INLINE ? length : ART_PREFIX_INLINE);
+}
+
+// A copy of node, one size up when grow is set, for publishing in its
+// place; children are shared with the original
+static nexus_art_node_t* copy_node(nexus_art_node_t* node, bool grow) {
+    nexus_art_node_t* copy = new_node(grow ? node->type + 1 : node->type);
+    if (!copy) return NULL;
+    copy->prefix_length = node->prefix_length;
+    memcpy(copy->prefix, node->prefix, sizeof(copy->prefix));
+
+    uint16_t count = atomic_load_explicit(&node->count, memory_order_relaxed);
+    switch (node->type) {
+        case ART_NODE4:
+        case ART_NODE16: {
+            const uint8_t* keys = node->type == ART_NODE4 ? ((art_node4_t*)node)->keys
+                                                          : ((art_node16_t*)node)->keys;
+            _Atomic(nexus_art_node_t*)* children = node->type == ART_NODE4
+                ? ((art_node4_t*)node)->children : ((art_node16_t*)node)->children;
+            for (uint16_t i = 0; i < count; i++) {
+                add_child(copy, keys[i], load_child(&children[i]));
+            }
+            break;
+        }
+        case ART_NODE48: {
+            art_node48_t* n = (art_node48_t*)node;
+            for (int byte = 0; byte < 256; byte++) {
+                uint8_t slot = atomic_load_explicit(&n->index[byte], memory_order_relaxed);
+                if (slot) add_child(copy, (uint8_t)byte, load_child(&n->children[slot - 1]));
+            }
+            break;
+        }
+        case ART_NODE256: {
+            art_node256_t* n = (art_node256_t*)node;
+            for (int byte = 0; byte < 256; byte++) {
+                nexus_art_node_t* child = load_child(&n->children[byte]);
+                if (child) add_child(copy, (uint8_t)byte, child);
+            }
+            break;
+        }
+    }
+    return copy;
+}
+
+static bool leaf_matches(const art_leaf_t* leaf, const uint8_t* key, uint32_t length) {
+    return leaf->key_length == length && memcmp(leaf->key, key, length) == 0;
+}
+
+static art_leaf_t* art_lookup(nexus_component_index_t* index, const uint8_t* key, uint32_t length) {
+    nexus_art_node_t* node = atomic_load_explicit(&index->root, memory_order_acquire);
+    uint32_t depth = 0;
+    while (node) {
+        if (node->type == ART_LEAF) {
+            art_leaf_t* leaf = (art_leaf_t*)node;
+            return leaf_matches(leaf, key, length) ? leaf : NULL;
+        }
+        // Only the inline part here; the leaf settles the rest
+        uint32_t inline_length = node->prefix_length < ART_PREFIX_INLINE
+                               ? node->prefix_length : ART_PREFIX_INLINE;
+        if (depth + node->prefix_length >= length ||
+            memcmp(node->prefix, key + depth, inline_length) != 0) {
+            return NULL;
+        }
+        depth += node->prefix_length;
+        _Atomic(nexus_art_node_t*)* slot = find_child(node, key[depth]);
+        if (!slot) return NULL;
+        node = load_child(slot);
+        depth++;
+    }
+    return NULL;
+}
+
+// Write mutex held. Returns 0 when added, 1 when an existing entry was
+// replaced, -1 when out of memory.
+static int art_insert(nexus_component_index_t* index, const uint8_t* key, uint32_t length,
+                      component_manifest_t* manifest) {
+    _Atomic(nexus_art_node_t*)* ref = &index->root;
+    nexus_art_node_t* node = load_child(ref);
+    uint32_t depth = 0;
+
+    for (;;) {
+        if (!node) {
+            art_leaf_t* leaf = new_leaf(key, length, manifest);
+            if (!leaf) return -1;
+            atomic_store_explicit(ref, &leaf->base, memory_order_release);
+            return 0;
+        }
+
+        if (node->type == ART_LEAF) {
+            art_leaf_t* existing = (art_leaf_t*)node;
+            if (leaf_matches(existing, key, length)) {
+                atomic_store_explicit(&existing->manifest, manifest, memory_order_release);
+                return 1;
+            }
+            // Both keys end in NUL, so they part before either ends
+            uint32_t common = 0;
+            while (existing->key[depth + common] == key[depth + common]) common++;
+
+            nexus_art_node_t* split = new_node(ART_NODE4);
+            art_leaf_t* leaf = new_leaf(key, length, manifest);
+            if (!split || !leaf) {
+                free(split);
+                free(leaf);
+                return -1;
+            }
+            set_prefix(split, key + depth, common);
+            add_child(split, existing->key[depth + common], node);
+            add_child(split, key[depth + common], &leaf->base);
+            atomic_store_explicit(ref, split, memory_order_release);
+            return 0;
+        }
+
+        if (node->prefix_length > 0) {
+            uint32_t matched = prefix_mismatch(node, key, length, depth);
+            if (matched < node->prefix_length) {
+                // The key leaves the compressed path part way: a new node
+                // takes the common part, and a copy of this one the rest
+                art_leaf_t* below = any_leaf(node);
+                nexus_art_node_t* split = new_node(ART_NODE4);
+                nexus_art_node_t* rest = copy_node(node, false);
+                art_leaf_t* leaf = new_leaf(key, length, manifest);
+                if (!below || !split || !rest || !leaf) {
+                    free(split);
+                    free(rest);
+                    free(leaf);
+                    return -1;
+                }
+                set_prefix(split, key + depth, matched);
+                set_prefix(rest, below->key + depth + matched + 1,
+                           node->prefix_length - matched - 1);
+                add_child(split, below->key[depth + matched], rest);
+                add_child(split, key[depth + matched], &leaf->base);
+                atomic_store_explicit(ref, split, memory_order_release);
+                retire_node(index, node);
+                return 0;
+            }
+            depth += node->prefix_length;
+        }
+
+        _Atomic(nexus_art_node_t*)* slot = find_child(node, key[depth]);
+        if (slot) {
+            ref = slot;
+            node = load_child(slot);
+            depth++;
+            continue;
+        }
+
+        art_leaf_t* leaf = new_leaf(key, length, manifest);
+        if (!leaf) return -1;
+        if (atomic_load_explicit(&node->count, memory_order_relaxed) < art_capacity[node->type]) {
+            add_child(node, key[depth], &leaf->base);
+            return 0;
+        }
+        nexus_art_node_t* grown = copy_node(node, true);
+        if (!grown) {
+            free(leaf);
+            return -1;
+        }
+        add_child(grown, key[depth], &leaf->base);
+        atomic_store_explicit(ref, grown, memory_order_release);
+        retire_node(index, node);
+        return 0;
+    }
+}
+
+static void free_tree(nexus_art_node_t* node) {
+    if (!node) return;
+    if (node->type != ART_LEAF) {
+        // Children first; this node goes last
+        for (int byte = 0; byte < 256; byte++) {
+            _Atomic(nexus_art_node_t*)* slot = find_child(node, (uint8_t)byte);
+            if (slot) free_tree(load_child(slot));
+        }
+    }
+    free(node);
+}
+
+// Length of text, looking no further than ART_MAX_KEY bytes
+static size_t bounded_length(const char* text) {
+    size_t size = 0;
+    while (size < ART_MAX_KEY && text[size] != '\0') size++;
+    return size;
+}
+
+// Identifier as a key: its bytes and the terminating NUL
+static bool component_key(const char* component_id, uint32_t* length) {
+    size_t size = component_id ? bounded_length(component_id) : ART_MAX_KEY;
+    if (size == 0 || size >= ART_MAX_KEY) return false;
+    *length = (uint32_t)size + 1;
+    return true;
+}
+
+// ============================================================================
+// Prefix scan
+// ============================================================================
+
+typedef struct {
+    search_results_t* results;
+    const char* taxonomy_filter;
+} scan_state_t;
+
+static bool collect_leaves(nexus_art_node_t* node, void* user_data) {
+    scan_state_t* scan = user_data;
+    search_results_t* results = scan->results;
+    if (results->result_count >= results->max_results) return false;
+    if (node->type != ART_LEAF) return for_each_child(node, collect_leaves, scan);
+
+    component_manifest_t* manifest =
+        atomic_load_explicit(&((art_leaf_t*)node)->manifest, memory_order_acquire);
+    if (manifest && (!scan->taxonomy_filter ||
+                     strcmp(manifest->taxonomy_class, scan->taxonomy_filter) == 0)) {
+        results->results[results->result_count++] = manifest;
+    }
+    return results->result_count < results->max_results;
+}
+
+// The subtree holding every key that starts with prefix, or NULL
+static nexus_art_node_t* find_prefix(nexus_component_index_t* index, const uint8_t* prefix,
+                                     uint32_t length) {
+    nexus_art_node_t* node = atomic_load_explicit(&index->root, memory_order_acquire);
+    uint32_t depth = 0;
+    while (node && depth < length) {
+        if (node->type == ART_LEAF) {
+            art_leaf_t* leaf = (art_leaf_t*)node;
+            return leaf->key_length > length && memcmp(leaf->key, prefix, length) == 0
+                 ? node : NULL;
+        }
+        // A prefix that ends inside the compressed path takes the subtree
+        uint32_t matched = prefix_mismatch(node, prefix, length, depth);
+        if (matched < node->prefix_length && depth + matched < length) return NULL;
+        depth += node->prefix_length;
+        if (depth >= length) break;
+        _Atomic(nexus_art_node_t*)* slot = find_child(node, prefix[depth]);
+        node = slot ? load_child(slot) : NULL;
+        depth++;
+    }
+    return node;
+}
+
+// ============================================================================
+// Resolution cache
+// ============================================================================
+
+#define CACHE_SHARD_CAPACITY (NEXUS_RESOLUTION_CACHE_CAPACITY / NEXUS_RESOLUTION_CACHE_SHARDS)
+#define CACHE_BUCKETS CACHE_SHARD_CAPACITY      // Per shard, a power of two
+
+typedef struct cache_entry {
+    uint64_t hash;
+    char component_id[ART_MAX_KEY];
+    bool has_version;                    // Resolved without a requested version if not
+    uint32_t major, minor, patch, hotfix;
+    char prerelease[64];
+    resolution_strategy_t strategy;
+    component_manifest_t* manifest;      // NULL for a cached miss
+    struct cache_entry* hash_next;
+    struct cache_entry* lru_prev;        // Toward the most recently used
+    struct cache_entry* lru_next;
+} cache_entry_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    cache_entry_t* buckets[CACHE_BUCKETS];
+    cache_entry_t* lru_head;             // Most recently used
+    cache_entry_t* lru_tail;
+    uint32_t entries;
+    uint64_t generation;                 // Bumped by every invalidation
+    uint64_t hits, negative_hits, misses, evictions, invalidations;
+} cache_shard_t;
+
+struct nexus_resolution_cache {
+    cache_shard_t shards[NEXUS_RESOLUTION_CACHE_SHARDS];
+};
+
+// What a resolve call is asked; copied into the entry it fills
+typedef struct {
+    const char* component_id;
+    const semantic_version_x_t* version;
+    resolution_strategy_t strategy;
+    uint64_t id_hash;
+    uint64_t hash;
+} cache_key_t;
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void make_cache_key(cache_key_t* key, const char* component_id,
+                           const semantic_version_x_t* version, resolution_strategy_t strategy) {
+    key->component_id = component_id;
+    key->version = version;
+    key->strategy = strategy;
+    key->id_hash = fnv1a(0xcbf29ce484222325ULL, component_id, strlen(component_id));
+    uint64_t hash = fnv1a(key->id_hash, &strategy, sizeof(strategy));
+    if (version) {
+        uint32_t numbers[4] = { version->major, version->minor, version->patch, version->hotfix };
+        size_t prerelease = 0;
+        while (prerelease < sizeof(version->prerelease) && version->prerelease[prerelease]) {
+            prerelease++;
+        }
+        hash = fnv1a(hash, numbers, sizeof(numbers));
+        hash = fnv1a(hash, version->prerelease, prerelease);
+    }
+    key->hash = hash;
+}
+
+static bool entry_matches(const cache_entry_t* entry, const cache_key_t* key) {
+    if (entry->hash != key->hash || entry->strategy != key->strategy ||
+        entry->has_version != (key->version != NULL) ||
+        strcmp(entry->component_id, key->component_id) != 0) {
+        return false;
+    }
+    if (!key->version) return true;
+    return entry->major == key->version->major && entry->minor == key->version->minor &&
+           entry->patch == key->version->patch && entry->hotfix == key->version->hotfix &&
+           strncmp(entry->prerelease, key->version->prerelease, sizeof(entry->prerelease)) == 0;
+}
+
+// Shard by identifier alone, so one component's entries share a shard
+static cache_shard_t* cache_shard(nexus_resolution_cache_t* cache, uint64_t id_hash) {
+    return &cache->shards[(id_hash >> 32) % NEXUS_RESOLUTION_CACHE_SHARDS];
+}
+
+static void lru_unlink(cache_shard_t* shard, cache_entry_t* entry) {
+    if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else shard->lru_head = entry->lru_next;
+    if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else shard->lru_tail = entry->lru_prev;
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void lru_push_front(cache_shard_t* shard, cache_entry_t* entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = shard->lru_head;
+    if (shard->lru_head) shard->lru_head->lru_prev = entry;
+    shard->lru_head = entry;
+    if (!shard->lru_tail) shard->lru_tail = entry;
+}
+
+static void bucket_unlink(cache_shard_t* shard, cache_entry_t* entry) {
+    cache_entry_t** link = &shard->buckets[entry->hash & (CACHE_BUCKETS - 1)];
+    while (*link != entry) link = &(*link)->hash_next;
+    *link = entry->hash_next;
+}
+
+static nexus_resolution_cache_t* cache_create(void) {
+    nexus_resolution_cache_t* cache = calloc(1, sizeof(nexus_resolution_cache_t));
+    if (!cache) return NULL;
+    for (int i = 0; i < NEXUS_RESOLUTION_CACHE_SHARDS; i++) {
+        pthread_mutex_init(&cache->shards[i].mutex, NULL);
+    }
+    return cache;
+}
+
+static void cache_destroy(nexus_resolution_cache_t* cache) {
+    if (!cache) return;
+    for (int i = 0; i < NEXUS_RESOLUTION_CACHE_SHARDS; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        for (cache_entry_t* entry = shard->lru_head; entry; ) {
+            cache_entry_t* next = entry->lru_next;
+            free(entry);
+            entry = next;
+        }
+        pthread_mutex_destroy(&shard->mutex);
+    }
+    free(cache);
+}
+
+// True on a hit, with the cached answer (NULL for a cached miss) in
+// *manifest. On a miss, *generation is what cache_store must see unchanged.
+static bool cache_lookup(nexus_resolution_cache_t* cache, const cache_key_t* key,
+                         component_manifest_t** manifest, uint64_t* generation) {
+    cache_shard_t* shard = cache_shard(cache, key->id_hash);
+    pthread_mutex_lock(&shard->mutex);
+    cache_entry_t* entry = shard->buckets[key->hash & (CACHE_BUCKETS - 1)];
+    while (entry && !entry_matches(entry, key)) entry = entry->hash_next;
+    if (entry) {
+        if (entry != shard->lru_head) {
+            lru_unlink(shard, entry);
+            lru_push_front(shard, entry);
+        }
+        *manifest = entry->manifest;
+        shard->hits++;
+        if (!entry->manifest) shard->negative_hits++;
+    } else {
+        *generation = shard->generation;
+        shard->misses++;
+    }
+    pthread_mutex_unlock(&shard->mutex);
+    return entry != NULL;
+}
+
+// Remember an answer, unless the component was invalidated since the
+// lookup that missed: the answer may predate the change
+static void cache_store(nexus_resolution_cache_t* cache, const cache_key_t* key,
+                        component_manifest_t* manifest, uint64_t generation) {
+    cache_shard_t* shard = cache_shard(cache, key->id_hash);
+    pthread_mutex_lock(&shard->mutex);
+    if (shard->generation != generation) {
+        pthread_mutex_unlock(&shard->mutex);
+        return;
+    }
+
+    // Another resolver may have got here first
+    cache_entry_t* entry = shard->buckets[key->hash & (CACHE_BUCKETS - 1)];
+    while (entry && !entry_matches(entry, key)) entry = entry->hash_next;
+    if (!entry) {
+        if (shard->entries >= CACHE_SHARD_CAPACITY) {
+            entry = shard->lru_tail;
+            lru_unlink(shard, entry);
+            bucket_unlink(shard, entry);
+            shard->evictions++;
+        } else {
+            entry = malloc(sizeof(cache_entry_t));
+            if (!entry) {
+                pthread_mutex_unlock(&shard->mutex);
+                return;
+            }
+            shard->entries++;
+        }
+        memset(entry, 0, sizeof(*entry));
+        entry->hash = key->hash;
+        strcpy(entry->component_id, key->component_id);
+        entry->strategy = key->strategy;
+        entry->has_version = key->version != NULL;
+        if (key->version) {
+            entry->major = key->version->major;
+            entry->minor = key->version->minor;
+            entry->patch = key->version->patch;
+            entry->hotfix = key->version->hotfix;
+            memcpy(entry->prerelease, key->version->prerelease, sizeof(entry->prerelease) - 1);
+        }
+        cache_entry_t** bucket = &shard->buckets[key->hash & (CACHE_BUCKETS - 1)];
+        entry->hash_next = *bucket;
+        *bucket = entry;
+    } else {
+        lru_unlink(shard, entry);
+    }
+    entry->manifest = manifest;
+    lru_push_front(shard, entry);
+    pthread_mutex_unlock(&shard->mutex);
+}
+
+// ============================================================================
+// Versions
+// ============================================================================
+
+int nexus_compare_versions(
+    const semantic_version_x_t* v1,
+    const semantic_version_x_t* v2
+) {
+    if (v1->major != v2->major) return v1->major < v2->major ? -1 : 1;
+    if (v1->minor != v2->minor) return v1->minor < v2->minor ? -1 : 1;
+    if (v1->patch != v2->patch) return v1->patch < v2->patch ? -1 : 1;
+    if (v1->hotfix != v2->hotfix) return v1->hotfix < v2->hotfix ? -1 : 1;
+
+    // A release ranks above its prereleases
+    bool pre1 = v1->prerelease[0] != '\0';
+    bool pre2 = v2->prerelease[0] != '\0';
+    if (pre1 != pre2) return pre1 ? -1 : 1;
+    int order = strcmp(v1->prerelease, v2->prerelease);
+    return (order > 0) - (order < 0);
+}
+
+bool nexus_version_compatible(
+    const semantic_version_x_t* required,
+    const semantic_version_x_t* provided,
+    resolution_strategy_t strategy
+) {
+    if (!required || !provided) return false;
+    switch (strategy) {
+        case RESOLUTION_EXACT_MATCH:
+            return nexus_compare_versions(required, provided) == 0;
+        case RESOLUTION_LATEST_STABLE:
+            return provided->prerelease[0] == '\0';
+        case RESOLUTION_EXPERIMENTAL:
+            return true;
+        case RESOLUTION_COMPATIBLE:
+        case RESOLUTION_FALLBACK_CHAIN:
+        default:
+            return required->major == provided->major &&
+                   nexus_compare_versions(provided, required) >= 0;
+    }
+}
+
+// ============================================================================
+// Core API
+// ============================================================================
+
+nexus_resolution_context_t* nexus_link_init(
+    const char* config_path,
+    resolution_strategy_t default_strategy
+) {
+    (void)config_path;
+    nexus_resolution_context_t* ctx = calloc(1, sizeof(nexus_resolution_context_t));
+    if (!ctx) return NULL;
+
+    atomic_init(&ctx->component_trie.root, NULL);
+    pthread_mutex_init(&ctx->component_trie.write_mutex, NULL);
+    pthread_mutex_init(&ctx->context_mutex, NULL);
+    ctx->resolution_cache = cache_create();
+    if (!ctx->resolution_cache) {
+        nexus_link_destroy(ctx);
+        return NULL;
+    }
+
+    ctx->default_strategy = default_strategy;
+    ctx->preferred_sources[0] = SOURCE_OBINEXUS_DIRECT;
+    ctx->preferred_sources[1] = SOURCE_LOCAL_CACHE;
+    ctx->source_priority_count = 2;
+    ctx->max_retry_attempts = 3;
+    ctx->retry_backoff_ms = 100;
+    ctx->enable_circuit_breaker = true;
+    ctx->circuit_breaker_threshold = 5;
+    return ctx;
+}
+
+void nexus_link_destroy(nexus_resolution_context_t* ctx) {
+    if (!ctx) return;
+    nexus_component_index_t* index = &ctx->component_trie;
+    free_tree(atomic_load_explicit(&index->root, memory_order_relaxed));
+    for (nexus_art_node_t* node = index->retired; node; ) {
+        nexus_art_node_t* next = node->next_retired;
+        free(node);
+        node = next;
+    }
+    pthread_mutex_destroy(&index->write_mutex);
+    for (component_evolution_t* evolution = ctx->evolutions; evolution; ) {
+        component_evolution_t* next = evolution->next;
+        if (evolution->log_fd >= 0) close(evolution->log_fd);
+        free(evolution);
+        evolution = next;
+    }
+    pthread_mutex_destroy(&ctx->context_mutex);
+    cache_destroy(ctx->resolution_cache);
+    free(ctx);
+}
+
+int nexus_register_component(
+    nexus_resolution_context_t* ctx,
+    component_manifest_t* manifest,
+    component_source_t source
+) {
+    (void)source;
+    uint32_t length;
+    if (!ctx || !manifest || !component_key(manifest->component_id, &length)) return -1;
+
+    nexus_component_index_t* index = &ctx->component_trie;
+    pthread_mutex_lock(&index->write_mutex);
+    int result = art_insert(index, (const uint8_t*)manifest->component_id, length, manifest);
+    if (result == 0) index->component_count++;
+    reclaim_nodes(index);
+    pthread_mutex_unlock(&index->write_mutex);
+    // After the insert: a resolve that misses from here on sees the new manifest
+    if (result >= 0) nexus_invalidate_resolutions(ctx, manifest->component_id);
+    return result < 0 ? -1 : 0;
+}
+
+component_manifest_t* nexus_resolve_component(
+    nexus_resolution_context_t* ctx,
+    const char* component_id,
+    semantic_version_x_t* requested_version,
+    resolution_strategy_t strategy
+) {
+    uint32_t length;
+    if (!ctx || !component_key(component_id, &length)) return NULL;
+
+    cache_key_t key;
+    make_cache_key(&key, component_id, requested_version, strategy);
+    component_manifest_t* manifest = NULL;
+    uint64_t generation = 0;
+    if (!cache_lookup(ctx->resolution_cache, &key, &manifest, &generation)) {
+        if (!read_begin()) return NULL;
+        art_leaf_t* leaf = art_lookup(&ctx->component_trie, (const uint8_t*)component_id, length);
+        if (leaf) manifest = atomic_load_explicit(&leaf->manifest, memory_order_acquire);
+        read_end();
+
+        if (manifest && requested_version &&
+            !nexus_version_compatible(requested_version, &manifest->version, strategy)) {
+            manifest = NULL;
+        }
+        cache_store(ctx->resolution_cache, &key, manifest, generation);
+    }
+
+    __atomic_fetch_add(&ctx->metrics.total_resolutions, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(manifest ? &ctx->metrics.successful_resolutions
+                                : &ctx->metrics.failed_resolutions, 1, __ATOMIC_RELAXED);
+    return manifest;
+}
+
+void nexus_invalidate_resolutions(nexus_resolution_context_t* ctx, const char* component_id) {
+    uint32_t length;
+    if (!ctx || !component_key(component_id, &length)) return;
+
+    uint64_t id_hash = fnv1a(0xcbf29ce484222325ULL, component_id, length - 1);
+    cache_shard_t* shard = cache_shard(ctx->resolution_cache, id_hash);
+    pthread_mutex_lock(&shard->mutex);
+    shard->generation++;
+    for (cache_entry_t* entry = shard->lru_head; entry; ) {
+        cache_entry_t* next = entry->lru_next;
+        if (strcmp(entry->component_id, component_id) == 0) {
+            lru_unlink(shard, entry);
+            bucket_unlink(shard, entry);
+            free(entry);
+            shard->entries--;
+            shard->invalidations++;
+        }
+        entry = next;
+    }
+    pthread_mutex_unlock(&shard->mutex);
+}
+
+void nexus_get_resolution_cache_stats(nexus_resolution_context_t* ctx, nexus_cache_stats_t* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!ctx) return;
+    for (int i = 0; i < NEXUS_RESOLUTION_CACHE_SHARDS; i++) {
+        cache_shard_t* shard = &ctx->resolution_cache->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        stats->hits += shard->hits;
+        stats->negative_hits += shard->negative_hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->invalidations += shard->invalidations;
+        stats->entries += shard->entries;
+        pthread_mutex_unlock(&shard->mutex);
+    }
+    uint64_t lookups = stats->hits + stats->misses;
+    stats->hit_rate = lookups ? (double)stats->hits / (double)lookups : 0.0;
+}
+
+search_results_t* nexus_search_components(
+    nexus_resolution_context_t* ctx,
+    const char* prefix,
+    const char* taxonomy_filter,
+    uint32_t max_results
+) {
+    if (!ctx || max_results == 0) return NULL;
+    size_t length = prefix ? bounded_length(prefix) : 0;
+    if (length >= ART_MAX_KEY) return NULL;
+
+    search_results_t* results = calloc(1, sizeof(search_results_t));
+    if (!results) return NULL;
+    results->results = calloc(max_results, sizeof(component_manifest_t*));
+    results->max_results = max_results;
+    if (!results->results || !read_begin()) {
+        nexus_free_search_results(results);
+        return NULL;
+    }
+
+    scan_state_t scan = { .results = results, .taxonomy_filter = taxonomy_filter };
+    nexus_art_node_t* subtree = length > 0
+        ? find_prefix(&ctx->component_trie, (const uint8_t*)prefix, (uint32_t)length)
+        : atomic_load_explicit(&ctx->component_trie.root, memory_order_acquire);
+    if (subtree) collect_leaves(subtree, &scan);
+    read_end();
+    return results;
+}
+
+void nexus_free_search_results(search_results_t* results) {
+    if (!results) return;
+    free(results->results);
+    free(results);
+}
+
+// ============================================================================
+// Ship of Theseus
+// ============================================================================
+
+component_evolution_t* nexus_track_evolution(nexus_resolution_context_t* ctx, const char* component_id) {
+    uint32_t length;
+    if (!ctx || !component_key(component_id, &length)) return NULL;
+
+    pthread_mutex_lock(&ctx->context_mutex);
+    component_evolution_t* evolution = ctx->evolutions;
+    while (evolution && strcmp(evolution->original_component_id, component_id) != 0) {
+        evolution = evolution->next;
+    }
+    if (!evolution) {
+        evolution = calloc(1, sizeof(component_evolution_t));
+        if (evolution) {
+            memcpy(evolution->original_component_id, component_id, length);
+            component_manifest_t* manifest = nexus_resolve_component(ctx, component_id, NULL,
+                                                                     ctx->default_strategy);
+            if (manifest) {
+                evolution->original_version = manifest->version;
+                evolution->current_version = manifest->version;
+            }
+            evolution->uptime_percentage = 100.0;
+            evolution->log_fd = -1;
+            if (ctx->evolution_log_dir[0] != '\0') {
+                char path[512];
+                snprintf(path, sizeof(path), "%s/%s.evolution", ctx->evolution_log_dir, component_id);
+                evolution->log_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            }
+            evolution->next = ctx->evolutions;
+            ctx->evolutions = evolution;
+        }
+    }
+    pthread_mutex_unlock(&ctx->context_mutex);
+    return evolution;
+}
+
+int nexus_set_evolution_log_dir(nexus_resolution_context_t* ctx, const char* directory) {
+    if (!ctx) return -1;
+    if (directory && strlen(directory) >= sizeof(ctx->evolution_log_dir)) return -1;
+
+    pthread_mutex_lock(&ctx->context_mutex);
+    strcpy(ctx->evolution_log_dir, directory ? directory : "");
+    pthread_mutex_unlock(&ctx->context_mutex);
+    return 0;
+}
+
+// One line per event, written with a single O_APPEND write so concurrent
+// spills never interleave. Lines carry their position, since two spills
+// can land out of order.
+static void spill_event(component_evolution_t* evolution, uint64_t position, const evolution_event_t* event) {
+    char line[512];
+    int length = snprintf(line, sizeof(line), "%llu %llu %u.%u.%u.%u %u.%u.%u.%u %s %s\n",
+                          (unsigned long long)position, (unsigned long long)event->swap_timestamp,
+                          event->from_version.major, event->from_version.minor,
+                          event->from_version.patch, event->from_version.hotfix,
+                          event->to_version.major, event->to_version.minor,
+                          event->to_version.patch, event->to_version.hotfix,
+                          event->was_automatic ? "auto" : "manual", event->reason);
+    if (length < 0) return;
+    if ((size_t)length >= sizeof(line)) {
+        length = sizeof(line) - 1;
+        line[length - 1] = '\n';
+    }
+    if (write(evolution->log_fd, line, (size_t)length) == length) {
+        atomic_fetch_add_explicit(&evolution->spilled, 1, memory_order_relaxed);
+    }
+}
+
+// Slot events move word by word with relaxed atomics; the slot sequence
+// orders them
+static void slot_store_event(evolution_slot_t* slot, const evolution_event_t* event) {
+    uint64_t words[NEXUS_EVOLUTION_EVENT_WORDS] = {0};
+    memcpy(words, event, sizeof(*event));
+    for (size_t i = 0; i < NEXUS_EVOLUTION_EVENT_WORDS; i++) {
+        atomic_store_explicit(&slot->event[i], words[i], memory_order_relaxed);
+    }
+}
+
+static void slot_load_event(const evolution_slot_t* slot, evolution_event_t* event) {
+    uint64_t words[NEXUS_EVOLUTION_EVENT_WORDS];
+    for (size_t i = 0; i < NEXUS_EVOLUTION_EVENT_WORDS; i++) {
+        words[i] = atomic_load_explicit(&slot->event[i], memory_order_relaxed);
+    }
+    memcpy(event, words, sizeof(*event));
+}
+
+int nexus_evolution_record(component_evolution_t* evolution, const evolution_event_t* event) {
+    if (!evolution || !event) return -1;
+
+    // Claim a position, then wait for the event it overwrites (if any) to be
+    // published. Only this writer may take the slot from that state.
+    uint64_t position = atomic_fetch_add_explicit(&evolution->evolution_count, 1, memory_order_relaxed);
+    evolution_slot_t* slot = &evolution->ring[position & (NEXUS_EVOLUTION_RING_SIZE - 1)];
+    uint64_t previous = position >= NEXUS_EVOLUTION_RING_SIZE ? position - NEXUS_EVOLUTION_RING_SIZE + 1 : 0;
+    uint64_t expected = previous;
+    while (!atomic_compare_exchange_weak_explicit(&slot->sequence, &expected, UINT64_MAX,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+        expected = previous;
+        sched_yield();
+    }
+
+    // Readers must see the claim before any word of the new event
+    atomic_thread_fence(memory_order_release);
+
+    if (previous != 0 && evolution->log_fd >= 0) {
+        evolution_event_t spilled;
+        slot_load_event(slot, &spilled);
+        spill_event(evolution, previous - 1, &spilled);
+    }
+    evolution_event_t copy = *event;
+    copy.reason[sizeof(copy.reason) - 1] = '\0';
+    slot_store_event(slot, &copy);
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    if (event->to_version.major != event->from_version.major) {
+        atomic_fetch_add_explicit(&evolution->major_changes, 1, memory_order_relaxed);
+    }
+    return 0;
+}
+
+uint32_t nexus_evolution_recent(const component_evolution_t* evolution,
+                                evolution_event_t* events, uint32_t max) {
+    if (!evolution || !events) return 0;
+
+    uint64_t end = atomic_load_explicit(&evolution->evolution_count, memory_order_acquire);
+    if (max > NEXUS_EVOLUTION_RING_SIZE) max = NEXUS_EVOLUTION_RING_SIZE;
+    uint64_t start = end > max ? end - max : 0;
+
+    // Each slot is read like a seqlock: copy, then check the slot still
+    // holds the same event. Events being written or already overwritten
+    // are skipped.
+    uint32_t count = 0;
+    for (uint64_t position = start; position < end; position++) {
+        const evolution_slot_t* slot = &evolution->ring[position & (NEXUS_EVOLUTION_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != position + 1) continue;
+        slot_load_event(slot, &events[count]);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == position + 1) count++;
+    }
+    return count;
+}
+
+// The contract holds while no swap changed the major version and the
+// contract hash, once set on both sides, still matches
+bool nexus_validate_evolved_contract(component_evolution_t* evolution, const char* original_contract_hash) {
+    if (!evolution) return false;
+    if (atomic_load_explicit(&evolution->major_changes, memory_order_relaxed) != 0) return false;
+    if (original_contract_hash && original_contract_hash[0] != '\0' && evolution->contract_hash[0] != '\0') {
+        return strcmp(evolution->contract_hash, original_contract_hash) == 0;
+    }
+    return true;
+}
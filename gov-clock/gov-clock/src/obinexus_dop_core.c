@@ -4,19 +4,40 @@
 
 #include "obinexus_dop_core.h"
 #include "nexus_link_semserver_x.h"
+#include "dop_component_pool.h"
 #include <assert.h>
 #include <dlfcn.h>  // For dynamic loading
 #include <string.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+
+// One loaded version of a component. Immutable once published: a hot swap
+// publishes a new one and frees the old after a grace period, so readers
+// use it without a lock.
+typedef struct {
+    semantic_version_x_t semver_x;
+    void* component_handle;        // dlopen handle for dynamic loading
+    char library_path[256];        // Path to component library
+
+    // Function pointers for hot-swappable operations
+    struct {
+        int (*update)(void* component);
+        int (*validate)(void* component);
+        int (*quiesce)(void* component);
+        int (*resume)(void* component);
+        int (*shadow)(void* component);     // Instantiate and warm up beside the serving version
+        int (*sync)(void* component);       // Take over state changed since the last sync
+    } operations;
+} dop_component_impl_t;
+
 // Enhanced component metadata for hot-swapping
 typedef struct {
-    dop_metadata_t base_metadata;
+    dop_component_metadata_t base_metadata;  // mutex serializes hot swaps; readers never take it
 
     // Hot-swap capabilities
-    semantic_version_x_t semver_x;
     bool is_hot_swappable;
-    void* component_handle;        // dlopen handle for dynamic loading
-    char library_path[256];        // Path to component library
 
     // Fault tolerance tracking
     uint32_t consecutive_failures;
@@ -34,13 +55,15 @@ typedef struct {
     enhanced_dop_metadata_t metadata;
     dop_component_data_t data;
 
-    // Function pointers for hot-swappable operations
-    struct {
-        int (*update)(void* component);
-        int (*validate)(void* component);
-        int (*quiesce)(void* component);
-        int (*resume)(void* component);
-    } operations;
+    // Current version; read inside dop_component_acquire/release
+    _Atomic(dop_component_impl_t*) impl;
+
+    // Shadow swaps: updates count themselves in and bump the generation,
+    // and wait out a cutover
+    _Atomic bool cutover;
+    _Atomic uint32_t updates_in_flight;
+    _Atomic uint64_t state_generation;
+    uint64_t last_cutover_ns;
 
     // Fault tolerance configuration
     fault_tolerant_component_t* fault_config;
@@ -52,6 +75,101 @@ typedef struct {
 // Global Nexus-Link context for component resolution
 static nexus_resolution_context_t* g_nexus_ctx = NULL;
 
+// Enhanced components are pooled together with their circuit breaker, so
+// creating and destroying one allocates nothing once the pool is warm
+typedef struct {
+    enhanced_dop_component_t component;
+    circuit_breaker_t circuit_breaker;
+} enhanced_component_slot_t;
+
+static dop_object_pool_t* g_enhanced_pool = NULL;
+static pthread_once_t g_enhanced_pool_once = PTHREAD_ONCE_INIT;
+
+static void create_enhanced_pool(void) {
+    g_enhanced_pool = dop_object_pool_create(
+        sizeof(enhanced_component_slot_t),
+        offsetof(enhanced_component_slot_t, component.metadata.base_metadata.mutex));
+}
+
+static dop_object_pool_t* enhanced_pool(void) {
+    pthread_once(&g_enhanced_pool_once, create_enhanced_pool);
+    return g_enhanced_pool;
+}
+
+// Load a version's library and its operations. A missing library leaves the
+// handle and operations NULL. NULL only when out of memory.
+static dop_component_impl_t* load_implementation(const char* component_id,
+                                                 const semantic_version_x_t* version,
+                                                 bool load_library) {
+    dop_component_impl_t* impl = calloc(1, sizeof(dop_component_impl_t));
+    if (!impl) return NULL;
+    impl->semver_x = *version;
+    if (!load_library) return impl;
+
+    snprintf(impl->library_path, sizeof(impl->library_path),
+             "/opt/obinexus/components/%s/v%d.%d.%d/lib%s.so",
+             component_id, version->major, version->minor, version->patch, component_id);
+    impl->component_handle = dlopen(impl->library_path, RTLD_LAZY | RTLD_LOCAL);
+    if (impl->component_handle) {
+        // ISO C has no conversion from void* to a function pointer, so each
+        // dlsym result is stored through a void* lvalue, as POSIX suggests
+        void* handle = impl->component_handle;
+        *(void**)&impl->operations.update = dlsym(handle, "component_update");
+        *(void**)&impl->operations.validate = dlsym(handle, "component_validate");
+        *(void**)&impl->operations.quiesce = dlsym(handle, "component_quiesce");
+        *(void**)&impl->operations.resume = dlsym(handle, "component_resume");
+        *(void**)&impl->operations.shadow = dlsym(handle, "component_shadow");
+        *(void**)&impl->operations.sync = dlsym(handle, "component_sync");
+    }
+    return impl;
+}
+
+static void unload_implementation(dop_component_impl_t* impl) {
+    if (!impl) return;
+    if (impl->component_handle) dlclose(impl->component_handle);
+    free(impl);
+}
+
+// Read side of a component: no lock, and a concurrent hot swap never makes
+// it wait. The implementation stays valid until dop_component_release.
+const dop_component_impl_t* dop_component_acquire(enhanced_dop_component_t* component) {
+    if (!component || !nexus_read_begin()) return NULL;
+    const dop_component_impl_t* impl = atomic_load_explicit(&component->impl, memory_order_acquire);
+    if (!impl) nexus_read_end();    // Being destroyed
+    return impl;
+}
+
+void dop_component_release(void) {
+    nexus_read_end();
+}
+
+int dop_component_update(enhanced_dop_component_t* component) {
+    const dop_component_impl_t* impl;
+    for (;;) {
+        impl = dop_component_acquire(component);
+        if (!impl) return DOP_ERROR_INVALID_PARAMETER;
+        atomic_fetch_add(&component->updates_in_flight, 1);
+
+        // Counted in with no cutover running, so none can start until this
+        // update is done. One may have finished since impl was read, though,
+        // and then impl is no longer the published version.
+        if (!atomic_load(&component->cutover) &&
+            atomic_load(&component->impl) == impl) break;
+
+        // A shadow swap is cutting over, or just has; retry on whichever
+        // version it leaves
+        atomic_fetch_sub(&component->updates_in_flight, 1);
+        dop_component_release();
+        sched_yield();
+    }
+
+    int result = impl->operations.update ? impl->operations.update(component) : DOP_SUCCESS;
+    atomic_fetch_add_explicit(&component->state_generation, 1, memory_order_release);
+    atomic_fetch_sub_explicit(&component->updates_in_flight, 1, memory_order_release);
+    dop_component_release();
+    return result;
+}
+
 // Initialize enhanced DOP system with Nexus-Link integration
 int dop_enhanced_init(const char* config_path) {
     if (g_nexus_ctx != NULL) {
@@ -130,10 +248,11 @@ enhanced_dop_component_t* dop_create_enhanced_component(
         }
     }
 
-    enhanced_dop_component_t* component = calloc(1, sizeof(enhanced_dop_component_t));
-    if (!component) {
+    enhanced_component_slot_t* slot = dop_object_pool_acquire(enhanced_pool());
+    if (!slot) {
         return NULL;
     }
+    enhanced_dop_component_t* component = &slot->component;
 
     // Initialize enhanced metadata
     snprintf(component->metadata.base_metadata.component_id,
@@ -141,43 +260,24 @@ enhanced_dop_component_t* dop_create_enhanced_component(
              "%s_%llu", component_id, (unsigned long long)time(NULL));
 
     strcpy(component->metadata.base_metadata.component_name, manifest->component_name);
-    component->metadata.semver_x = manifest->version;
     component->metadata.is_hot_swappable = manifest->version.is_hot_swappable;
 
     // Initialize fault tolerance
     component->metadata.health_status = HEALTH_HEALTHY;
-    component->metadata.circuit_breaker = calloc(1, sizeof(circuit_breaker_t));
-    strcpy(component->metadata.circuit_breaker->component_id, component_id);
-    component->metadata.circuit_breaker->state = CIRCUIT_CLOSED;
-    pthread_mutex_init(&component->metadata.circuit_breaker->breaker_mutex, NULL);
+    component->metadata.circuit_breaker = &slot->circuit_breaker;
+    nexus_circuit_init(component->metadata.circuit_breaker, component_id);  // Pooled: clear the window
 
     // Initialize evolution tracking
     component->metadata.evolution = nexus_track_evolution(g_nexus_ctx, component_id);
 
     // Load component library if hot-swappable
-    if (component->metadata.is_hot_swappable) {
-        snprintf(component->metadata.library_path,
-                 sizeof(component->metadata.library_path),
-                 "/opt/obinexus/components/%s/v%d.%d.%d/lib%s.so",
-                 component_id,
-                 manifest->version.major,
-                 manifest->version.minor,
-                 manifest->version.patch,
-                 component_id);
-
-        component->metadata.component_handle = dlopen(
-            component->metadata.library_path,
-            RTLD_LAZY | RTLD_LOCAL
-        );
-
-        if (component->metadata.component_handle) {
-            // Load function pointers
-            component->operations.update = dlsym(component->metadata.component_handle, "component_update");
-            component->operations.validate = dlsym(component->metadata.component_handle, "component_validate");
-            component->operations.quiesce = dlsym(component->metadata.component_handle, "component_quiesce");
-            component->operations.resume = dlsym(component->metadata.component_handle, "component_resume");
-        }
+    dop_component_impl_t* impl = load_implementation(component_id, &manifest->version,
+                                                     component->metadata.is_hot_swappable);
+    if (!impl) {
+        dop_object_pool_release(enhanced_pool(), slot);
+        return NULL;
     }
+    atomic_init(&component->impl, impl);
 
     // Set up fault-tolerant configuration
     if (manifest->fault_tolerance.fallback_component[0] != '\0') {
@@ -193,12 +293,97 @@ enhanced_dop_component_t* dop_create_enhanced_component(
     component->metadata.base_metadata.gate_state = DOP_GATE_CLOSED;
     component->metadata.base_metadata.creation_timestamp = (uint64_t)time(NULL) * 1000;
 
-    pthread_mutex_init(&component->metadata.base_metadata.mutex, NULL);
-
     return component;
 }
 
+// Return an enhanced component to the pool. Its implementation is unloaded
+// once readers still inside dop_component_acquire have finished with it.
+int dop_destroy_enhanced_component(enhanced_dop_component_t* component) {
+    if (!component) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    dop_component_impl_t* impl = atomic_exchange_explicit(&component->impl, NULL, memory_order_acq_rel);
+    nexus_synchronize();
+    unload_implementation(impl);
+
+    component->metadata.base_metadata.state = DOP_STATE_DESTROYED;
+    return dop_object_pool_release(enhanced_pool(), component);
+}
+
+// Steps shared by both hot swap modes: check compatibility, then load and
+// validate the new version without publishing it. Called with the swap
+// mutex held.
+static int load_swap_candidate(enhanced_dop_component_t* component,
+                               const dop_component_impl_t* old_impl,
+                               semantic_version_x_t* new_version,
+                               bool force_swap,
+                               dop_component_impl_t** candidate) {
+    // Validate new version compatibility
+    if (!nexus_version_compatible(&old_impl->semver_x, new_version, RESOLUTION_COMPATIBLE)) {
+        if (!force_swap) {
+            return DOP_ERROR_VERSION_INCOMPATIBLE;
+        }
+    }
+
+    // Load new component library, unpublished
+    dop_component_impl_t* new_impl = load_implementation(
+        component->metadata.base_metadata.component_id, new_version, true);
+    if (!new_impl || !new_impl->component_handle) {
+        unload_implementation(new_impl);
+        return DOP_ERROR_LIBRARY_LOAD_FAILED;
+    }
+
+    // Validate new component; nothing to roll back on failure
+    if (new_impl->operations.validate) {
+        int validate_result = new_impl->operations.validate(component);
+        if (validate_result != DOP_SUCCESS) {
+            unload_implementation(new_impl);
+            return DOP_ERROR_VALIDATION_FAILED;
+        }
+    }
+
+    *candidate = new_impl;
+    return DOP_SUCCESS;
+}
+
+// Record a published swap in the evolution history and tell Nexus-Link.
+// Called with the swap mutex held.
+static int record_swap(enhanced_dop_component_t* component,
+                       semantic_version_x_t* old_version,
+                       semantic_version_x_t* new_version,
+                       bool force_swap,
+                       const char* reason) {
+    component_evolution_t* evolution = component->metadata.evolution;
+    if (evolution) {
+        // Lock-free append; the oldest event spills to disk when the ring is full
+        evolution_event_t event = {
+            .from_version = *old_version,
+            .to_version = *new_version,
+            .swap_timestamp = (uint64_t)time(NULL),
+            .was_automatic = !force_swap
+        };
+        snprintf(event.reason, sizeof(event.reason), "%s", reason);
+        nexus_evolution_record(evolution, &event);
+        evolution->total_swaps++;
+        evolution->current_version = *new_version;
+    }
+
+    swap_result_t swap_result = nexus_hot_swap_component(
+        g_nexus_ctx,
+        component->metadata.base_metadata.component_id,
+        old_version,
+        new_version,
+        force_swap
+    );
+    return (swap_result == SWAP_SUCCESS) ? DOP_SUCCESS : DOP_ERROR_SWAP_NOTIFICATION_FAILED;
+}
+
 // Hot-swap implementation
+// The new version is loaded and validated before anyone can see it, then
+// published with one atomic store. Readers in flight finish on the old
+// version; it is unloaded once they have (nexus_synchronize), so only the
+// swapping thread ever waits.
 int dop_hot_swap_component(
     enhanced_dop_component_t* component,
     semantic_version_x_t* new_version,
@@ -209,141 +394,151 @@ int dop_hot_swap_component(
     }
 
     pthread_mutex_lock(&component->metadata.base_metadata.mutex);
+    dop_component_impl_t* old_impl = atomic_load_explicit(&component->impl, memory_order_relaxed);
+
+    // Steps 1-3: Check compatibility, load and validate the new version
+    dop_component_impl_t* new_impl = NULL;
+    int result = load_swap_candidate(component, old_impl, new_version, force_swap, &new_impl);
+    if (result != DOP_SUCCESS) {
+        pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+        return result;
+    }
 
-    // Step 1: Quiesce component if required
-    if (component->metadata.semver_x.requires_quiesce && component->operations.quiesce) {
-        int quiesce_result = component->operations.quiesce(component);
+    // Step 4: Quiesce component if required
+    if (old_impl->semver_x.requires_quiesce && old_impl->operations.quiesce) {
+        int quiesce_result = old_impl->operations.quiesce(component);
         if (quiesce_result != DOP_SUCCESS && !force_swap) {
+            unload_implementation(new_impl);
             pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
             return DOP_ERROR_QUIESCE_FAILED;
         }
     }
 
-    // Step 2: Validate new version compatibility
-    if (!nexus_version_compatible(&component->metadata.semver_x, new_version, RESOLUTION_COMPATIBLE)) {
-        if (!force_swap) {
-            pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
-            return DOP_ERROR_VERSION_INCOMPATIBLE;
-        }
-    }
+    // Step 5: Publish; readers from here on get the new version
+    atomic_store_explicit(&component->impl, new_impl, memory_order_release);
+    semantic_version_x_t old_version = old_impl->semver_x;
 
-    // Step 3: Load new component library
-    char new_library_path[256];
-    snprintf(new_library_path, sizeof(new_library_path),
-             "/opt/obinexus/components/%s/v%d.%d.%d/lib%s.so",
-             component->metadata.base_metadata.component_id,
-             new_version->major,
-             new_version->minor,
-             new_version->patch,
-             component->metadata.base_metadata.component_id);
-
-    void* new_handle = dlopen(new_library_path, RTLD_LAZY | RTLD_LOCAL);
-    if (!new_handle) {
-        pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
-        return DOP_ERROR_LIBRARY_LOAD_FAILED;
+    // Step 6: Resume operations
+    if (new_impl->operations.resume) {
+        new_impl->operations.resume(component);
     }
 
-    // Step 4: Backup current state
-    semantic_version_x_t old_version = component->metadata.semver_x;
-    void* old_handle = component->metadata.component_handle;
+    // Step 7: Clean up old library after the grace period
+    nexus_synchronize();
+    unload_implementation(old_impl);
 
-    // Step 5: Perform swap
-    component->metadata.component_handle = new_handle;
-    component->metadata.semver_x = *new_version;
-    strcpy(component->metadata.library_path, new_library_path);
+    // Steps 8-9: Update evolution tracking and notify Nexus-Link
+    result = record_swap(component, &old_version, new_version, force_swap, "Hot swap upgrade");
+    pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+    return result;
+}
 
-    // Update function pointers
-    component->operations.update = dlsym(new_handle, "component_update");
-    component->operations.validate = dlsym(new_handle, "component_validate");
-    component->operations.quiesce = dlsym(new_handle, "component_quiesce");
-    component->operations.resume = dlsym(new_handle, "component_resume");
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
 
-    // Step 6: Validate new component
-    if (component->operations.validate) {
-        int validate_result = component->operations.validate(component);
-        if (validate_result != DOP_SUCCESS) {
-            // Rollback
-            component->metadata.component_handle = old_handle;
-            component->metadata.semver_x = old_version;
-            dlclose(new_handle);
+// Two-phase hot swap
+// The new version is instantiated beside the old one (component_shadow) and
+// catches up on state (component_sync) while the old one keeps serving,
+// repeating until an update-free round shows it has caught up or the rounds
+// run out. The cutover then holds back new updates, waits for those in
+// flight, takes the last delta and publishes: only that window stops
+// traffic, and it is recorded in new_version->swap_duration_ms (and in
+// nanoseconds in *cutover_ns when given). Libraries without the shadow and
+// sync entry points swap with an empty state transfer.
+#define SHADOW_SYNC_ROUNDS 8
+
+int dop_hot_swap_component_shadow(
+    enhanced_dop_component_t* component,
+    semantic_version_x_t* new_version,
+    bool force_swap,
+    uint64_t* cutover_ns
+) {
+    if (!component || !new_version || !component->metadata.is_hot_swappable) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&component->metadata.base_metadata.mutex);
+    dop_component_impl_t* old_impl = atomic_load_explicit(&component->impl, memory_order_relaxed);
+
+    dop_component_impl_t* new_impl = NULL;
+    int result = load_swap_candidate(component, old_impl, new_version, force_swap, &new_impl);
+    if (result != DOP_SUCCESS) {
+        pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+        return result;
+    }
+
+    // Phase 1: shadow instance, warmed while the old version serves
+    if (new_impl->operations.shadow && new_impl->operations.shadow(component) != DOP_SUCCESS) {
+        unload_implementation(new_impl);
+        pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+        return DOP_ERROR_VALIDATION_FAILED;
+    }
 
+    // Phase 2: stream deltas until a round passes with no updates
+    for (int round = 0; round < SHADOW_SYNC_ROUNDS && new_impl->operations.sync; round++) {
+        uint64_t generation = atomic_load_explicit(&component->state_generation, memory_order_acquire);
+        if (new_impl->operations.sync(component) != DOP_SUCCESS) {
+            unload_implementation(new_impl);
             pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
             return DOP_ERROR_VALIDATION_FAILED;
         }
+        if (atomic_load_explicit(&component->state_generation, memory_order_acquire) == generation &&
+            atomic_load(&component->updates_in_flight) == 0) {
+            break;
+        }
     }
 
-    // Step 7: Resume operations
-    if (component->operations.resume) {
-        component->operations.resume(component);
+    // Phase 3: cutover. Hold back new updates, drain those in flight, then
+    // the final delta is exact.
+    uint64_t cutover_start = monotonic_ns();
+    atomic_store(&component->cutover, true);
+    while (atomic_load(&component->updates_in_flight) != 0) {
+        sched_yield();
     }
-
-    // Step 8: Clean up old library
-    if (old_handle) {
-        dlclose(old_handle);
+    int sync_result = new_impl->operations.sync ? new_impl->operations.sync(component) : DOP_SUCCESS;
+    if (sync_result == DOP_SUCCESS) {
+        atomic_store_explicit(&component->impl, new_impl, memory_order_release);
+        if (new_impl->operations.resume) {
+            new_impl->operations.resume(component);
+        }
     }
+    atomic_store(&component->cutover, false);
+    uint64_t window_ns = monotonic_ns() - cutover_start;
 
-    // Step 9: Update evolution tracking
-    if (component->metadata.evolution) {
-        component->metadata.evolution->evolution_history[component->metadata.evolution->evolution_count].from_version = old_version;
-        component->metadata.evolution->evolution_history[component->metadata.evolution->evolution_count].to_version = *new_version;
-        component->metadata.evolution->evolution_history[component->metadata.evolution->evolution_count].swap_timestamp = time(NULL);
-        strcpy(component->metadata.evolution->evolution_history[component->metadata.evolution->evolution_count].reason, "Hot swap upgrade");
-        component->metadata.evolution->evolution_history[component->metadata.evolution->evolution_count].was_automatic = !force_swap;
-        component->metadata.evolution->evolution_count++;
-        component->metadata.evolution->total_swaps++;
-        component->metadata.evolution->current_version = *new_version;
+    if (sync_result != DOP_SUCCESS) {
+        // Nothing was published; the old version carries on
+        unload_implementation(new_impl);
+        pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+        return DOP_ERROR_VALIDATION_FAILED;
     }
 
-    // Step 10: Notify Nexus-Link of successful swap
-    swap_result_t swap_result = nexus_hot_swap_component(
-        g_nexus_ctx,
-        component->metadata.base_metadata.component_id,
-        &old_version,
-        new_version,
-        force_swap
-    );
+    component->last_cutover_ns = window_ns;
+    if (cutover_ns) *cutover_ns = window_ns;
+    new_version->swap_duration_ms = (uint32_t)((window_ns + 999999) / 1000000);
+    new_impl->semver_x.swap_duration_ms = new_version->swap_duration_ms;
+    semantic_version_x_t old_version = old_impl->semver_x;
 
-    pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+    nexus_synchronize();
+    unload_implementation(old_impl);
 
-    return (swap_result == SWAP_SUCCESS) ? DOP_SUCCESS : DOP_ERROR_SWAP_NOTIFICATION_FAILED;
+    result = record_swap(component, &old_version, new_version, force_swap, "Shadow hot swap upgrade");
+    pthread_mutex_unlock(&component->metadata.base_metadata.mutex);
+    return result;
 }
 
-// Circuit breaker implementation for fault tolerance
+// Circuit breaker implementation for fault tolerance; the breaker itself
+// lives in nexus_health.c
+
 int dop_check_circuit_breaker(enhanced_dop_component_t* component) {
     if (!component || !component->metadata.circuit_breaker) {
         return DOP_ERROR_INVALID_PARAMETER;
     }
 
-    circuit_breaker_t* breaker = component->metadata.circuit_breaker;
-    pthread_mutex_lock(&breaker->breaker_mutex);
-
-    uint64_t current_time = time(NULL);
-
-    switch (breaker->state) {
-        case CIRCUIT_CLOSED:
-            // Normal operation - allow requests
-            pthread_mutex_unlock(&breaker->breaker_mutex);
-            return DOP_SUCCESS;
-
-        case CIRCUIT_OPEN:
-            // Check if we should transition to half-open
-            if (current_time >= breaker->next_retry_time) {
-                breaker->state = CIRCUIT_HALF_OPEN;
-                breaker->success_count = 0;
-                pthread_mutex_unlock(&breaker->breaker_mutex);
-                return DOP_SUCCESS;  // Allow one test request
-            }
-            pthread_mutex_unlock(&breaker->breaker_mutex);
-            return DOP_ERROR_CIRCUIT_OPEN;
-
-        case CIRCUIT_HALF_OPEN:
-            // In testing phase - allow limited requests
-            pthread_mutex_unlock(&breaker->breaker_mutex);
-            return DOP_SUCCESS;
-    }
-
-    pthread_mutex_unlock(&breaker->breaker_mutex);
-    return DOP_ERROR_UNKNOWN_STATE;
+    return nexus_circuit_allow(component->metadata.circuit_breaker)
+        ? DOP_SUCCESS : DOP_ERROR_CIRCUIT_OPEN;
 }
 
 // Record component failure for circuit breaker
@@ -352,30 +547,15 @@ void dop_record_failure(enhanced_dop_component_t* component) {
         return;
     }
 
-    circuit_breaker_t* breaker = component->metadata.circuit_breaker;
-    pthread_mutex_lock(&breaker->breaker_mutex);
-
-    breaker->failure_count++;
-    breaker->last_failure_time = time(NULL);
-    component->metadata.consecutive_failures++;
-    component->metadata.last_failure_time = breaker->last_failure_time;
-
-    // Check if we should open the circuit
-    if (breaker->state == CIRCUIT_CLOSED && breaker->failure_count >= 5) {
-        breaker->state = CIRCUIT_OPEN;
-        breaker->next_retry_time = breaker->last_failure_time + 30;  // 30 second timeout
+    __atomic_fetch_add(&component->metadata.consecutive_failures, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&component->metadata.last_failure_time, (uint64_t)time(NULL), __ATOMIC_RELAXED);
 
+    if (nexus_circuit_record_failure(component->metadata.circuit_breaker)) {
         // Attempt failover if available
         if (component->fault_config && component->fault_config->fallback) {
             // TODO: Implement automatic failover
         }
-    } else if (breaker->state == CIRCUIT_HALF_OPEN) {
-        // Failed during testing - reopen circuit
-        breaker->state = CIRCUIT_OPEN;
-        breaker->next_retry_time = breaker->last_failure_time + 60;  // Longer timeout
     }
-
-    pthread_mutex_unlock(&breaker->breaker_mutex);
 }
 
 // Record component success for circuit breaker
@@ -384,20 +564,10 @@ void dop_record_success(enhanced_dop_component_t* component) {
         return;
     }
 
-    circuit_breaker_t* breaker = component->metadata.circuit_breaker;
-    pthread_mutex_lock(&breaker->breaker_mutex);
-
-    breaker->success_count++;
-    component->metadata.consecutive_failures = 0;
-
-    if (breaker->state == CIRCUIT_HALF_OPEN && breaker->success_count >= 3) {
-        // Sufficient successes - close the circuit
-        breaker->state = CIRCUIT_CLOSED;
-        breaker->failure_count = 0;
-        breaker->success_count = 0;
+    if (__atomic_load_n(&component->metadata.consecutive_failures, __ATOMIC_RELAXED) != 0) {
+        __atomic_store_n(&component->metadata.consecutive_failures, 0, __ATOMIC_RELAXED);
     }
-
-    pthread_mutex_unlock(&breaker->breaker_mutex);
+    nexus_circuit_record_success(component->metadata.circuit_breaker);
 }
 
 // Validate component evolution maintains contract (Ship of Theseus)
@@ -4,11 +4,15 @@
 // src/taxonomy_testing.c
 // ==============================================================================
 
+#define _DEFAULT_SOURCE  // usleep, pthread barriers
+
 #include "taxonomy_testing.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 // Initialize taxonomy test context
@@ -190,7 +194,6 @@ int taxonomy_memory_load_test(dop_component_t* component) {
     }
     
     // Verify component integrity under memory load
-    uint32_t original_checksum = component->checksum;
     dop_func_update_component(component);
     bool integrity_maintained = dop_checksum_verify(component);
     
@@ -237,7 +240,7 @@ int clock_taxonomy_test_time_precision(dop_component_t* clock, taxonomy_level_t
             printf("✓ Closed clock timezone test passed\n");
             break;
             
-        case TAXONOMY_OPEN:
+        case TAXONOMY_OPEN: {
             // Open clock should support CLI formatting
             char* formatted = dop_clock_format_time(clock);
             if (formatted) {
@@ -245,11 +248,268 @@ int clock_taxonomy_test_time_precision(dop_component_t* clock, taxonomy_level_t
                 free(formatted);
             }
             break;
+        }
     }
     
     return DOP_SUCCESS;
 }
 
+// Benchmark Mode
+typedef struct {
+    const taxonomy_benchmark_config_t* config;
+    dop_component_t** components;           // This worker's, or the shared set
+    uint32_t component_count;
+    pthread_barrier_t* start;
+    atomic_bool* stop;
+    uint64_t seed;
+    uint64_t operations;
+    uint64_t failures;
+    uint64_t latency_buckets[TAXONOMY_BENCHMARK_BUCKETS];
+    uint64_t latency_max_ns;
+    uint64_t contended;
+    uint64_t lock_wait_ns;
+    uint64_t lock_wait_max_ns;
+} benchmark_worker_t;
+
+static uint64_t benchmark_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t benchmark_rss_kb(void) {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long long size, resident;
+    int fields = fscanf(statm, "%llu %llu", &size, &resident);
+    fclose(statm);
+    return fields == 2 ? resident * (uint64_t)sysconf(_SC_PAGESIZE) / 1024 : 0;
+}
+
+static uint32_t benchmark_bucket(uint64_t ns) {
+    uint32_t bucket = 0;
+    while (ns >>= 1) bucket++;
+    return bucket < TAXONOMY_BENCHMARK_BUCKETS ? bucket : TAXONOMY_BENCHMARK_BUCKETS - 1;
+}
+
+static void* benchmark_worker(void* arg) {
+    benchmark_worker_t* worker = arg;
+    bool verify = worker->config->level == TAXONOMY_OPEN;
+    uint64_t state = worker->seed | 1;
+    pthread_barrier_wait(worker->start);
+
+    while (!atomic_load_explicit(worker->stop, memory_order_relaxed)) {
+        // xorshift64 picks the next component
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        dop_component_t* component = worker->components[state % worker->component_count];
+
+        uint64_t start_ns = benchmark_now_ns();
+        if (pthread_mutex_trylock(&component->metadata.mutex) != 0) {
+            pthread_mutex_lock(&component->metadata.mutex);
+            uint64_t wait_ns = benchmark_now_ns() - start_ns;
+            worker->contended++;
+            worker->lock_wait_ns += wait_ns;
+            if (wait_ns > worker->lock_wait_max_ns) worker->lock_wait_max_ns = wait_ns;
+        }
+        pthread_mutex_unlock(&component->metadata.mutex);
+
+        int result = dop_func_update_component(component);
+        if (result == DOP_SUCCESS && verify) {
+            // Shared components change under other workers' updates
+            pthread_mutex_lock(&component->metadata.mutex);
+            if (!dop_checksum_verify(component)) result = DOP_ERROR_CHECKSUM_FAILED;
+            pthread_mutex_unlock(&component->metadata.mutex);
+        }
+        uint64_t latency_ns = benchmark_now_ns() - start_ns;
+
+        worker->operations++;
+        if (result != DOP_SUCCESS) worker->failures++;
+        worker->latency_buckets[benchmark_bucket(latency_ns)]++;
+        if (latency_ns > worker->latency_max_ns) worker->latency_max_ns = latency_ns;
+    }
+    return NULL;
+}
+
+// Component types in proportion to the mix, interleaved
+static dop_component_type_t benchmark_pick_type(const uint32_t* mix, uint32_t total, uint32_t i) {
+    uint32_t point = i % total;
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) {
+        if (point < mix[type]) return (dop_component_type_t)type;
+        point -= mix[type];
+    }
+    return DOP_COMPONENT_CLOCK;
+}
+
+static dop_component_t* benchmark_create_component(dop_component_type_t type) {
+    dop_component_t* component = dop_func_create_component(type);
+    if (!component) return NULL;
+
+    dop_gate_open(component);
+    // Keep stopwatches and timers running so updates do their full work
+    if (type == DOP_COMPONENT_STOPWATCH) {
+        dop_stopwatch_start(component);
+    } else if (type == DOP_COMPONENT_TIMER) {
+        dop_timer_set_duration(component, 3600000);
+        dop_timer_start(component);
+    }
+    return component;
+}
+
+static uint64_t benchmark_percentile(const uint64_t* buckets, uint64_t total, double fraction) {
+    uint64_t target = (uint64_t)(fraction * (double)total);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < TAXONOMY_BENCHMARK_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen > target) return 1ULL << (i + 1);
+    }
+    return 1ULL << TAXONOMY_BENCHMARK_BUCKETS;
+}
+
+int taxonomy_run_benchmark(const taxonomy_benchmark_config_t* config, taxonomy_benchmark_result_t* result) {
+    if (!config || !result || config->threads == 0 || config->components == 0 ||
+        config->level < TAXONOMY_ISOLATED || config->level > TAXONOMY_OPEN) {
+        return DOP_ERROR_INVALID_PARAMETER;
+    }
+    uint32_t mix_total = 0;
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) mix_total += config->mix[type];
+    if (mix_total == 0) return DOP_ERROR_INVALID_PARAMETER;
+
+    memset(result, 0, sizeof(taxonomy_benchmark_result_t));
+    result->config = *config;
+    result->rss_start_kb = benchmark_rss_kb();
+
+    bool isolated = config->level == TAXONOMY_ISOLATED;
+    uint32_t total = isolated ? config->threads * config->components : config->components;
+    dop_component_t** components = calloc(total, sizeof(dop_component_t*));
+    benchmark_worker_t* workers = calloc(config->threads, sizeof(benchmark_worker_t));
+    pthread_t* threads = calloc(config->threads, sizeof(pthread_t));
+    int status = components && workers && threads ? DOP_SUCCESS : DOP_ERROR_MEMORY_ALLOCATION;
+
+    uint32_t created = 0;
+    while (status == DOP_SUCCESS && created < total) {
+        uint32_t index = isolated ? created % config->components : created;
+        components[created] = benchmark_create_component(benchmark_pick_type(config->mix, mix_total, index));
+        if (!components[created]) status = DOP_ERROR_MEMORY_ALLOCATION;
+        else created++;
+    }
+
+    pthread_barrier_t start;
+    atomic_bool stop = false;
+    uint32_t started = 0;
+    if (status == DOP_SUCCESS) {
+        pthread_barrier_init(&start, NULL, config->threads + 1);
+        for (uint32_t t = 0; t < config->threads; t++) {
+            workers[t].config = config;
+            workers[t].components = isolated ? components + t * config->components : components;
+            workers[t].component_count = config->components;
+            workers[t].start = &start;
+            workers[t].stop = &stop;
+            workers[t].seed = 0x9E3779B97F4A7C15ULL * (t + 1);
+        }
+        for (; started < config->threads; started++) {
+            if (pthread_create(&threads[started], NULL, benchmark_worker, &workers[started]) != 0) break;
+        }
+        if (started < config->threads) {
+            // Release the barrier for the workers that did start
+            status = DOP_ERROR_INVALID_STATE;
+            atomic_store(&stop, true);
+            for (uint32_t t = started; t < config->threads; t++) {
+                pthread_barrier_wait(&start);
+            }
+        } else {
+            pthread_barrier_wait(&start);
+            uint64_t start_ns = benchmark_now_ns();
+            usleep(config->duration_ms * 1000);
+            atomic_store(&stop, true);
+            for (uint32_t t = 0; t < started; t++) pthread_join(threads[t], NULL);
+            result->elapsed_ns = benchmark_now_ns() - start_ns;
+            started = 0;
+        }
+        for (uint32_t t = 0; t < started; t++) pthread_join(threads[t], NULL);
+        pthread_barrier_destroy(&start);
+    }
+
+    if (status == DOP_SUCCESS) {
+        for (uint32_t t = 0; t < config->threads; t++) {
+            const benchmark_worker_t* worker = &workers[t];
+            result->operations += worker->operations;
+            result->failures += worker->failures;
+            result->contended += worker->contended;
+            result->lock_wait_ns += worker->lock_wait_ns;
+            for (uint32_t i = 0; i < TAXONOMY_BENCHMARK_BUCKETS; i++) {
+                result->latency_buckets[i] += worker->latency_buckets[i];
+            }
+            if (worker->latency_max_ns > result->latency_max_ns) result->latency_max_ns = worker->latency_max_ns;
+            if (worker->lock_wait_max_ns > result->lock_wait_max_ns) result->lock_wait_max_ns = worker->lock_wait_max_ns;
+        }
+        result->ops_per_sec = result->elapsed_ns ?
+            (double)result->operations * 1e9 / (double)result->elapsed_ns : 0.0;
+        result->latency_p50_ns = benchmark_percentile(result->latency_buckets, result->operations, 0.50);
+        result->latency_p90_ns = benchmark_percentile(result->latency_buckets, result->operations, 0.90);
+        result->latency_p99_ns = benchmark_percentile(result->latency_buckets, result->operations, 0.99);
+        result->latency_p999_ns = benchmark_percentile(result->latency_buckets, result->operations, 0.999);
+        result->rss_end_kb = benchmark_rss_kb();
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) result->rss_peak_kb = (uint64_t)usage.ru_maxrss;
+    }
+
+    for (uint32_t i = 0; i < created; i++) dop_func_destroy_component(components[i]);
+    free(components);
+    free(workers);
+    free(threads);
+    return status;
+}
+
+int taxonomy_benchmark_write_json(const taxonomy_benchmark_result_t* result, FILE* out) {
+    if (!result || !out) return DOP_ERROR_INVALID_PARAMETER;
+
+    const taxonomy_benchmark_config_t* config = &result->config;
+    fprintf(out, "{\"level\": \"%s\", \"threads\": %u, \"duration_ms\": %u, \"components\": %u, "
+                 "\"mix\": {\"alarm\": %u, \"clock\": %u, \"stopwatch\": %u, \"timer\": %u}, ",
+            taxonomy_level_to_string(config->level), config->threads, config->duration_ms, config->components,
+            config->mix[DOP_COMPONENT_ALARM], config->mix[DOP_COMPONENT_CLOCK],
+            config->mix[DOP_COMPONENT_STOPWATCH], config->mix[DOP_COMPONENT_TIMER]);
+    fprintf(out, "\"elapsed_ns\": %llu, \"operations\": %llu, \"failures\": %llu, \"ops_per_sec\": %.1f, ",
+            (unsigned long long)result->elapsed_ns, (unsigned long long)result->operations,
+            (unsigned long long)result->failures, result->ops_per_sec);
+    fprintf(out, "\"latency_ns\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu, "
+                 "\"buckets\": [",
+            (unsigned long long)result->latency_p50_ns, (unsigned long long)result->latency_p90_ns,
+            (unsigned long long)result->latency_p99_ns, (unsigned long long)result->latency_p999_ns,
+            (unsigned long long)result->latency_max_ns);
+    for (uint32_t i = 0; i < TAXONOMY_BENCHMARK_BUCKETS; i++) {
+        fprintf(out, "%s%llu", i ? ", " : "", (unsigned long long)result->latency_buckets[i]);
+    }
+    fprintf(out, "]}, \"lock\": {\"contended\": %llu, \"wait_ns\": %llu, \"wait_max_ns\": %llu}, ",
+            (unsigned long long)result->contended, (unsigned long long)result->lock_wait_ns,
+            (unsigned long long)result->lock_wait_max_ns);
+    fprintf(out, "\"rss_kb\": {\"start\": %llu, \"end\": %llu, \"peak\": %llu}}",
+            (unsigned long long)result->rss_start_kb, (unsigned long long)result->rss_end_kb,
+            (unsigned long long)result->rss_peak_kb);
+    return ferror(out) ? DOP_ERROR_INVALID_STATE : DOP_SUCCESS;
+}
+
+int taxonomy_run_benchmark_suite(const taxonomy_benchmark_config_t* config, FILE* out) {
+    if (!config || !out) return DOP_ERROR_INVALID_PARAMETER;
+
+    static const taxonomy_level_t levels[] = { TAXONOMY_ISOLATED, TAXONOMY_CLOSED, TAXONOMY_OPEN };
+    fprintf(out, "{\"benchmarks\": [\n");
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        taxonomy_benchmark_config_t level_config = *config;
+        level_config.level = levels[i];
+        taxonomy_benchmark_result_t result;
+        int status = taxonomy_run_benchmark(&level_config, &result);
+        if (status != DOP_SUCCESS) return status;
+        fprintf(out, "  ");
+        taxonomy_benchmark_write_json(&result, out);
+        fprintf(out, i + 1 < sizeof(levels) / sizeof(levels[0]) ? ",\n" : "\n");
+    }
+    fprintf(out, "]}\n");
+    return ferror(out) ? DOP_ERROR_INVALID_STATE : DOP_SUCCESS;
+}
+
 // Utility functions
 const char* taxonomy_level_to_string(taxonomy_level_t level) {
     switch (level) {
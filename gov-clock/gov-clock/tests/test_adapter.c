@@ -0,0 +1,103 @@
+// tests/test_adapter.c
+// Checks for the function-pointer and direct-dispatch OOP adapters
+
+#include "dop_adapter.h"
+#include "dop_serialize.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define ADAPTER_BATCH 1000
+
+// Drive any adapter through the same calls
+static void exercise_interface(dop_oop_interface_t* interface) {
+    assert(interface->get_data(interface->instance) == NULL);
+    assert(interface->update(interface->instance) == DOP_ERROR_INVALID_PARAMETER);
+    assert(interface->create(interface->instance, DOP_COMPONENT_CLOCK) == DOP_SUCCESS);
+    dop_component_t* component = interface->get_data(interface->instance);
+    assert(component != NULL && component->metadata.type == DOP_COMPONENT_CLOCK);
+
+    // Updates go through only with the gate open
+    assert(interface->update(interface->instance) == DOP_ERROR_INVALID_PARAMETER);
+    dop_gate_open(component);
+    component->metadata.last_update_timestamp = 0;
+    assert(interface->update(interface->instance) == DOP_SUCCESS);
+    assert(component->metadata.last_update_timestamp != 0);
+
+    char* text = interface->serialize(interface->instance);
+    assert(text != NULL && strstr(text, component->metadata.component_id) != NULL);
+    free(text);
+    unsigned char buffer[1024];
+    size_t written = 0;
+    assert(dop_serialize_size(1) <= sizeof(buffer));
+    assert(interface->serialize_into(interface->instance, buffer, sizeof(buffer), &written) == DOP_SUCCESS);
+    assert(written > 0 && written <= dop_serialize_size(1));
+
+    assert(interface->destroy(interface->instance) == DOP_SUCCESS);
+}
+
+static void test_function_adapter(void) {
+    printf("Testing function adapter...\n");
+
+    assert(dop_adapter_func_to_oop(NULL, dop_func_update_component, dop_func_destroy_component,
+                                   dop_func_serialize_component) == NULL);
+    dop_oop_interface_t* interface = dop_adapter_func_to_oop(dop_func_create_component,
+                                                             dop_func_update_component,
+                                                             dop_func_destroy_component,
+                                                             dop_func_serialize_component);
+    assert(interface != NULL && interface->instance != NULL);
+    exercise_interface(interface);
+    assert(dop_adapter_oop_to_func_create(interface) == dop_func_create_component);
+    assert(dop_adapter_oop_to_func_update(interface) == dop_func_update_component);
+
+    free(interface->instance);
+    free(interface);
+    printf("Function adapter test passed\n");
+}
+
+static void test_direct_adapter(void) {
+    printf("Testing direct adapter...\n");
+
+    // In caller storage the interface points back at its own adapter
+    dop_direct_adapter_t adapter;
+    dop_adapter_direct_init(&adapter);
+    assert(adapter.interface.instance == &adapter && adapter.component == NULL);
+    exercise_interface(&adapter.interface);
+    assert(adapter.component == NULL);
+    assert(adapter.interface.destroy(&adapter) == DOP_ERROR_INVALID_PARAMETER);
+
+    // Heap adapters are one allocation each; a batch update counts the
+    // components it updated and skips empty or missing adapters
+    dop_direct_adapter_t* adapters[ADAPTER_BATCH];
+    for (uint32_t i = 0; i < ADAPTER_BATCH; i++) {
+        adapters[i] = dop_adapter_direct_create();
+        assert(adapters[i] != NULL && adapters[i]->interface.instance == adapters[i]);
+        if (i % 10 == 9) continue;
+        assert(adapters[i]->interface.create(adapters[i], DOP_COMPONENT_CLOCK) == DOP_SUCCESS);
+        if (i % 2 == 0) dop_gate_open(adapters[i]->component);
+    }
+    dop_direct_adapter_t* holes[ADAPTER_BATCH + 1];
+    memcpy(holes, adapters, sizeof(adapters));
+    holes[ADAPTER_BATCH] = NULL;
+    uint32_t open = 0;
+    for (uint32_t i = 0; i < ADAPTER_BATCH; i++) open += i % 10 != 9 && i % 2 == 0;
+    assert(dop_adapter_direct_update_many(holes, ADAPTER_BATCH + 1) == open);
+    assert(dop_adapter_direct_update_many(NULL, ADAPTER_BATCH) == 0);
+    assert(dop_adapter_direct_update_many(adapters, 0) == 0);
+
+    for (uint32_t i = 0; i < ADAPTER_BATCH; i++) {
+        if (adapters[i]->component) {
+            assert(adapters[i]->interface.destroy(adapters[i]) == DOP_SUCCESS);
+        }
+        dop_adapter_direct_free(adapters[i]);
+    }
+    printf("Direct adapter test passed\n");
+}
+
+int main(void) {
+    test_function_adapter();
+    test_direct_adapter();
+    printf("All adapter tests passed!\n");
+    return 0;
+}
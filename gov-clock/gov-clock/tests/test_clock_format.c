@@ -0,0 +1,161 @@
+// tests/test_clock_format.c
+// Checks for clock formatting into caller buffers against a snprintf
+// reference, across the per-second prefix cache
+
+#include "obinexus_dop_core.h"
+#include "dop_update_engine.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define FORMAT_THREADS 4
+#define FORMAT_CLOCKS 64
+
+// What the formatter printed with snprintf before it cached
+static void reference_format(dop_time_data_t time, bool is_24_hour, char* out, size_t size) {
+    if (is_24_hour) {
+        snprintf(out, size, "%02u:%02u:%02u.%03u", time.hours, time.minutes, time.seconds,
+                 time.milliseconds);
+    } else {
+        uint32_t hour = time.hours == 0 ? 12 : time.hours > 12 ? time.hours - 12 : time.hours;
+        snprintf(out, size, "%u:%02u:%02u.%03u %s", hour, time.minutes, time.seconds,
+                 time.milliseconds, time.hours >= 12 ? "PM" : "AM");
+    }
+}
+
+static void set_time(dop_component_t* clock, uint32_t hours, uint32_t minutes, uint32_t seconds,
+                     uint32_t milliseconds) {
+    pthread_mutex_lock(&clock->metadata.mutex);
+    clock->data.clock.current_time.hours = hours;
+    clock->data.clock.current_time.minutes = minutes;
+    clock->data.clock.current_time.seconds = seconds;
+    clock->data.clock.current_time.milliseconds = milliseconds;
+    pthread_mutex_unlock(&clock->metadata.mutex);
+}
+
+static void assert_formats(const dop_component_t* clock) {
+    char expected[DOP_CLOCK_FORMAT_SIZE], actual[DOP_CLOCK_FORMAT_SIZE];
+    pthread_mutex_lock((pthread_mutex_t*)&clock->metadata.mutex);
+    dop_time_data_t time = clock->data.clock.current_time;
+    bool is_24_hour = clock->data.clock.is_24_hour_format;
+    pthread_mutex_unlock((pthread_mutex_t*)&clock->metadata.mutex);
+    reference_format(time, is_24_hour, expected, sizeof(expected));
+    assert(dop_clock_format_time_into(clock, actual, sizeof(actual)) == DOP_SUCCESS);
+    assert(strcmp(actual, expected) == 0);
+}
+
+static void test_format_into(void) {
+    printf("Testing clock format into buffers...\n");
+
+    dop_component_t* clock = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    dop_component_t* other = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    assert(clock != NULL && other != NULL);
+
+    // Every hour in both formats; consecutive calls change one field at a
+    // time, so a stale cached prefix would show
+    for (int format = 0; format < 2; format++) {
+        assert(dop_clock_set_format(clock, format == 0) == DOP_SUCCESS);
+        for (uint32_t hours = 0; hours < 24; hours++) {
+            for (uint32_t ms = 0; ms < 1000; ms += 37) {
+                set_time(clock, hours, 59, 7, ms);
+                assert_formats(clock);
+            }
+            set_time(clock, hours, 58, 7, 5);
+            assert_formats(clock);
+            set_time(clock, hours, 58, 8, 5);
+            assert_formats(clock);
+        }
+        set_time(clock, 12, 0, 0, 0);   // Noon, then midnight in the same second
+        assert_formats(clock);
+        set_time(clock, 0, 0, 0, 0);
+        assert_formats(clock);
+    }
+
+    // Same second on two clocks of different formats
+    assert(dop_clock_set_format(clock, true) == DOP_SUCCESS);
+    assert(dop_clock_set_format(other, false) == DOP_SUCCESS);
+    set_time(clock, 13, 14, 15, 16);
+    set_time(other, 13, 14, 15, 16);
+    assert_formats(clock);
+    assert_formats(other);
+    assert_formats(clock);
+
+    // The buffer must hold the text and its terminator
+    char small[DOP_CLOCK_FORMAT_SIZE];
+    assert(dop_clock_format_time_into(clock, small, 12) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_clock_format_time_into(clock, small, 13) == DOP_SUCCESS);
+    assert(strcmp(small, "13:14:15.016") == 0);
+    assert(dop_clock_format_time_into(other, small, 14) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_clock_format_time_into(other, small, 15) == DOP_SUCCESS);
+    assert(strcmp(small, "1:14:15.016 PM") == 0);
+    assert(dop_clock_format_time_into(NULL, small, sizeof(small)) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_clock_format_time_into(clock, NULL, sizeof(small)) == DOP_ERROR_INVALID_PARAMETER);
+    dop_component_t* timer = dop_func_create_component(DOP_COMPONENT_TIMER);
+    assert(dop_clock_format_time_into(timer, small, sizeof(small)) == DOP_ERROR_INVALID_PARAMETER);
+
+    // The allocating call returns the same text
+    char* formatted = dop_clock_format_time(other);
+    assert(formatted != NULL && strcmp(formatted, "1:14:15.016 PM") == 0);
+    free(formatted);
+    assert(dop_clock_format_time(timer) == NULL);
+
+    dop_func_destroy_component(timer);
+    dop_func_destroy_component(clock);
+    dop_func_destroy_component(other);
+    printf("Clock format into buffers test passed\n");
+}
+
+static dop_component_t* tick_clocks[FORMAT_CLOCKS];
+
+// Each thread keeps its own cache; formatting clocks set to other seconds
+// in between must not disturb it
+static void* format_clocks(void* arg) {
+    uint32_t offset = (uint32_t)(uintptr_t)arg;
+    dop_component_t* clock = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    assert(clock != NULL);
+    for (uint32_t i = 0; i < 5000; i++) {
+        set_time(clock, (i / 3600 + offset) % 24, i / 60 % 60, (i + offset) % 60, i % 1000);
+        assert_formats(clock);
+        assert_formats(tick_clocks[i % FORMAT_CLOCKS]);
+    }
+    dop_func_destroy_component(clock);
+    return NULL;
+}
+
+static void test_engine_clocks(void) {
+    printf("Testing clocks from one engine tick...\n");
+
+    // Clocks updated by one tick share its reading and so its text
+    dop_update_engine_t* engine = dop_update_engine_create();
+    for (uint32_t i = 0; i < FORMAT_CLOCKS; i++) {
+        tick_clocks[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        dop_gate_open(tick_clocks[i]);
+        assert(dop_update_engine_add(engine, tick_clocks[i]) == DOP_SUCCESS);
+    }
+    assert(dop_update_engine_tick(engine) == FORMAT_CLOCKS);
+    char first[DOP_CLOCK_FORMAT_SIZE], text[DOP_CLOCK_FORMAT_SIZE];
+    assert(dop_clock_format_time_into(tick_clocks[0], first, sizeof(first)) == DOP_SUCCESS);
+    for (uint32_t i = 0; i < FORMAT_CLOCKS; i++) {
+        assert(dop_clock_format_time_into(tick_clocks[i], text, sizeof(text)) == DOP_SUCCESS);
+        assert(strcmp(text, first) == 0);
+        assert_formats(tick_clocks[i]);
+    }
+
+    pthread_t threads[FORMAT_THREADS];
+    for (uintptr_t t = 0; t < FORMAT_THREADS; t++) {
+        assert(pthread_create(&threads[t], NULL, format_clocks, (void*)(t * 7)) == 0);
+    }
+    for (int t = 0; t < FORMAT_THREADS; t++) pthread_join(threads[t], NULL);
+
+    dop_update_engine_destroy(engine);
+    for (uint32_t i = 0; i < FORMAT_CLOCKS; i++) dop_func_destroy_component(tick_clocks[i]);
+    printf("Engine clock test passed\n");
+}
+
+int main(void) {
+    test_format_into();
+    test_engine_clocks();
+    printf("All clock format tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+// tests/test_component_pool.c
+// Checks for the object pools and the per-type component pools behind
+// dop_func_create_component and dop_func_destroy_component
+
+#include "dop_component_pool.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define POOL_OBJECTS 1000
+#define POOL_THREADS 4
+#define POOL_ROUNDS 2000
+#define POOL_HELD 16
+#define COMPONENT_CHURN 10000
+
+typedef struct {
+    uint64_t head;
+    pthread_mutex_t mutex;
+    char tail[40];
+} pooled_object_t;
+
+static void test_object_pool(void) {
+    printf("Testing object pool...\n");
+
+    assert(dop_object_pool_create(0, 0) == NULL);
+    assert(dop_object_pool_create(sizeof(pooled_object_t), sizeof(pooled_object_t)) == NULL);
+    dop_object_pool_t* pool = dop_object_pool_create(sizeof(pooled_object_t),
+                                                     offsetof(pooled_object_t, mutex));
+    assert(pool != NULL);
+
+    // Reserved capacity is there before the first acquire
+    dop_pool_stats_t stats;
+    assert(dop_object_pool_reserve(pool, POOL_OBJECTS) == DOP_SUCCESS);
+    dop_object_pool_get_stats(pool, &stats);
+    uint32_t reserved = stats.capacity;
+    assert(reserved >= POOL_OBJECTS && stats.in_use == 0);
+
+    pooled_object_t* objects[POOL_OBJECTS];
+    uint64_t handles[POOL_OBJECTS];
+    for (uint32_t i = 0; i < POOL_OBJECTS; i++) {
+        objects[i] = dop_object_pool_acquire(pool);
+        assert(objects[i] != NULL && objects[i]->head == 0 && objects[i]->tail[39] == 0);
+        assert((uintptr_t)objects[i] % 64 == 0);    // A cache line, for embedded aligned members
+        objects[i]->head = i + 1;
+        memset(objects[i]->tail, 0x5a, sizeof(objects[i]->tail));
+        handles[i] = dop_object_pool_handle(pool, objects[i]);
+        assert(handles[i] != 0 && handles[i] < (1ULL << 56));
+        assert(dop_object_pool_resolve(pool, handles[i]) == objects[i]);
+    }
+    for (uint32_t i = 1; i < POOL_OBJECTS; i++) assert(objects[i] != objects[i - 1]);
+    dop_object_pool_get_stats(pool, &stats);
+    assert(stats.capacity == reserved && stats.in_use == POOL_OBJECTS);
+
+    // Released, a handle no longer resolves and a second release is refused
+    pooled_object_t* first = objects[0];
+    assert(dop_object_pool_release(pool, first) == DOP_SUCCESS);
+    assert(dop_object_pool_release(pool, first) == DOP_ERROR_INVALID_STATE);
+    assert(dop_object_pool_resolve(pool, handles[0]) == NULL);
+    assert(dop_object_pool_resolve(pool, 0) == NULL);
+    assert(dop_object_pool_resolve(pool, UINT32_MAX) == NULL);
+
+    // The slot comes back zeroed, with a new handle and a working mutex
+    pooled_object_t* reused = dop_object_pool_acquire(pool);
+    assert(reused == first && reused->head == 0);
+    for (size_t i = 0; i < sizeof(reused->tail); i++) assert(reused->tail[i] == 0);
+    assert(dop_object_pool_handle(pool, reused) != handles[0]);
+    assert(pthread_mutex_lock(&reused->mutex) == 0 && pthread_mutex_unlock(&reused->mutex) == 0);
+    objects[0] = reused;
+
+    for (uint32_t i = 0; i < POOL_OBJECTS; i++) {
+        assert(dop_object_pool_release(pool, objects[i]) == DOP_SUCCESS);
+    }
+    dop_object_pool_get_stats(pool, &stats);
+    assert(stats.acquired == POOL_OBJECTS + 1 && stats.released == POOL_OBJECTS + 1);
+    assert(stats.in_use == 0 && stats.capacity == reserved);
+
+    dop_object_pool_destroy(pool);
+    printf("Object pool test passed\n");
+}
+
+static dop_object_pool_t* shared_pool;
+
+static void* churn_objects(void* arg) {
+    uint64_t tag = (uint64_t)(uintptr_t)arg;
+    pooled_object_t* held[POOL_HELD];
+    for (int round = 0; round < POOL_ROUNDS; round++) {
+        for (int i = 0; i < POOL_HELD; i++) {
+            held[i] = dop_object_pool_acquire(shared_pool);
+            assert(held[i] != NULL && held[i]->head == 0);
+            held[i]->head = tag;
+        }
+        for (int i = 0; i < POOL_HELD; i++) {
+            assert(held[i]->head == tag);   // Nobody else was handed it
+            pthread_mutex_lock(&held[i]->mutex);
+            pthread_mutex_unlock(&held[i]->mutex);
+            assert(dop_object_pool_release(shared_pool, held[i]) == DOP_SUCCESS);
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_pool(void) {
+    printf("Testing concurrent pool...\n");
+
+    shared_pool = dop_object_pool_create(sizeof(pooled_object_t), offsetof(pooled_object_t, mutex));
+    assert(shared_pool != NULL);
+    pthread_t threads[POOL_THREADS];
+    for (uintptr_t t = 0; t < POOL_THREADS; t++) {
+        assert(pthread_create(&threads[t], NULL, churn_objects, (void*)(t + 1)) == 0);
+    }
+    for (int t = 0; t < POOL_THREADS; t++) pthread_join(threads[t], NULL);
+
+    // Churn recycles; the pool only grew to what was held at once
+    dop_pool_stats_t stats;
+    dop_object_pool_get_stats(shared_pool, &stats);
+    assert(stats.acquired == (uint64_t)POOL_THREADS * POOL_ROUNDS * POOL_HELD);
+    assert(stats.released == stats.acquired && stats.in_use == 0);
+    assert(stats.capacity >= POOL_HELD && stats.capacity <= 256);  // One chunk
+
+    dop_object_pool_destroy(shared_pool);
+    printf("Concurrent pool test passed\n");
+}
+
+static void test_component_pools(void) {
+    printf("Testing component pools...\n");
+
+    assert(dop_component_pool_reserve(DOP_COMPONENT_COUNT, 1) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_func_create_component(DOP_COMPONENT_COUNT) == NULL);
+    assert(dop_component_pool_reserve(DOP_COMPONENT_CLOCK, 512) == DOP_SUCCESS);
+    dop_pool_stats_t before, after;
+    dop_component_pool_get_stats(DOP_COMPONENT_CLOCK, &before);
+
+    // A new component is fully initialised, whatever the slot held before
+    dop_component_t* clock = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    assert(clock != NULL);
+    assert(strcmp(clock->metadata.component_name, "Clock Component") == 0);
+    assert(clock->metadata.type == DOP_COMPONENT_CLOCK && clock->metadata.state == DOP_STATE_READY);
+    assert(clock->metadata.gate_state == DOP_GATE_CLOSED && clock->data.clock.is_running);
+    assert(dop_checksum_verify(clock));
+
+    // Handles carry the type and go stale on destroy
+    dop_component_t* timer = dop_func_create_component(DOP_COMPONENT_TIMER);
+    assert(timer != NULL && strcmp(timer->metadata.component_id, clock->metadata.component_id) != 0);
+    dop_component_handle_t clock_handle = dop_component_get_handle(clock);
+    dop_component_handle_t timer_handle = dop_component_get_handle(timer);
+    assert(clock_handle >> 56 == DOP_COMPONENT_CLOCK && timer_handle >> 56 == DOP_COMPONENT_TIMER);
+    assert(dop_component_from_handle(clock_handle) == clock);
+    assert(dop_component_from_handle(timer_handle) == timer);
+    assert(dop_func_destroy_component(timer) == DOP_SUCCESS);
+    assert(dop_component_from_handle(timer_handle) == NULL);
+    assert(dop_component_get_handle(NULL) == 0);
+    assert(dop_func_destroy_component(NULL) == DOP_ERROR_INVALID_PARAMETER);
+
+    // Create, open, destroy churn never grows the reserved pool
+    for (int i = 0; i < COMPONENT_CHURN; i++) {
+        dop_component_t* component = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(component != NULL && component->metadata.gate_state == DOP_GATE_CLOSED);
+        assert(dop_gate_open(component) == DOP_SUCCESS && dop_gate_is_accessible(component));
+        assert(dop_func_destroy_component(component) == DOP_SUCCESS);
+    }
+    assert(dop_func_destroy_component(clock) == DOP_SUCCESS);
+    dop_component_pool_get_stats(DOP_COMPONENT_CLOCK, &after);
+    assert(after.capacity == before.capacity && after.in_use == before.in_use);
+    assert(after.acquired - before.acquired == COMPONENT_CHURN + 1);
+
+    printf("Component pool test passed\n");
+}
+
+int main(void) {
+    test_object_pool();
+    test_concurrent_pool();
+    test_component_pools();
+    printf("All component pool tests passed!\n");
+    return 0;
+}
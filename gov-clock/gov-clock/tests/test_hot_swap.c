@@ -0,0 +1,360 @@
+// tests/test_hot_swap.c
+// Checks for the in-place and shadow hot swaps in obinexus_dop_core.c. The
+// swaps load component libraries from /opt/obinexus; the check includes the
+// unit with dlopen, dlsym and dlclose standing in fake libraries, picked by
+// the version in the path, so its private types are in reach too.
+
+#define dlopen fake_dlopen
+#define dlsym fake_dlsym
+#define dlclose fake_dlclose
+#include "../src/obinexus_dop_core.c"
+#undef dlopen
+#undef dlsym
+#undef dlclose
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define UPDATERS 4
+#define LOADED_SWAPS 64
+
+// Minor versions of the libraries that fail a step, or are missing
+#define MINOR_FAILS_VALIDATE 900
+#define MINOR_FAILS_SHADOW 901
+#define MINOR_FAILS_CUTOVER_SYNC 902
+#define MINOR_MISSING 903
+
+// Even and odd minor versions get their own set of operations. Every update
+// counts in applied and in its set's state; a sync takes the state over
+// from applied and resume marks the set serving.
+static _Atomic uint64_t applied;
+static _Atomic uint64_t set_state[2];
+static _Atomic int serving_set;
+static _Atomic int shadows, syncs, cutover_syncs, resumes, quiesces;
+static _Atomic int libraries_opened, libraries_closed;
+static char last_path[256];
+
+static int notifications;
+static uint32_t notified_from, notified_to;
+
+typedef struct {
+    int (*update)(void* component);
+    int (*validate)(void* component);
+    int (*quiesce)(void* component);
+    int (*resume)(void* component);
+    int (*shadow)(void* component);
+    int (*sync)(void* component);
+} fake_library_t;
+
+static int update_on(int set) {
+    // An update never runs on a version other than the published one
+    assert(atomic_load(&serving_set) == set);
+    atomic_fetch_add(&applied, 1);
+    atomic_fetch_add(&set_state[set], 1);
+    return DOP_SUCCESS;
+}
+
+static int sync_on(int set, void* component) {
+    atomic_fetch_add(&syncs, 1);
+    if (atomic_load(&((enhanced_dop_component_t*)component)->cutover)) {
+        atomic_fetch_add(&cutover_syncs, 1);
+    }
+    atomic_store(&set_state[set], atomic_load(&applied));
+    return DOP_SUCCESS;
+}
+
+static int shadow_on(int set) {
+    atomic_fetch_add(&shadows, 1);
+    atomic_store(&set_state[set], 0);
+    return DOP_SUCCESS;
+}
+
+static int resume_on(int set) {
+    atomic_fetch_add(&resumes, 1);
+    atomic_store(&serving_set, set);
+    return DOP_SUCCESS;
+}
+
+static int even_update(void* component) { (void)component; return update_on(0); }
+static int odd_update(void* component) { (void)component; return update_on(1); }
+static int even_sync(void* component) { return sync_on(0, component); }
+static int odd_sync(void* component) { return sync_on(1, component); }
+static int even_shadow(void* component) { (void)component; return shadow_on(0); }
+static int odd_shadow(void* component) { (void)component; return shadow_on(1); }
+static int even_resume(void* component) { (void)component; return resume_on(0); }
+static int odd_resume(void* component) { (void)component; return resume_on(1); }
+
+static int validate_ok(void* component) {
+    (void)component;
+    return DOP_SUCCESS;
+}
+
+static int quiesce_ok(void* component) {
+    (void)component;
+    atomic_fetch_add(&quiesces, 1);
+    return DOP_SUCCESS;
+}
+
+static int validate_fails(void* component) {
+    (void)component;
+    return DOP_ERROR_VALIDATION_FAILED;
+}
+
+static int shadow_fails(void* component) {
+    (void)component;
+    atomic_fetch_add(&shadows, 1);
+    return DOP_ERROR_VALIDATION_FAILED;
+}
+
+// Catches up while the old version serves, then fails the final delta
+static int sync_fails_at_cutover(void* component) {
+    atomic_fetch_add(&syncs, 1);
+    return atomic_load(&((enhanced_dop_component_t*)component)->cutover)
+        ? DOP_ERROR_VALIDATION_FAILED : DOP_SUCCESS;
+}
+
+void* fake_dlopen(const char* path, int flags) {
+    (void)flags;
+    snprintf(last_path, sizeof(last_path), "%s", path);
+    unsigned major, minor, patch;
+    const char* version = strstr(path, "/v");
+    if (!version || sscanf(version, "/v%u.%u.%u/", &major, &minor, &patch) != 3 ||
+        minor == MINOR_MISSING) {
+        return NULL;
+    }
+
+    fake_library_t* library = calloc(1, sizeof(fake_library_t));
+    assert(library != NULL);
+    int odd = minor & 1;
+    library->update = odd ? odd_update : even_update;
+    library->validate = minor == MINOR_FAILS_VALIDATE ? validate_fails : validate_ok;
+    library->quiesce = quiesce_ok;
+    library->resume = odd ? odd_resume : even_resume;
+    library->shadow = minor == MINOR_FAILS_SHADOW ? shadow_fails : odd ? odd_shadow : even_shadow;
+    library->sync = minor == MINOR_FAILS_CUTOVER_SYNC ? sync_fails_at_cutover : odd ? odd_sync : even_sync;
+    atomic_fetch_add(&libraries_opened, 1);
+    return library;
+}
+
+void* fake_dlsym(void* handle, const char* name) {
+    fake_library_t* library = handle;
+    int (*operation)(void*) = NULL;
+    if (strcmp(name, "component_update") == 0) operation = library->update;
+    else if (strcmp(name, "component_validate") == 0) operation = library->validate;
+    else if (strcmp(name, "component_quiesce") == 0) operation = library->quiesce;
+    else if (strcmp(name, "component_resume") == 0) operation = library->resume;
+    else if (strcmp(name, "component_shadow") == 0) operation = library->shadow;
+    else if (strcmp(name, "component_sync") == 0) operation = library->sync;
+
+    // As dlsym hands it back: a function pointer in a void*
+    void* symbol;
+    memcpy(&symbol, &operation, sizeof(symbol));
+    return symbol;
+}
+
+int fake_dlclose(void* handle) {
+    atomic_fetch_add(&libraries_closed, 1);
+    free(handle);
+    return 0;
+}
+
+// Declared by nexus_link_semserver_x.h and not defined in src/ yet; the
+// check records the notification every published swap sends
+swap_result_t nexus_hot_swap_component(nexus_resolution_context_t* ctx,
+                                       const char* component_id,
+                                       semantic_version_x_t* old_version,
+                                       semantic_version_x_t* new_version,
+                                       bool force_swap) {
+    (void)force_swap;
+    assert(ctx == g_nexus_ctx && strncmp(component_id, "obinexus.dop.alarm_", 19) == 0);
+    notifications++;
+    notified_from = old_version->minor;
+    notified_to = new_version->minor;
+    return SWAP_SUCCESS;
+}
+
+fault_tolerant_component_t* nexus_create_fault_tolerant(nexus_resolution_context_t* ctx,
+                                                        const char* primary_id,
+                                                        const char* fallback_id) {
+    (void)ctx;
+    (void)primary_id;
+    (void)fallback_id;
+    return NULL;
+}
+
+static enhanced_dop_component_t* component;
+static uint32_t serving_minor;
+
+static semantic_version_x_t version_of(uint32_t major, uint32_t minor) {
+    semantic_version_x_t version = {.major = major, .minor = minor, .is_hot_swappable = true};
+    return version;
+}
+
+static uint32_t published_minor(void) {
+    const dop_component_impl_t* impl = dop_component_acquire(component);
+    assert(impl != NULL);
+    uint32_t minor = impl->semver_x.minor;
+    dop_component_release();
+    return minor;
+}
+
+// A swap that is refused leaves the serving version alone and unloads
+// whatever it loaded
+static void expect_refused(uint32_t major, uint32_t minor, int error) {
+    semantic_version_x_t version = version_of(major, minor);
+    int opened = atomic_load(&libraries_opened);
+    int closed = atomic_load(&libraries_closed);
+    int notified = notifications;
+    assert(dop_hot_swap_component_shadow(component, &version, false, NULL) == error);
+    assert(published_minor() == serving_minor && atomic_load(&serving_set) == (int)(serving_minor & 1));
+    assert(atomic_load(&libraries_opened) - opened == atomic_load(&libraries_closed) - closed);
+    assert(notifications == notified && !atomic_load(&component->cutover));
+    assert(dop_component_update(component) == DOP_SUCCESS);
+}
+
+static void test_refused_swaps(void) {
+    printf("Testing refused shadow swaps...\n");
+
+    expect_refused(2, 0, DOP_ERROR_VERSION_INCOMPATIBLE);
+    expect_refused(1, MINOR_MISSING, DOP_ERROR_LIBRARY_LOAD_FAILED);
+    assert(strncmp(last_path, "/opt/obinexus/components/obinexus.dop.alarm_", 44) == 0);
+    expect_refused(1, MINOR_FAILS_VALIDATE, DOP_ERROR_VALIDATION_FAILED);
+
+    int shadowed = atomic_load(&shadows);
+    expect_refused(1, MINOR_FAILS_SHADOW, DOP_ERROR_VALIDATION_FAILED);
+    assert(atomic_load(&shadows) == shadowed + 1);
+
+    // A failed final delta publishes nothing, and updates carry on
+    int synced = atomic_load(&syncs);
+    expect_refused(1, MINOR_FAILS_CUTOVER_SYNC, DOP_ERROR_VALIDATION_FAILED);
+    assert(atomic_load(&syncs) - synced == 2);
+
+    assert(dop_hot_swap_component_shadow(NULL, NULL, false, NULL) == DOP_ERROR_INVALID_PARAMETER);
+    printf("Refused shadow swaps test passed\n");
+}
+
+static void test_shadow_swap(void) {
+    printf("Testing shadow swap...\n");
+
+    // With no traffic: shadow, one quiet round, then the final delta
+    int shadowed = atomic_load(&shadows);
+    int synced = atomic_load(&syncs);
+    int cutovers = atomic_load(&cutover_syncs);
+    int closed = atomic_load(&libraries_closed);
+    uint64_t before = atomic_load(&applied);
+    semantic_version_x_t version = version_of(1, ++serving_minor);
+    uint64_t cutover_ns = 0;
+    assert(dop_hot_swap_component_shadow(component, &version, false, &cutover_ns) == DOP_SUCCESS);
+    assert(atomic_load(&shadows) - shadowed == 1);
+    assert(atomic_load(&syncs) - synced == 2 && atomic_load(&cutover_syncs) - cutovers == 1);
+    assert(published_minor() == serving_minor && atomic_load(&serving_set) == 1);
+    assert(atomic_load(&set_state[1]) == before);
+    assert(atomic_load(&libraries_closed) == closed + 1);
+
+    // The cutover window is what gets recorded
+    assert(cutover_ns > 0 && component->last_cutover_ns == cutover_ns);
+    assert(version.swap_duration_ms == (cutover_ns + 999999) / 1000000);
+    assert(notifications > 0 && notified_from == serving_minor - 1 && notified_to == serving_minor);
+    component_evolution_t* evolution = component->metadata.evolution;
+    assert(evolution != NULL && evolution->current_version.minor == serving_minor);
+
+    assert(dop_component_update(component) == DOP_SUCCESS);
+    assert(atomic_load(&set_state[1]) == atomic_load(&applied));
+    printf("Shadow swap test passed\n");
+}
+
+static _Atomic bool stop_updates;
+
+static void* updater(void* arg) {
+    uint64_t* calls = arg;
+    while (!atomic_load(&stop_updates)) {
+        assert(dop_component_update(component) == DOP_SUCCESS);
+        (*calls)++;
+    }
+    return NULL;
+}
+
+static void test_shadow_swap_under_load(void) {
+    printf("Testing shadow swaps under load...\n");
+
+    pthread_t threads[UPDATERS];
+    uint64_t calls[UPDATERS] = {0};
+    uint64_t before = atomic_load(&applied);
+    atomic_store(&stop_updates, false);
+    for (int i = 0; i < UPDATERS; i++) {
+        assert(pthread_create(&threads[i], NULL, updater, &calls[i]) == 0);
+    }
+
+    uint32_t swaps_before = component->metadata.evolution->total_swaps;
+    for (int i = 0; i < LOADED_SWAPS; i++) {
+        semantic_version_x_t version = version_of(1, serving_minor + 1);
+        assert(dop_hot_swap_component_shadow(component, &version, false, NULL) == DOP_SUCCESS);
+        serving_minor++;
+        sched_yield();
+    }
+
+    atomic_store(&stop_updates, true);
+    uint64_t total = 0;
+    for (int i = 0; i < UPDATERS; i++) {
+        pthread_join(threads[i], NULL);
+        total += calls[i];
+    }
+
+    // Every update ran exactly once, and the serving version's state took
+    // over every one made before its cutover
+    assert(atomic_load(&applied) - before == total);
+    int set = (int)(serving_minor & 1);
+    assert(atomic_load(&serving_set) == set && published_minor() == serving_minor);
+    assert(atomic_load(&set_state[set]) == atomic_load(&applied));
+    assert(component->metadata.evolution->total_swaps - swaps_before == LOADED_SWAPS);
+    assert(atomic_load(&libraries_opened) - atomic_load(&libraries_closed) == 1);
+    printf("Shadow swaps under load test passed (%llu updates)\n", (unsigned long long)total);
+}
+
+static void test_in_place_swap(void) {
+    printf("Testing in-place swap...\n");
+
+    // The new version asks for quiescing; the serving one does not
+    semantic_version_x_t version = version_of(1, ++serving_minor);
+    version.requires_quiesce = true;
+    int quiesced = atomic_load(&quiesces);
+    int closed = atomic_load(&libraries_closed);
+    assert(dop_hot_swap_component(component, &version, false) == DOP_SUCCESS);
+    assert(published_minor() == serving_minor && atomic_load(&serving_set) == (int)(serving_minor & 1));
+    assert(atomic_load(&quiesces) == quiesced && atomic_load(&libraries_closed) == closed + 1);
+    assert(notified_to == serving_minor);
+
+    // Now it is the old one, so it is quiesced before the next goes out
+    version = version_of(1, ++serving_minor);
+    assert(dop_hot_swap_component(component, &version, false) == DOP_SUCCESS);
+    assert(published_minor() == serving_minor && atomic_load(&quiesces) == quiesced + 1);
+    assert(dop_component_update(component) == DOP_SUCCESS);
+
+    version = version_of(1, MINOR_MISSING);
+    assert(dop_hot_swap_component(component, &version, false) == DOP_ERROR_LIBRARY_LOAD_FAILED);
+    version = version_of(0, 1);
+    assert(dop_hot_swap_component(component, &version, false) == DOP_ERROR_VERSION_INCOMPATIBLE);
+    assert(published_minor() == serving_minor);
+    printf("In-place swap test passed\n");
+}
+
+int main(void) {
+    assert(dop_enhanced_init(NULL) == DOP_SUCCESS);
+    semantic_version_x_t requested = version_of(1, 0);
+    component = dop_create_enhanced_component("obinexus.dop.alarm", &requested);
+    assert(component != NULL && component->metadata.is_hot_swappable);
+    assert(published_minor() == 0 && atomic_load(&libraries_opened) == 1);
+
+    test_refused_swaps();
+    test_shadow_swap();
+    test_shadow_swap_under_load();
+    test_in_place_swap();
+
+    assert(dop_destroy_enhanced_component(component) == DOP_SUCCESS);
+    assert(atomic_load(&libraries_opened) == atomic_load(&libraries_closed));
+    printf("All hot swap tests passed!\n");
+    return 0;
+}
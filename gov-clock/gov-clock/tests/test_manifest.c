@@ -0,0 +1,341 @@
+// tests/test_manifest.c
+// Checks for the buffered manifest writer, the streaming reader and the
+// binary manifest loaded in place of unchanged XML
+
+#define _POSIX_C_SOURCE 200809L  // mkdtemp, gmtime_r
+
+#include "dop_manifest.h"
+#include "dop_topology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define MANIFEST_NODES 2000
+
+static char directory[64];
+static char xml_path[128];
+static char bin_path[160];
+static char log_path[128];
+static dop_component_t* components[MANIFEST_NODES];
+
+// Components are found by the "comp.NNNN" ids given to them below
+static dop_component_t* resolve_component(const char* component_ref, void* user_data) {
+    (void)user_data;
+    unsigned index;
+    char rest;
+    if (sscanf(component_ref, "comp.%u%c", &index, &rest) != 1 || index >= MANIFEST_NODES) return NULL;
+    return components[index];
+}
+
+static dop_component_t* resolve_nothing(const char* component_ref, void* user_data) {
+    (void)component_ref;
+    (void)user_data;
+    return NULL;
+}
+
+static void write_text(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    assert(file != NULL);
+    fputs(text, file);
+    fclose(file);
+}
+
+static char* read_text(const char* path) {
+    FILE* file = fopen(path, "r");
+    assert(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+    char* text = malloc((size_t)length + 1);
+    assert(text != NULL && fread(text, 1, (size_t)length, file) == (size_t)length);
+    text[length] = '\0';
+    fclose(file);
+    return text;
+}
+
+static void destroy_nodes(dop_build_topology_t* topology) {
+    for (uint32_t i = 0; i < topology->node_count; i++) dop_topology_destroy_node(topology->nodes[i]);
+    dop_topology_release(topology);
+}
+
+// Node i peers with i+1 and i+7; every other node is fault tolerant, and
+// node 0's id needs escaping
+static void build_topology(dop_build_topology_t* topology) {
+    memset(topology, 0, sizeof(*topology));
+    strcpy(topology->build_id, "gov-clock & <co>");
+    topology->is_p2p_enabled = true;
+    topology->is_fault_tolerant = true;
+    for (uint32_t i = 0; i < MANIFEST_NODES; i++) {
+        char id[64];
+        snprintf(id, sizeof(id), i ? "node.%04u" : "node.\"a&b<c>'%u", i);
+        dop_topology_node_t* node = dop_topology_create_node(id, components[i]);
+        assert(node != NULL);
+        node->is_fault_tolerant = i % 2 == 0;
+        assert(dop_topology_add_node(topology, node) == DOP_SUCCESS);
+    }
+    for (uint32_t i = 0; i < MANIFEST_NODES; i++) {
+        assert(dop_topology_add_peer(topology->nodes[i], topology->nodes[(i + 1) % MANIFEST_NODES]) ==
+               DOP_SUCCESS);
+        assert(dop_topology_add_peer(topology->nodes[i], topology->nodes[(i + 7) % MANIFEST_NODES]) ==
+               DOP_SUCCESS);
+    }
+}
+
+// Same settings, and the same nodes in order with the same peers
+static void assert_same_topology(const dop_build_topology_t* loaded, uint32_t first,
+                                 const dop_build_topology_t* saved) {
+    assert(strcmp(loaded->build_id, saved->build_id) == 0);
+    assert(loaded->is_p2p_enabled == saved->is_p2p_enabled);
+    assert(loaded->is_fault_tolerant == saved->is_fault_tolerant);
+    assert(loaded->node_count == first + saved->node_count);
+    for (uint32_t i = 0; i < saved->node_count; i++) {
+        const dop_topology_node_t* a = loaded->nodes[first + i];
+        const dop_topology_node_t* b = saved->nodes[i];
+        assert(strcmp(a->node_id, b->node_id) == 0);
+        assert(a->component == b->component && a->is_fault_tolerant == b->is_fault_tolerant);
+        assert(a->peer_count == b->peer_count);
+        for (uint32_t j = 0; j < b->peer_count; j++) {
+            assert(strcmp(a->peers[j]->node_id, b->peers[j]->node_id) == 0);
+        }
+    }
+}
+
+static void test_round_trip(void) {
+    printf("Testing manifest round trip...\n");
+
+    dop_build_topology_t saved;
+    build_topology(&saved);
+    assert(dop_manifest_save_to_xml(NULL, xml_path) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_manifest_save_to_xml(&saved, xml_path) == DOP_SUCCESS);
+    assert(dop_manifest_validate_schema(xml_path) == DOP_SUCCESS);
+
+    // Markup in text is escaped, and the timestamp is the time of the save
+    char* text = read_text(xml_path);
+    assert(strstr(text, "<dop:target_name>gov-clock &amp; &lt;co&gt;</dop:target_name>") != NULL);
+    assert(strstr(text, "<dop:node_id>node.&quot;a&amp;b&lt;c&gt;&apos;0</dop:node_id>") != NULL);
+    time_t now = time(NULL);
+    struct tm utc;
+    char year[32];
+    gmtime_r(&now, &utc);
+    strftime(year, sizeof(year), "<dop:build_timestamp>%Y-", &utc);
+    assert(strstr(text, year) != NULL);
+    free(text);
+
+    // Settings only, without a resolver
+    dop_build_topology_t settings;
+    memset(&settings, 0, sizeof(settings));
+    assert(dop_manifest_load_from_xml(xml_path, &settings) == DOP_SUCCESS);
+    assert(strcmp(settings.build_id, saved.build_id) == 0);
+    assert(settings.is_p2p_enabled && settings.is_fault_tolerant && settings.node_count == 0);
+
+    // Nodes and peers, appended after the nodes already there
+    dop_build_topology_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    assert(dop_topology_add_node(&loaded, dop_topology_create_node("existing", components[0])) ==
+           DOP_SUCCESS);
+    assert(dop_manifest_load_topology_from_xml(xml_path, &loaded, NULL, NULL) ==
+           DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_manifest_load_topology_from_xml(xml_path, &loaded, resolve_component, NULL) ==
+           DOP_SUCCESS);
+    assert_same_topology(&loaded, 1, &saved);
+
+    destroy_nodes(&loaded);
+    destroy_nodes(&saved);
+    unlink(xml_path);
+    unlink(bin_path);
+    printf("Manifest round trip test passed\n");
+}
+
+static void test_reader(void) {
+    printf("Testing manifest reader...\n");
+
+    // Declarations, comments, CDATA, attributes and character references
+    write_text(xml_path,
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE manifest>\n"
+        "<dop:dop_manifest xmlns:dop=\"urn:dop\" note='a > b'>\n"
+        "  <!-- <dop:build_id>commented</dop:build_id> -->\n"
+        "  <![CDATA[ <dop:node> ]]>\n"
+        "  <dop:build_id> &#65;&#x42;c </dop:build_id>\n"
+        "  <dop:p2p_enabled>1</dop:p2p_enabled>\n"
+        "  <dop:nodes>\n"
+        "    <dop:node><dop:node_id>one</dop:node_id><dop:component_ref>comp.1</dop:component_ref>\n"
+        "      <dop:is_fault_tolerant>false</dop:is_fault_tolerant>\n"
+        "      <dop:peer_connections><dop:peer>two</dop:peer></dop:peer_connections></dop:node>\n"
+        "    <dop:node><dop:node_id>two</dop:node_id><dop:component_ref>comp.2</dop:component_ref>\n"
+        "      <dop:empty/></dop:node>\n"
+        "  </dop:nodes>\n"
+        "</dop:dop_manifest>\n");
+    dop_build_topology_t topology;
+    memset(&topology, 0, sizeof(topology));
+    assert(dop_manifest_load_topology_from_xml(xml_path, &topology, resolve_component, NULL) ==
+           DOP_SUCCESS);
+    assert(strcmp(topology.build_id, "ABc") == 0 && topology.is_p2p_enabled);
+    assert(topology.node_count == 2);
+    assert(strcmp(topology.nodes[0]->node_id, "one") == 0 && !topology.nodes[0]->is_fault_tolerant);
+    assert(topology.nodes[0]->component == components[1] && topology.nodes[1]->component == components[2]);
+    assert(topology.nodes[0]->peer_count == 1 && topology.nodes[0]->peers[0] == topology.nodes[1]);
+    assert(topology.nodes[1]->is_fault_tolerant && topology.nodes[1]->peer_count == 0);
+
+    // Failures leave only the nodes that were there before
+    static const struct { const char* xml; int result; } broken[] = {
+        { "<a><build_id>x</build_id><node><node_id>n</node_id><component_ref>comp.1</component_ref>"
+          "</node>", DOP_ERROR_XML_PARSING },
+        { "<a><build_id>x</build_id></a></a>", DOP_ERROR_XML_PARSING },
+        { "<a><node><node_id>n</node_id><component_ref>comp.1</component_ref></node></a>",
+          DOP_ERROR_XML_PARSING },
+        { "<a><build_id>x</build_id><node><component_ref>comp.1</component_ref></node></a>",
+          DOP_ERROR_XML_PARSING },
+        { "<a><build_id>x</build_id><node><node_id>"
+          "0123456789012345678901234567890123456789012345678901234567890123"
+          "</node_id><component_ref>comp.1</component_ref></node></a>", DOP_ERROR_XML_PARSING },
+        { "<a><build_id>x</build_id><node><node_id>n</node_id><component_ref>none</component_ref>"
+          "</node></a>", DOP_ERROR_TOPOLOGY_FAULT },
+        { "<a><build_id>x</build_id><node><node_id>n</node_id><component_ref>comp.1</component_ref>"
+          "<peer>missing</peer></node></a>", DOP_ERROR_TOPOLOGY_FAULT },
+        { "<a><build_id>x</build_id><node><node_id>n</node_id><component_ref>comp.1</component_ref>"
+          "</node><!-- unterminated", DOP_ERROR_XML_PARSING },
+    };
+    for (size_t i = 0; i < sizeof(broken) / sizeof(broken[0]); i++) {
+        write_text(xml_path, broken[i].xml);
+        assert(dop_manifest_load_topology_from_xml(xml_path, &topology, resolve_component, NULL) ==
+               broken[i].result);
+        assert(topology.node_count == 2);
+    }
+    write_text(xml_path, "<a><build_id>x</build_id><node><node_id>n</node_id></node></a>");
+    assert(dop_manifest_load_topology_from_xml(xml_path, &topology, resolve_nothing, NULL) ==
+           DOP_ERROR_TOPOLOGY_FAULT);
+    assert(topology.node_count == 2);
+    unlink(xml_path);
+    assert(dop_manifest_load_from_xml(xml_path, &topology) == DOP_ERROR_XML_PARSING);
+
+    destroy_nodes(&topology);
+    printf("Manifest reader test passed\n");
+}
+
+// Overwrite bytes of a file in place
+static void patch_file(const char* path, long offset, const void* bytes, size_t length) {
+    FILE* file = fopen(path, "r+b");
+    assert(file != NULL);
+    fseek(file, offset, SEEK_SET);
+    assert(fwrite(bytes, 1, length, file) == length);
+    fclose(file);
+}
+
+// dop_manifest_load_cached with its output captured, to see whether the
+// schema check ran
+static int load_cached(dop_build_topology_t* topology, bool* validated) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int fd = open(log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(saved >= 0 && fd >= 0);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+    int result = dop_manifest_load_cached(xml_path, topology, resolve_component, NULL);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    char* output = read_text(log_path);
+    *validated = strstr(output, "schema validation") != NULL;
+    free(output);
+    return result;
+}
+
+static void test_binary_manifest(void) {
+    printf("Testing binary manifest...\n");
+
+    // Saving the XML writes the binary next to it, recording the XML's hash
+    dop_build_topology_t saved;
+    build_topology(&saved);
+    assert(dop_manifest_save_to_xml(&saved, xml_path) == DOP_SUCCESS);
+    assert(access(bin_path, R_OK) == 0);
+    uint64_t hash;
+    assert(dop_manifest_hash_file(xml_path, &hash) == DOP_SUCCESS);
+    char* text = read_text(xml_path);
+    assert(hash == dop_manifest_hash_bytes(text, strlen(text)));
+    free(text);
+
+    dop_build_topology_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    assert(dop_manifest_load_binary(bin_path, hash, &loaded, resolve_component, NULL) == DOP_SUCCESS);
+    assert_same_topology(&loaded, 0, &saved);
+    destroy_nodes(&loaded);
+
+    // A stale or damaged binary is refused with nothing loaded
+    memset(&loaded, 0, sizeof(loaded));
+    assert(dop_manifest_load_binary(bin_path, hash + 1, &loaded, resolve_component, NULL) ==
+           DOP_ERROR_CHECKSUM_FAILED);
+    uint32_t huge = UINT32_MAX;
+    patch_file(bin_path, 28, &huge, sizeof(huge));  // Header node_count
+    assert(dop_manifest_load_binary(bin_path, hash, &loaded, resolve_component, NULL) ==
+           DOP_ERROR_XML_PARSING);
+    patch_file(bin_path, 0, "XXXX", 4);
+    assert(dop_manifest_load_binary(bin_path, hash, &loaded, resolve_component, NULL) ==
+           DOP_ERROR_XML_PARSING);
+    assert(truncate(bin_path, 8) == 0);
+    assert(dop_manifest_load_binary(bin_path, hash, &loaded, resolve_component, NULL) ==
+           DOP_ERROR_XML_PARSING);
+    assert(loaded.node_count == 0);
+
+    // The cached load parses and validates the XML only when the binary
+    // does not match it, and then regenerates the binary
+    bool validated;
+    unlink(bin_path);
+    assert(load_cached(&loaded, &validated) == DOP_SUCCESS && validated);
+    assert_same_topology(&loaded, 0, &saved);
+    destroy_nodes(&loaded);
+    memset(&loaded, 0, sizeof(loaded));
+    assert(load_cached(&loaded, &validated) == DOP_SUCCESS && !validated);
+    assert_same_topology(&loaded, 0, &saved);
+    destroy_nodes(&loaded);
+
+    FILE* file = fopen(xml_path, "a");
+    assert(file != NULL);
+    fputs("<!-- edited -->\n", file);
+    fclose(file);
+    memset(&loaded, 0, sizeof(loaded));
+    assert(load_cached(&loaded, &validated) == DOP_SUCCESS && validated);
+    destroy_nodes(&loaded);
+    memset(&loaded, 0, sizeof(loaded));
+    assert(load_cached(&loaded, &validated) == DOP_SUCCESS && !validated);
+    assert_same_topology(&loaded, 0, &saved);
+
+    // Loaded on top of other nodes, the binary is not regenerated
+    unlink(bin_path);
+    assert(load_cached(&loaded, &validated) == DOP_SUCCESS && validated);
+    assert(loaded.node_count == 2 * MANIFEST_NODES && access(bin_path, F_OK) != 0);
+
+    destroy_nodes(&loaded);
+    destroy_nodes(&saved);
+    unlink(xml_path);
+    unlink(log_path);
+    printf("Binary manifest test passed\n");
+}
+
+int main(void) {
+    strcpy(directory, "/tmp/dop_manifest_XXXXXX");
+    assert(mkdtemp(directory) != NULL);
+    snprintf(xml_path, sizeof(xml_path), "%s/dop_manifest.xml", directory);
+    snprintf(bin_path, sizeof(bin_path), "%s%s", xml_path, DOP_MANIFEST_BINARY_SUFFIX);
+    snprintf(log_path, sizeof(log_path), "%s/output.log", directory);
+    for (uint32_t i = 0; i < MANIFEST_NODES; i++) {
+        components[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(components[i] != NULL);
+        snprintf(components[i]->metadata.component_id, sizeof(components[i]->metadata.component_id),
+                 "comp.%04u", i);
+    }
+
+    test_round_trip();
+    test_reader();
+    test_binary_manifest();
+
+    for (uint32_t i = 0; i < MANIFEST_NODES; i++) dop_func_destroy_component(components[i]);
+    rmdir(directory);
+    printf("All manifest tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,169 @@
+// tests/test_membership.c
+// Checks for SWIM membership over a topology: failure detection, gossip
+// cost, refutation and partitions
+
+#include "dop_membership.h"
+#include "dop_topology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define MEMBERSHIP_NODES 256
+#define MEMBERSHIP_MAX_PERIODS 200
+
+static dop_build_topology_t topology;
+static dop_component_t* components[MEMBERSHIP_NODES];
+
+static void create_topology(void) {
+    memset(&topology, 0, sizeof(topology));
+    for (uint32_t i = 0; i < MEMBERSHIP_NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "member.%03u", i);
+        components[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(components[i] != NULL);
+        dop_gate_open(components[i]);
+        assert(dop_topology_add_node(&topology, dop_topology_create_node(id, components[i])) ==
+               DOP_SUCCESS);
+    }
+}
+
+static void destroy_topology(void) {
+    for (uint32_t i = 0; i < MEMBERSHIP_NODES; i++) {
+        dop_topology_destroy_node(topology.nodes[i]);
+        dop_func_destroy_component(components[i]);
+    }
+    dop_topology_release(&topology);
+}
+
+// Observers in group see exactly the members in group as not dead
+static bool views_settled(dop_membership_t* membership, const bool* group, uint32_t size) {
+    for (uint32_t observer = 0; observer < MEMBERSHIP_NODES; observer++) {
+        if (!group[observer]) continue;
+        if (dop_membership_alive_count(membership, observer) != size) return false;
+        for (uint32_t member = 0; member < MEMBERSHIP_NODES; member++) {
+            if (group[member] && dop_membership_state(membership, observer, member) != DOP_MEMBER_ALIVE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Periods until views_settled, or fail
+static uint32_t run_until_settled(dop_membership_t* membership, const bool* group, uint32_t size) {
+    for (uint32_t periods = 1; periods <= MEMBERSHIP_MAX_PERIODS; periods++) {
+        dop_membership_period(membership);
+        if (views_settled(membership, group, size)) return periods;
+    }
+    assert(!"membership never settled");
+    return 0;
+}
+
+static void test_failure_detection(void) {
+    printf("Testing failure detection...\n");
+
+    dop_build_topology_t empty;
+    memset(&empty, 0, sizeof(empty));
+    assert(dop_membership_create(&empty, NULL) == NULL);
+
+    dop_membership_t* membership = dop_membership_create(&topology, NULL);
+    assert(membership != NULL);
+    assert(dop_membership_state(membership, MEMBERSHIP_NODES, 0) == DOP_MEMBER_DEAD);
+    assert(dop_membership_alive_count(membership, MEMBERSHIP_NODES) == 0);
+
+    // Healthy, nobody is suspected, and each live node probes once a period
+    bool group[MEMBERSHIP_NODES];
+    for (uint32_t i = 0; i < MEMBERSHIP_NODES; i++) group[i] = true;
+    for (int period = 0; period < 20; period++) dop_membership_period(membership);
+    assert(views_settled(membership, group, MEMBERSHIP_NODES));
+    dop_membership_stats_t stats;
+    dop_membership_get_stats(membership, &stats);
+    assert(stats.periods == 20 && stats.probes == 20 * MEMBERSHIP_NODES && stats.suspicions == 0);
+
+    // A node that goes down is declared dead by everyone else, in bounded
+    // time, and nobody else is
+    assert(dop_gate_isolate(components[7]) == DOP_SUCCESS);
+    group[7] = false;
+    uint32_t periods = run_until_settled(membership, group, MEMBERSHIP_NODES - 1);
+    dop_membership_get_stats(membership, &stats);
+    assert(stats.suspicions >= 1 && stats.deaths >= 1);
+    assert(stats.indirect_probes >= stats.suspicions);
+
+    // Gossip costs at most a few messages per live node per period
+    dop_membership_config_t defaults = DOP_MEMBERSHIP_DEFAULT_CONFIG;
+    uint64_t per_period = (uint64_t)MEMBERSHIP_NODES * 2 * (1 + 2 * defaults.indirect_probes) *
+                          defaults.max_piggyback;
+    assert(stats.gossip_sent <= stats.periods * per_period);
+
+    dop_membership_destroy(membership);
+    dop_gate_open(components[7]);
+    printf("Failure detection test passed (%u periods)\n", periods);
+}
+
+static void test_refutation(void) {
+    printf("Testing refutation...\n");
+
+    // Suspicion lasts long enough for a refutation to get round
+    dop_membership_config_t config = DOP_MEMBERSHIP_DEFAULT_CONFIG;
+    config.suspect_periods = 20;
+    dop_membership_t* membership = dop_membership_create(&topology, &config);
+    assert(membership != NULL);
+
+    // Cut off until someone suspects it, then back before it is declared dead
+    dop_membership_set_partition(membership, 9, 1);
+    dop_membership_stats_t stats;
+    do {
+        dop_membership_period(membership);
+        dop_membership_get_stats(membership, &stats);
+    } while (stats.suspicions == 0);
+    dop_membership_set_partition(membership, 9, 0);
+
+    bool group[MEMBERSHIP_NODES];
+    for (uint32_t i = 0; i < MEMBERSHIP_NODES; i++) group[i] = true;
+    run_until_settled(membership, group, MEMBERSHIP_NODES);
+    dop_membership_get_stats(membership, &stats);
+    assert(stats.refutations >= 1 && stats.deaths == 0);
+
+    dop_membership_destroy(membership);
+    printf("Refutation test passed\n");
+}
+
+static void test_partition(void) {
+    printf("Testing partitions...\n");
+
+    dop_membership_t* membership = dop_membership_create(&topology, NULL);
+    assert(membership != NULL);
+
+    // Split in half, each side declares the other dead
+    bool low[MEMBERSHIP_NODES], high[MEMBERSHIP_NODES];
+    for (uint32_t i = 0; i < MEMBERSHIP_NODES; i++) {
+        low[i] = i < MEMBERSHIP_NODES / 2;
+        high[i] = !low[i];
+        if (high[i]) dop_membership_set_partition(membership, i, 1);
+    }
+    for (uint32_t periods = 0; periods < MEMBERSHIP_MAX_PERIODS; periods++) {
+        dop_membership_period(membership);
+        if (views_settled(membership, low, MEMBERSHIP_NODES / 2) &&
+            views_settled(membership, high, MEMBERSHIP_NODES / 2)) {
+            break;
+        }
+    }
+    assert(views_settled(membership, low, MEMBERSHIP_NODES / 2));
+    assert(views_settled(membership, high, MEMBERSHIP_NODES / 2));
+    assert(dop_membership_state(membership, 0, MEMBERSHIP_NODES - 1) == DOP_MEMBER_DEAD);
+    assert(dop_membership_state(membership, MEMBERSHIP_NODES - 1, 0) == DOP_MEMBER_DEAD);
+
+    dop_membership_destroy(membership);
+    printf("Partition test passed\n");
+}
+
+int main(void) {
+    create_topology();
+    test_failure_detection();
+    test_refutation();
+    test_partition();
+    destroy_topology();
+    printf("All membership tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,953 @@
+// tests/test_nexus_link.c
+// Checks for the Nexus-Link component index, resolution cache, dependency
+// plans, the epoch-protected reads behind lock-free hot swaps, the
+// circuit breaker, the health scheduler and the evolution ring. Links
+// only the Nexus-Link sources, as the microbenchmarks do.
+
+#define _POSIX_C_SOURCE 200809L  // nanosleep, mkdtemp
+
+#include "nexus_link_semserver_x.h"
+#include <sched.h>
+#include <time.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define INDEX_GROUPS 16
+#define INDEX_PER_GROUP 256
+#define INDEX_SHORT (INDEX_GROUPS * INDEX_PER_GROUP)
+#define INDEX_LONG 64
+#define INDEX_SINGLE 94                    // One-character identifiers, '!' to '~'
+#define INDEX_COMPONENTS (INDEX_SHORT + INDEX_LONG + INDEX_SINGLE)
+#define INDEX_READERS 4
+#define CACHE_COMPONENTS 64
+#define CACHE_SWAPS 2000
+#define PLAN_LAYERS 6
+#define PLAN_PER_LAYER 40
+#define PLAN_FANOUT 3
+#define EPOCH_READERS 4
+#define EPOCH_SWAPS 5000
+#define CIRCUIT_THREADS 8
+#define HEALTH_COMPONENTS 64
+#define HEALTH_WORKERS 4
+#define HEALTH_JITTER_CHECKS 21
+#define EVOLUTION_SERIAL 200
+#define EVOLUTION_WRITERS 4
+#define EVOLUTION_PER_WRITER 1000
+#define EVOLUTION_TOTAL (EVOLUTION_WRITERS * EVOLUTION_PER_WRITER)
+
+static component_manifest_t* index_manifests;
+static _Atomic bool index_registered[INDEX_COMPONENTS];
+static _Atomic bool index_done;
+
+static void name_component(component_manifest_t* manifest, uint32_t i) {
+    if (i < INDEX_SHORT) {
+        snprintf(manifest->component_id, sizeof(manifest->component_id), "svc.%02u.%03u",
+                 i / INDEX_PER_GROUP, i % INDEX_PER_GROUP);
+    } else if (i < INDEX_SHORT + INDEX_LONG) {
+        // Past the prefix bytes a node keeps inline
+        snprintf(manifest->component_id, sizeof(manifest->component_id),
+                 "org.obinexus.governance.clock.alarm.%02u", i - INDEX_SHORT);
+    } else {
+        snprintf(manifest->component_id, sizeof(manifest->component_id), "%c",
+                 (char)('!' + (i - INDEX_SHORT - INDEX_LONG)));
+    }
+    snprintf(manifest->taxonomy_class, sizeof(manifest->taxonomy_class), "%s",
+             i % 2 ? "odd" : "even");
+    manifest->version.major = 1;
+    manifest->version.minor = i % 7;
+}
+
+// Lookups run against registrations; whatever is registered resolves to itself
+static void* resolve_registered(void* arg) {
+    nexus_resolution_context_t* ctx = arg;
+    uint32_t seed = 12345;
+    while (!atomic_load(&index_done)) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t i = (seed >> 8) % INDEX_COMPONENTS;
+        if (!atomic_load(&index_registered[i])) continue;
+        component_manifest_t* manifest = nexus_resolve_component(
+            ctx, index_manifests[i].component_id, NULL, RESOLUTION_LATEST_STABLE);
+        assert(manifest == &index_manifests[i]);
+    }
+    return NULL;
+}
+
+static void test_component_index(void) {
+    printf("Testing component index...\n");
+
+    nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+    assert(ctx != NULL);
+    index_manifests = calloc(INDEX_COMPONENTS + 1, sizeof(component_manifest_t));
+    assert(index_manifests != NULL);
+    for (uint32_t i = 0; i < INDEX_COMPONENTS; i++) name_component(&index_manifests[i], i);
+
+    pthread_t readers[INDEX_READERS];
+    for (int r = 0; r < INDEX_READERS; r++) {
+        assert(pthread_create(&readers[r], NULL, resolve_registered, ctx) == 0);
+    }
+
+    // Registered in a scattered order, so nodes grow and split under readers
+    for (uint32_t n = 0; n < INDEX_COMPONENTS; n++) {
+        uint32_t i = (n * 2654435761u) % INDEX_COMPONENTS;
+        if (atomic_load(&index_registered[i])) {
+            i = 0;
+            while (atomic_load(&index_registered[i])) i++;
+        }
+        assert(nexus_register_component(ctx, &index_manifests[i], SOURCE_LOCAL_CACHE) == 0);
+        atomic_store(&index_registered[i], true);
+    }
+    atomic_store(&index_done, true);
+    for (int r = 0; r < INDEX_READERS; r++) pthread_join(readers[r], NULL);
+    assert(ctx->component_trie.component_count == INDEX_COMPONENTS);
+
+    for (uint32_t i = 0; i < INDEX_COMPONENTS; i++) {
+        assert(nexus_resolve_component(ctx, index_manifests[i].component_id, NULL,
+                                       RESOLUTION_LATEST_STABLE) == &index_manifests[i]);
+    }
+
+    // Not registered: part of an identifier, one run past it, or beyond a split
+    assert(nexus_resolve_component(ctx, "svc.07", NULL, RESOLUTION_LATEST_STABLE) == NULL);
+    assert(nexus_resolve_component(ctx, "svc.07.0001", NULL, RESOLUTION_LATEST_STABLE) == NULL);
+    assert(nexus_resolve_component(ctx, "org.obinexus.governance.clock.alarX.00", NULL,
+                                   RESOLUTION_LATEST_STABLE) == NULL);
+
+    // Registering an identifier again replaces its manifest
+    component_manifest_t* replacement = &index_manifests[INDEX_COMPONENTS];
+    name_component(replacement, 42);
+    replacement->version.minor = 9;
+    assert(nexus_register_component(ctx, replacement, SOURCE_LOCAL_CACHE) == 0);
+    assert(ctx->component_trie.component_count == INDEX_COMPONENTS);
+    assert(nexus_resolve_component(ctx, replacement->component_id, NULL,
+                                   RESOLUTION_LATEST_STABLE) == replacement);
+
+    // Identifiers the index cannot hold
+    component_manifest_t invalid;
+    memset(&invalid, 0, sizeof(invalid));
+    assert(nexus_register_component(ctx, &invalid, SOURCE_LOCAL_CACHE) == -1);
+    memset(invalid.component_id, 'x', sizeof(invalid.component_id));
+    assert(nexus_register_component(ctx, &invalid, SOURCE_LOCAL_CACHE) == -1);
+
+    // Prefix scans come back whole and in identifier order
+    search_results_t* results = nexus_search_components(ctx, "svc.07.", NULL, INDEX_COMPONENTS);
+    assert(results != NULL && results->result_count == INDEX_PER_GROUP);
+    for (uint32_t i = 0; i < results->result_count; i++) {
+        assert(strncmp(results->results[i]->component_id, "svc.07.", 7) == 0);
+        assert(i == 0 || strcmp(results->results[i - 1]->component_id,
+                                results->results[i]->component_id) < 0);
+    }
+    nexus_free_search_results(results);
+
+    // A prefix that ends inside a compressed path, and a taxonomy filter
+    results = nexus_search_components(ctx, "org.obinexus.gov", NULL, INDEX_COMPONENTS);
+    assert(results != NULL && results->result_count == INDEX_LONG);
+    nexus_free_search_results(results);
+    results = nexus_search_components(ctx, "org.obinexus.gov", "odd", INDEX_COMPONENTS);
+    assert(results != NULL && results->result_count == INDEX_LONG / 2);
+    nexus_free_search_results(results);
+
+    // Everything, cut off at the limit
+    results = nexus_search_components(ctx, NULL, NULL, INDEX_COMPONENTS);
+    assert(results != NULL && results->result_count == INDEX_COMPONENTS);
+    nexus_free_search_results(results);
+    results = nexus_search_components(ctx, "svc.", NULL, 10);
+    assert(results != NULL && results->result_count == 10);
+    assert(strcmp(results->results[0]->component_id, "svc.00.000") == 0);
+    nexus_free_search_results(results);
+
+    nexus_link_destroy(ctx);
+    free(index_manifests);
+    printf("Component index test passed\n");
+}
+
+static nexus_cache_stats_t cache_stats(nexus_resolution_context_t* ctx) {
+    nexus_cache_stats_t stats;
+    nexus_get_resolution_cache_stats(ctx, &stats);
+    return stats;
+}
+
+static component_manifest_t* cache_swapped;
+static _Atomic uint32_t cache_current;
+
+// Once a swap is registered, no resolve started after it answers an older
+// manifest from the cache
+static void* resolve_swapped(void* arg) {
+    nexus_resolution_context_t* ctx = arg;
+    while (!atomic_load(&index_done)) {
+        uint32_t current = atomic_load(&cache_current);
+        component_manifest_t* got = nexus_resolve_component(ctx, "cache.swapped", NULL,
+                                                            RESOLUTION_LATEST_STABLE);
+        assert(got >= &cache_swapped[current] && got <= &cache_swapped[CACHE_SWAPS]);
+    }
+    return NULL;
+}
+
+static void test_resolution_cache(void) {
+    printf("Testing resolution cache...\n");
+
+    nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+    assert(ctx != NULL);
+    nexus_cache_stats_t stats = cache_stats(ctx);
+    assert(stats.entries == 0 && stats.hit_rate == 0.0);
+
+    component_manifest_t* manifests = calloc(CACHE_COMPONENTS, sizeof(component_manifest_t));
+    assert(manifests != NULL);
+    for (uint32_t i = 0; i < CACHE_COMPONENTS; i++) {
+        snprintf(manifests[i].component_id, sizeof(manifests[i].component_id), "cache.%02u", i);
+        manifests[i].version.major = 2;
+        manifests[i].version.minor = 3;
+        assert(nexus_register_component(ctx, &manifests[i], SOURCE_LOCAL_CACHE) == 0);
+    }
+
+    // The first resolve misses, the second is a hit
+    assert(nexus_resolve_component(ctx, "cache.00", NULL, RESOLUTION_LATEST_STABLE) == &manifests[0]);
+    assert(nexus_resolve_component(ctx, "cache.00", NULL, RESOLUTION_LATEST_STABLE) == &manifests[0]);
+    stats = cache_stats(ctx);
+    assert(stats.misses == 1 && stats.hits == 1 && stats.entries == 1 && stats.hit_rate == 0.5);
+
+    // Requested version and strategy are part of the key, failures included
+    semantic_version_x_t wanted = { .major = 2, .minor = 1 };
+    semantic_version_x_t too_new = { .major = 2, .minor = 4 };
+    assert(nexus_resolve_component(ctx, "cache.00", &wanted, RESOLUTION_COMPATIBLE) == &manifests[0]);
+    assert(nexus_resolve_component(ctx, "cache.00", &wanted, RESOLUTION_EXACT_MATCH) == NULL);
+    assert(nexus_resolve_component(ctx, "cache.00", &too_new, RESOLUTION_COMPATIBLE) == NULL);
+    assert(nexus_resolve_component(ctx, "cache.00", &too_new, RESOLUTION_COMPATIBLE) == NULL);
+    assert(nexus_resolve_component(ctx, "cache.missing", NULL, RESOLUTION_LATEST_STABLE) == NULL);
+    assert(nexus_resolve_component(ctx, "cache.missing", NULL, RESOLUTION_LATEST_STABLE) == NULL);
+    stats = cache_stats(ctx);
+    assert(stats.misses == 5 && stats.hits == 3 && stats.negative_hits == 2 && stats.entries == 5);
+    assert(ctx->metrics.total_resolutions == 8 && ctx->metrics.failed_resolutions == 5);
+
+    // Registering drops every entry of that component, misses included
+    component_manifest_t newer = manifests[0];
+    newer.version.minor = 4;
+    assert(nexus_register_component(ctx, &newer, SOURCE_LOCAL_CACHE) == 0);
+    stats = cache_stats(ctx);
+    assert(stats.invalidations == 4 && stats.entries == 1);
+    assert(nexus_resolve_component(ctx, "cache.00", &too_new, RESOLUTION_COMPATIBLE) == &newer);
+    component_manifest_t found = { .component_id = "cache.missing" };
+    assert(nexus_register_component(ctx, &found, SOURCE_LOCAL_CACHE) == 0);
+    assert(nexus_resolve_component(ctx, "cache.missing", NULL, RESOLUTION_LATEST_STABLE) == &found);
+
+    // Explicit invalidation, as a swap does
+    nexus_invalidate_resolutions(ctx, "cache.00");
+    stats = cache_stats(ctx);
+    assert(stats.invalidations == 6 && stats.entries == 1);
+
+    // Past capacity the least recently used entries make way
+    char id[32];
+    for (uint32_t i = 0; i < 2 * NEXUS_RESOLUTION_CACHE_CAPACITY; i++) {
+        snprintf(id, sizeof(id), "cache.absent.%u", i);
+        assert(nexus_resolve_component(ctx, id, NULL, RESOLUTION_LATEST_STABLE) == NULL);
+    }
+    stats = cache_stats(ctx);
+    assert(stats.entries <= NEXUS_RESOLUTION_CACHE_CAPACITY && stats.evictions > 0);
+    assert(stats.entries + stats.evictions == 2 * NEXUS_RESOLUTION_CACHE_CAPACITY + 1);
+
+    // Swaps under concurrent resolves never leave a stale answer behind
+    cache_swapped = calloc(CACHE_SWAPS + 1, sizeof(component_manifest_t));
+    assert(cache_swapped != NULL);
+    for (int i = 0; i <= CACHE_SWAPS; i++) {
+        snprintf(cache_swapped[i].component_id, sizeof(cache_swapped[i].component_id),
+                 "cache.swapped");
+        cache_swapped[i].version.minor = (uint32_t)i;
+    }
+    assert(nexus_register_component(ctx, &cache_swapped[0], SOURCE_LOCAL_CACHE) == 0);
+    atomic_store(&index_done, false);
+    pthread_t readers[INDEX_READERS];
+    for (int r = 0; r < INDEX_READERS; r++) {
+        assert(pthread_create(&readers[r], NULL, resolve_swapped, ctx) == 0);
+    }
+    for (uint32_t n = 1; n <= CACHE_SWAPS; n++) {
+        assert(nexus_register_component(ctx, &cache_swapped[n], SOURCE_LOCAL_CACHE) == 0);
+        atomic_store(&cache_current, n);
+    }
+    atomic_store(&index_done, true);
+    for (int r = 0; r < INDEX_READERS; r++) pthread_join(readers[r], NULL);
+    assert(nexus_resolve_component(ctx, "cache.swapped", NULL, RESOLUTION_LATEST_STABLE) ==
+           &cache_swapped[CACHE_SWAPS]);
+
+    nexus_link_destroy(ctx);
+    free(cache_swapped);
+    free(manifests);
+    printf("Resolution cache test passed\n");
+}
+
+static void add_dependency(component_manifest_t* manifest, const char* id, bool optional) {
+    uint32_t d = manifest->dependency_count++;
+    snprintf(manifest->dependencies[d].dependency_id, sizeof(manifest->dependencies[d].dependency_id),
+             "%s", id);
+    manifest->dependencies[d].is_optional = optional;
+    manifest->dependencies[d].strategy = RESOLUTION_COMPATIBLE;
+}
+
+static uint32_t plan_position(const nexus_activation_plan_t* plan, const char* id) {
+    for (uint32_t i = 0; i < plan->count; i++) {
+        if (strcmp(plan->order[i]->component_id, id) == 0) return i;
+    }
+    return UINT32_MAX;
+}
+
+static void test_dependency_plan(void) {
+    printf("Testing dependency plan...\n");
+
+    nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+    assert(ctx != NULL);
+
+    // Layers of components, each depending on a few of the layer below;
+    // most are shared by several dependents
+    component_manifest_t* layered = calloc(PLAN_LAYERS * PLAN_PER_LAYER, sizeof(component_manifest_t));
+    assert(layered != NULL);
+    for (uint32_t layer = 0; layer < PLAN_LAYERS; layer++) {
+        for (uint32_t i = 0; i < PLAN_PER_LAYER; i++) {
+            component_manifest_t* manifest = &layered[layer * PLAN_PER_LAYER + i];
+            snprintf(manifest->component_id, sizeof(manifest->component_id), "plan.%u.%02u", layer, i);
+            manifest->version.major = 1;
+            manifest->version.minor = 2;
+            if (layer == 0) continue;
+            for (uint32_t f = 0; f < PLAN_FANOUT; f++) {
+                char id[32];
+                snprintf(id, sizeof(id), "plan.%u.%02u", layer - 1, (i * 7 + f * 13) % PLAN_PER_LAYER);
+                if (f > 0 && strcmp(id, manifest->dependencies[0].dependency_id) == 0) continue;
+                add_dependency(manifest, id, false);
+                manifest->dependencies[manifest->dependency_count - 1].min_version.major = 1;
+            }
+            if (i == 0) add_dependency(manifest, "plan.optional.absent", true);
+        }
+    }
+    for (uint32_t i = 0; i < PLAN_LAYERS * PLAN_PER_LAYER; i++) {
+        assert(nexus_register_component(ctx, &layered[i], SOURCE_LOCAL_CACHE) == 0);
+    }
+
+    const char* roots[PLAN_PER_LAYER];
+    for (uint32_t i = 0; i < PLAN_PER_LAYER; i++) {
+        roots[i] = layered[(PLAN_LAYERS - 1) * PLAN_PER_LAYER + i].component_id;
+    }
+
+    // Serial and parallel resolution agree on a plan that respects every edge
+    nexus_activation_plan_t* serial = nexus_resolve_dependencies(ctx, roots, PLAN_PER_LAYER, 1);
+    assert(serial != NULL && serial->conflict_count == 0);
+    for (uint32_t i = 0; i < serial->count; i++) {
+        const component_manifest_t* manifest = serial->order[i];
+        assert(plan_position(serial, manifest->component_id) == i);
+        assert(i == 0 || serial->levels[i - 1] <= serial->levels[i]);
+        for (uint32_t d = 0; d < manifest->dependency_count; d++) {
+            uint32_t position = plan_position(serial, manifest->dependencies[d].dependency_id);
+            if (manifest->dependencies[d].is_optional) {
+                assert(position == UINT32_MAX);
+                continue;
+            }
+            assert(position < i && serial->levels[position] < serial->levels[i]);
+        }
+    }
+    assert(serial->level_count == PLAN_LAYERS && serial->levels[serial->count - 1] == PLAN_LAYERS - 1);
+
+    for (int round = 0; round < 8; round++) {
+        nexus_activation_plan_t* parallel = nexus_resolve_dependencies(ctx, roots, PLAN_PER_LAYER, 8);
+        assert(parallel != NULL && parallel->conflict_count == 0 && parallel->count == serial->count);
+        assert(memcmp(parallel->order, serial->order, serial->count * sizeof(*serial->order)) == 0);
+        assert(memcmp(parallel->levels, serial->levels, serial->count * sizeof(*serial->levels)) == 0);
+        nexus_free_activation_plan(parallel);
+    }
+
+    // A missing root
+    const char* absent[] = { "plan.absent" };
+    nexus_activation_plan_t* plan = nexus_resolve_dependencies(ctx, absent, 1, 4);
+    assert(plan != NULL && plan->conflict_count == 1 && plan->count == 0);
+    assert(plan->conflicts[0].kind == NEXUS_CONFLICT_MISSING);
+    assert(strcmp(plan->conflicts[0].component_id, "plan.absent") == 0);
+    assert(plan->conflicts[0].required_by[0] == '\0');
+    nexus_free_activation_plan(plan);
+
+    // A required dependency that is missing, and one outside its range
+    static component_manifest_t broken[2];
+    snprintf(broken[0].component_id, sizeof(broken[0].component_id), "plan.needs.missing");
+    add_dependency(&broken[0], "plan.0.00", false);
+    add_dependency(&broken[0], "plan.gone", false);
+    snprintf(broken[1].component_id, sizeof(broken[1].component_id), "plan.needs.newer");
+    add_dependency(&broken[1], "plan.0.01", false);
+    broken[1].dependencies[0].min_version.major = 1;
+    broken[1].dependencies[0].min_version.minor = 5;
+    for (int i = 0; i < 2; i++) {
+        assert(nexus_register_component(ctx, &broken[i], SOURCE_LOCAL_CACHE) == 0);
+    }
+    const char* missing_root[] = { "plan.needs.missing" };
+    plan = nexus_resolve_dependencies(ctx, missing_root, 1, 4);
+    assert(plan != NULL && plan->conflict_count == 1);
+    assert(plan->conflicts[0].kind == NEXUS_CONFLICT_MISSING);
+    assert(strcmp(plan->conflicts[0].component_id, "plan.gone") == 0);
+    assert(strcmp(plan->conflicts[0].required_by, "plan.needs.missing") == 0);
+    nexus_free_activation_plan(plan);
+    const char* newer_root[] = { "plan.needs.newer" };
+    plan = nexus_resolve_dependencies(ctx, newer_root, 1, 4);
+    assert(plan != NULL && plan->conflict_count == 1);
+    assert(plan->conflicts[0].kind == NEXUS_CONFLICT_VERSION);
+    assert(strcmp(plan->conflicts[0].component_id, "plan.0.01") == 0);
+    nexus_free_activation_plan(plan);
+
+    // A cycle through two components, reached from a third
+    static component_manifest_t cycle[3];
+    const char* cycle_ids[] = { "plan.cycle.a", "plan.cycle.b", "plan.cycle.top" };
+    for (int i = 0; i < 3; i++) {
+        snprintf(cycle[i].component_id, sizeof(cycle[i].component_id), "%s", cycle_ids[i]);
+    }
+    add_dependency(&cycle[0], "plan.cycle.b", false);
+    add_dependency(&cycle[1], "plan.cycle.a", false);
+    add_dependency(&cycle[2], "plan.cycle.a", false);
+    for (int i = 0; i < 3; i++) {
+        assert(nexus_register_component(ctx, &cycle[i], SOURCE_LOCAL_CACHE) == 0);
+    }
+    plan = nexus_resolve_dependencies(ctx, &cycle_ids[2], 1, 4);
+    assert(plan != NULL && plan->conflict_count == 1 && plan->count == 0);
+    assert(plan->conflicts[0].kind == NEXUS_CONFLICT_CYCLE);
+    assert(strncmp(plan->conflicts[0].component_id, "plan.cycle.", 11) == 0);
+    assert(strcmp(plan->conflicts[0].component_id, "plan.cycle.top") != 0);
+    nexus_free_activation_plan(plan);
+
+    nexus_free_activation_plan(serial);
+    nexus_link_destroy(ctx);
+    free(layered);
+    printf("Dependency plan test passed\n");
+}
+
+// Published versions hold their generation until retired, then -1
+static _Atomic(int64_t*) epoch_current;
+static _Atomic bool epoch_holding;
+static _Atomic bool epoch_release;
+static _Atomic bool epoch_synchronized;
+
+static void* read_published(void* arg) {
+    (void)arg;
+    int64_t last = 0;
+    while (!atomic_load(&index_done)) {
+        assert(nexus_read_begin());
+        int64_t* version = atomic_load_explicit(&epoch_current, memory_order_acquire);
+        int64_t seen = *version;
+        sched_yield();
+        assert(*version == seen && seen >= last);
+        last = seen;
+        nexus_read_end();
+    }
+    return NULL;
+}
+
+static void* hold_read(void* arg) {
+    (void)arg;
+    assert(nexus_read_begin());
+    atomic_store(&epoch_holding, true);
+    while (!atomic_load(&epoch_release)) sched_yield();
+    nexus_read_end();
+    return NULL;
+}
+
+static void* synchronize_once(void* arg) {
+    (void)arg;
+    nexus_synchronize();
+    atomic_store(&epoch_synchronized, true);
+    return NULL;
+}
+
+static void test_read_epochs(void) {
+    printf("Testing epoch-protected reads...\n");
+
+    // Reads nest; only the outermost end leaves the read
+    assert(nexus_read_begin());
+    assert(nexus_read_begin());
+    nexus_read_end();
+    nexus_read_end();
+    nexus_synchronize();
+
+    // A version is retired only after every read that could see it ends
+    int64_t* first = malloc(sizeof(int64_t));
+    assert(first != NULL);
+    *first = 0;
+    atomic_store(&epoch_current, first);
+    atomic_store(&index_done, false);
+    pthread_t readers[EPOCH_READERS];
+    for (int r = 0; r < EPOCH_READERS; r++) {
+        assert(pthread_create(&readers[r], NULL, read_published, NULL) == 0);
+    }
+    for (int64_t n = 1; n <= EPOCH_SWAPS; n++) {
+        int64_t* next = malloc(sizeof(int64_t));
+        assert(next != NULL);
+        *next = n;
+        int64_t* old = atomic_exchange_explicit(&epoch_current, next, memory_order_acq_rel);
+        nexus_synchronize();
+        *old = -1;
+        free(old);
+    }
+    atomic_store(&index_done, true);
+    for (int r = 0; r < EPOCH_READERS; r++) pthread_join(readers[r], NULL);
+    free(atomic_load(&epoch_current));
+
+    // Synchronize waits for a read that began before it
+    pthread_t holder, synchronizer;
+    assert(pthread_create(&holder, NULL, hold_read, NULL) == 0);
+    while (!atomic_load(&epoch_holding)) sched_yield();
+    assert(pthread_create(&synchronizer, NULL, synchronize_once, NULL) == 0);
+    struct timespec pause = { 0, 50 * 1000 * 1000 };
+    nanosleep(&pause, NULL);
+    assert(!atomic_load(&epoch_synchronized));
+    atomic_store(&epoch_release, true);
+    pthread_join(synchronizer, NULL);
+    pthread_join(holder, NULL);
+    assert(atomic_load(&epoch_synchronized));
+
+    printf("Epoch-protected read test passed\n");
+}
+
+static circuit_state_t circuit_state_of(circuit_breaker_t* breaker) {
+    return (circuit_state_t)(atomic_load(&breaker->state) & CIRCUIT_STATE_MASK);
+}
+
+static uint64_t circuit_open_until(circuit_breaker_t* breaker) {
+    return atomic_load(&breaker->state) >> CIRCUIT_UNTIL_SHIFT;
+}
+
+// An open circuit whose time is up
+static void circuit_expire(circuit_breaker_t* breaker) {
+    uint64_t past = (uint64_t)time(NULL) - 1;
+    atomic_store(&breaker->state, (uint64_t)CIRCUIT_OPEN | past << CIRCUIT_UNTIL_SHIFT);
+}
+
+static circuit_breaker_t circuit_shared;
+static _Atomic uint32_t circuit_openings;
+
+static void* fail_often(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 1000; i++) {
+        if (nexus_circuit_record_failure(&circuit_shared)) atomic_fetch_add(&circuit_openings, 1);
+    }
+    return NULL;
+}
+
+static void test_circuit_breaker(void) {
+    printf("Testing circuit breaker...\n");
+
+    static circuit_breaker_t breaker;
+    nexus_circuit_init(&breaker, "circuit.test");
+    assert(strcmp(breaker.component_id, "circuit.test") == 0);
+    assert(circuit_state_of(&breaker) == CIRCUIT_CLOSED && nexus_circuit_allow(&breaker));
+
+    // A success clears the run of failures
+    for (int i = 0; i < CIRCUIT_FAILURE_THRESHOLD - 1; i++) {
+        assert(!nexus_circuit_record_failure(&breaker));
+    }
+    nexus_circuit_record_success(&breaker);
+    for (int i = 0; i < CIRCUIT_FAILURE_THRESHOLD - 1; i++) {
+        assert(!nexus_circuit_record_failure(&breaker));
+    }
+    assert(circuit_state_of(&breaker) == CIRCUIT_CLOSED);
+
+    // The threshold opens it, for a while; later failures change nothing
+    uint64_t now = (uint64_t)time(NULL);
+    assert(nexus_circuit_record_failure(&breaker));
+    assert(circuit_state_of(&breaker) == CIRCUIT_OPEN && !nexus_circuit_allow(&breaker));
+    assert(circuit_open_until(&breaker) >= now + 30 && circuit_open_until(&breaker) <= now + 31);
+    assert(!nexus_circuit_record_failure(&breaker));
+    nexus_circuit_record_success(&breaker);
+    assert(circuit_state_of(&breaker) == CIRCUIT_OPEN);
+
+    // Once due, one call goes through as a test; enough successes close it
+    circuit_expire(&breaker);
+    assert(nexus_circuit_allow(&breaker) && circuit_state_of(&breaker) == CIRCUIT_HALF_OPEN);
+    for (int i = 0; i < CIRCUIT_RECOVERY_SUCCESSES - 1; i++) {
+        nexus_circuit_record_success(&breaker);
+        assert(circuit_state_of(&breaker) == CIRCUIT_HALF_OPEN);
+    }
+    nexus_circuit_record_success(&breaker);
+    assert(circuit_state_of(&breaker) == CIRCUIT_CLOSED);
+
+    // A failed test opens it again, for longer
+    nexus_circuit_init(&breaker, "circuit.test");
+    circuit_expire(&breaker);
+    assert(nexus_circuit_allow(&breaker));
+    now = (uint64_t)time(NULL);
+    assert(nexus_circuit_record_failure(&breaker));
+    assert(circuit_state_of(&breaker) == CIRCUIT_OPEN && circuit_open_until(&breaker) >= now + 60);
+
+    // Failures that never run long still open it once they are half the window
+    nexus_circuit_init(&breaker, "circuit.test");
+    int calls = 0;
+    bool opened = false;
+    while (!opened && calls < 200) {
+        nexus_circuit_record_success(&breaker);
+        opened = nexus_circuit_record_failure(&breaker);
+        calls += 2;
+    }
+    assert(opened && calls >= CIRCUIT_WINDOW_MIN_CALLS && calls <= CIRCUIT_WINDOW_MIN_CALLS + 2);
+
+    // A third failing is not enough
+    nexus_circuit_init(&breaker, "circuit.test");
+    for (int i = 0; i < 100; i++) {
+        nexus_circuit_record_success(&breaker);
+        nexus_circuit_record_success(&breaker);
+        assert(!nexus_circuit_record_failure(&breaker));
+    }
+    assert(circuit_state_of(&breaker) == CIRCUIT_CLOSED);
+
+    // Racing failures open it exactly once
+    nexus_circuit_init(&circuit_shared, "circuit.shared");
+    pthread_t threads[CIRCUIT_THREADS];
+    for (int t = 0; t < CIRCUIT_THREADS; t++) {
+        assert(pthread_create(&threads[t], NULL, fail_often, NULL) == 0);
+    }
+    for (int t = 0; t < CIRCUIT_THREADS; t++) pthread_join(threads[t], NULL);
+    assert(atomic_load(&circuit_openings) == 1 && circuit_state_of(&circuit_shared) == CIRCUIT_OPEN);
+
+    printf("Circuit breaker test passed\n");
+}
+
+// What a check does to one probed component
+typedef struct {
+    health_status_t result;
+    long sleep_ms;
+    _Atomic uint32_t checks;
+    uint64_t checked_ns[HEALTH_JITTER_CHECKS];
+} health_probe_t;
+
+static _Atomic uint32_t health_in_flight;
+static _Atomic uint32_t health_most_in_flight;
+static component_manifest_t health_manifest;
+static _Atomic uint32_t health_manifest_checks;
+
+static uint64_t health_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static health_status_t check_probe(void* component) {
+    // Resolved components are the registered manifest
+    if (component == &health_manifest) {
+        atomic_fetch_add(&health_manifest_checks, 1);
+        return HEALTH_DEGRADED;
+    }
+    health_probe_t* probe = component;
+    uint32_t in_flight = atomic_fetch_add(&health_in_flight, 1) + 1;
+    uint32_t most = atomic_load(&health_most_in_flight);
+    while (in_flight > most && !atomic_compare_exchange_weak(&health_most_in_flight, &most, in_flight)) {
+    }
+    uint32_t check = atomic_load(&probe->checks);
+    if (check < HEALTH_JITTER_CHECKS) probe->checked_ns[check] = health_now_ns();
+    if (probe->sleep_ms) {
+        struct timespec pause = {0, probe->sleep_ms * 1000000};
+        nanosleep(&pause, NULL);
+    }
+    atomic_fetch_sub(&health_in_flight, 1);
+    atomic_fetch_add(&probe->checks, 1);
+    return probe->result;
+}
+
+static void wait_for_status(nexus_health_scheduler_t* scheduler, int32_t slot) {
+    while (nexus_health_status(scheduler, slot) == HEALTH_UNKNOWN) {
+        struct timespec pause = {0, 1000000};
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void test_health_scheduler(void) {
+    printf("Testing health scheduler...\n");
+
+    nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+    assert(ctx != NULL);
+    snprintf(health_manifest.component_id, sizeof(health_manifest.component_id), "health.registered");
+    health_manifest.version.major = 1;
+    assert(nexus_register_component(ctx, &health_manifest, SOURCE_LOCAL_CACHE) == 0);
+
+    // One check on the calling thread gets the registered manifest; a
+    // component without one is unknown, and an overrun is unhealthy
+    health_check_config_t config = {0};
+    config.check_function = check_probe;
+    config.check_interval_ms = 60000;
+    assert(nexus_check_component_health(ctx, "health.registered", &config) == HEALTH_DEGRADED);
+    assert(config.last_status == HEALTH_DEGRADED && config.last_check_time > 0);
+    assert(atomic_load(&health_manifest_checks) == 1);
+    assert(nexus_check_component_health(ctx, "health.missing", &config) == HEALTH_UNKNOWN);
+    assert(config.last_status == HEALTH_UNKNOWN);
+    assert(nexus_check_component_health(NULL, "health.registered", &config) == HEALTH_UNKNOWN);
+
+    nexus_health_scheduler_config_t scheduler_config = {HEALTH_COMPONENTS + 8, HEALTH_WORKERS, 0};
+    nexus_health_scheduler_config_t bad = scheduler_config;
+    bad.jitter_percent = 101;
+    assert(nexus_health_scheduler_create(ctx, &bad) == NULL);
+    bad = scheduler_config;
+    bad.max_components = 0;
+    assert(nexus_health_scheduler_create(ctx, &bad) == NULL);
+    assert(nexus_health_scheduler_create(NULL, &scheduler_config) == NULL);
+    nexus_health_scheduler_t* scheduler = nexus_health_scheduler_create(ctx, &scheduler_config);
+    assert(scheduler != NULL);
+
+    // Many components share a bounded pool; a batch checks each once
+    static health_probe_t probes[HEALTH_COMPONENTS];
+    int32_t slots[HEALTH_COMPONENTS];
+    for (uint32_t i = 0; i < HEALTH_COMPONENTS; i++) {
+        probes[i].result = i % 2 ? HEALTH_DEGRADED : HEALTH_HEALTHY;
+        probes[i].sleep_ms = 2;
+        char id[32];
+        snprintf(id, sizeof(id), "health.%02u", i);
+        slots[i] = nexus_health_watch(scheduler, id, &probes[i], &config, NULL);
+        assert(slots[i] == (int32_t)i);
+        assert(nexus_health_status(scheduler, slots[i]) == HEALTH_UNKNOWN);
+    }
+    health_check_config_t no_check = config;
+    no_check.check_function = NULL;
+    assert(nexus_health_watch(scheduler, "health.bad", &probes[0], &no_check, NULL) == -1);
+    no_check = config;
+    no_check.check_interval_ms = 0;
+    assert(nexus_health_watch(scheduler, "health.bad", &probes[0], &no_check, NULL) == -1);
+    assert(nexus_health_status(scheduler, HEALTH_COMPONENTS) == HEALTH_UNKNOWN);
+    assert(nexus_health_breaker(scheduler, -1) == NULL);
+
+    assert(nexus_health_scheduler_start(scheduler) == 0);
+    assert(nexus_health_scheduler_start(scheduler) == 0);
+    nexus_health_check_all(scheduler);
+    for (uint32_t i = 0; i < HEALTH_COMPONENTS; i++) wait_for_status(scheduler, slots[i]);
+    assert(atomic_load(&health_most_in_flight) <= HEALTH_WORKERS);
+    for (uint32_t i = 0; i < HEALTH_COMPONENTS; i++) {
+        assert(atomic_load(&probes[i].checks) >= 1);
+        assert(nexus_health_status(scheduler, slots[i]) == probes[i].result);
+        assert(circuit_state_of(nexus_health_breaker(scheduler, slots[i])) == CIRCUIT_CLOSED);
+    }
+
+    // Failing checks open the component's breaker, once; overruns fail
+    static health_probe_t failing = {HEALTH_UNHEALTHY, 0, 0, {0}};
+    static health_probe_t slow = {HEALTH_HEALTHY, 20, 0, {0}};
+    health_check_config_t fast_config = config;
+    fast_config.check_interval_ms = 1;
+    int32_t failing_slot = nexus_health_watch(scheduler, "health.failing", &failing, &fast_config, NULL);
+    health_check_config_t timed_config = config;
+    timed_config.timeout_ms = 5;
+    static circuit_breaker_t slow_breaker;
+    nexus_circuit_init(&slow_breaker, "health.slow");
+    int32_t slow_slot = nexus_health_watch(scheduler, "health.slow", &slow, &timed_config, &slow_breaker);
+    assert(nexus_health_breaker(scheduler, slow_slot) == &slow_breaker);
+    int32_t resolved_slot = nexus_health_watch(scheduler, "health.registered", NULL, &config, NULL);
+    int32_t missing_slot = nexus_health_watch(scheduler, "health.missing", NULL, &fast_config, NULL);
+    assert(failing_slot >= 0 && slow_slot >= 0 && resolved_slot >= 0 && missing_slot >= 0);
+    nexus_health_check_all(scheduler);
+    while (atomic_load(&failing.checks) < 2 * CIRCUIT_FAILURE_THRESHOLD ||
+           atomic_load(&slow.checks) < 1 || atomic_load(&health_manifest_checks) < 2) {
+        struct timespec pause = {0, 1000000};
+        nanosleep(&pause, NULL);
+    }
+    nexus_health_scheduler_stop(scheduler);
+
+    nexus_health_stats_t stats;
+    nexus_health_get_stats(scheduler, &stats);
+    assert(stats.components == HEALTH_COMPONENTS + 4);
+    assert(stats.circuits_opened == 1 && stats.timeouts >= 1);
+    assert(stats.failures >= 2 * CIRCUIT_FAILURE_THRESHOLD + stats.timeouts);
+    assert(nexus_health_status(scheduler, failing_slot) == HEALTH_UNHEALTHY);
+    assert(circuit_state_of(nexus_health_breaker(scheduler, failing_slot)) == CIRCUIT_OPEN);
+    assert(nexus_health_status(scheduler, slow_slot) == HEALTH_UNHEALTHY);
+    assert(nexus_health_status(scheduler, resolved_slot) == HEALTH_DEGRADED);
+
+    // Unknown results leave the breaker alone
+    assert(nexus_health_status(scheduler, missing_slot) == HEALTH_UNKNOWN);
+    assert(circuit_state_of(nexus_health_breaker(scheduler, missing_slot)) == CIRCUIT_CLOSED);
+
+    // The scheduler fills up
+    for (int32_t slot = (int32_t)stats.components; slot < HEALTH_COMPONENTS + 8; slot++) {
+        assert(nexus_health_watch(scheduler, "health.filler", &probes[0], &config, NULL) == slot);
+    }
+    assert(nexus_health_watch(scheduler, "health.full", &probes[0], &config, NULL) == -1);
+    nexus_health_scheduler_destroy(scheduler);
+
+    // Intervals are spread either way around the configured one
+    scheduler_config.jitter_percent = 50;
+    scheduler = nexus_health_scheduler_create(ctx, &scheduler_config);
+    static health_probe_t jittered = {HEALTH_HEALTHY, 0, 0, {0}};
+    health_check_config_t jitter_config = config;
+    jitter_config.check_interval_ms = 20;
+    assert(nexus_health_watch(scheduler, "health.jittered", &jittered, &jitter_config, NULL) == 0);
+    assert(nexus_health_scheduler_start(scheduler) == 0);
+    while (atomic_load(&jittered.checks) < HEALTH_JITTER_CHECKS) {
+        struct timespec pause = {0, 1000000};
+        nanosleep(&pause, NULL);
+    }
+    nexus_health_scheduler_destroy(scheduler);
+    bool shorter = false;
+    for (int i = 1; i < HEALTH_JITTER_CHECKS; i++) {
+        uint64_t gap = jittered.checked_ns[i] - jittered.checked_ns[i - 1];
+        assert(gap >= 9000000);             // 10 ms at the least, less clock slack
+        if (gap < 19000000) shorter = true;
+    }
+    assert(shorter);
+
+    nexus_link_destroy(ctx);
+    printf("Health scheduler test passed\n");
+}
+
+static component_evolution_t* evolution_shared;
+static _Atomic int evolution_writing;
+
+static void* record_swaps(void* arg) {
+    uint64_t writer = (uint64_t)(uintptr_t)arg;
+    evolution_event_t event = {0};
+    event.from_version.major = event.to_version.major = 1;
+    for (uint32_t i = 0; i < EVOLUTION_PER_WRITER; i++) {
+        event.swap_timestamp = writer << 32 | i;
+        snprintf(event.reason, sizeof(event.reason), "writer %llu swap %u",
+                 (unsigned long long)writer, i);
+        assert(nexus_evolution_record(evolution_shared, &event) == 0);
+    }
+    atomic_fetch_sub(&evolution_writing, 1);
+    return NULL;
+}
+
+// Copies taken mid-append are whole events, each writer's in its own order
+static void* read_recent(void* arg) {
+    (void)arg;
+    static evolution_event_t events[NEXUS_EVOLUTION_RING_SIZE];
+    while (atomic_load(&evolution_writing) > 0) {
+        uint32_t count = nexus_evolution_recent(evolution_shared, events, NEXUS_EVOLUTION_RING_SIZE);
+        int64_t last[EVOLUTION_WRITERS];
+        for (int w = 0; w < EVOLUTION_WRITERS; w++) last[w] = -1;
+        for (uint32_t e = 0; e < count; e++) {
+            uint64_t writer = events[e].swap_timestamp >> 32;
+            int64_t i = (int64_t)(events[e].swap_timestamp & UINT32_MAX);
+            assert(writer < EVOLUTION_WRITERS && i > last[writer]);
+            last[writer] = i;
+            char reason[sizeof(events[e].reason)];
+            snprintf(reason, sizeof(reason), "writer %llu swap %lld",
+                     (unsigned long long)writer, (long long)i);
+            assert(strcmp(events[e].reason, reason) == 0);
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+// Positions in a spill log, counted; returns the number of lines
+static uint32_t read_spill_log(const char* directory, const char* component_id,
+                               uint32_t* seen, uint32_t positions) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.evolution", directory, component_id);
+    FILE* log = fopen(path, "r");
+    assert(log != NULL);
+    char line[512];
+    uint32_t lines = 0;
+    while (fgets(line, sizeof(line), log)) {
+        unsigned long long position;
+        assert(sscanf(line, "%llu", &position) == 1 && position < positions);
+        assert(strchr(line, '\n') != NULL);
+        seen[position]++;
+        lines++;
+    }
+    fclose(log);
+    unlink(path);
+    return lines;
+}
+
+static void test_evolution_ring(void) {
+    printf("Testing evolution ring...\n");
+
+    nexus_resolution_context_t* ctx = nexus_link_init(NULL, RESOLUTION_COMPATIBLE);
+    assert(ctx != NULL);
+    static component_manifest_t manifest;
+    snprintf(manifest.component_id, sizeof(manifest.component_id), "evolution.clock");
+    manifest.version.major = 2;
+    manifest.version.minor = 3;
+    assert(nexus_register_component(ctx, &manifest, SOURCE_LOCAL_CACHE) == 0);
+
+    // Tracking starts from the registered version and returns one record
+    // per component; before a log directory is set, history stays in memory
+    assert(nexus_track_evolution(NULL, "evolution.clock") == NULL);
+    component_evolution_t* clock = nexus_track_evolution(ctx, "evolution.clock");
+    assert(clock != NULL && clock->log_fd == -1);
+    assert(clock->original_version.major == 2 && clock->original_version.minor == 3);
+    assert(nexus_track_evolution(ctx, "evolution.clock") == clock);
+    assert(nexus_evolution_record(clock, NULL) == -1);
+
+    char directory[] = "/tmp/nexus_evolution_XXXXXX";
+    assert(mkdtemp(directory) != NULL);
+    char too_long[300];
+    memset(too_long, 'd', sizeof(too_long) - 1);
+    too_long[sizeof(too_long) - 1] = '\0';
+    assert(nexus_set_evolution_log_dir(ctx, too_long) == -1);
+    assert(nexus_set_evolution_log_dir(ctx, directory) == 0);
+    component_evolution_t* serial = nexus_track_evolution(ctx, "evolution.serial");
+    assert(serial != NULL && serial->log_fd >= 0);
+
+    // The ring keeps the latest events, oldest first; the rest went to the
+    // log in order
+    evolution_event_t event = {0};
+    event.from_version.major = event.to_version.major = 1;
+    for (uint32_t i = 0; i < EVOLUTION_SERIAL; i++) {
+        event.swap_timestamp = i;
+        event.was_automatic = i % 2;
+        assert(nexus_evolution_record(serial, &event) == 0);
+        assert(nexus_evolution_record(clock, &event) == 0);
+    }
+    evolution_event_t events[NEXUS_EVOLUTION_RING_SIZE];
+    assert(nexus_evolution_recent(serial, events, 10) == 10);
+    for (uint32_t e = 0; e < 10; e++) assert(events[e].swap_timestamp == EVOLUTION_SERIAL - 10 + e);
+    assert(nexus_evolution_recent(serial, events, 1000) == NEXUS_EVOLUTION_RING_SIZE);
+    assert(events[0].swap_timestamp == EVOLUTION_SERIAL - NEXUS_EVOLUTION_RING_SIZE);
+    assert(atomic_load(&serial->evolution_count) == EVOLUTION_SERIAL);
+    assert(atomic_load(&serial->spilled) == EVOLUTION_SERIAL - NEXUS_EVOLUTION_RING_SIZE);
+    assert(atomic_load(&clock->spilled) == 0);
+    assert(nexus_evolution_recent(clock, events, NEXUS_EVOLUTION_RING_SIZE) == NEXUS_EVOLUTION_RING_SIZE);
+
+    static uint32_t seen[EVOLUTION_TOTAL];
+    assert(read_spill_log(directory, "evolution.serial", seen, EVOLUTION_SERIAL) ==
+           EVOLUTION_SERIAL - NEXUS_EVOLUTION_RING_SIZE);
+    for (uint32_t i = 0; i < EVOLUTION_SERIAL; i++) {
+        assert(seen[i] == (i < EVOLUTION_SERIAL - NEXUS_EVOLUTION_RING_SIZE));
+    }
+
+    // Racing appends lose nothing: every overwritten event is in the log
+    // once and the ring holds the rest
+    evolution_shared = nexus_track_evolution(ctx, "evolution.shared");
+    assert(evolution_shared != NULL && evolution_shared->log_fd >= 0);
+    atomic_store(&evolution_writing, EVOLUTION_WRITERS);
+    pthread_t reader, writers[EVOLUTION_WRITERS];
+    assert(pthread_create(&reader, NULL, read_recent, NULL) == 0);
+    for (uintptr_t w = 0; w < EVOLUTION_WRITERS; w++) {
+        assert(pthread_create(&writers[w], NULL, record_swaps, (void*)w) == 0);
+    }
+    for (int w = 0; w < EVOLUTION_WRITERS; w++) pthread_join(writers[w], NULL);
+    pthread_join(reader, NULL);
+    assert(atomic_load(&evolution_shared->evolution_count) == EVOLUTION_TOTAL);
+    assert(atomic_load(&evolution_shared->spilled) == EVOLUTION_TOTAL - NEXUS_EVOLUTION_RING_SIZE);
+    memset(seen, 0, sizeof(seen));
+    assert(read_spill_log(directory, "evolution.shared", seen, EVOLUTION_TOTAL) ==
+           EVOLUTION_TOTAL - NEXUS_EVOLUTION_RING_SIZE);
+    for (uint32_t i = 0; i < EVOLUTION_TOTAL; i++) {
+        assert(seen[i] == (i < EVOLUTION_TOTAL - NEXUS_EVOLUTION_RING_SIZE));
+    }
+    assert(nexus_evolution_recent(evolution_shared, events, NEXUS_EVOLUTION_RING_SIZE) ==
+           NEXUS_EVOLUTION_RING_SIZE);
+
+    // The contract holds until a swap changes the major version or the
+    // hashes differ
+    assert(nexus_validate_evolved_contract(serial, NULL));
+    assert(nexus_validate_evolved_contract(serial, "abc"));
+    snprintf(serial->contract_hash, sizeof(serial->contract_hash), "abc");
+    assert(nexus_validate_evolved_contract(serial, "abc"));
+    assert(!nexus_validate_evolved_contract(serial, "abd"));
+    assert(!nexus_validate_evolved_contract(NULL, "abc"));
+    event.to_version.major = 2;
+    assert(nexus_evolution_record(serial, &event) == 0);
+    assert(atomic_load(&serial->major_changes) == 1);
+    assert(!nexus_validate_evolved_contract(serial, "abc"));
+
+    nexus_link_destroy(ctx);
+    assert(rmdir(directory) == 0);
+    printf("Evolution ring test passed\n");
+}
+
+int main(void) {
+    test_component_index();
+    test_resolution_cache();
+    test_dependency_plan();
+    test_read_epochs();
+    test_circuit_breaker();
+    test_health_scheduler();
+    test_evolution_ring();
+    printf("All nexus-link tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,337 @@
+// tests/test_serialize.c
+// Checks for the binary serializer: round trips for every component type,
+// header and hash checks, and whole topologies matched by component id
+
+#include "dop_serialize.h"
+#include "dop_topology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define SERIAL_NODES 500
+#define SERIAL_HASH_OFFSET 24
+#define SERIAL_STATE_OFFSET (DOP_SERIAL_HEADER_SIZE + 68)
+
+static dop_time_data_t make_time(uint64_t ms) {
+    dop_time_data_t time;
+    memset(&time, 0, sizeof(time));
+    time.timestamp_ms = ms;
+    time.hours = (uint32_t)(ms / 3600000 % 24);
+    time.minutes = (uint32_t)(ms / 60000 % 60);
+    time.seconds = (uint32_t)(ms / 1000 % 60);
+    time.milliseconds = (uint32_t)(ms % 1000);
+    time.is_valid = true;
+    return time;
+}
+
+static bool same_time(dop_time_data_t a, dop_time_data_t b) {
+    return a.timestamp_ms == b.timestamp_ms && a.hours == b.hours && a.minutes == b.minutes &&
+           a.seconds == b.seconds && a.milliseconds == b.milliseconds && a.is_valid == b.is_valid;
+}
+
+// Give a component state that differs in every serialized field from a new one
+static void fill_component(dop_component_t* component, uint64_t seed) {
+    pthread_mutex_lock(&component->metadata.mutex);
+    component->metadata.state = DOP_STATE_SUSPENDED;
+    component->metadata.gate_state = DOP_GATE_ISOLATED;
+    component->metadata.creation_timestamp = seed;
+    component->metadata.last_update_timestamp = seed + 1;
+    dop_component_data_t* data = &component->data;
+    switch (component->metadata.type) {
+        case DOP_COMPONENT_ALARM:
+            data->alarm.alarm_time = make_time(seed + 2);
+            data->alarm.current_time = make_time(seed + 3);
+            data->alarm.is_armed = true;
+            data->alarm.is_triggered = true;
+            data->alarm.snooze_duration_ms = (uint32_t)seed + 4;
+            break;
+        case DOP_COMPONENT_CLOCK:
+            data->clock.current_time = make_time(seed + 2);
+            data->clock.is_running = false;
+            data->clock.timezone_offset = (uint32_t)seed + 3;
+            data->clock.is_24_hour_format = true;
+            break;
+        case DOP_COMPONENT_STOPWATCH:
+            data->stopwatch.start_time = make_time(seed + 2);
+            data->stopwatch.current_time = make_time(seed + 3);
+            data->stopwatch.elapsed_time = make_time(seed + 4);
+            data->stopwatch.is_running = true;
+            data->stopwatch.is_paused = true;
+            data->stopwatch.lap_count = (uint32_t)seed + 5;
+            break;
+        case DOP_COMPONENT_TIMER:
+            data->timer.start_time = make_time(seed + 2);
+            data->timer.duration = make_time(seed + 3);
+            data->timer.remaining = make_time(seed + 4);
+            data->timer.is_running = false;
+            data->timer.is_expired = true;
+            data->timer.auto_restart = true;
+            break;
+        default:
+            break;
+    }
+    component->checksum = dop_checksum_calculate(component);
+    pthread_mutex_unlock(&component->metadata.mutex);
+}
+
+static void assert_same_state(const dop_component_t* a, const dop_component_t* b) {
+    assert(a->metadata.type == b->metadata.type);
+    assert(a->metadata.state == b->metadata.state && a->metadata.gate_state == b->metadata.gate_state);
+    assert(a->metadata.creation_timestamp == b->metadata.creation_timestamp);
+    assert(a->metadata.last_update_timestamp == b->metadata.last_update_timestamp);
+    const dop_component_data_t* x = &a->data;
+    const dop_component_data_t* y = &b->data;
+    switch (a->metadata.type) {
+        case DOP_COMPONENT_ALARM:
+            assert(same_time(x->alarm.alarm_time, y->alarm.alarm_time));
+            assert(same_time(x->alarm.current_time, y->alarm.current_time));
+            assert(x->alarm.is_armed == y->alarm.is_armed && x->alarm.is_triggered == y->alarm.is_triggered);
+            assert(x->alarm.snooze_duration_ms == y->alarm.snooze_duration_ms);
+            break;
+        case DOP_COMPONENT_CLOCK:
+            assert(same_time(x->clock.current_time, y->clock.current_time));
+            assert(x->clock.is_running == y->clock.is_running);
+            assert(x->clock.timezone_offset == y->clock.timezone_offset);
+            assert(x->clock.is_24_hour_format == y->clock.is_24_hour_format);
+            break;
+        case DOP_COMPONENT_STOPWATCH:
+            assert(same_time(x->stopwatch.start_time, y->stopwatch.start_time));
+            assert(same_time(x->stopwatch.current_time, y->stopwatch.current_time));
+            assert(same_time(x->stopwatch.elapsed_time, y->stopwatch.elapsed_time));
+            assert(x->stopwatch.is_running == y->stopwatch.is_running);
+            assert(x->stopwatch.is_paused == y->stopwatch.is_paused);
+            assert(x->stopwatch.lap_count == y->stopwatch.lap_count);
+            break;
+        case DOP_COMPONENT_TIMER:
+            assert(same_time(x->timer.start_time, y->timer.start_time));
+            assert(same_time(x->timer.duration, y->timer.duration));
+            assert(same_time(x->timer.remaining, y->timer.remaining));
+            assert(x->timer.is_running == y->timer.is_running && x->timer.is_expired == y->timer.is_expired);
+            assert(x->timer.auto_restart == y->timer.auto_restart);
+            break;
+        default:
+            break;
+    }
+}
+
+// Recompute the records hash after editing a record, as a writer would
+static void rehash(unsigned char* buffer, uint32_t count) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < (size_t)count * DOP_SERIAL_RECORD_SIZE; i++) {
+        hash = (hash ^ buffer[DOP_SERIAL_HEADER_SIZE + i]) * 1099511628211ULL;
+    }
+    memcpy(buffer + SERIAL_HASH_OFFSET, &hash, sizeof(hash));
+}
+
+static void test_component_round_trip(void) {
+    printf("Testing component round trip...\n");
+
+    assert(dop_serialize_size(0) == DOP_SERIAL_HEADER_SIZE);
+    assert(dop_serialize_size(3) == DOP_SERIAL_HEADER_SIZE + 3 * DOP_SERIAL_RECORD_SIZE);
+
+    // Every type, through a buffer that is not aligned
+    unsigned char storage[1 + DOP_SERIAL_HEADER_SIZE + DOP_SERIAL_RECORD_SIZE];
+    unsigned char* buffer = storage + 1;
+    size_t written = 0;
+    for (int type = 0; type < DOP_COMPONENT_COUNT; type++) {
+        dop_component_t* source = dop_func_create_component((dop_component_type_t)type);
+        dop_component_t* target = dop_func_create_component((dop_component_type_t)type);
+        assert(source != NULL && target != NULL);
+        fill_component(source, 1000000 * (uint64_t)(type + 1));
+        assert(dop_serialize_component(source, buffer, dop_serialize_size(1), &written) == DOP_SUCCESS);
+        assert(written == dop_serialize_size(1));
+
+        char target_id[64];
+        strcpy(target_id, target->metadata.component_id);
+        assert(dop_deserialize_component(buffer, written, target) == DOP_SUCCESS);
+        assert_same_state(source, target);
+        assert(strcmp(target->metadata.component_id, target_id) == 0);   // Keeps its own id
+        assert(dop_checksum_verify(target));
+
+        // A record only applies to a component of its type
+        dop_component_t* other = dop_func_create_component((dop_component_type_t)((type + 1) % DOP_COMPONENT_COUNT));
+        uint32_t checksum = other->checksum;
+        assert(dop_deserialize_component(buffer, written, other) == DOP_ERROR_INVALID_STATE);
+        assert(other->checksum == checksum && other->metadata.state == DOP_STATE_READY);
+
+        dop_func_destroy_component(other);
+        dop_func_destroy_component(source);
+        dop_func_destroy_component(target);
+    }
+
+    // A buffer that is too small is left alone and told the size needed
+    dop_component_t* clock = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    memset(storage, 0xAA, sizeof(storage));
+    assert(dop_serialize_component(clock, buffer, dop_serialize_size(1) - 1, &written) ==
+           DOP_ERROR_MEMORY_ALLOCATION);
+    assert(written == dop_serialize_size(1));
+    for (size_t i = 0; i < sizeof(storage); i++) assert(storage[i] == 0xAA);
+    assert(dop_serialize_component(clock, buffer, sizeof(storage) - 1, NULL) == DOP_SUCCESS);
+    assert(dop_serialize_component(NULL, buffer, sizeof(storage) - 1, NULL) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_serialize_component(clock, NULL, sizeof(storage) - 1, NULL) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_deserialize_component(buffer, dop_serialize_size(1), NULL) == DOP_ERROR_INVALID_PARAMETER);
+
+    dop_func_destroy_component(clock);
+    printf("Component round trip test passed\n");
+}
+
+static void test_rejected_buffers(void) {
+    printf("Testing rejected buffers...\n");
+
+    dop_component_t* clocks[2];
+    for (int i = 0; i < 2; i++) {
+        clocks[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        fill_component(clocks[i], 5000 + (uint64_t)i);
+    }
+    dop_component_t* target = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    uint32_t checksum = target->checksum;
+    unsigned char good[DOP_SERIAL_HEADER_SIZE + 2 * DOP_SERIAL_RECORD_SIZE];
+    unsigned char bad[sizeof(good)];
+    size_t one = dop_serialize_size(1);
+    assert(dop_serialize_component(clocks[0], good, one, NULL) == DOP_SUCCESS);
+
+    // Each header field, a changed record, and truncation
+    const size_t header_fields[] = {0, 4, 8, 16};
+    for (size_t f = 0; f < sizeof(header_fields) / sizeof(header_fields[0]); f++) {
+        memcpy(bad, good, one);
+        bad[header_fields[f]] ^= 0x40;
+        assert(dop_deserialize_component(bad, one, target) == DOP_ERROR_INVALID_PARAMETER);
+    }
+    memcpy(bad, good, one);
+    bad[DOP_SERIAL_HEADER_SIZE + 90] ^= 0x01;
+    assert(dop_deserialize_component(bad, one, target) == DOP_ERROR_CHECKSUM_FAILED);
+    assert(dop_deserialize_component(good, one - 1, target) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_deserialize_component(good, DOP_SERIAL_HEADER_SIZE - 1, target) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_deserialize_component(NULL, one, target) == DOP_ERROR_INVALID_PARAMETER);
+
+    // A record with a valid hash but an impossible state
+    memcpy(bad, good, one);
+    uint32_t state = DOP_STATE_DESTROYED + 1;
+    memcpy(bad + SERIAL_STATE_OFFSET, &state, sizeof(state));
+    rehash(bad, 1);
+    assert(dop_deserialize_component(bad, one, target) == DOP_ERROR_INVALID_PARAMETER);
+    state = DOP_STATE_ERROR;
+    memcpy(bad + SERIAL_STATE_OFFSET, &state, sizeof(state));
+    rehash(bad, 1);
+    assert(dop_deserialize_component(bad, one, target) == DOP_SUCCESS);
+    assert(target->metadata.state == DOP_STATE_ERROR);
+    assert(checksum != target->checksum && dop_checksum_verify(target));
+
+    // Arrays: a missing component is refused; one component needs one record
+    const dop_component_t* array[2] = {clocks[0], clocks[1]};
+    size_t written = 0;
+    assert(dop_serialize_components(array, 2, good, sizeof(good), &written) == DOP_SUCCESS);
+    assert(written == sizeof(good));
+    assert(dop_deserialize_component(good, sizeof(good), target) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_serialize_components(array, 0, good, sizeof(good), &written) == DOP_SUCCESS);
+    assert(written == DOP_SERIAL_HEADER_SIZE);
+    array[1] = NULL;
+    assert(dop_serialize_components(array, 2, good, sizeof(good), NULL) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_serialize_components(NULL, 2, good, sizeof(good), NULL) == DOP_ERROR_INVALID_PARAMETER);
+
+    for (int i = 0; i < 2; i++) dop_func_destroy_component(clocks[i]);
+    dop_func_destroy_component(target);
+    printf("Rejected buffer test passed\n");
+}
+
+static void build_topology(dop_build_topology_t* topology, dop_component_t** components, bool reversed) {
+    memset(topology, 0, sizeof(*topology));
+    for (uint32_t n = 0; n < SERIAL_NODES; n++) {
+        uint32_t i = reversed ? SERIAL_NODES - 1 - n : n;
+        char id[32];
+        snprintf(id, sizeof(id), "node.%03u", i);
+        dop_topology_node_t* node = dop_topology_create_node(id, components[i]);
+        assert(node != NULL && dop_topology_add_node(topology, node) == DOP_SUCCESS);
+    }
+}
+
+static void destroy_topology(dop_build_topology_t* topology) {
+    for (uint32_t i = 0; i < topology->node_count; i++) dop_topology_destroy_node(topology->nodes[i]);
+    dop_topology_release(topology);
+}
+
+static void test_topology(void) {
+    printf("Testing topology serialization...\n");
+
+    // Sources and targets share ids; node i holds component i
+    static dop_component_t* sources[SERIAL_NODES];
+    static dop_component_t* targets[SERIAL_NODES];
+    for (uint32_t i = 0; i < SERIAL_NODES; i++) {
+        dop_component_type_t type = (dop_component_type_t)(i % DOP_COMPONENT_COUNT);
+        sources[i] = dop_func_create_component(type);
+        targets[i] = dop_func_create_component(type);
+        snprintf(sources[i]->metadata.component_id, sizeof(sources[i]->metadata.component_id), "serial.%03u", i);
+        snprintf(targets[i]->metadata.component_id, sizeof(targets[i]->metadata.component_id), "serial.%03u", i);
+        fill_component(sources[i], 10000 * (uint64_t)i);
+        targets[i]->checksum = dop_checksum_calculate(targets[i]);
+    }
+
+    // Nodes without a component are skipped
+    dop_build_topology_t source;
+    build_topology(&source, sources, false);
+    source.nodes[7]->component = NULL;
+    source.nodes[300]->component = NULL;
+    size_t needed = 0;
+    unsigned char probe[1];
+    assert(dop_serialize_topology(&source, probe, sizeof(probe), &needed) == DOP_ERROR_MEMORY_ALLOCATION);
+    assert(needed == dop_serialize_size(SERIAL_NODES - 2));
+    unsigned char* buffer = malloc(needed);
+    size_t written = 0;
+    assert(dop_serialize_topology(&source, buffer, needed, &written) == DOP_SUCCESS && written == needed);
+
+    // Matched by id, whatever the node order
+    for (int pass = 0; pass < 2; pass++) {
+        dop_build_topology_t target;
+        build_topology(&target, targets, pass == 1);
+        uint32_t applied = 0;
+        assert(dop_deserialize_topology(buffer, written, &target, &applied) == DOP_SUCCESS);
+        assert(applied == SERIAL_NODES - 2);
+        for (uint32_t i = 0; i < SERIAL_NODES; i++) {
+            if (i == 7 || i == 300) {
+                assert(targets[i]->metadata.state == DOP_STATE_READY);
+            } else {
+                assert_same_state(sources[i], targets[i]);
+            }
+            assert(dop_checksum_verify(targets[i]));
+        }
+        destroy_topology(&target);
+    }
+
+    // Records with no node, or a node of another type, are skipped
+    snprintf(targets[10]->metadata.component_id, sizeof(targets[10]->metadata.component_id), "serial.other");
+    dop_component_t* stranger = dop_func_create_component(DOP_COMPONENT_CLOCK);
+    snprintf(stranger->metadata.component_id, sizeof(stranger->metadata.component_id), "serial.%03u", 11);
+    dop_component_t* swapped = targets[11];
+    targets[11] = stranger;
+    dop_build_topology_t target;
+    build_topology(&target, targets, false);
+    uint32_t applied = 0;
+    assert(dop_deserialize_topology(buffer, written, &target, &applied) == DOP_SUCCESS);
+    assert(applied == SERIAL_NODES - 4);
+    assert(stranger->metadata.state == DOP_STATE_READY);
+    buffer[written - 1] ^= 0x01;
+    assert(dop_deserialize_topology(buffer, written, &target, &applied) == DOP_ERROR_CHECKSUM_FAILED);
+    assert(applied == 0);
+    assert(dop_deserialize_topology(buffer, written, NULL, &applied) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_serialize_topology(NULL, buffer, written, NULL) == DOP_ERROR_INVALID_PARAMETER);
+    destroy_topology(&target);
+    targets[11] = swapped;
+    dop_func_destroy_component(stranger);
+
+    free(buffer);
+    destroy_topology(&source);
+    for (uint32_t i = 0; i < SERIAL_NODES; i++) {
+        dop_func_destroy_component(sources[i]);
+        dop_func_destroy_component(targets[i]);
+    }
+    printf("Topology serialization test passed\n");
+}
+
+int main(void) {
+    test_component_round_trip();
+    test_rejected_buffers();
+    test_topology();
+    printf("All serialize tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,303 @@
+// tests/test_shared_table.c
+// Checks for component tables in shared memory, across processes: slot
+// allocation, lock-free views, robust mutexes and wheel timer ownership
+
+#define _POSIX_C_SOURCE 200809L  // fork, waitpid, nanosleep
+
+#include "dop_shared_table.h"
+#include "dop_timer_wheel.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define SHARED_CAPACITY 8
+#define VIEW_ROUNDS 20000
+#define VIEW_FINAL 59
+
+static char table_name[64];
+
+// Run fn in a child process; it passes by returning normally
+static void run_child(void (*fn)(void)) {
+    fflush(stdout);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        fn();
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000};
+    nanosleep(&delay, NULL);
+}
+
+static void test_slots(void) {
+    printf("Testing shared table slots...\n");
+
+    assert(dop_shared_table_create(NULL, 1) == NULL);
+    assert(dop_shared_table_create(table_name, 0) == NULL);
+    assert(dop_shared_table_attach(table_name, false) == NULL);
+    dop_shared_table_t* table = dop_shared_table_create(table_name, SHARED_CAPACITY);
+    assert(table != NULL && dop_shared_table_capacity(table) == SHARED_CAPACITY);
+    assert(dop_shared_table_create(table_name, SHARED_CAPACITY) == NULL);   // Already exists
+
+    // Ids are unique and must fit; components start like pooled ones
+    dop_component_t* clock = dop_shared_table_create_component(table, DOP_COMPONENT_CLOCK, "shared.clock");
+    assert(clock != NULL && clock->metadata.type == DOP_COMPONENT_CLOCK);
+    assert(clock->metadata.state == DOP_STATE_READY && dop_checksum_verify(clock));
+    assert(dop_shared_table_create_component(table, DOP_COMPONENT_TIMER, "shared.clock") == NULL);
+    assert(dop_shared_table_create_component(table, DOP_COMPONENT_TIMER, "") == NULL);
+    assert(dop_shared_table_create_component(table, DOP_COMPONENT_COUNT, "shared.bad") == NULL);
+    char long_id[80];
+    memset(long_id, 'x', sizeof(long_id) - 1);
+    long_id[sizeof(long_id) - 1] = '\0';
+    assert(dop_shared_table_create_component(table, DOP_COMPONENT_TIMER, long_id) == NULL);
+    assert(dop_shared_table_find(table, "shared.clock") == 0);
+    assert(dop_shared_table_find(table, "shared.none") == -1);
+
+    // The table fills up; a destroyed slot is reused with a clean view
+    dop_component_t* fillers[SHARED_CAPACITY];
+    for (uint32_t i = 1; i < SHARED_CAPACITY; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "shared.filler.%u", i);
+        fillers[i] = dop_shared_table_create_component(table, DOP_COMPONENT_STOPWATCH, id);
+        assert(fillers[i] != NULL && dop_shared_table_component(table, i) == fillers[i]);
+    }
+    assert(dop_shared_table_create_component(table, DOP_COMPONENT_TIMER, "shared.full") == NULL);
+    assert(dop_shared_table_destroy_component(table, fillers[3]) == DOP_SUCCESS);
+    assert(dop_shared_table_destroy_component(table, fillers[3]) == DOP_ERROR_INVALID_STATE);
+    assert(dop_shared_table_component(table, 3) == NULL);
+    assert(dop_shared_table_view(table, 3)->component_id[0] == '\0');
+    dop_component_t* reused = dop_shared_table_create_component(table, DOP_COMPONENT_TIMER, "shared.timer");
+    assert(reused == fillers[3] && reused->metadata.type == DOP_COMPONENT_TIMER);
+    assert(strcmp(dop_shared_table_view(table, 3)->component_id, "shared.timer") == 0);
+    dop_component_t outside;
+    assert(dop_shared_table_destroy_component(table, &outside) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_shared_table_view(table, SHARED_CAPACITY) == NULL);
+    for (uint32_t i = 1; i < SHARED_CAPACITY; i++) {
+        if (i != 3) assert(dop_shared_table_destroy_component(table, fillers[i]) == DOP_SUCCESS);
+    }
+
+    // Read-only attachers see views but cannot reach components
+    dop_shared_table_t* reader = dop_shared_table_attach(table_name, false);
+    assert(reader != NULL && dop_shared_table_capacity(reader) == SHARED_CAPACITY);
+    assert(dop_shared_table_component(reader, 0) == NULL);
+    assert(dop_shared_table_create_component(reader, DOP_COMPONENT_CLOCK, "shared.ro") == NULL);
+    assert(dop_shared_table_publish(reader) == 0);
+    assert(dop_shared_table_find(reader, "shared.timer") == 3);
+
+    // Publishing refreshes only views that changed
+    assert(dop_shared_table_publish(table) == 0);
+    dop_gate_open(clock);
+    assert(dop_func_update_component(clock) == DOP_SUCCESS);
+    assert(dop_shared_table_publish(table) == 1);
+    assert(dop_shared_table_publish(table) == 0);
+    dop_shared_view_t view;
+    assert(dop_shared_view_read(dop_shared_table_view(reader, 0), &view) == DOP_SUCCESS);
+    assert(view.gate_state == DOP_GATE_OPEN && view.checksum == clock->checksum);
+    assert(view.last_update_timestamp == clock->metadata.last_update_timestamp);
+    assert(memcmp(&view.data, &clock->data, sizeof(view.data)) == 0);
+    assert(dop_shared_view_read(NULL, &view) == DOP_ERROR_INVALID_PARAMETER);
+
+    dop_shared_table_detach(reader);
+    dop_shared_table_detach(table);
+    printf("Shared table slot test passed\n");
+}
+
+// A view copied mid-publish would mix two of the writer's rounds
+static void assert_view_whole(const dop_shared_view_t* view) {
+    dop_time_data_t time = view->data.clock.current_time;
+    assert(time.hours == time.minutes && time.minutes == time.seconds);
+    assert(time.seconds == time.milliseconds && view->last_update_timestamp == time.seconds);
+}
+
+static void read_views(void) {
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, false);
+    assert(table != NULL);
+    const dop_shared_view_t* in_place = dop_shared_table_view(table, 0);
+    dop_shared_view_t view;
+    do {
+        assert(dop_shared_view_read(in_place, &view) == DOP_SUCCESS);
+        assert_view_whole(&view);
+
+        // Reading in place between begin and retry
+        uint32_t sequence;
+        dop_time_data_t time;
+        uint64_t stamp;
+        do {
+            sequence = dop_shared_view_begin(in_place);
+            time = in_place->data.clock.current_time;
+            stamp = in_place->last_update_timestamp;
+        } while (dop_shared_view_retry(in_place, sequence));
+        assert(time.hours == time.seconds && stamp == time.seconds);
+    } while (view.last_update_timestamp != VIEW_FINAL);
+    dop_shared_table_detach(table);
+}
+
+static void test_views_across_processes(void) {
+    printf("Testing views across processes...\n");
+
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    assert(table != NULL);
+    dop_component_t* clock = dop_shared_table_component(table, 0);
+    assert(clock != NULL);
+    pthread_mutex_lock(&clock->metadata.mutex);
+    clock->metadata.last_update_timestamp = 0;
+    memset(&clock->data.clock.current_time, 0, sizeof(clock->data.clock.current_time));
+    clock->checksum = dop_checksum_calculate(clock);
+    pthread_mutex_unlock(&clock->metadata.mutex);
+    dop_shared_table_publish(table);
+
+    // The reader runs until it sees the last round
+    fflush(stdout);
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        read_views();
+        _exit(0);
+    }
+    for (uint32_t round = 0; round <= VIEW_ROUNDS; round++) {
+        uint32_t value = round == VIEW_ROUNDS ? VIEW_FINAL : round % VIEW_FINAL;
+        assert(dop_shared_component_lock(clock) == DOP_SUCCESS);
+        clock->data.clock.current_time.hours = value;
+        clock->data.clock.current_time.minutes = value;
+        clock->data.clock.current_time.seconds = value;
+        clock->data.clock.current_time.milliseconds = value;
+        clock->metadata.last_update_timestamp = value;
+        clock->checksum = dop_checksum_calculate(clock);
+        pthread_mutex_unlock(&clock->metadata.mutex);
+        dop_shared_table_publish(table);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    dop_shared_table_detach(table);
+    printf("Views across processes test passed\n");
+}
+
+// Die holding the clock's lock, mid-update or not
+static void die_mid_update(void) {
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    dop_component_t* clock = dop_shared_table_component(table, 0);
+    assert(clock != NULL && dop_shared_component_lock(clock) == DOP_SUCCESS);
+    clock->data.clock.current_time.hours++;
+}
+
+static void die_idle(void) {
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    dop_component_t* clock = dop_shared_table_component(table, 0);
+    assert(clock != NULL && dop_shared_component_lock(clock) == DOP_SUCCESS);
+}
+
+static void test_dead_owner(void) {
+    printf("Testing dead lock owners...\n");
+
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    assert(table != NULL);
+    dop_component_t* clock = dop_shared_table_component(table, 0);
+    dop_gate_open(clock);
+
+    // A component left consistent keeps its state
+    run_child(die_idle);
+    assert(dop_shared_table_publish(table) == 0);
+    assert(clock->metadata.state == DOP_STATE_READY && clock->metadata.gate_state == DOP_GATE_OPEN);
+
+    // One left mid-update is taken out of service, with a valid checksum
+    run_child(die_mid_update);
+    assert(dop_shared_component_lock(clock) == DOP_SUCCESS);
+    assert(clock->metadata.state == DOP_STATE_ERROR && clock->metadata.gate_state == DOP_GATE_CLOSED);
+    assert(dop_checksum_verify(clock));
+    pthread_mutex_unlock(&clock->metadata.mutex);
+    assert(dop_shared_table_publish(table) == 1);
+    assert(dop_shared_table_view(table, 0)->state == DOP_STATE_ERROR);
+
+    // The same through publish
+    run_child(die_mid_update);
+    clock->metadata.state = DOP_STATE_READY;
+    assert(dop_shared_table_publish(table) == 1);
+    assert(clock->metadata.state == DOP_STATE_ERROR && dop_checksum_verify(clock));
+
+    dop_shared_table_detach(table);
+    printf("Dead lock owner test passed\n");
+}
+
+// Start the shared timer in this process, then detach
+static void start_and_detach(void) {
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    dop_component_t* timer = dop_shared_table_component(table, 3);
+    assert(timer != NULL);
+    assert(dop_timer_set_duration(timer, 3600000) == DOP_SUCCESS);
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    assert(timer->metadata.wheel_owner == getpid() && dop_timer_wheel_owned(timer) != 0);
+    dop_shared_table_detach(table);
+}
+
+static void stop_foreign(void) {
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    dop_component_t* timer = dop_shared_table_component(table, 3);
+    assert(timer != NULL && timer->metadata.wheel_owner == getppid());
+    assert(dop_timer_wheel_owned(timer) == 0);
+    assert(dop_timer_stop(timer) == DOP_SUCCESS);
+    dop_shared_table_detach(table);
+}
+
+static void test_timer_owner(void) {
+    printf("Testing wheel timer owners...\n");
+
+    // The children run before this process first uses its wheel, so none
+    // inherits a wheel whose thread may hold its lock
+    dop_shared_table_t* table = dop_shared_table_attach(table_name, true);
+    assert(table != NULL);
+    dop_component_t* timer = dop_shared_table_component(table, 3);
+    assert(timer != NULL && timer->metadata.type == DOP_COMPONENT_TIMER);
+
+    // A detaching process stops the timers it scheduled
+    run_child(start_and_detach);
+    assert(!timer->data.timer.is_running && timer->metadata.wheel_timer == 0);
+    assert(dop_checksum_verify(timer));
+
+    // Another process stopping this one's timer leaves the entry in this
+    // wheel, and its expiry is ignored
+    assert(dop_timer_set_duration(timer, 20) == DOP_SUCCESS);
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    assert(timer->metadata.wheel_owner == getpid() && dop_timer_wheel_owned(timer) != 0);
+    run_child(stop_foreign);
+    assert(!timer->data.timer.is_running && dop_timer_wheel_owned(timer) == 0);
+    for (int waited = 0; dop_timer_wheel_pending(dop_timer_wheel_shared()) != 0; waited++) {
+        assert(waited < 5000);
+        sleep_ms(1);
+    }
+    assert(!dop_timer_is_expired(timer) && !timer->data.timer.is_running);
+
+    // Run here, it fires here
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    for (int waited = 0; !dop_timer_is_expired(timer); waited++) {
+        assert(waited < 5000);
+        sleep_ms(1);
+    }
+    assert(!timer->data.timer.is_running && timer->metadata.wheel_timer == 0);
+
+    dop_shared_table_detach(table);
+    printf("Wheel timer owner test passed\n");
+}
+
+int main(void) {
+    snprintf(table_name, sizeof(table_name), "/gov_clock_check_%d", (int)getpid());
+    dop_shared_table_unlink(table_name);
+    test_slots();
+    test_views_across_processes();
+    test_dead_owner();
+    test_timer_owner();
+    assert(dop_shared_table_unlink(table_name) == DOP_SUCCESS);
+    assert(dop_shared_table_unlink(table_name) == DOP_ERROR_INVALID_STATE);
+    printf("All shared table tests passed!\n");
+    return 0;
+}
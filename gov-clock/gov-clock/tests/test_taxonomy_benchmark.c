@@ -0,0 +1,130 @@
+// tests/test_taxonomy_benchmark.c
+// Checks for the taxonomy benchmark: its measurements hang together and
+// its JSON is well formed
+
+#define _POSIX_C_SOURCE 200809L  // open_memstream
+
+#include "taxonomy_testing.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Brackets balance outside strings, and nothing follows the document
+static bool json_balanced(const char* text) {
+    char stack[64];
+    size_t depth = 0;
+    bool in_string = false;
+    for (const char* c = text; *c; c++) {
+        if (in_string) {
+            if (*c == '\\' && c[1]) c++;
+            else if (*c == '"') in_string = false;
+        } else if (*c == '"') {
+            in_string = true;
+        } else if (*c == '{' || *c == '[') {
+            if (depth == sizeof(stack)) return false;
+            stack[depth++] = *c == '{' ? '}' : ']';
+        } else if (*c == '}' || *c == ']') {
+            if (depth == 0 || stack[--depth] != *c) return false;
+            if (depth == 0 && strspn(c + 1, " \n") != strlen(c + 1)) return false;
+        }
+    }
+    return depth == 0 && !in_string;
+}
+
+static void assert_result(const taxonomy_benchmark_result_t* result) {
+    assert(result->operations > 0 && result->failures == 0);
+    assert(result->elapsed_ns >= (uint64_t)result->config.duration_ms * 1000000);
+    assert(result->ops_per_sec > 0);
+
+    // Every operation lands in one bucket, and percentiles are ordered
+    uint64_t bucketed = 0;
+    for (uint32_t i = 0; i < TAXONOMY_BENCHMARK_BUCKETS; i++) {
+        bucketed += result->latency_buckets[i];
+    }
+    assert(bucketed == result->operations);
+    assert(result->latency_p50_ns > 0 && result->latency_p50_ns <= result->latency_p90_ns);
+    assert(result->latency_p90_ns <= result->latency_p99_ns);
+    assert(result->latency_p99_ns <= result->latency_p999_ns);
+    assert(result->latency_max_ns >= result->latency_p999_ns / 2);   // Bucket bounds
+
+    assert(result->contended <= result->operations);
+    assert(result->lock_wait_max_ns <= result->lock_wait_ns);
+    assert(result->contended > 0 || result->lock_wait_ns == 0);
+    // The kernel syncs per-thread RSS counters lazily, so statm and the
+    // getrusage peak need not agree at any one moment
+    assert(result->rss_start_kb > 0 && result->rss_end_kb > 0 && result->rss_peak_kb > 0);
+}
+
+static void test_benchmark(void) {
+    printf("Testing taxonomy benchmark...\n");
+
+    taxonomy_benchmark_config_t config = TAXONOMY_BENCHMARK_DEFAULT_CONFIG;
+    config.threads = 2;
+    config.duration_ms = 50;
+    config.components = 8;
+    taxonomy_benchmark_result_t result;
+
+    // Configurations that cannot run are refused
+    taxonomy_benchmark_config_t bad = config;
+    bad.threads = 0;
+    assert(taxonomy_run_benchmark(&bad, &result) == DOP_ERROR_INVALID_PARAMETER);
+    bad = config;
+    bad.components = 0;
+    assert(taxonomy_run_benchmark(&bad, &result) == DOP_ERROR_INVALID_PARAMETER);
+    bad = config;
+    memset(bad.mix, 0, sizeof(bad.mix));
+    assert(taxonomy_run_benchmark(&bad, &result) == DOP_ERROR_INVALID_PARAMETER);
+    bad = config;
+    bad.level = (taxonomy_level_t)0;
+    assert(taxonomy_run_benchmark(&bad, &result) == DOP_ERROR_INVALID_PARAMETER);
+    assert(taxonomy_run_benchmark(NULL, &result) == DOP_ERROR_INVALID_PARAMETER);
+
+    // Every level, with the default mix and with clocks only
+    for (int level = TAXONOMY_ISOLATED; level <= TAXONOMY_OPEN; level++) {
+        config.level = (taxonomy_level_t)level;
+        assert(taxonomy_run_benchmark(&config, &result) == DOP_SUCCESS);
+        assert(result.config.level == config.level);
+        assert_result(&result);
+    }
+    taxonomy_benchmark_config_t clocks = config;
+    memset(clocks.mix, 0, sizeof(clocks.mix));
+    clocks.mix[DOP_COMPONENT_CLOCK] = 1;
+    assert(taxonomy_run_benchmark(&clocks, &result) == DOP_SUCCESS);
+    assert_result(&result);
+
+    // One result as JSON
+    char* text = NULL;
+    size_t length = 0;
+    FILE* out = open_memstream(&text, &length);
+    assert(out != NULL);
+    assert(taxonomy_benchmark_write_json(&result, out) == DOP_SUCCESS);
+    fclose(out);
+    assert(json_balanced(text));
+    assert(strstr(text, "\"level\": \"open\"") != NULL);
+    assert(strstr(text, "\"mix\": {\"alarm\": 0, \"clock\": 1, \"stopwatch\": 0, \"timer\": 0}") != NULL);
+    char operations[64];
+    snprintf(operations, sizeof(operations), "\"operations\": %llu,",
+             (unsigned long long)result.operations);
+    assert(strstr(text, operations) != NULL);
+    assert(strstr(text, "\"buckets\": [") && strstr(text, "\"lock\": {") && strstr(text, "\"rss_kb\": {"));
+    free(text);
+    assert(taxonomy_benchmark_write_json(NULL, stdout) == DOP_ERROR_INVALID_PARAMETER);
+
+    // The suite runs each level once into one document
+    out = open_memstream(&text, &length);
+    assert(taxonomy_run_benchmark_suite(&config, out) == DOP_SUCCESS);
+    fclose(out);
+    assert(json_balanced(text) && strncmp(text, "{\"benchmarks\": [", 16) == 0);
+    assert(strstr(text, "\"level\": \"isolated\"") && strstr(text, "\"level\": \"closed\"") &&
+           strstr(text, "\"level\": \"open\""));
+    free(text);
+
+    printf("Taxonomy benchmark test passed\n");
+}
+
+int main(void) {
+    test_benchmark();
+    printf("All taxonomy benchmark tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,203 @@
+// tests/test_timer_wheel.c
+// Checks for the hierarchical timer wheel and the timer and alarm
+// components that register with the shared one
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime, nanosleep
+
+#include "dop_timer_wheel.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define WHEEL_TIMERS 5000
+#define WHEEL_SPREAD_MS 300     // Past the first level's 64 ticks
+
+typedef struct {
+    uint64_t handle;
+    uint64_t due_ms;
+    bool cancelled;
+    int fired;
+    bool reschedule;            // Schedule itself again once from the callback
+} wheel_probe_t;
+
+static wheel_probe_t probes[WHEEL_TIMERS];
+static wheel_probe_t far_probe;
+static pthread_mutex_t probe_lock = PTHREAD_MUTEX_INITIALIZER;
+static dop_timer_wheel_t* probe_wheel;
+static uint64_t deliveries;
+static uint64_t batches;
+static uint64_t early;
+
+static uint64_t now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+static void pause_ms(long ms) {
+    struct timespec pause = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&pause, NULL);
+}
+
+static void on_expire(const dop_wheel_expiry_t* expired, size_t count, void* user_data) {
+    assert(user_data == &probes);
+    uint64_t now = now_ms();
+    pthread_mutex_lock(&probe_lock);
+    batches++;
+    for (size_t i = 0; i < count; i++) {
+        wheel_probe_t* probe = expired[i].context;
+        assert(expired[i].handle == probe->handle);
+        probe->fired++;
+        deliveries++;
+        early += now + 1 < probe->due_ms;   // Monotonic ms truncate differently here
+        if (probe->reschedule) {
+            probe->reschedule = false;
+            probe->due_ms = now + 5;
+            probe->handle = dop_timer_wheel_schedule(probe_wheel, 5, probe);
+        }
+    }
+    pthread_mutex_unlock(&probe_lock);
+}
+
+static uint64_t delivered(void) {
+    pthread_mutex_lock(&probe_lock);
+    uint64_t count = deliveries;
+    pthread_mutex_unlock(&probe_lock);
+    return count;
+}
+
+static void test_wheel(void) {
+    printf("Testing timer wheel...\n");
+
+    assert(dop_timer_wheel_create(0, on_expire, NULL) == NULL);
+    assert(dop_timer_wheel_create(1, NULL, NULL) == NULL);
+    probe_wheel = dop_timer_wheel_create(1, on_expire, &probes);
+    assert(probe_wheel != NULL);
+
+    // Schedule across the levels, with every third timer cancelled and one
+    // rescheduling itself when it fires
+    pthread_mutex_lock(&probe_lock);
+    for (uint32_t i = 0; i < WHEEL_TIMERS; i++) {
+        uint64_t delay = (i * 7919u) % WHEEL_SPREAD_MS;
+        probes[i].due_ms = now_ms() + delay;
+        probes[i].handle = dop_timer_wheel_schedule(probe_wheel, delay, &probes[i]);
+        assert(probes[i].handle != 0);
+    }
+    probes[1].reschedule = true;
+    pthread_mutex_unlock(&probe_lock);
+    uint32_t cancelled = 0;
+    for (uint32_t i = 0; i < WHEEL_TIMERS; i += 3) {
+        pthread_mutex_lock(&probe_lock);
+        uint64_t handle = probes[i].handle;
+        pthread_mutex_unlock(&probe_lock);
+        if (dop_timer_wheel_cancel(probe_wheel, handle) == DOP_SUCCESS) {
+            probes[i].cancelled = true;
+            cancelled++;
+            assert(dop_timer_wheel_cancel(probe_wheel, handle) == DOP_ERROR_INVALID_STATE);
+        }
+    }
+    assert(cancelled > WHEEL_TIMERS / 4);
+    assert(dop_timer_wheel_cancel(probe_wheel, 0) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_timer_wheel_cancel(probe_wheel, UINT32_MAX) == DOP_ERROR_INVALID_STATE);
+
+    // Everything not cancelled fires once, no earlier than due, in batches
+    uint64_t expected = WHEEL_TIMERS - cancelled + 1;
+    for (int tries = 0; tries < 10000 && delivered() < expected; tries++) pause_ms(1);
+    pause_ms(20);
+    pthread_mutex_lock(&probe_lock);
+    assert(deliveries == expected && early == 0);
+    assert(batches < deliveries);
+    for (uint32_t i = 0; i < WHEEL_TIMERS; i++) {
+        assert(probes[i].fired == (probes[i].cancelled ? 0 : i == 1 ? 2 : 1));
+    }
+    uint64_t fired = probes[2].handle;
+    pthread_mutex_unlock(&probe_lock);
+    assert(dop_timer_wheel_pending(probe_wheel) == 0);
+    assert(dop_timer_wheel_cancel(probe_wheel, fired) == DOP_ERROR_INVALID_STATE);
+
+    // Far timers sit in the upper levels until destroy drops them
+    assert(dop_timer_wheel_schedule(probe_wheel, 3600 * 1000, &far_probe) != 0);
+    assert(dop_timer_wheel_schedule(probe_wheel, 7 * 24 * 3600 * 1000ULL, &far_probe) != 0);
+    assert(dop_timer_wheel_pending(probe_wheel) == 2);
+    dop_timer_wheel_destroy(probe_wheel);
+    assert(far_probe.fired == 0);
+    printf("Timer wheel test passed (%llu deliveries in %llu batches)\n",
+           (unsigned long long)deliveries, (unsigned long long)batches);
+}
+
+static bool wait_until(bool (*done)(const dop_component_t*), const dop_component_t* component) {
+    for (int tries = 0; tries < 10000; tries++) {
+        if (done(component)) return true;
+        pause_ms(1);
+    }
+    return false;
+}
+
+static void test_components(void) {
+    printf("Testing timer and alarm components...\n");
+
+    // A started timer expires through the shared wheel
+    dop_component_t* timer = dop_func_create_component(DOP_COMPONENT_TIMER);
+    assert(timer != NULL);
+    assert(dop_timer_set_duration(timer, 20) == DOP_SUCCESS);
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    assert(timer->data.timer.is_running && timer->metadata.wheel_timer != 0);
+    assert(wait_until(dop_timer_is_expired, timer));
+    pthread_mutex_lock(&timer->metadata.mutex);
+    assert(!timer->data.timer.is_running && timer->metadata.wheel_timer == 0);
+    pthread_mutex_unlock(&timer->metadata.mutex);
+
+    // Stopped before it is due, it never expires
+    assert(dop_timer_reset(timer) == DOP_SUCCESS && !dop_timer_is_expired(timer));
+    assert(dop_timer_set_duration(timer, 100) == DOP_SUCCESS);
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    assert(dop_timer_stop(timer) == DOP_SUCCESS);
+    assert(timer->metadata.wheel_timer == 0);
+    pause_ms(200);
+    assert(!dop_timer_is_expired(timer));
+
+    // Auto restart keeps it scheduled after each expiry
+    timer->data.timer.auto_restart = true;
+    assert(dop_timer_set_duration(timer, 5) == DOP_SUCCESS);
+    assert(dop_timer_start(timer) == DOP_SUCCESS);
+    assert(wait_until(dop_timer_is_expired, timer));
+    pthread_mutex_lock(&timer->metadata.mutex);
+    assert(timer->data.timer.is_running && timer->metadata.wheel_timer != 0);
+    pthread_mutex_unlock(&timer->metadata.mutex);
+    assert(dop_timer_stop(timer) == DOP_SUCCESS);
+
+    // An armed alarm an hour off triggers when a snooze runs out instead
+    dop_component_t* alarm = dop_func_create_component(DOP_COMPONENT_ALARM);
+    assert(alarm != NULL);
+    dop_gate_open(alarm);
+    dop_time_data_t alarm_time = dop_time_get_current();
+    alarm_time.hours = (alarm_time.hours + 1) % 24;
+    assert(dop_alarm_set_time(alarm, alarm_time) == DOP_SUCCESS);
+    assert(dop_alarm_arm(alarm) == DOP_SUCCESS);
+    assert(alarm->metadata.wheel_timer != 0);
+    pause_ms(20);
+    assert(!dop_alarm_is_triggered(alarm));
+    assert(dop_alarm_snooze(alarm, 10) == DOP_SUCCESS);
+    assert(wait_until(dop_alarm_is_triggered, alarm));
+
+    // Disarming clears the trigger and the timer, and keeps it quiet
+    assert(dop_alarm_arm(alarm) == DOP_SUCCESS);
+    assert(dop_alarm_disarm(alarm) == DOP_SUCCESS);
+    assert(!dop_alarm_is_triggered(alarm) && alarm->metadata.wheel_timer == 0);
+    assert(dop_alarm_snooze(alarm, 5) == DOP_SUCCESS);
+    pause_ms(30);
+    assert(!dop_alarm_is_triggered(alarm));
+
+    dop_func_destroy_component(timer);
+    dop_func_destroy_component(alarm);
+    printf("Timer and alarm component test passed\n");
+}
+
+int main(void) {
+    test_wheel();
+    test_components();
+    printf("All timer wheel tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+// tests/test_topology.c
+// Checks for P2P topologies: peer sets, per-node workers and their
+// mailboxes, and fault tolerance sampling
+
+#define _POSIX_C_SOURCE 200809L  // nanosleep
+
+#include "dop_topology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TOPOLOGY_NODES 16
+#define TOPOLOGY_UPDATES 50
+
+static void pause_ms(long ms) {
+    struct timespec pause = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&pause, NULL);
+}
+
+// Wait until every node but skip has updated at least target times, or fail
+static void wait_for_updates(dop_build_topology_t* topology, uint64_t target,
+                             const dop_topology_node_t* skip) {
+    for (int tries = 0; tries < 10000; tries++) {
+        uint32_t done = 0;
+        for (uint32_t i = 0; i < topology->node_count; i++) {
+            done += topology->nodes[i] == skip || atomic_load(&topology->nodes[i]->updates) >= target;
+        }
+        if (done == topology->node_count) return;
+        pause_ms(1);
+    }
+    assert(!"nodes stopped updating");
+}
+
+static void test_peer_sets(void) {
+    printf("Testing peer sets...\n");
+
+    dop_component_t* components[2];
+    dop_topology_node_t* nodes[2];
+    for (int i = 0; i < 2; i++) {
+        components[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(components[i] != NULL);
+        nodes[i] = dop_topology_create_node(i ? "peer.b" : "peer.a", components[i]);
+        assert(nodes[i] != NULL && nodes[i]->component == components[i]);
+    }
+    assert(dop_topology_create_node(NULL, components[0]) == NULL);
+    assert(dop_topology_create_node("peer.none", NULL) == NULL);
+
+    // A node is not its own peer, and a peer added twice is there once
+    assert(dop_topology_add_peer(nodes[0], nodes[0]) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_topology_add_peer(nodes[0], nodes[1]) == DOP_SUCCESS);
+    assert(dop_topology_add_peer(nodes[0], nodes[1]) == DOP_SUCCESS);
+    assert(nodes[0]->peer_count == 1 && nodes[0]->peers[0] == nodes[1]);
+
+    // Past the first table size, every peer still goes in once
+    dop_topology_node_t* many[100];
+    for (int i = 0; i < 100; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "peer.many.%d", i);
+        many[i] = dop_topology_create_node(id, components[1]);
+        assert(dop_topology_add_peer(nodes[0], many[i]) == DOP_SUCCESS);
+    }
+    for (int i = 0; i < 100; i++) {
+        assert(dop_topology_add_peer(nodes[0], many[i]) == DOP_SUCCESS);
+    }
+    assert(nodes[0]->peer_count == 101);
+    assert(nodes[0]->peer_set_capacity >= 2 * nodes[0]->peer_count);
+
+    for (int i = 0; i < 100; i++) dop_topology_destroy_node(many[i]);
+    for (int i = 0; i < 2; i++) {
+        dop_topology_destroy_node(nodes[i]);
+        dop_func_destroy_component(components[i]);
+    }
+    printf("Peer set test passed\n");
+}
+
+static void test_p2p_network(void) {
+    printf("Testing P2P network...\n");
+
+    // A ring, each node peered with the next two
+    dop_build_topology_t topology;
+    memset(&topology, 0, sizeof(topology));
+    dop_component_t* components[TOPOLOGY_NODES];
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "node.%02u", i);
+        components[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(components[i] != NULL);
+        assert(dop_topology_add_node(&topology, dop_topology_create_node(id, components[i])) ==
+               DOP_SUCCESS);
+    }
+    assert(topology.node_count == TOPOLOGY_NODES && topology.node_capacity >= TOPOLOGY_NODES);
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        for (uint32_t k = 1; k <= 2; k++) {
+            assert(dop_topology_add_peer(topology.nodes[i],
+                                         topology.nodes[(i + k) % TOPOLOGY_NODES]) == DOP_SUCCESS);
+        }
+    }
+    assert(dop_topology_stop_p2p_network(&topology) == DOP_ERROR_INVALID_STATE);
+
+    // Every node updates its component and hears from its peers
+    assert(dop_topology_start_p2p_network(&topology) == DOP_SUCCESS);
+    assert(topology.is_p2p_enabled);
+    assert(dop_topology_start_p2p_network(&topology) == DOP_ERROR_INVALID_STATE);
+    dop_topology_node_t* extra = dop_topology_create_node("node.extra", components[0]);
+    assert(dop_topology_add_node(&topology, extra) == DOP_ERROR_INVALID_STATE);
+    wait_for_updates(&topology, TOPOLOGY_UPDATES, NULL);
+
+    // An isolated node stops updating while the rest carry on; an update
+    // that passed its gate before the isolation may still be counted
+    dop_topology_node_t* isolated = topology.nodes[3];
+    assert(dop_gate_isolate(isolated->component) == DOP_SUCCESS);
+    uint64_t frozen = atomic_load(&isolated->updates);
+    uint64_t busiest = 0;
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        uint64_t updates = atomic_load(&topology.nodes[i]->updates);
+        if (updates > busiest) busiest = updates;
+    }
+    wait_for_updates(&topology, busiest + TOPOLOGY_UPDATES, isolated);
+    assert(atomic_load(&isolated->updates) <= frozen + 1);
+    assert(dop_gate_open(isolated->component) == DOP_SUCCESS);
+    wait_for_updates(&topology, frozen + 1 + TOPOLOGY_UPDATES, NULL);
+
+    // Applications can send their own messages; a full mailbox counts the loss
+    dop_peer_message_t message = { .from = NULL, .type = DOP_PEER_MSG_USER, .payload = 42 };
+    uint64_t dropped = atomic_load(&topology.nodes[0]->messages_dropped);
+    if (!dop_topology_send(topology.nodes[0], &message)) {
+        assert(atomic_load(&topology.nodes[0]->messages_dropped) > dropped);
+    }
+
+    assert(dop_topology_stop_p2p_network(&topology) == DOP_SUCCESS);
+    assert(!topology.is_p2p_enabled);
+    dropped = atomic_load(&topology.nodes[0]->messages_dropped);
+    assert(!dop_topology_send(topology.nodes[0], &message));
+    assert(atomic_load(&topology.nodes[0]->messages_dropped) == dropped);
+
+    // Only peers send, and only after an update, so nothing is received
+    // that was not sent
+    uint64_t sent = 0, accounted = 0;
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        dop_topology_node_t* node = topology.nodes[i];
+        sent += atomic_load(&node->updates) * node->peer_count;
+        accounted += atomic_load(&node->messages_received) + atomic_load(&node->messages_dropped);
+        assert(atomic_load(&node->messages_received) > 0);
+        assert(node->mailbox == NULL && !atomic_load(&node->running));
+    }
+    assert(accounted <= sent + 1);
+
+    // Isolating samples of the nodes leaves the others accessible
+    assert(dop_topology_test_fault_tolerance(&topology) == DOP_SUCCESS);
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        assert(dop_gate_is_accessible(topology.nodes[i]->component));
+    }
+
+    // Restartable once stopped
+    assert(dop_topology_start_p2p_network(&topology) == DOP_SUCCESS);
+    assert(dop_topology_stop_p2p_network(&topology) == DOP_SUCCESS);
+
+    dop_topology_destroy_node(extra);
+    for (uint32_t i = 0; i < TOPOLOGY_NODES; i++) {
+        dop_topology_destroy_node(topology.nodes[i]);
+        dop_func_destroy_component(components[i]);
+    }
+    dop_topology_release(&topology);
+    assert(topology.nodes == NULL && topology.node_count == 0);
+    printf("P2P network test passed\n");
+}
+
+int main(void) {
+    test_peer_sets();
+    test_p2p_network();
+    printf("All topology tests passed!\n");
+    return 0;
+}
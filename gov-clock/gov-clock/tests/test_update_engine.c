@@ -0,0 +1,171 @@
+// tests/test_update_engine.c
+// Checks for the batched update engine and dop_func_update_component
+
+#include "dop_update_engine.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define ENGINE_CLOCKS 10000
+#define ENGINE_TIMERS 100
+#define ENGINE_STOPWATCHES 100
+#define ENGINE_RACE_TICKS 200
+
+static dop_component_t* clocks[ENGINE_CLOCKS];
+static dop_component_t* timers[ENGINE_TIMERS];
+static dop_component_t* stopwatches[ENGINE_STOPWATCHES];
+
+static void assert_duration(dop_time_data_t time, uint64_t ms) {
+    assert(time.timestamp_ms == ms && time.is_valid);
+    assert(time.hours == ms / 3600000 && time.minutes == ms / 60000 % 60);
+    assert(time.seconds == ms / 1000 % 60 && time.milliseconds == ms % 1000);
+}
+
+static void test_engine_tick(void) {
+    printf("Testing engine tick...\n");
+
+    dop_update_engine_t* engine = dop_update_engine_create();
+    assert(engine != NULL);
+    uint64_t now_ms = dop_time_get_current().timestamp_ms;
+
+    // Every other clock is open. Timers started a second ago run for five,
+    // except one started in the future and one long overdue; every third
+    // stopwatch is paused.
+    for (uint32_t i = 0; i < ENGINE_CLOCKS; i++) {
+        clocks[i] = dop_func_create_component(DOP_COMPONENT_CLOCK);
+        assert(clocks[i] != NULL);
+        if (i % 2 == 0) {
+            dop_gate_open(clocks[i]);
+        } else {
+            clocks[i]->data.clock.current_time.timestamp_ms = 0;
+            clocks[i]->checksum = dop_checksum_calculate(clocks[i]);
+        }
+        assert(dop_update_engine_add(engine, clocks[i]) == DOP_SUCCESS);
+    }
+    for (uint32_t i = 0; i < ENGINE_TIMERS; i++) {
+        timers[i] = dop_func_create_component(DOP_COMPONENT_TIMER);
+        dop_gate_open(timers[i]);
+        timers[i]->data.timer.is_running = true;
+        timers[i]->data.timer.start_time.timestamp_ms = now_ms - 1000;
+        timers[i]->data.timer.duration.timestamp_ms = 5000;
+        assert(dop_update_engine_add(engine, timers[i]) == DOP_SUCCESS);
+    }
+    timers[0]->data.timer.start_time.timestamp_ms = now_ms + 60000;
+    timers[1]->data.timer.start_time.timestamp_ms = now_ms - 3600000;
+    for (uint32_t i = 0; i < ENGINE_STOPWATCHES; i++) {
+        stopwatches[i] = dop_func_create_component(DOP_COMPONENT_STOPWATCH);
+        dop_gate_open(stopwatches[i]);
+        stopwatches[i]->data.stopwatch.is_running = true;
+        stopwatches[i]->data.stopwatch.is_paused = i % 3 == 0;
+        stopwatches[i]->data.stopwatch.start_time.timestamp_ms = now_ms - 3723004;
+        assert(dop_update_engine_add(engine, stopwatches[i]) == DOP_SUCCESS);
+    }
+    assert(dop_update_engine_add(engine, clocks[0]) == DOP_ERROR_INVALID_STATE);
+    assert(dop_update_engine_add(engine, NULL) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_update_engine_count(engine, DOP_COMPONENT_CLOCK) == ENGINE_CLOCKS);
+    assert(dop_update_engine_count(engine, DOP_COMPONENT_TIMER) == ENGINE_TIMERS);
+    assert(dop_update_engine_count(engine, DOP_COMPONENT_COUNT) == 0);
+
+    // One clock reading for the whole tick; closed gates are left alone
+    uint32_t updated = dop_update_engine_tick(engine);
+    assert(updated == ENGINE_CLOCKS / 2 + ENGINE_TIMERS + ENGINE_STOPWATCHES);
+    uint64_t tick_ms = clocks[0]->metadata.last_update_timestamp;
+    assert(tick_ms >= now_ms);
+    for (uint32_t i = 0; i < ENGINE_CLOCKS; i++) {
+        if (i % 2 == 0) {
+            assert(clocks[i]->data.clock.current_time.timestamp_ms == tick_ms);
+            assert(clocks[i]->metadata.last_update_timestamp == tick_ms);
+        } else {
+            assert(clocks[i]->data.clock.current_time.timestamp_ms == 0);
+        }
+        assert(dop_checksum_verify(clocks[i]));
+    }
+
+    // Remaining and elapsed come from that same reading, clamped at zero
+    assert_duration(timers[0]->data.timer.remaining, 5000);
+    assert_duration(timers[1]->data.timer.remaining, 0);
+    for (uint32_t i = 2; i < ENGINE_TIMERS; i++) {
+        assert_duration(timers[i]->data.timer.remaining, 5000 - (tick_ms - (now_ms - 1000)));
+        assert(dop_checksum_verify(timers[i]));
+    }
+    for (uint32_t i = 0; i < ENGINE_STOPWATCHES; i++) {
+        if (i % 3 == 0) {
+            assert(stopwatches[i]->data.stopwatch.elapsed_time.timestamp_ms == 0);
+        } else {
+            assert_duration(stopwatches[i]->data.stopwatch.elapsed_time, tick_ms - (now_ms - 3723004));
+        }
+    }
+
+    // Removal fills the gap with the last member and stops its updates
+    assert(dop_update_engine_remove(engine, clocks[0]) == DOP_SUCCESS);
+    assert(dop_update_engine_remove(engine, clocks[0]) == DOP_ERROR_INVALID_STATE);
+    assert(clocks[0]->metadata.batch_slot == 0);
+    assert(clocks[ENGINE_CLOCKS - 1]->metadata.batch_slot == 1);
+    assert(dop_update_engine_count(engine, DOP_COMPONENT_CLOCK) == ENGINE_CLOCKS - 1);
+    clocks[0]->data.clock.current_time.timestamp_ms = 0;
+    assert(dop_update_engine_tick(engine) == updated - 1);
+    assert(clocks[0]->data.clock.current_time.timestamp_ms == 0);
+
+    // A single update runs the same passes
+    assert(dop_func_update_component(clocks[0]) == DOP_SUCCESS);
+    assert(clocks[0]->data.clock.current_time.timestamp_ms >= tick_ms);
+    assert(dop_func_update_component(clocks[1]) == DOP_ERROR_INVALID_PARAMETER);
+    assert(dop_func_update_component(NULL) == DOP_ERROR_INVALID_PARAMETER);
+
+    // A component belongs to one engine at a time; destroy lets it go
+    dop_update_engine_t* other = dop_update_engine_create();
+    assert(dop_update_engine_add(other, clocks[2]) == DOP_ERROR_INVALID_STATE);
+    assert(dop_update_engine_remove(other, clocks[2]) == DOP_ERROR_INVALID_STATE);
+    assert(dop_update_engine_add(other, clocks[0]) == DOP_SUCCESS);
+    dop_update_engine_destroy(engine);
+    assert(clocks[2]->metadata.batch_slot == 0);
+    assert(dop_update_engine_add(other, clocks[2]) == DOP_SUCCESS);
+    dop_update_engine_destroy(other);
+    printf("Engine tick test passed\n");
+}
+
+static dop_update_engine_t* race_engine;
+
+static void* tick_engine(void* arg) {
+    (void)arg;
+    for (int i = 0; i < ENGINE_RACE_TICKS; i++) dop_update_engine_tick(race_engine);
+    return NULL;
+}
+
+static void test_concurrent_updates(void) {
+    printf("Testing concurrent updates...\n");
+
+    // Ticks race single updates and gate changes on the same components
+    race_engine = dop_update_engine_create();
+    for (uint32_t i = 0; i < 256; i++) {
+        assert(dop_update_engine_add(race_engine, clocks[i]) == DOP_SUCCESS);
+    }
+    pthread_t ticker;
+    assert(pthread_create(&ticker, NULL, tick_engine, NULL) == 0);
+    for (int round = 0; round < ENGINE_RACE_TICKS; round++) {
+        for (uint32_t i = 0; i < 256; i += 16) {
+            dop_func_update_component(clocks[i]);
+            if (round % 2) dop_gate_isolate(clocks[i + 1]);
+            else dop_gate_open(clocks[i + 1]);
+        }
+    }
+    pthread_join(ticker, NULL);
+    for (uint32_t i = 0; i < 256; i++) {
+        pthread_mutex_lock(&clocks[i]->metadata.mutex);
+        assert(dop_checksum_verify(clocks[i]));
+        pthread_mutex_unlock(&clocks[i]->metadata.mutex);
+    }
+    dop_update_engine_destroy(race_engine);
+    printf("Concurrent update test passed\n");
+}
+
+int main(void) {
+    test_engine_tick();
+    test_concurrent_updates();
+    for (uint32_t i = 0; i < ENGINE_CLOCKS; i++) dop_func_destroy_component(clocks[i]);
+    for (uint32_t i = 0; i < ENGINE_TIMERS; i++) dop_func_destroy_component(timers[i]);
+    for (uint32_t i = 0; i < ENGINE_STOPWATCHES; i++) dop_func_destroy_component(stopwatches[i]);
+    printf("All update engine tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+# tests/test_validation_cache.cmake
+# Checks for the content-hash cache behind incremental validation, and for
+# the manifest and source-to-build scripts that use it
+#
+# Run with cmake -P; WORK_DIR is scratch space, removed and recreated.
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT DEFINED WORK_DIR)
+    message(FATAL_ERROR "WORK_DIR is required")
+endif()
+# The scripts under test need it absolute as SOURCE_DIR; make passes it relative
+get_filename_component(WORK_DIR "${WORK_DIR}" ABSOLUTE)
+get_filename_component(SCRIPTS_DIR "${CMAKE_CURRENT_LIST_DIR}/../scripts" ABSOLUTE)
+include("${SCRIPTS_DIR}/validation_cache.cmake")
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/src")
+set(CACHE_FILE "${WORK_DIR}/cache/source_hashes.txt")
+
+# Sources written at a fixed time in the past, so none counts as modified
+# in the current second
+function(write_source NAME CONTENT MTIME)
+    file(WRITE "${WORK_DIR}/src/${NAME}" "${CONTENT}")
+    execute_process(COMMAND touch -d "@${MTIME}" "${WORK_DIR}/src/${NAME}" RESULT_VARIABLE TOUCHED)
+    if(NOT TOUCHED EQUAL 0)
+        message(FATAL_ERROR "Cannot set the mtime of ${NAME}")
+    endif()
+endfunction()
+
+function(expect_hashed EXPECTED)
+    set(ACTUAL ${DOP_HASHED})
+    list(SORT ACTUAL)
+    list(SORT EXPECTED)
+    if(NOT "${ACTUAL}" STREQUAL "${EXPECTED}")
+        message(FATAL_ERROR "Hashed [${ACTUAL}], expected [${EXPECTED}]")
+    endif()
+endfunction()
+
+# Every listed file that exists has its true hash
+function(expect_hashes)
+    foreach(FILE_PATH ${ARGN})
+        dop_hash_key(KEY "${FILE_PATH}")
+        file(SHA256 "${FILE_PATH}" EXPECTED)
+        if(NOT "${DOP_HASH_${KEY}}" STREQUAL "${EXPECTED}")
+            message(FATAL_ERROR "Wrong hash for ${FILE_PATH}: ${DOP_HASH_${KEY}}")
+        endif()
+    endforeach()
+endfunction()
+
+message(STATUS "Testing hash cache...")
+
+set(SOURCES "")
+foreach(INDEX RANGE 1 6)
+    write_source("unit_${INDEX}.c" "int unit_${INDEX}(void) { return ${INDEX}; }\n" 1000000000)
+    list(APPEND SOURCES "${WORK_DIR}/src/unit_${INDEX}.c")
+endforeach()
+write_source("with space.c" "int spaced;\n" 1000000000)
+list(APPEND SOURCES "${WORK_DIR}/src/with space.c")
+
+# A cold cache hashes everything, across three workers
+dop_hash_files("${CACHE_FILE}" 3 ${SOURCES})
+expect_hashed("${SOURCES}")
+expect_hashes(${SOURCES})
+if(EXISTS "${WORK_DIR}/cache/.hash_workers")
+    message(FATAL_ERROR "Worker files were left behind")
+endif()
+
+# A warm cache hashes nothing and still answers
+dop_hash_files("${CACHE_FILE}" 3 ${SOURCES})
+expect_hashed("")
+expect_hashes(${SOURCES})
+
+# A change in size or mtime is rehashed, and only that file
+write_source("unit_2.c" "int unit_2(void) { return 22; }\n" 1000000000)
+write_source("unit_5.c" "int unit_5(void) { return 6; }\n" 1000000100)
+dop_hash_files("${CACHE_FILE}" 2 ${SOURCES})
+expect_hashed("${WORK_DIR}/src/unit_2.c;${WORK_DIR}/src/unit_5.c")
+expect_hashes(${SOURCES})
+
+# A file modified in the current second is hashed again next run
+file(WRITE "${WORK_DIR}/src/unit_3.c" "int unit_3(void) { return 33; }\n")
+dop_hash_files("${CACHE_FILE}" 1 ${SOURCES})
+expect_hashed("${WORK_DIR}/src/unit_3.c")
+dop_hash_files("${CACHE_FILE}" 1 ${SOURCES})
+expect_hashed("${WORK_DIR}/src/unit_3.c")
+expect_hashes(${SOURCES})
+write_source("unit_3.c" "int unit_3(void) { return 33; }\n" 1000000000)
+
+# Files outside a run keep their entries; missing files get none
+list(GET SOURCES 0 FIRST_SOURCE)
+dop_hash_files("${CACHE_FILE}" 1 "${FIRST_SOURCE}" "${WORK_DIR}/src/missing.c")
+expect_hashed("")
+dop_hash_key(MISSING_KEY "${WORK_DIR}/src/missing.c")
+if(DEFINED DOP_HASH_${MISSING_KEY})
+    message(FATAL_ERROR "A missing file was given a hash")
+endif()
+file(STRINGS "${CACHE_FILE}" CACHE_LINES)
+list(LENGTH CACHE_LINES CACHE_ENTRIES)
+list(LENGTH SOURCES SOURCE_COUNT)
+if(NOT CACHE_ENTRIES EQUAL SOURCE_COUNT)
+    message(FATAL_ERROR "Cache holds ${CACHE_ENTRIES} entries, expected ${SOURCE_COUNT}")
+endif()
+dop_hash_files("${CACHE_FILE}" 4 ${SOURCES})
+expect_hashed("${WORK_DIR}/src/unit_3.c")
+
+message(STATUS "Hash cache test passed")
+
+message(STATUS "Testing incremental scripts...")
+
+# Run a script, returning its exit code and output
+function(run_script OUT_RESULT OUT_OUTPUT SCRIPT)
+    execute_process(COMMAND "${CMAKE_COMMAND}" ${ARGN} -P "${SCRIPTS_DIR}/${SCRIPT}"
+                    RESULT_VARIABLE RESULT OUTPUT_VARIABLE OUTPUT ERROR_VARIABLE OUTPUT)
+    set(${OUT_RESULT} "${RESULT}" PARENT_SCOPE)
+    set(${OUT_OUTPUT} "${OUTPUT}" PARENT_SCOPE)
+endfunction()
+
+function(expect_output OUTPUT PATTERN)
+    if(NOT OUTPUT MATCHES "${PATTERN}")
+        message(FATAL_ERROR "Output lacks \"${PATTERN}\":\n${OUTPUT}")
+    endif()
+endfunction()
+
+set(SOURCE_LIST "")
+foreach(INDEX RANGE 1 6)
+    list(APPEND SOURCE_LIST "src/unit_${INDEX}.c")
+endforeach()
+string(REPLACE ";" "," SOURCE_LIST "${SOURCE_LIST}")
+file(MAKE_DIRECTORY "${WORK_DIR}/build")
+file(WRITE "${WORK_DIR}/build/gov_clock" "artifact\n")
+set(MANIFEST_ARGS -DTARGET_NAME=gov_clock "-DSOURCE_FILES=${SOURCE_LIST}"
+    "-DSOURCE_DIR=${WORK_DIR}" "-DMANIFEST_FILE=${WORK_DIR}/build/manifest.xml")
+set(VALIDATE_ARGS -DTARGET_NAME=gov_clock "-DSOURCE_DIR=${WORK_DIR}" "-DBUILD_DIR=${WORK_DIR}/build"
+    "-DMANIFEST_FILE=${WORK_DIR}/build/manifest.xml")
+
+# The incremental manifest carries the same checksums as a full one
+run_script(RESULT OUTPUT generate_manifest.cmake ${MANIFEST_ARGS})
+file(READ "${WORK_DIR}/build/manifest.xml" FULL_MANIFEST)
+string(REGEX MATCHALL "<dop:checksum_sha256>[0-9a-f]+</dop:checksum_sha256>" FULL_CHECKSUMS "${FULL_MANIFEST}")
+list(LENGTH FULL_CHECKSUMS FULL_COUNT)
+if(NOT RESULT EQUAL 0 OR NOT FULL_COUNT EQUAL 6)
+    message(FATAL_ERROR "Full manifest failed:\n${OUTPUT}")
+endif()
+foreach(PASS cold warm)
+    run_script(RESULT OUTPUT generate_manifest.cmake ${MANIFEST_ARGS} -DINCREMENTAL=ON -DJOBS=2)
+    if(PASS STREQUAL "cold")
+        expect_output("${OUTPUT}" "Incremental manifest: 6 of 6 sources rehashed")
+    else()
+        expect_output("${OUTPUT}" "Incremental manifest: 0 of 6 sources rehashed")
+    endif()
+    file(READ "${WORK_DIR}/build/manifest.xml" MANIFEST)
+    string(REGEX MATCHALL "<dop:checksum_sha256>[0-9a-f]+</dop:checksum_sha256>" CHECKSUMS "${MANIFEST}")
+    if(NOT "${CHECKSUMS}" STREQUAL "${FULL_CHECKSUMS}")
+        message(FATAL_ERROR "Incremental manifest checksums differ:\n${CHECKSUMS}")
+    endif()
+endforeach()
+
+# Validation against that manifest rehashes nothing, then catches a change
+run_script(RESULT OUTPUT validate_source_to_build.cmake ${VALIDATE_ARGS} -DINCREMENTAL=ON -DJOBS=2)
+expect_output("${OUTPUT}" "Incremental validation: 0 of 6 sources changed")
+expect_output("${OUTPUT}" "Source-to-build validation: PASSED")
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Validation failed:\n${OUTPUT}")
+endif()
+write_source("unit_4.c" "int unit_4(void) { return 44; }\n" 1000000000)
+run_script(RESULT OUTPUT validate_source_to_build.cmake ${VALIDATE_ARGS} -DINCREMENTAL=ON -DJOBS=2)
+expect_output("${OUTPUT}" "Incremental validation: 1 of 6 sources changed")
+expect_output("${OUTPUT}" "src/unit_4.c: Checksum mismatch")
+if(RESULT EQUAL 0)
+    message(FATAL_ERROR "Validation passed a changed source")
+endif()
+
+message(STATUS "Incremental script test passed")
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+message(STATUS "All validation cache tests passed!")
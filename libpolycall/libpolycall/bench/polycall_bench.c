@@ -0,0 +1,941 @@
+// polycall_bench.c - Load generator and latency benchmark for the polycall protocol
+//
+// Opens connections to an echo server (built in, or another polycall-bench
+// running with -S), takes each through the handshake and authentication,
+// then drives commands from a size mix. Closed loop keeps a fixed number
+// of commands in flight per connection; open loop sends at a fixed total
+// rate and measures from when each command was due, so a stalled server
+// shows up in the latencies instead of slowing the load down.
+#include "polycall.h"
+#include "polycall_log.h"
+#include "polycall_protocol.h"
+#include "network.h"
+#include <getopt.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#define BENCH_MIX_MAX 16            // Entries in a command mix
+#define BENCH_INFLIGHT 4096         // Commands in flight per connection (power of two)
+#define BENCH_SETUP_TIMEOUT_NS (5 * 1000000000ull)
+#define BENCH_RECV_SIZE 65536
+
+// Latencies in nanoseconds, log-linear like HdrHistogram: each power of
+// two is split into HIST_SUB / 2 equal steps, so a recorded value is off
+// by less than 1 percent
+#define HIST_SUB_BITS 8
+#define HIST_SUB (1u << HIST_SUB_BITS)
+#define HIST_HALF (HIST_SUB / 2)
+#define HIST_SIZE ((64 - HIST_SUB_BITS + 1) * HIST_HALF + HIST_HALF)
+#define HIST_TICKS_PER_HALF 5       // Percentile rows per halving of the tail
+
+typedef struct {
+    uint64_t counts[HIST_SIZE];
+    uint64_t total;
+    uint64_t max;
+    double sum;
+    double sum_squares;
+} Histogram;
+
+typedef struct {
+    size_t size;                    // Payload bytes
+    uint32_t weight;
+} MixEntry;
+
+typedef struct {
+    size_t connections;
+    size_t threads;
+    double duration;                // Measured seconds
+    double warmup;                  // Seconds run before measuring
+    size_t depth;                   // Closed loop: commands in flight per connection
+    double rate;                    // Open loop: commands per second in total, 0 for closed
+    MixEntry mix[BENCH_MIX_MAX];
+    size_t mix_count;
+    uint64_t mix_weight;
+    size_t max_size;
+    NetworkEventBackend backend;    // Built-in server
+    const char* host;               // External server, NULL for the built-in one
+    uint16_t port;
+    const char* unix_path;          // Unix socket instead of TCP
+    uint16_t capabilities;          // Offered by the clients
+    bool serve_only;
+} BenchOptions;
+
+typedef struct {
+    uint32_t sequence;              // 0 when the slot is free
+    uint32_t size;
+    uint64_t sent_ns;               // When it was due (open loop) or sent
+} Inflight;
+
+typedef struct BenchThread BenchThread;
+
+typedef struct {
+    BenchThread* thread;
+    NetworkEndpoint endpoint;
+    polycall_protocol_context_t protocol;
+    bool handshake_seen;
+    bool ready;
+    bool closed;
+    Inflight inflight[BENCH_INFLIGHT];
+    size_t outstanding;
+    uint64_t next_due_ns;           // Open loop schedule
+} BenchConnection;
+
+struct BenchThread {
+    const BenchOptions* options;
+    pthread_t id;
+    BenchConnection* connections;
+    size_t count;
+    BenchConnection** by_fd;        // Connection for a descriptor
+    size_t fd_capacity;
+    NetworkEventLoop* events;
+    NetworkBuffer* receive;
+    uint8_t* payload;
+    uint64_t random;
+    uint64_t interval_ns;           // Open loop gap per connection
+    Histogram histogram;
+    uint64_t completed;             // Measured responses
+    uint64_t errors;
+    uint64_t setup_ns;              // Connect to authenticated, summed
+    uint64_t cpu_ns;                // Thread CPU over the measured window
+    bool failed;
+};
+
+// Shared by the threads, written by main before the start barrier
+static polycall_context_t bench_context;
+static pthread_barrier_t bench_ready;
+static pthread_barrier_t bench_start;
+static uint64_t measure_from_ns;
+static uint64_t measure_until_ns;
+static bool bench_abort;
+static volatile sig_atomic_t bench_stop;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t process_cpu_ns(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + (uint64_t)usage.ru_stime.tv_sec) * 1000000000ull +
+           ((uint64_t)usage.ru_utime.tv_usec + (uint64_t)usage.ru_stime.tv_usec) * 1000ull;
+}
+
+/* Histogram */
+
+static size_t hist_index(uint64_t value) {
+    if (value < HIST_SUB) return (size_t)value;
+    unsigned shift = (unsigned)(63 - __builtin_clzll(value)) - (HIST_SUB_BITS - 1);
+    return (size_t)shift * HIST_HALF + (size_t)(value >> shift);
+}
+
+// Largest value that lands in the same slot
+static uint64_t hist_value(size_t index) {
+    if (index < HIST_SUB) return index;
+    unsigned shift = (unsigned)(index / HIST_HALF) - 1;
+    uint64_t mantissa = index - (size_t)shift * HIST_HALF;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+static void hist_record(Histogram* hist, uint64_t value) {
+    hist->counts[hist_index(value)]++;
+    hist->total++;
+    if (value > hist->max) hist->max = value;
+    hist->sum += (double)value;
+    hist->sum_squares += (double)value * (double)value;
+}
+
+static void hist_merge(Histogram* into, const Histogram* from) {
+    for (size_t i = 0; i < HIST_SIZE; i++) into->counts[i] += from->counts[i];
+    into->total += from->total;
+    if (from->max > into->max) into->max = from->max;
+    into->sum += from->sum;
+    into->sum_squares += from->sum_squares;
+}
+
+// Value at a percentile, with the number of samples at or below it
+static uint64_t hist_percentile(const Histogram* hist, double percentile, uint64_t* below) {
+    uint64_t target = (uint64_t)(percentile / 100.0 * (double)hist->total + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HIST_SIZE; i++) {
+        seen += hist->counts[i];
+        if (seen >= target) {
+            if (below) *below = seen;
+            uint64_t value = hist_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+    if (below) *below = hist->total;
+    return hist->max;
+}
+
+// Percentile rows get denser toward the tail, HIST_TICKS_PER_HALF for each
+// halving of what is left, in the layout HdrHistogram prints
+static void hist_print(const Histogram* hist, FILE* out) {
+    fprintf(out, "%12s %14s %10s %14s\n\n", "Value(us)", "Percentile", "TotalCount",
+            "1/(1-Percentile)");
+    if (hist->total == 0) return;
+
+    double percentile = 0.0;
+    for (;;) {
+        uint64_t below;
+        uint64_t value = hist_percentile(hist, percentile, &below);
+        if (below >= hist->total) break;
+        fprintf(out, "%12.3f %14.12f %10llu %14.2f\n", value / 1000.0, percentile / 100.0,
+                (unsigned long long)below, 1.0 / (1.0 - percentile / 100.0));
+
+        double ticks = HIST_TICKS_PER_HALF;
+        for (double left = 100.0 - percentile; left <= 50.0; left *= 2.0) ticks *= 2.0;
+        percentile += 100.0 / (ticks * 2.0);
+    }
+    fprintf(out, "%12.3f %14.12f %10llu\n", hist->max / 1000.0, 1.0,
+            (unsigned long long)hist->total);
+
+    double mean = hist->sum / (double)hist->total;
+    double variance = hist->sum_squares / (double)hist->total - mean * mean;
+    double deviation = 0.0;
+    if (variance > 0.0) {
+        // Newton's method, to keep libm out of the link
+        deviation = variance;
+        for (int i = 0; i < 64; i++) deviation = 0.5 * (deviation + variance / deviation);
+    }
+    fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean / 1000.0, deviation / 1000.0);
+    fprintf(out, "#[Max     = %12.3f, Total count    = %12llu]\n", hist->max / 1000.0,
+            (unsigned long long)hist->total);
+    fprintf(out, "#[Buckets = %12d, SubBuckets     = %12u]\n", 64 - HIST_SUB_BITS + 1, HIST_SUB);
+}
+
+/* Built-in echo server */
+
+typedef struct {
+    NetworkEndpoint endpoint;       // Outlives the handler's copy
+    polycall_protocol_context_t protocol;
+} ServerConnection;
+
+static NetworkProgram server_program;
+static ServerConnection** server_connections;
+static size_t server_capacity;
+static _Atomic uint64_t server_errors;
+static volatile bool server_stop;
+
+static void server_on_handshake(polycall_protocol_context_t* ctx) {
+    polycall_protocol_complete_handshake(ctx);
+}
+
+static void server_on_command(polycall_protocol_context_t* ctx, const char* command, size_t length) {
+    // A short write leaves the stream cut mid-frame, so the connection is done
+    if (!polycall_protocol_respond(ctx, ctx->current_sequence, command, length)) {
+        atomic_fetch_add_explicit(&server_errors, 1, memory_order_relaxed);
+        shutdown(ctx->endpoint->socket_fd, SHUT_RDWR);
+    }
+}
+
+static void server_on_connect(NetworkEndpoint* endpoint) {
+    int fd = endpoint->socket_fd;
+    if ((size_t)fd >= server_capacity) {
+        size_t capacity = server_capacity ? server_capacity : 256;
+        while (capacity <= (size_t)fd) capacity *= 2;
+        ServerConnection** grown = realloc(server_connections, capacity * sizeof(*grown));
+        if (!grown) {
+            shutdown(fd, SHUT_RDWR);
+            return;
+        }
+        memset(grown + server_capacity, 0, (capacity - server_capacity) * sizeof(*grown));
+        server_connections = grown;
+        server_capacity = capacity;
+    }
+
+    ServerConnection* connection = calloc(1, sizeof(*connection));
+    if (!connection) {
+        shutdown(fd, SHUT_RDWR);
+        return;
+    }
+    connection->endpoint = *endpoint;
+    polycall_protocol_config_t config = {
+        .callbacks = {
+            .on_handshake = server_on_handshake,
+            .on_command = server_on_command
+        },
+        .capabilities = POLYCALL_CAP_PIPELINE | POLYCALL_CAP_BATCH | POLYCALL_CAP_CRC32C |
+                        POLYCALL_CAP_LOCAL_UNCHECKED
+    };
+    if (!polycall_protocol_init(&connection->protocol, bench_context, &connection->endpoint, &config)) {
+        free(connection);
+        shutdown(fd, SHUT_RDWR);
+        return;
+    }
+    server_connections[fd] = connection;
+    polycall_protocol_start_handshake(&connection->protocol);
+}
+
+static void server_on_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    int fd = endpoint->socket_fd;
+    ServerConnection* connection = (size_t)fd < server_capacity ? server_connections[fd] : NULL;
+    if (!connection) return;
+    if (!polycall_protocol_process_packet(&connection->protocol, packet)) {
+        atomic_fetch_add_explicit(&server_errors, 1, memory_order_relaxed);
+        shutdown(fd, SHUT_RDWR);
+    }
+}
+
+static void server_on_disconnect(NetworkEndpoint* endpoint) {
+    int fd = endpoint->socket_fd;
+    ServerConnection* connection = (size_t)fd < server_capacity ? server_connections[fd] : NULL;
+    if (!connection) return;
+    server_connections[fd] = NULL;
+    polycall_protocol_cleanup(&connection->protocol);
+    free(connection);
+}
+
+static bool server_start(const BenchOptions* options) {
+    if (options->unix_path) {
+        net_init_program_unix(&server_program, options->backend, NET_UNIX, options->unix_path);
+    } else if (options->port) {
+        net_init_program_shared(&server_program, options->backend, options->port);
+    } else {
+        net_init_program_with_backend(&server_program, options->backend);
+    }
+    if (!server_program.endpoints || server_program.count == 0) return false;
+
+    server_program.handlers.on_connect = server_on_connect;
+    server_program.handlers.on_receive = server_on_receive;
+    server_program.handlers.on_disconnect = server_on_disconnect;
+    return true;
+}
+
+static const char* server_backend_name(void) {
+    if (server_program.uring) return net_event_backend_name(NET_EVENT_URING);
+    return net_event_backend_name(net_event_backend(server_program.events));
+}
+
+static void* server_main(void* arg) {
+    (void)arg;
+    while (!server_stop) net_run(&server_program);
+    return NULL;
+}
+
+static void server_stop_and_cleanup(pthread_t thread) {
+    server_stop = true;
+    pthread_join(thread, NULL);
+    for (size_t i = 0; i < server_capacity; i++) {
+        if (server_connections[i]) {
+            polycall_protocol_cleanup(&server_connections[i]->protocol);
+            free(server_connections[i]);
+        }
+    }
+    free(server_connections);
+    server_connections = NULL;
+    server_capacity = 0;
+    net_cleanup_program(&server_program);
+}
+
+/* Clients */
+
+static uint64_t next_random(BenchThread* thread) {
+    uint64_t x = thread->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    thread->random = x;
+    return x;
+}
+
+static size_t pick_size(BenchThread* thread) {
+    const BenchOptions* options = thread->options;
+    uint64_t point = next_random(thread) % options->mix_weight;
+    for (size_t i = 0; i < options->mix_count; i++) {
+        if (point < options->mix[i].weight) return options->mix[i].size;
+        point -= options->mix[i].weight;
+    }
+    return options->mix[0].size;
+}
+
+// due is when the command should have gone out
+static void send_command(BenchConnection* connection, uint64_t due) {
+    BenchThread* thread = connection->thread;
+    if (connection->closed || connection->outstanding >= BENCH_INFLIGHT) return;
+
+    size_t size = pick_size(thread);
+    uint32_t sequence = polycall_protocol_send_command(&connection->protocol, thread->payload, size);
+    if (sequence == 0) {
+        thread->errors++;
+        connection->closed = true;
+        return;
+    }
+    Inflight* slot = &connection->inflight[sequence & (BENCH_INFLIGHT - 1)];
+    slot->sequence = sequence;
+    slot->size = (uint32_t)size;
+    slot->sent_ns = due;
+    connection->outstanding++;
+}
+
+static void client_on_handshake(polycall_protocol_context_t* ctx) {
+    BenchConnection* connection = ctx->user_data;
+    connection->handshake_seen = true;
+}
+
+static void client_on_response(polycall_protocol_context_t* ctx, uint32_t sequence,
+                               const char* response, size_t length) {
+    (void)response;
+    BenchConnection* connection = ctx->user_data;
+    BenchThread* thread = connection->thread;
+    Inflight* slot = &connection->inflight[sequence & (BENCH_INFLIGHT - 1)];
+    if (slot->sequence != sequence) {
+        thread->errors++;
+        return;
+    }
+
+    uint64_t now = now_ns();
+    if (length != slot->size) thread->errors++;
+    if (slot->sent_ns >= measure_from_ns && now <= measure_until_ns) {
+        hist_record(&thread->histogram, now - slot->sent_ns);
+        thread->completed++;
+    }
+    slot->sequence = 0;
+    connection->outstanding--;
+
+    if (thread->options->rate == 0 && now < measure_until_ns) send_command(connection, now);
+}
+
+static int connect_tcp(const char* host, uint16_t port) {
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* found = NULL;
+    if (getaddrinfo(host, service, &hints, &found) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo* ai = found; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if (fd >= 0) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return fd;
+}
+
+// Sends stay blocking so a frame always goes out whole; reads use
+// MSG_DONTWAIT to drain edge-triggered readiness
+static bool open_connection(BenchThread* thread, BenchConnection* connection) {
+    const BenchOptions* options = thread->options;
+    connection->thread = thread;
+    if (options->unix_path) {
+        connection->endpoint.protocol = NET_UNIX;
+        connection->endpoint.role = NET_CLIENT;
+        snprintf(connection->endpoint.path, sizeof(connection->endpoint.path), "%s",
+                 options->unix_path);
+        if (!net_init(&connection->endpoint)) return false;
+    } else {
+        connection->endpoint.socket_fd = connect_tcp(options->host, options->port);
+        if (connection->endpoint.socket_fd < 0) return false;
+    }
+
+    int fd = connection->endpoint.socket_fd;
+    if ((size_t)fd >= thread->fd_capacity) {
+        size_t capacity = thread->fd_capacity ? thread->fd_capacity : 256;
+        while (capacity <= (size_t)fd) capacity *= 2;
+        BenchConnection** grown = realloc(thread->by_fd, capacity * sizeof(*grown));
+        if (!grown) return false;
+        memset(grown + thread->fd_capacity, 0, (capacity - thread->fd_capacity) * sizeof(*grown));
+        thread->by_fd = grown;
+        thread->fd_capacity = capacity;
+    }
+    thread->by_fd[fd] = connection;
+
+    polycall_protocol_config_t config = {
+        .callbacks = {
+            .on_handshake = client_on_handshake,
+            .on_response = client_on_response
+        },
+        .user_data = connection,
+        .capabilities = options->capabilities
+    };
+    return polycall_protocol_init(&connection->protocol, bench_context, &connection->endpoint, &config) &&
+           net_event_add(thread->events, fd) &&
+           polycall_protocol_start_handshake(&connection->protocol);
+}
+
+static void drain_connection(BenchThread* thread, BenchConnection* connection) {
+    NetworkBuffer* buffer = thread->receive;
+    for (;;) {
+        ssize_t received = recv(connection->endpoint.socket_fd, buffer->data, buffer->capacity,
+                                MSG_DONTWAIT);
+        if (received > 0) {
+            NetworkPacket packet = {
+                .data = buffer->data,
+                .size = (size_t)received,
+                .buffer = buffer
+            };
+            if (!polycall_protocol_process_packet(&connection->protocol, &packet)) {
+                thread->errors++;
+                connection->closed = true;
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            if (!connection->closed) thread->errors++;
+            connection->closed = true;
+        }
+        return;
+    }
+}
+
+static void poll_connections(BenchThread* thread, int timeout_ms) {
+    NetworkEvent events[NET_EVENT_BATCH];
+    int ready = net_event_wait(thread->events, events, timeout_ms);
+    for (int i = 0; i < ready; i++) {
+        int fd = events[i].fd;
+        BenchConnection* connection = (size_t)fd < thread->fd_capacity ? thread->by_fd[fd] : NULL;
+        if (connection && !connection->closed) drain_connection(thread, connection);
+    }
+}
+
+// Connect and authenticate every connection of the thread
+static bool setup_connections(BenchThread* thread) {
+    uint64_t started = now_ns();
+    for (size_t i = 0; i < thread->count; i++) {
+        if (!open_connection(thread, &thread->connections[i])) {
+            fprintf(stderr, "polycall-bench: connection %zu failed: %s\n", i, strerror(errno));
+            return false;
+        }
+    }
+
+    size_t ready = 0;
+    while (ready < thread->count) {
+        if (now_ns() - started > BENCH_SETUP_TIMEOUT_NS) {
+            fprintf(stderr, "polycall-bench: handshake timed out (%zu of %zu done)\n",
+                    ready, thread->count);
+            return false;
+        }
+        poll_connections(thread, 10);
+        for (size_t i = 0; i < thread->count; i++) {
+            BenchConnection* connection = &thread->connections[i];
+            if (connection->ready || !connection->handshake_seen) continue;
+            if (connection->closed ||
+                !polycall_protocol_complete_handshake(&connection->protocol) ||
+                !polycall_protocol_authenticate(&connection->protocol, "polycall-bench", 14)) {
+                fprintf(stderr, "polycall-bench: authentication failed: %s\n",
+                        polycall_protocol_get_error(&connection->protocol));
+                return false;
+            }
+            connection->ready = true;
+            ready++;
+        }
+    }
+    thread->setup_ns = (now_ns() - started) * thread->count;
+    return true;
+}
+
+static void run_load(BenchThread* thread) {
+    const BenchOptions* options = thread->options;
+    uint64_t start = now_ns();
+    bool open_loop = options->rate > 0;
+
+    // Spread the open-loop schedule so the connections do not fire together
+    for (size_t i = 0; i < thread->count; i++) {
+        BenchConnection* connection = &thread->connections[i];
+        if (open_loop) {
+            connection->next_due_ns = start + thread->interval_ns * i / thread->count;
+        } else {
+            for (size_t d = 0; d < options->depth; d++) send_command(connection, now_ns());
+        }
+    }
+
+    uint64_t cpu_from = 0;
+    bool measuring = false;
+    for (;;) {
+        uint64_t now = now_ns();
+        if (!measuring && now >= measure_from_ns) {
+            cpu_from = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+            measuring = true;
+        }
+        if (now >= measure_until_ns) break;
+
+        uint64_t wake = measure_until_ns;
+        if (open_loop) {
+            for (size_t i = 0; i < thread->count; i++) {
+                BenchConnection* connection = &thread->connections[i];
+                while (connection->next_due_ns <= now && !connection->closed &&
+                       connection->outstanding < BENCH_INFLIGHT) {
+                    send_command(connection, connection->next_due_ns);
+                    connection->next_due_ns += thread->interval_ns;
+                }
+                if (connection->next_due_ns < wake) wake = connection->next_due_ns;
+            }
+        } else if (wake > now + 100000000ull) {
+            wake = now + 100000000ull;
+        }
+        if (!measuring && wake > measure_from_ns) wake = measure_from_ns;
+
+        int timeout_ms = wake > now ? (int)((wake - now) / 1000000ull) : 0;
+        poll_connections(thread, timeout_ms);
+    }
+    thread->cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_from;
+}
+
+static void* client_main(void* arg) {
+    BenchThread* thread = arg;
+    thread->failed = !setup_connections(thread);
+    pthread_barrier_wait(&bench_ready);
+    pthread_barrier_wait(&bench_start);
+    if (!bench_abort) run_load(thread);
+    return NULL;
+}
+
+static void close_connections(BenchThread* thread) {
+    for (size_t i = 0; i < thread->count; i++) {
+        BenchConnection* connection = &thread->connections[i];
+        if (connection->protocol.internal) polycall_protocol_cleanup(&connection->protocol);
+        if (connection->endpoint.socket_fd > 0) {
+            net_event_remove(thread->events, connection->endpoint.socket_fd);
+            close(connection->endpoint.socket_fd);
+        }
+    }
+    net_event_destroy(thread->events);
+    net_buffer_release(thread->receive);
+    free(thread->payload);
+    free(thread->by_fd);
+    free(thread->connections);
+}
+
+/* Options */
+
+static void usage(FILE* out) {
+    fprintf(out,
+        "Usage: polycall-bench [options]\n"
+        "  -c N          connections (default 16)\n"
+        "  -t N          client threads (default 1)\n"
+        "  -d SECONDS    measured duration (default 10)\n"
+        "  -w SECONDS    warmup before measuring (default 1)\n"
+        "  -p N          closed loop: commands in flight per connection (default 1)\n"
+        "  -r RATE       open loop: commands per second over all connections\n"
+        "  -m MIX        payload sizes and weights, SIZE[:WEIGHT],... (default 64)\n"
+        "                sizes take a k or m suffix, e.g. 64:90,4k:9,64k:1\n"
+        "  -k MASK       capabilities the clients offer (default 0x1, pipelining)\n"
+        "  -b BACKEND    built-in server backend: auto, epoll, kqueue, select, io_uring\n"
+        "  -a HOST:PORT  use the server at HOST:PORT instead of the built-in one\n"
+        "  -U PATH       connect over a Unix socket at PATH\n"
+        "  -S            only run the echo server (on -a's port or -U's path)\n"
+        "  -v            log protocol warnings\n");
+}
+
+static bool parse_size(const char* text, size_t* size, char** end) {
+    unsigned long long value = strtoull(text, end, 10);
+    if (*end == text) return false;
+    if (**end == 'k' || **end == 'K') {
+        value *= 1024;
+        (*end)++;
+    } else if (**end == 'm' || **end == 'M') {
+        value *= 1024 * 1024;
+        (*end)++;
+    }
+    *size = (size_t)value;
+    return value > 0 && value <= POLYCALL_PROTOCOL_DEFAULT_MAX_MESSAGE;
+}
+
+static bool parse_mix(BenchOptions* options, const char* text) {
+    options->mix_count = 0;
+    options->mix_weight = 0;
+    options->max_size = 0;
+    while (*text) {
+        if (options->mix_count == BENCH_MIX_MAX) return false;
+        MixEntry* entry = &options->mix[options->mix_count];
+        char* end;
+        if (!parse_size(text, &entry->size, &end)) return false;
+        entry->weight = 1;
+        if (*end == ':') {
+            entry->weight = (uint32_t)strtoul(end + 1, &end, 10);
+            if (entry->weight == 0) return false;
+        }
+        if (*end != ',' && *end != '\0') return false;
+        options->mix_weight += entry->weight;
+        if (entry->size > options->max_size) options->max_size = entry->size;
+        options->mix_count++;
+        text = *end ? end + 1 : end;
+    }
+    return options->mix_count > 0;
+}
+
+static bool parse_backend(const char* name, NetworkEventBackend* backend) {
+    for (int i = 0; i < NET_EVENT_BACKEND_MAX; i++) {
+        if (strcmp(name, net_event_backend_name((NetworkEventBackend)i)) == 0) {
+            *backend = (NetworkEventBackend)i;
+            return true;
+        }
+    }
+    if (strcmp(name, "uring") == 0) {
+        *backend = NET_EVENT_URING;
+        return true;
+    }
+    return false;
+}
+
+static bool parse_address(BenchOptions* options, char* text) {
+    char* colon = strrchr(text, ':');
+    if (!colon) return false;
+    *colon = '\0';
+    long port = strtol(colon + 1, NULL, 10);
+    if (port <= 0 || port > 65535) return false;
+    options->host = *text ? text : "127.0.0.1";
+    options->port = (uint16_t)port;
+    return true;
+}
+
+static bool parse_options(BenchOptions* options, int argc, char** argv) {
+    *options = (BenchOptions){
+        .connections = 16,
+        .threads = 1,
+        .duration = 10.0,
+        .warmup = 1.0,
+        .depth = 1,
+        .backend = NET_EVENT_AUTO,
+        .capabilities = POLYCALL_CAP_PIPELINE
+    };
+    parse_mix(options, "64");
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:t:d:w:p:r:m:k:b:a:U:Svh")) != -1) {
+        switch (opt) {
+            case 'c': options->connections = strtoul(optarg, NULL, 10); break;
+            case 't': options->threads = strtoul(optarg, NULL, 10); break;
+            case 'd': options->duration = strtod(optarg, NULL); break;
+            case 'w': options->warmup = strtod(optarg, NULL); break;
+            case 'p': options->depth = strtoul(optarg, NULL, 10); break;
+            case 'r': options->rate = strtod(optarg, NULL); break;
+            case 'k': options->capabilities = (uint16_t)strtoul(optarg, NULL, 0); break;
+            case 'U': options->unix_path = optarg; break;
+            case 'S': options->serve_only = true; break;
+            case 'v': polycall_log_set_level(POLYCALL_LOG_LEVEL_WARN); break;
+            case 'm':
+                if (!parse_mix(options, optarg)) {
+                    fprintf(stderr, "polycall-bench: bad mix '%s'\n", optarg);
+                    return false;
+                }
+                break;
+            case 'b':
+                if (!parse_backend(optarg, &options->backend)) {
+                    fprintf(stderr, "polycall-bench: unknown backend '%s'\n", optarg);
+                    return false;
+                }
+                break;
+            case 'a':
+                if (!parse_address(options, optarg)) {
+                    fprintf(stderr, "polycall-bench: bad address, expected HOST:PORT\n");
+                    return false;
+                }
+                break;
+            case 'h':
+                usage(stdout);
+                exit(0);
+            default:
+                usage(stderr);
+                return false;
+        }
+    }
+
+    if (options->connections == 0 || options->threads == 0 || options->duration <= 0 ||
+        options->warmup < 0 || options->depth == 0 || options->depth > BENCH_INFLIGHT ||
+        options->rate < 0) {
+        fprintf(stderr, "polycall-bench: invalid option value\n");
+        return false;
+    }
+    if (options->threads > options->connections) options->threads = options->connections;
+    options->capabilities |= POLYCALL_CAP_PIPELINE;     // Responses are matched by sequence
+    options->capabilities &= ~POLYCALL_CAP_SHARED_MEMORY;
+    return true;
+}
+
+/* Main */
+
+static void on_signal(int signal_number) {
+    (void)signal_number;
+    bench_stop = 1;
+}
+
+static int serve(const BenchOptions* options) {
+    if (!server_start(options)) {
+        fprintf(stderr, "polycall-bench: cannot start the server\n");
+        return 1;
+    }
+    if (options->unix_path) {
+        printf("polycall-bench: serving on %s (%s)\n", options->unix_path, server_backend_name());
+    } else {
+        printf("polycall-bench: serving on port %u (%s)\n", server_program.endpoints[0].port,
+               server_backend_name());
+    }
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    pthread_t thread;
+    pthread_create(&thread, NULL, server_main, NULL);
+    while (!bench_stop) pause();
+    server_stop_and_cleanup(thread);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    polycall_log_set_level(POLYCALL_LOG_LEVEL_ERROR);
+    BenchOptions options;
+    if (!parse_options(&options, argc, argv)) return 2;
+
+    polycall_config_t config = {0};
+    if (polycall_init_with_config(&bench_context, &config) != POLYCALL_SUCCESS) {
+        fprintf(stderr, "polycall-bench: cannot initialize libpolycall\n");
+        return 1;
+    }
+    if (options.serve_only) {
+        int status = serve(&options);
+        polycall_cleanup(bench_context);
+        return status;
+    }
+
+    // Built-in server unless one was named
+    bool builtin = !options.host;
+    pthread_t server_thread;
+    clockid_t server_clock;
+    if (builtin) {
+        if (!server_start(&options)) {
+            fprintf(stderr, "polycall-bench: cannot start the server\n");
+            return 1;
+        }
+        options.host = "127.0.0.1";
+        options.port = server_program.endpoints[0].port;
+        pthread_create(&server_thread, NULL, server_main, NULL);
+        if (pthread_getcpuclockid(server_thread, &server_clock) != 0) builtin = false;
+    }
+
+    BenchThread* threads = calloc(options.threads, sizeof(*threads));
+    if (!threads) return 1;
+    pthread_barrier_init(&bench_ready, NULL, (unsigned)options.threads + 1);
+    pthread_barrier_init(&bench_start, NULL, (unsigned)options.threads + 1);
+
+    // Connections are dealt out as evenly as they go
+    for (size_t i = 0; i < options.threads; i++) {
+        BenchThread* thread = &threads[i];
+        thread->options = &options;
+        thread->count = options.connections / options.threads +
+                        (i < options.connections % options.threads ? 1 : 0);
+        thread->connections = calloc(thread->count, sizeof(BenchConnection));
+        thread->events = net_event_create(NET_EVENT_AUTO);
+        thread->receive = net_buffer_alloc(NULL, BENCH_RECV_SIZE);
+        thread->payload = malloc(options.max_size);
+        thread->random = 0x9E3779B97F4A7C15ull * (i + 1);
+        if (options.rate > 0) {
+            thread->interval_ns = (uint64_t)(1e9 * (double)thread->count / options.rate);
+            if (thread->interval_ns == 0) thread->interval_ns = 1;
+        }
+        if (!thread->connections || !thread->events || !thread->receive || !thread->payload) {
+            fprintf(stderr, "polycall-bench: out of memory\n");
+            return 1;
+        }
+        memset(thread->payload, 'x', options.max_size);
+        pthread_create(&thread->id, NULL, client_main, thread);
+    }
+
+    pthread_barrier_wait(&bench_ready);
+    for (size_t i = 0; i < options.threads; i++) bench_abort |= threads[i].failed;
+    uint64_t start = now_ns();
+    measure_from_ns = start + (uint64_t)(options.warmup * 1e9);
+    measure_until_ns = measure_from_ns + (uint64_t)(options.duration * 1e9);
+    pthread_barrier_wait(&bench_start);
+
+    // Sample the server and the whole process over the measured window
+    uint64_t server_cpu = 0, process_cpu = 0;
+    if (!bench_abort) {
+        struct timespec pause_until = {
+            .tv_sec = (time_t)(measure_from_ns / 1000000000ull),
+            .tv_nsec = (long)(measure_from_ns % 1000000000ull)
+        };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &pause_until, NULL);
+        if (builtin) server_cpu = clock_ns(server_clock);
+        process_cpu = process_cpu_ns();
+        pause_until.tv_sec = (time_t)(measure_until_ns / 1000000000ull);
+        pause_until.tv_nsec = (long)(measure_until_ns % 1000000000ull);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &pause_until, NULL);
+        if (builtin) server_cpu = clock_ns(server_clock) - server_cpu;
+        process_cpu = process_cpu_ns() - process_cpu;
+    }
+
+    Histogram* total = calloc(1, sizeof(Histogram));
+    uint64_t completed = 0, errors = 0, client_cpu = 0, setup_ns = 0;
+    uint16_t capabilities = 0;
+    for (size_t i = 0; i < options.threads; i++) {
+        BenchThread* thread = &threads[i];
+        pthread_join(thread->id, NULL);
+        hist_merge(total, &thread->histogram);
+        completed += thread->completed;
+        errors += thread->errors;
+        client_cpu += thread->cpu_ns;
+        setup_ns += thread->setup_ns;
+        if (thread->count > 0) capabilities = polycall_protocol_capabilities(&thread->connections[0].protocol);
+        close_connections(thread);
+    }
+    if (builtin || !options.host) server_stop_and_cleanup(server_thread);
+    errors += atomic_load(&server_errors);
+
+    int status = 0;
+    if (bench_abort) {
+        status = 1;
+    } else {
+        if (options.rate > 0) {
+            printf("polycall-bench: %zu connections, open loop at %.0f/s, %.1f s", options.connections,
+                   options.rate, options.duration);
+        } else {
+            printf("polycall-bench: %zu connections, closed loop %zu deep, %.1f s", options.connections,
+                   options.depth, options.duration);
+        }
+        if (!options.host || builtin) {
+            printf(", built-in server (%s)\n", server_backend_name());
+        } else {
+            printf(", server %s:%u\n", options.host, options.port);
+        }
+        printf("  capabilities 0x%x, %zu client threads, setup %.1f us per connection\n\n",
+               capabilities, options.threads, setup_ns / 1000.0 / (double)options.connections);
+
+        hist_print(total, stdout);
+        double per_second = completed / options.duration;
+        printf("\nRequests:   %llu in %.2f s, %.1f req/s\n", (unsigned long long)completed,
+               options.duration, per_second);
+        printf("Latency us: p50 %.3f  p99 %.3f  p999 %.3f  max %.3f\n",
+               hist_percentile(total, 50.0, NULL) / 1000.0,
+               hist_percentile(total, 99.0, NULL) / 1000.0,
+               hist_percentile(total, 99.9, NULL) / 1000.0, total->max / 1000.0);
+        if (completed > 0) {
+            printf("CPU us/req: client %.3f", client_cpu / 1000.0 / (double)completed);
+            if (builtin) printf("  server %.3f", server_cpu / 1000.0 / (double)completed);
+            printf("  process %.3f\n", process_cpu / 1000.0 / (double)completed);
+        }
+        printf("Errors:     %llu\n", (unsigned long long)errors);
+        if (errors > 0) status = 1;
+    }
+
+    free(total);
+    free(threads);
+    pthread_barrier_destroy(&bench_ready);
+    pthread_barrier_destroy(&bench_start);
+    polycall_cleanup(bench_context);
+    return status;
+}
\ No newline at end of file
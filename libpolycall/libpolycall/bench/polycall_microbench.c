@@ -0,0 +1,104 @@
+// polycall_microbench.c - Hot-path microbenchmarks on the shared harness
+//
+// Times the per-message work with no network in the way: CRC32C over
+// frame-sized and page-sized buffers, and a state
+// machine transition taken through the runtime machine and straight from
+// static tables. See bench/include/obibench.h at the top of the tree for
+// the options; `make bench` runs it after building polycall-bench.
+#include "polycall.h"
+#include "polycall_checksum.h"
+#include "polycall_state_machine.h"
+#include "obibench.h"
+
+// Two states and the events between them, laid out as polycall-smgen
+// writes a machine
+enum { TOGGLE_STATE_IDLE, TOGGLE_STATE_BUSY };
+enum { TOGGLE_EVENT_START, TOGGLE_EVENT_STOP };
+
+static const PolyCall_State toggle_states[] = {
+    { .name = "IDLE", .id = TOGGLE_STATE_IDLE },
+    { .name = "BUSY", .id = TOGGLE_STATE_BUSY },
+};
+
+static const char* const toggle_event_names[] = { "start", "stop" };
+
+static const PolyCall_StaticTransition toggle_transitions[] = {
+    { "start", TOGGLE_EVENT_START, TOGGLE_STATE_IDLE, TOGGLE_STATE_BUSY, NULL, NULL },
+    { "stop", TOGGLE_EVENT_STOP, TOGGLE_STATE_BUSY, TOGGLE_STATE_IDLE, NULL, NULL },
+};
+
+static const uint8_t toggle_next[] = {
+    0, POLYCALL_SM_NO_TRANSITION,
+    POLYCALL_SM_NO_TRANSITION, 1,
+};
+
+static const PolyCall_StaticMachine toggle_machine = {
+    toggle_states, 2, toggle_transitions, 2, toggle_event_names, 2,
+    TOGGLE_STATE_IDLE, toggle_next
+};
+
+typedef struct {
+    polycall_context_t ctx;
+    PolyCall_StateMachine* sm;
+    unsigned int state;             // For the static machine
+    uint64_t fired;                 // Transitions taken on the runtime machine
+} MachineBench;
+
+static void bench_crc32c(void* arg, uint64_t count) {
+    const uint8_t* buffer = arg;
+    uint32_t crc = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        crc = polycall_crc32c(crc, buffer, 64);
+    }
+    obibench_do_not_optimize(&crc);
+}
+
+static void bench_crc32c_page(void* arg, uint64_t count) {
+    const uint8_t* buffer = arg;
+    uint32_t crc = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        crc = polycall_crc32c(crc, buffer, 4096);
+    }
+    obibench_do_not_optimize(&crc);
+}
+
+// Each operation is one transition; start and stop alternate
+static void bench_sm_fire(void* arg, uint64_t count) {
+    MachineBench* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        polycall_sm_fire(bench->sm, (unsigned int)(bench->fired++ & 1));
+    }
+}
+
+static void bench_sm_static_fire(void* arg, uint64_t count) {
+    MachineBench* bench = arg;
+    for (uint64_t i = 0; i < count; i++) {
+        polycall_sm_static_fire(&toggle_machine, bench->ctx, &bench->state,
+                                (unsigned int)(bench->state == TOGGLE_STATE_BUSY));
+    }
+}
+
+int main(int argc, char** argv) {
+    polycall_config_t config = { 0 };
+    MachineBench machine = { .state = toggle_machine.initial_state };
+    if (polycall_init_with_config(&machine.ctx, &config) != POLYCALL_SUCCESS ||
+        polycall_sm_create_from_static(machine.ctx, &machine.sm, &toggle_machine, NULL)
+            != POLYCALL_SM_SUCCESS) {
+        fprintf(stderr, "Failed to set up the state machine\n");
+        return 1;
+    }
+
+    static uint8_t buffer[4096];
+    for (size_t i = 0; i < sizeof(buffer); i++) buffer[i] = (uint8_t)(i * 131u);
+
+    obibench_suite_t* suite = obibench_init("libpolycall", argc, argv);
+    obibench_run_bytes(suite, "crc32c/64", bench_crc32c, buffer, 64);
+    obibench_run_bytes(suite, "crc32c/4096", bench_crc32c_page, buffer, 4096);
+    obibench_run(suite, "sm_fire", bench_sm_fire, &machine);
+    obibench_run(suite, "sm_static_fire", bench_sm_static_fire, &machine);
+    int status = obibench_finish(suite);
+
+    polycall_sm_destroy(machine.sm);
+    polycall_cleanup(machine.ctx);
+    return status;
+}
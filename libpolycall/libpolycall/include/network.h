@@ -8,17 +8,26 @@
     #include <winsock2.h>
     #include <ws2tcpip.h>
     #include <windows.h>
+    struct iovec {
+        void* iov_base;
+        size_t iov_len;
+    };
 #else
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
 #endif
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
 #include <fcntl.h>
+#include "network_buffer.h"
+#include "network_event.h"
+#include "network_uring.h"
 
 // Windows compatibility defines
 #ifdef _WIN32
@@ -32,8 +41,12 @@
 
 
 // Network Constants
-#define NET_MAX_CLIENTS 10
+#define NET_INITIAL_CLIENTS 64     // Client table grows past this on demand
 #define NET_BUFFER_SIZE 1024
+#define NET_SEND_IOV_MAX 64        // Pieces per gathered send
+#define NET_UNSENT_MAX (4u << 20)  // Bytes held per client behind a full socket
+#define NET_MAX_FDS 16             // Descriptors passed with one message
+#define NET_UNIX_PATH_MAX 108      // Unix socket path, '@' first for an abstract name
 #define NET_MAX_BACKLOG 5
 #define NET_TIMEOUT_SEC 1
 #define NET_TIMEOUT_USEC 0
@@ -56,6 +69,8 @@ typedef enum {
     NET_TCP,            // TCP protocol
     NET_UDP,            // UDP protocol
     NET_RAW,           // Raw sockets
+    NET_UNIX,          // Unix domain stream socket at path
+    NET_UNIX_SEQPACKET, // Unix domain socket that keeps message boundaries
     NET_PROTOCOL_MAX   // Protocol count
 } NetworkProtocol;
 
@@ -69,13 +84,22 @@ typedef enum {
 
 // Forward declaration
 typedef struct PhantomDaemon PhantomDaemon;
+struct NetworkProgram;
 
 // Client Connection State
+// A send the socket only partly takes leaves its tail in unsent, which
+// later sends queue behind and net_run writes out as the socket drains,
+// so a frame is never cut short on the wire.
 typedef struct {
     pthread_mutex_t lock;           // State mutex
     bool is_active;                 // Active flag
     int socket_fd;                  // Socket descriptor
     struct sockaddr_in addr;        // Client address
+    uint32_t tag;                   // Connection generation, routes io_uring completions
+    pthread_mutex_t send_lock;      // Guards the unsent bytes
+    char* unsent;                   // Bytes accepted but not yet written
+    size_t unsent_length;
+    size_t unsent_capacity;
 } ClientState;
 
 // Network Endpoint
@@ -83,27 +107,67 @@ typedef struct {
     pthread_mutex_t lock;           // Endpoint mutex
     char address[INET_ADDRSTRLEN];  // IP address
     uint16_t port;                  // Port number
+    char path[NET_UNIX_PATH_MAX];   // Socket path for NET_UNIX protocols
     NetworkProtocol protocol;       // Protocol type
     NetworkRole role;               // Endpoint role
     int socket_fd;                  // Socket descriptor
     struct sockaddr_in addr;        // Socket address
     PhantomDaemon* phantom;         // Phantom daemon reference
     void* user_data;               // Added user data field
+    bool reuse_port;                // Share the port with other listeners (SO_REUSEPORT)
+    NetworkUring* uring;            // When set, net_send queues on this ring
+    bool inherited;                 // Listener handed over by another process
+    struct NetworkProgram* program; // Serving program on handler endpoints, or NULL
 } NetworkEndpoint;
 
 // Network Packet
+// On receive, buffer holds the bytes at data; a handler that needs them
+// after it returns retains the buffer instead of copying. buffer is NULL
+// when the data is only lent for the duration of the call (io_uring).
+// Descriptors passed along with the data (SCM_RIGHTS over Unix sockets)
+// are in fds; a handler keeps one by setting its slot to -1, and the rest
+// are closed once it returns. The io_uring backend does not collect them.
 typedef struct {
     void* data;                     // Packet data
     size_t size;                    // Data size
     uint32_t flags;                 // Packet flags
+    NetworkBuffer* buffer;          // Refcounted storage behind data, or NULL
+    int* fds;                       // Received descriptors, or NULL
+    int fd_count;
 } NetworkPacket;
 
-// Network Program
+// Network Statistics
+// Counters are written only by the thread running net_run and may be read
+// from any thread; net_get_stats takes a snapshot.
+typedef struct {
+    _Atomic uint64_t accepted;      // Connections accepted
+    _Atomic uint64_t disconnected;  // Connections closed
+    _Atomic uint64_t packets;       // Reads delivered to on_receive
+    _Atomic uint64_t bytes;         // Bytes delivered to on_receive
+    _Atomic uint64_t wakeups;       // Event waits that returned events
+} NetworkCounters;
+
 typedef struct {
+    uint64_t accepted;
+    uint64_t disconnected;
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t wakeups;
+    size_t clients;                 // Currently connected
+} NetworkStats;
+
+// Network Program
+typedef struct NetworkProgram {
     NetworkEndpoint* endpoints;      // Endpoint array
     size_t count;                   // Endpoint count
-    ClientState clients[NET_MAX_CLIENTS]; // Client states
-    pthread_mutex_t clients_lock;    // Clients mutex
+    ClientState** clients;          // Client table indexed by socket fd
+    size_t client_capacity;         // Table slots
+    size_t client_count;            // Active clients
+    pthread_mutex_t clients_lock;    // Guards the table, not the clients
+    NetworkEventLoop* events;       // Readiness backend
+    NetworkUring* uring;            // Completion backend, replaces events
+    uint32_t next_tag;              // Last client tag handed out
+    NetworkBufferPool* buffers;     // Receive buffers
     volatile bool running;           // Running flag
     struct {
         void (*on_receive)(NetworkEndpoint*, NetworkPacket*);  // Data handler
@@ -111,21 +175,57 @@ typedef struct {
         void (*on_disconnect)(NetworkEndpoint*);               // Disconnect handler
     } handlers;
     PhantomDaemon* phantom;         // Phantom daemon reference
+    void* user_data;                // Copied into each handler's endpoint
+    NetworkCounters counters;       // Activity counters
+    uint16_t claimed_port;          // Picked for it by net_init_program, or 0
+    bool draining;                  // Listener handed on, clients still served
 } NetworkProgram;
 
 // Core Network Functions
 bool net_init(NetworkEndpoint* endpoint);
 void net_close(NetworkEndpoint* endpoint);
 ssize_t net_send(NetworkEndpoint* endpoint, NetworkPacket* packet);
+ssize_t net_sendv(NetworkEndpoint* endpoint, const struct iovec* iov, int count);
+ssize_t net_send_buffer(NetworkEndpoint* endpoint, const NetworkBuffer* head);
 ssize_t net_receive(NetworkEndpoint* endpoint, NetworkPacket* packet);
+
+// Descriptor passing over Unix sockets. Send needs at least one byte of
+// data and fails on io_uring endpoints, whose queued sends it would pass.
+// Receive fills packet->fds from fds, which has room for NET_MAX_FDS;
+// the caller owns what arrives.
+ssize_t net_send_fds(NetworkEndpoint* endpoint, const struct iovec* iov, int count,
+                     const int* fds, int fd_count);
+ssize_t net_receive_fds(NetworkEndpoint* endpoint, NetworkPacket* packet, int* fds);
 void net_run(NetworkProgram* program);
+bool net_add_client(NetworkProgram* program, int socket_fd, struct sockaddr_in addr);
+void net_remove_client(NetworkProgram* program, int socket_fd);
 
 // Utility Functions
 bool net_is_port_in_use(uint16_t port);
+// Which of first..last are taken, from one read of the kernel's socket
+// tables; in_use has last - first + 1 entries. Falls back to a bind probe
+// per port where the tables can't be read.
+void net_ports_in_use(uint16_t first, uint16_t last, bool* in_use);
+// True when something listens at a Unix socket path
+bool net_is_path_in_use(const char* path);
+bool net_protocol_is_unix(NetworkProtocol protocol);
+const char* net_protocol_name(NetworkProtocol protocol);
 bool net_release_port(uint16_t port);
 void net_init_client_state(ClientState* state);
 void net_cleanup_client_state(ClientState* state);
 void net_init_program(NetworkProgram* program);
+void net_init_program_with_backend(NetworkProgram* program, NetworkEventBackend backend);
+void net_init_program_shared(NetworkProgram* program, NetworkEventBackend backend, uint16_t port);
+void net_init_program_unix(NetworkProgram* program, NetworkEventBackend backend,
+                           NetworkProtocol protocol, const char* path);
+// Serve on a listening socket handed over by another process; the program
+// owns listen_fd from then on, failed or not
+void net_init_program_adopt(NetworkProgram* program, NetworkEventBackend backend,
+                            NetworkProtocol protocol, int listen_fd);
+// Close the listener, which another process accepts on now, and keep
+// serving the connected clients. Call from the thread running net_run.
+void net_stop_accepting(NetworkProgram* program);
+void net_get_stats(NetworkProgram* program, NetworkStats* stats);
 void net_cleanup_program(NetworkProgram* program);
 
 #endif // NETWORK_H
\ No newline at end of file
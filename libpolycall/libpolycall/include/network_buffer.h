@@ -0,0 +1,54 @@
+#ifndef NETWORK_BUFFER_H
+#define NETWORK_BUFFER_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+// Refcounted packet buffers. A pool carves fixed-size buffers out of slabs
+// and keeps returned ones on a free list; a request larger than the pool's
+// buffer size gets a one-off heap buffer, so one received message always
+// sits in one piece. Buffers can also be linked through next into a chain,
+// which net_send_buffer hands to the kernel with a single writev.
+//
+// The reference count on the first buffer of a chain covers the whole
+// chain. Retain and release may be called from any thread, and a pool that
+// is destroyed while buffers are still held goes away with the last one.
+
+#define NET_PACKET_BUFFER_SIZE 16384    // Pooled buffer capacity
+#define NET_BUFFER_SLAB 64              // Buffers carved per slab
+
+typedef struct NetworkBufferPool NetworkBufferPool;
+typedef struct NetworkBuffer NetworkBuffer;
+
+struct NetworkBuffer {
+    _Atomic uint32_t refs;          // References to the chain headed here
+    size_t capacity;                // Bytes available at data
+    size_t length;                  // Bytes in use
+    NetworkBuffer* next;            // Next buffer of a chained message
+    NetworkBufferPool* pool;        // Pool it returns to, NULL for a one-off
+    uint8_t data[];                 // Inline storage
+};
+
+NetworkBufferPool* net_buffer_pool_create(size_t buffer_size);
+void net_buffer_pool_destroy(NetworkBufferPool* pool);
+size_t net_buffer_pool_buffer_size(const NetworkBufferPool* pool);
+
+// A buffer of at least size bytes with one reference and length 0.
+// pool may be NULL, which always gives a one-off buffer.
+NetworkBuffer* net_buffer_alloc(NetworkBufferPool* pool, size_t size);
+
+NetworkBuffer* net_buffer_retain(NetworkBuffer* buffer);
+void net_buffer_release(NetworkBuffer* buffer);
+
+// True when the caller holds the only reference, so the buffer may be reused
+bool net_buffer_unique(const NetworkBuffer* buffer);
+
+// Copy size bytes onto the end of the chain, linking new buffers from the
+// head's pool as needed
+bool net_buffer_append(NetworkBuffer* head, const void* data, size_t size);
+
+// Bytes held by the whole chain
+size_t net_buffer_chain_length(const NetworkBuffer* head);
+
+#endif // NETWORK_BUFFER_H
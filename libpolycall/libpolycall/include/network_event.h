@@ -0,0 +1,51 @@
+#ifndef NETWORK_EVENT_H
+#define NETWORK_EVENT_H
+#include <stdint.h>
+#include <stdbool.h>
+
+// Readiness notification backends. Registration is edge-triggered where
+// the kernel supports it (EPOLLET, EV_CLEAR): a descriptor is reported once
+// per new readiness, so the caller must drain it until EAGAIN. The select
+// fallback is level-triggered and limited to descriptors below FD_SETSIZE.
+typedef enum {
+    NET_EVENT_AUTO,     // Best backend for this platform
+    NET_EVENT_EPOLL,    // Linux
+    NET_EVENT_KQUEUE,   // BSD and macOS
+    NET_EVENT_SELECT,   // Portable fallback
+    NET_EVENT_URING,    // io_uring completions, Linux 6.0+ (network_uring.h)
+    NET_EVENT_BACKEND_MAX
+} NetworkEventBackend;
+
+// Event flags
+#define NET_EVENT_READ   0x01u      // Readable, or a listener has connections
+#define NET_EVENT_HANGUP 0x02u      // Peer closed or socket error
+#define NET_EVENT_WRITE  0x04u      // Writable again, when asked for
+
+#define NET_EVENT_BATCH 256         // Events returned per wait at most
+
+typedef struct {
+    int fd;                         // Ready descriptor
+    uint32_t flags;                 // NET_EVENT_* flags
+} NetworkEvent;
+
+typedef struct NetworkEventLoop NetworkEventLoop;
+
+// Returns NULL if the backend is unavailable on this platform; io_uring is
+// not a readiness backend and is driven by net_run directly
+NetworkEventLoop* net_event_create(NetworkEventBackend backend);
+void net_event_destroy(NetworkEventLoop* loop);
+NetworkEventBackend net_event_backend(const NetworkEventLoop* loop);
+const char* net_event_backend_name(NetworkEventBackend backend);
+
+// Watch fd for readability; fd should be non-blocking
+bool net_event_add(NetworkEventLoop* loop, int fd);
+// Stop watching fd; call before closing it
+void net_event_remove(NetworkEventLoop* loop, int fd);
+// Also report fd when it becomes writable, or stop; fd must be watched
+bool net_event_want_write(NetworkEventLoop* loop, int fd, bool on);
+
+// Wait up to timeout_ms (-1 blocks) and fill at most NET_EVENT_BATCH
+// events. Returns the event count, 0 on timeout or EINTR, -1 on error.
+int net_event_wait(NetworkEventLoop* loop, NetworkEvent* events, int timeout_ms);
+
+#endif // NETWORK_EVENT_H
\ No newline at end of file
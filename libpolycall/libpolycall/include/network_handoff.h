@@ -0,0 +1,64 @@
+#ifndef NETWORK_HANDOFF_H
+#define NETWORK_HANDOFF_H
+#include "network.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Restarts without dropping a connection. The running daemon keeps a Unix
+// socket open for its successor. A successor started with the same path
+// connects, receives every listening socket along with an opaque state
+// blob (a serialized state machine snapshot, say), starts accepting on
+// them and confirms. Only then does the old daemon stop accepting; it
+// serves the clients it has until they leave. Until the confirmation the
+// old daemon changes nothing, so a successor that fails half way costs
+// nothing but its own start.
+//
+// The handoff socket itself goes to the successor too, already listening,
+// so the next upgrade works the same way without a gap.
+//
+// Needs Unix sockets; net_handoff_listen and net_handoff_take fail on
+// Windows.
+
+#define NET_HANDOFF_MAX_LISTENERS 256
+#define NET_HANDOFF_MAX_STATE (64u << 20)   // Largest state blob accepted
+
+typedef struct NetworkHandoff NetworkHandoff;
+
+typedef struct {
+    int fd;                         // Listening socket
+    NetworkProtocol protocol;       // NET_TCP or a Unix protocol
+} NetworkHandoffListener;
+
+// Old side. Listen at path (a leading '@' is the abstract namespace).
+NetworkHandoff* net_handoff_listen(const char* path);
+
+// Hand everything to a successor, if one is waiting; never blocks for
+// one. Once connected, waits up to timeout_ms (0 for no limit) for each
+// step. Returns true once the successor has confirmed: from then on the
+// listeners are its to accept on, and the handoff socket too, so this
+// side only closes.
+// False with errno EAGAIN when no successor is waiting.
+bool net_handoff_offer(NetworkHandoff* handoff,
+                       const NetworkHandoffListener* listeners, size_t count,
+                       const void* state, size_t state_size, int timeout_ms);
+
+// New side. Connect to the daemon at path and receive its listeners, at
+// most capacity, and its state, malloc'd (NULL when empty). The caller
+// owns the descriptors and the state; the daemon keeps accepting until
+// net_handoff_confirm.
+NetworkHandoff* net_handoff_take(const char* path, int timeout_ms,
+                                 NetworkHandoffListener* listeners, size_t capacity,
+                                 size_t* count, void** state, size_t* state_size);
+
+// Tell the old daemon to stop accepting. The handoff is then the one the
+// next successor connects to, as if from net_handoff_listen.
+bool net_handoff_confirm(NetworkHandoff* handoff);
+
+// The descriptor to watch for a waiting successor
+int net_handoff_fd(const NetworkHandoff* handoff);
+
+// Removes the socket file only while this side owns it
+void net_handoff_close(NetworkHandoff* handoff);
+
+#endif // NETWORK_HANDOFF_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef NETWORK_REACTOR_H
+#define NETWORK_REACTOR_H
+#include "network.h"
+
+#define NET_MAX_REACTORS 64
+
+typedef struct NetworkReactorGroup NetworkReactorGroup;
+
+// One event loop thread with its own listener and client set. Clients stay
+// on the reactor that accepted them, so handlers for a connection always
+// run on the same thread and never contend with other reactors.
+typedef struct {
+    NetworkProgram program;         // Listener, client table and counters
+    pthread_t thread;               // Reactor thread
+    size_t index;                   // Position in the group
+    bool started;                   // Thread is running
+    NetworkReactorGroup* group;     // Owning group
+} NetworkReactor;
+
+// N reactors bound to one port through SO_REUSEPORT; the kernel shards
+// incoming connections across their listeners
+struct NetworkReactorGroup {
+    NetworkReactor* reactors;       // Reactor array
+    size_t count;                   // Reactor count
+    uint16_t port;                  // Shared port
+    atomic_bool running;            // Cleared to stop the reactors
+    struct {
+        void (*on_receive)(NetworkEndpoint*, NetworkPacket*);  // Data handler
+        void (*on_connect)(NetworkEndpoint*);                  // Connect handler
+        void (*on_disconnect)(NetworkEndpoint*);               // Disconnect handler
+    } handlers;
+    PhantomDaemon* phantom;         // Phantom daemon reference
+};
+
+// Handlers and phantom must be set on the group before starting; each
+// handler's endpoint->user_data is its NetworkReactor. A count of 0 uses
+// one reactor per online CPU and port 0 picks a free port.
+bool net_reactors_start(NetworkReactorGroup* group, size_t count, uint16_t port,
+                        NetworkEventBackend backend);
+// Stops and joins every reactor, then closes their clients
+void net_reactors_stop(NetworkReactorGroup* group);
+
+// Per-reactor and summed statistics
+bool net_reactor_stats(NetworkReactorGroup* group, size_t index, NetworkStats* stats);
+void net_reactors_total(NetworkReactorGroup* group, NetworkStats* stats);
+
+#endif // NETWORK_REACTOR_H
\ No newline at end of file
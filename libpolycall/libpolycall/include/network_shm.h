@@ -0,0 +1,67 @@
+#ifndef NETWORK_SHM_H
+#define NETWORK_SHM_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Same-host transport over a pair of single-producer single-consumer rings
+// in one shared memfd region, one ring per direction. A frame is copied
+// once, straight into the peer's view of the ring, and is read in place.
+// An idle reader spins briefly and then sleeps on a futex in the region;
+// the writer only makes a system call when the reader is asleep.
+//
+// The creator describes the region with net_shm_offer and sends the offer
+// over an existing local connection. The peer opens the memfd through
+// /proc, which needs the same user (or ptrace rights over the creator),
+// and checks the random token in the offer against the one in the region.
+// Once attached, the creator can drop its descriptor with net_shm_seal.
+//
+// Each ring has one writer and one reader; calls on a ring must not race.
+// Needs Linux; net_shm_create and net_shm_attach return NULL elsewhere.
+
+#define NET_SHM_RING_MIN  65536         // Ring size bounds (powers of two)
+#define NET_SHM_RING_MAX  (1u << 30)
+#define NET_SHM_SPIN      4096          // Polls before a wait sleeps (none on one CPU)
+
+typedef struct NetworkShm NetworkShm;
+struct iovec;
+
+// What a peer needs to attach; plain data, safe to send as is
+typedef struct {
+    uint64_t token;                 // Random, repeated in the region
+    int32_t pid;                    // Process holding the memfd
+    int32_t fd;                     // The memfd in that process
+    uint32_t ring_size;             // Bytes per direction
+    uint32_t reserved;              // Zero
+} NetworkShmOffer;
+
+// A region whose rings hold at least ring_size bytes each, rounded up to a
+// power of two within the bounds above
+NetworkShm* net_shm_create(size_t ring_size);
+NetworkShm* net_shm_attach(const NetworkShmOffer* offer);
+bool net_shm_offer(const NetworkShm* shm, NetworkShmOffer* offer);
+// Close the creator's memfd; the mappings stay
+void net_shm_seal(NetworkShm* shm);
+// Tell the peer we are gone, then unmap
+void net_shm_destroy(NetworkShm* shm);
+
+// Largest frame the outgoing ring takes
+size_t net_shm_frame_limit(const NetworkShm* shm);
+
+// Append one frame gathered from count pieces, waiting up to timeout_ms
+// (-1 forever) for room. Fails with errno EMSGSIZE when the frame is over
+// the limit, EAGAIN when there was no room in time, EPIPE when the peer
+// has gone.
+bool net_shm_sendv(NetworkShm* shm, const struct iovec* iov, int count, int timeout_ms);
+
+// The oldest unread frame, in place, or NULL when there is none (errno
+// EAGAIN), the peer has gone and the ring is drained (EPIPE), or the ring
+// is corrupt (EPROTO). The frame stays valid until net_shm_consume.
+const void* net_shm_peek(NetworkShm* shm, size_t* length);
+void net_shm_consume(NetworkShm* shm);
+
+// Wait up to timeout_ms (-1 forever) for a frame or for the peer to go.
+// True when net_shm_peek has something to report.
+bool net_shm_wait(NetworkShm* shm, int timeout_ms);
+
+#endif // NETWORK_SHM_H
@@ -0,0 +1,72 @@
+#ifndef NETWORK_URING_H
+#define NETWORK_URING_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// Completion-based socket I/O over io_uring, driven through the raw
+// syscalls so no liburing is needed. Accepts and receives are multishot:
+// armed once, each keeps producing completions. Received data lands in a
+// kernel-selected buffer from a registered buffer ring. Sends are copied
+// into a preallocated slab and queued per socket with one sendmsg in
+// flight, so a stream keeps its order; each sendmsg gathers every queued
+// slot it can, so a reply larger than a slot still goes out in one call. New requests accumulate in the submission
+// queue until net_uring_submit or net_uring_wait, so a whole batch of
+// handler output goes to the kernel in one io_uring_enter.
+//
+// Needs Linux 6.0 or later (multishot recv and buffer rings);
+// net_uring_create returns NULL elsewhere.
+
+#define NET_URING_ENTRIES      4096 // Submission queue depth
+#define NET_URING_RECV_BUFFERS 1024 // Shared receive buffers (power of two)
+#define NET_URING_SEND_SLOTS   4096 // Send slab, NET_BUFFER_SIZE bytes per slot
+
+typedef enum {
+    NET_URING_ACCEPT,               // result is the new socket
+    NET_URING_RECV,                 // result is the byte count, 0 on EOF
+    NET_URING_SEND,                 // internal, never reported
+    NET_URING_CANCEL                // internal, never reported
+} NetworkUringOp;
+
+typedef struct {
+    NetworkUringOp op;
+    int fd;                         // Listener or client socket
+    uint32_t tag;                   // Tag given when the request was armed
+    int result;                     // As described above, or -errno
+    bool more;                      // Request is still armed
+    void* data;                     // RECV: received bytes
+    int buffer;                     // RECV: buffer to recycle, -1 if none
+} NetworkUringEvent;
+
+typedef struct NetworkUring NetworkUring;
+struct iovec;
+
+NetworkUring* net_uring_create(void);
+void net_uring_destroy(NetworkUring* ring);
+
+// Arm a multishot request; tag (24 bits) comes back in each event
+bool net_uring_accept(NetworkUring* ring, int listen_fd);
+bool net_uring_recv(NetworkUring* ring, int fd, uint32_t tag);
+// Disarm the listener's accept; its last event comes with more unset
+bool net_uring_cancel_accept(NetworkUring* ring, int listen_fd);
+
+// Copy size bytes into as many slots as needed and queue them for fd.
+// Returns size, or -1 with errno EAGAIN when too few slots are free.
+// Not thread-safe: call from the thread that runs the ring.
+ssize_t net_uring_send(NetworkUring* ring, int fd, const void* data, size_t size);
+// Same, gathering count pieces into the slots in order
+ssize_t net_uring_sendv(NetworkUring* ring, int fd, const struct iovec* iov, int count);
+// Drop queued sends for fd before it is closed
+void net_uring_forget(NetworkUring* ring, int fd);
+
+// Submit queued requests; returns the number submitted or -1
+int net_uring_submit(NetworkUring* ring);
+
+// Submit, then wait up to timeout_ms for completions and fill at most
+// NET_EVENT_BATCH events. Returns the count, 0 on timeout, -1 on error.
+int net_uring_wait(NetworkUring* ring, NetworkUringEvent* events, int timeout_ms);
+// Hand a RECV buffer back to the kernel once its data has been consumed
+void net_uring_recycle(NetworkUring* ring, int buffer);
+
+#endif // NETWORK_URING_H
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef POLYCALL_CHECKSUM_H
+#define POLYCALL_CHECKSUM_H
+#include <stdint.h>
+#include <stddef.h>
+
+// CRC32C (Castagnoli) over a payload. Uses the SSE4.2 or ARMv8 CRC
+// instructions when the CPU has them, and slice-by-8 tables otherwise;
+// every path gives the same value. crc is 0 for a new checksum, or the
+// value returned for the preceding bytes, so a payload can be fed in
+// pieces.
+uint32_t polycall_crc32c(uint32_t crc, const void* data, size_t length);
+
+// Name of the implementation in use ("sse4.2", "armv8" or "slice-by-8")
+const char* polycall_crc32c_impl(void);
+
+#endif // POLYCALL_CHECKSUM_H
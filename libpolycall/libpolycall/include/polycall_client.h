@@ -0,0 +1,109 @@
+#ifndef POLYCALL_CLIENT_H
+#define POLYCALL_CLIENT_H
+
+#include "polycall.h"
+#include "polycall_protocol.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Client side of the protocol: a pool of kept-alive connections to one
+// server. Each connection does the handshake and authentication once, when
+// it is opened, and then carries many requests at a time; responses are
+// matched to requests by sequence, so they may come back in any order.
+// Connections are opened on demand, up to max_connections, whenever every
+// open one already has requests outstanding. A lost connection fails its
+// outstanding requests and the next call opens a fresh one.
+//
+// One I/O thread per pool reads the responses and runs the completion
+// callbacks. Calls may be made from any thread, including from callbacks.
+
+#define POLYCALL_CLIENT_DEFAULT_CONNECTIONS 4
+#define POLYCALL_CLIENT_DEFAULT_INFLIGHT 1024   // Per connection, rounded up to a power of two
+#define POLYCALL_CLIENT_DEFAULT_TIMEOUT_MS 5000 // Connect, handshake and auth
+
+typedef enum {
+    POLYCALL_CLIENT_OK = 0,
+    POLYCALL_CLIENT_ERROR_INVALID,  // Bad arguments
+    POLYCALL_CLIENT_ERROR_CONNECT,  // No connection could be opened and authenticated
+    POLYCALL_CLIENT_ERROR_BUSY,     // Every connection has max_inflight requests out
+    POLYCALL_CLIENT_ERROR_SEND,     // The request could not be written
+    POLYCALL_CLIENT_ERROR_CLOSED,   // Connection lost before the response came
+    POLYCALL_CLIENT_ERROR_SHUTDOWN  // Pool destroyed with the request outstanding
+} polycall_client_status_t;
+
+// Completion of one request, on the pool's I/O thread. response is only
+// valid during the call and is NULL unless status is POLYCALL_CLIENT_OK.
+typedef void (*polycall_client_callback_t)(void* user_data, polycall_client_status_t status,
+                                           const void* response, size_t length);
+
+typedef struct {
+    const char* host;               // Server name or address, for TCP
+    uint16_t port;
+    const char* unix_path;          // Unix socket instead of TCP, or NULL
+    const void* credentials;        // Sent to authenticate each connection
+    size_t credentials_length;
+    size_t max_connections;         // 0 for POLYCALL_CLIENT_DEFAULT_CONNECTIONS
+    size_t max_inflight;            // 0 for POLYCALL_CLIENT_DEFAULT_INFLIGHT
+    uint32_t timeout_ms;            // 0 for POLYCALL_CLIENT_DEFAULT_TIMEOUT_MS
+    uint16_t capabilities;          // Offered on top of POLYCALL_CAP_PIPELINE
+    size_t max_message_size;        // Largest response accepted, 0 for the default
+} polycall_client_config_t;
+
+typedef struct {
+    uint64_t connects;              // Connections opened and authenticated
+    uint64_t connect_failures;
+    uint64_t requests;              // Requests written
+    uint64_t responses;             // Requests completed with a response
+    uint64_t failures;              // Requests completed with an error
+    size_t connections;             // Open now
+    size_t inflight;                // Outstanding now
+} polycall_client_stats_t;
+
+typedef struct polycall_client_pool polycall_client_pool_t;
+
+// Starts the I/O thread; no connection is opened until the first call.
+// The configuration's strings are copied.
+polycall_client_pool_t* polycall_client_create(
+    polycall_context_t pc_ctx,
+    const polycall_client_config_t* config
+);
+
+// Closes every connection and fails what is outstanding with
+// POLYCALL_CLIENT_ERROR_SHUTDOWN. No call may be running or made after.
+void polycall_client_destroy(polycall_client_pool_t* pool);
+
+// Send a command; callback runs once with the response or an error. On
+// anything but POLYCALL_CLIENT_OK nothing was sent and the callback will
+// not run.
+polycall_client_status_t polycall_client_call_async(
+    polycall_client_pool_t* pool,
+    const void* command,
+    size_t length,
+    polycall_client_callback_t callback,
+    void* user_data
+);
+
+// Send a command and wait for its completion. On success *response is a
+// malloc'd copy of the response, which the caller frees. Must not be
+// called from a completion callback.
+polycall_client_status_t polycall_client_call(
+    polycall_client_pool_t* pool,
+    const void* command,
+    size_t length,
+    void** response,
+    size_t* response_length
+);
+
+void polycall_client_get_stats(polycall_client_pool_t* pool, polycall_client_stats_t* stats);
+
+const char* polycall_client_status_name(polycall_client_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POLYCALL_CLIENT_H
\ No newline at end of file
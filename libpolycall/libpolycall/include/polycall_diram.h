@@ -0,0 +1,22 @@
+#ifndef POLYCALL_DIRAM_H
+#define POLYCALL_DIRAM_H
+#include "polycall_micro.h"
+
+/**
+ * @file polycall_diram.h
+ * @brief diram memory spaces as the accounting behind service arenas
+ *
+ * Built with `make DIRAM=1`, which compiles against the diram tree next
+ * to this one and links its static library. Each service gets a diram
+ * space named "polycall-service-<id>" with the limit given to
+ * polycall_micro_set_memory_backend; arena chunks are charged to it, so
+ * the space's usage is the service's footprint and its limit the cap.
+ *
+ *     polycall_micro_set_memory_backend(&ctx, polycall_diram_backend(), 1 << 20);
+ */
+
+#ifdef POLYCALL_WITH_DIRAM
+const PolycallMemoryBackend* polycall_diram_backend(void);
+#endif
+
+#endif // POLYCALL_DIRAM_H
@@ -0,0 +1,100 @@
+#ifndef POLYCALL_LOG_H
+#define POLYCALL_LOG_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+/**
+ * @file polycall_log.h
+ * @brief Leveled logging for libpolycall
+ *
+ * Calls below POLYCALL_LOG_COMPILE_LEVEL compile to nothing, arguments
+ * included. Calls above it are checked against a runtime level before
+ * anything is formatted. Once polycall_log_start has run, messages go to
+ * a lock-free queue drained by a writer thread, so a producer never waits
+ * on the sink; when the queue is full the message is dropped and counted.
+ * Before start, and after stop, messages are written synchronously.
+ */
+
+typedef enum {
+    POLYCALL_LOG_LEVEL_TRACE = 0,
+    POLYCALL_LOG_LEVEL_DEBUG = 1,
+    POLYCALL_LOG_LEVEL_INFO = 2,
+    POLYCALL_LOG_LEVEL_WARN = 3,
+    POLYCALL_LOG_LEVEL_ERROR = 4,
+    POLYCALL_LOG_LEVEL_OFF = 5
+} polycall_log_level_t;
+
+// Release builds keep INFO and up; other builds keep everything
+#ifndef POLYCALL_LOG_COMPILE_LEVEL
+    #ifdef NDEBUG
+        #define POLYCALL_LOG_COMPILE_LEVEL 2
+    #else
+        #define POLYCALL_LOG_COMPILE_LEVEL 0
+    #endif
+#endif
+
+#define POLYCALL_LOG_QUEUE_SIZE 1024    // Queued messages (power of two)
+#define POLYCALL_LOG_MESSAGE_MAX 224    // Longer messages are truncated
+
+// Runtime threshold; defaults to DEBUG in -DDEBUG builds, INFO otherwise
+void polycall_log_set_level(polycall_log_level_t level);
+polycall_log_level_t polycall_log_get_level(void);
+
+extern _Atomic int polycall_log_threshold;
+
+static inline bool polycall_log_enabled(polycall_log_level_t level) {
+    return (int)level >= atomic_load_explicit(&polycall_log_threshold, memory_order_relaxed);
+}
+
+// Destination for log lines (stderr by default)
+void polycall_log_set_sink(FILE* sink);
+
+// Start or stop the asynchronous writer; stop drains the queue first
+bool polycall_log_start(void);
+void polycall_log_stop(void);
+
+// Messages dropped because the queue was full
+size_t polycall_log_dropped(void);
+
+// module must outlive the message (use a string literal)
+void polycall_log_write(polycall_log_level_t level, const char* module, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define POLYCALL_LOG_AT(level, module, ...) \
+    do { \
+        if (polycall_log_enabled(level)) polycall_log_write(level, module, __VA_ARGS__); \
+    } while (0)
+
+#if POLYCALL_LOG_COMPILE_LEVEL <= 0
+    #define POLYCALL_LOG_TRACE(module, ...) POLYCALL_LOG_AT(POLYCALL_LOG_LEVEL_TRACE, module, __VA_ARGS__)
+#else
+    #define POLYCALL_LOG_TRACE(module, ...) ((void)0)
+#endif
+
+#if POLYCALL_LOG_COMPILE_LEVEL <= 1
+    #define POLYCALL_LOG_DEBUG(module, ...) POLYCALL_LOG_AT(POLYCALL_LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+#else
+    #define POLYCALL_LOG_DEBUG(module, ...) ((void)0)
+#endif
+
+#if POLYCALL_LOG_COMPILE_LEVEL <= 2
+    #define POLYCALL_LOG_INFO(module, ...) POLYCALL_LOG_AT(POLYCALL_LOG_LEVEL_INFO, module, __VA_ARGS__)
+#else
+    #define POLYCALL_LOG_INFO(module, ...) ((void)0)
+#endif
+
+#if POLYCALL_LOG_COMPILE_LEVEL <= 3
+    #define POLYCALL_LOG_WARN(module, ...) POLYCALL_LOG_AT(POLYCALL_LOG_LEVEL_WARN, module, __VA_ARGS__)
+#else
+    #define POLYCALL_LOG_WARN(module, ...) ((void)0)
+#endif
+
+#if POLYCALL_LOG_COMPILE_LEVEL <= 4
+    #define POLYCALL_LOG_ERROR(module, ...) POLYCALL_LOG_AT(POLYCALL_LOG_LEVEL_ERROR, module, __VA_ARGS__)
+#else
+    #define POLYCALL_LOG_ERROR(module, ...) ((void)0)
+#endif
+
+#endif // POLYCALL_LOG_H
\ No newline at end of file
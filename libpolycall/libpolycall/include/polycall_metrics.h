@@ -0,0 +1,92 @@
+#ifndef POLYCALL_METRICS_H
+#define POLYCALL_METRICS_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file polycall_metrics.h
+ * @brief Runtime counters and latency histograms
+ *
+ * Every thread that records gets its own shard, so recording is a plain
+ * load and store on memory no other thread writes. A scrape sums the
+ * shards; values are exact once writers are quiet and may lag by the
+ * updates in flight otherwise. Shards of exited threads are kept, with
+ * their counts, for the next thread that starts recording.
+ *
+ * The built-in metrics below are recorded by the network, protocol, micro
+ * service and client layers. Others can be registered at run time, and
+ * gauges are read through a callback at scrape time. Output is the
+ * Prometheus text format, written to a stream or served over HTTP.
+ */
+
+#define POLYCALL_METRICS_MAX_COUNTERS 64        // Built-in and registered
+#define POLYCALL_METRICS_MAX_HISTOGRAMS 16
+#define POLYCALL_METRICS_MAX_GAUGES 16
+#define POLYCALL_METRICS_BUCKETS 26             // Powers of two from 256 ns, then +Inf
+#define POLYCALL_METRICS_FIRST_BUCKET_SHIFT 8
+
+// Built-in counters
+typedef enum {
+    POLYCALL_METRIC_NET_ACCEPTED = 0,
+    POLYCALL_METRIC_NET_DISCONNECTED,
+    POLYCALL_METRIC_NET_BYTES_IN,
+    POLYCALL_METRIC_NET_BYTES_OUT,
+    POLYCALL_METRIC_NET_SEND_ERRORS,
+    POLYCALL_METRIC_PROTOCOL_FRAMES_IN,
+    POLYCALL_METRIC_PROTOCOL_FRAMES_OUT,
+    POLYCALL_METRIC_PROTOCOL_CHECKSUM_FAILURES,
+    POLYCALL_METRIC_PROTOCOL_BAD_FRAMES,
+    POLYCALL_METRIC_MICRO_ENQUEUED,
+    POLYCALL_METRIC_MICRO_DEQUEUED,
+    POLYCALL_METRIC_MICRO_QUEUE_FULL,
+    POLYCALL_METRIC_CLIENT_REQUESTS,
+    POLYCALL_METRIC_CLIENT_FAILURES,
+    POLYCALL_METRIC_COUNTER_BUILTIN
+} polycall_counter_t;
+
+// Built-in histograms, in nanoseconds
+typedef enum {
+    POLYCALL_METRIC_PROTOCOL_HANDSHAKE_NS = 0,  // Handshake sent to peer's handshake in
+    POLYCALL_METRIC_PROTOCOL_COMMAND_NS,        // Server side: time in the command handler
+    POLYCALL_METRIC_CLIENT_REQUEST_NS,          // Client side: request sent to response in
+    POLYCALL_METRIC_HISTOGRAM_BUILTIN
+} polycall_histogram_t;
+
+// Register a counter or histogram; returns its id, or -1 when the table
+// is full. A name registered before gets its existing id. name and help
+// must outlive the registry (use string literals).
+int polycall_metrics_register_counter(const char* name, const char* help);
+int polycall_metrics_register_histogram(const char* name, const char* help);
+
+// Gauges are read at scrape time, from the scraping thread
+typedef int64_t (*polycall_gauge_fn)(void* user_data);
+bool polycall_metrics_register_gauge(const char* name, const char* help,
+                                     polycall_gauge_fn read, void* user_data);
+void polycall_metrics_unregister_gauge(const char* name);
+
+void polycall_metrics_add(int counter, uint64_t amount);
+void polycall_metrics_observe(int histogram, uint64_t value_ns);
+
+static inline void polycall_metrics_inc(int counter) {
+    polycall_metrics_add(counter, 1);
+}
+
+// Monotonic clock for latency measurements
+uint64_t polycall_metrics_now_ns(void);
+
+// Summed value of a counter, and count and sum of a histogram
+uint64_t polycall_metrics_counter_value(int counter);
+uint64_t polycall_metrics_histogram_count(int histogram, uint64_t* sum_ns);
+
+// Prometheus text exposition of everything registered
+void polycall_metrics_write(FILE* out);
+
+// Serve the exposition over HTTP on port (any path), from a thread of its
+// own; port 0 picks a free one. address is an IPv4 address to bind, NULL
+// for loopback only. Returns the port, or 0 on failure.
+uint16_t polycall_metrics_serve(const char* address, uint16_t port);
+void polycall_metrics_stop_serving(void);
+
+#endif // POLYCALL_METRICS_H
\ No newline at end of file
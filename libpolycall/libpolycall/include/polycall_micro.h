@@ -13,49 +13,103 @@ extern "C" {
 #endif
 
 // Constants for micro service configuration
-#define POLYCALL_MICRO_MAX_SERVICES 32
+#ifndef POLYCALL_MICRO_MAX_SERVICES
+#define POLYCALL_MICRO_MAX_SERVICES 256         // Power of two, at most 32768
+#endif
+#define POLYCALL_MICRO_SERVICE_WORDS ((POLYCALL_MICRO_MAX_SERVICES + 63) / 64)
+#define POLYCALL_MICRO_ID_BUCKETS (POLYCALL_MICRO_MAX_SERVICES * 2)
 #define POLYCALL_MICRO_MAX_ENDPOINTS 16
 #define POLYCALL_MICRO_MAX_COMMANDS 64
-#define POLYCALL_MICRO_BUFFER_SIZE 4096
+#define POLYCALL_MICRO_BUFFER_SIZE 4096        // Largest command payload
+#define POLYCALL_MICRO_SLAB_CHUNK 65536         // Bytes carved per payload slab chunk
+#define POLYCALL_MICRO_QUEUE_SIZE 256           // Default ring capacity (power of two)
+#define POLYCALL_MICRO_TRANSFORM_BLOCK 32       // Commands taken through all stages at once
 
-// Data-oriented command structure for contiguous memory layout
+// Command header; the payload lives elsewhere. Commands handed to
+// polycall_micro_batch_process point at the caller's bytes, queued
+// commands at a slot in the context's payload slab.
 typedef struct {
     uint32_t id;
     uint32_t flags;
     uint32_t payload_size;
-    uint8_t payload[POLYCALL_MICRO_BUFFER_SIZE];
+    uint32_t checksum;                  // Set by POLYCALL_STAGE_CHECKSUM
+    uint8_t* payload;
 } PolycallCommand;
 
-// Command array for batch processing
+// Command array for batch processing; storage belongs to whoever built it
 typedef struct {
-    PolycallCommand commands[POLYCALL_MICRO_MAX_COMMANDS];
+    PolycallCommand* commands;
     uint32_t count;
     uint32_t capacity;
 } PolycallCommandArray;
 
-// Service state structure with minimal indirection
+typedef struct PolycallPayloadSlab PolycallPayloadSlab;
+typedef struct PolycallCommandRing PolycallCommandRing;
+
+// Accounting for per-service arenas. Each service gets a space from
+// space_create; the arena charges and uncharges it one slab chunk at a
+// time, so a refused charge is the service's cap and everything else runs
+// at slab speed. polycall_diram.h provides one backed by diram spaces.
+typedef struct {
+    void* (*space_create)(uint32_t service_id, size_t limit, void* user_data);
+    bool (*charge)(void* space, size_t bytes);
+    void (*uncharge)(void* space, size_t bytes);
+    void (*space_destroy)(void* space);
+    void* user_data;
+} PolycallMemoryBackend;
+
+// Command taken off a service ring. payload points into buffer, which the
+// consumer releases once it is done with the bytes.
+typedef struct {
+    PolycallCommand command;
+    NetworkBuffer* buffer;
+} PolycallQueuedCommand;
+
+// Called with full true when an enqueue finds the ring full, and with
+// false once consumers have drained it to half. A reactor stops reading
+// the service's connections in between.
+typedef void (*PolycallBackpressureHandler)(uint32_t service_id, bool full, void* user_data);
+
+// Per-service data off the hot path, allocated when the service is
+// created. Endpoints and the queue grow on demand up to their limits.
 typedef struct {
     uint32_t id;
-    uint32_t flags;
-    uint32_t state;
-    uint64_t last_update;
-    NetworkEndpoint endpoints[POLYCALL_MICRO_MAX_ENDPOINTS];
+    NetworkEndpoint* endpoints;
     uint32_t endpoint_count;
+    uint32_t endpoint_capacity;
     PolycallCommandArray command_queue;
-    uint8_t memory_pool[POLYCALL_MICRO_BUFFER_SIZE];
+    PolycallCommandRing* ring;          // From polycall_micro_open_queue, or NULL
+    PolycallPayloadSlab* arena;         // Own payload/queue arena, or NULL to share the context's
 } PolycallServiceState;
 
-// Service array for contiguous state storage
+// Stable reference to a service: slot in the low 16 bits, the slot's
+// generation in the high 16. A handle to a destroyed service stops
+// resolving even after its slot is reused. 0 is never a valid handle.
+typedef uint32_t PolycallServiceHandle;
+
+// Services as parallel arrays indexed by slot: lookups and GC scans touch
+// only the ids and timestamps, never the cold per-service data. id_index
+// is an open-addressed table from service ID to slot + 1 (0 is empty).
 typedef struct {
-    PolycallServiceState services[POLYCALL_MICRO_MAX_SERVICES];
+    uint32_t ids[POLYCALL_MICRO_MAX_SERVICES];
+    uint16_t generations[POLYCALL_MICRO_MAX_SERVICES];
+    uint32_t flags[POLYCALL_MICRO_MAX_SERVICES];
+    uint32_t states[POLYCALL_MICRO_MAX_SERVICES];
+    uint64_t last_update[POLYCALL_MICRO_MAX_SERVICES];
+    PolycallServiceState* services[POLYCALL_MICRO_MAX_SERVICES];
+    uint64_t active[POLYCALL_MICRO_SERVICE_WORDS];  // Bit per occupied slot
+    uint16_t id_index[POLYCALL_MICRO_ID_BUCKETS];
     uint32_t count;
-    uint32_t active_mask;
     uint64_t last_gc;
 } PolycallServiceArray;
 
 // Micro service context with data-oriented layout
 typedef struct {
     PolycallServiceArray service_array;
+    PolycallPayloadSlab* payloads;      // Shared by services without an arena
+    const PolycallMemoryBackend* memory_backend;   // Set: new services get an arena
+    size_t service_memory_limit;
+    NetworkBufferPool* ring_buffers;    // Payload copies for ring commands
     PolyCall_StateMachine* state_machine;
     polycall_protocol_context_t protocol_ctx;
     uint32_t flags;
@@ -73,6 +127,40 @@ typedef struct {
     uint32_t transform_count;
 } PolycallTransformChain;
 
+// Batch stages. Built-in kinds run as plain loops over the payloads, with
+// no call per command, and are written so the compiler can vectorize them.
+typedef void (*PolycallBatchTransform)(PolycallCommand* commands, uint32_t count, void* arg);
+
+typedef enum {
+    POLYCALL_STAGE_CALL,                // call for each command
+    POLYCALL_STAGE_BATCH,               // batch once per block of commands
+    POLYCALL_STAGE_BSWAP32,             // Byte-swap each whole 32-bit payload word
+    POLYCALL_STAGE_XOR,                 // XOR the payload with key, repeated
+    POLYCALL_STAGE_CHECKSUM,            // CRC32C of the payload into checksum
+    POLYCALL_STAGE_FILTER_FLAGS         // Keep commands with (flags & mask) == value
+} PolycallStageKind;
+
+typedef struct {
+    PolycallStageKind kind;
+    union {
+        PolycallTransform call;
+        struct {
+            PolycallBatchTransform fn;
+            void* arg;
+        } batch;
+        uint32_t key;
+        struct {
+            uint32_t mask;
+            uint32_t value;
+        } filter;
+    };
+} PolycallTransformStage;
+
+typedef struct {
+    const PolycallTransformStage* stages;
+    uint32_t stage_count;
+} PolycallStageChain;
+
 // Status codes
 typedef enum {
     POLYCALL_MICRO_SUCCESS = 0,
@@ -80,7 +168,9 @@ typedef enum {
     POLYCALL_MICRO_ERROR_SERVICE,
     POLYCALL_MICRO_ERROR_COMMAND,
     POLYCALL_MICRO_ERROR_PROTOCOL,
-    POLYCALL_MICRO_ERROR_MEMORY
+    POLYCALL_MICRO_ERROR_MEMORY,
+    POLYCALL_MICRO_ERROR_FULL,          // Ring full; retry after backpressure clears
+    POLYCALL_MICRO_ERROR_LIMIT          // Service arena refused to grow past its cap
 } PolycallMicroStatus;
 
 // Core initialization and cleanup functions
@@ -103,29 +193,126 @@ PolycallMicroStatus polycall_micro_destroy_service(
     uint32_t service_id
 );
 
+// Cold data for a service, or NULL
+PolycallServiceState* polycall_micro_get_service(
+    PolycallMicroContext* ctx,
+    uint32_t service_id
+);
+
+// Handle for a service ID, 0 if there is none
+PolycallServiceHandle polycall_micro_service_handle(
+    const PolycallMicroContext* ctx,
+    uint32_t service_id
+);
+
+// O(1) handle resolution; NULL once the service is gone
+PolycallServiceState* polycall_micro_resolve(
+    PolycallMicroContext* ctx,
+    PolycallServiceHandle handle
+);
+
+// Copy an endpoint into the service (at most POLYCALL_MICRO_MAX_ENDPOINTS)
+PolycallMicroStatus polycall_micro_add_endpoint(
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
+    const NetworkEndpoint* endpoint
+);
+
+// Services created from now on get their own arena for queued payloads
+// and the command queue, charged to a backend space capped at limit
+// bytes; destroying the service frees the arena and its space at once.
+// NULL goes back to the shared slab. backend must outlive the services.
+void polycall_micro_set_memory_backend(
+    PolycallMicroContext* ctx,
+    const PolycallMemoryBackend* backend,
+    size_t limit
+);
+
+// Bytes the service's arena has charged, 0 without one
+size_t polycall_micro_service_memory(const PolycallServiceState* service);
+
 // Point-free style command processing functions
 PolycallMicroStatus polycall_micro_transform_command(
     PolycallCommand* cmd,
     const PolycallTransformChain* chain
 );
 
+// Run a chain over a whole array, stage by stage. Commands go through
+// all stages in blocks of POLYCALL_MICRO_TRANSFORM_BLOCK, so a block's
+// payloads stay in cache between stages; filter stages compact the array.
+PolycallMicroStatus polycall_micro_transform_batch(
+    PolycallCommandArray* commands,
+    const PolycallStageChain* chain
+);
+
+// Same for a chain of per-command transforms
+PolycallMicroStatus polycall_micro_transform_commands(
+    PolycallCommandArray* commands,
+    const PolycallTransformChain* chain
+);
+
 PolycallMicroStatus polycall_micro_filter_commands(
     PolycallCommandArray* commands,
     PolycallPredicate predicate
 );
 
 PolycallMicroStatus polycall_micro_process_commands(
-    PolycallServiceState* service,
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
     PolycallOperation operation
 );
 
-// Batch processing functions
+// Batch processing functions. Payloads are copied into the shared slab,
+// so the caller's command array may be reused right away.
 PolycallMicroStatus polycall_micro_batch_process(
     PolycallMicroContext* ctx,
     uint32_t service_id,
     const PolycallCommandArray* commands
 );
 
+// Drop a service's queued commands and give their slots back to the slab
+PolycallMicroStatus polycall_micro_clear_commands(
+    PolycallMicroContext* ctx,
+    uint32_t service_id
+);
+
+/*
+ * Cross-thread queues. Each service can have a bounded lock-free ring
+ * that any number of threads enqueue to and dequeue from, so I/O threads
+ * hand commands to service workers without a lock. Open the queue and set
+ * the handler before other threads see the service, and stop them before
+ * destroying it.
+ */
+PolycallMicroStatus polycall_micro_open_queue(
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
+    uint32_t capacity                   // Rounded up to a power of two, 0 for the default
+);
+
+void polycall_micro_set_backpressure(
+    PolycallServiceState* service,
+    PolycallBackpressureHandler handler,
+    void* user_data
+);
+
+// With buffer set, cmd->payload must lie inside it and the buffer is
+// retained instead of copying; otherwise the payload is copied
+PolycallMicroStatus polycall_micro_enqueue(
+    PolycallServiceState* service,
+    const PolycallCommand* cmd,
+    NetworkBuffer* buffer
+);
+
+// Take up to max commands in one claim; returns how many
+uint32_t polycall_micro_dequeue_batch(
+    PolycallServiceState* service,
+    PolycallQueuedCommand* out,
+    uint32_t max
+);
+
+// Commands waiting in the ring (approximate while others run)
+uint32_t polycall_micro_queue_depth(const PolycallServiceState* service);
+
 // State management functions
 PolycallMicroStatus polycall_micro_update_service_state(
     PolycallMicroContext* ctx,
@@ -161,4 +348,4 @@ void polycall_micro_destroy_transform_chain(
 }
 #endif
 
-#endif // POLYCALL_MICRO_H
\ No newline at end of file
+#endif // POLYCALL_MICRO_H
\ No newline at end of file
@@ -31,9 +31,14 @@ typedef enum {
     AST_ATTR_STATIC   = 0x04,
     AST_ATTR_CONST    = 0x08,
     AST_ATTR_VOLATILE = 0x10,
-    AST_ATTR_EXPORTED = 0x20
+    AST_ATTR_EXPORTED = 0x20,
+    AST_ATTR_SHARED   = 0x40        // Linked from more than one parent
 } PolycallASTAttributes;
 
+// Nodes are addressed by their index in the owning AST
+typedef uint32_t PolycallASTIndex;
+#define POLYCALL_AST_NO_NODE UINT32_MAX
+
 // AST node structure optimized for cache alignment
 typedef struct PolycallASTNode {
     PolycallASTType type;           // 4 bytes - Node type
@@ -41,18 +46,48 @@ typedef struct PolycallASTNode {
     PolycallValue value;            // 24 bytes - Node value
     uint32_t line;                  // 4 bytes - Source location
     uint32_t column;                // 4 bytes - Source location
+    PolycallASTIndex parent;        // 4 bytes - Parent node
+    uint32_t first_child;           // 4 bytes - Start of the child range in links
     uint32_t child_count;           // 4 bytes - Number of children
-    struct PolycallASTNode** children; // 8 bytes - Child nodes
-    struct PolycallASTNode* parent;   // 8 bytes - Parent node
-} PolycallASTNode;                  // Total: 60 bytes
-
-// AST structure for batch operations
+    uint32_t child_capacity;        // 4 bytes - Links reserved for the range
+} PolycallASTNode;                  // Total: 56 bytes
+
+// Arena-owned AST. Every node lives in one contiguous array and refers
+// to others by index; the children of a node are the index range
+// links[first_child, first_child + child_count). Node pointers are only
+// good until the next node is added, since the arrays may move.
+//
+// Expression and control-flow shape understood by the optimizer:
+// an AST_EXPRESSION without children is a literal or, with a
+// VALUE_IDENTIFIER value, a name; one with one or two children applies
+// the operator whose text is its VALUE_IDENTIFIER value ("-", "+",
+// "==", "&&", ...). An AST_CONTROL_FLOW node has the condition as its
+// first child, the body taken when it holds as the second and an
+// optional else branch as the third; a "while" value makes it a loop.
+//
+// A node with AST_ATTR_SHARED may appear under several parents (its
+// parent field names the first); copies keep it shared.
+//
+// map, filter, apply_transforms and optimize never modify their input:
+// they walk it breadth first and write the result into a fresh arena in
+// one linear pass, so its nodes end up in breadth-first order with each
+// child range packed right behind the previous one.
 typedef struct {
-    PolycallASTNode* root;          // Root node
-    PolycallASTNode** nodes;        // Flat array of all nodes
+    PolycallASTNode* nodes;         // Node storage
     uint32_t node_count;            // Number of nodes
     uint32_t capacity;              // Node array capacity
+    PolycallASTIndex* links;        // Child ranges
+    uint32_t link_count;            // Links in use
+    uint32_t link_capacity;         // Link array capacity
+    PolycallASTIndex root;          // Root node, POLYCALL_AST_NO_NODE when empty
     uint32_t error_count;           // Number of error nodes
+    struct {                        // Reachable nodes after each optimizer pass
+        uint32_t input;             // Before optimizing
+        uint32_t collapsed;         // Level 1: single-child blocks spliced out
+        uint32_t folded;            // Level 2: constant expressions folded
+        uint32_t pruned;            // Level 3: dead branches removed
+        uint32_t shared;            // Level 3: common subexpressions shared
+    } optimize_stats;
 } PolycallAST;
 
 // Parser configuration for customization
@@ -64,8 +99,11 @@ typedef struct {
     void* user_data;                // User context data
 } PolycallParserConfig;
 
-// Point-free style transformation types
-typedef PolycallASTNode* (*ASTTransform)(const PolycallASTNode*);
+// Point-free style transformation types. A transform edits the copy of a
+// node in the output arena; returning false drops it and its subtree.
+// Links (parent and children) are maintained by the caller and must not
+// be changed.
+typedef bool (*ASTTransform)(PolycallASTNode*);
 typedef bool (*ASTPredicate)(const PolycallASTNode*);
 typedef void (*ASTVisitor)(PolycallASTNode*, void*);
 
@@ -75,10 +113,15 @@ typedef struct {
     uint32_t count;                 // Number of transforms
 } PolycallASTTransforms;
 
+// Files already parsed by polycall_parser_parse_file
+typedef struct PolycallParseCacheEntry PolycallParseCacheEntry;
+
 // Parser context with data locality
 typedef struct {
     PolycallTokenizer* tokenizer;   // Tokenizer instance
+    TokenizerOperations* ops;       // Built-in token matchers
     PolycallAST* ast;               // Current AST
+    PolycallParseCacheEntry* cache; // Parsed files, most recent first
     const PolycallParserConfig* config; // Parser configuration
     struct {
         char* message;              // Error message
@@ -92,18 +135,47 @@ PolycallParser* polycall_parser_create(const PolycallParserConfig* config);
 void polycall_parser_destroy(PolycallParser* parser);
 
 // File parsing functions
+//
+// parse_file maps the file read-only and tokenizes the mapping in place;
+// node values point into it. The AST stays in the parser's cache with
+// the file's device, inode, size and mtime, so parsing an unchanged file
+// again returns the same AST without reading it. When only the metadata
+// changed (the file was touched or rewritten with the same bytes), a
+// CRC32C of the contents keeps the cached AST too. Otherwise the file is
+// parsed again and the previous AST for it is freed, so callers must not
+// keep it (or destroy any AST from this function). If the new contents
+// fail to parse, the previous AST stays cached and NULL is returned.
+// Replace config files (write and rename) instead of rewriting them in
+// place: the cached AST reads from the mapping.
 PolycallAST* polycall_parser_parse_file(PolycallParser* parser, const char* filename);
 PolycallAST* polycall_parser_parse_string(PolycallParser* parser, const char* input, size_t length);
 
-// AST manipulation functions
-PolycallASTNode* polycall_ast_create_node(PolycallASTType type, const PolycallValue* value);
-void polycall_ast_destroy_node(PolycallASTNode* node);
-bool polycall_ast_add_child(PolycallASTNode* parent, PolycallASTNode* child);
+// Drop every cached file AST and its mapping
+void polycall_parser_clear_cache(PolycallParser* parser);
+
+// Arena management
+PolycallAST* polycall_ast_create(uint32_t capacity);
+void polycall_ast_destroy(PolycallAST* ast);
+
+// AST manipulation functions. add_node returns POLYCALL_AST_NO_NODE when
+// out of memory. add_child grows the parent's range in place while it
+// has room, and otherwise moves it to the end of links with twice the
+// room, so repeated adds stay amortized O(1); set_children writes a
+// whole range at once with no room to spare.
+PolycallASTIndex polycall_ast_add_node(PolycallAST* ast, PolycallASTType type, const PolycallValue* value);
+bool polycall_ast_add_child(PolycallAST* ast, PolycallASTIndex parent, PolycallASTIndex child);
+bool polycall_ast_set_children(PolycallAST* ast, PolycallASTIndex parent,
+                               const PolycallASTIndex* children, uint32_t count);
+
+// Node access; NULL or an empty range for an index out of range
+PolycallASTNode* polycall_ast_node(const PolycallAST* ast, PolycallASTIndex index);
+const PolycallASTIndex* polycall_ast_children(const PolycallAST* ast, PolycallASTIndex index, uint32_t* count);
 
 // Point-free style operations
-PolycallASTNode* polycall_ast_map(const PolycallASTNode* node, ASTTransform transform);
+PolycallAST* polycall_ast_map(const PolycallAST* ast, ASTTransform transform);
 PolycallAST* polycall_ast_filter(const PolycallAST* ast, ASTPredicate predicate);
-void polycall_ast_visit(PolycallASTNode* node, ASTVisitor visitor, void* user_data);
+// Pre-order from node
+void polycall_ast_visit(PolycallAST* ast, PolycallASTIndex node, ASTVisitor visitor, void* user_data);
 
 // Transform chain operations
 PolycallASTTransforms* polycall_ast_create_transforms(ASTTransform* transforms, uint32_t count);
@@ -114,11 +186,18 @@ PolycallAST* polycall_ast_apply_transforms(const PolycallAST* ast, const Polycal
 bool polycall_ast_validate(const PolycallAST* ast);
 const char* polycall_parser_get_error(const PolycallParser* parser);
 
-// AST query functions
-PolycallASTNode* polycall_ast_find_node(const PolycallAST* ast, PolycallASTType type);
-PolycallASTNode** polycall_ast_find_nodes(const PolycallAST* ast, PolycallASTType type, uint32_t* count);
-
-// Optimization functions
+// AST query functions; find_nodes returns a malloc'd index array
+PolycallASTIndex polycall_ast_find_node(const PolycallAST* ast, PolycallASTType type);
+PolycallASTIndex* polycall_ast_find_nodes(const PolycallAST* ast, PolycallASTType type, uint32_t* count);
+
+// Optimization functions. Each level includes the ones below it:
+// 1 splices out blocks with a single child, 2 folds operators over
+// literal operands (integer overflow, division by zero and non-numeric
+// operands other than string ==/!= are left for runtime), 3 removes
+// branches whose condition folded to a constant and makes repeated
+// subexpressions within a function share one node. Subexpressions
+// naming variables are only shared in functions without assignments.
+// The result records node counts per pass in optimize_stats.
 PolycallAST* polycall_ast_optimize(const PolycallAST* ast, uint32_t level);
 
 #ifdef __cplusplus
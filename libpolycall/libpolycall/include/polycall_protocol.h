@@ -4,12 +4,16 @@
 #include "polycall.h"
 #include "polycall_state_machine.h"
 #include "network.h"
+#include "network_shm.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 // Protocol version
 #define POLYCALL_PROTOCOL_VERSION 1
 
+// Payload limit when the configuration leaves max_message_size at 0
+#define POLYCALL_PROTOCOL_DEFAULT_MAX_MESSAGE (1024 * 1024)
+
 // Protocol message types
 typedef enum {
     POLYCALL_MSG_HANDSHAKE = 0x01,
@@ -17,9 +21,22 @@ typedef enum {
     POLYCALL_MSG_COMMAND = 0x03,
     POLYCALL_MSG_RESPONSE = 0x04,
     POLYCALL_MSG_ERROR = 0x05,
-    POLYCALL_MSG_HEARTBEAT = 0x06
+    POLYCALL_MSG_HEARTBEAT = 0x06,
+    POLYCALL_MSG_BATCH = 0x07,      // Several commands in one frame
+    POLYCALL_MSG_SHM = 0x08         // Shared-memory transport setup
 } polycall_message_type_t;
 
+// Protocol extensions, offered in the handshake flags. Each side only uses
+// what both offered, so a peer that offers nothing sees the base protocol.
+typedef enum {
+    POLYCALL_CAP_NONE = 0x00,
+    POLYCALL_CAP_PIPELINE = 0x01,   // Responses carry the request's sequence, in any order
+    POLYCALL_CAP_BATCH = 0x02,      // POLYCALL_MSG_BATCH frames
+    POLYCALL_CAP_CRC32C = 0x04,     // CRC32C checksums
+    POLYCALL_CAP_LOCAL_UNCHECKED = 0x08, // No checksums over loopback or Unix sockets
+    POLYCALL_CAP_SHARED_MEMORY = 0x10    // Frames through a shared ring pair, same host only
+} polycall_protocol_capability_t;
+
 // Protocol states
 typedef enum {
     POLYCALL_STATE_INIT = 0,
@@ -36,7 +53,9 @@ typedef enum {
     POLYCALL_FLAG_ENCRYPTED = 0x01,
     POLYCALL_FLAG_COMPRESSED = 0x02,
     POLYCALL_FLAG_URGENT = 0x04,
-    POLYCALL_FLAG_RELIABLE = 0x08
+    POLYCALL_FLAG_RELIABLE = 0x08,
+    POLYCALL_FLAG_CRC32C = 0x10,    // checksum is CRC32C rather than the rotate-and-add sum
+    POLYCALL_FLAG_UNCHECKED = 0x20  // checksum left out (POLYCALL_CAP_LOCAL_UNCHECKED)
 } polycall_protocol_flags_t;
 
 // Protocol message header
@@ -49,6 +68,12 @@ typedef struct {
     uint32_t checksum;
 } polycall_message_header_t;
 
+// Entry of a POLYCALL_MSG_BATCH payload; length command bytes follow
+typedef struct {
+    uint32_t sequence;              // Key for the response
+    uint32_t length;
+} polycall_batch_entry_t;
+
 // Protocol session context
 typedef struct {
     polycall_context_t pc_ctx;
@@ -57,6 +82,9 @@ typedef struct {
     uint32_t next_sequence;
     polycall_protocol_state_t state;
     void* user_data;
+    NetworkBuffer* current_buffer;  // Holds the message being dispatched, or NULL
+    uint32_t current_sequence;      // Sequence of the command being dispatched
+    void* internal;                 // Callbacks and error state
 } polycall_protocol_context_t;
 
 // Protocol callbacks
@@ -67,17 +95,27 @@ typedef struct {
     void (*on_error)(polycall_protocol_context_t* ctx, const char* error);
     void (*on_state_change)(polycall_protocol_context_t* ctx, polycall_protocol_state_t old_state, 
                            polycall_protocol_state_t new_state);
+    void (*on_response)(polycall_protocol_context_t* ctx, uint32_t sequence,
+                        const char* response, size_t length);
 } polycall_protocol_callbacks_t;
 
 // Protocol configuration
 typedef struct {
     polycall_protocol_callbacks_t callbacks;
     polycall_protocol_flags_t flags;
-    size_t max_message_size;
+    size_t max_message_size;        // Largest payload accepted, 0 for the default
     uint32_t timeout_ms;
     void* user_data;
+    uint16_t capabilities;          // POLYCALL_CAP_* offered in the handshake
 } polycall_protocol_config_t;
 
+// Pending POLYCALL_MSG_BATCH frame
+typedef struct {
+    polycall_protocol_context_t* ctx;
+    NetworkBuffer* payload;         // Entries so far
+    size_t count;
+} polycall_protocol_batch_t;
+
 // Initialize protocol context
 bool polycall_protocol_init(
     polycall_protocol_context_t* ctx,
@@ -98,13 +136,69 @@ bool polycall_protocol_send(
     polycall_protocol_flags_t flags
 );
 
-// Process incoming protocol message
+// Process one complete incoming protocol message
 bool polycall_protocol_process(
     polycall_protocol_context_t* ctx,
     const void* data,
     size_t length
 );
 
+// Feed one read from the connection's byte stream. Every complete message
+// is dispatched; a message cut off at the end is kept until later reads
+// complete it. Callbacks get pointers into the packet's buffer (or the
+// reassembly buffer) and may net_buffer_retain(ctx->current_buffer) to keep
+// them. Returns false on a malformed or oversized message, after which the
+// stream is out of sync and the connection should be closed.
+bool polycall_protocol_process_packet(
+    polycall_protocol_context_t* ctx,
+    NetworkPacket* packet
+);
+
+// Bytes held for a message that has not fully arrived
+size_t polycall_protocol_pending(const polycall_protocol_context_t* ctx);
+
+// Pipelining: send a command without waiting for earlier ones to be
+// answered. Returns its sequence, which the response callback reports, or
+// 0 on failure. The handler answers with polycall_protocol_respond, using
+// ctx->current_sequence, in whatever order the work finishes.
+uint32_t polycall_protocol_send_command(
+    polycall_protocol_context_t* ctx,
+    const void* command,
+    size_t length
+);
+bool polycall_protocol_respond(
+    polycall_protocol_context_t* ctx,
+    uint32_t sequence,
+    const void* response,
+    size_t length
+);
+
+// Batching: queue commands and send them as one frame. begin fails unless
+// both sides offered POLYCALL_CAP_BATCH; add returns the command's
+// sequence or 0. send and discard both release the batch.
+bool polycall_protocol_batch_begin(polycall_protocol_context_t* ctx, polycall_protocol_batch_t* batch);
+uint32_t polycall_protocol_batch_add(polycall_protocol_batch_t* batch, const void* command, size_t length);
+bool polycall_protocol_batch_send(polycall_protocol_batch_t* batch);
+void polycall_protocol_batch_discard(polycall_protocol_batch_t* batch);
+
+// Shared memory: once both sides offered POLYCALL_CAP_SHARED_MEMORY, either
+// may offer a ring pair (see network_shm.h) over the connection. The peer
+// attaches by itself, and each direction moves to its ring behind a marker
+// frame, so nothing is reordered; when anything fails both directions stay
+// on the socket. Ring frames carry no checksum and are dispatched in place
+// with ctx->current_buffer NULL, so callbacks copy what they keep.
+bool polycall_protocol_offer_shm(polycall_protocol_context_t* ctx);
+
+// Dispatch what has arrived over the ring, waiting up to timeout_ms (-1
+// forever) for the first frame. Frames from the ring are only seen here, so
+// call it alongside the socket reads. Returns the number dispatched, 0
+// while the ring is not in use, or -1 when the peer left the ring or sent a
+// bad frame; the connection should be closed then.
+int polycall_protocol_poll_shm(polycall_protocol_context_t* ctx, int timeout_ms);
+
+// Extensions both sides offered; none until the peer's handshake arrives
+uint16_t polycall_protocol_capabilities(const polycall_protocol_context_t* ctx);
+
 // Update protocol state
 void polycall_protocol_update(polycall_protocol_context_t* ctx);
 
@@ -138,11 +232,14 @@ void polycall_protocol_set_error(
 );
 
 // Protocol utility functions
+// Rotate-and-add sum of the base protocol; messages flagged
+// POLYCALL_FLAG_CRC32C carry polycall_crc32c instead
 uint32_t polycall_protocol_calculate_checksum(
     const void* data,
     size_t length
 );
 
+// Checks with the algorithm named by header->flags
 bool polycall_protocol_verify_checksum(
     const polycall_message_header_t* header,
     const void* payload,
@@ -8,6 +8,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "polycall.h"
 
 #ifdef __cplusplus
@@ -36,11 +38,84 @@ typedef struct PolyCall_Transition {
     bool is_valid;
     bool (*guard_condition)(const PolyCall_State*, const PolyCall_State*);
     uint32_t guard_checksum;
+    unsigned int event_id;          // Interned name, assigned by polycall_sm_compile
+    uint32_t checksum;              // Over name, endpoints, callbacks and is_valid
 } PolyCall_Transition;
 
+#define POLYCALL_SM_NO_EVENT ((unsigned int)-1)
+#define POLYCALL_SM_NO_TRANSITION 0xFF
+
+// Dense lookup built by polycall_sm_compile. Transitions that share a name
+// share an event ID, so one event can leave several states.
+typedef struct PolyCall_CompiledTable {
+    bool is_compiled;
+    unsigned int num_events;
+    uint8_t first[POLYCALL_MAX_TRANSITIONS];    // Event -> first transition with that name
+    uint8_t next[POLYCALL_MAX_STATES][POLYCALL_MAX_TRANSITIONS];  // [state][event] -> transition
+} PolyCall_CompiledTable;
+
+#define POLYCALL_SM_THREAD_SLOTS 64     // Per-thread counter slots (shared past that)
+#define POLYCALL_SM_CAS_RETRIES 8       // Re-resolve attempts after losing a race
+
+// Counters owned by one thread, on their own cache line
+typedef struct PolyCall_ThreadCounters {
+    _Alignas(64) _Atomic uint64_t transitions;
+    _Atomic uint64_t failed_transitions;
+    _Atomic uint64_t conflicts;         // Lost a commit to another thread
+    _Atomic uint64_t blocked_transitions; // Refused because a state was locked
+} PolyCall_ThreadCounters;
+
+// Totals over all threads, from polycall_sm_get_machine_diagnostics.
+// Refused events are counted here and only logged at debug level.
+typedef struct PolyCall_MachineDiagnostics {
+    uint64_t transitions;
+    uint64_t failed_transitions;
+    uint64_t conflicts;
+    uint64_t blocked_transitions;
+    uint64_t integrity_violations;
+} PolyCall_MachineDiagnostics;
+
+// Whole-machine snapshots share fixed pages of states and transitions
+#define POLYCALL_SM_PAGE_ENTRIES 8
+#define POLYCALL_SM_STATE_PAGES \
+    ((POLYCALL_MAX_STATES + POLYCALL_SM_PAGE_ENTRIES - 1) / POLYCALL_SM_PAGE_ENTRIES)
+#define POLYCALL_SM_TRANSITION_PAGES \
+    ((POLYCALL_MAX_TRANSITIONS + POLYCALL_SM_PAGE_ENTRIES - 1) / POLYCALL_SM_PAGE_ENTRIES)
+
+typedef struct PolyCall_MachineSnapshot PolyCall_MachineSnapshot;
+
+// A machine fixed at build time: tools/polycall_smgen.c (make statemachine)
+// writes these as static const tables from a Polycallfile, together with
+// enums whose values are the state and event IDs used here. Events are
+// numbered by first appearance, as polycall_sm_compile numbers them.
+typedef struct PolyCall_StaticTransition {
+    const char* name;
+    unsigned int event_id;
+    unsigned int from_state;
+    unsigned int to_state;
+    PolyCall_StateAction action;
+    bool (*guard_condition)(const PolyCall_State*, const PolyCall_State*);
+} PolyCall_StaticTransition;
+
+typedef struct PolyCall_StaticMachine {
+    const PolyCall_State* states;               // Checksums and timestamps unset
+    unsigned int num_states;
+    const PolyCall_StaticTransition* transitions;
+    unsigned int num_transitions;
+    const char* const* event_names;
+    unsigned int num_events;
+    unsigned int initial_state;
+    const uint8_t* next;    // [state * num_events + event] -> transition, or POLYCALL_SM_NO_TRANSITION
+} PolyCall_StaticMachine;
+
 // State integrity verification function type
 typedef bool (*PolyCall_StateIntegrityCheck)(const PolyCall_State* state);
 
+// Called by the auditor for each state or transition whose checksum is off
+struct PolyCall_StateMachine;
+typedef void (*PolyCall_IntegrityViolation)(struct PolyCall_StateMachine* sm,
+                                            bool is_transition, unsigned int index);
+
 // State machine structure
 typedef struct PolyCall_StateMachine {
     PolyCall_State states[POLYCALL_MAX_STATES];
@@ -52,11 +127,39 @@ typedef struct PolyCall_StateMachine {
     bool is_initialized;
     PolyCall_StateIntegrityCheck integrity_check;
     uint32_t machine_checksum;
+    PolyCall_CompiledTable compiled;
     struct {
         unsigned int failed_transitions;
         unsigned int integrity_violations;
         uint64_t last_verification;
     } diagnostics;
+
+    // Concurrent mode: the current state (low 32 bits) and a machine
+    // version (high 32 bits) share one word, and a transition commits by
+    // compare-and-swap. current_state trails the word and is only a hint.
+    bool concurrent;
+    _Atomic uint64_t state_word;
+    PolyCall_ThreadCounters thread_counters[POLYCALL_SM_THREAD_SLOTS];
+
+    // Integrity: machine_checksum folds every state and transition checksum
+    // and is adjusted as they change, so an audit can check it without the
+    // hot path ever rescanning the machine
+    pthread_mutex_t audit_lock;     // Audits against adding and restoring
+    pthread_cond_t audit_wake;
+    pthread_t auditor;
+    bool auditor_started;
+    bool auditor_stopping;          // Guarded by audit_lock
+    unsigned int audit_interval_ms;
+    PolyCall_IntegrityViolation on_violation;
+
+    // Whole-machine snapshots: base is the snapshot taken or restored last,
+    // and clean_*_page[p] is its page that live page p still matches, or
+    // NULL once the page has been written since. A snapshot copies only the
+    // NULL pages; restore copies only the pages that differ.
+    PolyCall_MachineSnapshot* base_snapshot;
+    const void* clean_state_page[POLYCALL_SM_STATE_PAGES];
+    const void* clean_transition_page[POLYCALL_SM_TRANSITION_PAGES];
+    uint64_t generation;
 } PolyCall_StateMachine;
 
 // Status codes
@@ -70,7 +173,8 @@ typedef enum {
     POLYCALL_SM_ERROR_NOT_INITIALIZED,
     POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED,
     POLYCALL_SM_ERROR_STATE_LOCKED,
-    POLYCALL_SM_ERROR_VERSION_MISMATCH
+    POLYCALL_SM_ERROR_VERSION_MISMATCH,
+    POLYCALL_SM_ERROR_CONFLICT          // Lost every retry, or setup change in concurrent mode
 } polycall_sm_status_t;
 
 // State snapshot structure
@@ -98,6 +202,32 @@ polycall_sm_status_t polycall_sm_create_with_integrity(
     PolyCall_StateIntegrityCheck integrity_check
 );
 
+// A runtime machine with a static machine's states and transitions, in
+// its initial state, for snapshots, the auditor or concurrent mode. The
+// table is copied in rather than compiled, and IDs match the generated
+// enums.
+polycall_sm_status_t polycall_sm_create_from_static(
+    polycall_context_t ctx,
+    PolyCall_StateMachine** sm,
+    const PolyCall_StaticMachine* machine,
+    PolyCall_StateIntegrityCheck integrity_check
+);
+
+// Take event_id out of *state straight from the tables: no setup and no
+// locks, and no integrity checks, the tables being read-only. The state
+// word is the caller's; the generated <prefix>_fire does the same with the
+// guards and actions inlined.
+polycall_sm_status_t polycall_sm_static_fire(
+    const PolyCall_StaticMachine* machine,
+    polycall_context_t ctx,
+    unsigned int* state,
+    unsigned int event_id
+);
+
+// Event ID for a transition name, or POLYCALL_SM_NO_EVENT
+unsigned int polycall_sm_static_event_id(const PolyCall_StaticMachine* machine,
+                                         const char* transition_name);
+
 polycall_sm_status_t polycall_sm_add_state(
     PolyCall_StateMachine* sm,
     const char* name,
@@ -115,6 +245,43 @@ polycall_sm_status_t polycall_sm_add_transition(
     bool (*guard_condition)(const PolyCall_State*, const PolyCall_State*)
 );
 
+// Intern transition names and build the [state][event] table. Adding a
+// state or transition afterwards drops the table; polycall_sm_fire
+// rebuilds it on next use.
+polycall_sm_status_t polycall_sm_compile(PolyCall_StateMachine* sm);
+
+// Event ID for a transition name, or POLYCALL_SM_NO_EVENT
+unsigned int polycall_sm_event_id(PolyCall_StateMachine* sm, const char* transition_name);
+
+// Take the transition for event_id out of the current state
+polycall_sm_status_t polycall_sm_fire(
+    PolyCall_StateMachine* sm,
+    unsigned int event_id
+);
+
+// Optimistic variant: commit only if the machine version is still
+// expected_version (from polycall_sm_current), else
+// POLYCALL_SM_ERROR_VERSION_MISMATCH
+polycall_sm_status_t polycall_sm_fire_if_version(
+    PolyCall_StateMachine* sm,
+    unsigned int event_id,
+    uint32_t expected_version
+);
+
+// Switch concurrent mode. In it polycall_sm_fire may run from any number
+// of threads: a transition is resolved from a snapshot of the state word
+// and committed by CAS, and a thread that loses re-resolves from the new
+// state up to POLYCALL_SM_CAS_RETRIES times. Actions run after the commit,
+// so guards and actions must be thread-safe. States and transitions cannot
+// be added while it is on. Switch only while no thread is firing.
+polycall_sm_status_t polycall_sm_set_concurrent(PolyCall_StateMachine* sm, bool enabled);
+
+// Current state and machine version, read together
+void polycall_sm_current(const PolyCall_StateMachine* sm, unsigned int* state, uint32_t* version);
+
+// Name-based wrapper over polycall_sm_fire. If the current state has no
+// transition of that name the first one declared with it is taken, as
+// before the table existed (outside concurrent mode).
 polycall_sm_status_t polycall_sm_execute_transition(
     PolyCall_StateMachine* sm,
     const char* transition_name
@@ -125,6 +292,20 @@ polycall_sm_status_t polycall_sm_verify_state_integrity(
     unsigned int state_id
 );
 
+// Full audit: every state and transition checksum, then machine_checksum.
+// Transitions themselves only check the two states they touch, and only
+// when the machine was created with an integrity_check.
+polycall_sm_status_t polycall_sm_verify_machine(PolyCall_StateMachine* sm);
+
+// Run polycall_sm_verify_machine every interval_ms on a background thread;
+// on_violation (may be NULL) hears about each bad entry
+polycall_sm_status_t polycall_sm_start_auditor(
+    PolyCall_StateMachine* sm,
+    unsigned int interval_ms,
+    PolyCall_IntegrityViolation on_violation
+);
+void polycall_sm_stop_auditor(PolyCall_StateMachine* sm);
+
 polycall_sm_status_t polycall_sm_lock_state(
     PolyCall_StateMachine* sm,
     unsigned int state_id
@@ -135,6 +316,46 @@ polycall_sm_status_t polycall_sm_unlock_state(
     unsigned int state_id
 );
 
+/*
+ * Whole-machine snapshots. Taking one costs a copy of the pages written
+ * since the previous snapshot; the rest are shared with it. Restoring one
+ * copies back only the pages that differ from it, and rolls back the
+ * current state too. Neither may run in concurrent mode.
+ */
+polycall_sm_status_t polycall_sm_snapshot_machine(
+    PolyCall_StateMachine* sm,
+    PolyCall_MachineSnapshot** snapshot
+);
+
+polycall_sm_status_t polycall_sm_restore_machine(
+    PolyCall_StateMachine* sm,
+    const PolyCall_MachineSnapshot* snapshot
+);
+
+void polycall_sm_release_machine_snapshot(PolyCall_MachineSnapshot* snapshot);
+
+// Increases with each snapshot taken from the machine
+uint64_t polycall_sm_machine_snapshot_generation(const PolyCall_MachineSnapshot* snapshot);
+
+// Portable encoding for a standby node. Callbacks are not carried: the
+// receiving machine must have been built with the same states and
+// transitions, and supplies them. With buffer NULL only *size is set.
+polycall_sm_status_t polycall_sm_serialize_machine_snapshot(
+    const PolyCall_MachineSnapshot* snapshot,
+    uint8_t* buffer,
+    size_t capacity,
+    size_t* size
+);
+
+// Decode a snapshot for sm; POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED for
+// damaged data, POLYCALL_SM_ERROR_INVALID_STATE when sm does not match it
+polycall_sm_status_t polycall_sm_deserialize_machine_snapshot(
+    PolyCall_StateMachine* sm,
+    const uint8_t* data,
+    size_t size,
+    PolyCall_MachineSnapshot** snapshot
+);
+
 polycall_sm_status_t polycall_sm_get_state_version(
     const PolyCall_StateMachine* sm,
     unsigned int state_id,
@@ -158,6 +379,12 @@ polycall_sm_status_t polycall_sm_get_state_diagnostics(
     PolyCall_StateDiagnostics* diagnostics
 );
 
+// Legacy and per-thread counters, summed
+polycall_sm_status_t polycall_sm_get_machine_diagnostics(
+    const PolyCall_StateMachine* sm,
+    PolyCall_MachineDiagnostics* diagnostics
+);
+
 void polycall_sm_destroy(PolyCall_StateMachine* sm);
 
 
@@ -166,4 +393,4 @@ void polycall_sm_destroy(PolyCall_StateMachine* sm);
 }
 #endif
 
-#endif // POLYCALL_STATE_MACHINE_H
\ No newline at end of file
+#endif // POLYCALL_STATE_MACHINE_H
\ No newline at end of file
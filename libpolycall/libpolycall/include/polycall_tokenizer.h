@@ -44,21 +44,42 @@ typedef struct {
     PolycallTokenType accepts;    // Token type accepted
 } TokenConsumer;
 
+// Built-in matchers compiled into one table-driven DFA
+typedef struct PolycallTokenizerDfa PolycallTokenizerDfa;
+
 // Operation chain for composition
+//
+// create_ops and compose_ops compile the built-in matchers
+// (polycall_tokenizer_match_*) into dfa: bytes map to character classes
+// and each byte costs one table lookup for all of them together. Other
+// matchers are still called through their pointers at each token start.
+// A token is the longest match over all patterns, the earlier pattern
+// winning a tie. Operations built by hand, without a dfa, keep the old
+// first-pattern-that-matches loop.
 typedef struct {
     TokenPattern* patterns;       // Pattern matchers
     TokenConsumer* consumers;     // Token consumers
     size_t count;                 // Number of operations
+    PolycallTokenizerDfa* dfa;    // Compiled built-ins, or NULL
 } TokenizerOperations;
 
 // Main tokenizer context
 typedef struct {
     struct {                      // Input management
         char* buffer;
-        size_t size;
+        size_t size;              // Buffer capacity
+        size_t length;            // Bytes of input in it
         size_t position;
     } input;
     
+    struct {                      // Streaming input
+        char* carry;              // Head of a token cut off by a chunk end
+        size_t carry_length;
+        char* window;             // Carry joined with the next chunk's head
+        char* scratch;            // Terminated copy for custom matchers
+        size_t limit;             // Longest token that may straddle chunks
+    } stream;
+    
     struct {                      // Position tracking
         size_t line;
         size_t column;
@@ -83,6 +104,30 @@ void polycall_tokenizer_reset(PolycallTokenizer* tokenizer);
 bool polycall_tokenizer_set_input(PolycallTokenizer* tokenizer, const char* input, size_t length);
 bool polycall_tokenizer_process(PolycallTokenizer* tokenizer, const TokenizerOperations* ops);
 
+// Streaming input, for data that arrives in pieces or is too big to stage.
+//
+// feed tokenizes a chunk in place: tokens point into the chunk itself, so
+// it must outlive them. A token cut off by the end of the chunk is kept
+// in a small carry buffer and finished by the next feed; only those
+// straddling tokens are copied, and they may be at most
+// max(limits.token, limits.string + 2) bytes long. Each call starts a
+// fresh token array; once it is full, *consumed stops short of length
+// and the rest of the chunk should be fed again after the tokens are
+// read. Tokens finished from the carry stay valid until the next call.
+//
+// finish tokenizes what is left in the carry and appends TOKEN_EOF, then
+// the state is TOKENIZER_STATE_EOF; if the array filled first, read the
+// tokens and call finish again. All three need operations with a
+// compiled dfa.
+bool polycall_tokenizer_feed(PolycallTokenizer* tokenizer, const TokenizerOperations* ops,
+                             const char* chunk, size_t length, size_t* consumed);
+// Same for the chunk that ends the input: nothing is carried, so every
+// token points into the chunk, and TOKEN_EOF follows once it is all
+// consumed (call finish if the array was too full for it)
+bool polycall_tokenizer_feed_last(PolycallTokenizer* tokenizer, const TokenizerOperations* ops,
+                                  const char* chunk, size_t length, size_t* consumed);
+bool polycall_tokenizer_finish(PolycallTokenizer* tokenizer, const TokenizerOperations* ops);
+
 // Pattern matching functions
 bool polycall_tokenizer_match_identifier(const char* input, size_t* length);
 bool polycall_tokenizer_match_number(const char* input, size_t* length);
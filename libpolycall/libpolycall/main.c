@@ -2,7 +2,13 @@
 #include "polycall_protocol.h"
 #include "polycall_state_machine.h"
 #include "polycall_tokenizer.h"
+#include "polycall_log.h"
+#include "polycall_metrics.h"
 #include "network.h"
+#include "network_handoff.h"
+#ifdef POLYCALL_SM_TABLE
+#include POLYCALL_SM_TABLE      // States and transitions from the Polycallfile
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,8 +23,9 @@
 #define PPI_VERSION "1.0.0"
 #define MAX_INPUT 256 
 #define MAX_PORTS 64
-#define MAX_PROGRAMS 8
+#define MAX_PROGRAMS MAX_PORTS
 #define HISTORY_SIZE 10
+#define HANDOFF_TIMEOUT_MS 10000
 
 // Port mapping structure using data-oriented design
 typedef struct {
@@ -58,6 +65,8 @@ typedef struct {
     bool wsaInitialized;
 #endif
     bool running;
+    NetworkHandoff* handoff;        // Where a successor can take over
+    bool draining;                  // Handed over; serving the last clients
 } PPI_Runtime;
 
 // Global runtime instance
@@ -152,6 +161,13 @@ static bool cmd_init(const PPI_Runtime* runtime, const char* arg1, const char* a
         return false;
     }
 
+#ifdef POLYCALL_SM_TABLE
+    if (polycall_sm_create_from_static(runtime->pc_ctx, &g_runtime.state_machine,
+                                       &ppi_machine, NULL) != POLYCALL_SM_SUCCESS) {
+        printf("Failed to initialize state machine\n");
+        return false;
+    }
+#else
     if (polycall_sm_create_with_integrity(runtime->pc_ctx, &g_runtime.state_machine, NULL) 
         != POLYCALL_SM_SUCCESS) {
         printf("Failed to initialize state machine\n");
@@ -164,6 +180,7 @@ static bool cmd_init(const PPI_Runtime* runtime, const char* arg1, const char* a
     polycall_sm_add_state(g_runtime.state_machine, "RUNNING", on_running, NULL, false);
     polycall_sm_add_state(g_runtime.state_machine, "PAUSED", on_paused, NULL, false);
     polycall_sm_add_state(g_runtime.state_machine, "ERROR", on_error, NULL, true);
+#endif
 
     printf("State machine initialized successfully\n");
     return true;
@@ -227,6 +244,9 @@ static bool cmd_help(const PPI_Runtime* runtime, const char* arg1, const char* a
     printf("  stop_network           - Stop network services\n");
     printf("  list_endpoints         - List all network endpoints\n");
     printf("  list_clients          - List connected clients\n");
+    printf("  metrics               - Print runtime metrics\n");
+    printf("  metrics_serve [PORT] [ADDR] - Serve metrics over HTTP (Prometheus format),\n");
+    printf("                        on loopback unless ADDR is given\n");
     
     printf("\nState Machine Commands:\n");
     printf("  init                  - Initialize the state machine\n");
@@ -285,11 +305,16 @@ static void list_endpoints(void) {
             printf("\nProgram %zu Endpoints:\n", i);
             for (size_t j = 0; j < program->count; j++) {
                 NetworkEndpoint* ep = &program->endpoints[j];
+                if (net_protocol_is_unix(ep->protocol)) {
+                    printf("  Endpoint %zu: %s (%s)\n", j, ep->path,
+                           net_protocol_name(ep->protocol));
+                    continue;
+                }
                 printf("  Endpoint %zu: %s:%d (%s)\n",
                        j,
                        ep->address,
                        ep->port,
-                       ep->protocol == NET_TCP ? "TCP" : "UDP");
+                       net_protocol_name(ep->protocol));
             }
         }
     }
@@ -299,14 +324,16 @@ static void list_clients(void) {
     for (size_t i = 0; i < g_runtime.program_count; i++) {
         NetworkProgram* program = g_runtime.programs[i];
         if (program) {
-            printf("\nProgram %zu Clients:\n", i);
+            printf("\nProgram %zu Clients (%zu):\n", i, program->client_count);
             pthread_mutex_lock(&program->clients_lock);
-            for (int j = 0; j < NET_MAX_CLIENTS; j++) {
-                pthread_mutex_lock(&program->clients[j].lock);
-                if (program->clients[j].is_active) {
-                    printf("  Client %d: Connected\n", j);
+            for (size_t j = 0; j < program->client_capacity; j++) {
+                ClientState* client = program->clients[j];
+                if (!client) continue;
+                pthread_mutex_lock(&client->lock);
+                if (client->is_active) {
+                    printf("  Client %zu: Connected\n", j);
                 }
-                pthread_mutex_unlock(&program->clients[j].lock);
+                pthread_mutex_unlock(&client->lock);
             }
             pthread_mutex_unlock(&program->clients_lock);
         }
@@ -343,6 +370,7 @@ static void register_signal_handlers(void);
 // Initialize runtime
 static bool initialize_runtime(void) {
     register_signal_handlers();
+    polycall_log_start();
     
 #ifdef _WIN32
     WSADATA wsaData;
@@ -445,8 +473,19 @@ typedef struct {
 #define DEFAULT_PORT_BASE 3000
 #define CONFIG_FILENAME ".polycallrc"
 
+/* Program waiting to be started for a port mapping */
+typedef struct {
+    char service_name[256];
+    size_t mapping;                 // Index into the runtime's port mappings
+    NetworkProgram* program;        // Set once live
+    pthread_t thread;
+    bool threaded;
+} ServiceStartup;
+
 /* Global state */
 static DirectoryControl dir_control = {0};
+static ServiceStartup g_startups[MAX_PORTS];
+static size_t g_startup_count = 0;
 
 /* Directory control functions */
 static bool init_directory_control(const char* base_path) {
@@ -529,35 +568,73 @@ static bool add_port_mapping(const char* service_name, uint16_t host_port, uint1
         return false;
     }
     
-    // Add mapping
+    // Add mapping; its program comes up with the others in start_services
+    ServiceStartup* startup = &g_startups[g_startup_count++];
+    memset(startup, 0, sizeof(*startup));
+    snprintf(startup->service_name, sizeof(startup->service_name), "%s", service_name);
+    startup->mapping = g_runtime.port_mappings.count;
+    
     PortMapping* mapping = &g_runtime.port_mappings.mappings[g_runtime.port_mappings.count++];
     mapping->host_port = host_port;
     mapping->container_port = container_port;
     mapping->is_active = true;
+    return true;
+}
+
+// Runs on a thread of its own; reports as soon as the program is live
+static void* start_service(void* arg) {
+    ServiceStartup* startup = arg;
+    const PortMapping* mapping = &g_runtime.port_mappings.mappings[startup->mapping];
     
-    // Initialize network program
     NetworkProgram* program = calloc(1, sizeof(NetworkProgram));
-    if (!program) {
-        g_runtime.port_mappings.count--;
-        return false;
-    }
+    if (!program) return NULL;
     
     net_init_program(program);
-    if (program->endpoints && program->count > 0) {
-        program->endpoints[0].port = container_port;
-        program->handlers.on_receive = on_network_receive;
-        program->handlers.on_connect = on_network_connect;
-        program->handlers.on_disconnect = on_network_disconnect;
-        
-        g_runtime.programs[g_runtime.program_count++] = program;
-        printf("Mapped port %d to %d for service %s\n", 
-               host_port, container_port, service_name);
-        return true;
+    if (!program->endpoints || program->count == 0) {
+        free(program);
+        fprintf(stderr, "Failed to start service %s\n", startup->service_name);
+        return NULL;
     }
-    free(program);
+    program->endpoints[0].port = mapping->container_port;
+    program->handlers.on_receive = on_network_receive;
+    program->handlers.on_connect = on_network_connect;
+    program->handlers.on_disconnect = on_network_disconnect;
     
-    g_runtime.port_mappings.count--;
-    return false;
+    startup->program = program;
+    printf("Mapped port %d to %d for service %s\n",
+           mapping->host_port, mapping->container_port, startup->service_name);
+    return NULL;
+}
+
+// Programs are independent, so bring the queued ones up in parallel and
+// register them in the order they were queued. Returns how many started.
+static size_t start_services(void) {
+    for (size_t i = 0; i < g_startup_count; i++) {
+        ServiceStartup* startup = &g_startups[i];
+        startup->threaded = pthread_create(&startup->thread, NULL, start_service, startup) == 0;
+        if (!startup->threaded) start_service(startup);
+    }
+    
+    size_t started = 0;
+    for (size_t i = 0; i < g_startup_count; i++) {
+        ServiceStartup* startup = &g_startups[i];
+        if (startup->threaded) pthread_join(startup->thread, NULL);
+        
+        NetworkProgram* program = startup->program;
+        if (program && g_runtime.program_count < MAX_PROGRAMS) {
+            g_runtime.programs[g_runtime.program_count++] = program;
+            started++;
+            continue;
+        }
+        if (program) {
+            fprintf(stderr, "Too many programs, dropping service %s\n", startup->service_name);
+            net_cleanup_program(program);
+            free(program);
+        }
+        g_runtime.port_mappings.mappings[startup->mapping].is_active = false;
+    }
+    g_startup_count = 0;
+    return started;
 }
 
 /* Service discovery and initialization */
@@ -616,7 +693,7 @@ static bool discover_and_init_services(void) {
     closedir(dir_control.current_dir);
     dir_control.current_dir = NULL;
 
-    return services_found > 0;
+    return services_found > 0 && start_services() > 0;
 }
 
 /* Configuration file functions */
@@ -645,6 +722,7 @@ static bool process_config_file(const char* filename) {
     }
 
     fclose(fp);
+    start_services();
     return true;
 }
 
@@ -692,8 +770,130 @@ static void cleanup_runtime(void) {
         g_runtime.wsaInitialized = false;
     }
 #endif
+
+    polycall_metrics_stop_serving();
+    net_handoff_close(g_runtime.handoff);
+    g_runtime.handoff = NULL;
+    polycall_log_stop();
+}
+
+
+// Serialized snapshot of the state machine, or NULL without one
+static uint8_t* serialize_state(size_t* size) {
+    *size = 0;
+    PolyCall_MachineSnapshot* snapshot = NULL;
+    if (!g_runtime.state_machine ||
+        polycall_sm_snapshot_machine(g_runtime.state_machine, &snapshot) != POLYCALL_SM_SUCCESS) {
+        return NULL;
+    }
+    
+    uint8_t* buffer = NULL;
+    if (polycall_sm_serialize_machine_snapshot(snapshot, NULL, 0, size) == POLYCALL_SM_SUCCESS) {
+        buffer = malloc(*size);
+    }
+    if (!buffer || polycall_sm_serialize_machine_snapshot(snapshot, buffer, *size, size)
+                   != POLYCALL_SM_SUCCESS) {
+        free(buffer);
+        buffer = NULL;
+        *size = 0;
+    }
+    polycall_sm_release_machine_snapshot(snapshot);
+    return buffer;
+}
+
+static void restore_state(const uint8_t* data, size_t size) {
+    if (size == 0) return;
+    if (!g_runtime.state_machine) {
+        fprintf(stderr, "No state machine to restore the inherited state into\n");
+        return;
+    }
+    PolyCall_MachineSnapshot* snapshot = NULL;
+    if (polycall_sm_deserialize_machine_snapshot(g_runtime.state_machine, data, size, &snapshot)
+            != POLYCALL_SM_SUCCESS ||
+        polycall_sm_restore_machine(g_runtime.state_machine, snapshot) != POLYCALL_SM_SUCCESS) {
+        fprintf(stderr, "Inherited state does not fit this state machine\n");
+    }
+    polycall_sm_release_machine_snapshot(snapshot);
 }
 
+// Start on the listeners of the daemon at path, then confirm so that it
+// stops accepting. Later successors take over from us at the same path.
+static bool take_over(const char* path) {
+    NetworkHandoffListener listeners[MAX_PROGRAMS];
+    size_t count;
+    void* state;
+    size_t state_size;
+    NetworkHandoff* handoff = net_handoff_take(path, HANDOFF_TIMEOUT_MS, listeners, MAX_PROGRAMS,
+                                               &count, &state, &state_size);
+    if (!handoff) {
+        fprintf(stderr, "Failed to take over from %s\n", path);
+        return false;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        NetworkProgram* program = calloc(1, sizeof(NetworkProgram));
+        if (!program) {
+            close(listeners[i].fd);
+            continue;
+        }
+        net_init_program_adopt(program, NET_EVENT_AUTO, listeners[i].protocol, listeners[i].fd);
+        if (!program->endpoints || program->count == 0) {
+            free(program);
+            continue;
+        }
+        program->handlers.on_receive = on_network_receive;
+        program->handlers.on_connect = on_network_connect;
+        program->handlers.on_disconnect = on_network_disconnect;
+        g_runtime.programs[g_runtime.program_count++] = program;
+    }
+    restore_state(state, state_size);
+    free(state);
+    
+    // Unconfirmed, the old daemon goes on as before; so must it alone
+    if (!net_handoff_confirm(handoff)) {
+        fprintf(stderr, "Failed to confirm the takeover from %s\n", path);
+        net_handoff_close(handoff);
+        return false;
+    }
+    g_runtime.handoff = handoff;
+    printf("Took over %zu listeners from %s\n", g_runtime.program_count, path);
+    return true;
+}
+
+// Give our listeners to a waiting successor, if any, and from then on
+// serve only the clients already connected
+static void offer_handoff(void) {
+    NetworkHandoffListener listeners[MAX_PROGRAMS];
+    size_t count = 0;
+    for (size_t i = 0; i < g_runtime.program_count; i++) {
+        NetworkProgram* program = g_runtime.programs[i];
+        if (!program || !program->endpoints || program->endpoints[0].socket_fd <= 0) continue;
+        listeners[count].fd = program->endpoints[0].socket_fd;
+        listeners[count++].protocol = program->endpoints[0].protocol;
+    }
+    
+    size_t state_size;
+    uint8_t* state = serialize_state(&state_size);
+    bool taken = net_handoff_offer(g_runtime.handoff, listeners, count, state, state_size,
+                                   HANDOFF_TIMEOUT_MS);
+    free(state);
+    if (!taken) return;
+    
+    for (size_t i = 0; i < g_runtime.program_count; i++) {
+        net_stop_accepting(g_runtime.programs[i]);
+    }
+    net_handoff_close(g_runtime.handoff);
+    g_runtime.handoff = NULL;
+    g_runtime.draining = true;
+    printf("Handed over to successor; draining clients\n");
+}
+
+static bool clients_remaining(void) {
+    for (size_t i = 0; i < g_runtime.program_count; i++) {
+        if (g_runtime.programs[i] && g_runtime.programs[i]->client_count > 0) return true;
+    }
+    return false;
+}
 
 // Adding signal handler registration
 static void cleanup_and_exit(void) {
@@ -715,12 +915,20 @@ static void register_signal_handlers(void) {
 int main(int argc, char* argv[]) {
     bool non_interactive = false;
     const char* config_file = NULL;
+    const char* handoff_path = NULL;
+    bool take_over_listeners = false;
     
-    // Parse command line arguments
+    // Parse command line arguments. --handoff PATH lets a successor take
+    // over at PATH; --takeover PATH is that successor.
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
             config_file = argv[++i];
             non_interactive = true;
+        } else if (strcmp(argv[i], "--handoff") == 0 && i + 1 < argc) {
+            handoff_path = argv[++i];
+        } else if (strcmp(argv[i], "--takeover") == 0 && i + 1 < argc) {
+            handoff_path = argv[++i];
+            take_over_listeners = true;
         }
     }
 
@@ -729,6 +937,18 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (take_over_listeners) {
+        if (!take_over(handoff_path)) {
+            cleanup_runtime();
+            return 1;
+        }
+    } else if (handoff_path) {
+        g_runtime.handoff = net_handoff_listen(handoff_path);
+        if (!g_runtime.handoff) {
+            fprintf(stderr, "Failed to accept successors on %s\n", handoff_path);
+        }
+    }
+
     if (non_interactive) {
         // Handle non-interactive mode with config file
         FILE* fp = fopen(config_file, "r");
@@ -762,6 +982,26 @@ int main(int argc, char* argv[]) {
                     if (sscanf(value, "%hu:%hu", &host_port, &container_port) == 2) {
                         port_number = container_port;
                     }
+                } else if (strcmp(cmd, "metrics") == 0) {
+                    // Admin endpoint (format: "metrics [ADDRESS:]PORT"),
+                    // loopback unless an address is given
+                    const char* address = NULL;
+                    char* separator = strrchr(value, ':');
+                    if (separator) {
+                        *separator = '\0';
+                        address = value;
+                    }
+                    uint16_t port = (uint16_t)strtoul(separator ? separator + 1 : value, NULL, 10);
+                    uint16_t bound = polycall_metrics_serve(address, port);
+                    if (bound) {
+                        printf("Metrics served on port %u\n", bound);
+                    } else {
+                        fprintf(stderr, "Failed to serve metrics on port %u\n", port);
+                    }
+                } else if (strcmp(cmd, "network") == 0 && strcmp(value, "start") == 0 &&
+                           take_over_listeners) {
+                    // The listeners came from the daemon we took over from
+                    network_started = g_runtime.program_count > 0;
                 } else if (strcmp(cmd, "network") == 0 && strcmp(value, "start") == 0) {
                     // Start network services
                     NetworkProgram* program = calloc(1, sizeof(NetworkProgram));
@@ -809,6 +1049,11 @@ int main(int argc, char* argv[]) {
                     }
                 }
             }
+            if (g_runtime.handoff) {
+                offer_handoff();
+            } else if (g_runtime.draining && !clients_remaining()) {
+                g_runtime.running = false;
+            }
             // Small sleep to prevent CPU spin
             usleep(1000); // 1ms sleep
         }
@@ -863,6 +1108,17 @@ int main(int argc, char* argv[]) {
                 list_states();
             } else if (strcmp(command, "list_transitions") == 0) {
                 list_transitions();
+            } else if (strcmp(command, "metrics") == 0) {
+                polycall_metrics_write(stdout);
+            } else if (strcmp(command, "metrics_serve") == 0) {
+                char* address = arg1 ? strtok(NULL, " ") : NULL;
+                uint16_t port = arg1 ? (uint16_t)strtoul(arg1, NULL, 10) : 0;
+                uint16_t bound = polycall_metrics_serve(address, port);
+                if (bound) {
+                    printf("Metrics served on port %u\n", bound);
+                } else {
+                    printf("Failed to serve metrics\n");
+                }
             } else if (strcmp(command, "history") == 0) {
                 show_history();
             } else if (strcmp(command, "status") == 0) {
@@ -1,4 +1,6 @@
 #include "network.h"
+#include "polycall_log.h"
+#include "polycall_metrics.h"
 #ifdef _WIN32
     #include <winsock2.h>
     #include <ws2tcpip.h>
@@ -7,11 +9,15 @@
     typedef char* sock_opt_type;
 #else
     #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
     #include <netinet/in.h>
+    #include <netinet/tcp.h>
     #include <arpa/inet.h>
     #include <fcntl.h>
+    #include <stddef.h>
     #include <unistd.h>
-    #include <sys/select.h>
+    #include <sys/resource.h>
     typedef void* sock_opt_type;
 #endif
 
@@ -27,21 +33,93 @@ static int set_nonblocking(int sockfd) {
 #endif
 }
 
+static bool would_block(void) {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
 // Initialize client state
 void net_init_client_state(ClientState* state) {
     pthread_mutex_init(&state->lock, NULL);
+    pthread_mutex_init(&state->send_lock, NULL);
     state->is_active = false;
     state->socket_fd = 0;
     memset(&state->addr, 0, sizeof(state->addr));
+    state->unsent = NULL;
+    state->unsent_length = 0;
+    state->unsent_capacity = 0;
+}
+
+#ifndef _WIN32
+// Mark local ports of one /proc/net table. Sockets in TIME_WAIT don't
+// count, since listeners bind with SO_REUSEADDR.
+static bool scan_socket_table(const char* table, uint16_t first, uint16_t last, bool* in_use) {
+    FILE* fp = fopen(table, "r");
+    if (!fp) return false;
+    
+    char line[256];
+    if (!fgets(line, sizeof(line), fp)) {
+        fclose(fp);
+        return false;
+    }
+    unsigned int port, state;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, " %*u: %*[0-9A-Fa-f]:%x %*[0-9A-Fa-f]:%*x %x", &port, &state) != 2) continue;
+        if (state == 0x06 || port < first || port > last) continue;
+        in_use[port - first] = true;
+    }
+    fclose(fp);
+    return true;
 }
+#endif
+
+void net_ports_in_use(uint16_t first, uint16_t last, bool* in_use) {
+    if (!in_use || first > last) return;
+    memset(in_use, 0, (size_t)(last - first) + 1);
+#ifndef _WIN32
+    // tcp6 may be missing without IPv6; tcp alone is still a full answer
+    if (scan_socket_table("/proc/net/tcp", first, last, in_use)) {
+        scan_socket_table("/proc/net/tcp6", first, last, in_use);
+        return;
+    }
+#endif
+    for (uint32_t port = first; port <= last; port++) {
+        in_use[port - first] = net_is_port_in_use((uint16_t)port);
+    }
+}
+
+// Ports handed out below, held until their program is cleaned up: one
+// bound after another program's scan would otherwise look free to it
+static pthread_mutex_t port_claims_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t port_claims[65536 / 64];
 
 static uint16_t find_available_port(uint16_t start_port, uint16_t end_port) {
-    for (uint16_t port = start_port; port <= end_port; port++) {
-        if (!net_is_port_in_use(port)) {
-            return port;
+    bool* in_use = malloc((size_t)(end_port - start_port) + 1);
+    if (!in_use) return 0;
+    net_ports_in_use(start_port, end_port, in_use);
+    
+    uint16_t found = 0;
+    pthread_mutex_lock(&port_claims_lock);
+    for (uint32_t port = start_port; port <= end_port; port++) {
+        uint64_t bit = 1ULL << (port % 64);
+        if (!in_use[port - start_port] && !(port_claims[port / 64] & bit)) {
+            port_claims[port / 64] |= bit;
+            found = (uint16_t)port;
+            break;
         }
     }
-    return 0;
+    pthread_mutex_unlock(&port_claims_lock);
+    free(in_use);
+    return found;
+}
+
+static void release_port_claim(uint16_t port) {
+    pthread_mutex_lock(&port_claims_lock);
+    port_claims[port / 64] &= ~(1ULL << (port % 64));
+    pthread_mutex_unlock(&port_claims_lock);
 }
 
 // Clean up client state
@@ -54,6 +132,14 @@ void net_cleanup_client_state(ClientState* state) {
     state->is_active = false;
     pthread_mutex_unlock(&state->lock);
     pthread_mutex_destroy(&state->lock);
+    
+    // A sender that found the client before it left the table finishes first
+    pthread_mutex_lock(&state->send_lock);
+    free(state->unsent);
+    state->unsent = NULL;
+    state->unsent_length = state->unsent_capacity = 0;
+    pthread_mutex_unlock(&state->send_lock);
+    pthread_mutex_destroy(&state->send_lock);
 }
 
 bool net_is_port_in_use(uint16_t port) {
@@ -72,6 +158,63 @@ bool net_is_port_in_use(uint16_t port) {
     return result < 0;
 }
 
+bool net_protocol_is_unix(NetworkProtocol protocol) {
+    return protocol == NET_UNIX || protocol == NET_UNIX_SEQPACKET;
+}
+
+const char* net_protocol_name(NetworkProtocol protocol) {
+    switch (protocol) {
+        case NET_TCP: return "TCP";
+        case NET_UDP: return "UDP";
+        case NET_RAW: return "RAW";
+        case NET_UNIX: return "Unix";
+        case NET_UNIX_SEQPACKET: return "Unix seqpacket";
+        default: return "unknown";
+    }
+}
+
+#ifndef _WIN32
+// A leading '@' names a socket in the abstract namespace (Linux), which
+// has no file and leaves nothing behind
+static bool unix_address(const char* path, struct sockaddr_un* addr, socklen_t* length) {
+    size_t size = path ? strnlen(path, sizeof(addr->sun_path)) : 0;
+    if (size == 0 || size >= sizeof(addr->sun_path)) return false;
+    
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    memcpy(addr->sun_path, path, size);
+    bool abstract = path[0] == '@';
+    if (abstract) addr->sun_path[0] = '\0';
+    *length = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + size + (abstract ? 0 : 1));
+    return true;
+}
+#endif
+
+bool net_is_path_in_use(const char* path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    struct sockaddr_un addr;
+    socklen_t length;
+    if (!unix_address(path, &addr, &length)) return true;  // Error on the safe side
+    
+    // Nonblocking, so a listener with a full backlog answers EAGAIN
+    // instead of holding us up
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || set_nonblocking(sock) < 0) {
+        if (sock >= 0) close(sock);
+        return true;
+    }
+    int result = connect(sock, (struct sockaddr*)&addr, length);
+    int error = errno;
+    close(sock);
+    
+    // Nobody there, or a socket file left behind by a listener that is gone
+    return result == 0 || (error != ENOENT && error != ECONNREFUSED);
+#endif
+}
+
 // Attempt to release port
 bool net_release_port(uint16_t port) {
     int sock = socket(AF_INET, SOCK_STREAM, 0);
@@ -100,18 +243,71 @@ bool net_release_port(uint16_t port) {
     return result >= 0;
 }
 
+// A server binds and listens at path, a client connects to it
+static bool init_unix(NetworkEndpoint* endpoint) {
+#ifdef _WIN32
+    POLYCALL_LOG_ERROR("net", "Unix sockets are not supported here");
+    return false;
+#else
+    struct sockaddr_un addr;
+    socklen_t length;
+    if (!unix_address(endpoint->path, &addr, &length)) {
+        POLYCALL_LOG_ERROR("net", "Invalid Unix socket path '%.*s'", NET_UNIX_PATH_MAX,
+                           endpoint->path);
+        return false;
+    }
+    
+    bool server = endpoint->role == NET_SERVER;
+    if (server) {
+        if (net_is_path_in_use(endpoint->path)) {
+            POLYCALL_LOG_ERROR("net", "Socket %s is in use", endpoint->path);
+            return false;
+        }
+        // A socket file whose listener has gone would fail the bind
+        struct stat st;
+        if (endpoint->path[0] != '@' && lstat(endpoint->path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+            unlink(endpoint->path);
+        }
+    }
+    
+    pthread_mutex_init(&endpoint->lock, NULL);
+    endpoint->socket_fd = socket(AF_UNIX,
+        endpoint->protocol == NET_UNIX ? SOCK_STREAM : SOCK_SEQPACKET, 0);
+    if (endpoint->socket_fd < 0) {
+        POLYCALL_LOG_ERROR("net", "Socket creation failed: %s", strerror(errno));
+        pthread_mutex_destroy(&endpoint->lock);
+        return false;
+    }
+    
+    int result = server ? bind(endpoint->socket_fd, (struct sockaddr*)&addr, length)
+                        : connect(endpoint->socket_fd, (struct sockaddr*)&addr, length);
+    bool bound = server && result == 0;
+    if (bound) result = listen(endpoint->socket_fd, SOMAXCONN);
+    if (result < 0) {
+        POLYCALL_LOG_ERROR("net", "%s %s failed: %s", server ? "Listen on" : "Connect to",
+                           endpoint->path, strerror(errno));
+        close(endpoint->socket_fd);
+        if (bound && endpoint->path[0] != '@') unlink(endpoint->path);
+        pthread_mutex_destroy(&endpoint->lock);
+        return false;
+    }
+    return true;
+#endif
+}
+
 // Update net_init for cross-platform compatibility
 bool net_init(NetworkEndpoint* endpoint) {
     if (!endpoint) return false;
+    if (net_protocol_is_unix(endpoint->protocol)) return init_unix(endpoint);
     
-    // Check if port is in use
-    if (net_is_port_in_use(endpoint->port)) {
-        printf("Port %d is in use, attempting to release...\n", endpoint->port);
+    // Check if port is in use; shared listeners expect it to be
+    if (!endpoint->reuse_port && net_is_port_in_use(endpoint->port)) {
+        POLYCALL_LOG_INFO("net", "Port %d is in use, attempting to release...", endpoint->port);
         if (!net_release_port(endpoint->port)) {
-            printf("Failed to release port %d\n", endpoint->port);
+            POLYCALL_LOG_ERROR("net", "Failed to release port %d", endpoint->port);
             return false;
         }
-        printf("Successfully released port %d\n", endpoint->port);
+        POLYCALL_LOG_INFO("net", "Successfully released port %d", endpoint->port);
     }
     
     pthread_mutex_init(&endpoint->lock, NULL);
@@ -123,7 +319,7 @@ bool net_init(NetworkEndpoint* endpoint) {
         0);
     
     if (endpoint->socket_fd < 0) {
-        perror("Socket creation failed");
+        POLYCALL_LOG_ERROR("net", "Socket creation failed: %s", strerror(errno));
         pthread_mutex_unlock(&endpoint->lock);
         pthread_mutex_destroy(&endpoint->lock);
         return false;
@@ -133,12 +329,29 @@ bool net_init(NetworkEndpoint* endpoint) {
     int opt = 1;
     if (setsockopt(endpoint->socket_fd, SOL_SOCKET, SO_REUSEADDR, 
                    (sock_opt_type)&opt, sizeof(opt)) < 0) {
-        perror("setsockopt failed");
+        POLYCALL_LOG_ERROR("net", "setsockopt failed: %s", strerror(errno));
         close(endpoint->socket_fd);
         pthread_mutex_unlock(&endpoint->lock);
         pthread_mutex_destroy(&endpoint->lock);
         return false;
     }
+
+    if (endpoint->reuse_port) {
+#ifdef SO_REUSEPORT
+        int reuse = setsockopt(endpoint->socket_fd, SOL_SOCKET, SO_REUSEPORT,
+                               (sock_opt_type)&opt, sizeof(opt));
+#else
+        int reuse = -1;
+        errno = ENOTSUP;
+#endif
+        if (reuse < 0) {
+            POLYCALL_LOG_ERROR("net", "SO_REUSEPORT failed: %s", strerror(errno));
+            close(endpoint->socket_fd);
+            pthread_mutex_unlock(&endpoint->lock);
+            pthread_mutex_destroy(&endpoint->lock);
+            return false;
+        }
+    }
     
     // Configure address
     endpoint->addr.sin_family = AF_INET;
@@ -149,7 +362,7 @@ bool net_init(NetworkEndpoint* endpoint) {
     if (endpoint->role == NET_SERVER) {
         if (bind(endpoint->socket_fd, (struct sockaddr*)&endpoint->addr, 
                 sizeof(endpoint->addr)) < 0) {
-            perror("Bind failed");
+            POLYCALL_LOG_ERROR("net", "Bind failed: %s", strerror(errno));
             close(endpoint->socket_fd);
             pthread_mutex_unlock(&endpoint->lock);
             pthread_mutex_destroy(&endpoint->lock);
@@ -157,8 +370,8 @@ bool net_init(NetworkEndpoint* endpoint) {
         }
         
         if (endpoint->protocol == NET_TCP) {
-            if (listen(endpoint->socket_fd, NET_MAX_CLIENTS) < 0) {
-                perror("Listen failed");
+            if (listen(endpoint->socket_fd, SOMAXCONN) < 0) {
+                POLYCALL_LOG_ERROR("net", "Listen failed: %s", strerror(errno));
                 close(endpoint->socket_fd);
                 pthread_mutex_unlock(&endpoint->lock);
                 pthread_mutex_destroy(&endpoint->lock);
@@ -177,29 +390,273 @@ void net_close(NetworkEndpoint* endpoint) {
     pthread_mutex_lock(&endpoint->lock);
     
     if (endpoint->socket_fd > 0) {
-        // Set linger to ensure complete socket shutdown
-        struct linger ling = {1, 0};  // Immediate shutdown
-        setsockopt(endpoint->socket_fd, SOL_SOCKET, SO_LINGER, 
-                  (sock_opt_type)&ling, sizeof(ling));
-        
-        shutdown(endpoint->socket_fd, SHUT_RDWR);  // Shutdown both directions
+        // An inherited listener may still be shared with the process that
+        // handed it over, which a shutdown would cut off too; a stale
+        // socket file is cleared by the next bind
+        if (!endpoint->inherited) {
+            // Set linger to ensure complete socket shutdown
+            struct linger ling = {1, 0};  // Immediate shutdown
+            setsockopt(endpoint->socket_fd, SOL_SOCKET, SO_LINGER, 
+                      (sock_opt_type)&ling, sizeof(ling));
+            
+            shutdown(endpoint->socket_fd, SHUT_RDWR);  // Shutdown both directions
+        }
         close(endpoint->socket_fd);
         endpoint->socket_fd = 0;
+        
+        // The socket file is ours to remove
+        if (net_protocol_is_unix(endpoint->protocol) && endpoint->role == NET_SERVER &&
+            !endpoint->inherited &&
+            endpoint->path[0] != '\0' && endpoint->path[0] != '@') {
+            unlink(endpoint->path);
+        }
     }
     
     pthread_mutex_unlock(&endpoint->lock);
     pthread_mutex_destroy(&endpoint->lock);
 }
 
+// Sends are counted here whichever path they take
+static ssize_t count_sent(ssize_t result) {
+    if (result > 0) {
+        polycall_metrics_add(POLYCALL_METRIC_NET_BYTES_OUT, (uint64_t)result);
+    } else if (result < 0) {
+        polycall_metrics_inc(POLYCALL_METRIC_NET_SEND_ERRORS);
+    }
+    return result;
+}
+
+#ifndef _WIN32
+static ssize_t send_nosignal(int fd, const struct msghdr* message) {
+#ifdef MSG_NOSIGNAL
+    return sendmsg(fd, message, MSG_NOSIGNAL);
+#else
+    return sendmsg(fd, message, 0);
+#endif
+}
+
+// Keep the bytes of iov past the first skip for a later write; send_lock held
+static bool hold_unsent(ClientState* client, const struct iovec* iov, int count, size_t skip) {
+    size_t size = 0;
+    for (int i = 0; i < count; i++) size += iov[i].iov_len;
+    size -= skip;
+
+    size_t needed = client->unsent_length + size;
+    if (needed > client->unsent_capacity) {
+        size_t capacity = client->unsent_capacity ? client->unsent_capacity : NET_BUFFER_SIZE;
+        while (capacity < needed) capacity *= 2;
+        char* unsent = realloc(client->unsent, capacity);
+        if (!unsent) return false;
+        client->unsent = unsent;
+        client->unsent_capacity = capacity;
+    }
+    for (int i = 0; i < count; i++) {
+        size_t length = iov[i].iov_len;
+        size_t from = skip < length ? skip : length;
+        skip -= from;
+        memcpy(client->unsent + client->unsent_length, (const char*)iov[i].iov_base + from,
+               length - from);
+        client->unsent_length += length - from;
+    }
+    return true;
+}
+
+// Write what the socket takes of the held bytes; send_lock held. False
+// once the socket has failed.
+static bool flush_unsent(ClientState* client) {
+    size_t done = 0;
+    bool alive = true;
+    while (done < client->unsent_length) {
+        struct iovec iov = { client->unsent + done, client->unsent_length - done };
+        struct msghdr message = { .msg_iov = &iov, .msg_iovlen = 1 };
+        ssize_t sent = send_nosignal(client->socket_fd, &message);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && would_block()) break;
+        if (sent <= 0) {
+            count_sent(-1);
+            alive = false;
+            break;
+        }
+        count_sent(sent);
+        done += (size_t)sent;
+    }
+    memmove(client->unsent, client->unsent + done, client->unsent_length - done);
+    client->unsent_length -= done;
+    return alive;
+}
+
+// Sends to a client of a readiness-driven program. What the socket does
+// not take at once is held and written as it drains (flush_client), and
+// later sends queue behind it, so a frame is never left half written. The
+// result is the whole size, or -1 with nothing sent: past NET_UNSENT_MAX
+// held bytes a send is refused (ENOBUFS) rather than cut.
+static ssize_t queued_sendv(NetworkProgram* program, int fd, const struct iovec* iov, int count) {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) total += iov[i].iov_len;
+
+    // Taken under the table lock, so the client cannot be freed under us
+    pthread_mutex_lock(&program->clients_lock);
+    ClientState* client = fd >= 0 && (size_t)fd < program->client_capacity
+                              ? program->clients[fd] : NULL;
+    if (client) pthread_mutex_lock(&client->send_lock);
+    pthread_mutex_unlock(&program->clients_lock);
+    if (!client) {
+        errno = ENOTCONN;
+        return count_sent(-1);
+    }
+
+    ssize_t result = (ssize_t)total;
+    if (client->unsent_length + total > NET_UNSENT_MAX) {
+        errno = ENOBUFS;
+        result = -1;
+    } else if (client->unsent_length > 0) {
+        // The socket is full; the writable event sends these in order
+        if (!hold_unsent(client, iov, count, 0)) {
+            errno = ENOMEM;
+            result = -1;
+        }
+    } else if (total > 0) {
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = (struct iovec*)iov;
+        message.msg_iovlen = (size_t)count;
+        ssize_t sent;
+        do {
+            sent = send_nosignal(fd, &message);
+        } while (sent < 0 && errno == EINTR);
+
+        if (sent < 0 && !would_block()) {
+            result = -1;
+        } else {
+            size_t written = sent > 0 ? (size_t)sent : 0;
+            if (written > 0) count_sent(sent);
+            if (written < total) {
+                if (hold_unsent(client, iov, count, written)) {
+                    net_event_want_write(program->events, fd, true);
+                } else {
+                    // Part of the frame is out and the rest cannot be kept:
+                    // end the stream rather than leave it torn
+                    shutdown(fd, SHUT_RDWR);
+                    errno = ENOMEM;
+                    result = -1;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&client->send_lock);
+    if (result < 0) count_sent(-1);
+    return result;
+}
+
+// The socket has room again: write out what was held, and stop watching
+// for it once nothing is left
+static void flush_client(NetworkProgram* program, int fd) {
+    pthread_mutex_lock(&program->clients_lock);
+    ClientState* client = (size_t)fd < program->client_capacity ? program->clients[fd] : NULL;
+    if (client) pthread_mutex_lock(&client->send_lock);
+    pthread_mutex_unlock(&program->clients_lock);
+    if (!client) return;
+
+    if (!flush_unsent(client)) {
+        // The read side reports the disconnect
+        shutdown(fd, SHUT_RDWR);
+    } else if (client->unsent_length == 0) {
+        net_event_want_write(program->events, fd, false);
+    }
+    pthread_mutex_unlock(&client->send_lock);
+}
+#endif
+
 // Send data through network endpoint
 ssize_t net_send(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     if (!endpoint || !packet) return -1;
+
+    // Queued for the next io_uring submission; the ring belongs to the
+    // net_run thread, which is where handlers run
+    if (endpoint->uring) {
+        return count_sent(net_uring_send(endpoint->uring, endpoint->socket_fd, packet->data,
+                                         packet->size));
+    }
+#ifndef _WIN32
+    if (endpoint->program && endpoint->program->events && packet->flags == 0) {
+        struct iovec iov = { .iov_base = packet->data, .iov_len = packet->size };
+        return queued_sendv(endpoint->program, endpoint->socket_fd, &iov, 1);
+    }
+#endif
     
     ssize_t result;
     pthread_mutex_lock(&endpoint->lock);
     result = send(endpoint->socket_fd, packet->data, packet->size, packet->flags);
     pthread_mutex_unlock(&endpoint->lock);
-    return result;
+    return count_sent(result);
+}
+
+// Gathered send: the pieces go out in order without being concatenated.
+// On a program's client endpoint the send is all or nothing (queued_sendv);
+// otherwise, like send, the result may be short on a nonblocking socket.
+ssize_t net_sendv(NetworkEndpoint* endpoint, const struct iovec* iov, int count) {
+    if (!endpoint || count < 0 || (!iov && count > 0)) return -1;
+
+    if (endpoint->uring) {
+        return count_sent(net_uring_sendv(endpoint->uring, endpoint->socket_fd, iov, count));
+    }
+#ifndef _WIN32
+    if (endpoint->program && endpoint->program->events) {
+        return queued_sendv(endpoint->program, endpoint->socket_fd, iov, count);
+    }
+#endif
+
+    ssize_t result = 0;
+    pthread_mutex_lock(&endpoint->lock);
+#ifdef _WIN32
+    for (int i = 0; i < count; i++) {
+        int sent = send(endpoint->socket_fd, iov[i].iov_base, (int)iov[i].iov_len, 0);
+        if (sent < 0) {
+            if (result == 0) result = -1;
+            break;
+        }
+        result += sent;
+        if ((size_t)sent < iov[i].iov_len) break;
+    }
+#else
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = (struct iovec*)iov;
+    message.msg_iovlen = (size_t)count;
+#ifdef MSG_NOSIGNAL
+    result = sendmsg(endpoint->socket_fd, &message, MSG_NOSIGNAL);
+#else
+    result = sendmsg(endpoint->socket_fd, &message, 0);
+#endif
+#endif
+    pthread_mutex_unlock(&endpoint->lock);
+    return count_sent(result);
+}
+
+// Send a buffer chain, NET_SEND_IOV_MAX links per call
+ssize_t net_send_buffer(NetworkEndpoint* endpoint, const NetworkBuffer* head) {
+    if (!endpoint || !head) return -1;
+
+    ssize_t total = 0;
+    while (head) {
+        struct iovec iov[NET_SEND_IOV_MAX];
+        int count = 0;
+        size_t size = 0;
+        for (; head && count < NET_SEND_IOV_MAX; head = head->next) {
+            if (head->length == 0) continue;
+            iov[count].iov_base = (void*)head->data;
+            iov[count].iov_len = head->length;
+            size += head->length;
+            count++;
+        }
+        if (count == 0) break;
+
+        ssize_t sent = net_sendv(endpoint, iov, count);
+        if (sent < 0) return total > 0 ? total : -1;
+        total += sent;
+        if ((size_t)sent < size) break;
+    }
+    return total;
 }
 
 // Receive data through network endpoint
@@ -213,49 +670,251 @@ ssize_t net_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     return result;
 }
 
-// Add client to program
-bool net_add_client(NetworkProgram* program, int socket_fd, struct sockaddr_in addr) {
-    if (!program) return false;
+// recv that also picks up passed descriptors, at most NET_MAX_FDS into
+// fds. msg_flags reports truncation (MSG_TRUNC, MSG_CTRUNC).
+static ssize_t receive_message(int socket_fd, void* data, size_t size, int flags,
+                               int* fds, int* fd_count, int* msg_flags) {
+    *fd_count = 0;
+    *msg_flags = 0;
+#ifdef _WIN32
+    (void)fds;
+    return recv(socket_fd, data, (int)size, flags);
+#else
+    union {
+        struct cmsghdr align;
+        char bytes[CMSG_SPACE(NET_MAX_FDS * sizeof(int))];
+    } control;
+    struct iovec iov = { .iov_base = data, .iov_len = size };
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.bytes;
+    message.msg_controllen = sizeof(control.bytes);
+#ifdef MSG_CMSG_CLOEXEC
+    flags |= MSG_CMSG_CLOEXEC;
+#endif
     
-    bool added = false;
-    pthread_mutex_lock(&program->clients_lock);
+    ssize_t result = recvmsg(socket_fd, &message, flags);
+    if (result < 0) return result;
     
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (!program->clients[i].is_active) {
-            program->clients[i].socket_fd = socket_fd;
-            program->clients[i].addr = addr;
-            program->clients[i].is_active = true;
-            added = true;
-            pthread_mutex_unlock(&program->clients[i].lock);
-            break;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; i++) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (*fd_count < NET_MAX_FDS) {
+                fds[(*fd_count)++] = fd;
+            } else {
+                close(fd);
+            }
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
     }
+    *msg_flags = message.msg_flags;
+    return result;
+#endif
+}
+
+ssize_t net_receive_fds(NetworkEndpoint* endpoint, NetworkPacket* packet, int* fds) {
+    if (!endpoint || !packet || !fds) return -1;
     
+    int fd_count;
+    int msg_flags;
+    pthread_mutex_lock(&endpoint->lock);
+    ssize_t result = receive_message(endpoint->socket_fd, packet->data, packet->size,
+                                     (int)packet->flags, fds, &fd_count, &msg_flags);
+    pthread_mutex_unlock(&endpoint->lock);
+    packet->fds = fd_count > 0 ? fds : NULL;
+    packet->fd_count = fd_count;
+    return result;
+}
+
+ssize_t net_send_fds(NetworkEndpoint* endpoint, const struct iovec* iov, int count,
+                     const int* fds, int fd_count) {
+    if (!endpoint || !iov || count <= 0 || fd_count < 0 || fd_count > NET_MAX_FDS ||
+        (fd_count > 0 && !fds)) {
+        return -1;
+    }
+#ifdef _WIN32
+    errno = ENOTSUP;
+    return -1;
+#else
+    if (endpoint->uring) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    
+    union {
+        struct cmsghdr align;
+        char bytes[CMSG_SPACE(NET_MAX_FDS * sizeof(int))];
+    } control;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    memset(&control, 0, sizeof(control));
+    message.msg_iov = (struct iovec*)iov;
+    message.msg_iovlen = (size_t)count;
+    if (fd_count > 0) {
+        message.msg_control = control.bytes;
+        message.msg_controllen = CMSG_SPACE((size_t)fd_count * sizeof(int));
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN((size_t)fd_count * sizeof(int));
+        memcpy(CMSG_DATA(cmsg), fds, (size_t)fd_count * sizeof(int));
+    }
+    
+    pthread_mutex_lock(&endpoint->lock);
+#ifdef MSG_NOSIGNAL
+    ssize_t result = sendmsg(endpoint->socket_fd, &message, MSG_NOSIGNAL);
+#else
+    ssize_t result = sendmsg(endpoint->socket_fd, &message, 0);
+#endif
+    pthread_mutex_unlock(&endpoint->lock);
+    return count_sent(result);
+#endif
+}
+
+// Grow the client table so that fd indexes a slot; clients_lock held
+static bool reserve_client_slot(NetworkProgram* program, int fd) {
+    if ((size_t)fd < program->client_capacity) return true;
+
+    size_t capacity = program->client_capacity ? program->client_capacity : NET_INITIAL_CLIENTS;
+    while (capacity <= (size_t)fd) capacity *= 2;
+
+    ClientState** clients = realloc(program->clients, capacity * sizeof(ClientState*));
+    if (!clients) return false;
+    memset(clients + program->client_capacity, 0,
+           (capacity - program->client_capacity) * sizeof(ClientState*));
+    program->clients = clients;
+    program->client_capacity = capacity;
+    return true;
+}
+
+// Add client to program
+bool net_add_client(NetworkProgram* program, int socket_fd, struct sockaddr_in addr) {
+    if (!program || socket_fd < 0) return false;
+
+    ClientState* client = malloc(sizeof(ClientState));
+    if (!client) return false;
+    net_init_client_state(client);
+    client->socket_fd = socket_fd;
+    client->addr = addr;
+    client->is_active = true;
+
+    pthread_mutex_lock(&program->clients_lock);
+    bool added = reserve_client_slot(program, socket_fd) &&
+                 program->clients[socket_fd] == NULL;
+    if (added) {
+        program->clients[socket_fd] = client;
+        program->client_count++;
+        client->tag = ++program->next_tag & 0xFFFFFFu;
+    }
     pthread_mutex_unlock(&program->clients_lock);
+
+    bool registered = added && (program->uring
+        ? net_uring_recv(program->uring, socket_fd, client->tag)
+        : net_event_add(program->events, socket_fd));
+    if (added && !registered) {
+        pthread_mutex_lock(&program->clients_lock);
+        program->clients[socket_fd] = NULL;
+        program->client_count--;
+        pthread_mutex_unlock(&program->clients_lock);
+        added = false;
+    }
+
+    if (added && addr.sin_family == AF_INET) {
+        POLYCALL_LOG_DEBUG("net", "Client %d connected from %s:%d", socket_fd,
+                           inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+    } else if (added) {
+        POLYCALL_LOG_DEBUG("net", "Client %d connected", socket_fd);
+    } else {
+        // The caller still owns the socket
+        client->socket_fd = 0;
+        net_cleanup_client_state(client);
+        free(client);
+    }
     return added;
 }
 
 // Remove client from program
 void net_remove_client(NetworkProgram* program, int socket_fd) {
-    if (!program) return;
-    
+    if (!program || socket_fd < 0) return;
+
+    ClientState* client = NULL;
     pthread_mutex_lock(&program->clients_lock);
-    
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active && program->clients[i].socket_fd == socket_fd) {
-            close(program->clients[i].socket_fd);
-            program->clients[i].is_active = false;
-            program->clients[i].socket_fd = 0;
+    if ((size_t)socket_fd < program->client_capacity) {
+        client = program->clients[socket_fd];
+        program->clients[socket_fd] = NULL;
+        if (client) program->client_count--;
+    }
+    pthread_mutex_unlock(&program->clients_lock);
+
+    if (client) {
+        POLYCALL_LOG_DEBUG("net", "Client %d disconnected", socket_fd);
+        if (program->uring) {
+            // Ends a still-armed multishot recv, which holds its own
+            // reference to the socket
+            net_uring_forget(program->uring, socket_fd);
+            shutdown(socket_fd, SHUT_RDWR);
+        } else {
+            net_event_remove(program->events, socket_fd);
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
+        net_cleanup_client_state(client);
+        free(client);
+    }
+}
+
+#ifndef _WIN32
+// Each client holds a descriptor, so lift the soft limit to the hard one
+static void raise_descriptor_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
     }
+}
+#endif
+
+// Fill in where an inherited listener listens, for the messages and
+// list_endpoints
+static bool describe_listener(NetworkEndpoint* endpoint) {
+#ifdef _WIN32
+    (void)endpoint;
+    return false;
+#else
+    struct sockaddr_storage storage;
+    socklen_t length = sizeof(storage);
+    memset(&storage, 0, sizeof(storage));
+    if (getsockname(endpoint->socket_fd, (struct sockaddr*)&storage, &length) < 0) return false;
     
-    pthread_mutex_unlock(&program->clients_lock);
+    if (net_protocol_is_unix(endpoint->protocol)) {
+        const struct sockaddr_un* un = (const struct sockaddr_un*)&storage;
+        size_t size = length > offsetof(struct sockaddr_un, sun_path)
+                    ? length - offsetof(struct sockaddr_un, sun_path) : 0;
+        if (storage.ss_family != AF_UNIX || size == 0) return false;
+        if (un->sun_path[0] == '\0') {
+            snprintf(endpoint->path, sizeof(endpoint->path), "@%.*s", (int)(size - 1), un->sun_path + 1);
+        } else {
+            snprintf(endpoint->path, sizeof(endpoint->path), "%.*s", (int)size, un->sun_path);
+        }
+        return true;
+    }
+    if (storage.ss_family != AF_INET) return false;
+    memcpy(&endpoint->addr, &storage, sizeof(endpoint->addr));
+    endpoint->port = ntohs(endpoint->addr.sin_port);
+    inet_ntop(AF_INET, &endpoint->addr.sin_addr, endpoint->address, INET_ADDRSTRLEN);
+    return true;
+#endif
 }
-void net_init_program(NetworkProgram* program) {
+
+// Port 0 picks a free port; reuse_port binds with SO_REUSEPORT. A Unix
+// protocol listens at path instead. A listen_fd of 0 or more is a socket
+// already listening, which the program takes over rather than binding.
+static void init_program(NetworkProgram* program, NetworkEventBackend backend,
+                         uint16_t port, bool reuse_port,
+                         NetworkProtocol protocol, const char* path, int listen_fd) {
     if (!program) return;
     
     // Initialize base program structure
@@ -266,46 +925,201 @@ void net_init_program(NetworkProgram* program) {
     // Allocate endpoints
     program->endpoints = calloc(1, sizeof(NetworkEndpoint));
     if (!program->endpoints) {
-        fprintf(stderr, "Failed to allocate endpoints\n");
+        POLYCALL_LOG_ERROR("net", "Failed to allocate endpoints");
         return;
     }
     program->count = 1;
     
     // Initialize default endpoint
     NetworkEndpoint* endpoint = &program->endpoints[0];
+    endpoint->protocol = protocol;
+    endpoint->role = NET_SERVER;
+    
+    // Named for the log messages below
+    char where[NET_UNIX_PATH_MAX + 8];
+    if (listen_fd >= 0) {
+        // Bound and listening already, and still shared with the process
+        // that handed it over: closing it must not shut it down
+        endpoint->socket_fd = listen_fd;
+        if (!describe_listener(endpoint)) {
+            POLYCALL_LOG_ERROR("net", "Inherited socket %d is not a %s listener", listen_fd,
+                               net_protocol_name(protocol));
+            close(listen_fd);
+            free(program->endpoints);
+            program->endpoints = NULL;
+            program->count = 0;
+            return;
+        }
+        if (net_protocol_is_unix(protocol)) {
+            snprintf(where, sizeof(where), "%s", endpoint->path);
+        } else {
+            snprintf(where, sizeof(where), "port %d", endpoint->port);
+        }
+        pthread_mutex_init(&endpoint->lock, NULL);
+        endpoint->inherited = true;
+        POLYCALL_LOG_INFO("net", "Took over the listener on %s", where);
+    } else if (net_protocol_is_unix(protocol)) {
+        snprintf(endpoint->path, sizeof(endpoint->path), "%s", path ? path : "");
+        snprintf(where, sizeof(where), "%s", endpoint->path);
+    } else {
+        // Try to find an available port
+        if (port == 0) program->claimed_port = port = find_available_port(8080, 8180);
+        if (port == 0) {
+            POLYCALL_LOG_ERROR("net", "No available ports found in range 8080-8180");
+            free(program->endpoints);
+            program->endpoints = NULL;
+            program->count = 0;
+            return;
+        }
+        
+        POLYCALL_LOG_INFO("net", "Using port %d", port);
+        
+        endpoint->port = port;
+        endpoint->reuse_port = reuse_port;
+        strncpy(endpoint->address, "0.0.0.0", INET_ADDRSTRLEN);
+        snprintf(where, sizeof(where), "port %d", port);
+    }
     
-    // Try to find an available port
-    uint16_t port = find_available_port(8080, 8180);
-    if (port == 0) {
-        fprintf(stderr, "No available ports found in range 8080-8180\n");
+    // Initialize endpoint
+    if (listen_fd < 0 && !net_init(endpoint)) {
+        POLYCALL_LOG_ERROR("net", "Failed to initialize endpoint on %s", where);
         free(program->endpoints);
         program->endpoints = NULL;
         program->count = 0;
+        release_port_claim(program->claimed_port);
+        program->claimed_port = 0;
         return;
     }
-    
-    printf("Using port %d\n", port);
-    
-    endpoint->port = port;
-    endpoint->protocol = NET_TCP;
-    endpoint->role = NET_SERVER;
-    strncpy(endpoint->address, "0.0.0.0", INET_ADDRSTRLEN);
-    
-    // Initialize endpoint
-    if (!net_init(endpoint)) {
-        fprintf(stderr, "Failed to initialize endpoint on port %d\n", port);
+
+#ifndef _WIN32
+    raise_descriptor_limit();
+#endif
+
+    // Without a pool, reads fall back to one-off buffers
+    program->buffers = net_buffer_pool_create(NET_PACKET_BUFFER_SIZE);
+
+    // io_uring keeps the listener blocking and arms one multishot accept
+    if (backend == NET_EVENT_URING) {
+        program->uring = net_uring_create();
+        if (program->uring && net_uring_accept(program->uring, endpoint->socket_fd)) {
+            POLYCALL_LOG_INFO("net", "Network program initialized successfully on %s (io_uring)", where);
+            return;
+        }
+        net_uring_destroy(program->uring);
+        program->uring = NULL;
+        backend = NET_EVENT_AUTO;
+        POLYCALL_LOG_WARN("net", "Event backend io_uring unavailable, falling back");
+    }
+
+    // Register the listener; accepts are drained, so it must not block
+    program->events = net_event_create(backend);
+    if (!program->events && backend != NET_EVENT_SELECT) {
+        POLYCALL_LOG_WARN("net", "Event backend %s unavailable, using select",
+                net_event_backend_name(backend));
+        program->events = net_event_create(NET_EVENT_SELECT);
+    }
+    if (!program->events ||
+        set_nonblocking(endpoint->socket_fd) < 0 ||
+        !net_event_add(program->events, endpoint->socket_fd)) {
+        POLYCALL_LOG_ERROR("net", "Failed to register endpoint on %s", where);
+        net_event_destroy(program->events);
+        program->events = NULL;
+        net_buffer_pool_destroy(program->buffers);
+        program->buffers = NULL;
+        net_close(endpoint);
         free(program->endpoints);
         program->endpoints = NULL;
         program->count = 0;
+        release_port_claim(program->claimed_port);
+        program->claimed_port = 0;
+        return;
+    }
+    
+    POLYCALL_LOG_INFO("net", "Network program initialized successfully on %s (%s)", where,
+            net_event_backend_name(net_event_backend(program->events)));
+}
+
+void net_init_program(NetworkProgram* program) {
+    init_program(program, NET_EVENT_AUTO, 0, false, NET_TCP, NULL, -1);
+}
+
+void net_init_program_with_backend(NetworkProgram* program, NetworkEventBackend backend) {
+    init_program(program, backend, 0, false, NET_TCP, NULL, -1);
+}
+
+// Several programs may share one port; the kernel spreads connections
+// across their listeners
+void net_init_program_shared(NetworkProgram* program, NetworkEventBackend backend, uint16_t port) {
+    init_program(program, backend, port, true, NET_TCP, NULL, -1);
+}
+
+// Listen on a Unix socket (NET_UNIX or NET_UNIX_SEQPACKET) for sidecars
+// on the same host; the socket file goes away with the program
+void net_init_program_unix(NetworkProgram* program, NetworkEventBackend backend,
+                           NetworkProtocol protocol, const char* path) {
+    // Anything else ends up as a program without endpoints, like any
+    // other failure
+    if (!net_protocol_is_unix(protocol)) {
+        POLYCALL_LOG_ERROR("net", "%s is not a Unix protocol", net_protocol_name(protocol));
+        protocol = NET_UNIX;
+        path = NULL;
+    }
+    init_program(program, backend, 0, false, protocol, path, -1);
+}
+
+// Serve on a listener handed over by another process (NET_TCP or a Unix
+// protocol). The program owns listen_fd from here on, even on failure.
+void net_init_program_adopt(NetworkProgram* program, NetworkEventBackend backend,
+                            NetworkProtocol protocol, int listen_fd) {
+    if (listen_fd < 0) {
+        memset(program, 0, sizeof(NetworkProgram));
+        pthread_mutex_init(&program->clients_lock, NULL);
+        POLYCALL_LOG_ERROR("net", "No listener to take over");
         return;
     }
+    init_program(program, backend, 0, false, protocol, NULL, listen_fd);
+}
+
+// The listener stays open in the process that took it over; closing our
+// copy leaves it, and its socket file, alone. Clients already connected
+// are served until they leave.
+void net_stop_accepting(NetworkProgram* program) {
+    if (!program || !program->endpoints || program->count == 0) return;
+    NetworkEndpoint* endpoint = &program->endpoints[0];
+    int listen_fd = endpoint->socket_fd;
+    if (listen_fd <= 0 || program->draining) return;
     
-    // Initialize client states
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        net_init_client_state(&program->clients[i]);
+    program->draining = true;
+    if (program->uring) {
+        net_uring_cancel_accept(program->uring, listen_fd);
+        net_uring_submit(program->uring);
     }
+    if (program->events) net_event_remove(program->events, listen_fd);
     
-    fprintf(stderr, "Network program initialized successfully on port %d\n", port);
+    pthread_mutex_lock(&endpoint->lock);
+    close(listen_fd);
+    endpoint->socket_fd = 0;
+    pthread_mutex_unlock(&endpoint->lock);
+    POLYCALL_LOG_INFO("net", "Stopped accepting; %zu clients left to serve", program->client_count);
+}
+
+// Only the thread running net_run writes the counters
+static void bump_counter(_Atomic uint64_t* counter, uint64_t amount) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+void net_get_stats(NetworkProgram* program, NetworkStats* stats) {
+    if (!program || !stats) return;
+    stats->accepted = atomic_load_explicit(&program->counters.accepted, memory_order_relaxed);
+    stats->disconnected = atomic_load_explicit(&program->counters.disconnected, memory_order_relaxed);
+    stats->packets = atomic_load_explicit(&program->counters.packets, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&program->counters.bytes, memory_order_relaxed);
+    stats->wakeups = atomic_load_explicit(&program->counters.wakeups, memory_order_relaxed);
+    pthread_mutex_lock(&program->clients_lock);
+    stats->clients = program->client_count;
+    pthread_mutex_unlock(&program->clients_lock);
 }
 
 void net_cleanup_program(NetworkProgram* program) {
@@ -323,160 +1137,360 @@ void net_cleanup_program(NetworkProgram* program) {
         program->endpoints = NULL;
     }
     program->count = 0;
-    
-    // Clean up clients
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        net_cleanup_client_state(&program->clients[i]);
+    if (program->claimed_port) {
+        release_port_claim(program->claimed_port);
+        program->claimed_port = 0;
     }
     
+    // Detach the clients; they are freed below, outside the table lock
+    ClientState** clients = program->clients;
+    size_t client_capacity = program->client_capacity;
+    program->clients = NULL;
+    program->client_capacity = 0;
+    program->client_count = 0;
+
+    net_event_destroy(program->events);
+    program->events = NULL;
+    net_uring_destroy(program->uring);
+    program->uring = NULL;
+
+    // Buffers still retained by handlers keep the pool alive
+    net_buffer_pool_destroy(program->buffers);
+    program->buffers = NULL;
+    
     pthread_mutex_unlock(&program->clients_lock);
+
+    // Handlers send while holding their client's lock and take the table
+    // lock after it, so a client's locks are never taken under the table
+    // lock (as in net_remove_client)
+    for (size_t i = 0; i < client_capacity; i++) {
+        if (clients[i]) {
+            net_cleanup_client_state(clients[i]);
+            free(clients[i]);
+        }
+    }
+    free(clients);
     pthread_mutex_destroy(&program->clients_lock);
 }
 
-void net_run(NetworkProgram* program) {
-    if (!program) {
-        fprintf(stderr, "DEBUG: net_run called with NULL program\n");
-        return;
+// Clients are keyed by IPv4 address; other peers (Unix sockets) get a
+// zeroed one
+static struct sockaddr_in inet_address(const struct sockaddr_storage* peer) {
+    struct sockaddr_in addr;
+    if (peer->ss_family == AF_INET) {
+        memcpy(&addr, peer, sizeof(addr));
+    } else {
+        memset(&addr, 0, sizeof(addr));
     }
-    
-    if (!program->running) {
-        fprintf(stderr, "DEBUG: Program not running\n");
-        return;
+    return addr;
+}
+
+// Accept every pending connection; readiness is reported once per burst
+static void accept_pending(NetworkProgram* program, int listen_fd) {
+    for (;;) {
+        struct sockaddr_storage peer;
+        socklen_t addr_len = sizeof(peer);
+        memset(&peer, 0, sizeof(peer));
+
+        int new_socket = accept(listen_fd, (struct sockaddr*)&peer, &addr_len);
+        struct sockaddr_in client_addr = inet_address(&peer);
+        if (new_socket < 0) {
+            if (errno == EINTR) continue;
+            if (!would_block() && errno != ECONNABORTED) {
+                POLYCALL_LOG_WARN("net", "accept failed: %s", strerror(errno));
+            }
+            return;
+        }
+
+        // Set socket to non-blocking mode
+        if (set_nonblocking(new_socket) < 0 ||
+            !net_add_client(program, new_socket, client_addr)) {
+            close(new_socket);
+            continue;
+        }
+        bump_counter(&program->counters.accepted, 1);
+        polycall_metrics_inc(POLYCALL_METRIC_NET_ACCEPTED);
+
+        if (program->handlers.on_connect) {
+            NetworkEndpoint client_endpoint = {
+                .socket_fd = new_socket,
+                .addr = client_addr,
+                .phantom = program->phantom,
+                .user_data = program->user_data,
+                .uring = program->uring,
+                .program = program
+            };
+            program->handlers.on_connect(&client_endpoint);
+        }
     }
-    
-    if (!program->endpoints || program->count == 0) {
-        fprintf(stderr, "DEBUG: No endpoints initialized\n");
-        return;
+}
+
+// Descriptors the handler did not keep
+static void close_fds(const int* fds, int count) {
+    for (int i = 0; i < count; i++) {
+        if (fds[i] >= 0) close(fds[i]);
     }
+}
 
-    fd_set readfds;
-    struct timeval tv = {
-        .tv_sec = 1,  // 1 second timeout
-        .tv_usec = 0
-    };
+// Read everything the client has sent; returns false once it has gone
+// Reads land straight in a pool buffer that the handler may keep; one it
+// leaves alone is reused for the next read
+static bool drain_client(NetworkProgram* program, ClientState* client) {
+    NetworkBuffer* buffer = NULL;
+    bool connected;
 
-    // Setup file descriptors
-    FD_ZERO(&readfds);
-    fprintf(stderr, "DEBUG: Setting up file descriptors for socket %d\n", 
-            program->endpoints[0].socket_fd);
-            
-    int max_fd = program->endpoints[0].socket_fd;
-    if (max_fd <= 0) {
-        fprintf(stderr, "DEBUG: Invalid socket descriptor\n");
-        return;
+    for (;;) {
+        if (!buffer) {
+            buffer = net_buffer_alloc(program->buffers, NET_PACKET_BUFFER_SIZE);
+            if (!buffer) return false;
+        }
+        int fds[NET_MAX_FDS];
+        int fd_count;
+        int msg_flags;
+        ssize_t bytes_read = receive_message(client->socket_fd, buffer->data, buffer->capacity, 0,
+                                             fds, &fd_count, &msg_flags);
+        // A seqpacket message is cut off rather than split; the rest is lost
+        if (bytes_read > 0 && (msg_flags & MSG_TRUNC)) {
+            POLYCALL_LOG_WARN("net", "Message from client %d over %zu bytes, closing",
+                              client->socket_fd, buffer->capacity);
+            close_fds(fds, fd_count);
+            connected = false;
+            break;
+        }
+        if (bytes_read > 0) {
+            buffer->length = (size_t)bytes_read;
+            bump_counter(&program->counters.packets, 1);
+            bump_counter(&program->counters.bytes, (uint64_t)bytes_read);
+            polycall_metrics_add(POLYCALL_METRIC_NET_BYTES_IN, (uint64_t)bytes_read);
+            if (program->handlers.on_receive) {
+                NetworkEndpoint client_endpoint = {
+                    .socket_fd = client->socket_fd,
+                    .addr = client->addr,
+                    .phantom = program->phantom,
+                    .user_data = program->user_data,
+                    .uring = program->uring,
+                    .program = program
+                };
+                NetworkPacket packet = {
+                    .data = buffer->data,
+                    .size = (size_t)bytes_read,
+                    .flags = 0,
+                    .buffer = buffer,
+                    .fds = fd_count > 0 ? fds : NULL,
+                    .fd_count = fd_count
+                };
+                program->handlers.on_receive(&client_endpoint, &packet);
+                if (!net_buffer_unique(buffer)) {
+                    net_buffer_release(buffer);
+                    buffer = NULL;
+                }
+            }
+            close_fds(fds, fd_count);
+            continue;
+        }
+        close_fds(fds, fd_count);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        connected = bytes_read < 0 && would_block();
+        break;
     }
-    
-    FD_SET(max_fd, &readfds);
+    net_buffer_release(buffer);
+    return connected;
+}
 
-    // Add active clients
+static void service_client(NetworkProgram* program, int fd) {
     pthread_mutex_lock(&program->clients_lock);
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active) {
-            int fd = program->clients[i].socket_fd;
-            if (fd > 0) {
-                FD_SET(fd, &readfds);
-                if (fd > max_fd) max_fd = fd;
-            }
+    ClientState* client = (size_t)fd < program->client_capacity ? program->clients[fd] : NULL;
+    pthread_mutex_unlock(&program->clients_lock);
+    if (!client) return;
+
+    pthread_mutex_lock(&client->lock);
+    bool connected = client->is_active && drain_client(program, client);
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = client->socket_fd,
+        .addr = client->addr,
+        .phantom = program->phantom,
+        .user_data = program->user_data,
+        .uring = program->uring,
+        .program = program
+    };
+    pthread_mutex_unlock(&client->lock);
+
+    if (!connected) {
+        bump_counter(&program->counters.disconnected, 1);
+        polycall_metrics_inc(POLYCALL_METRIC_NET_DISCONNECTED);
+        if (program->handlers.on_disconnect) {
+            program->handlers.on_disconnect(&client_endpoint);
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
+        net_remove_client(program, fd);
+    }
+}
+
+static void uring_accepted(NetworkProgram* program, int new_socket) {
+    struct sockaddr_storage peer;
+    socklen_t addr_len = sizeof(peer);
+    memset(&peer, 0, sizeof(peer));
+    getpeername(new_socket, (struct sockaddr*)&peer, &addr_len);
+    struct sockaddr_in client_addr = inet_address(&peer);
+
+    // Replies are queued and sent as the previous one completes, which
+    // Nagle would hold back for the peer's delayed ACK
+    if (peer.ss_family == AF_INET) {
+        int on = 1;
+        setsockopt(new_socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    // The ring needs blocking sockets; it never parks the thread on them
+    if (!net_add_client(program, new_socket, client_addr)) {
+        close(new_socket);
+        return;
     }
+    bump_counter(&program->counters.accepted, 1);
+    polycall_metrics_inc(POLYCALL_METRIC_NET_ACCEPTED);
+
+    if (program->handlers.on_connect) {
+        NetworkEndpoint client_endpoint = {
+            .socket_fd = new_socket,
+            .addr = client_addr,
+            .phantom = program->phantom,
+            .user_data = program->user_data,
+            .uring = program->uring,
+            .program = program
+        };
+        program->handlers.on_connect(&client_endpoint);
+    }
+}
+
+static void uring_received(NetworkProgram* program, const NetworkUringEvent* event) {
+    pthread_mutex_lock(&program->clients_lock);
+    ClientState* client = (size_t)event->fd < program->client_capacity
+                              ? program->clients[event->fd] : NULL;
     pthread_mutex_unlock(&program->clients_lock);
 
-    fprintf(stderr, "DEBUG: Calling select with max_fd=%d\n", max_fd);
-    
-    // Wait for activity with timeout
-    int activity = select(max_fd + 1, &readfds, NULL, NULL, &tv);
-    
-    if (activity < 0) {
-        if (errno != EINTR) {
-            perror("DEBUG: select error");
+    // Completions can outlive the connection they were armed for
+    if (!client || client->tag != event->tag) return;
+
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = client->socket_fd,
+        .addr = client->addr,
+        .phantom = program->phantom,
+        .user_data = program->user_data,
+        .uring = program->uring,
+        .program = program
+    };
+
+    if (event->result > 0) {
+        bump_counter(&program->counters.packets, 1);
+        bump_counter(&program->counters.bytes, (uint64_t)event->result);
+        polycall_metrics_add(POLYCALL_METRIC_NET_BYTES_IN, (uint64_t)event->result);
+        if (program->handlers.on_receive && event->data) {
+            NetworkPacket packet = {
+                .data = event->data,
+                .size = (size_t)event->result,
+                .flags = 0,
+                .buffer = NULL          // Ring buffer, recycled after the call
+            };
+            pthread_mutex_lock(&client->lock);
+            program->handlers.on_receive(&client_endpoint, &packet);
+            pthread_mutex_unlock(&client->lock);
         }
+        if (event->more || net_uring_recv(program->uring, event->fd, event->tag)) return;
+    } else if (event->result == -ENOBUFS) {
+        // Every receive buffer was in use; the kernel disarmed the recv
+        if (net_uring_recv(program->uring, event->fd, event->tag)) return;
+    }
+
+    bump_counter(&program->counters.disconnected, 1);
+    polycall_metrics_inc(POLYCALL_METRIC_NET_DISCONNECTED);
+    if (program->handlers.on_disconnect) {
+        program->handlers.on_disconnect(&client_endpoint);
+    }
+    net_remove_client(program, event->fd);
+}
+
+// Completion-driven counterpart of the readiness loop in net_run
+static void run_uring(NetworkProgram* program, int listen_fd) {
+    NetworkUringEvent events[NET_EVENT_BATCH];
+    int ready = net_uring_wait(program->uring, events,
+                               NET_TIMEOUT_SEC * 1000 + NET_TIMEOUT_USEC / 1000);
+    if (ready < 0) {
+        POLYCALL_LOG_ERROR("net", "io_uring wait failed: %s", strerror(errno));
         return;
     }
 
-    fprintf(stderr, "DEBUG: Select returned %d\n", activity);
+    if (ready > 0) bump_counter(&program->counters.wakeups, 1);
+    POLYCALL_LOG_TRACE("net", "io_uring returned %d completions", ready);
 
-    // Handle new connections
-    if (FD_ISSET(program->endpoints[0].socket_fd, &readfds)) {
-        struct sockaddr_in client_addr;
-        socklen_t addr_len = sizeof(client_addr);
-        
-        int new_socket = accept(program->endpoints[0].socket_fd,
-                              (struct sockaddr*)&client_addr,
-                              &addr_len);
-
-        if (new_socket >= 0) {
-            // Set socket to non-blocking mode
-            if (set_nonblocking(new_socket) < 0) {
-                close(new_socket);
-                return;
+    for (int i = 0; i < ready; i++) {
+        NetworkUringEvent* event = &events[i];
+        if (event->op == NET_URING_ACCEPT) {
+            if (event->result >= 0) {
+                uring_accepted(program, event->result);
             }
-
-            // Add client
-            if (net_add_client(program, new_socket, client_addr)) {
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = new_socket,
-                    .addr = client_addr,
-                    .phantom = program->phantom
-                };
-                
-                if (program->handlers.on_connect) {
-                    program->handlers.on_connect(&client_endpoint);
-                }
-            } else {
-                close(new_socket);
+            if (!event->more && !program->draining) {
+                net_uring_accept(program->uring, listen_fd);
             }
+        } else {
+            uring_received(program, event);
         }
+        net_uring_recycle(program->uring, event->buffer);
     }
 
-    // Rest of the function remains unchanged...
-    // Handle client data
-    pthread_mutex_lock(&program->clients_lock);
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active &&
-            FD_ISSET(program->clients[i].socket_fd, &readfds)) {
-            
-            char buffer[NET_BUFFER_SIZE];
-            ssize_t bytes_read = recv(program->clients[i].socket_fd,
-                                    buffer,
-                                    sizeof(buffer) - 1,
-                                    0);
-
-            if (bytes_read <= 0) {
-                // Handle disconnection
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = program->clients[i].socket_fd,
-                    .addr = program->clients[i].addr,
-                    .phantom = program->phantom
-                };
+    // One submission carries everything the handlers queued
+    net_uring_submit(program->uring);
+}
 
-                if (program->handlers.on_disconnect) {
-                    program->handlers.on_disconnect(&client_endpoint);
-                }
-                
-                net_remove_client(program, program->clients[i].socket_fd);
-            } else {
-                // Handle received data
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = program->clients[i].socket_fd,
-                    .addr = program->clients[i].addr,
-                    .phantom = program->phantom
-                };
+void net_run(NetworkProgram* program) {
+    if (!program) {
+        POLYCALL_LOG_DEBUG("net", "net_run called with NULL program");
+        return;
+    }
+    
+    if (!program->running) {
+        POLYCALL_LOG_DEBUG("net", "Program not running");
+        return;
+    }
+    
+    if (!program->endpoints || program->count == 0 || (!program->events && !program->uring)) {
+        POLYCALL_LOG_DEBUG("net", "No endpoints initialized");
+        return;
+    }
 
-                NetworkPacket packet = {
-                    .data = buffer,
-                    .size = bytes_read,
-                    .flags = 0
-                };
+    // A draining program has no listener, only its clients
+    int listen_fd = program->endpoints[0].socket_fd;
+    if (listen_fd <= 0 && !program->draining) {
+        POLYCALL_LOG_DEBUG("net", "Invalid socket descriptor");
+        return;
+    }
 
-                if (program->handlers.on_receive) {
-                    program->handlers.on_receive(&client_endpoint, &packet);
-                }
-            }
+    if (program->uring) {
+        run_uring(program, listen_fd);
+        return;
+    }
+
+    // Wait for activity with timeout
+    NetworkEvent events[NET_EVENT_BATCH];
+    int ready = net_event_wait(program->events, events,
+                               NET_TIMEOUT_SEC * 1000 + NET_TIMEOUT_USEC / 1000);
+    if (ready < 0) {
+        POLYCALL_LOG_ERROR("net", "Event wait failed: %s", strerror(errno));
+        return;
+    }
+
+    if (ready > 0) bump_counter(&program->counters.wakeups, 1);
+    POLYCALL_LOG_TRACE("net", "%s returned %d events",
+                       net_event_backend_name(net_event_backend(program->events)), ready);
+
+    for (int i = 0; i < ready; i++) {
+        if (events[i].fd == listen_fd) {
+            accept_pending(program, listen_fd);
+            continue;
+        }
+#ifndef _WIN32
+        if (events[i].flags & NET_EVENT_WRITE) {
+            flush_client(program, events[i].fd);
+            if (events[i].flags == NET_EVENT_WRITE) continue;
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
+#endif
+        service_client(program, events[i].fd);
     }
-    pthread_mutex_unlock(&program->clients_lock);
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "network_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef struct BufferSlab {
+    struct BufferSlab* next;
+    uint8_t memory[];               // NET_BUFFER_SLAB buffers of stride bytes
+} BufferSlab;
+
+struct NetworkBufferPool {
+    pthread_mutex_t lock;           // Guards free and slabs
+    NetworkBuffer* free;            // Returned buffers, linked through next
+    BufferSlab* slabs;
+    size_t buffer_size;             // Capacity of each pooled buffer
+    size_t stride;                  // Header plus capacity, kept aligned
+    _Atomic size_t refs;            // Buffers handed out, plus one for the owner
+};
+
+static void pool_unref(NetworkBufferPool* pool) {
+    if (atomic_fetch_sub_explicit(&pool->refs, 1, memory_order_acq_rel) != 1) return;
+
+    BufferSlab* slab = pool->slabs;
+    while (slab) {
+        BufferSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+NetworkBufferPool* net_buffer_pool_create(size_t buffer_size) {
+    if (buffer_size == 0) return NULL;
+
+    NetworkBufferPool* pool = calloc(1, sizeof(NetworkBufferPool));
+    if (!pool) return NULL;
+
+    size_t align = _Alignof(max_align_t);
+    pool->buffer_size = buffer_size;
+    pool->stride = (sizeof(NetworkBuffer) + buffer_size + align - 1) / align * align;
+    atomic_init(&pool->refs, 1);
+    pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+
+void net_buffer_pool_destroy(NetworkBufferPool* pool) {
+    if (pool) pool_unref(pool);
+}
+
+size_t net_buffer_pool_buffer_size(const NetworkBufferPool* pool) {
+    return pool ? pool->buffer_size : 0;
+}
+
+// Called with the pool locked
+static bool grow_pool(NetworkBufferPool* pool) {
+    BufferSlab* slab = malloc(sizeof(BufferSlab) + pool->stride * NET_BUFFER_SLAB);
+    if (!slab) return false;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    for (size_t i = 0; i < NET_BUFFER_SLAB; i++) {
+        NetworkBuffer* buffer = (NetworkBuffer*)(slab->memory + i * pool->stride);
+        buffer->capacity = pool->buffer_size;
+        buffer->pool = pool;
+        buffer->next = pool->free;
+        pool->free = buffer;
+    }
+    return true;
+}
+
+NetworkBuffer* net_buffer_alloc(NetworkBufferPool* pool, size_t size) {
+    NetworkBuffer* buffer = NULL;
+
+    if (pool && size <= pool->buffer_size) {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->free || grow_pool(pool)) {
+            buffer = pool->free;
+            pool->free = buffer->next;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (!buffer) return NULL;
+        atomic_fetch_add_explicit(&pool->refs, 1, memory_order_relaxed);
+    } else {
+        buffer = malloc(sizeof(NetworkBuffer) + size);
+        if (!buffer) return NULL;
+        buffer->capacity = size;
+        buffer->pool = NULL;
+    }
+
+    atomic_init(&buffer->refs, 1);
+    buffer->length = 0;
+    buffer->next = NULL;
+    return buffer;
+}
+
+NetworkBuffer* net_buffer_retain(NetworkBuffer* buffer) {
+    if (buffer) atomic_fetch_add_explicit(&buffer->refs, 1, memory_order_relaxed);
+    return buffer;
+}
+
+static void free_one(NetworkBuffer* buffer) {
+    NetworkBufferPool* pool = buffer->pool;
+    if (!pool) {
+        free(buffer);
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    buffer->next = pool->free;
+    pool->free = buffer;
+    pthread_mutex_unlock(&pool->lock);
+    pool_unref(pool);
+}
+
+void net_buffer_release(NetworkBuffer* buffer) {
+    if (!buffer) return;
+    if (atomic_fetch_sub_explicit(&buffer->refs, 1, memory_order_acq_rel) != 1) return;
+
+    while (buffer) {
+        NetworkBuffer* next = buffer->next;
+        free_one(buffer);
+        buffer = next;
+    }
+}
+
+bool net_buffer_unique(const NetworkBuffer* buffer) {
+    return buffer && atomic_load_explicit(&buffer->refs, memory_order_acquire) == 1;
+}
+
+bool net_buffer_append(NetworkBuffer* head, const void* data, size_t size) {
+    if (!head || (!data && size > 0)) return false;
+
+    NetworkBuffer* tail = head;
+    while (tail->next) tail = tail->next;
+
+    const uint8_t* bytes = data;
+    while (size > 0) {
+        if (tail->length == tail->capacity) {
+            // One-off links at least double, so a chain built from many
+            // small appends stays short
+            size_t want = head->pool ? head->pool->buffer_size
+                                     : (size > 2 * tail->capacity ? size : 2 * tail->capacity);
+            NetworkBuffer* link = net_buffer_alloc(head->pool, want);
+            if (!link) return false;
+            tail->next = link;
+            tail = link;
+        }
+        size_t room = tail->capacity - tail->length;
+        size_t take = size < room ? size : room;
+        memcpy(tail->data + tail->length, bytes, take);
+        tail->length += take;
+        bytes += take;
+        size -= take;
+    }
+    return true;
+}
+
+size_t net_buffer_chain_length(const NetworkBuffer* head) {
+    size_t total = 0;
+    for (; head; head = head->next) total += head->length;
+    return total;
+}
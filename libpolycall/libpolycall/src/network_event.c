@@ -0,0 +1,290 @@
+#include "network_event.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+#else
+    #include <sys/select.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+    #define NET_HAVE_EPOLL 1
+#endif
+
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+    defined(__NetBSD__) || defined(__DragonFly__)
+    #include <sys/types.h>
+    #include <sys/event.h>
+    #include <sys/time.h>
+    #define NET_HAVE_KQUEUE 1
+#endif
+
+struct NetworkEventLoop {
+    NetworkEventBackend backend;
+    int kernel_fd;                  // epoll or kqueue descriptor, -1 for select
+#ifdef NET_HAVE_EPOLL
+    struct epoll_event ready[NET_EVENT_BATCH];
+#endif
+#ifdef NET_HAVE_KQUEUE
+    struct kevent ready[NET_EVENT_BATCH];
+#endif
+    // Select fallback
+    fd_set watched;
+    fd_set writers;                 // Subset of watched waiting to write
+    int max_fd;                     // Highest watched descriptor, -1 if none
+    int scan_from;                  // Where the next wait resumes its scan
+};
+
+static const char* backend_names[NET_EVENT_BACKEND_MAX] = {
+    "auto", "epoll", "kqueue", "select", "io_uring"
+};
+
+const char* net_event_backend_name(NetworkEventBackend backend) {
+    if ((int)backend < 0 || backend >= NET_EVENT_BACKEND_MAX) return "unknown";
+    return backend_names[backend];
+}
+
+static NetworkEventBackend resolve_backend(NetworkEventBackend backend) {
+    if (backend != NET_EVENT_AUTO) return backend;
+#if defined(NET_HAVE_EPOLL)
+    return NET_EVENT_EPOLL;
+#elif defined(NET_HAVE_KQUEUE)
+    return NET_EVENT_KQUEUE;
+#else
+    return NET_EVENT_SELECT;
+#endif
+}
+
+NetworkEventLoop* net_event_create(NetworkEventBackend backend) {
+    backend = resolve_backend(backend);
+
+    NetworkEventLoop* loop = calloc(1, sizeof(NetworkEventLoop));
+    if (!loop) return NULL;
+    loop->backend = backend;
+    loop->kernel_fd = -1;
+    loop->max_fd = -1;
+    FD_ZERO(&loop->watched);
+    FD_ZERO(&loop->writers);
+
+    switch (backend) {
+#ifdef NET_HAVE_EPOLL
+        case NET_EVENT_EPOLL:
+            loop->kernel_fd = epoll_create1(EPOLL_CLOEXEC);
+            break;
+#endif
+#ifdef NET_HAVE_KQUEUE
+        case NET_EVENT_KQUEUE:
+            loop->kernel_fd = kqueue();
+            break;
+#endif
+        case NET_EVENT_SELECT:
+            return loop;
+        default:
+            free(loop);
+            return NULL;
+    }
+
+    if (loop->kernel_fd < 0) {
+        free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+void net_event_destroy(NetworkEventLoop* loop) {
+    if (!loop) return;
+#ifndef _WIN32
+    if (loop->kernel_fd >= 0) {
+        close(loop->kernel_fd);
+    }
+#endif
+    free(loop);
+}
+
+NetworkEventBackend net_event_backend(const NetworkEventLoop* loop) {
+    return loop ? loop->backend : NET_EVENT_AUTO;
+}
+
+bool net_event_add(NetworkEventLoop* loop, int fd) {
+    if (!loop || fd < 0) return false;
+
+    switch (loop->backend) {
+#ifdef NET_HAVE_EPOLL
+        case NET_EVENT_EPOLL: {
+            struct epoll_event ev = {
+                .events = EPOLLIN | EPOLLRDHUP | EPOLLET,
+                .data.fd = fd
+            };
+            return epoll_ctl(loop->kernel_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+        }
+#endif
+#ifdef NET_HAVE_KQUEUE
+        case NET_EVENT_KQUEUE: {
+            struct kevent change;
+            EV_SET(&change, fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, NULL);
+            return kevent(loop->kernel_fd, &change, 1, NULL, 0, NULL) == 0;
+        }
+#endif
+        default:
+#ifndef _WIN32
+            if (fd >= FD_SETSIZE) return false;
+#endif
+            FD_SET(fd, &loop->watched);
+            if (fd > loop->max_fd) loop->max_fd = fd;
+            return true;
+    }
+}
+
+void net_event_remove(NetworkEventLoop* loop, int fd) {
+    if (!loop || fd < 0) return;
+
+    switch (loop->backend) {
+#ifdef NET_HAVE_EPOLL
+        case NET_EVENT_EPOLL:
+            epoll_ctl(loop->kernel_fd, EPOLL_CTL_DEL, fd, NULL);
+            return;
+#endif
+#ifdef NET_HAVE_KQUEUE
+        case NET_EVENT_KQUEUE: {
+            // The write filter may not be there, so it goes on its own
+            // and its failure cannot hold back the read filter's removal
+            struct kevent change;
+            EV_SET(&change, fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+            kevent(loop->kernel_fd, &change, 1, NULL, 0, NULL);
+            EV_SET(&change, fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+            kevent(loop->kernel_fd, &change, 1, NULL, 0, NULL);
+            return;
+        }
+#endif
+        default:
+#ifndef _WIN32
+            if (fd >= FD_SETSIZE) return;
+#endif
+            FD_CLR(fd, &loop->watched);
+            FD_CLR(fd, &loop->writers);
+            while (loop->max_fd >= 0 && !FD_ISSET(loop->max_fd, &loop->watched)) {
+                loop->max_fd--;
+            }
+            return;
+    }
+}
+
+bool net_event_want_write(NetworkEventLoop* loop, int fd, bool on) {
+    if (!loop || fd < 0) return false;
+
+    switch (loop->backend) {
+#ifdef NET_HAVE_EPOLL
+        case NET_EVENT_EPOLL: {
+            struct epoll_event ev = {
+                .events = EPOLLIN | EPOLLRDHUP | EPOLLET | (on ? EPOLLOUT : 0),
+                .data.fd = fd
+            };
+            return epoll_ctl(loop->kernel_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+        }
+#endif
+#ifdef NET_HAVE_KQUEUE
+        case NET_EVENT_KQUEUE: {
+            struct kevent change;
+            EV_SET(&change, fd, EVFILT_WRITE, on ? EV_ADD | EV_CLEAR : EV_DELETE, 0, 0, NULL);
+            return kevent(loop->kernel_fd, &change, 1, NULL, 0, NULL) == 0 || !on;
+        }
+#endif
+        default:
+#ifndef _WIN32
+            if (fd >= FD_SETSIZE) return false;
+#endif
+            if (!FD_ISSET(fd, &loop->watched)) return false;
+            if (on) {
+                FD_SET(fd, &loop->writers);
+            } else {
+                FD_CLR(fd, &loop->writers);
+            }
+            return true;
+    }
+}
+
+static int select_wait(NetworkEventLoop* loop, NetworkEvent* events, int timeout_ms) {
+    if (loop->max_fd < 0) {
+        // Nothing watched; still honour the timeout so callers do not spin
+        struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+        select(0, NULL, NULL, NULL, timeout_ms < 0 ? NULL : &tv);
+        return 0;
+    }
+
+    fd_set readable = loop->watched;
+    fd_set writable = loop->writers;
+    struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+    int ready = select(loop->max_fd + 1, &readable, &writable, NULL,
+                       timeout_ms < 0 ? NULL : &tv);
+    if (ready <= 0) {
+        return (ready < 0 && errno != EINTR) ? -1 : 0;
+    }
+
+    // Resume the scan where the last full batch stopped so low descriptors
+    // cannot starve the rest. ready counts a descriptor once per set, so
+    // it bounds the events from above.
+    int count = 0;
+    int span = loop->max_fd + 1;
+    for (int i = 0; i < span && count < ready && count < NET_EVENT_BATCH; i++) {
+        int fd = (loop->scan_from + i) % span;
+        uint32_t flags = (FD_ISSET(fd, &readable) ? NET_EVENT_READ : 0) |
+                         (FD_ISSET(fd, &writable) ? NET_EVENT_WRITE : 0);
+        if (flags) {
+            events[count].fd = fd;
+            events[count].flags = flags;
+            count++;
+            if (count == NET_EVENT_BATCH) loop->scan_from = (fd + 1) % span;
+        }
+    }
+    return count;
+}
+
+int net_event_wait(NetworkEventLoop* loop, NetworkEvent* events, int timeout_ms) {
+    if (!loop || !events) return -1;
+
+    switch (loop->backend) {
+#ifdef NET_HAVE_EPOLL
+        case NET_EVENT_EPOLL: {
+            int n = epoll_wait(loop->kernel_fd, loop->ready, NET_EVENT_BATCH, timeout_ms);
+            if (n < 0) return errno == EINTR ? 0 : -1;
+            for (int i = 0; i < n; i++) {
+                events[i].fd = loop->ready[i].data.fd;
+                events[i].flags = 0;
+                if (loop->ready[i].events & EPOLLIN) {
+                    events[i].flags |= NET_EVENT_READ;
+                }
+                if (loop->ready[i].events & EPOLLOUT) {
+                    events[i].flags |= NET_EVENT_WRITE;
+                }
+                if (loop->ready[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    events[i].flags |= NET_EVENT_HANGUP;
+                }
+            }
+            return n;
+        }
+#endif
+#ifdef NET_HAVE_KQUEUE
+        case NET_EVENT_KQUEUE: {
+            struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+            int n = kevent(loop->kernel_fd, NULL, 0, loop->ready, NET_EVENT_BATCH,
+                           timeout_ms < 0 ? NULL : &ts);
+            if (n < 0) return errno == EINTR ? 0 : -1;
+            for (int i = 0; i < n; i++) {
+                events[i].fd = (int)loop->ready[i].ident;
+                events[i].flags = loop->ready[i].filter == EVFILT_WRITE ? NET_EVENT_WRITE
+                                                                         : NET_EVENT_READ;
+                if (loop->ready[i].flags & (EV_EOF | EV_ERROR)) {
+                    events[i].flags |= NET_EVENT_HANGUP;
+                }
+            }
+            return n;
+        }
+#endif
+        default:
+            return select_wait(loop, events, timeout_ms);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include "network_handoff.h"
+#include "polycall_log.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define HANDOFF_MAGIC   0x46485043u     // "CPHF"
+#define HANDOFF_CONFIRM 0x4B4F4843u     // "CHOK"
+#define HANDOFF_VERSION 1
+#define HANDOFF_CHUNK   65536           // State bytes per message
+
+// Sent first, with the handoff socket attached. Listeners follow in
+// batches of up to NET_MAX_FDS, each message an array of protocols with
+// the descriptors attached, and then the state in chunks.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;                 // Listeners
+    uint64_t state_size;
+} HandoffHeader;
+
+struct NetworkHandoff {
+    NetworkEndpoint listener;       // Where successors connect
+    NetworkEndpoint peer;           // The other side, while handing off
+    bool owner;                     // The socket file is ours to remove
+};
+
+static bool open_peer(NetworkHandoff* handoff, int fd, int timeout_ms) {
+    if (timeout_ms > 0) {
+        struct timeval tv = {
+            .tv_sec = timeout_ms / 1000,
+            .tv_usec = (timeout_ms % 1000) * 1000
+        };
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0 ||
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) < 0) {
+            close(fd);
+            return false;
+        }
+    }
+    pthread_mutex_init(&handoff->peer.lock, NULL);
+    handoff->peer.socket_fd = fd;
+    return true;
+}
+
+static void close_peer(NetworkHandoff* handoff) {
+    if (handoff->peer.socket_fd <= 0) return;
+    close(handoff->peer.socket_fd);
+    handoff->peer.socket_fd = 0;
+    pthread_mutex_destroy(&handoff->peer.lock);
+}
+
+// The listener may be shared with the other side: close only our copy
+static void drop_listener(NetworkHandoff* handoff) {
+    if (handoff->listener.socket_fd <= 0) return;
+    if (handoff->owner) {
+        net_close(&handoff->listener);
+    } else {
+        close(handoff->listener.socket_fd);
+        pthread_mutex_destroy(&handoff->listener.lock);
+    }
+    handoff->listener.socket_fd = 0;
+}
+
+static bool send_message(NetworkHandoff* handoff, const void* data, size_t size,
+                         const int* fds, int fd_count) {
+    struct iovec iov = { .iov_base = (void*)data, .iov_len = size };
+    return net_send_fds(&handoff->peer, &iov, 1, fds, fd_count) == (ssize_t)size;
+}
+
+// One message into data; passed descriptors land in fds
+static ssize_t receive_message(NetworkHandoff* handoff, void* data, size_t size,
+                               int* fds, int* fd_count) {
+    NetworkPacket packet = { .data = data, .size = size };
+    ssize_t result = net_receive_fds(&handoff->peer, &packet, fds);
+    *fd_count = packet.fd_count;
+    return result;
+}
+
+static void close_fds(const int* fds, int count) {
+    for (int i = 0; i < count; i++) close(fds[i]);
+}
+
+static bool send_all(NetworkHandoff* handoff, const NetworkHandoffListener* listeners,
+                     size_t count, const uint8_t* state, size_t state_size) {
+    HandoffHeader header = {
+        .magic = HANDOFF_MAGIC,
+        .version = HANDOFF_VERSION,
+        .count = (uint16_t)count,
+        .state_size = state_size
+    };
+    if (!send_message(handoff, &header, sizeof(header), &handoff->listener.socket_fd, 1)) {
+        return false;
+    }
+
+    for (size_t sent = 0; sent < count; ) {
+        uint32_t protocols[NET_MAX_FDS];
+        int fds[NET_MAX_FDS];
+        int batch = 0;
+        for (; batch < NET_MAX_FDS && sent < count; batch++, sent++) {
+            protocols[batch] = (uint32_t)listeners[sent].protocol;
+            fds[batch] = listeners[sent].fd;
+        }
+        if (!send_message(handoff, protocols, (size_t)batch * sizeof(uint32_t), fds, batch)) {
+            return false;
+        }
+    }
+
+    for (size_t sent = 0; sent < state_size; ) {
+        size_t chunk = state_size - sent < HANDOFF_CHUNK ? state_size - sent : HANDOFF_CHUNK;
+        if (!send_message(handoff, state + sent, chunk, NULL, 0)) return false;
+        sent += chunk;
+    }
+    return true;
+}
+
+NetworkHandoff* net_handoff_listen(const char* path) {
+    NetworkHandoff* handoff = calloc(1, sizeof(NetworkHandoff));
+    if (!handoff) return NULL;
+
+    NetworkEndpoint* listener = &handoff->listener;
+    listener->protocol = NET_UNIX_SEQPACKET;
+    listener->role = NET_SERVER;
+    snprintf(listener->path, sizeof(listener->path), "%s", path ? path : "");
+    if (!net_init(listener)) {
+        free(handoff);
+        return NULL;
+    }
+    // Checked on every turn of the loop, so accepting must not block
+    int flags = fcntl(listener->socket_fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(listener->socket_fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        net_close(listener);
+        free(handoff);
+        return NULL;
+    }
+    handoff->owner = true;
+    POLYCALL_LOG_INFO("net", "Accepting successors on %s", listener->path);
+    return handoff;
+}
+
+bool net_handoff_offer(NetworkHandoff* handoff,
+                       const NetworkHandoffListener* listeners, size_t count,
+                       const void* state, size_t state_size, int timeout_ms) {
+    if (!handoff || !handoff->owner || count > NET_HANDOFF_MAX_LISTENERS ||
+        (count > 0 && !listeners) || (state_size > 0 && !state) ||
+        state_size > NET_HANDOFF_MAX_STATE) {
+        errno = EINVAL;
+        return false;
+    }
+
+    int fd = accept(handoff->listener.socket_fd, NULL, NULL);
+    if (fd < 0) {
+        if (errno == EWOULDBLOCK) errno = EAGAIN;
+        return false;
+    }
+    if (!open_peer(handoff, fd, timeout_ms)) return false;
+
+    POLYCALL_LOG_INFO("net", "Successor connected, handing over %zu listeners and %zu state bytes",
+                      count, state_size);
+    uint32_t reply = 0;
+    int fds[NET_MAX_FDS];
+    int fd_count = 0;
+    bool confirmed = send_all(handoff, listeners, count, state, state_size) &&
+                     receive_message(handoff, &reply, sizeof(reply), fds, &fd_count) ==
+                         (ssize_t)sizeof(reply) &&
+                     reply == HANDOFF_CONFIRM;
+    close_fds(fds, fd_count);
+    close_peer(handoff);
+    if (!confirmed) {
+        POLYCALL_LOG_WARN("net", "Successor left before confirming; still serving");
+        errno = ECONNABORTED;
+        return false;
+    }
+
+    handoff->owner = false;
+    POLYCALL_LOG_INFO("net", "Successor took over");
+    return true;
+}
+
+// Header, listeners and state, in that order; false on anything unexpected
+static bool receive_all(NetworkHandoff* handoff, NetworkHandoffListener* listeners,
+                        size_t capacity, size_t* count, uint8_t** state, size_t* state_size) {
+    int fds[NET_MAX_FDS];
+    int fd_count;
+    HandoffHeader header;
+    uint8_t spare[sizeof(header) + 1];
+    ssize_t size = receive_message(handoff, spare, sizeof(spare), fds, &fd_count);
+    memcpy(&header, spare, sizeof(header));
+    if (size != (ssize_t)sizeof(header) || fd_count != 1 || header.magic != HANDOFF_MAGIC ||
+        header.version != HANDOFF_VERSION || header.count > capacity ||
+        header.state_size > NET_HANDOFF_MAX_STATE) {
+        POLYCALL_LOG_ERROR("net", "Bad handoff header");
+        close_fds(fds, fd_count);
+        return false;
+    }
+    pthread_mutex_init(&handoff->listener.lock, NULL);
+    handoff->listener.socket_fd = fds[0];
+
+    while (*count < header.count) {
+        uint32_t protocols[NET_MAX_FDS + 1];
+        size = receive_message(handoff, protocols, sizeof(protocols), fds, &fd_count);
+        if (size <= 0 || size != (ssize_t)(fd_count * sizeof(uint32_t)) ||
+            *count + (size_t)fd_count > header.count) {
+            POLYCALL_LOG_ERROR("net", "Bad handoff listener batch");
+            close_fds(fds, fd_count);
+            return false;
+        }
+        for (int i = 0; i < fd_count; i++) {
+            listeners[*count].fd = fds[i];
+            listeners[(*count)++].protocol = (NetworkProtocol)protocols[i];
+        }
+    }
+
+    if (header.state_size == 0) return true;
+    *state = malloc(header.state_size);
+    if (!*state) return false;
+    while (*state_size < header.state_size) {
+        size = receive_message(handoff, *state + *state_size, header.state_size - *state_size,
+                               fds, &fd_count);
+        close_fds(fds, fd_count);
+        if (size <= 0 || fd_count > 0) {
+            POLYCALL_LOG_ERROR("net", "Handoff state cut short");
+            return false;
+        }
+        *state_size += (size_t)size;
+    }
+    return true;
+}
+
+NetworkHandoff* net_handoff_take(const char* path, int timeout_ms,
+                                 NetworkHandoffListener* listeners, size_t capacity,
+                                 size_t* count, void** state, size_t* state_size) {
+    if (!listeners || !count || !state || !state_size) return NULL;
+    *count = 0;
+    *state = NULL;
+    *state_size = 0;
+
+    NetworkHandoff* handoff = calloc(1, sizeof(NetworkHandoff));
+    if (!handoff) return NULL;
+
+    // Connect through an endpoint to get its path handling, then keep
+    // just the socket
+    NetworkEndpoint connection = { .protocol = NET_UNIX_SEQPACKET, .role = NET_CLIENT };
+    snprintf(connection.path, sizeof(connection.path), "%s", path ? path : "");
+    if (!net_init(&connection)) {
+        free(handoff);
+        return NULL;
+    }
+    pthread_mutex_destroy(&connection.lock);
+    if (!open_peer(handoff, connection.socket_fd, timeout_ms)) {
+        free(handoff);
+        return NULL;
+    }
+    handoff->listener.protocol = NET_UNIX_SEQPACKET;
+    handoff->listener.role = NET_SERVER;
+    snprintf(handoff->listener.path, sizeof(handoff->listener.path), "%s", connection.path);
+
+    uint8_t* bytes = NULL;
+    if (!receive_all(handoff, listeners, capacity, count, &bytes, state_size)) {
+        for (size_t i = 0; i < *count; i++) close(listeners[i].fd);
+        *count = 0;
+        free(bytes);
+        *state_size = 0;
+        net_handoff_close(handoff);
+        return NULL;
+    }
+    *state = bytes;
+    POLYCALL_LOG_INFO("net", "Received %zu listeners and %zu state bytes from %s",
+                      *count, *state_size, handoff->listener.path);
+    return handoff;
+}
+
+bool net_handoff_confirm(NetworkHandoff* handoff) {
+    if (!handoff || handoff->peer.socket_fd <= 0) return false;
+    uint32_t confirm = HANDOFF_CONFIRM;
+    bool sent = send_message(handoff, &confirm, sizeof(confirm), NULL, 0);
+    close_peer(handoff);
+    if (!sent) return false;
+    handoff->owner = true;
+    return true;
+}
+
+int net_handoff_fd(const NetworkHandoff* handoff) {
+    return handoff && handoff->listener.socket_fd > 0 ? handoff->listener.socket_fd : -1;
+}
+
+void net_handoff_close(NetworkHandoff* handoff) {
+    if (!handoff) return;
+    close_peer(handoff);
+    drop_listener(handoff);
+    free(handoff);
+}
+
+#else
+
+NetworkHandoff* net_handoff_listen(const char* path) {
+    (void)path;
+    POLYCALL_LOG_ERROR("net", "Listener handoff needs Unix sockets");
+    return NULL;
+}
+
+bool net_handoff_offer(NetworkHandoff* handoff,
+                       const NetworkHandoffListener* listeners, size_t count,
+                       const void* state, size_t state_size, int timeout_ms) {
+    (void)handoff; (void)listeners; (void)count; (void)state; (void)state_size; (void)timeout_ms;
+    errno = ENOSYS;
+    return false;
+}
+
+NetworkHandoff* net_handoff_take(const char* path, int timeout_ms,
+                                 NetworkHandoffListener* listeners, size_t capacity,
+                                 size_t* count, void** state, size_t* state_size) {
+    (void)path; (void)timeout_ms; (void)listeners; (void)capacity;
+    if (count) *count = 0;
+    if (state) *state = NULL;
+    if (state_size) *state_size = 0;
+    POLYCALL_LOG_ERROR("net", "Listener handoff needs Unix sockets");
+    return NULL;
+}
+
+bool net_handoff_confirm(NetworkHandoff* handoff) { (void)handoff; return false; }
+int net_handoff_fd(const NetworkHandoff* handoff) { (void)handoff; return -1; }
+void net_handoff_close(NetworkHandoff* handoff) { (void)handoff; }
+
+#endif // _WIN32
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "network_reactor.h"
+#include "polycall_log.h"
+
+static void* reactor_main(void* arg) {
+    NetworkReactor* reactor = arg;
+    while (atomic_load(&reactor->group->running) && reactor->program.running) {
+        net_run(&reactor->program);
+    }
+    return NULL;
+}
+
+static size_t online_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t)cpus : 1;
+#else
+    return 1;
+#endif
+}
+
+bool net_reactors_start(NetworkReactorGroup* group, size_t count, uint16_t port,
+                        NetworkEventBackend backend) {
+    if (!group) return false;
+    if (count == 0) count = online_cpus();
+    if (count > NET_MAX_REACTORS) count = NET_MAX_REACTORS;
+
+    group->reactors = calloc(count, sizeof(NetworkReactor));
+    if (!group->reactors) return false;
+    group->count = 0;
+    atomic_store(&group->running, true);
+
+    // Bind every listener before any thread starts accepting
+    for (size_t i = 0; i < count; i++) {
+        NetworkReactor* reactor = &group->reactors[i];
+        net_init_program_shared(&reactor->program, backend, port);
+        if (!reactor->program.endpoints || reactor->program.count == 0) {
+            POLYCALL_LOG_ERROR("net", "Failed to start reactor %zu on port %d", i, port);
+            net_reactors_stop(group);
+            return false;
+        }
+        group->count++;
+
+        // The first reactor settles the port when the caller left it open
+        port = reactor->program.endpoints[0].port;
+        reactor->index = i;
+        reactor->group = group;
+        reactor->program.handlers.on_receive = group->handlers.on_receive;
+        reactor->program.handlers.on_connect = group->handlers.on_connect;
+        reactor->program.handlers.on_disconnect = group->handlers.on_disconnect;
+        reactor->program.phantom = group->phantom;
+        reactor->program.user_data = reactor;
+    }
+    group->port = port;
+
+    for (size_t i = 0; i < group->count; i++) {
+        NetworkReactor* reactor = &group->reactors[i];
+        if (pthread_create(&reactor->thread, NULL, reactor_main, reactor) != 0) {
+            POLYCALL_LOG_ERROR("net", "Failed to create reactor thread %zu", i);
+            net_reactors_stop(group);
+            return false;
+        }
+        reactor->started = true;
+    }
+    return true;
+}
+
+void net_reactors_stop(NetworkReactorGroup* group) {
+    if (!group || !group->reactors) return;
+
+    // Threads notice within one net_run timeout
+    atomic_store(&group->running, false);
+    for (size_t i = 0; i < group->count; i++) {
+        if (group->reactors[i].started) {
+            pthread_join(group->reactors[i].thread, NULL);
+            group->reactors[i].started = false;
+        }
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        net_cleanup_program(&group->reactors[i].program);
+    }
+
+    free(group->reactors);
+    group->reactors = NULL;
+    group->count = 0;
+}
+
+bool net_reactor_stats(NetworkReactorGroup* group, size_t index, NetworkStats* stats) {
+    if (!group || !stats || index >= group->count) return false;
+    net_get_stats(&group->reactors[index].program, stats);
+    return true;
+}
+
+void net_reactors_total(NetworkReactorGroup* group, NetworkStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!group) return;
+
+    for (size_t i = 0; i < group->count; i++) {
+        NetworkStats reactor;
+        net_get_stats(&group->reactors[i].program, &reactor);
+        stats->accepted += reactor.accepted;
+        stats->disconnected += reactor.disconnected;
+        stats->packets += reactor.packets;
+        stats->bytes += reactor.bytes;
+        stats->wakeups += reactor.wakeups;
+        stats->clients += reactor.clients;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "network_shm.h"
+#include <errno.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <linux/memfd.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_MAGIC        0x31304D4853434C50ull  // "PLCSHM01"
+#define SHM_CONTROL_SIZE 4096               // Control page; the rings follow
+#define SHM_PREFIX       8                  // Record length word and padding
+#define SHM_WRAP         UINT32_MAX         // Record length: go on at offset 0
+
+#define SHM_ALIGN(size) (((size) + SHM_PREFIX - 1) & ~(uint32_t)(SHM_PREFIX - 1))
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define cpu_relax() __asm__ __volatile__("yield")
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+// Positions are byte counts that wrap at 2^32; the ring size divides that.
+// Each side sleeps on its own signal word, bumped by the other side only
+// when the waiting flag says someone is asleep.
+typedef struct {
+    // Written by the reader
+    _Alignas(64) _Atomic uint32_t head;     // Bytes consumed
+    _Atomic uint32_t space_waiting;         // Writer is asleep on space_signal
+    _Atomic uint32_t space_signal;
+    // Written by the writer
+    _Alignas(64) _Atomic uint32_t tail;     // Bytes published
+    _Atomic uint32_t data_waiting;          // Reader is asleep on data_signal
+    _Atomic uint32_t data_signal;
+} ShmRing;
+
+typedef struct {
+    uint64_t magic;
+    uint64_t token;
+    uint32_t ring_size;
+    _Atomic uint32_t gone;                  // Bit per side that has left
+    ShmRing rings[2];                       // rings[0] is written by the creator
+} ShmControl;
+
+_Static_assert(sizeof(ShmControl) <= SHM_CONTROL_SIZE, "control block outgrew its page");
+
+struct NetworkShm {
+    ShmControl* control;
+    size_t map_size;
+    int fd;                                 // Creator's memfd until sealed, else -1
+    int side;                               // 0 for the creator, 1 for the peer
+    ShmRing* out;
+    ShmRing* in;
+    uint8_t* out_data;
+    uint8_t* in_data;
+    uint32_t size;                          // Bytes per ring
+    uint32_t pending;                       // Record returned by peek, 0 if none
+};
+
+static void futex_wait(_Atomic uint32_t* word, uint32_t expected, const struct timespec* timeout) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t* word) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static bool peer_gone(const NetworkShm* shm) {
+    uint32_t gone = atomic_load_explicit(&shm->control->gone, memory_order_acquire);
+    return gone & (1u << (1 - shm->side));
+}
+
+static bool has_data(NetworkShm* shm, uint32_t need) {
+    (void)need;
+    return atomic_load_explicit(&shm->in->tail, memory_order_acquire) !=
+           atomic_load_explicit(&shm->in->head, memory_order_relaxed) || peer_gone(shm);
+}
+
+static bool has_space(NetworkShm* shm, uint32_t need) {
+    uint32_t used = atomic_load_explicit(&shm->out->tail, memory_order_relaxed) -
+                    atomic_load_explicit(&shm->out->head, memory_order_acquire);
+    return (used <= shm->size && shm->size - used >= need) || peer_gone(shm);
+}
+
+// Time left until deadline, false once it has passed
+static bool time_left(const struct timespec* deadline, struct timespec* left) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left->tv_sec = deadline->tv_sec - now.tv_sec;
+    left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (left->tv_nsec < 0) {
+        left->tv_sec--;
+        left->tv_nsec += 1000000000L;
+    }
+    return left->tv_sec >= 0;
+}
+
+// Spinning only helps when the peer can run meanwhile
+static int spin_limit(void) {
+    static _Atomic int limit = -1;
+    int value = atomic_load_explicit(&limit, memory_order_relaxed);
+    if (value < 0) {
+        value = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? NET_SHM_SPIN : 0;
+        atomic_store_explicit(&limit, value, memory_order_relaxed);
+    }
+    return value;
+}
+
+// Spin for a while, then sleep on signal until ready holds or time runs out
+static bool await(NetworkShm* shm, bool (*ready)(NetworkShm*, uint32_t), uint32_t need,
+                  _Atomic uint32_t* waiting, _Atomic uint32_t* signal, int timeout_ms) {
+    if (ready(shm, need)) return true;
+    if (timeout_ms == 0) return false;
+    for (int i = spin_limit(); i > 0; i--) {
+        cpu_relax();
+        if (ready(shm, need)) return true;
+    }
+
+    struct timespec deadline, left;
+    if (timeout_ms > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    for (;;) {
+        // Read the signal before announcing ourselves, so a bump that comes
+        // between the check below and the sleep makes the sleep return
+        uint32_t seen = atomic_load_explicit(signal, memory_order_acquire);
+        atomic_store_explicit(waiting, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (ready(shm, need)) break;
+        if (timeout_ms > 0 && !time_left(&deadline, &left)) {
+            atomic_store_explicit(waiting, 0, memory_order_relaxed);
+            return false;
+        }
+        futex_wait(signal, seen, timeout_ms > 0 ? &left : NULL);
+    }
+    atomic_store_explicit(waiting, 0, memory_order_relaxed);
+    return true;
+}
+
+// Called after publishing; pairs with the fence in await
+static void wake(_Atomic uint32_t* waiting, _Atomic uint32_t* signal) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiting, memory_order_relaxed)) {
+        atomic_store_explicit(waiting, 0, memory_order_relaxed);
+        atomic_fetch_add_explicit(signal, 1, memory_order_release);
+        futex_wake(signal);
+    }
+}
+
+static bool map_region(NetworkShm* shm, int fd, uint32_t size, int side) {
+    size_t map_size = SHM_CONTROL_SIZE + 2 * (size_t)size;
+    void* base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) return false;
+
+    uint8_t* data = (uint8_t*)base + SHM_CONTROL_SIZE;
+    shm->control = base;
+    shm->map_size = map_size;
+    shm->side = side;
+    shm->size = size;
+    shm->out = &shm->control->rings[side];
+    shm->in = &shm->control->rings[1 - side];
+    shm->out_data = data + (size_t)side * size;
+    shm->in_data = data + (size_t)(1 - side) * size;
+    return true;
+}
+
+NetworkShm* net_shm_create(size_t ring_size) {
+    uint32_t size = NET_SHM_RING_MIN;
+    while (size < ring_size && size < NET_SHM_RING_MAX) size <<= 1;
+
+    NetworkShm* shm = calloc(1, sizeof(*shm));
+    if (!shm) return NULL;
+
+    uint64_t token;
+    shm->fd = (int)syscall(SYS_memfd_create, "polycall-shm", MFD_CLOEXEC);
+    if (shm->fd < 0 ||
+        ftruncate(shm->fd, SHM_CONTROL_SIZE + 2 * (off_t)size) != 0 ||
+        getrandom(&token, sizeof(token), 0) != (ssize_t)sizeof(token) ||
+        !map_region(shm, shm->fd, size, 0)) {
+        int saved = errno;
+        if (shm->fd >= 0) close(shm->fd);
+        free(shm);
+        errno = saved;
+        return NULL;
+    }
+
+    // The file starts zeroed, so only the identity needs filling in
+    shm->control->token = token;
+    shm->control->ring_size = size;
+    shm->control->magic = SHM_MAGIC;
+    return shm;
+}
+
+bool net_shm_offer(const NetworkShm* shm, NetworkShmOffer* offer) {
+    if (!shm || !offer || shm->side != 0 || shm->fd < 0) {
+        errno = EINVAL;
+        return false;
+    }
+    memset(offer, 0, sizeof(*offer));
+    offer->token = shm->control->token;
+    offer->pid = (int32_t)getpid();
+    offer->fd = shm->fd;
+    offer->ring_size = shm->size;
+    return true;
+}
+
+NetworkShm* net_shm_attach(const NetworkShmOffer* offer) {
+    if (!offer || offer->pid <= 0 || offer->fd < 0 ||
+        offer->ring_size < NET_SHM_RING_MIN || offer->ring_size > NET_SHM_RING_MAX ||
+        (offer->ring_size & (offer->ring_size - 1)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd/%d", (int)offer->pid, (int)offer->fd);
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    // The file must be exactly what the offer describes before it is mapped
+    struct stat st;
+    NetworkShm* shm = NULL;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        st.st_size != SHM_CONTROL_SIZE + 2 * (off_t)offer->ring_size) {
+        errno = EINVAL;
+    } else if ((shm = calloc(1, sizeof(*shm))) && !map_region(shm, fd, offer->ring_size, 1)) {
+        free(shm);
+        shm = NULL;
+    }
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    if (!shm) return NULL;
+
+    shm->fd = -1;
+    if (shm->control->magic != SHM_MAGIC || shm->control->token != offer->token ||
+        shm->control->ring_size != offer->ring_size) {
+        munmap(shm->control, shm->map_size);
+        free(shm);
+        errno = EINVAL;
+        return NULL;
+    }
+    return shm;
+}
+
+void net_shm_seal(NetworkShm* shm) {
+    if (!shm || shm->fd < 0) return;
+    close(shm->fd);
+    shm->fd = -1;
+}
+
+void net_shm_destroy(NetworkShm* shm) {
+    if (!shm) return;
+
+    // Whatever the peer is waiting for, it will not come now
+    atomic_fetch_or_explicit(&shm->control->gone, 1u << shm->side, memory_order_release);
+    atomic_fetch_add_explicit(&shm->out->data_signal, 1, memory_order_release);
+    atomic_fetch_add_explicit(&shm->in->space_signal, 1, memory_order_release);
+    futex_wake(&shm->out->data_signal);
+    futex_wake(&shm->in->space_signal);
+
+    munmap(shm->control, shm->map_size);
+    net_shm_seal(shm);
+    free(shm);
+}
+
+size_t net_shm_frame_limit(const NetworkShm* shm) {
+    // Half a ring, so a record never has to wait for its own wrap padding
+    return shm ? shm->size / 2 - SHM_PREFIX : 0;
+}
+
+bool net_shm_sendv(NetworkShm* shm, const struct iovec* iov, int count, int timeout_ms) {
+    if (!shm || count < 0 || (!iov && count > 0)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t length = 0;
+    for (int i = 0; i < count; i++) length += iov[i].iov_len;
+    if (length > net_shm_frame_limit(shm)) {
+        errno = EMSGSIZE;
+        return false;
+    }
+
+    // A record that would run past the end leaves the rest of the ring as
+    // padding and starts again at the front
+    uint32_t record = SHM_ALIGN(SHM_PREFIX + (uint32_t)length);
+    uint32_t tail = atomic_load_explicit(&shm->out->tail, memory_order_relaxed);
+    uint32_t offset = tail & (shm->size - 1);
+    uint32_t room = shm->size - offset;
+    uint32_t need = room < record ? room + record : record;
+
+    if (!await(shm, has_space, need, &shm->out->space_waiting, &shm->out->space_signal,
+               timeout_ms)) {
+        errno = EAGAIN;
+        return false;
+    }
+    if (peer_gone(shm)) {
+        errno = EPIPE;
+        return false;
+    }
+
+    uint32_t prefix[2] = {SHM_WRAP, 0};
+    if (room < record) {
+        memcpy(shm->out_data + offset, prefix, sizeof(prefix));
+        tail += room;
+        offset = 0;
+    }
+    prefix[0] = (uint32_t)length;
+    uint8_t* dest = shm->out_data + offset;
+    memcpy(dest, prefix, sizeof(prefix));
+    dest += SHM_PREFIX;
+    for (int i = 0; i < count; i++) {
+        memcpy(dest, iov[i].iov_base, iov[i].iov_len);
+        dest += iov[i].iov_len;
+    }
+
+    atomic_store_explicit(&shm->out->tail, tail + record, memory_order_release);
+    wake(&shm->out->data_waiting, &shm->out->data_signal);
+    return true;
+}
+
+const void* net_shm_peek(NetworkShm* shm, size_t* length) {
+    if (!shm || !length) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    uint32_t head = atomic_load_explicit(&shm->in->head, memory_order_relaxed);
+    for (;;) {
+        // Anything published before the peer left is still delivered
+        bool gone = peer_gone(shm);
+        uint32_t available = atomic_load_explicit(&shm->in->tail, memory_order_acquire) - head;
+        if (available == 0) {
+            errno = gone ? EPIPE : EAGAIN;
+            return NULL;
+        }
+
+        // The peer writes these bytes, so nothing in them is taken on trust
+        uint32_t offset = head & (shm->size - 1);
+        uint32_t prefix;
+        memcpy(&prefix, shm->in_data + offset, sizeof(prefix));
+        if (prefix == SHM_WRAP) {
+            if (available > shm->size || shm->size - offset > available) break;
+            head += shm->size - offset;
+            atomic_store_explicit(&shm->in->head, head, memory_order_release);
+            continue;
+        }
+        uint32_t record = prefix <= net_shm_frame_limit(shm) ? SHM_ALIGN(SHM_PREFIX + prefix) : 0;
+        if (record == 0 || available > shm->size || record > available ||
+            record > shm->size - offset) {
+            break;
+        }
+
+        shm->pending = record;
+        *length = prefix;
+        return shm->in_data + offset + SHM_PREFIX;
+    }
+
+    errno = EPROTO;
+    return NULL;
+}
+
+void net_shm_consume(NetworkShm* shm) {
+    if (!shm || shm->pending == 0) return;
+    atomic_fetch_add_explicit(&shm->in->head, shm->pending, memory_order_release);
+    shm->pending = 0;
+    wake(&shm->in->space_waiting, &shm->in->space_signal);
+}
+
+bool net_shm_wait(NetworkShm* shm, int timeout_ms) {
+    if (!shm) return false;
+    return await(shm, has_data, 0, &shm->in->data_waiting, &shm->in->data_signal, timeout_ms);
+}
+
+#else // !__linux__
+
+NetworkShm* net_shm_create(size_t ring_size) { (void)ring_size; errno = ENOSYS; return NULL; }
+NetworkShm* net_shm_attach(const NetworkShmOffer* offer) { (void)offer; errno = ENOSYS; return NULL; }
+bool net_shm_offer(const NetworkShm* shm, NetworkShmOffer* offer) {
+    (void)shm; (void)offer;
+    errno = ENOSYS;
+    return false;
+}
+void net_shm_seal(NetworkShm* shm) { (void)shm; }
+void net_shm_destroy(NetworkShm* shm) { (void)shm; }
+size_t net_shm_frame_limit(const NetworkShm* shm) { (void)shm; return 0; }
+bool net_shm_sendv(NetworkShm* shm, const struct iovec* iov, int count, int timeout_ms) {
+    (void)shm; (void)iov; (void)count; (void)timeout_ms;
+    errno = ENOSYS;
+    return false;
+}
+const void* net_shm_peek(NetworkShm* shm, size_t* length) {
+    (void)shm; (void)length;
+    errno = ENOSYS;
+    return NULL;
+}
+void net_shm_consume(NetworkShm* shm) { (void)shm; }
+bool net_shm_wait(NetworkShm* shm, int timeout_ms) { (void)shm; (void)timeout_ms; return false; }
+
+#endif // __linux__
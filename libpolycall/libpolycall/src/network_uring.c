@@ -0,0 +1,564 @@
+#include "network_uring.h"
+#include "network.h"
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+
+#define URING_BUFFER_GROUP 0
+#define URING_NO_SLOT -1
+#define URING_SEND_IOV 32           // Queued slots gathered into one sendmsg
+
+// user_data: op in the top byte, a 24-bit tag, then the fd or send slot
+#define URING_DATA(op, tag, low) \
+    (((uint64_t)(op) << 56) | ((uint64_t)((tag) & 0xFFFFFFu) << 32) | (uint32_t)(low))
+
+typedef struct {
+    int fd;                         // Destination socket
+    uint32_t offset;                // Bytes already sent
+    uint32_t size;                  // Bytes held
+    int next;                       // Next slot queued for fd, or next free slot
+} SendSlot;
+
+typedef struct {
+    int head;                       // First slot of the send in flight, URING_NO_SLOT when idle
+    int tail;                       // Last queued slot
+} SendQueue;
+
+// The sendmsg issued from a queue's head slot, kept with that slot until
+// it completes, since the kernel reads the iovec after submission
+typedef struct {
+    struct msghdr msg;
+    struct iovec iov[URING_SEND_IOV];
+    int count;                      // Slots covered
+} SendBatch;
+
+struct NetworkUring {
+    int fd;                         // io_uring descriptor
+
+    // Submission ring
+    void* sq_map;
+    size_t sq_map_size;
+    _Atomic unsigned* sq_head;
+    _Atomic unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local_tail;         // One past the last SQE filled
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+
+    // Completion ring
+    void* cq_map;
+    size_t cq_map_size;
+    _Atomic unsigned* cq_head;
+    _Atomic unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+
+    // Receive buffer ring, registered as group URING_BUFFER_GROUP
+    struct io_uring_buf_ring* buf_ring;
+    size_t buf_ring_size;
+    uint16_t buf_tail;
+    char* recv_buffers;
+
+    // Send slab
+    char* send_buffers;
+    SendSlot slots[NET_URING_SEND_SLOTS];
+    SendBatch* batches;             // Indexed by the batch's first slot
+    int free_slot;
+    size_t free_count;
+    SendQueue* queues;              // Indexed by fd
+    size_t queue_capacity;
+};
+
+static int sys_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                     void* arg, size_t arg_size) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static int sys_register(int fd, unsigned opcode, void* arg, unsigned count) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+// Multishot recv arrived in 6.0 and cannot be probed for
+static bool kernel_supported(void) {
+    struct utsname name;
+    int major = 0, minor = 0;
+    if (uname(&name) != 0 || sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    (void)minor;
+    return major >= 6;
+}
+
+static void recycle_buffer(NetworkUring* ring, int buffer) {
+    struct io_uring_buf* buf = &ring->buf_ring->bufs[ring->buf_tail & (NET_URING_RECV_BUFFERS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(ring->recv_buffers + (size_t)buffer * NET_BUFFER_SIZE);
+    buf->len = NET_BUFFER_SIZE;
+    buf->bid = (uint16_t)buffer;
+    ring->buf_tail++;
+    atomic_thread_fence(memory_order_release);
+    ((volatile struct io_uring_buf_ring*)ring->buf_ring)->tail = ring->buf_tail;
+}
+
+static void* map_or_null(size_t size, int fd, off_t offset) {
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED | MAP_POPULATE,
+                     fd, offset);
+    return map == MAP_FAILED ? NULL : map;
+}
+
+NetworkUring* net_uring_create(void) {
+    if (!kernel_supported()) return NULL;
+
+    NetworkUring* ring = calloc(1, sizeof(NetworkUring));
+    if (!ring) return NULL;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = NET_URING_ENTRIES * 4;
+    ring->fd = sys_setup(NET_URING_ENTRIES, &params);
+    if (ring->fd < 0) {
+        free(ring);
+        return NULL;
+    }
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)) {
+        net_uring_destroy(ring);
+        return NULL;
+    }
+
+    // Rings
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_map_size > ring->sq_map_size) ring->sq_map_size = ring->cq_map_size;
+        ring->sq_map = map_or_null(ring->sq_map_size, ring->fd, IORING_OFF_SQ_RING);
+        ring->cq_map = ring->sq_map;
+    } else {
+        ring->sq_map = map_or_null(ring->sq_map_size, ring->fd, IORING_OFF_SQ_RING);
+        ring->cq_map = map_or_null(ring->cq_map_size, ring->fd, IORING_OFF_CQ_RING);
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = map_or_null(ring->sqes_size, ring->fd, IORING_OFF_SQES);
+    if (!ring->sq_map || !ring->cq_map || !ring->sqes) {
+        net_uring_destroy(ring);
+        return NULL;
+    }
+
+    char* sq = ring->sq_map;
+    ring->sq_head = (_Atomic unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (_Atomic unsigned*)(sq + params.sq_off.tail);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_local_tail = atomic_load_explicit(ring->sq_tail, memory_order_relaxed);
+
+    char* cq = ring->cq_map;
+    ring->cq_head = (_Atomic unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (_Atomic unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    // Receive buffers, all handed to the kernel up front
+    ring->buf_ring_size = NET_URING_RECV_BUFFERS * sizeof(struct io_uring_buf);
+    ring->buf_ring = map_or_null(ring->buf_ring_size, -1, 0);
+    ring->recv_buffers = map_or_null((size_t)NET_URING_RECV_BUFFERS * NET_BUFFER_SIZE, -1, 0);
+    if (!ring->buf_ring || !ring->recv_buffers) {
+        net_uring_destroy(ring);
+        return NULL;
+    }
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring->buf_ring;
+    reg.ring_entries = NET_URING_RECV_BUFFERS;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (sys_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        net_uring_destroy(ring);
+        return NULL;
+    }
+    for (int i = 0; i < NET_URING_RECV_BUFFERS; i++) {
+        recycle_buffer(ring, i);
+    }
+
+    // Send slab
+    ring->send_buffers = map_or_null((size_t)NET_URING_SEND_SLOTS * NET_BUFFER_SIZE, -1, 0);
+    ring->batches = map_or_null(NET_URING_SEND_SLOTS * sizeof(SendBatch), -1, 0);
+    if (!ring->send_buffers || !ring->batches) {
+        net_uring_destroy(ring);
+        return NULL;
+    }
+    for (int i = 0; i < NET_URING_SEND_SLOTS; i++) {
+        ring->slots[i].next = i + 1 < NET_URING_SEND_SLOTS ? i + 1 : URING_NO_SLOT;
+    }
+    ring->free_slot = 0;
+    ring->free_count = NET_URING_SEND_SLOTS;
+    return ring;
+}
+
+void net_uring_destroy(NetworkUring* ring) {
+    if (!ring) return;
+    // Closing the ring cancels whatever is still armed
+    if (ring->fd >= 0) close(ring->fd);
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map && ring->cq_map != ring->sq_map) munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map) munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->buf_ring) munmap(ring->buf_ring, ring->buf_ring_size);
+    if (ring->recv_buffers) munmap(ring->recv_buffers, (size_t)NET_URING_RECV_BUFFERS * NET_BUFFER_SIZE);
+    if (ring->send_buffers) munmap(ring->send_buffers, (size_t)NET_URING_SEND_SLOTS * NET_BUFFER_SIZE);
+    if (ring->batches) munmap(ring->batches, NET_URING_SEND_SLOTS * sizeof(SendBatch));
+    free(ring->queues);
+    free(ring);
+}
+
+int net_uring_submit(NetworkUring* ring) {
+    if (!ring) return -1;
+    atomic_store_explicit(ring->sq_tail, ring->sq_local_tail, memory_order_release);
+    unsigned pending = ring->sq_local_tail - atomic_load_explicit(ring->sq_head, memory_order_acquire);
+    if (pending == 0) return 0;
+
+    int submitted;
+    do {
+        submitted = sys_enter(ring->fd, pending, 0, 0, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return submitted;
+}
+
+static struct io_uring_sqe* get_sqe(NetworkUring* ring) {
+    unsigned head = atomic_load_explicit(ring->sq_head, memory_order_acquire);
+    if (ring->sq_local_tail - head >= ring->sq_entries) {
+        // Queue full: hand the batch to the kernel and retry once
+        if (net_uring_submit(ring) < 0) return NULL;
+        head = atomic_load_explicit(ring->sq_head, memory_order_acquire);
+        if (ring->sq_local_tail - head >= ring->sq_entries) return NULL;
+    }
+    unsigned index = ring->sq_local_tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    ring->sq_local_tail++;
+    return sqe;
+}
+
+bool net_uring_accept(NetworkUring* ring, int listen_fd) {
+    if (!ring || listen_fd < 0) return false;
+    struct io_uring_sqe* sqe = get_sqe(ring);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = URING_DATA(NET_URING_ACCEPT, 0, listen_fd);
+    return true;
+}
+
+bool net_uring_recv(NetworkUring* ring, int fd, uint32_t tag) {
+    if (!ring || fd < 0) return false;
+    struct io_uring_sqe* sqe = get_sqe(ring);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_DATA(NET_URING_RECV, tag, fd);
+    return true;
+}
+
+bool net_uring_cancel_accept(NetworkUring* ring, int listen_fd) {
+    if (!ring || listen_fd < 0) return false;
+    struct io_uring_sqe* sqe = get_sqe(ring);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = URING_DATA(NET_URING_ACCEPT, 0, listen_fd);
+    sqe->user_data = URING_DATA(NET_URING_CANCEL, 0, listen_fd);
+    return true;
+}
+
+// One sendmsg for the queued slots from slot on, up to URING_SEND_IOV of
+// them, so a large reply is not trickled out a slot per round trip
+static bool issue_send(NetworkUring* ring, int slot) {
+    struct io_uring_sqe* sqe = get_sqe(ring);
+    if (!sqe) return false;
+    SendBatch* batch = &ring->batches[slot];
+    batch->count = 0;
+    for (int s = slot; s != URING_NO_SLOT && batch->count < URING_SEND_IOV; s = ring->slots[s].next) {
+        SendSlot* queued = &ring->slots[s];
+        batch->iov[batch->count].iov_base = ring->send_buffers + (size_t)s * NET_BUFFER_SIZE + queued->offset;
+        batch->iov[batch->count].iov_len = queued->size - queued->offset;
+        batch->count++;
+    }
+    memset(&batch->msg, 0, sizeof(batch->msg));
+    batch->msg.msg_iov = batch->iov;
+    batch->msg.msg_iovlen = (size_t)batch->count;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = ring->slots[slot].fd;
+    sqe->addr = (uint64_t)(uintptr_t)&batch->msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = URING_DATA(NET_URING_SEND, 0, slot);
+    return true;
+}
+
+static void release_slot(NetworkUring* ring, int slot) {
+    ring->slots[slot].next = ring->free_slot;
+    ring->free_slot = slot;
+    ring->free_count++;
+}
+
+static SendQueue* queue_for(NetworkUring* ring, int fd, bool create) {
+    if ((size_t)fd >= ring->queue_capacity) {
+        if (!create) return NULL;
+        size_t capacity = ring->queue_capacity ? ring->queue_capacity : NET_INITIAL_CLIENTS;
+        while (capacity <= (size_t)fd) capacity *= 2;
+        SendQueue* queues = realloc(ring->queues, capacity * sizeof(SendQueue));
+        if (!queues) return NULL;
+        for (size_t i = ring->queue_capacity; i < capacity; i++) {
+            queues[i].head = queues[i].tail = URING_NO_SLOT;
+        }
+        ring->queues = queues;
+        ring->queue_capacity = capacity;
+    }
+    return &ring->queues[fd];
+}
+
+// Release everything queued behind the in-flight send; its slots stay
+// allocated until its completion, since the kernel may still read them
+static void drop_queue(NetworkUring* ring, SendQueue* queue) {
+    if (queue->head == URING_NO_SLOT) return;
+    int last = queue->head;
+    for (int i = 1; i < ring->batches[queue->head].count; i++) last = ring->slots[last].next;
+    int slot = ring->slots[last].next;
+    ring->slots[last].next = URING_NO_SLOT;
+    while (slot != URING_NO_SLOT) {
+        int next = ring->slots[slot].next;
+        release_slot(ring, slot);
+        slot = next;
+    }
+    queue->head = queue->tail = URING_NO_SLOT;
+}
+
+// Release every slot queued for a socket, none of which is in flight
+static void release_queue(NetworkUring* ring, SendQueue* queue) {
+    int slot = queue->head;
+    while (slot != URING_NO_SLOT) {
+        int next = ring->slots[slot].next;
+        release_slot(ring, slot);
+        slot = next;
+    }
+    queue->head = queue->tail = URING_NO_SLOT;
+}
+
+ssize_t net_uring_sendv(NetworkUring* ring, int fd, const struct iovec* iov, int count) {
+    if (!ring || fd < 0 || (!iov && count > 0) || count < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t size = 0;
+    for (int i = 0; i < count; i++) {
+        if (!iov[i].iov_base && iov[i].iov_len > 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        size += iov[i].iov_len;
+    }
+    if (size == 0) return 0;
+
+    size_t needed = (size + NET_BUFFER_SIZE - 1) / NET_BUFFER_SIZE;
+    SendQueue* queue = queue_for(ring, fd, true);
+    if (!queue || needed > ring->free_count) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    // Pieces are packed back to back, so a header and its payload share a slot
+    bool idle = queue->head == URING_NO_SLOT;
+    int piece = 0;
+    size_t piece_offset = 0;
+    for (size_t done = 0; done < size; ) {
+        size_t chunk = size - done < NET_BUFFER_SIZE ? size - done : NET_BUFFER_SIZE;
+        int slot = ring->free_slot;
+        ring->free_slot = ring->slots[slot].next;
+        ring->free_count--;
+
+        char* dst = ring->send_buffers + (size_t)slot * NET_BUFFER_SIZE;
+        for (size_t filled = 0; filled < chunk; ) {
+            size_t left = iov[piece].iov_len - piece_offset;
+            size_t take = chunk - filled < left ? chunk - filled : left;
+            memcpy(dst + filled, (const char*)iov[piece].iov_base + piece_offset, take);
+            filled += take;
+            piece_offset += take;
+            if (piece_offset == iov[piece].iov_len) {
+                piece++;
+                piece_offset = 0;
+            }
+        }
+        ring->slots[slot].fd = fd;
+        ring->slots[slot].offset = 0;
+        ring->slots[slot].size = (uint32_t)chunk;
+        ring->slots[slot].next = URING_NO_SLOT;
+        if (queue->head == URING_NO_SLOT) {
+            queue->head = slot;
+        } else {
+            ring->slots[queue->tail].next = slot;
+        }
+        queue->tail = slot;
+        done += chunk;
+    }
+
+    if (idle && !issue_send(ring, queue->head)) {
+        release_queue(ring, queue);
+        errno = EAGAIN;
+        return -1;
+    }
+    return (ssize_t)size;
+}
+
+ssize_t net_uring_send(NetworkUring* ring, int fd, const void* data, size_t size) {
+    struct iovec iov = { .iov_base = (void*)data, .iov_len = size };
+    return net_uring_sendv(ring, fd, &iov, 1);
+}
+
+void net_uring_forget(NetworkUring* ring, int fd) {
+    if (!ring || fd < 0) return;
+    SendQueue* queue = queue_for(ring, fd, false);
+    if (queue) drop_queue(ring, queue);
+}
+
+static void send_completed(NetworkUring* ring, int slot, int result) {
+    if (slot < 0 || slot >= NET_URING_SEND_SLOTS) return;
+    SendQueue* queue = queue_for(ring, ring->slots[slot].fd, false);
+
+    // A forgotten socket's last send, or one whose fd has since been
+    // reused: drop_queue left only the slots this send covered
+    if (!queue || queue->head != slot) {
+        while (slot != URING_NO_SLOT) {
+            int next = ring->slots[slot].next;
+            release_slot(ring, slot);
+            slot = next;
+        }
+        return;
+    }
+
+    // The peer is gone; the receive side reports the disconnect
+    if (result <= 0) {
+        release_queue(ring, queue);
+        return;
+    }
+
+    // Retire the slots sent in full; a short send resumes mid-slot
+    size_t sent = (size_t)result;
+    while (queue->head != URING_NO_SLOT) {
+        SendSlot* s = &ring->slots[queue->head];
+        size_t left = s->size - s->offset;
+        if (sent < left) {
+            s->offset += (uint32_t)sent;
+            break;
+        }
+        sent -= left;
+        int next = s->next;
+        release_slot(ring, queue->head);
+        queue->head = next;
+    }
+
+    if (queue->head == URING_NO_SLOT) {
+        queue->tail = URING_NO_SLOT;
+    } else if (!issue_send(ring, queue->head)) {
+        release_queue(ring, queue);
+    }
+}
+
+int net_uring_wait(NetworkUring* ring, NetworkUringEvent* events, int timeout_ms) {
+    if (!ring || !events) return -1;
+
+    atomic_store_explicit(ring->sq_tail, ring->sq_local_tail, memory_order_release);
+    unsigned pending = ring->sq_local_tail - atomic_load_explicit(ring->sq_head, memory_order_acquire);
+    unsigned head = atomic_load_explicit(ring->cq_head, memory_order_relaxed);
+
+    if (head == atomic_load_explicit(ring->cq_tail, memory_order_acquire)) {
+        struct __kernel_timespec ts = {
+            .tv_sec = timeout_ms / 1000,
+            .tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL
+        };
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        if (timeout_ms >= 0) arg.ts = (uint64_t)(uintptr_t)&ts;
+        int result = sys_enter(ring->fd, pending, 1,
+                               IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                               &arg, sizeof(arg));
+        if (result < 0 && errno != ETIME && errno != EINTR) return -1;
+    } else if (pending > 0) {
+        net_uring_submit(ring);
+    }
+
+    int count = 0;
+    unsigned tail = atomic_load_explicit(ring->cq_tail, memory_order_acquire);
+    while (head != tail && count < NET_EVENT_BATCH) {
+        struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        head++;
+
+        NetworkUringOp op = (NetworkUringOp)(cqe->user_data >> 56);
+        int low = (int)(uint32_t)cqe->user_data;
+        if (op == NET_URING_SEND) {
+            send_completed(ring, low, cqe->res);
+            continue;
+        }
+        if (op == NET_URING_CANCEL) continue;
+
+        NetworkUringEvent* event = &events[count++];
+        event->op = op;
+        event->fd = low;
+        event->tag = (uint32_t)(cqe->user_data >> 32) & 0xFFFFFFu;
+        event->result = cqe->res;
+        event->more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+        event->buffer = -1;
+        event->data = NULL;
+        if (cqe->flags & IORING_CQE_F_BUFFER) {
+            event->buffer = (int)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+            event->data = ring->recv_buffers + (size_t)event->buffer * NET_BUFFER_SIZE;
+        }
+    }
+    atomic_store_explicit(ring->cq_head, head, memory_order_release);
+    return count;
+}
+
+void net_uring_recycle(NetworkUring* ring, int buffer) {
+    if (!ring || buffer < 0 || buffer >= NET_URING_RECV_BUFFERS) return;
+    recycle_buffer(ring, buffer);
+}
+
+#else // !__linux__
+
+NetworkUring* net_uring_create(void) { return NULL; }
+void net_uring_destroy(NetworkUring* ring) { (void)ring; }
+bool net_uring_accept(NetworkUring* ring, int listen_fd) { (void)ring; (void)listen_fd; return false; }
+bool net_uring_recv(NetworkUring* ring, int fd, uint32_t tag) { (void)ring; (void)fd; (void)tag; return false; }
+bool net_uring_cancel_accept(NetworkUring* ring, int listen_fd) { (void)ring; (void)listen_fd; return false; }
+ssize_t net_uring_send(NetworkUring* ring, int fd, const void* data, size_t size) {
+    (void)ring; (void)fd; (void)data; (void)size;
+    errno = ENOSYS;
+    return -1;
+}
+ssize_t net_uring_sendv(NetworkUring* ring, int fd, const struct iovec* iov, int count) {
+    (void)ring; (void)fd; (void)iov; (void)count;
+    errno = ENOSYS;
+    return -1;
+}
+void net_uring_forget(NetworkUring* ring, int fd) { (void)ring; (void)fd; }
+int net_uring_submit(NetworkUring* ring) { (void)ring; return -1; }
+int net_uring_wait(NetworkUring* ring, NetworkUringEvent* events, int timeout_ms) {
+    (void)ring; (void)events; (void)timeout_ms;
+    return -1;
+}
+void net_uring_recycle(NetworkUring* ring, int buffer) { (void)ring; (void)buffer; }
+
+#endif // __linux__
\ No newline at end of file
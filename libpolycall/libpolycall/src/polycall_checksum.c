@@ -0,0 +1,148 @@
+#include "polycall_checksum.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <nmmintrin.h>
+    #define CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__linux__)
+    #include <arm_acle.h>
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+    #define CRC32C_ARM 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78u     // Reflected Castagnoli polynomial
+
+typedef uint32_t (*crc32c_fn)(uint32_t crc, const uint8_t* bytes, size_t length);
+
+static uint32_t table[8][256];
+static crc32c_fn implementation;
+static const char* implementation_name;
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+// Portable path: eight table lookups per 8 bytes
+static uint32_t crc32c_slice8(uint32_t crc, const uint8_t* bytes, size_t length) {
+    while (length > 0 && ((uintptr_t)bytes & 7) != 0) {
+        crc = table[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+    while (length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, bytes, 4);
+        memcpy(&high, bytes + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+#endif
+        low ^= crc;
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^
+              table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+              table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+              table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length > 0) {
+        crc = table[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+    return crc;
+}
+
+#ifdef CRC32C_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* bytes, size_t length) {
+    while (length > 0 && ((uintptr_t)bytes & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+        length--;
+    }
+#ifdef __x86_64__
+    uint64_t wide = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        wide = _mm_crc32_u64(wide, word);
+        bytes += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)wide;
+#endif
+    while (length >= 4) {
+        uint32_t word;
+        memcpy(&word, bytes, 4);
+        crc = _mm_crc32_u32(crc, word);
+        bytes += 4;
+        length -= 4;
+    }
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+        length--;
+    }
+    return crc;
+}
+#endif
+
+#ifdef CRC32C_ARM
+__attribute__((target("+crc")))
+static uint32_t crc32c_armv8(uint32_t crc, const uint8_t* bytes, size_t length) {
+    while (length > 0 && ((uintptr_t)bytes & 7) != 0) {
+        crc = __crc32cb(crc, *bytes++);
+        length--;
+    }
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, bytes, 8);
+        crc = __crc32cd(crc, word);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length > 0) {
+        crc = __crc32cb(crc, *bytes++);
+        length--;
+    }
+    return crc;
+}
+#endif
+
+static void init_crc32c(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int slice = 1; slice < 8; slice++) {
+            table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+        }
+    }
+
+    implementation = crc32c_slice8;
+    implementation_name = "slice-by-8";
+#ifdef CRC32C_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        implementation = crc32c_sse42;
+        implementation_name = "sse4.2";
+    }
+#endif
+#ifdef CRC32C_ARM
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        implementation = crc32c_armv8;
+        implementation_name = "armv8";
+    }
+#endif
+}
+
+uint32_t polycall_crc32c(uint32_t crc, const void* data, size_t length) {
+    pthread_once(&init_once, init_crc32c);
+    if (!data || length == 0) return crc;
+    return ~implementation(~crc, data, length);
+}
+
+const char* polycall_crc32c_impl(void) {
+    pthread_once(&init_once, init_crc32c);
+    return implementation_name;
+}
@@ -0,0 +1,709 @@
+#include "polycall_client.h"
+#include "polycall_log.h"
+#include "polycall_metrics.h"
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <time.h>
+
+#define CLIENT_RECV_SIZE 65536
+#define CLIENT_SUBMIT_ATTEMPTS 4    // Connections tried before a call gives up
+
+// Outstanding request, in the slot its sequence maps to
+typedef struct {
+    uint32_t sequence;              // 0 when the slot is free
+    polycall_client_callback_t callback;
+    void* user_data;
+    uint64_t sent_ns;
+} client_request_t;
+
+typedef struct client_connection client_connection_t;
+
+// References: one while the pool lists the connection, one for each call
+// using it. The descriptor is closed with the last.
+struct client_connection {
+    polycall_client_pool_t* pool;
+    NetworkEndpoint endpoint;
+    polycall_protocol_context_t protocol;
+    pthread_mutex_t send_lock;      // Sequence numbers and frame writes
+    pthread_mutex_t pending_lock;   // Request table and closed
+    client_request_t* pending;      // max_inflight slots
+    _Atomic size_t outstanding;
+    _Atomic uint32_t refs;
+    bool closed;                    // Outstanding requests have been failed
+    bool watched;                   // In the I/O thread's event loop
+    bool handshake_seen;
+};
+
+struct polycall_client_pool {
+    polycall_context_t pc_ctx;
+    polycall_client_config_t config;
+    char* host;
+    char* unix_path;
+    void* credentials;
+    size_t inflight_mask;
+
+    pthread_mutex_t lock;           // Everything below up to the counters
+    client_connection_t** connections;
+    size_t count;
+    size_t capacity;
+    size_t connecting;              // Being opened outside the lock
+    client_connection_t** by_fd;    // Listed connections by descriptor
+    size_t fd_capacity;
+    bool stopping;
+
+    pthread_t thread;
+    NetworkEventLoop* events;
+    NetworkBuffer* receive;         // I/O thread only
+    int wake[2];                    // Pipe that interrupts the I/O thread
+
+    _Atomic uint64_t connects;
+    _Atomic uint64_t connect_failures;
+    _Atomic uint64_t requests;
+    _Atomic uint64_t responses;
+    _Atomic uint64_t failures;
+};
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static void bump_counter(_Atomic uint64_t* counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static void wake_io(polycall_client_pool_t* pool) {
+    char byte = 0;
+    ssize_t written = write(pool->wake[1], &byte, 1);
+    (void)written;  // A full pipe already wakes it
+}
+
+/* Connections */
+
+static void connection_release(client_connection_t* connection) {
+    if (atomic_fetch_sub_explicit(&connection->refs, 1, memory_order_acq_rel) != 1) return;
+
+    polycall_protocol_cleanup(&connection->protocol);
+    if (connection->endpoint.socket_fd > 0) close(connection->endpoint.socket_fd);
+    pthread_mutex_destroy(&connection->endpoint.lock);
+    pthread_mutex_destroy(&connection->send_lock);
+    pthread_mutex_destroy(&connection->pending_lock);
+    free(connection->pending);
+    free(connection);
+}
+
+// Complete the request registered under sequence, if it is still there
+static void complete_request(client_connection_t* connection, uint32_t sequence,
+                             polycall_client_status_t status, const void* response, size_t length) {
+    polycall_client_pool_t* pool = connection->pool;
+    pthread_mutex_lock(&connection->pending_lock);
+    client_request_t* slot = &connection->pending[sequence & pool->inflight_mask];
+    if (slot->sequence != sequence) {
+        pthread_mutex_unlock(&connection->pending_lock);
+        POLYCALL_LOG_WARN("client", "Response for unknown request %u", sequence);
+        return;
+    }
+    client_request_t request = *slot;
+    slot->sequence = 0;
+    atomic_fetch_sub_explicit(&connection->outstanding, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&connection->pending_lock);
+
+    if (status == POLYCALL_CLIENT_OK) {
+        bump_counter(&pool->responses);
+        polycall_metrics_observe(POLYCALL_METRIC_CLIENT_REQUEST_NS,
+                                 polycall_metrics_now_ns() - request.sent_ns);
+    } else {
+        bump_counter(&pool->failures);
+        polycall_metrics_inc(POLYCALL_METRIC_CLIENT_FAILURES);
+    }
+    request.callback(request.user_data, status, response, length);
+}
+
+static void client_on_handshake(polycall_protocol_context_t* ctx) {
+    client_connection_t* connection = ctx->user_data;
+    connection->handshake_seen = true;
+}
+
+static void client_on_response(polycall_protocol_context_t* ctx, uint32_t sequence,
+                               const char* response, size_t length) {
+    complete_request(ctx->user_data, sequence, POLYCALL_CLIENT_OK, response, length);
+}
+
+static void client_on_error(polycall_protocol_context_t* ctx, const char* error) {
+    (void)ctx;
+    POLYCALL_LOG_WARN("client", "Server reported an error: %.64s", error);
+}
+
+static int connect_tcp(const char* host, uint16_t port) {
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* found = NULL;
+    int error = getaddrinfo(host, service, &hints, &found);
+    if (error != 0) {
+        POLYCALL_LOG_WARN("client", "Cannot resolve %s: %s", host, gai_strerror(error));
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo* ai = found; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if (fd < 0) {
+        POLYCALL_LOG_WARN("client", "Connect to %s:%u failed: %s", host, port, strerror(errno));
+        return -1;
+    }
+
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    return fd;
+}
+
+// Read whatever has arrived and dispatch it. Sends stay blocking so a
+// frame always goes out whole; reads use MSG_DONTWAIT. Returns false when
+// the connection is finished.
+static bool drain_connection(client_connection_t* connection, NetworkBuffer** receive) {
+    for (;;) {
+        // A callback may have kept the last buffer
+        if (!net_buffer_unique(*receive)) {
+            NetworkBuffer* fresh = net_buffer_alloc(NULL, CLIENT_RECV_SIZE);
+            if (!fresh) return false;
+            net_buffer_release(*receive);
+            *receive = fresh;
+        }
+
+        NetworkBuffer* buffer = *receive;
+        ssize_t received = recv(connection->endpoint.socket_fd, buffer->data, buffer->capacity,
+                                MSG_DONTWAIT);
+        if (received > 0) {
+            NetworkPacket packet = {
+                .data = buffer->data,
+                .size = (size_t)received,
+                .buffer = buffer
+            };
+            if (!polycall_protocol_process_packet(&connection->protocol, &packet)) return false;
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+// Open, handshake and authenticate, all on the calling thread; the
+// connection only goes to the I/O thread once it is ready
+static client_connection_t* open_connection(polycall_client_pool_t* pool) {
+    const polycall_client_config_t* config = &pool->config;
+    client_connection_t* connection = calloc(1, sizeof(*connection));
+    if (!connection) return NULL;
+    connection->pending = calloc(pool->inflight_mask + 1, sizeof(client_request_t));
+    if (!connection->pending) {
+        free(connection);
+        return NULL;
+    }
+    connection->pool = pool;
+    atomic_init(&connection->refs, 1);
+    pthread_mutex_init(&connection->send_lock, NULL);
+    pthread_mutex_init(&connection->pending_lock, NULL);
+
+    if (pool->unix_path) {
+        connection->endpoint.protocol = NET_UNIX;
+        connection->endpoint.role = NET_CLIENT;
+        snprintf(connection->endpoint.path, sizeof(connection->endpoint.path), "%s",
+                 pool->unix_path);
+        if (!net_init(&connection->endpoint)) {
+            // net_init closed the socket and took the lock with it
+            connection->endpoint.socket_fd = 0;
+            pthread_mutex_init(&connection->endpoint.lock, NULL);
+            connection_release(connection);
+            return NULL;
+        }
+    } else {
+        pthread_mutex_init(&connection->endpoint.lock, NULL);
+        connection->endpoint.protocol = NET_TCP;
+        connection->endpoint.role = NET_CLIENT;
+        connection->endpoint.port = config->port;
+        connection->endpoint.socket_fd = connect_tcp(pool->host, config->port);
+        if (connection->endpoint.socket_fd < 0) {
+            connection->endpoint.socket_fd = 0;
+            connection_release(connection);
+            return NULL;
+        }
+    }
+
+    polycall_protocol_config_t protocol_config = {
+        .callbacks = {
+            .on_handshake = client_on_handshake,
+            .on_response = client_on_response,
+            .on_error = client_on_error
+        },
+        .max_message_size = config->max_message_size,
+        .user_data = connection,
+        .capabilities = (uint16_t)(config->capabilities | POLYCALL_CAP_PIPELINE)
+    };
+    if (!polycall_protocol_init(&connection->protocol, pool->pc_ctx, &connection->endpoint,
+                                &protocol_config) ||
+        !polycall_protocol_start_handshake(&connection->protocol)) {
+        POLYCALL_LOG_WARN("client", "Handshake failed: %s",
+                          polycall_protocol_get_error(&connection->protocol));
+        connection_release(connection);
+        return NULL;
+    }
+
+    // Wait for the server's handshake
+    uint64_t deadline = now_ms() + config->timeout_ms;
+    NetworkBuffer* receive = net_buffer_alloc(NULL, CLIENT_RECV_SIZE);
+    bool ok = receive != NULL;
+    while (ok && !connection->handshake_seen) {
+        uint64_t now = now_ms();
+        if (now >= deadline) {
+            POLYCALL_LOG_WARN("client", "Handshake timed out");
+            ok = false;
+            break;
+        }
+        struct pollfd readable = { .fd = connection->endpoint.socket_fd, .events = POLLIN };
+        int ready = poll(&readable, 1, (int)(deadline - now));
+        if (ready < 0 && errno != EINTR) ok = false;
+        if (ready > 0) ok = drain_connection(connection, &receive);
+    }
+    net_buffer_release(receive);
+
+    // Responses are matched by sequence, which needs pipelining
+    if (ok && !(polycall_protocol_capabilities(&connection->protocol) & POLYCALL_CAP_PIPELINE)) {
+        POLYCALL_LOG_WARN("client", "Server does not pipeline responses");
+        ok = false;
+    }
+    ok = ok && polycall_protocol_complete_handshake(&connection->protocol) &&
+         polycall_protocol_authenticate(&connection->protocol, pool->credentials,
+                                        config->credentials_length);
+    if (!ok) {
+        connection_release(connection);
+        return NULL;
+    }
+    return connection;
+}
+
+// List a ready connection and hand it to the I/O thread. Fails once the
+// pool is stopping.
+static bool list_connection(polycall_client_pool_t* pool, client_connection_t* connection) {
+    int fd = connection->endpoint.socket_fd;
+    if (pool->stopping) return false;
+
+    if (pool->count == pool->capacity) {
+        size_t capacity = pool->capacity ? pool->capacity * 2 : 4;
+        client_connection_t** grown = realloc(pool->connections, capacity * sizeof(*grown));
+        if (!grown) return false;
+        pool->connections = grown;
+        pool->capacity = capacity;
+    }
+    if ((size_t)fd >= pool->fd_capacity) {
+        size_t capacity = pool->fd_capacity ? pool->fd_capacity : 64;
+        while (capacity <= (size_t)fd) capacity *= 2;
+        client_connection_t** grown = realloc(pool->by_fd, capacity * sizeof(*grown));
+        if (!grown) return false;
+        memset(grown + pool->fd_capacity, 0, (capacity - pool->fd_capacity) * sizeof(*grown));
+        pool->by_fd = grown;
+        pool->fd_capacity = capacity;
+    }
+    pool->connections[pool->count++] = connection;
+    pool->by_fd[fd] = connection;
+    return true;
+}
+
+// Take a connection out of the pool and fail what it had outstanding.
+// I/O thread only.
+static void retire_connection(polycall_client_pool_t* pool, client_connection_t* connection,
+                              polycall_client_status_t status) {
+    pthread_mutex_lock(&pool->lock);
+    for (size_t i = 0; i < pool->count; i++) {
+        if (pool->connections[i] == connection) {
+            pool->connections[i] = pool->connections[--pool->count];
+            break;
+        }
+    }
+    pool->by_fd[connection->endpoint.socket_fd] = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    if (connection->watched) net_event_remove(pool->events, connection->endpoint.socket_fd);
+
+    // Calls that still hold the connection see it closed and go elsewhere
+    pthread_mutex_lock(&connection->pending_lock);
+    connection->closed = true;
+    pthread_mutex_unlock(&connection->pending_lock);
+    shutdown(connection->endpoint.socket_fd, SHUT_RDWR);
+
+    for (size_t i = 0; i <= pool->inflight_mask; i++) {
+        pthread_mutex_lock(&connection->pending_lock);
+        uint32_t sequence = connection->pending[i].sequence;
+        pthread_mutex_unlock(&connection->pending_lock);
+        if (sequence != 0) complete_request(connection, sequence, status, NULL, 0);
+    }
+    connection_release(connection);
+}
+
+/* I/O thread */
+
+static void* io_main(void* arg) {
+    polycall_client_pool_t* pool = arg;
+    NetworkEvent events[NET_EVENT_BATCH];
+
+    for (;;) {
+        // Start watching connections listed since the last round
+        pthread_mutex_lock(&pool->lock);
+        bool stopping = pool->stopping;
+        for (size_t i = 0; i < pool->count; i++) {
+            client_connection_t* connection = pool->connections[i];
+            if (!connection->watched) {
+                connection->watched = net_event_add(pool->events, connection->endpoint.socket_fd);
+            }
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (stopping) break;
+
+        int ready = net_event_wait(pool->events, events, -1);
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].fd;
+            if (fd == pool->wake[0]) {
+                char drain[64];
+                while (read(fd, drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+
+            pthread_mutex_lock(&pool->lock);
+            client_connection_t* connection = (size_t)fd < pool->fd_capacity ? pool->by_fd[fd] : NULL;
+            pthread_mutex_unlock(&pool->lock);
+            if (!connection) continue;
+
+            // A send that failed shut the socket down, which ends up here too
+            if (!drain_connection(connection, &pool->receive)) {
+                POLYCALL_LOG_INFO("client", "Connection closed with %zu requests outstanding",
+                                  atomic_load(&connection->outstanding));
+                retire_connection(pool, connection, POLYCALL_CLIENT_ERROR_CLOSED);
+            }
+        }
+    }
+
+    // Stopping: nothing new can be listed
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        client_connection_t* connection = pool->count ? pool->connections[0] : NULL;
+        pthread_mutex_unlock(&pool->lock);
+        if (!connection) break;
+        retire_connection(pool, connection, POLYCALL_CLIENT_ERROR_SHUTDOWN);
+    }
+    return NULL;
+}
+
+/* Pool */
+
+static char* copy_string(const char* text) {
+    if (!text) return NULL;
+    size_t length = strlen(text) + 1;
+    char* copy = malloc(length);
+    if (copy) memcpy(copy, text, length);
+    return copy;
+}
+
+static void free_pool(polycall_client_pool_t* pool) {
+    if (pool->events) net_event_destroy(pool->events);
+    if (pool->wake[0] >= 0) close(pool->wake[0]);
+    if (pool->wake[1] >= 0) close(pool->wake[1]);
+    net_buffer_release(pool->receive);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->connections);
+    free(pool->by_fd);
+    free(pool->host);
+    free(pool->unix_path);
+    free(pool->credentials);
+    free(pool);
+}
+
+polycall_client_pool_t* polycall_client_create(
+    polycall_context_t pc_ctx,
+    const polycall_client_config_t* config
+) {
+    if (!pc_ctx || !config || !config->credentials || config->credentials_length == 0 ||
+        (!config->unix_path && (!config->host || config->port == 0))) {
+        return NULL;
+    }
+
+    polycall_client_pool_t* pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->pc_ctx = pc_ctx;
+    pool->config = *config;
+    pool->wake[0] = pool->wake[1] = -1;
+    pthread_mutex_init(&pool->lock, NULL);
+
+    polycall_client_config_t* own = &pool->config;
+    if (own->max_connections == 0) own->max_connections = POLYCALL_CLIENT_DEFAULT_CONNECTIONS;
+    if (own->max_inflight == 0) own->max_inflight = POLYCALL_CLIENT_DEFAULT_INFLIGHT;
+    if (own->timeout_ms == 0) own->timeout_ms = POLYCALL_CLIENT_DEFAULT_TIMEOUT_MS;
+    size_t slots = 1;
+    while (slots < own->max_inflight) slots <<= 1;
+    pool->inflight_mask = slots - 1;
+
+    // Copies so the caller's strings may go
+    pool->host = copy_string(config->host);
+    pool->unix_path = copy_string(config->unix_path);
+    pool->credentials = malloc(config->credentials_length);
+    if (pool->credentials) memcpy(pool->credentials, config->credentials, config->credentials_length);
+    own->host = pool->host;
+    own->unix_path = pool->unix_path;
+    own->credentials = pool->credentials;
+
+    pool->events = net_event_create(NET_EVENT_AUTO);
+    pool->receive = net_buffer_alloc(NULL, CLIENT_RECV_SIZE);
+    bool ok = (pool->host || pool->unix_path) && pool->credentials && pool->events &&
+              pool->receive && pipe(pool->wake) == 0;
+    if (ok) {
+        fcntl(pool->wake[0], F_SETFL, fcntl(pool->wake[0], F_GETFL) | O_NONBLOCK);
+        fcntl(pool->wake[1], F_SETFL, fcntl(pool->wake[1], F_GETFL) | O_NONBLOCK);
+        ok = net_event_add(pool->events, pool->wake[0]) &&
+             pthread_create(&pool->thread, NULL, io_main, pool) == 0;
+    }
+    if (!ok) {
+        POLYCALL_LOG_ERROR("client", "Cannot create connection pool");
+        free_pool(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void polycall_client_destroy(polycall_client_pool_t* pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_mutex_unlock(&pool->lock);
+    wake_io(pool);
+    pthread_join(pool->thread, NULL);
+    free_pool(pool);
+}
+
+// Least loaded listed connection, or a new one while every listed one is
+// busy and there is room. Returns it with a reference, or NULL.
+static client_connection_t* acquire_connection(polycall_client_pool_t* pool,
+                                               polycall_client_status_t* status) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->stopping) {
+        pthread_mutex_unlock(&pool->lock);
+        *status = POLYCALL_CLIENT_ERROR_SHUTDOWN;
+        return NULL;
+    }
+
+    client_connection_t* best = NULL;
+    size_t best_load = SIZE_MAX;
+    for (size_t i = 0; i < pool->count; i++) {
+        size_t load = atomic_load_explicit(&pool->connections[i]->outstanding, memory_order_relaxed);
+        if (load < best_load) {
+            best = pool->connections[i];
+            best_load = load;
+        }
+    }
+
+    if ((!best || best_load > 0) && pool->count + pool->connecting < pool->config.max_connections) {
+        pool->connecting++;
+        pthread_mutex_unlock(&pool->lock);
+        client_connection_t* opened = open_connection(pool);
+        pthread_mutex_lock(&pool->lock);
+        pool->connecting--;
+
+        if (opened && list_connection(pool, opened)) {
+            bump_counter(&pool->connects);
+            wake_io(pool);
+            best = opened;
+        } else if (opened) {
+            connection_release(opened);
+            *status = pool->stopping ? POLYCALL_CLIENT_ERROR_SHUTDOWN : POLYCALL_CLIENT_ERROR_CONNECT;
+            best = NULL;
+        } else {
+            bump_counter(&pool->connect_failures);
+            *status = POLYCALL_CLIENT_ERROR_CONNECT;
+            // A connection listed while we were opening ours still serves
+            best = pool->count ? pool->connections[0] : NULL;
+        }
+    } else if (!best) {
+        *status = POLYCALL_CLIENT_ERROR_CONNECT;
+    }
+
+    if (best) atomic_fetch_add_explicit(&best->refs, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&pool->lock);
+    return best;
+}
+
+// Register the request under the sequence the command will carry, then
+// write it. Registering first means the response cannot beat the request
+// into the table.
+static polycall_client_status_t submit(client_connection_t* connection, const void* command,
+                                       size_t length, polycall_client_callback_t callback,
+                                       void* user_data) {
+    polycall_client_pool_t* pool = connection->pool;
+    pthread_mutex_lock(&connection->send_lock);
+    uint32_t sequence = connection->protocol.next_sequence;
+    if (sequence == 0) sequence = 1;
+
+    pthread_mutex_lock(&connection->pending_lock);
+    client_request_t* slot = &connection->pending[sequence & pool->inflight_mask];
+    polycall_client_status_t status = POLYCALL_CLIENT_OK;
+    if (connection->closed) {
+        status = POLYCALL_CLIENT_ERROR_CLOSED;
+    } else if (slot->sequence != 0) {
+        status = POLYCALL_CLIENT_ERROR_BUSY;
+    } else {
+        slot->sequence = sequence;
+        slot->callback = callback;
+        slot->user_data = user_data;
+        slot->sent_ns = polycall_metrics_now_ns();
+        atomic_fetch_add_explicit(&connection->outstanding, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&connection->pending_lock);
+    if (status != POLYCALL_CLIENT_OK) {
+        pthread_mutex_unlock(&connection->send_lock);
+        return status;
+    }
+
+    uint32_t sent = polycall_protocol_send_command(&connection->protocol, command, length);
+    pthread_mutex_unlock(&connection->send_lock);
+    if (sent == sequence) {
+        bump_counter(&pool->requests);
+        polycall_metrics_inc(POLYCALL_METRIC_CLIENT_REQUESTS);
+        return POLYCALL_CLIENT_OK;
+    }
+
+    // Unless the I/O thread already failed it along with the connection,
+    // the request is still ours to withdraw
+    pthread_mutex_lock(&connection->pending_lock);
+    bool withdrawn = slot->sequence == sequence;
+    if (withdrawn) {
+        slot->sequence = 0;
+        atomic_fetch_sub_explicit(&connection->outstanding, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&connection->pending_lock);
+    POLYCALL_LOG_WARN("client", "Send failed: %s", strerror(errno));
+    shutdown(connection->endpoint.socket_fd, SHUT_RDWR);
+    return withdrawn ? POLYCALL_CLIENT_ERROR_SEND : POLYCALL_CLIENT_OK;
+}
+
+polycall_client_status_t polycall_client_call_async(
+    polycall_client_pool_t* pool,
+    const void* command,
+    size_t length,
+    polycall_client_callback_t callback,
+    void* user_data
+) {
+    if (!pool || !command || length == 0 || !callback) return POLYCALL_CLIENT_ERROR_INVALID;
+
+    // A connection can close or fill up between picking and sending
+    polycall_client_status_t status = POLYCALL_CLIENT_ERROR_CONNECT;
+    for (int attempt = 0; attempt < CLIENT_SUBMIT_ATTEMPTS; attempt++) {
+        client_connection_t* connection = acquire_connection(pool, &status);
+        if (!connection) return status;
+        status = submit(connection, command, length, callback, user_data);
+        connection_release(connection);
+        if (status == POLYCALL_CLIENT_OK || status == POLYCALL_CLIENT_ERROR_SEND) break;
+    }
+    return status;
+}
+
+// Completion of a blocking call
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done_cond;
+    bool done;
+    polycall_client_status_t status;
+    void* response;
+    size_t length;
+} client_waiter_t;
+
+static void wake_waiter(void* user_data, polycall_client_status_t status,
+                        const void* response, size_t length) {
+    client_waiter_t* waiter = user_data;
+    void* copy = NULL;
+    if (status == POLYCALL_CLIENT_OK) {
+        copy = malloc(length ? length : 1);
+        if (copy) {
+            memcpy(copy, response, length);
+        } else {
+            status = POLYCALL_CLIENT_ERROR_INVALID;
+        }
+    }
+
+    pthread_mutex_lock(&waiter->lock);
+    waiter->status = status;
+    waiter->response = copy;
+    waiter->length = copy ? length : 0;
+    waiter->done = true;
+    pthread_cond_signal(&waiter->done_cond);
+    pthread_mutex_unlock(&waiter->lock);
+}
+
+polycall_client_status_t polycall_client_call(
+    polycall_client_pool_t* pool,
+    const void* command,
+    size_t length,
+    void** response,
+    size_t* response_length
+) {
+    if (!response || !response_length) return POLYCALL_CLIENT_ERROR_INVALID;
+    *response = NULL;
+    *response_length = 0;
+
+    client_waiter_t waiter = { .done = false };
+    pthread_mutex_init(&waiter.lock, NULL);
+    pthread_cond_init(&waiter.done_cond, NULL);
+
+    // Every submitted request completes, if only when its connection goes
+    polycall_client_status_t status = polycall_client_call_async(pool, command, length,
+                                                                 wake_waiter, &waiter);
+    if (status == POLYCALL_CLIENT_OK) {
+        pthread_mutex_lock(&waiter.lock);
+        while (!waiter.done) pthread_cond_wait(&waiter.done_cond, &waiter.lock);
+        pthread_mutex_unlock(&waiter.lock);
+        status = waiter.status;
+        *response = waiter.response;
+        *response_length = waiter.length;
+    }
+
+    pthread_cond_destroy(&waiter.done_cond);
+    pthread_mutex_destroy(&waiter.lock);
+    return status;
+}
+
+void polycall_client_get_stats(polycall_client_pool_t* pool, polycall_client_stats_t* stats) {
+    if (!pool || !stats) return;
+    memset(stats, 0, sizeof(*stats));
+    stats->connects = atomic_load_explicit(&pool->connects, memory_order_relaxed);
+    stats->connect_failures = atomic_load_explicit(&pool->connect_failures, memory_order_relaxed);
+    stats->requests = atomic_load_explicit(&pool->requests, memory_order_relaxed);
+    stats->responses = atomic_load_explicit(&pool->responses, memory_order_relaxed);
+    stats->failures = atomic_load_explicit(&pool->failures, memory_order_relaxed);
+
+    pthread_mutex_lock(&pool->lock);
+    stats->connections = pool->count;
+    for (size_t i = 0; i < pool->count; i++) {
+        stats->inflight += atomic_load_explicit(&pool->connections[i]->outstanding,
+                                                memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+const char* polycall_client_status_name(polycall_client_status_t status) {
+    switch (status) {
+        case POLYCALL_CLIENT_OK: return "ok";
+        case POLYCALL_CLIENT_ERROR_INVALID: return "invalid arguments";
+        case POLYCALL_CLIENT_ERROR_CONNECT: return "cannot connect";
+        case POLYCALL_CLIENT_ERROR_BUSY: return "too many requests outstanding";
+        case POLYCALL_CLIENT_ERROR_SEND: return "send failed";
+        case POLYCALL_CLIENT_ERROR_CLOSED: return "connection closed";
+        case POLYCALL_CLIENT_ERROR_SHUTDOWN: return "pool shut down";
+        default: return "unknown";
+    }
+}
\ No newline at end of file
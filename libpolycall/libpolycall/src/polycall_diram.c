@@ -0,0 +1,37 @@
+#include "polycall_diram.h"
+
+#ifdef POLYCALL_WITH_DIRAM
+#include "diram/core/feature-alloc/feature_alloc.h"
+#include <stdio.h>
+
+static void* diram_space_open(uint32_t service_id, size_t limit, void* user_data) {
+    (void)user_data;
+    char name[64];
+    snprintf(name, sizeof(name), "polycall-service-%u", service_id);
+    return diram_space_create(name, limit);
+}
+
+// Called once per arena chunk, so the space counts chunks as allocations
+static bool diram_space_charge_chunk(void* space, size_t bytes) {
+    return diram_space_charge(space, bytes, 1) == 0;
+}
+
+static void diram_space_uncharge_chunk(void* space, size_t bytes) {
+    diram_space_uncharge(space, bytes, 1);
+}
+
+static void diram_space_close(void* space) {
+    diram_space_destroy(space);
+}
+
+const PolycallMemoryBackend* polycall_diram_backend(void) {
+    static const PolycallMemoryBackend backend = {
+        .space_create = diram_space_open,
+        .charge = diram_space_charge_chunk,
+        .uncharge = diram_space_uncharge_chunk,
+        .space_destroy = diram_space_close,
+        .user_data = NULL,
+    };
+    return &backend;
+}
+#endif
@@ -0,0 +1,208 @@
+#include "polycall_log.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef DEBUG
+_Atomic int polycall_log_threshold = POLYCALL_LOG_LEVEL_DEBUG;
+#else
+_Atomic int polycall_log_threshold = POLYCALL_LOG_LEVEL_INFO;
+#endif
+
+// Bounded queue after Vyukov: each slot's sequence says whether it is free
+// for the producer holding ticket n (sequence == n) or holds a message for
+// the consumer (sequence == n + 1). Producers claim tickets with a CAS; the
+// writer thread is the only consumer.
+typedef struct {
+    _Atomic size_t sequence;
+    uint64_t timestamp_ns;
+    polycall_log_level_t level;
+    const char* module;
+    char message[POLYCALL_LOG_MESSAGE_MAX];
+} log_slot_t;
+
+static log_slot_t g_slots[POLYCALL_LOG_QUEUE_SIZE];
+static _Atomic size_t g_enqueue_pos = 0;
+static size_t g_dequeue_pos = 0;                // Writer thread only
+static _Atomic size_t g_dropped = 0;
+static size_t g_reported_drops = 0;             // Writer thread only
+
+static _Atomic(FILE*) g_sink = NULL;
+static atomic_bool g_async = false;             // Producers enqueue
+static atomic_bool g_writer_running = false;    // Writer keeps polling
+static pthread_t g_writer;
+static pthread_mutex_t g_control_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* level_names[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+
+void polycall_log_set_level(polycall_log_level_t level) {
+    atomic_store_explicit(&polycall_log_threshold, (int)level, memory_order_relaxed);
+}
+
+polycall_log_level_t polycall_log_get_level(void) {
+    return (polycall_log_level_t)atomic_load_explicit(&polycall_log_threshold, memory_order_relaxed);
+}
+
+void polycall_log_set_sink(FILE* sink) {
+    atomic_store(&g_sink, sink);
+}
+
+size_t polycall_log_dropped(void) {
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
+
+static FILE* current_sink(void) {
+    FILE* sink = atomic_load(&g_sink);
+    return sink ? sink : stderr;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void emit(FILE* sink, uint64_t timestamp_ns, polycall_log_level_t level,
+                 const char* module, const char* message) {
+    fprintf(sink, "[%llu.%06llu] %-5s %s: %s\n",
+            (unsigned long long)(timestamp_ns / 1000000000ULL),
+            (unsigned long long)(timestamp_ns % 1000000000ULL / 1000ULL),
+            level_names[level], module ? module : "-", message);
+}
+
+static bool enqueue(polycall_log_level_t level, const char* module,
+                    const char* format, va_list args) {
+    size_t pos = atomic_load_explicit(&g_enqueue_pos, memory_order_relaxed);
+    log_slot_t* slot;
+    for (;;) {
+        slot = &g_slots[pos & (POLYCALL_LOG_QUEUE_SIZE - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&g_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;       // Full
+        } else {
+            pos = atomic_load_explicit(&g_enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->timestamp_ns = now_ns();
+    slot->level = level;
+    slot->module = module;
+    vsnprintf(slot->message, sizeof(slot->message), format, args);
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+// Write out whatever is queued; returns the number of messages written
+static size_t drain(FILE* sink) {
+    size_t written = 0;
+    for (;;) {
+        log_slot_t* slot = &g_slots[g_dequeue_pos & (POLYCALL_LOG_QUEUE_SIZE - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != g_dequeue_pos + 1) break;
+
+        emit(sink, slot->timestamp_ns, slot->level, slot->module, slot->message);
+        atomic_store_explicit(&slot->sequence, g_dequeue_pos + POLYCALL_LOG_QUEUE_SIZE,
+                              memory_order_release);
+        g_dequeue_pos++;
+        written++;
+    }
+    if (written > 0) fflush(sink);
+    return written;
+}
+
+// Note in the log itself what was dropped since the last note
+static void report_drops(FILE* sink) {
+    size_t dropped = polycall_log_dropped();
+    if (dropped == g_reported_drops) return;
+    char message[64];
+    snprintf(message, sizeof(message), "%zu messages dropped, queue full",
+             dropped - g_reported_drops);
+    emit(sink, now_ns(), POLYCALL_LOG_LEVEL_WARN, "log", message);
+    fflush(sink);
+    g_reported_drops = dropped;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    unsigned idle = 0;
+
+    while (atomic_load(&g_writer_running)) {
+        FILE* sink = current_sink();
+        size_t written = drain(sink);
+        report_drops(sink);
+
+        // Back off while idle: yield a few times, then sleep up to 1ms
+        if (written > 0) {
+            idle = 0;
+        } else if (++idle < 16) {
+            sched_yield();
+        } else {
+            usleep(idle < 64 ? 100 : 1000);
+        }
+    }
+    // Drops after the last pass would otherwise go unmentioned
+    drain(current_sink());
+    report_drops(current_sink());
+    return NULL;
+}
+
+bool polycall_log_start(void) {
+    pthread_mutex_lock(&g_control_lock);
+    bool ok = true;
+    if (!atomic_load(&g_writer_running)) {
+        // Slot n starts out free for ticket n
+        if (atomic_load(&g_enqueue_pos) == 0) {
+            for (size_t i = 0; i < POLYCALL_LOG_QUEUE_SIZE; i++) {
+                atomic_store_explicit(&g_slots[i].sequence, i, memory_order_relaxed);
+            }
+        }
+        atomic_store(&g_writer_running, true);
+        if (pthread_create(&g_writer, NULL, writer_main, NULL) != 0) {
+            atomic_store(&g_writer_running, false);
+            ok = false;
+        } else {
+            atomic_store(&g_async, true);
+        }
+    }
+    pthread_mutex_unlock(&g_control_lock);
+    return ok;
+}
+
+void polycall_log_stop(void) {
+    pthread_mutex_lock(&g_control_lock);
+    if (atomic_load(&g_writer_running)) {
+        // New messages go straight to the sink; the writer drains the rest
+        atomic_store(&g_async, false);
+        atomic_store(&g_writer_running, false);
+        pthread_join(g_writer, NULL);
+    }
+    pthread_mutex_unlock(&g_control_lock);
+}
+
+void polycall_log_write(polycall_log_level_t level, const char* module, const char* format, ...) {
+    if (level >= POLYCALL_LOG_LEVEL_OFF || !polycall_log_enabled(level)) return;
+
+    va_list args;
+    va_start(args, format);
+    if (atomic_load_explicit(&g_async, memory_order_acquire)) {
+        if (!enqueue(level, module, format, args)) {
+            atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        }
+    } else {
+        char message[POLYCALL_LOG_MESSAGE_MAX];
+        vsnprintf(message, sizeof(message), format, args);
+        emit(current_sink(), now_ns(), level, module, message);
+    }
+    va_end(args);
+}
\ No newline at end of file
@@ -0,0 +1,462 @@
+#include "polycall_metrics.h"
+#include "polycall_log.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define METRICS_ACCEPT_POLL_MS 200      // How often the server thread checks for stop
+#define METRICS_REQUEST_MAX 2048        // Request bytes read before answering
+#define METRICS_REQUEST_DEADLINE_MS 2000 // Whole request read, however it trickles in
+#define METRICS_SEND_TIMEOUT_MS 2000    // Per send, so a stalled reader is dropped
+
+typedef struct {
+    const char* name;
+    const char* help;
+} metric_info_t;
+
+typedef struct {
+    const char* name;
+    const char* help;
+    polycall_gauge_fn read;
+    void* user_data;
+} gauge_info_t;
+
+typedef struct {
+    _Atomic uint64_t buckets[POLYCALL_METRICS_BUCKETS];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+} histogram_shard_t;
+
+// One thread's values. Only the owning thread writes, so updates are a
+// relaxed load and store; scrapes read them from other threads.
+typedef struct metrics_shard {
+    _Atomic uint64_t counters[POLYCALL_METRICS_MAX_COUNTERS];
+    histogram_shard_t histograms[POLYCALL_METRICS_MAX_HISTOGRAMS];
+    struct metrics_shard* next;     // Never unlinked
+    atomic_bool in_use;             // Owned by a live thread
+} metrics_shard_t;
+
+static metric_info_t g_counters[POLYCALL_METRICS_MAX_COUNTERS] = {
+    [POLYCALL_METRIC_NET_ACCEPTED] = {"polycall_net_accepted_total", "Connections accepted"},
+    [POLYCALL_METRIC_NET_DISCONNECTED] = {"polycall_net_disconnected_total", "Connections closed"},
+    [POLYCALL_METRIC_NET_BYTES_IN] = {"polycall_net_bytes_in_total", "Bytes received"},
+    [POLYCALL_METRIC_NET_BYTES_OUT] = {"polycall_net_bytes_out_total", "Bytes sent"},
+    [POLYCALL_METRIC_NET_SEND_ERRORS] = {"polycall_net_send_errors_total", "Sends that failed"},
+    [POLYCALL_METRIC_PROTOCOL_FRAMES_IN] = {"polycall_protocol_frames_in_total",
+                                            "Protocol frames dispatched"},
+    [POLYCALL_METRIC_PROTOCOL_FRAMES_OUT] = {"polycall_protocol_frames_out_total",
+                                             "Protocol frames sent"},
+    [POLYCALL_METRIC_PROTOCOL_CHECKSUM_FAILURES] = {"polycall_protocol_checksum_failures_total",
+                                                    "Frames rejected for a bad checksum"},
+    [POLYCALL_METRIC_PROTOCOL_BAD_FRAMES] = {"polycall_protocol_bad_frames_total",
+                                             "Frames rejected as malformed or oversized"},
+    [POLYCALL_METRIC_MICRO_ENQUEUED] = {"polycall_micro_enqueued_total",
+                                        "Commands put on service queues"},
+    [POLYCALL_METRIC_MICRO_DEQUEUED] = {"polycall_micro_dequeued_total",
+                                        "Commands taken off service queues"},
+    [POLYCALL_METRIC_MICRO_QUEUE_FULL] = {"polycall_micro_queue_full_total",
+                                          "Enqueues refused by a full queue"},
+    [POLYCALL_METRIC_CLIENT_REQUESTS] = {"polycall_client_requests_total",
+                                         "Requests sent by client pools"},
+    [POLYCALL_METRIC_CLIENT_FAILURES] = {"polycall_client_failures_total",
+                                         "Client requests completed with an error"},
+};
+
+static metric_info_t g_histograms[POLYCALL_METRICS_MAX_HISTOGRAMS] = {
+    [POLYCALL_METRIC_PROTOCOL_HANDSHAKE_NS] = {"polycall_protocol_handshake_seconds",
+                                               "Handshake sent to the peer's handshake received"},
+    [POLYCALL_METRIC_PROTOCOL_COMMAND_NS] = {"polycall_protocol_command_seconds",
+                                             "Time spent in command handlers"},
+    [POLYCALL_METRIC_CLIENT_REQUEST_NS] = {"polycall_client_request_seconds",
+                                           "Client request sent to response received"},
+};
+
+static int64_t read_queued(void* user_data);
+static int64_t read_log_dropped(void* user_data);
+
+static gauge_info_t g_gauges[POLYCALL_METRICS_MAX_GAUGES] = {
+    {"polycall_micro_queued", "Commands waiting on service queues", read_queued, NULL},
+    {"polycall_log_dropped", "Log messages dropped on a full queue", read_log_dropped, NULL},
+};
+
+// Registration appends under the lock; readers take the counts with acquire
+static pthread_mutex_t g_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic int g_counter_count = POLYCALL_METRIC_COUNTER_BUILTIN;
+static _Atomic int g_histogram_count = POLYCALL_METRIC_HISTOGRAM_BUILTIN;
+static size_t g_gauge_count = 2;
+
+static _Atomic(metrics_shard_t*) g_shards = NULL;
+static _Thread_local metrics_shard_t* tls_shard = NULL;
+static pthread_key_t g_shard_key;
+static pthread_once_t g_shard_key_once = PTHREAD_ONCE_INIT;
+
+static int64_t read_queued(void* user_data) {
+    (void)user_data;
+    return (int64_t)(polycall_metrics_counter_value(POLYCALL_METRIC_MICRO_ENQUEUED) -
+                     polycall_metrics_counter_value(POLYCALL_METRIC_MICRO_DEQUEUED));
+}
+
+static int64_t read_log_dropped(void* user_data) {
+    (void)user_data;
+    return (int64_t)polycall_log_dropped();
+}
+
+uint64_t polycall_metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Shards */
+
+// The thread's shard goes back up for adoption, counts and all
+static void release_shard(void* shard) {
+    atomic_store_explicit(&((metrics_shard_t*)shard)->in_use, false, memory_order_release);
+}
+
+static void create_shard_key(void) {
+    pthread_key_create(&g_shard_key, release_shard);
+}
+
+static metrics_shard_t* acquire_shard(void) {
+    pthread_once(&g_shard_key_once, create_shard_key);
+
+    metrics_shard_t* shard = NULL;
+    for (metrics_shard_t* s = atomic_load_explicit(&g_shards, memory_order_acquire); s; s = s->next) {
+        bool free_shard = false;
+        if (atomic_compare_exchange_strong_explicit(&s->in_use, &free_shard, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            shard = s;
+            break;
+        }
+    }
+    if (!shard) {
+        shard = calloc(1, sizeof(*shard));
+        if (!shard) return NULL;
+        atomic_init(&shard->in_use, true);
+        metrics_shard_t* head = atomic_load_explicit(&g_shards, memory_order_relaxed);
+        do {
+            shard->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&g_shards, &head, shard,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+    pthread_setspecific(g_shard_key, shard);
+    tls_shard = shard;
+    return shard;
+}
+
+static inline metrics_shard_t* thread_shard(void) {
+    metrics_shard_t* shard = tls_shard;
+    return shard ? shard : acquire_shard();
+}
+
+static inline void shard_add(_Atomic uint64_t* value, uint64_t amount) {
+    atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+void polycall_metrics_add(int counter, uint64_t amount) {
+    if (counter < 0 || counter >= POLYCALL_METRICS_MAX_COUNTERS) return;
+    metrics_shard_t* shard = thread_shard();
+    if (shard) shard_add(&shard->counters[counter], amount);
+}
+
+// Bucket i holds values up to 2^(FIRST_BUCKET_SHIFT + i) ns; the last
+// holds the rest
+static inline unsigned bucket_of(uint64_t value_ns) {
+    if (value_ns <= (1ULL << POLYCALL_METRICS_FIRST_BUCKET_SHIFT)) return 0;
+    unsigned bits = 64u - (unsigned)__builtin_clzll(value_ns - 1);
+    unsigned bucket = bits - POLYCALL_METRICS_FIRST_BUCKET_SHIFT;
+    return bucket < POLYCALL_METRICS_BUCKETS - 1 ? bucket : POLYCALL_METRICS_BUCKETS - 1;
+}
+
+void polycall_metrics_observe(int histogram, uint64_t value_ns) {
+    if (histogram < 0 || histogram >= POLYCALL_METRICS_MAX_HISTOGRAMS) return;
+    metrics_shard_t* shard = thread_shard();
+    if (!shard) return;
+    histogram_shard_t* h = &shard->histograms[histogram];
+    shard_add(&h->buckets[bucket_of(value_ns)], 1);
+    shard_add(&h->count, 1);
+    shard_add(&h->sum, value_ns);
+}
+
+/* Registry */
+
+static int register_metric(metric_info_t* table, _Atomic int* count, int max,
+                           const char* name, const char* help) {
+    if (!name) return -1;
+    pthread_mutex_lock(&g_registry_lock);
+    int n = atomic_load_explicit(count, memory_order_relaxed);
+    int id = -1;
+    for (int i = 0; i < n; i++) {
+        if (strcmp(table[i].name, name) == 0) id = i;
+    }
+    if (id < 0 && n < max) {
+        table[n].name = name;
+        table[n].help = help ? help : "";
+        id = n;
+        atomic_store_explicit(count, n + 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+    if (id < 0) POLYCALL_LOG_WARN("metrics", "No room to register %s", name);
+    return id;
+}
+
+int polycall_metrics_register_counter(const char* name, const char* help) {
+    return register_metric(g_counters, &g_counter_count, POLYCALL_METRICS_MAX_COUNTERS, name, help);
+}
+
+int polycall_metrics_register_histogram(const char* name, const char* help) {
+    return register_metric(g_histograms, &g_histogram_count, POLYCALL_METRICS_MAX_HISTOGRAMS,
+                           name, help);
+}
+
+bool polycall_metrics_register_gauge(const char* name, const char* help,
+                                     polycall_gauge_fn read, void* user_data) {
+    if (!name || !read) return false;
+    pthread_mutex_lock(&g_registry_lock);
+    size_t slot = g_gauge_count;
+    for (size_t i = 0; i < g_gauge_count; i++) {
+        if (strcmp(g_gauges[i].name, name) == 0) slot = i;
+    }
+    bool ok = slot < POLYCALL_METRICS_MAX_GAUGES;
+    if (ok) {
+        g_gauges[slot] = (gauge_info_t){name, help ? help : "", read, user_data};
+        if (slot == g_gauge_count) g_gauge_count++;
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+    return ok;
+}
+
+void polycall_metrics_unregister_gauge(const char* name) {
+    if (!name) return;
+    pthread_mutex_lock(&g_registry_lock);
+    for (size_t i = 0; i < g_gauge_count; i++) {
+        if (strcmp(g_gauges[i].name, name) == 0) {
+            g_gauges[i] = g_gauges[--g_gauge_count];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+}
+
+/* Scrape */
+
+uint64_t polycall_metrics_counter_value(int counter) {
+    if (counter < 0 || counter >= POLYCALL_METRICS_MAX_COUNTERS) return 0;
+    uint64_t total = 0;
+    for (metrics_shard_t* s = atomic_load_explicit(&g_shards, memory_order_acquire); s; s = s->next) {
+        total += atomic_load_explicit(&s->counters[counter], memory_order_relaxed);
+    }
+    return total;
+}
+
+// Merge every shard's copy of a histogram
+static void merge_histogram(int histogram, uint64_t* buckets, uint64_t* count, uint64_t* sum) {
+    memset(buckets, 0, POLYCALL_METRICS_BUCKETS * sizeof(uint64_t));
+    *count = 0;
+    *sum = 0;
+    for (metrics_shard_t* s = atomic_load_explicit(&g_shards, memory_order_acquire); s; s = s->next) {
+        histogram_shard_t* h = &s->histograms[histogram];
+        for (int i = 0; i < POLYCALL_METRICS_BUCKETS; i++) {
+            buckets[i] += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        }
+        *count += atomic_load_explicit(&h->count, memory_order_relaxed);
+        *sum += atomic_load_explicit(&h->sum, memory_order_relaxed);
+    }
+}
+
+uint64_t polycall_metrics_histogram_count(int histogram, uint64_t* sum_ns) {
+    if (histogram < 0 || histogram >= POLYCALL_METRICS_MAX_HISTOGRAMS) return 0;
+    uint64_t buckets[POLYCALL_METRICS_BUCKETS], count, sum;
+    merge_histogram(histogram, buckets, &count, &sum);
+    if (sum_ns) *sum_ns = sum;
+    return count;
+}
+
+void polycall_metrics_write(FILE* out) {
+    if (!out) return;
+
+    int counters = atomic_load_explicit(&g_counter_count, memory_order_acquire);
+    for (int i = 0; i < counters; i++) {
+        fprintf(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", g_counters[i].name,
+                g_counters[i].help, g_counters[i].name, g_counters[i].name,
+                (unsigned long long)polycall_metrics_counter_value(i));
+    }
+
+    // Buckets are cumulative, the bounds in seconds
+    int histograms = atomic_load_explicit(&g_histogram_count, memory_order_acquire);
+    for (int i = 0; i < histograms; i++) {
+        const char* name = g_histograms[i].name;
+        uint64_t buckets[POLYCALL_METRICS_BUCKETS], count, sum;
+        merge_histogram(i, buckets, &count, &sum);
+        fprintf(out, "# HELP %s %s\n# TYPE %s histogram\n", name, g_histograms[i].help, name);
+        uint64_t cumulative = 0;
+        for (int b = 0; b < POLYCALL_METRICS_BUCKETS - 1; b++) {
+            cumulative += buckets[b];
+            double bound = (double)(1ULL << (POLYCALL_METRICS_FIRST_BUCKET_SHIFT + b)) / 1e9;
+            fprintf(out, "%s_bucket{le=\"%.9g\"} %llu\n", name, bound,
+                    (unsigned long long)cumulative);
+        }
+        fprintf(out, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n", name,
+                (unsigned long long)count, name, (double)sum / 1e9, name,
+                (unsigned long long)count);
+    }
+
+    // Callbacks run under the lock so a gauge cannot be unregistered mid-read
+    pthread_mutex_lock(&g_registry_lock);
+    for (size_t i = 0; i < g_gauge_count; i++) {
+        fprintf(out, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n", g_gauges[i].name,
+                g_gauges[i].help, g_gauges[i].name, g_gauges[i].name,
+                (long long)g_gauges[i].read(g_gauges[i].user_data));
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+}
+
+/* HTTP endpoint */
+
+static pthread_mutex_t g_server_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t g_server_thread;
+static int g_server_fd = -1;
+static atomic_bool g_server_stop = false;
+
+static bool send_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+#else
+        ssize_t sent = send(fd, data, length, 0);
+#endif
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+// Whatever was asked for gets the exposition; the request is read up to
+// its blank line so the client does not see a reset. The server has one
+// thread, so a client gets a fixed budget for its whole request and each
+// send times out: a slow or stalled peer cannot hold the endpoint for
+// longer than that. A stop request cuts the read short.
+static void answer(int fd) {
+    struct timeval send_timeout = {
+        .tv_sec = METRICS_SEND_TIMEOUT_MS / 1000,
+        .tv_usec = (METRICS_SEND_TIMEOUT_MS % 1000) * 1000
+    };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+    char request[METRICS_REQUEST_MAX];
+    size_t have = 0;
+    uint64_t deadline = polycall_metrics_now_ns() + METRICS_REQUEST_DEADLINE_MS * 1000000ULL;
+    while (have < sizeof(request) - 1 && !atomic_load(&g_server_stop)) {
+        uint64_t now = polycall_metrics_now_ns();
+        if (now >= deadline) break;
+        int wait_ms = (int)((deadline - now + 999999) / 1000000);
+        if (wait_ms > METRICS_ACCEPT_POLL_MS) wait_ms = METRICS_ACCEPT_POLL_MS;
+        struct pollfd readable = { .fd = fd, .events = POLLIN };
+        int ready = poll(&readable, 1, wait_ms);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+        ssize_t got = recv(fd, request + have, sizeof(request) - 1 - have, 0);
+        if (got <= 0) break;
+        have += (size_t)got;
+        request[have] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) break;
+    }
+
+    char* body = NULL;
+    size_t body_length = 0;
+    FILE* out = open_memstream(&body, &body_length);
+    if (!out) return;
+    polycall_metrics_write(out);
+    fclose(out);
+
+    char header[160];
+    int header_length = snprintf(header, sizeof(header),
+        "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: %zu\r\nConnection: close\r\n\r\n", body_length);
+    if (send_all(fd, header, (size_t)header_length)) send_all(fd, body, body_length);
+    free(body);
+}
+
+static void* serve_main(void* arg) {
+    int listen_fd = (int)(intptr_t)arg;
+    while (!atomic_load(&g_server_stop)) {
+        struct pollfd readable = { .fd = listen_fd, .events = POLLIN };
+        if (poll(&readable, 1, METRICS_ACCEPT_POLL_MS) <= 0) continue;
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        answer(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+uint16_t polycall_metrics_serve(const char* address, uint16_t port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (address && inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+        POLYCALL_LOG_ERROR("metrics", "Invalid metrics address %s", address);
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_server_lock);
+    if (g_server_fd >= 0) {
+        pthread_mutex_unlock(&g_server_lock);
+        POLYCALL_LOG_WARN("metrics", "Metrics endpoint already running");
+        return 0;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    socklen_t length = sizeof(addr);
+    int on = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 ||
+        bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &length) < 0) {
+        POLYCALL_LOG_ERROR("metrics", "Cannot listen on port %u: %s", port, strerror(errno));
+        if (fd >= 0) close(fd);
+        pthread_mutex_unlock(&g_server_lock);
+        return 0;
+    }
+
+    atomic_store(&g_server_stop, false);
+    if (pthread_create(&g_server_thread, NULL, serve_main, (void*)(intptr_t)fd) != 0) {
+        close(fd);
+        pthread_mutex_unlock(&g_server_lock);
+        return 0;
+    }
+    g_server_fd = fd;
+    pthread_mutex_unlock(&g_server_lock);
+
+    uint16_t bound = ntohs(addr.sin_port);
+    char shown[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, shown, sizeof(shown));
+    POLYCALL_LOG_INFO("metrics", "Serving metrics on %s:%u", shown, bound);
+    return bound;
+}
+
+void polycall_metrics_stop_serving(void) {
+    pthread_mutex_lock(&g_server_lock);
+    if (g_server_fd >= 0) {
+        atomic_store(&g_server_stop, true);
+        pthread_join(g_server_thread, NULL);
+        close(g_server_fd);
+        g_server_fd = -1;
+    }
+    pthread_mutex_unlock(&g_server_lock);
+}
\ No newline at end of file
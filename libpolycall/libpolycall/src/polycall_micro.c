@@ -1,25 +1,242 @@
 #include "polycall_micro.h"
+#include "polycall_checksum.h"
+#include "polycall_metrics.h"
+#include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <time.h>
 
-// Internal helper functions for data-oriented operations
-static void reset_command_array(PolycallCommandArray* array) {
-    if (!array) return;
-    memset(array->commands, 0, sizeof(PolycallCommand) * POLYCALL_MICRO_MAX_COMMANDS);
-    array->count = 0;
-    array->capacity = POLYCALL_MICRO_MAX_COMMANDS;
+// Payload slab: power-of-two slot classes from 64 bytes up to
+// POLYCALL_MICRO_BUFFER_SIZE, each with its own free list, carved out of
+// shared chunks. A small command costs a small slot. A service arena is
+// the same slab with a backend space charged for every chunk.
+#define SLAB_MIN_SHIFT 6
+#define SLAB_CLASSES 7                  // 64 .. 4096
+
+typedef struct SlabFree {
+    struct SlabFree* next;
+} SlabFree;
+
+typedef struct SlabChunk {
+    struct SlabChunk* next;
+    size_t used;
+    _Alignas(max_align_t) uint8_t memory[POLYCALL_MICRO_SLAB_CHUNK];
+} SlabChunk;
+
+struct PolycallPayloadSlab {
+    SlabFree* free[SLAB_CLASSES];
+    SlabChunk* chunks;
+    const PolycallMemoryBackend* backend;   // NULL for the shared slab
+    void* space;
+    size_t charged;
+    bool over_limit;                    // The last chunk was refused
+};
+
+static int slab_class(uint32_t size) {
+    int index = 0;
+    while (index < SLAB_CLASSES - 1 && ((size_t)1 << (SLAB_MIN_SHIFT + index)) < size) index++;
+    return index;
+}
+
+static uint8_t* slab_alloc(PolycallPayloadSlab* slab, uint32_t size) {
+    int index = slab_class(size);
+    if (slab->free[index]) {
+        SlabFree* slot = slab->free[index];
+        slab->free[index] = slot->next;
+        return (uint8_t*)slot;
+    }
+
+    size_t slot_size = (size_t)1 << (SLAB_MIN_SHIFT + index);
+    SlabChunk* chunk = slab->chunks;
+    if (!chunk || chunk->used + slot_size > POLYCALL_MICRO_SLAB_CHUNK) {
+        if (slab->backend) {
+            slab->over_limit = !slab->backend->charge(slab->space, sizeof(SlabChunk));
+            if (slab->over_limit) return NULL;
+        }
+        chunk = malloc(sizeof(SlabChunk));
+        if (!chunk) {
+            if (slab->backend) slab->backend->uncharge(slab->space, sizeof(SlabChunk));
+            return NULL;
+        }
+        slab->charged += slab->backend ? sizeof(SlabChunk) : 0;
+        chunk->used = 0;
+        chunk->next = slab->chunks;
+        slab->chunks = chunk;
+    }
+    // Every class is a multiple of 64 bytes, so slots stay 64-byte aligned
+    uint8_t* slot = chunk->memory + chunk->used;
+    chunk->used += slot_size;
+    return slot;
 }
 
-static void reset_service_state(PolycallServiceState* state) {
-    if (!state) return;
-    memset(state, 0, sizeof(PolycallServiceState));
-    reset_command_array(&state->command_queue);
+static void slab_free(PolycallPayloadSlab* slab, uint8_t* payload, uint32_t size) {
+    if (!payload) return;
+    int index = slab_class(size);
+    SlabFree* slot = (SlabFree*)payload;
+    slot->next = slab->free[index];
+    slab->free[index] = slot;
+}
+
+static void slab_destroy(PolycallPayloadSlab* slab) {
+    if (!slab) return;
+    while (slab->chunks) {
+        SlabChunk* next = slab->chunks->next;
+        free(slab->chunks);
+        if (slab->backend) slab->backend->uncharge(slab->space, sizeof(SlabChunk));
+        slab->chunks = next;
+    }
+    if (slab->backend) slab->backend->space_destroy(slab->space);
+    free(slab);
+}
+
+static PolycallPayloadSlab* arena_create(const PolycallMemoryBackend* backend,
+                                         uint32_t service_id, size_t limit) {
+    PolycallPayloadSlab* arena = calloc(1, sizeof(PolycallPayloadSlab));
+    if (!arena) return NULL;
+    arena->space = backend->space_create(service_id, limit, backend->user_data);
+    if (!arena->space) {
+        free(arena);
+        return NULL;
+    }
+    arena->backend = backend;
+    return arena;
+}
+
+// Bounded MPMC ring after Vyukov: a cell's sequence equals the ticket a
+// producer may fill it for, or that ticket plus one once it holds a
+// command. Both ends claim tickets by CAS, consumers several at a time.
+typedef struct {
+    _Atomic size_t sequence;
+    PolycallCommand command;
+    NetworkBuffer* buffer;
+} RingCell;
+
+struct PolycallCommandRing {
+    _Alignas(64) _Atomic size_t enqueue_pos;
+    _Alignas(64) _Atomic size_t dequeue_pos;
+    _Alignas(64) size_t mask;
+    uint32_t service_id;
+    NetworkBufferPool* pool;
+    PolycallBackpressureHandler on_backpressure;
+    void* user_data;
+    atomic_bool full;                   // Backpressure reported and not yet cleared
+    RingCell cells[];
+};
+
+static PolycallCommandRing* ring_create(uint32_t service_id, uint32_t capacity,
+                                        NetworkBufferPool* pool) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    PolycallCommandRing* ring = aligned_alloc(64, (sizeof(PolycallCommandRing) +
+                                                   size * sizeof(RingCell) + 63) / 64 * 64);
+    if (!ring) return NULL;
+    memset(ring, 0, sizeof(PolycallCommandRing));
+    atomic_init(&ring->enqueue_pos, 0);
+    atomic_init(&ring->dequeue_pos, 0);
+    atomic_init(&ring->full, false);
+    ring->mask = size - 1;
+    ring->service_id = service_id;
+    ring->pool = pool;
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring->cells[i].sequence, i);
+    }
+    return ring;
+}
+
+static void ring_destroy(PolycallCommandRing* ring) {
+    if (!ring) return;
+    ring->on_backpressure = NULL;
+    PolycallQueuedCommand left[32];
+    PolycallServiceState holder = { .ring = ring };
+    uint32_t count;
+    while ((count = polycall_micro_dequeue_batch(&holder, left, 32)) > 0) {
+        for (uint32_t i = 0; i < count; i++) net_buffer_release(left[i].buffer);
+    }
+    free(ring);
 }
 
 static uint64_t get_current_timestamp(void) {
     return (uint64_t)time(NULL);
 }
 
+_Static_assert((POLYCALL_MICRO_MAX_SERVICES & (POLYCALL_MICRO_MAX_SERVICES - 1)) == 0 &&
+               POLYCALL_MICRO_MAX_SERVICES <= 32768,
+               "POLYCALL_MICRO_MAX_SERVICES must be a power of two that fits a handle");
+
+_Static_assert(POLYCALL_MICRO_MAX_COMMANDS * sizeof(PolycallCommand) <= POLYCALL_MICRO_BUFFER_SIZE,
+               "A service arena keeps its whole command queue in one slab slot");
+
+#define ID_BUCKET_MASK (POLYCALL_MICRO_ID_BUCKETS - 1)
+
+static inline uint32_t id_bucket(uint32_t service_id) {
+    return (service_id * 0x9E3779B1u) >> 16 & ID_BUCKET_MASK;
+}
+
+static inline bool slot_active(const PolycallServiceArray* array, uint32_t slot) {
+    return (array->active[slot / 64] >> (slot % 64)) & 1;
+}
+
+// Visit every occupied slot, lowest first; body may free the current slot
+#define FOR_EACH_SERVICE(array, slot)                                    \
+    for (uint32_t word_ = 0; word_ < POLYCALL_MICRO_SERVICE_WORDS; word_++)  \
+        for (uint64_t bits_ = (array)->active[word_], slot;              \
+             bits_ && (slot = word_ * 64 + (uint32_t)__builtin_ctzll(bits_), 1); \
+             bits_ &= bits_ - 1)
+
+// Slot holding service_id, or -1. The index stays at most half full, so
+// probes are short and always end at an empty bucket.
+static int find_service(const PolycallMicroContext* ctx, uint32_t service_id) {
+    const PolycallServiceArray* array = &ctx->service_array;
+    for (uint32_t bucket = id_bucket(service_id); ; bucket = (bucket + 1) & ID_BUCKET_MASK) {
+        uint16_t entry = array->id_index[bucket];
+        if (entry == 0) return -1;
+        if (array->ids[entry - 1] == service_id) return entry - 1;
+    }
+}
+
+static void index_insert(PolycallServiceArray* array, uint32_t service_id, uint32_t slot) {
+    uint32_t bucket = id_bucket(service_id);
+    while (array->id_index[bucket] != 0) bucket = (bucket + 1) & ID_BUCKET_MASK;
+    array->id_index[bucket] = (uint16_t)(slot + 1);
+}
+
+// Backward-shift delete, so no tombstones build up
+static void index_remove(PolycallServiceArray* array, uint32_t service_id) {
+    uint32_t hole = id_bucket(service_id);
+    while (array->ids[array->id_index[hole] - 1] != service_id) hole = (hole + 1) & ID_BUCKET_MASK;
+
+    for (uint32_t next = (hole + 1) & ID_BUCKET_MASK; array->id_index[next] != 0;
+         next = (next + 1) & ID_BUCKET_MASK) {
+        uint32_t home = id_bucket(array->ids[array->id_index[next] - 1]);
+        // Move the entry back unless its home lies in (hole, next]
+        if (((next - home) & ID_BUCKET_MASK) >= ((next - hole) & ID_BUCKET_MASK)) {
+            array->id_index[hole] = array->id_index[next];
+            hole = next;
+        }
+    }
+    array->id_index[hole] = 0;
+}
+
+// Where a service's payloads and queue live
+static PolycallPayloadSlab* service_slab(const PolycallMicroContext* ctx,
+                                         const PolycallServiceState* service) {
+    return service->arena ? service->arena : ctx->payloads;
+}
+
+static PolycallMicroStatus slab_failure(const PolycallPayloadSlab* slab) {
+    return slab->over_limit ? POLYCALL_MICRO_ERROR_LIMIT : POLYCALL_MICRO_ERROR_MEMORY;
+}
+
+static void release_queue(PolycallPayloadSlab* slab, PolycallCommandArray* queue) {
+    for (uint32_t i = 0; i < queue->count; i++) {
+        slab_free(slab, queue->commands[i].payload, queue->commands[i].payload_size);
+    }
+    queue->count = 0;
+}
+
+static void destroy_slot(PolycallMicroContext* ctx, uint32_t slot);
+
 // Initialize the micro service context
 PolycallMicroStatus polycall_micro_init(
     PolycallMicroContext* ctx,
@@ -30,12 +247,27 @@ PolycallMicroStatus polycall_micro_init(
     // Initialize service array with contiguous memory layout
     memset(&ctx->service_array, 0, sizeof(PolycallServiceArray));
     ctx->service_array.count = 0;
-    ctx->service_array.active_mask = 0;
     ctx->service_array.last_gc = get_current_timestamp();
+    ctx->memory_backend = NULL;
+    ctx->service_memory_limit = 0;
+
+    // Chunks are only carved once commands arrive
+    ctx->payloads = calloc(1, sizeof(PolycallPayloadSlab));
+    if (!ctx->payloads) return POLYCALL_MICRO_ERROR_MEMORY;
+    ctx->ring_buffers = net_buffer_pool_create(POLYCALL_MICRO_BUFFER_SIZE);
+    if (!ctx->ring_buffers) {
+        slab_destroy(ctx->payloads);
+        ctx->payloads = NULL;
+        return POLYCALL_MICRO_ERROR_MEMORY;
+    }
     
     // Initialize state machine
     if (polycall_sm_create_with_integrity(config->user_data, &ctx->state_machine, NULL) 
         != POLYCALL_SM_SUCCESS) {
+        net_buffer_pool_destroy(ctx->ring_buffers);
+        slab_destroy(ctx->payloads);
+        ctx->payloads = NULL;
+        ctx->ring_buffers = NULL;
         return POLYCALL_MICRO_ERROR_INIT;
     }
     
@@ -53,6 +285,10 @@ PolycallMicroStatus polycall_micro_init(
     
     if (!polycall_protocol_init(&ctx->protocol_ctx, config->user_data, &endpoint, &proto_config)) {
         polycall_sm_destroy(ctx->state_machine);
+        net_buffer_pool_destroy(ctx->ring_buffers);
+        slab_destroy(ctx->payloads);
+        ctx->payloads = NULL;
+        ctx->ring_buffers = NULL;
         return POLYCALL_MICRO_ERROR_PROTOCOL;
     }
     
@@ -67,15 +303,15 @@ void polycall_micro_cleanup(PolycallMicroContext* ctx) {
     if (!ctx) return;
     
     // Cleanup all services
-    for (uint32_t i = 0; i < ctx->service_array.count; i++) {
-        if (ctx->service_array.active_mask & (1U << i)) {
-            polycall_micro_destroy_service(ctx, ctx->service_array.services[i].id);
-        }
+    FOR_EACH_SERVICE(&ctx->service_array, slot) {
+        destroy_slot(ctx, (uint32_t)slot);
     }
     
     // Cleanup protocol and state machine
     polycall_protocol_cleanup(&ctx->protocol_ctx);
     polycall_sm_destroy(ctx->state_machine);
+    slab_destroy(ctx->payloads);
+    net_buffer_pool_destroy(ctx->ring_buffers);
     
     memset(ctx, 0, sizeof(PolycallMicroContext));
 }
@@ -86,30 +322,47 @@ PolycallMicroStatus polycall_micro_create_service(
     uint32_t service_id,
     uint32_t flags
 ) {
-    if (!ctx || ctx->service_array.count >= POLYCALL_MICRO_MAX_SERVICES) {
+    if (!ctx || ctx->service_array.count >= POLYCALL_MICRO_MAX_SERVICES ||
+        find_service(ctx, service_id) >= 0) {
         return POLYCALL_MICRO_ERROR_SERVICE;
     }
     
     // Find available slot using bit manipulation
-    uint32_t slot = 0;
-    uint32_t mask = ctx->service_array.active_mask;
-    while (mask & (1U << slot)) slot++;
+    PolycallServiceArray* array = &ctx->service_array;
+    uint32_t slot = POLYCALL_MICRO_MAX_SERVICES;
+    for (uint32_t word = 0; word < POLYCALL_MICRO_SERVICE_WORDS; word++) {
+        if (~array->active[word]) {
+            slot = word * 64 + (uint32_t)__builtin_ctzll(~array->active[word]);
+            break;
+        }
+    }
     
     if (slot >= POLYCALL_MICRO_MAX_SERVICES) {
         return POLYCALL_MICRO_ERROR_SERVICE;
     }
     
-    // Initialize service state in contiguous memory
-    PolycallServiceState* service = &ctx->service_array.services[slot];
-    reset_service_state(service);
-    
+    PolycallServiceState* service = calloc(1, sizeof(PolycallServiceState));
+    if (!service) return POLYCALL_MICRO_ERROR_MEMORY;
     service->id = service_id;
-    service->flags = flags;
-    service->last_update = get_current_timestamp();
+    if (ctx->memory_backend) {
+        service->arena = arena_create(ctx->memory_backend, service_id, ctx->service_memory_limit);
+        if (!service->arena) {
+            free(service);
+            return POLYCALL_MICRO_ERROR_MEMORY;
+        }
+    }
+    
+    array->ids[slot] = service_id;
+    array->flags[slot] = flags;
+    array->states[slot] = 0;
+    array->last_update[slot] = get_current_timestamp();
+    array->services[slot] = service;
+    if (array->generations[slot] == 0) array->generations[slot] = 1;
+    index_insert(array, service_id, slot);
     
     // Update active mask and count
-    ctx->service_array.active_mask |= (1U << slot);
-    ctx->service_array.count++;
+    array->active[slot / 64] |= 1ULL << (slot % 64);
+    array->count++;
     
     return POLYCALL_MICRO_SUCCESS;
 }
@@ -121,23 +374,92 @@ PolycallMicroStatus polycall_micro_destroy_service(
 ) {
     if (!ctx) return POLYCALL_MICRO_ERROR_SERVICE;
     
-    // Find service using contiguous memory layout
-    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_SERVICES; i++) {
-        if ((ctx->service_array.active_mask & (1U << i)) && 
-            ctx->service_array.services[i].id == service_id) {
-            
-            // Clear service state
-            reset_service_state(&ctx->service_array.services[i]);
-            
-            // Update active mask and count
-            ctx->service_array.active_mask &= ~(1U << i);
-            ctx->service_array.count--;
-            
-            return POLYCALL_MICRO_SUCCESS;
-        }
+    int slot = find_service(ctx, service_id);
+    if (slot < 0) return POLYCALL_MICRO_ERROR_SERVICE;
+    
+    destroy_slot(ctx, (uint32_t)slot);
+    return POLYCALL_MICRO_SUCCESS;
+}
+
+static void destroy_slot(PolycallMicroContext* ctx, uint32_t slot) {
+    // Give back queued payloads, then the cold data. An arena holds the
+    // queue and its payloads, so it goes in one teardown.
+    PolycallServiceArray* array = &ctx->service_array;
+    PolycallServiceState* service = array->services[slot];
+    if (service->arena) {
+        slab_destroy(service->arena);
+    } else {
+        release_queue(ctx->payloads, &service->command_queue);
+        free(service->command_queue.commands);
     }
+    ring_destroy(service->ring);
+    free(service->endpoints);
+    free(service);
+    array->services[slot] = NULL;
+    index_remove(array, array->ids[slot]);
     
-    return POLYCALL_MICRO_ERROR_SERVICE;
+    // Outstanding handles stop resolving; 0 is skipped so handles are never 0
+    if (++array->generations[slot] == 0) array->generations[slot] = 1;
+    
+    // Update active mask and count
+    array->active[slot / 64] &= ~(1ULL << (slot % 64));
+    array->count--;
+}
+
+PolycallServiceHandle polycall_micro_service_handle(
+    const PolycallMicroContext* ctx,
+    uint32_t service_id
+) {
+    if (!ctx) return 0;
+    int slot = find_service(ctx, service_id);
+    if (slot < 0) return 0;
+    return (PolycallServiceHandle)ctx->service_array.generations[slot] << 16 | (uint32_t)slot;
+}
+
+PolycallServiceState* polycall_micro_resolve(
+    PolycallMicroContext* ctx,
+    PolycallServiceHandle handle
+) {
+    if (!ctx) return NULL;
+    uint32_t slot = handle & 0xFFFF;
+    if (slot >= POLYCALL_MICRO_MAX_SERVICES || !slot_active(&ctx->service_array, slot) ||
+        ctx->service_array.generations[slot] != handle >> 16) {
+        return NULL;
+    }
+    return ctx->service_array.services[slot];
+}
+
+PolycallServiceState* polycall_micro_get_service(
+    PolycallMicroContext* ctx,
+    uint32_t service_id
+) {
+    if (!ctx) return NULL;
+    int slot = find_service(ctx, service_id);
+    return slot < 0 ? NULL : ctx->service_array.services[slot];
+}
+
+PolycallMicroStatus polycall_micro_add_endpoint(
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
+    const NetworkEndpoint* endpoint
+) {
+    if (!ctx || !endpoint) return POLYCALL_MICRO_ERROR_SERVICE;
+
+    PolycallServiceState* service = polycall_micro_get_service(ctx, service_id);
+    if (!service || service->endpoint_count >= POLYCALL_MICRO_MAX_ENDPOINTS) {
+        return POLYCALL_MICRO_ERROR_SERVICE;
+    }
+
+    if (service->endpoint_count == service->endpoint_capacity) {
+        uint32_t capacity = service->endpoint_capacity ? service->endpoint_capacity * 2 : 2;
+        if (capacity > POLYCALL_MICRO_MAX_ENDPOINTS) capacity = POLYCALL_MICRO_MAX_ENDPOINTS;
+        NetworkEndpoint* grown = realloc(service->endpoints, capacity * sizeof(NetworkEndpoint));
+        if (!grown) return POLYCALL_MICRO_ERROR_MEMORY;
+        service->endpoints = grown;
+        service->endpoint_capacity = capacity;
+    }
+    service->endpoints[service->endpoint_count++] = *endpoint;
+    return POLYCALL_MICRO_SUCCESS;
 }
 
 // Transform command using point-free style
@@ -159,6 +481,125 @@ PolycallMicroStatus polycall_micro_transform_command(
     return POLYCALL_MICRO_SUCCESS;
 }
 
+static void stage_bswap32(PolycallCommand* commands, uint32_t count) {
+    for (uint32_t c = 0; c < count; c++) {
+        uint8_t* payload = commands[c].payload;
+        uint32_t words = commands[c].payload_size / 4;
+        for (uint32_t i = 0; i < words; i++) {
+            uint32_t word;
+            memcpy(&word, payload + i * 4, 4);
+            word = __builtin_bswap32(word);
+            memcpy(payload + i * 4, &word, 4);
+        }
+    }
+}
+
+static void stage_xor(PolycallCommand* commands, uint32_t count, uint32_t key) {
+    uint64_t wide = (uint64_t)key << 32 | key;
+    for (uint32_t c = 0; c < count; c++) {
+        uint8_t* payload = commands[c].payload;
+        uint32_t size = commands[c].payload_size;
+        uint32_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t chunk;
+            memcpy(&chunk, payload + i, 8);
+            chunk ^= wide;
+            memcpy(payload + i, &chunk, 8);
+        }
+        // The key keeps its byte order across the tail
+        const uint8_t* key_bytes = (const uint8_t*)&wide;
+        for (; i < size; i++) payload[i] ^= key_bytes[i % 8];
+    }
+}
+
+static void stage_checksum(PolycallCommand* commands, uint32_t count) {
+    for (uint32_t c = 0; c < count; c++) {
+        commands[c].checksum = polycall_crc32c(0, commands[c].payload, commands[c].payload_size);
+    }
+}
+
+static uint32_t stage_filter(PolycallCommand* commands, uint32_t count, uint32_t mask, uint32_t value) {
+    uint32_t kept = 0;
+    for (uint32_t c = 0; c < count; c++) {
+        commands[kept] = commands[c];
+        kept += (commands[c].flags & mask) == value;
+    }
+    return kept;
+}
+
+PolycallMicroStatus polycall_micro_transform_batch(
+    PolycallCommandArray* commands,
+    const PolycallStageChain* chain
+) {
+    if (!commands || !chain || (chain->stage_count > 0 && !chain->stages)) {
+        return POLYCALL_MICRO_ERROR_COMMAND;
+    }
+
+    uint32_t write_idx = 0;
+    for (uint32_t start = 0; start < commands->count; start += POLYCALL_MICRO_TRANSFORM_BLOCK) {
+        uint32_t remaining = commands->count - start;
+        uint32_t count = remaining < POLYCALL_MICRO_TRANSFORM_BLOCK ? remaining : POLYCALL_MICRO_TRANSFORM_BLOCK;
+        PolycallCommand* block = &commands->commands[start];
+
+        for (uint32_t s = 0; s < chain->stage_count && count > 0; s++) {
+            const PolycallTransformStage* stage = &chain->stages[s];
+            switch (stage->kind) {
+                case POLYCALL_STAGE_CALL:
+                    if (!stage->call) return POLYCALL_MICRO_ERROR_COMMAND;
+                    for (uint32_t c = 0; c < count; c++) stage->call(&block[c]);
+                    break;
+                case POLYCALL_STAGE_BATCH:
+                    if (!stage->batch.fn) return POLYCALL_MICRO_ERROR_COMMAND;
+                    stage->batch.fn(block, count, stage->batch.arg);
+                    break;
+                case POLYCALL_STAGE_BSWAP32:
+                    stage_bswap32(block, count);
+                    break;
+                case POLYCALL_STAGE_XOR:
+                    stage_xor(block, count, stage->key);
+                    break;
+                case POLYCALL_STAGE_CHECKSUM:
+                    stage_checksum(block, count);
+                    break;
+                case POLYCALL_STAGE_FILTER_FLAGS:
+                    count = stage_filter(block, count, stage->filter.mask, stage->filter.value);
+                    break;
+                default:
+                    return POLYCALL_MICRO_ERROR_COMMAND;
+            }
+        }
+
+        // Blocks shrunk by filters close up behind the ones before them
+        if (write_idx != start && count > 0) {
+            memmove(&commands->commands[write_idx], block, count * sizeof(PolycallCommand));
+        }
+        write_idx += count;
+    }
+
+    commands->count = write_idx;
+    return POLYCALL_MICRO_SUCCESS;
+}
+
+PolycallMicroStatus polycall_micro_transform_commands(
+    PolycallCommandArray* commands,
+    const PolycallTransformChain* chain
+) {
+    if (!commands || !chain || !chain->transforms) {
+        return POLYCALL_MICRO_ERROR_COMMAND;
+    }
+
+    for (uint32_t start = 0; start < commands->count; start += POLYCALL_MICRO_TRANSFORM_BLOCK) {
+        uint32_t remaining = commands->count - start;
+        uint32_t count = remaining < POLYCALL_MICRO_TRANSFORM_BLOCK ? remaining : POLYCALL_MICRO_TRANSFORM_BLOCK;
+        for (uint32_t i = 0; i < chain->transform_count; i++) {
+            PolycallTransform transform = chain->transforms[i];
+            if (!transform) continue;
+            for (uint32_t c = 0; c < count; c++) transform(&commands->commands[start + c]);
+        }
+    }
+    return POLYCALL_MICRO_SUCCESS;
+}
+
 // Filter commands using predicate
 PolycallMicroStatus polycall_micro_filter_commands(
     PolycallCommandArray* commands,
@@ -174,9 +615,7 @@ PolycallMicroStatus polycall_micro_filter_commands(
     for (uint32_t read_idx = 0; read_idx < commands->count; read_idx++) {
         if (predicate(&commands->commands[read_idx])) {
             if (write_idx != read_idx) {
-                memcpy(&commands->commands[write_idx], 
-                       &commands->commands[read_idx],
-                       sizeof(PolycallCommand));
+                commands->commands[write_idx] = commands->commands[read_idx];
             }
             write_idx++;
         }
@@ -188,16 +627,20 @@ PolycallMicroStatus polycall_micro_filter_commands(
 
 // Process commands using operation
 PolycallMicroStatus polycall_micro_process_commands(
-    PolycallServiceState* service,
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
     PolycallOperation operation
 ) {
-    if (!service || !operation) {
+    if (!ctx || !operation) {
         return POLYCALL_MICRO_ERROR_COMMAND;
     }
     
+    int slot = find_service(ctx, service_id);
+    if (slot < 0) return POLYCALL_MICRO_ERROR_SERVICE;
+    
     // Apply operation to service state
-    operation(service);
-    service->last_update = get_current_timestamp();
+    operation(ctx->service_array.services[slot]);
+    ctx->service_array.last_update[slot] = get_current_timestamp();
     
     return POLYCALL_MICRO_SUCCESS;
 }
@@ -212,41 +655,223 @@ PolycallMicroStatus polycall_micro_batch_process(
         return POLYCALL_MICRO_ERROR_COMMAND;
     }
     
-    // Find service using contiguous memory layout
-    PolycallServiceState* service = NULL;
-    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_SERVICES; i++) {
-        if ((ctx->service_array.active_mask & (1U << i)) && 
-            ctx->service_array.services[i].id == service_id) {
-            service = &ctx->service_array.services[i];
-            break;
-        }
-    }
-    
-    if (!service) {
+    int slot = find_service(ctx, service_id);
+    if (slot < 0) {
         return POLYCALL_MICRO_ERROR_SERVICE;
     }
+    PolycallServiceState* service = ctx->service_array.services[slot];
+    PolycallCommandArray* queue = &service->command_queue;
+    PolycallPayloadSlab* slab = service_slab(ctx, service);
     
     // Process commands in batches
     for (uint32_t i = 0; i < commands->count; i++) {
         const PolycallCommand* cmd = &commands->commands[i];
         
         // Validate command
-        if (cmd->payload_size > POLYCALL_MICRO_BUFFER_SIZE) {
+        if (cmd->payload_size > POLYCALL_MICRO_BUFFER_SIZE ||
+            (cmd->payload_size > 0 && !cmd->payload)) {
             continue;
         }
         
-        // Add to service command queue
-        if (service->command_queue.count < service->command_queue.capacity) {
-            memcpy(&service->command_queue.commands[service->command_queue.count],
-                   cmd, sizeof(PolycallCommand));
-            service->command_queue.count++;
+        // Add to service command queue, growing it up to the limit. An
+        // arena takes the whole queue in one slot the first time.
+        if (queue->count == queue->capacity) {
+            if (queue->capacity >= POLYCALL_MICRO_MAX_COMMANDS) break;
+            if (service->arena) {
+                queue->commands = (PolycallCommand*)slab_alloc(
+                    slab, (uint32_t)(POLYCALL_MICRO_MAX_COMMANDS * sizeof(PolycallCommand)));
+                if (!queue->commands) return slab_failure(slab);
+                queue->capacity = POLYCALL_MICRO_MAX_COMMANDS;
+            } else {
+                uint32_t capacity = queue->capacity ? queue->capacity * 2 : 8;
+                if (capacity > POLYCALL_MICRO_MAX_COMMANDS) capacity = POLYCALL_MICRO_MAX_COMMANDS;
+                PolycallCommand* grown = realloc(queue->commands, capacity * sizeof(PolycallCommand));
+                if (!grown) return POLYCALL_MICRO_ERROR_MEMORY;
+                queue->commands = grown;
+                queue->capacity = capacity;
+            }
+        }
+        
+        uint8_t* payload = NULL;
+        if (cmd->payload_size > 0) {
+            payload = slab_alloc(slab, cmd->payload_size);
+            if (!payload) return slab_failure(slab);
+            memcpy(payload, cmd->payload, cmd->payload_size);
         }
+        PolycallCommand* queued = &queue->commands[queue->count++];
+        *queued = *cmd;
+        queued->payload = payload;
     }
     
-    service->last_update = get_current_timestamp();
+    ctx->service_array.last_update[slot] = get_current_timestamp();
     return POLYCALL_MICRO_SUCCESS;
 }
 
+PolycallMicroStatus polycall_micro_clear_commands(
+    PolycallMicroContext* ctx,
+    uint32_t service_id
+) {
+    if (!ctx) return POLYCALL_MICRO_ERROR_COMMAND;
+
+    PolycallServiceState* service = polycall_micro_get_service(ctx, service_id);
+    if (!service) return POLYCALL_MICRO_ERROR_SERVICE;
+
+    release_queue(service_slab(ctx, service), &service->command_queue);
+    return POLYCALL_MICRO_SUCCESS;
+}
+
+void polycall_micro_set_memory_backend(
+    PolycallMicroContext* ctx,
+    const PolycallMemoryBackend* backend,
+    size_t limit
+) {
+    if (!ctx) return;
+    ctx->memory_backend = backend;
+    ctx->service_memory_limit = limit;
+}
+
+size_t polycall_micro_service_memory(const PolycallServiceState* service) {
+    return service && service->arena ? service->arena->charged : 0;
+}
+
+PolycallMicroStatus polycall_micro_open_queue(
+    PolycallMicroContext* ctx,
+    uint32_t service_id,
+    uint32_t capacity
+) {
+    if (!ctx) return POLYCALL_MICRO_ERROR_SERVICE;
+
+    PolycallServiceState* service = polycall_micro_get_service(ctx, service_id);
+    if (!service) return POLYCALL_MICRO_ERROR_SERVICE;
+    if (service->ring) return POLYCALL_MICRO_SUCCESS;
+
+    service->ring = ring_create(service_id, capacity ? capacity : POLYCALL_MICRO_QUEUE_SIZE,
+                                ctx->ring_buffers);
+    return service->ring ? POLYCALL_MICRO_SUCCESS : POLYCALL_MICRO_ERROR_MEMORY;
+}
+
+void polycall_micro_set_backpressure(
+    PolycallServiceState* service,
+    PolycallBackpressureHandler handler,
+    void* user_data
+) {
+    if (!service || !service->ring) return;
+    service->ring->on_backpressure = handler;
+    service->ring->user_data = user_data;
+}
+
+PolycallMicroStatus polycall_micro_enqueue(
+    PolycallServiceState* service,
+    const PolycallCommand* cmd,
+    NetworkBuffer* buffer
+) {
+    if (!service || !service->ring || !cmd) return POLYCALL_MICRO_ERROR_SERVICE;
+    if (cmd->payload_size > POLYCALL_MICRO_BUFFER_SIZE ||
+        (cmd->payload_size > 0 && !cmd->payload)) {
+        return POLYCALL_MICRO_ERROR_COMMAND;
+    }
+
+    // Copy before claiming a ticket, so a claimed cell is always published
+    PolycallCommandRing* ring = service->ring;
+    PolycallCommand queued = *cmd;
+    if (buffer) {
+        net_buffer_retain(buffer);
+    } else {
+        buffer = net_buffer_alloc(ring->pool, cmd->payload_size);
+        if (!buffer) return POLYCALL_MICRO_ERROR_MEMORY;
+        memcpy(buffer->data, cmd->payload, cmd->payload_size);
+        buffer->length = cmd->payload_size;
+        queued.payload = buffer->data;
+    }
+
+    size_t pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    RingCell* cell;
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            net_buffer_release(buffer);
+            if (ring->on_backpressure &&
+                !atomic_exchange_explicit(&ring->full, true, memory_order_acq_rel)) {
+                ring->on_backpressure(ring->service_id, true, ring->user_data);
+            }
+            polycall_metrics_inc(POLYCALL_METRIC_MICRO_QUEUE_FULL);
+            return POLYCALL_MICRO_ERROR_FULL;
+        } else {
+            pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->command = queued;
+    cell->buffer = buffer;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    polycall_metrics_inc(POLYCALL_METRIC_MICRO_ENQUEUED);
+    return POLYCALL_MICRO_SUCCESS;
+}
+
+uint32_t polycall_micro_dequeue_batch(
+    PolycallServiceState* service,
+    PolycallQueuedCommand* out,
+    uint32_t max
+) {
+    if (!service || !service->ring || !out || max == 0) return 0;
+
+    PolycallCommandRing* ring = service->ring;
+    size_t pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+    uint32_t count;
+    for (;;) {
+        // Count the filled cells from pos, then claim them all at once
+        count = 0;
+        while (count < max && count <= ring->mask) {
+            size_t sequence = atomic_load_explicit(&ring->cells[(pos + count) & ring->mask].sequence,
+                                                   memory_order_acquire);
+            if (sequence != pos + count + 1) break;
+            count++;
+        }
+        if (count == 0) {
+            size_t sequence = atomic_load_explicit(&ring->cells[pos & ring->mask].sequence,
+                                                   memory_order_acquire);
+            if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0) return 0;   // Empty
+            pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&ring->dequeue_pos, &pos, pos + count,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        RingCell* cell = &ring->cells[(pos + i) & ring->mask];
+        out[i].command = cell->command;
+        out[i].buffer = cell->buffer;
+        atomic_store_explicit(&cell->sequence, pos + i + ring->mask + 1, memory_order_release);
+    }
+    polycall_metrics_add(POLYCALL_METRIC_MICRO_DEQUEUED, count);
+
+    if (ring->on_backpressure && atomic_load_explicit(&ring->full, memory_order_relaxed) &&
+        polycall_micro_queue_depth(service) <= (ring->mask + 1) / 2 &&
+        atomic_exchange_explicit(&ring->full, false, memory_order_acq_rel)) {
+        ring->on_backpressure(ring->service_id, false, ring->user_data);
+    }
+    return count;
+}
+
+uint32_t polycall_micro_queue_depth(const PolycallServiceState* service) {
+    if (!service || !service->ring) return 0;
+    size_t tail = atomic_load_explicit(&service->ring->dequeue_pos, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&service->ring->enqueue_pos, memory_order_relaxed);
+    return head > tail ? (uint32_t)(head - tail) : 0;
+}
+
 // Update service state
 PolycallMicroStatus polycall_micro_update_service_state(
     PolycallMicroContext* ctx,
@@ -255,17 +880,12 @@ PolycallMicroStatus polycall_micro_update_service_state(
 ) {
     if (!ctx) return POLYCALL_MICRO_ERROR_SERVICE;
     
-    // Find and update service state
-    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_SERVICES; i++) {
-        if ((ctx->service_array.active_mask & (1U << i)) && 
-            ctx->service_array.services[i].id == service_id) {
-            ctx->service_array.services[i].state = new_state;
-            ctx->service_array.services[i].last_update = get_current_timestamp();
-            return POLYCALL_MICRO_SUCCESS;
-        }
-    }
+    int slot = find_service(ctx, service_id);
+    if (slot < 0) return POLYCALL_MICRO_ERROR_SERVICE;
     
-    return POLYCALL_MICRO_ERROR_SERVICE;
+    ctx->service_array.states[slot] = new_state;
+    ctx->service_array.last_update[slot] = get_current_timestamp();
+    return POLYCALL_MICRO_SUCCESS;
 }
 
 // Garbage collection
@@ -276,13 +896,9 @@ PolycallMicroStatus polycall_micro_collect_garbage(PolycallMicroContext* ctx) {
     uint64_t timeout = 3600; // 1 hour timeout
     
     // Clean up inactive services
-    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_SERVICES; i++) {
-        if (ctx->service_array.active_mask & (1U << i)) {
-            PolycallServiceState* service = &ctx->service_array.services[i];
-            
-            if (current_time - service->last_update > timeout) {
-                polycall_micro_destroy_service(ctx, service->id);
-            }
+    FOR_EACH_SERVICE(&ctx->service_array, slot) {
+        if (current_time - ctx->service_array.last_update[slot] > timeout) {
+            destroy_slot(ctx, (uint32_t)slot);
         }
     }
     
@@ -299,6 +915,8 @@ const char* polycall_micro_status_string(PolycallMicroStatus status) {
         case POLYCALL_MICRO_ERROR_COMMAND: return "Command error";
         case POLYCALL_MICRO_ERROR_PROTOCOL: return "Protocol error";
         case POLYCALL_MICRO_ERROR_MEMORY: return "Memory error";
+        case POLYCALL_MICRO_ERROR_FULL: return "Queue full";
+        case POLYCALL_MICRO_ERROR_LIMIT: return "Service memory limit";
         default: return "Unknown error";
     }
 }
@@ -330,4 +948,4 @@ void polycall_micro_destroy_transform_chain(PolycallTransformChain* chain) {
         chain->transforms = NULL;
         chain->transform_count = 0;
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
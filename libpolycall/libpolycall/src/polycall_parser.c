@@ -1,8 +1,13 @@
 #include "polycall_parser.h"
+#include "polycall_checksum.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // Internal constants
 #define INITIAL_NODE_CAPACITY 1024
@@ -10,19 +15,20 @@
 #define DEFAULT_MAX_DEPTH 256
 #define DEFAULT_MAX_NODES 65536
 
-// Memory pool for efficient node allocation
+// Children gathered while their parent is parsed, then written as one range
 typedef struct {
-    PolycallASTNode* nodes;
-    size_t capacity;
-    size_t used;
-} NodePool;
+    PolycallASTIndex* items;
+    uint32_t count;
+    uint32_t capacity;
+} ChildList;
 
 // Internal parser state
 typedef struct {
     const PolycallToken* current_token;
     uint32_t token_index;
     uint32_t depth;
-    NodePool pool;
+    PolycallAST* ast;
+    size_t max_nodes;
     char error_buffer[MAX_ERROR_LENGTH];
 } ParserState;
 
@@ -35,36 +41,18 @@ static const PolycallParserConfig DEFAULT_CONFIG = {
     .user_data = NULL
 };
 
-// Node pool management
-static NodePool create_node_pool(size_t capacity) {
-    NodePool pool = {
-        .nodes = calloc(capacity, sizeof(PolycallASTNode)),
-        .capacity = capacity,
-        .used = 0
-    };
-    return pool;
-}
-
-static void destroy_node_pool(NodePool* pool) {
-    if (pool) {
-        free(pool->nodes);
-        pool->nodes = NULL;
-        pool->capacity = 0;
-        pool->used = 0;
+static bool child_list_push(ChildList* list, PolycallASTIndex child) {
+    if (list->count == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 16;
+        PolycallASTIndex* items = realloc(list->items, capacity * sizeof(PolycallASTIndex));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
     }
+    list->items[list->count++] = child;
+    return true;
 }
 
-static PolycallASTNode* allocate_node(NodePool* pool) {
-    if (!pool || pool->used >= pool->capacity) return NULL;
-    return &pool->nodes[pool->used++];
-}
-
-// Node counter callback
-static void count_node(PolycallASTNode* node, void* count) {
-    if (node && count) {
-        (*(uint32_t*)count)++;
-    }
-}
 // Error handling function
 static void set_parser_error(PolycallParser* parser, const char* format, ...) {
     if (!parser) return;
@@ -99,28 +87,132 @@ static bool expect_token(ParserState* state, const PolycallTokenArray* tokens, P
     return advance_token(state, tokens);
 }
 
+// Arena management
+static bool reserve_nodes(PolycallAST* ast, uint32_t needed) {
+    if (needed <= ast->capacity) return true;
+    uint32_t capacity = ast->capacity ? ast->capacity : INITIAL_NODE_CAPACITY;
+    while (capacity < needed) capacity *= 2;
+    PolycallASTNode* nodes = realloc(ast->nodes, (size_t)capacity * sizeof(PolycallASTNode));
+    if (!nodes) return false;
+    ast->nodes = nodes;
+    ast->capacity = capacity;
+    return true;
+}
+
+static bool reserve_links(PolycallAST* ast, uint32_t needed) {
+    if (needed <= ast->link_capacity) return true;
+    uint32_t capacity = ast->link_capacity ? ast->link_capacity : INITIAL_NODE_CAPACITY;
+    while (capacity < needed) capacity *= 2;
+    PolycallASTIndex* links = realloc(ast->links, (size_t)capacity * sizeof(PolycallASTIndex));
+    if (!links) return false;
+    ast->links = links;
+    ast->link_capacity = capacity;
+    return true;
+}
+
+PolycallAST* polycall_ast_create(uint32_t capacity) {
+    PolycallAST* ast = calloc(1, sizeof(PolycallAST));
+    if (!ast) return NULL;
+    
+    ast->root = POLYCALL_AST_NO_NODE;
+    if (capacity > 0 && (!reserve_nodes(ast, capacity) || !reserve_links(ast, capacity))) {
+        polycall_ast_destroy(ast);
+        return NULL;
+    }
+    return ast;
+}
+
+void polycall_ast_destroy(PolycallAST* ast) {
+    if (!ast) return;
+    free(ast->nodes);
+    free(ast->links);
+    free(ast);
+}
+
 // AST node creation
-PolycallASTNode* polycall_ast_create_node(PolycallASTType type, const PolycallValue* value) {
-    PolycallASTNode* node = calloc(1, sizeof(PolycallASTNode));
-    if (!node) return NULL;
+PolycallASTIndex polycall_ast_add_node(PolycallAST* ast, PolycallASTType type, const PolycallValue* value) {
+    if (!ast || ast->node_count == POLYCALL_AST_NO_NODE) return POLYCALL_AST_NO_NODE;
+    if (!reserve_nodes(ast, ast->node_count + 1)) return POLYCALL_AST_NO_NODE;
     
+    PolycallASTIndex index = ast->node_count++;
+    PolycallASTNode* node = &ast->nodes[index];
+    memset(node, 0, sizeof(*node));
     node->type = type;
     if (value) {
         node->value = *value;
     }
+    node->parent = POLYCALL_AST_NO_NODE;
+    node->first_child = ast->link_count;
     
-    return node;
+    if (type == AST_ERROR) ast->error_count++;
+    return index;
 }
 
-void polycall_ast_destroy_node(PolycallASTNode* node) {
-    if (!node) return;
+bool polycall_ast_set_children(
+    PolycallAST* ast,
+    PolycallASTIndex parent,
+    const PolycallASTIndex* children,
+    uint32_t count
+) {
+    if (!ast || parent >= ast->node_count || (!children && count > 0)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        if (children[i] >= ast->node_count || children[i] == parent) return false;
+    }
+    if (!reserve_links(ast, ast->link_count + count)) return false;
     
+    PolycallASTNode* node = &ast->nodes[parent];
     for (uint32_t i = 0; i < node->child_count; i++) {
-        polycall_ast_destroy_node(node->children[i]);
+        ast->nodes[ast->links[node->first_child + i]].parent = POLYCALL_AST_NO_NODE;
     }
     
-    free(node->children);
-    free(node);
+    node->first_child = ast->link_count;
+    node->child_count = count;
+    node->child_capacity = count;
+    for (uint32_t i = 0; i < count; i++) {
+        ast->links[ast->link_count++] = children[i];
+        ast->nodes[children[i]].parent = parent;
+    }
+    return true;
+}
+
+// Tree manipulation helpers
+bool polycall_ast_add_child(PolycallAST* ast, PolycallASTIndex parent, PolycallASTIndex child) {
+    if (!ast || parent >= ast->node_count || child >= ast->node_count || child == parent) {
+        return false;
+    }
+    
+    PolycallASTNode* node = &ast->nodes[parent];
+    if (node->child_count == node->child_capacity) {
+        uint32_t capacity = node->child_capacity ? node->child_capacity * 2 : 1;
+        bool at_end = node->first_child + node->child_capacity == ast->link_count;
+        uint32_t needed = at_end ? capacity - node->child_capacity : capacity;
+        if (!reserve_links(ast, ast->link_count + needed)) return false;
+        
+        // The last range can grow in place; any other moves to the end
+        if (!at_end) {
+            memcpy(&ast->links[ast->link_count], &ast->links[node->first_child],
+                   node->child_count * sizeof(PolycallASTIndex));
+            node->first_child = ast->link_count;
+        }
+        ast->link_count += needed;
+        node->child_capacity = capacity;
+    }
+    
+    ast->links[node->first_child + node->child_count++] = child;
+    ast->nodes[child].parent = parent;
+    return true;
+}
+
+PolycallASTNode* polycall_ast_node(const PolycallAST* ast, PolycallASTIndex index) {
+    if (!ast || index >= ast->node_count) return NULL;
+    return &ast->nodes[index];
+}
+
+const PolycallASTIndex* polycall_ast_children(const PolycallAST* ast, PolycallASTIndex index, uint32_t* count) {
+    if (count) *count = 0;
+    if (!ast || index >= ast->node_count || !count) return NULL;
+    *count = ast->nodes[index].child_count;
+    return ast->links ? &ast->links[ast->nodes[index].first_child] : NULL;
 }
 
 // Parser creation and destruction
@@ -138,6 +230,19 @@ PolycallParser* polycall_parser_create(const PolycallParserConfig* config) {
         return NULL;
     }
     
+    TokenPattern patterns[] = {
+        { polycall_tokenizer_match_string, TOKEN_STRING },
+        { polycall_tokenizer_match_identifier, TOKEN_IDENTIFIER },
+        { polycall_tokenizer_match_number, TOKEN_NUMBER },
+        { polycall_tokenizer_match_operator, TOKEN_OPERATOR }
+    };
+    TokenConsumer consumers[4] = {{0}};
+    parser->ops = polycall_tokenizer_create_ops(patterns, consumers, 4);
+    if (!parser->ops) {
+        polycall_parser_destroy(parser);
+        return NULL;
+    }
+    
     return parser;
 }
 
@@ -147,36 +252,39 @@ void polycall_parser_destroy(PolycallParser* parser) {
     if (parser->tokenizer) {
         polycall_tokenizer_destroy(parser->tokenizer);
     }
+    polycall_tokenizer_destroy_ops(parser->ops);
 
-    if (parser->ast) {
-
-        polycall_ast_destroy_node(parser->ast->root);
-
-        free(parser->ast->nodes);
-
-        free(parser->ast);
-
-    }
-
+    polycall_parser_clear_cache(parser);
+    polycall_ast_destroy(parser->ast);
     
     free(parser->error.message);
     free(parser);
 }
 
 // Parsing functions
-static PolycallASTNode* parse_expression(ParserState* state, const PolycallTokenArray* tokens) {
-    if (!state->current_token) return NULL;
+static PolycallASTIndex new_node(ParserState* state, PolycallASTType type) {
+    if (state->ast->node_count >= state->max_nodes) return POLYCALL_AST_NO_NODE;
     
-    PolycallASTNode* node = NULL;
+    PolycallASTIndex index = polycall_ast_add_node(state->ast, type, NULL);
+    if (index != POLYCALL_AST_NO_NODE && state->current_token) {
+        state->ast->nodes[index].line = state->current_token->line;
+        state->ast->nodes[index].column = state->current_token->column;
+    }
+    return index;
+}
+
+static PolycallASTIndex parse_expression(ParserState* state, const PolycallTokenArray* tokens) {
+    if (!state->current_token) return POLYCALL_AST_NO_NODE;
+    
+    PolycallASTIndex node = POLYCALL_AST_NO_NODE;
     
     switch (state->current_token->type) {
         case TOKEN_NUMBER:
         case TOKEN_STRING:
         case TOKEN_IDENTIFIER:
-            node = allocate_node(&state->pool);
-            if (node) {
-                node->type = AST_EXPRESSION;
-                node->value = state->current_token->value;
+            node = new_node(state, AST_EXPRESSION);
+            if (node != POLYCALL_AST_NO_NODE) {
+                state->ast->nodes[node].value = state->current_token->value;
                 advance_token(state, tokens);
             }
             break;
@@ -188,73 +296,66 @@ static PolycallASTNode* parse_expression(ParserState* state, const PolycallToken
     return node;
 }
 
-static PolycallASTNode* parse_statement(ParserState* state, const PolycallTokenArray* tokens) {
-    if (!state->current_token) return NULL;
-    
-    PolycallASTNode* node = allocate_node(&state->pool);
-    if (!node) return NULL;
-    
-    node->type = AST_STATEMENT;
-    
-    // Parse expression statement
-    PolycallASTNode* expr = parse_expression(state, tokens);
-    if (expr) {
-        node->children = calloc(1, sizeof(PolycallASTNode*));
-        node->children[0] = expr;
-        node->child_count = 1;
-        expr->parent = node;
+static PolycallASTIndex parse_statement(ParserState* state, const PolycallTokenArray* tokens) {
+    if (!state->current_token) return POLYCALL_AST_NO_NODE;
+    
+    PolycallASTIndex node = new_node(state, AST_STATEMENT);
+    if (node == POLYCALL_AST_NO_NODE) return POLYCALL_AST_NO_NODE;
+    
+    // Parse expression statement; skip a token that cannot start one
+    PolycallASTIndex expr = parse_expression(state, tokens);
+    if (expr != POLYCALL_AST_NO_NODE) {
+        polycall_ast_set_children(state->ast, node, &expr, 1);
+    } else if (!advance_token(state, tokens)) {
+        state->current_token = NULL;
     }
     
     return node;
 }
 
-static PolycallASTNode* parse_block(ParserState* state, const PolycallTokenArray* tokens) {
-    if (!expect_token(state, tokens, TOKEN_SEPARATOR)) return NULL;
-    
-    PolycallASTNode* node = allocate_node(&state->pool);
-    if (!node) return NULL;
+static PolycallASTIndex parse_block(ParserState* state, const PolycallTokenArray* tokens) {
+    if (!expect_token(state, tokens, TOKEN_SEPARATOR)) return POLYCALL_AST_NO_NODE;
     
-    node->type = AST_BLOCK;
-    node->children = calloc(16, sizeof(PolycallASTNode*));  // Initial capacity
+    PolycallASTIndex node = new_node(state, AST_BLOCK);
+    if (node == POLYCALL_AST_NO_NODE) return POLYCALL_AST_NO_NODE;
     
+    ChildList statements = {0};
     while (state->current_token && 
            state->current_token->type != TOKEN_SEPARATOR) {
         
-        PolycallASTNode* stmt = parse_statement(state, tokens);
-        if (stmt) {
-            node->children[node->child_count++] = stmt;
-            stmt->parent = node;
-        }
+        PolycallASTIndex stmt = parse_statement(state, tokens);
+        if (stmt == POLYCALL_AST_NO_NODE || !child_list_push(&statements, stmt)) break;
     }
+    polycall_ast_set_children(state->ast, node, statements.items, statements.count);
+    free(statements.items);
     
     expect_token(state, tokens, TOKEN_SEPARATOR);
     return node;
 }
 
-static PolycallASTNode* parse_function(ParserState* state, const PolycallTokenArray* tokens) {
-    if (!expect_token(state, tokens, TOKEN_IDENTIFIER)) return NULL;
+static PolycallASTIndex parse_function(ParserState* state, const PolycallTokenArray* tokens) {
+    const PolycallToken* name = state->current_token;
+    if (!expect_token(state, tokens, TOKEN_IDENTIFIER)) return POLYCALL_AST_NO_NODE;
     
-    PolycallASTNode* node = allocate_node(&state->pool);
-    if (!node) return NULL;
+    PolycallASTIndex node = new_node(state, AST_FUNCTION);
+    if (node == POLYCALL_AST_NO_NODE) return POLYCALL_AST_NO_NODE;
     
-    node->type = AST_FUNCTION;
-    node->value = state->current_token->value;
+    state->ast->nodes[node].value = name->value;
+    state->ast->nodes[node].line = name->line;
+    state->ast->nodes[node].column = name->column;
     
     // Parse parameter list
     expect_token(state, tokens, TOKEN_SEPARATOR);
     while (state->current_token && 
            state->current_token->type != TOKEN_SEPARATOR) {
-        advance_token(state, tokens);
+        if (!advance_token(state, tokens)) state->current_token = NULL;
     }
     expect_token(state, tokens, TOKEN_SEPARATOR);
     
     // Parse function body
-    PolycallASTNode* body = parse_block(state, tokens);
-    if (body) {
-        node->children = calloc(1, sizeof(PolycallASTNode*));
-        node->children[0] = body;
-        node->child_count = 1;
-        body->parent = node;
+    PolycallASTIndex body = parse_block(state, tokens);
+    if (body != POLYCALL_AST_NO_NODE) {
+        polycall_ast_set_children(state->ast, node, &body, 1);
     }
     
     return node;
@@ -263,48 +364,119 @@ static PolycallASTNode* parse_function(ParserState* state, const PolycallTokenAr
 static PolycallAST* parse_tokens(PolycallParser* parser, const PolycallTokenArray* tokens) {
     if (!parser || !tokens) return NULL;
     
-    PolycallAST* ast = calloc(1, sizeof(PolycallAST));
+    PolycallAST* ast = polycall_ast_create(INITIAL_NODE_CAPACITY);
     if (!ast) return NULL;
     
     ParserState state = {
         .current_token = tokens->count > 0 ? &tokens->tokens[0] : NULL,
-        .token_index = 0,
+        .token_index = tokens->count > 0 ? 1 : 0,
         .depth = 0,
-        .pool = create_node_pool(parser->config->max_nodes)
+        .ast = ast,
+        .max_nodes = parser->config->max_nodes
     };
     
     // Parse program
-    ast->root = allocate_node(&state.pool);
-    if (ast->root) {
-        ast->root->type = AST_PROGRAM;
-        ast->root->children = calloc(16, sizeof(PolycallASTNode*));  // Initial capacity
-        
+    ast->root = new_node(&state, AST_PROGRAM);
+    if (ast->root != POLYCALL_AST_NO_NODE) {
+        ChildList functions = {0};
         while (state.current_token && 
                state.current_token->type != TOKEN_EOF) {
             
-            PolycallASTNode* node = parse_function(&state, tokens);
-            if (node) {
-                ast->root->children[ast->root->child_count++] = node;
-                node->parent = ast->root;
+            PolycallASTIndex node = parse_function(&state, tokens);
+            if (node == POLYCALL_AST_NO_NODE) {
+                // Not a function: skip the token rather than stall on it
+                if (!advance_token(&state, tokens)) break;
+                continue;
             }
+            if (!child_list_push(&functions, node)) break;
         }
+        polycall_ast_set_children(ast, ast->root, functions.items, functions.count);
+        free(functions.items);
     }
     
-    // Build flat node array for efficient traversal
-    ast->capacity = state.pool.used;
-    ast->nodes = calloc(ast->capacity, sizeof(PolycallASTNode*));
-    if (ast->nodes) {
-        for (size_t i = 0; i < state.pool.used; i++) {
-            ast->nodes[i] = &state.pool.nodes[i];
+    return ast;
+}
+
+// Public parsing functions
+
+// A file parsed by polycall_parser_parse_file. The AST's values point
+// into map, so both go together.
+struct PolycallParseCacheEntry {
+    char* path;
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec mtime;
+    uint32_t checksum;              // CRC32C of the contents
+    void* map;                      // Read-only mapping, NULL when empty
+    PolycallAST* ast;
+    PolycallParseCacheEntry* next;
+};
+
+static void destroy_cache_entry(PolycallParseCacheEntry* entry) {
+    if (entry->map) munmap(entry->map, (size_t)entry->size);
+    polycall_ast_destroy(entry->ast);
+    free(entry->path);
+    free(entry);
+}
+
+void polycall_parser_clear_cache(PolycallParser* parser) {
+    if (!parser) return;
+    while (parser->cache) {
+        PolycallParseCacheEntry* next = parser->cache->next;
+        destroy_cache_entry(parser->cache);
+        parser->cache = next;
+    }
+}
+
+// Tokenize input in place and parse it; node values point into input
+static PolycallAST* parse_in_place(PolycallParser* parser, const char* input, size_t length) {
+    if (!parser->ops) {
+        set_parser_error(parser, "No tokenizer operations");
+        return NULL;
+    }
+    polycall_tokenizer_reset(parser->tokenizer);
+    
+    // The tokenizer hands tokens over a window at a time
+    PolycallTokenArray all = {0};
+    bool ok = true;
+    size_t offset = 0;
+    while (ok && polycall_tokenizer_get_state(parser->tokenizer) != TOKENIZER_STATE_EOF) {
+        size_t used = 0;
+        ok = offset < length || length == 0
+            ? polycall_tokenizer_feed_last(parser->tokenizer, parser->ops, input + offset, length - offset, &used)
+            : polycall_tokenizer_finish(parser->tokenizer, parser->ops);
+        offset += used;
+        
+        const PolycallTokenArray* window = polycall_tokenizer_get_tokens(parser->tokenizer);
+        if (!ok || !window || window->count == 0) continue;
+        if (all.count + window->count > all.capacity) {
+            uint32_t capacity = all.capacity ? all.capacity : 256;
+            while (capacity < all.count + window->count) capacity *= 2;
+            PolycallToken* tokens = realloc(all.tokens, capacity * sizeof(PolycallToken));
+            if (!tokens) {
+                set_parser_error(parser, "Failed to allocate memory for tokens");
+                free(all.tokens);
+                return NULL;
+            }
+            all.tokens = tokens;
+            all.capacity = capacity;
         }
-        ast->node_count = state.pool.used;
+        memcpy(all.tokens + all.count, window->tokens, window->count * sizeof(PolycallToken));
+        all.count += window->count;
+    }
+    if (!ok) {
+        const char* reason = polycall_tokenizer_get_error(parser->tokenizer);
+        set_parser_error(parser, "Tokenization failed: %s", reason ? reason : "unknown error");
+        free(all.tokens);
+        return NULL;
     }
     
-    destroy_node_pool(&state.pool);
+    PolycallAST* ast = parse_tokens(parser, &all);
+    free(all.tokens);
     return ast;
 }
 
-// Public parsing functions
 PolycallAST* polycall_parser_parse_string(
     PolycallParser* parser,
     const char* input,
@@ -312,94 +484,236 @@ PolycallAST* polycall_parser_parse_string(
 ) {
     if (!parser || !input || length == 0) return NULL;
     
-    // Tokenize input
-    if (!polycall_tokenizer_set_input(parser->tokenizer, input, length)) {
-        set_parser_error(parser, "Failed to set parser input");
-        return NULL;
-    }
-    
-    TokenizerOperations ops = {0};  // Define tokenizer operations
-    if (!polycall_tokenizer_process(parser->tokenizer, &ops)) {
-        set_parser_error(parser, "Tokenization failed");
-        return NULL;
-    }
-    
-    // Parse tokens
-    const PolycallTokenArray* tokens = polycall_tokenizer_get_tokens(parser->tokenizer);
-    return parse_tokens(parser, tokens);
+    return parse_in_place(parser, input, length);
+}
+
+static bool same_file(const PolycallParseCacheEntry* entry, const struct stat* info) {
+    return entry->device == info->st_dev && entry->inode == info->st_ino &&
+           entry->size == info->st_size &&
+           entry->mtime.tv_sec == info->st_mtim.tv_sec &&
+           entry->mtime.tv_nsec == info->st_mtim.tv_nsec;
+}
+
+static void remember_file(PolycallParseCacheEntry* entry, const struct stat* info) {
+    entry->device = info->st_dev;
+    entry->inode = info->st_ino;
+    entry->size = info->st_size;
+    entry->mtime = info->st_mtim;
 }
 
 PolycallAST* polycall_parser_parse_file(PolycallParser* parser, const char* filename) {
     if (!parser || !filename) return NULL;
     
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
+    PolycallParseCacheEntry* entry = parser->cache;
+    while (entry && strcmp(entry->path, filename) != 0) entry = entry->next;
+    
+    // Unchanged since last time: no need to even open it
+    struct stat info;
+    if (entry && stat(filename, &info) == 0 && same_file(entry, &info)) {
+        return entry->ast;
+    }
+    
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         set_parser_error(parser, "Failed to open file: %s", filename);
         return NULL;
     }
-    
-    // Read file content
-    fseek(file, 0, SEEK_END);
-    size_t size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char* buffer = malloc(size + 1);
-    if (!buffer) {
-        fclose(file);
-        set_parser_error(parser, "Failed to allocate memory for file content");
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        set_parser_error(parser, "Not a regular file: %s", filename);
         return NULL;
     }
     
-    size_t read = fread(buffer, 1, size, file);
-    fclose(file);
+    void* map = NULL;
+    size_t size = (size_t)info.st_size;
+    if (size > 0) {
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            set_parser_error(parser, "Failed to map file: %s", filename);
+            return NULL;
+        }
+    }
+    close(fd);
+    
+    // Same bytes under new metadata keep the AST (and the old mapping)
+    uint32_t checksum = polycall_crc32c(0, map, size);
+    if (entry && entry->checksum == checksum && (size_t)entry->size == size) {
+        if (map) munmap(map, size);
+        remember_file(entry, &info);
+        return entry->ast;
+    }
     
-    if (read != size) {
-        free(buffer);
-        set_parser_error(parser, "Failed to read file content");
+    PolycallAST* ast = parse_in_place(parser, map ? map : "", size);
+    if (!ast) {
+        if (map) munmap(map, size);
         return NULL;
     }
     
-    buffer[size] = '\0';
+    if (!entry) {
+        entry = calloc(1, sizeof(PolycallParseCacheEntry));
+        char* path = strdup(filename);
+        if (!entry || !path) {
+            free(entry);
+            free(path);
+            polycall_ast_destroy(ast);
+            if (map) munmap(map, size);
+            set_parser_error(parser, "Failed to allocate parse cache entry");
+            return NULL;
+        }
+        entry->path = path;
+        entry->next = parser->cache;
+        parser->cache = entry;
+    } else {
+        if (entry->map) munmap(entry->map, (size_t)entry->size);
+        polycall_ast_destroy(entry->ast);
+    }
     
-    // Parse file content
-    PolycallAST* ast = polycall_parser_parse_string(parser, buffer, size);
-    free(buffer);
+    remember_file(entry, &info);
+    entry->checksum = checksum;
+    entry->map = map;
+    entry->ast = ast;
     return ast;
 }
 
-// Point-free style operations
-PolycallASTNode* polycall_ast_map(const PolycallASTNode* node, ASTTransform transform) {
-    if (!node || !transform) return NULL;
-    return transform(node);
+/*
+ * Copying pass shared by map, filter, apply_transforms and optimize.
+ * The output arena is its own work queue: node d of the output came from
+ * origin[d] of the input, and visiting the output in order copies each
+ * node's children to the end, so the walk is breadth first and the child
+ * ranges come out packed. copied[] maps shared input nodes to their one
+ * copy (or COPY_DROPPED), so a shared node stays shared.
+ */
+#define COPY_DROPPED (POLYCALL_AST_NO_NODE - 1)
+
+typedef struct {
+    ASTTransform transform;                 // map
+    ASTPredicate predicate;                 // filter
+    const PolycallASTTransforms* chain;     // apply_transforms
+    uint32_t level;                         // optimize
+} CopyPass;
+
+// Optimization levels 1 and up splice out blocks with a single child
+static PolycallASTIndex splice(const PolycallAST* ast, PolycallASTIndex index, uint32_t level) {
+    uint32_t hops = 0;
+    while (level >= 1 && ast->nodes[index].type == AST_BLOCK &&
+           ast->nodes[index].child_count == 1 && hops++ < ast->node_count) {
+        index = ast->links[ast->nodes[index].first_child];
+    }
+    return index;
 }
 
-PolycallAST* polycall_ast_filter(const PolycallAST* ast, ASTPredicate predicate) {
-    if (!ast || !predicate) return NULL;
-    
-    PolycallAST* filtered = calloc(1, sizeof(PolycallAST));
-    if (!filtered) return NULL;
+static bool keep_copy(const CopyPass* pass, PolycallASTNode* node) {
+    if (pass->transform && !pass->transform(node)) return false;
+    if (pass->predicate && !pass->predicate(node)) return false;
+    if (pass->chain) {
+        for (uint32_t t = 0; t < pass->chain->count; t++) {
+            if (pass->chain->transforms[t] && !pass->chain->transforms[t](node)) return false;
+        }
+    }
+    return true;
+}
+
+// Copy source node index into out as node count; false when it was dropped
+static bool copy_node(const PolycallAST* ast, PolycallAST* out, PolycallASTIndex* origin,
+                      PolycallASTIndex* copied, const CopyPass* pass,
+                      PolycallASTIndex index, PolycallASTIndex parent) {
+    PolycallASTIndex slot = out->node_count;
+    PolycallASTNode* node = &out->nodes[slot];
+    *node = ast->nodes[index];
+    node->parent = parent;
+    bool shared = (node->attrs & AST_ATTR_SHARED) != 0;
+    if (!keep_copy(pass, node)) {
+        if (shared) copied[index] = COPY_DROPPED;
+        return false;
+    }
+    if (shared) copied[index] = slot;
+    
+    // The transform sees the node, not its links
+    node->parent = parent;
+    node->first_child = 0;
+    node->child_count = 0;
+    node->child_capacity = 0;
+    origin[slot] = index;
+    out->node_count++;
+    if (node->type == AST_ERROR) out->error_count++;
+    return true;
+}
+
+static PolycallAST* copy_tree(const PolycallAST* ast, const CopyPass* pass) {
+    // Each input node is copied at most once and each input link at most
+    // once, which bounds both arrays
+    uint32_t capacity = ast->node_count ? ast->node_count : 1;
+    PolycallAST* out = polycall_ast_create(capacity);
+    PolycallASTIndex* origin = malloc(capacity * sizeof(PolycallASTIndex) * 2);
+    if (!out || !origin || !reserve_links(out, ast->link_count)) {
+        free(origin);
+        polycall_ast_destroy(out);
+        return NULL;
+    }
+    PolycallASTIndex* copied = origin + capacity;
+    memset(copied, 0xFF, capacity * sizeof(PolycallASTIndex));
     
-    filtered->capacity = ast->node_count;
-    filtered->nodes = calloc(filtered->capacity, sizeof(PolycallASTNode*));
+    if (ast->root < ast->node_count &&
+        copy_node(ast, out, origin, copied, pass, splice(ast, ast->root, pass->level),
+                  POLYCALL_AST_NO_NODE)) {
+        out->root = 0;
+    }
     
-    if (filtered->nodes) {
-        for (uint32_t i = 0; i < ast->node_count; i++) {
-            if (predicate(ast->nodes[i])) {
-                filtered->nodes[filtered->node_count++] = ast->nodes[i];
+    for (PolycallASTIndex d = 0; d < out->node_count; d++) {
+        const PolycallASTNode* source = &ast->nodes[origin[d]];
+        out->nodes[d].first_child = out->link_count;
+        
+        for (uint32_t i = 0; i < source->child_count; i++) {
+            PolycallASTIndex child = ast->links[source->first_child + i];
+            if (child >= ast->node_count) continue;
+            child = splice(ast, child, pass->level);
+            
+            PolycallASTIndex target = copied[child];
+            if (target == POLYCALL_AST_NO_NODE) {
+                if (out->node_count == capacity) {
+                    // More nodes reachable than exist: the input is not a tree
+                    free(origin);
+                    polycall_ast_destroy(out);
+                    return NULL;
+                }
+                if (!copy_node(ast, out, origin, copied, pass, child, d)) continue;
+                target = out->node_count - 1;
+            } else if (target == COPY_DROPPED) {
+                continue;
             }
+            out->links[out->link_count++] = target;
+            out->nodes[d].child_count++;
+            out->nodes[d].child_capacity++;
         }
     }
     
-    return filtered;
+    free(origin);
+    return out;
+}
+
+// Point-free style operations
+PolycallAST* polycall_ast_map(const PolycallAST* ast, ASTTransform transform) {
+    if (!ast || !transform) return NULL;
+    CopyPass pass = { .transform = transform };
+    return copy_tree(ast, &pass);
+}
+
+PolycallAST* polycall_ast_filter(const PolycallAST* ast, ASTPredicate predicate) {
+    if (!ast || !predicate) return NULL;
+    CopyPass pass = { .predicate = predicate };
+    return copy_tree(ast, &pass);
 }
 
-void polycall_ast_visit(PolycallASTNode* node, ASTVisitor visitor, void* user_data) {
-    if (!node || !visitor) return;
+void polycall_ast_visit(PolycallAST* ast, PolycallASTIndex node, ASTVisitor visitor, void* user_data) {
+    if (!ast || node >= ast->node_count || !visitor) return;
     
-    visitor(node, user_data);
+    visitor(&ast->nodes[node], user_data);
     
-    for (uint32_t i = 0; i < node->child_count; i++) {
-        polycall_ast_visit(node->children[i], visitor, user_data);
+    uint32_t count = ast->nodes[node].child_count;
+    uint32_t first = ast->nodes[node].first_child;
+    for (uint32_t i = 0; i < count; i++) {
+        polycall_ast_visit(ast, ast->links[first + i], visitor, user_data);
     }
 }
 
@@ -433,57 +747,25 @@ PolycallAST* polycall_ast_apply_transforms(
 ) {
     if (!ast || !transforms || !transforms->transforms) return NULL;
     
-    // Create a copy of the AST for transformation
-    PolycallAST* result = calloc(1, sizeof(PolycallAST));
-    if (!result) return NULL;
-    
-    result->capacity = ast->node_count;
-    result->nodes = calloc(result->capacity, sizeof(PolycallASTNode*));
-    if (!result->nodes) {
-        free(result);
-        return NULL;
-    }
-    
-    // Apply transforms in sequence
-    for (uint32_t i = 0; i < ast->node_count; i++) {
-        const PolycallASTNode* current = ast->nodes[i];
-        PolycallASTNode* transformed = (PolycallASTNode*)current;
-        
-        // Apply each transform in the chain
-        for (uint32_t t = 0; t < transforms->count; t++) {
-            if (transforms->transforms[t]) {
-                transformed = transforms->transforms[t](transformed);
-                if (!transformed) break;
-            }
-        }
-        
-        if (transformed) {
-            result->nodes[result->node_count++] = transformed;
-        }
-    }
-    
-    // Reconstruct tree structure if needed
-    if (result->node_count > 0) {
-        result->root = result->nodes[0];
-    }
-    
-    return result;
+    // Every transform runs on a node before its children are copied
+    CopyPass pass = { .chain = transforms };
+    return copy_tree(ast, &pass);
 }
 
 // AST query functions implementation
-PolycallASTNode* polycall_ast_find_node(const PolycallAST* ast, PolycallASTType type) {
-    if (!ast || !ast->nodes) return NULL;
+PolycallASTIndex polycall_ast_find_node(const PolycallAST* ast, PolycallASTType type) {
+    if (!ast || !ast->nodes) return POLYCALL_AST_NO_NODE;
     
     for (uint32_t i = 0; i < ast->node_count; i++) {
-        if (ast->nodes[i]->type == type) {
-            return ast->nodes[i];
+        if (ast->nodes[i].type == type) {
+            return i;
         }
     }
     
-    return NULL;
+    return POLYCALL_AST_NO_NODE;
 }
 
-PolycallASTNode** polycall_ast_find_nodes(
+PolycallASTIndex* polycall_ast_find_nodes(
     const PolycallAST* ast,
     PolycallASTType type,
     uint32_t* count
@@ -493,7 +775,7 @@ PolycallASTNode** polycall_ast_find_nodes(
     // First pass: count matching nodes
     *count = 0;
     for (uint32_t i = 0; i < ast->node_count; i++) {
-        if (ast->nodes[i]->type == type) {
+        if (ast->nodes[i].type == type) {
             (*count)++;
         }
     }
@@ -501,7 +783,7 @@ PolycallASTNode** polycall_ast_find_nodes(
     if (*count == 0) return NULL;
     
     // Allocate result array
-    PolycallASTNode** result = calloc(*count, sizeof(PolycallASTNode*));
+    PolycallASTIndex* result = calloc(*count, sizeof(PolycallASTIndex));
     if (!result) {
         *count = 0;
         return NULL;
@@ -510,33 +792,37 @@ PolycallASTNode** polycall_ast_find_nodes(
     // Second pass: collect matching nodes
     uint32_t index = 0;
     for (uint32_t i = 0; i < ast->node_count && index < *count; i++) {
-        if (ast->nodes[i]->type == type) {
-            result[index++] = ast->nodes[i];
+        if (ast->nodes[i].type == type) {
+            result[index++] = i;
         }
     }
     
     return result;
 }
-// Node visit for optimization callback
-static void collect_optimized_node(PolycallASTNode* node, void* ast) {
-    if (node && ast) {
-        PolycallAST* opt = (PolycallAST*)ast;
-        opt->nodes[opt->node_count++] = node;
-    }
-}
 
 // Validation functions
-static bool validate_node_structure(const PolycallASTNode* node, uint32_t depth, size_t max_depth) {
-    if (!node || depth > max_depth) return false;
+static bool validate_node_structure(const PolycallAST* ast, PolycallASTIndex index, uint32_t depth,
+                                    size_t max_depth, uint8_t* seen, uint32_t* counted) {
+    if (index >= ast->node_count || depth > max_depth || seen[index]) return false;
+    seen[index] = 1;
+    (*counted)++;
     
     // Validate parent-child relationships
+    const PolycallASTNode* node = &ast->nodes[index];
+    if ((uint64_t)node->first_child + node->child_count > ast->link_count) return false;
     for (uint32_t i = 0; i < node->child_count; i++) {
-        if (!node->children[i] || node->children[i]->parent != node) {
+        PolycallASTIndex child = ast->links[node->first_child + i];
+        if (child >= ast->node_count) return false;
+        
+        // A shared node names only its first parent and is checked once
+        bool shared = (ast->nodes[child].attrs & AST_ATTR_SHARED) != 0;
+        if (ast->nodes[child].parent != index && !shared) {
             return false;
         }
+        if (shared && seen[child]) continue;
         
         // Recursively validate children
-        if (!validate_node_structure(node->children[i], depth + 1, max_depth)) {
+        if (!validate_node_structure(ast, child, depth + 1, max_depth, seen, counted)) {
             return false;
         }
     }
@@ -546,108 +832,391 @@ static bool validate_node_structure(const PolycallASTNode* node, uint32_t depth,
 
 
 bool polycall_ast_validate(const PolycallAST* ast) {
-    if (!ast || !ast->root) return false;
+    if (!ast || ast->root >= ast->node_count) return false;
+    if (ast->nodes[ast->root].parent != POLYCALL_AST_NO_NODE) return false;
     
-    // Validate node count consistency
-    uint32_t counted_nodes = 0;
-    polycall_ast_visit((PolycallASTNode*)ast->root, count_node, &counted_nodes);
+    uint8_t* seen = calloc(ast->node_count, 1);
+    if (!seen) return false;
     
-    if (counted_nodes != ast->node_count) return false;
+    // Validate tree structure, then that every node is reachable from the root
+    uint32_t counted_nodes = 0;
+    bool valid = validate_node_structure(ast, ast->root, 0, DEFAULT_MAX_DEPTH, seen, &counted_nodes);
+    free(seen);
     
-    // Validate tree structure
-    return validate_node_structure(ast->root, 0, DEFAULT_MAX_DEPTH);
+    return valid && counted_nodes == ast->node_count;
 }
 // Error reporting
 const char* polycall_parser_get_error(const PolycallParser* parser) {
     return parser ? parser->error.message : "Invalid parser";
 }
 
-// AST optimization functions
-static PolycallASTNode* optimize_node(PolycallASTNode* node, uint32_t level) {
-    if (!node) return NULL;
+/*
+ * AST optimization. optimize copies its input once (splicing blocks at
+ * level 1), rewrites that private copy in place, and compacts the result
+ * with a second copy that leaves behind whatever the rewrites cut off.
+ * The copy is in breadth-first order, so every node comes after its
+ * parent: a backward sweep sees operands before their operator, and a
+ * forward sweep sees a branch before anything inside it.
+ */
+static bool is_literal(const PolycallASTNode* node) {
+    return node->type == AST_EXPRESSION && node->child_count == 0 &&
+           (node->value.type == VALUE_INTEGER || node->value.type == VALUE_FLOAT ||
+            node->value.type == VALUE_STRING);
+}
+
+static bool is_operator(const PolycallASTNode* node) {
+    return node->type == AST_EXPRESSION && node->child_count > 0 && node->child_count <= 2 &&
+           node->value.type == VALUE_IDENTIFIER;
+}
+
+static bool name_is(const PolycallASTNode* node, const char* name) {
+    size_t length = strlen(name);
+    return node->value.type == VALUE_IDENTIFIER &&
+           node->value.data.string_value.length == length &&
+           memcmp(node->value.data.string_value.data, name, length) == 0;
+}
+
+static bool is_assignment(const PolycallASTNode* node) {
+    static const char* const ASSIGNMENTS[] = { "=", "+=", "-=", "*=", "/=", "++", "--", NULL };
+    for (const char* const* op = ASSIGNMENTS; *op; op++) {
+        if (name_is(node, *op)) return true;
+    }
+    return false;
+}
+
+static bool truthy(const PolycallValue* value) {
+    switch (value->type) {
+        case VALUE_INTEGER: return value->data.int_value != 0;
+        case VALUE_FLOAT: return value->data.float_value != 0.0;
+        case VALUE_STRING: return value->data.string_value.length != 0;
+        default: return false;
+    }
+}
+
+static bool strings_equal(const PolycallValue* a, const PolycallValue* b) {
+    return a->data.string_value.length == b->data.string_value.length &&
+           (a->data.string_value.length == 0 ||
+            memcmp(a->data.string_value.data, b->data.string_value.data, a->data.string_value.length) == 0);
+}
+
+static bool values_equal(const PolycallValue* a, const PolycallValue* b) {
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case VALUE_INTEGER: return a->data.int_value == b->data.int_value;
+        case VALUE_FLOAT: return a->data.float_value == b->data.float_value;
+        case VALUE_STRING:
+        case VALUE_IDENTIFIER: return strings_equal(a, b);
+        default: return true;
+    }
+}
+
+static PolycallValue integer_value(int64_t value) {
+    PolycallValue result = { .type = VALUE_INTEGER, .data.int_value = value };
+    return result;
+}
+
+static PolycallValue float_value(double value) {
+    PolycallValue result = { .type = VALUE_FLOAT, .data.float_value = value };
+    return result;
+}
+
+static bool fold_unary(const PolycallASTNode* op, const PolycallValue* a, PolycallValue* result) {
+    if (name_is(op, "!")) {
+        *result = integer_value(!truthy(a));
+        return true;
+    }
+    if (a->type == VALUE_INTEGER) {
+        if (name_is(op, "+")) { *result = *a; return true; }
+        if (name_is(op, "-") && a->data.int_value != INT64_MIN) {
+            *result = integer_value(-a->data.int_value);
+            return true;
+        }
+    } else if (a->type == VALUE_FLOAT) {
+        if (name_is(op, "+")) { *result = *a; return true; }
+        if (name_is(op, "-")) { *result = float_value(-a->data.float_value); return true; }
+    }
+    return false;
+}
+
+static bool fold_binary(const PolycallASTNode* op, const PolycallValue* a, const PolycallValue* b,
+                        PolycallValue* result) {
+    if (name_is(op, "&&")) { *result = integer_value(truthy(a) && truthy(b)); return true; }
+    if (name_is(op, "||")) { *result = integer_value(truthy(a) || truthy(b)); return true; }
+    
+    if (a->type == VALUE_STRING || b->type == VALUE_STRING) {
+        if (a->type != b->type) return false;
+        if (name_is(op, "==")) { *result = integer_value(strings_equal(a, b)); return true; }
+        if (name_is(op, "!=")) { *result = integer_value(!strings_equal(a, b)); return true; }
+        return false;
+    }
+    
+    if (a->type == VALUE_INTEGER && b->type == VALUE_INTEGER) {
+        int64_t x = a->data.int_value, y = b->data.int_value, r;
+        if (name_is(op, "+")) { if (__builtin_add_overflow(x, y, &r)) return false; }
+        else if (name_is(op, "-")) { if (__builtin_sub_overflow(x, y, &r)) return false; }
+        else if (name_is(op, "*")) { if (__builtin_mul_overflow(x, y, &r)) return false; }
+        else if (name_is(op, "/") || name_is(op, "%")) {
+            if (y == 0 || (x == INT64_MIN && y == -1)) return false;
+            r = name_is(op, "/") ? x / y : x % y;
+        }
+        else if (name_is(op, "==")) r = x == y;
+        else if (name_is(op, "!=")) r = x != y;
+        else if (name_is(op, "<")) r = x < y;
+        else if (name_is(op, ">")) r = x > y;
+        else if (name_is(op, "<=")) r = x <= y;
+        else if (name_is(op, ">=")) r = x >= y;
+        else return false;
+        *result = integer_value(r);
+        return true;
+    }
+    
+    double x = a->type == VALUE_FLOAT ? a->data.float_value : (double)a->data.int_value;
+    double y = b->type == VALUE_FLOAT ? b->data.float_value : (double)b->data.int_value;
+    if (name_is(op, "+")) *result = float_value(x + y);
+    else if (name_is(op, "-")) *result = float_value(x - y);
+    else if (name_is(op, "*")) *result = float_value(x * y);
+    else if (name_is(op, "/") && y != 0.0) *result = float_value(x / y);
+    else if (name_is(op, "==")) *result = integer_value(x == y);
+    else if (name_is(op, "!=")) *result = integer_value(x != y);
+    else if (name_is(op, "<")) *result = integer_value(x < y);
+    else if (name_is(op, ">")) *result = integer_value(x > y);
+    else if (name_is(op, "<=")) *result = integer_value(x <= y);
+    else if (name_is(op, ">=")) *result = integer_value(x >= y);
+    else return false;
+    return true;
+}
+
+// Level 2: an operator over literals becomes the literal it evaluates to
+static void fold_constants(PolycallAST* ast) {
+    for (PolycallASTIndex d = ast->node_count; d-- > 0;) {
+        PolycallASTNode* node = &ast->nodes[d];
+        if (!is_operator(node)) continue;
+        
+        const PolycallASTIndex* links = &ast->links[node->first_child];
+        const PolycallASTNode* a = &ast->nodes[links[0]];
+        const PolycallASTNode* b = node->child_count == 2 ? &ast->nodes[links[1]] : NULL;
+        if (!is_literal(a) || (b && !is_literal(b))) continue;
+        
+        PolycallValue result;
+        if (b ? fold_binary(node, &a->value, &b->value, &result) : fold_unary(node, &a->value, &result)) {
+            node->value = result;
+            node->child_count = 0;
+        }
+    }
+}
+
+// Point parent's link to old at replacement instead, or drop it
+static void replace_link(PolycallAST* ast, PolycallASTIndex parent, PolycallASTIndex old,
+                         PolycallASTIndex replacement) {
+    PolycallASTNode* node = &ast->nodes[parent];
+    PolycallASTIndex* links = &ast->links[node->first_child];
+    for (uint32_t i = 0; i < node->child_count; i++) {
+        if (links[i] != old) continue;
+        if (replacement != POLYCALL_AST_NO_NODE) {
+            links[i] = replacement;
+        } else {
+            memmove(&links[i], &links[i + 1], (node->child_count - i - 1) * sizeof(PolycallASTIndex));
+            node->child_count--;
+        }
+        return;
+    }
+}
+
+// Level 3: a branch with a literal condition becomes the path it takes
+static void prune_branches(PolycallAST* ast) {
+    for (PolycallASTIndex d = 0; d < ast->node_count; d++) {
+        PolycallASTNode* node = &ast->nodes[d];
+        if (node->type != AST_CONTROL_FLOW || node->child_count == 0 ||
+            node->parent == POLYCALL_AST_NO_NODE || (node->attrs & AST_ATTR_SHARED)) {
+            continue;
+        }
+        
+        const PolycallASTIndex* links = &ast->links[node->first_child];
+        const PolycallASTNode* condition = &ast->nodes[links[0]];
+        if (!is_literal(condition)) continue;
+        
+        bool taken = truthy(&condition->value);
+        PolycallASTIndex replacement = POLYCALL_AST_NO_NODE;
+        if (name_is(node, "while")) {
+            if (taken) continue;
+        } else if (taken) {
+            if (node->child_count > 1) replacement = links[1];
+        } else if (node->child_count > 2) {
+            replacement = links[2];
+        }
+        
+        replace_link(ast, node->parent, d, replacement);
+        if (replacement != POLYCALL_AST_NO_NODE) ast->nodes[replacement].parent = node->parent;
+    }
+}
+
+static uint64_t hash_mix(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * 0x100000001B3ULL;
+}
+
+static uint64_t hash_bytes(uint64_t hash, const char* data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) hash = hash_mix(hash, (unsigned char)data[i]);
+    return hash;
+}
+
+#define CSE_HAS_NAME 0x01           // Subtree reads a name
+#define CSE_MUTABLE  0x02           // Scope node whose body assigns
+
+// Level 3: identical expressions in one function share a single node
+static bool share_subexpressions(PolycallAST* ast) {
+    uint32_t count = ast->node_count;
+    uint32_t buckets = 16;
+    while (buckets < count * 2) buckets *= 2;
+    
+    PolycallASTIndex* canon = malloc((size_t)(count * 2 + buckets) * sizeof(PolycallASTIndex) + count);
+    if (!canon) return false;
+    PolycallASTIndex* scope = canon + count;
+    PolycallASTIndex* table = scope + count;
+    uint8_t* info = (uint8_t*)(table + buckets);
+    memset(scope, 0xFF, count * sizeof(PolycallASTIndex));
+    memset(table, 0xFF, buckets * sizeof(PolycallASTIndex));
+    memset(info, 0, count);
+    
+    // Forward: the function (or root) each node belongs to, and whether it assigns
+    if (ast->root < count) scope[ast->root] = ast->root;
+    for (PolycallASTIndex d = 0; d < count; d++) {
+        const PolycallASTNode* node = &ast->nodes[d];
+        if (scope[d] == POLYCALL_AST_NO_NODE) continue;
+        if (is_operator(node) && is_assignment(node)) info[scope[d]] |= CSE_MUTABLE;
+        for (uint32_t i = 0; i < node->child_count; i++) {
+            PolycallASTIndex child = ast->links[node->first_child + i];
+            if (scope[child] != POLYCALL_AST_NO_NODE) continue;
+            scope[child] = ast->nodes[child].type == AST_FUNCTION ? child : scope[d];
+        }
+    }
     
-    // Apply optimizations based on level
-    switch (level) {
-        case 1:  // Basic optimizations
-            // Remove redundant nodes
-            if (node->type == AST_BLOCK && node->child_count == 1) {
-                PolycallASTNode* child = node->children[0];
-                free(node->children);
-                free(node);
-                return optimize_node(child, level);
+    // Backward: value-number expressions, operands first
+    for (PolycallASTIndex d = count; d-- > 0;) {
+        PolycallASTNode* node = &ast->nodes[d];
+        canon[d] = d;
+        if (scope[d] == POLYCALL_AST_NO_NODE || node->type != AST_EXPRESSION) continue;
+        
+        const PolycallASTIndex* links = &ast->links[node->first_child];
+        bool applies = node->child_count > 0;
+        if (!applies) {
+            if (node->value.type == VALUE_IDENTIFIER) info[d] |= CSE_HAS_NAME;
+        } else {
+            for (uint32_t i = 0; i < node->child_count; i++) info[d] |= info[links[i]] & CSE_HAS_NAME;
+            if ((info[d] & CSE_HAS_NAME) && (info[scope[d]] & CSE_MUTABLE)) continue;
+        }
+        
+        uint64_t hash = hash_mix(hash_mix(0xCBF29CE484222325ULL, scope[d]), node->value.type);
+        switch (node->value.type) {
+            case VALUE_INTEGER: hash = hash_mix(hash, (uint64_t)node->value.data.int_value); break;
+            case VALUE_FLOAT: {
+                uint64_t bits;
+                memcpy(&bits, &node->value.data.float_value, sizeof(bits));
+                hash = hash_mix(hash, bits);
+                break;
             }
-            break;
-            
-        case 2:  // Intermediate optimizations
-            // Constant folding
-            if (node->type == AST_EXPRESSION) {
-                // Implement constant folding logic
+            case VALUE_STRING:
+            case VALUE_IDENTIFIER:
+                hash = hash_bytes(hash, node->value.data.string_value.data, node->value.data.string_value.length);
+                break;
+            default: break;
+        }
+        for (uint32_t i = 0; i < node->child_count; i++) hash = hash_mix(hash, canon[links[i]]);
+        
+        for (uint32_t b = (uint32_t)(hash >> 32) & (buckets - 1);; b = (b + 1) & (buckets - 1)) {
+            PolycallASTIndex other = table[b];
+            if (other == POLYCALL_AST_NO_NODE) {
+                table[b] = d;
+                break;
             }
-            break;
+            const PolycallASTNode* candidate = &ast->nodes[other];
+            if (scope[other] != scope[d] || candidate->child_count != node->child_count ||
+                !values_equal(&candidate->value, &node->value)) {
+                continue;
+            }
+            bool same = true;
+            for (uint32_t i = 0; i < node->child_count && same; i++) {
+                same = canon[ast->links[candidate->first_child + i]] == canon[links[i]];
+            }
+            if (!same) continue;
             
-        case 3:  // Advanced optimizations
-            // Control flow optimization
-            if (node->type == AST_CONTROL_FLOW) {
-                // Implement control flow optimization
+            // Leaves only get the number; operators hand their parent the other node
+            canon[d] = other;
+            if (applies && node->parent != POLYCALL_AST_NO_NODE && !(node->attrs & AST_ATTR_SHARED)) {
+                replace_link(ast, node->parent, d, other);
+                ast->nodes[other].attrs |= AST_ATTR_SHARED;
             }
             break;
+        }
     }
     
-    // Recursively optimize children
-    for (uint32_t i = 0; i < node->child_count; i++) {
-        node->children[i] = optimize_node(node->children[i], level);
+    free(canon);
+    return true;
+}
+
+// Distinct nodes reachable from the root
+static uint32_t count_reachable(const PolycallAST* ast) {
+    if (ast->root >= ast->node_count) return 0;
+    
+    PolycallASTIndex* stack = malloc((size_t)ast->node_count * sizeof(PolycallASTIndex) + ast->node_count);
+    if (!stack) return 0;
+    uint8_t* seen = (uint8_t*)(stack + ast->node_count);
+    memset(seen, 0, ast->node_count);
+    
+    uint32_t top = 0, reached = 0;
+    stack[top++] = ast->root;
+    seen[ast->root] = 1;
+    while (top > 0) {
+        const PolycallASTNode* node = &ast->nodes[stack[--top]];
+        reached++;
+        for (uint32_t i = 0; i < node->child_count; i++) {
+            PolycallASTIndex child = ast->links[node->first_child + i];
+            if (child < ast->node_count && !seen[child]) {
+                seen[child] = 1;
+                stack[top++] = child;
+            }
+        }
     }
     
-    return node;
+    free(stack);
+    return reached;
 }
 
 PolycallAST* polycall_ast_optimize(const PolycallAST* ast, uint32_t level) {
-    if (!ast || !ast->root) return NULL;
-    
-    // Create optimized copy of AST
-    PolycallAST* optimized = calloc(1, sizeof(PolycallAST));
-    if (!optimized) return NULL;
-    
-    // Copy and optimize nodes
-    optimized->capacity = ast->capacity;
-    optimized->nodes = calloc(optimized->capacity, sizeof(PolycallASTNode*));
-    if (!optimized->nodes) {
-        free(optimized);
+    if (!ast || ast->root >= ast->node_count) return NULL;
+    
+    CopyPass pass = { .level = level };
+    PolycallAST* work = copy_tree(ast, &pass);
+    if (!work) return NULL;
+    
+    uint32_t input = count_reachable(ast);
+    uint32_t collapsed = work->node_count;
+    if (level >= 2) fold_constants(work);
+    uint32_t folded = level >= 2 ? count_reachable(work) : collapsed;
+    if (level >= 3) prune_branches(work);
+    uint32_t pruned = level >= 3 ? count_reachable(work) : folded;
+    if (level >= 3 && !share_subexpressions(work)) {
+        polycall_ast_destroy(work);
         return NULL;
     }
-    
-    // Deep copy and optimize root node
-    optimized->root = optimize_node(polycall_ast_create_node(ast->root->type, &ast->root->value), level);
-    if (!optimized->root) {
-        free(optimized->nodes);
-        free(optimized);
-        return NULL;
+    uint32_t shared = level >= 3 ? count_reachable(work) : pruned;
+    
+    // Rewrites left unreachable nodes behind; copying drops them
+    PolycallAST* optimized = work;
+    if (level >= 2) {
+        CopyPass compact = { .level = 0 };
+        optimized = copy_tree(work, &compact);
+        polycall_ast_destroy(work);
+        if (!optimized) return NULL;
     }
     
-    // Build optimized node array
-    polycall_ast_visit(optimized->root, collect_optimized_node, optimized);
-    
+    optimized->optimize_stats.input = input;
+    optimized->optimize_stats.collapsed = collapsed;
+    optimized->optimize_stats.folded = folded;
+    optimized->optimize_stats.pruned = pruned;
+    optimized->optimize_stats.shared = shared;
     return optimized;
 }
 
-// Tree manipulation helpers
-bool polycall_ast_add_child(PolycallASTNode* parent, PolycallASTNode* child) {
-    if (!parent || !child) return false;
-    
-    // Resize children array if needed
-    size_t new_size = parent->child_count + 1;
-    PolycallASTNode** new_children = realloc(parent->children,
-                                            new_size * sizeof(PolycallASTNode*));
-    
-    if (!new_children) return false;
-    
-    parent->children = new_children;
-    parent->children[parent->child_count++] = child;
-    child->parent = parent;
-    
-    return true;
-}
-
 // Node attribute manipulation
 void polycall_ast_set_attributes(PolycallASTNode* node, PolycallASTAttributes attrs) {
     if (node) {
@@ -672,4 +1241,4 @@ void polycall_ast_get_location(const PolycallASTNode* node, uint32_t* line, uint
         *line = node->line;
         *column = node->column;
     }
-}
\ No newline at end of file
+}
@@ -1,24 +1,91 @@
 #include "polycall_protocol.h"
+#include "polycall_checksum.h"
+#include "polycall_log.h"
+#include "polycall_metrics.h"
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
 
 #define MAX_ERROR_LENGTH 256
-#define PROTOCOL_BUFFER_SIZE 4096
 #define PROTOCOL_MAGIC 0x504C43 // "PLC"
 #define PROTOCOL_TIMEOUT_MS 5000
 #define MAX_SEQUENCE_NUMBER 0xFFFFFFFF
+#define SHM_POLL_BATCH 256  // Frames dispatched per poll, so one peer cannot hog it
 
 // Internal protocol error states
 static char protocol_error_buffer[MAX_ERROR_LENGTH] = {0};
 
-// Internal protocol context structure
+// Internal protocol state, reached through polycall_protocol_context_t.internal
 typedef struct {
-    polycall_protocol_context_t base;  // Base context
     polycall_protocol_callbacks_t callbacks;  // Callback functions
     char last_error[MAX_ERROR_LENGTH];  // Error buffer
+    size_t max_message_size;  // Largest payload accepted
+    
+    // Frame decoder: a frame split across reads is carried here
+    uint8_t header_bytes[sizeof(polycall_message_header_t)];  // Partial header
+    size_t header_length;  // Bytes in header_bytes
+    NetworkBuffer* frame;  // Whole frame once its header is known
+    
+    uint16_t local_capabilities;  // Offered in our handshake
+    uint16_t capabilities;  // Offered by both sides
+    uint64_t handshake_sent_ns;  // Until the peer's handshake arrives
+    
+    // Shared-memory transport: ours while offered, then used both ways
+    NetworkShm* shm;
+    uint64_t shm_token;  // Token of the region we offered
+    bool shm_send;  // Our frames go to the ring
+    bool shm_recv;  // The peer's frames come from the ring
 } protocol_context_internal_t;
 
+// Handshake payload; padding is zeroed before it goes on the wire
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint16_t flags;  // POLYCALL_CAP_* offered by the sender
+} protocol_handshake_t;
+
+// POLYCALL_MSG_SHM payload. The creator offers; the peer answers with
+// ACCEPT as its last socket frame or with REFUSE; the creator then sends
+// SWITCH as its last. Each side reads the ring once the other's last
+// socket frame is in.
+typedef enum {
+    SHM_OP_OFFER = 1,
+    SHM_OP_ACCEPT = 2,
+    SHM_OP_REFUSE = 3,
+    SHM_OP_SWITCH = 4
+} protocol_shm_op_t;
+
+typedef struct {
+    uint32_t op;  // protocol_shm_op_t
+    uint32_t reserved;
+    NetworkShmOffer offer;  // SHM_OP_OFFER only
+} protocol_shm_t;
+
+#define BATCH_INITIAL_SIZE 4096
+
+static protocol_context_internal_t* internal_of(const polycall_protocol_context_t* ctx) {
+    return (protocol_context_internal_t*)ctx->internal;
+}
+
+// Continue a checksum over the next piece of a payload
+static uint32_t checksum_update(uint32_t checksum, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    
+    for (size_t i = 0; i < length; i++) {
+        checksum = ((checksum << 5) | (checksum >> 27)) + bytes[i];
+    }
+    
+    return checksum;
+}
+
+// Drop a partially decoded frame
+static void reset_decoder(protocol_context_internal_t* internal_ctx) {
+    net_buffer_release(internal_ctx->frame);
+    internal_ctx->frame = NULL;
+    internal_ctx->header_length = 0;
+}
+
 // Internal protocol error states
 // Protocol message validation helper
 static bool validate_message_header(const polycall_message_header_t* header) {
@@ -29,13 +96,15 @@ static bool validate_message_header(const polycall_message_header_t* header) {
         snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
                 "Protocol version mismatch: expected %d, got %d",
                 POLYCALL_PROTOCOL_VERSION, header->version);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
         return false;
     }
     
     // Validate message type
-    if (header->type < POLYCALL_MSG_HANDSHAKE || header->type > POLYCALL_MSG_HEARTBEAT) {
+    if (header->type < POLYCALL_MSG_HANDSHAKE || header->type > POLYCALL_MSG_SHM) {
         snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
                 "Invalid message type: %d", header->type);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
         return false;
     }
     
@@ -44,12 +113,12 @@ static bool validate_message_header(const polycall_message_header_t* header) {
 
 // Protocol state transition helper
 static bool transition_protocol_state(
-    protocol_context_internal_t* ctx,
+    polycall_protocol_context_t* ctx,
     polycall_protocol_state_t new_state
 ) {
-    if (!ctx || !ctx->base.state_machine) return false;
+    if (!ctx || !ctx->state_machine || !ctx->internal) return false;
     
-    polycall_protocol_state_t old_state = ctx->base.state;
+    polycall_protocol_state_t old_state = ctx->state;
     const char* transition_name = NULL;
     
     // Determine appropriate transition
@@ -74,21 +143,57 @@ static bool transition_protocol_state(
     }
     
     // Execute state machine transition
-    if (polycall_sm_execute_transition(ctx->base.state_machine, transition_name) 
+    if (polycall_sm_execute_transition(ctx->state_machine, transition_name) 
         != POLYCALL_SM_SUCCESS) {
+        POLYCALL_LOG_WARN("protocol", "Transition %s from state %d failed",
+                          transition_name, old_state);
         return false;
     }
     
-    ctx->base.state = new_state;
+    ctx->state = new_state;
+    POLYCALL_LOG_DEBUG("protocol", "State %d -> %d", old_state, new_state);
     
     // Notify state change
-    if (ctx->base.state != old_state && ctx->callbacks.on_state_change) {
-        ctx->callbacks.on_state_change(&ctx->base, old_state, new_state);
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    if (ctx->state != old_state && internal_ctx->callbacks.on_state_change) {
+        internal_ctx->callbacks.on_state_change(ctx, old_state, new_state);
     }
     
     return true;
 }
 
+// States in polycall_protocol_state_t order, so a state's ID is its value
+static polycall_sm_status_t define_protocol_states(PolyCall_StateMachine* sm) {
+    static const char* const states[] = {
+        "INIT", "HANDSHAKE", "AUTH", "READY", "ERROR", "CLOSED"
+    };
+    static const struct {
+        const char* name;
+        polycall_protocol_state_t from;
+        polycall_protocol_state_t to;
+    } transitions[] = {
+        {POLYCALL_TRANSITION_TO_HANDSHAKE, POLYCALL_STATE_INIT, POLYCALL_STATE_HANDSHAKE},
+        {POLYCALL_TRANSITION_TO_AUTH, POLYCALL_STATE_HANDSHAKE, POLYCALL_STATE_AUTH},
+        {POLYCALL_TRANSITION_TO_READY, POLYCALL_STATE_AUTH, POLYCALL_STATE_READY},
+        {POLYCALL_TRANSITION_TO_ERROR, POLYCALL_STATE_HANDSHAKE, POLYCALL_STATE_ERROR},
+        {POLYCALL_TRANSITION_TO_ERROR, POLYCALL_STATE_AUTH, POLYCALL_STATE_ERROR},
+        {POLYCALL_TRANSITION_TO_ERROR, POLYCALL_STATE_READY, POLYCALL_STATE_ERROR},
+        {POLYCALL_TRANSITION_TO_CLOSED, POLYCALL_STATE_READY, POLYCALL_STATE_CLOSED},
+        {POLYCALL_TRANSITION_TO_CLOSED, POLYCALL_STATE_ERROR, POLYCALL_STATE_CLOSED}
+    };
+    
+    polycall_sm_status_t status = POLYCALL_SM_SUCCESS;
+    for (size_t i = 0; status == POLYCALL_SM_SUCCESS && i < sizeof(states) / sizeof(states[0]); i++) {
+        status = polycall_sm_add_state(sm, states[i], NULL, NULL, i == POLYCALL_STATE_CLOSED);
+    }
+    for (size_t i = 0; status == POLYCALL_SM_SUCCESS &&
+                       i < sizeof(transitions) / sizeof(transitions[0]); i++) {
+        status = polycall_sm_add_transition(sm, transitions[i].name, transitions[i].from,
+                                            transitions[i].to, NULL, NULL);
+    }
+    return status;
+}
+
 // Initialize protocol context
 bool polycall_protocol_init(
     polycall_protocol_context_t* ctx,
@@ -104,44 +209,55 @@ bool polycall_protocol_init(
     protocol_context_internal_t* internal_ctx = calloc(1, sizeof(protocol_context_internal_t));
     if (!internal_ctx) {
         snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Memory allocation failed");
+        POLYCALL_LOG_ERROR("protocol", "%s", protocol_error_buffer);
         return false;
     }
 
     // Initialize base context
-    internal_ctx->base.pc_ctx = pc_ctx;
-    internal_ctx->base.endpoint = endpoint;
-    internal_ctx->base.state = POLYCALL_STATE_INIT;
-    internal_ctx->base.next_sequence = 1;
-    internal_ctx->base.user_data = config->user_data;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->pc_ctx = pc_ctx;
+    ctx->endpoint = endpoint;
+    ctx->state = POLYCALL_STATE_INIT;
+    ctx->next_sequence = 1;
+    ctx->user_data = config->user_data;
     
     // Copy callbacks
     memcpy(&internal_ctx->callbacks, &config->callbacks, sizeof(polycall_protocol_callbacks_t));
+    internal_ctx->max_message_size = config->max_message_size
+        ? config->max_message_size : POLYCALL_PROTOCOL_DEFAULT_MAX_MESSAGE;
+    internal_ctx->local_capabilities = config->capabilities &
+        (POLYCALL_CAP_PIPELINE | POLYCALL_CAP_BATCH | POLYCALL_CAP_CRC32C |
+         POLYCALL_CAP_LOCAL_UNCHECKED | POLYCALL_CAP_SHARED_MEMORY);
     
     // Initialize state machine
     polycall_sm_status_t sm_status = polycall_sm_create_with_integrity(
         pc_ctx,
-        &internal_ctx->base.state_machine,
+        &ctx->state_machine,
         NULL  // No integrity check for now
     );
+    if (sm_status == POLYCALL_SM_SUCCESS) {
+        sm_status = define_protocol_states(ctx->state_machine);
+        if (sm_status != POLYCALL_SM_SUCCESS) {
+            polycall_sm_destroy(ctx->state_machine);
+            ctx->state_machine = NULL;
+        }
+    }
     
     if (sm_status != POLYCALL_SM_SUCCESS) {
         snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
                 "Failed to create protocol state machine");
+        POLYCALL_LOG_ERROR("protocol", "%s", protocol_error_buffer);
         free(internal_ctx);
         return false;
     }
     
-    // Copy internal context back to provided context
-    memcpy(ctx, &internal_ctx->base, sizeof(polycall_protocol_context_t));
-    
+    ctx->internal = internal_ctx;
     return true;
 }
 
 void polycall_protocol_cleanup(polycall_protocol_context_t* ctx) {
     if (!ctx) return;
     
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    
     // Clean up state machine
     if (ctx->state_machine) {
         polycall_sm_destroy(ctx->state_machine);
@@ -149,106 +265,489 @@ void polycall_protocol_cleanup(polycall_protocol_context_t* ctx) {
     }
     
     // Clean up context
-    free(internal_ctx);
+    if (ctx->internal) {
+        reset_decoder(internal_of(ctx));
+        net_shm_destroy(internal_of(ctx)->shm);
+    }
+    free(ctx->internal);
+    ctx->internal = NULL;
 }
 
-// Protocol message handling
-bool polycall_protocol_send(
+// Send header and payload with one gathered write. The payload is either
+// flat or a buffer chain.
+static bool send_frame(
     polycall_protocol_context_t* ctx,
     polycall_message_type_t type,
+    uint32_t sequence,
     const void* payload,
+    const NetworkBuffer* chain,
     size_t payload_length,
     polycall_protocol_flags_t flags
 ) {
-    if (!ctx || !ctx->endpoint || !payload || payload_length == 0) {
+    if (payload_length > UINT32_MAX) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
+                "Message too large: %zu bytes", payload_length);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
         return false;
     }
     
+    // Pick the checksum the peer agreed to; the ring needs none
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    uint16_t capabilities = internal_ctx->capabilities;
+    bool unchecked = (capabilities & POLYCALL_CAP_LOCAL_UNCHECKED) || internal_ctx->shm_send;
+    bool crc32c = capabilities & POLYCALL_CAP_CRC32C;
+    if (unchecked) {
+        flags |= POLYCALL_FLAG_UNCHECKED;
+    } else if (crc32c) {
+        flags |= POLYCALL_FLAG_CRC32C;
+    }
+    
     // Create message header
     polycall_message_header_t header = {
         .version = POLYCALL_PROTOCOL_VERSION,
         .type = type,
-        .flags = flags,
-        .sequence = ctx->next_sequence++,
-        .payload_length = payload_length,
+        .flags = (uint16_t)flags,
+        .sequence = sequence,
+        .payload_length = (uint32_t)payload_length,
         .checksum = 0
     };
     
-    // Calculate checksum
-    header.checksum = polycall_protocol_calculate_checksum(payload, payload_length);
-    
-    // Prepare network packet
-    uint8_t buffer[PROTOCOL_BUFFER_SIZE];
+    // Header and payload go out together without being concatenated
+    struct iovec iov[NET_SEND_IOV_MAX];
+    int count = 0;
+    iov[count].iov_base = &header;
+    iov[count++].iov_len = sizeof(header);
+    if (chain) {
+        for (; chain && count < NET_SEND_IOV_MAX; chain = chain->next) {
+            if (chain->length == 0) continue;
+            if (!unchecked) {
+                header.checksum = crc32c
+                    ? polycall_crc32c(header.checksum, chain->data, chain->length)
+                    : checksum_update(header.checksum, chain->data, chain->length);
+            }
+            iov[count].iov_base = (void*)chain->data;
+            iov[count++].iov_len = chain->length;
+        }
+        if (chain) {
+            snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Message has too many pieces");
+            POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+            return false;
+        }
+    } else {
+        if (!unchecked) {
+            header.checksum = crc32c ? polycall_crc32c(0, payload, payload_length)
+                                     : checksum_update(0, payload, payload_length);
+        }
+        iov[count].iov_base = (void*)payload;
+        iov[count++].iov_len = payload_length;
+    }
     
-    // Copy header and payload to buffer
     size_t total_size = sizeof(header) + payload_length;
-    if (total_size > PROTOCOL_BUFFER_SIZE) {
-        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
-                "Message too large: %zu bytes", total_size);
+    POLYCALL_LOG_TRACE("protocol", "Send type %d seq %u, %zu bytes",
+                       type, sequence, payload_length);
+    
+    if (internal_ctx->shm_send) {
+        if (net_shm_sendv(internal_ctx->shm, iov, count, PROTOCOL_TIMEOUT_MS)) {
+            polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_FRAMES_OUT);
+            return true;
+        }
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Shared-memory send failed: %s",
+                 strerror(errno));
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+        return false;
+    }
+    if (net_sendv(ctx->endpoint, iov, count) != (ssize_t)total_size) return false;
+    polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_FRAMES_OUT);
+    return true;
+}
+
+// Protocol message handling
+bool polycall_protocol_send(
+    polycall_protocol_context_t* ctx,
+    polycall_message_type_t type,
+    const void* payload,
+    size_t payload_length,
+    polycall_protocol_flags_t flags
+) {
+    if (!ctx || !ctx->endpoint || !payload || payload_length == 0) {
         return false;
     }
     
-    memcpy(buffer, &header, sizeof(header));
-    memcpy(buffer + sizeof(header), payload, payload_length);
-    
-    NetworkPacket packet = {
-        .data = buffer,
-        .size = total_size,
-        .flags = 0
-    };
-    
-    return net_send(ctx->endpoint, &packet) == (ssize_t)total_size;
+    return send_frame(ctx, type, ctx->next_sequence++, payload, NULL, payload_length, flags);
 }
 
+uint32_t polycall_protocol_send_command(
+    polycall_protocol_context_t* ctx,
+    const void* command,
+    size_t length
+) {
+    if (!ctx || !ctx->endpoint || !command || length == 0) return 0;
+    
+    uint32_t sequence = ctx->next_sequence++;
+    if (sequence == 0) sequence = ctx->next_sequence++;  // 0 means failure
+    return send_frame(ctx, POLYCALL_MSG_COMMAND, sequence, command, NULL, length, 0)
+        ? sequence : 0;
+}
 
-bool polycall_protocol_process(
+bool polycall_protocol_respond(
     polycall_protocol_context_t* ctx,
-    const void* data,
+    uint32_t sequence,
+    const void* response,
     size_t length
 ) {
-    if (!ctx || !data || length < sizeof(polycall_message_header_t)) {
+    if (!ctx || !ctx->internal || !ctx->endpoint || !response || length == 0) return false;
+    
+    // A peer without pipelining cannot match responses to requests
+    if (!(internal_of(ctx)->capabilities & POLYCALL_CAP_PIPELINE)) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Pipelining not negotiated");
         return false;
     }
+    return send_frame(ctx, POLYCALL_MSG_RESPONSE, sequence, response, NULL, length, 0);
+}
+
+bool polycall_protocol_batch_begin(polycall_protocol_context_t* ctx, polycall_protocol_batch_t* batch) {
+    if (!ctx || !ctx->internal || !batch) return false;
+    memset(batch, 0, sizeof(*batch));
+    if (!(internal_of(ctx)->capabilities & POLYCALL_CAP_BATCH)) return false;
     
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    const polycall_message_header_t* header = (const polycall_message_header_t*)data;
-    const void* payload = (const uint8_t*)data + sizeof(polycall_message_header_t);
-    size_t payload_length = length - sizeof(polycall_message_header_t);
+    batch->payload = net_buffer_alloc(NULL, BATCH_INITIAL_SIZE);
+    if (!batch->payload) return false;
+    batch->ctx = ctx;
+    return true;
+}
+
+uint32_t polycall_protocol_batch_add(polycall_protocol_batch_t* batch, const void* command, size_t length) {
+    if (!batch || !batch->payload || !command || length == 0) return 0;
     
-    // Validate message
+    polycall_protocol_context_t* ctx = batch->ctx;
+    size_t queued = net_buffer_chain_length(batch->payload);
+    if (length > UINT32_MAX ||
+        queued + sizeof(polycall_batch_entry_t) + length > internal_of(ctx)->max_message_size) {
+        return 0;
+    }
+    
+    polycall_batch_entry_t entry = {
+        .sequence = ctx->next_sequence++,
+        .length = (uint32_t)length
+    };
+    if (entry.sequence == 0) entry.sequence = ctx->next_sequence++;
+    if (!net_buffer_append(batch->payload, &entry, sizeof(entry)) ||
+        !net_buffer_append(batch->payload, command, length)) {
+        return 0;
+    }
+    batch->count++;
+    return entry.sequence;
+}
+
+bool polycall_protocol_batch_send(polycall_protocol_batch_t* batch) {
+    if (!batch || !batch->payload) return false;
+    
+    bool sent = true;
+    if (batch->count > 0) {
+        polycall_protocol_context_t* ctx = batch->ctx;
+        sent = send_frame(ctx, POLYCALL_MSG_BATCH, ctx->next_sequence++, NULL, batch->payload,
+                          net_buffer_chain_length(batch->payload), 0);
+    }
+    polycall_protocol_batch_discard(batch);
+    return sent;
+}
+
+void polycall_protocol_batch_discard(polycall_protocol_batch_t* batch) {
+    if (!batch) return;
+    net_buffer_release(batch->payload);
+    memset(batch, 0, sizeof(*batch));
+}
+
+uint16_t polycall_protocol_capabilities(const polycall_protocol_context_t* ctx) {
+    return ctx && ctx->internal ? internal_of(ctx)->capabilities : 0;
+}
+
+
+// Reject a header before anything is buffered for it
+static bool check_frame_header(
+    protocol_context_internal_t* internal_ctx,
+    const polycall_message_header_t* header
+) {
     if (!validate_message_header(header)) {
+        polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_BAD_FRAMES);
+        return false;
+    }
+    if (header->payload_length > internal_ctx->max_message_size) {
+        polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_BAD_FRAMES);
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
+                "Message too large: %u bytes, limit %zu",
+                header->payload_length, internal_ctx->max_message_size);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+        return false;
+    }
+    return true;
+}
+
+// Checksums are only worth skipping when the bytes never leave the host
+static bool endpoint_is_local(const NetworkEndpoint* endpoint) {
+    if (!endpoint || endpoint->socket_fd <= 0) return false;
+    
+    struct sockaddr_storage peer;
+    socklen_t length = sizeof(peer);
+    memset(&peer, 0, sizeof(peer));
+    if (getpeername(endpoint->socket_fd, (struct sockaddr*)&peer, &length) != 0) {
+        return false;
+    }
+    switch (peer.ss_family) {
+#ifdef AF_UNIX
+        case AF_UNIX:
+            return true;
+#endif
+        case AF_INET: {
+            const struct sockaddr_in* in = (const struct sockaddr_in*)&peer;
+            return (ntohl(in->sin_addr.s_addr) >> 24) == 127;
+        }
+        case AF_INET6: {
+            const struct sockaddr_in6* in6 = (const struct sockaddr_in6*)&peer;
+            return IN6_IS_ADDR_LOOPBACK(&in6->sin6_addr) ||
+                   (IN6_IS_ADDR_V4MAPPED(&in6->sin6_addr) && in6->sin6_addr.s6_addr[12] == 127);
+        }
+        default:
+            return false;
+    }
+}
+
+// What our handshake offers; the same-host extensions are withdrawn off-host
+static uint16_t offered_capabilities(const polycall_protocol_context_t* ctx) {
+    const uint16_t local_only = POLYCALL_CAP_LOCAL_UNCHECKED | POLYCALL_CAP_SHARED_MEMORY;
+    uint16_t capabilities = internal_of(ctx)->local_capabilities;
+    if ((capabilities & local_only) && !endpoint_is_local(ctx->endpoint)) {
+        capabilities &= ~local_only;
+    }
+    return capabilities;
+}
+
+// Take note of what the peer offered. A peer whose version we do not
+// accept gets the base protocol only.
+static void record_peer_handshake(
+    polycall_protocol_context_t* ctx,
+    const void* payload,
+    size_t payload_length
+) {
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    protocol_handshake_t handshake;
+    if (payload_length < sizeof(handshake)) {
+        internal_ctx->capabilities = 0;
+        return;
+    }
+    memcpy(&handshake, payload, sizeof(handshake));
+    if (handshake.magic != PROTOCOL_MAGIC ||
+        !polycall_protocol_version_compatible(handshake.version)) {
+        POLYCALL_LOG_WARN("protocol", "Peer handshake version %d not compatible, extensions off",
+                          handshake.version);
+        internal_ctx->capabilities = 0;
+        return;
+    }
+    uint16_t offered = offered_capabilities(ctx);
+    internal_ctx->capabilities = offered & handshake.flags;
+    POLYCALL_LOG_DEBUG("protocol", "Capabilities offered 0x%x, peer 0x%x, using 0x%x",
+                       offered, handshake.flags, internal_ctx->capabilities);
+}
+
+// Hand one command to the handler, timing it
+static void run_command(polycall_protocol_context_t* ctx, const void* command, size_t length) {
+    uint64_t started = polycall_metrics_now_ns();
+    internal_of(ctx)->callbacks.on_command(ctx, command, length);
+    polycall_metrics_observe(POLYCALL_METRIC_PROTOCOL_COMMAND_NS,
+                             polycall_metrics_now_ns() - started);
+}
+
+// Walk the entries of a batch frame; the whole frame is checked first so
+// a malformed one runs no commands
+static bool dispatch_batch(
+    polycall_protocol_context_t* ctx,
+    const void* payload,
+    size_t payload_length
+) {
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    const uint8_t* bytes = payload;
+    polycall_batch_entry_t entry;
+    
+    for (size_t offset = 0; offset < payload_length; offset += sizeof(entry) + entry.length) {
+        if (payload_length - offset < sizeof(entry)) return false;
+        memcpy(&entry, bytes + offset, sizeof(entry));
+        if (entry.length > payload_length - offset - sizeof(entry)) {
+            snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Malformed batch frame");
+            polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_BAD_FRAMES);
+            POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+            return false;
+        }
+    }
+    
+    for (size_t offset = 0; offset < payload_length; offset += sizeof(entry) + entry.length) {
+        memcpy(&entry, bytes + offset, sizeof(entry));
+        ctx->current_sequence = entry.sequence;
+        if (internal_ctx->callbacks.on_command) {
+            run_command(ctx, (const char*)bytes + offset + sizeof(entry), entry.length);
+        }
+    }
+    return true;
+}
+
+static bool send_shm_message(polycall_protocol_context_t* ctx, protocol_shm_op_t op,
+                             const NetworkShmOffer* offer) {
+    protocol_shm_t message;
+    memset(&message, 0, sizeof(message));
+    message.op = op;
+    if (offer) message.offer = *offer;
+    return send_frame(ctx, POLYCALL_MSG_SHM, ctx->next_sequence++, &message, NULL,
+                      sizeof(message), POLYCALL_FLAG_RELIABLE);
+}
+
+// One step of the shared-memory setup described at protocol_shm_op_t
+static bool handle_shm_message(
+    polycall_protocol_context_t* ctx,
+    const void* payload,
+    size_t payload_length
+) {
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    protocol_shm_t message;
+    if (!(internal_ctx->capabilities & POLYCALL_CAP_SHARED_MEMORY) ||
+        payload_length < sizeof(message)) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Shared memory not negotiated");
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
         return false;
     }
+    memcpy(&message, payload, sizeof(message));
+    bool offering = internal_ctx->shm && !internal_ctx->shm_send && !internal_ctx->shm_recv;
+    
+    switch (message.op) {
+        case SHM_OP_OFFER: {
+            // Both sides offered at once: the lower token wins
+            if (offering && internal_ctx->shm_token < message.offer.token) {
+                return send_shm_message(ctx, SHM_OP_REFUSE, NULL);
+            }
+            if (offering) {
+                net_shm_destroy(internal_ctx->shm);
+                internal_ctx->shm = NULL;
+            } else if (internal_ctx->shm) {
+                return send_shm_message(ctx, SHM_OP_REFUSE, NULL);
+            }
+            
+            NetworkShm* shm = net_shm_attach(&message.offer);
+            if (!shm) {
+                POLYCALL_LOG_INFO("protocol", "Cannot attach to peer's shared memory: %s",
+                                  strerror(errno));
+                return send_shm_message(ctx, SHM_OP_REFUSE, NULL);
+            }
+            if (!send_shm_message(ctx, SHM_OP_ACCEPT, NULL)) {
+                net_shm_destroy(shm);
+                return false;
+            }
+            internal_ctx->shm = shm;
+            internal_ctx->shm_send = true;
+            return true;
+        }
+        
+        case SHM_OP_ACCEPT:
+            if (!offering) break;
+            internal_ctx->shm_recv = true;
+            net_shm_seal(internal_ctx->shm);
+            if (!send_shm_message(ctx, SHM_OP_SWITCH, NULL)) return false;
+            internal_ctx->shm_send = true;
+            POLYCALL_LOG_DEBUG("protocol", "Using shared memory");
+            return true;
+            
+        case SHM_OP_REFUSE:
+            // Also the answer to an offer we withdrew, which is already gone
+            if (offering) {
+                net_shm_destroy(internal_ctx->shm);
+                internal_ctx->shm = NULL;
+            }
+            return true;
+            
+        case SHM_OP_SWITCH:
+            if (!internal_ctx->shm_send || internal_ctx->shm_recv) break;
+            internal_ctx->shm_recv = true;
+            POLYCALL_LOG_DEBUG("protocol", "Using shared memory");
+            return true;
+            
+        default:
+            break;
+    }
     
-    // Verify checksum
-    if (!polycall_protocol_verify_checksum(header, payload, payload_length)) {
+    snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Unexpected shared-memory message %u",
+             message.op);
+    POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+    return false;
+}
+
+// Verify and dispatch one complete message; from_ring frames need no checksum
+static bool dispatch_message(
+    polycall_protocol_context_t* ctx,
+    const polycall_message_header_t* header,
+    const void* payload,
+    bool from_ring
+) {
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    size_t payload_length = header->payload_length;
+    
+    // Verify checksum; an unchecked frame is only taken when we agreed to it
+    if (header->flags & POLYCALL_FLAG_UNCHECKED) {
+        if (!from_ring && !(internal_ctx->capabilities & POLYCALL_CAP_LOCAL_UNCHECKED)) {
+            snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Unchecked frame not negotiated");
+            POLYCALL_LOG_WARN("protocol", "Unchecked frame seq %u not negotiated", header->sequence);
+            return false;
+        }
+    } else if (!polycall_protocol_verify_checksum(header, payload, payload_length)) {
+        polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_CHECKSUM_FAILURES);
         snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Checksum verification failed");
+        POLYCALL_LOG_WARN("protocol", "Checksum verification failed for seq %u", header->sequence);
         return false;
     }
+    POLYCALL_LOG_TRACE("protocol", "Received type %d seq %u, %zu bytes",
+                       header->type, header->sequence, payload_length);
+    polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_FRAMES_IN);
     
     // Process message based on type
     switch (header->type) {
         case POLYCALL_MSG_HANDSHAKE:
+            if (internal_ctx->handshake_sent_ns) {
+                polycall_metrics_observe(POLYCALL_METRIC_PROTOCOL_HANDSHAKE_NS,
+                                         polycall_metrics_now_ns() - internal_ctx->handshake_sent_ns);
+                internal_ctx->handshake_sent_ns = 0;
+            }
+            record_peer_handshake(ctx, payload, payload_length);
             if (internal_ctx->callbacks.on_handshake) {
-                internal_ctx->callbacks.on_handshake(&internal_ctx->base);
+                internal_ctx->callbacks.on_handshake(ctx);
             }
             break;
             
         case POLYCALL_MSG_AUTH:
             if (internal_ctx->callbacks.on_auth_request) {
-                internal_ctx->callbacks.on_auth_request(&internal_ctx->base, payload);
+                internal_ctx->callbacks.on_auth_request(ctx, payload);
             }
             break;
             
         case POLYCALL_MSG_COMMAND:
+            ctx->current_sequence = header->sequence;
             if (internal_ctx->callbacks.on_command) {
-                internal_ctx->callbacks.on_command(&internal_ctx->base, payload, payload_length);
+                run_command(ctx, payload, payload_length);
+            }
+            break;
+            
+        case POLYCALL_MSG_BATCH:
+            if (!(internal_ctx->local_capabilities & POLYCALL_CAP_BATCH)) {
+                snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Batch frame not negotiated");
+                POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+                return false;
+            }
+            return dispatch_batch(ctx, payload, payload_length);
+            
+        case POLYCALL_MSG_RESPONSE:
+            if (internal_ctx->callbacks.on_response) {
+                internal_ctx->callbacks.on_response(ctx, header->sequence, payload, payload_length);
             }
             break;
             
         case POLYCALL_MSG_ERROR:
             if (internal_ctx->callbacks.on_error) {
-                internal_ctx->callbacks.on_error(&internal_ctx->base, payload);
+                internal_ctx->callbacks.on_error(ctx, payload);
             }
             break;
             
@@ -256,6 +755,9 @@ bool polycall_protocol_process(
             // Process heartbeat
             break;
             
+        case POLYCALL_MSG_SHM:
+            return handle_shm_message(ctx, payload, payload_length);
+            
         default:
             return false;
     }
@@ -263,11 +765,219 @@ bool polycall_protocol_process(
     return true;
 }
 
+// Check and dispatch a frame held whole in memory
+static bool process_frame(
+    polycall_protocol_context_t* ctx,
+    const void* data,
+    size_t length,
+    bool from_ring
+) {
+    if (length < sizeof(polycall_message_header_t)) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Truncated message: %zu bytes", length);
+        polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_BAD_FRAMES);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+        return false;
+    }
+    
+    // The header may sit at any offset in a receive buffer
+    polycall_message_header_t header;
+    memcpy(&header, data, sizeof(header));
+    const void* payload = (const uint8_t*)data + sizeof(polycall_message_header_t);
+    
+    // Validate message
+    if (!check_frame_header(internal_of(ctx), &header)) {
+        return false;
+    }
+    if (length - sizeof(header) != header.payload_length) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH,
+                "Payload length mismatch: header says %u, got %zu",
+                header.payload_length, length - sizeof(header));
+        polycall_metrics_inc(POLYCALL_METRIC_PROTOCOL_BAD_FRAMES);
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+        return false;
+    }
+    
+    return dispatch_message(ctx, &header, payload, from_ring);
+}
+
+bool polycall_protocol_process(
+    polycall_protocol_context_t* ctx,
+    const void* data,
+    size_t length
+) {
+    if (!ctx || !ctx->internal || !data || length < sizeof(polycall_message_header_t)) {
+        return false;
+    }
+    return process_frame(ctx, data, length, false);
+}
+
+// Frames that lie wholly inside the packet are dispatched in place. Only a
+// frame cut off by the end of a read is copied, into a buffer sized from
+// its header, and finished from the reads that follow.
+bool polycall_protocol_process_packet(
+    polycall_protocol_context_t* ctx,
+    NetworkPacket* packet
+) {
+    if (!ctx || !ctx->internal || !packet || (!packet->data && packet->size > 0)) {
+        return false;
+    }
+    
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    const size_t header_size = sizeof(polycall_message_header_t);
+    const uint8_t* bytes = packet->data;
+    size_t left = packet->size;
+    NetworkBuffer* previous = ctx->current_buffer;
+    polycall_message_header_t header;
+    bool ok = true;
+    
+    while (ok && left > 0) {
+        bool carried = internal_ctx->frame || internal_ctx->header_length > 0;
+        
+        if (!carried && left >= header_size) {
+            memcpy(&header, bytes, header_size);
+            if (!check_frame_header(internal_ctx, &header)) {
+                ok = false;
+                break;
+            }
+            size_t frame_size = header_size + header.payload_length;
+            if (left >= frame_size) {
+                ctx->current_buffer = packet->buffer;
+                ok = dispatch_message(ctx, &header, bytes + header_size, false);
+                bytes += frame_size;
+                left -= frame_size;
+                continue;
+            }
+        }
+        
+        // Collect the header of a frame that spans reads
+        if (!internal_ctx->frame) {
+            size_t take = header_size - internal_ctx->header_length;
+            if (take > left) take = left;
+            memcpy(internal_ctx->header_bytes + internal_ctx->header_length, bytes, take);
+            internal_ctx->header_length += take;
+            bytes += take;
+            left -= take;
+            if (internal_ctx->header_length < header_size) break;
+            
+            memcpy(&header, internal_ctx->header_bytes, header_size);
+            if (!check_frame_header(internal_ctx, &header)) {
+                ok = false;
+                break;
+            }
+            internal_ctx->frame = net_buffer_alloc(NULL, header_size + header.payload_length);
+            if (!internal_ctx->frame) {
+                snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Memory allocation failed");
+                POLYCALL_LOG_ERROR("protocol", "%s", protocol_error_buffer);
+                ok = false;
+                break;
+            }
+            memcpy(internal_ctx->frame->data, &header, header_size);
+            internal_ctx->frame->length = header_size;
+            internal_ctx->header_length = 0;
+        }
+        
+        // Then its payload
+        NetworkBuffer* frame = internal_ctx->frame;
+        size_t take = frame->capacity - frame->length;
+        if (take > left) take = left;
+        memcpy(frame->data + frame->length, bytes, take);
+        frame->length += take;
+        bytes += take;
+        left -= take;
+        
+        if (frame->length == frame->capacity) {
+            internal_ctx->frame = NULL;
+            memcpy(&header, frame->data, header_size);
+            ctx->current_buffer = frame;
+            ok = dispatch_message(ctx, &header, frame->data + header_size, false);
+            net_buffer_release(frame);
+        }
+    }
+    
+    ctx->current_buffer = previous;
+    
+    // The stream cannot be resynchronized after a bad frame
+    if (!ok) reset_decoder(internal_ctx);
+    return ok;
+}
+
+size_t polycall_protocol_pending(const polycall_protocol_context_t* ctx) {
+    if (!ctx || !ctx->internal) return 0;
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    return internal_ctx->frame ? internal_ctx->frame->length : internal_ctx->header_length;
+}
+
+// Rings are sized so that any frame we accept fits in one
+bool polycall_protocol_offer_shm(polycall_protocol_context_t* ctx) {
+    if (!ctx || !ctx->internal) return false;
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    if (!(internal_ctx->capabilities & POLYCALL_CAP_SHARED_MEMORY) || internal_ctx->shm) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Shared memory not negotiated");
+        return false;
+    }
+    
+    size_t frame_size = sizeof(polycall_message_header_t) + internal_ctx->max_message_size;
+    NetworkShm* shm = net_shm_create(2 * (frame_size + sizeof(uint64_t)));
+    NetworkShmOffer offer;
+    if (!shm || !net_shm_offer(shm, &offer)) {
+        snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "Cannot create shared memory: %s",
+                 strerror(errno));
+        POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+        net_shm_destroy(shm);
+        return false;
+    }
+    
+    // Offered before the frame goes out, since the answer may be dispatched
+    // from another thread's read
+    internal_ctx->shm = shm;
+    internal_ctx->shm_token = offer.token;
+    if (!send_shm_message(ctx, SHM_OP_OFFER, &offer)) {
+        internal_ctx->shm = NULL;
+        net_shm_destroy(shm);
+        return false;
+    }
+    return true;
+}
+
+int polycall_protocol_poll_shm(polycall_protocol_context_t* ctx, int timeout_ms) {
+    if (!ctx || !ctx->internal) return -1;
+    protocol_context_internal_t* internal_ctx = internal_of(ctx);
+    if (!internal_ctx->shm_recv) return 0;
+    
+    NetworkShm* shm = internal_ctx->shm;
+    if (!net_shm_wait(shm, timeout_ms)) return 0;
+    
+    NetworkBuffer* previous = ctx->current_buffer;
+    ctx->current_buffer = NULL;
+    int dispatched = 0;
+    int result = 0;
+    while (dispatched < SHM_POLL_BATCH) {
+        size_t length;
+        const void* frame = net_shm_peek(shm, &length);
+        if (!frame) {
+            if (errno != EAGAIN) {
+                snprintf(protocol_error_buffer, MAX_ERROR_LENGTH, "%s",
+                         errno == EPIPE ? "Peer left shared memory" : "Corrupt shared-memory ring");
+                POLYCALL_LOG_WARN("protocol", "%s", protocol_error_buffer);
+                result = -1;
+            }
+            break;
+        }
+        bool ok = process_frame(ctx, frame, length, true);
+        net_shm_consume(shm);
+        if (!ok) {
+            result = -1;
+            break;
+        }
+        dispatched++;
+    }
+    ctx->current_buffer = previous;
+    return result < 0 ? -1 : dispatched;
+}
+
 void polycall_protocol_update(polycall_protocol_context_t* ctx) {
     if (!ctx) return;
     
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    
     // Process any pending state transitions
     switch (ctx->state) {
         case POLYCALL_STATE_INIT:
@@ -278,13 +988,13 @@ void polycall_protocol_update(polycall_protocol_context_t* ctx) {
             
         case POLYCALL_STATE_HANDSHAKE:
             if (polycall_protocol_can_transition(ctx, POLYCALL_STATE_AUTH)) {
-                transition_protocol_state(internal_ctx, POLYCALL_STATE_AUTH);
+                transition_protocol_state(ctx, POLYCALL_STATE_AUTH);
             }
             break;
             
         case POLYCALL_STATE_AUTH:
             if (polycall_protocol_can_transition(ctx, POLYCALL_STATE_READY)) {
-                transition_protocol_state(internal_ctx, POLYCALL_STATE_READY);
+                transition_protocol_state(ctx, POLYCALL_STATE_READY);
             }
             break;
             
@@ -332,35 +1042,29 @@ bool polycall_protocol_can_transition(
 }
 
 bool polycall_protocol_start_handshake(polycall_protocol_context_t* ctx) {
-    if (!ctx || ctx->state != POLYCALL_STATE_INIT) return false;
-    
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
+    if (!ctx || !ctx->internal || ctx->state != POLYCALL_STATE_INIT) return false;
     
     // Create handshake payload
-    struct {
-        uint32_t magic;
-        uint8_t version;
-        uint16_t flags;
-    } handshake = {
-        .magic = PROTOCOL_MAGIC,
-        .version = POLYCALL_PROTOCOL_VERSION,
-        .flags = 0
-    };
+    protocol_handshake_t handshake;
+    memset(&handshake, 0, sizeof(handshake));
+    handshake.magic = PROTOCOL_MAGIC;
+    handshake.version = POLYCALL_PROTOCOL_VERSION;
+    handshake.flags = offered_capabilities(ctx);
     
-    // Send handshake message
+    // Send handshake message, timed until the peer's arrives
+    internal_of(ctx)->handshake_sent_ns = polycall_metrics_now_ns();
     if (!polycall_protocol_send(ctx, POLYCALL_MSG_HANDSHAKE,
                                &handshake, sizeof(handshake),
                                POLYCALL_FLAG_RELIABLE)) {
         return false;
     }
     
-    return transition_protocol_state(internal_ctx, POLYCALL_STATE_HANDSHAKE);
+    return transition_protocol_state(ctx, POLYCALL_STATE_HANDSHAKE);
 }
 
 bool polycall_protocol_complete_handshake(polycall_protocol_context_t* ctx) {
     if (!ctx || ctx->state != POLYCALL_STATE_HANDSHAKE) return false;
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    return transition_protocol_state(internal_ctx, POLYCALL_STATE_AUTH);
+    return transition_protocol_state(ctx, POLYCALL_STATE_AUTH);
 }
 
 bool polycall_protocol_authenticate(
@@ -370,8 +1074,6 @@ bool polycall_protocol_authenticate(
 ) {
     if (!ctx || !credentials || credentials_length == 0) return false;
     
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    
     // Send authentication message
     if (!polycall_protocol_send(ctx, POLYCALL_MSG_AUTH,
                                credentials, credentials_length,
@@ -379,17 +1081,24 @@ bool polycall_protocol_authenticate(
         return false;
     }
     
-    return transition_protocol_state(internal_ctx, POLYCALL_STATE_READY);
+    return transition_protocol_state(ctx, POLYCALL_STATE_READY);
 }
 
 
 
 
+const char* polycall_protocol_get_error(const polycall_protocol_context_t* ctx) {
+    if (!ctx || !ctx->internal || internal_of(ctx)->last_error[0] == '\0') {
+        return protocol_error_buffer;
+    }
+    return internal_of(ctx)->last_error;
+}
+
 void polycall_protocol_set_error(polycall_protocol_context_t* ctx, const char* error) {
-    if (!ctx || !error) return;
-    protocol_context_internal_t* internal_ctx = (protocol_context_internal_t*)ctx;
-    snprintf(internal_ctx->last_error, MAX_ERROR_LENGTH, "%s", error);
-    transition_protocol_state(internal_ctx, POLYCALL_STATE_ERROR);
+    if (!ctx || !ctx->internal || !error) return;
+    snprintf(internal_of(ctx)->last_error, MAX_ERROR_LENGTH, "%s", error);
+    POLYCALL_LOG_WARN("protocol", "Protocol error: %s", error);
+    transition_protocol_state(ctx, POLYCALL_STATE_ERROR);
 }
 
 // Protocol utility functions
@@ -398,15 +1107,7 @@ uint32_t polycall_protocol_calculate_checksum(
     size_t length
 ) {
     if (!data || length == 0) return 0;
-    
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t checksum = 0;
-    
-    for (size_t i = 0; i < length; i++) {
-        checksum = ((checksum << 5) | (checksum >> 27)) + bytes[i];
-    }
-    
-    return checksum;
+    return checksum_update(0, data, length);
 }
 
 bool polycall_protocol_verify_checksum(
@@ -416,7 +1117,9 @@ bool polycall_protocol_verify_checksum(
 ) {
     if (!header || !payload || payload_length == 0) return false;
     
-    uint32_t calculated = polycall_protocol_calculate_checksum(payload, payload_length);
+    uint32_t calculated = (header->flags & POLYCALL_FLAG_CRC32C)
+        ? polycall_crc32c(0, payload, payload_length)
+        : polycall_protocol_calculate_checksum(payload, payload_length);
     return calculated == header->checksum;
 }
 
@@ -1,28 +1,36 @@
 #include "polycall_state_machine.h"
 #include "polycall.h"
+#include "polycall_checksum.h"
+#include "polycall_log.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
+
+// Concurrent-mode state word: version in the high half, state in the low
+#define WORD_STATE(word) ((unsigned int)((word) & 0xFFFFFFFFu))
+#define WORD_VERSION(word) ((uint32_t)((word) >> 32))
+#define PACK_WORD(state, version) (((uint64_t)(version) << 32) | (uint32_t)(state))
 
 // Define state callback functions
 static void on_init(polycall_context_t ctx __attribute__((unused))) {
-    fprintf(stderr, "State callback: System initialized\n");
+    POLYCALL_LOG_INFO("sm", "State callback: System initialized");
 }
 
 static void on_ready(polycall_context_t ctx __attribute__((unused))) {
-    fprintf(stderr, "State callback: System ready\n");
+    POLYCALL_LOG_INFO("sm", "State callback: System ready");
 }
 
 static void on_running(polycall_context_t ctx __attribute__((unused))) {
-    fprintf(stderr, "State callback: System running\n");
+    POLYCALL_LOG_INFO("sm", "State callback: System running");
 }
 
 static void on_paused(polycall_context_t ctx __attribute__((unused))) {
-    fprintf(stderr, "State callback: System paused\n");
+    POLYCALL_LOG_INFO("sm", "State callback: System paused");
 }
 
 static void on_error(polycall_context_t ctx __attribute__((unused))) {
-    fprintf(stderr, "State callback: System error\n");
+    POLYCALL_LOG_INFO("sm", "State callback: System error");
 }
 
 
@@ -103,21 +111,93 @@ static polycall_sm_status_t init_default_transitions(PolyCall_StateMachine* sm)
 
 
 // Utility functions
+// Covers the fields before checksum: what a transition never changes
 static inline uint32_t calculate_state_checksum(const PolyCall_State* state) {
-    uint32_t checksum = 0;
-    const uint8_t* data = (const uint8_t*)state;
-    size_t size = offsetof(PolyCall_State, checksum);
+    return polycall_crc32c(0, state, offsetof(PolyCall_State, checksum));
+}
+
+static uint32_t calculate_transition_checksum(const PolyCall_Transition* transition) {
+    struct {
+        unsigned int from_state;
+        unsigned int to_state;
+        PolyCall_StateAction action;
+        bool (*guard_condition)(const PolyCall_State*, const PolyCall_State*);
+        bool is_valid;
+    } covered;
+    memset(&covered, 0, sizeof(covered));
+    covered.from_state = transition->from_state;
+    covered.to_state = transition->to_state;
+    covered.action = transition->action;
+    covered.guard_condition = transition->guard_condition;
+    covered.is_valid = transition->is_valid;
     
-    for (size_t i = 0; i < size; i++) {
-        checksum = (checksum << 8) | (checksum >> 24);
-        checksum += data[i];
+    uint32_t checksum = polycall_crc32c(0, transition->name, sizeof(transition->name));
+    return polycall_crc32c(checksum, &covered, sizeof(covered));
+}
+
+// Contribution of one entry to machine_checksum; XOR lets an entry be
+// swapped out in O(1), and the position keeps equal entries apart
+static inline uint32_t machine_term(bool is_transition, unsigned int index, uint32_t checksum) {
+    uint32_t position = ((is_transition ? 1u : 0u) << 16 | index) * 0x9E3779B1u;
+    return (checksum * 0x85EBCA6Bu) ^ position;
+}
+
+static inline void replace_machine_term(PolyCall_StateMachine* sm, bool is_transition,
+                                        unsigned int index, uint32_t old_checksum,
+                                        uint32_t new_checksum) {
+    sm->machine_checksum ^= machine_term(is_transition, index, old_checksum) ^
+                            machine_term(is_transition, index, new_checksum);
+}
+
+static inline void count_violation(PolyCall_StateMachine* sm) {
+    __atomic_fetch_add(&sm->diagnostics.integrity_violations, 1, __ATOMIC_RELAXED);
+}
+
+// Hot-path check for the two states a transition touches
+static bool touched_states_intact(PolyCall_StateMachine* sm,
+                                  const PolyCall_State* from_state,
+                                  const PolyCall_State* to_state) {
+    if (!sm->integrity_check) return true;
+    if (calculate_state_checksum(from_state) != from_state->checksum ||
+        calculate_state_checksum(to_state) != to_state->checksum ||
+        !sm->integrity_check(from_state) || !sm->integrity_check(to_state)) {
+        count_violation(sm);
+        POLYCALL_LOG_ERROR("sm", "Integrity check failed between %s and %s",
+                           from_state->name, to_state->name);
+        return false;
     }
-    return checksum;
+    return true;
+}
+
+// The next machine snapshot has to copy these pages
+static inline void touch_state_page(PolyCall_StateMachine* sm, unsigned int state_id) {
+    __atomic_store_n(&sm->clean_state_page[state_id / POLYCALL_SM_PAGE_ENTRIES], NULL,
+                     __ATOMIC_RELAXED);
+}
+
+static inline void touch_transition_page(PolyCall_StateMachine* sm, unsigned int index) {
+    sm->clean_transition_page[index / POLYCALL_SM_PAGE_ENTRIES] = NULL;
 }
 
-static inline void update_state_timestamp(PolyCall_State* state) {
+static inline void update_state_timestamp(PolyCall_StateMachine* sm, PolyCall_State* state) {
     state->timestamp = (uint64_t)time(NULL);
     state->version++;
+    touch_state_page(sm, state->id);
+}
+
+// Slot for the calling thread; threads past POLYCALL_SM_THREAD_SLOTS share
+static PolyCall_ThreadCounters* thread_counters(PolyCall_StateMachine* sm) {
+    static _Atomic unsigned int next_slot = 0;
+    static _Thread_local unsigned int slot = UINT_MAX;
+    if (slot == UINT_MAX) {
+        slot = atomic_fetch_add_explicit(&next_slot, 1, memory_order_relaxed) %
+               POLYCALL_SM_THREAD_SLOTS;
+    }
+    return &sm->thread_counters[slot];
+}
+
+static inline void count(_Atomic uint64_t* counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
 }
 
 
@@ -131,26 +211,132 @@ polycall_sm_status_t polycall_sm_create_with_integrity(
 ) {
     if (!ctx || !sm) return POLYCALL_SM_ERROR_INVALID_CONTEXT;
     
-    *sm = (PolyCall_StateMachine*)calloc(1, sizeof(PolyCall_StateMachine));
+    // Aligned so each thread's counters get their own cache line
+    *sm = (PolyCall_StateMachine*)aligned_alloc(_Alignof(PolyCall_StateMachine),
+                                                sizeof(PolyCall_StateMachine));
     if (!*sm) return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    memset(*sm, 0, sizeof(PolyCall_StateMachine));
     
     (*sm)->ctx = ctx;
     (*sm)->is_initialized = true;
     (*sm)->integrity_check = integrity_check;
     (*sm)->diagnostics.last_verification = (uint64_t)time(NULL);
     (*sm)->machine_checksum = 0;
+    pthread_mutex_init(&(*sm)->audit_lock, NULL);
+    pthread_cond_init(&(*sm)->audit_wake, NULL);
     
     return POLYCALL_SM_SUCCESS;
 }
 
 void polycall_sm_destroy(PolyCall_StateMachine* sm) {
     if (sm) {
+        polycall_sm_stop_auditor(sm);
+        polycall_sm_release_machine_snapshot(sm->base_snapshot);
+        pthread_cond_destroy(&sm->audit_wake);
+        pthread_mutex_destroy(&sm->audit_lock);
         /* Clear sensitive data before freeing */
         memset(sm, 0, sizeof(PolyCall_StateMachine));
         free(sm);
     }
 }
 
+polycall_sm_status_t polycall_sm_create_from_static(
+    polycall_context_t ctx,
+    PolyCall_StateMachine** sm,
+    const PolyCall_StaticMachine* machine,
+    PolyCall_StateIntegrityCheck integrity_check
+) {
+    if (!sm) return POLYCALL_SM_ERROR_INVALID_CONTEXT;
+    if (!machine || machine->num_states > POLYCALL_MAX_STATES ||
+        machine->num_transitions > POLYCALL_MAX_TRANSITIONS ||
+        machine->num_events > machine->num_transitions ||
+        machine->initial_state >= machine->num_states) {
+        return POLYCALL_SM_ERROR_INVALID_STATE;
+    }
+
+    polycall_sm_status_t status = polycall_sm_create_with_integrity(ctx, sm, integrity_check);
+    if (status != POLYCALL_SM_SUCCESS) return status;
+
+    for (unsigned int i = 0; i < machine->num_states && status == POLYCALL_SM_SUCCESS; i++) {
+        const PolyCall_State* state = &machine->states[i];
+        status = polycall_sm_add_state(*sm, state->name, state->on_enter, state->on_exit,
+                                       state->is_final);
+    }
+    for (unsigned int i = 0; i < machine->num_transitions && status == POLYCALL_SM_SUCCESS; i++) {
+        const PolyCall_StaticTransition* transition = &machine->transitions[i];
+        status = transition->event_id < machine->num_events
+            ? polycall_sm_add_transition(*sm, transition->name, transition->from_state,
+                                         transition->to_state, transition->action,
+                                         transition->guard_condition)
+            : POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    }
+    if (status != POLYCALL_SM_SUCCESS) {
+        POLYCALL_LOG_ERROR("sm", "Static machine does not load: %d", (int)status);
+        polycall_sm_destroy(*sm);
+        *sm = NULL;
+        return status;
+    }
+
+    /* The generator interned the names already */
+    PolyCall_CompiledTable* table = &(*sm)->compiled;
+    memset(table->first, POLYCALL_SM_NO_TRANSITION, sizeof(table->first));
+    memset(table->next, POLYCALL_SM_NO_TRANSITION, sizeof(table->next));
+    table->num_events = machine->num_events;
+    for (unsigned int i = machine->num_transitions; i-- > 0;) {
+        (*sm)->transitions[i].event_id = machine->transitions[i].event_id;
+        table->first[machine->transitions[i].event_id] = (uint8_t)i;
+    }
+    for (unsigned int s = 0; s < machine->num_states; s++) {
+        memcpy(table->next[s], &machine->next[s * machine->num_events], machine->num_events);
+    }
+    table->is_compiled = true;
+
+    (*sm)->current_state = machine->initial_state;
+    atomic_store_explicit(&(*sm)->state_word, PACK_WORD(machine->initial_state, 0),
+                          memory_order_relaxed);
+    return POLYCALL_SM_SUCCESS;
+}
+
+polycall_sm_status_t polycall_sm_static_fire(
+    const PolyCall_StaticMachine* machine,
+    polycall_context_t ctx,
+    unsigned int* state,
+    unsigned int event_id
+) {
+    if (!machine || !state || *state >= machine->num_states) 
+        return POLYCALL_SM_ERROR_INVALID_STATE;
+    if (event_id >= machine->num_events) 
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+
+    uint8_t index = machine->next[*state * machine->num_events + event_id];
+    if (index == POLYCALL_SM_NO_TRANSITION) 
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+
+    const PolyCall_StaticTransition* transition = &machine->transitions[index];
+    const PolyCall_State* from_state = &machine->states[transition->from_state];
+    const PolyCall_State* to_state = &machine->states[transition->to_state];
+    if (transition->guard_condition && 
+        !transition->guard_condition(from_state, to_state)) {
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    }
+
+    if (from_state->on_exit) from_state->on_exit(ctx);
+    if (transition->action) transition->action(ctx);
+    if (to_state->on_enter) to_state->on_enter(ctx);
+    *state = transition->to_state;
+    return POLYCALL_SM_SUCCESS;
+}
+
+unsigned int polycall_sm_static_event_id(const PolyCall_StaticMachine* machine,
+                                         const char* transition_name) {
+    if (!machine || !transition_name) return POLYCALL_SM_NO_EVENT;
+
+    for (unsigned int e = 0; e < machine->num_events; e++) {
+        if (strcmp(machine->event_names[e], transition_name) == 0) return e;
+    }
+    return POLYCALL_SM_NO_EVENT;
+}
+
 // Main initialization function
 polycall_sm_status_t initialize_state_machine(
     polycall_context_t* ctx,
@@ -159,13 +345,13 @@ polycall_sm_status_t initialize_state_machine(
     // Step 1: Initialize PolyCall context
     polycall_config_t config = {0};
     if (polycall_init_with_config(ctx, &config) != POLYCALL_SUCCESS) {
-        fprintf(stderr, "Failed to initialize PolyCall context\n");
+        POLYCALL_LOG_ERROR("sm", "Failed to initialize PolyCall context");
         return POLYCALL_SM_ERROR_INVALID_CONTEXT;
     }
 
     // Step 2: Create state machine
     if (polycall_sm_create_with_integrity(*ctx, sm, NULL) != POLYCALL_SM_SUCCESS) {
-        fprintf(stderr, "Failed to create state machine\n");
+        POLYCALL_LOG_ERROR("sm", "Failed to create state machine");
         polycall_cleanup(*ctx);
         return POLYCALL_SM_ERROR_NOT_INITIALIZED;
     }
@@ -174,7 +360,7 @@ polycall_sm_status_t initialize_state_machine(
     for (size_t i = 0; i < sizeof(DEFAULT_STATES) / sizeof(DEFAULT_STATES[0]); i++) {
         polycall_sm_status_t status = init_state(*sm, &DEFAULT_STATES[i]);
         if (status != POLYCALL_SM_SUCCESS) {
-            fprintf(stderr, "Failed to initialize state %s\n", DEFAULT_STATES[i].name);
+            POLYCALL_LOG_ERROR("sm", "Failed to initialize state %s", DEFAULT_STATES[i].name);
             polycall_sm_destroy(*sm);
             polycall_cleanup(*ctx);
             return status;
@@ -184,7 +370,7 @@ polycall_sm_status_t initialize_state_machine(
     // Step 4: Initialize default transitions
     polycall_sm_status_t status = init_default_transitions(*sm);
     if (status != POLYCALL_SM_SUCCESS) {
-        fprintf(stderr, "Failed to initialize transitions\n");
+        POLYCALL_LOG_ERROR("sm", "Failed to initialize transitions");
         polycall_sm_destroy(*sm);
         polycall_cleanup(*ctx);
         return status;
@@ -205,9 +391,13 @@ polycall_sm_status_t polycall_sm_add_state(
     if (!sm || !sm->is_initialized || !name) 
         return POLYCALL_SM_ERROR_INVALID_STATE;
     
+    if (sm->concurrent) 
+        return POLYCALL_SM_ERROR_CONFLICT;
+    
     if (sm->num_states >= POLYCALL_MAX_STATES) 
         return POLYCALL_SM_ERROR_MAX_STATES_REACHED;
 
+    pthread_mutex_lock(&sm->audit_lock);
     PolyCall_State* state = &sm->states[sm->num_states];
     
     /* Initialize state */
@@ -220,10 +410,13 @@ polycall_sm_status_t polycall_sm_add_state(
     state->version = 1;
     state->is_locked = false;
 
-    update_state_timestamp(state);
+    update_state_timestamp(sm, state);
     state->checksum = calculate_state_checksum(state);
+    sm->machine_checksum ^= machine_term(false, state->id, state->checksum);
     
     sm->num_states++;
+    sm->compiled.is_compiled = false;
+    pthread_mutex_unlock(&sm->audit_lock);
     return POLYCALL_SM_SUCCESS;
 }
 
@@ -240,12 +433,16 @@ polycall_sm_status_t polycall_sm_add_transition(
     if (!sm || !sm->is_initialized || !name) 
         return POLYCALL_SM_ERROR_INVALID_TRANSITION;
     
+    if (sm->concurrent) 
+        return POLYCALL_SM_ERROR_CONFLICT;
+    
     if (sm->num_transitions >= POLYCALL_MAX_TRANSITIONS) 
         return POLYCALL_SM_ERROR_MAX_TRANSITIONS_REACHED;
     
     if (from_state >= sm->num_states || to_state >= sm->num_states) 
         return POLYCALL_SM_ERROR_INVALID_STATE;
 
+    pthread_mutex_lock(&sm->audit_lock);
     PolyCall_Transition* transition = &sm->transitions[sm->num_transitions];
     
     /* Initialize transition */
@@ -256,29 +453,80 @@ polycall_sm_status_t polycall_sm_add_transition(
     transition->action = action;
     transition->guard_condition = guard_condition;
     transition->is_valid = true;
+    transition->event_id = POLYCALL_SM_NO_EVENT;
+    transition->checksum = calculate_transition_checksum(transition);
+    touch_transition_page(sm, sm->num_transitions);
+    sm->machine_checksum ^= machine_term(true, sm->num_transitions, transition->checksum);
 
     sm->num_transitions++;
+    sm->compiled.is_compiled = false;
+    pthread_mutex_unlock(&sm->audit_lock);
     return POLYCALL_SM_SUCCESS;
 }
 
-polycall_sm_status_t polycall_sm_execute_transition(
-    PolyCall_StateMachine* sm,
-    const char* transition_name
-) {
-    if (!sm || !sm->is_initialized || !transition_name) 
-        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+/* Compiled transition lookup */
+
+polycall_sm_status_t polycall_sm_compile(PolyCall_StateMachine* sm) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    PolyCall_CompiledTable* table = &sm->compiled;
+    memset(table->first, POLYCALL_SM_NO_TRANSITION, sizeof(table->first));
+    memset(table->next, POLYCALL_SM_NO_TRANSITION, sizeof(table->next));
+    table->num_events = 0;
 
-    /* Find the requested transition */
-    PolyCall_Transition* transition = NULL;
     for (unsigned int i = 0; i < sm->num_transitions; i++) {
-        if (strcmp(sm->transitions[i].name, transition_name) == 0) {
-            transition = &sm->transitions[i];
-            break;
+        PolyCall_Transition* transition = &sm->transitions[i];
+
+        /* Intern the name: reuse the ID of an earlier transition */
+        unsigned int event = POLYCALL_SM_NO_EVENT;
+        for (unsigned int e = 0; e < table->num_events; e++) {
+            if (strcmp(sm->transitions[table->first[e]].name, transition->name) == 0) {
+                event = e;
+                break;
+            }
+        }
+        if (event == POLYCALL_SM_NO_EVENT) {
+            event = table->num_events++;
+            table->first[event] = (uint8_t)i;
+        }
+        transition->event_id = event;
+
+        /* The first declaration wins for a given state, as the name search did */
+        if (transition->is_valid &&
+            table->next[transition->from_state][event] == POLYCALL_SM_NO_TRANSITION) {
+            table->next[transition->from_state][event] = (uint8_t)i;
         }
     }
 
-    if (!transition || !transition->is_valid) {
+    table->is_compiled = true;
+    POLYCALL_LOG_DEBUG("sm", "Compiled %u transitions into %u events",
+                       sm->num_transitions, table->num_events);
+    return POLYCALL_SM_SUCCESS;
+}
+
+unsigned int polycall_sm_event_id(PolyCall_StateMachine* sm, const char* transition_name) {
+    if (!sm || !transition_name) return POLYCALL_SM_NO_EVENT;
+    if (!sm->compiled.is_compiled && polycall_sm_compile(sm) != POLYCALL_SM_SUCCESS) {
+        return POLYCALL_SM_NO_EVENT;
+    }
+
+    for (unsigned int e = 0; e < sm->compiled.num_events; e++) {
+        if (strcmp(sm->transitions[sm->compiled.first[e]].name, transition_name) == 0) {
+            return e;
+        }
+    }
+    return POLYCALL_SM_NO_EVENT;
+}
+
+// Locks, guard, actions and the state update for one resolved transition
+static polycall_sm_status_t run_transition(
+    PolyCall_StateMachine* sm,
+    PolyCall_Transition* transition
+) {
+    if (!transition->is_valid) {
         sm->diagnostics.failed_transitions++;
+        POLYCALL_LOG_DEBUG("sm", "Transition %s is not valid", transition->name);
         return POLYCALL_SM_ERROR_INVALID_TRANSITION;
     }
 
@@ -286,15 +534,23 @@ polycall_sm_status_t polycall_sm_execute_transition(
     PolyCall_State* to_state = &sm->states[transition->to_state];
 
     /* Check state locks and guard conditions */
-    if (from_state->is_locked || to_state->is_locked) 
+    if (from_state->is_locked || to_state->is_locked) {
+        count(&thread_counters(sm)->blocked_transitions);
+        POLYCALL_LOG_DEBUG("sm", "Transition %s blocked by a locked state", transition->name);
         return POLYCALL_SM_ERROR_STATE_LOCKED;
+    }
     
     if (transition->guard_condition && 
         !transition->guard_condition(from_state, to_state)) {
         sm->diagnostics.failed_transitions++;
+        POLYCALL_LOG_DEBUG("sm", "Transition %s rejected by its guard", transition->name);
         return POLYCALL_SM_ERROR_INVALID_TRANSITION;
     }
 
+    if (!touched_states_intact(sm, from_state, to_state)) {
+        return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+    }
+
     /* Execute transition actions */
     if (from_state->on_exit) from_state->on_exit(sm->ctx);
     if (transition->action) transition->action(sm->ctx);
@@ -302,11 +558,187 @@ polycall_sm_status_t polycall_sm_execute_transition(
 
     /* Update state machine */
     sm->current_state = transition->to_state;
-    update_state_timestamp(to_state);
+    uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_relaxed);
+    atomic_store_explicit(&sm->state_word,
+                          PACK_WORD(transition->to_state, WORD_VERSION(word) + 1),
+                          memory_order_release);
+    update_state_timestamp(sm, to_state);
+    count(&thread_counters(sm)->transitions);
+    POLYCALL_LOG_DEBUG("sm", "Transition %s: %s -> %s", transition->name,
+                       from_state->name, to_state->name);
+
+    return POLYCALL_SM_SUCCESS;
+}
+
+// Resolve against a snapshot of the state word and commit by CAS. With
+// check_version, a machine that moved since expected_version is rejected;
+// otherwise a lost race re-resolves from the state the winner left.
+static polycall_sm_status_t fire_concurrent(
+    PolyCall_StateMachine* sm,
+    unsigned int event_id,
+    bool check_version,
+    uint32_t expected_version
+) {
+    PolyCall_ThreadCounters* counters = thread_counters(sm);
+    uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_acquire);
+    PolyCall_Transition* transition;
+
+    for (unsigned int attempt = 0; ; attempt++) {
+        if (check_version && WORD_VERSION(word) != expected_version) {
+            count(&counters->conflicts);
+            return POLYCALL_SM_ERROR_VERSION_MISMATCH;
+        }
+
+        unsigned int state = WORD_STATE(word);
+        uint8_t index = POLYCALL_SM_NO_TRANSITION;
+        if (event_id < sm->compiled.num_events && state < POLYCALL_MAX_STATES) {
+            index = sm->compiled.next[state][event_id];
+        }
+        if (index == POLYCALL_SM_NO_TRANSITION) {
+            count(&counters->failed_transitions);
+            return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+        }
+
+        transition = &sm->transitions[index];
+        PolyCall_State* from_state = &sm->states[transition->from_state];
+        PolyCall_State* to_state = &sm->states[transition->to_state];
+        if (__atomic_load_n(&from_state->is_locked, __ATOMIC_ACQUIRE) ||
+            __atomic_load_n(&to_state->is_locked, __ATOMIC_ACQUIRE)) {
+            count(&counters->blocked_transitions);
+            return POLYCALL_SM_ERROR_STATE_LOCKED;
+        }
+        if (!transition->is_valid ||
+            (transition->guard_condition &&
+             !transition->guard_condition(from_state, to_state))) {
+            count(&counters->failed_transitions);
+            return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+        }
+        if (!touched_states_intact(sm, from_state, to_state)) {
+            return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+        }
+
+        uint64_t desired = PACK_WORD(transition->to_state, WORD_VERSION(word) + 1);
+        if (atomic_compare_exchange_strong_explicit(&sm->state_word, &word, desired,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            break;
+        }
+        count(&counters->conflicts);
+        if (check_version) return POLYCALL_SM_ERROR_VERSION_MISMATCH;
+        if (attempt + 1 >= POLYCALL_SM_CAS_RETRIES) return POLYCALL_SM_ERROR_CONFLICT;
+    }
+
+    /* Committed: only the winner runs the actions */
+    PolyCall_State* from_state = &sm->states[transition->from_state];
+    PolyCall_State* to_state = &sm->states[transition->to_state];
+    __atomic_store_n(&sm->current_state, transition->to_state, __ATOMIC_RELAXED);
+    if (from_state->on_exit) from_state->on_exit(sm->ctx);
+    if (transition->action) transition->action(sm->ctx);
+    if (to_state->on_enter) to_state->on_enter(sm->ctx);
 
+    __atomic_store_n(&to_state->timestamp, (uint64_t)time(NULL), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&to_state->version, 1, __ATOMIC_RELAXED);
+    touch_state_page(sm, to_state->id);
+    count(&counters->transitions);
     return POLYCALL_SM_SUCCESS;
 }
 
+polycall_sm_status_t polycall_sm_fire(
+    PolyCall_StateMachine* sm,
+    unsigned int event_id
+) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    if (sm->concurrent) return fire_concurrent(sm, event_id, false, 0);
+    if (!sm->compiled.is_compiled && polycall_sm_compile(sm) != POLYCALL_SM_SUCCESS) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    uint8_t index = POLYCALL_SM_NO_TRANSITION;
+    if (event_id < sm->compiled.num_events && sm->current_state < POLYCALL_MAX_STATES) {
+        index = sm->compiled.next[sm->current_state][event_id];
+    }
+    if (index == POLYCALL_SM_NO_TRANSITION) {
+        sm->diagnostics.failed_transitions++;
+        POLYCALL_LOG_DEBUG("sm", "No transition for event %u from state %u",
+                           event_id, sm->current_state);
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    }
+
+    return run_transition(sm, &sm->transitions[index]);
+}
+
+polycall_sm_status_t polycall_sm_fire_if_version(
+    PolyCall_StateMachine* sm,
+    unsigned int event_id,
+    uint32_t expected_version
+) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    if (sm->concurrent) return fire_concurrent(sm, event_id, true, expected_version);
+
+    uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_relaxed);
+    if (WORD_VERSION(word) != expected_version) 
+        return POLYCALL_SM_ERROR_VERSION_MISMATCH;
+    return polycall_sm_fire(sm, event_id);
+}
+
+polycall_sm_status_t polycall_sm_set_concurrent(PolyCall_StateMachine* sm, bool enabled) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    if (enabled && !sm->concurrent) {
+        // Threads only read the table, so it must exist up front
+        polycall_sm_status_t status = polycall_sm_compile(sm);
+        if (status != POLYCALL_SM_SUCCESS) return status;
+        uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_relaxed);
+        atomic_store_explicit(&sm->state_word, PACK_WORD(sm->current_state, WORD_VERSION(word)),
+                              memory_order_release);
+    } else if (!enabled && sm->concurrent) {
+        sm->current_state = WORD_STATE(atomic_load_explicit(&sm->state_word, memory_order_acquire));
+    }
+    sm->concurrent = enabled;
+    return POLYCALL_SM_SUCCESS;
+}
+
+void polycall_sm_current(const PolyCall_StateMachine* sm, unsigned int* state, uint32_t* version) {
+    if (!sm) return;
+    uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_acquire);
+    if (state) *state = sm->concurrent ? WORD_STATE(word) : sm->current_state;
+    if (version) *version = WORD_VERSION(word);
+}
+
+polycall_sm_status_t polycall_sm_execute_transition(
+    PolyCall_StateMachine* sm,
+    const char* transition_name
+) {
+    if (!sm || !sm->is_initialized || !transition_name) 
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+
+    if (sm->concurrent) {
+        unsigned int event = POLYCALL_SM_NO_EVENT;
+        for (unsigned int e = 0; e < sm->compiled.num_events; e++) {
+            if (strcmp(sm->transitions[sm->compiled.first[e]].name, transition_name) == 0) {
+                event = e;
+                break;
+            }
+        }
+        return fire_concurrent(sm, event, false, 0);
+    }
+
+    unsigned int event = polycall_sm_event_id(sm, transition_name);
+    if (event == POLYCALL_SM_NO_EVENT) {
+        sm->diagnostics.failed_transitions++;
+        POLYCALL_LOG_DEBUG("sm", "Unknown transition %s", transition_name);
+        return POLYCALL_SM_ERROR_INVALID_TRANSITION;
+    }
+
+    if (sm->current_state < POLYCALL_MAX_STATES &&
+        sm->compiled.next[sm->current_state][event] != POLYCALL_SM_NO_TRANSITION) {
+        return polycall_sm_fire(sm, event);
+    }
+    return run_transition(sm, &sm->transitions[sm->compiled.first[event]]);
+}
+
 /* Integrity verification functions */
 
 polycall_sm_status_t polycall_sm_verify_state_integrity(
@@ -323,18 +755,121 @@ polycall_sm_status_t polycall_sm_verify_state_integrity(
     uint32_t current_checksum = calculate_state_checksum(state);
 
     if (current_checksum != state->checksum) {
-        sm->diagnostics.integrity_violations++;
+        count_violation(sm);
         return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
     }
 
     if (sm->integrity_check && !sm->integrity_check(state)) {
-        sm->diagnostics.integrity_violations++;
+        count_violation(sm);
         return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
     }
 
     return POLYCALL_SM_SUCCESS;
 }
 
+// Called with audit_lock held
+static polycall_sm_status_t audit_machine(PolyCall_StateMachine* sm) {
+    polycall_sm_status_t status = POLYCALL_SM_SUCCESS;
+    uint32_t folded = 0;
+
+    for (unsigned int i = 0; i < sm->num_states; i++) {
+        const PolyCall_State* state = &sm->states[i];
+        folded ^= machine_term(false, i, state->checksum);
+        if (calculate_state_checksum(state) != state->checksum ||
+            (sm->integrity_check && !sm->integrity_check(state))) {
+            count_violation(sm);
+            status = POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+            POLYCALL_LOG_ERROR("sm", "Audit: state %u (%s) is corrupt", i, state->name);
+            if (sm->on_violation) sm->on_violation(sm, false, i);
+        }
+    }
+    for (unsigned int i = 0; i < sm->num_transitions; i++) {
+        const PolyCall_Transition* transition = &sm->transitions[i];
+        folded ^= machine_term(true, i, transition->checksum);
+        if (calculate_transition_checksum(transition) != transition->checksum) {
+            count_violation(sm);
+            status = POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+            POLYCALL_LOG_ERROR("sm", "Audit: transition %u (%s) is corrupt", i, transition->name);
+            if (sm->on_violation) sm->on_violation(sm, true, i);
+        }
+    }
+
+    // Catches a stored checksum rewritten to match a corrupted entry
+    if (folded != sm->machine_checksum && status == POLYCALL_SM_SUCCESS) {
+        count_violation(sm);
+        status = POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+        POLYCALL_LOG_ERROR("sm", "Audit: machine checksum mismatch");
+    }
+
+    __atomic_store_n(&sm->diagnostics.last_verification, (uint64_t)time(NULL), __ATOMIC_RELAXED);
+    return status;
+}
+
+polycall_sm_status_t polycall_sm_verify_machine(PolyCall_StateMachine* sm) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    pthread_mutex_lock(&sm->audit_lock);
+    polycall_sm_status_t status = audit_machine(sm);
+    pthread_mutex_unlock(&sm->audit_lock);
+    return status;
+}
+
+static void* auditor_main(void* arg) {
+    PolyCall_StateMachine* sm = arg;
+
+    pthread_mutex_lock(&sm->audit_lock);
+    while (!sm->auditor_stopping) {
+        audit_machine(sm);
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += sm->audit_interval_ms / 1000;
+        deadline.tv_nsec += (long)(sm->audit_interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (!sm->auditor_stopping &&
+               pthread_cond_timedwait(&sm->audit_wake, &sm->audit_lock, &deadline) == 0) {
+        }
+    }
+    pthread_mutex_unlock(&sm->audit_lock);
+    return NULL;
+}
+
+polycall_sm_status_t polycall_sm_start_auditor(
+    PolyCall_StateMachine* sm,
+    unsigned int interval_ms,
+    PolyCall_IntegrityViolation on_violation
+) {
+    if (!sm || !sm->is_initialized) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    if (sm->auditor_started) 
+        return POLYCALL_SM_ERROR_CONFLICT;
+
+    sm->audit_interval_ms = interval_ms ? interval_ms : 1000;
+    sm->on_violation = on_violation;
+    sm->auditor_stopping = false;
+    if (pthread_create(&sm->auditor, NULL, auditor_main, sm) != 0) {
+        POLYCALL_LOG_ERROR("sm", "Failed to start the integrity auditor");
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    }
+    sm->auditor_started = true;
+    return POLYCALL_SM_SUCCESS;
+}
+
+void polycall_sm_stop_auditor(PolyCall_StateMachine* sm) {
+    if (!sm || !sm->auditor_started) return;
+
+    pthread_mutex_lock(&sm->audit_lock);
+    sm->auditor_stopping = true;
+    pthread_cond_signal(&sm->audit_wake);
+    pthread_mutex_unlock(&sm->audit_lock);
+    pthread_join(sm->auditor, NULL);
+    sm->auditor_started = false;
+}
+
 /* State locking functions */
 
 polycall_sm_status_t polycall_sm_lock_state(
@@ -347,8 +882,8 @@ polycall_sm_status_t polycall_sm_lock_state(
     if (state_id >= sm->num_states) 
         return POLYCALL_SM_ERROR_INVALID_STATE;
 
-    sm->states[state_id].is_locked = true;
-    update_state_timestamp(&sm->states[state_id]);
+    __atomic_store_n(&sm->states[state_id].is_locked, true, __ATOMIC_RELEASE);
+    update_state_timestamp(sm, &sm->states[state_id]);
     return POLYCALL_SM_SUCCESS;
 }
 
@@ -362,8 +897,8 @@ polycall_sm_status_t polycall_sm_unlock_state(
     if (state_id >= sm->num_states) 
         return POLYCALL_SM_ERROR_INVALID_STATE;
 
-    sm->states[state_id].is_locked = false;
-    update_state_timestamp(&sm->states[state_id]);
+    __atomic_store_n(&sm->states[state_id].is_locked, false, __ATOMIC_RELEASE);
+    update_state_timestamp(sm, &sm->states[state_id]);
     return POLYCALL_SM_SUCCESS;
 }
 
@@ -406,12 +941,370 @@ polycall_sm_status_t polycall_sm_restore_state_from_snapshot(
     if (state->version != snapshot->state.version) 
         return POLYCALL_SM_ERROR_VERSION_MISMATCH;
 
+    pthread_mutex_lock(&sm->audit_lock);
+    uint32_t old_checksum = state->checksum;
     memcpy(state, &snapshot->state, sizeof(PolyCall_State));
-    update_state_timestamp(state);
+    update_state_timestamp(sm, state);
+    replace_machine_term(sm, false, state->id, old_checksum, state->checksum);
+    pthread_mutex_unlock(&sm->audit_lock);
 
     return POLYCALL_SM_SUCCESS;
 }
 
+/* Whole-machine snapshots */
+
+typedef struct StatePage {
+    _Atomic uint32_t refs;
+    PolyCall_State states[POLYCALL_SM_PAGE_ENTRIES];
+} StatePage;
+
+typedef struct TransitionPage {
+    _Atomic uint32_t refs;
+    PolyCall_Transition transitions[POLYCALL_SM_PAGE_ENTRIES];
+} TransitionPage;
+
+struct PolyCall_MachineSnapshot {
+    _Atomic uint32_t refs;
+    const PolyCall_StateMachine* machine;   // Identity only, never dereferenced
+    uint64_t generation;
+    unsigned int current_state;
+    unsigned int num_states;
+    unsigned int num_transitions;
+    uint32_t machine_checksum;
+    StatePage* state_pages[POLYCALL_SM_STATE_PAGES];
+    TransitionPage* transition_pages[POLYCALL_SM_TRANSITION_PAGES];
+};
+
+static inline unsigned int pages_for(unsigned int entries) {
+    return (entries + POLYCALL_SM_PAGE_ENTRIES - 1) / POLYCALL_SM_PAGE_ENTRIES;
+}
+
+static inline void* page_retain(void* page) {
+    // refs is the first member of both page types
+    if (page) atomic_fetch_add_explicit((_Atomic uint32_t*)page, 1, memory_order_relaxed);
+    return page;
+}
+
+static inline void page_release(void* page) {
+    if (page && atomic_fetch_sub_explicit((_Atomic uint32_t*)page, 1, memory_order_acq_rel) == 1) {
+        free(page);
+    }
+}
+
+void polycall_sm_release_machine_snapshot(PolyCall_MachineSnapshot* snapshot) {
+    if (!snapshot) return;
+    if (atomic_fetch_sub_explicit(&snapshot->refs, 1, memory_order_acq_rel) != 1) return;
+
+    for (unsigned int p = 0; p < POLYCALL_SM_STATE_PAGES; p++) page_release(snapshot->state_pages[p]);
+    for (unsigned int p = 0; p < POLYCALL_SM_TRANSITION_PAGES; p++) page_release(snapshot->transition_pages[p]);
+    free(snapshot);
+}
+
+uint64_t polycall_sm_machine_snapshot_generation(const PolyCall_MachineSnapshot* snapshot) {
+    return snapshot ? snapshot->generation : 0;
+}
+
+// Make snapshot the base: every live page now matches it
+static void set_base_snapshot(PolyCall_StateMachine* sm, PolyCall_MachineSnapshot* snapshot) {
+    atomic_fetch_add_explicit(&snapshot->refs, 1, memory_order_relaxed);
+    polycall_sm_release_machine_snapshot(sm->base_snapshot);
+    sm->base_snapshot = snapshot;
+    for (unsigned int p = 0; p < POLYCALL_SM_STATE_PAGES; p++) {
+        sm->clean_state_page[p] = snapshot->state_pages[p];
+    }
+    for (unsigned int p = 0; p < POLYCALL_SM_TRANSITION_PAGES; p++) {
+        sm->clean_transition_page[p] = snapshot->transition_pages[p];
+    }
+}
+
+polycall_sm_status_t polycall_sm_snapshot_machine(
+    PolyCall_StateMachine* sm,
+    PolyCall_MachineSnapshot** snapshot
+) {
+    if (!sm || !sm->is_initialized || !snapshot) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    if (sm->concurrent) 
+        return POLYCALL_SM_ERROR_CONFLICT;
+
+    PolyCall_MachineSnapshot* taken = calloc(1, sizeof(PolyCall_MachineSnapshot));
+    if (!taken) return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    pthread_mutex_lock(&sm->audit_lock);
+    atomic_init(&taken->refs, 1);
+    taken->machine = sm;
+    taken->generation = ++sm->generation;
+    taken->current_state = sm->current_state;
+    taken->num_states = sm->num_states;
+    taken->num_transitions = sm->num_transitions;
+    taken->machine_checksum = sm->machine_checksum;
+
+    // Share clean pages, copy written ones
+    bool ok = true;
+    for (unsigned int p = 0; ok && p < pages_for(sm->num_states); p++) {
+        StatePage* page = (StatePage*)sm->clean_state_page[p];
+        if (!page) {
+            page = malloc(sizeof(StatePage));
+            if (!page) { ok = false; break; }
+            atomic_init(&page->refs, 0);
+            memcpy(page->states, &sm->states[p * POLYCALL_SM_PAGE_ENTRIES], sizeof(page->states));
+        }
+        taken->state_pages[p] = page_retain(page);
+    }
+    for (unsigned int p = 0; ok && p < pages_for(sm->num_transitions); p++) {
+        TransitionPage* page = (TransitionPage*)sm->clean_transition_page[p];
+        if (!page) {
+            page = malloc(sizeof(TransitionPage));
+            if (!page) { ok = false; break; }
+            atomic_init(&page->refs, 0);
+            memcpy(page->transitions, &sm->transitions[p * POLYCALL_SM_PAGE_ENTRIES],
+                   sizeof(page->transitions));
+        }
+        taken->transition_pages[p] = page_retain(page);
+    }
+    if (ok) set_base_snapshot(sm, taken);
+    pthread_mutex_unlock(&sm->audit_lock);
+
+    if (!ok) {
+        polycall_sm_release_machine_snapshot(taken);
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    }
+    *snapshot = taken;
+    return POLYCALL_SM_SUCCESS;
+}
+
+polycall_sm_status_t polycall_sm_restore_machine(
+    PolyCall_StateMachine* sm,
+    const PolyCall_MachineSnapshot* snapshot
+) {
+    if (!sm || !sm->is_initialized || !snapshot) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    if (snapshot->machine != sm) 
+        return POLYCALL_SM_ERROR_INVALID_CONTEXT;
+    if (sm->concurrent) 
+        return POLYCALL_SM_ERROR_CONFLICT;
+
+    pthread_mutex_lock(&sm->audit_lock);
+    for (unsigned int p = 0; p < POLYCALL_SM_STATE_PAGES; p++) {
+        const StatePage* page = snapshot->state_pages[p];
+        if (sm->clean_state_page[p] == page) continue;
+        PolyCall_State* live = &sm->states[p * POLYCALL_SM_PAGE_ENTRIES];
+        if (page) memcpy(live, page->states, sizeof(page->states));
+        else memset(live, 0, sizeof(PolyCall_State) * POLYCALL_SM_PAGE_ENTRIES);
+    }
+    for (unsigned int p = 0; p < POLYCALL_SM_TRANSITION_PAGES; p++) {
+        const TransitionPage* page = snapshot->transition_pages[p];
+        if (sm->clean_transition_page[p] == page) continue;
+        PolyCall_Transition* live = &sm->transitions[p * POLYCALL_SM_PAGE_ENTRIES];
+        if (page) memcpy(live, page->transitions, sizeof(page->transitions));
+        else memset(live, 0, sizeof(PolyCall_Transition) * POLYCALL_SM_PAGE_ENTRIES);
+    }
+
+    // Entries past the counts on a shared last page are stale copies
+    for (unsigned int i = snapshot->num_states; i < pages_for(snapshot->num_states) * POLYCALL_SM_PAGE_ENTRIES; i++) {
+        memset(&sm->states[i], 0, sizeof(PolyCall_State));
+    }
+    for (unsigned int i = snapshot->num_transitions; i < pages_for(snapshot->num_transitions) * POLYCALL_SM_PAGE_ENTRIES; i++) {
+        memset(&sm->transitions[i], 0, sizeof(PolyCall_Transition));
+    }
+
+    if (sm->num_states != snapshot->num_states || sm->num_transitions != snapshot->num_transitions) {
+        sm->compiled.is_compiled = false;
+    }
+    sm->num_states = snapshot->num_states;
+    sm->num_transitions = snapshot->num_transitions;
+    sm->current_state = snapshot->current_state;
+    sm->machine_checksum = snapshot->machine_checksum;
+
+    // A rollback is a move: optimistic fires from before it must fail
+    uint64_t word = atomic_load_explicit(&sm->state_word, memory_order_relaxed);
+    atomic_store_explicit(&sm->state_word, PACK_WORD(sm->current_state, WORD_VERSION(word) + 1),
+                          memory_order_release);
+
+    set_base_snapshot(sm, (PolyCall_MachineSnapshot*)snapshot);
+    pthread_mutex_unlock(&sm->audit_lock);
+    return POLYCALL_SM_SUCCESS;
+}
+
+/*
+ * Encoding, all integers little-endian:
+ *   header      magic u32, format u16, reserved u16, generation u64,
+ *               current_state u32, num_states u32, num_transitions u32
+ *   per state   name[POLYCALL_MAX_NAME_LENGTH], id u32, is_final u8,
+ *               is_locked u8, version u32, timestamp u64
+ *   per transition  name[POLYCALL_MAX_NAME_LENGTH], from u32, to u32, is_valid u8
+ *   trailer     CRC32C u32 of everything before it
+ */
+#define SNAPSHOT_MAGIC 0x4D534350u      // "PCSM"
+#define SNAPSHOT_FORMAT 1
+#define SNAPSHOT_HEADER_SIZE 28
+#define SNAPSHOT_STATE_SIZE (POLYCALL_MAX_NAME_LENGTH + 18)
+#define SNAPSHOT_TRANSITION_SIZE (POLYCALL_MAX_NAME_LENGTH + 9)
+
+static uint8_t* put_u16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return out + 2;
+}
+
+static uint8_t* put_u32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+    return out + 4;
+}
+
+static uint8_t* put_u64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)(value >> (8 * i));
+    return out + 8;
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+static uint64_t get_u64(const uint8_t* in) {
+    return (uint64_t)get_u32(in) | (uint64_t)get_u32(in + 4) << 32;
+}
+
+static inline const PolyCall_State* snapshot_state(const PolyCall_MachineSnapshot* snapshot, unsigned int i) {
+    return &snapshot->state_pages[i / POLYCALL_SM_PAGE_ENTRIES]->states[i % POLYCALL_SM_PAGE_ENTRIES];
+}
+
+static inline const PolyCall_Transition* snapshot_transition(const PolyCall_MachineSnapshot* snapshot, unsigned int i) {
+    return &snapshot->transition_pages[i / POLYCALL_SM_PAGE_ENTRIES]->transitions[i % POLYCALL_SM_PAGE_ENTRIES];
+}
+
+polycall_sm_status_t polycall_sm_serialize_machine_snapshot(
+    const PolyCall_MachineSnapshot* snapshot,
+    uint8_t* buffer,
+    size_t capacity,
+    size_t* size
+) {
+    if (!snapshot || !size) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    size_t needed = SNAPSHOT_HEADER_SIZE + snapshot->num_states * SNAPSHOT_STATE_SIZE +
+                    snapshot->num_transitions * SNAPSHOT_TRANSITION_SIZE + 4;
+    *size = needed;
+    if (!buffer) return POLYCALL_SM_SUCCESS;
+    if (capacity < needed) return POLYCALL_SM_ERROR_INVALID_STATE;
+
+    uint8_t* out = put_u32(buffer, SNAPSHOT_MAGIC);
+    out = put_u16(out, SNAPSHOT_FORMAT);
+    out = put_u16(out, 0);
+    out = put_u64(out, snapshot->generation);
+    out = put_u32(out, snapshot->current_state);
+    out = put_u32(out, snapshot->num_states);
+    out = put_u32(out, snapshot->num_transitions);
+
+    for (unsigned int i = 0; i < snapshot->num_states; i++) {
+        const PolyCall_State* state = snapshot_state(snapshot, i);
+        memcpy(out, state->name, POLYCALL_MAX_NAME_LENGTH);
+        out = put_u32(out + POLYCALL_MAX_NAME_LENGTH, state->id);
+        *out++ = state->is_final;
+        *out++ = state->is_locked;
+        out = put_u32(out, state->version);
+        out = put_u64(out, state->timestamp);
+    }
+    for (unsigned int i = 0; i < snapshot->num_transitions; i++) {
+        const PolyCall_Transition* transition = snapshot_transition(snapshot, i);
+        memcpy(out, transition->name, POLYCALL_MAX_NAME_LENGTH);
+        out = put_u32(out + POLYCALL_MAX_NAME_LENGTH, transition->from_state);
+        out = put_u32(out, transition->to_state);
+        *out++ = transition->is_valid;
+    }
+    put_u32(out, polycall_crc32c(0, buffer, (size_t)(out - buffer)));
+    return POLYCALL_SM_SUCCESS;
+}
+
+polycall_sm_status_t polycall_sm_deserialize_machine_snapshot(
+    PolyCall_StateMachine* sm,
+    const uint8_t* data,
+    size_t size,
+    PolyCall_MachineSnapshot** snapshot
+) {
+    if (!sm || !sm->is_initialized || !data || !snapshot) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    if (size < SNAPSHOT_HEADER_SIZE + 4 || get_u32(data) != SNAPSHOT_MAGIC ||
+        (data[4] | data[5] << 8) != SNAPSHOT_FORMAT ||
+        get_u32(data + size - 4) != polycall_crc32c(0, data, size - 4)) {
+        return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+    }
+
+    unsigned int num_states = get_u32(data + 20);
+    unsigned int num_transitions = get_u32(data + 24);
+    unsigned int current_state = get_u32(data + 16);
+    if (num_states > sm->num_states || num_transitions > sm->num_transitions ||
+        (num_states > 0 && current_state >= num_states)) {
+        return POLYCALL_SM_ERROR_INVALID_STATE;
+    }
+    if (size != SNAPSHOT_HEADER_SIZE + (size_t)num_states * SNAPSHOT_STATE_SIZE +
+                (size_t)num_transitions * SNAPSHOT_TRANSITION_SIZE + 4) {
+        return POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED;
+    }
+
+    PolyCall_MachineSnapshot* decoded = calloc(1, sizeof(PolyCall_MachineSnapshot));
+    if (!decoded) return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+    atomic_init(&decoded->refs, 1);
+    decoded->machine = sm;
+    decoded->generation = get_u64(data + 8);
+    decoded->current_state = current_state;
+    decoded->num_states = num_states;
+    decoded->num_transitions = num_transitions;
+
+    polycall_sm_status_t status = POLYCALL_SM_SUCCESS;
+    const uint8_t* in = data + SNAPSHOT_HEADER_SIZE;
+
+    // Callbacks come from sm's own definition, which has to match
+    pthread_mutex_lock(&sm->audit_lock);
+    for (unsigned int p = 0; p < pages_for(num_states); p++) {
+        StatePage* page = calloc(1, sizeof(StatePage));
+        if (!page) { status = POLYCALL_SM_ERROR_NOT_INITIALIZED; break; }
+        atomic_init(&page->refs, 1);
+        decoded->state_pages[p] = page;
+    }
+    for (unsigned int p = 0; status == POLYCALL_SM_SUCCESS && p < pages_for(num_transitions); p++) {
+        TransitionPage* page = calloc(1, sizeof(TransitionPage));
+        if (!page) { status = POLYCALL_SM_ERROR_NOT_INITIALIZED; break; }
+        atomic_init(&page->refs, 1);
+        decoded->transition_pages[p] = page;
+    }
+
+    for (unsigned int i = 0; status == POLYCALL_SM_SUCCESS && i < num_states; i++, in += SNAPSHOT_STATE_SIZE) {
+        PolyCall_State* state = (PolyCall_State*)snapshot_state(decoded, i);
+        *state = sm->states[i];
+        const uint8_t* fields = in + POLYCALL_MAX_NAME_LENGTH;
+        if (memcmp(in, state->name, POLYCALL_MAX_NAME_LENGTH) != 0 ||
+            get_u32(fields) != i || fields[4] != state->is_final) {
+            status = POLYCALL_SM_ERROR_INVALID_STATE;
+            break;
+        }
+        state->is_locked = fields[5] != 0;
+        state->version = get_u32(fields + 6);
+        state->timestamp = get_u64(fields + 10);
+        decoded->machine_checksum ^= machine_term(false, i, state->checksum);
+    }
+    for (unsigned int i = 0; status == POLYCALL_SM_SUCCESS && i < num_transitions; i++, in += SNAPSHOT_TRANSITION_SIZE) {
+        PolyCall_Transition* transition = (PolyCall_Transition*)snapshot_transition(decoded, i);
+        *transition = sm->transitions[i];
+        const uint8_t* fields = in + POLYCALL_MAX_NAME_LENGTH;
+        if (memcmp(in, transition->name, POLYCALL_MAX_NAME_LENGTH) != 0 ||
+            get_u32(fields) != transition->from_state || get_u32(fields + 4) != transition->to_state ||
+            fields[8] != transition->is_valid) {
+            status = POLYCALL_SM_ERROR_INVALID_STATE;
+            break;
+        }
+        decoded->machine_checksum ^= machine_term(true, i, transition->checksum);
+    }
+    pthread_mutex_unlock(&sm->audit_lock);
+
+    if (status != POLYCALL_SM_SUCCESS) {
+        polycall_sm_release_machine_snapshot(decoded);
+        return status;
+    }
+    *snapshot = decoded;
+    return POLYCALL_SM_SUCCESS;
+}
+
 /* Version and diagnostic functions */
 
 polycall_sm_status_t polycall_sm_get_state_version(
@@ -429,6 +1322,30 @@ polycall_sm_status_t polycall_sm_get_state_version(
     return POLYCALL_SM_SUCCESS;
 }
 
+polycall_sm_status_t polycall_sm_get_machine_diagnostics(
+    const PolyCall_StateMachine* sm,
+    PolyCall_MachineDiagnostics* diagnostics
+) {
+    if (!sm || !sm->is_initialized || !diagnostics) 
+        return POLYCALL_SM_ERROR_NOT_INITIALIZED;
+
+    memset(diagnostics, 0, sizeof(*diagnostics));
+    diagnostics->failed_transitions = sm->diagnostics.failed_transitions;
+    diagnostics->integrity_violations = __atomic_load_n(&sm->diagnostics.integrity_violations, __ATOMIC_RELAXED);
+    for (unsigned int i = 0; i < POLYCALL_SM_THREAD_SLOTS; i++) {
+        const PolyCall_ThreadCounters* counters = &sm->thread_counters[i];
+        diagnostics->transitions += atomic_load_explicit(
+            &counters->transitions, memory_order_relaxed);
+        diagnostics->failed_transitions += atomic_load_explicit(
+            &counters->failed_transitions, memory_order_relaxed);
+        diagnostics->conflicts += atomic_load_explicit(
+            &counters->conflicts, memory_order_relaxed);
+        diagnostics->blocked_transitions += atomic_load_explicit(
+            &counters->blocked_transitions, memory_order_relaxed);
+    }
+    return POLYCALL_SM_SUCCESS;
+}
+
 polycall_sm_status_t polycall_sm_get_state_diagnostics(
     const PolyCall_StateMachine* sm,
     unsigned int state_id,
@@ -451,4 +1368,4 @@ polycall_sm_status_t polycall_sm_get_state_diagnostics(
     diagnostics->integrity_check_count = 0;  /* Updated in future implementation */
 
     return POLYCALL_SM_SUCCESS;
-}
\ No newline at end of file
+}
\ No newline at end of file
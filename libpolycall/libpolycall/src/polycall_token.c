@@ -0,0 +1,26 @@
+#include "polycall_token.h"
+#include <stdlib.h>
+
+// Token arrays are fixed-size; the tokenizer stops at capacity
+PolycallTokenArray* polycall_token_create_array(uint32_t capacity) {
+    PolycallTokenArray* array = calloc(1, sizeof(PolycallTokenArray));
+    if (!array) return NULL;
+    
+    if (capacity > 0) {
+        array->tokens = calloc(capacity, sizeof(PolycallToken));
+        if (!array->tokens) {
+            free(array);
+            return NULL;
+        }
+    }
+    array->capacity = capacity;
+    array->position.line = 1;
+    array->position.column = 1;
+    return array;
+}
+
+void polycall_token_destroy_array(PolycallTokenArray* array) {
+    if (!array) return;
+    free(array->tokens);
+    free(array);
+}
@@ -1,6 +1,7 @@
 #include "polycall_tokenizer.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <ctype.h>
 
 // Default configuration values
@@ -12,6 +13,8 @@
 // Error messages
 static const char* ERROR_BUFFER_OVERFLOW = "Buffer overflow";
 static const char* ERROR_INVALID_INPUT = "Invalid input";
+static const char* ERROR_TOKEN_TOO_LONG = "Token too long";
+static const char* ERROR_NO_DFA = "Operations have no compiled DFA";
 
 // Default configuration
 const PolycallTokenizerConfig POLYCALL_TOKENIZER_DEFAULT_CONFIG = {
@@ -43,6 +46,7 @@ static void reset_state(PolycallTokenizer* tokenizer) {
     tokenizer->position.line = 1;
     tokenizer->position.column = 1;
     tokenizer->input.position = 0;
+    tokenizer->stream.carry_length = 0;
     
     if (tokenizer->state.error_message) {
         free(tokenizer->state.error_message);
@@ -128,18 +132,19 @@ bool polycall_tokenizer_match_string(const char* input, size_t* length) {
     return false;
 }
 
+// Two-character operators first, so the longest one wins
+static const char* const OPERATORS[] = {
+    "++", "--", "+=", "-=", "*=", "/=",
+    "==", "!=", ">=", "<=", "&&", "||",
+    "+", "-", "*", "/", "%",
+    "=", "<", ">", "!", "&", "|",
+    NULL
+};
+
 bool polycall_tokenizer_match_operator(const char* input, size_t* length) {
     if (!input || !length) return false;
     
-    static const char* operators[] = {
-        "++", "--", "+=", "-=", "*=", "/=", 
-        "==", "!=", ">=", "<=", "&&", "||",
-        "+", "-", "*", "/", "%", 
-        "=", "<", ">", "!", "&", "|", 
-        NULL
-    };
-    
-    for (const char** op = operators; *op; op++) {
+    for (const char* const* op = OPERATORS; *op; op++) {
         size_t op_len = strlen(*op);
         if (strncmp(input, *op, op_len) == 0) {
             *length = op_len;
@@ -150,6 +155,351 @@ bool polycall_tokenizer_match_operator(const char* input, size_t* length) {
     return false;
 }
 
+/*
+ * DFA compilation. Each built-in matcher has a small hand-written DFA over
+ * bytes; compiling a pattern list folds them together with the product
+ * construction, and compose_ops folds two compiled DFAs the same way.
+ * The result keeps one column per character class: bytes that every state
+ * treats alike share a class, so the table stays a few KB.
+ *
+ * State 0 is dead and state 1 is the start. accept[s] is the index of the
+ * earliest pattern that accepts in s, or -1.
+ */
+#define DFA_DEAD 0
+#define DFA_START 1
+#define DFA_MAX_STATES 4096
+
+struct PolycallTokenizerDfa {
+    uint8_t classes[256];         // Byte -> character class
+    uint16_t num_classes;
+    uint16_t num_states;
+    uint16_t* next;               // [state * num_classes + class]
+    int32_t* accept;
+    size_t* custom;               // Patterns that are not built in
+    size_t custom_count;
+};
+
+// Byte-level DFA used while building
+typedef struct {
+    uint16_t (*next)[256];
+    int32_t* accept;
+    uint16_t count;
+    uint16_t capacity;
+} ByteDfa;
+
+static uint16_t byte_dfa_add(ByteDfa* dfa, int32_t accept) {
+    if (dfa->count == dfa->capacity) {
+        if (dfa->capacity >= DFA_MAX_STATES) return DFA_DEAD;
+        uint16_t capacity = dfa->capacity ? dfa->capacity * 2 : 16;
+        void* next = realloc(dfa->next, capacity * sizeof(*dfa->next));
+        if (!next) return DFA_DEAD;
+        dfa->next = next;
+        void* accepts = realloc(dfa->accept, capacity * sizeof(int32_t));
+        if (!accepts) return DFA_DEAD;
+        dfa->accept = accepts;
+        dfa->capacity = capacity;
+    }
+    memset(dfa->next[dfa->count], 0, sizeof(dfa->next[0]));
+    dfa->accept[dfa->count] = accept;
+    return dfa->count++;
+}
+
+static bool byte_dfa_init(ByteDfa* dfa) {
+    memset(dfa, 0, sizeof(ByteDfa));
+    return byte_dfa_add(dfa, -1) == DFA_DEAD && byte_dfa_add(dfa, -1) == DFA_START;
+}
+
+static void byte_dfa_free(ByteDfa* dfa) {
+    free(dfa->next);
+    free(dfa->accept);
+}
+
+static void byte_dfa_range(ByteDfa* dfa, uint16_t from, int lo, int hi, uint16_t to) {
+    for (int c = lo; c <= hi; c++) dfa->next[from][c] = to;
+}
+
+static void byte_dfa_digits(ByteDfa* dfa, uint16_t from, uint16_t to) {
+    byte_dfa_range(dfa, from, '0', '9', to);
+}
+
+static void byte_dfa_word(ByteDfa* dfa, uint16_t from, uint16_t to, bool digits) {
+    byte_dfa_range(dfa, from, 'a', 'z', to);
+    byte_dfa_range(dfa, from, 'A', 'Z', to);
+    dfa->next[from]['_'] = to;
+    if (digits) byte_dfa_digits(dfa, from, to);
+}
+
+static bool build_identifier(ByteDfa* dfa, int32_t pattern) {
+    uint16_t word = byte_dfa_add(dfa, pattern);
+    if (!word) return false;
+    byte_dfa_word(dfa, DFA_START, word, false);
+    byte_dfa_word(dfa, word, word, true);
+    return true;
+}
+
+// [+-]?D+(.D+)?([eE][+-]?D+)?
+static bool build_number(ByteDfa* dfa, int32_t pattern) {
+    uint16_t sign = byte_dfa_add(dfa, -1);
+    uint16_t whole = byte_dfa_add(dfa, pattern);
+    uint16_t point = byte_dfa_add(dfa, -1);
+    uint16_t fraction = byte_dfa_add(dfa, pattern);
+    uint16_t exp = byte_dfa_add(dfa, -1);
+    uint16_t exp_sign = byte_dfa_add(dfa, -1);
+    uint16_t exp_digits = byte_dfa_add(dfa, pattern);
+    if (!exp_digits) return false;
+
+    dfa->next[DFA_START]['+'] = dfa->next[DFA_START]['-'] = sign;
+    byte_dfa_digits(dfa, DFA_START, whole);
+    byte_dfa_digits(dfa, sign, whole);
+    byte_dfa_digits(dfa, whole, whole);
+    dfa->next[whole]['.'] = point;
+    byte_dfa_digits(dfa, point, fraction);
+    byte_dfa_digits(dfa, fraction, fraction);
+    dfa->next[whole]['e'] = dfa->next[whole]['E'] = exp;
+    dfa->next[fraction]['e'] = dfa->next[fraction]['E'] = exp;
+    dfa->next[exp]['+'] = dfa->next[exp]['-'] = exp_sign;
+    byte_dfa_digits(dfa, exp, exp_digits);
+    byte_dfa_digits(dfa, exp_sign, exp_digits);
+    byte_dfa_digits(dfa, exp_digits, exp_digits);
+    return true;
+}
+
+// "..." with backslash escapes, not crossing a NUL
+static bool build_string(ByteDfa* dfa, int32_t pattern) {
+    uint16_t body = byte_dfa_add(dfa, -1);
+    uint16_t escape = byte_dfa_add(dfa, -1);
+    uint16_t closed = byte_dfa_add(dfa, pattern);
+    if (!closed) return false;
+
+    dfa->next[DFA_START]['"'] = body;
+    byte_dfa_range(dfa, body, 1, 255, body);
+    byte_dfa_range(dfa, escape, 1, 255, body);
+    dfa->next[body]['\\'] = escape;
+    dfa->next[body]['"'] = closed;
+    return true;
+}
+
+// Trie of OPERATORS
+static bool build_operator(ByteDfa* dfa, int32_t pattern) {
+    for (const char* const* op = OPERATORS; *op; op++) {
+        uint16_t state = DFA_START;
+        for (const unsigned char* c = (const unsigned char*)*op; *c; c++) {
+            uint16_t next = dfa->next[state][*c];
+            if (!next) {
+                next = byte_dfa_add(dfa, -1);
+                if (!next) return false;
+                dfa->next[state][*c] = next;
+            }
+            state = next;
+        }
+        dfa->accept[state] = pattern;
+    }
+    return true;
+}
+
+static bool (*builtin_builder(bool (*match)(const char*, size_t*)))(ByteDfa*, int32_t) {
+    if (match == polycall_tokenizer_match_identifier) return build_identifier;
+    if (match == polycall_tokenizer_match_number) return build_number;
+    if (match == polycall_tokenizer_match_string) return build_string;
+    if (match == polycall_tokenizer_match_operator) return build_operator;
+    return NULL;
+}
+
+static void dfa_destroy(PolycallTokenizerDfa* dfa) {
+    if (!dfa) return;
+    free(dfa->next);
+    free(dfa->accept);
+    free(dfa->custom);
+    free(dfa);
+}
+
+static inline uint16_t dfa_step(const PolycallTokenizerDfa* dfa, uint16_t state, unsigned char c) {
+    return dfa->next[(size_t)state * dfa->num_classes + dfa->classes[c]];
+}
+
+// Compress a byte-level DFA into class columns
+static PolycallTokenizerDfa* dfa_from_bytes(const ByteDfa* bytes) {
+    PolycallTokenizerDfa* dfa = calloc(1, sizeof(PolycallTokenizerDfa));
+    if (!dfa) return NULL;
+
+    unsigned char representative[256];
+    for (int c = 0; c < 256; c++) {
+        uint16_t cls = 0;
+        for (; cls < dfa->num_classes; cls++) {
+            int r = representative[cls];
+            uint16_t s = 0;
+            while (s < bytes->count && bytes->next[s][c] == bytes->next[s][r]) s++;
+            if (s == bytes->count) break;
+        }
+        if (cls == dfa->num_classes) representative[dfa->num_classes++] = (unsigned char)c;
+        dfa->classes[c] = (uint8_t)cls;
+    }
+
+    dfa->num_states = bytes->count;
+    dfa->next = malloc((size_t)dfa->num_states * dfa->num_classes * sizeof(uint16_t));
+    dfa->accept = malloc((size_t)dfa->num_states * sizeof(int32_t));
+    if (!dfa->next || !dfa->accept) {
+        dfa_destroy(dfa);
+        return NULL;
+    }
+    for (uint16_t s = 0; s < dfa->num_states; s++) {
+        for (uint16_t cls = 0; cls < dfa->num_classes; cls++) {
+            dfa->next[(size_t)s * dfa->num_classes + cls] = bytes->next[s][representative[cls]];
+        }
+        dfa->accept[s] = bytes->accept[s];
+    }
+    return dfa;
+}
+
+static inline int32_t earliest(int32_t a, int32_t b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    return a < b ? a : b;
+}
+
+// Product of two DFAs; b's pattern indices are shifted by offset. Either
+// may be NULL. Returns NULL when both are, or on failure (*failed set).
+static PolycallTokenizerDfa* dfa_merge(const PolycallTokenizerDfa* a, const PolycallTokenizerDfa* b,
+                                       size_t offset, bool* failed) {
+    *failed = false;
+    if (!a && !b) return NULL;
+
+    ByteDfa out;
+    uint32_t* pairs = NULL;             // Product state -> (a state << 16 | b state)
+    if (!byte_dfa_init(&out) || !(pairs = malloc(DFA_MAX_STATES * sizeof(uint32_t)))) {
+        byte_dfa_free(&out);
+        *failed = true;
+        return NULL;
+    }
+    pairs[DFA_DEAD] = 0;
+    pairs[DFA_START] = (uint32_t)(a ? DFA_START : 0) << 16 | (b ? DFA_START : 0);
+
+    for (uint16_t s = DFA_START; s < out.count && !*failed; s++) {
+        uint16_t sa = pairs[s] >> 16, sb = pairs[s] & 0xFFFF;
+        int32_t accept_b = sb && b->accept[sb] >= 0 ? b->accept[sb] + (int32_t)offset : -1;
+        out.accept[s] = earliest(sa ? a->accept[sa] : -1, accept_b);
+
+        for (int c = 0; c < 256; c++) {
+            uint16_t na = sa ? dfa_step(a, sa, (unsigned char)c) : 0;
+            uint16_t nb = sb ? dfa_step(b, sb, (unsigned char)c) : 0;
+            if (!na && !nb) continue;
+            uint32_t key = (uint32_t)na << 16 | nb;
+
+            // States are few; a linear search keeps this simple
+            uint16_t target = 0;
+            for (uint16_t t = DFA_START; t < out.count; t++) {
+                if (pairs[t] == key) { target = t; break; }
+            }
+            if (!target) {
+                target = byte_dfa_add(&out, -1);
+                if (!target) { *failed = true; break; }
+                pairs[target] = key;
+            }
+            out.next[s][c] = target;
+        }
+    }
+
+    PolycallTokenizerDfa* merged = *failed ? NULL : dfa_from_bytes(&out);
+    if (!*failed && !merged) *failed = true;
+    free(pairs);
+    byte_dfa_free(&out);
+    return merged;
+}
+
+static bool dfa_add_custom(PolycallTokenizerDfa* dfa, const size_t* custom, size_t count, size_t offset) {
+    if (count == 0) return true;
+    size_t* grown = realloc(dfa->custom, (dfa->custom_count + count) * sizeof(size_t));
+    if (!grown) return false;
+    for (size_t i = 0; i < count; i++) grown[dfa->custom_count + i] = custom[i] + offset;
+    dfa->custom = grown;
+    dfa->custom_count += count;
+    return true;
+}
+
+// Compile a pattern list. Always returns a DFA (possibly with no
+// built-ins) so custom patterns are listed too; NULL only on failure.
+static PolycallTokenizerDfa* compile_patterns(const TokenPattern* patterns, size_t count) {
+    PolycallTokenizerDfa* compiled = NULL;
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        bool (*build)(ByteDfa*, int32_t) = builtin_builder(patterns[i].match);
+        if (!build) continue;
+
+        // Built one at a time and merged, so overlapping starts stay separate
+        ByteDfa single;
+        PolycallTokenizerDfa* part = NULL;
+        ok = byte_dfa_init(&single) && build(&single, (int32_t)i) && (part = dfa_from_bytes(&single));
+        byte_dfa_free(&single);
+        if (!ok) break;
+
+        bool failed;
+        PolycallTokenizerDfa* merged = dfa_merge(compiled, part, 0, &failed);
+        dfa_destroy(part);
+        ok = !failed;
+        if (ok) {
+            dfa_destroy(compiled);
+            compiled = merged;
+        }
+    }
+
+    if (ok && !compiled) {
+        // No built-ins: a DFA that is dead from the start
+        ByteDfa empty;
+        ok = byte_dfa_init(&empty) && (compiled = dfa_from_bytes(&empty));
+        byte_dfa_free(&empty);
+    }
+    for (size_t i = 0; i < count && ok; i++) {
+        if (!builtin_builder(patterns[i].match)) ok = dfa_add_custom(compiled, &i, 1, 0);
+    }
+    if (!ok) {
+        dfa_destroy(compiled);
+        return NULL;
+    }
+    return compiled;
+}
+
+// Longest match at input over the DFA and the custom patterns, earlier
+// pattern winning ties. Custom matchers see custom_input instead, which
+// must be terminated after custom_available bytes. *open is set when the
+// DFA was still alive at the end of input, so more input could extend
+// the match. Returns the pattern index or -1.
+static int32_t dfa_match(const PolycallTokenizerDfa* dfa, const TokenizerOperations* ops,
+                         const char* input, size_t available,
+                         const char* custom_input, size_t custom_available,
+                         size_t* length, bool* open) {
+    int32_t best = -1;
+    size_t best_length = 0;
+
+    uint16_t state = DFA_START;
+    size_t i = 0;
+    for (; i < available; i++) {
+        state = dfa_step(dfa, state, (unsigned char)input[i]);
+        if (state == DFA_DEAD) break;
+        if (dfa->accept[state] >= 0) {
+            best = dfa->accept[state];
+            best_length = i + 1;
+        }
+    }
+    *open = i == available;
+
+    for (size_t i = 0; i < dfa->custom_count; i++) {
+        size_t pattern = dfa->custom[i];
+        size_t custom_length = 0;
+        if (!ops->patterns[pattern].match(custom_input, &custom_length) || custom_length == 0 ||
+            custom_length > custom_available) {
+            continue;
+        }
+        if (custom_length > best_length ||
+            (custom_length == best_length && (int32_t)pattern < best)) {
+            best = (int32_t)pattern;
+            best_length = custom_length;
+        }
+    }
+
+    *length = best_length;
+    return best;
+}
+
 // Tokenizer management functions
 PolycallTokenizer* polycall_tokenizer_create(const PolycallTokenizerConfig* config) {
     PolycallTokenizer* tokenizer = calloc(1, sizeof(PolycallTokenizer));
@@ -158,14 +508,7 @@ PolycallTokenizer* polycall_tokenizer_create(const PolycallTokenizerConfig* conf
     const PolycallTokenizerConfig* actual_config = 
         config ? config : &POLYCALL_TOKENIZER_DEFAULT_CONFIG;
     
-    // Allocate input buffer
-    tokenizer->input.buffer = malloc(actual_config->limits.buffer);
-    if (!tokenizer->input.buffer) {
-        free(tokenizer);
-        return NULL;
-    }
-    
-    tokenizer->input.size = actual_config->limits.buffer;
+    // The input buffer is allocated by set_input; streaming never needs it
     tokenizer->config = actual_config;
     
     // Initialize token array
@@ -174,7 +517,6 @@ PolycallTokenizer* polycall_tokenizer_create(const PolycallTokenizerConfig* conf
     );
     
     if (!tokenizer->tokens) {
-        free(tokenizer->input.buffer);
         free(tokenizer);
         return NULL;
     }
@@ -198,6 +540,7 @@ void polycall_tokenizer_destroy(PolycallTokenizer* tokenizer) {
         free(tokenizer->state.error_message);
     }
     
+    free(tokenizer->stream.carry);
     free(tokenizer);
 }
 void polycall_tokenizer_reset(PolycallTokenizer* tokenizer) {
@@ -223,13 +566,21 @@ bool polycall_tokenizer_set_input(
         return false;
     }
     
-    if (length > tokenizer->input.size) {
+    // One byte stays free for the terminator the matchers rely on
+    if (length >= tokenizer->config->limits.buffer) {
         set_error_state(tokenizer, ERROR_BUFFER_OVERFLOW);
         return false;
     }
     
+    if (!tokenizer->input.buffer) {
+        tokenizer->input.buffer = malloc(tokenizer->config->limits.buffer);
+        if (!tokenizer->input.buffer) return false;
+        tokenizer->input.size = tokenizer->config->limits.buffer;
+    }
+    
     memcpy(tokenizer->input.buffer, input, length);
     tokenizer->input.buffer[length] = '\0';
+    tokenizer->input.length = length;
     tokenizer->input.position = 0;
     
     reset_state(tokenizer);
@@ -260,14 +611,22 @@ static PolycallToken create_token(
             token.value.data.string_value.length = length;
             break;
             
-        case TOKEN_NUMBER:
-            token.value.type = VALUE_FLOAT;
-            token.value.data.float_value = strtod(start, NULL);
-            if (strchr(start, '.') == NULL) {
+        case TOKEN_NUMBER: {
+            // Parse a terminated copy: a streamed chunk has no terminator,
+            // and strtod would also read on past the token ("0x1p3")
+            char digits[64];
+            size_t n = length < sizeof(digits) ? length : sizeof(digits) - 1;
+            memcpy(digits, start, n);
+            digits[n] = '\0';
+            if (strpbrk(digits, ".eE") == NULL) {
                 token.value.type = VALUE_INTEGER;
-                token.value.data.int_value = strtoll(start, NULL, 10);
+                token.value.data.int_value = strtoll(digits, NULL, 10);
+            } else {
+                token.value.type = VALUE_FLOAT;
+                token.value.data.float_value = strtod(digits, NULL);
             }
             break;
+        }
             
         case TOKEN_STRING:
             token.value.type = VALUE_STRING;
@@ -281,6 +640,31 @@ static PolycallToken create_token(
     
     return token;
 }
+
+static void advance_position(PolycallTokenizer* tokenizer, const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            tokenizer->position.line++;
+            tokenizer->position.column = 1;
+        } else {
+            tokenizer->position.column++;
+        }
+    }
+}
+
+static void emit_token(PolycallTokenizer* tokenizer, const TokenizerOperations* ops,
+                       int32_t pattern, const char* start, size_t length) {
+    PolycallToken token = create_token(tokenizer, ops->patterns[pattern].produces, start, length);
+    if (ops->consumers[pattern].accepts == token.type && ops->consumers[pattern].consume) {
+        ops->consumers[pattern].consume(&token);
+    }
+    if (tokenizer->tokens && tokenizer->tokens->count < tokenizer->tokens->capacity) {
+        tokenizer->tokens->tokens[tokenizer->tokens->count++] = token;
+    }
+    // Strings may span lines
+    advance_position(tokenizer, start, length);
+}
+
 bool polycall_tokenizer_process(
     PolycallTokenizer* tokenizer,
     const TokenizerOperations* ops
@@ -289,7 +673,7 @@ bool polycall_tokenizer_process(
     
     tokenizer->state.current = TOKENIZER_STATE_SCANNING;
     
-    while (tokenizer->input.position < tokenizer->input.size) {
+    while (tokenizer->input.position < tokenizer->input.length) {
         const char* current = tokenizer->input.buffer + tokenizer->input.position;
         
         // Skip whitespace
@@ -304,6 +688,22 @@ bool polycall_tokenizer_process(
             continue;
         }
         
+        if (ops->dfa) {
+            size_t available = tokenizer->input.length - tokenizer->input.position;
+            size_t length = 0;
+            bool open = false;
+            int32_t pattern = dfa_match(ops->dfa, ops, current, available,
+                                        current, available, &length, &open);
+            if (pattern < 0) {
+                set_error_state(tokenizer, ERROR_INVALID_INPUT);
+                return false;
+            }
+
+            emit_token(tokenizer, ops, pattern, current, length);
+            tokenizer->input.position += length;
+            continue;
+        }
+        
         // Try each pattern matcher
         bool matched = false;
         for (size_t i = 0; i < ops->count; i++) {
@@ -359,6 +759,236 @@ bool polycall_tokenizer_process(
     return true;
 }
 
+/*
+ * Streaming input. Tokens are matched in the caller's chunk and point into
+ * it. A token that reaches the end of a chunk might continue in the next
+ * one, so its bytes (at most stream.limit) move to the carry buffer. The
+ * next feed joins the carry with the head of the new chunk in the window
+ * buffer, finishes every token that starts in the carry there, and goes
+ * back to matching in the chunk itself.
+ */
+typedef enum {
+    SCAN_DONE,                    // Every token starting before stop matched
+    SCAN_FULL,                    // Token array is full
+    SCAN_PENDING,                 // Token at *offset may go on past length
+    SCAN_ERROR
+} ScanResult;
+
+static bool stream_reserve(PolycallTokenizer* tokenizer) {
+    if (tokenizer->stream.carry) return true;
+
+    const PolycallTokenizerConfig* config = tokenizer->config;
+    size_t limit = config->limits.token;
+    if (config->limits.string + 2 > limit) limit = config->limits.string + 2;
+
+    // carry: limit, window: carry plus limit bytes of chunk, scratch: limit + 1
+    char* block = malloc(limit * 4 + 1);
+    if (!block) return false;
+    tokenizer->stream.carry = block;
+    tokenizer->stream.window = block + limit;
+    tokenizer->stream.scratch = block + limit * 3;
+    tokenizer->stream.limit = limit;
+    tokenizer->stream.carry_length = 0;
+    return true;
+}
+
+// Match tokens starting in data[*offset, stop); data[stop, length) is
+// lookahead. final means nothing follows data[length).
+static ScanResult scan_tokens(PolycallTokenizer* tokenizer, const TokenizerOperations* ops,
+                              const char* data, size_t stop, size_t length, bool final,
+                              size_t* offset) {
+    const PolycallTokenizerDfa* dfa = ops->dfa;
+    size_t limit = tokenizer->stream.limit;
+    size_t pos = *offset;
+
+    while (pos < stop) {
+        if (isspace((unsigned char)data[pos])) {
+            advance_position(tokenizer, data + pos, 1);
+            pos++;
+            continue;
+        }
+        if (tokenizer->tokens && tokenizer->tokens->count == tokenizer->tokens->capacity) {
+            *offset = pos;
+            return SCAN_FULL;
+        }
+
+        // Custom matchers expect a terminator, so they get a bounded copy
+        size_t available = length - pos;
+        const char* custom_input = data + pos;
+        size_t custom_available = available;
+        if (dfa->custom_count > 0) {
+            custom_available = available < limit ? available : limit;
+            memcpy(tokenizer->stream.scratch, data + pos, custom_available);
+            tokenizer->stream.scratch[custom_available] = '\0';
+            custom_input = tokenizer->stream.scratch;
+        }
+
+        size_t token_length = 0;
+        bool open = false;
+        int32_t pattern = dfa_match(dfa, ops, data + pos, available,
+                                    custom_input, custom_available, &token_length, &open);
+        if (!final && (open || (dfa->custom_count > 0 && custom_available == available))) {
+            if (available > limit) {
+                set_error_state(tokenizer, ERROR_TOKEN_TOO_LONG);
+                return SCAN_ERROR;
+            }
+            *offset = pos;
+            return SCAN_PENDING;
+        }
+        if (pattern < 0) {
+            set_error_state(tokenizer, ERROR_INVALID_INPUT);
+            return SCAN_ERROR;
+        }
+
+        emit_token(tokenizer, ops, pattern, data + pos, token_length);
+        pos += token_length;
+    }
+
+    *offset = pos;
+    return SCAN_DONE;
+}
+
+// Append TOKEN_EOF and end the stream, unless the token array is full
+static void finish_stream(PolycallTokenizer* tokenizer) {
+    if (tokenizer->tokens && tokenizer->tokens->count == tokenizer->tokens->capacity) {
+        return;
+    }
+
+    PolycallToken eof_token = {
+        .type = TOKEN_EOF,
+        .value = { .type = VALUE_NONE },
+        .flags = TOKEN_FLAG_NONE,
+        .line = tokenizer->position.line,
+        .column = tokenizer->position.column,
+        .length = 0
+    };
+    if (tokenizer->tokens) {
+        tokenizer->tokens->tokens[tokenizer->tokens->count++] = eof_token;
+    }
+
+    tokenizer->state.current = TOKENIZER_STATE_EOF;
+}
+
+static bool feed_chunk(
+    PolycallTokenizer* tokenizer,
+    const TokenizerOperations* ops,
+    const char* chunk,
+    size_t length,
+    size_t* consumed,
+    bool last
+) {
+    if (!tokenizer || !ops || (!chunk && length > 0) || !consumed) return false;
+    *consumed = 0;
+    if (!ops->dfa) {
+        set_error_state(tokenizer, ERROR_NO_DFA);
+        return false;
+    }
+    if (!stream_reserve(tokenizer)) return false;
+
+    tokenizer->state.current = TOKENIZER_STATE_SCANNING;
+    if (tokenizer->tokens) tokenizer->tokens->count = 0;
+
+    size_t limit = tokenizer->stream.limit;
+    size_t offset = 0;
+
+    size_t carried = tokenizer->stream.carry_length;
+    if (carried > 0) {
+        // Only as much of the chunk as a token starting in the carry can use
+        size_t head = length < limit ? length : limit;
+        char* window = tokenizer->stream.window;
+        memcpy(window, tokenizer->stream.carry, carried);
+        memcpy(window + carried, chunk, head);
+
+        size_t pos = 0;
+        ScanResult result = scan_tokens(tokenizer, ops, window, carried, carried + head,
+                                        last && head == length, &pos);
+        switch (result) {
+            case SCAN_ERROR:
+                return false;
+            case SCAN_FULL:
+                // Not into the chunk yet; keep the rest of the carry
+                tokenizer->stream.carry_length = carried - pos;
+                memcpy(tokenizer->stream.carry, window + pos, carried - pos);
+                return true;
+            case SCAN_PENDING:
+                // head is the whole chunk here, or the token would be too long
+                tokenizer->stream.carry_length = carried + head - pos;
+                memcpy(tokenizer->stream.carry, window + pos, carried + head - pos);
+                *consumed = length;
+                return true;
+            case SCAN_DONE:
+                break;
+        }
+        tokenizer->stream.carry_length = 0;
+        offset = pos - carried;
+    }
+
+    switch (scan_tokens(tokenizer, ops, chunk, length, length, last, &offset)) {
+        case SCAN_ERROR:
+            return false;
+        case SCAN_FULL:
+            *consumed = offset;
+            return true;
+        case SCAN_PENDING:
+            tokenizer->stream.carry_length = length - offset;
+            memcpy(tokenizer->stream.carry, chunk + offset, length - offset);
+            break;
+        case SCAN_DONE:
+            if (last) finish_stream(tokenizer);
+            break;
+    }
+    *consumed = length;
+    return true;
+}
+
+bool polycall_tokenizer_feed(
+    PolycallTokenizer* tokenizer,
+    const TokenizerOperations* ops,
+    const char* chunk,
+    size_t length,
+    size_t* consumed
+) {
+    return feed_chunk(tokenizer, ops, chunk, length, consumed, false);
+}
+
+bool polycall_tokenizer_feed_last(
+    PolycallTokenizer* tokenizer,
+    const TokenizerOperations* ops,
+    const char* chunk,
+    size_t length,
+    size_t* consumed
+) {
+    return feed_chunk(tokenizer, ops, chunk, length, consumed, true);
+}
+
+bool polycall_tokenizer_finish(PolycallTokenizer* tokenizer, const TokenizerOperations* ops) {
+    if (!tokenizer || !ops) return false;
+    if (!ops->dfa) {
+        set_error_state(tokenizer, ERROR_NO_DFA);
+        return false;
+    }
+    if (!stream_reserve(tokenizer)) return false;
+
+    tokenizer->state.current = TOKENIZER_STATE_SCANNING;
+    if (tokenizer->tokens) tokenizer->tokens->count = 0;
+
+    size_t carried = tokenizer->stream.carry_length;
+    if (carried > 0) {
+        char* window = tokenizer->stream.window;
+        memcpy(window, tokenizer->stream.carry, carried);
+
+        size_t pos = 0;
+        ScanResult result = scan_tokens(tokenizer, ops, window, carried, carried, true, &pos);
+        if (result == SCAN_ERROR) return false;
+        tokenizer->stream.carry_length = carried - pos;
+        memcpy(tokenizer->stream.carry, window + pos, carried - pos);
+        if (result == SCAN_FULL) return true;
+    }
+
+    finish_stream(tokenizer);
+    return true;
+}
+
 // Operation management
 TokenizerOperations* polycall_tokenizer_create_ops(
     TokenPattern* patterns,
@@ -367,7 +997,7 @@ TokenizerOperations* polycall_tokenizer_create_ops(
 ) {
     if (!patterns || !consumers || count == 0) return NULL;
     
-    TokenizerOperations* ops = malloc(sizeof(TokenizerOperations));
+    TokenizerOperations* ops = calloc(1, sizeof(TokenizerOperations));
     if (!ops) return NULL;
     
     ops->patterns = malloc(sizeof(TokenPattern) * count);
@@ -382,6 +1012,11 @@ TokenizerOperations* polycall_tokenizer_create_ops(
     memcpy(ops->consumers, consumers, sizeof(TokenConsumer) * count);
     ops->count = count;
     
+    ops->dfa = compile_patterns(patterns, count);
+    if (!ops->dfa) {
+        polycall_tokenizer_destroy_ops(ops);
+        return NULL;
+    }
     return ops;
 }
 
@@ -392,7 +1027,7 @@ TokenizerOperations* polycall_tokenizer_compose_ops(
     if (!ops1 || !ops2) return NULL;
     
     size_t total_count = ops1->count + ops2->count;
-    TokenizerOperations* result = malloc(sizeof(TokenizerOperations));
+    TokenizerOperations* result = calloc(1, sizeof(TokenizerOperations));
     if (!result) return NULL;
     
     result->patterns = malloc(sizeof(TokenPattern) * total_count);
@@ -411,6 +1046,29 @@ TokenizerOperations* polycall_tokenizer_compose_ops(
     memcpy(result->consumers + ops1->count, ops2->consumers, sizeof(TokenConsumer) * ops2->count);
     
     result->count = total_count;
+    
+    // Merge the compiled DFAs rather than recompiling the combined list
+    PolycallTokenizerDfa* first = ops1->dfa ? ops1->dfa : compile_patterns(ops1->patterns, ops1->count);
+    PolycallTokenizerDfa* second = ops2->dfa ? ops2->dfa : compile_patterns(ops2->patterns, ops2->count);
+    bool failed = !first || !second;
+    if (!failed) {
+        result->dfa = dfa_merge(first, second, ops1->count, &failed);
+        if (!failed && !result->dfa) {
+            ByteDfa empty;
+            failed = !(byte_dfa_init(&empty) && (result->dfa = dfa_from_bytes(&empty)));
+            byte_dfa_free(&empty);
+        }
+    }
+    if (!failed) {
+        failed = !dfa_add_custom(result->dfa, first->custom, first->custom_count, 0) ||
+                 !dfa_add_custom(result->dfa, second->custom, second->custom_count, ops1->count);
+    }
+    if (first != ops1->dfa) dfa_destroy(first);
+    if (second != ops2->dfa) dfa_destroy(second);
+    if (failed) {
+        polycall_tokenizer_destroy_ops(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -419,6 +1077,7 @@ void polycall_tokenizer_destroy_ops(TokenizerOperations* ops) {
     
     if (ops->patterns) free(ops->patterns);
     if (ops->consumers) free(ops->consumers);
+    dfa_destroy(ops->dfa);
     free(ops);
 }
 
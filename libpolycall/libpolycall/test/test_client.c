@@ -0,0 +1,212 @@
+// Checks for the pooled, multiplexing client of polycall_client.c against
+// an echo server on a Unix socket
+#include "polycall_client.h"
+#include "network.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define CALLING_THREADS 8
+#define CALLS_PER_THREAD 2000
+#define POOL_CONNECTIONS 2
+
+typedef struct {
+    NetworkEndpoint endpoint;       // Outlives the handler's copy
+    polycall_protocol_context_t protocol;
+} ServerConnection;
+
+static polycall_context_t g_ctx;
+static NetworkProgram server_program;
+static ServerConnection* server_connections[1024];
+static atomic_bool server_stop;
+
+static void server_on_handshake(polycall_protocol_context_t* ctx) {
+    polycall_protocol_complete_handshake(ctx);
+}
+
+static void server_on_command(polycall_protocol_context_t* ctx, const char* command, size_t length) {
+    assert(polycall_protocol_respond(ctx, ctx->current_sequence, command, length));
+}
+
+static void server_on_connect(NetworkEndpoint* endpoint) {
+    int fd = endpoint->socket_fd;
+    assert((size_t)fd < sizeof(server_connections) / sizeof(server_connections[0]));
+    ServerConnection* connection = calloc(1, sizeof(*connection));
+    connection->endpoint = *endpoint;
+    polycall_protocol_config_t config = {
+        .callbacks = {
+            .on_handshake = server_on_handshake,
+            .on_command = server_on_command
+        },
+        .capabilities = POLYCALL_CAP_PIPELINE
+    };
+    assert(polycall_protocol_init(&connection->protocol, g_ctx, &connection->endpoint, &config));
+    server_connections[fd] = connection;
+    polycall_protocol_start_handshake(&connection->protocol);
+}
+
+static void server_on_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    ServerConnection* connection = server_connections[endpoint->socket_fd];
+    if (connection && !polycall_protocol_process_packet(&connection->protocol, packet)) {
+        shutdown(endpoint->socket_fd, SHUT_RDWR);
+    }
+}
+
+static void server_on_disconnect(NetworkEndpoint* endpoint) {
+    ServerConnection* connection = server_connections[endpoint->socket_fd];
+    if (!connection) return;
+    server_connections[endpoint->socket_fd] = NULL;
+    polycall_protocol_cleanup(&connection->protocol);
+    free(connection);
+}
+
+static void* server_main(void* arg) {
+    (void)arg;
+    while (!server_stop) net_run(&server_program);
+    return NULL;
+}
+
+typedef struct {
+    polycall_client_pool_t* pool;
+    uint32_t thread;
+    _Atomic uint32_t completed;
+    _Atomic uint32_t mismatched;
+} CallJob;
+
+static CallJob g_jobs[CALLING_THREADS];
+
+// The request is the thread and call number; user_data carries the same
+static void on_completion(void* user_data, polycall_client_status_t status,
+                          const void* response, size_t length) {
+    uintptr_t expected = (uintptr_t)user_data;
+    CallJob* owner = &g_jobs[expected >> 16];
+    uint32_t got = 0;
+    if (status != POLYCALL_CLIENT_OK || length != sizeof(got)) {
+        atomic_fetch_add(&owner->mismatched, 1);
+    } else {
+        memcpy(&got, response, sizeof(got));
+        if (got != (uint32_t)expected) atomic_fetch_add(&owner->mismatched, 1);
+    }
+    atomic_fetch_add(&owner->completed, 1);
+}
+
+static void* call_many(void* arg) {
+    CallJob* job = arg;
+    for (uint32_t i = 0; i < CALLS_PER_THREAD; i++) {
+        uint32_t request = job->thread << 16 | i;
+        polycall_client_status_t status;
+        while ((status = polycall_client_call_async(job->pool, &request, sizeof(request),
+                                                    on_completion,
+                                                    (void*)(uintptr_t)request)) ==
+               POLYCALL_CLIENT_ERROR_BUSY) {
+            usleep(100);
+        }
+        assert(status == POLYCALL_CLIENT_OK);
+    }
+    return NULL;
+}
+
+void test_client_pool(const char* path) {
+    printf("Testing the client pool...\n");
+    polycall_client_config_t config = {
+        .unix_path = path,
+        .credentials = "secret",
+        .credentials_length = 6,
+        .max_connections = POOL_CONNECTIONS,
+        .max_inflight = 64
+    };
+    polycall_client_pool_t* pool = polycall_client_create(g_ctx, &config);
+    assert(pool);
+
+    // One call in and back, on a connection opened for it
+    void* response = NULL;
+    size_t length = 0;
+    assert(polycall_client_call(pool, "ping", 4, &response, &length) == POLYCALL_CLIENT_OK);
+    assert(length == 4 && memcmp(response, "ping", 4) == 0);
+    free(response);
+    assert(polycall_client_call(pool, NULL, 4, &response, &length) ==
+           POLYCALL_CLIENT_ERROR_INVALID);
+
+    // Many threads share the few connections, each response finding its call
+    pthread_t threads[CALLING_THREADS];
+    for (uint32_t t = 0; t < CALLING_THREADS; t++) {
+        g_jobs[t].pool = pool;
+        g_jobs[t].thread = t;
+        assert(pthread_create(&threads[t], NULL, call_many, &g_jobs[t]) == 0);
+    }
+    for (uint32_t t = 0; t < CALLING_THREADS; t++) pthread_join(threads[t], NULL);
+    for (uint32_t t = 0; t < CALLING_THREADS; t++) {
+        while (atomic_load(&g_jobs[t].completed) < CALLS_PER_THREAD) usleep(1000);
+        assert(atomic_load(&g_jobs[t].mismatched) == 0);
+    }
+
+    polycall_client_stats_t stats;
+    polycall_client_get_stats(pool, &stats);
+    assert(stats.connections <= POOL_CONNECTIONS && stats.connects <= POOL_CONNECTIONS);
+    assert(stats.responses == 1 + CALLING_THREADS * CALLS_PER_THREAD);
+    assert(stats.failures == 0 && stats.inflight == 0);
+    polycall_client_destroy(pool);
+    printf("  V %d calls over %zu connections, all matched\n",
+           CALLING_THREADS * CALLS_PER_THREAD, (size_t)stats.connects);
+}
+
+void test_no_server(void) {
+    printf("Testing a pool with no server...\n");
+    polycall_client_config_t config = {
+        .unix_path = "/tmp/polycall-test-nobody.sock",
+        .timeout_ms = 200
+    };
+
+    // Credentials are required up front
+    assert(polycall_client_create(g_ctx, &config) == NULL);
+    config.credentials = "secret";
+    config.credentials_length = 6;
+    polycall_client_pool_t* pool = polycall_client_create(g_ctx, &config);
+    assert(pool);
+    void* response = NULL;
+    size_t length = 0;
+    assert(polycall_client_call(pool, "x", 1, &response, &length) ==
+           POLYCALL_CLIENT_ERROR_CONNECT);
+    polycall_client_stats_t stats;
+    polycall_client_get_stats(pool, &stats);
+    assert(stats.connect_failures == 1 && stats.connections == 0);
+    assert(strcmp(polycall_client_status_name(POLYCALL_CLIENT_ERROR_CONNECT), "") != 0);
+    polycall_client_destroy(pool);
+    printf("  V Connect failure reported and counted\n");
+}
+
+int main(void) {
+    polycall_config_t config = { 0 };
+    assert(polycall_init_with_config(&g_ctx, &config) == POLYCALL_SUCCESS);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/polycall-test-%d.sock", (int)getpid());
+    net_init_program_unix(&server_program, NET_EVENT_AUTO, NET_UNIX, path);
+    assert(server_program.endpoints && server_program.count == 1);
+    server_program.handlers.on_connect = server_on_connect;
+    server_program.handlers.on_receive = server_on_receive;
+    server_program.handlers.on_disconnect = server_on_disconnect;
+    pthread_t server;
+    assert(pthread_create(&server, NULL, server_main, NULL) == 0);
+
+    test_client_pool(path);
+    test_no_server();
+
+    server_stop = true;
+    pthread_join(server, NULL);
+    for (size_t i = 0; i < sizeof(server_connections) / sizeof(server_connections[0]); i++) {
+        if (server_connections[i]) {
+            polycall_protocol_cleanup(&server_connections[i]->protocol);
+            free(server_connections[i]);
+        }
+    }
+    net_cleanup_program(&server_program);
+    polycall_cleanup(g_ctx);
+    printf("All client tests passed\n");
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Checks that listening sockets and state pass to a successor, and on to
+// the one after it, through network_handoff.c
+#include "network_handoff.h"
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define STATE_SIZE 100000
+
+typedef struct {
+    const char* path;
+    NetworkHandoff* handoff;        // Confirmed, listening for the next one
+    NetworkHandoffListener listener;
+    size_t count;
+    unsigned char* state;
+    size_t state_size;
+} Successor;
+
+static void* take_over(void* arg) {
+    Successor* successor = arg;
+    void* state = NULL;
+    successor->handoff = net_handoff_take(successor->path, 5000, &successor->listener, 1,
+                                          &successor->count, &state, &successor->state_size);
+    assert(successor->handoff && successor->count == 1);
+    successor->state = state;
+    assert(net_handoff_confirm(successor->handoff));
+    return NULL;
+}
+
+// Offer until the successor thread has connected and confirmed
+static void hand_over(NetworkHandoff* from, Successor* to, const NetworkHandoffListener* listener,
+                      const void* state, size_t state_size) {
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, take_over, to) == 0);
+    while (!net_handoff_offer(from, listener, 1, state, state_size, 5000)) {
+        assert(errno == EAGAIN);
+        usleep(1000);
+    }
+    pthread_join(thread, NULL);
+}
+
+static uint16_t listen_tcp(int* fd) {
+    *fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(bind(*fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 && listen(*fd, 16) == 0);
+    socklen_t length = sizeof(addr);
+    assert(getsockname(*fd, (struct sockaddr*)&addr, &length) == 0);
+    return ntohs(addr.sin_port);
+}
+
+// A connection to port is accepted on fd
+static void check_accepts(int fd, uint16_t port) {
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(client, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    assert(write(client, "x", 1) == 1);
+    int served = accept(fd, NULL, NULL);
+    char byte = 0;
+    assert(served >= 0 && read(served, &byte, 1) == 1 && byte == 'x');
+    close(served);
+    close(client);
+}
+
+void test_handoff_chain(void) {
+    printf("Testing listener handoff...\n");
+    char path[64];
+    snprintf(path, sizeof(path), "@polycall-test-handoff-%d", (int)getpid());
+    NetworkHandoff* first = net_handoff_listen(path);
+    assert(first && net_handoff_fd(first) >= 0);
+
+    // Nobody waiting: the offer returns at once and changes nothing
+    NetworkHandoffListener listener = { -1, NET_TCP };
+    uint16_t port = listen_tcp(&listener.fd);
+    assert(!net_handoff_offer(first, &listener, 1, NULL, 0, 1000) && errno == EAGAIN);
+
+    static unsigned char state[STATE_SIZE];
+    for (size_t i = 0; i < sizeof(state); i++) state[i] = (unsigned char)(i * 31);
+    Successor second = { .path = path };
+    hand_over(first, &second, &listener, state, sizeof(state));
+    net_handoff_close(first);
+    close(listener.fd);
+
+    // The listener arrived as a new descriptor on the same socket
+    assert(second.listener.protocol == NET_TCP && second.listener.fd != listener.fd);
+    assert(second.state_size == sizeof(state) && memcmp(second.state, state, sizeof(state)) == 0);
+    check_accepts(second.listener.fd, port);
+
+    // The successor's handoff serves the next upgrade at the same path
+    Successor third = { .path = path };
+    hand_over(second.handoff, &third, &second.listener, NULL, 0);
+    net_handoff_close(second.handoff);
+    close(second.listener.fd);
+    assert(third.state == NULL && third.state_size == 0);
+    check_accepts(third.listener.fd, port);
+
+    // With its sender gone, taking again finds no daemon
+    net_handoff_close(third.handoff);
+    size_t count = 0;
+    void* none = NULL;
+    size_t none_size = 0;
+    NetworkHandoffListener nothing;
+    assert(net_handoff_take(path, 200, &nothing, 1, &count, &none, &none_size) == NULL);
+
+    close(third.listener.fd);
+    free(second.state);
+    printf("  V Port %u accepted after two handoffs, %d bytes of state intact\n", port, STATE_SIZE);
+}
+
+int main(void) {
+    test_handoff_chain();
+    printf("All handoff tests passed\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Checks for the leveled log of polycall_log.c: compile-time and runtime
+// filtering, and the asynchronous queue with its drop count
+#define POLYCALL_LOG_COMPILE_LEVEL 2
+#include "polycall_log.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOGGING_THREADS 4
+#define MESSAGES_PER_THREAD 20000
+
+static int evaluated;
+
+static int side_effect(void) {
+    return ++evaluated;
+}
+
+// Lines of the sink that carry text, counted from the start
+static size_t count_lines(FILE* sink, const char* text) {
+    fflush(sink);
+    rewind(sink);
+    char line[512];
+    size_t count = 0;
+    while (fgets(line, sizeof(line), sink)) count += strstr(line, text) != NULL;
+    fseek(sink, 0, SEEK_END);
+    return count;
+}
+
+void test_filtering(FILE* sink) {
+    printf("Testing log filtering...\n");
+    polycall_log_set_level(POLYCALL_LOG_LEVEL_TRACE);
+
+    // Below the compile level nothing is left, arguments included
+    POLYCALL_LOG_DEBUG("test", "debug %d", side_effect());
+    POLYCALL_LOG_TRACE("test", "trace %d", side_effect());
+    assert(evaluated == 0);
+
+    // Above it, the runtime level decides before anything is formatted
+    POLYCALL_LOG_INFO("test", "info %d", side_effect());
+    assert(evaluated == 1 && count_lines(sink, "INFO  test: info 1") == 1);
+    polycall_log_set_level(POLYCALL_LOG_LEVEL_WARN);
+    assert(polycall_log_get_level() == POLYCALL_LOG_LEVEL_WARN);
+    POLYCALL_LOG_INFO("test", "info %d", side_effect());
+    assert(evaluated == 1);
+    POLYCALL_LOG_WARN("test", "warn %d", side_effect());
+    assert(evaluated == 2 && count_lines(sink, "WARN  test: warn 2") == 1);
+
+    // Long messages are cut, not overrun
+    char long_text[POLYCALL_LOG_MESSAGE_MAX * 2];
+    memset(long_text, 'z', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    POLYCALL_LOG_ERROR("test", "%s", long_text);
+    assert(count_lines(sink, "ERROR test: zzz") == 1);
+    printf("  V Removed below INFO, filtered at run time above it\n");
+}
+
+static void* log_many(void* arg) {
+    int thread = (int)(intptr_t)arg;
+    for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+        POLYCALL_LOG_WARN("test", "thread %d message %d", thread, i);
+    }
+    return NULL;
+}
+
+void test_async_queue(FILE* sink) {
+    printf("Testing the asynchronous queue...\n");
+    assert(polycall_log_start());
+    size_t dropped_before = polycall_log_dropped();
+
+    pthread_t threads[LOGGING_THREADS];
+    for (int t = 0; t < LOGGING_THREADS; t++) {
+        assert(pthread_create(&threads[t], NULL, log_many, (void*)(intptr_t)t) == 0);
+    }
+    for (int t = 0; t < LOGGING_THREADS; t++) pthread_join(threads[t], NULL);
+    polycall_log_stop();
+
+    // Every message was either written, in its thread's order, or counted
+    size_t dropped = polycall_log_dropped() - dropped_before;
+    fflush(sink);
+    rewind(sink);
+    int last[LOGGING_THREADS];
+    for (int t = 0; t < LOGGING_THREADS; t++) last[t] = -1;
+    size_t written = 0, reported = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), sink)) {
+        const char* text = strstr(line, "test: thread ");
+        const char* note = strstr(line, "log: ");
+        int thread, message;
+        size_t lost;
+        if (note && sscanf(note, "log: %zu messages dropped", &lost) == 1) reported += lost;
+        if (!text || sscanf(text, "test: thread %d message %d", &thread, &message) != 2) continue;
+        assert(thread >= 0 && thread < LOGGING_THREADS && message > last[thread]);
+        last[thread] = message;
+        written++;
+    }
+    assert(written + dropped == (size_t)LOGGING_THREADS * MESSAGES_PER_THREAD);
+
+    // The log says so itself, down to drops after the writer's last pass
+    assert(reported == dropped);
+
+    // Stopped, writes are synchronous again
+    POLYCALL_LOG_WARN("test", "after stop");
+    assert(count_lines(sink, "test: after stop") == 1);
+    printf("  V %zu written in order, %zu dropped and counted\n", written, dropped);
+}
+
+int main(void) {
+    FILE* sink = tmpfile();
+    assert(sink);
+    polycall_log_set_sink(sink);
+    test_filtering(sink);
+    test_async_queue(sink);
+    polycall_log_set_sink(NULL);
+    fclose(sink);
+    printf("All log tests passed\n");
+    return 0;
+}
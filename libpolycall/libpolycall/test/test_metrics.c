@@ -0,0 +1,149 @@
+// Checks for the per-thread metric shards, the Prometheus exposition and
+// the HTTP endpoint of polycall_metrics.c
+#include "polycall_metrics.h"
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define RECORDING_THREADS 8
+#define RECORDS_PER_THREAD 100000
+
+static int g_counter;
+static int g_histogram;
+
+static void* record(void* arg) {
+    (void)arg;
+    for (int i = 0; i < RECORDS_PER_THREAD; i++) {
+        polycall_metrics_inc(g_counter);
+        polycall_metrics_observe(g_histogram, 1000);
+    }
+    return NULL;
+}
+
+static int64_t read_answer(void* user_data) {
+    return *(int64_t*)user_data;
+}
+
+// The exposition as one string, for the caller to free
+static char* exposition(void) {
+    char* text = NULL;
+    size_t length = 0;
+    FILE* out = open_memstream(&text, &length);
+    assert(out);
+    polycall_metrics_write(out);
+    fclose(out);
+    return text;
+}
+
+void test_sharded_counts(void) {
+    printf("Testing per-thread shards...\n");
+    g_counter = polycall_metrics_register_counter("test_records_total", "Records made by the test");
+    g_histogram = polycall_metrics_register_histogram("test_record_seconds", "Test latencies");
+    assert(g_counter >= POLYCALL_METRIC_COUNTER_BUILTIN);
+    assert(g_histogram >= POLYCALL_METRIC_HISTOGRAM_BUILTIN);
+    assert(polycall_metrics_register_counter("test_records_total", "again") == g_counter);
+
+    // Counts of threads that have exited are kept, and exact once quiet;
+    // two rounds let the second reuse the first round's shards
+    for (int round = 1; round <= 2; round++) {
+        pthread_t threads[RECORDING_THREADS];
+        for (int i = 0; i < RECORDING_THREADS; i++) {
+            assert(pthread_create(&threads[i], NULL, record, NULL) == 0);
+        }
+        for (int i = 0; i < RECORDING_THREADS; i++) pthread_join(threads[i], NULL);
+        uint64_t expected = (uint64_t)round * RECORDING_THREADS * RECORDS_PER_THREAD;
+        uint64_t sum = 0;
+        assert(polycall_metrics_counter_value(g_counter) == expected);
+        assert(polycall_metrics_histogram_count(g_histogram, &sum) == expected);
+        assert(sum == expected * 1000);
+    }
+
+    // Ids out of range are ignored
+    polycall_metrics_add(-1, 5);
+    polycall_metrics_add(POLYCALL_METRICS_MAX_COUNTERS, 5);
+    polycall_metrics_observe(POLYCALL_METRICS_MAX_HISTOGRAMS, 5);
+    printf("  V %d threads x %d records summed exactly\n", RECORDING_THREADS, RECORDS_PER_THREAD);
+}
+
+void test_exposition(void) {
+    printf("Testing the Prometheus exposition...\n");
+    int64_t answer = 42;
+    assert(polycall_metrics_register_gauge("test_answer", "A gauge", read_answer, &answer));
+
+    // 1000 ns falls in the bucket up to 1024 ns, and the ones above it
+    char* text = exposition();
+    char line[128];
+    uint64_t records = 2ull * RECORDING_THREADS * RECORDS_PER_THREAD;
+    assert(strstr(text, "# TYPE test_records_total counter\n"));
+    snprintf(line, sizeof(line), "\ntest_records_total %llu\n", (unsigned long long)records);
+    assert(strstr(text, line));
+    assert(strstr(text, "\ntest_record_seconds_bucket{le=\"5.12e-07\"} 0\n"));
+    snprintf(line, sizeof(line), "\ntest_record_seconds_bucket{le=\"1.024e-06\"} %llu\n",
+             (unsigned long long)records);
+    assert(strstr(text, line));
+    snprintf(line, sizeof(line), "\ntest_record_seconds_bucket{le=\"+Inf\"} %llu\n",
+             (unsigned long long)records);
+    assert(strstr(text, line));
+    assert(strstr(text, "\ntest_answer 42\n"));
+    assert(strstr(text, "# TYPE polycall_net_accepted_total counter\n"));
+    free(text);
+
+    // Gauges are read at scrape time and go away when unregistered
+    answer = -7;
+    text = exposition();
+    assert(strstr(text, "\ntest_answer -7\n"));
+    free(text);
+    polycall_metrics_unregister_gauge("test_answer");
+    text = exposition();
+    assert(!strstr(text, "test_answer"));
+    free(text);
+    printf("  V Counters, cumulative buckets and gauges\n");
+}
+
+void test_http_endpoint(void) {
+    printf("Testing the HTTP endpoint...\n");
+    uint16_t port = polycall_metrics_serve(NULL, 0);
+    assert(port != 0);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    const char* request = "GET /metrics HTTP/1.0\r\n\r\n";
+    assert(write(fd, request, strlen(request)) == (ssize_t)strlen(request));
+
+    static char response[65536];
+    size_t length = 0;
+    ssize_t got;
+    while ((got = read(fd, response + length, sizeof(response) - 1 - length)) > 0) {
+        length += (size_t)got;
+    }
+    response[length] = '\0';
+    close(fd);
+    assert(strncmp(response, "HTTP/1.0 200 OK\r\n", 17) == 0);
+    assert(strstr(response, "\r\n\r\n# HELP "));
+    assert(strstr(response, "\ntest_records_total "));
+
+    // Stopped, the port no longer answers
+    polycall_metrics_stop_serving();
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0);
+    close(fd);
+    printf("  V Served %zu bytes on port %u\n", length, port);
+}
+
+int main(void) {
+    test_sharded_counts();
+    test_exposition();
+    test_http_endpoint();
+    printf("All metrics tests passed\n");
+    return 0;
+}
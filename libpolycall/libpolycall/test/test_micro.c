@@ -0,0 +1,430 @@
+// Checks for the service handles, payload slab and arenas, batched
+// transform stages and cross-thread command rings of polycall_micro.c
+#include "polycall.h"
+#include "polycall_checksum.h"
+#include "polycall_micro.h"
+#include "polycall_diram.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef POLYCALL_WITH_DIRAM
+#include "diram/core/feature-alloc/feature_alloc.h"
+#endif
+
+#define RING_CAPACITY 64
+#define RING_PRODUCERS 4
+#define RING_CONSUMERS 4
+#define COMMANDS_PER_PRODUCER 50000
+#define RING_COMMANDS (RING_PRODUCERS * COMMANDS_PER_PRODUCER)
+
+static polycall_context_t make_context(void) {
+    polycall_context_t ctx = NULL;
+    polycall_config_t config = { 0 };
+    assert(polycall_init_with_config(&ctx, &config) == POLYCALL_SUCCESS);
+    return ctx;
+}
+
+static void make_micro(polycall_context_t ctx, PolycallMicroContext* micro) {
+    polycall_config_t config = { 0 };
+    config.user_data = ctx;
+    assert(polycall_micro_init(micro, &config) == POLYCALL_MICRO_SUCCESS);
+}
+
+void test_service_handles(polycall_context_t ctx) {
+    printf("Testing service handles...\n");
+    PolycallMicroContext micro;
+    make_micro(ctx, &micro);
+
+    assert(polycall_micro_create_service(&micro, 7, 0) == POLYCALL_MICRO_SUCCESS);
+    assert(polycall_micro_create_service(&micro, 9, 0) == POLYCALL_MICRO_SUCCESS);
+    PolycallServiceHandle first = polycall_micro_service_handle(&micro, 7);
+    assert(first != 0);
+    assert(polycall_micro_resolve(&micro, first) == polycall_micro_get_service(&micro, 7));
+    assert(polycall_micro_service_handle(&micro, 8) == 0);
+
+    // The slot goes to the next service, and the old handle stops resolving
+    assert(polycall_micro_destroy_service(&micro, 7) == POLYCALL_MICRO_SUCCESS);
+    assert(polycall_micro_resolve(&micro, first) == NULL);
+    assert(polycall_micro_create_service(&micro, 11, 0) == POLYCALL_MICRO_SUCCESS);
+    PolycallServiceHandle reused = polycall_micro_service_handle(&micro, 11);
+    assert((reused & 0xFFFF) == (first & 0xFFFF) && reused != first);
+    assert(polycall_micro_resolve(&micro, first) == NULL);
+    assert(polycall_micro_resolve(&micro, reused)->id == 11);
+    assert(polycall_micro_get_service(&micro, 7) == NULL);
+    assert(polycall_micro_get_active_services(&micro) == 2);
+
+    polycall_micro_cleanup(&micro);
+    printf("  V Stale handles resolve to nothing after slot reuse\n");
+}
+
+static PolycallCommand make_command(uint32_t id, uint32_t flags, uint8_t* payload, uint32_t size) {
+    PolycallCommand cmd = { 0 };
+    cmd.id = id;
+    cmd.flags = flags;
+    cmd.payload = payload;
+    cmd.payload_size = size;
+    return cmd;
+}
+
+void test_batch_queue(polycall_context_t ctx) {
+    printf("Testing batched command queues...\n");
+    PolycallMicroContext micro;
+    make_micro(ctx, &micro);
+    assert(polycall_micro_create_service(&micro, 1, 0) == POLYCALL_MICRO_SUCCESS);
+
+    // Payloads are copied, so the caller's buffer is reused at once
+    uint8_t scratch[32];
+    PolycallCommand cmds[POLYCALL_MICRO_MAX_COMMANDS + 8];
+    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_COMMANDS + 8; i++) {
+        cmds[i] = make_command(i, 0, scratch, 1 + i % sizeof(scratch));
+    }
+    PolycallCommandArray batch = { cmds, 0, POLYCALL_MICRO_MAX_COMMANDS + 8 };
+    for (uint32_t i = 0; i < 3; i++) {
+        memset(scratch, 0x10 + i, sizeof(scratch));
+        batch.commands = &cmds[i];
+        batch.count = 1;
+        assert(polycall_micro_batch_process(&micro, 1, &batch) == POLYCALL_MICRO_SUCCESS);
+    }
+    PolycallServiceState* service = polycall_micro_get_service(&micro, 1);
+    assert(service->command_queue.count == 3);
+    for (uint32_t i = 0; i < 3; i++) {
+        const PolycallCommand* queued = &service->command_queue.commands[i];
+        assert(queued->id == i && queued->payload != scratch);
+        for (uint32_t b = 0; b < queued->payload_size; b++) assert(queued->payload[b] == 0x10 + i);
+    }
+
+    // The queue stops at its limit, and clearing hands the slots back
+    batch.commands = cmds;
+    batch.count = POLYCALL_MICRO_MAX_COMMANDS + 8;
+    assert(polycall_micro_batch_process(&micro, 1, &batch) == POLYCALL_MICRO_SUCCESS);
+    assert(service->command_queue.count == POLYCALL_MICRO_MAX_COMMANDS);
+    assert(polycall_micro_clear_commands(&micro, 1) == POLYCALL_MICRO_SUCCESS);
+    assert(service->command_queue.count == 0);
+    for (int round = 0; round < 100; round++) {
+        batch.count = POLYCALL_MICRO_MAX_COMMANDS;
+        assert(polycall_micro_batch_process(&micro, 1, &batch) == POLYCALL_MICRO_SUCCESS);
+        assert(polycall_micro_clear_commands(&micro, 1) == POLYCALL_MICRO_SUCCESS);
+    }
+    assert(polycall_micro_clear_commands(&micro, 2) == POLYCALL_MICRO_ERROR_SERVICE);
+
+    polycall_micro_cleanup(&micro);
+    printf("  V Payloads copied, queue capped and cleared\n");
+}
+
+typedef struct {
+    size_t charged;
+    size_t limit;
+} TestSpace;
+
+static void* space_create(uint32_t service_id, size_t limit, void* user_data) {
+    (void)service_id;
+    atomic_int* spaces = user_data;
+    TestSpace* space = calloc(1, sizeof(TestSpace));
+    if (space) {
+        space->limit = limit;
+        atomic_fetch_add(spaces, 1);
+    }
+    return space;
+}
+
+static bool space_charge(void* space, size_t bytes) {
+    TestSpace* s = space;
+    if (s->charged + bytes > s->limit) return false;
+    s->charged += bytes;
+    return true;
+}
+
+static void space_uncharge(void* space, size_t bytes) {
+    ((TestSpace*)space)->charged -= bytes;
+}
+
+static atomic_int g_spaces = 0;
+
+static void space_destroy(void* space) {
+    atomic_fetch_sub(&g_spaces, 1);
+    free(space);
+}
+
+void test_service_arenas(polycall_context_t ctx) {
+    printf("Testing per-service arenas...\n");
+    PolycallMicroContext micro;
+    make_micro(ctx, &micro);
+    PolycallMemoryBackend backend = { space_create, space_charge, space_uncharge,
+                                      space_destroy, &g_spaces };
+    polycall_micro_set_memory_backend(&micro, &backend, 2 * POLYCALL_MICRO_SLAB_CHUNK);
+
+    assert(polycall_micro_create_service(&micro, 1, 0) == POLYCALL_MICRO_SUCCESS);
+    assert(atomic_load(&g_spaces) == 1);
+    PolycallServiceState* service = polycall_micro_get_service(&micro, 1);
+    assert(polycall_micro_service_memory(service) == 0);
+
+    uint8_t payload[POLYCALL_MICRO_BUFFER_SIZE];
+    memset(payload, 0x3c, sizeof(payload));
+    PolycallCommand cmds[POLYCALL_MICRO_MAX_COMMANDS];
+    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_COMMANDS; i++) {
+        cmds[i] = make_command(i, 0, payload, sizeof(payload));
+    }
+    PolycallCommandArray batch = { cmds, POLYCALL_MICRO_MAX_COMMANDS, POLYCALL_MICRO_MAX_COMMANDS };
+
+    // 64 full payloads do not fit under the cap
+    assert(polycall_micro_batch_process(&micro, 1, &batch) == POLYCALL_MICRO_ERROR_LIMIT);
+    size_t charged = polycall_micro_service_memory(service);
+    assert(charged > 0 && charged <= 2 * POLYCALL_MICRO_SLAB_CHUNK);
+
+    // Destroying the service frees the arena and its space in one go
+    assert(polycall_micro_destroy_service(&micro, 1) == POLYCALL_MICRO_SUCCESS);
+    assert(atomic_load(&g_spaces) == 0);
+
+    // Without a backend, services share the slab again
+    polycall_micro_set_memory_backend(&micro, NULL, 0);
+    assert(polycall_micro_create_service(&micro, 2, 0) == POLYCALL_MICRO_SUCCESS);
+    assert(atomic_load(&g_spaces) == 0);
+    assert(polycall_micro_batch_process(&micro, 2, &batch) == POLYCALL_MICRO_SUCCESS);
+    assert(polycall_micro_service_memory(polycall_micro_get_service(&micro, 2)) == 0);
+
+    polycall_micro_cleanup(&micro);
+    printf("  V Arenas capped at their limit and freed with the service\n");
+}
+
+#ifdef POLYCALL_WITH_DIRAM
+// The diram backend, with the space it creates kept for inspection
+static void* g_diram_space = NULL;
+
+static void* diram_space_recorded(uint32_t service_id, size_t limit, void* user_data) {
+    (void)user_data;
+    const PolycallMemoryBackend* diram = polycall_diram_backend();
+    g_diram_space = diram->space_create(service_id, limit, diram->user_data);
+    return g_diram_space;
+}
+
+void test_diram_arenas(polycall_context_t ctx) {
+    printf("Testing diram-backed arenas...\n");
+    PolycallMicroContext micro;
+    make_micro(ctx, &micro);
+    const PolycallMemoryBackend* diram = polycall_diram_backend();
+    PolycallMemoryBackend backend = *diram;
+    backend.space_create = diram_space_recorded;
+    polycall_micro_set_memory_backend(&micro, &backend, 2 * POLYCALL_MICRO_SLAB_CHUNK);
+
+    assert(polycall_micro_create_service(&micro, 7, 0) == POLYCALL_MICRO_SUCCESS);
+    assert(g_diram_space != NULL);
+    PolycallServiceState* service = polycall_micro_get_service(&micro, 7);
+
+    uint8_t payload[POLYCALL_MICRO_BUFFER_SIZE];
+    memset(payload, 0x5a, sizeof(payload));
+    PolycallCommand cmds[POLYCALL_MICRO_MAX_COMMANDS];
+    for (uint32_t i = 0; i < POLYCALL_MICRO_MAX_COMMANDS; i++) {
+        cmds[i] = make_command(i, 0, payload, sizeof(payload));
+    }
+    PolycallCommandArray batch = { cmds, POLYCALL_MICRO_MAX_COMMANDS, POLYCALL_MICRO_MAX_COMMANDS };
+
+    // The space refuses the chunk past its limit, and its usage is the
+    // arena's footprint, one allocation per chunk
+    assert(polycall_micro_batch_process(&micro, 7, &batch) == POLYCALL_MICRO_ERROR_LIMIT);
+    size_t used = 0;
+    uint32_t chunks = 0;
+    diram_space_get_usage(g_diram_space, &used, &chunks);
+    assert(used > 0 && used <= 2 * POLYCALL_MICRO_SLAB_CHUNK);
+    assert(used == polycall_micro_service_memory(service) && chunks > 0);
+
+    assert(polycall_micro_destroy_service(&micro, 7) == POLYCALL_MICRO_SUCCESS);
+    polycall_micro_cleanup(&micro);
+    printf("  V %zu bytes in %u chunks charged to the service's diram space\n", used, chunks);
+}
+#endif
+
+static uint32_t bswap_word(uint32_t word) {
+    return (word >> 24) | ((word >> 8) & 0xff00) | ((word << 8) & 0xff0000) | (word << 24);
+}
+
+void test_transform_stages(void) {
+    printf("Testing batched transform stages...\n");
+
+    // More commands than one block, with payload tails that are not whole words
+    enum { COMMANDS = POLYCALL_MICRO_TRANSFORM_BLOCK * 3 + 5, SIZE = 23 };
+    static uint8_t payloads[COMMANDS][SIZE];
+    static uint8_t expected[COMMANDS][SIZE];
+    PolycallCommand cmds[COMMANDS];
+    const uint32_t key = 0xa5c3961e;
+    for (uint32_t c = 0; c < COMMANDS; c++) {
+        for (uint32_t b = 0; b < SIZE; b++) payloads[c][b] = (uint8_t)(c * 31 + b * 7);
+        memcpy(expected[c], payloads[c], SIZE);
+        for (uint32_t w = 0; w + 4 <= SIZE; w += 4) {
+            uint32_t word;
+            memcpy(&word, &expected[c][w], 4);
+            word = bswap_word(word);
+            memcpy(&expected[c][w], &word, 4);
+        }
+        for (uint32_t b = 0; b < SIZE; b++) expected[c][b] ^= ((const uint8_t*)&key)[b % 4];
+        cmds[c] = make_command(c, c % 3 == 0 ? 0x12 : 0x02, payloads[c], SIZE);
+    }
+
+    PolycallTransformStage stages[4];
+    stages[0].kind = POLYCALL_STAGE_BSWAP32;
+    stages[1].kind = POLYCALL_STAGE_XOR;
+    stages[1].key = key;
+    stages[2].kind = POLYCALL_STAGE_FILTER_FLAGS;
+    stages[2].filter.mask = 0x10;
+    stages[2].filter.value = 0;
+    stages[3].kind = POLYCALL_STAGE_CHECKSUM;
+    PolycallStageChain chain = { stages, 4 };
+    PolycallCommandArray array = { cmds, COMMANDS, COMMANDS };
+    assert(polycall_micro_transform_batch(&array, &chain) == POLYCALL_MICRO_SUCCESS);
+
+    // The filter keeps order and closes the gaps across blocks
+    uint32_t kept = 0;
+    for (uint32_t c = 0; c < COMMANDS; c++) {
+        if (c % 3 == 0) continue;
+        const PolycallCommand* cmd = &array.commands[kept++];
+        assert(cmd->id == c);
+        assert(memcmp(cmd->payload, expected[c], SIZE) == 0);
+        assert(cmd->checksum == polycall_crc32c(0, expected[c], SIZE));
+    }
+    assert(array.count == kept);
+
+    // Filtered commands were still transformed before the filter stage
+    assert(memcmp(payloads[0], expected[0], SIZE) == 0);
+
+    PolycallTransformStage unknown = { .kind = (PolycallStageKind)99 };
+    PolycallStageChain bad = { &unknown, 1 };
+    assert(polycall_micro_transform_batch(&array, &bad) == POLYCALL_MICRO_ERROR_COMMAND);
+    printf("  V %u of %u commands kept with every stage applied\n", kept, (unsigned)COMMANDS);
+}
+
+typedef struct {
+    PolycallServiceState* service;
+    uint32_t first_id;
+} RingProducer;
+
+typedef struct {
+    PolycallServiceState* service;
+    _Atomic uint8_t* seen;
+    atomic_uint* remaining;
+} RingConsumer;
+
+static atomic_int g_full_events = 0;
+static atomic_int g_clear_events = 0;
+
+static void count_backpressure(uint32_t service_id, bool full, void* user_data) {
+    (void)service_id;
+    (void)user_data;
+    atomic_fetch_add(full ? &g_full_events : &g_clear_events, 1);
+}
+
+static void* produce(void* arg) {
+    RingProducer* producer = arg;
+    for (uint32_t i = 0; i < COMMANDS_PER_PRODUCER; i++) {
+        uint32_t id = producer->first_id + i;
+        uint32_t payload[2] = { id, ~id };
+        PolycallCommand cmd = make_command(id, 0, (uint8_t*)payload, sizeof(payload));
+        PolycallMicroStatus status;
+        while ((status = polycall_micro_enqueue(producer->service, &cmd, NULL)) ==
+               POLYCALL_MICRO_ERROR_FULL) {
+            sched_yield();
+        }
+        assert(status == POLYCALL_MICRO_SUCCESS);
+    }
+    return NULL;
+}
+
+static void* consume(void* arg) {
+    RingConsumer* consumer = arg;
+    PolycallQueuedCommand out[16];
+    while (atomic_load(consumer->remaining) > 0) {
+        uint32_t count = polycall_micro_dequeue_batch(consumer->service, out, 16);
+        if (count == 0) {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t id = out[i].command.id;
+            uint32_t payload[2];
+            assert(id < RING_COMMANDS && out[i].command.payload_size == sizeof(payload));
+            memcpy(payload, out[i].command.payload, sizeof(payload));
+            assert(payload[0] == id && payload[1] == ~id);
+            assert(atomic_fetch_add(&consumer->seen[id], 1) == 0);
+            net_buffer_release(out[i].buffer);
+        }
+        atomic_fetch_sub(consumer->remaining, count);
+    }
+    return NULL;
+}
+
+void test_command_ring(polycall_context_t ctx) {
+    printf("Testing cross-thread command rings...\n");
+    PolycallMicroContext micro;
+    make_micro(ctx, &micro);
+    assert(polycall_micro_create_service(&micro, 1, 0) == POLYCALL_MICRO_SUCCESS);
+    assert(polycall_micro_open_queue(&micro, 1, RING_CAPACITY - 1) == POLYCALL_MICRO_SUCCESS);
+    PolycallServiceState* service = polycall_micro_get_service(&micro, 1);
+    polycall_micro_set_backpressure(service, count_backpressure, NULL);
+
+    // Alone: fill to capacity, refuse one more, clear at half
+    uint8_t byte = 0;
+    PolycallCommand cmd = make_command(0, 0, &byte, 1);
+    for (uint32_t i = 0; i < RING_CAPACITY; i++) {
+        assert(polycall_micro_enqueue(service, &cmd, NULL) == POLYCALL_MICRO_SUCCESS);
+    }
+    assert(polycall_micro_queue_depth(service) == RING_CAPACITY);
+    assert(polycall_micro_enqueue(service, &cmd, NULL) == POLYCALL_MICRO_ERROR_FULL);
+    assert(polycall_micro_enqueue(service, &cmd, NULL) == POLYCALL_MICRO_ERROR_FULL);
+    assert(atomic_load(&g_full_events) == 1);
+
+    PolycallQueuedCommand out[RING_CAPACITY];
+    assert(polycall_micro_dequeue_batch(service, out, RING_CAPACITY / 2 - 1) == RING_CAPACITY / 2 - 1);
+    assert(atomic_load(&g_clear_events) == 0);
+    assert(polycall_micro_dequeue_batch(service, &out[RING_CAPACITY / 2 - 1], 1) == 1);
+    assert(atomic_load(&g_clear_events) == 1);
+    assert(polycall_micro_dequeue_batch(service, &out[RING_CAPACITY / 2], RING_CAPACITY) ==
+           RING_CAPACITY / 2);
+    assert(polycall_micro_dequeue_batch(service, out, RING_CAPACITY) == 0);
+    for (uint32_t i = 0; i < RING_CAPACITY; i++) net_buffer_release(out[i].buffer);
+
+    // Many producers and consumers: every command arrives once, intact
+    _Atomic uint8_t* seen = calloc(RING_COMMANDS, sizeof(*seen));
+    assert(seen);
+    atomic_uint remaining = RING_COMMANDS;
+    pthread_t producers[RING_PRODUCERS], consumers[RING_CONSUMERS];
+    RingProducer producer_args[RING_PRODUCERS];
+    RingConsumer consumer_args[RING_CONSUMERS];
+    for (int i = 0; i < RING_CONSUMERS; i++) {
+        consumer_args[i] = (RingConsumer){ service, seen, &remaining };
+        assert(pthread_create(&consumers[i], NULL, consume, &consumer_args[i]) == 0);
+    }
+    for (int i = 0; i < RING_PRODUCERS; i++) {
+        producer_args[i] = (RingProducer){ service, (uint32_t)i * COMMANDS_PER_PRODUCER };
+        assert(pthread_create(&producers[i], NULL, produce, &producer_args[i]) == 0);
+    }
+    for (int i = 0; i < RING_PRODUCERS; i++) pthread_join(producers[i], NULL);
+    for (int i = 0; i < RING_CONSUMERS; i++) pthread_join(consumers[i], NULL);
+
+    for (uint32_t id = 0; id < RING_COMMANDS; id++) assert(atomic_load(&seen[id]) == 1);
+    assert(polycall_micro_queue_depth(service) == 0);
+
+    // Every full report was followed by a clear once the ring drained
+    assert(atomic_load(&g_full_events) == atomic_load(&g_clear_events));
+
+    free(seen);
+    polycall_micro_cleanup(&micro);
+    printf("  V %d commands through %d producers and %d consumers, %d full reports\n",
+           RING_COMMANDS, RING_PRODUCERS, RING_CONSUMERS, atomic_load(&g_full_events));
+}
+
+int main(void) {
+    polycall_context_t ctx = make_context();
+    test_service_handles(ctx);
+    test_batch_queue(ctx);
+    test_service_arenas(ctx);
+#ifdef POLYCALL_WITH_DIRAM
+    test_diram_arenas(ctx);
+#endif
+    test_transform_stages();
+    test_command_ring(ctx);
+    polycall_cleanup(ctx);
+    printf("All micro service tests passed\n");
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Checks that sends to a readiness-driven client are queued whole behind
+// a full socket and written out in order as it drains (network.c)
+#include "network.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define FRAME_SIZE 32768
+#define FRAME_WORDS (FRAME_SIZE / sizeof(uint32_t))
+
+typedef struct {
+    uint32_t frames_sent;           // Accepted whole by net_sendv
+    uint32_t frames_wanted;
+    int refusal;                    // errno of the first refused send, or 0
+} SendJob;
+
+// Frame n is FRAME_WORDS words of n * FRAME_WORDS + i, so any byte out of
+// place or missing shows up in the reader
+static void fill_frame(uint32_t* words, uint32_t n) {
+    for (uint32_t i = 0; i < FRAME_WORDS; i++) words[i] = n * FRAME_WORDS + i;
+}
+
+static void on_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    (void)packet;
+    SendJob* job = endpoint->user_data;
+    static uint32_t words[FRAME_WORDS];
+    while (job->frames_sent < job->frames_wanted) {
+        fill_frame(words, job->frames_sent);
+
+        // Header and body in two pieces, so a cut can fall between them
+        struct iovec iov[2] = {
+            { words, 4 * sizeof(uint32_t) },
+            { words + 4, FRAME_SIZE - 4 * sizeof(uint32_t) }
+        };
+        ssize_t sent = net_sendv(endpoint, iov, 2);
+        if (sent < 0) {
+            job->refusal = errno;
+            break;
+        }
+        assert(sent == FRAME_SIZE);
+        job->frames_sent++;
+    }
+}
+
+static size_t unsent_bytes(NetworkProgram* program, int fd) {
+    pthread_mutex_lock(&program->clients_lock);
+    ClientState* client = program->clients[fd];
+    pthread_mutex_lock(&client->send_lock);
+    size_t length = client->unsent_length;
+    pthread_mutex_unlock(&client->send_lock);
+    pthread_mutex_unlock(&program->clients_lock);
+    return length;
+}
+
+// Have the server send frames_wanted frames to a reader that does not read
+// until the handler is done, then read them all back while net_run drains
+// the held bytes
+static void run_send_job(NetworkEventBackend backend, uint32_t frames_wanted, SendJob* job) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/polycall-test-%d.sock", (int)getpid());
+    NetworkProgram program;
+    net_init_program_unix(&program, backend, NET_UNIX, path);
+    assert(program.events);
+    *job = (SendJob){ 0, frames_wanted, 0 };
+    program.user_data = job;
+    program.handlers.on_receive = on_receive;
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    assert(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK) == 0);
+    struct sockaddr_in none = { 0 };
+    assert(net_add_client(&program, fds[0], none));
+    int reader = fds[1];
+
+    assert(write(reader, "go", 2) == 2);
+    net_run(&program);
+    assert(job->frames_sent > 0);
+
+    // The socket could not take everything, so the rest is held
+    size_t total = (size_t)job->frames_sent * FRAME_SIZE;
+    assert(unsent_bytes(&program, fds[0]) > 0);
+
+    static uint32_t frame[FRAME_WORDS], expected[FRAME_WORDS];
+    size_t received = 0, filled = 0;
+    uint32_t frames = 0;
+    while (received < total) {
+        ssize_t got = recv(reader, (char*)frame + filled, FRAME_SIZE - filled, MSG_DONTWAIT);
+        if (got > 0) {
+            received += (size_t)got;
+            filled += (size_t)got;
+            if (filled == FRAME_SIZE) {
+                fill_frame(expected, frames++);
+                assert(memcmp(frame, expected, FRAME_SIZE) == 0);
+                filled = 0;
+            }
+            continue;
+        }
+        assert(got < 0 && errno == EAGAIN);
+        net_run(&program);
+    }
+    assert(frames == job->frames_sent);
+
+    // Once everything is out, nothing more follows and nothing is held
+    assert(unsent_bytes(&program, fds[0]) == 0);
+    assert(recv(reader, frame, 1, MSG_DONTWAIT) < 0 && errno == EAGAIN);
+
+    close(reader);
+    net_cleanup_program(&program);
+}
+
+void test_held_sends(NetworkEventBackend backend) {
+    printf("Testing held sends with %s...\n", net_event_backend_name(backend));
+    SendJob job;
+    run_send_job(backend, 48, &job);
+    assert(job.frames_sent == 48 && job.refusal == 0);
+    printf("  V %u frames of %d bytes arrived whole and in order\n", job.frames_sent, FRAME_SIZE);
+}
+
+void test_unsent_limit(NetworkEventBackend backend) {
+    printf("Testing the held-bytes limit with %s...\n", net_event_backend_name(backend));
+
+    // More than NET_UNSENT_MAX can hold: the first send past it is refused
+    // whole, and every frame accepted before it still arrives
+    SendJob job;
+    uint32_t wanted = NET_UNSENT_MAX / FRAME_SIZE * 2;
+    run_send_job(backend, wanted, &job);
+    assert(job.refusal == ENOBUFS);
+    assert(job.frames_sent < wanted && job.frames_sent > NET_UNSENT_MAX / FRAME_SIZE);
+    printf("  V Refused after %u frames, none of them torn\n", job.frames_sent);
+}
+
+int main(void) {
+    NetworkEventBackend backends[] = { NET_EVENT_AUTO, NET_EVENT_SELECT };
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        test_held_sends(backends[i]);
+        test_unsent_limit(backends[i]);
+    }
+    printf("All network tests passed\n");
+    return 0;
+}
@@ -0,0 +1,308 @@
+// Checks for the arena AST, its copying passes, the optimizer levels and
+// the parse cache of polycall_parser.c
+#include "polycall_parser.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define WIDE_CHILDREN 200
+
+static PolycallASTIndex add(PolycallAST* ast, PolycallASTType type, const PolycallValue* value,
+                            const PolycallASTIndex* children, uint32_t count) {
+    PolycallASTIndex node = polycall_ast_add_node(ast, type, value);
+    assert(node != POLYCALL_AST_NO_NODE);
+    assert(polycall_ast_set_children(ast, node, children, count));
+    return node;
+}
+
+static PolycallValue integer(int64_t n) {
+    PolycallValue value = { .type = VALUE_INTEGER, .data.int_value = n };
+    return value;
+}
+
+static PolycallValue text(PolycallValueType type, const char* s) {
+    PolycallValue value = { .type = type };
+    value.data.string_value.data = s;
+    value.data.string_value.length = (uint32_t)strlen(s);
+    return value;
+}
+
+static PolycallASTIndex literal(PolycallAST* ast, int64_t n) {
+    PolycallValue value = integer(n);
+    return add(ast, AST_EXPRESSION, &value, NULL, 0);
+}
+
+static PolycallASTIndex name(PolycallAST* ast, const char* s) {
+    PolycallValue value = text(VALUE_IDENTIFIER, s);
+    return add(ast, AST_EXPRESSION, &value, NULL, 0);
+}
+
+static PolycallASTIndex apply(PolycallAST* ast, const char* op, PolycallASTIndex a, PolycallASTIndex b) {
+    PolycallValue value = text(VALUE_IDENTIFIER, op);
+    PolycallASTIndex operands[2] = { a, b };
+    return add(ast, AST_EXPRESSION, &value, operands, b == POLYCALL_AST_NO_NODE ? 1 : 2);
+}
+
+static PolycallASTIndex statement(PolycallAST* ast, PolycallASTIndex expr) {
+    return add(ast, AST_STATEMENT, NULL, &expr, 1);
+}
+
+static PolycallASTIndex block(PolycallAST* ast, const PolycallASTIndex* items, uint32_t count) {
+    return add(ast, AST_BLOCK, NULL, items, count);
+}
+
+static void count_nodes(PolycallASTNode* node, void* user_data) {
+    (void)node;
+    (*(uint32_t*)user_data)++;
+}
+
+void test_arena(void) {
+    printf("Testing the arena AST...\n");
+    PolycallAST* ast = polycall_ast_create(4);
+    PolycallASTIndex root = polycall_ast_add_node(ast, AST_PROGRAM, NULL);
+    PolycallASTIndex left = polycall_ast_add_node(ast, AST_BLOCK, NULL);
+    PolycallASTIndex right = polycall_ast_add_node(ast, AST_BLOCK, NULL);
+    ast->root = root;
+    assert(polycall_ast_add_child(ast, root, left) && polycall_ast_add_child(ast, root, right));
+
+    // Interleaved adds make the ranges move past each other as they grow
+    for (int i = 0; i < WIDE_CHILDREN; i++) {
+        PolycallASTIndex parent = i % 3 == 0 ? left : right;
+        assert(polycall_ast_add_child(ast, parent, literal(ast, i)));
+    }
+    uint32_t count = 0;
+    const PolycallASTIndex* children = polycall_ast_children(ast, left, &count);
+    assert(count == (WIDE_CHILDREN + 2) / 3);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(ast->nodes[children[i]].value.data.int_value == (int64_t)i * 3);
+        assert(ast->nodes[children[i]].parent == left);
+    }
+    children = polycall_ast_children(ast, right, &count);
+    assert(count == WIDE_CHILDREN - (WIDE_CHILDREN + 2) / 3);
+    assert(polycall_ast_validate(ast));
+    assert(polycall_ast_node(ast, ast->node_count) == NULL);
+    assert(!polycall_ast_add_child(ast, left, left));
+
+    uint32_t visited = 0;
+    polycall_ast_visit(ast, root, count_nodes, &visited);
+    assert(visited == ast->node_count);
+
+    // A node reachable twice without being marked shared is not a tree
+    assert(polycall_ast_add_child(ast, left, children[0]));
+    assert(!polycall_ast_validate(ast));
+
+    polycall_ast_destroy(ast);
+    printf("  V %d children over moving ranges\n", WIDE_CHILDREN);
+}
+
+// f() { 2 + 3; if ("a" == "a") { 1 } else { 0 }; x * y; x * y; 1 / 0 }
+static PolycallAST* build_function(void) {
+    PolycallAST* ast = polycall_ast_create(0);
+    PolycallValue if_name = text(VALUE_IDENTIFIER, "if");
+    PolycallValue a = text(VALUE_STRING, "a");
+    PolycallValue f = text(VALUE_IDENTIFIER, "f");
+
+    PolycallASTIndex then_body = statement(ast, literal(ast, 1));
+    PolycallASTIndex else_body = statement(ast, literal(ast, 0));
+    PolycallASTIndex branch[3] = {
+        apply(ast, "==", add(ast, AST_EXPRESSION, &a, NULL, 0), add(ast, AST_EXPRESSION, &a, NULL, 0)),
+        block(ast, &then_body, 1),
+        block(ast, &else_body, 1)
+    };
+    PolycallASTIndex statements[5] = {
+        statement(ast, apply(ast, "+", literal(ast, 2), literal(ast, 3))),
+        statement(ast, add(ast, AST_CONTROL_FLOW, &if_name, branch, 3)),
+        statement(ast, apply(ast, "*", name(ast, "x"), name(ast, "y"))),
+        statement(ast, apply(ast, "*", name(ast, "x"), name(ast, "y"))),
+        statement(ast, apply(ast, "/", literal(ast, 1), literal(ast, 0)))
+    };
+    PolycallASTIndex body = block(ast, statements, 5);
+    PolycallASTIndex function = add(ast, AST_FUNCTION, &f, &body, 1);
+    ast->root = add(ast, AST_PROGRAM, NULL, &function, 1);
+    assert(ast->node_count == 30 && polycall_ast_validate(ast));
+    return ast;
+}
+
+static bool not_control_flow(const PolycallASTNode* node) {
+    return node->type != AST_CONTROL_FLOW;
+}
+
+static bool negate_integers(PolycallASTNode* node) {
+    if (node->value.type == VALUE_INTEGER) node->value.data.int_value = -node->value.data.int_value;
+    return true;
+}
+
+// The statements of the function in an optimized copy
+static const PolycallASTIndex* function_body(const PolycallAST* ast, uint32_t* count) {
+    uint32_t n = 0;
+    const PolycallASTIndex* functions = polycall_ast_children(ast, ast->root, &n);
+    assert(n == 1);
+    const PolycallASTIndex* body = polycall_ast_children(ast, functions[0], &n);
+    assert(n == 1 && ast->nodes[body[0]].type == AST_BLOCK);
+    return polycall_ast_children(ast, body[0], count);
+}
+
+static const PolycallASTNode* only_child(const PolycallAST* ast, PolycallASTIndex index) {
+    uint32_t n = 0;
+    const PolycallASTIndex* children = polycall_ast_children(ast, index, &n);
+    assert(n == 1);
+    return &ast->nodes[children[0]];
+}
+
+void test_copying_passes(void) {
+    printf("Testing the copying passes...\n");
+    PolycallAST* ast = build_function();
+
+    // Filter drops the branch with everything under it
+    PolycallAST* filtered = polycall_ast_filter(ast, not_control_flow);
+    assert(filtered && polycall_ast_validate(filtered));
+    assert(filtered->node_count == 20);
+    assert(polycall_ast_find_node(filtered, AST_CONTROL_FLOW) == POLYCALL_AST_NO_NODE);
+
+    // Map edits copies and leaves the input alone
+    PolycallAST* mapped = polycall_ast_map(ast, negate_integers);
+    assert(mapped && polycall_ast_validate(mapped) && mapped->node_count == ast->node_count);
+    uint32_t found = 0;
+    PolycallASTIndex* expressions = polycall_ast_find_nodes(mapped, AST_EXPRESSION, &found);
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < found; i++) {
+        if (mapped->nodes[expressions[i]].value.type == VALUE_INTEGER) {
+            sum += mapped->nodes[expressions[i]].value.data.int_value;
+        }
+    }
+    assert(sum == -7);
+    free(expressions);
+
+    // Output is breadth first: every node comes after its parent
+    for (uint32_t i = 1; i < mapped->node_count; i++) assert(mapped->nodes[i].parent < i);
+
+    polycall_ast_destroy(mapped);
+    polycall_ast_destroy(filtered);
+    polycall_ast_destroy(ast);
+    printf("  V Filter, map and breadth-first layout\n");
+}
+
+void test_optimizer(void) {
+    printf("Testing the optimizer levels...\n");
+    PolycallAST* ast = build_function();
+
+    // Level 1 splices out the single-statement blocks of the branch
+    PolycallAST* level1 = polycall_ast_optimize(ast, 1);
+    assert(level1 && polycall_ast_validate(level1));
+    assert(level1->optimize_stats.input == 30 && level1->node_count == 28);
+
+    // Level 2 folds 2 + 3 and "a" == "a", but not 1 / 0
+    PolycallAST* level2 = polycall_ast_optimize(ast, 2);
+    assert(level2 && polycall_ast_validate(level2));
+    uint32_t count = 0;
+    const PolycallASTIndex* statements = function_body(level2, &count);
+    assert(count == 5);
+    const PolycallASTNode* sum = only_child(level2, statements[0]);
+    assert(sum->child_count == 0 && sum->value.type == VALUE_INTEGER && sum->value.data.int_value == 5);
+    const PolycallASTNode* division = only_child(level2, statements[4]);
+    assert(division->child_count == 2);
+    assert(level2->optimize_stats.folded == 24 && level2->node_count == 24);
+
+    // Level 3 takes the branch and shares the repeated x * y
+    PolycallAST* level3 = polycall_ast_optimize(ast, 3);
+    assert(level3 && polycall_ast_validate(level3));
+    statements = function_body(level3, &count);
+    assert(count == 5);
+    const PolycallASTNode* taken = only_child(level3, statements[1]);
+    assert(taken->type == AST_STATEMENT);
+    const PolycallASTNode* one = only_child(level3, (PolycallASTIndex)(taken - level3->nodes));
+    assert(one->value.type == VALUE_INTEGER && one->value.data.int_value == 1);
+    const PolycallASTNode* first = only_child(level3, statements[2]);
+    const PolycallASTNode* second = only_child(level3, statements[3]);
+    assert(first == second && (first->attrs & AST_ATTR_SHARED));
+    assert(level3->optimize_stats.input == 30);
+    assert(level3->optimize_stats.pruned < level3->optimize_stats.folded);
+    assert(level3->optimize_stats.shared < level3->optimize_stats.pruned);
+
+    // Shared nodes stay shared through another pass
+    PolycallAST* again = polycall_ast_optimize(level3, 3);
+    assert(again && polycall_ast_validate(again) && again->node_count == level3->node_count);
+
+    polycall_ast_destroy(again);
+    polycall_ast_destroy(level3);
+    polycall_ast_destroy(level2);
+    polycall_ast_destroy(level1);
+    polycall_ast_destroy(ast);
+    printf("  V Folding, pruning and sharing\n");
+}
+
+static void write_file(const char* path, const char* contents) {
+    FILE* file = fopen(path, "w");
+    assert(file);
+    fputs(contents, file);
+    fclose(file);
+}
+
+// Write elsewhere and rename over, as the cache expects of config files
+static void replace_file(const char* dir, const char* path, const char* contents) {
+    char staging[256];
+    snprintf(staging, sizeof(staging), "%s/staging", dir);
+    write_file(staging, contents);
+    assert(rename(staging, path) == 0);
+}
+
+void test_parse_cache(void) {
+    printf("Testing the parse cache...\n");
+    char dir[] = "/tmp/polycall-parse-XXXXXX";
+    assert(mkdtemp(dir));
+    char path[256];
+    snprintf(path, sizeof(path), "%s/config.polycall", dir);
+    write_file(path, "alpha beta 42\n");
+
+    PolycallParser* parser = polycall_parser_create(NULL);
+    PolycallAST* first = polycall_parser_parse_file(parser, path);
+    assert(first && polycall_ast_validate(first));
+    assert(polycall_parser_parse_file(parser, path) == first);
+
+    // New metadata with the same bytes keeps the AST
+    struct timespec times[2] = { { 1000000000, 0 }, { 1000000000, 0 } };
+    assert(utimensat(AT_FDCWD, path, times, 0) == 0);
+    assert(polycall_parser_parse_file(parser, path) == first);
+    replace_file(dir, path, "alpha beta 42\n");
+    assert(polycall_parser_parse_file(parser, path) == first);
+
+    // Changed bytes parse again
+    replace_file(dir, path, "gamma 7 delta 8\n");
+    PolycallAST* second = polycall_parser_parse_file(parser, path);
+    assert(second && second != first && polycall_ast_validate(second));
+
+    // Contents that fail to parse leave the last good AST cached
+    replace_file(dir, path, "gamma # delta\n");
+    assert(polycall_parser_parse_file(parser, path) == NULL);
+    assert(polycall_parser_get_error(parser) != NULL);
+    replace_file(dir, path, "gamma 7 delta 8\n");
+    assert(polycall_parser_parse_file(parser, path) == second);
+
+    // Empty files parse, and clearing the cache forgets them all
+    replace_file(dir, path, "");
+    assert(polycall_parser_parse_file(parser, path) != NULL);
+    polycall_parser_clear_cache(parser);
+    assert(parser->cache == NULL);
+
+    PolycallAST* inline_ast = polycall_parser_parse_string(parser, "a 1 b 2", 7);
+    assert(inline_ast && polycall_ast_validate(inline_ast));
+    polycall_ast_destroy(inline_ast);
+
+    polycall_parser_destroy(parser);
+    unlink(path);
+    rmdir(dir);
+    printf("  V Unchanged, touched and renamed files hit the cache\n");
+}
+
+int main(void) {
+    test_arena();
+    test_copying_passes();
+    test_optimizer();
+    test_parse_cache();
+    printf("All parser tests passed\n");
+    return 0;
+}
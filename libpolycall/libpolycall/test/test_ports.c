@@ -0,0 +1,93 @@
+// Checks for the one-pass port scan and the in-process port claims that
+// keep concurrently started programs apart (network.c)
+#include "network.h"
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PARALLEL_PROGRAMS 8
+#define LISTENERS 4
+
+static uint16_t listen_any(int* fd) {
+    *fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(bind(*fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 && listen(*fd, 1) == 0);
+    socklen_t length = sizeof(addr);
+    assert(getsockname(*fd, (struct sockaddr*)&addr, &length) == 0);
+    return ntohs(addr.sin_port);
+}
+
+void test_port_scan(void) {
+    printf("Testing the one-pass port scan...\n");
+    int fds[LISTENERS];
+    uint16_t ports[LISTENERS];
+    for (int i = 0; i < LISTENERS; i++) ports[i] = listen_any(&fds[i]);
+
+    // Each listener shows in a range around it, and agrees with a probe
+    for (int i = 0; i < LISTENERS; i++) {
+        uint16_t first = ports[i] > 8 ? ports[i] - 8 : 1;
+        uint16_t last = ports[i] < 65527 ? ports[i] + 8 : 65535;
+        bool in_use[17];
+        net_ports_in_use(first, last, in_use);
+        assert(in_use[ports[i] - first]);
+        assert(net_is_port_in_use(ports[i]));
+    }
+
+    // Closed, they are free again
+    for (int i = 0; i < LISTENERS; i++) close(fds[i]);
+    for (int i = 0; i < LISTENERS; i++) {
+        bool in_use = true;
+        net_ports_in_use(ports[i], ports[i], &in_use);
+        assert(!in_use);
+    }
+    printf("  V %d listeners found and released\n", LISTENERS);
+}
+
+static NetworkProgram programs[PARALLEL_PROGRAMS];
+
+static void* start_program(void* arg) {
+    net_init_program(arg);
+    return NULL;
+}
+
+void test_parallel_start(void) {
+    printf("Testing parallel program start...\n");
+
+    // Started together, programs still pick a port each
+    pthread_t threads[PARALLEL_PROGRAMS];
+    for (int i = 0; i < PARALLEL_PROGRAMS; i++) {
+        assert(pthread_create(&threads[i], NULL, start_program, &programs[i]) == 0);
+    }
+    for (int i = 0; i < PARALLEL_PROGRAMS; i++) pthread_join(threads[i], NULL);
+    for (int i = 0; i < PARALLEL_PROGRAMS; i++) {
+        assert(programs[i].endpoints && programs[i].count == 1 && programs[i].claimed_port);
+        assert(programs[i].endpoints[0].port == programs[i].claimed_port);
+        for (int j = 0; j < i; j++) assert(programs[i].claimed_port != programs[j].claimed_port);
+        assert(net_is_port_in_use(programs[i].claimed_port));
+    }
+
+    // Cleanup releases the claim along with the socket
+    uint16_t port = programs[0].claimed_port;
+    net_cleanup_program(&programs[0]);
+    assert(!net_is_port_in_use(port));
+    net_init_program(&programs[0]);
+    assert(programs[0].claimed_port == port);
+
+    for (int i = 0; i < PARALLEL_PROGRAMS; i++) net_cleanup_program(&programs[i]);
+    printf("  V %d programs on %d distinct ports\n", PARALLEL_PROGRAMS, PARALLEL_PROGRAMS);
+}
+
+int main(void) {
+    test_port_scan();
+    test_parallel_start();
+    printf("All port tests passed\n");
+    return 0;
+}
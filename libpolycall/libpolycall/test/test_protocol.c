@@ -0,0 +1,351 @@
+// Checks for the stream decoder, pipelining, batching and CRC32C
+// checksums of polycall_protocol.c, over a Unix socket pair
+#include "polycall.h"
+#include "polycall_checksum.h"
+#include "polycall_protocol.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define MAX_SEEN 64
+#define STREAM_SIZE 65536
+
+typedef struct {
+    uint32_t count;
+    uint32_t sequences[MAX_SEEN];
+    size_t lengths[MAX_SEEN];
+    char data[MAX_SEEN][256];
+    uint32_t handshakes;
+} Recorder;
+
+typedef struct {
+    NetworkEndpoint endpoint;
+    polycall_protocol_context_t protocol;
+    Recorder commands;
+    Recorder responses;
+} Peer;
+
+static void record(Recorder* recorder, uint32_t sequence, const char* data, size_t length) {
+    assert(recorder->count < MAX_SEEN && length <= sizeof(recorder->data[0]));
+    recorder->sequences[recorder->count] = sequence;
+    recorder->lengths[recorder->count] = length;
+    memcpy(recorder->data[recorder->count], data, length);
+    recorder->count++;
+}
+
+static void on_handshake(polycall_protocol_context_t* ctx) {
+    ((Peer*)ctx->user_data)->commands.handshakes++;
+}
+
+static void on_command(polycall_protocol_context_t* ctx, const char* command, size_t length) {
+    record(&((Peer*)ctx->user_data)->commands, ctx->current_sequence, command, length);
+}
+
+static void on_response(polycall_protocol_context_t* ctx, uint32_t sequence,
+                        const char* response, size_t length) {
+    record(&((Peer*)ctx->user_data)->responses, sequence, response, length);
+}
+
+static polycall_context_t make_context(void) {
+    polycall_context_t ctx = NULL;
+    polycall_config_t config = { 0 };
+    assert(polycall_init_with_config(&ctx, &config) == POLYCALL_SUCCESS);
+    return ctx;
+}
+
+static void make_peer(polycall_context_t ctx, Peer* peer, int fd, uint16_t capabilities,
+                      size_t max_message_size) {
+    memset(peer, 0, sizeof(*peer));
+    pthread_mutex_init(&peer->endpoint.lock, NULL);
+    peer->endpoint.socket_fd = fd;
+    peer->endpoint.protocol = NET_UNIX;
+
+    polycall_protocol_config_t config = { 0 };
+    config.callbacks.on_handshake = on_handshake;
+    config.callbacks.on_command = on_command;
+    config.callbacks.on_response = on_response;
+    config.capabilities = capabilities;
+    config.max_message_size = max_message_size;
+    config.user_data = peer;
+    assert(polycall_protocol_init(&peer->protocol, ctx, &peer->endpoint, &config));
+}
+
+static void destroy_peer(Peer* peer) {
+    polycall_protocol_cleanup(&peer->protocol);
+    close(peer->endpoint.socket_fd);
+    pthread_mutex_destroy(&peer->endpoint.lock);
+}
+
+// Everything the other side has written so far
+static size_t drain(Peer* peer, uint8_t* stream, size_t capacity) {
+    size_t length = 0;
+    ssize_t got;
+    while (length < capacity &&
+           (got = recv(peer->endpoint.socket_fd, stream + length, capacity - length,
+                       MSG_DONTWAIT)) > 0) {
+        length += (size_t)got;
+    }
+    return length;
+}
+
+static bool feed(Peer* peer, uint8_t* data, size_t length) {
+    NetworkPacket packet = { 0 };
+    packet.data = data;
+    packet.size = length;
+    return polycall_protocol_process_packet(&peer->protocol, &packet);
+}
+
+static bool deliver(Peer* peer) {
+    static uint8_t stream[STREAM_SIZE];
+    return feed(peer, stream, drain(peer, stream, sizeof(stream)));
+}
+
+static void make_pair(polycall_context_t ctx, Peer* a, Peer* b, uint16_t a_caps, uint16_t b_caps) {
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    make_peer(ctx, a, fds[0], a_caps, 0);
+    make_peer(ctx, b, fds[1], b_caps, 0);
+    assert(polycall_protocol_start_handshake(&a->protocol));
+    assert(polycall_protocol_start_handshake(&b->protocol));
+    assert(deliver(a) && deliver(b));
+    assert(a->commands.handshakes == 1 && b->commands.handshakes == 1);
+}
+
+static const uint16_t ALL_CAPS = POLYCALL_CAP_PIPELINE | POLYCALL_CAP_BATCH | POLYCALL_CAP_CRC32C;
+
+void test_capabilities(polycall_context_t ctx) {
+    printf("Testing capability negotiation...\n");
+    Peer a, b;
+    make_pair(ctx, &a, &b, ALL_CAPS, ALL_CAPS);
+    assert(polycall_protocol_capabilities(&a.protocol) == ALL_CAPS);
+    assert(polycall_protocol_capabilities(&b.protocol) == ALL_CAPS);
+    destroy_peer(&a);
+    destroy_peer(&b);
+
+    // Each side uses only what both offered
+    make_pair(ctx, &a, &b, ALL_CAPS, POLYCALL_CAP_CRC32C);
+    assert(polycall_protocol_capabilities(&a.protocol) == POLYCALL_CAP_CRC32C);
+    assert(polycall_protocol_capabilities(&b.protocol) == POLYCALL_CAP_CRC32C);
+    polycall_protocol_batch_t batch;
+    assert(!polycall_protocol_batch_begin(&a.protocol, &batch));
+    assert(!polycall_protocol_respond(&a.protocol, 1, "x", 1));
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V Extensions agreed per pair\n");
+}
+
+void test_split_reads(polycall_context_t ctx) {
+    printf("Testing the stream decoder across split reads...\n");
+    Peer a, b;
+    make_pair(ctx, &a, &b, ALL_CAPS, ALL_CAPS);
+
+    char commands[8][200];
+    size_t lengths[8];
+    for (int i = 0; i < 8; i++) {
+        lengths[i] = 1 + (size_t)i * 27;
+        for (size_t c = 0; c < lengths[i]; c++) commands[i][c] = (char)('a' + (i + c) % 26);
+        assert(polycall_protocol_send_command(&a.protocol, commands[i], lengths[i]) != 0);
+    }
+    static uint8_t stream[STREAM_SIZE];
+    size_t length = drain(&b, stream, sizeof(stream));
+
+    // Cut the stream at every size from one byte up, so frames and headers
+    // are split at every offset
+    for (size_t step = 1; step <= 41; step += 4) {
+        b.commands.count = 0;
+        bool cut = false;
+        for (size_t offset = 0; offset < length; offset += step) {
+            size_t piece = length - offset < step ? length - offset : step;
+            assert(feed(&b, stream + offset, piece));
+            cut |= polycall_protocol_pending(&b.protocol) > 0;
+        }
+        assert(cut || step > length);
+        assert(polycall_protocol_pending(&b.protocol) == 0);
+        assert(b.commands.count == 8);
+        for (int i = 0; i < 8; i++) {
+            assert(b.commands.lengths[i] == lengths[i]);
+            assert(memcmp(b.commands.data[i], commands[i], lengths[i]) == 0);
+        }
+    }
+
+    // All in one read is dispatched in place
+    b.commands.count = 0;
+    assert(feed(&b, stream, length));
+    assert(b.commands.count == 8 && polycall_protocol_pending(&b.protocol) == 0);
+
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V %zu stream bytes reassembled at every cut\n", length);
+}
+
+void test_pipelining(polycall_context_t ctx) {
+    printf("Testing pipelined commands...\n");
+    Peer a, b;
+    make_pair(ctx, &a, &b, ALL_CAPS, ALL_CAPS);
+
+    uint32_t sequences[5];
+    char command[16];
+    for (int i = 0; i < 5; i++) {
+        snprintf(command, sizeof(command), "cmd-%d", i);
+        sequences[i] = polycall_protocol_send_command(&a.protocol, command, strlen(command));
+        assert(sequences[i] != 0);
+    }
+    assert(deliver(&b));
+    assert(b.commands.count == 5);
+
+    // Answered out of order; each response carries its command's sequence
+    char response[16];
+    for (int i = 4; i >= 0; i--) {
+        assert(b.commands.sequences[i] == sequences[i]);
+        snprintf(response, sizeof(response), "re-%d", i);
+        assert(polycall_protocol_respond(&b.protocol, b.commands.sequences[i], response,
+                                         strlen(response)));
+    }
+    assert(deliver(&a));
+    assert(a.responses.count == 5);
+    for (int r = 0; r < 5; r++) {
+        int i = 4 - r;
+        snprintf(response, sizeof(response), "re-%d", i);
+        assert(a.responses.sequences[r] == sequences[i]);
+        assert(a.responses.lengths[r] == strlen(response));
+        assert(memcmp(a.responses.data[r], response, strlen(response)) == 0);
+    }
+
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V Responses matched to commands out of order\n");
+}
+
+void test_batching(polycall_context_t ctx) {
+    printf("Testing batched commands...\n");
+    Peer a, b;
+    make_pair(ctx, &a, &b, ALL_CAPS, ALL_CAPS);
+
+    polycall_protocol_batch_t batch;
+    assert(polycall_protocol_batch_begin(&a.protocol, &batch));
+    uint32_t sequences[10];
+    char command[32];
+    for (int i = 0; i < 10; i++) {
+        snprintf(command, sizeof(command), "batched command %d", i);
+        sequences[i] = polycall_protocol_batch_add(&batch, command, strlen(command));
+        assert(sequences[i] != 0 && (i == 0 || sequences[i] != sequences[i - 1]));
+    }
+    assert(batch.count == 10);
+    assert(polycall_protocol_batch_send(&batch));
+    assert(batch.payload == NULL);
+
+    // One frame on the wire, ten commands out of it
+    static uint8_t stream[STREAM_SIZE];
+    size_t length = drain(&b, stream, sizeof(stream));
+    polycall_message_header_t header;
+    memcpy(&header, stream, sizeof(header));
+    assert(header.type == POLYCALL_MSG_BATCH && sizeof(header) + header.payload_length == length);
+    assert(feed(&b, stream, length));
+    assert(b.commands.count == 10);
+    for (int i = 0; i < 10; i++) {
+        snprintf(command, sizeof(command), "batched command %d", i);
+        assert(b.commands.sequences[i] == sequences[i]);
+        assert(b.commands.lengths[i] == strlen(command));
+        assert(memcmp(b.commands.data[i], command, strlen(command)) == 0);
+    }
+
+    // A batch entry that runs past the frame runs none of them
+    polycall_batch_entry_t entry = { 99, 1000 };
+    assert(polycall_protocol_batch_begin(&a.protocol, &batch));
+    assert(polycall_protocol_batch_add(&batch, "ok", 2) != 0);
+    assert(net_buffer_append(batch.payload, &entry, sizeof(entry)));
+    batch.count++;
+    assert(polycall_protocol_batch_send(&batch));
+    b.commands.count = 0;
+    assert(!deliver(&b));
+    assert(b.commands.count == 0);
+
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V Ten commands in one frame, malformed frames refused whole\n");
+}
+
+void test_checksums(polycall_context_t ctx) {
+    printf("Testing CRC32C checksums...\n");
+
+    // Standard check value, and the same from pieces
+    const char* check = "123456789";
+    assert(polycall_crc32c(0, check, 9) == 0xE3069283u);
+    assert(polycall_crc32c(polycall_crc32c(0, check, 4), check + 4, 5) == 0xE3069283u);
+    static uint8_t large[4099];
+    for (size_t i = 0; i < sizeof(large); i++) large[i] = (uint8_t)(i * 131);
+    uint32_t whole = polycall_crc32c(0, large, sizeof(large));
+    assert(polycall_crc32c(polycall_crc32c(0, large, 1001), large + 1001, sizeof(large) - 1001) ==
+           whole);
+    printf("  V crc32c check value with %s\n", polycall_crc32c_impl());
+
+    Peer a, b;
+    make_pair(ctx, &a, &b, ALL_CAPS, ALL_CAPS);
+    assert(polycall_protocol_send_command(&a.protocol, "checked", 7) != 0);
+    static uint8_t stream[STREAM_SIZE];
+    size_t length = drain(&b, stream, sizeof(stream));
+    polycall_message_header_t header;
+    memcpy(&header, stream, sizeof(header));
+    assert(header.flags & POLYCALL_FLAG_CRC32C);
+    assert(header.checksum == polycall_crc32c(0, "checked", 7));
+    assert(polycall_protocol_verify_checksum(&header, "checked", 7));
+
+    // A flipped payload bit fails the frame
+    stream[sizeof(header) + 3] ^= 0x04;
+    assert(!feed(&b, stream, length));
+    assert(b.commands.count == 0);
+    destroy_peer(&a);
+    destroy_peer(&b);
+
+    // Without the extension the base sum is used
+    make_pair(ctx, &a, &b, POLYCALL_CAP_PIPELINE, POLYCALL_CAP_PIPELINE);
+    assert(polycall_protocol_send_command(&a.protocol, "checked", 7) != 0);
+    length = drain(&b, stream, sizeof(stream));
+    memcpy(&header, stream, sizeof(header));
+    assert(!(header.flags & POLYCALL_FLAG_CRC32C));
+    assert(header.checksum == polycall_protocol_calculate_checksum("checked", 7));
+    assert(feed(&b, stream, length) && b.commands.count == 1);
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V Frames carry the agreed checksum and damage is caught\n");
+}
+
+void test_message_limit(polycall_context_t ctx) {
+    printf("Testing the message size limit...\n");
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    Peer a, b;
+    make_peer(ctx, &a, fds[0], 0, 0);
+    make_peer(ctx, &b, fds[1], 0, 64);
+
+    static char big[65];
+    memset(big, 'z', sizeof(big));
+    assert(polycall_protocol_send_command(&a.protocol, big, 64) != 0);
+    assert(deliver(&b) && b.commands.count == 1);
+
+    // Refused from the header alone, before any payload is held
+    assert(polycall_protocol_send_command(&a.protocol, big, 65) != 0);
+    static uint8_t stream[STREAM_SIZE];
+    size_t length = drain(&b, stream, sizeof(stream));
+    assert(!feed(&b, stream, sizeof(polycall_message_header_t)));
+    assert(polycall_protocol_pending(&b.protocol) == 0);
+    assert(length == sizeof(polycall_message_header_t) + 65);
+
+    destroy_peer(&a);
+    destroy_peer(&b);
+    printf("  V Oversized frames rejected at the header\n");
+}
+
+int main(void) {
+    polycall_context_t ctx = make_context();
+    test_capabilities(ctx);
+    test_split_reads(ctx);
+    test_pipelining(ctx);
+    test_batching(ctx);
+    test_checksums(ctx);
+    test_message_limit(ctx);
+    polycall_cleanup(ctx);
+    printf("All protocol tests passed\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Checks for the SO_REUSEPORT reactor group and the io_uring backend
+// (network_reactor.c, network_uring.c) with an echo handler over TCP
+#include "network_reactor.h"
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define REACTORS 4
+#define CONNECTIONS 32
+#define ROUNDS 3
+
+// Reactor that echoed each connection's messages; -1 before the first
+static _Atomic int served_by[CONNECTIONS];
+static _Atomic int moved;
+
+static void on_echo(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    // Messages are "<connection>:<round>"
+    int connection = 0;
+    if (sscanf(packet->data, "%d:", &connection) == 1 && connection >= 0 &&
+        connection < CONNECTIONS) {
+        int index = endpoint->user_data ? (int)((NetworkReactor*)endpoint->user_data)->index : 0;
+        int expected = -1;
+        if (!atomic_compare_exchange_strong(&served_by[connection], &expected, index) &&
+            expected != index) {
+            atomic_fetch_add(&moved, 1);
+        }
+    }
+    NetworkPacket reply = { .data = packet->data, .size = packet->size };
+    assert(net_send(endpoint, &reply) == (ssize_t)packet->size);
+}
+
+static int connect_to(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    struct timeval timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+// Each connection sends ROUNDS messages, one at a time, and reads each
+// echo back whole
+static void exchange(const int* fds) {
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < CONNECTIONS; i++) {
+            char message[32], echo[32];
+            int length = snprintf(message, sizeof(message), "%d:%d", i, round);
+            assert(write(fds[i], message, (size_t)length) == length);
+            ssize_t got = 0;
+            while (got < length) {
+                ssize_t n = read(fds[i], echo + got, (size_t)(length - got));
+                assert(n > 0);
+                got += n;
+            }
+            assert(memcmp(message, echo, (size_t)length) == 0);
+        }
+    }
+}
+
+static void reset_served(void) {
+    for (int i = 0; i < CONNECTIONS; i++) atomic_store(&served_by[i], -1);
+    atomic_store(&moved, 0);
+}
+
+void test_reactor_group(void) {
+    printf("Testing the reactor group...\n");
+    reset_served();
+    NetworkReactorGroup group;
+    memset(&group, 0, sizeof(group));
+    group.handlers.on_receive = on_echo;
+    assert(net_reactors_start(&group, REACTORS, 0, NET_EVENT_AUTO));
+    assert(group.count == REACTORS && group.port != 0);
+
+    int fds[CONNECTIONS];
+    for (int i = 0; i < CONNECTIONS; i++) fds[i] = connect_to(group.port);
+    exchange(fds);
+
+    // Every connection stayed on the reactor that accepted it
+    assert(atomic_load(&moved) == 0);
+    NetworkStats total, one;
+    net_reactors_total(&group, &total);
+    assert(total.accepted == CONNECTIONS && total.packets >= CONNECTIONS * ROUNDS);
+    uint64_t accepted = 0;
+    size_t busy = 0;
+    for (size_t r = 0; r < REACTORS; r++) {
+        assert(net_reactor_stats(&group, r, &one));
+        accepted += one.accepted;
+        busy += one.accepted > 0;
+    }
+    assert(accepted == CONNECTIONS && !net_reactor_stats(&group, REACTORS, &one));
+
+    for (int i = 0; i < CONNECTIONS; i++) close(fds[i]);
+    net_reactors_stop(&group);
+    printf("  V %d connections over %zu of %d reactors, none moved\n", CONNECTIONS, busy, REACTORS);
+}
+
+static NetworkProgram uring_program;
+static atomic_bool uring_stop;
+
+static void* uring_main(void* arg) {
+    (void)arg;
+    while (!atomic_load(&uring_stop)) net_run(&uring_program);
+    return NULL;
+}
+
+void test_uring_backend(void) {
+    printf("Testing the io_uring backend...\n");
+    reset_served();
+    net_init_program_with_backend(&uring_program, NET_EVENT_URING);
+    assert(uring_program.endpoints && uring_program.count == 1);
+    if (!uring_program.uring) {
+        // Kernels before 6.0, or io_uring disabled: readiness took over
+        net_cleanup_program(&uring_program);
+        printf("  V Unavailable here, fell back to readiness\n");
+        return;
+    }
+    uring_program.handlers.on_receive = on_echo;
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, uring_main, NULL) == 0);
+
+    int fds[CONNECTIONS];
+    for (int i = 0; i < CONNECTIONS; i++) fds[i] = connect_to(uring_program.endpoints[0].port);
+    exchange(fds);
+    for (int i = 0; i < CONNECTIONS; i++) close(fds[i]);
+
+    atomic_store(&uring_stop, true);
+    pthread_join(thread, NULL);
+    NetworkStats stats;
+    net_get_stats(&uring_program, &stats);
+    assert(stats.accepted == CONNECTIONS && stats.packets >= CONNECTIONS * ROUNDS);
+    net_cleanup_program(&uring_program);
+    printf("  V %d connections echoed through completions\n", CONNECTIONS);
+}
+
+int main(void) {
+    test_reactor_group();
+    test_uring_backend();
+    printf("All reactor tests passed\n");
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Checks for the tables polycall-smgen writes: the generated smgen_fire,
+// polycall_sm_static_fire on smgen_machine and a runtime machine made from
+// it must agree on every step of the same event sequence
+#include "polycall.h"
+#include "polycall_state_machine.h"
+#include "smgen_machine.h"      // Generated from test/smgen.Polycallfile
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WALK_STEPS 5000
+
+// Callbacks append a letter each, so a step's trace shows which ran and in
+// what order
+static char g_trace[16];
+static size_t g_trace_length;
+static bool g_allow_restart, g_allow_reset;
+
+static void trace(char letter) {
+    assert(g_trace_length + 1 < sizeof(g_trace));
+    g_trace[g_trace_length++] = letter;
+    g_trace[g_trace_length] = '\0';
+}
+
+static void enter_idle(polycall_context_t ctx) { (void)ctx; trace('i'); }
+static void enter_busy(polycall_context_t ctx) { (void)ctx; trace('b'); }
+static void exit_busy(polycall_context_t ctx) { (void)ctx; trace('B'); }
+static void exit_draining(polycall_context_t ctx) { (void)ctx; trace('D'); }
+static void enter_done(polycall_context_t ctx) { (void)ctx; trace('d'); }
+static void on_start(polycall_context_t ctx) { (void)ctx; trace('s'); }
+static void on_finish(polycall_context_t ctx) { (void)ctx; trace('f'); }
+
+static bool allow_restart(const PolyCall_State* from, const PolyCall_State* to) {
+    assert(from->id == SMGEN_STATE_DRAINING && to->id == SMGEN_STATE_BUSY);
+    trace('?');
+    return g_allow_restart;
+}
+
+static bool allow_reset(const PolyCall_State* from, const PolyCall_State* to) {
+    assert(from->id == SMGEN_STATE_BUSY && to->id == SMGEN_STATE_IDLE);
+    trace('?');
+    return g_allow_reset;
+}
+
+static polycall_context_t make_context(void) {
+    polycall_context_t ctx = NULL;
+    polycall_config_t config = { 0 };
+    assert(polycall_init_with_config(&ctx, &config) == POLYCALL_SUCCESS);
+    return ctx;
+}
+
+void test_tables(polycall_context_t ctx) {
+    printf("Testing the generated tables...\n");
+
+    // IDs follow declaration order; events are numbered by first appearance
+    assert(SMGEN_STATE_COUNT == 4 && SMGEN_EVENT_COUNT == 4);
+    assert(SMGEN_STATE_IDLE == 0 && SMGEN_STATE_DONE == 3);
+    assert(SMGEN_EVENT_START == 0 && SMGEN_EVENT_DRAIN == 1 &&
+           SMGEN_EVENT_FINISH == 2 && SMGEN_EVENT_RESET == 3);
+    assert(smgen_machine.num_states == 4 && smgen_machine.num_transitions == 7);
+    assert(smgen_machine.initial_state == SMGEN_STATE_IDLE);
+    assert(smgen_states[SMGEN_STATE_DONE].is_final && !smgen_states[SMGEN_STATE_IDLE].is_final);
+    assert(strcmp(smgen_states[SMGEN_STATE_DRAINING].name, "draining") == 0);
+    assert(polycall_sm_static_event_id(&smgen_machine, "reset") == SMGEN_EVENT_RESET);
+    assert(polycall_sm_static_event_id(&smgen_machine, "missing") == POLYCALL_SM_NO_EVENT);
+
+    // For any one state the first declaration of an event wins
+    assert(smgen_next[SMGEN_STATE_IDLE * SMGEN_EVENT_COUNT + SMGEN_EVENT_START] == 0);
+    assert(smgen_next[SMGEN_STATE_DONE * SMGEN_EVENT_COUNT + SMGEN_EVENT_RESET] ==
+           POLYCALL_SM_NO_TRANSITION);
+
+    // The runtime machine gets the same IDs
+    PolyCall_StateMachine* sm = NULL;
+    assert(polycall_sm_create_from_static(ctx, &sm, &smgen_machine, NULL) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_event_id(sm, "start") == SMGEN_EVENT_START);
+    assert(polycall_sm_event_id(sm, "reset") == SMGEN_EVENT_RESET);
+    unsigned int state = 99;
+    polycall_sm_current(sm, &state, NULL);
+    assert(state == SMGEN_STATE_IDLE);
+    polycall_sm_destroy(sm);
+
+    assert(polycall_sm_static_fire(&smgen_machine, ctx, &state, SMGEN_EVENT_COUNT) ==
+           POLYCALL_SM_ERROR_INVALID_TRANSITION);
+    state = SMGEN_STATE_COUNT;
+    assert(polycall_sm_static_fire(&smgen_machine, ctx, &state, SMGEN_EVENT_START) ==
+           POLYCALL_SM_ERROR_INVALID_STATE);
+    printf("  V Tables, enums and IDs match the Polycallfile\n");
+}
+
+void test_walk(polycall_context_t ctx) {
+    printf("Testing the three ways to fire...\n");
+
+    PolyCall_StateMachine* sm = NULL;
+    assert(polycall_sm_create_from_static(ctx, &sm, &smgen_machine, NULL) == POLYCALL_SM_SUCCESS);
+    unsigned int generated = SMGEN_STATE_IDLE, table = SMGEN_STATE_IDLE;
+    char expected[sizeof(g_trace)];
+    unsigned int taken = 0, refused = 0, guarded = 0;
+    uint32_t seed = 12345;
+
+    for (int step = 0; step < WALK_STEPS; step++) {
+        seed = seed * 1103515245u + 12345u;
+        smgen_event_t event = (smgen_event_t)((seed >> 16) % SMGEN_EVENT_COUNT);
+        g_allow_restart = (seed >> 20) & 1;
+        g_allow_reset = (seed >> 21) & 1;
+
+        // Done is final; start over so the walk keeps moving
+        if (generated == SMGEN_STATE_DONE) {
+            polycall_sm_destroy(sm);
+            sm = NULL;
+            assert(polycall_sm_create_from_static(ctx, &sm, &smgen_machine, NULL) ==
+                   POLYCALL_SM_SUCCESS);
+            generated = table = SMGEN_STATE_IDLE;
+        }
+
+        g_trace_length = 0;
+        g_trace[0] = '\0';
+        polycall_sm_status_t status = smgen_fire(ctx, &generated, event);
+        strcpy(expected, g_trace);
+
+        g_trace_length = 0;
+        g_trace[0] = '\0';
+        assert(polycall_sm_static_fire(&smgen_machine, ctx, &table, event) == status);
+        assert(table == generated && strcmp(g_trace, expected) == 0);
+
+        g_trace_length = 0;
+        g_trace[0] = '\0';
+        assert(polycall_sm_fire(sm, event) == status);
+        unsigned int runtime = 99;
+        polycall_sm_current(sm, &runtime, NULL);
+        assert(runtime == generated && strcmp(g_trace, expected) == 0);
+
+        if (status == POLYCALL_SM_SUCCESS) taken++;
+        else refused++;
+        if (strchr(expected, '?')) guarded++;
+    }
+    assert(taken > 0 && refused > 0 && guarded > 0);
+
+    polycall_sm_destroy(sm);
+    printf("  V %u transitions taken and %u refused alike (%u guarded)\n", taken, refused, guarded);
+}
+
+int main(void) {
+    polycall_context_t ctx = make_context();
+    test_tables(ctx);
+    test_walk(ctx);
+    polycall_cleanup(ctx);
+    printf("All smgen tests passed\n");
+    return 0;
+}
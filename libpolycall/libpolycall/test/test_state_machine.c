@@ -0,0 +1,283 @@
+// Checks for the compiled event table, refused events, concurrent mode,
+// incremental checksums and whole-machine snapshots of polycall_state_machine.c
+#include "polycall.h"
+#include "polycall_log.h"
+#include "polycall_state_machine.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RING_STATES 4
+#define FIRING_THREADS 8
+#define FIRES_PER_THREAD 20000
+
+static _Atomic uint64_t g_actions = 0;
+
+static void count_action(polycall_context_t ctx) {
+    (void)ctx;
+    atomic_fetch_add_explicit(&g_actions, 1, memory_order_relaxed);
+}
+
+static polycall_context_t make_context(void) {
+    polycall_context_t ctx = NULL;
+    polycall_config_t config = { 0 };
+    assert(polycall_init_with_config(&ctx, &config) == POLYCALL_SUCCESS);
+    return ctx;
+}
+
+// States s0..s3 with "next" going round the ring and "reset" back to s0
+static PolyCall_StateMachine* make_ring(polycall_context_t ctx) {
+    PolyCall_StateMachine* sm = NULL;
+    assert(polycall_sm_create_with_integrity(ctx, &sm, NULL) == POLYCALL_SM_SUCCESS);
+    char name[POLYCALL_MAX_NAME_LENGTH];
+    for (unsigned int i = 0; i < RING_STATES; i++) {
+        snprintf(name, sizeof(name), "s%u", i);
+        assert(polycall_sm_add_state(sm, name, NULL, NULL, false) == POLYCALL_SM_SUCCESS);
+    }
+    for (unsigned int i = 0; i < RING_STATES; i++) {
+        assert(polycall_sm_add_transition(sm, "next", i, (i + 1) % RING_STATES,
+                                          count_action, NULL) == POLYCALL_SM_SUCCESS);
+    }
+    for (unsigned int i = 1; i < RING_STATES; i++) {
+        assert(polycall_sm_add_transition(sm, "reset", i, 0, NULL, NULL) == POLYCALL_SM_SUCCESS);
+    }
+    return sm;
+}
+
+static unsigned int current_state(const PolyCall_StateMachine* sm) {
+    unsigned int state = 0;
+    polycall_sm_current(sm, &state, NULL);
+    return state;
+}
+
+void test_event_table(polycall_context_t ctx) {
+    printf("Testing the compiled event table...\n");
+    PolyCall_StateMachine* sm = make_ring(ctx);
+    assert(polycall_sm_compile(sm) == POLYCALL_SM_SUCCESS);
+
+    // Transitions sharing a name share an event
+    unsigned int next = polycall_sm_event_id(sm, "next");
+    unsigned int reset = polycall_sm_event_id(sm, "reset");
+    assert(next != POLYCALL_SM_NO_EVENT && reset != POLYCALL_SM_NO_EVENT && next != reset);
+    assert(polycall_sm_event_id(sm, "missing") == POLYCALL_SM_NO_EVENT);
+
+    assert(current_state(sm) == 0);
+    assert(polycall_sm_fire(sm, reset) == POLYCALL_SM_ERROR_INVALID_TRANSITION);
+    for (unsigned int i = 1; i <= RING_STATES + 1; i++) {
+        assert(polycall_sm_fire(sm, next) == POLYCALL_SM_SUCCESS);
+        assert(current_state(sm) == i % RING_STATES);
+    }
+    assert(polycall_sm_fire(sm, reset) == POLYCALL_SM_SUCCESS);
+    assert(current_state(sm) == 0);
+    assert(polycall_sm_execute_transition(sm, "next") == POLYCALL_SM_SUCCESS);
+    assert(current_state(sm) == 1);
+
+    // Adding a state drops the table; fire rebuilds it
+    assert(polycall_sm_add_state(sm, "extra", NULL, NULL, true) == POLYCALL_SM_SUCCESS);
+    assert(!sm->compiled.is_compiled);
+    assert(polycall_sm_fire(sm, next) == POLYCALL_SM_SUCCESS);
+    assert(current_state(sm) == 2);
+
+    polycall_sm_destroy(sm);
+    printf("  V Events resolve per state\n");
+}
+
+void test_refused_events(polycall_context_t ctx) {
+    printf("Testing refused events...\n");
+    PolyCall_StateMachine* sm = make_ring(ctx);
+    unsigned int next = polycall_sm_event_id(sm, "next");
+    unsigned int reset = polycall_sm_event_id(sm, "reset");
+
+    // Refusals are counted, and stay quiet unless debug logging is on
+    FILE* sink = tmpfile();
+    assert(sink);
+    polycall_log_level_t level = polycall_log_get_level();
+    polycall_log_set_level(POLYCALL_LOG_LEVEL_INFO);
+    polycall_log_set_sink(sink);
+
+    assert(polycall_sm_fire(sm, reset) == POLYCALL_SM_ERROR_INVALID_TRANSITION);
+    assert(polycall_sm_execute_transition(sm, "missing") == POLYCALL_SM_ERROR_INVALID_TRANSITION);
+    assert(polycall_sm_lock_state(sm, 1) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_fire(sm, next) == POLYCALL_SM_ERROR_STATE_LOCKED);
+    assert(polycall_sm_set_concurrent(sm, true) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_fire(sm, next) == POLYCALL_SM_ERROR_STATE_LOCKED);
+    assert(polycall_sm_fire(sm, reset) == POLYCALL_SM_ERROR_INVALID_TRANSITION);
+    assert(current_state(sm) == 0);
+
+    assert(ftell(sink) == 0);
+    polycall_log_set_sink(NULL);
+    polycall_log_set_level(level);
+    fclose(sink);
+
+    PolyCall_MachineDiagnostics diagnostics;
+    assert(polycall_sm_get_machine_diagnostics(sm, &diagnostics) == POLYCALL_SM_SUCCESS);
+    assert(diagnostics.transitions == 0);
+    assert(diagnostics.failed_transitions == 3);
+    assert(diagnostics.blocked_transitions == 2);
+
+    polycall_sm_destroy(sm);
+    printf("  V Counted without logging\n");
+}
+
+typedef struct {
+    PolyCall_StateMachine* sm;
+    unsigned int event;
+    uint64_t committed;
+} FiringThread;
+
+static void* fire_ring(void* arg) {
+    FiringThread* thread = arg;
+    for (int i = 0; i < FIRES_PER_THREAD; i++) {
+        polycall_sm_status_t status = polycall_sm_fire(thread->sm, thread->event);
+        assert(status == POLYCALL_SM_SUCCESS || status == POLYCALL_SM_ERROR_CONFLICT);
+        if (status == POLYCALL_SM_SUCCESS) thread->committed++;
+    }
+    return NULL;
+}
+
+void test_concurrent_mode(polycall_context_t ctx) {
+    printf("Testing concurrent mode...\n");
+    PolyCall_StateMachine* sm = make_ring(ctx);
+    unsigned int next = polycall_sm_event_id(sm, "next");
+    assert(polycall_sm_set_concurrent(sm, true) == POLYCALL_SM_SUCCESS);
+
+    // No setup changes while threads may be firing
+    assert(polycall_sm_add_state(sm, "late", NULL, NULL, false) != POLYCALL_SM_SUCCESS);
+
+    uint32_t start_version = 0;
+    polycall_sm_current(sm, NULL, &start_version);
+    atomic_store(&g_actions, 0);
+
+    pthread_t threads[FIRING_THREADS];
+    FiringThread args[FIRING_THREADS];
+    for (int i = 0; i < FIRING_THREADS; i++) {
+        args[i] = (FiringThread){ sm, next, 0 };
+        assert(pthread_create(&threads[i], NULL, fire_ring, &args[i]) == 0);
+    }
+    uint64_t committed = 0;
+    for (int i = 0; i < FIRING_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        committed += args[i].committed;
+    }
+
+    // Every commit moved the ring one step, bumped the version once and ran
+    // its action once
+    unsigned int state = 0;
+    uint32_t version = 0;
+    polycall_sm_current(sm, &state, &version);
+    assert(committed > 0);
+    assert(state == committed % RING_STATES);
+    assert((uint32_t)(version - start_version) == (uint32_t)committed);
+    assert(atomic_load(&g_actions) == committed);
+
+    PolyCall_MachineDiagnostics diagnostics;
+    assert(polycall_sm_get_machine_diagnostics(sm, &diagnostics) == POLYCALL_SM_SUCCESS);
+    assert(diagnostics.transitions == committed);
+    assert(diagnostics.transitions + diagnostics.failed_transitions ==
+           (uint64_t)FIRING_THREADS * FIRES_PER_THREAD);
+
+    // A stale version is refused without moving the machine
+    assert(polycall_sm_fire_if_version(sm, next, version - 1) ==
+           POLYCALL_SM_ERROR_VERSION_MISMATCH);
+    assert(current_state(sm) == state);
+    assert(polycall_sm_fire_if_version(sm, next, version) == POLYCALL_SM_SUCCESS);
+    assert(current_state(sm) == (state + 1) % RING_STATES);
+
+    // The state carries over when the mode is switched off
+    assert(polycall_sm_set_concurrent(sm, false) == POLYCALL_SM_SUCCESS);
+    assert(sm->current_state == (state + 1) % RING_STATES);
+
+    polycall_sm_destroy(sm);
+    printf("  V %llu transitions committed from %d threads\n",
+           (unsigned long long)committed, FIRING_THREADS);
+}
+
+void test_incremental_checksums(polycall_context_t ctx) {
+    printf("Testing incremental checksums...\n");
+    PolyCall_StateMachine* sm = make_ring(ctx);
+    unsigned int next = polycall_sm_event_id(sm, "next");
+
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_SUCCESS);
+    for (int i = 0; i < 10; i++) assert(polycall_sm_fire(sm, next) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_lock_state(sm, 2) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_unlock_state(sm, 2) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_add_state(sm, "late", NULL, NULL, true) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_SUCCESS);
+
+    // A change behind the machine's back fails the audit
+    sm->states[1].name[0] = 'x';
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED);
+    sm->states[1].name[0] = 's';
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_SUCCESS);
+
+    sm->transitions[0].to_state = 3;
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED);
+
+    polycall_sm_destroy(sm);
+    printf("  V Audits pass after updates and catch tampering\n");
+}
+
+void test_machine_snapshots(polycall_context_t ctx) {
+    printf("Testing whole-machine snapshots...\n");
+    PolyCall_StateMachine* sm = make_ring(ctx);
+    unsigned int next = polycall_sm_event_id(sm, "next");
+    assert(polycall_sm_fire(sm, next) == POLYCALL_SM_SUCCESS);
+
+    PolyCall_MachineSnapshot* first = NULL;
+    assert(polycall_sm_snapshot_machine(sm, &first) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_fire(sm, next) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_lock_state(sm, 3) == POLYCALL_SM_SUCCESS);
+
+    PolyCall_MachineSnapshot* second = NULL;
+    assert(polycall_sm_snapshot_machine(sm, &second) == POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_machine_snapshot_generation(second) >
+           polycall_sm_machine_snapshot_generation(first));
+
+    // Restoring rolls back the current state and the locked flag
+    assert(polycall_sm_restore_machine(sm, first) == POLYCALL_SM_SUCCESS);
+    assert(current_state(sm) == 1);
+    assert(!sm->states[3].is_locked);
+    assert(polycall_sm_verify_machine(sm) == POLYCALL_SM_SUCCESS);
+
+    // Round trip through the portable encoding onto a machine built alike
+    size_t size = 0;
+    assert(polycall_sm_serialize_machine_snapshot(second, NULL, 0, &size) == POLYCALL_SM_SUCCESS);
+    uint8_t buffer[size];
+    assert(polycall_sm_serialize_machine_snapshot(second, buffer, size, &size) ==
+           POLYCALL_SM_SUCCESS);
+
+    PolyCall_StateMachine* standby = make_ring(ctx);
+    PolyCall_MachineSnapshot* decoded = NULL;
+    assert(polycall_sm_deserialize_machine_snapshot(standby, buffer, size, &decoded) ==
+           POLYCALL_SM_SUCCESS);
+    assert(polycall_sm_restore_machine(standby, decoded) == POLYCALL_SM_SUCCESS);
+    assert(current_state(standby) == 2);
+    assert(standby->states[3].is_locked);
+
+    // Damaged data is refused
+    buffer[size / 2] ^= 0x5a;
+    PolyCall_MachineSnapshot* damaged = NULL;
+    assert(polycall_sm_deserialize_machine_snapshot(standby, buffer, size, &damaged) ==
+           POLYCALL_SM_ERROR_INTEGRITY_CHECK_FAILED);
+
+    polycall_sm_release_machine_snapshot(decoded);
+    polycall_sm_release_machine_snapshot(second);
+    polycall_sm_release_machine_snapshot(first);
+    polycall_sm_destroy(standby);
+    polycall_sm_destroy(sm);
+    printf("  V Snapshots restore locally and on a standby\n");
+}
+
+int main(void) {
+    polycall_context_t ctx = make_context();
+    test_event_table(ctx);
+    test_refused_events(ctx);
+    test_concurrent_mode(ctx);
+    test_incremental_checksums(ctx);
+    test_machine_snapshots(ctx);
+    polycall_cleanup(ctx);
+    printf("All state machine tests passed\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Checks for the compiled DFA and the chunked streaming input of
+// polycall_tokenizer.c
+#include "polycall_tokenizer.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_INPUT_SIZE 40000
+
+static const PolycallTokenizerConfig STREAM_CONFIG = {
+    .limits = { .buffer = 65536, .token = 4, .identifier = 64, .string = 256 },
+    .flags = 0
+};
+
+static TokenPattern PATTERNS[] = {
+    { polycall_tokenizer_match_string, TOKEN_STRING },
+    { polycall_tokenizer_match_identifier, TOKEN_IDENTIFIER },
+    { polycall_tokenizer_match_number, TOKEN_NUMBER },
+    { polycall_tokenizer_match_operator, TOKEN_OPERATOR }
+};
+static TokenConsumer CONSUMERS[4];
+
+static const char* token_text(const PolycallToken* token) {
+    return token->value.data.string_value.data;
+}
+
+static bool same_token(const PolycallToken* a, const PolycallToken* b) {
+    if (a->type != b->type || a->length != b->length || a->line != b->line ||
+        a->column != b->column || a->value.type != b->value.type) {
+        return false;
+    }
+    switch (a->value.type) {
+        case VALUE_INTEGER:
+            return a->value.data.int_value == b->value.data.int_value;
+        case VALUE_FLOAT:
+            return a->value.data.float_value == b->value.data.float_value;
+        case VALUE_STRING:
+        case VALUE_IDENTIFIER:
+            return a->value.data.string_value.length == b->value.data.string_value.length &&
+                   memcmp(token_text(a), token_text(b), a->value.data.string_value.length) == 0;
+        default:
+            return true;
+    }
+}
+
+static const PolycallTokenArray* tokenize(PolycallTokenizer* tokenizer,
+                                          const TokenizerOperations* ops, const char* input) {
+    assert(polycall_tokenizer_set_input(tokenizer, input, strlen(input)));
+    assert(polycall_tokenizer_process(tokenizer, ops));
+    return polycall_tokenizer_get_tokens(tokenizer);
+}
+
+void test_dfa_tokens(void) {
+    printf("Testing the compiled DFA...\n");
+    TokenizerOperations* ops = polycall_tokenizer_create_ops(PATTERNS, CONSUMERS, 4);
+    assert(ops && ops->dfa);
+    PolycallTokenizer* tokenizer = polycall_tokenizer_create(NULL);
+
+    // Longest match: a signed number beats the "-" operator, ">=" beats ">"
+    const char* input = "count = -12.5e3 + foo_2\n  \"a \\\" b\" >= 7";
+    const PolycallTokenArray* tokens = tokenize(tokenizer, ops, input);
+    struct { PolycallTokenType type; const char* text; uint32_t line, column; } expected[] = {
+        { TOKEN_IDENTIFIER, "count", 1, 1 },
+        { TOKEN_OPERATOR, "=", 1, 7 },
+        { TOKEN_NUMBER, "-12.5e3", 1, 9 },
+        { TOKEN_OPERATOR, "+", 1, 17 },
+        { TOKEN_IDENTIFIER, "foo_2", 1, 19 },
+        { TOKEN_STRING, "\"a \\\" b\"", 2, 3 },
+        { TOKEN_OPERATOR, ">=", 2, 12 },
+        { TOKEN_NUMBER, "7", 2, 15 },
+        { TOKEN_EOF, "", 2, 16 }
+    };
+    size_t count = sizeof(expected) / sizeof(expected[0]);
+    assert(tokens->count == count);
+    for (size_t i = 0; i < count; i++) {
+        const PolycallToken* token = &tokens->tokens[i];
+        assert(token->type == expected[i].type);
+        assert(token->length == strlen(expected[i].text));
+        assert(token->line == expected[i].line && token->column == expected[i].column);
+    }
+    assert(tokens->tokens[2].value.type == VALUE_FLOAT &&
+           tokens->tokens[2].value.data.float_value == -12.5e3);
+    assert(tokens->tokens[7].value.type == VALUE_INTEGER &&
+           tokens->tokens[7].value.data.int_value == 7);
+    assert(tokens->tokens[5].value.data.string_value.length == 6 &&
+           memcmp(token_text(&tokens->tokens[5]), "a \\\" b", 6) == 0);
+
+    // Without ambiguity the DFA agrees with the first-match loop it replaced
+    const char* plain = "alpha = beta * 3 + \"str\" - x != y && z_1 <= 42.75 || !w";
+    TokenizerOperations loop = { PATTERNS, CONSUMERS, 4, NULL };
+    PolycallTokenizer* reference = polycall_tokenizer_create(NULL);
+    const PolycallTokenArray* by_loop = tokenize(reference, &loop, plain);
+    polycall_tokenizer_reset(tokenizer);
+    const PolycallTokenArray* by_dfa = tokenize(tokenizer, ops, plain);
+    assert(polycall_tokenizer_get_state(tokenizer) == TOKENIZER_STATE_READY);
+    assert(by_dfa->count == by_loop->count);
+    for (uint32_t i = 0; i < by_dfa->count; i++) {
+        assert(by_dfa->tokens[i].type == by_loop->tokens[i].type);
+        assert(by_dfa->tokens[i].length == by_loop->tokens[i].length);
+    }
+
+    // Bytes no pattern takes are an error
+    polycall_tokenizer_reset(tokenizer);
+    assert(polycall_tokenizer_set_input(tokenizer, "a # b", 5));
+    assert(!polycall_tokenizer_process(tokenizer, ops));
+    assert(polycall_tokenizer_get_state(tokenizer) == TOKENIZER_STATE_ERROR);
+
+    // Composed operations keep longest match across both sets
+    TokenizerOperations* words = polycall_tokenizer_create_ops(&PATTERNS[1], CONSUMERS, 1);
+    TokenizerOperations* rest = polycall_tokenizer_create_ops(&PATTERNS[2], CONSUMERS, 2);
+    TokenizerOperations* composed = polycall_tokenizer_compose_ops(words, rest);
+    assert(composed && composed->dfa && composed->count == 3);
+    polycall_tokenizer_reset(tokenizer);
+    tokens = tokenize(tokenizer, composed, "n -5 - m");
+    assert(tokens->count == 5);
+    assert(tokens->tokens[1].type == TOKEN_NUMBER && tokens->tokens[1].length == 2);
+    assert(tokens->tokens[2].type == TOKEN_OPERATOR && tokens->tokens[2].length == 1);
+
+    polycall_tokenizer_destroy_ops(composed);
+    polycall_tokenizer_destroy_ops(rest);
+    polycall_tokenizer_destroy_ops(words);
+    polycall_tokenizer_destroy(reference);
+    polycall_tokenizer_destroy(tokenizer);
+    polycall_tokenizer_destroy_ops(ops);
+    printf("  V Longest match, positions and values\n");
+}
+
+// Mixed tokens with line breaks, strings up to 40 bytes, escaped quotes
+// and numbers in every form, so chunk ends fall inside each kind of token
+static char* make_stream_input(void) {
+    char* input = malloc(STREAM_INPUT_SIZE + 64);
+    assert(input);
+    size_t length = 0;
+    unsigned int seed = 12345;
+    while (length < STREAM_INPUT_SIZE) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int pick = (seed >> 16) % 8;
+        switch (pick) {
+            case 0: length += (size_t)sprintf(input + length, "ident_%u", seed % 100000); break;
+            case 1: length += (size_t)sprintf(input + length, "%u", seed % 1000000); break;
+            case 2: length += (size_t)sprintf(input + length, "-%u.%ue%u", seed % 97, seed % 13, seed % 9); break;
+            case 3: length += (size_t)sprintf(input + length, "\"%.*s\"", (int)(seed % 40),
+                                             "some quoted text that runs on for a while"); break;
+            case 4: length += (size_t)sprintf(input + length, "\"esc \\\" aped\""); break;
+            case 5: length += (size_t)sprintf(input + length, "%s", seed & 1 ? "<=" : "&&"); break;
+            case 6: length += (size_t)sprintf(input + length, "%s", seed & 1 ? "+" : "*"); break;
+            default: input[length++] = '\n'; break;
+        }
+        input[length++] = (seed & 3) ? ' ' : '\t';
+    }
+    input[length] = '\0';
+    return input;
+}
+
+void test_streaming_input(void) {
+    printf("Testing chunked streaming input...\n");
+    TokenizerOperations* ops = polycall_tokenizer_create_ops(PATTERNS, CONSUMERS, 4);
+    char* input = make_stream_input();
+    size_t length = strlen(input);
+
+    PolycallTokenizer* reference = polycall_tokenizer_create(&STREAM_CONFIG);
+    const PolycallTokenArray* expected = tokenize(reference, ops, input);
+    assert(expected->count > 1000 && expected->tokens[expected->count - 1].type == TOKEN_EOF);
+
+    const size_t chunk_sizes[] = { 1, 2, 3, 7, 64, 1000, 4093, 65536 };
+    PolycallTokenizer* tokenizer = polycall_tokenizer_create(&STREAM_CONFIG);
+    for (size_t s = 0; s < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); s++) {
+        polycall_tokenizer_reset(tokenizer);
+        uint32_t seen = 0;
+        for (size_t offset = 0; offset < length; ) {
+            size_t piece = length - offset < chunk_sizes[s] ? length - offset : chunk_sizes[s];
+            size_t consumed = 0;
+            assert(polycall_tokenizer_feed(tokenizer, ops, input + offset, piece, &consumed));
+            const PolycallTokenArray* tokens = polycall_tokenizer_get_tokens(tokenizer);
+            for (uint32_t i = 0; i < tokens->count; i++) {
+                assert(same_token(&tokens->tokens[i], &expected->tokens[seen++]));
+            }
+            offset += consumed;
+        }
+        assert(polycall_tokenizer_finish(tokenizer, ops));
+        const PolycallTokenArray* tokens = polycall_tokenizer_get_tokens(tokenizer);
+        for (uint32_t i = 0; i < tokens->count; i++) {
+            assert(same_token(&tokens->tokens[i], &expected->tokens[seen++]));
+        }
+        assert(seen == expected->count);
+        assert(polycall_tokenizer_get_state(tokenizer) == TOKENIZER_STATE_EOF);
+    }
+
+    // The last chunk given as such needs no finish
+    polycall_tokenizer_reset(tokenizer);
+    size_t consumed = 0;
+    uint32_t seen = 0;
+    for (size_t offset = 0; offset < length; offset += consumed) {
+        assert(polycall_tokenizer_feed_last(tokenizer, ops, input + offset, length - offset,
+                                            &consumed));
+        const PolycallTokenArray* tokens = polycall_tokenizer_get_tokens(tokenizer);
+        for (uint32_t i = 0; i < tokens->count; i++) {
+            assert(same_token(&tokens->tokens[i], &expected->tokens[seen++]));
+        }
+    }
+    assert(seen == expected->count);
+    assert(polycall_tokenizer_get_state(tokenizer) == TOKENIZER_STATE_EOF);
+
+    // A straddling token past the carry limit is refused
+    char long_name[300];
+    memset(long_name, 'q', sizeof(long_name));
+    polycall_tokenizer_reset(tokenizer);
+    bool ok = true;
+    for (size_t offset = 0; ok && offset < sizeof(long_name); offset += 100) {
+        size_t piece = sizeof(long_name) - offset < 100 ? sizeof(long_name) - offset : 100;
+        ok = polycall_tokenizer_feed(tokenizer, ops, long_name + offset, piece, &consumed);
+    }
+    assert(!ok && strcmp(polycall_tokenizer_get_error(tokenizer), "Token too long") == 0);
+    printf("  V %u tokens identical at every chunk size\n", expected->count);
+
+    polycall_tokenizer_destroy(tokenizer);
+    polycall_tokenizer_destroy(reference);
+    polycall_tokenizer_destroy_ops(ops);
+    free(input);
+}
+
+int main(void) {
+    test_dfa_tokens();
+    test_streaming_input();
+    printf("All tokenizer tests passed\n");
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Checks for the pooled packet buffers, descriptor passing over Unix
+// sockets and the shared-memory rings (network_buffer.c, network.c,
+// network_shm.c)
+#include "network.h"
+#include "network_shm.h"
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define CHAIN_BYTES 40000
+#define SHM_FRAMES 200000
+
+static void make_endpoint(NetworkEndpoint* endpoint, int fd) {
+    memset(endpoint, 0, sizeof(*endpoint));
+    pthread_mutex_init(&endpoint->lock, NULL);
+    endpoint->protocol = NET_UNIX;
+    endpoint->socket_fd = fd;
+}
+
+void test_buffer_pool(void) {
+    printf("Testing pooled packet buffers...\n");
+    NetworkBufferPool* pool = net_buffer_pool_create(1024);
+    assert(net_buffer_pool_buffer_size(pool) == 1024);
+
+    // A returned buffer is handed out again
+    NetworkBuffer* first = net_buffer_alloc(pool, 100);
+    assert(first && first->pool == pool && first->capacity == 1024 && first->length == 0);
+    assert(net_buffer_unique(first));
+    assert(net_buffer_retain(first) == first && !net_buffer_unique(first));
+    net_buffer_release(first);
+    assert(net_buffer_unique(first));
+    net_buffer_release(first);
+    assert(net_buffer_alloc(pool, 1024) == first);
+
+    // Larger than the pool's buffers: one piece off the heap
+    NetworkBuffer* large = net_buffer_alloc(pool, 5000);
+    assert(large && large->pool == NULL && large->capacity == 5000);
+    net_buffer_release(large);
+
+    // Appends link pool buffers, and the chain goes out in one piece
+    static uint8_t bytes[CHAIN_BYTES], received[CHAIN_BYTES];
+    for (size_t i = 0; i < sizeof(bytes); i++) bytes[i] = (uint8_t)(i * 7);
+    assert(net_buffer_append(first, bytes, 10));
+    assert(net_buffer_append(first, bytes + 10, sizeof(bytes) - 10));
+    assert(net_buffer_chain_length(first) == sizeof(bytes));
+    int links = 0;
+    for (NetworkBuffer* link = first; link; link = link->next) links++;
+    assert(links == (CHAIN_BYTES + 1023) / 1024);
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int size = CHAIN_BYTES * 2;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    NetworkEndpoint endpoint;
+    make_endpoint(&endpoint, fds[0]);
+    assert(net_send_buffer(&endpoint, first) == CHAIN_BYTES);
+    size_t got = 0;
+    while (got < sizeof(received)) {
+        ssize_t n = recv(fds[1], received + got, sizeof(received) - got, 0);
+        assert(n > 0);
+        got += (size_t)n;
+    }
+    assert(memcmp(bytes, received, sizeof(bytes)) == 0);
+
+    // The pool outlives its destroy while a chain is still held
+    net_buffer_pool_destroy(pool);
+    assert(first->next->pool == pool);
+    net_buffer_release(first);
+
+    // Without a pool, appends grow one-off links at least twice as large
+    NetworkBuffer* loose = net_buffer_alloc(NULL, 16);
+    for (int i = 0; i < 100; i++) assert(net_buffer_append(loose, bytes, 100));
+    links = 0;
+    for (NetworkBuffer* link = loose; link; link = link->next) links++;
+    assert(net_buffer_chain_length(loose) == 10000 && links <= 11);
+    net_buffer_release(loose);
+
+    close(fds[0]);
+    close(fds[1]);
+    pthread_mutex_destroy(&endpoint.lock);
+    printf("  V %d-link chain sent whole, buffers reused\n", (CHAIN_BYTES + 1023) / 1024);
+}
+
+void test_descriptor_passing(void) {
+    printf("Testing descriptor passing...\n");
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+    NetworkEndpoint sender, receiver;
+    make_endpoint(&sender, fds[0]);
+    make_endpoint(&receiver, fds[1]);
+
+    // Pass the write ends of two pipes and use them from the other side
+    int pipes[2][2];
+    assert(pipe(pipes[0]) == 0 && pipe(pipes[1]) == 0);
+    int passing[2] = { pipes[0][1], pipes[1][1] };
+    struct iovec iov = { "fds", 3 };
+    assert(net_send_fds(&sender, &iov, 1, passing, 2) == 3);
+    close(pipes[0][1]);
+    close(pipes[1][1]);
+
+    char data[16];
+    int arrived[NET_MAX_FDS];
+    NetworkPacket packet = { .data = data, .size = sizeof(data) };
+    assert(net_receive_fds(&receiver, &packet, arrived) == 3);
+    assert(memcmp(data, "fds", 3) == 0);
+    assert(packet.fd_count == 2 && packet.fds == arrived);
+    for (int i = 0; i < 2; i++) {
+        char byte = 0;
+        assert(write(packet.fds[i], "ab" + i, 1) == 1);
+        close(packet.fds[i]);
+        assert(read(pipes[i][0], &byte, 1) == 1 && byte == "ab"[i]);
+        assert(read(pipes[i][0], &byte, 1) == 0);
+        close(pipes[i][0]);
+    }
+
+    // Data alone arrives without descriptors; too many are refused
+    assert(net_send_fds(&sender, &iov, 1, NULL, 0) == 3);
+    assert(net_receive_fds(&receiver, &packet, arrived) == 3);
+    assert(packet.fd_count == 0 && packet.fds == NULL);
+    assert(net_send_fds(&sender, &iov, 1, arrived, NET_MAX_FDS + 1) == -1);
+
+    close(fds[0]);
+    close(fds[1]);
+    pthread_mutex_destroy(&sender.lock);
+    pthread_mutex_destroy(&receiver.lock);
+    printf("  V Two descriptors arrived with their data and work\n");
+}
+
+// Frame n is n + 1 words counting up from n, so sizes vary, the ring
+// wraps at different offsets, and a torn or reordered frame shows
+static size_t shm_frame(uint32_t* words, uint32_t n) {
+    size_t count = n % 61 + 1;
+    for (size_t i = 0; i < count; i++) words[i] = n + (uint32_t)i;
+    return count * sizeof(uint32_t);
+}
+
+static void* shm_writer(void* arg) {
+    NetworkShm* shm = arg;
+    uint32_t words[64];
+    for (uint32_t n = 0; n < SHM_FRAMES; n++) {
+        struct iovec iov = { words, shm_frame(words, n) };
+        assert(net_shm_sendv(shm, &iov, 1, -1));
+    }
+    return NULL;
+}
+
+void test_shared_memory(void) {
+    printf("Testing the shared-memory rings...\n");
+    NetworkShm* creator = net_shm_create(1000);
+    assert(creator);
+    assert(net_shm_frame_limit(creator) == NET_SHM_RING_MIN / 2 - 8);
+    NetworkShmOffer offer;
+    assert(net_shm_offer(creator, &offer) && offer.ring_size == NET_SHM_RING_MIN);
+
+    // A wrong token does not attach
+    NetworkShmOffer forged = offer;
+    forged.token ^= 1;
+    assert(net_shm_attach(&forged) == NULL && errno == EINVAL);
+    NetworkShm* peer = net_shm_attach(&offer);
+    assert(peer);
+    net_shm_seal(creator);
+    assert(!net_shm_offer(creator, &offer));
+
+    // Frames go both ways, gathered on send and whole on receive
+    struct iovec pieces[2] = { { "hello ", 6 }, { "ring", 4 } };
+    assert(net_shm_sendv(creator, pieces, 2, 0));
+    assert(net_shm_sendv(peer, pieces + 1, 1, 0));
+    size_t length = 0;
+    const char* frame = net_shm_peek(peer, &length);
+    assert(frame && length == 10 && memcmp(frame, "hello ring", 10) == 0);
+    net_shm_consume(peer);
+    assert(net_shm_peek(peer, &length) == NULL && errno == EAGAIN);
+    frame = net_shm_peek(creator, &length);
+    assert(frame && length == 4 && memcmp(frame, "ring", 4) == 0);
+    net_shm_consume(creator);
+
+    // Oversized frames are refused; a full ring times out
+    static char big[NET_SHM_RING_MIN];
+    struct iovec whole = { big, net_shm_frame_limit(creator) + 1 };
+    assert(!net_shm_sendv(creator, &whole, 1, 0) && errno == EMSGSIZE);
+    whole.iov_len = 1000;
+    int sent = 0;
+    while (net_shm_sendv(creator, &whole, 1, 0)) sent++;
+    assert(errno == EAGAIN && sent >= NET_SHM_RING_MIN / 1008 - 1);
+    assert(!net_shm_sendv(creator, &whole, 1, 20) && errno == EAGAIN);
+    for (int i = 0; i < sent; i++) {
+        assert(net_shm_peek(peer, &length) && length == 1000);
+        net_shm_consume(peer);
+    }
+
+    // A writer thread keeps the ring wrapping while this one reads
+    pthread_t writer;
+    assert(pthread_create(&writer, NULL, shm_writer, creator) == 0);
+    uint32_t expected[64];
+    for (uint32_t n = 0; n < SHM_FRAMES; n++) {
+        const void* words;
+        while (!(words = net_shm_peek(peer, &length))) {
+            assert(errno == EAGAIN);
+            net_shm_wait(peer, -1);
+        }
+        assert(length == shm_frame(expected, n) && memcmp(words, expected, length) == 0);
+        net_shm_consume(peer);
+    }
+    pthread_join(writer, NULL);
+
+    // A departed peer reads as EPIPE once the ring is drained
+    assert(net_shm_sendv(creator, pieces, 1, 0));
+    net_shm_destroy(creator);
+    assert(net_shm_wait(peer, 0));
+    assert(net_shm_peek(peer, &length) && length == 6);
+    net_shm_consume(peer);
+    assert(net_shm_peek(peer, &length) == NULL && errno == EPIPE);
+    assert(!net_shm_sendv(peer, pieces, 1, 0) && errno == EPIPE);
+    net_shm_destroy(peer);
+    printf("  V %d frames across a wrapping ring, in order\n", SHM_FRAMES);
+}
+
+int main(void) {
+    test_buffer_pool();
+    test_descriptor_passing();
+    test_shared_memory();
+    printf("All transport tests passed\n");
+    return 0;
+}
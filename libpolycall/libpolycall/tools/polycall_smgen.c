@@ -0,0 +1,468 @@
+// polycall-smgen: state machine tables from a Polycallfile
+//
+// Reads the state machine lines of a Polycallfile and writes a C header
+// with the machine as static const tables, ready for polycall_sm_static_fire
+// or polycall_sm_create_from_static, and an inline <prefix>_fire that
+// calls the guards and actions directly. Other lines are skipped, so the
+// definition can live in the same file as the rest of the configuration:
+//
+//     state NAME [initial] [final] [enter FN] [exit FN]
+//     transition NAME FROM -> TO [guard FN] [action FN]
+//
+// Transitions that share a name share an event ID, so one event can leave
+// several states; for any one state the first declaration wins. The header
+// declares each named guard (bool FN(const PolyCall_State*, const
+// PolyCall_State*)) and action (void FN(polycall_context_t)) static, for
+// the file that includes it to define.
+//
+//     polycall-smgen [-p prefix] [-o header] Polycallfile
+
+#include "polycall.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_TRANSITION 0xFF
+#define MAX_LINE 512
+#define MAX_CALLBACKS (POLYCALL_MAX_STATES * 2 + POLYCALL_MAX_TRANSITIONS * 2)
+
+typedef struct {
+    char name[POLYCALL_MAX_NAME_LENGTH];
+    char on_enter[POLYCALL_MAX_NAME_LENGTH];
+    char on_exit[POLYCALL_MAX_NAME_LENGTH];
+    bool is_final;
+} StateDef;
+
+typedef struct {
+    char name[POLYCALL_MAX_NAME_LENGTH];
+    unsigned int from_state;
+    unsigned int to_state;
+    unsigned int event_id;
+    char guard[POLYCALL_MAX_NAME_LENGTH];
+    char action[POLYCALL_MAX_NAME_LENGTH];
+} TransitionDef;
+
+typedef struct {
+    const char* path;
+    StateDef states[POLYCALL_MAX_STATES];
+    unsigned int num_states;
+    unsigned int initial_state;
+    bool has_initial;
+    TransitionDef transitions[POLYCALL_MAX_TRANSITIONS];
+    unsigned int num_transitions;
+    unsigned int event_first[POLYCALL_MAX_TRANSITIONS];   // Event -> first transition with its name
+    unsigned int num_events;
+    uint8_t next[POLYCALL_MAX_STATES][POLYCALL_MAX_TRANSITIONS];
+} MachineDef;
+
+static bool fail(const MachineDef* def, unsigned int line, const char* format, ...) {
+    va_list args;
+    fprintf(stderr, "%s:%u: ", def->path, line);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    return false;
+}
+
+static bool is_identifier(const char* text) {
+    if (!text || !(isalpha((unsigned char)*text) || *text == '_')) return false;
+    for (const char* p = text; *p; p++) {
+        if (!isalnum((unsigned char)*p) && *p != '_') return false;
+    }
+    return strlen(text) < POLYCALL_MAX_NAME_LENGTH;
+}
+
+// Names are compared as they will appear in the enums
+static bool same_upper(const char* a, const char* b) {
+    for (; *a && *b; a++, b++) {
+        if (toupper((unsigned char)*a) != toupper((unsigned char)*b)) return false;
+    }
+    return *a == *b;
+}
+
+static int find_state(const MachineDef* def, const char* name) {
+    for (unsigned int i = 0; i < def->num_states; i++) {
+        if (strcmp(def->states[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+// The callback after a keyword such as "enter"
+static bool take_callback(const MachineDef* def, unsigned int line, const char* keyword,
+                          char* target) {
+    const char* name = strtok(NULL, " \t\r\n");
+    if (!is_identifier(name)) return fail(def, line, "'%s' needs a function name", keyword);
+    if (*target) return fail(def, line, "'%s' given twice", keyword);
+    strcpy(target, name);
+    return true;
+}
+
+static bool parse_state(MachineDef* def, unsigned int line) {
+    const char* name = strtok(NULL, " \t\r\n");
+    if (!is_identifier(name)) return fail(def, line, "state needs a name");
+    for (unsigned int i = 0; i < def->num_states; i++) {
+        if (same_upper(def->states[i].name, name)) {
+            return fail(def, line, "state %s already defined", name);
+        }
+    }
+    if (def->num_states >= POLYCALL_MAX_STATES) {
+        return fail(def, line, "more than %d states", POLYCALL_MAX_STATES);
+    }
+
+    StateDef* state = &def->states[def->num_states];
+    memset(state, 0, sizeof(*state));
+    strcpy(state->name, name);
+
+    for (const char* word; (word = strtok(NULL, " \t\r\n")) != NULL;) {
+        if (strcmp(word, "initial") == 0) {
+            if (def->has_initial) return fail(def, line, "second initial state");
+            def->initial_state = def->num_states;
+            def->has_initial = true;
+        } else if (strcmp(word, "final") == 0) {
+            state->is_final = true;
+        } else if (strcmp(word, "enter") == 0) {
+            if (!take_callback(def, line, word, state->on_enter)) return false;
+        } else if (strcmp(word, "exit") == 0) {
+            if (!take_callback(def, line, word, state->on_exit)) return false;
+        } else {
+            return fail(def, line, "unexpected '%s'", word);
+        }
+    }
+
+    def->num_states++;
+    return true;
+}
+
+static bool parse_transition(MachineDef* def, unsigned int line) {
+    const char* name = strtok(NULL, " \t\r\n");
+    const char* from = strtok(NULL, " \t\r\n");
+    const char* arrow = strtok(NULL, " \t\r\n");
+    const char* to = strtok(NULL, " \t\r\n");
+    if (!is_identifier(name) || !from || !arrow || strcmp(arrow, "->") != 0 || !to) {
+        return fail(def, line, "expected: transition NAME FROM -> TO");
+    }
+    if (def->num_transitions >= POLYCALL_MAX_TRANSITIONS) {
+        return fail(def, line, "more than %d transitions", POLYCALL_MAX_TRANSITIONS);
+    }
+
+    int from_state = find_state(def, from), to_state = find_state(def, to);
+    if (from_state < 0) return fail(def, line, "unknown state %s", from);
+    if (to_state < 0) return fail(def, line, "unknown state %s", to);
+
+    TransitionDef* transition = &def->transitions[def->num_transitions];
+    memset(transition, 0, sizeof(*transition));
+    strcpy(transition->name, name);
+    transition->from_state = (unsigned int)from_state;
+    transition->to_state = (unsigned int)to_state;
+
+    for (const char* word; (word = strtok(NULL, " \t\r\n")) != NULL;) {
+        if (strcmp(word, "guard") == 0) {
+            if (!take_callback(def, line, word, transition->guard)) return false;
+        } else if (strcmp(word, "action") == 0) {
+            if (!take_callback(def, line, word, transition->action)) return false;
+        } else {
+            return fail(def, line, "unexpected '%s'", word);
+        }
+    }
+
+    // Intern the name, as polycall_sm_compile does at run time
+    unsigned int event = def->num_events;
+    for (unsigned int e = 0; e < def->num_events; e++) {
+        const char* other = def->transitions[def->event_first[e]].name;
+        if (strcmp(other, name) == 0) {
+            event = e;
+            break;
+        }
+        if (same_upper(other, name)) {
+            return fail(def, line, "event %s clashes with %s", name, other);
+        }
+    }
+    if (event == def->num_events) def->event_first[def->num_events++] = def->num_transitions;
+    transition->event_id = event;
+    if (def->next[from_state][event] == NO_TRANSITION) {
+        def->next[from_state][event] = (uint8_t)def->num_transitions;
+    }
+
+    def->num_transitions++;
+    return true;
+}
+
+static bool parse_file(MachineDef* def, FILE* in) {
+    char text[MAX_LINE];
+    unsigned int line = 0;
+    memset(def->next, NO_TRANSITION, sizeof(def->next));
+
+    while (fgets(text, sizeof(text), in)) {
+        line++;
+        const char* keyword = strtok(text, " \t\r\n");
+        if (!keyword || keyword[0] == '#') continue;
+
+        if (strcmp(keyword, "state") == 0) {
+            if (!parse_state(def, line)) return false;
+        } else if (strcmp(keyword, "transition") == 0) {
+            if (!parse_transition(def, line)) return false;
+        }
+    }
+
+    if (def->num_states == 0 || def->num_transitions == 0) {
+        return fail(def, line, "no state machine defined (state and transition lines)");
+    }
+    return true;
+}
+
+static void emit_upper(FILE* out, const char* text) {
+    for (; *text; text++) fputc(toupper((unsigned char)*text), out);
+}
+
+static void emit_state_id(FILE* out, const char* prefix, const MachineDef* def, unsigned int state) {
+    emit_upper(out, prefix);
+    fputs("_STATE_", out);
+    emit_upper(out, def->states[state].name);
+}
+
+static void emit_event_id(FILE* out, const char* prefix, const MachineDef* def, unsigned int event) {
+    emit_upper(out, prefix);
+    fputs("_EVENT_", out);
+    emit_upper(out, def->transitions[def->event_first[event]].name);
+}
+
+static void emit_callback(FILE* out, const char* name) {
+    fputs(*name ? name : "NULL", out);
+}
+
+// One prototype per distinct callback name, guards and actions apart
+static bool emit_prototypes(FILE* out, const MachineDef* def) {
+    const char* actions[MAX_CALLBACKS];
+    const char* guards[POLYCALL_MAX_TRANSITIONS];
+    unsigned int num_actions = 0, num_guards = 0;
+
+    for (unsigned int i = 0; i < def->num_states; i++) {
+        actions[num_actions++] = def->states[i].on_enter;
+        actions[num_actions++] = def->states[i].on_exit;
+    }
+    for (unsigned int i = 0; i < def->num_transitions; i++) {
+        actions[num_actions++] = def->transitions[i].action;
+        guards[num_guards++] = def->transitions[i].guard;
+    }
+
+    bool any = false;
+    for (unsigned int i = 0; i < num_actions; i++) {
+        bool seen = !*actions[i];
+        for (unsigned int j = 0; j < i && !seen; j++) seen = strcmp(actions[i], actions[j]) == 0;
+        for (unsigned int j = 0; j < num_guards && !seen; j++) {
+            if (strcmp(actions[i], guards[j]) == 0) {
+                fprintf(stderr, "%s: %s is used as both a guard and an action\n", def->path, actions[i]);
+                return false;
+            }
+        }
+        if (seen) continue;
+        if (!any) fprintf(out, "// Guards and actions, defined by the including file\n");
+        fprintf(out, "static void %s(polycall_context_t ctx);\n", actions[i]);
+        any = true;
+    }
+    for (unsigned int i = 0; i < num_guards; i++) {
+        bool seen = !*guards[i];
+        for (unsigned int j = 0; j < i && !seen; j++) seen = strcmp(guards[i], guards[j]) == 0;
+        if (seen) continue;
+        if (!any) fprintf(out, "// Guards and actions, defined by the including file\n");
+        fprintf(out, "static bool %s(const PolyCall_State* from, const PolyCall_State* to);\n", guards[i]);
+        any = true;
+    }
+    if (any) fputc('\n', out);
+    return true;
+}
+
+static void emit_fire(FILE* out, const char* prefix, const MachineDef* def) {
+    fprintf(out, "// Take event out of *state: polycall_sm_static_fire with the lookup\n");
+    fprintf(out, "// unrolled into switches and the guards and actions called directly\n");
+    fprintf(out, "static inline polycall_sm_status_t %s_fire(polycall_context_t ctx, unsigned int* state,\n", prefix);
+    fprintf(out, "                                           %s_event_t event) {\n", prefix);
+    fprintf(out, "    (void)ctx;\n");
+    fprintf(out, "    switch (event) {\n");
+
+    for (unsigned int e = 0; e < def->num_events; e++) {
+        fprintf(out, "    case ");
+        emit_event_id(out, prefix, def, e);
+        fprintf(out, ":\n        switch (*state) {\n");
+        for (unsigned int s = 0; s < def->num_states; s++) {
+            if (def->next[s][e] == NO_TRANSITION) continue;
+            const TransitionDef* transition = &def->transitions[def->next[s][e]];
+            const StateDef* from = &def->states[transition->from_state];
+            const StateDef* to = &def->states[transition->to_state];
+
+            fprintf(out, "        case ");
+            emit_state_id(out, prefix, def, s);
+            fprintf(out, ":\n");
+            if (*transition->guard) {
+                fprintf(out, "            if (!%s(&%s_states[%u], &%s_states[%u])) {\n",
+                        transition->guard, prefix, transition->from_state, prefix, transition->to_state);
+                fprintf(out, "                return POLYCALL_SM_ERROR_INVALID_TRANSITION;\n");
+                fprintf(out, "            }\n");
+            }
+            if (*from->on_exit) fprintf(out, "            %s(ctx);\n", from->on_exit);
+            if (*transition->action) fprintf(out, "            %s(ctx);\n", transition->action);
+            if (*to->on_enter) fprintf(out, "            %s(ctx);\n", to->on_enter);
+            fprintf(out, "            *state = ");
+            emit_state_id(out, prefix, def, transition->to_state);
+            fprintf(out, ";\n            return POLYCALL_SM_SUCCESS;\n");
+        }
+        fprintf(out, "        default:\n            break;\n        }\n        break;\n");
+    }
+
+    fprintf(out, "    default:\n        break;\n    }\n");
+    fprintf(out, "    return POLYCALL_SM_ERROR_INVALID_TRANSITION;\n");
+    fprintf(out, "}\n\n");
+}
+
+static bool emit_header(FILE* out, const char* prefix, const MachineDef* def) {
+    fprintf(out, "// Generated by polycall-smgen from %s; do not edit.\n", def->path);
+    fprintf(out, "// %u states, %u transitions, %u events\n\n",
+            def->num_states, def->num_transitions, def->num_events);
+    fprintf(out, "#ifndef ");
+    emit_upper(out, prefix);
+    fprintf(out, "_MACHINE_H\n#define ");
+    emit_upper(out, prefix);
+    fprintf(out, "_MACHINE_H\n\n#include \"polycall_state_machine.h\"\n\n");
+
+    fprintf(out, "typedef enum {\n");
+    for (unsigned int s = 0; s < def->num_states; s++) {
+        fprintf(out, "    ");
+        emit_state_id(out, prefix, def, s);
+        fprintf(out, ",\n");
+    }
+    fprintf(out, "    ");
+    emit_upper(out, prefix);
+    fprintf(out, "_STATE_COUNT\n} %s_state_t;\n\n", prefix);
+
+    fprintf(out, "typedef enum {\n");
+    for (unsigned int e = 0; e < def->num_events; e++) {
+        fprintf(out, "    ");
+        emit_event_id(out, prefix, def, e);
+        fprintf(out, ",\n");
+    }
+    fprintf(out, "    ");
+    emit_upper(out, prefix);
+    fprintf(out, "_EVENT_COUNT\n} %s_event_t;\n\n", prefix);
+
+    if (!emit_prototypes(out, def)) return false;
+
+    fprintf(out, "static const PolyCall_State %s_states[] __attribute__((unused)) = {\n", prefix);
+    for (unsigned int s = 0; s < def->num_states; s++) {
+        const StateDef* state = &def->states[s];
+        fprintf(out, "    { .name = \"%s\", .on_enter = ", state->name);
+        emit_callback(out, state->on_enter);
+        fprintf(out, ", .on_exit = ");
+        emit_callback(out, state->on_exit);
+        fprintf(out, ", .is_final = %s, .id = ", state->is_final ? "true" : "false");
+        emit_state_id(out, prefix, def, s);
+        fprintf(out, ", .version = 1 },\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const char* const %s_event_names[] __attribute__((unused)) = {\n", prefix);
+    for (unsigned int e = 0; e < def->num_events; e++) {
+        fprintf(out, "    \"%s\",\n", def->transitions[def->event_first[e]].name);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const PolyCall_StaticTransition %s_transitions[] __attribute__((unused)) = {\n", prefix);
+    for (unsigned int i = 0; i < def->num_transitions; i++) {
+        const TransitionDef* transition = &def->transitions[i];
+        fprintf(out, "    { \"%s\", ", transition->name);
+        emit_event_id(out, prefix, def, transition->event_id);
+        fprintf(out, ", ");
+        emit_state_id(out, prefix, def, transition->from_state);
+        fprintf(out, ", ");
+        emit_state_id(out, prefix, def, transition->to_state);
+        fprintf(out, ", ");
+        emit_callback(out, transition->action);
+        fprintf(out, ", ");
+        emit_callback(out, transition->guard);
+        fprintf(out, " },\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// [state][event] -> transition, 0x%02X for none\n", NO_TRANSITION);
+    fprintf(out, "static const uint8_t %s_next[] __attribute__((unused)) = {\n", prefix);
+    for (unsigned int s = 0; s < def->num_states; s++) {
+        fprintf(out, "    ");
+        for (unsigned int e = 0; e < def->num_events; e++) {
+            fprintf(out, "0x%02X,%s", def->next[s][e], e + 1 < def->num_events ? " " : "");
+        }
+        fprintf(out, "  // %s\n", def->states[s].name);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const PolyCall_StaticMachine %s_machine __attribute__((unused)) = {\n", prefix);
+    fprintf(out, "    .states = %s_states,\n", prefix);
+    fprintf(out, "    .num_states = %u,\n", def->num_states);
+    fprintf(out, "    .transitions = %s_transitions,\n", prefix);
+    fprintf(out, "    .num_transitions = %u,\n", def->num_transitions);
+    fprintf(out, "    .event_names = %s_event_names,\n", prefix);
+    fprintf(out, "    .num_events = %u,\n", def->num_events);
+    fprintf(out, "    .initial_state = ");
+    emit_state_id(out, prefix, def, def->initial_state);
+    fprintf(out, ",\n    .next = %s_next,\n};\n\n", prefix);
+
+    emit_fire(out, prefix, def);
+
+    fprintf(out, "#endif\n");
+    return !ferror(out);
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "Usage: %s [-p prefix] [-o header] Polycallfile\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    const char* prefix = "polycall_machine";
+    const char* output = NULL;
+    const char* input = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] != '-' && !input) {
+            input = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!input || !is_identifier(prefix)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    static MachineDef def;
+    def.path = input;
+    FILE* in = fopen(input, "r");
+    if (!in) {
+        perror(input);
+        return 1;
+    }
+    bool parsed = parse_file(&def, in);
+    fclose(in);
+    if (!parsed) return 1;
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        return 1;
+    }
+    bool written = emit_header(out, prefix, &def);
+    if (output && fclose(out) != 0) written = false;
+    if (!written) {
+        fprintf(stderr, "Failed to write %s\n", output ? output : "header");
+        if (output) remove(output);
+        return 1;
+    }
+    return 0;
+}
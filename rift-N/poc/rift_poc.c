@@ -2,11 +2,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <regex.h>
+#include <time.h>
 
 // Structure definitions
 typedef struct State {
     char* pattern;
+    regex_t regex;          // pattern, compiled once in state_create
+    bool compiled;          // false if pattern failed to compile
+    size_t group_count;     // Parenthesised subexpressions in pattern
     bool is_final;
     size_t id;
 } State;
@@ -26,6 +31,15 @@ typedef struct RegexAutomaton {
     size_t transition_capacity;
     State* initial_state;
     State* current_state;
+
+    // All compiled state patterns as one alternation, rebuilt on the next
+    // match after a state is added; group_state maps each subexpression of
+    // combined to the state whose alternative it opens, or NULL
+    regex_t combined;
+    bool combined_valid;
+    bool combined_dirty;
+    State** group_state;
+    size_t group_count;
 } RegexAutomaton;
 
 typedef struct TokenNode {
@@ -33,8 +47,12 @@ typedef struct TokenNode {
     char* value;
 } TokenNode;
 
+struct RiftLexTable;
+
 typedef struct IRGenerator {
     RegexAutomaton* automaton;
+    struct RiftLexTable* table;     // Compiled automaton, or NULL
+    size_t table_state_count;       // Automaton states when table was compiled
     TokenNode** nodes;
     size_t node_count;
     size_t node_capacity;
@@ -46,6 +64,34 @@ static size_t generate_id(void) {
     return next_id++;
 }
 
+// Counts the subexpressions a POSIX ERE opens: unescaped '(' outside
+// bracket expressions
+static size_t count_groups(const char* pattern) {
+    size_t groups = 0;
+    for (const char* p = pattern; *p; p++) {
+        if (*p == '\\') {
+            if (!*++p) break;
+        } else if (*p == '[') {
+            p++;
+            if (*p == '^') p++;
+            if (*p == ']') p++;
+            while (*p && *p != ']') {
+                if (*p == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '=')) {
+                    char delim = p[1];
+                    p += 2;
+                    while (*p && !(*p == delim && p[1] == ']')) p++;
+                    if (*p) p++;
+                }
+                if (*p) p++;
+            }
+            if (!*p) break;
+        } else if (*p == '(') {
+            groups++;
+        }
+    }
+    return groups;
+}
+
 // State functions
 State* state_create(const char* pattern, bool is_final) {
     State* state = malloc(sizeof(State));
@@ -57,6 +103,9 @@ State* state_create(const char* pattern, bool is_final) {
         return NULL;
     }
     
+    // A pattern that does not compile never matches
+    state->compiled = (regcomp(&state->regex, pattern, REG_EXTENDED) == 0);
+    state->group_count = count_groups(pattern);
     state->is_final = is_final;
     state->id = generate_id();
     return state;
@@ -64,23 +113,15 @@ State* state_create(const char* pattern, bool is_final) {
 
 void state_destroy(State* state) {
     if (!state) return;
+    if (state->compiled) regfree(&state->regex);
     free(state->pattern);
     free(state);
 }
 
 bool state_matches(State* state, const char* text) {
-    if (!state || !text) return false;
+    if (!state || !text || !state->compiled) return false;
     
-    regex_t regex;
-    int result;
-    
-    result = regcomp(&regex, state->pattern, REG_EXTENDED);
-    if (result) return false;
-    
-    result = regexec(&regex, text, 0, NULL, 0);
-    regfree(&regex);
-    
-    return (result == 0);
+    return regexec(&state->regex, text, 0, NULL, 0) == 0;
 }
 
 // Automaton functions
@@ -107,13 +148,27 @@ RegexAutomaton* automaton_create(void) {
     automaton->transition_count = 0;
     automaton->initial_state = NULL;
     automaton->current_state = NULL;
+    automaton->combined_valid = false;
+    automaton->combined_dirty = false;
+    automaton->group_state = NULL;
+    automaton->group_count = 0;
     
     return automaton;
 }
 
+static void automaton_free_combined(RegexAutomaton* automaton) {
+    if (automaton->combined_valid) regfree(&automaton->combined);
+    free(automaton->group_state);
+    automaton->combined_valid = false;
+    automaton->group_state = NULL;
+    automaton->group_count = 0;
+}
+
 void automaton_destroy(RegexAutomaton* automaton) {
     if (!automaton) return;
     
+    automaton_free_combined(automaton);
+    
     for (size_t i = 0; i < automaton->state_count; i++) {
         state_destroy(automaton->states[i]);
     }
@@ -145,6 +200,7 @@ State* automaton_add_state(RegexAutomaton* automaton, const char* pattern, bool
     if (!state) return NULL;
     
     automaton->states[automaton->state_count++] = state;
+    automaton->combined_dirty = true;
     
     if (!automaton->initial_state) {
         automaton->initial_state = state;
@@ -183,18 +239,1125 @@ bool automaton_add_transition(RegexAutomaton* automaton, State* from, const char
     return true;
 }
 
+// Joins the compiled state patterns into "(p1)|(p2)|...", so one regexec
+// tests every state; the outermost group that matched names the state
+static bool automaton_build_combined(RegexAutomaton* automaton) {
+    automaton_free_combined(automaton);
+    automaton->combined_dirty = false;
+    
+    size_t length = 1, groups = 1;
+    for (size_t i = 0; i < automaton->state_count; i++) {
+        State* state = automaton->states[i];
+        if (!state->compiled) continue;
+        length += strlen(state->pattern) + 3;
+        groups += state->group_count + 1;
+    }
+    
+    char* pattern = malloc(length);
+    State** group_state = calloc(groups, sizeof(State*));
+    if (!pattern || !group_state) {
+        free(pattern);
+        free(group_state);
+        return false;
+    }
+    
+    char* out = pattern;
+    size_t group = 1;
+    for (size_t i = 0; i < automaton->state_count; i++) {
+        State* state = automaton->states[i];
+        if (!state->compiled) continue;
+        if (out != pattern) *out++ = '|';
+        out += sprintf(out, "(%s)", state->pattern);
+        group_state[group] = state;
+        group += state->group_count + 1;
+    }
+    *out = '\0';
+    
+    // No compiled states: nothing can match
+    if (out == pattern || regcomp(&automaton->combined, pattern, REG_EXTENDED) != 0) {
+        free(pattern);
+        free(group_state);
+        return false;
+    }
+    
+    free(pattern);
+    automaton->combined_valid = true;
+    automaton->group_state = group_state;
+    automaton->group_count = groups;
+    return true;
+}
+
+// Finds the state matching input with a single scan. Where several states
+// match, POSIX takes the leftmost-longest match and, between equally long
+// ones, the earliest state; for whole-token "^...$" patterns that is the
+// first matching state, as a state-by-state search would give.
+State* automaton_match(RegexAutomaton* automaton, const char* input) {
+    if (!automaton || !input) return NULL;
+    
+    if (automaton->combined_dirty && !automaton_build_combined(automaton)) return NULL;
+    if (!automaton->combined_valid) return NULL;
+    
+    regmatch_t stack_matches[32];
+    regmatch_t* matches = stack_matches;
+    if (automaton->group_count > 32) {
+        matches = malloc(sizeof(regmatch_t) * automaton->group_count);
+        if (!matches) return NULL;
+    }
+    
+    State* state = NULL;
+    if (regexec(&automaton->combined, input, automaton->group_count, matches, 0) == 0) {
+        for (size_t g = 1; g < automaton->group_count; g++) {
+            if (automaton->group_state[g] && matches[g].rm_so != -1) {
+                state = automaton->group_state[g];
+                break;
+            }
+        }
+    }
+    
+    if (matches != stack_matches) free(matches);
+    return state;
+}
+
 State* automaton_get_next_state(RegexAutomaton* automaton, const char* input) {
     if (!automaton || !automaton->current_state || !input) return NULL;
     
-    // Try direct pattern matching first
+    State* state = automaton_match(automaton, input);
+    if (state) automaton->current_state = state;
+    return state;
+}
+
+// Lexer compiler: every state pattern becomes a Thompson NFA fragment, the
+// fragments are joined under one start state, subset construction turns
+// the NFA into a DFA over byte equivalence classes, and Hopcroft's
+// algorithm minimises it into a dense table. Tokenizing is then one class
+// lookup and one table lookup per input byte.
+//
+// Patterns are the ERE subset lexers use: literals, '.', bracket
+// expressions with ranges and [:class:] names, groups, '|', '*', '+', '?'
+// and {m,n}, plus the \d \w \s escapes (and their negations) that POSIX
+// regcomp lacks. As in flex, '\' escapes inside brackets too. A token
+// always starts at the scan position and ends where the match does, so a
+// leading '^' and trailing '$' are implied and accepted; elsewhere they,
+// and backreferences, make the pattern unsupported, and it never matches.
+
+#define RIFT_MAX_REPEAT 255
+
+typedef struct ByteSet {
+    uint32_t bits[8];
+} ByteSet;
+
+static inline void byteset_add(ByteSet* set, int c) {
+    set->bits[c >> 5] |= 1u << (c & 31);
+}
+
+static inline bool byteset_has(const ByteSet* set, int c) {
+    return (set->bits[c >> 5] >> (c & 31)) & 1u;
+}
+
+static void byteset_add_range(ByteSet* set, int lo, int hi) {
+    for (int c = lo; c <= hi; c++) byteset_add(set, c);
+}
+
+static void byteset_invert(ByteSet* set) {
+    for (int i = 0; i < 8; i++) set->bits[i] = ~set->bits[i];
+}
+
+typedef enum {
+    NFA_EPSILON,            // Up to two empty edges, out and out2
+    NFA_SET,                // One edge to out on any byte in the set
+    NFA_ACCEPT              // End of the pattern for token
+} NfaEdge;
+
+typedef struct NfaState {
+    NfaEdge edge;
+    int out;                // -1 if none
+    int out2;
+    int set;                // Index into Nfa.sets, for NFA_SET
+    int token;              // Index into the automaton's states, for NFA_ACCEPT
+} NfaState;
+
+typedef struct Nfa {
+    NfaState* states;
+    size_t count;
+    size_t capacity;
+    ByteSet* sets;
+    size_t set_count;
+    size_t set_capacity;
+} Nfa;
+
+// Thompson fragment: start, and an epsilon end state with no edges yet
+typedef struct NfaFragment {
+    int start;
+    int end;
+} NfaFragment;
+
+typedef struct RegexParser {
+    const char* p;
+    const char* end;        // Pattern end, after any trailing '$'
+    Nfa* nfa;
+    bool error;
+} RegexParser;
+
+static int nfa_add(Nfa* nfa, NfaEdge edge) {
+    if (nfa->count >= nfa->capacity) {
+        size_t new_capacity = nfa->capacity ? nfa->capacity * 2 : 64;
+        NfaState* new_states = realloc(nfa->states, sizeof(NfaState) * new_capacity);
+        if (!new_states) return -1;
+
+        nfa->states = new_states;
+        nfa->capacity = new_capacity;
+    }
+
+    NfaState* state = &nfa->states[nfa->count];
+    state->edge = edge;
+    state->out = -1;
+    state->out2 = -1;
+    state->set = -1;
+    state->token = -1;
+    return (int)nfa->count++;
+}
+
+static int nfa_add_set(Nfa* nfa, const ByteSet* set) {
+    if (nfa->set_count >= nfa->set_capacity) {
+        size_t new_capacity = nfa->set_capacity ? nfa->set_capacity * 2 : 32;
+        ByteSet* new_sets = realloc(nfa->sets, sizeof(ByteSet) * new_capacity);
+        if (!new_sets) return -1;
+
+        nfa->sets = new_sets;
+        nfa->set_capacity = new_capacity;
+    }
+
+    nfa->sets[nfa->set_count] = *set;
+    return (int)nfa->set_count++;
+}
+
+static void nfa_destroy(Nfa* nfa) {
+    free(nfa->states);
+    free(nfa->sets);
+}
+
+static NfaFragment fragment_empty(RegexParser* parser) {
+    int state = nfa_add(parser->nfa, NFA_EPSILON);
+    if (state < 0) parser->error = true;
+    return (NfaFragment){state, state};
+}
+
+static NfaFragment fragment_set(RegexParser* parser, const ByteSet* set) {
+    int index = nfa_add_set(parser->nfa, set);
+    int start = nfa_add(parser->nfa, NFA_SET);
+    int end = nfa_add(parser->nfa, NFA_EPSILON);
+    if (index < 0 || start < 0 || end < 0) {
+        parser->error = true;
+        return (NfaFragment){-1, -1};
+    }
+
+    parser->nfa->states[start].set = index;
+    parser->nfa->states[start].out = end;
+    return (NfaFragment){start, end};
+}
+
+static NfaFragment fragment_concat(RegexParser* parser, NfaFragment a, NfaFragment b) {
+    if (parser->error) return a;
+    parser->nfa->states[a.end].out = b.start;
+    return (NfaFragment){a.start, b.end};
+}
+
+static NfaFragment fragment_alternate(RegexParser* parser, NfaFragment a, NfaFragment b) {
+    int start = nfa_add(parser->nfa, NFA_EPSILON);
+    int end = nfa_add(parser->nfa, NFA_EPSILON);
+    if (start < 0 || end < 0 || parser->error) {
+        parser->error = true;
+        return a;
+    }
+
+    NfaState* states = parser->nfa->states;
+    states[start].out = a.start;
+    states[start].out2 = b.start;
+    states[a.end].out = end;
+    states[b.end].out = end;
+    return (NfaFragment){start, end};
+}
+
+static NfaFragment fragment_star(RegexParser* parser, NfaFragment a) {
+    int start = nfa_add(parser->nfa, NFA_EPSILON);
+    int end = nfa_add(parser->nfa, NFA_EPSILON);
+    if (start < 0 || end < 0 || parser->error) {
+        parser->error = true;
+        return a;
+    }
+
+    NfaState* states = parser->nfa->states;
+    states[start].out = a.start;
+    states[start].out2 = end;
+    states[a.end].out = a.start;
+    states[a.end].out2 = end;
+    return (NfaFragment){start, end};
+}
+
+static NfaFragment fragment_plus(RegexParser* parser, NfaFragment a) {
+    int end = nfa_add(parser->nfa, NFA_EPSILON);
+    if (end < 0 || parser->error) {
+        parser->error = true;
+        return a;
+    }
+
+    NfaState* states = parser->nfa->states;
+    states[a.end].out = a.start;
+    states[a.end].out2 = end;
+    return (NfaFragment){a.start, end};
+}
+
+static NfaFragment fragment_optional(RegexParser* parser, NfaFragment a) {
+    int start = nfa_add(parser->nfa, NFA_EPSILON);
+    if (start < 0 || parser->error) {
+        parser->error = true;
+        return a;
+    }
+
+    NfaState* states = parser->nfa->states;
+    states[start].out = a.start;
+    states[start].out2 = a.end;
+    return (NfaFragment){start, a.end};
+}
+
+// Adds the bytes of a \d \w \s escape (or its negation); false for others
+static bool escape_class(char c, ByteSet* set) {
+    ByteSet class = {{0}};
+    switch (c) {
+        case 'd': case 'D':
+            byteset_add_range(&class, '0', '9');
+            break;
+        case 'w': case 'W':
+            byteset_add_range(&class, '0', '9');
+            byteset_add_range(&class, 'a', 'z');
+            byteset_add_range(&class, 'A', 'Z');
+            byteset_add(&class, '_');
+            break;
+        case 's': case 'S':
+            byteset_add_range(&class, '\t', '\r');
+            byteset_add(&class, ' ');
+            break;
+        default:
+            return false;
+    }
+
+    if (c == 'D' || c == 'W' || c == 'S') byteset_invert(&class);
+    for (int i = 0; i < 8; i++) set->bits[i] |= class.bits[i];
+    return true;
+}
+
+static bool posix_class(const char* name, size_t length, ByteSet* set) {
+    for (int c = 0; c < 256; c++) {
+        bool member;
+        if (length == 5 && strncmp(name, "alpha", 5) == 0) member = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        else if (length == 5 && strncmp(name, "digit", 5) == 0) member = c >= '0' && c <= '9';
+        else if (length == 5 && strncmp(name, "alnum", 5) == 0) member = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        else if (length == 5 && strncmp(name, "space", 5) == 0) member = (c >= '\t' && c <= '\r') || c == ' ';
+        else if (length == 5 && strncmp(name, "upper", 5) == 0) member = c >= 'A' && c <= 'Z';
+        else if (length == 5 && strncmp(name, "lower", 5) == 0) member = c >= 'a' && c <= 'z';
+        else if (length == 5 && strncmp(name, "punct", 5) == 0) member = c > ' ' && c < 127 && !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'));
+        else if (length == 6 && strncmp(name, "xdigit", 6) == 0) member = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        else if (length == 5 && strncmp(name, "blank", 5) == 0) member = c == ' ' || c == '\t';
+        else return false;
+        if (member) byteset_add(set, c);
+    }
+    return true;
+}
+
+static NfaFragment parse_bracket(RegexParser* parser) {
+    ByteSet set = {{0}};
+    bool negate = false;
+    const char* p = parser->p;
+
+    if (p < parser->end && *p == '^') {
+        negate = true;
+        p++;
+    }
+
+    bool first = true;
+    while (p < parser->end && (*p != ']' || first)) {
+        first = false;
+
+        if (p[0] == '[' && p + 1 < parser->end && p[1] == ':') {
+            const char* name = p + 2;
+            const char* close = strstr(name, ":]");
+            if (!close || close >= parser->end || !posix_class(name, (size_t)(close - name), &set)) {
+                parser->error = true;
+                return (NfaFragment){-1, -1};
+            }
+            p = close + 2;
+            continue;
+        }
+
+        int lo = (unsigned char)*p++;
+        if (lo == '\\' && p < parser->end) {
+            if (escape_class(*p, &set)) {
+                p++;
+                continue;
+            }
+            lo = (unsigned char)*p++;
+        }
+
+        int hi = lo;
+        if (p + 1 < parser->end && *p == '-' && p[1] != ']') {
+            p++;
+            hi = (unsigned char)*p++;
+            if (hi == '\\' && p < parser->end) hi = (unsigned char)*p++;
+            if (hi < lo) {
+                parser->error = true;
+                return (NfaFragment){-1, -1};
+            }
+        }
+        byteset_add_range(&set, lo, hi);
+    }
+
+    if (p >= parser->end) {
+        parser->error = true;                       // Unterminated bracket
+        return (NfaFragment){-1, -1};
+    }
+
+    parser->p = p + 1;
+    if (negate) byteset_invert(&set);
+    return fragment_set(parser, &set);
+}
+
+static NfaFragment parse_alternation(RegexParser* parser);
+
+static NfaFragment parse_atom(RegexParser* parser) {
+    char c = *parser->p++;
+    ByteSet set = {{0}};
+
+    switch (c) {
+        case '(': {
+            NfaFragment inner = parser->p < parser->end && *parser->p == ')'
+                ? fragment_empty(parser) : parse_alternation(parser);
+            if (parser->p >= parser->end || *parser->p != ')') {
+                parser->error = true;
+                return inner;
+            }
+            parser->p++;
+            return inner;
+        }
+        case '[':
+            return parse_bracket(parser);
+        case '.':
+            byteset_add_range(&set, 1, 255);
+            return fragment_set(parser, &set);
+        case '\\':
+            if (parser->p >= parser->end) break;
+            c = *parser->p++;
+            if (escape_class(c, &set)) return fragment_set(parser, &set);
+            if (c >= '1' && c <= '9') break;        // Backreferences are not regular
+            byteset_add(&set, (unsigned char)c);
+            return fragment_set(parser, &set);
+        case '^': case '$': case '*': case '+': case '?': case '{': case '|': case ')':
+            break;
+        default:
+            byteset_add(&set, (unsigned char)c);
+            return fragment_set(parser, &set);
+    }
+
+    parser->error = true;
+    return (NfaFragment){-1, -1};
+}
+
+static bool parse_count(RegexParser* parser, int* value) {
+    if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') return false;
+
+    *value = 0;
+    while (parser->p < parser->end && *parser->p >= '0' && *parser->p <= '9') {
+        *value = *value * 10 + (*parser->p++ - '0');
+        if (*value > RIFT_MAX_REPEAT) return false;
+    }
+    return true;
+}
+
+// An atom and its quantifiers. {m,n} needs copies of the atom, so the
+// atom's source is parsed again for each one after the first.
+static NfaFragment parse_repeat(RegexParser* parser) {
+    const char* atom_start = parser->p;
+    NfaFragment fragment = parse_atom(parser);
+    bool quantified = false;
+
+    while (!parser->error && parser->p < parser->end) {
+        char c = *parser->p;
+        if (c == '*') {
+            fragment = fragment_star(parser, fragment);
+        } else if (c == '+') {
+            fragment = fragment_plus(parser, fragment);
+        } else if (c == '?') {
+            fragment = fragment_optional(parser, fragment);
+        } else if (c == '{') {
+            if (quantified) {
+                parser->error = true;               // A bound must follow the atom itself
+                break;
+            }
+
+            int min, max;
+            parser->p++;
+            if (!parse_count(parser, &min)) {
+                parser->error = true;
+                break;
+            }
+            max = min;
+            if (parser->p < parser->end && *parser->p == ',') {
+                parser->p++;
+                max = -1;                           // Unbounded
+                if (parser->p < parser->end && *parser->p != '}' && !parse_count(parser, &max)) {
+                    parser->error = true;
+                    break;
+                }
+            }
+            if (parser->p >= parser->end || *parser->p != '}' || (max >= 0 && max < min)) {
+                parser->error = true;
+                break;
+            }
+            const char* close = parser->p;
+
+            // min required copies, then a starred copy or max - min optional ones
+            NfaFragment result = fragment_empty(parser);
+            int copies = max < 0 ? min + 1 : max;
+            for (int i = 0; i < copies && !parser->error; i++) {
+                NfaFragment copy = fragment;
+                if (i > 0) {
+                    parser->p = atom_start;
+                    copy = parse_atom(parser);
+                }
+                if (i >= min) {
+                    copy = max < 0 ? fragment_star(parser, copy) : fragment_optional(parser, copy);
+                }
+                result = fragment_concat(parser, result, copy);
+            }
+            fragment = result;
+            parser->p = close;
+        } else {
+            break;
+        }
+        quantified = true;
+        parser->p++;
+    }
+    return fragment;
+}
+
+static NfaFragment parse_concatenation(RegexParser* parser) {
+    NfaFragment fragment = fragment_empty(parser);
+    while (!parser->error && parser->p < parser->end && *parser->p != '|' && *parser->p != ')') {
+        fragment = fragment_concat(parser, fragment, parse_repeat(parser));
+    }
+    return fragment;
+}
+
+static NfaFragment parse_alternation(RegexParser* parser) {
+    NfaFragment fragment = parse_concatenation(parser);
+    while (!parser->error && parser->p < parser->end && *parser->p == '|') {
+        parser->p++;
+        fragment = fragment_alternate(parser, fragment, parse_concatenation(parser));
+    }
+    return fragment;
+}
+
+// Adds pattern as token to nfa; returns its start state, or -1 if the
+// pattern is unsupported, after discarding any states it added
+static int nfa_add_pattern(Nfa* nfa, const char* pattern, int token) {
+    size_t state_mark = nfa->count, set_mark = nfa->set_count;
+    size_t length = strlen(pattern);
+
+    // Implied anchors; a '$' is only an anchor if not escaped
+    if (length > 0 && pattern[0] == '^') {
+        pattern++;
+        length--;
+    }
+    if (length > 0 && pattern[length - 1] == '$') {
+        size_t slashes = 0;
+        while (slashes + 1 < length && pattern[length - 2 - slashes] == '\\') slashes++;
+        if (slashes % 2 == 0) length--;
+    }
+
+    RegexParser parser = {pattern, pattern + length, nfa, false};
+    NfaFragment fragment = parse_alternation(&parser);
+    int accept = nfa_add(nfa, NFA_ACCEPT);
+    if (parser.error || parser.p != parser.end || accept < 0) {
+        nfa->count = state_mark;
+        nfa->set_count = set_mark;
+        return -1;
+    }
+
+    nfa->states[accept].token = token;
+    nfa->states[fragment.end].out = accept;
+    return fragment.start;
+}
+
+// Dense lexer table: next[state * class_count + byte_class[byte]]. State 0
+// is the dead state and state 1 the start; accept[state] is the index of
+// the matching automaton state, or -1.
+typedef struct RiftLexTable {
+    uint8_t byte_class[256];
+    size_t class_count;
+    size_t state_count;
+    uint32_t* next;
+    int* accept;
+} RiftLexTable;
+
+void rift_lex_table_destroy(RiftLexTable* table) {
+    if (!table) return;
+    free(table->next);
+    free(table->accept);
+    free(table);
+}
+
+// Splits bytes into classes no NFA byte set tells apart
+static size_t compute_byte_classes(const Nfa* nfa, uint8_t byte_class[256]) {
+    size_t class_count = 1;
+    memset(byte_class, 0, 256);
+
+    for (size_t s = 0; s < nfa->set_count; s++) {
+        int split[256];
+        for (size_t k = 0; k < class_count; k++) split[k] = -1;
+
+        size_t new_count = class_count;
+        for (int c = 0; c < 256; c++) {
+            if (!byteset_has(&nfa->sets[s], c)) continue;
+            int old = byte_class[c];
+            if (split[old] < 0) split[old] = (int)new_count++;
+            byte_class[c] = (uint8_t)split[old];
+        }
+
+        // A class wholly inside the set keeps a number; renumber densely
+        int renumber[512];
+        bool used[512] = {false};
+        for (int c = 0; c < 256; c++) used[byte_class[c]] = true;
+        size_t dense = 0;
+        for (size_t k = 0; k < new_count; k++) renumber[k] = used[k] ? (int)dense++ : -1;
+        for (int c = 0; c < 256; c++) byte_class[c] = (uint8_t)renumber[byte_class[c]];
+        class_count = dense;
+    }
+    return class_count;
+}
+
+// DFA states under construction: sets of NFA states as bitsets, found
+// again through an open-addressed hash table
+typedef struct SubsetTable {
+    size_t words;           // Bitset words per DFA state
+    uint64_t* sets;
+    size_t count;
+    size_t capacity;
+    int* slots;             // DFA state + 1, 0 when empty
+    size_t slot_count;      // Power of two
+} SubsetTable;
+
+static uint64_t subset_hash(const uint64_t* set, size_t words) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < words; i++) {
+        hash ^= set[i];
+        hash *= 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+static bool subset_grow_slots(SubsetTable* table) {
+    size_t slot_count = table->slot_count ? table->slot_count * 2 : 64;
+    int* slots = calloc(slot_count, sizeof(int));
+    if (!slots) return false;
+
+    for (size_t d = 0; d < table->count; d++) {
+        size_t slot = subset_hash(table->sets + d * table->words, table->words) & (slot_count - 1);
+        while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = (int)d + 1;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+// Returns the DFA state for set, adding it if new; -1 if out of memory
+static int subset_intern(SubsetTable* table, const uint64_t* set, bool* added) {
+    *added = false;
+    if ((table->count + 1) * 2 > table->slot_count && !subset_grow_slots(table)) return -1;
+
+    size_t slot = subset_hash(set, table->words) & (table->slot_count - 1);
+    while (table->slots[slot]) {
+        int d = table->slots[slot] - 1;
+        if (memcmp(table->sets + (size_t)d * table->words, set, table->words * sizeof(uint64_t)) == 0) return d;
+        slot = (slot + 1) & (table->slot_count - 1);
+    }
+
+    if (table->count >= table->capacity) {
+        size_t new_capacity = table->capacity ? table->capacity * 2 : 64;
+        uint64_t* new_sets = realloc(table->sets, new_capacity * table->words * sizeof(uint64_t));
+        if (!new_sets) return -1;
+
+        table->sets = new_sets;
+        table->capacity = new_capacity;
+    }
+
+    memcpy(table->sets + table->count * table->words, set, table->words * sizeof(uint64_t));
+    table->slots[slot] = (int)table->count + 1;
+    *added = true;
+    return (int)table->count++;
+}
+
+// Adds the epsilon closure of the states on stack to set
+static void epsilon_closure(const Nfa* nfa, uint64_t* set, int* stack, size_t depth) {
+    while (depth > 0) {
+        int s = stack[--depth];
+        const NfaState* state = &nfa->states[s];
+        if (state->edge != NFA_EPSILON) continue;
+
+        int outs[2] = {state->out, state->out2};
+        for (int k = 0; k < 2; k++) {
+            int t = outs[k];
+            if (t < 0 || (set[t >> 6] >> (t & 63)) & 1u) continue;
+            set[t >> 6] |= 1ULL << (t & 63);
+            stack[depth++] = t;
+        }
+    }
+}
+
+typedef struct Dfa {
+    size_t state_count;
+    size_t class_count;
+    uint32_t* next;
+    int* accept;
+} Dfa;
+
+// Subset construction from start, over byte classes; DFA state 0 is the
+// empty set, so the transition function is total
+static bool build_dfa(const Nfa* nfa, int start, const uint8_t byte_class[256], size_t class_count, Dfa* dfa) {
+    SubsetTable table = {(nfa->count + 63) / 64, NULL, 0, 0, NULL, 0};
+    uint64_t* set = calloc(table.words, sizeof(uint64_t));
+    int* stack = malloc(sizeof(int) * (nfa->count + 1));
+    int representative[256];
+    size_t next_capacity = 0;
+    bool ok = set && stack;
+    bool added;
+
+    for (int c = 255; c >= 0; c--) representative[byte_class[c]] = c;
+    memset(dfa, 0, sizeof(*dfa));
+    dfa->class_count = class_count;
+
+    // Dead state, then the start state
+    if (ok) ok = subset_intern(&table, set, &added) == 0;
+    if (ok) {
+        set[start >> 6] |= 1ULL << (start & 63);
+        stack[0] = start;
+        epsilon_closure(nfa, set, stack, 1);
+        ok = subset_intern(&table, set, &added) == 1;
+    }
+
+    for (size_t d = 0; ok && d < table.count; d++) {
+        if (table.count * class_count > next_capacity) {
+            next_capacity = table.count * class_count * 2;
+            uint32_t* new_next = realloc(dfa->next, next_capacity * sizeof(uint32_t));
+            if (!new_next) {
+                ok = false;
+                break;
+            }
+            dfa->next = new_next;
+        }
+
+        for (size_t k = 0; ok && k < class_count; k++) {
+            size_t depth = 0;
+            memset(set, 0, table.words * sizeof(uint64_t));
+            const uint64_t* from = table.sets + d * table.words;
+            for (size_t s = 0; s < nfa->count; s++) {
+                if (!((from[s >> 6] >> (s & 63)) & 1u)) continue;
+                const NfaState* state = &nfa->states[s];
+                if (state->edge != NFA_SET || !byteset_has(&nfa->sets[state->set], representative[k])) continue;
+                int t = state->out;
+                if ((set[t >> 6] >> (t & 63)) & 1u) continue;
+                set[t >> 6] |= 1ULL << (t & 63);
+                stack[depth++] = t;
+            }
+            epsilon_closure(nfa, set, stack, depth);
+
+            int target = subset_intern(&table, set, &added);
+            if (target < 0) {
+                ok = false;
+                break;
+            }
+            dfa->next[d * class_count + k] = (uint32_t)target;
+        }
+    }
+
+    if (ok) {
+        dfa->state_count = table.count;
+        dfa->accept = malloc(sizeof(int) * table.count);
+        ok = dfa->accept != NULL;
+    }
+
+    // The earliest automaton state wins when several accept
+    for (size_t d = 0; ok && d < table.count; d++) {
+        const uint64_t* members = table.sets + d * table.words;
+        dfa->accept[d] = -1;
+        for (size_t s = 0; s < nfa->count; s++) {
+            if (!((members[s >> 6] >> (s & 63)) & 1u) || nfa->states[s].edge != NFA_ACCEPT) continue;
+            int token = nfa->states[s].token;
+            if (dfa->accept[d] < 0 || token < dfa->accept[d]) dfa->accept[d] = token;
+        }
+    }
+
+    if (!ok) {
+        free(dfa->next);
+        free(dfa->accept);
+        memset(dfa, 0, sizeof(*dfa));
+    }
+    free(set);
+    free(stack);
+    free(table.sets);
+    free(table.slots);
+    return ok;
+}
+
+// Hopcroft's algorithm: starts from blocks of states with the same accept
+// token and splits blocks by their predecessors on each class until none
+// can be split. Blocks are contiguous ranges of elements, with the marked
+// states of a block moved to its front while splitting.
+static bool minimize_dfa(const Dfa* dfa, int* block_of, size_t* block_count) {
+    size_t n = dfa->state_count, k = dfa->class_count;
+    size_t* in_start = calloc(k * n + 1, sizeof(size_t));
+    int* in_source = malloc(sizeof(int) * n * k);
+    int* elements = malloc(sizeof(int) * n);
+    size_t* location = malloc(sizeof(size_t) * n);
+    size_t* first = malloc(sizeof(size_t) * n);
+    size_t* end = malloc(sizeof(size_t) * n);
+    size_t* marked = calloc(n, sizeof(size_t));
+    int* touched = malloc(sizeof(int) * n);
+    int* splitter = malloc(sizeof(int) * n);
+    bool* pending = calloc(n * k, sizeof(bool));
+    int* work = malloc(sizeof(int) * 2 * n * k);
+    bool ok = in_start && in_source && elements && location && first && end && marked &&
+              touched && splitter && pending && work;
+
+    if (ok) {
+        // Predecessors of each state on each class, grouped by (class, target)
+        for (size_t s = 0; s < n; s++) {
+            for (size_t c = 0; c < k; c++) in_start[c * n + dfa->next[s * k + c] + 1]++;
+        }
+        for (size_t i = 0; i < k * n; i++) in_start[i + 1] += in_start[i];
+        size_t* fill = malloc(sizeof(size_t) * k * n);
+        ok = fill != NULL;
+        if (ok) {
+            memcpy(fill, in_start, sizeof(size_t) * k * n);
+            for (size_t s = 0; s < n; s++) {
+                for (size_t c = 0; c < k; c++) in_source[fill[c * n + dfa->next[s * k + c]]++] = (int)s;
+            }
+            free(fill);
+        }
+    }
+
+    size_t blocks = 0, work_count = 0;
+    if (ok) {
+        // Initial blocks by accept token, in order of first appearance
+        for (size_t s = 0; s < n; s++) block_of[s] = -1;
+        for (size_t s = 0; s < n; s++) {
+            if (block_of[s] >= 0) continue;
+            for (size_t t = s; t < n; t++) {
+                if (block_of[t] < 0 && dfa->accept[t] == dfa->accept[s]) block_of[t] = (int)blocks;
+            }
+            blocks++;
+        }
+
+        size_t position = 0;
+        for (size_t b = 0; b < blocks; b++) {
+            first[b] = position;
+            for (size_t s = 0; s < n; s++) {
+                if (block_of[s] != (int)b) continue;
+                elements[position] = (int)s;
+                location[s] = position++;
+            }
+            end[b] = position;
+        }
+
+        // Every block but the largest is a splitter on every class
+        size_t largest = 0;
+        for (size_t b = 1; b < blocks; b++) {
+            if (end[b] - first[b] > end[largest] - first[largest]) largest = b;
+        }
+        for (size_t b = 0; b < blocks; b++) {
+            if (b == largest) continue;
+            for (size_t c = 0; c < k; c++) {
+                pending[b * k + c] = true;
+                work[work_count++] = (int)(b * k + c);
+            }
+        }
+    }
+
+    while (ok && work_count > 0) {
+        int item = work[--work_count];
+        size_t a = (size_t)item / k, c = (size_t)item % k;
+        pending[item] = false;
+
+        // Copy the splitter, as marking may reorder its own block
+        size_t size = end[a] - first[a];
+        memcpy(splitter, elements + first[a], sizeof(int) * size);
+
+        size_t touched_count = 0;
+        for (size_t i = 0; i < size; i++) {
+            int target = splitter[i];
+            for (size_t j = in_start[c * n + target]; j < in_start[c * n + target + 1]; j++) {
+                int s = in_source[j];
+                size_t b = (size_t)block_of[s];
+                size_t boundary = first[b] + marked[b];
+                if (location[s] < boundary) continue;   // Already marked
+
+                if (marked[b] == 0) touched[touched_count++] = (int)b;
+                int other = elements[boundary];
+                elements[location[s]] = other;
+                location[other] = location[s];
+                elements[boundary] = s;
+                location[s] = boundary;
+                marked[b]++;
+            }
+        }
+
+        for (size_t t = 0; t < touched_count; t++) {
+            size_t b = (size_t)touched[t];
+            size_t count = marked[b];
+            marked[b] = 0;
+            if (count == end[b] - first[b]) continue;
+
+            // The marked states become a new block
+            size_t nb = blocks++;
+            first[nb] = first[b];
+            end[nb] = first[b] + count;
+            first[b] = end[nb];
+            for (size_t i = first[nb]; i < end[nb]; i++) block_of[elements[i]] = (int)nb;
+
+            for (size_t cc = 0; cc < k; cc++) {
+                size_t smaller = (end[nb] - first[nb] <= end[b] - first[b]) ? nb : b;
+                size_t add = pending[b * k + cc] ? nb : smaller;
+                if (!pending[add * k + cc]) {
+                    pending[add * k + cc] = true;
+                    work[work_count++] = (int)(add * k + cc);
+                }
+            }
+        }
+    }
+
+    *block_count = blocks;
+    free(in_start);
+    free(in_source);
+    free(elements);
+    free(location);
+    free(first);
+    free(end);
+    free(marked);
+    free(touched);
+    free(splitter);
+    free(pending);
+    free(work);
+    return ok;
+}
+
+// Compiles every state pattern of the automaton into one minimal lexer
+// table. Earlier states win where patterns overlap; patterns the compiler
+// does not support never match. Returns NULL if out of memory.
+RiftLexTable* automaton_compile(RegexAutomaton* automaton) {
+    if (!automaton) return NULL;
+
+    Nfa nfa = {0};
+    RiftLexTable* table = calloc(1, sizeof(RiftLexTable));
+    int start = nfa_add(&nfa, NFA_EPSILON);
+    if (!table || start < 0) {
+        free(table);
+        nfa_destroy(&nfa);
+        return NULL;
+    }
+
+    // Joined by a chain of epsilon splits under the start state
+    int tail = start;
     for (size_t i = 0; i < automaton->state_count; i++) {
-        if (state_matches(automaton->states[i], input)) {
-            automaton->current_state = automaton->states[i];
-            return automaton->states[i];
+        int pattern_start = nfa_add_pattern(&nfa, automaton->states[i]->pattern, (int)i);
+        if (pattern_start < 0) continue;
+
+        int link = nfa_add(&nfa, NFA_EPSILON);
+        if (link < 0) {
+            free(table);
+            nfa_destroy(&nfa);
+            return NULL;
         }
+        nfa.states[tail].out = pattern_start;
+        nfa.states[tail].out2 = link;
+        tail = link;
     }
-    
-    return NULL;
+
+    table->class_count = compute_byte_classes(&nfa, table->byte_class);
+
+    Dfa dfa;
+    if (!build_dfa(&nfa, start, table->byte_class, table->class_count, &dfa)) {
+        free(table);
+        nfa_destroy(&nfa);
+        return NULL;
+    }
+    nfa_destroy(&nfa);
+
+    int* block_of = malloc(sizeof(int) * dfa.state_count);
+    int* renumber = malloc(sizeof(int) * dfa.state_count);
+    size_t block_count = 0;
+    if (!block_of || !renumber || !minimize_dfa(&dfa, block_of, &block_count)) {
+        free(block_of);
+        free(renumber);
+        free(dfa.next);
+        free(dfa.accept);
+        free(table);
+        return NULL;
+    }
+
+    // Number the minimal states: the dead state's block 0, the start's 1
+    for (size_t b = 0; b < block_count; b++) renumber[b] = -1;
+    int next_number = 0;
+    renumber[block_of[0]] = next_number++;
+    if (renumber[block_of[1]] < 0) renumber[block_of[1]] = next_number++;
+    for (size_t s = 0; s < dfa.state_count; s++) {
+        if (renumber[block_of[s]] < 0) renumber[block_of[s]] = next_number++;
+    }
+
+    // When no pattern can match, the start merges into the dead state; it
+    // keeps number 1 as a second dead state
+    bool start_dead = renumber[block_of[1]] == 0;
+    table->state_count = start_dead ? 2 : block_count;
+    table->next = calloc(table->state_count * table->class_count, sizeof(uint32_t));
+    table->accept = malloc(sizeof(int) * table->state_count);
+    if (!table->next || !table->accept) {
+        free(block_of);
+        free(renumber);
+        free(dfa.next);
+        free(dfa.accept);
+        rift_lex_table_destroy(table);
+        return NULL;
+    }
+
+    if (start_dead) {
+        table->accept[0] = table->accept[1] = -1;
+    } else {
+        for (size_t s = 0; s < dfa.state_count; s++) {
+            size_t m = (size_t)renumber[block_of[s]];
+            table->accept[m] = dfa.accept[s];
+            for (size_t c = 0; c < table->class_count; c++) {
+                table->next[m * table->class_count + c] = (uint32_t)renumber[block_of[dfa.next[s * dfa.class_count + c]]];
+            }
+        }
+    }
+
+    free(block_of);
+    free(renumber);
+    free(dfa.next);
+    free(dfa.accept);
+    return table;
+}
+
+// Longest token at the start of text: returns its length, 0 if none, and
+// stores the index of its automaton state in *token
+size_t rift_lex_table_match(const RiftLexTable* table, const char* text, size_t length, int* token) {
+    uint32_t state = 1;
+    size_t matched = 0;
+    *token = -1;
+
+    for (size_t i = 0; i < length; i++) {
+        state = table->next[state * table->class_count + table->byte_class[(unsigned char)text[i]]];
+        if (state == 0) break;
+        if (table->accept[state] >= 0) {
+            matched = i + 1;
+            *token = table->accept[state];
+        }
+    }
+    return matched;
+}
+
+// Code generation backend: writes the table out as a direct-coded C lexer,
+// one label per state and a switch on the next byte, as re2c does. The
+// generated function has rift_lex_table_match's contract, so it can be
+// compiled back into a program in place of the table:
+//
+//     ./rift_poc --emit-c rift_lexer.c
+//     cc -O2 -DRIFT_GENERATED_LEXER='"rift_lexer.c"' rift_poc.c -o rift_bench
+//     ./rift_bench --bench
+static void emit_c_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p >= ' ' && *p < 127) fputc(*p, out);
+        else fprintf(out, "\\%03o", (unsigned char)*p);
+    }
+    fputc('"', out);
+}
+
+// Emits name(text, length, token) for table, with name_patterns[] giving
+// the pattern of each token index. Returns false on a write error.
+bool rift_lex_table_emit_c(const RiftLexTable* table, const RegexAutomaton* automaton, const char* name, FILE* out) {
+    if (!table || !automaton || !name || !out) return false;
+
+    fprintf(out, "// Generated by rift_poc --emit-c: %zu states, %zu byte classes\n",
+            table->state_count, table->class_count);
+    fprintf(out, "#include <stddef.h>\n\n");
+    fprintf(out, "static const char* const %s_patterns[] = {\n", name);
+    for (size_t i = 0; i < automaton->state_count; i++) {
+        fprintf(out, "    ");
+        emit_c_string(out, automaton->states[i]->pattern);
+        fprintf(out, ",\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// Longest token at the start of text: its length, 0 if none, with its\n");
+    fprintf(out, "// index into %s_patterns in *token\n", name);
+    fprintf(out, "static size_t %s(const char* text, size_t length, int* token) {\n", name);
+    fprintf(out, "    const unsigned char* p = (const unsigned char*)text;\n");
+    fprintf(out, "    const unsigned char* end = p + length;\n");
+    fprintf(out, "    const unsigned char* last = p;\n");
+    fprintf(out, "    int matched = -1;\n\n");
+    fprintf(out, "    goto s1;\n");
+
+    // The dead state is the exit; every other state tests for the end of
+    // input, then branches on the byte, with its most common target as the
+    // default case
+    for (size_t s = 1; s < table->state_count; s++) {
+        const uint32_t* row = table->next + s * table->class_count;
+        fprintf(out, "s%zu:\n", s);
+        if (table->accept[s] >= 0) {
+            fprintf(out, "    last = p;\n");
+            fprintf(out, "    matched = %d;\n", table->accept[s]);
+        }
+        fprintf(out, "    if (p == end) goto done;\n");
+
+        // Distinct targets in byte order, with how many bytes lead to each
+        uint32_t targets[256];
+        size_t votes[256] = {0};
+        size_t distinct = 0, fallback = 0;
+        for (int c = 0; c < 256; c++) {
+            uint32_t target = row[table->byte_class[c]];
+            size_t t = 0;
+            while (t < distinct && targets[t] != target) t++;
+            if (t == distinct) targets[distinct++] = target;
+            if (++votes[t] > votes[fallback]) fallback = t;
+        }
+
+        fprintf(out, "    switch (*p++) {\n");
+        for (size_t t = 0; t < distinct; t++) {
+            if (t == fallback) continue;
+            int labels = 0;
+            for (int c = 0; c < 256; c++) {
+                if (row[table->byte_class[c]] != targets[t]) continue;
+                fprintf(out, labels % 8 == 0 ? "        case %d:" : " case %d:", c);
+                if (++labels % 8 == 0) fputc('\n', out);
+            }
+            if (labels % 8 != 0) fputc('\n', out);
+            if (targets[t] == 0) fprintf(out, "            goto done;\n");
+            else fprintf(out, "            goto s%u;\n", (unsigned)targets[t]);
+        }
+        if (targets[fallback] == 0) fprintf(out, "        default: goto done;\n");
+        else fprintf(out, "        default: goto s%u;\n", (unsigned)targets[fallback]);
+        fprintf(out, "    }\n");
+    }
+
+    fprintf(out, "done:\n");
+    fprintf(out, "    *token = matched;\n");
+    fprintf(out, "    return (size_t)(last - (const unsigned char*)text);\n");
+    fprintf(out, "}\n");
+
+    return !ferror(out);
 }
 
 // IR Generator functions
@@ -205,6 +1368,8 @@ IRGenerator* ir_generator_create(RegexAutomaton* automaton) {
     if (!generator) return NULL;
     
     generator->automaton = automaton;
+    generator->table = NULL;
+    generator->table_state_count = 0;
     generator->node_capacity = 10;
     generator->nodes = malloc(sizeof(TokenNode*) * generator->node_capacity);
     if (!generator->nodes) {
@@ -226,20 +1391,27 @@ void ir_generator_destroy(IRGenerator* generator) {
     }
     
     free(generator->nodes);
+    rift_lex_table_destroy(generator->table);
     free(generator);
 }
 
-TokenNode* ir_generator_process_token(IRGenerator* generator, const char* token) {
-    if (!generator || !token) return NULL;
-    
-    State* next_state = automaton_get_next_state(generator->automaton, token);
-    if (!next_state) return NULL;
-    
+// The lexer table for the automaton's current states, compiled on first use
+// and again after states are added; NULL if it cannot be built
+static RiftLexTable* ir_generator_table(IRGenerator* generator) {
+    if (!generator->table || generator->table_state_count != generator->automaton->state_count) {
+        rift_lex_table_destroy(generator->table);
+        generator->table = automaton_compile(generator->automaton);
+        generator->table_state_count = generator->automaton->state_count;
+    }
+    return generator->table;
+}
+
+static TokenNode* token_node_create(const char* type, const char* value, size_t length) {
     TokenNode* node = malloc(sizeof(TokenNode));
     if (!node) return NULL;
     
-    node->type = strdup(next_state->pattern);
-    node->value = strdup(token);
+    node->type = strdup(type);
+    node->value = strndup(value, length);
     
     if (!node->type || !node->value) {
         free(node->type);
@@ -251,6 +1423,69 @@ TokenNode* ir_generator_process_token(IRGenerator* generator, const char* token)
     return node;
 }
 
+// Classifies a whole token, through the lexer table when it builds and
+// the regex automaton otherwise
+TokenNode* ir_generator_process_token(IRGenerator* generator, const char* token) {
+    if (!generator || !token) return NULL;
+    
+    State* next_state = NULL;
+    RiftLexTable* table = ir_generator_table(generator);
+    if (table) {
+        size_t length = strlen(token);
+        int index;
+        if (length > 0 && rift_lex_table_match(table, token, length, &index) == length) {
+            next_state = generator->automaton->states[index];
+            generator->automaton->current_state = next_state;
+        }
+    } else {
+        next_state = automaton_get_next_state(generator->automaton, token);
+    }
+    if (!next_state) return NULL;
+    
+    return token_node_create(next_state->pattern, token, strlen(token));
+}
+
+// Splits input into longest-match tokens with the lexer table, appending
+// them to the generator's nodes. Bytes no pattern matches are skipped.
+// Returns the number of nodes added, or -1 if the table cannot be built
+// or memory runs out.
+long ir_generator_tokenize(IRGenerator* generator, const char* input) {
+    if (!generator || !input) return -1;
+    
+    RiftLexTable* table = ir_generator_table(generator);
+    if (!table) return -1;
+    
+    long added = 0;
+    size_t length = strlen(input);
+    size_t pos = 0;
+    while (pos < length) {
+        int index;
+        size_t matched = rift_lex_table_match(table, input + pos, length - pos, &index);
+        if (matched == 0) {
+            pos++;
+            continue;
+        }
+        
+        if (generator->node_count >= generator->node_capacity) {
+            size_t new_capacity = generator->node_capacity * 2;
+            TokenNode** new_nodes = realloc(generator->nodes, sizeof(TokenNode*) * new_capacity);
+            if (!new_nodes) return -1;
+            
+            generator->nodes = new_nodes;
+            generator->node_capacity = new_capacity;
+        }
+        
+        TokenNode* node = token_node_create(generator->automaton->states[index]->pattern, input + pos, matched);
+        if (!node) return -1;
+        
+        generator->nodes[generator->node_count++] = node;
+        pos += matched;
+        added++;
+    }
+    
+    return added;
+}
+
 // Example usage
 void create_simple_lexer(void) {
     RegexAutomaton* automaton = automaton_create();
@@ -290,11 +1525,221 @@ void create_simple_lexer(void) {
         }
     }
     
+    // Whole input through the compiled table
+    const char* source = "x1 + 123 * y";
+    long count = ir_generator_tokenize(generator, source);
+    if (count >= 0 && generator->table) {
+        printf("\nLexer table: %zu states, %zu byte classes\n",
+               generator->table->state_count, generator->table->class_count);
+        printf("Tokens of \"%s\":\n", source);
+        for (size_t i = 0; i < generator->node_count; i++) {
+            printf("Type: %s, Value: '%s'\n", generator->nodes[i]->type, generator->nodes[i]->value);
+        }
+    }
+    
     ir_generator_destroy(generator);
     automaton_destroy(automaton);
 }
 
-int main(void) {
+// Lexer benchmark: the same patterns through POSIX regexec, the table
+// matcher and, when compiled in, the generated direct-coded lexer. The
+// patterns stay within what regcomp accepts, so all three agree.
+static const char* const bench_patterns[] = {
+    "^[a-zA-Z_][a-zA-Z0-9_]*",
+    "^[0-9]+",
+    "^[-+*/=();]",
+    "^[[:space:]]+",
+};
+#define BENCH_PATTERN_COUNT (sizeof(bench_patterns) / sizeof(bench_patterns[0]))
+#define BENCH_REGEX_WINDOW 256
+
+static RegexAutomaton* create_bench_automaton(void) {
+    RegexAutomaton* automaton = automaton_create();
+    if (!automaton) return NULL;
+
+    for (size_t i = 0; i < BENCH_PATTERN_COUNT; i++) {
+        if (!automaton_add_state(automaton, bench_patterns[i], false)) {
+            automaton_destroy(automaton);
+            return NULL;
+        }
+    }
+    return automaton;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Tokens and a checksum of their kinds and lengths, so the matchers can
+// be checked against each other
+typedef struct LexRun {
+    size_t tokens;
+    uint64_t checksum;
+    double seconds;
+} LexRun;
+
+static void lex_run_add(LexRun* run, int token, size_t length) {
+    run->tokens++;
+    run->checksum = run->checksum * 31 + (uint64_t)token * 1000003 + length;
+}
+
+static LexRun bench_table(const RiftLexTable* table, const char* input, size_t length) {
+    LexRun run = {0, 0, 0.0};
+    double start = now_seconds();
+    for (size_t pos = 0; pos < length;) {
+        int token;
+        size_t matched = rift_lex_table_match(table, input + pos, length - pos, &token);
+        if (matched == 0) {
+            pos++;
+            continue;
+        }
+        lex_run_add(&run, token, matched);
+        pos += matched;
+    }
+    run.seconds = now_seconds() - start;
+    return run;
+}
+
+// One regexec of the combined patterns per token. REG_STARTEND bounds each
+// call to a window, or glibc would strlen the rest of the input every time.
+static LexRun bench_regexec(RegexAutomaton* automaton, const char* input, size_t length) {
+    LexRun run = {0, 0, 0.0};
+    if (automaton->combined_dirty) automaton_build_combined(automaton);
+    if (!automaton->combined_valid) return run;
+
+    regmatch_t matches[BENCH_PATTERN_COUNT * 4 + 1];
+    int group_token[BENCH_PATTERN_COUNT * 4 + 1];
+    size_t group_count = automaton->group_count;
+    if (group_count > sizeof(matches) / sizeof(matches[0])) return run;
+
+    // Token index of the state each group opens, or -1
+    for (size_t g = 0; g < group_count; g++) {
+        group_token[g] = -1;
+        for (size_t i = 0; i < automaton->state_count; i++) {
+            if (automaton->group_state[g] == automaton->states[i]) group_token[g] = (int)i;
+        }
+    }
+
+    double start = now_seconds();
+    for (size_t pos = 0; pos < length;) {
+        matches[0].rm_so = 0;
+        matches[0].rm_eo = (regoff_t)(length - pos < BENCH_REGEX_WINDOW ? length - pos : BENCH_REGEX_WINDOW);
+        if (regexec(&automaton->combined, input + pos, group_count, matches, REG_STARTEND) != 0 ||
+            matches[0].rm_eo == 0) {
+            pos++;
+            continue;
+        }
+
+        int token = -1;
+        for (size_t g = 1; g < group_count && token < 0; g++) {
+            if (matches[g].rm_so != -1) token = group_token[g];
+        }
+        lex_run_add(&run, token, (size_t)matches[0].rm_eo);
+        pos += (size_t)matches[0].rm_eo;
+    }
+    run.seconds = now_seconds() - start;
+    return run;
+}
+
+#ifdef RIFT_GENERATED_LEXER
+#include RIFT_GENERATED_LEXER
+
+static LexRun bench_generated(const char* input, size_t length) {
+    LexRun run = {0, 0, 0.0};
+    double start = now_seconds();
+    for (size_t pos = 0; pos < length;) {
+        int token;
+        size_t matched = rift_generated_lex(input + pos, length - pos, &token);
+        if (matched == 0) {
+            pos++;
+            continue;
+        }
+        lex_run_add(&run, token, matched);
+        pos += matched;
+    }
+    run.seconds = now_seconds() - start;
+    return run;
+}
+#endif
+
+static void print_lex_run(const char* name, LexRun run, size_t length, const LexRun* reference) {
+    printf("%-10s %8.2f MB/s %8.1f ns/token  %zu tokens%s\n", name,
+           length / run.seconds / 1e6, run.seconds * 1e9 / (run.tokens ? run.tokens : 1), run.tokens,
+           reference && (run.tokens != reference->tokens || run.checksum != reference->checksum)
+               ? "  MISMATCH" : "");
+}
+
+int run_lexer_benchmark(size_t megabytes) {
+    static const char snippet[] =
+        "total_sum = (count1 + 42) * rate / 7;\n"
+        "value_x = value_x - 1000 * (y + z2);\n";
+
+    size_t length = megabytes * 1024 * 1024;
+    char* input = malloc(length + 1);
+    RegexAutomaton* automaton = create_bench_automaton();
+    RiftLexTable* table = automaton ? automaton_compile(automaton) : NULL;
+    if (!input || !table) {
+        fprintf(stderr, "Failed to set up the lexer benchmark\n");
+        free(input);
+        rift_lex_table_destroy(table);
+        automaton_destroy(automaton);
+        return 1;
+    }
+
+    for (size_t i = 0; i < length; i++) input[i] = snippet[i % (sizeof(snippet) - 1)];
+    input[length] = '\0';
+
+    printf("Lexer benchmark: %zu MB, table of %zu states and %zu byte classes\n",
+           megabytes, table->state_count, table->class_count);
+    LexRun table_run = bench_table(table, input, length);
+    print_lex_run("table", table_run, length, NULL);
+#ifdef RIFT_GENERATED_LEXER
+    print_lex_run("generated", bench_generated(input, length), length, &table_run);
+#else
+    printf("generated  (build with -DRIFT_GENERATED_LEXER, see --emit-c)\n");
+#endif
+    print_lex_run("regexec", bench_regexec(automaton, input, length), length, &table_run);
+
+    free(input);
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+    return 0;
+}
+
+// Writes the benchmark patterns' lexer to path as rift_generated_lex
+int emit_bench_lexer(const char* path) {
+    RegexAutomaton* automaton = create_bench_automaton();
+    RiftLexTable* table = automaton ? automaton_compile(automaton) : NULL;
+    FILE* out = table ? fopen(path, "w") : NULL;
+    bool ok = out && rift_lex_table_emit_c(table, automaton, "rift_generated_lex", out);
+    if (out && fclose(out) != 0) ok = false;
+
+    if (!ok) fprintf(stderr, "Failed to write %s\n", path);
+    else printf("Wrote %s (%zu states, %zu byte classes)\n", path, table->state_count, table->class_count);
+
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+    return ok ? 0 : 1;
+}
+
+//   rift_poc                  Lexer demo
+//   rift_poc --bench [MB]     Lexer benchmark, 16 MB of input by default
+//   rift_poc --emit-c FILE    Write the benchmark lexer as direct-coded C
+//
+// The tests include this file and define RIFT_POC_NO_MAIN
+#ifndef RIFT_POC_NO_MAIN
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        long megabytes = argc >= 3 ? atol(argv[2]) : 16;
+        return run_lexer_benchmark(megabytes > 0 ? (size_t)megabytes : 16);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--emit-c") == 0) {
+        return emit_bench_lexer(argv[2]);
+    }
+    
     create_simple_lexer();
     return 0;
 }
+#endif
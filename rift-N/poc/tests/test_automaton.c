@@ -0,0 +1,153 @@
+// tests/test_automaton.c
+// Checks for the compiled automaton: patterns compile once, and the single
+// combined scan picks the same state a state-by-state search would
+
+#include "rift_poc.c"
+#include <assert.h>
+
+// The state-by-state search the combined regex replaces
+static State* first_match(RegexAutomaton* automaton, const char* input) {
+    for (size_t i = 0; i < automaton->state_count; i++) {
+        if (state_matches(automaton->states[i], input)) return automaton->states[i];
+    }
+    return NULL;
+}
+
+static void test_state_create(void) {
+    printf("Testing state create...\n");
+
+    State* state = state_create("^(a|b)[0-9]+$", true);
+    assert(state != NULL && state->compiled && state->is_final);
+    assert(state->group_count == 1);
+    assert(state_matches(state, "a12") && state_matches(state, "b0"));
+    assert(!state_matches(state, "c1") && !state_matches(state, "a"));
+    assert(!state_matches(NULL, "a1") && !state_matches(state, NULL));
+
+    // Groups inside brackets or escaped are not counted
+    State* literal = state_create("^[(]\\(([a-z]+)[[:digit:])]$", false);
+    assert(literal->compiled && literal->group_count == 1);
+    assert(state_matches(literal, "((ab)"));
+
+    // A pattern that does not compile never matches
+    State* broken = state_create("^(ab$", false);
+    assert(broken != NULL && !broken->compiled);
+    assert(!state_matches(broken, "ab") && !state_matches(broken, "(ab"));
+    assert(state->id != literal->id && literal->id != broken->id);
+
+    state_destroy(state);
+    state_destroy(literal);
+    state_destroy(broken);
+    state_destroy(NULL);
+    printf("State create test passed\n");
+}
+
+static void test_combined_match(void) {
+    printf("Testing combined match...\n");
+
+    // Overlapping whole-token patterns, some with groups of their own, and
+    // one that does not compile
+    const char* patterns[] = {
+        "^(ab)+$", "^[a-z]+$", "^a(b|c)d$", "^(", "^[0-9]+$",
+        "^[a-z_][a-z0-9_]*$", "^((a|b)(c|d))*x$", "^[-+*/=]$", "^.+$"
+    };
+    RegexAutomaton* automaton = automaton_create();
+    assert(automaton != NULL);
+    assert(automaton_match(automaton, "ab") == NULL);
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        assert(automaton_add_state(automaton, patterns[i], false) != NULL);
+    }
+    assert(!automaton->states[3]->compiled);
+
+    const char* inputs[] = {
+        "ab", "abab", "aba", "abd", "acd", "x", "acbdx", "acbd", "42", "a1",
+        "_tmp", "+", "==", "", "A", "(", "abc_9", "9a"
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        assert(automaton_match(automaton, inputs[i]) == first_match(automaton, inputs[i]));
+    }
+
+    // Random strings over a small alphabet hit the overlaps harder
+    const char alphabet[] = "abcdx0+_";
+    uint32_t seed = 12345;
+    char input[9];
+    int matched = 0;
+    for (int k = 0; k < 20000; k++) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t length = (seed >> 24) % 9;
+        for (size_t j = 0; j < length; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            input[j] = alphabet[(seed >> 24) % (sizeof(alphabet) - 1)];
+        }
+        input[length] = '\0';
+        State* state = automaton_match(automaton, input);
+        assert(state == first_match(automaton, input));
+        matched += state != NULL && state != automaton->states[8];
+    }
+    assert(matched > 0);
+
+    assert(automaton_match(automaton, NULL) == NULL);
+    assert(automaton_match(NULL, "ab") == NULL);
+    automaton_destroy(automaton);
+    printf("Combined match test passed\n");
+}
+
+static void test_rebuild(void) {
+    printf("Testing rebuild...\n");
+
+    // More groups than the stack match array holds
+    RegexAutomaton* automaton = automaton_create();
+    char pattern[64];
+    for (int i = 0; i < 12; i++) {
+        snprintf(pattern, sizeof(pattern), "^((k)(%d))$", i);
+        assert(automaton_add_state(automaton, pattern, false) != NULL);
+    }
+    assert(automaton_match(automaton, "k11") == automaton->states[11]);
+    assert(automaton->group_count > 32);
+    assert(automaton_match(automaton, "k12") == NULL);
+
+    // A state added after a match takes part in the next one
+    State* added = automaton_add_state(automaton, "^k[0-9]+$", true);
+    assert(automaton->combined_dirty);
+    assert(automaton_match(automaton, "k12") == added);
+    assert(!automaton->combined_dirty);
+    assert(automaton_match(automaton, "k3") == automaton->states[3]);
+    automaton_destroy(automaton);
+
+    // Only broken patterns: nothing matches
+    automaton = automaton_create();
+    automaton_add_state(automaton, "^[a", false);
+    assert(automaton_match(automaton, "a") == NULL);
+    assert(!automaton->combined_valid);
+    automaton_destroy(automaton);
+    printf("Rebuild test passed\n");
+}
+
+static void test_next_state(void) {
+    printf("Testing next state...\n");
+
+    RegexAutomaton* automaton = automaton_create();
+    assert(automaton_get_next_state(automaton, "a") == NULL);
+    State* word = automaton_add_state(automaton, "^[a-z]+$", false);
+    State* number = automaton_add_state(automaton, "^[0-9]+$", true);
+    assert(automaton->initial_state == word && automaton->current_state == word);
+
+    // A match moves the automaton on; no match leaves it where it was
+    assert(automaton_get_next_state(automaton, "12") == number);
+    assert(automaton->current_state == number);
+    assert(automaton_get_next_state(automaton, "?") == NULL);
+    assert(automaton->current_state == number);
+    assert(automaton_get_next_state(automaton, "abc") == word);
+    assert(automaton->current_state == word);
+    assert(automaton->initial_state == word);
+    automaton_destroy(automaton);
+    printf("Next state test passed\n");
+}
+
+int main(void) {
+    test_state_create();
+    test_combined_match();
+    test_rebuild();
+    test_next_state();
+    printf("All automaton tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+// tests/test_emit_c.c
+// Checks for the C backend: the lexer rift_poc --emit-c writes for the
+// benchmark patterns, compiled in through RIFT_GENERATED_LEXER, agrees
+// with the table it came from on every input
+
+#include "rift_poc.c"
+#include <assert.h>
+#include <unistd.h>
+
+#ifndef RIFT_GENERATED_LEXER
+#error "build with -DRIFT_GENERATED_LEXER naming the output of rift_poc --emit-c"
+#endif
+
+static void test_generated_lexer(void) {
+    printf("Testing generated lexer...\n");
+
+    RegexAutomaton* automaton = create_bench_automaton();
+    RiftLexTable* table = automaton_compile(automaton);
+    assert(table != NULL);
+    assert(sizeof(rift_generated_lex_patterns) / sizeof(rift_generated_lex_patterns[0]) == BENCH_PATTERN_COUNT);
+    for (size_t i = 0; i < BENCH_PATTERN_COUNT; i++) {
+        assert(strcmp(rift_generated_lex_patterns[i], bench_patterns[i]) == 0);
+    }
+
+    // Source-like text, plus bytes no pattern takes: NUL, high bytes and
+    // punctuation; every suffix and length of each input is tried
+    const char alphabet[] = "ab_Z09 \t\n+-*/=();.#\0\x80\xff";
+    uint32_t seed = 77;
+    int tokens = 0;
+    for (int k = 0; k < 2000; k++) {
+        char text[24];
+        size_t length = 0;
+        while (length < sizeof(text)) {
+            seed = seed * 1664525u + 1013904223u;
+            text[length++] = alphabet[(seed >> 8) % (sizeof(alphabet) - 1)];
+        }
+        for (size_t pos = 0; pos < length; pos++) {
+            for (size_t end = pos; end <= length; end++) {
+                int expected_token = 0, token = 0;
+                size_t expected = rift_lex_table_match(table, text + pos, end - pos, &expected_token);
+                assert(rift_generated_lex(text + pos, end - pos, &token) == expected);
+                assert(token == expected_token);
+                tokens += expected > 0;
+            }
+        }
+    }
+    assert(tokens > 0);
+
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+    printf("Generated lexer test passed\n");
+}
+
+static void test_emit_errors(void) {
+    printf("Testing emit errors...\n");
+
+    RegexAutomaton* automaton = create_bench_automaton();
+    RiftLexTable* table = automaton_compile(automaton);
+    assert(!rift_lex_table_emit_c(NULL, automaton, "lex", stdout));
+    assert(!rift_lex_table_emit_c(table, automaton, NULL, stdout));
+
+    // Writes that fail are reported
+    FILE* full = fopen("/dev/full", "w");
+    if (full) {
+        setvbuf(full, NULL, _IONBF, 0);
+        assert(!rift_lex_table_emit_c(table, automaton, "lex", full));
+        fclose(full);
+    }
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+    printf("Emit errors test passed\n");
+}
+
+static void test_benchmark(void) {
+    printf("Testing benchmark...\n");
+
+    // All three matchers run and none disagrees with the table
+    FILE* report = tmpfile();
+    assert(report != NULL);
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    assert(saved >= 0);
+    dup2(fileno(report), STDOUT_FILENO);
+    int status = run_lexer_benchmark(1);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    assert(status == 0);
+
+    rewind(report);
+    char line[256];
+    int runs = 0;
+    while (fgets(line, sizeof(line), report)) {
+        assert(strstr(line, "MISMATCH") == NULL);
+        runs += strstr(line, "MB/s") != NULL;
+    }
+    assert(runs == 3);
+    fclose(report);
+    printf("Benchmark test passed\n");
+}
+
+int main(void) {
+    test_generated_lexer();
+    test_emit_errors();
+    test_benchmark();
+    printf("All emit C tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,289 @@
+// tests/test_lex_table.c
+// Checks for the lexer table compiler: random patterns lex exactly as
+// glibc regexec would, Hopcroft minimisation agrees with a naive Moore
+// refinement, and the escapes regcomp lacks are understood
+
+#include "rift_poc.c"
+#include <assert.h>
+
+#define RANDOM_ROUNDS 300
+#define RANDOM_INPUTS 60
+
+static uint32_t seed = 2024;
+
+static uint32_t next_random(uint32_t bound) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) % bound;
+}
+
+// Appends a random ERE over {a,b,c} that both regcomp and the table
+// compiler accept
+static void random_pattern(char* out, size_t* length, int depth) {
+    int terms = 1 + (int)next_random(3);
+    for (int t = 0; t < terms; t++) {
+        static const char* const atoms[] = { "a", "b", "c", ".", "[ab]", "[^a]", "[a-b]" };
+        if (depth < 2 && next_random(4) == 0) {
+            out[(*length)++] = '(';
+            random_pattern(out, length, depth + 1);
+            if (next_random(2)) {
+                out[(*length)++] = '|';
+                random_pattern(out, length, depth + 1);
+            }
+            out[(*length)++] = ')';
+        } else {
+            const char* atom = atoms[next_random(sizeof(atoms) / sizeof(atoms[0]))];
+            memcpy(out + *length, atom, strlen(atom));
+            *length += strlen(atom);
+        }
+        static const char* const repeats[] = { "", "", "", "*", "+", "?", "{2}", "{1,3}", "{0,2}" };
+        const char* repeat = repeats[next_random(sizeof(repeats) / sizeof(repeats[0]))];
+        memcpy(out + *length, repeat, strlen(repeat));
+        *length += strlen(repeat);
+    }
+    out[*length] = '\0';
+}
+
+// Longest prefix of text some pattern matches whole, the earliest pattern
+// winning ties, found by trying every prefix with regexec
+static size_t regexec_match(regex_t* whole, size_t count, const char* text, size_t length, int* token) {
+    char prefix[32];
+    for (size_t n = length; n > 0; n--) {
+        memcpy(prefix, text, n);
+        prefix[n] = '\0';
+        for (size_t i = 0; i < count; i++) {
+            if (regexec(&whole[i], prefix, 0, NULL, 0) == 0) {
+                *token = (int)i;
+                return n;
+            }
+        }
+    }
+    *token = -1;
+    return 0;
+}
+
+static void test_against_regexec(void) {
+    printf("Testing against regexec...\n");
+
+    int tokens = 0;
+    for (int round = 0; round < RANDOM_ROUNDS; round++) {
+        RegexAutomaton* automaton = automaton_create();
+        size_t count = 1 + next_random(4);
+        regex_t whole[4];
+        for (size_t i = 0; i < count; i++) {
+            char pattern[256], anchored[272];
+            size_t length = 0;
+            random_pattern(pattern, &length, 0);
+            snprintf(anchored, sizeof(anchored), "^(%s)$", pattern);
+            assert(regcomp(&whole[i], anchored, REG_EXTENDED) == 0);
+            // Anchors are implied, so half the states leave them off
+            assert(automaton_add_state(automaton, next_random(2) ? anchored : pattern, false) != NULL);
+        }
+
+        RiftLexTable* table = automaton_compile(automaton);
+        assert(table != NULL);
+        assert(table->accept[0] == -1);
+        for (size_t c = 0; c < table->class_count; c++) assert(table->next[c] == 0);
+
+        for (int k = 0; k < RANDOM_INPUTS; k++) {
+            char text[16];
+            size_t length = next_random(sizeof(text));
+            for (size_t j = 0; j < length; j++) text[j] = "abcd"[next_random(4)];
+            int expected_token, token;
+            size_t expected = regexec_match(whole, count, text, length, &expected_token);
+            assert(rift_lex_table_match(table, text, length, &token) == expected);
+            assert(token == expected_token);
+            tokens += expected > 0;
+        }
+
+        for (size_t i = 0; i < count; i++) regfree(&whole[i]);
+        rift_lex_table_destroy(table);
+        automaton_destroy(automaton);
+    }
+    assert(tokens > RANDOM_ROUNDS * RANDOM_INPUTS / 4);
+
+    printf("Against regexec test passed\n");
+}
+
+// Moore's refinement, the slow way: split blocks by the blocks their
+// successors fall in until nothing changes
+static size_t moore_block_count(const Dfa* dfa) {
+    size_t n = dfa->state_count, k = dfa->class_count;
+    int* block = malloc(sizeof(int) * n);
+    int* refined = malloc(sizeof(int) * n);
+    assert(block != NULL && refined != NULL);
+    for (size_t s = 0; s < n; s++) block[s] = dfa->accept[s] + 1;
+
+    size_t blocks = 0;
+    for (;;) {
+        size_t count = 0;
+        for (size_t s = 0; s < n; s++) {
+            refined[s] = -1;
+            for (size_t t = 0; t < s && refined[s] < 0; t++) {
+                bool same = block[t] == block[s];
+                for (size_t c = 0; c < k && same; c++) {
+                    same = block[dfa->next[t * k + c]] == block[dfa->next[s * k + c]];
+                }
+                if (same) refined[s] = refined[t];
+            }
+            if (refined[s] < 0) refined[s] = (int)count++;
+        }
+        memcpy(block, refined, sizeof(int) * n);
+        if (count == blocks) break;
+        blocks = count;
+    }
+    free(block);
+    free(refined);
+    return blocks;
+}
+
+static void test_minimization(void) {
+    printf("Testing minimization...\n");
+
+    int reduced = 0;
+    for (int round = 0; round < RANDOM_ROUNDS; round++) {
+        Nfa nfa = {0};
+        int start = nfa_add(&nfa, NFA_EPSILON);
+        int tail = start;
+        size_t count = 1 + next_random(4);
+        for (size_t i = 0; i < count; i++) {
+            char pattern[256];
+            size_t length = 0;
+            random_pattern(pattern, &length, 0);
+            int pattern_start = nfa_add_pattern(&nfa, pattern, (int)i);
+            assert(pattern_start >= 0);
+            int link = nfa_add(&nfa, NFA_EPSILON);
+            nfa.states[tail].out = pattern_start;
+            nfa.states[tail].out2 = link;
+            tail = link;
+        }
+
+        uint8_t byte_class[256];
+        size_t class_count = compute_byte_classes(&nfa, byte_class);
+        Dfa dfa;
+        assert(build_dfa(&nfa, start, byte_class, class_count, &dfa));
+        int* block_of = malloc(sizeof(int) * dfa.state_count);
+        size_t block_count;
+        assert(minimize_dfa(&dfa, block_of, &block_count));
+        assert(block_count == moore_block_count(&dfa));
+        reduced += block_count < dfa.state_count;
+
+        // States in one block agree on their token and their successors'
+        // blocks
+        for (size_t s = 0; s < dfa.state_count; s++) {
+            for (size_t t = s + 1; t < dfa.state_count; t++) {
+                if (block_of[s] != block_of[t]) continue;
+                assert(dfa.accept[s] == dfa.accept[t]);
+                for (size_t c = 0; c < class_count; c++) {
+                    assert(block_of[dfa.next[s * class_count + c]] == block_of[dfa.next[t * class_count + c]]);
+                }
+            }
+        }
+
+        free(block_of);
+        free(dfa.next);
+        free(dfa.accept);
+        nfa_destroy(&nfa);
+    }
+    assert(reduced > 0);
+
+    printf("Minimization test passed\n");
+}
+
+static void test_escapes(void) {
+    printf("Testing escapes...\n");
+
+    // The demo's patterns: \w \d \s, and '\' escaping inside brackets
+    RegexAutomaton* automaton = automaton_create();
+    automaton_add_state(automaton, "^[a-zA-Z_]\\w*$", false);
+    automaton_add_state(automaton, "^\\d+$", false);
+    automaton_add_state(automaton, "^[+\\-*/]$", false);
+    automaton_add_state(automaton, "^\\s+$", false);
+    automaton_add_state(automaton, "^\\D\\W\\S$", false);
+    automaton_add_state(automaton, "^\\.\\$$", false);
+    RiftLexTable* table = automaton_compile(automaton);
+    assert(table != NULL);
+
+    struct { const char* text; size_t length; int token; } cases[] = {
+        { "x1_y", 4, 0 }, { "_", 1, 0 }, { "1x", 1, 1 }, { "0123", 4, 1 },
+        { "-", 1, 2 }, { "\\", 0, -1 }, { "/", 1, 2 }, { " \t\n", 3, 3 },
+        { "a- ", 1, 0 }, { "%-a", 3, 4 }, { "%% ", 0, -1 }, { "%a%", 0, -1 },
+        { ".$", 2, 5 }, { ".$ ", 2, 5 }, { "a$b", 3, 4 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int token;
+        assert(rift_lex_table_match(table, cases[i].text, strlen(cases[i].text), &token) == cases[i].length);
+        assert(token == cases[i].token);
+    }
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+
+    // Mid-pattern anchors, backreferences and broken patterns never
+    // match; with no usable pattern the start is a dead state
+    automaton = automaton_create();
+    automaton_add_state(automaton, "^a$b$", false);
+    automaton_add_state(automaton, "^(x)\\1$", false);
+    automaton_add_state(automaton, "^a(b$", false);
+    table = automaton_compile(automaton);
+    assert(table != NULL && table->state_count == 2);
+    int token;
+    assert(rift_lex_table_match(table, "ab", 2, &token) == 0 && token == -1);
+    assert(rift_lex_table_match(table, "xx", 2, &token) == 0 && token == -1);
+    rift_lex_table_destroy(table);
+    automaton_destroy(automaton);
+
+    printf("Escapes test passed\n");
+}
+
+static void test_tokenize(void) {
+    printf("Testing tokenize...\n");
+
+    RegexAutomaton* automaton = automaton_create();
+    automaton_add_state(automaton, "^[a-zA-Z_]\\w*$", false);
+    automaton_add_state(automaton, "^\\d+$", false);
+    automaton_add_state(automaton, "^[+\\-*/]$", false);
+    IRGenerator* generator = ir_generator_create(automaton);
+    assert(generator != NULL);
+
+    // Longest matches; the spaces match no pattern and are skipped
+    const char* expected[][2] = {
+        { "x1", "^[a-zA-Z_]\\w*$" }, { "+", "^[+\\-*/]$" }, { "123", "^\\d+$" },
+        { "*", "^[+\\-*/]$" }, { "y", "^[a-zA-Z_]\\w*$" },
+    };
+    assert(ir_generator_tokenize(generator, "x1 + 123 * y") == 5);
+    assert(generator->node_count == 5);
+    for (size_t i = 0; i < 5; i++) {
+        assert(strcmp(generator->nodes[i]->value, expected[i][0]) == 0);
+        assert(strcmp(generator->nodes[i]->type, expected[i][1]) == 0);
+    }
+    size_t states = generator->table->state_count;
+
+    // A whole token classifies through the table; a partial one does not
+    TokenNode* node = ir_generator_process_token(generator, "42");
+    assert(node != NULL && strcmp(node->type, "^\\d+$") == 0);
+    assert(automaton->current_state == automaton->states[1]);
+    free(node->type);
+    free(node->value);
+    free(node);
+    assert(ir_generator_process_token(generator, "42+") == NULL);
+    assert(ir_generator_process_token(generator, "") == NULL);
+
+    // Adding a state recompiles the table before the next token
+    automaton_add_state(automaton, "^\\s+$", false);
+    assert(ir_generator_tokenize(generator, "a b") == 3);
+    assert(generator->table->state_count > states);
+    assert(strcmp(generator->nodes[6]->type, "^\\s+$") == 0);
+    assert(ir_generator_tokenize(NULL, "a") == -1 && ir_generator_tokenize(generator, NULL) == -1);
+
+    ir_generator_destroy(generator);
+    automaton_destroy(automaton);
+    printf("Tokenize test passed\n");
+}
+
+int main(void) {
+    test_against_regexec();
+    test_minimization();
+    test_escapes();
+    test_tokenize();
+    printf("All lex table tests passed!\n");
+    return 0;
+}
@@ -7,6 +7,8 @@
 // State structure for the regex automaton
 typedef struct State {
     char *pattern;
+    regex_t regex;  // Compiled once, in state_create
+    bool compiled;  // false if pattern failed to compile
     bool is_final;
     size_t id;
 } State;
@@ -26,6 +28,7 @@ state_create(const char *pattern, bool is_final)
         return NULL;
 
     state->pattern = strdup(pattern);
+    state->compiled = (regcomp(&state->regex, pattern, REG_EXTENDED) == 0);
     state->is_final = is_final;
 
     // Simple ID generation
@@ -35,26 +38,28 @@ state_create(const char *pattern, bool is_final)
     return state;
 }
 
+// Release a state and its compiled pattern
+void
+state_destroy(State *state)
+{
+    if (!state)
+        return;
+
+    if (state->compiled)
+        regfree(&state->regex);
+    free(state->pattern);
+    free(state);
+}
+
 // Check if text matches a state's regex pattern
 bool
 state_matches(State *state, const char *text)
 {
-    if (!state || !text)
+    if (!state || !text || !state->compiled)
         return false;
 
-    regex_t regex;
-    int result;
-
-    // Compile the regex pattern
-    result = regcomp(&regex, state->pattern, REG_EXTENDED);
-    if (result)
-        return false;
-
-    // Execute the regex match
-    result = regexec(&regex, text, 0, NULL, 0);
-    regfree(&regex);
-
-    return (result == 0);
+    // Execute the precompiled regex
+    return regexec(&state->regex, text, 0, NULL, 0) == 0;
 }
 
 // Demo of LibRift's language processing capabilities
@@ -94,12 +99,9 @@ demonstrate_librift_tokenization()
     }
 
     // Clean up
-    free(identifier->pattern);
-    free(identifier);
-    free(number->pattern);
-    free(number);
-    free(operator->pattern);
-    free(operator);
+    state_destroy(identifier);
+    state_destroy(number);
+    state_destroy(operator);
 }
 
 int
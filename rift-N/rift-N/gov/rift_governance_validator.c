@@ -9,6 +9,8 @@
  * Implements semverx_lock enforcement and stakeholder authorization
  */
 
+#define _XOPEN_SOURCE 700   // strptime, open_memstream, st_mtim
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,7 +18,9 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <errno.h>
-#include <cjson/cJSON.h>
+#include <ctype.h>
+#include <strings.h>
+#include <pthread.h>
 #include <openssl/sha.h>
 
 // AEGIS Governance Constants
@@ -25,6 +29,8 @@
 #define MAX_SUBSTAGES_PER_STAGE 4
 #define GOVERNANCE_EXPIRY_DAYS 90
 #define SHA256_DIGEST_LENGTH 32
+#define JSON_MAX_DEPTH 64
+#define GOVERNANCE_CACHE_MAGIC "RIFTGOV1"
 
 // Stage Type Enumeration
 typedef enum {
@@ -75,12 +81,36 @@ typedef struct {
     int semantic_equivalence_proof;
 } stage5_optimizer_t;
 
+// Parsed governance file, keyed by path, modification time, size and
+// SHA-256 of its contents
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    long long mtime_sec;
+    long mtime_nsec;
+    long long size;
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    validation_result_t parse_result;
+    governance_config_t config;
+} governance_cache_entry_t;
+
+// Parse cache shared by the stage workers, persisted between runs
+typedef struct {
+    governance_cache_entry_t *entries;
+    size_t count;
+    size_t capacity;
+    int dirty;
+    pthread_mutex_t lock;
+    char cache_path[MAX_PATH_LENGTH];
+} governance_cache_t;
+
 // Validation Context Structure
 typedef struct {
     char project_root[MAX_PATH_LENGTH];
     int verbose_mode;
     int strict_mode;
+    int worker_threads;         // Stage validation threads; 0 selects online CPUs
     FILE *validation_log;
+    governance_cache_t *cache;  // NULL disables caching
     governance_config_t stage_configs[MAX_STAGE_COUNT];
     int validated_stages;
 } validation_context_t;
@@ -114,6 +144,404 @@ validation_result_t rift_validation_init(validation_context_t *ctx, const char *
     return VALIDATION_SUCCESS;
 }
 
+// Minimal JSON reader: walks the top-level object once, decoding only the
+// governance keys and skipping every other value without building a tree
+typedef struct {
+    const char *p;
+    const char *end;
+} json_cursor_t;
+
+static void json_skip_whitespace(json_cursor_t *c) {
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+static void json_put_utf8(char *out, size_t out_size, size_t *n, unsigned long code) {
+    char bytes[4];
+    size_t count;
+    if (code < 0x80) {
+        bytes[0] = (char)code;
+        count = 1;
+    } else if (code < 0x800) {
+        bytes[0] = (char)(0xC0 | (code >> 6));
+        bytes[1] = (char)(0x80 | (code & 0x3F));
+        count = 2;
+    } else if (code < 0x10000) {
+        bytes[0] = (char)(0xE0 | (code >> 12));
+        bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (code & 0x3F));
+        count = 3;
+    } else {
+        bytes[0] = (char)(0xF0 | (code >> 18));
+        bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+        bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+        bytes[3] = (char)(0x80 | (code & 0x3F));
+        count = 4;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (out && *n + 1 < out_size) {
+            out[*n] = bytes[i];
+        }
+        (*n)++;
+    }
+}
+
+static int json_read_hex4(json_cursor_t *c, unsigned long *code) {
+    if (c->end - c->p < 4) {
+        return 0;
+    }
+    *code = 0;
+    for (int i = 0; i < 4; i++) {
+        char h = *c->p++;
+        *code <<= 4;
+        if (h >= '0' && h <= '9') *code |= (unsigned long)(h - '0');
+        else if (h >= 'a' && h <= 'f') *code |= (unsigned long)(h - 'a' + 10);
+        else if (h >= 'A' && h <= 'F') *code |= (unsigned long)(h - 'A' + 10);
+        else return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Read a JSON string at the cursor, decoding escapes
+ * @param c Cursor positioned on the opening quote
+ * @param out Output buffer, truncated to out_size - 1 bytes; NULL to skip
+ * @param out_size Size of out
+ * @param length Receives the full decoded length; may be NULL
+ * @return int 1 on success, 0 on malformed input
+ */
+static int json_read_string(json_cursor_t *c, char *out, size_t out_size, size_t *length) {
+    size_t n = 0;
+    if (c->p >= c->end || *c->p != '"') {
+        return 0;
+    }
+    c->p++;
+
+    while (c->p < c->end && *c->p != '"') {
+        unsigned char ch = (unsigned char)*c->p++;
+        if (ch < 0x20) {
+            return 0;
+        }
+        if (ch != '\\') {
+            if (out && n + 1 < out_size) {
+                out[n] = (char)ch;
+            }
+            n++;
+            continue;
+        }
+
+        if (c->p >= c->end) {
+            return 0;
+        }
+        char escape = *c->p++;
+        unsigned long code;
+        switch (escape) {
+            case '"': code = '"'; break;
+            case '\\': code = '\\'; break;
+            case '/': code = '/'; break;
+            case 'b': code = '\b'; break;
+            case 'f': code = '\f'; break;
+            case 'n': code = '\n'; break;
+            case 'r': code = '\r'; break;
+            case 't': code = '\t'; break;
+            case 'u':
+                if (!json_read_hex4(c, &code)) {
+                    return 0;
+                }
+                // Surrogate pair
+                if (code >= 0xD800 && code < 0xDC00 && c->end - c->p >= 6 && c->p[0] == '\\' && c->p[1] == 'u') {
+                    unsigned long low;
+                    c->p += 2;
+                    if (!json_read_hex4(c, &low) || low < 0xDC00 || low > 0xDFFF) {
+                        return 0;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                break;
+            default:
+                return 0;
+        }
+        json_put_utf8(out, out_size, &n, code);
+    }
+
+    if (c->p >= c->end) {
+        return 0;
+    }
+    c->p++;
+    if (out && out_size > 0) {
+        out[n < out_size ? n : out_size - 1] = '\0';
+    }
+    if (length) {
+        *length = n;
+    }
+    return 1;
+}
+
+static int json_skip_value(json_cursor_t *c, int depth);
+
+static int json_skip_container(json_cursor_t *c, int depth, char close) {
+    if (depth >= JSON_MAX_DEPTH) {
+        return 0;
+    }
+    c->p++;
+    json_skip_whitespace(c);
+    if (c->p < c->end && *c->p == close) {
+        c->p++;
+        return 1;
+    }
+
+    for (;;) {
+        if (close == '}') {
+            if (!json_read_string(c, NULL, 0, NULL)) {
+                return 0;
+            }
+            json_skip_whitespace(c);
+            if (c->p >= c->end || *c->p++ != ':') {
+                return 0;
+            }
+        }
+        if (!json_skip_value(c, depth + 1)) {
+            return 0;
+        }
+        json_skip_whitespace(c);
+        if (c->p >= c->end) {
+            return 0;
+        }
+        char next = *c->p++;
+        if (next == close) {
+            return 1;
+        }
+        if (next != ',') {
+            return 0;
+        }
+        json_skip_whitespace(c);
+    }
+}
+
+/**
+ * @brief Skip any JSON value at the cursor, checking its structure
+ * @param c Cursor, advanced past the value
+ * @param depth Current nesting depth
+ * @return int 1 on success, 0 on malformed input
+ */
+static int json_skip_value(json_cursor_t *c, int depth) {
+    json_skip_whitespace(c);
+    if (c->p >= c->end) {
+        return 0;
+    }
+
+    switch (*c->p) {
+        case '"':
+            return json_read_string(c, NULL, 0, NULL);
+        case '{':
+            return json_skip_container(c, depth, '}');
+        case '[':
+            return json_skip_container(c, depth, ']');
+        case 't':
+            if (c->end - c->p >= 4 && memcmp(c->p, "true", 4) == 0) { c->p += 4; return 1; }
+            return 0;
+        case 'f':
+            if (c->end - c->p >= 5 && memcmp(c->p, "false", 5) == 0) { c->p += 5; return 1; }
+            return 0;
+        case 'n':
+            if (c->end - c->p >= 4 && memcmp(c->p, "null", 4) == 0) { c->p += 4; return 1; }
+            return 0;
+        default: {
+            const char *start = c->p;
+            while (c->p < c->end && (isdigit((unsigned char)*c->p) || *c->p == '-' || *c->p == '+' ||
+                                     *c->p == '.' || *c->p == 'e' || *c->p == 'E')) {
+                c->p++;
+            }
+            return c->p > start;
+        }
+    }
+}
+
+// Governance keys, matched case-insensitively as cJSON_GetObjectItem did;
+// the first occurrence of each wins
+enum {
+    GOV_KEY_PACKAGE_NAME,
+    GOV_KEY_VERSION,
+    GOV_KEY_TIMESTAMP,
+    GOV_KEY_STAGE,
+    GOV_KEY_STAGE_TYPE,
+    GOV_KEY_SEMVERX_LOCK,
+    GOV_KEY_ENTRY_POINT,
+    GOV_KEY_NLINK_ENABLED,
+    GOV_KEY_COUNT
+};
+
+static const char *const governance_keys[GOV_KEY_COUNT] = {
+    "package_name", "version", "timestamp", "stage",
+    "stage_type", "semverx_lock", "entry_point", "nlink_enabled"
+};
+
+/**
+ * @brief Extract the governance fields from JSON text
+ * @param json Governance file contents
+ * @param length Length of json in bytes
+ * @param config Output governance configuration
+ * @return validation_result_t Parsing result
+ */
+validation_result_t parse_governance_json(const char *json, size_t length, governance_config_t *config) {
+    json_cursor_t c = {json, json + length};
+    int found[GOV_KEY_COUNT] = {0};
+    int required_strings = 1;
+    char stage_type[32] = "";
+
+    memset(config, 0, sizeof(*config));
+    config->stage_type = STAGE_TYPE_EXPERIMENTAL;
+
+    json_skip_whitespace(&c);
+    if (c.p >= c.end || *c.p != '{') {
+        return VALIDATION_SCHEMA_VIOLATION;
+    }
+    c.p++;
+    json_skip_whitespace(&c);
+    if (c.p < c.end && *c.p == '}') {
+        return VALIDATION_SCHEMA_VIOLATION;         // No required fields
+    }
+
+    for (;;) {
+        char key[32];
+        size_t key_length;
+        if (!json_read_string(&c, key, sizeof(key), &key_length)) {
+            return VALIDATION_SCHEMA_VIOLATION;
+        }
+        json_skip_whitespace(&c);
+        if (c.p >= c.end || *c.p++ != ':') {
+            return VALIDATION_SCHEMA_VIOLATION;
+        }
+        json_skip_whitespace(&c);
+
+        int k = GOV_KEY_COUNT;
+        if (key_length < sizeof(key)) {
+            for (k = 0; k < GOV_KEY_COUNT && strcasecmp(key, governance_keys[k]) != 0; k++) {
+            }
+        }
+
+        int is_string = c.p < c.end && *c.p == '"';
+        int handled = 0;
+        if (k < GOV_KEY_COUNT && !found[k]) {
+            found[k] = 1;
+            switch (k) {
+                case GOV_KEY_PACKAGE_NAME:
+                case GOV_KEY_VERSION:
+                case GOV_KEY_TIMESTAMP:
+                case GOV_KEY_STAGE_TYPE:
+                case GOV_KEY_ENTRY_POINT: {
+                    if (!is_string) {
+                        if (k != GOV_KEY_STAGE_TYPE && k != GOV_KEY_ENTRY_POINT) required_strings = 0;
+                        break;
+                    }
+                    char *out = k == GOV_KEY_PACKAGE_NAME ? config->package_name
+                              : k == GOV_KEY_VERSION ? config->version
+                              : k == GOV_KEY_TIMESTAMP ? config->timestamp
+                              : k == GOV_KEY_STAGE_TYPE ? stage_type : config->entry_point;
+                    size_t size = k == GOV_KEY_PACKAGE_NAME ? sizeof(config->package_name)
+                                : k == GOV_KEY_VERSION ? sizeof(config->version)
+                                : k == GOV_KEY_TIMESTAMP ? sizeof(config->timestamp)
+                                : k == GOV_KEY_STAGE_TYPE ? sizeof(stage_type) : sizeof(config->entry_point);
+                    if (!json_read_string(&c, out, size, NULL)) {
+                        return VALIDATION_SCHEMA_VIOLATION;
+                    }
+                    handled = 1;
+                    break;
+                }
+                case GOV_KEY_STAGE: {
+                    char number[64];
+                    const char *start = c.p;
+                    if (!json_skip_value(&c, 1) || is_string || c.p - start >= (long)sizeof(number) ||
+                        !(isdigit((unsigned char)*start) || *start == '-')) {
+                        return VALIDATION_SCHEMA_VIOLATION;
+                    }
+                    memcpy(number, start, (size_t)(c.p - start));
+                    number[c.p - start] = '\0';
+                    config->stage = (int)strtod(number, NULL);
+                    handled = 1;
+                    break;
+                }
+                case GOV_KEY_SEMVERX_LOCK:
+                case GOV_KEY_NLINK_ENABLED: {
+                    int is_true = c.end - c.p >= 4 && memcmp(c.p, "true", 4) == 0;
+                    if (k == GOV_KEY_SEMVERX_LOCK) config->semverx_lock = is_true;
+                    else config->nlink_enabled = is_true;
+                    break;
+                }
+            }
+        }
+        if (!handled && !json_skip_value(&c, 1)) {
+            return VALIDATION_SCHEMA_VIOLATION;
+        }
+
+        json_skip_whitespace(&c);
+        if (c.p >= c.end) {
+            return VALIDATION_SCHEMA_VIOLATION;
+        }
+        char next = *c.p++;
+        if (next == '}') {
+            break;
+        }
+        if (next != ',') {
+            return VALIDATION_SCHEMA_VIOLATION;
+        }
+        json_skip_whitespace(&c);
+    }
+
+    if (!found[GOV_KEY_PACKAGE_NAME] || !found[GOV_KEY_VERSION] || !found[GOV_KEY_TIMESTAMP] ||
+        !found[GOV_KEY_STAGE] || !required_strings) {
+        return VALIDATION_SCHEMA_VIOLATION;
+    }
+
+    if (strcmp(stage_type, "legacy") == 0) {
+        config->stage_type = STAGE_TYPE_LEGACY;
+    } else if (strcmp(stage_type, "stable") == 0) {
+        config->stage_type = STAGE_TYPE_STABLE;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+/**
+ * @brief Read a whole file into memory
+ * @param file_path Path to read
+ * @param length Receives the number of bytes read
+ * @return char* NUL-terminated contents to free(), or NULL
+ */
+static char *read_whole_file(const char *file_path, size_t *length) {
+    FILE *file = fopen(file_path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    size_t capacity = 4096, n = 0;
+    char *content = malloc(capacity);
+    while (content) {
+        n += fread(content + n, 1, capacity - n - 1, file);
+        if (n + 1 < capacity) {
+            break;
+        }
+        char *grown = realloc(content, capacity * 2);
+        if (!grown) {
+            free(content);
+            content = NULL;
+            break;
+        }
+        content = grown;
+        capacity *= 2;
+    }
+    int failed = ferror(file);
+    fclose(file);
+
+    if (!content || failed) {
+        free(content);
+        return NULL;
+    }
+    content[n] = '\0';
+    *length = n;
+    return content;
+}
+
 /**
  * @brief Parse JSON governance configuration file
  * @param file_path Path to governance file
@@ -121,79 +549,178 @@ validation_result_t rift_validation_init(validation_context_t *ctx, const char *
  * @return validation_result_t Parsing result
  */
 validation_result_t parse_governance_file(const char *file_path, governance_config_t *config) {
-    FILE *file = fopen(file_path, "r");
+    size_t length;
+    char *json_content = read_whole_file(file_path, &length);
+    if (!json_content) {
+        return access(file_path, F_OK) == 0 ? VALIDATION_CRITICAL_FAILURE : VALIDATION_MISSING_GOVERNANCE;
+    }
+
+    validation_result_t result = parse_governance_json(json_content, length, config);
+    free(json_content);
+    return result;
+}
+
+/**
+ * @brief Load the parse cache saved by an earlier run, if any
+ * @param cache Cache to initialize
+ * @param project_root Project whose logs directory holds the cache
+ */
+void governance_cache_init(governance_cache_t *cache, const char *project_root) {
+    memset(cache, 0, sizeof(*cache));
+    pthread_mutex_init(&cache->lock, NULL);
+    snprintf(cache->cache_path, sizeof(cache->cache_path), "%s/logs/governance_cache.bin", project_root);
+
+    FILE *file = fopen(cache->cache_path, "rb");
     if (!file) {
+        return;
+    }
+
+    char magic[8];
+    unsigned int count = 0;
+    if (fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+        memcmp(magic, GOVERNANCE_CACHE_MAGIC, sizeof(magic)) == 0 &&
+        fread(&count, sizeof(count), 1, file) == 1 && count <= 4096 && count > 0) {
+        cache->entries = malloc(count * sizeof(governance_cache_entry_t));
+        if (cache->entries && fread(cache->entries, sizeof(governance_cache_entry_t), count, file) == count) {
+            cache->count = cache->capacity = count;
+        } else {
+            free(cache->entries);
+            cache->entries = NULL;
+        }
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Save the parse cache if it changed, then release it
+ * @param cache Cache to save and free
+ */
+void governance_cache_cleanup(governance_cache_t *cache) {
+    if (cache->dirty && cache->count > 0) {
+        // Written aside and renamed, so a concurrent run never reads half a cache
+        char temp_path[MAX_PATH_LENGTH + 16];
+        snprintf(temp_path, sizeof(temp_path), "%s.%ld", cache->cache_path, (long)getpid());
+        FILE *file = fopen(temp_path, "wb");
+        if (file) {
+            unsigned int count = (unsigned int)cache->count;
+            int ok = fwrite(GOVERNANCE_CACHE_MAGIC, 1, 8, file) == 8 &&
+                     fwrite(&count, sizeof(count), 1, file) == 1 &&
+                     fwrite(cache->entries, sizeof(governance_cache_entry_t), cache->count, file) == cache->count;
+            if (fclose(file) != 0 || !ok || rename(temp_path, cache->cache_path) != 0) {
+                remove(temp_path);
+            }
+        }
+    }
+
+    free(cache->entries);
+    pthread_mutex_destroy(&cache->lock);
+    memset(cache, 0, sizeof(*cache));
+}
+
+/**
+ * @brief Parse a governance file through the cache
+ *
+ * An unchanged modification time and size reuse the cached parse without
+ * opening the file. Otherwise the file is read and hashed, and only parsed
+ * if its SHA-256 differs from the cached one.
+ *
+ * @param cache Parse cache, or NULL to always parse
+ * @param file_path Path to governance file
+ * @param config Output governance configuration
+ * @return validation_result_t Parsing result
+ */
+validation_result_t parse_governance_file_cached(governance_cache_t *cache, const char *file_path,
+                                                 governance_config_t *config) {
+    struct stat st;
+    if (!cache) {
+        return parse_governance_file(file_path, config);
+    }
+    if (stat(file_path, &st) != 0) {
         return VALIDATION_MISSING_GOVERNANCE;
     }
-    
-    // Read file content
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char *json_content = malloc(file_size + 1);
+
+    pthread_mutex_lock(&cache->lock);
+    governance_cache_entry_t *entry = NULL;
+    for (size_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].path, file_path) == 0) {
+            entry = &cache->entries[i];
+            break;
+        }
+    }
+    if (entry && entry->mtime_sec == (long long)st.st_mtim.tv_sec && entry->mtime_nsec == st.st_mtim.tv_nsec &&
+        entry->size == (long long)st.st_size) {
+        validation_result_t result = entry->parse_result;
+        *config = entry->config;
+        pthread_mutex_unlock(&cache->lock);
+        return result;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    size_t length;
+    char *json_content = read_whole_file(file_path, &length);
     if (!json_content) {
-        fclose(file);
-        return VALIDATION_CRITICAL_FAILURE;
+        return access(file_path, F_OK) == 0 ? VALIDATION_CRITICAL_FAILURE : VALIDATION_MISSING_GOVERNANCE;
     }
-    
-    fread(json_content, 1, file_size, file);
-    json_content[file_size] = '\0';
-    fclose(file);
-    
-    // Parse JSON
-    cJSON *json = cJSON_Parse(json_content);
-    free(json_content);
-    
-    if (!json) {
-        return VALIDATION_SCHEMA_VIOLATION;
+
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256((const unsigned char *)json_content, length, hash);
+
+    governance_cache_entry_t fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    strncpy(fresh.path, file_path, sizeof(fresh.path) - 1);
+    fresh.mtime_sec = (long long)st.st_mtim.tv_sec;
+    fresh.mtime_nsec = st.st_mtim.tv_nsec;
+    fresh.size = (long long)st.st_size;
+    memcpy(fresh.hash, hash, sizeof(hash));
+
+    // The entry may have moved while unlocked; look it up again
+    pthread_mutex_lock(&cache->lock);
+    entry = NULL;
+    for (size_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].path, file_path) == 0) {
+            entry = &cache->entries[i];
+            break;
+        }
     }
-    
-    // Extract required fields
-    cJSON *package_name = cJSON_GetObjectItem(json, "package_name");
-    cJSON *version = cJSON_GetObjectItem(json, "version");
-    cJSON *timestamp = cJSON_GetObjectItem(json, "timestamp");
-    cJSON *stage = cJSON_GetObjectItem(json, "stage");
-    
-    if (!package_name || !version || !timestamp || !stage) {
-        cJSON_Delete(json);
-        return VALIDATION_SCHEMA_VIOLATION;
+    int reuse = entry && memcmp(entry->hash, hash, sizeof(hash)) == 0;
+    if (reuse) {
+        fresh.parse_result = entry->parse_result;
+        fresh.config = entry->config;
     }
-    
-    // Populate configuration structure
-    strncpy(config->package_name, cJSON_GetStringValue(package_name), sizeof(config->package_name) - 1);
-    strncpy(config->version, cJSON_GetStringValue(version), sizeof(config->version) - 1);
-    strncpy(config->timestamp, cJSON_GetStringValue(timestamp), sizeof(config->timestamp) - 1);
-    config->stage = cJSON_GetNumberValue(stage);
-    
-    // Extract optional fields
-    cJSON *stage_type = cJSON_GetObjectItem(json, "stage_type");
-    if (stage_type) {
-        const char *type_str = cJSON_GetStringValue(stage_type);
-        if (strcmp(type_str, "legacy") == 0) {
-            config->stage_type = STAGE_TYPE_LEGACY;
-        } else if (strcmp(type_str, "stable") == 0) {
-            config->stage_type = STAGE_TYPE_STABLE;
-        } else {
-            config->stage_type = STAGE_TYPE_EXPERIMENTAL;
+    pthread_mutex_unlock(&cache->lock);
+
+    if (!reuse) {
+        fresh.parse_result = parse_governance_json(json_content, length, &fresh.config);
+    }
+    free(json_content);
+
+    pthread_mutex_lock(&cache->lock);
+    entry = NULL;
+    for (size_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].path, file_path) == 0) {
+            entry = &cache->entries[i];
+            break;
         }
-    } else {
-        config->stage_type = STAGE_TYPE_EXPERIMENTAL;
     }
-    
-    cJSON *semverx_lock = cJSON_GetObjectItem(json, "semverx_lock");
-    config->semverx_lock = semverx_lock ? cJSON_IsTrue(semverx_lock) : 0;
-    
-    cJSON *entry_point = cJSON_GetObjectItem(json, "entry_point");
-    if (entry_point) {
-        strncpy(config->entry_point, cJSON_GetStringValue(entry_point), sizeof(config->entry_point) - 1);
+    if (!entry && cache->count == cache->capacity) {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : 16;
+        governance_cache_entry_t *grown = realloc(cache->entries, capacity * sizeof(*grown));
+        if (grown) {
+            cache->entries = grown;
+            cache->capacity = capacity;
+        }
     }
-    
-    cJSON *nlink_enabled = cJSON_GetObjectItem(json, "nlink_enabled");
-    config->nlink_enabled = nlink_enabled ? cJSON_IsTrue(nlink_enabled) : 0;
-    
-    cJSON_Delete(json);
-    return VALIDATION_SUCCESS;
+    if (!entry && cache->count < cache->capacity) {
+        entry = &cache->entries[cache->count++];
+    }
+    if (entry && strlen(file_path) < sizeof(entry->path)) {
+        *entry = fresh;
+        cache->dirty = 1;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    *config = fresh.config;
+    return fresh.parse_result;
 }
 
 /**
@@ -234,9 +761,14 @@ validation_result_t validate_semverx_compliance(validation_context_t *ctx, gover
     
     // Execute NLink SemVerX validation
     char nlink_command[512];
-    snprintf(nlink_command, sizeof(nlink_command),
-             "nlink --semverx-validate --project-root %s --package %s --version %s",
-             ctx->project_root, config->package_name, config->version);
+    int length = snprintf(nlink_command, sizeof(nlink_command),
+                          "nlink --semverx-validate --project-root %s --package %s --version %s",
+                          ctx->project_root, config->package_name, config->version);
+    if (length < 0 || (size_t)length >= sizeof(nlink_command)) {
+        fprintf(ctx->validation_log, "[SEMVERX] Validation command too long for %s\n",
+                config->package_name);
+        return VALIDATION_SEMVERX_VIOLATION;
+    }
     
     int nlink_result = system(nlink_command);
     
@@ -276,9 +808,9 @@ validation_result_t validate_stage5_security(validation_context_t *ctx, stage5_o
     // Check for audit trail if enabled
     if (stage5_config->audit_enabled) {
         char audit_path[MAX_PATH_LENGTH];
-        snprintf(audit_path, sizeof(audit_path), "%s/logs/opt_trace.sig", ctx->project_root);
+        int length = snprintf(audit_path, sizeof(audit_path), "%s/logs/opt_trace.sig", ctx->project_root);
         
-        if (access(audit_path, F_OK) != 0) {
+        if (length < 0 || (size_t)length >= sizeof(audit_path) || access(audit_path, F_OK) != 0) {
             fprintf(ctx->validation_log, "[STAGE5] Missing audit trail: %s\n", audit_path);
             return VALIDATION_MISSING_GOVERNANCE;
         }
@@ -307,10 +839,15 @@ validation_result_t validate_stage_governance(validation_context_t *ctx, int sta
     
     // Primary stage configuration
     char primary_config_path[MAX_PATH_LENGTH];
-    snprintf(primary_config_path, sizeof(primary_config_path), "%s/.riftrc.%d", ctx->project_root, stage_id);
+    int length = snprintf(primary_config_path, sizeof(primary_config_path), "%s/.riftrc.%d",
+                          ctx->project_root, stage_id);
+    if (length < 0 || (size_t)length >= sizeof(primary_config_path)) {
+        fprintf(ctx->validation_log, "[STAGE%d] Configuration path too long\n", stage_id);
+        return VALIDATION_MISSING_GOVERNANCE;
+    }
     
     governance_config_t stage_config;
-    validation_result_t result = parse_governance_file(primary_config_path, &stage_config);
+    validation_result_t result = parse_governance_file_cached(ctx->cache, primary_config_path, &stage_config);
     
     if (result != VALIDATION_SUCCESS) {
         fprintf(ctx->validation_log, "[STAGE%d] Primary configuration validation failed: %d\n", stage_id, result);
@@ -337,7 +874,12 @@ validation_result_t validate_stage_governance(validation_context_t *ctx, int sta
     if (stage_id == 5) {
         // Stage 5 requires additional security validation
         char stage5_config_path[MAX_PATH_LENGTH];
-        snprintf(stage5_config_path, sizeof(stage5_config_path), "%s/gov.optimizer.stage.riftrc.5", ctx->project_root);
+        length = snprintf(stage5_config_path, sizeof(stage5_config_path), "%s/gov.optimizer.stage.riftrc.5",
+                          ctx->project_root);
+        if (length < 0 || (size_t)length >= sizeof(stage5_config_path)) {
+            fprintf(ctx->validation_log, "[STAGE5] Optimizer configuration path too long\n");
+            return VALIDATION_MISSING_GOVERNANCE;
+        }
         
         // TODO: Parse Stage 5 specific configuration
         // This would require extending the JSON parsing to handle stage5_optimizer section
@@ -357,8 +899,60 @@ validation_result_t validate_stage_governance(validation_context_t *ctx, int sta
     return VALIDATION_SUCCESS;
 }
 
+// One stage validated on a worker thread, with its log lines buffered so
+// they reach the validation log in stage order
+typedef struct {
+    validation_result_t result;
+    governance_config_t config;
+    int validated;
+    char *log;
+    size_t log_length;
+} stage_outcome_t;
+
+typedef struct {
+    validation_context_t *ctx;
+    stage_outcome_t outcomes[MAX_STAGE_COUNT];
+    int next_stage;
+    pthread_mutex_t lock;
+} stage_pool_t;
+
+static void validate_stage_buffered(validation_context_t *ctx, int stage_id, stage_outcome_t *outcome) {
+    validation_context_t local = *ctx;
+    FILE *log = open_memstream(&outcome->log, &outcome->log_length);
+    if (log) {
+        local.validation_log = log;
+    }
+    local.validated_stages = 0;
+
+    outcome->result = validate_stage_governance(&local, stage_id);
+    outcome->config = local.stage_configs[stage_id];
+    outcome->validated = local.validated_stages;
+
+    if (log) {
+        fclose(log);
+    }
+}
+
+static void *stage_worker(void *arg) {
+    stage_pool_t *pool = arg;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        int stage_id = pool->next_stage++;
+        pthread_mutex_unlock(&pool->lock);
+        if (stage_id >= MAX_STAGE_COUNT) {
+            return NULL;
+        }
+        validate_stage_buffered(pool->ctx, stage_id, &pool->outcomes[stage_id]);
+    }
+}
+
 /**
  * @brief Validate complete RIFT compiler pipeline (stages 0-6)
+ *
+ * Stages are validated concurrently on a pool of worker threads, then
+ * their results are applied in stage order, so the outcome and log match
+ * a sequential run.
+ *
  * @param ctx Validation context
  * @return validation_result_t Overall validation result
  */
@@ -367,22 +961,57 @@ validation_result_t validate_complete_pipeline(validation_context_t *ctx) {
     
     fprintf(ctx->validation_log, "[PIPELINE] Starting complete pipeline validation\n");
     
-    for (int stage_id = 0; stage_id < MAX_STAGE_COUNT; stage_id++) {
-        validation_result_t stage_result = validate_stage_governance(ctx, stage_id);
+    stage_pool_t pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.ctx = ctx;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    int threads = ctx->worker_threads > 0 ? ctx->worker_threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    if (threads > MAX_STAGE_COUNT) threads = MAX_STAGE_COUNT;
+
+    // The calling thread is one of the workers
+    pthread_t workers[MAX_STAGE_COUNT];
+    int started = 0;
+    while (started < threads - 1 && pthread_create(&workers[started], NULL, stage_worker, &pool) == 0) {
+        started++;
+    }
+    stage_worker(&pool);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.lock);
+
+    int stage_id;
+    for (stage_id = 0; stage_id < MAX_STAGE_COUNT; stage_id++) {
+        stage_outcome_t *outcome = &pool.outcomes[stage_id];
+        validation_result_t stage_result = outcome->result;
+
+        if (outcome->log) {
+            fwrite(outcome->log, 1, outcome->log_length, ctx->validation_log);
+            free(outcome->log);
+            outcome->log = NULL;
+        }
+        if (outcome->validated) {
+            ctx->stage_configs[stage_id] = outcome->config;
+            ctx->validated_stages++;
+        }
         
         switch (stage_result) {
             case VALIDATION_SEMVERX_VIOLATION:
             case VALIDATION_EXPIRED_GOVERNANCE:
                 // Critical failures halt the build
                 fprintf(ctx->validation_log, "[PIPELINE] Critical failure at stage %d: %d\n", stage_id, stage_result);
-                return stage_result;
+                overall_result = stage_result;
+                break;
                 
-            case VALIDATION_MISSING_GOVERNANCE:
+            case VALIDATION_MISSING_GOVERNANCE: {
                 // Check for fallback governance
                 char fallback_path[MAX_PATH_LENGTH];
-                snprintf(fallback_path, sizeof(fallback_path), "%s/irift/.riftrc.%d", ctx->project_root, stage_id);
+                int length = snprintf(fallback_path, sizeof(fallback_path), "%s/irift/.riftrc.%d",
+                                      ctx->project_root, stage_id);
                 
-                if (access(fallback_path, F_OK) == 0) {
+                if (length >= 0 && (size_t)length < sizeof(fallback_path) && access(fallback_path, F_OK) == 0) {
                     fprintf(ctx->validation_log, "[STAGE%d] Using fallback governance\n", stage_id);
                     // Re-validate with fallback
                     // TODO: Implement fallback validation logic
@@ -390,6 +1019,7 @@ validation_result_t validate_complete_pipeline(validation_context_t *ctx) {
                     overall_result = VALIDATION_MISSING_GOVERNANCE;
                 }
                 break;
+            }
                 
             case VALIDATION_SCHEMA_VIOLATION:
                 if (overall_result == VALIDATION_SUCCESS) {
@@ -401,6 +1031,18 @@ validation_result_t validate_complete_pipeline(validation_context_t *ctx) {
                 // Continue validation
                 break;
         }
+
+        if (stage_result == VALIDATION_SEMVERX_VIOLATION || stage_result == VALIDATION_EXPIRED_GOVERNANCE) {
+            break;
+        }
+    }
+
+    // Stages after a critical failure ran but are discarded, as if never validated
+    for (stage_id++; stage_id < MAX_STAGE_COUNT; stage_id++) {
+        free(pool.outcomes[stage_id].log);
+    }
+    if (overall_result == VALIDATION_SEMVERX_VIOLATION || overall_result == VALIDATION_EXPIRED_GOVERNANCE) {
+        return overall_result;
     }
     
     fprintf(ctx->validation_log, "[PIPELINE] Validation completed with result: %d\n", overall_result);
@@ -417,6 +1059,88 @@ void rift_validation_cleanup(validation_context_t *ctx) {
     }
 }
 
+#ifdef RIFT_OBIBENCH
+#include "obibench.h"
+
+static const char bench_governance_json[] =
+    "{\"package_name\":\"rift-optimizer\",\"version\":\"1.0.0\",\"timestamp\":\"2025-06-20T00:00:00Z\","
+    "\"stage\":5,\"stage_type\":\"stable\",\"semverx_lock\":true,"
+    "\"entry_point\":\"src/core/stage-5/optimizer.c\",\"nlink_enabled\":true,"
+    "\"stage_5_optimizer\":{\"optimizer_model\":\"AST-aware-minimizer-v2\",\"minimization_verified\":true,"
+    "\"audit_enabled\":true,\"security_level\":\"exploit_elimination\",\"semantic_equivalence_proof\":true}}";
+
+typedef struct {
+    governance_cache_t cache;
+    char path[MAX_PATH_LENGTH];
+} governance_bench_t;
+
+static void bench_parse_json(void *arg, uint64_t count) {
+    (void)arg;
+    governance_config_t config;
+    for (uint64_t i = 0; i < count; i++) {
+        parse_governance_json(bench_governance_json, sizeof(bench_governance_json) - 1, &config);
+        obibench_do_not_optimize(&config);
+    }
+}
+
+static void bench_timestamp(void *arg, uint64_t count) {
+    (void)arg;
+    validation_result_t result = VALIDATION_SUCCESS;
+    for (uint64_t i = 0; i < count; i++) {
+        obibench_clobber();
+        result |= validate_timestamp_freshness("2025-06-20T00:00:00Z");
+    }
+    obibench_do_not_optimize(&result);
+}
+
+// A stat and a lookup: the path every stage takes on an unchanged tree
+static void bench_parse_cached(void *arg, uint64_t count) {
+    governance_bench_t *bench = arg;
+    governance_config_t config;
+    for (uint64_t i = 0; i < count; i++) {
+        parse_governance_file_cached(&bench->cache, bench->path, &config);
+        obibench_do_not_optimize(&config);
+    }
+}
+
+// Microbenchmarks on the shared harness (make bench); argv takes the
+// harness options. The cached parse runs against a stage file in a
+// scratch directory that is removed afterwards.
+static int run_governance_microbench(int argc, char *argv[]) {
+    char root[] = "/tmp/rift-gov-bench-XXXXXX";
+    if (!mkdtemp(root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    governance_bench_t bench;
+    snprintf(bench.path, sizeof(bench.path), "%s/.riftrc.5", root);
+    FILE *file = fopen(bench.path, "w");
+    if (!file) {
+        perror(bench.path);
+        rmdir(root);
+        return 1;
+    }
+    fputs(bench_governance_json, file);
+    fclose(file);
+    governance_cache_init(&bench.cache, root);
+
+    obibench_suite_t *suite = obibench_init("rift-gov", argc, argv);
+    obibench_run_bytes(suite, "parse_governance_json", bench_parse_json, NULL,
+                       sizeof(bench_governance_json) - 1);
+    obibench_run(suite, "timestamp_freshness", bench_timestamp, NULL);
+    obibench_run(suite, "parse_governance_file_cached", bench_parse_cached, &bench);
+    int status = obibench_finish(suite);
+
+    bench.cache.dirty = 0;      // Nothing worth persisting in a scratch tree
+    governance_cache_cleanup(&bench.cache);
+    unlink(bench.path);
+    rmdir(root);
+    return status;
+}
+#endif
+
+// The tests include this file and define RIFT_GOVERNANCE_NO_MAIN
+#ifndef RIFT_GOVERNANCE_NO_MAIN
 /**
  * @brief Main validation entry point
  * @param argc Argument count
@@ -424,8 +1148,13 @@ void rift_validation_cleanup(validation_context_t *ctx) {
  * @return int Exit code (0 = success, non-zero = failure)
  */
 int main(int argc, char *argv[]) {
+#ifdef RIFT_OBIBENCH
+    if (argc > 1 && strcmp(argv[1], "--microbench") == 0) {
+        return run_governance_microbench(argc - 1, argv + 1);
+    }
+#endif
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <project_root> [--verbose] [--strict]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <project_root> [--verbose] [--strict] [--jobs N] [--no-cache]\n", argv[0]);
         return 1;
     }
     
@@ -438,13 +1167,24 @@ int main(int argc, char *argv[]) {
     }
     
     // Parse command line options
+    int use_cache = 1;
     for (int i = 2; i < argc; i++) {
         if (strcmp(argv[i], "--verbose") == 0) {
             ctx.verbose_mode = 1;
         } else if (strcmp(argv[i], "--strict") == 0) {
             ctx.strict_mode = 1;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            ctx.worker_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            use_cache = 0;
         }
     }
+
+    governance_cache_t cache;
+    if (use_cache) {
+        governance_cache_init(&cache, ctx.project_root);
+        ctx.cache = &cache;
+    }
     
     printf("AEGIS RIFT Governance Validation Engine v1.0.0\n");
     printf("Project Root: %s\n", ctx.project_root);
@@ -480,6 +1220,9 @@ int main(int argc, char *argv[]) {
             break;
     }
     
+    if (ctx.cache) {
+        governance_cache_cleanup(ctx.cache);
+    }
     rift_validation_cleanup(&ctx);
     
     // Return appropriate exit code
@@ -495,4 +1238,5 @@ int main(int argc, char *argv[]) {
         default:
             return 3;  // General error
     }
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -132,9 +132,7 @@ install_dependencies() {
                 build-essential \
                 cmake \
                 pkg-config \
-                libcjson-dev \
                 libssl-dev \
-                libcjson1 \
                 openssl \
                 git \
                 curl \
@@ -146,14 +144,12 @@ install_dependencies() {
                 sudo dnf install -y \
                     gcc gcc-c++ make cmake \
                     pkg-config \
-                    cjson-devel \
                     openssl-devel \
                     git curl wget
             else
                 sudo yum install -y \
                     gcc gcc-c++ make cmake \
                     pkg-config \
-                    cjson-devel \
                     openssl-devel \
                     git curl wget
             fi
@@ -164,7 +160,6 @@ install_dependencies() {
                 base-devel \
                 cmake \
                 pkg-config \
-                cjson \
                 openssl \
                 git \
                 curl \
@@ -180,7 +175,6 @@ install_dependencies() {
             brew install \
                 cmake \
                 pkg-config \
-                cjson \
                 openssl \
                 git \
                 curl \
@@ -208,7 +202,6 @@ install_dependencies() {
             log_info "  - build-essential (gcc, make, etc.)"
             log_info "  - cmake"
             log_info "  - pkg-config"
-            log_info "  - libcjson-dev"
             log_info "  - libssl-dev"
             return 1
             ;;
@@ -222,7 +215,7 @@ verify_dependencies() {
     log_phase "Phase 3: Dependency Verification"
     
     # Check pkg-config packages
-    local required_packages=("libcjson" "openssl")
+    local required_packages=("openssl")
     local missing_packages=()
     
     for package in "${required_packages[@]}"; do
@@ -235,18 +228,6 @@ verify_dependencies() {
         fi
     done
     
-    # Special handling for different cjson package names
-    if [[ " ${missing_packages[*]} " =~ " libcjson " ]]; then
-        # Try alternative package names
-        if pkg-config --exists "cjson"; then
-            log_success "cjson found (alternative name)"
-            missing_packages=("${missing_packages[@]/libcjson}")
-        elif pkg-config --exists "libcjson-dev"; then
-            log_success "libcjson-dev found"
-            missing_packages=("${missing_packages[@]/libcjson}")
-        fi
-    fi
-    
     if [ ${#missing_packages[@]} -ne 0 ]; then
         log_error "Missing pkg-config packages: ${missing_packages[*]}"
         
@@ -254,7 +235,7 @@ verify_dependencies() {
         log_info "Troubleshooting steps:"
         log_info "1. Check PKG_CONFIG_PATH: $PKG_CONFIG_PATH"
         log_info "2. Search for .pc files:"
-        find /usr -name "*.pc" 2>/dev/null | grep -E "(cjson|ssl)" | head -5
+        find /usr -name "*.pc" 2>/dev/null | grep -E "ssl" | head -5
         
         return 1
     fi
@@ -365,12 +346,11 @@ test_build() {
     
     log_info "Testing governance validator compilation..."
     
-    # Try to compile with direct gcc command first
-    if gcc -std=c11 -Wall -Wextra -Wpedantic \
-        $(pkg-config --cflags libcjson openssl || pkg-config --cflags cjson openssl) \
+    if gcc -std=c11 -Wall -Wextra -Wpedantic -pthread \
+        $(pkg-config --cflags openssl) \
         -o bin/rift_governance_validator \
         rift_governance_validator.c \
-        $(pkg-config --libs libcjson openssl || pkg-config --libs cjson openssl) 2>/dev/null; then
+        $(pkg-config --libs openssl) 2>/dev/null; then
         log_success "Direct compilation successful"
         
         # Test the validator
@@ -380,20 +360,8 @@ test_build() {
             log_success "Governance validator test completed"
         fi
     else
-        log_error "Direct compilation failed"
-        log_info "Attempting with alternative package names..."
-        
-        # Try alternative compilation
-        if gcc -std=c11 -Wall -Wextra -Wpedantic \
-            $(pkg-config --cflags cjson openssl) \
-            -o bin/rift_governance_validator \
-            rift_governance_validator.c \
-            $(pkg-config --libs cjson openssl) 2>/dev/null; then
-            log_success "Alternative compilation successful"
-        else
-            log_error "Compilation failed. Manual intervention required."
-            return 1
-        fi
+        log_error "Compilation failed. Manual intervention required."
+        return 1
     fi
     
     # Test Makefile build
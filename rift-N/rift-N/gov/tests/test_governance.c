@@ -0,0 +1,402 @@
+/**
+ * @file tests/test_governance.c
+ * @brief Checks for the governance validator
+ *
+ * parse_governance_json decodes what cJSON did and rejects what it should,
+ * the parse cache reuses and refreshes entries as documented, stages
+ * validated in parallel give the results and log of a sequential run, and
+ * paths too long for MAX_PATH_LENGTH are refused rather than truncated.
+ */
+
+#include "rift_governance_validator.c"
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#define GOV(extra) \
+    "{\"package_name\":\"rift-core\",\"version\":\"1.2.3\",\"timestamp\":\"2025-06-20T00:00:00Z\"," \
+    "\"stage\":3" extra "}"
+
+static validation_result_t parse_text(const char *json, governance_config_t *config) {
+    return parse_governance_json(json, strlen(json), config);
+}
+
+static void write_text(const char *path, const char *text) {
+    FILE *file = fopen(path, "w");
+    assert(file != NULL);
+    fputs(text, file);
+    fclose(file);
+}
+
+// A governance document whose timestamp is the current time
+static void write_fresh(const char *root, int stage_id, const char *extra) {
+    char path[MAX_PATH_LENGTH], stamp[32], text[512];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", localtime(&now));
+    snprintf(path, sizeof(path), "%s/.riftrc.%d", root, stage_id);
+    snprintf(text, sizeof(text),
+             "{\"package_name\":\"stage-%d\",\"version\":\"1.0.%d\",\"timestamp\":\"%s\",\"stage\":%d%s}",
+             stage_id, stage_id, stamp, stage_id, extra);
+    write_text(path, text);
+}
+
+static void remove_tree(const char *root) {
+    char command[MAX_PATH_LENGTH + 16];
+    snprintf(command, sizeof(command), "rm -rf '%s'", root);
+    int status = system(command);
+    assert(status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void test_parse_json(void) {
+    printf("Testing governance JSON parsing...\n");
+
+    governance_config_t config;
+    assert(parse_text(GOV(",\"stage_type\":\"stable\",\"semverx_lock\":true,\"entry_point\":\"src/main.c\","
+                          "\"nlink_enabled\":false"), &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-core") == 0 && strcmp(config.version, "1.2.3") == 0);
+    assert(strcmp(config.timestamp, "2025-06-20T00:00:00Z") == 0 && config.stage == 3);
+    assert(config.stage_type == STAGE_TYPE_STABLE && config.semverx_lock && !config.nlink_enabled);
+    assert(strcmp(config.entry_point, "src/main.c") == 0);
+
+    // Defaults, and stage types other than legacy and stable
+    assert(parse_text(GOV(""), &config) == VALIDATION_SUCCESS);
+    assert(config.stage_type == STAGE_TYPE_EXPERIMENTAL && !config.semverx_lock && config.entry_point[0] == '\0');
+    assert(parse_text(GOV(",\"stage_type\":\"legacy\""), &config) == VALIDATION_SUCCESS);
+    assert(config.stage_type == STAGE_TYPE_LEGACY);
+    assert(parse_text(GOV(",\"stage_type\":\"Stable\",\"semverx_lock\":1"), &config) == VALIDATION_SUCCESS);
+    assert(config.stage_type == STAGE_TYPE_EXPERIMENTAL && !config.semverx_lock);
+
+    // Keys match case-insensitively and the first occurrence wins, as with
+    // cJSON_GetObjectItem
+    assert(parse_text("{\"PACKAGE_NAME\":\"a\",\"package_name\":\"b\",\"Version\":\"2\","
+                      "\"TimeStamp\":\"t\",\"STAGE\":-1,\"stage\":4}", &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "a") == 0 && strcmp(config.version, "2") == 0);
+    assert(config.stage == -1);
+    assert(parse_text("{\"package_name\":1,\"package_name\":\"b\",\"version\":\"2\",\"timestamp\":\"t\","
+                      "\"stage\":1}", &config) == VALIDATION_SCHEMA_VIOLATION);
+
+    // Skipped values of every kind, escapes, and fractional stages
+    assert(parse_text("{\"meta\":{\"list\":[1,-2.5e3,true,false,null,\"x\\\"y\",[],{}]},"
+                      "\"package_name\":\"caf\\u00e9 \\ud83d\\ude00\\n\\t\\/\",\"version\":\"1\","
+                      "\"timestamp\":\"t\",\"stage\":2.9,\"stage_type\":7}", &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "caf\xc3\xa9 \xf0\x9f\x98\x80\n\t/") == 0);
+    assert(config.stage == 2 && config.stage_type == STAGE_TYPE_EXPERIMENTAL);
+
+    // Over-long strings are truncated to the field
+    char json[512], name[300];
+    memset(name, 'n', sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    snprintf(json, sizeof(json), "{\"package_name\":\"%s\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":0}", name);
+    assert(parse_text(json, &config) == VALIDATION_SUCCESS);
+    assert(strlen(config.package_name) == sizeof(config.package_name) - 1);
+
+    // Missing or non-string required fields, and malformed documents
+    const char *const invalid[] = {
+        "", "{", "[]", "{}", "{\"package_name\":\"a\"}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":\"3\"}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":{}}",
+        "{\"package_name\":null,\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\":\"a\",\"version\":[\"1\"],\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1,}",
+        "{\"package_name\":\"a\" \"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\"\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1",
+        "{\"package_name\":\"a\\q\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\":\"\\ud83d\\u0041\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1,\"x\":[1 2]}",
+        "{\"package_name\":\"a\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1,\"x\":tru}",
+        "{\"package_name\":\"a\tb\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":1}",
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(parse_text(invalid[i], &config) == VALIDATION_SCHEMA_VIOLATION);
+    }
+
+    // Skipped values nest no deeper than JSON_MAX_DEPTH
+    char deep[2 * JSON_MAX_DEPTH + 128];
+    for (int depth = JSON_MAX_DEPTH - 1; depth <= JSON_MAX_DEPTH; depth++) {
+        size_t n = (size_t)snprintf(deep, sizeof(deep), "{\"package_name\":\"a\",\"version\":\"1\","
+                                    "\"timestamp\":\"t\",\"stage\":1,\"x\":");
+        for (int i = 0; i < depth; i++) deep[n++] = '[';
+        for (int i = 0; i < depth; i++) deep[n++] = ']';
+        deep[n++] = '}';
+        deep[n] = '\0';
+        assert(parse_text(deep, &config) ==
+               (depth < JSON_MAX_DEPTH ? VALIDATION_SUCCESS : VALIDATION_SCHEMA_VIOLATION));
+    }
+
+    // Text after the object is ignored, as cJSON_Parse did; length bounds
+    // the document, not a NUL
+    assert(parse_text(GOV("") " trailing", &config) == VALIDATION_SUCCESS);
+    const char *text = GOV("");
+    assert(parse_governance_json(text, strlen(text) - 1, &config) == VALIDATION_SCHEMA_VIOLATION);
+
+    printf("Governance JSON parsing test passed\n");
+}
+
+#define GOV_NAMED(name) \
+    "{\"package_name\":\"" name "\",\"version\":\"1.2.3\",\"timestamp\":\"2025-06-20T00:00:00Z\",\"stage\":3}"
+
+// Rewrites path, then puts its modification time back to st's
+static void rewrite_keeping_time(const char *path, const char *text, const struct stat *st) {
+    write_text(path, text);
+    struct timespec times[2] = {st->st_atim, st->st_mtim};
+    assert(utimensat(AT_FDCWD, path, times, 0) == 0);
+}
+
+static void test_parse_cache(void) {
+    printf("Testing parse cache...\n");
+
+    char root[] = "/tmp/rift-gov-test-XXXXXX";
+    assert(mkdtemp(root) != NULL);
+    char logs[MAX_PATH_LENGTH], path[MAX_PATH_LENGTH];
+    snprintf(logs, sizeof(logs), "%s/logs", root);
+    assert(mkdir(logs, 0755) == 0);
+    snprintf(path, sizeof(path), "%s/.riftrc.1", root);
+    write_text(path, GOV_NAMED("rift-core"));
+
+    governance_cache_t cache;
+    governance_cache_init(&cache, root);
+    assert(cache.count == 0);
+    governance_config_t config;
+    assert(parse_governance_file_cached(&cache, path, &config) == VALIDATION_SUCCESS);
+    assert(cache.count == 1 && cache.dirty && strcmp(config.package_name, "rift-core") == 0);
+
+    // Same size and modification time: the cached parse is used without
+    // reading the file, so a same-length edit with the old time goes unseen
+    struct stat st;
+    assert(stat(path, &st) == 0);
+    rewrite_keeping_time(path, GOV_NAMED("rift-edit"), &st);
+    assert(parse_governance_file_cached(&cache, path, &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-core") == 0);
+
+    // A new modification time with the same contents keeps the parse and
+    // records the new time; new contents are parsed
+    struct timespec later[2] = {st.st_atim, st.st_mtim};
+    later[1].tv_sec += 10;
+    rewrite_keeping_time(path, GOV_NAMED("rift-core"), &st);
+    assert(utimensat(AT_FDCWD, path, later, 0) == 0);
+    assert(parse_governance_file_cached(&cache, path, &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-core") == 0 && cache.count == 1);
+    assert(cache.entries[0].mtime_sec == (long long)later[1].tv_sec);
+    write_text(path, GOV_NAMED("rift-next"));
+    assert(parse_governance_file_cached(&cache, path, &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-next") == 0 && cache.count == 1);
+
+    // Parse failures are cached too; missing and unreadable files are not
+    char broken[MAX_PATH_LENGTH], missing[MAX_PATH_LENGTH];
+    snprintf(broken, sizeof(broken), "%s/.riftrc.2", root);
+    snprintf(missing, sizeof(missing), "%s/.riftrc.3", root);
+    write_text(broken, "{\"package_name\":");
+    assert(parse_governance_file_cached(&cache, broken, &config) == VALIDATION_SCHEMA_VIOLATION);
+    assert(parse_governance_file_cached(&cache, missing, &config) == VALIDATION_MISSING_GOVERNANCE);
+    assert(parse_governance_file_cached(&cache, logs, &config) == VALIDATION_CRITICAL_FAILURE);
+    assert(cache.count == 2);
+    assert(parse_governance_file(missing, &config) == VALIDATION_MISSING_GOVERNANCE);
+    assert(parse_governance_file(logs, &config) == VALIDATION_CRITICAL_FAILURE);
+
+    // Saved on cleanup and loaded by the next run, which again trusts the
+    // recorded size and time
+    assert(stat(path, &st) == 0);
+    governance_cache_cleanup(&cache);
+    char saved[MAX_PATH_LENGTH + 32];
+    snprintf(saved, sizeof(saved), "%s/governance_cache.bin", logs);
+    assert(access(saved, F_OK) == 0);
+    governance_cache_init(&cache, root);
+    assert(cache.count == 2 && !cache.dirty);
+    rewrite_keeping_time(path, GOV_NAMED("rift-edit"), &st);
+    assert(parse_governance_file_cached(&cache, path, &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-next") == 0);
+    assert(parse_governance_file_cached(&cache, broken, &config) == VALIDATION_SCHEMA_VIOLATION);
+
+    // Nothing new: the saved cache is left alone
+    assert(!cache.dirty);
+    assert(unlink(saved) == 0);
+    governance_cache_cleanup(&cache);
+    assert(access(saved, F_OK) != 0);
+
+    // A cache file from something else is ignored
+    write_text(saved, "RIFTGOV0 not a cache");
+    governance_cache_init(&cache, root);
+    assert(cache.count == 0 && cache.entries == NULL);
+    governance_cache_cleanup(&cache);
+
+    // No cache: always parse
+    assert(parse_governance_file_cached(NULL, path, &config) == VALIDATION_SUCCESS);
+    assert(strcmp(config.package_name, "rift-edit") == 0);
+
+    remove_tree(root);
+    printf("Parse cache test passed\n");
+}
+
+// The pipeline as it ran before stages went parallel: one stage at a
+// time, logging straight to the validation log
+static validation_result_t sequential_pipeline(validation_context_t *ctx) {
+    validation_result_t overall_result = VALIDATION_SUCCESS;
+    fprintf(ctx->validation_log, "[PIPELINE] Starting complete pipeline validation\n");
+    for (int stage_id = 0; stage_id < MAX_STAGE_COUNT; stage_id++) {
+        validation_result_t stage_result = validate_stage_governance(ctx, stage_id);
+        if (stage_result == VALIDATION_SEMVERX_VIOLATION || stage_result == VALIDATION_EXPIRED_GOVERNANCE) {
+            fprintf(ctx->validation_log, "[PIPELINE] Critical failure at stage %d: %d\n", stage_id, stage_result);
+            return stage_result;
+        }
+        if (stage_result == VALIDATION_MISSING_GOVERNANCE) {
+            char fallback_path[MAX_PATH_LENGTH];
+            int length = snprintf(fallback_path, sizeof(fallback_path), "%s/irift/.riftrc.%d",
+                                  ctx->project_root, stage_id);
+            if (length >= 0 && (size_t)length < sizeof(fallback_path) && access(fallback_path, F_OK) == 0) {
+                fprintf(ctx->validation_log, "[STAGE%d] Using fallback governance\n", stage_id);
+            } else if (overall_result == VALIDATION_SUCCESS) {
+                overall_result = VALIDATION_MISSING_GOVERNANCE;
+            }
+        } else if (stage_result == VALIDATION_SCHEMA_VIOLATION && overall_result == VALIDATION_SUCCESS) {
+            overall_result = VALIDATION_SCHEMA_VIOLATION;
+        }
+    }
+    fprintf(ctx->validation_log, "[PIPELINE] Validation completed with result: %d\n", overall_result);
+    return overall_result;
+}
+
+typedef struct {
+    validation_result_t result;
+    int validated_stages;
+    governance_config_t stage_configs[MAX_STAGE_COUNT];
+    char *log;
+    size_t log_length;
+} pipeline_run_t;
+
+static void run_pipeline(const char *root, int threads, governance_cache_t *cache, pipeline_run_t *run) {
+    validation_context_t ctx;
+    assert(rift_validation_init(&ctx, root) == VALIDATION_SUCCESS);
+    rift_validation_cleanup(&ctx);
+    ctx.validation_log = open_memstream(&run->log, &run->log_length);
+    assert(ctx.validation_log != NULL);
+    ctx.worker_threads = threads;
+    ctx.cache = cache;
+
+    run->result = threads < 0 ? sequential_pipeline(&ctx) : validate_complete_pipeline(&ctx);
+    fclose(ctx.validation_log);
+    run->validated_stages = ctx.validated_stages;
+    memcpy(run->stage_configs, ctx.stage_configs, sizeof(run->stage_configs));
+}
+
+static void check_pipeline(const char *root, validation_result_t expected, int expected_stages) {
+    pipeline_run_t reference;
+    run_pipeline(root, -1, NULL, &reference);
+    assert(reference.result == expected && reference.validated_stages == expected_stages);
+
+    // Every thread count, uncached and then from a cold and a warm cache
+    governance_cache_t cache;
+    governance_cache_init(&cache, root);
+    const int thread_counts[] = {0, 1, 2, 3, 7, 16};
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        for (int pass = 0; pass < 3; pass++) {
+            pipeline_run_t run;
+            run_pipeline(root, thread_counts[t], pass == 0 ? NULL : &cache, &run);
+            assert(run.result == reference.result && run.validated_stages == reference.validated_stages);
+            assert(memcmp(run.stage_configs, reference.stage_configs, sizeof(run.stage_configs)) == 0);
+            assert(run.log_length == reference.log_length && memcmp(run.log, reference.log, run.log_length) == 0);
+            free(run.log);
+        }
+    }
+    cache.dirty = 0;
+    governance_cache_cleanup(&cache);
+    free(reference.log);
+}
+
+static void test_parallel_pipeline(void) {
+    printf("Testing parallel pipeline...\n");
+
+    char root[] = "/tmp/rift-gov-test-XXXXXX";
+    assert(mkdtemp(root) != NULL);
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/logs", root);
+    assert(mkdir(path, 0755) == 0);
+
+    // Every kind of non-critical outcome: valid stages, missing ones with
+    // and without a fallback, a schema violation and a bad timestamp.
+    // Stage 5 is left out, as its security check cannot pass yet.
+    write_fresh(root, 0, "");
+    write_fresh(root, 1, ",\"stage_type\":\"stable\",\"extra\":{\"deps\":[\"a\",\"b\"]}");
+    snprintf(path, sizeof(path), "%s/irift", root);
+    assert(mkdir(path, 0755) == 0);
+    snprintf(path, sizeof(path), "%s/irift/.riftrc.2", root);
+    write_text(path, "{}");
+    snprintf(path, sizeof(path), "%s/.riftrc.3", root);
+    write_text(path, "{\"package_name\":\"stage-3\",\"version\":\"1\",\"timestamp\":\"t\",\"stage\":\"3\"}");
+    write_fresh(root, 4, ",\"semverx_lock\":false");
+    snprintf(path, sizeof(path), "%s/.riftrc.6", root);
+    write_text(path, "{\"package_name\":\"stage-6\",\"version\":\"1\",\"timestamp\":\"June\",\"stage\":6}");
+    check_pipeline(root, VALIDATION_SCHEMA_VIOLATION, 3);
+
+    snprintf(path, sizeof(path), "%s/irift/.riftrc.2", root);
+    assert(unlink(path) == 0);
+    check_pipeline(root, VALIDATION_MISSING_GOVERNANCE, 3);
+
+    // A critical failure halts the pipeline; the stages after it are
+    // discarded even though they were validated
+    write_fresh(root, 6, "");
+    snprintf(path, sizeof(path), "%s/.riftrc.3", root);
+    write_text(path, "{\"package_name\":\"stage-3\",\"version\":\"1\",\"timestamp\":\"2020-01-01T00:00:00Z\","
+                     "\"stage\":3}");
+    check_pipeline(root, VALIDATION_EXPIRED_GOVERNANCE, 2);
+
+    // As does stage 5's security check
+    write_fresh(root, 2, "");
+    write_fresh(root, 3, "");
+    write_fresh(root, 5, "");
+    check_pipeline(root, VALIDATION_SEMVERX_VIOLATION, 5);
+
+    remove_tree(root);
+    printf("Parallel pipeline test passed\n");
+}
+
+static void test_long_root(void) {
+    printf("Testing long project roots...\n");
+
+    char base[] = "/tmp/rift-gov-test-XXXXXX";
+    assert(mkdtemp(base) != NULL);
+
+    // Nest directories until "/.riftrc.0" no longer fits after the root
+    validation_context_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    size_t length = strlen(base);
+    memcpy(ctx.project_root, base, length + 1);
+    while (length < MAX_PATH_LENGTH - 8) {
+        size_t part = MAX_PATH_LENGTH - 8 - length - 1;
+        if (part > 200) part = 200;
+        ctx.project_root[length++] = '/';
+        memset(ctx.project_root + length, 'd', part);
+        length += part;
+        ctx.project_root[length] = '\0';
+        assert(mkdir(ctx.project_root, 0755) == 0);
+    }
+
+    // A valid document where the truncated path would land is not read
+    char truncated[MAX_PATH_LENGTH];
+    snprintf(truncated, sizeof(truncated), "%s/.riftr", ctx.project_root);
+    assert(strlen(truncated) == MAX_PATH_LENGTH - 1);
+    write_fresh(ctx.project_root, 0, "");
+    assert(access(truncated, F_OK) == 0);
+
+    char *log = NULL;
+    size_t log_length = 0;
+    ctx.validation_log = open_memstream(&log, &log_length);
+    assert(ctx.validation_log != NULL);
+    assert(validate_stage_governance(&ctx, 0) == VALIDATION_MISSING_GOVERNANCE);
+    assert(ctx.validated_stages == 0);
+    fclose(ctx.validation_log);
+    assert(strstr(log, "[STAGE0] Configuration path too long") != NULL);
+    free(log);
+
+    remove_tree(base);
+    printf("Long project roots test passed\n");
+}
+
+int main(void) {
+    test_parse_json();
+    test_parse_cache();
+    test_parallel_pipeline();
+    test_long_root();
+    printf("All governance tests passed!\n");
+    return 0;
+}
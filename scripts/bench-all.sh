@@ -0,0 +1,60 @@
+#!/bin/bash
+# bench-all.sh
+# Run `make bench` in every MVP subsystem and gather the results into one
+# JSON document for the dashboard: {"revision", "timestamp", "suites": [...]}
+#
+# Usage: scripts/bench-all.sh [output.json] [harness options...]
+#   e.g. scripts/bench-all.sh bench/results/all.json --samples 500
+# Each suite also leaves bench/results/suites/<suite>.json behind.
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+OUTPUT="${1:-$ROOT/bench/results/all.json}"
+shift
+BENCH_ARGS="$*"
+
+SUBSYSTEMS=(
+    "diram/diram"
+    "libpolycall/libpolycall"
+    "gov-clock/gov-clock"
+    "OBIAI/stress_filter_flash"
+    "OBIAI/void_processor"
+    "verlet_cloth_simulation"
+    "rift-N/rift-N/gov"
+    "gosilabs/01_let_get_gossipy"
+)
+
+export OBIBENCH_RESULTS_DIR="$ROOT/bench/results/suites"
+export OBIBENCH_REVISION="$(git -C "$ROOT" rev-parse --short HEAD 2>/dev/null)"
+mkdir -p "$OBIBENCH_RESULTS_DIR" "$(dirname "$OUTPUT")"
+rm -f "$OBIBENCH_RESULTS_DIR"/*.json
+
+make -C "$ROOT/bench" >/dev/null || exit 1
+
+FAILED=()
+for subsystem in "${SUBSYSTEMS[@]}"; do
+    echo "== $subsystem"
+    if ! make -C "$ROOT/$subsystem" bench BENCH_ARGS="$BENCH_ARGS"; then
+        FAILED+=("$subsystem")
+    fi
+done
+
+# Suites in name order, one per line of the array
+{
+    printf '{\n  "revision": "%s",\n  "timestamp": %s,\n  "suites": [\n' \
+        "$OBIBENCH_REVISION" "$(date +%s)"
+    first=1
+    for result in "$OBIBENCH_RESULTS_DIR"/*.json; do
+        [ -e "$result" ] || continue
+        [ $first -eq 1 ] || printf ',\n'
+        first=0
+        printf '    '
+        tr -d '\n' < "$result"
+    done
+    printf '\n  ]\n}\n'
+} > "$OUTPUT.tmp" && mv "$OUTPUT.tmp" "$OUTPUT"
+
+echo "Results: $OUTPUT"
+if [ ${#FAILED[@]} -gt 0 ]; then
+    echo "Failed: ${FAILED[*]}" >&2
+    exit 1
+fi
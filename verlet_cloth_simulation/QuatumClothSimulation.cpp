@@ -11,6 +11,11 @@ AQuantumClothSimulation::AQuantumClothSimulation()
     ActiveContract.CurrentState = EQuantumState::ISOLATED;
     ActiveContract.CollapseThreshold = 0.5f;
     ActiveContract.bIsStabilized = false;
+
+    // Tick jobs run alongside physics; their results are applied after it
+    PostPhysicsTick.bCanEverTick = true;
+    PostPhysicsTick.bStartWithTickEnabled = true;
+    PostPhysicsTick.TickGroup = TG_PostPhysics;
 }
 
 void AQuantumClothSimulation::BeginPlay()
@@ -23,36 +28,135 @@ void AQuantumClothSimulation::BeginPlay()
     }
     
     LastStablePosition = GetActorLocation();
+    QuantumRandom.Initialize(FMath::Rand());
+}
+
+void AQuantumClothSimulation::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FinishTickJob();
+    Super::EndPlay(EndPlayReason);
 }
 
+void AQuantumClothSimulation::RegisterActorTickFunctions(bool bRegister)
+{
+    Super::RegisterActorTickFunctions(bRegister);
+
+    if (bRegister)
+    {
+        if (PrimaryActorTick.bCanEverTick)
+        {
+            PostPhysicsTick.Target = this;
+            PostPhysicsTick.SetTickFunctionEnable(PostPhysicsTick.bStartWithTickEnabled);
+            PostPhysicsTick.RegisterTickFunction(GetLevel());
+            PostPhysicsTick.AddPrerequisite(this, PrimaryActorTick);
+        }
+    }
+    else if (PostPhysicsTick.IsTickFunctionRegistered())
+    {
+        PostPhysicsTick.UnRegisterTickFunction();
+    }
+}
+
+// Snapshots the actor and hands the anti-jitter and quantum field update
+// to a task graph job, so many cloth actors spread across worker threads
+// and overlap physics instead of running serially on the game thread
 void AQuantumClothSimulation::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
-    
+
+    FinishTickJob();
+
+    TickJobState.Contract = ActiveContract;
+    TickJobState.LastStablePosition = LastStablePosition;
+    TickJobState.JitterSampleCount = JitterSampleCount;
+
+    const FVector CurrentPos = GetActorLocation();
+    const float Threshold = JitterThreshold;
+    const float WorldDeltaSeconds = GetWorld()->GetDeltaSeconds();
+    FQuantumTickState* State = &TickJobState;
+    FRandomStream* Random = &QuantumRandom;
+
+    TickJob = FFunctionGraphTask::CreateAndDispatchWhenReady(
+        [State, CurrentPos, Threshold, WorldDeltaSeconds, Random]()
+        {
+            StepQuantumState(*State, CurrentPos, Threshold, WorldDeltaSeconds, *Random);
+        },
+        TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+// Waits for the tick job, if any, and copies its results back
+void AQuantumClothSimulation::FinishTickJob()
+{
+    if (!TickJob.IsValid())
+    {
+        return;
+    }
+
+    FTaskGraphInterface::Get().WaitUntilTaskCompletes(TickJob, ENamedThreads::GameThread);
+    TickJob = nullptr;
+
+    ActiveContract = TickJobState.Contract;
+    LastStablePosition = TickJobState.LastStablePosition;
+    JitterSampleCount = TickJobState.JitterSampleCount;
+}
+
+void FQuantumClothPostPhysicsTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType,
+    ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (!IsValid(Target))
+    {
+        return;
+    }
+
+    Target->FinishTickJob();
+
+    // Every ApplyNegativeMassField call this frame, as one offset; the
+    // latest strength wins, as it would have applied serially
+    if (Target->bFieldPending)
+    {
+        Target->ActiveContract.NegativeMassInfluence = Target->PendingFieldStrength;
+        if (!Target->PendingFieldOffset.IsZero())
+        {
+            Target->AddActorWorldOffset(Target->PendingFieldOffset * Target->GetWorld()->GetDeltaSeconds());
+        }
+        Target->PendingFieldOffset = FVector::ZeroVector;
+        Target->bFieldPending = false;
+    }
+}
+
+FString FQuantumClothPostPhysicsTickFunction::DiagnosticMessage()
+{
+    return Target ? Target->GetFullName() + TEXT("[PostPhysicsTick]") : TEXT("<null>[PostPhysicsTick]");
+}
+
+// One frame of the anti-jitter and quantum field update; touches nothing
+// but its arguments, so it is safe on any thread
+void AQuantumClothSimulation::StepQuantumState(FQuantumTickState& State, const FVector& Location,
+    float JitterThreshold, float WorldDeltaSeconds, FRandomStream& Random)
+{
     // Anti-jitter logic
-    FVector CurrentPos = GetActorLocation();
-    float JitterDist = FVector::Dist(CurrentPos, LastStablePosition);
+    float JitterDist = FVector::Dist(Location, State.LastStablePosition);
     
     if (JitterDist < JitterThreshold)
     {
-        JitterSampleCount++;
-        if (JitterSampleCount > 5)
+        State.JitterSampleCount++;
+        if (State.JitterSampleCount > 5)
         {
-            LastStablePosition = CurrentPos;
-            JitterSampleCount = 0;
+            State.LastStablePosition = Location;
+            State.JitterSampleCount = 0;
         }
     }
     else
     {
-        JitterSampleCount = 0;
+        State.JitterSampleCount = 0;
     }
     
     // Process quantum state
-    StabilizeQuantumField();
+    StabilizeQuantumField(State, Random);
     
-    if (ActiveContract.NegativeMassInfluence > 0.0f)
+    if (State.Contract.NegativeMassInfluence > 0.0f)
     {
-        ProcessNegativeMassInteraction();
+        ProcessNegativeMassInteraction(State.Contract, WorldDeltaSeconds);
     }
 }
 
@@ -85,6 +189,9 @@ void AQuantumClothSimulation::SetUnixDetachFlags(const FString& Flags)
 
 void AQuantumClothSimulation::UpdateQuantumContract(const FQuantumContract& NewContract)
 {
+    // Settle any job in flight first, so its results cannot overwrite this
+    FinishTickJob();
+
     EQuantumState OldState = ActiveContract.CurrentState;
     ActiveContract = NewContract;
     
@@ -94,9 +201,12 @@ void AQuantumClothSimulation::UpdateQuantumContract(const FQuantumContract& NewC
     }
 }
 
+// Batched: calls within a frame are summed and applied in one pass by the
+// post-physics tick
 void AQuantumClothSimulation::ApplyNegativeMassField(FVector Location, float Strength)
 {
-    ActiveContract.NegativeMassInfluence = Strength;
+    PendingFieldStrength = Strength;
+    bFieldPending = true;
     
     // Direct coupling to negative mass system as specified
     if (ActiveContract.CurrentState == EQuantumState::OPEN)
@@ -106,12 +216,14 @@ void AQuantumClothSimulation::ApplyNegativeMassField(FVector Location, float Str
         Direction.Normalize();
         
         // Apply inverse force for negative mass interaction
-        AddActorWorldOffset(Direction * -Strength * GetWorld()->GetDeltaSeconds());
+        PendingFieldOffset += Direction * -Strength;
     }
 }
 
-void AQuantumClothSimulation::StabilizeQuantumField()
+void AQuantumClothSimulation::StabilizeQuantumField(FQuantumTickState& State, FRandomStream& Random)
 {
+    FQuantumContract& ActiveContract = State.Contract;
+
     switch (ActiveContract.CurrentState)
     {
         case EQuantumState::ISOLATED:
@@ -129,12 +241,12 @@ void AQuantumClothSimulation::StabilizeQuantumField()
             
         case EQuantumState::CLOSED:
             // System exchanges energy but not matter
-            ActiveContract.bIsStabilized = (JitterSampleCount > 3);
+            ActiveContract.bIsStabilized = (State.JitterSampleCount > 3);
             break;
             
         case EQuantumState::COLLAPSING:
             // Quantum field collapse in progress
-            if (FMath::FRand() < 0.1f) // Probabilistic collapse
+            if (Random.FRand() < 0.1f) // Probabilistic collapse
             {
                 ActiveContract.CurrentState = EQuantumState::CLOSED;
                 ActiveContract.bIsStabilized = false;
@@ -164,7 +276,7 @@ void AQuantumClothSimulation::HandleStateTransition(EQuantumState FromState, EQu
     }
 }
 
-void AQuantumClothSimulation::ProcessNegativeMassInteraction()
+void AQuantumClothSimulation::ProcessNegativeMassInteraction(FQuantumContract& ActiveContract, float WorldDeltaSeconds)
 {
     // As specified: "if there is a negative force mass system involved it must direct count"
     float InteractionStrength = ActiveContract.NegativeMassInfluence;
@@ -187,6 +299,6 @@ void AQuantumClothSimulation::ProcessNegativeMassInteraction()
     ActiveContract.NegativeMassInfluence = FMath::Lerp(
         ActiveContract.NegativeMassInfluence, 
         InteractionStrength, 
-        GetWorld()->GetDeltaSeconds()
+        WorldDeltaSeconds
     );
 }
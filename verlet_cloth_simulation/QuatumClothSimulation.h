@@ -5,6 +5,9 @@
 #include "GameFramework/Actor.h"
 #include "Engine/World.h"
 #include "Components/SceneComponent.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Math/RandomStream.h"
 #include "QuantumClothSimulation.generated.h"
 
 UENUM(BlueprintType)
@@ -34,6 +37,27 @@ struct FQuantumContract
     bool bIsStabilized = false;
 };
 
+class AQuantumClothSimulation;
+
+// Applies the results of an actor's quantum tick job after physics
+USTRUCT()
+struct FQuantumClothPostPhysicsTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    AQuantumClothSimulation* Target = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+        const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FQuantumClothPostPhysicsTickFunction> : public TStructOpsTypeTraitsBase2<FQuantumClothPostPhysicsTickFunction>
+{
+    enum { WithCopy = false };
+};
+
 UCLASS()
 class OBINEXUS_API AQuantumClothSimulation : public AActor
 {
@@ -58,7 +82,9 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
+    virtual void RegisterActorTickFunctions(bool bRegister) override;
 
     UPROPERTY(EditAnywhere, Category = "OBINexus|Config")
     bool bUseDetachMode = true;
@@ -70,12 +96,39 @@ protected:
     FQuantumContract ActiveContract;
 
 private:
-    void StabilizeQuantumField();
+    friend struct FQuantumClothPostPhysicsTickFunction;
+    friend class FQuantumClothTickJobTest;
+    friend class FQuantumClothFieldBatchTest;
+
+    // Contract and anti-jitter state advanced by one tick job
+    struct FQuantumTickState
+    {
+        FQuantumContract Contract;
+        FVector LastStablePosition;
+        int32 JitterSampleCount = 0;
+    };
+
+    static void StepQuantumState(FQuantumTickState& State, const FVector& Location, float JitterThreshold,
+        float WorldDeltaSeconds, FRandomStream& Random);
+    static void StabilizeQuantumField(FQuantumTickState& State, FRandomStream& Random);
+    static void ProcessNegativeMassInteraction(FQuantumContract& Contract, float WorldDeltaSeconds);
     void HandleStateTransition(EQuantumState FromState, EQuantumState ToState);
-    void ProcessNegativeMassInteraction();
+    void FinishTickJob();
 
     // Anti-jitter system
     FVector LastStablePosition;
     float JitterThreshold = 0.1f;
     int32 JitterSampleCount = 0;
+
+    // Tick job in flight: reads TickJobState only, which the post-physics
+    // tick copies back once the job completes
+    FQuantumClothPostPhysicsTickFunction PostPhysicsTick;
+    FGraphEventRef TickJob;
+    FQuantumTickState TickJobState;
+    FRandomStream QuantumRandom;
+
+    // ApplyNegativeMassField calls since the last post-physics tick
+    FVector PendingFieldOffset = FVector::ZeroVector;
+    float PendingFieldStrength = 0.0f;
+    bool bFieldPending = false;
 };
@@ -1,9 +1,16 @@
 // cloth_simulation.c - Cross-platform OBINexus Cloth Simulation
+#ifndef CLOTH_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 #include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
 
 // Cross-platform macros
 #ifdef _WIN32
@@ -15,67 +22,147 @@
     #define PLATFORM_UNIX
 #endif
 
+// The clock, sleeps and core count come from SDL in the windowed build.
+// The headless build (CLOTH_HEADLESS) has no SDL and asks the OS instead.
+#ifdef CLOTH_HEADLESS
+static inline uint64_t cloth_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t cloth_tick_rate(void) {
+    return 1000000000ULL;
+}
+
+static inline void cloth_delay_ms(uint32_t ms) {
+    struct timespec ts = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static inline int cloth_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+#else
+static inline uint64_t cloth_ticks(void) {
+    return SDL_GetPerformanceCounter();
+}
+
+static inline uint64_t cloth_tick_rate(void) {
+    return SDL_GetPerformanceFrequency();
+}
+
+static inline void cloth_delay_ms(uint32_t ms) {
+    SDL_Delay(ms);
+}
+
+static inline int cloth_cpu_count(void) {
+    return SDL_GetCPUCount();
+}
+#endif
+
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
 #define GRID_WIDTH 50
 #define GRID_HEIGHT 30
 #define PARTICLE_SPACING 15
+#define GRAVITY 980.0f
+#define CONSTRAINT_ITERATIONS 5    // Default; --iterations=N overrides
+#define SOLVER_REPORT_FRAMES 300
+#define PHYSICS_DT (1.0f / 60.0f)        // Fixed timestep for the physics thread and benchmark
+#define PHYSICS_MAX_LAG 5                // Steps the physics thread may fall behind before skipping
+#define COLLISION_DIAMETER 0.8f          // Self-collision distance, in grid spacings
+#define HASH_MIN_BUCKETS 64
+#define HASH_MAX_COUNTERS (1 << 25)      // Bucket counters over all hash-build threads
+#define MOUSE_RADIUS 20.0f
+#define CUT_RADIUS 8.0f
+#define TEAR_SETTLE_STEPS 600            // Untouched steps calibrate_tearing measures over
 
-// Function pointer types for physics laws
-typedef void (*ForceFunction)(void* particle, float dt);
-typedef float (*EnergyFunction)(void* particle, void** neighbors, int num_neighbors);
-typedef void (*ConstraintFunction)(void* particle1, void* particle2, float rest_length);
+// Optional physics, off by default: --tear and --self-collision
+#define CLOTH_TEARING 1
+#define CLOTH_SELF_COLLISION 2
+
+// SIMD integration paths; the scalar loop is written so compilers can
+// vectorise it where neither is enabled
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define CLOTH_SIMD_AVX2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define CLOTH_SIMD_NEON
+#endif
+
+typedef struct Material Material;
+typedef struct Cloth Cloth;
+
+// Function pointer types for physics laws. Each works on the whole cloth,
+// so the material is dispatched once per frame rather than per particle.
+typedef void (*IntegrateFunction)(Cloth* cloth, const Material* material, float dt);
+typedef float (*EnergyFunction)(const Cloth* cloth, const Material* material, int particle,
+                                const int* neighbors, int num_neighbors);
+typedef void (*ConstraintFunction)(Cloth* cloth, const Material* material);
 
 // Material properties with function pointers
-typedef struct {
+struct Material {
     float elasticity;
     float mass;
     float stiffness;
     float damping;
-    float tear_distance;
+    float tear_strain;          // Tears at this multiple of a link's hanging length
     float air_friction;
     float bend_stiffness;
-    ForceFunction apply_force;
+    IntegrateFunction integrate;
     EnergyFunction calc_energy;
-    ConstraintFunction solve_constraint;
-} Material;
+    ConstraintFunction solve_constraints;
+};
 
 typedef struct {
-    float x, y;
-    float old_x, old_y;
-    float vx, vy;
-    float force_x, force_y;
-    float mass;
-    bool locked;
-    void** neighbors;
-    int num_neighbors;
-    Material* material;
-} Particle;
-
-typedef struct {
-    Particle *p1, *p2;
+    int p1, p2;                 // Particle indices
     float rest_length;
     float strength;
 } Constraint;
 
+// Particles as structure of arrays: each field is contiguous, so the
+// integrator streams through memory and fills whole SIMD registers
+struct Cloth {
+    int width, height;
+    int count;
+    float spacing;
+    float *x, *y;
+    float *old_x, *old_y;
+    float *vx, *vy;
+    unsigned char* locked;      // Nonzero for particles pinned in place
+    unsigned char* torn_right;  // Nonzero once the link to particle i + 1 has torn
+    unsigned char* torn_down;   // Nonzero once the link to particle i + width has torn
+    float* tear_right_sq;       // Per row, squared length at which its links tear
+    float* tear_down_sq;
+    Constraint* constraints;
+    int num_constraints;
+};
+
 // Forward declarations of physics functions
-void apply_force_cotton(void* particle, float dt);
-void apply_force_silk(void* particle, float dt);
-void apply_force_denim(void* particle, float dt);
-float calc_energy_cotton(void* particle, void** neighbors, int num_neighbors);
-float calc_energy_silk(void* particle, void** neighbors, int num_neighbors);
-float calc_energy_denim(void* particle, void** neighbors, int num_neighbors);
-void solve_constraint_cotton(void* p1, void* p2, float rest_length);
-void solve_constraint_silk(void* p1, void* p2, float rest_length);
-void solve_constraint_denim(void* p1, void* p2, float rest_length);
-
-// Global variables
-Particle particles[GRID_WIDTH * GRID_HEIGHT];
-Constraint constraints[(GRID_WIDTH - 1) * GRID_HEIGHT + GRID_WIDTH * (GRID_HEIGHT - 1)];
+void integrate_cotton(Cloth* cloth, const Material* material, float dt);
+void integrate_silk(Cloth* cloth, const Material* material, float dt);
+void integrate_denim(Cloth* cloth, const Material* material, float dt);
+float calc_energy_cotton(const Cloth* cloth, const Material* material, int particle,
+                         const int* neighbors, int num_neighbors);
+float calc_energy_silk(const Cloth* cloth, const Material* material, int particle,
+                       const int* neighbors, int num_neighbors);
+float calc_energy_denim(const Cloth* cloth, const Material* material, int particle,
+                        const int* neighbors, int num_neighbors);
+void solve_constraints_cotton(Cloth* cloth, const Material* material);
+void solve_constraints_silk(Cloth* cloth, const Material* material);
+void solve_constraints_denim(Cloth* cloth, const Material* material);
+
+// Global variables. The mouse is written by the event loop and read by the
+// physics thread, so it is only accessed atomically.
+Cloth cloth;
 Material current_material;
-SDL_Point mouse = {0, 0};
-bool mouse_down = false;
-bool right_click = false;
+int cloth_features = 0;         // CLOTH_TEARING | CLOTH_SELF_COLLISION
+struct { int x, y; } mouse = {0, 0};
+int mouse_down = 0;             // Left button drags particles
+int right_click = 0;            // Right button cuts links
 
 // Define materials with their specific physics functions
 void init_materials() {
@@ -84,216 +171,1529 @@ void init_materials() {
         .mass = 1.0f,
         .stiffness = 0.8f,
         .damping = 0.99f,
-        .tear_distance = 25.0f,
+        .tear_strain = 1.5f,
         .air_friction = 0.02f,
         .bend_stiffness = 0.3f,
-        .apply_force = apply_force_cotton,
+        .integrate = integrate_cotton,
         .calc_energy = calc_energy_cotton,
-        .solve_constraint = solve_constraint_cotton
+        .solve_constraints = solve_constraints_cotton
     };
-    
+
     current_material = COTTON;
 }
 
-// Implementation of physics functions
-void apply_force_cotton(void* particle_ptr, float dt) {
-    Particle* p = (Particle*)particle_ptr;
-    if (p->locked) return;
+// Verlet step shared by every material. Gravity plus quadratic air drag,
+// velocity from the last two positions, then the stored velocity scaled
+// by velocity_scale. Locked particles keep all their state. Each material
+// calls this with a constant velocity_scale, so it is specialised and
+// inlined per material.
+static inline void integrate_kernel(Cloth* c, const Material* material, float dt,
+                                    float velocity_scale) {
+    if (dt <= 0.0f) return;
+    const float inv_dt = 1.0f / dt;
+    const float drag = material->air_friction / material->mass;    // Per unit speed squared
+    const float gravity = GRAVITY;                                  // F = m g, a = g
+    int i = 0;
 
-    const float GRAVITY = 980.0f;
-    
-    // Reset forces
-    p->force_x = 0;
-    p->force_y = GRAVITY * p->mass;
-    
-    // Air resistance
-    float speed = sqrtf(p->vx * p->vx + p->vy * p->vy);
-    if (speed > 0) {
-        float air_force = speed * speed * p->material->air_friction;
-        p->force_x -= (p->vx / speed) * air_force;
-        p->force_y -= (p->vy / speed) * air_force;
+#if defined(CLOTH_SIMD_AVX2)
+    const __m256 v_dt = _mm256_set1_ps(dt);
+    const __m256 v_inv_dt = _mm256_set1_ps(inv_dt);
+    const __m256 v_drag = _mm256_set1_ps(drag);
+    const __m256 v_gravity = _mm256_set1_ps(gravity);
+    const __m256 v_scale = _mm256_set1_ps(velocity_scale);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 8 <= c->count; i += 8) {
+        __m256 x = _mm256_loadu_ps(c->x + i), y = _mm256_loadu_ps(c->y + i);
+        __m256 ox = _mm256_loadu_ps(c->old_x + i), oy = _mm256_loadu_ps(c->old_y + i);
+        __m256 vx = _mm256_loadu_ps(c->vx + i), vy = _mm256_loadu_ps(c->vy + i);
+        __m256i lock8 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(c->locked + i)));
+        __m256 keep = _mm256_castsi256_ps(_mm256_cmpgt_epi32(lock8, zero));
+
+        // Drag opposes velocity with magnitude speed^2 * air_friction
+        __m256 speed_drag = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx),
+                                                                       _mm256_mul_ps(vy, vy))), v_drag);
+        __m256 ax = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(vx, speed_drag));
+        __m256 ay = _mm256_sub_ps(v_gravity, _mm256_mul_ps(vy, speed_drag));
+        __m256 nvx = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(x, ox), v_inv_dt), _mm256_mul_ps(ax, v_dt));
+        __m256 nvy = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(y, oy), v_inv_dt), _mm256_mul_ps(ay, v_dt));
+        __m256 nx = _mm256_add_ps(x, _mm256_mul_ps(nvx, v_dt));
+        __m256 ny = _mm256_add_ps(y, _mm256_mul_ps(nvy, v_dt));
+
+        _mm256_storeu_ps(c->x + i, _mm256_blendv_ps(nx, x, keep));
+        _mm256_storeu_ps(c->y + i, _mm256_blendv_ps(ny, y, keep));
+        _mm256_storeu_ps(c->old_x + i, _mm256_blendv_ps(x, ox, keep));
+        _mm256_storeu_ps(c->old_y + i, _mm256_blendv_ps(y, oy, keep));
+        _mm256_storeu_ps(c->vx + i, _mm256_blendv_ps(_mm256_mul_ps(nvx, v_scale), vx, keep));
+        _mm256_storeu_ps(c->vy + i, _mm256_blendv_ps(_mm256_mul_ps(nvy, v_scale), vy, keep));
     }
-    
-    // Update velocity and position
-    float ax = p->force_x / p->mass;
-    float ay = p->force_y / p->mass;
-    p->vx = (p->x - p->old_x) / dt + ax * dt;
-    p->vy = (p->y - p->old_y) / dt + ay * dt;
-    
-    float temp_x = p->x;
-    float temp_y = p->y;
-    p->x += p->vx * dt;
-    p->y += p->vy * dt;
-    p->old_x = temp_x;
-    p->old_y = temp_y;
+#elif defined(CLOTH_SIMD_NEON)
+    const float32x4_t v_drag = vdupq_n_f32(drag);
+    const float32x4_t v_gravity = vdupq_n_f32(gravity);
+    for (; i + 4 <= c->count; i += 4) {
+        float32x4_t x = vld1q_f32(c->x + i), y = vld1q_f32(c->y + i);
+        float32x4_t ox = vld1q_f32(c->old_x + i), oy = vld1q_f32(c->old_y + i);
+        float32x4_t vx = vld1q_f32(c->vx + i), vy = vld1q_f32(c->vy + i);
+        uint32_t lock[4] = { c->locked[i], c->locked[i + 1], c->locked[i + 2], c->locked[i + 3] };
+        uint32x4_t keep = vcgtq_u32(vld1q_u32(lock), vdupq_n_u32(0));
+
+        float32x4_t speed_drag = vmulq_f32(vsqrtq_f32(vmlaq_f32(vmulq_f32(vx, vx), vy, vy)), v_drag);
+        float32x4_t ax = vnegq_f32(vmulq_f32(vx, speed_drag));
+        float32x4_t ay = vmlsq_f32(v_gravity, vy, speed_drag);
+        float32x4_t nvx = vmlaq_n_f32(vmulq_n_f32(vsubq_f32(x, ox), inv_dt), ax, dt);
+        float32x4_t nvy = vmlaq_n_f32(vmulq_n_f32(vsubq_f32(y, oy), inv_dt), ay, dt);
+        float32x4_t nx = vmlaq_n_f32(x, nvx, dt);
+        float32x4_t ny = vmlaq_n_f32(y, nvy, dt);
+
+        vst1q_f32(c->x + i, vbslq_f32(keep, x, nx));
+        vst1q_f32(c->y + i, vbslq_f32(keep, y, ny));
+        vst1q_f32(c->old_x + i, vbslq_f32(keep, ox, x));
+        vst1q_f32(c->old_y + i, vbslq_f32(keep, oy, y));
+        vst1q_f32(c->vx + i, vbslq_f32(keep, vx, vmulq_n_f32(nvx, velocity_scale)));
+        vst1q_f32(c->vy + i, vbslq_f32(keep, vy, vmulq_n_f32(nvy, velocity_scale)));
+    }
+#endif
+
+    for (; i < c->count; i++) {
+        float x = c->x[i], y = c->y[i];
+        float vx = c->vx[i], vy = c->vy[i];
+        float speed_drag = sqrtf(vx * vx + vy * vy) * drag;
+        float ax = -vx * speed_drag;
+        float ay = gravity - vy * speed_drag;
+        float nvx = (x - c->old_x[i]) * inv_dt + ax * dt;
+        float nvy = (y - c->old_y[i]) * inv_dt + ay * dt;
+        bool keep = c->locked[i] != 0;
+
+        c->x[i] = keep ? x : x + nvx * dt;
+        c->y[i] = keep ? y : y + nvy * dt;
+        c->old_x[i] = keep ? c->old_x[i] : x;
+        c->old_y[i] = keep ? c->old_y[i] : y;
+        c->vx[i] = keep ? vx : nvx * velocity_scale;
+        c->vy[i] = keep ? vy : nvy * velocity_scale;
+    }
+}
+
+// Implementation of physics functions
+void integrate_cotton(Cloth* cloth, const Material* material, float dt) {
+    integrate_kernel(cloth, material, dt, 1.0f);
 }
 
 // Similar implementations for silk and denim
-void apply_force_silk(void* particle_ptr, float dt) {
-    Particle* p = (Particle*)particle_ptr;
-    apply_force_cotton(p, dt); // Base implementation with silk-specific adjustments
-    p->vx *= p->material->damping;
-    p->vy *= p->material->damping;
+void integrate_silk(Cloth* cloth, const Material* material, float dt) {
+    integrate_kernel(cloth, material, dt, material->damping);
 }
 
-void apply_force_denim(void* particle_ptr, float dt) {
-    Particle* p = (Particle*)particle_ptr;
-    apply_force_cotton(p, dt); // Base implementation with denim-specific adjustments
+void integrate_denim(Cloth* cloth, const Material* material, float dt) {
     // Add more resistance to movement
-    p->vx *= p->material->damping * 0.9f;
-    p->vy *= p->material->damping * 0.9f;
+    integrate_kernel(cloth, material, dt, material->damping * 0.9f);
 }
 
-float calc_energy_cotton(void* particle_ptr, void** neighbors, int num_neighbors) {
-    Particle* p = (Particle*)particle_ptr;
-    if (p->locked) return 0;
-    
-    float kinetic = 0.5f * p->mass * (p->vx * p->vx + p->vy * p->vy);
-    float potential = p->mass * 980.0f * p->y;
-    
+float calc_energy_cotton(const Cloth* cloth, const Material* material, int particle,
+                         const int* neighbors, int num_neighbors) {
+    if (cloth->locked[particle]) return 0;
+
+    float vx = cloth->vx[particle], vy = cloth->vy[particle];
+    float kinetic = 0.5f * material->mass * (vx * vx + vy * vy);
+    float potential = material->mass * GRAVITY * cloth->y[particle];
+
     // Add spring potential energy
     float spring = 0;
     for (int i = 0; i < num_neighbors; i++) {
-        Particle* n = (Particle*)neighbors[i];
-        float dx = n->x - p->x;
-        float dy = n->y - p->y;
+        float dx = cloth->x[neighbors[i]] - cloth->x[particle];
+        float dy = cloth->y[neighbors[i]] - cloth->y[particle];
         float dist = sqrtf(dx * dx + dy * dy);
-        spring += 0.5f * p->material->stiffness * (dist - PARTICLE_SPACING) * (dist - PARTICLE_SPACING);
+        spring += 0.5f * material->stiffness * (dist - cloth->spacing) * (dist - cloth->spacing);
     }
-    
+
     return kinetic + potential + spring;
 }
 
 // Similar energy calculations for silk and denim
-float calc_energy_silk(void* particle_ptr, void** neighbors, int num_neighbors) {
-    return calc_energy_cotton(particle_ptr, neighbors, num_neighbors) * 0.8f;
+float calc_energy_silk(const Cloth* cloth, const Material* material, int particle,
+                       const int* neighbors, int num_neighbors) {
+    return calc_energy_cotton(cloth, material, particle, neighbors, num_neighbors) * 0.8f;
 }
 
-float calc_energy_denim(void* particle_ptr, void** neighbors, int num_neighbors) {
-    return calc_energy_cotton(particle_ptr, neighbors, num_neighbors) * 1.2f;
+float calc_energy_denim(const Cloth* cloth, const Material* material, int particle,
+                        const int* neighbors, int num_neighbors) {
+    return calc_energy_cotton(cloth, material, particle, neighbors, num_neighbors) * 1.2f;
 }
 
-void solve_constraint_cotton(void* p1_ptr, void* p2_ptr, float rest_length) {
-    Particle* p1 = (Particle*)p1_ptr;
-    Particle* p2 = (Particle*)p2_ptr;
-    
-    float dx = p2->x - p1->x;
-    float dy = p2->y - p1->y;
+// Parallel constraint solver. The grid's structural constraints split
+// into four colours whose members share no particle: horizontal links
+// starting at even columns, then odd columns, then vertical links from
+// even rows, then odd rows. Each colour is solved in one sweep with SIMD
+// across constraints and rows shared out between threads; a barrier
+// separates the colours. Rest lengths are uniform (the grid spacing).
+// The same worker pool runs the spatial hash, self-collision and tearing
+// passes; each is a task that every participant runs on its own share.
+
+// Barrier for the solver threads: spins briefly, since colours are short,
+// then sleeps. The count can shrink if fewer workers start than asked for.
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int count;
+    int arrived;
+    unsigned generation;
+} SolverBarrier;
+
+static void solver_barrier_init(SolverBarrier* b, int count) {
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->count = count;
+    b->arrived = 0;
+    b->generation = 0;
+}
+
+static void solver_barrier_destroy(SolverBarrier* b) {
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->cond);
+}
+
+// Caller holds the lock
+static void solver_barrier_release(SolverBarrier* b) {
+    b->arrived = 0;
+    __atomic_store_n(&b->generation, b->generation + 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&b->cond);
+}
+
+static void solver_barrier_wait(SolverBarrier* b) {
+    pthread_mutex_lock(&b->lock);
+    unsigned generation = b->generation;
+    if (++b->arrived >= b->count) {
+        solver_barrier_release(b);
+        pthread_mutex_unlock(&b->lock);
+        return;
+    }
+    pthread_mutex_unlock(&b->lock);
+
+    for (int spin = 0; spin < 4096; spin++) {
+        if (__atomic_load_n(&b->generation, __ATOMIC_ACQUIRE) != generation) return;
+    }
+    pthread_mutex_lock(&b->lock);
+    while (b->generation == generation) {
+        pthread_cond_wait(&b->cond, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+static void solver_barrier_resize(SolverBarrier* b, int count) {
+    pthread_mutex_lock(&b->lock);
+    b->count = count;
+    if (b->arrived > 0 && b->arrived >= count) solver_barrier_release(b);
+    pthread_mutex_unlock(&b->lock);
+}
+
+typedef struct ConstraintSolver ConstraintSolver;
+typedef void (*SolverTask)(ConstraintSolver* s, int id);
+
+struct ConstraintSolver {
+    int iterations;             // Relaxation passes per frame
+    int threads;                // Participants, including the calling thread
+    pthread_t* workers;
+    SolverBarrier barrier;
+    bool quit;
+
+    // Pass in progress, published to the workers by the start barrier
+    SolverTask task;
+    Cloth* cloth;
+    float rest;
+    float share;
+
+    double* iteration_ms;       // Per pass, summed since the last report
+    int timed_frames;
+};
+
+ConstraintSolver solver;
+
+// Branch-free single constraint; the SIMD paths follow the same steps.
+// A torn link still runs but applies no correction.
+static inline void solve_link(Cloth* c, int i1, int i2, unsigned char torn, float rest, float share) {
+    float dx = c->x[i2] - c->x[i1];
+    float dy = c->y[i2] - c->y[i1];
     float dist = sqrtf(dx * dx + dy * dy);
-    
-    if (dist > 0.0001f) {
-        float diff = (dist - rest_length) / dist;
-        
-        if (!p1->locked) {
-            p1->x += dx * diff * 0.5f * p1->material->elasticity;
-            p1->y += dy * diff * 0.5f * p1->material->elasticity;
+    float diff = dist > 0.0001f ? (dist - rest) / dist * share : 0.0f;
+    diff *= torn ? 0.0f : 1.0f;
+    float free1 = c->locked[i1] ? 0.0f : 1.0f;
+    float free2 = c->locked[i2] ? 0.0f : 1.0f;
+
+    c->x[i1] += dx * diff * free1;
+    c->y[i1] += dy * diff * free1;
+    c->x[i2] -= dx * diff * free2;
+    c->y[i2] -= dy * diff * free2;
+}
+
+#if defined(CLOTH_SIMD_AVX2)
+static inline __m256 free_mask8(__m128i locked_bytes, __m256 one) {
+    __m256i locked = _mm256_cvtepu8_epi32(locked_bytes);
+    __m256 pinned = _mm256_castsi256_ps(_mm256_cmpgt_epi32(locked, _mm256_setzero_si256()));
+    return _mm256_andnot_ps(pinned, one);
+}
+
+static inline void solve_links8(__m256* x1, __m256* y1, __m256* x2, __m256* y2,
+                                __m256 free1, __m256 free2, __m256 live,
+                                __m256 rest, __m256 share) {
+    __m256 dx = _mm256_sub_ps(*x2, *x1);
+    __m256 dy = _mm256_sub_ps(*y2, *y1);
+    __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+    __m256 valid = _mm256_cmp_ps(dist, _mm256_set1_ps(0.0001f), _CMP_GT_OQ);
+    __m256 diff = _mm256_and_ps(valid, _mm256_mul_ps(_mm256_div_ps(_mm256_sub_ps(dist, rest), dist), share));
+    diff = _mm256_mul_ps(diff, live);
+    __m256 cx = _mm256_mul_ps(dx, diff), cy = _mm256_mul_ps(dy, diff);
+    *x1 = _mm256_add_ps(*x1, _mm256_mul_ps(cx, free1));
+    *y1 = _mm256_add_ps(*y1, _mm256_mul_ps(cy, free1));
+    *x2 = _mm256_sub_ps(*x2, _mm256_mul_ps(cx, free2));
+    *y2 = _mm256_sub_ps(*y2, _mm256_mul_ps(cy, free2));
+}
+
+// p[0..16) as its even and odd elements, and back
+static inline void load_pairs8(const float* p, __m256* even, __m256* odd) {
+    __m256 a = _mm256_loadu_ps(p), b = _mm256_loadu_ps(p + 8);
+    __m256 e = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 o = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    *even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(e), _MM_SHUFFLE(3, 1, 2, 0)));
+    *odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(o), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+static inline void store_pairs8(float* p, __m256 even, __m256 odd) {
+    __m256 e = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+    __m256 o = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_ps(p, _mm256_unpacklo_ps(e, o));
+    _mm256_storeu_ps(p + 8, _mm256_unpackhi_ps(e, o));
+}
+#elif defined(CLOTH_SIMD_NEON)
+static inline float32x4_t free_mask4(const unsigned char* locked, int stride) {
+    uint32_t lock[4] = { locked[0], locked[stride], locked[2 * stride], locked[3 * stride] };
+    uint32x4_t pinned = vcgtq_u32(vld1q_u32(lock), vdupq_n_u32(0));
+    return vbslq_f32(pinned, vdupq_n_f32(0.0f), vdupq_n_f32(1.0f));
+}
+
+static inline void solve_links4(float32x4_t* x1, float32x4_t* y1, float32x4_t* x2, float32x4_t* y2,
+                                float32x4_t free1, float32x4_t free2, float32x4_t live,
+                                float rest, float share) {
+    float32x4_t dx = vsubq_f32(*x2, *x1);
+    float32x4_t dy = vsubq_f32(*y2, *y1);
+    float32x4_t dist = vsqrtq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy));
+    uint32x4_t valid = vcgtq_f32(dist, vdupq_n_f32(0.0001f));
+    float32x4_t diff = vmulq_n_f32(vdivq_f32(vsubq_f32(dist, vdupq_n_f32(rest)), dist), share);
+    diff = vmulq_f32(vbslq_f32(valid, diff, vdupq_n_f32(0.0f)), live);
+    float32x4_t cx = vmulq_f32(dx, diff), cy = vmulq_f32(dy, diff);
+    *x1 = vmlaq_f32(*x1, cx, free1);
+    *y1 = vmlaq_f32(*y1, cy, free1);
+    *x2 = vmlsq_f32(*x2, cx, free2);
+    *y2 = vmlsq_f32(*y2, cy, free2);
+}
+#endif
+
+// Horizontal links (x, x + 1) with x of the given parity, in rows [begin, end)
+static void solve_horizontal(Cloth* c, int begin, int end, int parity, float rest, float share) {
+    for (int row = begin; row < end; row++) {
+        int base = row * c->width;
+        int x = parity;
+#if defined(CLOTH_SIMD_AVX2)
+        const __m256 v_rest = _mm256_set1_ps(rest), v_share = _mm256_set1_ps(share);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        for (; x + 16 <= c->width; x += 16) {
+            int i = base + x;
+            __m256 x1, x2, y1, y2;
+            load_pairs8(c->x + i, &x1, &x2);
+            load_pairs8(c->y + i, &y1, &y2);
+            __m128i locks = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(c->locked + i)), split);
+            __m256 free1 = free_mask8(locks, one);
+            __m256 free2 = free_mask8(_mm_srli_si128(locks, 8), one);
+            __m128i torn = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(c->torn_right + i)), split);
+            __m256 live = free_mask8(torn, one);
+            solve_links8(&x1, &y1, &x2, &y2, free1, free2, live, v_rest, v_share);
+            store_pairs8(c->x + i, x1, x2);
+            store_pairs8(c->y + i, y1, y2);
         }
-        if (!p2->locked) {
-            p2->x -= dx * diff * 0.5f * p2->material->elasticity;
-            p2->y -= dy * diff * 0.5f * p2->material->elasticity;
+#elif defined(CLOTH_SIMD_NEON)
+        for (; x + 8 <= c->width; x += 8) {
+            int i = base + x;
+            float32x4x2_t px = vld2q_f32(c->x + i), py = vld2q_f32(c->y + i);
+            float32x4_t free1 = free_mask4(c->locked + i, 2);
+            float32x4_t free2 = free_mask4(c->locked + i + 1, 2);
+            float32x4_t live = free_mask4(c->torn_right + i, 2);
+            solve_links4(&px.val[0], &py.val[0], &px.val[1], &py.val[1], free1, free2, live, rest, share);
+            vst2q_f32(c->x + i, px);
+            vst2q_f32(c->y + i, py);
+        }
+#endif
+        for (; x + 1 < c->width; x += 2) {
+            solve_link(c, base + x, base + x + 1, c->torn_right[base + x], rest, share);
         }
     }
 }
 
+// Vertical links between row and row + 1; both rows are contiguous
+static void solve_vertical(Cloth* c, int row, float rest, float share) {
+    int top = row * c->width, bottom = top + c->width;
+    int x = 0;
+#if defined(CLOTH_SIMD_AVX2)
+    const __m256 v_rest = _mm256_set1_ps(rest), v_share = _mm256_set1_ps(share);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (; x + 8 <= c->width; x += 8) {
+        __m256 x1 = _mm256_loadu_ps(c->x + top + x), y1 = _mm256_loadu_ps(c->y + top + x);
+        __m256 x2 = _mm256_loadu_ps(c->x + bottom + x), y2 = _mm256_loadu_ps(c->y + bottom + x);
+        __m256 free1 = free_mask8(_mm_loadl_epi64((const __m128i*)(c->locked + top + x)), one);
+        __m256 free2 = free_mask8(_mm_loadl_epi64((const __m128i*)(c->locked + bottom + x)), one);
+        __m256 live = free_mask8(_mm_loadl_epi64((const __m128i*)(c->torn_down + top + x)), one);
+        solve_links8(&x1, &y1, &x2, &y2, free1, free2, live, v_rest, v_share);
+        _mm256_storeu_ps(c->x + top + x, x1);
+        _mm256_storeu_ps(c->y + top + x, y1);
+        _mm256_storeu_ps(c->x + bottom + x, x2);
+        _mm256_storeu_ps(c->y + bottom + x, y2);
+    }
+#elif defined(CLOTH_SIMD_NEON)
+    for (; x + 4 <= c->width; x += 4) {
+        float32x4_t x1 = vld1q_f32(c->x + top + x), y1 = vld1q_f32(c->y + top + x);
+        float32x4_t x2 = vld1q_f32(c->x + bottom + x), y2 = vld1q_f32(c->y + bottom + x);
+        float32x4_t free1 = free_mask4(c->locked + top + x, 1);
+        float32x4_t free2 = free_mask4(c->locked + bottom + x, 1);
+        float32x4_t live = free_mask4(c->torn_down + top + x, 1);
+        solve_links4(&x1, &y1, &x2, &y2, free1, free2, live, rest, share);
+        vst1q_f32(c->x + top + x, x1);
+        vst1q_f32(c->y + top + x, y1);
+        vst1q_f32(c->x + bottom + x, x2);
+        vst1q_f32(c->y + bottom + x, y2);
+    }
+#endif
+    for (; x < c->width; x++) {
+        solve_link(c, top + x, bottom + x, c->torn_down[top + x], rest, share);
+    }
+}
+
+// This participant's share of each colour, with a barrier after each
+static void solve_colours(ConstraintSolver* s, int id) {
+    Cloth* c = s->cloth;
+    int rows_begin = c->height * id / s->threads;
+    int rows_end = c->height * (id + 1) / s->threads;
+    int links_begin = (c->height - 1) * id / s->threads;
+    int links_end = (c->height - 1) * (id + 1) / s->threads;
+
+    for (int parity = 0; parity < 2; parity++) {
+        solve_horizontal(c, rows_begin, rows_end, parity, s->rest, s->share);
+        if (s->threads > 1) solver_barrier_wait(&s->barrier);
+    }
+    for (int parity = 0; parity < 2; parity++) {
+        for (int row = links_begin; row < links_end; row++) {
+            if ((row & 1) == parity) solve_vertical(c, row, s->rest, s->share);
+        }
+        if (s->threads > 1) solver_barrier_wait(&s->barrier);
+    }
+}
+
+static void* solver_worker(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (;;) {
+        solver_barrier_wait(&solver.barrier);      // Start of a pass
+        if (solver.quit) return NULL;
+        solver.task(&solver, id);
+    }
+}
+
+static inline void solver_sync(ConstraintSolver* s) {
+    if (s->threads > 1) solver_barrier_wait(&s->barrier);
+}
+
+// Runs task on every participant; tasks end with a barrier, so all of
+// them have finished when this returns
+static void run_solver_task(SolverTask task, Cloth* c) {
+    solver.task = task;
+    solver.cloth = c;
+    solver_sync(&solver);                           // Start the workers
+    task(&solver, 0);
+}
+
+bool init_solver(int iterations, int threads) {
+    memset(&solver, 0, sizeof(solver));
+    solver.iterations = iterations;
+    solver.threads = threads;
+    solver.iteration_ms = calloc((size_t)iterations, sizeof(double));
+    if (!solver.iteration_ms) return false;
+    if (threads == 1) return true;
+
+    solver.workers = calloc((size_t)threads - 1, sizeof(pthread_t));
+    if (!solver.workers) {
+        free(solver.iteration_ms);
+        return false;
+    }
+    solver_barrier_init(&solver.barrier, threads);
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&solver.workers[i - 1], NULL, solver_worker, (void*)(intptr_t)i) != 0) {
+            // Carry on with the workers that did start
+            fprintf(stderr, "[OBINexus] Constraint solver limited to %d thread(s)\n", i);
+            solver.threads = i;
+            solver_barrier_resize(&solver.barrier, i);
+            break;
+        }
+    }
+    return true;
+}
+
+void free_solver(void) {
+    if (solver.threads > 1) {
+        solver.quit = true;
+        solver_barrier_wait(&solver.barrier);
+        for (int i = 0; i < solver.threads - 1; i++) {
+            pthread_join(solver.workers[i], NULL);
+        }
+    }
+    if (solver.workers) {
+        solver_barrier_destroy(&solver.barrier);
+    }
+    free(solver.workers);
+    free(solver.iteration_ms);
+    memset(&solver, 0, sizeof(solver));
+}
+
+// One relaxation pass over every constraint
+static inline void solve_constraints_kernel(Cloth* c, const Material* material, float rest_scale) {
+    solver.rest = c->spacing * rest_scale;
+    solver.share = 0.5f * material->elasticity;
+    run_solver_task(solve_colours, c);
+}
+
+void solve_constraints_cotton(Cloth* cloth, const Material* material) {
+    solve_constraints_kernel(cloth, material, 1.0f);
+}
+
 // Similar constraint solvers for silk and denim
-void solve_constraint_silk(void* p1_ptr, void* p2_ptr, float rest_length) {
-    solve_constraint_cotton(p1_ptr, p2_ptr, rest_length);
+void solve_constraints_silk(Cloth* cloth, const Material* material) {
+    solve_constraints_kernel(cloth, material, 1.0f);
+}
+
+void solve_constraints_denim(Cloth* cloth, const Material* material) {
+    solve_constraints_kernel(cloth, material, 0.9f);
+}
+
+// Uniform-grid spatial hash over particle positions, rebuilt each step
+// with a parallel counting sort: every participant counts its particles
+// per bucket, the counts are prefix-summed bucket-major, then each
+// participant scatters its particles in index order. The result is the
+// same for any thread count. Positions are scattered alongside, so
+// queries read buckets contiguously. Cells are one collision diameter
+// wide, so a particle's contacts lie in its 3x3 block of cells. Cells map
+// to buckets row-major with a power-of-two row stride, wrapped to the
+// table, so each row of that block is three adjacent buckets. Distinct
+// cells can share a bucket, so queries still check distances.
+typedef struct {
+    float cell_size;
+    float inv_cell;
+    int buckets;                // Power of two, at least HASH_MIN_BUCKETS
+    int stride;                 // Buckets per cell row; power of two
+    int* key;                   // Bucket of each particle
+    int* sorted;                // Particles grouped by bucket
+    float* sorted_x;            // Their positions, in the same order
+    float* sorted_y;
+    int* start;                 // buckets + 1 offsets into sorted
+    int* counts;                // Per participant and bucket; then scatter cursors
+    int* block_total;           // Per participant: particles in its bucket block
+    float* push_x;              // Self-collision correction per particle
+    float* push_y;
+} SpatialHash;
+
+SpatialHash spatial_hash;
+
+static inline int hash_cell(const SpatialHash* h, int cx, int cy) {
+    return (int)(((unsigned)cx + (unsigned)cy * (unsigned)h->stride) & (unsigned)(h->buckets - 1));
+}
+
+static inline int cell_coord(const SpatialHash* h, float v) {
+    return (int)floorf(v * h->inv_cell);
+}
+
+void free_spatial_hash(SpatialHash* h) {
+    free(h->key);
+    free(h->sorted);
+    free(h->sorted_x);
+    free(h->sorted_y);
+    free(h->start);
+    free(h->counts);
+    free(h->block_total);
+    free(h->push_x);
+    free(h->push_y);
+    memset(h, 0, sizeof(*h));
+}
+
+bool init_spatial_hash(SpatialHash* h, const Cloth* c, int threads) {
+    memset(h, 0, sizeof(*h));
+    h->cell_size = c->spacing * COLLISION_DIAMETER;
+    h->inv_cell = 1.0f / h->cell_size;
+
+    // About one bucket per particle, within the counter budget
+    h->buckets = 1;
+    while (h->buckets < c->count) h->buckets <<= 1;
+    while (h->buckets > HASH_MIN_BUCKETS && (size_t)h->buckets * threads > HASH_MAX_COUNTERS) {
+        h->buckets >>= 1;
+    }
+    if (h->buckets < HASH_MIN_BUCKETS) h->buckets = HASH_MIN_BUCKETS;
+
+    // Square-ish table; with at least 64 buckets the nine buckets of a
+    // 3x3 block are distinct
+    h->stride = 1;
+    while (h->stride * h->stride < h->buckets) h->stride <<= 1;
+
+    size_t n = (size_t)c->count;
+    h->key = malloc(n * sizeof(int));
+    h->sorted = malloc(n * sizeof(int));
+    h->sorted_x = malloc(n * sizeof(float));
+    h->sorted_y = malloc(n * sizeof(float));
+    h->start = malloc(((size_t)h->buckets + 1) * sizeof(int));
+    h->counts = malloc((size_t)h->buckets * threads * sizeof(int));
+    h->block_total = malloc((size_t)threads * sizeof(int));
+    h->push_x = malloc(n * sizeof(float));
+    h->push_y = malloc(n * sizeof(float));
+    if (!h->key || !h->sorted || !h->sorted_x || !h->sorted_y || !h->start || !h->counts || !h->block_total ||
+        !h->push_x || !h->push_y) {
+        free_spatial_hash(h);
+        return false;
+    }
+    return true;
+}
+
+static void build_hash_task(ConstraintSolver* s, int id) {
+    SpatialHash* h = &spatial_hash;
+    const Cloth* c = s->cloth;
+    int begin = (int)((long long)c->count * id / s->threads);
+    int end = (int)((long long)c->count * (id + 1) / s->threads);
+    int* counts = h->counts + (size_t)id * h->buckets;
+
+    memset(counts, 0, (size_t)h->buckets * sizeof(int));
+    for (int i = begin; i < end; i++) {
+        int k = hash_cell(h, cell_coord(h, c->x[i]), cell_coord(h, c->y[i]));
+        h->key[i] = k;
+        counts[k]++;
+    }
+    solver_sync(s);
+
+    // Each participant prefix-sums a block of buckets across all counters
+    int bucket_begin = (int)((long long)h->buckets * id / s->threads);
+    int bucket_end = (int)((long long)h->buckets * (id + 1) / s->threads);
+    int total = 0;
+    for (int b = bucket_begin; b < bucket_end; b++) {
+        for (int t = 0; t < s->threads; t++) total += h->counts[(size_t)t * h->buckets + b];
+    }
+    h->block_total[id] = total;
+    solver_sync(s);
+
+    int offset = 0;
+    for (int t = 0; t < id; t++) offset += h->block_total[t];
+    for (int b = bucket_begin; b < bucket_end; b++) {
+        h->start[b] = offset;
+        for (int t = 0; t < s->threads; t++) {
+            int* count = &h->counts[(size_t)t * h->buckets + b];
+            int n = *count;
+            *count = offset;
+            offset += n;
+        }
+    }
+    if (id == s->threads - 1) h->start[h->buckets] = c->count;
+    solver_sync(s);
+
+    for (int i = begin; i < end; i++) {
+        int q = counts[h->key[i]]++;
+        h->sorted[q] = i;
+        h->sorted_x[q] = c->x[i];
+        h->sorted_y[q] = c->y[i];
+    }
+    solver_sync(s);
+}
+
+// Pushes sorted particle p away from sorted particles [from, to) closer
+// than a collision diameter, half the overlap each
+static inline void add_pushes(const SpatialHash* h, int p, int from, int to,
+                              float* push_x, float* push_y) {
+    const float diameter = h->cell_size;
+    float xi = h->sorted_x[p], yi = h->sorted_y[p];
+    for (int q = from; q < to; q++) {
+        float dx = xi - h->sorted_x[q], dy = yi - h->sorted_y[q];
+        float d2 = dx * dx + dy * dy;
+        if (q == p || d2 >= diameter * diameter || d2 < 1e-12f) continue;
+        float dist = sqrtf(d2);
+        float f = 0.5f * (diameter - dist) / dist;
+        *push_x += dx * f;
+        *push_y += dy * f;
+    }
+}
+
+// Jacobi self-collision: each free particle sums pushes away from every
+// particle closer than a collision diameter, then all pushes are applied
+// together, so no two participants write the same particle. Particles are
+// visited in bucket order, so neighbouring queries share cached buckets.
+static void collide_task(ConstraintSolver* s, int id) {
+    SpatialHash* h = &spatial_hash;
+    Cloth* c = s->cloth;
+    int begin = (int)((long long)c->count * id / s->threads);
+    int end = (int)((long long)c->count * (id + 1) / s->threads);
+
+    for (int p = begin; p < end; p++) {
+        int i = h->sorted[p];
+        float push_x = 0.0f, push_y = 0.0f;
+        if (!c->locked[i]) {
+            int cx = cell_coord(h, h->sorted_x[p]), cy = cell_coord(h, h->sorted_y[p]);
+            for (int oy = -1; oy <= 1; oy++) {
+                int first = hash_cell(h, cx - 1, cy + oy);
+                int last = hash_cell(h, cx + 1, cy + oy);
+                if (first < last) {
+                    add_pushes(h, p, h->start[first], h->start[last + 1], &push_x, &push_y);
+                } else {
+                    // The row wraps around the end of the table
+                    for (int b = 0; b < 3; b++) {
+                        int k = (first + b) & (h->buckets - 1);
+                        add_pushes(h, p, h->start[k], h->start[k + 1], &push_x, &push_y);
+                    }
+                }
+            }
+        }
+        h->push_x[i] = push_x;
+        h->push_y[i] = push_y;
+    }
+    solver_sync(s);
+
+    for (int i = begin; i < end; i++) {
+        c->x[i] += h->push_x[i];
+        c->y[i] += h->push_y[i];
+    }
+    solver_sync(s);
+}
+
+// Tears links stretched past their row's tear length. Each link belongs to
+// the row of its first particle, so rows are shared out as in the solver.
+static void tear_task(ConstraintSolver* s, int id) {
+    Cloth* c = s->cloth;
+    int rows_begin = c->height * id / s->threads;
+    int rows_end = c->height * (id + 1) / s->threads;
+
+    for (int row = rows_begin; row < rows_end; row++) {
+        const float limit_right = c->tear_right_sq[row], limit_down = c->tear_down_sq[row];
+        for (int x = 0; x < c->width; x++) {
+            int i = row * c->width + x;
+            if (x + 1 < c->width) {
+                float dx = c->x[i + 1] - c->x[i], dy = c->y[i + 1] - c->y[i];
+                c->torn_right[i] |= dx * dx + dy * dy > limit_right;
+            }
+            if (row + 1 < c->height) {
+                float dx = c->x[i + c->width] - c->x[i], dy = c->y[i + c->width] - c->y[i];
+                c->torn_down[i] |= dx * dx + dy * dy > limit_down;
+            }
+        }
+    }
+    solver_sync(s);
+}
+
+void build_spatial_hash(Cloth* c) {
+    run_solver_task(build_hash_task, c);
+}
+
+void collide_cloth(Cloth* c) {
+    run_solver_task(collide_task, c);
+}
+
+void tear_cloth(Cloth* c) {
+    run_solver_task(tear_task, c);
+}
+
+// Tearing is measured against how far the solver lets each row's links
+// stretch while the cloth just hangs, not against the rest length: the
+// upper rows carry the weight below them, and a relaxation solver leaves
+// them well past rest (about 1.7 times at the default 50x30 grid and five
+// iterations, more with taller grids or fewer iterations). The untouched
+// cloth runs for TEAR_SETTLE_STEPS on its own state, which is restored
+// afterwards, and each row keeps the longest link it reached, at least
+// the rest length; a link tears at material->tear_strain times that.
+// Call once the solver is running, before the first step.
+bool calibrate_tearing(Cloth* c, const Material* material) {
+    size_t n = (size_t)c->count * sizeof(float);
+    float* saved = malloc(6 * n);
+    if (!saved) return false;
+    float* const state[6] = { c->x, c->y, c->old_x, c->old_y, c->vx, c->vy };
+    for (int k = 0; k < 6; k++) memcpy((char*)saved + k * n, state[k], n);
+
+    const float rest_sq = c->spacing * c->spacing;
+    for (int row = 0; row < c->height; row++) {
+        c->tear_right_sq[row] = c->tear_down_sq[row] = rest_sq;
+    }
+    for (int step = 0; step < TEAR_SETTLE_STEPS; step++) {
+        material->integrate(c, material, PHYSICS_DT);
+        for (int j = 0; j < solver.iterations; j++) material->solve_constraints(c, material);
+        for (int row = 0; row < c->height; row++) {
+            for (int x = 0; x < c->width; x++) {
+                int i = row * c->width + x;
+                if (x + 1 < c->width) {
+                    float dx = c->x[i + 1] - c->x[i], dy = c->y[i + 1] - c->y[i];
+                    c->tear_right_sq[row] = fmaxf(c->tear_right_sq[row], dx * dx + dy * dy);
+                }
+                if (row + 1 < c->height) {
+                    float dx = c->x[i + c->width] - c->x[i], dy = c->y[i + c->width] - c->y[i];
+                    c->tear_down_sq[row] = fmaxf(c->tear_down_sq[row], dx * dx + dy * dy);
+                }
+            }
+        }
+    }
+
+    const float strain_sq = material->tear_strain * material->tear_strain;
+    for (int row = 0; row < c->height; row++) {
+        c->tear_right_sq[row] *= strain_sq;
+        c->tear_down_sq[row] *= strain_sq;
+    }
+    for (int k = 0; k < 6; k++) memcpy(state[k], (char*)saved + k * n, n);
+    free(saved);
+    return true;
 }
 
-void solve_constraint_denim(void* p1_ptr, void* p2_ptr, float rest_length) {
-    solve_constraint_cotton(p1_ptr, p2_ptr, rest_length * 0.9f);
+// Mean time of each relaxation pass over the frames since the last report
+void report_solver_timing(void) {
+    printf("[OBINexus] Solver ms/iteration over %d frames:", solver.timed_frames);
+    for (int j = 0; j < solver.iterations; j++) {
+        printf(" %.3f", solver.iteration_ms[j] / solver.timed_frames);
+        solver.iteration_ms[j] = 0.0;
+    }
+    printf("\n");
+    solver.timed_frames = 0;
+}
+
+void free_cloth(Cloth* c) {
+    free(c->x);
+    free(c->y);
+    free(c->old_x);
+    free(c->old_y);
+    free(c->vx);
+    free(c->vy);
+    free(c->locked);
+    free(c->torn_right);
+    free(c->torn_down);
+    free(c->tear_right_sq);
+    free(c->tear_down_sq);
+    free(c->constraints);
+    memset(c, 0, sizeof(*c));
+}
+
+bool init_cloth(Cloth* c, int width, int height) {
+    memset(c, 0, sizeof(*c));
+    if (width < 2 || height < 2 || width > 4096 || height > 4096) return false;
+    c->width = width;
+    c->height = height;
+    c->count = width * height;
+
+    // Keep the default spacing for grids that fit, shrink it for larger ones
+    c->spacing = PARTICLE_SPACING;
+    float fit_x = (SCREEN_WIDTH - 40.0f) / (width - 1);
+    float fit_y = (SCREEN_HEIGHT - 40.0f) / (height - 1);
+    if (fit_x < c->spacing) c->spacing = fit_x;
+    if (fit_y < c->spacing) c->spacing = fit_y;
+
+    size_t n = (size_t)c->count;
+    c->x = malloc(n * sizeof(float));
+    c->y = malloc(n * sizeof(float));
+    c->old_x = malloc(n * sizeof(float));
+    c->old_y = malloc(n * sizeof(float));
+    c->vx = calloc(n, sizeof(float));
+    c->vy = calloc(n, sizeof(float));
+    c->locked = calloc(n, 1);
+    c->torn_right = calloc(n, 1);
+    c->torn_down = calloc(n, 1);
+    c->tear_right_sq = calloc((size_t)height, sizeof(float));
+    c->tear_down_sq = calloc((size_t)height, sizeof(float));
+    c->num_constraints = (width - 1) * height + width * (height - 1);
+    c->constraints = malloc((size_t)c->num_constraints * sizeof(Constraint));
+    if (!c->x || !c->y || !c->old_x || !c->old_y || !c->vx || !c->vy ||
+        !c->locked || !c->torn_right || !c->torn_down || !c->tear_right_sq ||
+        !c->tear_down_sq || !c->constraints) {
+        free_cloth(c);
+        return false;
+    }
+    return true;
 }
 
 void init_particles() {
     // Calculate starting position to center the cloth
-    float start_x = (SCREEN_WIDTH - (GRID_WIDTH - 1) * PARTICLE_SPACING) / 2;
-    float start_y = (SCREEN_HEIGHT - (GRID_HEIGHT - 1) * PARTICLE_SPACING) / 4; // Place in upper quarter
-
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            Particle *p = &particles[y * GRID_WIDTH + x];
-            p->x = start_x + x * PARTICLE_SPACING;
-            p->y = start_y + y * PARTICLE_SPACING;
-            p->old_x = p->x;
-            p->old_y = p->y;
-            p->vx = p->vy = 0;
-            p->force_x = p->force_y = 0;
-            p->mass = current_material.mass;
-            p->material = &current_material;
-            p->locked = (y == 0); // Lock entire top row
-            p->neighbors = NULL;
-            p->num_neighbors = 0;
+    float start_x = (SCREEN_WIDTH - (cloth.width - 1) * cloth.spacing) / 2;
+    float start_y = (SCREEN_HEIGHT - (cloth.height - 1) * cloth.spacing) / 4; // Place in upper quarter
+
+    for (int y = 0; y < cloth.height; y++) {
+        for (int x = 0; x < cloth.width; x++) {
+            int i = y * cloth.width + x;
+            cloth.x[i] = start_x + x * cloth.spacing;
+            cloth.y[i] = start_y + y * cloth.spacing;
+            cloth.old_x[i] = cloth.x[i];
+            cloth.old_y[i] = cloth.y[i];
+            cloth.vx[i] = cloth.vy[i] = 0;
+            cloth.locked[i] = (y == 0); // Lock entire top row
         }
     }
 }
 
 void init_constraints() {
     int index = 0;
-    for (int y = 0; y < GRID_HEIGHT; y++) {
-        for (int x = 0; x < GRID_WIDTH - 1; x++) {
-            constraints[index++] = (Constraint){
-                &particles[y * GRID_WIDTH + x],
-                &particles[y * GRID_WIDTH + x + 1],
-                PARTICLE_SPACING,
+    for (int y = 0; y < cloth.height; y++) {
+        for (int x = 0; x < cloth.width - 1; x++) {
+            cloth.constraints[index++] = (Constraint){
+                y * cloth.width + x,
+                y * cloth.width + x + 1,
+                cloth.spacing,
                 current_material.stiffness
             };
         }
     }
-    for (int y = 0; y < GRID_HEIGHT - 1; y++) {
-        for (int x = 0; x < GRID_WIDTH; x++) {
-            constraints[index++] = (Constraint){
-                &particles[y * GRID_WIDTH + x],
-                &particles[(y + 1) * GRID_WIDTH + x],
-                PARTICLE_SPACING,
+    for (int y = 0; y < cloth.height - 1; y++) {
+        for (int x = 0; x < cloth.width; x++) {
+            cloth.constraints[index++] = (Constraint){
+                y * cloth.width + x,
+                (y + 1) * cloth.width + x,
+                cloth.spacing,
                 current_material.stiffness
             };
         }
     }
 }
 
-void handle_mouse_interaction() {
-    if (!mouse_down) return;
-    
-    for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
-        Particle *p = &particles[i];
-        float dx = p->x - mouse.x;
-        float dy = p->y - mouse.y;
-        float dist = sqrtf(dx * dx + dy * dy);
-        
-        if (dist < 20.0f && !p->locked) {
-            p->x = mouse.x;
-            p->y = mouse.y;
-            p->old_x = mouse.x;
-            p->old_y = mouse.y;
+void set_mouse(int x, int y) {
+    __atomic_store_n(&mouse.x, x, __ATOMIC_RELAXED);
+    __atomic_store_n(&mouse.y, y, __ATOMIC_RELAXED);
+}
+
+// Cuts every link touching particle i
+static void cut_particle(Cloth* c, int i) {
+    int x = i % c->width;
+    c->torn_right[i] = c->torn_down[i] = 1;
+    if (x > 0) c->torn_right[i - 1] = 1;
+    if (i >= c->width) c->torn_down[i - c->width] = 1;
+}
+
+// Drags free particles near the mouse onto it, or cuts the links of those
+// under it, visiting only the hash cells that cover the mouse radius. A
+// bucket shared by several of those cells is visited once per cell, which
+// is harmless as both actions are idempotent.
+void handle_mouse_interaction(bool drag, bool cut) {
+    if (!drag && !cut) return;
+    const SpatialHash* h = &spatial_hash;
+    float mouse_x = __atomic_load_n(&mouse.x, __ATOMIC_RELAXED);
+    float mouse_y = __atomic_load_n(&mouse.y, __ATOMIC_RELAXED);
+    float radius = drag ? MOUSE_RADIUS : CUT_RADIUS;
+
+    int x0 = cell_coord(h, mouse_x - radius), x1 = cell_coord(h, mouse_x + radius);
+    int y0 = cell_coord(h, mouse_y - radius), y1 = cell_coord(h, mouse_y + radius);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int k = hash_cell(h, cx, cy);
+            for (int q = h->start[k]; q < h->start[k + 1]; q++) {
+                int i = h->sorted[q];
+                float dx = cloth.x[i] - mouse_x;
+                float dy = cloth.y[i] - mouse_y;
+                if (dx * dx + dy * dy >= radius * radius) continue;
+
+                if (cut) {
+                    cut_particle(&cloth, i);
+                } else if (!cloth.locked[i]) {
+                    cloth.x[i] = mouse_x;
+                    cloth.y[i] = mouse_y;
+                    cloth.old_x[i] = mouse_x;
+                    cloth.old_y[i] = mouse_y;
+                }
+            }
         }
     }
 }
 
-void render_cloth(SDL_Renderer *renderer) {
-    // Draw constraints
+// Particle positions and link state as published by the physics thread
+typedef struct {
+    float* x;
+    float* y;
+    unsigned char* torn_right;
+    unsigned char* torn_down;
+} ClothFrame;
+
+#ifndef CLOTH_HEADLESS
+// SDL_RenderGeometry (SDL 2.0.18+) draws the whole cloth in one call; older
+// SDL falls back to one line strip per row and column plus one rect batch
+// per particle colour
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    #define CLOTH_RENDER_GEOMETRY
+#endif
+
+#define PARTICLE_SIZE 4.0f
+
+// Per-frame draw buffers, sized once for the grid so rendering never
+// allocates and the number of draw calls does not grow with the cloth
+typedef struct {
+#ifdef CLOTH_RENDER_GEOMETRY
+    SDL_Vertex* vertices;       // Four per constraint, then four per particle
+    int* indices;               // Two triangles per quad; fixed by the grid
+    int num_vertices;
+    int num_indices;
+#else
+    SDL_Point* strip;           // One row or column of the grid
+    SDL_Rect* rects[2];         // Free and locked particles
+#endif
+} RenderBatch;
+
+RenderBatch batch;
+
+void free_render_batch(RenderBatch* b) {
+#ifdef CLOTH_RENDER_GEOMETRY
+    free(b->vertices);
+    free(b->indices);
+#else
+    free(b->strip);
+    free(b->rects[0]);
+    free(b->rects[1]);
+#endif
+    memset(b, 0, sizeof(*b));
+}
+
+bool init_render_batch(RenderBatch* b, const Cloth* c) {
+    memset(b, 0, sizeof(*b));
+#ifdef CLOTH_RENDER_GEOMETRY
+    size_t quads = (size_t)c->num_constraints + (size_t)c->count;
+    if (quads > INT_MAX / 6) return false;
+    b->num_vertices = (int)(quads * 4);
+    b->num_indices = (int)(quads * 6);
+    b->vertices = malloc(quads * 4 * sizeof(SDL_Vertex));
+    b->indices = malloc(quads * 6 * sizeof(int));
+    if (!b->vertices || !b->indices) {
+        free_render_batch(b);
+        return false;
+    }
+    for (size_t q = 0; q < quads; q++) {
+        int v = (int)(q * 4);
+        int* idx = &b->indices[q * 6];
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v;     idx[4] = v + 2; idx[5] = v + 3;
+    }
+    // Constraint colours never change; particle colours are set per frame
+    SDL_Color line = {200, 200, 200, 255};
+    for (int v = 0; v < c->num_constraints * 4; v++) {
+        b->vertices[v].color = line;
+        b->vertices[v].tex_coord = (SDL_FPoint){0.0f, 0.0f};
+    }
+    for (int v = c->num_constraints * 4; v < b->num_vertices; v++) {
+        b->vertices[v].tex_coord = (SDL_FPoint){0.0f, 0.0f};
+    }
+#else
+    int longest = c->width > c->height ? c->width : c->height;
+    b->strip = malloc((size_t)longest * sizeof(SDL_Point));
+    b->rects[0] = malloc((size_t)c->count * sizeof(SDL_Rect));
+    b->rects[1] = malloc((size_t)c->count * sizeof(SDL_Rect));
+    if (!b->strip || !b->rects[0] || !b->rects[1]) {
+        free_render_batch(b);
+        return false;
+    }
+#endif
+    return true;
+}
+
+#ifdef CLOTH_RENDER_GEOMETRY
+static inline void set_quad(SDL_Vertex* v, float x0, float y0, float x1, float y1,
+                            float x2, float y2, float x3, float y3) {
+    v[0].position = (SDL_FPoint){x0, y0};
+    v[1].position = (SDL_FPoint){x1, y1};
+    v[2].position = (SDL_FPoint){x2, y2};
+    v[3].position = (SDL_FPoint){x3, y3};
+}
+#endif
+
+// Draws a published frame with the cloth's pinned particles; torn links
+// are skipped
+void render_cloth(SDL_Renderer *renderer, const ClothFrame* frame) {
+    const float* px = frame->x;
+    const float* py = frame->y;
+#ifdef CLOTH_RENDER_GEOMETRY
+    SDL_Vertex* v = batch.vertices;
+
+    // Constraints as one-pixel-wide quads along each link
+    for (int i = 0; i < cloth.num_constraints; i++, v += 4) {
+        const Constraint* c = &cloth.constraints[i];
+        float x1 = px[c->p1], y1 = py[c->p1];
+        float x2 = px[c->p2], y2 = py[c->p2];
+        bool torn = c->p2 == c->p1 + 1 ? frame->torn_right[c->p1] : frame->torn_down[c->p1];
+        if (torn) {
+            set_quad(v, x1, y1, x1, y1, x1, y1, x1, y1);    // Zero area: not drawn
+            continue;
+        }
+        float dx = x2 - x1, dy = y2 - y1;
+        float len = sqrtf(dx * dx + dy * dy);
+        float nx = 0.5f, ny = 0.0f;
+        if (len > 1e-6f) {
+            nx = -dy * 0.5f / len;
+            ny = dx * 0.5f / len;
+        }
+        set_quad(v, x1 + nx, y1 + ny, x1 - nx, y1 - ny,
+                    x2 - nx, y2 - ny, x2 + nx, y2 + ny);
+    }
+
+    // Particles on top, since indices are drawn in order
+    const SDL_Color free_colour = {100, 100, 100, 255};
+    const SDL_Color locked_colour = {255, 0, 0, 255};
+    const float h = PARTICLE_SIZE * 0.5f;
+    for (int i = 0; i < cloth.count; i++, v += 4) {
+        float x = px[i], y = py[i];
+        set_quad(v, x - h, y - h, x + h, y - h, x + h, y + h, x - h, y + h);
+        SDL_Color colour = cloth.locked[i] ? locked_colour : free_colour;
+        v[0].color = v[1].color = v[2].color = v[3].color = colour;
+    }
+
+    SDL_RenderGeometry(renderer, NULL, batch.vertices, batch.num_vertices,
+                       batch.indices, batch.num_indices);
+#else
+    // Draw constraints as row and column strips, broken where links tore
     SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-    for (int i = 0; i < (GRID_WIDTH - 1) * GRID_HEIGHT + GRID_WIDTH * (GRID_HEIGHT - 1); i++) {
-        Constraint *c = &constraints[i];
-        SDL_RenderDrawLine(renderer, 
-            (int)c->p1->x, (int)c->p1->y, 
-            (int)c->p2->x, (int)c->p2->y);
+    for (int y = 0; y < cloth.height; y++) {
+        int n = 0;
+        for (int x = 0; x < cloth.width; x++) {
+            int i = y * cloth.width + x;
+            batch.strip[n++] = (SDL_Point){(int)px[i], (int)py[i]};
+            if (x + 1 == cloth.width || frame->torn_right[i]) {
+                if (n > 1) SDL_RenderDrawLines(renderer, batch.strip, n);
+                n = 0;
+            }
+        }
     }
-    
-    // Draw particles
-    for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
-        Particle *p = &particles[i];
-        if (p->locked) {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+    for (int x = 0; x < cloth.width; x++) {
+        int n = 0;
+        for (int y = 0; y < cloth.height; y++) {
+            int i = y * cloth.width + x;
+            batch.strip[n++] = (SDL_Point){(int)px[i], (int)py[i]};
+            if (y + 1 == cloth.height || frame->torn_down[i]) {
+                if (n > 1) SDL_RenderDrawLines(renderer, batch.strip, n);
+                n = 0;
+            }
+        }
+    }
+
+    // Draw particles grouped by colour
+    int counts[2] = {0, 0};
+    int size = (int)PARTICLE_SIZE;
+    for (int i = 0; i < cloth.count; i++) {
+        int group = cloth.locked[i] != 0;
+        batch.rects[group][counts[group]++] =
+            (SDL_Rect){(int)px[i] - size / 2, (int)py[i] - size / 2, size, size};
+    }
+    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
+    SDL_RenderFillRects(renderer, batch.rects[0], counts[0]);
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+    SDL_RenderFillRects(renderer, batch.rects[1], counts[1]);
+#endif
+}
+#endif
+
+// Triple-buffered particle positions and link state. The physics thread
+// fills `back` and swaps it with `middle`; the render thread swaps `front`
+// with `middle` when FRAME_FRESH says it holds a newer frame. Each side
+// owns its buffer outright, so neither ever waits for the other.
+#define FRAME_FRESH 4
+
+typedef struct {
+    ClothFrame frame[3];
+    int back;                   // Physics thread only
+    int middle;                 // Buffer index | FRAME_FRESH, swapped atomically
+    int front;                  // Render thread only
+} FrameBuffer;
+
+typedef struct {
+    FrameBuffer frames;
+    pthread_t thread;
+    int quit;
+    bool running;
+} PhysicsLoop;
+
+PhysicsLoop physics;
+
+static void copy_frame(ClothFrame* frame, const Cloth* c) {
+    size_t n = (size_t)c->count;
+    memcpy(frame->x, c->x, n * sizeof(float));
+    memcpy(frame->y, c->y, n * sizeof(float));
+    memcpy(frame->torn_right, c->torn_right, n);
+    memcpy(frame->torn_down, c->torn_down, n);
+}
+
+void free_frames(FrameBuffer* f) {
+    for (int k = 0; k < 3; k++) {
+        free(f->frame[k].x);
+        free(f->frame[k].y);
+        free(f->frame[k].torn_right);
+        free(f->frame[k].torn_down);
+    }
+    memset(f, 0, sizeof(*f));
+}
+
+// All three buffers start as the cloth's current state
+bool init_frames(FrameBuffer* f, const Cloth* c) {
+    memset(f, 0, sizeof(*f));
+    size_t n = (size_t)c->count;
+    for (int k = 0; k < 3; k++) {
+        ClothFrame* frame = &f->frame[k];
+        frame->x = malloc(n * sizeof(float));
+        frame->y = malloc(n * sizeof(float));
+        frame->torn_right = malloc(n);
+        frame->torn_down = malloc(n);
+        if (!frame->x || !frame->y || !frame->torn_right || !frame->torn_down) {
+            free_frames(f);
+            return false;
+        }
+        copy_frame(frame, c);
+    }
+    f->back = 0;
+    f->middle = 1;
+    f->front = 2;
+    return true;
+}
+
+void publish_frame(FrameBuffer* f, const Cloth* c) {
+    copy_frame(&f->frame[f->back], c);
+    int old = __atomic_exchange_n(&f->middle, f->back | FRAME_FRESH, __ATOMIC_ACQ_REL);
+    f->back = old & 3;
+}
+
+// Makes the newest published frame the front buffer, if there is one
+void acquire_frame(FrameBuffer* f) {
+    if (!(__atomic_load_n(&f->middle, __ATOMIC_ACQUIRE) & FRAME_FRESH)) return;
+    int old = __atomic_exchange_n(&f->middle, f->front, __ATOMIC_ACQ_REL);
+    f->front = old & 3;
+}
+
+// One fixed step: integration; the spatial hash, when the mouse or
+// self-collision needs it; mouse dragging or cutting; self-collision; the
+// timed solver passes; then tearing
+void step_cloth(float dt) {
+    current_material.integrate(&cloth, &current_material, dt);
+
+    bool drag = __atomic_load_n(&mouse_down, __ATOMIC_RELAXED);
+    bool cut = __atomic_load_n(&right_click, __ATOMIC_RELAXED);
+    bool collide = cloth_features & CLOTH_SELF_COLLISION;
+    if (drag || cut || collide) build_spatial_hash(&cloth);
+    handle_mouse_interaction(drag, cut);
+    if (collide) collide_cloth(&cloth);
+
+    for (int j = 0; j < solver.iterations; j++) {
+        uint64_t start = cloth_ticks();
+        current_material.solve_constraints(&cloth, &current_material);
+        solver.iteration_ms[j] += (cloth_ticks() - start) * 1000.0 / cloth_tick_rate();
+    }
+    if (cloth_features & CLOTH_TEARING) tear_cloth(&cloth);
+
+    if (++solver.timed_frames == SOLVER_REPORT_FRAMES) {
+        report_solver_timing();
+    }
+}
+
+// Steps the cloth every PHYSICS_DT of wall-clock time, independent of how
+// fast frames are presented. Deadlines are absolute, so sleep overshoot
+// does not drift; after falling more than PHYSICS_MAX_LAG steps behind,
+// the backlog is dropped rather than run as a burst.
+static void* physics_thread(void* arg) {
+    PhysicsLoop* loop = arg;
+    uint64_t frequency = cloth_tick_rate();
+    uint64_t tick = (uint64_t)(frequency * PHYSICS_DT);
+    if (tick == 0) tick = 1;
+    uint64_t next = cloth_ticks();
+
+    while (!__atomic_load_n(&loop->quit, __ATOMIC_ACQUIRE)) {
+        uint64_t now = cloth_ticks();
+        if (now < next) {
+            uint32_t ms = (uint32_t)((next - now) * 1000 / frequency);
+            cloth_delay_ms(ms > 0 ? ms : 1);
+            continue;
+        }
+        step_cloth(PHYSICS_DT);
+        publish_frame(&loop->frames, &cloth);
+        next += tick;
+        if (now > next + tick * PHYSICS_MAX_LAG) next = now;
+    }
+    return NULL;
+}
+
+bool start_physics(PhysicsLoop* loop) {
+    if (!init_frames(&loop->frames, &cloth)) return false;
+    loop->quit = 0;
+    if (pthread_create(&loop->thread, NULL, physics_thread, loop) != 0) {
+        free_frames(&loop->frames);
+        return false;
+    }
+    loop->running = true;
+    return true;
+}
+
+void stop_physics(PhysicsLoop* loop) {
+    if (loop->running) {
+        __atomic_store_n(&loop->quit, 1, __ATOMIC_RELEASE);
+        pthread_join(loop->thread, NULL);
+        loop->running = false;
+    }
+    free_frames(&loop->frames);
+}
+
+// One thread per core, but no fewer than 32 rows each
+int default_solver_threads(int grid_height) {
+    int threads = cloth_cpu_count();
+    if (threads > grid_height / 32) threads = grid_height / 32;
+    return threads < 1 ? 1 : threads;
+}
+
+static double elapsed_ns(uint64_t start, uint64_t end) {
+    return (double)(end - start) * 1e9 / (double)cloth_tick_rate();
+}
+
+// Headless benchmark: a fixed timestep and no window, renderer or event
+// loop, so runs are reproducible and not tied to vsync. Reports step rate
+// and per-particle and per-constraint costs; dump_path, when given ("-"
+// for stdout), receives the final "x y" of every particle for regression
+// checks. Zero or negative sizes, iterations and threads take defaults;
+// features selects CLOTH_TEARING and CLOTH_SELF_COLLISION.
+int run_cloth_benchmark(int width, int height, int steps, int iterations, int threads,
+                        int features, const char* dump_path) {
+    if (width <= 0 || height <= 0) {
+        width = GRID_WIDTH;
+        height = GRID_HEIGHT;
+    }
+    if (steps < 1) steps = 1;
+    if (iterations < 1 || iterations > 1000) iterations = CONSTRAINT_ITERATIONS;
+    if (threads < 1) threads = default_solver_threads(height);
+
+    init_materials();
+    if (!init_cloth(&cloth, width, height)) {
+        fprintf(stderr, "[OBINexus] Cannot create a %dx%d cloth\n", width, height);
+        return 1;
+    }
+    init_particles();
+    init_constraints();
+    if (!init_solver(iterations, threads)) {
+        fprintf(stderr, "[OBINexus] Cannot start the constraint solver\n");
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!init_spatial_hash(&spatial_hash, &cloth, solver.threads)) {
+        fprintf(stderr, "[OBINexus] Cannot allocate the spatial hash\n");
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+    cloth_features = features;
+    if ((cloth_features & CLOTH_TEARING) && !calibrate_tearing(&cloth, &current_material)) {
+        fprintf(stderr, "[OBINexus] Cannot calibrate tearing\n");
+        free_spatial_hash(&spatial_hash);
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+
+    double integrate_ns = 0.0, collide_ns = 0.0, solve_ns = 0.0, tear_ns = 0.0;
+    uint64_t run_start = cloth_ticks();
+    for (int step = 0; step < steps; step++) {
+        uint64_t t0 = cloth_ticks();
+        current_material.integrate(&cloth, &current_material, PHYSICS_DT);
+        uint64_t t1 = cloth_ticks();
+        if (features & CLOTH_SELF_COLLISION) {
+            build_spatial_hash(&cloth);
+            collide_cloth(&cloth);
+        }
+        uint64_t t2 = cloth_ticks();
+        for (int j = 0; j < solver.iterations; j++) {
+            current_material.solve_constraints(&cloth, &current_material);
+        }
+        uint64_t t3 = cloth_ticks();
+        if (features & CLOTH_TEARING) tear_cloth(&cloth);
+        uint64_t t4 = cloth_ticks();
+        integrate_ns += elapsed_ns(t0, t1);
+        collide_ns += elapsed_ns(t1, t2);
+        solve_ns += elapsed_ns(t2, t3);
+        tear_ns += elapsed_ns(t3, t4);
+    }
+    double total_ns = elapsed_ns(run_start, cloth_ticks());
+
+    printf("[OBINexus] Benchmark: %dx%d particles, %d constraints, %d steps of %.4f s\n",
+           cloth.width, cloth.height, cloth.num_constraints, steps, PHYSICS_DT);
+    printf("[OBINexus] Solver: %d iterations, %d thread(s)\n", solver.iterations, solver.threads);
+    printf("[OBINexus] Steps/sec: %.1f\n", steps / (total_ns * 1e-9));
+    printf("[OBINexus] ns per particle-update: %.3f\n",
+           integrate_ns / ((double)steps * cloth.count));
+    printf("[OBINexus] ns per constraint-solve: %.3f\n",
+           solve_ns / ((double)steps * solver.iterations * cloth.num_constraints));
+    if (features & CLOTH_SELF_COLLISION) {
+        printf("[OBINexus] ns per particle-collision (hash + contacts): %.3f\n",
+               collide_ns / ((double)steps * cloth.count));
+    }
+    if (features & CLOTH_TEARING) {
+        int torn = 0;
+        for (int i = 0; i < cloth.count; i++) torn += (cloth.torn_right[i] != 0) + (cloth.torn_down[i] != 0);
+        printf("[OBINexus] ns per tear check: %.3f, %d link(s) torn\n",
+               tear_ns / ((double)steps * cloth.num_constraints), torn);
+    }
+
+    int status = 0;
+    if (dump_path) {
+        FILE* out = strcmp(dump_path, "-") == 0 ? stdout : fopen(dump_path, "w");
+        if (out) {
+            for (int i = 0; i < cloth.count; i++) {
+                fprintf(out, "%.6f %.6f\n", cloth.x[i], cloth.y[i]);
+            }
+            if (out != stdout) fclose(out);
         } else {
-            SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
+            perror(dump_path);
+            status = 1;
         }
-        SDL_Rect rect = {(int)p->x - 2, (int)p->y - 2, 4, 4};
-        SDL_RenderFillRect(renderer, &rect);
+    }
+
+    free_spatial_hash(&spatial_hash);
+    free_solver();
+    free_cloth(&cloth);
+    return status;
+}
+
+#ifdef CLOTH_OBIBENCH
+#include "obibench.h"
+
+#define MICROBENCH_GRID 200
+
+static void bench_integrate(void* arg, uint64_t count) {
+    (void)arg;
+    for (uint64_t i = 0; i < count; i++) {
+        current_material.integrate(&cloth, &current_material, PHYSICS_DT);
     }
 }
 
+static void bench_solve(void* arg, uint64_t count) {
+    (void)arg;
+    for (uint64_t i = 0; i < count; i++) {
+        current_material.solve_constraints(&cloth, &current_material);
+    }
+}
+
+static void bench_collide(void* arg, uint64_t count) {
+    (void)arg;
+    for (uint64_t i = 0; i < count; i++) {
+        build_spatial_hash(&cloth);
+        collide_cloth(&cloth);
+    }
+}
+
+static void bench_tear(void* arg, uint64_t count) {
+    (void)arg;
+    for (uint64_t i = 0; i < count; i++) {
+        tear_cloth(&cloth);
+    }
+}
+
+// The stages of run_cloth_benchmark on the shared harness (make bench), one
+// whole-cloth pass per operation on a MICROBENCH_GRID square grid; argv
+// takes the harness options
+int run_cloth_microbench(int argc, char* argv[]) {
+    init_materials();
+    if (!init_cloth(&cloth, MICROBENCH_GRID, MICROBENCH_GRID)) {
+        fprintf(stderr, "[OBINexus] Cannot create the benchmark cloth\n");
+        return 1;
+    }
+    init_particles();
+    init_constraints();
+    if (!init_solver(1, default_solver_threads(MICROBENCH_GRID))) {
+        fprintf(stderr, "[OBINexus] Cannot start the constraint solver\n");
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!init_spatial_hash(&spatial_hash, &cloth, solver.threads)) {
+        fprintf(stderr, "[OBINexus] Cannot allocate the spatial hash\n");
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!calibrate_tearing(&cloth, &current_material)) {
+        fprintf(stderr, "[OBINexus] Cannot calibrate tearing\n");
+        free_spatial_hash(&spatial_hash);
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+
+    obibench_suite_t* suite = obibench_init("verlet-cloth", argc, argv);
+    obibench_run(suite, "integrate", bench_integrate, NULL);
+    obibench_run(suite, "solve_constraints", bench_solve, NULL);
+    obibench_run(suite, "self_collision", bench_collide, NULL);
+    obibench_run(suite, "tear_check", bench_tear, NULL);
+    int status = obibench_finish(suite);
+
+    free_spatial_hash(&spatial_hash);
+    free_solver();
+    free_cloth(&cloth);
+    return status;
+}
+#endif
+
+#ifdef CLOTH_HEADLESS
+// Without SDL there is no window; main.c still runs --headless
+int run_cloth_simulation(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+    fprintf(stderr, "[OBINexus] Built without SDL (CLOTH_HEADLESS); only --headless runs\n");
+    return 1;
+}
+#else
 // Main entry point - works on both Windows and Unix/Linux
 int run_cloth_simulation(int argc, char* argv[]) {
+    // --grid=WxH overrides the default GRID_WIDTH x GRID_HEIGHT;
+    // --iterations=N and --solver-threads=N tune the constraint solver;
+    // --tear and --self-collision enable the optional physics
+    int grid_width = GRID_WIDTH, grid_height = GRID_HEIGHT;
+    int iterations = CONSTRAINT_ITERATIONS, solver_threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--grid=", 7) == 0 &&
+            sscanf(argv[i] + 7, "%dx%d", &grid_width, &grid_height) != 2) {
+            grid_width = GRID_WIDTH;
+            grid_height = GRID_HEIGHT;
+        } else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = atoi(argv[i] + 13);
+        } else if (strncmp(argv[i], "--solver-threads=", 17) == 0) {
+            solver_threads = atoi(argv[i] + 17);
+        } else if (strcmp(argv[i], "--tear") == 0) {
+            cloth_features |= CLOTH_TEARING;
+        } else if (strcmp(argv[i], "--self-collision") == 0) {
+            cloth_features |= CLOTH_SELF_COLLISION;
+        }
+    }
+    if (iterations < 1 || iterations > 1000) iterations = CONSTRAINT_ITERATIONS;
+    if (solver_threads < 1) solver_threads = default_solver_threads(grid_height);
+
+    init_materials();
+    if (!init_cloth(&cloth, grid_width, grid_height)) {
+        fprintf(stderr, "[OBINexus] Cannot create a %dx%d cloth\n", grid_width, grid_height);
+        return 1;
+    }
+    init_particles();
+    init_constraints();
+    if (!init_solver(iterations, solver_threads)) {
+        fprintf(stderr, "[OBINexus] Cannot start the constraint solver\n");
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!init_spatial_hash(&spatial_hash, &cloth, solver.threads)) {
+        fprintf(stderr, "[OBINexus] Cannot allocate the spatial hash\n");
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+    if ((cloth_features & CLOTH_TEARING) && !calibrate_tearing(&cloth, &current_material)) {
+        fprintf(stderr, "[OBINexus] Cannot calibrate tearing\n");
+        free_spatial_hash(&spatial_hash);
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!init_render_batch(&batch, &cloth)) {
+        fprintf(stderr, "[OBINexus] Cannot allocate render buffers\n");
+        free_spatial_hash(&spatial_hash);
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+    if (!start_physics(&physics)) {
+        fprintf(stderr, "[OBINexus] Cannot start the physics thread\n");
+        free_render_batch(&batch);
+        free_spatial_hash(&spatial_hash);
+        free_solver();
+        free_cloth(&cloth);
+        return 1;
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
     SDL_Window *window = SDL_CreateWindow("OBINexus Quantum Cloth Simulation",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -301,15 +1701,15 @@ int run_cloth_simulation(int argc, char* argv[]) {
     SDL_Renderer *renderer = SDL_CreateRenderer(window, -1,
         SDL_RENDERER_ACCELERATED);
 
-    init_materials();
-    init_particles();
-    init_constraints();
-
     bool running = true;
     SDL_Event event;
-    Uint32 last_time = SDL_GetTicks();
 
-    printf("[OBINexus] Cloth simulation started\n");
+    printf("[OBINexus] Cloth simulation started (%dx%d particles)\n", cloth.width, cloth.height);
+    printf("[OBINexus] Constraint solver: %d iterations, %d thread(s), %.0f Hz\n",
+           solver.iterations, solver.threads, 1.0f / PHYSICS_DT);
+    printf("[OBINexus] Tearing: %s, self-collision: %s (right-click cuts)\n",
+           cloth_features & CLOTH_TEARING ? "on" : "off",
+           cloth_features & CLOTH_SELF_COLLISION ? "on" : "off");
     printf("[OBINexus] Platform: %s\n", 
         #ifdef PLATFORM_WINDOWS
             "Windows"
@@ -323,14 +1723,14 @@ int run_cloth_simulation(int argc, char* argv[]) {
             if (event.type == SDL_QUIT) {
                 running = false;
             } else if (event.type == SDL_MOUSEBUTTONDOWN) {
-                mouse_down = true;
-                mouse.x = event.button.x;
-                mouse.y = event.button.y;
+                set_mouse(event.button.x, event.button.y);
+                int* button = event.button.button == SDL_BUTTON_RIGHT ? &right_click : &mouse_down;
+                __atomic_store_n(button, 1, __ATOMIC_RELAXED);
             } else if (event.type == SDL_MOUSEBUTTONUP) {
-                mouse_down = false;
+                int* button = event.button.button == SDL_BUTTON_RIGHT ? &right_click : &mouse_down;
+                __atomic_store_n(button, 0, __ATOMIC_RELAXED);
             } else if (event.type == SDL_MOUSEMOTION) {
-                mouse.x = event.motion.x;
-                mouse.y = event.motion.y;
+                set_mouse(event.motion.x, event.motion.y);
             } else if (event.type == SDL_KEYDOWN) {
                 switch (event.key.keysym.sym) {
                     case SDLK_1: 
@@ -346,40 +1746,31 @@ int run_cloth_simulation(int argc, char* argv[]) {
             }
         }
 
-        Uint32 current_time = SDL_GetTicks();
-        float dt = (current_time - last_time) / 1000.0f;
-        last_time = current_time;
-
-        // Update physics using encoded laws
-        for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
-            current_material.apply_force(&particles[i], dt);
-        }
-
-        handle_mouse_interaction();
-
-        // Solve constraints using material-specific solvers
-        for (int j = 0; j < 5; j++) {
-            for (int i = 0; i < (GRID_WIDTH - 1) * GRID_HEIGHT + GRID_WIDTH * (GRID_HEIGHT - 1); i++) {
-                Constraint* c = &constraints[i];
-                current_material.solve_constraint(c->p1, c->p2, c->rest_length);
-            }
-        }
+        // Physics runs on its own thread; draw the newest frame it published
+        acquire_frame(&physics.frames);
+        const ClothFrame* frame = &physics.frames.frame[physics.frames.front];
 
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
-        render_cloth(renderer);
+        render_cloth(renderer, frame);
         SDL_RenderPresent(renderer);
 
         SDL_Delay(16);
     }
 
+    stop_physics(&physics);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
+    free_render_batch(&batch);
+    free_spatial_hash(&spatial_hash);
+    free_solver();
+    free_cloth(&cloth);
     
     printf("[OBINexus] Cloth simulation ended\n");
     return 0;
 }
+#endif
 
 // Platform-specific entry points
 #ifdef PLATFORM_WINDOWS
@@ -393,6 +1784,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 #undef main
 #endif
 
+// main.c supplies the entry point in the full build and defines
+// CLOTH_NO_MAIN for this file
+#ifndef CLOTH_NO_MAIN
 int main(int argc, char *argv[]) {
+#ifdef CLOTH_OBIBENCH
+    if (argc > 1 && strcmp(argv[1], "--microbench") == 0) {
+        return run_cloth_microbench(argc - 1, argv + 1);
+    }
+#endif
     return run_cloth_simulation(argc, argv);
 }
+#endif
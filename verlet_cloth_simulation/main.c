@@ -49,8 +49,14 @@ void signal_handler(int sig);
 int launch_detached_process(const char* executable, char* const argv[]);
 void transfer_pid_to_child(pid_t parent, pid_t child);
 
-// External function from cloth_simulation.c
+// External functions from cloth_simulation.c
 extern int run_cloth_simulation(int argc, char* argv[]);
+extern int run_cloth_benchmark(int width, int height, int steps, int iterations, int threads,
+                               int features, const char* dump_path);
+
+// Feature flags for run_cloth_benchmark, as in cloth_simulation.c
+#define CLOTH_TEARING 1
+#define CLOTH_SELF_COLLISION 2
 
 // Initialize process list
 void init_process_list(void) {
@@ -218,14 +224,52 @@ void transfer_pid_to_child(pid_t parent, pid_t child) {
     pthread_mutex_unlock(&g_process_list->mutex);
 }
 
+// Value of "--name value" or "--name=value" at argv[*i]; advances *i past
+// a separate value. NULL if argv[*i] is not this option.
+static const char* option_value(int argc, char* argv[], int* i, const char* name) {
+    size_t len = strlen(name);
+    if (strncmp(argv[*i], name, len) != 0) return NULL;
+    if (argv[*i][len] == '=') return argv[*i] + len + 1;
+    if (argv[*i][len] == '\0' && *i + 1 < argc) return argv[++*i];
+    return NULL;
+}
+
 int main(int argc, char* argv[]) {
     int detach_mode = 0;
     int fork_mode = 0;
     int thread_mode = 0;
 
+    // Headless benchmark:
+    //   --headless [--steps N] [--grid WxH] [--iterations N] [--solver-threads N] [--dump PATH]
+    //              [--tear] [--self-collision]
+    // Zeros select the simulation's defaults
+    int headless = 0, features = 0;
+    int steps = 1000, grid_width = 0, grid_height = 0, iterations = 0, solver_threads = 0;
+    const char* dump_path = NULL;
+    const char* value;
+
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--detach") == 0) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if ((value = option_value(argc, argv, &i, "--steps"))) {
+            steps = atoi(value);
+        } else if ((value = option_value(argc, argv, &i, "--grid"))) {
+            if (sscanf(value, "%dx%d", &grid_width, &grid_height) != 2) {
+                fprintf(stderr, "[OBINexus] --grid expects WxH, got %s\n", value);
+                return 1;
+            }
+        } else if ((value = option_value(argc, argv, &i, "--iterations"))) {
+            iterations = atoi(value);
+        } else if ((value = option_value(argc, argv, &i, "--solver-threads"))) {
+            solver_threads = atoi(value);
+        } else if ((value = option_value(argc, argv, &i, "--dump"))) {
+            dump_path = value;
+        } else if (strcmp(argv[i], "--tear") == 0) {
+            features |= CLOTH_TEARING;
+        } else if (strcmp(argv[i], "--self-collision") == 0) {
+            features |= CLOTH_SELF_COLLISION;
+        } else if (strcmp(argv[i], "--detach") == 0) {
             detach_mode = 1;
         } else if (strncmp(argv[i], "--fork-mode=", 12) == 0) {
             if (strcmp(argv[i] + 12, "thread") == 0) {
@@ -236,6 +280,11 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (headless) {
+        return run_cloth_benchmark(grid_width, grid_height, steps, iterations,
+                                   solver_threads, features, dump_path);
+    }
+
     // Initialize process list
     init_process_list();
 
@@ -0,0 +1,151 @@
+// QuantumClothSimulationTest.cpp
+// Automation tests for the quantum cloth tick job; built by the engine with
+// the rest of the module and run from Session Frontend or with
+// -ExecCmds="Automation RunTests OBINexus.QuantumCloth"
+#include "QuantumClothSimulation.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    constexpr int32 TickJobActors = 64;
+    constexpr int32 TickJobFrames = 200;
+
+    bool SameContract(const FQuantumContract& A, const FQuantumContract& B)
+    {
+        return A.CurrentState == B.CurrentState && A.CollapseThreshold == B.CollapseThreshold
+            && A.NegativeMassInfluence == B.NegativeMassInfluence && A.bIsStabilized == B.bIsStabilized;
+    }
+}
+
+// StepQuantumState touches only its arguments, so the same frames run as
+// concurrent task graph jobs match a serial run exactly
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuantumClothTickJobTest, "OBINexus.QuantumCloth.TickJob",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FQuantumClothTickJobTest::RunTest(const FString& Parameters)
+{
+    using FState = AQuantumClothSimulation::FQuantumTickState;
+    const float Threshold = 0.1f;
+    const float DeltaSeconds = 1.0f / 60.0f;
+
+    TArray<FState> Serial, Jobs;
+    TArray<FRandomStream> SerialRandom, JobRandom;
+    for (int32 Actor = 0; Actor < TickJobActors; Actor++)
+    {
+        FState State;
+        State.Contract.CurrentState = static_cast<EQuantumState>(Actor % 4);
+        State.Contract.NegativeMassInfluence = 0.25f * (Actor % 5);
+        State.LastStablePosition = FVector(Actor, 0.0f, 0.0f);
+        Serial.Add(State);
+        Jobs.Add(State);
+        SerialRandom.Add(FRandomStream(Actor + 1));
+        JobRandom.Add(FRandomStream(Actor + 1));
+    }
+
+    // Actors drift by less than the jitter threshold, with a jump now and then
+    auto LocationAt = [](int32 Actor, int32 Frame)
+    {
+        return FVector(Actor + ((Frame % 37 == 0) ? 1.0f : 0.01f * (Frame % 3)), 0.0f, 0.0f);
+    };
+
+    for (int32 Frame = 0; Frame < TickJobFrames; Frame++)
+    {
+        FGraphEventArray Events;
+        for (int32 Actor = 0; Actor < TickJobActors; Actor++)
+        {
+            AQuantumClothSimulation::StepQuantumState(Serial[Actor], LocationAt(Actor, Frame), Threshold,
+                DeltaSeconds, SerialRandom[Actor]);
+
+            FState* State = &Jobs[Actor];
+            FRandomStream* Random = &JobRandom[Actor];
+            const FVector Location = LocationAt(Actor, Frame);
+            Events.Add(FFunctionGraphTask::CreateAndDispatchWhenReady(
+                [State, Random, Location, Threshold, DeltaSeconds]()
+                {
+                    AQuantumClothSimulation::StepQuantumState(*State, Location, Threshold, DeltaSeconds, *Random);
+                },
+                TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask));
+        }
+        FTaskGraphInterface::Get().WaitUntilTasksComplete(Events, ENamedThreads::GameThread);
+    }
+
+    for (int32 Actor = 0; Actor < TickJobActors; Actor++)
+    {
+        TestTrue(FString::Printf(TEXT("Actor %d contract"), Actor), SameContract(Serial[Actor].Contract, Jobs[Actor].Contract));
+        TestEqual(FString::Printf(TEXT("Actor %d stable position"), Actor),
+            Serial[Actor].LastStablePosition, Jobs[Actor].LastStablePosition);
+        TestEqual(FString::Printf(TEXT("Actor %d jitter samples"), Actor),
+            Serial[Actor].JitterSampleCount, Jobs[Actor].JitterSampleCount);
+    }
+
+    // Six still frames settle the anti-jitter position; a jump resets it
+    FState Still;
+    FRandomStream Random(7);
+    Still.LastStablePosition = FVector::ZeroVector;
+    const FVector Nearby(0.05f, 0.0f, 0.0f);
+    for (int32 Frame = 0; Frame < 5; Frame++)
+    {
+        AQuantumClothSimulation::StepQuantumState(Still, Nearby, Threshold, DeltaSeconds, Random);
+    }
+    TestEqual(TEXT("Samples before settling"), Still.JitterSampleCount, 5);
+    TestEqual(TEXT("Position before settling"), Still.LastStablePosition, FVector::ZeroVector);
+    AQuantumClothSimulation::StepQuantumState(Still, Nearby, Threshold, DeltaSeconds, Random);
+    TestEqual(TEXT("Settled position"), Still.LastStablePosition, Nearby);
+    TestEqual(TEXT("Samples after settling"), Still.JitterSampleCount, 0);
+    AQuantumClothSimulation::StepQuantumState(Still, FVector(5.0f, 0.0f, 0.0f), Threshold, DeltaSeconds, Random);
+    TestEqual(TEXT("Samples after a jump"), Still.JitterSampleCount, 0);
+    TestTrue(TEXT("Isolated contract stabilises"), Still.Contract.bIsStabilized);
+    return true;
+}
+
+// ApplyNegativeMassField calls within a frame are summed, the latest
+// strength winning, and the post-physics tick applies them once
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuantumClothFieldBatchTest, "OBINexus.QuantumCloth.FieldBatch",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FQuantumClothFieldBatchTest::RunTest(const FString& Parameters)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+    FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+    Context.SetCurrentWorld(World);
+
+    AQuantumClothSimulation* Cloth = World->SpawnActor<AQuantumClothSimulation>();
+    TestNotNull(TEXT("Spawned cloth"), Cloth);
+    if (Cloth)
+    {
+        FQuantumContract Open;
+        Open.CurrentState = EQuantumState::OPEN;
+        Open.CollapseThreshold = 10.0f;
+        Cloth->UpdateQuantumContract(Open);
+
+        Cloth->ApplyNegativeMassField(FVector(10.0f, 0.0f, 0.0f), 1.0f);
+        Cloth->ApplyNegativeMassField(FVector(0.0f, 10.0f, 0.0f), 2.0f);
+        TestTrue(TEXT("Field pending"), Cloth->bFieldPending);
+        TestEqual(TEXT("Latest strength"), Cloth->PendingFieldStrength, 2.0f);
+        TestEqual(TEXT("Summed offset"), Cloth->PendingFieldOffset, FVector(-1.0f, -2.0f, 0.0f));
+        TestEqual(TEXT("Not yet applied"), Cloth->ActiveContract.NegativeMassInfluence, 0.0f);
+
+        Cloth->PostPhysicsTick.Target = Cloth;
+        Cloth->PostPhysicsTick.ExecuteTick(0.0f, LEVELTICK_All, ENamedThreads::GameThread, FGraphEventRef());
+        TestFalse(TEXT("Field applied"), Cloth->bFieldPending);
+        TestEqual(TEXT("Strength applied"), Cloth->ActiveContract.NegativeMassInfluence, 2.0f);
+        TestEqual(TEXT("Offset cleared"), Cloth->PendingFieldOffset, FVector::ZeroVector);
+
+        // Outside the open state a field sets the strength but does not push
+        FQuantumContract Closed;
+        Closed.CurrentState = EQuantumState::CLOSED;
+        Cloth->UpdateQuantumContract(Closed);
+        Cloth->ApplyNegativeMassField(FVector(10.0f, 0.0f, 0.0f), 3.0f);
+        TestEqual(TEXT("No offset when closed"), Cloth->PendingFieldOffset, FVector::ZeroVector);
+        Cloth->Destroy();
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return true;
+}
+
+#endif
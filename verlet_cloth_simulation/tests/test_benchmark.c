@@ -0,0 +1,125 @@
+// tests/test_benchmark.c
+// Checks for the headless benchmark: fixed-timestep runs are reproducible
+// across runs and solver thread counts, the dump holds every particle, and
+// bad arguments fail cleanly
+
+#define _POSIX_C_SOURCE 200809L     // mkdtemp
+
+#include "cloth_simulation.c"
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// The benchmark reports on stdout; keep it out of the test log
+static int quiet_begin(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved >= 0 && null >= 0);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void quiet_end(int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static char* read_file(const char* path, size_t* size) {
+    struct stat st;
+    assert(stat(path, &st) == 0);
+    char* contents = malloc((size_t)st.st_size + 1);
+    assert(contents != NULL);
+    FILE* in = fopen(path, "r");
+    assert(in != NULL);
+    assert(fread(contents, 1, (size_t)st.st_size, in) == (size_t)st.st_size);
+    fclose(in);
+    contents[st.st_size] = '\0';
+    *size = (size_t)st.st_size;
+    return contents;
+}
+
+static size_t count_lines(const char* text) {
+    size_t lines = 0;
+    for (; *text; text++) lines += *text == '\n';
+    return lines;
+}
+
+static void test_reproducible_runs(void) {
+    printf("Testing reproducible runs...\n");
+
+    char dir[] = "/tmp/cloth_bench_XXXXXX";
+    assert(mkdtemp(dir) != NULL);
+    char first[64], second[64];
+    snprintf(first, sizeof(first), "%s/first", dir);
+    snprintf(second, sizeof(second), "%s/second", dir);
+
+    // Every feature on, so the hash, collision and tearing passes are
+    // covered too; threads share rows, so the count does not matter
+    const int features = CLOTH_TEARING | CLOTH_SELF_COLLISION;
+    int saved = quiet_begin();
+    assert(run_cloth_benchmark(40, 70, 120, 4, 1, features, first) == 0);
+    quiet_end(saved);
+    size_t size;
+    char* expected = read_file(first, &size);
+    assert(count_lines(expected) == 40 * 70);
+    float x, y;
+    assert(sscanf(expected, "%f %f", &x, &y) == 2);
+
+    int threads[] = { 1, 2, 3 };
+    for (size_t k = 0; k < sizeof(threads) / sizeof(threads[0]); k++) {
+        saved = quiet_begin();
+        assert(run_cloth_benchmark(40, 70, 120, 4, threads[k], features, second) == 0);
+        quiet_end(saved);
+        size_t other_size;
+        char* other = read_file(second, &other_size);
+        assert(other_size == size && memcmp(other, expected, size) == 0);
+        free(other);
+    }
+    free(expected);
+
+    // Zero sizes and out-of-range settings fall back to the defaults
+    saved = quiet_begin();
+    assert(run_cloth_benchmark(0, 0, 0, 0, 0, 0, first) == 0);
+    quiet_end(saved);
+    expected = read_file(first, &size);
+    assert(count_lines(expected) == GRID_WIDTH * GRID_HEIGHT);
+    free(expected);
+
+    unlink(first);
+    unlink(second);
+    rmdir(dir);
+    printf("Reproducible runs test passed\n");
+}
+
+static void test_bad_arguments(void) {
+    printf("Testing bad arguments...\n");
+
+    // Errors go to stderr; silence it as well
+    fflush(stderr);
+    int saved_err = dup(STDERR_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    assert(saved_err >= 0 && null >= 0);
+    dup2(null, STDERR_FILENO);
+    close(null);
+
+    int saved = quiet_begin();
+    assert(run_cloth_benchmark(5000, 10, 1, 1, 1, 0, NULL) == 1);
+    assert(run_cloth_benchmark(10, 1, 1, 1, 1, 0, NULL) == 1);
+    assert(run_cloth_benchmark(10, 10, 1, 1, 1, 0, "/nonexistent/dump") == 1);
+    assert(run_cloth_benchmark(10, 10, 1, 1, 1, 0, NULL) == 0);
+    quiet_end(saved);
+
+    dup2(saved_err, STDERR_FILENO);
+    close(saved_err);
+    printf("Bad arguments test passed\n");
+}
+
+int main(void) {
+    test_reproducible_runs();
+    test_bad_arguments();
+    printf("All benchmark tests passed!\n");
+    return 0;
+}
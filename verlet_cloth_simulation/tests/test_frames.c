@@ -0,0 +1,154 @@
+// tests/test_frames.c
+// Checks for the physics thread's triple buffer: the reader only ever sees
+// whole frames, newest last, and the physics loop publishes on its own
+// until stopped
+
+#include "cloth_simulation.c"
+#include <assert.h>
+
+#define TEST_WIDTH 64
+#define TEST_HEIGHT 64
+#define TEST_FRAMES 3000
+
+// Every particle of frame k sits at (k, -k); link state alternates
+static void fill_frame(Cloth* c, int k) {
+    for (int i = 0; i < c->count; i++) {
+        c->x[i] = (float)k;
+        c->y[i] = (float)-k;
+    }
+    memset(c->torn_right, k & 1, (size_t)c->count);
+    memset(c->torn_down, (k >> 1) & 1, (size_t)c->count);
+}
+
+// Frame number of a buffer, checking it holds one frame throughout
+static int frame_number(const ClothFrame* frame, int count) {
+    int k = (int)frame->x[0];
+    for (int i = 0; i < count; i++) {
+        assert(frame->x[i] == (float)k && frame->y[i] == (float)-k);
+        assert(frame->torn_right[i] == (k & 1) && frame->torn_down[i] == ((k >> 1) & 1));
+    }
+    return k;
+}
+
+static void test_single_thread(void) {
+    printf("Testing single thread...\n");
+
+    Cloth c;
+    assert(init_cloth(&c, 8, 4));
+    fill_frame(&c, 0);
+    FrameBuffer f;
+    assert(init_frames(&f, &c));
+    assert(f.back != f.middle && f.middle != f.front && f.front != f.back);
+    for (int k = 0; k < 3; k++) assert(frame_number(&f.frame[k], c.count) == 0);
+
+    // Nothing new: the front stays put
+    int front = f.front;
+    acquire_frame(&f);
+    assert(f.front == front);
+
+    // Only the newest of several frames reaches the front, once
+    for (int k = 1; k <= 3; k++) {
+        fill_frame(&c, k);
+        publish_frame(&f, &c);
+    }
+    acquire_frame(&f);
+    assert(frame_number(&f.frame[f.front], c.count) == 3);
+    front = f.front;
+    acquire_frame(&f);
+    assert(f.front == front);
+    assert(!(f.middle & FRAME_FRESH));
+    assert(f.back != f.middle && f.middle != f.front && f.front != f.back);
+
+    free_frames(&f);
+    free_frames(&f);
+    free_cloth(&c);
+    printf("Single thread test passed\n");
+}
+
+typedef struct {
+    FrameBuffer* frames;
+    Cloth* cloth;
+} Producer;
+
+static void* produce(void* arg) {
+    Producer* p = arg;
+    for (int k = 1; k <= TEST_FRAMES; k++) {
+        fill_frame(p->cloth, k);
+        publish_frame(p->frames, p->cloth);
+    }
+    return NULL;
+}
+
+static void test_across_threads(void) {
+    printf("Testing across threads...\n");
+
+    // The reader checks every buffer it is handed is a whole frame, and
+    // that frames never go backwards
+    Cloth c;
+    assert(init_cloth(&c, TEST_WIDTH, TEST_HEIGHT));
+    fill_frame(&c, 0);
+    FrameBuffer f;
+    assert(init_frames(&f, &c));
+    Producer p = { &f, &c };
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, produce, &p) == 0);
+
+    int last = 0, seen = 0;
+    while (last < TEST_FRAMES) {
+        acquire_frame(&f);
+        int k = frame_number(&f.frame[f.front], c.count);
+        assert(k >= last);
+        seen += k > last;
+        last = k;
+    }
+    pthread_join(thread, NULL);
+    assert(seen > 0);
+
+    free_frames(&f);
+    free_cloth(&c);
+    printf("Across threads test passed\n");
+}
+
+static void test_physics_loop(void) {
+    printf("Testing physics loop...\n");
+
+    init_materials();
+    assert(init_cloth(&cloth, 30, 20));
+    init_particles();
+    init_constraints();
+    assert(init_solver(3, 2));
+    assert(init_spatial_hash(&spatial_hash, &cloth, solver.threads));
+    float pinned_y = cloth.y[0], rest_y = cloth.y[cloth.count - 1];
+
+    // The loop publishes fresh frames on its own; the cloth sags in them
+    assert(start_physics(&physics));
+    assert(physics.running);
+    int fresh = 0;
+    for (int wait = 0; wait < 400 && fresh < 5; wait++) {
+        int front = physics.frames.front;
+        acquire_frame(&physics.frames);
+        fresh += physics.frames.front != front;
+        SDL_Delay(5);
+    }
+    assert(fresh >= 5);
+    const ClothFrame* frame = &physics.frames.frame[physics.frames.front];
+    assert(frame->y[cloth.count - 1] > rest_y);
+    assert(frame->y[0] == pinned_y);
+
+    stop_physics(&physics);
+    assert(!physics.running);
+    stop_physics(&physics);
+
+    free_spatial_hash(&spatial_hash);
+    free_solver();
+    free_cloth(&cloth);
+    printf("Physics loop test passed\n");
+}
+
+int main(void) {
+    test_single_thread();
+    test_across_threads();
+    test_physics_loop();
+    printf("All frame tests passed!\n");
+    return 0;
+}
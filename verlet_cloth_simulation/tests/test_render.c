@@ -0,0 +1,131 @@
+// tests/test_render.c
+// Checks for the batched renderer: buffers are sized once for the grid,
+// and each frame becomes one quad per intact link and per particle, with
+// torn links left out
+
+#include "cloth_simulation.c"
+#include <assert.h>
+
+#define TEST_WIDTH 9
+#define TEST_HEIGHT 6
+
+static void setup_cloth(void) {
+    init_materials();
+    assert(init_cloth(&cloth, TEST_WIDTH, TEST_HEIGHT));
+    init_particles();
+    init_constraints();
+    assert(init_render_batch(&batch, &cloth));
+}
+
+static void test_batch_layout(void) {
+    printf("Testing batch layout...\n");
+
+    setup_cloth();
+#ifdef CLOTH_RENDER_GEOMETRY
+    // One quad per constraint and per particle, as two triangles each
+    int quads = cloth.num_constraints + cloth.count;
+    assert(cloth.num_constraints == (TEST_WIDTH - 1) * TEST_HEIGHT + TEST_WIDTH * (TEST_HEIGHT - 1));
+    assert(batch.num_vertices == 4 * quads && batch.num_indices == 6 * quads);
+    for (int q = 0; q < quads; q++) {
+        const int* idx = &batch.indices[q * 6];
+        int v = q * 4;
+        assert(idx[0] == v && idx[1] == v + 1 && idx[2] == v + 2);
+        assert(idx[3] == v && idx[4] == v + 2 && idx[5] == v + 3);
+    }
+    for (int v = 0; v < cloth.num_constraints * 4; v++) {
+        SDL_Color c = batch.vertices[v].color;
+        assert(c.r == 200 && c.g == 200 && c.b == 200 && c.a == 255);
+    }
+#else
+    assert(batch.strip != NULL && batch.rects[0] != NULL && batch.rects[1] != NULL);
+#endif
+    free_render_batch(&batch);
+    free_render_batch(&batch);
+    free_cloth(&cloth);
+
+    printf("Batch layout test passed\n");
+}
+
+#ifdef CLOTH_RENDER_GEOMETRY
+static float quad_area(const SDL_Vertex* v) {
+    // Shoelace over the four corners
+    float area = 0.0f;
+    for (int k = 0; k < 4; k++) {
+        const SDL_FPoint* a = &v[k].position;
+        const SDL_FPoint* b = &v[(k + 1) % 4].position;
+        area += a->x * b->y - b->x * a->y;
+    }
+    return fabsf(area) * 0.5f;
+}
+#endif
+
+static void test_frame_quads(void) {
+    printf("Testing frame quads...\n");
+
+    setup_cloth();
+    // Tear one horizontal and one vertical link, and draw from a frame that
+    // differs from the simulation's own state
+    const int torn_h = 2 * TEST_WIDTH + 3, torn_v = 3 * TEST_WIDTH + 5;
+    size_t n = (size_t)cloth.count;
+    ClothFrame frame = {
+        malloc(n * sizeof(float)), malloc(n * sizeof(float)), calloc(n, 1), calloc(n, 1)
+    };
+    assert(frame.x && frame.y && frame.torn_right && frame.torn_down);
+    for (int i = 0; i < cloth.count; i++) {
+        frame.x[i] = cloth.x[i] + 1.5f;
+        frame.y[i] = cloth.y[i] + 0.25f * (float)(i % 3);
+    }
+    frame.torn_right[torn_h] = 1;
+    frame.torn_down[torn_v] = 1;
+
+    render_cloth(NULL, &frame);
+
+#ifdef CLOTH_RENDER_GEOMETRY
+    const SDL_Vertex* v = batch.vertices;
+    for (int i = 0; i < cloth.num_constraints; i++, v += 4) {
+        const Constraint* c = &cloth.constraints[i];
+        bool torn = c->p2 == c->p1 + 1 ? c->p1 == torn_h : c->p1 == torn_v;
+        float dx = frame.x[c->p2] - frame.x[c->p1], dy = frame.y[c->p2] - frame.y[c->p1];
+        float length = sqrtf(dx * dx + dy * dy);
+        if (torn) {
+            assert(quad_area(v) == 0.0f);
+            continue;
+        }
+        // A one-pixel-wide strip centred on the link
+        assert(fabsf(quad_area(v) - length) < 1e-3f * length);
+        float mid_x = 0.0f, mid_y = 0.0f;
+        for (int k = 0; k < 4; k++) {
+            mid_x += 0.25f * v[k].position.x;
+            mid_y += 0.25f * v[k].position.y;
+        }
+        assert(fabsf(mid_x - 0.5f * (frame.x[c->p1] + frame.x[c->p2])) < 1e-3f);
+        assert(fabsf(mid_y - 0.5f * (frame.y[c->p1] + frame.y[c->p2])) < 1e-3f);
+    }
+    for (int i = 0; i < cloth.count; i++, v += 4) {
+        // Particles are squares on their frame position, red when pinned
+        assert(fabsf(quad_area(v) - PARTICLE_SIZE * PARTICLE_SIZE) < 1e-3f);
+        assert(v[0].position.x == frame.x[i] - 0.5f * PARTICLE_SIZE);
+        assert(v[2].position.y == frame.y[i] + 0.5f * PARTICLE_SIZE);
+        for (int k = 0; k < 4; k++) {
+            assert(v[k].color.r == (cloth.locked[i] ? 255 : 100));
+            assert(v[k].color.g == (cloth.locked[i] ? 0 : 100));
+        }
+    }
+    assert(v == batch.vertices + batch.num_vertices);
+#endif
+
+    free(frame.x);
+    free(frame.y);
+    free(frame.torn_right);
+    free(frame.torn_down);
+    free_render_batch(&batch);
+    free_cloth(&cloth);
+    printf("Frame quads test passed\n");
+}
+
+int main(void) {
+    test_batch_layout();
+    test_frame_quads();
+    printf("All render tests passed!\n");
+    return 0;
+}
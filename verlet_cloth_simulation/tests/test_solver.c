@@ -0,0 +1,179 @@
+// tests/test_solver.c
+// Checks for the graph-coloured constraint solver: any number of threads
+// gives bit-identical results, which follow a scalar sweep in colour order,
+// and torn links and pinned particles are respected
+
+#include "cloth_simulation.c"
+#include <assert.h>
+
+#define TEST_WIDTH 37               // Odd: both parities end in a tail
+#define TEST_HEIGHT 41
+#define TEST_STEPS 30
+#define TEST_ITERATIONS 4
+
+static float next_unit(uint64_t* seed) {
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (float)(*seed >> 40) * 0x1.0p-24f;
+}
+
+// The hanging cloth, jostled and with a few links torn
+static void setup_cloth(void) {
+    init_materials();
+    assert(init_cloth(&cloth, TEST_WIDTH, TEST_HEIGHT));
+    init_particles();
+    init_constraints();
+    uint64_t seed = 5;
+    for (int i = 0; i < cloth.count; i++) {
+        if (cloth.locked[i]) continue;
+        cloth.x[i] += cloth.spacing * (next_unit(&seed) - 0.5f);
+        cloth.y[i] += cloth.spacing * (next_unit(&seed) - 0.5f);
+        cloth.torn_right[i] = next_unit(&seed) < 0.05f;
+        cloth.torn_down[i] = next_unit(&seed) < 0.05f;
+    }
+}
+
+// Steps the cloth with the given solver threads; returns the positions
+static float* run_steps(int threads) {
+    setup_cloth();
+    assert(init_solver(TEST_ITERATIONS, threads));
+    assert(solver.threads == threads);
+    for (int step = 0; step < TEST_STEPS; step++) {
+        current_material.integrate(&cloth, &current_material, PHYSICS_DT);
+        for (int j = 0; j < solver.iterations; j++) {
+            current_material.solve_constraints(&cloth, &current_material);
+        }
+    }
+    free_solver();
+
+    float* positions = malloc(2 * (size_t)cloth.count * sizeof(float));
+    assert(positions != NULL);
+    memcpy(positions, cloth.x, (size_t)cloth.count * sizeof(float));
+    memcpy(positions + cloth.count, cloth.y, (size_t)cloth.count * sizeof(float));
+    free_cloth(&cloth);
+    return positions;
+}
+
+static void test_thread_counts_agree(void) {
+    printf("Testing thread counts agree...\n");
+
+    // Each colour's links share no particle, so how rows are shared out
+    // cannot change the result
+    float* single = run_steps(1);
+    int counts[] = { 2, 3, 4, 7 };
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        float* threaded = run_steps(counts[k]);
+        assert(memcmp(single, threaded, 2 * (size_t)TEST_WIDTH * TEST_HEIGHT * sizeof(float)) == 0);
+        free(threaded);
+    }
+    free(single);
+
+    printf("Thread counts agree test passed\n");
+}
+
+// One pass as a plain loop over the four colours
+static void reference_pass(Cloth* c, float rest, float share) {
+    for (int parity = 0; parity < 2; parity++) {
+        for (int row = 0; row < c->height; row++) {
+            for (int x = parity; x + 1 < c->width; x += 2) {
+                int i = row * c->width + x;
+                solve_link(c, i, i + 1, c->torn_right[i], rest, share);
+            }
+        }
+    }
+    for (int parity = 0; parity < 2; parity++) {
+        for (int row = parity; row + 1 < c->height; row += 2) {
+            for (int x = 0; x < c->width; x++) {
+                int i = row * c->width + x;
+                solve_link(c, i, i + c->width, c->torn_down[i], rest, share);
+            }
+        }
+    }
+}
+
+static void test_matches_scalar_sweep(void) {
+    printf("Testing matches scalar sweep...\n");
+
+    setup_cloth();
+    Cloth reference;
+    assert(init_cloth(&reference, TEST_WIDTH, TEST_HEIGHT));
+    size_t n = (size_t)cloth.count;
+    memcpy(reference.x, cloth.x, n * sizeof(float));
+    memcpy(reference.y, cloth.y, n * sizeof(float));
+    memcpy(reference.locked, cloth.locked, n);
+    memcpy(reference.torn_right, cloth.torn_right, n);
+    memcpy(reference.torn_down, cloth.torn_down, n);
+
+    assert(init_solver(1, 3));
+    for (int pass = 0; pass < 20; pass++) {
+        solve_constraints_cotton(&cloth, &current_material);
+        reference_pass(&reference, cloth.spacing, 0.5f * current_material.elasticity);
+        for (size_t i = 0; i < n; i++) {
+            // Vector code may round multiply-adds differently
+            assert(fabsf(cloth.x[i] - reference.x[i]) < 1e-3f);
+            assert(fabsf(cloth.y[i] - reference.y[i]) < 1e-3f);
+        }
+    }
+    free_solver();
+    free_cloth(&reference);
+    free_cloth(&cloth);
+
+    printf("Matches scalar sweep test passed\n");
+}
+
+static void test_torn_and_pinned(void) {
+    printf("Testing torn and pinned...\n");
+
+    // With every link torn nothing moves
+    setup_cloth();
+    memset(cloth.torn_right, 1, (size_t)cloth.count);
+    memset(cloth.torn_down, 1, (size_t)cloth.count);
+    size_t bytes = (size_t)cloth.count * sizeof(float);
+    float* x = malloc(bytes);
+    float* y = malloc(bytes);
+    assert(x != NULL && y != NULL);
+    memcpy(x, cloth.x, bytes);
+    memcpy(y, cloth.y, bytes);
+    assert(init_solver(3, 2));
+    for (int j = 0; j < solver.iterations; j++) {
+        solve_constraints_cotton(&cloth, &current_material);
+    }
+    assert(memcmp(x, cloth.x, bytes) == 0 && memcmp(y, cloth.y, bytes) == 0);
+
+    // Intact, the stretched cloth relaxes toward its rest length, and the
+    // pinned top row stays put
+    memset(cloth.torn_right, 0, (size_t)cloth.count);
+    memset(cloth.torn_down, 0, (size_t)cloth.count);
+    float worst_before = 0.0f, worst_after = 0.0f;
+    for (int round = 0; round < 2; round++) {
+        float worst = 0.0f;
+        for (int i = 0; i + 1 < cloth.count; i++) {
+            if ((i + 1) % cloth.width == 0) continue;
+            float dx = cloth.x[i + 1] - cloth.x[i], dy = cloth.y[i + 1] - cloth.y[i];
+            worst = fmaxf(worst, fabsf(sqrtf(dx * dx + dy * dy) - cloth.spacing));
+        }
+        if (round == 0) {
+            worst_before = worst;
+            for (int pass = 0; pass < 200; pass++) solve_constraints_cotton(&cloth, &current_material);
+        } else {
+            worst_after = worst;
+        }
+    }
+    assert(worst_after < 0.5f * worst_before);
+    for (int i = 0; i < cloth.width; i++) {
+        assert(cloth.locked[i] && cloth.x[i] == x[i] && cloth.y[i] == y[i]);
+    }
+
+    free_solver();
+    free_cloth(&cloth);
+    free(x);
+    free(y);
+    printf("Torn and pinned test passed\n");
+}
+
+int main(void) {
+    test_thread_counts_agree();
+    test_matches_scalar_sweep();
+    test_torn_and_pinned();
+    printf("All solver tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+// tests/test_spatial_hash.c
+// Checks for the spatial hash and what uses it: the sort is the same for
+// any thread count, self-collision and mouse picking find exactly what a
+// brute-force search finds, and tearing is calibrated to the hanging cloth
+
+#include "cloth_simulation.c"
+#include <assert.h>
+
+#define TEST_WIDTH 45
+#define TEST_HEIGHT 38
+
+static float next_unit(uint64_t* seed) {
+    *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (float)(*seed >> 40) * 0x1.0p-24f;
+}
+
+// The hanging cloth, crumpled so particles crowd each other
+static void setup_cloth(int threads) {
+    init_materials();
+    assert(init_cloth(&cloth, TEST_WIDTH, TEST_HEIGHT));
+    init_particles();
+    init_constraints();
+    uint64_t seed = 9;
+    for (int i = 0; i < cloth.count; i++) {
+        if (cloth.locked[i]) continue;
+        float squeeze = 0.35f + 0.3f * next_unit(&seed);
+        cloth.x[i] = SCREEN_WIDTH / 2 + (cloth.x[i] - SCREEN_WIDTH / 2) * squeeze;
+        cloth.y[i] += cloth.spacing * (next_unit(&seed) - 0.5f);
+        cloth.old_x[i] = cloth.x[i];
+        cloth.old_y[i] = cloth.y[i];
+    }
+    assert(init_solver(1, threads));
+    assert(init_spatial_hash(&spatial_hash, &cloth, solver.threads));
+}
+
+static void teardown_cloth(void) {
+    free_spatial_hash(&spatial_hash);
+    free_solver();
+    free_cloth(&cloth);
+}
+
+static void test_hash_sort(void) {
+    printf("Testing hash sort...\n");
+
+    // Threads count and scatter their own ranges, so the sorted order is
+    // the same for any count: by bucket, then by particle index
+    setup_cloth(1);
+    build_spatial_hash(&cloth);
+    const SpatialHash* h = &spatial_hash;
+    assert(h->buckets >= HASH_MIN_BUCKETS && (h->buckets & (h->buckets - 1)) == 0);
+    assert(h->start[0] == 0 && h->start[h->buckets] == cloth.count);
+    size_t n = (size_t)cloth.count;
+    int* expected = malloc(n * sizeof(int));
+    assert(expected != NULL);
+    memcpy(expected, h->sorted, n * sizeof(int));
+    for (int b = 0; b < h->buckets; b++) {
+        assert(h->start[b] <= h->start[b + 1]);
+        for (int q = h->start[b]; q < h->start[b + 1]; q++) {
+            int i = h->sorted[q];
+            assert(h->key[i] == b);
+            assert(b == hash_cell(h, cell_coord(h, cloth.x[i]), cell_coord(h, cloth.y[i])));
+            assert(h->sorted_x[q] == cloth.x[i] && h->sorted_y[q] == cloth.y[i]);
+            assert(q == h->start[b] || h->sorted[q - 1] < i);
+        }
+    }
+    teardown_cloth();
+
+    int counts[] = { 2, 3, 5 };
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        setup_cloth(counts[k]);
+        build_spatial_hash(&cloth);
+        assert(memcmp(spatial_hash.sorted, expected, n * sizeof(int)) == 0);
+        teardown_cloth();
+    }
+    free(expected);
+
+    printf("Hash sort test passed\n");
+}
+
+static void test_collision_brute_force(void) {
+    printf("Testing collision against brute force...\n");
+
+    // Every pair closer than a collision diameter, found the slow way and
+    // applied the same Jacobi way
+    for (int threads = 1; threads <= 3; threads += 2) {
+        setup_cloth(threads);
+
+        // A few particles huddled on the cell boundary where a row of
+        // buckets wraps around the end of the table
+        const SpatialHash* h = &spatial_hash;
+        float wrap_y = (float)(h->buckets / h->stride) * h->cell_size + 0.5f * h->cell_size;
+        for (int k = 0; k < 6; k++) {
+            int i = cloth.count - 1 - k;
+            cloth.x[i] = (float)(k - 3) * 0.3f * h->cell_size;
+            cloth.y[i] = wrap_y + (float)(k % 2) * 0.2f * h->cell_size;
+        }
+        assert(hash_cell(h, -1, (int)(wrap_y * h->inv_cell)) == h->buckets - 1);
+
+        size_t n = (size_t)cloth.count;
+        float* x = malloc(n * sizeof(float));
+        float* y = malloc(n * sizeof(float));
+        assert(x != NULL && y != NULL);
+        const float diameter = cloth.spacing * COLLISION_DIAMETER;
+        int contacts = 0;
+        for (int i = 0; i < cloth.count; i++) {
+            float push_x = 0.0f, push_y = 0.0f;
+            for (int j = 0; j < cloth.count && !cloth.locked[i]; j++) {
+                float dx = cloth.x[i] - cloth.x[j], dy = cloth.y[i] - cloth.y[j];
+                float d2 = dx * dx + dy * dy;
+                if (j == i || d2 >= diameter * diameter || d2 < 1e-12f) continue;
+                float dist = sqrtf(d2);
+                push_x += dx * 0.5f * (diameter - dist) / dist;
+                push_y += dy * 0.5f * (diameter - dist) / dist;
+                contacts++;
+            }
+            x[i] = cloth.x[i] + push_x;
+            y[i] = cloth.y[i] + push_y;
+        }
+        assert(contacts > cloth.count);
+
+        build_spatial_hash(&cloth);
+        collide_cloth(&cloth);
+        for (int i = 0; i < cloth.count; i++) {
+            // Pushes are summed in a different order
+            assert(fabsf(cloth.x[i] - x[i]) < 1e-3f && fabsf(cloth.y[i] - y[i]) < 1e-3f);
+        }
+        free(x);
+        free(y);
+        teardown_cloth();
+    }
+
+    printf("Collision against brute force test passed\n");
+}
+
+static void test_mouse_picking(void) {
+    printf("Testing mouse picking...\n");
+
+    // Cutting at a point tears exactly the links of the particles within
+    // CUT_RADIUS of it, wherever it lands relative to the cells; the last
+    // point is on the pinned top row
+    float points[][2] = {
+        { SCREEN_WIDTH / 2.0f, 200.0f }, { SCREEN_WIDTH / 2.0f + 3.3f, 260.0f }, { 100.0f, 12.0f }
+    };
+    int dragged = 0, cut = 0;
+    for (size_t k = 0; k < sizeof(points) / sizeof(points[0]); k++) {
+        setup_cloth(2);
+        int mx = (int)points[k][0], my = (int)points[k][1];
+        size_t n = (size_t)cloth.count;
+        unsigned char* right = calloc(n, 1);
+        unsigned char* down = calloc(n, 1);
+        assert(right != NULL && down != NULL);
+        for (int i = 0; i < cloth.count; i++) {
+            float dx = cloth.x[i] - (float)mx, dy = cloth.y[i] - (float)my;
+            if (dx * dx + dy * dy >= CUT_RADIUS * CUT_RADIUS) continue;
+            right[i] = down[i] = 1;
+            cut++;
+            if (i % cloth.width > 0) right[i - 1] = 1;
+            if (i >= cloth.width) down[i - cloth.width] = 1;
+        }
+
+        set_mouse(mx, my);
+        build_spatial_hash(&cloth);
+        handle_mouse_interaction(false, true);
+        assert(memcmp(cloth.torn_right, right, n) == 0 && memcmp(cloth.torn_down, down, n) == 0);
+
+        // Dragging pulls free particles within MOUSE_RADIUS onto the mouse
+        // and leaves the rest, pinned ones included, where they were
+        float* x = malloc(n * sizeof(float));
+        float* y = malloc(n * sizeof(float));
+        assert(x != NULL && y != NULL);
+        memcpy(x, cloth.x, n * sizeof(float));
+        memcpy(y, cloth.y, n * sizeof(float));
+        handle_mouse_interaction(true, false);
+        for (int i = 0; i < cloth.count; i++) {
+            float dx = x[i] - (float)mx, dy = y[i] - (float)my;
+            if (!cloth.locked[i] && dx * dx + dy * dy < MOUSE_RADIUS * MOUSE_RADIUS) {
+                assert(cloth.x[i] == (float)mx && cloth.y[i] == (float)my);
+                assert(cloth.old_x[i] == (float)mx && cloth.old_y[i] == (float)my);
+                dragged++;
+            } else {
+                assert(cloth.x[i] == x[i] && cloth.y[i] == y[i]);
+            }
+        }
+        free(x);
+        free(y);
+        free(right);
+        free(down);
+        teardown_cloth();
+    }
+    assert(dragged > 0 && cut > 0);
+
+    printf("Mouse picking test passed\n");
+}
+
+static void test_tear_calibration(void) {
+    printf("Testing tear calibration...\n");
+
+    init_materials();
+    assert(init_cloth(&cloth, 30, 40));
+    init_particles();
+    init_constraints();
+    assert(init_solver(2, 2));
+    size_t bytes = (size_t)cloth.count * sizeof(float);
+    float* x = malloc(bytes);
+    assert(x != NULL);
+    memcpy(x, cloth.x, bytes);
+
+    // Calibration leaves the cloth as it found it; each row's limit is at
+    // least tear_strain times the rest length, and the upper rows, which
+    // carry the weight, stretch furthest
+    assert(calibrate_tearing(&cloth, &current_material));
+    assert(memcmp(x, cloth.x, bytes) == 0);
+    float strain_sq = current_material.tear_strain * current_material.tear_strain;
+    float rest_sq = cloth.spacing * cloth.spacing;
+    for (int row = 0; row < cloth.height; row++) {
+        assert(cloth.tear_right_sq[row] >= rest_sq * strain_sq * 0.999f);
+        assert(cloth.tear_down_sq[row] >= rest_sq * strain_sq * 0.999f);
+    }
+    assert(cloth.tear_down_sq[0] > cloth.tear_down_sq[cloth.height - 2]);
+
+    // Left alone it hangs without tearing; pulled hard, a link gives
+    for (int step = 0; step < 300; step++) {
+        current_material.integrate(&cloth, &current_material, PHYSICS_DT);
+        for (int j = 0; j < solver.iterations; j++) {
+            current_material.solve_constraints(&cloth, &current_material);
+        }
+        tear_cloth(&cloth);
+    }
+    for (int i = 0; i < cloth.count; i++) assert(!cloth.torn_right[i] && !cloth.torn_down[i]);
+    int pulled = (cloth.height - 1) * cloth.width + cloth.width / 2;
+    cloth.y[pulled] += 10.0f * cloth.spacing;
+    tear_cloth(&cloth);
+    assert(cloth.torn_down[pulled - cloth.width]);
+
+    free(x);
+    free_solver();
+    free_cloth(&cloth);
+    printf("Tear calibration test passed\n");
+}
+
+int main(void) {
+    test_hash_sort();
+    test_collision_brute_force();
+    test_mouse_picking();
+    test_tear_calibration();
+    printf("All spatial hash tests passed!\n");
+    return 0;
+}